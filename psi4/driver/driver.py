@@ -167,6 +167,10 @@ def energy(name, **kwargs):
     +-------------------------+---------------------------------------------------------------------------------------------------------------------------------------+
     | scs-dlpno-mp2           | spin-component-scaled DLPNO MP2 :ref:`[manual] <sec:dlpnomp2>`                                                                        |
     +-------------------------+---------------------------------------------------------------------------------------------------------------------------------------+
+    | dlpno-ccsd              | local CCSD in the DLPNO-MP2 pair natural orbitals :ref:`[manual] <sec:dlpnomp2>`                                                      |
+    +-------------------------+---------------------------------------------------------------------------------------------------------------------------------------+
+    | dlpno-ccsd(t)           | DLPNO-CCSD with semicanonical perturbative triples (T0) :ref:`[manual] <sec:dlpnomp2>`                                                |
+    +-------------------------+---------------------------------------------------------------------------------------------------------------------------------------+
     | mp3                     | 3rd-order |MollerPlesset| perturbation theory (MP3) :ref:`[manual] <sec:occ_nonoo>` :ref:`[details] <dd_mp3>`                         |
     +-------------------------+---------------------------------------------------------------------------------------------------------------------------------------+
     | fno-mp3                 | MP3 with frozen natural orbitals :ref:`[manual] <sec:fnocc>`                                                                          |
@@ -450,10 +454,12 @@ def energy(name, **kwargs):
     if lowername in integrated_basis_methods and userbas is None:
         kwargs['basis'] = '(auto)'
 
-    # Are we planning?
-    plan = task_planner.task_planner("energy", lowername, molecule, **kwargs)
-    logger.debug('ENERGY PLAN')
-    logger.debug(pp.pformat(plan.dict()))
+    # Are we planning? Force engines (MDI, i-PI) pass back the AtomicComputer of their first step
+    plan = kwargs.pop('reuse_plan', None)
+    if plan is None:
+        plan = task_planner.task_planner("energy", lowername, molecule, **kwargs)
+        logger.debug('ENERGY PLAN')
+        logger.debug(pp.pformat(plan.dict()))
 
     if kwargs.get("return_plan", False):
         # Plan-only requested
@@ -599,10 +605,12 @@ def gradient(name, **kwargs):
     if lowername in integrated_basis_methods and userbas is None:
         kwargs['basis'] = '(auto)'
 
-    # Are we planning?
-    plan = task_planner.task_planner("gradient", lowername, molecule, **kwargs)
-    logger.debug('GRADIENT PLAN')
-    logger.debug(pp.pformat(plan.dict()))
+    # Are we planning? Force engines (MDI, i-PI) pass back the AtomicComputer of their first step
+    plan = kwargs.pop('reuse_plan', None)
+    if plan is None:
+        plan = task_planner.task_planner("gradient", lowername, molecule, **kwargs)
+        logger.debug('GRADIENT PLAN')
+        logger.debug(pp.pformat(plan.dict()))
 
     if kwargs.get("return_plan", False):
         # Plan-only requested
@@ -1204,6 +1212,16 @@ def optimize(name, **kwargs):
     # Shifting the geometry so need to copy the active molecule
     moleculeclone = molecule.clone()
 
+    # Analytic gradients run in-process by a single procedures[] call take the converged wavefunction
+    #   of the previous step from memory, projected onto the new geometry, instead of reading file 180.
+    #   Other plans (findif, cbs, nbody) and cast-up guesses keep the GUESS READ handoff.
+    in_memory_guess = (not custom_gradient) and (not core.get_option('SCF', 'GUESS_PERSIST')) and \
+        (not core.has_option_changed('SCF', 'BASIS_GUESS')) and ('guess_wfn' not in kwargs)
+    if in_memory_guess:
+        plan = gradient(lowername, molecule=moleculeclone, return_plan=True, **kwargs)
+        in_memory_guess = isinstance(plan, AtomicComputer)
+    previous_wfn = None
+
     initial_sym = moleculeclone.schoenflies_symbol()
     while n <= core.get_option('OPTKING', 'GEOM_MAXITER'):
         current_sym = moleculeclone.schoenflies_symbol()
@@ -1217,7 +1235,7 @@ def optimize(name, **kwargs):
 
         # Use orbitals from previous iteration as a guess
         #   set within loop so that can be influenced by fns to optimize (e.g., cbs)
-        if (n > 1) and (not core.get_option('SCF', 'GUESS_PERSIST')):
+        if (n > 1) and (not core.get_option('SCF', 'GUESS_PERSIST')) and (previous_wfn is None):
             core.set_local_option('SCF', 'GUESS', 'READ')
 
         # Before computing gradient, save previous molecule and wavefunction if this is an IRC optimization
@@ -1226,8 +1244,14 @@ def optimize(name, **kwargs):
 
         # Compute the gradient - preserve opt data despite core.clean calls in gradient
         core.IOManager.shared_object().set_specific_retention(1, True)
-        G, wfn = gradient(lowername, return_wfn=True, molecule=moleculeclone, **kwargs)
+        if previous_wfn is not None:
+            G, wfn = gradient(lowername, return_wfn=True, molecule=moleculeclone, guess_wfn=previous_wfn, **kwargs)
+        else:
+            G, wfn = gradient(lowername, return_wfn=True, molecule=moleculeclone, **kwargs)
         thisenergy = core.variable('CURRENT ENERGY')
+        if in_memory_guess:
+            # post-SCF wavefunctions carry their reference
+            previous_wfn = wfn.reference_wavefunction() or wfn
 
         # above, used to be getting energy as last of energy list from gradient()
         # thisenergy below should ultimately be testing on wfn.energy()
@@ -99,7 +99,9 @@ CompositeComputer.build_tasks()
 ---------------------------
 CompositeComputer.compute()
 ---------------------------
-* compute() for each job in task list
+* group the jobs by basis and keywords, i.e., by SCF reference; in-process, later jobs of a group start
+  from the orbitals of the first and the in-core DF AO integrals are kept between them
+* compute() for each job in task list, group by group
 
 -----------------------------------
 CompositeComputer.get_psi_results()
@@ -143,9 +145,11 @@ CompositeComputer.get_psi_results()
 """
 
 import math
+import os
 import re
 import sys
 import copy
+import json
 import pprint
 from typing import Any, Callable, Dict, List, Optional, Tuple, Union, TYPE_CHECKING
 pp = pprint.PrettyPrinter(width=120, compact=True, indent=1)
@@ -1602,8 +1606,57 @@ class CompositeComputer(BaseComputer):
         core.print_out(instructions)
 
         with p4util.hold_options_state():
-            for t in reversed(self.task_list):
-                t.compute(client=client)
+            if client:
+                for t in reversed(self.task_list):
+                    t.compute(client=client)
+                return
+
+            groups = self._reference_groups()
+            orbital_files = self._share_references(groups)
+            cache_AOs = bool(orbital_files) and not core.DFHelper.get_AO_cache()
+            if cache_AOs:
+                core.DFHelper.set_AO_cache(True)
+            try:
+                for group in groups:
+                    for t in group:
+                        t.compute()
+            finally:
+                if cache_AOs:
+                    core.DFHelper.set_AO_cache(False)
+                for fname in orbital_files:
+                    if os.path.isfile(fname + ".npy"):
+                        os.remove(fname + ".npy")
+
+    def _reference_groups(self) -> List[List[AtomicComputer]]:
+        """The tasks still to run, in run order, grouped by basis and keywords. The tasks of a group
+        differ only in the correlated method, so they share the SCF reference."""
+
+        groups = {}
+        for t in reversed(self.task_list):
+            if t.computed:
+                continue
+            key = (t.basis, json.dumps(t.keywords, sort_keys=True, default=str))
+            groups.setdefault(key, []).append(t)
+        return list(groups.values())
+
+    def _share_references(self, groups: List[List[AtomicComputer]]) -> List[str]:
+        """Let the later tasks of each group start from the converged orbitals of the first, as
+        findif does for its displacements. Returns the names of the orbital files to remove."""
+
+        if core.has_option_changed('SCF', 'GUESS'):
+            return []
+
+        scratch = core.IOManager.shared_object().get_default_path()
+        orbital_files = []
+        for group in groups:
+            if len(group) < 2:
+                continue
+            fname = os.path.join(scratch, f"psi.{os.getpid()}.cbs_reference.{id(group[0])}")
+            group[0].keywords.setdefault("function_kwargs", {})["write_orbitals"] = fname
+            for t in group[1:]:
+                t.keywords["scf__orbitals_guess_file"] = fname
+            orbital_files.append(fname)
+        return orbital_files
 
     def _prepare_results(self, client: Optional["qcportal.FractalClient"] = None):
         results_list = [x.get_results(client=client) for x in self.task_list]
@@ -138,6 +138,7 @@ FiniteDifferenceComputer.get_psi_results()
 """
 
 import copy
+import os
 import logging
 from functools import partial
 from typing import Any, Callable, Dict, Iterator, List, Optional, Tuple, Union, TYPE_CHECKING
@@ -150,7 +151,7 @@ from qcelemental import constants
 from psi4 import core
 from psi4.driver import p4util, pp, qcdb, nppp10
 from psi4.driver.p4util.exceptions import ValidationError
-from psi4.driver.task_base import AtomicComputer, BaseComputer, EnergyGradientHessianWfnReturn
+from psi4.driver.task_base import AtomicComputer, BaseComputer, EnergyGradientHessianWfnReturn, compute_tasks
 
 if TYPE_CHECKING:
     import qcportal
@@ -274,7 +275,7 @@ def _initialize_findif(mol: Union["qcdb.Molecule", core.Molecule],
     # Get settings for CdSalcList, then get the CdSalcList.
     method_allowed_irreps = 0x1 if mode == "1_0" else 0xFF
     # core.get_option returns an int, but CdSalcList expect a bool, so re-cast
-    salc_list = core.CdSalcList(mol, method_allowed_irreps, t_project, r_project)
+    salc_list = core.CdSalcList.build(mol, method_allowed_irreps, t_project, r_project)
 
     n_atom = mol.natom()
     n_irrep = salc_list.nirrep()
@@ -1302,8 +1303,31 @@ class FiniteDifferenceComputer(BaseComputer):
         core.print_out(instructions)
 
         with p4util.hold_options_state():
-            for t in self.task_list.values():
-                t.compute(client=client)
+            reference_orbitals = None
+            if client is None and not core.has_option_changed('SCF', 'GUESS'):
+                reference_orbitals = self._compute_reference_first()
+            try:
+                compute_tasks(self.task_list.values(), client=client)
+            finally:
+                if reference_orbitals and os.path.isfile(reference_orbitals + ".npy"):
+                    os.remove(reference_orbitals + ".npy")
+
+    def _compute_reference_first(self) -> Optional[str]:
+        """Run the undisplaced task, keeping its orbitals in a file that starts the SCF of every
+        displacement. Returns the file name, or None if the tasks are not of that kind."""
+
+        reference = self.task_list["reference"]
+        displaced = [t for k, t in self.task_list.items() if k != "reference"]
+        if not displaced or not all(isinstance(t, AtomicComputer) for t in [reference] + displaced):
+            return None
+
+        fname = os.path.join(core.IOManager.shared_object().get_default_path(),
+                             f"psi.{os.getpid()}.findif_reference")
+        reference.keywords.setdefault("function_kwargs", {})["write_orbitals"] = fname
+        reference.compute()
+        for t in displaced:
+            t.keywords["scf__orbitals_guess_file"] = fname
+        return fname
 
     def _prepare_results(self, client: Optional["qcportal.FractalClient"] = None):
         results_list = {k: v.get_results(client=client) for k, v in self.task_list.items()}
@@ -53,6 +53,7 @@ task_planner.py::task_planner()
     ------------------------------
     ManyBodyComputer.build_tasks()
     ------------------------------
+    * on the first call with screening_distances or screening_energies, call screen_nmers() to set kept_nmers
     * if supersystem requested as a modelchem level, request (frag, bas) indices for full nbody range of nocp treatment from build_nbody_compute_list()
     * otherwise, request (frag, bas) indices for specified nbody range covering specified bsse treatments from build_nbody_compute_list()
 
@@ -162,7 +163,7 @@ from qcelemental.models import DriverEnum, AtomicResult
 from psi4 import core
 from psi4.driver import constants, driver_nbody_multilevel, p4util
 from psi4.driver.p4util.exceptions import *
-from psi4.driver.task_base import BaseComputer, AtomicComputer, EnergyGradientHessianWfnReturn
+from psi4.driver.task_base import BaseComputer, AtomicComputer, EnergyGradientHessianWfnReturn, compute_tasks
 from psi4.driver.driver_cbs import CompositeComputer
 from psi4.driver.driver_findif import FiniteDifferenceComputer
 
@@ -233,6 +234,30 @@ def nbody():
         Dictionary of atom-centered point charges. keys: 1-based index of fragment, values: list of charges for each fragment.
         Add atom-centered point charges for fragments whose basis sets are not included in the computation.
 
+    :type screening_distances: dict
+    :param screening_distances: ``{2: 9.0, 3: 5.0}`` || etc.
+
+        Opt-in screening of n-mers by distance. keys: n-body level, values: cutoff in Angstrom.
+        An n-mer is dropped when any two of its fragments have no atoms within the cutoff.
+
+    :type screening_energies: dict
+    :param screening_energies: ``{2: 1.e-5, 3: 1.e-6}`` || etc.
+
+        Opt-in screening of n-mers by estimated interaction energy. keys: n-body level, values: threshold in Eh.
+        Dimers are estimated by their interaction energy at *screening_method*, larger n-mers by the
+        weakest of their dimer estimates. Requires *screening_method*.
+
+    :type screening_method: str
+    :param screening_method: ``'hf'`` || ``'b3lyp-d3'`` || etc.
+
+        Cheap method for the monomer and dimer energies behind *screening_energies*. These run
+        in-process while the tasks are planned.
+
+    :type screening_basis: str
+    :param screening_basis: ``'sto-3g'`` || etc.
+
+        Basis for *screening_method*. Defaults to the basis of the many-body computation.
+
     """
     pass
 
@@ -400,6 +425,7 @@ def build_nbody_compute_list(
     nfragments: int,
     return_total_data: bool,
     verbose: int = 1,
+    kept_nmers: Optional[Set[Tuple[int, ...]]] = None,
 ) -> Dict[str, Dict[int, Set[FragBasIndex]]]:
     """Generates lists of N-Body computations needed for requested BSSE treatments.
 
@@ -419,6 +445,9 @@ def build_nbody_compute_list(
         Whether the total data (True; energy/gradient/Hessian) of the molecular system has been requested, as opposed to interaction data (False).
     verbose
         Control volume of printing.
+    kept_nmers
+        When screening is active, the n-mers (tuples of 1-indexed fragments) that survived it. Every
+        subset of a kept n-mer is kept, too. Others are left out of all treatments. Monomers are always kept.
 
     Returns
     -------
@@ -460,6 +489,9 @@ def build_nbody_compute_list(
     if bsse_type_remainder:
         raise ValidationError("""Unrecognized BSSE type(s): {bsse_type_remainder}""")
 
+    def kept(x: Tuple[int, ...]) -> bool:
+        return kept_nmers is None or len(x) == 1 or x in kept_nmers
+
     # Build up compute sets
     if 'cp' in bsse_type:
         # Everything is in full n-mer basis
@@ -471,19 +503,23 @@ def build_nbody_compute_list(
                     for x in itertools.combinations(fragment_range, sublevel):
                         # below was `nbodies`, which would never hit. present is closest to pre-DDD. purpose unclear to me.
                         # if self.max_nbody == 1: break
-                        cp_compute_list[nb].add((x, basis_tuple))
+                        if kept(x):
+                            cp_compute_list[nb].add((x, basis_tuple))
 
     if 'nocp' in bsse_type or return_total_data:
         # Everything in monomer basis
         for nb in nbodies:
             for sublevel in range(1, nb + 1):
                 for x in itertools.combinations(fragment_range, sublevel):
-                    nocp_compute_list[nb].add((x, x))
+                    if kept(x):
+                        nocp_compute_list[nb].add((x, x))
 
     if 'vmfc' in bsse_type:
         # Like a CP for all combinations of pairs or greater
         for nb in nbodies:
             for cp_combos in itertools.combinations(fragment_range, nb):
+                if not kept(cp_combos):
+                    continue
                 basis_tuple = tuple(cp_combos)
                 for interior_nbody in range(1, nb + 1):
                     for x in itertools.combinations(cp_combos, interior_nbody):
@@ -522,6 +558,26 @@ def build_nbody_compute_list(
     return compute_dict
 
 
+def _screened_mbe_coefficients(kept_nmers: Set[Tuple[int, ...]], nb: int) -> Dict[Tuple[int, ...], int]:
+    """Coefficients of the n-mer data in a many-body expansion through *nb* bodies over only the *kept_nmers*.
+
+    Summing the increments of the kept n-mers S, each an inclusion-exclusion over the subsets T of S,
+    gives c_T = sum over kept S containing T with len(S) <= nb of (-1)**(len(S) - len(T)).
+    Without screening, this is the binomial formula used in assemble_nbody_components.
+
+    """
+    coefficients = {}
+    for nmer in kept_nmers:
+        if len(nmer) > nb:
+            continue
+        for k in range(1, len(nmer) + 1):
+            sign = (-1)**(len(nmer) - k)
+            for sub in itertools.combinations(nmer, k):
+                coefficients[sub] = coefficients.get(sub, 0) + sign
+
+    return {sub: c for sub, c in coefficients.items() if c != 0}
+
+
 def assemble_nbody_components(
     ptype: DriverEnum,
     component_results: Dict[str, Union[float, np.ndarray]],
@@ -549,6 +605,8 @@ def assemble_nbody_components(
         See class field. Maximum number of bodies to include in the many-body treatment."
     embedding_charges : bool
         Whether embedding charges are present. Used to NaN the output printing rather than print bad numbers.
+    kept_nmers : Optional[Set[Tuple[int, ...]]]
+        See class field. When not None, cp and nocp data are summed with the coefficients of the screened expansion.
     molecule : psi4.core.Molecule
         See class field. Used to count atoms in fragments.
     nbodies_per_mc_level: List[List[Union[int, Literal["supersystem"]]]]
@@ -580,8 +638,10 @@ def assemble_nbody_components(
         metadata['bsse_type'] = ['nocp']
 
     # regenerate per-bsse required calcs list
+    kept_nmers = metadata.get("kept_nmers", None)
     compute_dict = build_nbody_compute_list(
-        metadata['bsse_type'], nbodies, metadata['nfragments'], metadata["return_total_data"], verbose=0
+        metadata['bsse_type'], nbodies, metadata['nfragments'], metadata["return_total_data"], verbose=0,
+        kept_nmers=kept_nmers
     )
 
     # Build size and slices dictionaries
@@ -674,6 +734,26 @@ def assemble_nbody_components(
     def labeler(item) -> str:
         return str(mc_level_lbl) + "_" + str(item)
 
+    def screened_sum(nb: int, compute_list: Dict[int, Set[FragBasIndex]], full_basis: bool):
+        """Screened expansion through nb bodies from the computed (frag, bas) in compute_list."""
+        groups = {}
+        for frag, coef in _screened_mbe_coefficients(kept_nmers, nb).items():
+            item = (frag, tuple(range(1, metadata['nfragments'] + 1)) if full_basis else frag)
+            if item in compute_list[len(frag)]:
+                groups.setdefault(coef, set()).add(item)
+
+        ret = shaped_zero(ptype)
+        for coef, items in groups.items():
+            ret += coef * _sum_cluster_ptype_data(
+                ptype,
+                component_results,
+                items,
+                fragment_slice_dict,
+                fragment_size_dict,
+                mc_level_lbl=mc_level_lbl,
+            )
+        return ret
+
     # Extract data for monomers in monomer basis for CP total data
     if 1 in nbodies:
         monomers_in_monomer_basis = [v for v in compute_dict["nocp"][1] if len(v[1]) == 1]
@@ -698,17 +778,21 @@ def assemble_nbody_components(
     # Compute cp
     if 'cp' in metadata['bsse_type']:
         for nb in range(1, nbodies[-1] + 1):
-            if nb == metadata['nfragments']:
+            if kept_nmers is not None:
+                cp_body_dict[nb] = screened_sum(nb, cp_compute_list, True)
+
+            elif nb == metadata['nfragments']:
                 if ptype == "energy":
                     cp_body_dict[nb] = cp_by_level[nb] - bsse
                 else:
                     cp_body_dict[nb][:] = cp_by_level[nb] - bsse
                 continue
 
-            for k in range(1, nb + 1):
-                take_nk = math.comb(metadata['nfragments'] - k - 1, nb - k)
-                sign = ((-1)**(nb - k))
-                cp_body_dict[nb] += take_nk * sign * cp_by_level[k]
+            else:
+                for k in range(1, nb + 1):
+                    take_nk = math.comb(metadata['nfragments'] - k - 1, nb - k)
+                    sign = ((-1)**(nb - k))
+                    cp_body_dict[nb] += take_nk * sign * cp_by_level[k]
 
             if nb == 1:
                 bsse = cp_body_dict[nb] - monomer_sum
@@ -736,6 +820,10 @@ def assemble_nbody_components(
     # Compute nocp
     if 'nocp' in metadata['bsse_type']:
         for nb in range(1, nbodies[-1] + 1):
+            if kept_nmers is not None:
+                nocp_body_dict[nb] = screened_sum(nb, nocp_compute_list, False)
+                continue
+
             if nb == metadata['nfragments']:
                 if ptype == "energy":
                     nocp_body_dict[nb] = nocp_by_level[nb]
@@ -864,6 +952,13 @@ class ManyBodyComputer(BaseComputer):
     return_total_data: Optional[bool] = Field(None, description="When True, returns the total data (energy/gradient/Hessian) of the system, otherwise returns interaction data. Default is False for energies, True for gradients and Hessians. Note that the calculation of total counterpoise corrected energies implies the calculation of the energies of monomers in the monomer basis, hence specifying ``return_total_data = True`` may carry out more computations than ``return_total_data = False``.")
     quiet: bool = Field(False, description="Whether to print/log formatted n-body energy analysis. Presently used by multi to suppress output. Candidate for removal from class once in-class/out-of-class functions sorted.")
 
+    screening_distances: Dict[int, float] = Field({}, description="Opt-in screening by distance. Keys: n-body level (2 or more). Values: cutoff [Angstrom]. An n-mer is dropped when any two of its fragments have no atoms within the cutoff of each other.")
+    screening_energies: Dict[int, float] = Field({}, description="Opt-in screening by estimated interaction energy. Keys: n-body level (2 or more). Values: threshold [Eh]. A dimer is dropped when its interaction energy at screening_method is smaller in magnitude than the threshold; a larger n-mer when the weakest of its dimer interaction energies is.")
+    screening_method: Optional[str] = Field(None, description="Cheap method for the monomer and dimer energies behind screening_energies. These run in-process while the tasks are planned.")
+    screening_basis: Optional[str] = Field(None, description="Basis for screening_method. Default is the basis of the many-body computation.")
+    kept_nmers: Optional[Set[Tuple[int, ...]]] = Field(None, description="The n-mers (2 or more fragments) that survived screening, or None when screening is off. Set in build_tasks. Every subset of a kept n-mer is kept, too.")
+    screening_summary: Dict[int, Dict[str, Any]] = Field({}, description="Per n-body level, the number of n-mers considered, dropped by distance, and dropped by energy, and the summed screening_method interaction energies of the dimers dropped by energy. Set in build_tasks.")
+
     task_list: Dict[str, SubTaskComputers] = {}
 
     # Note that validation of user fields happens through typing and validator functions, so no class __init__ needed.
@@ -900,6 +995,20 @@ class ManyBodyComputer(BaseComputer):
 
         return v
 
+    @validator("screening_distances", "screening_energies")
+    def set_screening_levels(cls, v):
+        if any(nb < 2 for nb in v):
+            raise ValueError("Screening applies to n-body levels 2 and up.")
+
+        return v
+
+    @validator("screening_method", always=True)
+    def set_screening_method(cls, v, values):
+        if values.get("screening_energies") and v is None:
+            raise ValueError("Screening by energy (screening_energies) needs a screening_method.")
+
+        return v
+
     @validator("return_total_data", always=True)
     def set_return_total_data(cls, v, values):
         if v is not None:
@@ -914,6 +1023,112 @@ class ManyBodyComputer(BaseComputer):
 
         return rtd
 
+    def screen_nmers(self, basis: str, keywords: Dict[str, Any]) -> None:
+        """Sets self.kept_nmers to the n-mers, up to self.max_nbody, that pass the distance and energy screening.
+
+        Levels are screened in increasing order, and an n-mer is only considered when all of its
+        (n-1)-body subsets were kept, so the kept set is closed under subsets. For energy screening, the
+        monomers and the dimers that pass distance screening are computed at self.screening_method.
+
+        Parameters
+        ----------
+        basis
+            Basis for the screening_method computations when self.screening_basis is not set.
+        keywords
+            Keywords for the screening_method computations.
+
+        """
+        if any("supersystem" in nbodies for nbodies in self.nbodies_per_mc_level):
+            raise ValidationError("N-body screening cannot be combined with a supersystem level.")
+
+        fragment_range = range(1, self.nfragments + 1)
+        frag_xyz = {ifr: self.molecule.extract_subsets(ifr).geometry().np * constants.bohr2angstroms for ifr in fragment_range}
+
+        def distance(i: int, j: int) -> float:
+            """Shortest interatomic distance [A] between fragments i and j."""
+            diff = frag_xyz[i][:, None, :] - frag_xyz[j][None, :, :]
+            return np.sqrt(np.min(np.einsum("abx,abx->ab", diff, diff)))
+
+        pair_distance = {}
+        pair_energy = {}
+        kept = {(ifr,) for ifr in fragment_range}
+        summary = {}
+        for nb in range(2, self.max_nbody + 1):
+            candidates = [
+                x for x in itertools.combinations(fragment_range, nb)
+                if all(sub in kept for sub in itertools.combinations(x, nb - 1))
+            ]
+            ndistance, nenergy, error = 0, 0, 0.0
+
+            if nb in self.screening_distances:
+                cutoff = self.screening_distances[nb]
+                survivors = []
+                for x in candidates:
+                    for pair in itertools.combinations(x, 2):
+                        if pair not in pair_distance:
+                            pair_distance[pair] = distance(*pair)
+                    if all(pair_distance[pair] <= cutoff for pair in itertools.combinations(x, 2)):
+                        survivors.append(x)
+                ndistance = len(candidates) - len(survivors)
+                candidates = survivors
+
+            # Dimer interaction energies at the screening level, once, for every dimer that can still be kept
+            if nb == 2 and self.screening_energies:
+                pair_energy = self._screening_pair_energies(candidates, self.screening_basis or basis, keywords)
+
+            if nb in self.screening_energies:
+                threshold = self.screening_energies[nb]
+                survivors = []
+                for x in candidates:
+                    estimate = min(abs(pair_energy[pair]) for pair in itertools.combinations(x, 2))
+                    if estimate >= threshold:
+                        survivors.append(x)
+                    elif nb == 2:
+                        error += pair_energy[x]
+                nenergy = len(candidates) - len(survivors)
+                candidates = survivors
+
+            kept.update(candidates)
+            summary[nb] = {
+                "considered": len(candidates) + ndistance + nenergy,
+                "distance": ndistance,
+                "energy": nenergy,
+                "error": error,
+            }
+
+        self.kept_nmers = {x for x in kept if len(x) > 1}
+        self.screening_summary = summary
+
+        info = "\n   ==> N-Body Screening <==\n\n"
+        info += f"    {'n-body':>6}  {'considered':>10}  {'by distance':>11}  {'by energy':>9}  {'kept':>8}  {'dropped IE [Eh]':>16}\n"
+        for nb, row in summary.items():
+            nkept = row["considered"] - row["distance"] - row["energy"]
+            info += f"    {nb:6d}  {row['considered']:10d}  {row['distance']:11d}  {row['energy']:9d}  {nkept:8d}  {row['error']:16.10f}\n"
+        info += "\n    Dropped IE sums the screening-level interaction energies of the dimers dropped by energy.\n"
+        core.print_out(info)
+        logger.info(info)
+
+    def _screening_pair_energies(self, pairs: List[Tuple[int, int]], basis: str,
+                                 keywords: Dict[str, Any]) -> Dict[Tuple[int, int], float]:
+        """Interaction energies at self.screening_method of the dimers in *pairs*, in the dimer basis."""
+
+        nmers = sorted({(ifr,) for pair in pairs for ifr in pair}) + list(pairs)
+        tasks = {}
+        for x in nmers:
+            tasks[x] = AtomicComputer(
+                molecule=self.molecule.extract_subsets(list(x)),
+                driver="energy",
+                method=self.screening_method,
+                basis=basis,
+                keywords=copy.deepcopy(keywords),
+            )
+
+        with p4util.hold_options_state():
+            compute_tasks(tasks.values())
+        energy = {x: t.get_results().properties.return_energy for x, t in tasks.items()}
+
+        return {pair: energy[pair] - energy[pair[:1]] - energy[pair[1:]] for pair in pairs}
+
     def build_tasks(
         self,
         mb_computer: SubTaskComputers,
@@ -955,6 +1170,11 @@ class ManyBodyComputer(BaseComputer):
             if kwg in kwargs:
                 kwargs['keywords']['function_kwargs'][kwg] = kwargs.pop(kwg)
 
+        if self.kept_nmers is None and (self.screening_distances or self.screening_energies):
+            if self.screening_basis is None and kwargs.get("method") == "cbs":
+                raise ValidationError("N-body screening by energy of a composite method needs a screening_basis.")
+            self.screen_nmers(kwargs["basis"], kwargs["keywords"])
+
         count = 0
         template = copy.deepcopy(kwargs)
 
@@ -971,7 +1191,9 @@ class ManyBodyComputer(BaseComputer):
                 ["nocp"], list(range(1, self.max_nbody + 1)), self.nfragments, self.return_total_data
             )
         else:
-            compute_dict = build_nbody_compute_list(self.bsse_type, nbodies, self.nfragments, self.return_total_data)
+            compute_dict = build_nbody_compute_list(
+                self.bsse_type, nbodies, self.nfragments, self.return_total_data, kept_nmers=self.kept_nmers
+            )
 
         def labeler(item) -> str:
             mc_level_lbl = mc_level_idx + 1
@@ -1013,9 +1235,18 @@ class ManyBodyComputer(BaseComputer):
         #core.print_out(info)
         logger.info(info)
 
-        with p4util.hold_options_state():
-            for t in self.task_list.values():
-                t.compute(client=client)
+        # Counterpoise subsets share the full-cluster basis and geometry, so in-process runs
+        #   build the in-core DF AO integrals once and reuse them for every later subset
+        cache_AOs = (client is None) and (BsseEnum.cp in self.bsse_type or BsseEnum.vmfc in self.bsse_type)
+        if cache_AOs:
+            core.DFHelper.set_AO_cache(True)
+
+        try:
+            with p4util.hold_options_state():
+                compute_tasks(self.task_list.values(), client=client)
+        finally:
+            if cache_AOs:
+                core.DFHelper.set_AO_cache(False)
 
     def prepare_results(
         self,
@@ -1297,6 +1528,7 @@ class ManyBodyComputer(BaseComputer):
             "molecule": self.molecule,
             "embedding_charges": bool(self.embedding_charges),
             "max_nbody": self.max_nbody,
+            "kept_nmers": self.kept_nmers,
         }
         if self.driver.name == "energy":
             nbody_results = assemble_nbody_components("energy", trove["energy"], metadata.copy())
@@ -1373,6 +1605,9 @@ class ManyBodyComputer(BaseComputer):
             'NUCLEAR REPULSION ENERGY': self.molecule.nuclear_repulsion_energy(),
             'NBODY NUMBER': len(self.task_list),
         }
+        if self.screening_summary:
+            qcvars['NBODY SCREENING DROPPED INTERACTION ENERGY'] = sum(
+                row["error"] for row in self.screening_summary.values())
 
         properties = {
             "calcinfo_natom": self.molecule.natom(),
@@ -33,6 +33,7 @@ __all__ = [
 
 import sys
 import time
+from collections import deque
 from typing import Dict, Optional, Union
 
 import numpy as np
@@ -52,7 +53,7 @@ except ImportError:
 class IPIBroker(Client):
     """Interface implementation between i-PI (https://ipi-code.org/) and |PSIfour|."""
 
-    def __init__(self, LOT, options=None, serverdata=False, molecule=None):
+    def __init__(self, LOT, options=None, serverdata=False, molecule=None, guess_history=0):
         self.serverdata = serverdata
         if not ipi_available:
             psi4.core.print_out("i-pi is not available for import: ")
@@ -85,6 +86,13 @@ class IPIBroker(Client):
 
         self.timing = {}
 
+        # converged wavefunctions of the last guess_history steps, extrapolated for each SCF guess
+        self.guess_history = guess_history
+        self.guess_wfns = deque(maxlen=guess_history)
+
+        # plans of the first gradient at each level of theory, reused by later steps when run in-process
+        self.plans = {}
+
         atoms = np.array(self.initial_molecule.geometry())
         psi4.core.print_out("Initial atoms %s\n" % atoms)
         psi4.core.print_out("Force:\n")
@@ -129,7 +137,19 @@ class IPIBroker(Client):
         When bypass_scf=True a hf energy calculation has been done before.
         """
         start = time.time()
-        self.grd = psi4.gradient(LOT, bypass_scf=bypass_scf, **kwargs)
+        if LOT not in self.plans:
+            plan = psi4.gradient(LOT, bypass_scf=bypass_scf, return_plan=True, **kwargs)
+            self.plans[LOT] = plan if isinstance(plan, psi4.driver.task_base.AtomicComputer) else None
+        if self.guess_history:
+            self.grd, wfn = psi4.gradient(LOT,
+                                          bypass_scf=bypass_scf,
+                                          guess_wfn=list(self.guess_wfns) or None,
+                                          return_wfn=True,
+                                          reuse_plan=self.plans[LOT],
+                                          **kwargs)
+            self.guess_wfns.append(wfn)
+        else:
+            self.grd = psi4.gradient(LOT, bypass_scf=bypass_scf, reuse_plan=self.plans[LOT], **kwargs)
         time_needed = time.time() - start
         self.timing[LOT] = self.timing.get(LOT, []) + [time_needed]
 
@@ -138,7 +158,8 @@ def ipi_broker(
     LOT: str,
     molecule: Optional[psi4.core.Molecule] = None,
     serverdata: Union[str, bool] = False,
-    options: Optional[Dict] = None
+    options: Optional[Dict] = None,
+    guess_history: int = 0
 ) -> IPIBroker:
     """Runs :class:`~psi4.driver.ipi_broker.IPIBroker` to connect to i-PI (https://ipi-code.org/).
 
@@ -152,9 +173,13 @@ def ipi_broker(
         Configuration where to connect to ipi
     options
         any additional Psi4 options
+    guess_history
+        Number of previous steps whose converged densities are extrapolated
+        (always-stable predictor-corrector) into the SCF guess of the next
+        step. With 0, every step starts from the usual guess.
 
     """
-    b = IPIBroker(LOT, molecule=molecule, serverdata=serverdata, options=options)
+    b = IPIBroker(LOT, molecule=molecule, serverdata=serverdata, options=options, guess_history=guess_history)
 
     try:
         if b.serverdata:
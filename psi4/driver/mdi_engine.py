@@ -36,6 +36,8 @@ __all__ = [
     "MDIEngine",
 ]
 
+from collections import deque
+
 import numpy as np
 import qcelemental as qcel
 
@@ -67,6 +69,10 @@ class MDIEngine():
             Method (SCF or post-SCF) used when calculating energies or gradients.
         molecule
             The target molecule, if not the last molecule defined.
+        guess_history
+            Number of previous force evaluations whose converged densities are
+            extrapolated (always-stable predictor-corrector) into the SCF guess.
+            With 0 (default), every SCF starts from the usual guess.
         kwargs
             Any additional arguments to pass to :func:`psi4.driver.energy` or
             :func:`psi4.driver.gradient` computation.
@@ -84,6 +90,13 @@ class MDIEngine():
         self.molecule = input_molecule.clone()
         psi4.core.set_active_molecule(self.molecule)
 
+        # Converged wavefunctions of the last guess_history force evaluations, one per MD step
+        self.guess_history = kwargs.pop('guess_history', 0)
+        self.guess_wfns = deque(maxlen=self.guess_history)
+
+        # Plans of the first energy and gradient, reused by later steps when they run in-process
+        self.plans = {}
+
         # Most recent SCF energy
         self.energy = 0.0
 
@@ -231,7 +244,17 @@ class MDIEngine():
 
         :returns: *forces* Atomic forces
         """
-        force_matrix = psi4.driver.gradient(self.scf_method, **self.kwargs)
+        if self.guess_history:
+            force_matrix, wfn = psi4.driver.gradient(self.scf_method,
+                                                     guess_wfn=list(self.guess_wfns) or None,
+                                                     return_wfn=True,
+                                                     reuse_plan=self.plan(psi4.driver.gradient),
+                                                     **self.kwargs)
+            self.guess_wfns.append(wfn)
+        else:
+            force_matrix = psi4.driver.gradient(self.scf_method,
+                                                reuse_plan=self.plan(psi4.driver.gradient),
+                                                **self.kwargs)
         forces = force_matrix.np.ravel()
         MDI_Send(forces, len(forces), MDI_DOUBLE, self.comm)
         return forces
@@ -350,7 +373,23 @@ class MDIEngine():
     def run_scf(self):
         """ Run an energy calculation
         """
-        self.energy = psi4.energy(self.scf_method, **self.kwargs)
+        if self.guess_wfns:
+            self.energy = psi4.energy(self.scf_method,
+                                      guess_wfn=list(self.guess_wfns),
+                                      reuse_plan=self.plan(psi4.driver.energy),
+                                      **self.kwargs)
+        else:
+            self.energy = psi4.energy(self.scf_method, reuse_plan=self.plan(psi4.driver.energy), **self.kwargs)
+
+    def plan(self, driver):
+        """ Plan of the first call to *driver*, reused by later steps so that they skip the planning
+
+        :returns: *plan* The AtomicComputer, or None if the method is not run in-process by a single procedure
+        """
+        if driver.__name__ not in self.plans:
+            plan = driver(self.scf_method, return_plan=True, **self.kwargs)
+            self.plans[driver.__name__] = plan if isinstance(plan, psi4.driver.task_base.AtomicComputer) else None
+        return self.plans[driver.__name__]
 
     # Respond to the <DIMENSIONS command
     def send_dimensions(self):
@@ -46,12 +46,22 @@ from psi4 import core
 from .exceptions import ValidationError, TestComparisonError
 
 
-def fcidump(wfn: core.Wavefunction, fname: str = 'INTDUMP', oe_ints: Optional[List] = None):
+# One line of a binary FCIDUMP: the integral and its four indices
+_binary_record = np.dtype([('value', '<f8'), ('index', '<i4', (4, ))])
+
+
+def fcidump(wfn: core.Wavefunction, fname: str = 'INTDUMP', oe_ints: Optional[List] = None, binary: bool = False):
     """Save integrals to file in FCIDUMP format as defined in Comp. Phys. Commun. 54 75 (1989),
     https://doi.org/10.1016/0010-4655(89)90033-7 .
     Additional one-electron integrals, including orbital energies, can also be saved.
     This latter format can be used with the HANDE QMC code but is not standard.
 
+    With ``binary=True`` the namelist header is written as usual, but each
+    following line is replaced by a 24-byte little-endian record of the
+    integral (float64) and its four indices (int32), in the same order.
+    These files are several times smaller and much faster to write and read;
+    read them back with ``fcidump_from_file(fname, binary=True)``.
+
     Parameters
     ----------
     wfn
@@ -61,6 +71,8 @@ def fcidump(wfn: core.Wavefunction, fname: str = 'INTDUMP', oe_ints: Optional[Li
     oe_ints
         List of additional one-electron integrals to save to file. So far only
         EIGENVALUES is a valid option.
+    binary
+        Write the integrals as binary records instead of text lines.
 
     Raises
     ------
@@ -139,7 +151,7 @@ def fcidump(wfn: core.Wavefunction, fname: str = 'INTDUMP', oe_ints: Optional[Li
     if not wfn.same_a_b_orbs():
         DPD_info['beta_MO'] = ints.DPD_ID("[a>=a]+")
     # Write TEI to fname in FCIDUMP format
-    core.fcidump_tei_helper(nirrep, wfn.same_a_b_orbs(), DPD_info, ints_tolerance, fname)
+    core.fcidump_tei_helper(nirrep, wfn.same_a_b_orbs(), DPD_info, ints_tolerance, fname, binary)
 
     # Read-in OEI and write them to fname in FCIDUMP format
     # Indexing functions to translate from zero-based (C and Python) to
@@ -148,7 +160,7 @@ def fcidump(wfn: core.Wavefunction, fname: str = 'INTDUMP', oe_ints: Optional[Li
     alpha_mo_idx = lambda x: 2 * x + 1
     beta_mo_idx = lambda x: 2 * (x + 1)
 
-    with open(fname, 'a') as intdump:
+    with open(fname, 'ab' if binary else 'a') as intdump:
         core.print_out('Writing frozen core operator in FCIDUMP format to ' + fname + '\n')
         if reference == 'RHF':
             PSIF_MO_FZC = 'MO-basis Frozen-Core Operator'
@@ -156,57 +168,33 @@ def fcidump(wfn: core.Wavefunction, fname: str = 'INTDUMP', oe_ints: Optional[Li
             moH.load(core.IO.shared_object(), psif.PSIF_OEI)
             mo_slice = core.Slice(frzcpi, frzcpi+active_mopi)
             MO_FZC = moH.get_block(mo_slice, mo_slice)
-            offset = 0
-            for h, block in enumerate(MO_FZC.nph):
-                il = np.tril_indices(block.shape[0])
-                for index, x in np.ndenumerate(block[il]):
-                    row = mo_idx(il[0][index] + offset)
-                    col = mo_idx(il[1][index] + offset)
-                    if (abs(x) > ints_tolerance):
-                        intdump.write('{:28.20E}{:4d}{:4d}{:4d}{:4d}\n'.format(x, row, col, 0, 0))
-                offset += block.shape[0]
+            _write_records(intdump, _oei_records(MO_FZC, mo_idx, ints_tolerance), binary)
             # Additional one-electron integrals as requested in oe_ints
             # Orbital energies
             core.print_out('Writing orbital energies in FCIDUMP format to ' + fname + '\n')
             if 'EIGENVALUES' in oe_ints:
                 eigs_dump = write_eigenvalues(wfn.epsilon_a().get_block(mo_slice).to_array(), mo_idx)
-                intdump.write(eigs_dump)
+                _write_records(intdump, eigs_dump, binary)
         else:
             PSIF_MO_A_FZC = 'MO-basis Alpha Frozen-Core Oper'
             moH_A = core.Matrix(PSIF_MO_A_FZC, wfn.nmopi(), wfn.nmopi())
             moH_A.load(core.IO.shared_object(), psif.PSIF_OEI)
             mo_slice = core.Slice(frzcpi, active_mopi)
             MO_FZC_A = moH_A.get_block(mo_slice, mo_slice)
-            offset = 0
-            for h, block in enumerate(MO_FZC_A.nph):
-                il = np.tril_indices(block.shape[0])
-                for index, x in np.ndenumerate(block[il]):
-                    row = alpha_mo_idx(il[0][index] + offset)
-                    col = alpha_mo_idx(il[1][index] + offset)
-                    if (abs(x) > ints_tolerance):
-                        intdump.write('{:28.20E}{:4d}{:4d}{:4d}{:4d}\n'.format(x, row, col, 0, 0))
-                offset += block.shape[0]
+            _write_records(intdump, _oei_records(MO_FZC_A, alpha_mo_idx, ints_tolerance), binary)
             PSIF_MO_B_FZC = 'MO-basis Beta Frozen-Core Oper'
             moH_B = core.Matrix(PSIF_MO_B_FZC, wfn.nmopi(), wfn.nmopi())
             moH_B.load(core.IO.shared_object(), psif.PSIF_OEI)
             mo_slice = core.Slice(frzcpi, active_mopi)
             MO_FZC_B = moH_B.get_block(mo_slice, mo_slice)
-            offset = 0
-            for h, block in enumerate(MO_FZC_B.nph):
-                il = np.tril_indices(block.shape[0])
-                for index, x in np.ndenumerate(block[il]):
-                    row = beta_mo_idx(il[0][index] + offset)
-                    col = beta_mo_idx(il[1][index] + offset)
-                    if (abs(x) > ints_tolerance):
-                        intdump.write('{:28.20E}{:4d}{:4d}{:4d}{:4d}\n'.format(x, row, col, 0, 0))
-                offset += block.shape[0]
+            _write_records(intdump, _oei_records(MO_FZC_B, beta_mo_idx, ints_tolerance), binary)
             # Additional one-electron integrals as requested in oe_ints
             # Orbital energies
             core.print_out('Writing orbital energies in FCIDUMP format to ' + fname + '\n')
             if 'EIGENVALUES' in oe_ints:
                 alpha_eigs_dump = write_eigenvalues(wfn.epsilon_a().get_block(mo_slice).to_array(), alpha_mo_idx)
                 beta_eigs_dump = write_eigenvalues(wfn.epsilon_b().get_block(mo_slice).to_array(), beta_mo_idx)
-                intdump.write(alpha_eigs_dump + beta_eigs_dump)
+                _write_records(intdump, alpha_eigs_dump + beta_eigs_dump, binary)
         # Dipole integrals
         #core.print_out('Writing dipole moment OEI in FCIDUMP format to ' + fname + '\n')
         # Traceless quadrupole integrals
@@ -215,22 +203,48 @@ def fcidump(wfn: core.Wavefunction, fname: str = 'INTDUMP', oe_ints: Optional[Li
         core.print_out('Writing frozen core + nuclear repulsion energy in FCIDUMP format to ' + fname + '\n')
         e_fzc = ints.get_frozen_core_energy()
         e_nuc = molecule.nuclear_repulsion_energy(wfn.get_dipole_field_strength())
-        intdump.write('{:28.20E}{:4d}{:4d}{:4d}{:4d}\n'.format(e_fzc + e_nuc, 0, 0, 0, 0))
+        _write_records(intdump, [(e_fzc + e_nuc, 0, 0, 0, 0)], binary)
     core.print_out('Done generating {} with integrals in FCIDUMP format.\n'.format(fname))
 
 
 def write_eigenvalues(eigs, mo_idx):
-    """Prepare multi-line string with one-particle eigenvalues to be written to the FCIDUMP file.
+    """Prepare the (value, i, j, k, l) lines with one-particle eigenvalues to be written to the FCIDUMP file.
     """
-    eigs_dump = ''
+    eigs_dump = []
     iorb = 0
     for h, block in enumerate(eigs):
         for idx, x in np.ndenumerate(block):
-            eigs_dump += '{:28.20E}{:4d}{:4d}{:4d}{:4d}\n'.format(x, mo_idx(iorb), 0, 0, 0)
+            eigs_dump.append((x, mo_idx(iorb), 0, 0, 0))
             iorb += 1
     return eigs_dump
 
 
+def _oei_records(mat, mo_idx, ints_tolerance):
+    """Lower triangle of each irrep block of a one-electron operator as (value, i, j, 0, 0) lines.
+    """
+    records = []
+    offset = 0
+    for h, block in enumerate(mat.nph):
+        il = np.tril_indices(block.shape[0])
+        for index, x in np.ndenumerate(block[il]):
+            if (abs(x) > ints_tolerance):
+                records.append((x, mo_idx(il[0][index] + offset), mo_idx(il[1][index] + offset), 0, 0))
+        offset += block.shape[0]
+    return records
+
+
+def _write_records(intdump, records, binary):
+    """Append (value, i, j, k, l) lines to an open FCIDUMP file, as text or as binary records.
+    """
+    if binary:
+        data = np.zeros(len(records), dtype=_binary_record)
+        for n, (x, i, j, k, l) in enumerate(records):
+            data[n] = (x, (i, j, k, l))
+        intdump.write(data.tobytes())
+    else:
+        intdump.write(''.join('{:28.20E}{:4d}{:4d}{:4d}{:4d}\n'.format(*r) for r in records))
+
+
 def _irrep_map(wfn):
     """Returns an array of irrep indices that maps from Psi4's ordering convention to the standard FCIDUMP convention.
     """
@@ -249,8 +263,8 @@ def _irrep_map(wfn):
     return np.array(irrep_map, dtype='int')
 
 
-def fcidump_from_file(fname: str) -> Dict[str, Any]:
-    """Function to read in a FCIDUMP file.
+def fcidump_from_file(fname: str, binary: bool = False) -> Dict[str, Any]:
+    """Function to read in a FCIDUMP file, as written by :py:func:`fcidump` as text or with ``binary=True``.
 
     :returns: a dictionary with FCIDUMP header and integrals
 
@@ -266,18 +280,19 @@ def fcidump_from_file(fname: str) -> Dict[str, Any]:
       - 'eri' : electron-repulsion integrals
 
     :param fname: FCIDUMP file name
+    :param binary: whether the integrals are binary records
 
     """
     intdump = {}
-    with open(fname, 'r') as handle:
-        firstline = handle.readline().strip()
+    with open(fname, 'rb') as handle:
+        firstline = handle.readline().decode().strip()
         assert '&FCI' == firstline, firstline
 
         skiplines = 1
         read = True
         while True:
             skiplines += 1
-            line = handle.readline()
+            line = handle.readline().decode()
             if 'END' in line:
                 break
 
@@ -292,8 +307,13 @@ def fcidump_from_file(fname: str) -> Dict[str, Any]:
 
             intdump[key.lower()] = value
 
-    # Read the data and index, skip header
-    raw_ints = np.genfromtxt(fname, skip_header=skiplines)
+        # Read the data and index, skip header
+        if binary:
+            records = np.fromfile(handle, dtype=_binary_record)
+            raw_ints = np.column_stack((records['value'], records['index']))
+
+    if not binary:
+        raw_ints = np.genfromtxt(fname, skip_header=skiplines)
 
     # Read last line, i.e. Enuc + Efzc
     intdump['enuc'] = raw_ints[-1, 0]
@@ -88,6 +88,7 @@ def array_to_matrix(
     name: str = "New Matrix",
     dim1: Optional[Union[List, Tuple, core.Dimension]] = None,
     dim2: Optional[core.Dimension] = None,
+    copy: bool = True,
 ) -> Union[core.Matrix, core.Vector]:
     """
     Converts a `NumPy array
@@ -111,6 +112,12 @@ def array_to_matrix(
         dimension.
     dim2
         Same as `dim1` only if using a :class:`~psi4.core.Dimension` object.
+    copy
+        Copy the data if `True`. Otherwise the new :class:`~psi4.core.Matrix`
+        adopts the arrays as its storage and keeps them alive, so changes
+        through either side are seen by the other. Adopting requires
+        C-contiguous, writeable float64 arrays and is not available for
+        :class:`~psi4.core.Vector` or together with `dim1`.
 
     Returns
     -------
@@ -131,11 +138,35 @@ def array_to_matrix(
     >>> matrix = psi4.core.Matrix.from_array(irrep_data)
     >>> print(matrix.rowdim().to_tuple())
     (2, 0, 4)
+
+    >>> data = np.zeros((1000, 1000))
+    >>> matrix = psi4.core.Matrix.from_array(data, copy=False)
+    >>> np.shares_memory(matrix.np, data)
+    True
     """
 
     # What type is it? MRO can help.
     arr_type = self.__mro__[0]
 
+    # Zero-copy case, the Matrix takes the arrays as they are or not at all
+    if not copy:
+        if arr_type != core.Matrix:
+            raise ValidationError("Array_to_Matrix: Only a Matrix can adopt NumPy arrays, pass copy=True.")
+        if (dim1 is not None) or (dim2 is not None):
+            raise ValidationError("Array_to_Matrix: Dimensions cannot be applied without a copy, pass copy=True.")
+
+        arrays = list(arr) if isinstance(arr, (list, tuple)) else [arr]
+        for a in arrays:
+            if not isinstance(a, np.ndarray) or (a.ndim != 2):
+                raise ValidationError("Array_to_Matrix: Only two-dimensional NumPy arrays can be adopted.")
+            if (a.dtype != np.float64) or not a.flags.c_contiguous or not a.flags.writeable:
+                raise ValidationError(
+                    "Array_to_Matrix: Only C-contiguous, writeable float64 arrays can be adopted, pass copy=True.")
+
+        ret = self(name)
+        ret.adopt(arrays)
+        return ret
+
     # Irrepped case
     if isinstance(arr, (list, tuple)):
         if (dim1 is not None) or (dim2 is not None):
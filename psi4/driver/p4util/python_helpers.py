@@ -49,12 +49,13 @@ __all__ = [
 ]
 
 
+import copy
 import os
 import re
 import sys
 import uuid
 import warnings
-from collections import Counter
+from collections import Counter, OrderedDict
 from itertools import product
 from pathlib import Path
 from tempfile import NamedTemporaryFile
@@ -71,6 +72,27 @@ from .exceptions import TestComparisonError, ValidationError, UpgradeHelper
 
 ## Python basis helps
 
+# Parsed basis dictionaries from qcdb.BasisSet.pyconstruct, which do not depend on the geometry.  Optimizations
+# and findif displacements rebuild the same basis for every step; with this only the C++ BasisSet (centers and
+# shell arrays) is rebuilt.  The entries are keyed on the atom list, so a loop over many different molecules
+# would otherwise keep one per molecule: only the most recently used ones are kept.
+_basis_dict_cache = OrderedDict()
+_basis_dict_cache_size = 32
+
+
+def _basis_dict_cache_key(mol: core.Molecule, key, target, fitrole, other):
+    """Key for :py:data:`_basis_dict_cache`, or None if the request is not cacheable.
+
+    Callable basis specifications (``basis {...}`` blocks) may assign by position or change between
+    calls, so only named basis sets are cached.
+    """
+    if not isinstance(target, str) or not (other is None or isinstance(other, str)):
+        return None
+    atoms = tuple((mol.label(A), mol.symbol(A), mol.Z(A) != 0) for A in range(mol.natom()))
+    return (atoms, key, target.lower(), fitrole, other.lower() if other else other,
+            os.environ.get('PSIPATH', ''), core.get_datadir())
+
+
 @staticmethod
 def _pybuild_basis(
         mol: core.Molecule,
@@ -154,13 +176,22 @@ def _pybuild_basis(
     # if a string, they search for a gbs file with that name.
     # if a function, it needs to apply a basis to each atom.
 
-    bs, basisdict = qcdb.BasisSet.pyconstruct(mol.to_dict(),
-                                              key,
-                                              resolved_target,
-                                              fitrole,
-                                              other,
-                                              return_dict=True,
-                                              return_atomlist=return_atomlist)
+    cache_key = None if return_atomlist else _basis_dict_cache_key(mol, key, resolved_target, fitrole, other)
+    if cache_key in _basis_dict_cache:
+        _basis_dict_cache.move_to_end(cache_key)
+        basisdict = copy.deepcopy(_basis_dict_cache[cache_key])
+    else:
+        bs, basisdict = qcdb.BasisSet.pyconstruct(mol.to_dict(),
+                                                  key,
+                                                  resolved_target,
+                                                  fitrole,
+                                                  other,
+                                                  return_dict=True,
+                                                  return_atomlist=return_atomlist)
+        if cache_key is not None:
+            _basis_dict_cache[cache_key] = copy.deepcopy(basisdict)
+            while len(_basis_dict_cache) > _basis_dict_cache_size:
+                _basis_dict_cache.popitem(last=False)
 
     if return_atomlist:
         atom_basis_list = []
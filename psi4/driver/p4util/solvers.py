@@ -438,6 +438,51 @@ def _gs_orth(engine, U, V, thresh: float = 1.0e-8):
     return U
 
 
+def _subspace_matrix(engine, vecs: List, products: List, old: np.ndarray = None, symmetric: bool = False) -> np.ndarray:
+    r"""Project a product onto the subspace, :math:`M_{ij} = X_{i} \cdot (A X_{j})`, reusing the block of a
+    previous projection.
+
+    Between collapses the solvers only ever append vectors to the subspace, so the leading block of the
+    subspace matrix is the one of the previous iteration and only the rows and columns of the new vectors
+    need products; this takes the vector dot products per iteration from :math:`O(l^2)` to :math:`O(l k)`.
+
+    Parameters
+    ----------
+    engine : object
+       The engine passed to the solver, required to define vector algebraic operations needed
+    vecs
+       list of `vector` {l}.
+       The current basis vectors
+    products
+       list of `vector` {l}.
+       The product of the operator with each basis vector
+    old
+       The subspace matrix of the previous iteration, whose basis vectors are the leading ones of `vecs`;
+       None after a collapse
+    symmetric
+       Fill the upper triangle from the lower one, :math:`M_{ij} = M_{ji} = X_{i} \cdot (A X_{j})` for :math:`j \le i`
+
+    Returns
+    -------
+    M
+       Numpy array {l, l}.
+    """
+    l = len(vecs)
+    nold = 0 if old is None else old.shape[0]
+    M = np.zeros((l, l))
+    if nold:
+        M[:nold, :nold] = old
+    if symmetric:
+        for i in range(nold, l):
+            for j in range(i + 1):
+                M[i, j] = M[j, i] = engine.vector_dot(vecs[i], products[j])
+    else:
+        for i in range(l):
+            for j in range(nold if i < nold else 0, l):
+                M[i, j] = engine.vector_dot(vecs[i], products[j])
+    return M
+
+
 def _best_vectors(engine, ss_vectors: np.ndarray, basis_vectors: List) -> List:
     r"""Compute the best approximation of the true eigenvectors as a linear combination of basis vectors:
 
@@ -754,6 +799,7 @@ def davidson_solver(
     _diag_print_heading(title_lines, print_name, max_ss_size, nroot, r_convergence, maxiter, verbose)
 
     vecs = guess
+    G = None
     stats = []
     best_eigvecs = []
     best_eigvals = []
@@ -780,11 +826,7 @@ def davidson_solver(
         iter_info['product_count'] += nprod
 
         # Build Subspace matrix
-        G = np.zeros((l, l))
-        for i in range(l):
-            for j in range(i):
-                G[i, j] = G[j, i] = engine.vector_dot(vecs[i], Ax[j])
-            G[i, i] = engine.vector_dot(vecs[i], Ax[i])
+        G = _subspace_matrix(engine, vecs, Ax, G, symmetric=True)
 
         _print_array("SS transformed A", G, verbose)
 
@@ -846,6 +888,7 @@ def davidson_solver(
 
             # restart needed
             vecs = best_eigvecs
+            G = None
         else:
 
             # Regular subspace update, orthonormalize preconditioned residuals and add to the trial set
@@ -967,6 +1010,8 @@ def hamiltonian_solver(
     _diag_print_heading(title_lines, print_name, max_ss_size, nroot, r_convergence, maxiter, verbose)
 
     vecs = guess
+    H1_ss = None
+    H2_ss = None
     best_L = []
     best_R = []
     best_vals = []
@@ -994,12 +1039,8 @@ def hamiltonian_solver(
         iter_info['product_count'] += nprod
 
         # form x*H1x (H1_ss) and x*H2x (H2_ss)
-        H1_ss = np.zeros((l, l))
-        H2_ss = np.zeros((l, l))
-        for i in range(l):
-            for j in range(l):
-                H1_ss[i, j] = engine.vector_dot(vecs[i], H1x[j])
-                H2_ss[i, j] = engine.vector_dot(vecs[i], H2x[j])
+        H1_ss = _subspace_matrix(engine, vecs, H1x, H1_ss)
+        H2_ss = _subspace_matrix(engine, vecs, H2x, H2_ss)
 
         _print_array("Subspace Transformed (A+B)", H1_ss, verbose)
         _print_array("Subspace Transformed (A-B)", H2_ss, verbose)
@@ -1110,6 +1151,8 @@ def hamiltonian_solver(
 
             # need to orthonormalize union of the Left/Right solutions on restart
             vecs = _gs_orth(engine, [], best_R + best_L)
+            H1_ss = None
+            H2_ss = None
         else:
 
             # Regular subspace update, orthonormalize preconditioned residuals and add to the trial set
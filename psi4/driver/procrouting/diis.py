@@ -155,15 +155,17 @@ class DIIS:
         return f"{self.name}: {name} Entry {entry_num}, Item {item_num}"
 
     def load_quantity(self, name, entry_num, item_num, force_new = True):
-        """ Load quantity from wherever it's stored, constructing a new object if needed. """
+        """ Load quantity from wherever it's stored, constructing a new object if needed.
+        With force_new=False, an in-core quantity is returned as-is; the caller must not modify it. """
         template_object = self.template[name][item_num]
         if isinstance(template_object, float) or self.storage_policy == StoragePolicy.InCore:
             quantity = self.stored_vectors[entry_num][name][item_num]
-            try:
-                quantity = quantity.clone()
-            except AttributeError:
-                # The quantity must have been a float. No need to clone.
-                pass
+            if force_new:
+                try:
+                    quantity = quantity.clone()
+                except AttributeError:
+                    # The quantity must have been a float. No need to clone.
+                    pass
         elif self.storage_policy == StoragePolicy.OnDisk:
             full_name = self.get_name(name, entry_num, item_num)
             psio = core.IO.shared_object()
@@ -193,13 +195,26 @@ class DIIS:
         except KeyError:
             dot_product = 0
             for item_num in range(len(self.template["error"])):
-                Rix = self.load_quantity("error", i, item_num)
-                Rjx = self.load_quantity("error", j, item_num)
+                Rix = self.load_quantity("error", i, item_num, force_new=False)
+                Rjx = self.load_quantity("error", j, item_num, force_new=False)
                 dot_product += Rix.vector_dot(Rjx)
 
             self.cached_dot_products[key] = dot_product
             return dot_product
 
+    def update_dot_products(self, index, errors):
+        """ Compute the dot products of the newly set entry index with every stored entry.
+        The new entry's errors are used as passed in, so only the other side is loaded. """
+        errors = [core.Matrix(R) if isinstance(R, (core.dpdbuf4, core.dpdfile2)) else R for R in errors]
+        for j in range(len(self.stored_vectors)):
+            if j == index:
+                dot_product = sum(R.vector_dot(R) for R in errors)
+            else:
+                dot_product = 0
+                for item_num, R in enumerate(errors):
+                    dot_product += R.vector_dot(self.load_quantity("error", j, item_num, force_new=False))
+            self.cached_dot_products[frozenset([index, j])] = dot_product
+
 
     def set_error_vector_size(self, *args):
         """ Set the template for the DIIS error. Kept mainly for backwards compatibility. """
@@ -242,8 +257,13 @@ class DIIS:
             # Set the new entry.
             self.stored_vectors[target_index] = self.build_entry(entry, target_index)
         else:
+            target_index = len(self.stored_vectors)
             self.stored_vectors.append(self.build_entry(entry, self.iter_num))
 
+        # Fill the new row of the B matrix now, while the new error vectors are still at hand.
+        if "diis" in self.engines and "error" in entry:
+            self.update_dot_products(target_index, entry["error"])
+
         return True
 
     def diis_coefficients(self):
@@ -299,7 +319,7 @@ class DIIS:
         dF = [[] for x in range(num_entries)]
         for name, array in zip(["densities", "target"], [dD, dF]):
             for item_num in range(len(self.template[name])):
-                latest_entry = self.load_quantity(name, len(self.stored_vectors) - 1, item_num)
+                latest_entry = self.load_quantity(name, len(self.stored_vectors) - 1, item_num, force_new=False)
                 for entry_num in range(num_entries):
                     temp = self.load_quantity(name, entry_num, item_num, force_new=True)
                     temp.subtract(latest_entry)
@@ -308,7 +328,7 @@ class DIIS:
         self.adiis_linear = np.zeros((num_entries))
         latest_fock = []
         for item_num in range(len(self.template["target"])):
-            latest_fock.append(self.load_quantity("target", len(self.stored_vectors) - 1, item_num))
+            latest_fock.append(self.load_quantity("target", len(self.stored_vectors) - 1, item_num, force_new=False))
         for i in range(num_entries):
             self.adiis_linear[i] = sum(d.vector_dot(f) for d, f in zip(dD[i], latest_fock))
 
@@ -347,12 +367,12 @@ class DIIS:
         num_entries = len(self.stored_vectors)
 
         self.ediis_quadratic = np.zeros((num_entries, num_entries))
-        for i in range(num_entries):
-            for item_num in range(len(self.template["densities"])):
-                d = self.load_quantity("densities", i, item_num)
+        for item_num in range(len(self.template["densities"])):
+            fs = [self.load_quantity("target", j, item_num, force_new=False) for j in range(num_entries)]
+            for i in range(num_entries):
+                d = self.load_quantity("densities", i, item_num, force_new=False)
                 for j in range(num_entries):
-                    f = self.load_quantity("target", j, item_num)
-                    self.ediis_quadratic[i][j] += d.vector_dot(f)
+                    self.ediis_quadratic[i][j] += d.vector_dot(fs[j])
 
         diag = np.diag(self.ediis_quadratic)
         # D_i F_i + D_j F_j - D_i F_j - D_j F_i; First two terms use broadcasting tricks
@@ -413,7 +433,7 @@ class DIIS:
         for j, Tj in enumerate(args):
             Tj.zero()
             for i, ci in enumerate(coeffs):
-                Tij = self.load_quantity("target", i, j)
+                Tij = self.load_quantity("target", i, j, force_new=False)
                 axpy(Tj, ci, Tij)
 
         return performed
@@ -149,6 +149,7 @@ class EmpiricalDispersion():
 
         if self.engine == 'libdisp':
             self.disp = core.Dispersion.build(self.dashlevel, **resolved['dashparams'])
+            self.disp.set_cutoff(core.get_option('SCF', 'DISPERSION_CUTOFF'))
 
     def print_out(self):
         """Format dispersion parameters of `self` for output file."""
@@ -1573,6 +1573,10 @@ def scf_helper(name, post_scf=True, **kwargs):
     ref_wfn = kwargs.pop('ref_wfn', None)
     if ref_wfn is not None:
         raise ValidationError("Cannot seed an SCF calculation with a reference wavefunction ('ref_wfn' kwarg).")
+    # converged wavefunction of a related system (e.g., the same monomer in a previous scan point)
+    guess_wfn = kwargs.pop('guess_wfn', None)
+    # the same, reduced to (Ca, Cb, nalphapi, nbetapi, basis name) of the occupied SO orbitals
+    guess_orbitals = kwargs.pop('guess_orbitals', None)
 
     # decide if we keep the checkpoint file
     _chkfile = kwargs.get('write_orbitals', True)
@@ -1798,6 +1802,53 @@ def scf_helper(name, post_scf=True, **kwargs):
             scf_wfn.set_sad_fitting_basissets(sad_fitting_list)
 
 
+    orbitals_cache = core.get_option('SCF', 'ORBITALS_CACHE')
+    cached = None
+    if orbitals_cache and (guess_wfn is None) and not (cast or read_orbitals):
+        cached = proc_util.read_orbital_cache(orbitals_cache, scf_wfn)
+        if cached is not None:
+            core.print_out(f"\n  Reading orbitals from the orbital cache {orbitals_cache}, no projection.\n\n")
+            scf_wfn.guess_Ca(cached[0])
+            scf_wfn.guess_Cb(cached[1])
+
+    orbitals_guess_file = core.get_option('SCF', 'ORBITALS_GUESS_FILE')
+    if orbitals_guess_file and (cached is None) and (guess_wfn is None) and not (cast or read_orbitals):
+        nearby = proc_util.read_nearby_orbitals(orbitals_guess_file, scf_wfn)
+        if nearby is not None:
+            core.print_out(f"\n  Reading orbitals of a nearby geometry from {orbitals_guess_file}.\n\n")
+            scf_wfn.guess_Ca(nearby[0])
+            scf_wfn.guess_Cb(nearby[1])
+
+    if (guess_orbitals is not None) and (guess_wfn is None) and not (cast or read_orbitals):
+        Ca, Cb, nalphapi, nbetapi, basis_name = guess_orbitals
+        nsopi = scf_wfn.nsopi().to_tuple()
+        if (basis_name == scf_wfn.basisset().name() and Ca.rowdim().to_tuple() == nsopi
+                and Cb.rowdim().to_tuple() == nsopi):
+            # same basis on the same atoms: projecting with the current basis re-orthonormalizes the
+            # orbitals in the overlap of the current geometry
+            core.print_out("\n  Projecting occupied orbitals of a previous calculation onto the current basis.\n\n")
+            basis = scf_wfn.basisset()
+            scf_wfn.guess_Ca(scf_wfn.basis_projection(Ca, nalphapi, basis, basis))
+            scf_wfn.guess_Cb(scf_wfn.basis_projection(Cb, nbetapi, basis, basis))
+
+    if (guess_wfn is not None) and not (cast or read_orbitals):
+        # a list holds the converged wavefunctions of the preceding steps of a trajectory, oldest first
+        guess_wfns = list(guess_wfn) if isinstance(guess_wfn, (list, tuple)) else [guess_wfn]
+        extrapolated = proc_util.extrapolated_guess_orbitals(guess_wfns, scf_wfn)
+        if extrapolated is not None:
+            core.print_out("\n  Extrapolating the densities of the %d previous steps (ASPC) for the guess.\n\n" %
+                           len(guess_wfns))
+            pCa, pCb = extrapolated
+        else:
+            guess_wfn = guess_wfns[-1]
+            core.print_out("\n  Projecting occupied orbitals of a previous calculation onto the current basis.\n\n")
+            pCa = guess_wfn.basis_projection(guess_wfn.Ca_subset("SO", "OCC"), guess_wfn.nalphapi(),
+                                             guess_wfn.basisset(), scf_wfn.basisset())
+            pCb = guess_wfn.basis_projection(guess_wfn.Cb_subset("SO", "OCC"), guess_wfn.nbetapi(),
+                                             guess_wfn.basisset(), scf_wfn.basisset())
+        scf_wfn.guess_Ca(pCa)
+        scf_wfn.guess_Cb(pCb)
+
     if cast:
         core.print_out("\n  Computing basis projection from %s to %s\n\n" % (ref_wfn.basisset().name(), base_wfn.basisset().name()))
         if ref_wfn.basisset().n_ecp_core() != base_wfn.basisset().n_ecp_core():
@@ -1825,7 +1876,11 @@ def scf_helper(name, post_scf=True, **kwargs):
             raise ValidationError("""Error: 3-layer QM/MM/PCM not implemented.\n""")
         pcmsolver_parsed_fname = core.get_local_option('PCM', 'PCMSOLVER_PARSED_FNAME')
         pcm_print_level = core.get_option('SCF', "PRINT")
-        scf_wfn.set_PCM(core.PCM(pcmsolver_parsed_fname, pcm_print_level, scf_wfn.basisset()))
+        pcm = core.PCM(pcmsolver_parsed_fname, pcm_print_level, scf_wfn.basisset(),
+                       core.get_option('PCM', 'PCM_SCREENING'))
+        pcm.set_incremental(core.get_option('PCM', 'PCM_INCREMENTAL'),
+                            core.get_option('PCM', 'PCM_INCREMENTAL_FULL_EVERY'))
+        scf_wfn.set_PCM(pcm)
 
     # PE preparation
     if core.get_option('SCF', 'PE'):
@@ -1901,6 +1956,9 @@ def scf_helper(name, post_scf=True, **kwargs):
         scf_wfn.to_file(filename)
         extras.register_numpy_file(filename) # retain with -m (messy) option
 
+    if orbitals_cache:
+        proc_util.write_orbital_cache(orbitals_cache, scf_wfn)
+
     if do_timer:
         core.tstop()
 
@@ -2524,7 +2582,8 @@ def run_scf(name, **kwargs):
     optstash_mp2 = p4util.OptionsState(
         ['DF_BASIS_MP2'],
         ['DFMP2', 'MP2_OS_SCALE'],
-        ['DFMP2', 'MP2_SS_SCALE'])
+        ['DFMP2', 'MP2_SS_SCALE'],
+        ['DFMP2', 'DFMP2_LAPLACE_OS_ONLY'])
 
     dft_func = False
     if "dft_functional" in kwargs:
@@ -2560,6 +2619,9 @@ def run_scf(name, **kwargs):
         if ssuper.is_c_scs_hybrid():
             core.set_local_option('DFMP2', 'MP2_OS_SCALE', ssuper.c_os_alpha())
             core.set_local_option('DFMP2', 'MP2_SS_SCALE', ssuper.c_ss_alpha())
+            if ssuper.c_ss_alpha() == 0.0 and core.get_option('DFMP2', 'DFMP2_LAPLACE'):
+                # skip the fifth-order same-spin term of the Laplace-transformed energy
+                core.set_local_option('DFMP2', 'DFMP2_LAPLACE_OS_ONLY', True)
             dfmp2_wfn = core.dfmp2(scf_wfn)
             dfmp2_wfn.compute_energy()
 
@@ -2679,10 +2741,10 @@ def run_scf_hessian(name, **kwargs):
     if ref_wfn is None:
         ref_wfn = run_scf(name, **kwargs)
 
-    badref = core.get_option('SCF', 'REFERENCE') in ['ROHF', 'CUHF', 'UKS']
+    badref = core.get_option('SCF', 'REFERENCE') in ['ROHF', 'CUHF']
     badint = core.get_global_option('SCF_TYPE') in [ 'CD', 'OUT_OF_CORE']
     if badref or badint:
-        raise ValidationError("Only RHF/UHF/RKS Hessians are currently implemented. SCF_TYPE either CD or OUT_OF_CORE not supported")
+        raise ValidationError("Only RHF/UHF/RKS/UKS Hessians are currently implemented. SCF_TYPE either CD or OUT_OF_CORE not supported")
 
     if hasattr(ref_wfn, "_disp_functor"):
         disp_hess = ref_wfn._disp_functor.compute_hessian(ref_wfn.molecule(), ref_wfn)
@@ -2851,7 +2913,7 @@ def run_ccenergy(name, **kwargs):
     if ref_wfn is None:
         ref_wfn = scf_helper(name, **kwargs)  # C1 certified
 
-    if core.get_global_option("CC_TYPE") == "DF":
+    if core.get_global_option("CC_TYPE") == "DF" or core.get_option("CCENERGY", "ABCD") == "DF":
         aux_basis = core.BasisSet.build(ref_wfn.molecule(), "DF_BASIS_CC",
                                             core.get_global_option("DF_BASIS_CC"),
                                             "RIFIT", core.get_global_option("BASIS"))
@@ -4161,7 +4223,12 @@ def run_dfmp2(name, **kwargs):
     dfmp2_wfn = core.dfmp2(ref_wfn)
     dfmp2_wfn.compute_energy()
 
-    if name == 'scs-mp2':
+    if not dfmp2_wfn.has_variable('MP2 TOTAL ENERGY'):
+        # opposite-spin term only, see DFMP2_LAPLACE_OS_ONLY
+        dfmp2_wfn.set_variable('CURRENT ENERGY', dfmp2_wfn.variable('CUSTOM SCS-MP2 TOTAL ENERGY'))
+        dfmp2_wfn.set_variable('CURRENT CORRELATION ENERGY', dfmp2_wfn.variable('CUSTOM SCS-MP2 CORRELATION ENERGY'))
+
+    elif name == 'scs-mp2':
         dfmp2_wfn.set_variable('CURRENT ENERGY', dfmp2_wfn.variable('SCS-MP2 TOTAL ENERGY'))
         dfmp2_wfn.set_variable('CURRENT CORRELATION ENERGY', dfmp2_wfn.variable('SCS-MP2 CORRELATION ENERGY'))
 
@@ -4350,6 +4417,74 @@ def run_dlpnomp2(name, **kwargs):
     return dlpnomp2_wfn
 
 
+def run_dlpnoccsd(name, **kwargs):
+    """Function encoding sequence of PSI module calls for
+    a DLPNO-CCSD or DLPNO-CCSD(T) calculation.
+
+    """
+    optstash = p4util.OptionsState(
+        ['DLPNO', 'DLPNO_METHOD'],
+        ['DF_BASIS_MP2'],
+        ['SCF_TYPE'])
+
+    # Alter default algorithm
+    if not core.has_global_option_changed('SCF_TYPE'):
+        core.set_global_option('SCF_TYPE', 'DF')
+        core.print_out("""    SCF Algorithm Type (re)set to DF.\n""")
+
+    # DLPNO-CCSD is only DF
+    if core.get_global_option('MP2_TYPE') != "DF":
+        raise ValidationError("""  DLPNO-CCSD is only implemented with density fitting.\n"""
+                              """  'mp2_type' must be set to 'DF'.\n""")
+
+    # Bypass the scf call if a reference wavefunction is given
+    ref_wfn = kwargs.get('ref_wfn', None)
+    if ref_wfn is None:
+        ref_wfn = scf_helper(name, use_c1=True, **kwargs)  # C1 certified
+    elif ref_wfn.molecule().schoenflies_symbol() != 'c1':
+        raise ValidationError("""  DLPNO-CCSD does not make use of molecular symmetry: """
+                              """reference wavefunction must be C1.\n""")
+
+    if core.get_global_option('REFERENCE') != "RHF":
+        raise ValidationError("DLPNO-CCSD is not available for %s references.",
+                              core.get_global_option('REFERENCE'))
+
+    if name == 'dlpno-ccsd(t)':
+        core.set_local_option('DLPNO', 'DLPNO_METHOD', 'CCSD_T')
+        label = 'DLPNO-CCSD(T)'
+    else:
+        core.set_local_option('DLPNO', 'DLPNO_METHOD', 'CCSD')
+        label = 'DLPNO-CCSD'
+
+    core.tstart()
+    core.print_out('\n')
+    p4util.banner(label)
+    core.print_out('\n')
+
+    aux_basis = core.BasisSet.build(ref_wfn.molecule(), "DF_BASIS_MP2",
+                                    core.get_option("DLPNO", "DF_BASIS_MP2"),
+                                    "RIFIT", core.get_global_option('BASIS'))
+    ref_wfn.set_basisset("DF_BASIS_MP2", aux_basis)
+
+    dlpnoccsd_wfn = core.dlpno(ref_wfn)
+    dlpnoccsd_wfn.compute_energy()
+
+    if name == 'dlpno-ccsd(t)':
+        dlpnoccsd_wfn.set_variable('CURRENT ENERGY', dlpnoccsd_wfn.variable('CCSD(T) TOTAL ENERGY'))
+        dlpnoccsd_wfn.set_variable('CURRENT CORRELATION ENERGY', dlpnoccsd_wfn.variable('CCSD(T) CORRELATION ENERGY'))
+    else:
+        dlpnoccsd_wfn.set_variable('CURRENT ENERGY', dlpnoccsd_wfn.variable('CCSD TOTAL ENERGY'))
+        dlpnoccsd_wfn.set_variable('CURRENT CORRELATION ENERGY', dlpnoccsd_wfn.variable('CCSD CORRELATION ENERGY'))
+
+    # Shove variables into global space
+    for k, v in dlpnoccsd_wfn.variables().items():
+        core.set_variable(k, v)
+
+    optstash.restore()
+    core.tstop()
+    return dlpnoccsd_wfn
+
+
 def run_dmrgscf(name, **kwargs):
     """Function encoding sequence of PSI module calls for
     an DMRG calculation.
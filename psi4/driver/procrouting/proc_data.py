@@ -126,6 +126,8 @@ method_governing_type_keywords = {
         "fno-ccsd(t)"  : "cc_type",
 
         "dlpno-mp2"    : "mp2_type",
+        "dlpno-ccsd"   : "mp2_type",
+        "dlpno-ccsd(t)": "mp2_type",
 
         "ep2"          : "mp2_type",
         "eom-cc2"      : "cc_type",
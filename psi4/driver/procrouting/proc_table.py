@@ -70,6 +70,8 @@ procedures = {
         'custom-scs-omp2' : proc.run_occ,
         'dlpno-mp2'     : proc.run_dlpnomp2,
         'scs-dlpno-mp2' : proc.run_dlpnomp2,
+        'dlpno-ccsd'    : proc.run_dlpnoccsd,
+        'dlpno-ccsd(t)' : proc.run_dlpnoccsd,
         'mp2.5'         : proc.select_mp2p5,
         'custom-scs-mp2.5' : proc.run_occ,
         'omp2.5'        : proc.select_omp2p5,
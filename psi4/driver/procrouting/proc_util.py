@@ -25,6 +25,10 @@
 #
 # @END LICENSE
 #
+import os
+import math
+import hashlib
+import tempfile
 from typing import Tuple
 
 import numpy as np
@@ -94,6 +98,8 @@ def oeprop_validator(prop_list):
 def check_iwl_file_from_scf_type(scf_type, wfn):
     """
     Ensures that a IWL file has been written based on input SCF type.
+    When TRANSFORM_TEI_TYPE is DF, also attaches the auxiliary basis that libtrans
+    uses to density fit the SO integrals.
     """
 
     if scf_type in ['DF', 'DISK_DF', 'MEM_DF', 'CD', 'PK', 'DIRECT']:
@@ -110,6 +116,12 @@ def check_iwl_file_from_scf_type(scf_type, wfn):
         mints.set_print(1)
         mints.integrals()
 
+    if core.get_global_option("TRANSFORM_TEI_TYPE") == "DF":
+        aux = core.BasisSet.build(wfn.molecule(), "DF_BASIS_TRANSFORM",
+                                  core.get_global_option("DF_BASIS_TRANSFORM"), "RIFIT",
+                                  core.get_global_option("BASIS"))
+        wfn.set_basisset("DF_BASIS_TRANSFORM", aux)
+
 
 def check_non_symmetric_jk_density(name):
     """
@@ -139,6 +151,153 @@ def check_disk_df(name, optstash):
             )
 
 
+def extrapolated_guess_orbitals(guess_wfns, scf_wfn):
+    """Occupied orbitals for the SCF guess of *scf_wfn* from the always-stable predictor-corrector
+    (ASPC) extrapolation of the densities of *guess_wfns*, the converged wavefunctions of the
+    preceding steps of a trajectory, oldest first (Kolafa, J. Comput. Chem. 25, 335 (2004)).
+
+    The AO densities are combined with the ASPC predictor coefficients of order len(guess_wfns) - 2,
+    and the result is made idempotent again by keeping its most occupied natural orbitals in the
+    overlap metric of the new geometry. Returns (Ca, Cb), or None when the wavefunctions cannot be
+    combined this way (symmetry, a change of basis or occupation), in which case the caller
+    should fall back to projecting the latest orbitals.
+
+    """
+    latest = guess_wfns[-1]
+    nbf = scf_wfn.basisset().nbf()
+    if len(guess_wfns) < 2 or scf_wfn.nirrep() != 1:
+        return None
+    for wfn in guess_wfns:
+        if (wfn.nirrep() != 1 or wfn.basisset().nbf() != nbf or wfn.nalpha() != latest.nalpha()
+                or wfn.nbeta() != latest.nbeta()):
+            return None
+
+    # predictor coefficients B_j for D(n+1) = sum_j B_j D(n+1-j), j = 1..k+2
+    k = len(guess_wfns) - 2
+    coeffs = [(-1)**(j + 1) * j * math.comb(2 * k + 4, k + 2 - j) / math.comb(2 * k + 2, k + 1) for j in range(1, k + 3)]
+
+    S = core.MintsHelper(scf_wfn.basisset()).ao_overlap().np
+    evals, evecs = np.linalg.eigh(S)
+    S_half = (evecs * np.sqrt(evals)) @ evecs.T
+    S_invhalf = (evecs / np.sqrt(evals)) @ evecs.T
+
+    orbitals = []
+    for nocc, subset in ((latest.nalpha(), "Ca_subset"), (latest.nbeta(), "Cb_subset")):
+        D = np.zeros((nbf, nbf))
+        for coeff, wfn in zip(coeffs, reversed(guess_wfns)):
+            Cocc = getattr(wfn, subset)("AO", "OCC").np
+            D += coeff * (Cocc @ Cocc.T)
+
+        Cocc = core.Matrix("Extrapolated guess orbitals", nbf, nocc)
+        if nocc:
+            occ, U = np.linalg.eigh(S_half @ D @ S_half)
+            Cocc.np[:] = S_invhalf @ U[:, ::-1][:, :nocc]
+        orbitals.append(Cocc)
+
+    return orbitals
+
+
+# bump when the layout of the orbital cache entries changes; older entries are then ignored
+_ORBITAL_CACHE_VERSION = 1
+
+
+def orbital_cache_key(wfn):
+    """Name of the orbital cache entry of *wfn*: a hash of everything that has to match for its
+    converged orbitals to be taken over as they are, namely the kind of reference (R, U, RO, CU),
+    the charge, multiplicity, point group and geometry of the molecule, and the shells of the basis.
+
+    """
+    mol = wfn.molecule()
+    basis = wfn.basisset()
+    ref = wfn.name().replace("KS", "").replace("HF", "")
+
+    key = hashlib.sha256()
+    key.update(f"{ref} {mol.molecular_charge()} {mol.multiplicity()} {mol.schoenflies_symbol()}\n".encode())
+    for A in range(mol.natom()):
+        key.update(f"{mol.Z(A)!r} {mol.x(A)!r} {mol.y(A)!r} {mol.z(A)!r}\n".encode())
+    key.update(f"{basis.name()} {basis.nbf()} {basis.has_puream()} {basis.n_ecp_core()}\n".encode())
+    for S in range(basis.nshell()):
+        shell = basis.shell(S)
+        prims = " ".join(f"{shell.exp(p)!r} {shell.coef(p)!r}" for p in range(shell.nprimitive))
+        key.update(f"{shell.ncenter} {shell.am} {prims}\n".encode())
+    return key.hexdigest()
+
+
+def write_orbital_cache(cache_dir, wfn):
+    """Store the occupied orbitals of the converged *wfn* in the orbital cache *cache_dir*.
+
+    The entry is written to a temporary file and renamed into place, so that processes
+    reading the cache concurrently never see a partial entry.
+
+    """
+    os.makedirs(cache_dir, exist_ok=True)
+    arrays = {"version": np.array(_ORBITAL_CACHE_VERSION), "nirrep": np.array(wfn.nirrep())}
+    for label, subset in (("a", wfn.Ca_subset("SO", "OCC")), ("b", wfn.Cb_subset("SO", "OCC"))):
+        for h in range(wfn.nirrep()):
+            arrays[f"C{label}_{h}"] = subset.nph[h]
+
+    fd, tmpname = tempfile.mkstemp(dir=cache_dir, suffix=".tmp")
+    with os.fdopen(fd, "wb") as fp:
+        np.savez(fp, **arrays)
+    os.replace(tmpname, os.path.join(cache_dir, orbital_cache_key(wfn) + ".npz"))
+
+
+def read_orbital_cache(cache_dir, scf_wfn):
+    """Occupied orbitals (Ca, Cb) for the guess of *scf_wfn* from the orbital cache *cache_dir*,
+    or None if there is no entry for this molecule, basis and reference.
+
+    """
+    fname = os.path.join(cache_dir, orbital_cache_key(scf_wfn) + ".npz")
+    if not os.path.isfile(fname):
+        return None
+
+    with np.load(fname) as entry:
+        if int(entry["version"]) != _ORBITAL_CACHE_VERSION or int(entry["nirrep"]) != scf_wfn.nirrep():
+            return None
+        orbitals = []
+        for label in ("a", "b"):
+            blocks = [entry[f"C{label}_{h}"] for h in range(scf_wfn.nirrep())]
+            orbitals.append(core.Matrix.from_array(blocks if len(blocks) > 1 else blocks[0]))
+
+    nsopi = scf_wfn.nsopi().to_tuple()
+    if orbitals[0].rowdim().to_tuple() != nsopi or orbitals[1].rowdim().to_tuple() != nsopi:
+        return None
+    return orbitals
+
+
+def read_nearby_orbitals(fname, scf_wfn):
+    """Occupied orbitals (Ca, Cb) for the guess of *scf_wfn* from the wavefunction file *fname*,
+    written for a nearby geometry of the same molecule in the same basis, or None if it does not fit.
+
+    The AO coefficients are taken over unchanged and split onto the irreps of *scf_wfn*, so the
+    point group may be a subgroup of the one of the file, as for finite-difference displacements.
+
+    """
+    if not os.path.isfile(fname if fname.endswith(".npy") else fname + ".npy"):
+        return None
+    old_wfn = core.Wavefunction.from_file(fname)
+
+    mol, old_mol = scf_wfn.molecule(), old_wfn.molecule()
+    basis, old_basis = scf_wfn.basisset(), old_wfn.basisset()
+    if (old_mol.natom() != mol.natom() or old_mol.molecular_charge() != mol.molecular_charge()
+            or old_mol.multiplicity() != mol.multiplicity()
+            or any(old_mol.Z(A) != mol.Z(A) for A in range(mol.natom()))
+            or old_basis.name() != basis.name() or old_basis.nbf() != basis.nbf()):
+        return None
+
+    nirrep = scf_wfn.nirrep()
+    aotoso = scf_wfn.aotoso()
+    orbitals = []
+    for C in (old_wfn.Ca_subset("AO", "OCC"), old_wfn.Cb_subset("AO", "OCC")):
+        proj = [aotoso.nph[h].T @ C.np for h in range(nirrep)]
+        # each orbital goes to the irrep holding most of it
+        weight = np.array([np.einsum("pi,pi->i", P, P) for P in proj])
+        irrep = np.argmax(weight, axis=0)
+        blocks = [proj[h][:, irrep == h] for h in range(nirrep)]
+        orbitals.append(core.Matrix.from_array(blocks if nirrep > 1 else blocks[0]))
+    return orbitals
+
+
 def print_ci_results(ciwfn, rname, scf_e, ci_e, print_opdm_no=False):
     """
     Printing for all CI Wavefunctions
@@ -630,6 +630,47 @@ def _sapt_cpscf_solve(cache, jk, rhsA, rhsB, maxiter, conv, sapt_jk_B=None):
 
         return [xA, xB]
 
+    # Hx function for two RHF monomers sharing one JK object, both products from a single JK build
+    def hessian_vec_batched(x_vec, act_mask):
+        active = [n for n in range(2) if act_mask[n]]
+
+        jk.C_clear()
+        for n in active:
+            jk.C_left_add(Cocc[n])
+            R = core.doublet(Cvir[n], x_vec[n], False, True)
+            R.scale(-1.0)
+            jk.C_right_add(R)
+        jk.compute()
+
+        ret = [False, False]
+        for pos, n in enumerate(active):
+            # Cocc_ni (4 * J[D]_nm - K[D]_nm - K[D]_mn) C_vir_ma
+            G = jk.J()[pos].clone()
+            G.scale(4.0)
+            functional = wfns[n].functional()
+            if functional.is_x_hybrid():
+                K = jk.K()[pos]
+                G.axpy(-functional.x_alpha(), K)
+                G.axpy(-functional.x_alpha(), K.transpose())
+
+            Hx = core.triplet(Cocc[n], G, Cvir[n], True, False, False)
+            Hx.add(wfns[n].onel_Hx([x_vec[n]])[0])
+            ret[n] = Hx
+
+        jk.C_clear()
+        return ret
+
+    wfns = [cache["wfn_A"], cache["wfn_B"]]
+    Cocc = [cache["Cocc_A"], cache["Cocc_B"]]
+    Cvir = [cache["Cvir_A"], cache["Cvir_B"]]
+
+    # Kernels with an XC or range-separated exchange part go through cphf_Hx one monomer at a time
+    batch_jk = (sapt_jk_B is None) and all(
+        isinstance(wfn, core.RHF) and not wfn.functional().needs_xc() and not wfn.functional().is_x_lrc()
+        for wfn in wfns)
+    if batch_jk:
+        hessian_vec = hessian_vec_batched
+
     # Manipulate the printing
     sep_size = 51
     core.print_out("   " + ("-" * sep_size) + "\n")
@@ -151,9 +151,21 @@ def df_fdds_dispersion(primary, auxiliary, cache, is_hybrid, x_alpha, leg_points
         Rtinv_A = np.linalg.pinv(R_A, rcond=1.e-13).transpose()
         Rtinv_B = np.linalg.pinv(R_B, rcond=1.e-13).transpose()
 
-    for point, weight in zip(*np.polynomial.legendre.leggauss(leg_points)):
+    # The metric products are the same for every frequency
+    metric_inv_W_A = metric_inv.dot(W_A)
+    metric_inv_W_B = metric_inv.dot(W_B)
 
-        omega = leg_lambda * (1.0 - point) / (1.0 + point)
+    leg_roots, leg_weights = np.polynomial.legendre.leggauss(leg_points)
+    omegas = [leg_lambda * (1.0 - point) / (1.0 + point) for point in leg_roots]
+
+    # Uncoupled amplitudes of all frequencies from one pass over the (ar|Q) integrals
+    if not is_hybrid:
+        unc_amps_A = fdds_obj.form_unc_amplitudes("A", omegas)
+        unc_amps_B = fdds_obj.form_unc_amplitudes("B", omegas)
+
+    for ipoint, (point, weight) in enumerate(zip(leg_roots, leg_weights)):
+
+        omega = omegas[ipoint]
         lambda_scale = ((2.0 * leg_lambda) / (point + 1.0)**2)
 
         # Monomer A
@@ -167,13 +179,13 @@ def df_fdds_dispersion(primary, auxiliary, cache, is_hybrid, x_alpha, leg_points
             K_A = -x_alpha * aux_dict["K1LD"] - x_alpha * aux_dict["K2LD"] + x_alpha * x_alpha * aux_dict["K21L"]
             KRS_A = K_A.dot(Rtinv_A).dot(metric)
         else:
-            X_A = fdds_obj.form_unc_amplitude("A", omega)
+            X_A = unc_amps_A[ipoint]
             X_A.scale(-1.0)
             X_A = X_A.to_array()
             X_A_uc = X_A.copy()
 
         # Coupled A
-        XSW_A = X_A.dot(metric_inv).dot(W_A)
+        XSW_A = X_A.dot(metric_inv_W_A)
         if is_hybrid:
             XSW_A += 0.25 * KRS_A
 
@@ -195,13 +207,13 @@ def df_fdds_dispersion(primary, auxiliary, cache, is_hybrid, x_alpha, leg_points
             K_B = -x_alpha * aux_dict["K1LD"] - x_alpha * aux_dict["K2LD"] + x_alpha * x_alpha * aux_dict["K21L"]
             KRS_B = K_B.dot(Rtinv_B).dot(metric)
         else:
-            X_B = fdds_obj.form_unc_amplitude("B", omega)
+            X_B = unc_amps_B[ipoint]
             X_B.scale(-1.0)
             X_B = X_B.to_array()
             X_B_uc = X_B.copy()
 
         # Coupled B
-        XSW_B = X_B.dot(metric_inv).dot(W_B)
+        XSW_B = X_B.dot(metric_inv_W_B)
         if is_hybrid:
             XSW_B += 0.25 * KRS_B
 
@@ -44,6 +44,38 @@ from . import sapt_sf_terms
 # Only export the run_ scripts
 __all__ = ['run_sapt_dft', 'sapt_dft', 'run_sf_sapt']
 
+# Occupied orbitals of the converged monomers of the last SAPT(DFT) run, reused as guesses when
+# SAPT_DFT_MONOMER_GUESS is set (scans and databases with recurring monomers). Only the orbitals,
+# occupations and basis name are kept, so no wavefunction (or its JK object) outlives its run.
+_monomer_guess_cache = {}
+
+
+def _monomer_guess(label, monomer, method):
+    """
+    Returns the guess_orbitals of scf_helper from a previous run for the same monomer and method, or
+    None. Only the atoms (including ghosts) and the electronic state have to match, not the geometry.
+    """
+
+    if not core.get_option("SAPT", "SAPT_DFT_MONOMER_GUESS"):
+        return None
+
+    key, orbitals = _monomer_guess_cache.get(label, (None, None))
+    if key != _monomer_guess_key(monomer, method):
+        return None
+    return orbitals
+
+
+def _store_monomer_guess(label, monomer, method, wfn):
+    if core.get_option("SAPT", "SAPT_DFT_MONOMER_GUESS"):
+        orbitals = (wfn.Ca_subset("SO", "OCC"), wfn.Cb_subset("SO", "OCC"), core.Dimension(list(wfn.nalphapi().to_tuple())),
+                    core.Dimension(list(wfn.nbetapi().to_tuple())), wfn.basisset().name())
+        _monomer_guess_cache[label] = (_monomer_guess_key(monomer, method), orbitals)
+
+
+def _monomer_guess_key(monomer, method):
+    atoms = tuple((monomer.symbol(i), monomer.Z(i) != 0) for i in range(monomer.natom()))
+    return (method, core.get_global_option("BASIS"), atoms, monomer.molecular_charge(), monomer.multiplicity())
+
 
 def run_sapt_dft(name, **kwargs):
     optstash = p4util.OptionsState(['SCF_TYPE'], ['SCF', 'REFERENCE'], ['SCF', 'DFT_GRAC_SHIFT'], ['SCF', 'SAVE_JK'])
@@ -130,7 +162,12 @@ def run_sapt_dft(name, **kwargs):
         if (core.get_global_option('SCF_TYPE') == 'DF'):
             core.IO.change_file_namespace(97, 'dimer', 'monomerA')
 
-        hf_wfn_A = scf_helper("SCF", molecule=monomerA, banner="SAPT(DFT): delta HF Monomer A", **kwargs)
+        hf_wfn_A = scf_helper("SCF",
+                              molecule=monomerA,
+                              banner="SAPT(DFT): delta HF Monomer A",
+                              guess_orbitals=_monomer_guess("HF A", monomerA, "HF"),
+                              **kwargs)
+        _store_monomer_guess("HF A", monomerA, "HF", hf_wfn_A)
         hf_data["HF MONOMER A"] = core.variable("CURRENT ENERGY")
         core.timer_off("SAPT(DFT):Monomer A SCF")
 
@@ -139,7 +176,12 @@ def run_sapt_dft(name, **kwargs):
         if (core.get_global_option('SCF_TYPE') == 'DF'):
             core.IO.change_file_namespace(97, 'monomerA', 'monomerB')
 
-        hf_wfn_B = scf_helper("SCF", molecule=monomerB, banner="SAPT(DFT): delta HF Monomer B", **kwargs)
+        hf_wfn_B = scf_helper("SCF",
+                              molecule=monomerB,
+                              banner="SAPT(DFT): delta HF Monomer B",
+                              guess_orbitals=_monomer_guess("HF B", monomerB, "HF"),
+                              **kwargs)
+        _store_monomer_guess("HF B", monomerB, "HF", hf_wfn_B)
         hf_data["HF MONOMER B"] = core.variable("CURRENT ENERGY")
         core.set_global_option("SAVE_JK", False)
         core.timer_off("SAPT(DFT):Monomer B SCF")
@@ -229,7 +271,9 @@ def run_sapt_dft(name, **kwargs):
                            post_scf=False,
                            molecule=monomerA,
                            banner="SAPT(DFT): DFT Monomer A",
+                           guess_orbitals=_monomer_guess("A", monomerA, sapt_dft_functional),
                            **kwargs)
+        _store_monomer_guess("A", monomerA, sapt_dft_functional, wfn_A)
         data["DFT MONOMERA"] = core.variable("CURRENT ENERGY")
 
         core.set_global_option("DFT_GRAC_SHIFT", 0.0)
@@ -249,7 +293,9 @@ def run_sapt_dft(name, **kwargs):
                            post_scf=False,
                            molecule=monomerB,
                            banner="SAPT(DFT): DFT Monomer B",
+                           guess_orbitals=_monomer_guess("B", monomerB, sapt_dft_functional),
                            **kwargs)
+        _store_monomer_guess("B", monomerB, sapt_dft_functional, wfn_B)
         data["DFT MONOMERB"] = core.variable("CURRENT ENERGY")
         core.timer_off("SAPT(DFT): Monomer B DFT")
 
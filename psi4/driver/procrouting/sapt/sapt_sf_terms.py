@@ -88,8 +88,9 @@ def _sf_compute_JK(jk, Cleft, Cright, rotation=None):
             else:
                 Cr = np.dot(Cr, rotation[num].T)
 
-        Cl = core.Matrix.from_array(Cl)
-        Cr = core.Matrix.from_array(Cr)
+        # JK only reads the orbitals, so share rather than copy them
+        Cl = core.Matrix.from_array(np.ascontiguousarray(Cl, dtype=np.float64), copy=False)
+        Cr = core.Matrix.from_array(np.ascontiguousarray(Cr, dtype=np.float64), copy=False)
 
         jk.C_left_add(Cl)
         jk.C_right_add(Cr)
@@ -29,6 +29,13 @@
 The SCF iteration functions
 """
 
+import os
+import json
+import math
+import time
+import platform
+import tempfile
+
 import numpy as np
 
 from psi4.driver import p4util
@@ -36,7 +43,7 @@ from psi4.driver import constants
 from psi4.driver.p4util.exceptions import SCFConvergenceError, ValidationError
 from psi4 import core
 
-from ..solvent.efp import get_qm_atoms_opts, modify_Fock_permanent, modify_Fock_induced
+from ..solvent.efp import get_qm_atoms_opts, modify_Fock_permanent, modify_Fock_induced, site_fields
 
 #import logging
 #logger = logging.getLogger("scf.scf_iterator")
@@ -60,6 +67,25 @@ def scf_compute_energy(self):
     returns the SCF energy computed by finalize_energy().
 
     """
+    try:
+        return _scf_compute_energy(self)
+    finally:
+        # the grants of initialize() do not outlive the SCF, also when it fails
+        _release_scf_memory()
+
+
+def _release_scf_memory():
+    """Hands the memory of this SCF back to the broker for the next module."""
+
+    broker = core.MemoryBroker.shared_object()
+    broker.release("SCF JK")
+    broker.release("SCF incremental XC")
+    if not core.get_option("SCF", "DFT_COLLOCATION_CACHE_KEEP"):
+        broker.release("SCF collocation")
+    broker.release("SCF DIIS")
+
+
+def _scf_compute_energy(self):
     if core.get_option('SCF', 'DF_SCF_GUESS') and (core.get_global_option('SCF_TYPE') == 'DIRECT'):
         # speed up DIRECT algorithm (recomputes full (non-DF) integrals
         #   each iter) by first converging via fast DF iterations, then
@@ -78,7 +104,7 @@ def scf_compute_energy(self):
         # reset the DIIS & JK objects in prep for DIRECT
         if self.initialized_diis_manager_:
             self.diis_manager_.reset_subspace()
-        self.initialize_jk(self.memory_jk_)
+        self.initialize_jk(self.memory_jk_, jk=_build_jk(self, self.memory_jk_, _jk_autotune_setup(self, self.memory_jk_)))
     else:
         self.initialize()
 
@@ -100,15 +126,129 @@ def scf_compute_energy(self):
     return scf_energy
 
 
-def _build_jk(wfn, memory):
+def _build_jk(wfn, memory, jk_type=None):
     jk = core.JK.build(wfn.get_basisset("ORBITAL"),
                        aux=wfn.get_basisset("DF_BASIS_SCF"),
+                       jk_type=jk_type,
                        do_wK=wfn.functional().is_x_lrc(),
                        memory=memory)
     return jk
 
 
-def initialize_jk(self, memory, jk=None):
+# JK algorithms that give the same Fock matrix (to the integral screening), grouped by SCF_TYPE.
+# Only the DF builders are tried: a PK or OUT_OF_CORE trial writes the whole integral file for a
+# single Fock build, and DIRECT has no exact-equivalent direct alternative.
+_JK_AUTOTUNE_FAMILIES = {
+    "DF": ["MEM_DF", "DISK_DF"],
+    "MEM_DF": ["MEM_DF", "DISK_DF"],
+    "DISK_DF": ["MEM_DF", "DISK_DF"],
+}
+
+# Fock builds of a typical SCF, over which the set-up cost of an algorithm is spread
+_JK_AUTOTUNE_BUILDS = 15
+
+
+def _jk_autotune_key(wfn, candidates, memory):
+    """Entry of the JK autotune cache for *wfn*: the candidate algorithms, the basis set and its
+    size class, the node, the thread count, and the size class of the JK *memory* (in doubles)."""
+
+    basis = wfn.basisset()
+    size_class = 2**math.ceil(math.log2(max(basis.nbf(), 1)))
+    memory_class = 2**max(math.ceil(math.log2(max(memory * 8, 1) / 1024**3)), 0)
+    return "/".join(candidates) + f" {basis.name()} nbf<={size_class} {platform.node()} " \
+        f"nthread={core.get_num_threads()} mem<={memory_class}GB"
+
+
+def _jk_autotune_read(cache_dir):
+    fname = os.path.join(cache_dir, "jk_autotune.json")
+    if not os.path.isfile(fname):
+        return {}
+    with open(fname) as fp:
+        return json.load(fp)
+
+
+def _jk_autotune_write(cache_dir, key, entry):
+    """Add *entry* to the JK autotune cache in *cache_dir*, replacing the file in one rename so
+    that concurrent jobs never read a partial cache."""
+
+    os.makedirs(cache_dir, exist_ok=True)
+    decisions = _jk_autotune_read(cache_dir)
+    decisions[key] = entry
+    fd, tmpname = tempfile.mkstemp(dir=cache_dir, suffix=".tmp")
+    with os.fdopen(fd, "w") as fp:
+        json.dump(decisions, fp, indent=1)
+    os.replace(tmpname, os.path.join(cache_dir, "jk_autotune.json"))
+
+
+def _jk_autotune_setup(self, memory):
+    """JK algorithm to build with *memory* doubles for the coming SCF iterations under
+    |scf__jk_autotune|, or None to follow |globals__scf_type|.
+
+    With a decision in |scf__jk_autotune_cache| for this system class and node, that algorithm is
+    used directly. Otherwise the exact-equivalent candidates are timed for one Fock build each
+    in the first iterations (see _jk_autotune_step), starting with the first returned here.
+
+    """
+    self._jk_autotune = None
+    candidates = _JK_AUTOTUNE_FAMILIES.get(core.get_global_option("SCF_TYPE"))
+    if not core.get_option("SCF", "JK_AUTOTUNE") or candidates is None:
+        return None
+    # integrals kept on disk for later modules need DISK_DF
+    if candidates[0] == "MEM_DF" and core.has_option_changed("SCF", "DF_INTS_IO"):
+        return None
+
+    key = _jk_autotune_key(self, candidates, memory)
+    cache_dir = core.get_option("SCF", "JK_AUTOTUNE_CACHE")
+    if cache_dir:
+        choice = _jk_autotune_read(cache_dir).get(key, {}).get("choice")
+        if choice in candidates:
+            core.print_out(f"  JK autotune: using {choice} from the cache.\n\n")
+            return choice
+
+    self._jk_autotune = {
+        "key": key,
+        "cache_dir": cache_dir,
+        "candidates": candidates,
+        "current": candidates[0],
+        "setup": {},
+        "build": {}
+    }
+    return candidates[0]
+
+
+def _jk_autotune_step(self, seconds):
+    """Record *seconds* for the Fock build of the current candidate, then set up the next one or,
+    once all were timed, continue with the fastest over a typical SCF and cache the decision.
+    Returns the iteration status."""
+
+    tune = self._jk_autotune
+    jk_type = tune["current"]
+    tune["build"][jk_type] = seconds
+    candidates = tune["candidates"]
+    pending = [c for c in candidates if c not in tune["build"]]
+    if pending:
+        t0 = time.perf_counter()
+        self.initialize_jk(self.memory_jk_, jk=_build_jk(self, self.memory_jk_, pending[0]), print_header=False)
+        tune["setup"][pending[0]] = time.perf_counter() - t0
+        tune["current"] = pending[0]
+        return "JK=" + jk_type
+
+    cost = {c: tune["setup"].get(c, 0.0) + _JK_AUTOTUNE_BUILDS * tune["build"][c] for c in candidates}
+    choice = min(candidates, key=cost.get)
+    if choice != jk_type:
+        self.initialize_jk(self.memory_jk_, jk=_build_jk(self, self.memory_jk_, choice), print_header=False)
+    self._jk_autotune = None
+
+    if tune["cache_dir"]:
+        _jk_autotune_write(tune["cache_dir"], tune["key"], {
+            "choice": choice,
+            "setup": tune["setup"],
+            "build": tune["build"],
+        })
+    return f"JK={jk_type}->{choice}"
+
+
+def initialize_jk(self, memory, jk=None, print_header=True):
 
     functional = self.functional()
     if jk is None:
@@ -126,7 +266,8 @@ def initialize_jk(self, memory, jk=None):
     jk.set_omega_beta(functional.x_beta())   
 
     jk.initialize()
-    jk.print_header()
+    if print_header:
+        jk.print_header()
 
 
 def scf_initialize(self):
@@ -145,29 +286,43 @@ def scf_initialize(self):
             collocation_size *= 4  # First derivs
         elif vbase.functional().ansatz() == 2:
             collocation_size *= 10  # Second derivs
+        if core.get_option("SCF", "DFT_COLLOCATION_CACHE_FLOAT"):
+            collocation_size //= 2  # Single precision
+        # The incremental XC build (DFT_INCXC) keeps its block matrices however little it is granted
+        incxc_size = vbase.incxc_size()
     else:
         collocation_size = 0
+        incxc_size = 0
 
     # Change allocation for collocation matrices based on DFT type
-    jk = _build_jk(self, total_memory)
+    jk = _build_jk(self, total_memory, _jk_autotune_setup(self, total_memory))
     jk_size = jk.memory_estimate()
 
-    # Give remaining to collocation
-    if total_memory > jk_size:
-        collocation_memory = total_memory - jk_size
-    # Give up to 10% to collocation
-    elif (total_memory * 0.1) > collocation_size:
-        collocation_memory = collocation_size
+    # DIIS keeps a Fock matrix, an error vector and a density per spin and vector
+    diis_size = core.get_option('SCF', 'DIIS_MAX_VECS') * 3 * (1 if self.same_a_b_orbs() else 2) * self.nso()**2
+
+    # The memory broker splits the SCF share (in bytes). The incremental XC storage comes off the top.
+    # The JK object is served next: all it asks for if that fits, with the collocation cache taking
+    # what is left; otherwise the collocation cache keeps up to 10% and JK the rest. Then the
+    # collocation cache and DIIS (in core rather than on disk), in order of benefit per byte. Memory
+    # nobody asked for stays with the broker.
+    share = max(total_memory - incxc_size, 0)
+    if share > jk_size:
+        jk_minimum, collocation_minimum = jk_size, 0
     else:
-        collocation_memory = total_memory * 0.1
-
-    if collocation_memory > collocation_size:
-        collocation_memory = collocation_size
+        jk_minimum, collocation_minimum = 0, min(share * 0.1, collocation_size)
+    broker = core.MemoryBroker.shared_object()
+    broker.request("SCF incremental XC", int(8 * incxc_size), [])
+    broker.request("SCF JK", int(8 * jk_minimum), [(int(8 * jk_size), 1.0)])
+    broker.request("SCF collocation", int(8 * collocation_minimum), [(int(8 * collocation_size), 0.25)])
+    broker.request("SCF DIIS", 0, [(int(8 * diis_size), 1.e-3)])
+    grants = broker.allocate(int(8 * total_memory))
 
     # Set constants
     self.iteration_ = 0
-    self.memory_jk_ = int(total_memory - collocation_memory)
-    self.memory_collocation_ = int(collocation_memory)
+    self.memory_jk_ = grants["SCF JK"] // 8
+    self.memory_collocation_ = grants["SCF collocation"] // 8
+    self.diis_in_core_ = grants["SCF DIIS"] >= 8 * diis_size
 
     if self.get_print():
         core.print_out("  ==> Integral Setup <==\n\n")
@@ -190,7 +345,10 @@ def scf_initialize(self):
     if self.attempt_number_ == 1:
         mints = core.MintsHelper(self.basisset())
 
+        t0 = time.perf_counter()
         self.initialize_jk(self.memory_jk_, jk=jk)
+        if getattr(self, "_jk_autotune", None):
+            self._jk_autotune["setup"][self._jk_autotune["current"]] = time.perf_counter() - t0
         if self.V_potential():
             self.V_potential().build_collocation_cache(self.memory_collocation_)
         core.timer_on("HF: Form core H")
@@ -260,14 +418,63 @@ def scf_iterate(self, e_conv=None, d_conv=None):
     damping_enabled = _validate_damping()
     soscf_enabled = _validate_soscf()
     frac_enabled = _validate_frac()
+
+    # purification only has the RHF occupations to work with, and SOSCF needs F diagonalized
+    # for its orbital rotations and the orbitals it converges on
+    if core.get_option('SCF', 'DENSITY_PURIFICATION') != 'NONE' and reference not in ['RHF', 'RKS']:
+        raise ValidationError('SCF DENSITY_PURIFICATION is only implemented for RHF and RKS, not {}.'.format(reference))
+    if self.purify_ and soscf_enabled:
+        self.purify_ = False
+        core.print_out("  Density purification is switched off with SOSCF.\n\n")
     efp_enabled = hasattr(self.molecule(), 'EFP')
 
     # does the JK algorithm use severe screening approximations for early SCF iterations?
     early_screening = self.jk().get_early_screening()
 
+    # integral-direct JK with a looser screening threshold for the early iterations (INTS_TOLERANCE_EARLY)
+    early_cutoff = hasattr(self.jk(), "has_early_cutoff") and self.jk().has_early_cutoff()
+    if early_cutoff and not early_screening:
+        early_screening = True
+        self.jk().set_early_screening(early_screening)
+
     # has early_screening changed from True to False?
     early_screening_disabled = False
 
+    # is the XC potential contracted in single precision until the density is nearly converged?
+    mixed_precision_xc = bool(self.V_potential()) and self.V_potential().mixed_precision()
+
+    # options are fixed for the duration of the iterations; look them up once rather than every cycle
+    if e_conv is None:
+        e_conv = core.get_option("SCF", "E_CONVERGENCE")
+    if d_conv is None:
+        d_conv = core.get_option("SCF", "D_CONVERGENCE")
+    maxiter = core.get_option('SCF', 'MAXITER')
+    diis_max_vecs = core.get_option('SCF', 'DIIS_MAX_VECS')
+    pcm_enabled = core.get_option('SCF', 'PCM')
+    pe_enabled = core.get_option('SCF', 'PE')
+    if pcm_enabled:
+        pcm_calc_type = core.PCM.CalcType.Total
+        if core.get_option("PCM", "PCM_SCF_TYPE") == "SEPARATE":
+            pcm_calc_type = core.PCM.CalcType.NucAndEle
+    if soscf_enabled:
+        soscf_start_convergence = core.get_option('SCF', 'SOSCF_START_CONVERGENCE')
+        soscf_options = (core.get_option('SCF', 'SOSCF_CONV'), core.get_option('SCF', 'SOSCF_MIN_ITER'),
+                         core.get_option('SCF', 'SOSCF_MAX_ITER'), core.get_option('SCF', 'SOSCF_PRINT'))
+        soscf_adaptive_conv = core.get_option('SCF', 'SOSCF_ADAPTIVE_CONV')
+        # forcing term and orbital gradient of the previous SOSCF step
+        soscf_eta = soscf_options[0]
+        soscf_gradient = None
+    level_shift = core.get_option("SCF", "LEVEL_SHIFT")
+    level_shift_cutoff = core.get_option('SCF', 'LEVEL_SHIFT_CUTOFF')
+    if damping_enabled:
+        damping_convergence = core.get_option('SCF', 'DAMPING_CONVERGENCE')
+        damping_percentage = core.get_option('SCF', "DAMPING_PERCENTAGE")
+    orbitals_write = core.get_option("SCF", "ORBITALS_WRITE") if core.has_option_changed(
+        "SCF", "ORBITALS_WRITE") else None
+    mom_start = core.get_option('SCF', "MOM_START")
+    if mixed_precision_xc:
+        mixed_precision_threshold = core.get_option('SCF', 'DFT_MIXED_PRECISION_THRESHOLD')
+
     # SCF iterations!
     SCFE_old = 0.0
     Dnorm = 0.0
@@ -294,27 +501,31 @@ def scf_iterate(self, e_conv=None, d_conv=None):
         self.clear_external_potentials()
 
         # Two-electron contribution to Fock matrix from self.jk()
+        jk_autotune = getattr(self, "_jk_autotune", None)
+        t0 = time.perf_counter()
         core.timer_on("HF: Form G")
         self.form_G()
         core.timer_off("HF: Form G")
+        # the SAD density is not representative of the builds to come
+        if jk_autotune and not ((self.iteration_ == 0) and self.sad_):
+            status_jk_autotune = _jk_autotune_step(self, time.perf_counter() - t0)
+        else:
+            status_jk_autotune = None
 
         # Check if special J/K construction algorithms were used
         incfock_performed = hasattr(self.jk(), "do_incfock_iter") and self.jk().do_incfock_iter()
         upcm = 0.0
-        if core.get_option('SCF', 'PCM'):
-            calc_type = core.PCM.CalcType.Total
-            if core.get_option("PCM", "PCM_SCF_TYPE") == "SEPARATE":
-                calc_type = core.PCM.CalcType.NucAndEle
+        if pcm_enabled:
             Dt = self.Da().clone()
             Dt.add(self.Db())
-            upcm, Vpcm = self.get_PCM().compute_PCM_terms(Dt, calc_type)
+            upcm, Vpcm = self.get_PCM().compute_PCM_terms(Dt, pcm_calc_type)
             SCFE += upcm
             self.push_back_external_potential(Vpcm)
         self.set_variable("PCM POLARIZATION ENERGY", upcm)  # P::e PCM
         self.set_energies("PCM Polarization", upcm)
 
         upe = 0.0
-        if core.get_option('SCF', 'PE'):
+        if pe_enabled:
             Dt = self.Da().clone()
             Dt.add(self.Db())
             upe, Vpe = self.pe_state.get_pe_contribution(
@@ -353,10 +564,12 @@ def scf_iterate(self, e_conv=None, d_conv=None):
         SCFE_old = SCFE
 
         status = []
+        if status_jk_autotune:
+            status.append(status_jk_autotune)
 
         # Check if we are doing SOSCF
-        if (soscf_enabled and (self.iteration_ >= 3) and (Dnorm < core.get_option('SCF', 'SOSCF_START_CONVERGENCE'))):
-            Dnorm = self.compute_orbital_gradient(False, core.get_option('SCF', 'DIIS_MAX_VECS'))
+        if (soscf_enabled and (self.iteration_ >= 3) and (Dnorm < soscf_start_convergence)):
+            Dnorm = self.compute_orbital_gradient(False, diis_max_vecs)
             diis_performed = False
             if self.functional().needs_xc():
                 base_name = "SOKS, nmicro="
@@ -364,10 +577,12 @@ def scf_iterate(self, e_conv=None, d_conv=None):
                 base_name = "SOSCF, nmicro="
 
             if not _converged(Ediff, Dnorm, e_conv=e_conv, d_conv=d_conv):
-                nmicro = self.soscf_update(core.get_option('SCF', 'SOSCF_CONV'),
-                                           core.get_option('SCF', 'SOSCF_MIN_ITER'),
-                                           core.get_option('SCF', 'SOSCF_MAX_ITER'),
-                                           core.get_option('SCF', 'SOSCF_PRINT'))
+                soscf_conv = soscf_options[0]
+                if soscf_adaptive_conv and soscf_gradient:
+                    soscf_conv = _soscf_forcing_term(soscf_conv, soscf_eta, Dnorm, soscf_gradient, d_conv)
+                soscf_eta = soscf_conv
+                soscf_gradient = Dnorm
+                nmicro = self.soscf_update(soscf_conv, *soscf_options[1:])
                 # if zero, the soscf call bounced for some reason
                 soscf_performed = (nmicro > 0)
 
@@ -404,7 +619,7 @@ def scf_iterate(self, e_conv=None, d_conv=None):
                 diis_performed = False
                 add_to_diis_subspace = self.diis_enabled_ and self.iteration_ >= self.diis_start_
 
-                Dnorm = self.compute_orbital_gradient(add_to_diis_subspace, core.get_option('SCF', 'DIIS_MAX_VECS'))
+                Dnorm = self.compute_orbital_gradient(add_to_diis_subspace, diis_max_vecs)
 
                 if add_to_diis_subspace:
                     for engine_used in self.diis(Dnorm):
@@ -419,8 +634,7 @@ def scf_iterate(self, e_conv=None, d_conv=None):
 
                 # frac, MOM invoked here from Wfn::HF::find_occupation
                 core.timer_on("HF: Form C")
-                level_shift = core.get_option("SCF", "LEVEL_SHIFT")
-                if level_shift > 0 and Dnorm > core.get_option('SCF', 'LEVEL_SHIFT_CUTOFF'):
+                if level_shift > 0 and Dnorm > level_shift_cutoff:
                     status.append("SHIFT")
                     self.form_C(level_shift)
                 else:
@@ -435,6 +649,11 @@ def scf_iterate(self, e_conv=None, d_conv=None):
 
                 if incfock_performed:
                     status.append("INCFOCK")
+                    if hasattr(self.jk(), "num_dropped_shells"):
+                        status.append("DROP={}".format(self.jk().num_dropped_shells()))
+
+                if early_cutoff and early_screening:
+                    status.append("TOL={:.0e}".format(self.jk().screening_cutoff()))
                 
                 # Reset occupations if necessary
                 if (self.iteration_ == 0) and self.reset_occ_:
@@ -450,14 +669,12 @@ def scf_iterate(self, e_conv=None, d_conv=None):
         core.set_variable("SCF D NORM", Dnorm)
 
         # After we've built the new D, damp the update
-        if (damping_enabled and self.iteration_ > 1 and Dnorm > core.get_option('SCF', 'DAMPING_CONVERGENCE')):
-            damping_percentage = core.get_option('SCF', "DAMPING_PERCENTAGE")
+        if (damping_enabled and self.iteration_ > 1 and Dnorm > damping_convergence):
             self.damping_update(damping_percentage * 0.01)
             status.append("DAMP={}%".format(round(damping_percentage)))
 
-        if core.has_option_changed("SCF", "ORBITALS_WRITE"):
-            filename = core.get_option("SCF", "ORBITALS_WRITE")
-            self.to_file(filename)
+        if orbitals_write is not None:
+            self.to_file(orbitals_write)
 
         if verbose > 3:
             self.Ca().print_out()
@@ -473,7 +690,7 @@ def scf_iterate(self, e_conv=None, d_conv=None):
 
         # if a an excited MOM is requested but not started, don't stop yet
         # Note that MOM_performed_ just checks initialization, and our convergence measures used the pre-MOM orbitals
-        if self.MOM_excited_ and ((not self.MOM_performed_) or self.iteration_ == core.get_option('SCF', "MOM_START")):
+        if self.MOM_excited_ and ((not self.MOM_performed_) or self.iteration_ == mom_start):
             continue
 
         # if a fractional occupation is requested but not started, don't stop yet
@@ -484,6 +701,22 @@ def scf_iterate(self, e_conv=None, d_conv=None):
         if early_screening_disabled:
             break
 
+        # leave single-precision XC before the final iterations, or before accepting a converged result
+        if mixed_precision_xc and not ((self.iteration_ == 0) and self.sad_) and (
+                Dnorm < mixed_precision_threshold
+                or _converged(Ediff, Dnorm, e_conv=e_conv, d_conv=d_conv)):
+            mixed_precision_xc = False
+            self.V_potential().set_mixed_precision(False)
+            core.print_out("  Switching the XC contractions to double precision.\n\n")
+            continue
+
+        # purification leaves the virtual orbitals and orbital energies stale; diagonalize for the final iteration
+        if self.purify_ and not ((self.iteration_ == 0) and self.sad_) and _converged(
+                Ediff, Dnorm, e_conv=e_conv, d_conv=d_conv):
+            self.purify_ = False
+            core.print_out("  Switching from density purification to diagonalization for the final orbitals.\n\n")
+            continue
+
         # Call any postiteration callbacks
         if not ((self.iteration_ == 0) and self.sad_) and _converged(Ediff, Dnorm, e_conv=e_conv, d_conv=d_conv):
 
@@ -506,7 +739,7 @@ def scf_iterate(self, e_conv=None, d_conv=None):
             else:
                 break
 
-        if self.iteration_ >= core.get_option('SCF', 'MAXITER'):
+        if self.iteration_ >= maxiter:
             raise SCFConvergenceError("""SCF iterations""", self.iteration_, self, Ediff, Dnorm)
 
 
@@ -684,9 +917,11 @@ def scf_finalize_energy(self):
 
     # TODO re-enable
     self.finalize()
-    if self.V_potential():
+    if self.V_potential() and not core.get_option("SCF", "DFT_COLLOCATION_CACHE_KEEP"):
         self.V_potential().clear_collocation_cache()
 
+    _release_scf_memory()
+
     core.print_out("\nComputation Completed\n")
     core.del_variable("SCF D NORM")
 
@@ -927,6 +1162,23 @@ def _validate_MOM():
     return enabled
 
 
+def _soscf_forcing_term(soscf_conv, eta_old, gradient, gradient_old, d_conv):
+    """Relative residual to which the SOSCF Newton equations are solved, following
+    Eisenstat and Walker, SIAM J. Sci. Comput. 17, 16 (1996), choice 2: the tolerance
+    tightens with the square of the reduction of the orbital gradient, so the early steps
+    are solved loosely and the later ones accurately. Never looser than |scf__soscf_conv|,
+    and never tighter than needed to bring the gradient below |scf__d_convergence|.
+
+    """
+    eta = 0.9 * (gradient / gradient_old)**2
+    # safeguard against the tolerance dropping abruptly on one lucky step
+    safeguard = 0.9 * eta_old**2
+    if safeguard > 0.1:
+        eta = max(eta, safeguard)
+    eta = min(eta, soscf_conv)
+    return max(eta, min(soscf_conv, 0.5 * d_conv / gradient))
+
+
 def _validate_soscf():
     """Sanity-checks SOSCF control options
 
@@ -986,6 +1238,6 @@ def efp_field_fn(xyz):
     matrix `efp_Dt_psi4_yo` from global namespace.
 
     """
-    points = core.Matrix.from_array(np.array(xyz).reshape(-1, 3))
-    field = mints_psi4_yo.electric_field_value(points, efp_Dt_psi4_yo).np.flatten()
+    sites = site_fields(mints_psi4_yo.basisset(), xyz)
+    field = sites.field(efp_Dt_psi4_yo).np.flatten()
     return field
@@ -17,13 +17,28 @@ def diis_engine_helper(self):
             engines.add(aediis.lower())
     return engines
 
+def _diis_storage_policy(self):
+    # In core when the memory broker granted DIIS its vectors (see scf_initialize), and, as before,
+    # always for DIRECT
+    if getattr(self, "diis_in_core_", False) or self.scf_type() == "DIRECT":
+        return StoragePolicy.InCore
+    return StoragePolicy.OnDisk
+
+def _orbital_gradient_buffers(self, n):
+    # The gradients are only read (DIIS copies them), so the same matrices serve every iteration
+    buffers = getattr(self, "_gradient_buffers", None)
+    if buffers is None or len(buffers) != n or buffers[0].rowdim() != self.nmopi():
+        buffers = [core.Matrix("FDS-SDF", self.nmopi(), self.nmopi()) for _ in range(n)]
+        self._gradient_buffers = buffers
+    return buffers
+
 def _RHF_orbital_gradient(self, save_fock: bool, max_diis_vectors: int) -> float:
-    gradient = self.form_FDSmSDF(self.Fa(), self.Da())
+    gradient, = _orbital_gradient_buffers(self, 1)
+    self.form_FDSmSDF(self.Fa(), self.Da(), gradient)
 
     if save_fock:
         if not self.initialized_diis_manager_:
-            storage_policy = StoragePolicy.InCore if self.scf_type() == "DIRECT" else StoragePolicy.OnDisk
-            self.diis_manager_ = DIIS(max_diis_vectors, "HF DIIS vector", RemovalPolicy.LargestError, storage_policy, engines=diis_engine_helper(self))
+            self.diis_manager_ = DIIS(max_diis_vectors, "HF DIIS vector", RemovalPolicy.LargestError, _diis_storage_policy(self), engines=diis_engine_helper(self))
             self.initialized_diis_manager_ = True
 
         entry = {"target": [self.Fa()]}
@@ -42,13 +57,14 @@ def _RHF_orbital_gradient(self, save_fock: bool, max_diis_vectors: int) -> float
         return gradient.absmax()
 
 def _UHF_orbital_gradient(self, save_fock: bool, max_diis_vectors: int) -> float:
-    gradient_a = self.form_FDSmSDF(self.Fa(), self.Da())
-    gradient_b = self.form_FDSmSDF(self.Fb(), self.Db())
+    gradient_a, gradient_b = _orbital_gradient_buffers(self, 2)
+    self.form_FDSmSDF(self.Fa(), self.Da(), gradient_a)
+    self.form_FDSmSDF(self.Fb(), self.Db(), gradient_b)
 
     if save_fock:
         if not self.initialized_diis_manager_:
             self.diis_manager_ = DIIS(max_diis_vectors, "HF DIIS vector", RemovalPolicy.LargestError,
-                                                          StoragePolicy.OnDisk, False, engines=diis_engine_helper(self))
+                                                          _diis_storage_policy(self), False, engines=diis_engine_helper(self))
             self.initialized_diis_manager_ = True
 
         entry = {"target": [self.Fa(), self.Fb()]}
@@ -94,7 +110,7 @@ def _ROHF_orbital_gradient(self, save_fock: bool, max_diis_vectors: int) -> floa
 
     if save_fock:
         if not self.initialized_diis_manager_:
-            self.diis_manager_ = DIIS(max_diis_vectors, "HF DIIS vector", RemovalPolicy.LargestError, StoragePolicy.OnDisk, engines=diis_engine_helper(self))
+            self.diis_manager_ = DIIS(max_diis_vectors, "HF DIIS vector", RemovalPolicy.LargestError, _diis_storage_policy(self), engines=diis_engine_helper(self))
             self.diis_manager_.set_error_vector_size(gradient)
             self.diis_manager_.set_vector_size(self.soFeff())
             self.initialized_diis_manager_ = True
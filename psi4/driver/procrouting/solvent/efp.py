@@ -30,6 +30,9 @@ import numpy as np
 
 from psi4 import core
 
+# SiteFields of the last basis set and sites seen by site_fields()
+_site_fields_cache = {}
+
 
 def get_qm_atoms_opts(mol):
     """Provides list of coordinates of quantum mechanical atoms from
@@ -63,6 +66,22 @@ def get_qm_atoms_opts(mol):
     return ptc, coords, opts
 
 
+def site_fields(basisset, xyz):
+    """Returns a :py:class:`psi4.core.SiteFields` for the points `xyz`
+    (npt, 3), reusing the previous one while the basis set and the points
+    are unchanged, as they are across the SCF and induction iterations of
+    one geometry.
+
+    """
+    xyz = np.asarray(xyz, dtype=float).reshape(-1, 3)
+    cached = _site_fields_cache.get('sites')
+    if (cached is None or _site_fields_cache['basisset'] is not basisset
+            or not np.array_equal(_site_fields_cache['xyz'], xyz)):
+        cached = core.SiteFields(basisset, core.Matrix.from_array(xyz))
+        _site_fields_cache.update({'sites': cached, 'basisset': basisset, 'xyz': xyz})
+    return cached
+
+
 def modify_Fock_permanent(mol, mints, verbose=1):
     """Computes array of the EFP contribution to the potential felt by
     QM atoms due to permanent EFP moments. Used for SCF procedure.
@@ -163,6 +182,6 @@ def modify_Fock_induced(efpobj, mints, verbose=1):
     val_id = (val_id + val_idt) * 0.5
 
     # EFP induced dipole contribution to the Fock Matrix
-    coords = core.Matrix.from_array(xyz_id)
-    V_ind = mints.induction_operator(coords, core.Matrix.from_array(val_id)).np
+    sites = site_fields(mints.basisset(), xyz_id)
+    V_ind = sites.induction_operator(core.Matrix.from_array(val_id)).np
     return V_ind
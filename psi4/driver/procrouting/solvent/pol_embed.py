@@ -123,6 +123,8 @@ class CppeInterface:
             self._enable_induction = True
             coords = self.cppe_state.positions_polarizable
             self.polarizable_coords = core.Matrix.from_array(coords)
+            # screening at the sites is set up once for all induction iterations
+            self.site_fields = core.SiteFields(self.basisset, self.polarizable_coords)
         self.V_es = None
         if self.pe_ecp:
             self._setup_pe_ecp()
@@ -167,13 +169,13 @@ class CppeInterface:
         V_pe = np.zeros((n_bas, n_bas))
         if self._enable_induction:
             # obtain expectation values of elec. field at polarizable sites
-            elec_fields = self.mints.electric_field_value(self.polarizable_coords, density_matrix).np
+            elec_fields = self.site_fields.field(density_matrix).np
             # solve induced moments
             self.cppe_state.update_induced_moments(elec_fields.flatten(), elec_only)
             induced_moments = np.array(self.cppe_state.get_induced_moments()).reshape(self.polarizable_coords.shape)
 
             # build induction operator
-            V_ind = self.mints.induction_operator(self.polarizable_coords, core.Matrix.from_array(induced_moments)).np
+            V_ind = self.site_fields.induction_operator(core.Matrix.from_array(induced_moments)).np
             V_pe += V_ind
         # only take electronic contributions into account
         if elec_only:
@@ -184,6 +184,7 @@ PSIF_DCC_R2                 =  264  # CEPA/CC residual
 PSIF_DCC_TEMP               =  265  # CEPA/CC temporary storage
 PSIF_DCC_T2                 =  266  # CEPA/CC t2 amplitudes
 PSIF_DCC_QSO                =  267  # DFCC 3-index integrals
+PSIF_DCC_TRIPLES            =  268  # CEPA/CC (T) checkpoint
 PSIF_DCC_SORT_START         =  270  # CEPA/CC integral sort starting file number
 PSIF_SAPT_CCD               =  271  # SAPT2+ CCD Utility File
 PSIF_HESS                   =  272  # Hessian Utility File
@@ -28,6 +28,7 @@
 
 import os
 import sys
+import copy
 import hashlib
 import warnings
 import itertools
@@ -36,7 +37,6 @@ import collections
 import qcelemental as qcel
 
 from .exceptions import *
-from .psiutil import search_file
 from .molecule import Molecule
 from .libmintsgshell import ShellInfo
 from .libmintsbasissetparser import Gaussian94BasisSetParser
@@ -45,6 +45,60 @@ from .basislist import corresponding_basis, corresponding_zeta
 
 basishorde = {}
 
+# Contents and parsed atom entries of basis set files, kept for the life of the process so that
+# repeated constructions (e.g., a loop over many molecules) read and parse each file entry once.
+# Keyed on path, modification time, and size so an edited file is reread.
+_gbs_file_cache = {}
+_gbs_entry_cache = {}
+# Atom labels with an entry in each cached file, so that a label missing from a file (the common case
+# of trying 'H1' before 'H', or a fallback basis) is answered without scanning the file.
+_gbs_symbols_cache = {}
+# Listings of the basis directories, so that finding a file on the search path is a set lookup per
+# directory. Keyed on directory and its modification time so that added files are seen.
+_gbs_dir_cache = {}
+
+
+def _find_gbs_file(filename, search_path):
+    """Return the full path of the first *filename* along the os.pathsep separated *search_path*, else None."""
+    for path in search_path.split(os.pathsep):
+        try:
+            stamp = os.stat(path or os.curdir).st_mtime_ns
+        except OSError:
+            continue
+        listing = _gbs_dir_cache.get(path)
+        if listing is None or listing[0] != stamp:
+            listing = (stamp, frozenset(os.listdir(path or os.curdir)))
+            _gbs_dir_cache[path] = listing
+        if filename in listing[1]:
+            return os.path.abspath(os.path.join(path, filename))
+    return None
+
+
+def _load_gbs_file(parser, fullfilename):
+    """Return the lines of basis file *fullfilename* and the key identifying this version of it."""
+    stamp = os.stat(fullfilename)
+    filekey = (fullfilename, stamp.st_mtime_ns, stamp.st_size)
+    if filekey not in _gbs_file_cache:
+        _gbs_file_cache[filekey] = parser.load_file(fullfilename)
+    parser.filename = fullfilename
+    return _gbs_file_cache[filekey], filekey
+
+
+def _parse_gbs_entry(parser, entry, lines, filekey):
+    """Parse *entry* out of *lines* with *parser*, reusing an earlier parse of the same file entry."""
+    if filekey is None:
+        return parser.parse(entry, lines)
+    if filekey not in _gbs_symbols_cache:
+        _gbs_symbols_cache[filekey] = parser.entry_symbols(lines)
+    if entry.upper() not in _gbs_symbols_cache[filekey]:
+        return None, None, None, None, None
+    key = (filekey, entry, parser.force_puream_or_cartesian, parser.forced_is_puream)
+    if key not in _gbs_entry_cache:
+        _gbs_entry_cache[key] = parser.parse(entry, lines)
+    # hand out copies so no caller can alter the cached shells
+    return copy.deepcopy(_gbs_entry_cache[key])
+
+
 class BasisSet(object):
     """Basis set container class
     Reads the basis set from a checkpoint file object. Also reads the molecule
@@ -795,6 +849,7 @@ class BasisSet(object):
         ecp_atom_basis_shell = collections.OrderedDict()
         ecp_atom_basis_ncore = collections.OrderedDict()
         names = {}
+        filekeys = {}
         summary = []
         bastitles = []
 
@@ -864,23 +919,24 @@ class BasisSet(object):
                     # Store contents
                     if index not in names:
                         names[index] = basstrings[filename[:-4]].split('\n')
+                        filekeys[index] = None
                 else:
                     # -- Else seek bas.gbs file in path
-                    fullfilename = search_file(_basis_file_warner_and_aliaser(filename), seek['path'])
+                    fullfilename = _find_gbs_file(_basis_file_warner_and_aliaser(filename), seek['path'])
                     if fullfilename is None:
                         # -- Else skip to next bas
                         continue
                     # Store contents so not reloading files
                     index = 'file %s' % (fullfilename)
                     if index not in names:
-                        names[index] = parser.load_file(fullfilename)
+                        names[index], filekeys[index] = _load_gbs_file(parser, fullfilename)
 
                 lines = names[index]
 
                 for entry in seek['entry']:
 
                     # Seek entry in lines, else skip to next entry
-                    shells, msg, ecp_shells, ecp_msg, ecp_ncore = parser.parse(entry, lines)
+                    shells, msg, ecp_shells, ecp_msg, ecp_ncore = _parse_gbs_entry(parser, entry, lines, filekeys[index])
                     if shells is None:
                         continue
 
@@ -33,6 +33,11 @@ import sys
 from .exceptions import *
 from .libmintsgshell import *
 
+# match 'C 0', 'Al c 0', 'P p88 p_pass 0' not 'Ofail 0', 'h99_text 0'
+_ATOM = r'(([A-Z]{1,3}\d*)|([A-Z]{1,3}_\w+))'
+# array of atomic symbols terminated by 0
+_atom_array = re.compile(r'^\s*((' + _ATOM + r'\s+)+)0\s*$', re.IGNORECASE)
+
 
 class Gaussian94BasisSetParser(object):
     """Class for parsing basis sets from a text file in Gaussian 94
@@ -95,6 +100,19 @@ class Gaussian94BasisSetParser(object):
 
         return lines
 
+    @staticmethod
+    def entry_symbols(lines):
+        """Return the set of (uppercase) atom labels that head an entry in *lines*,
+        i.e., those for which :py:meth:`parse` can find anything.
+
+        """
+        symbols = set()
+        for line in lines:
+            what = _atom_array.match(line)
+            if what:
+                symbols.update(x.upper() for x in what.group(1).split())
+        return symbols
+
     def parse(self, symbol, dataset):
         """Given a string, parse for the basis set needed for atom.
         * @param symbol atom symbol to look for in dataset
@@ -112,8 +130,8 @@ class Gaussian94BasisSetParser(object):
         spherical = re.compile(r'^\s*spherical\s*$', re.IGNORECASE)
         comment = re.compile(r'^\s*\!.*')  # line starts with !
         separator = re.compile(r'^\s*\*\*\*\*\s*$')  # line starts with ****
-        ATOM = r'(([A-Z]{1,3}\d*)|([A-Z]{1,3}_\w+))'  # match 'C 0', 'Al c 0', 'P p88 p_pass 0' not 'Ofail 0', 'h99_text 0'
-        atom_array = re.compile(r'^\s*((' + ATOM + r'\s+)+)0\s*$', re.IGNORECASE)  # array of atomic symbols terminated by 0
+        ATOM = _ATOM
+        atom_array = _atom_array
         atom_ecp = re.compile(r'^\s*((' + ATOM + r'-ECP\s+)+)(\d+)\s+(\d+)\s*$', re.IGNORECASE)  # atom_ECP number number
         shell = re.compile(r'^\s*(\w+|L=\d+)\s*(\d+)\s*(-?\d+\.\d+)\s*$')  # Match beginning of contraction
         blank_line = re.compile(r'^\s*$')
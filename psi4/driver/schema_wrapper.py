@@ -32,21 +32,28 @@ Runs a JSON input psi file.
 __all__ = [
     "run_json",
     "run_qcschema",
+    "run_qcschema_batch",
 ]
 
 import atexit
+import concurrent.futures
 import copy
 import datetime
+import glob
 import json
+import multiprocessing
+import multiprocessing.util
 import os
 import pprint
+import shutil
 import sys
+import tempfile
 import traceback
 import uuid
 import warnings
 from collections import defaultdict
 from pathlib import Path
-from typing import Any, Dict, Union
+from typing import Any, Dict, Iterable, Iterator, Tuple, Union
 
 import numpy as np
 import qcelemental as qcel
@@ -487,6 +494,112 @@ def run_qcschema(
     return ret
 
 
+def _batch_worker_init(memory: int, nthread: int, scratch: str):
+    """Set up a worker process of :py:func:`run_qcschema_batch` once, with its own scratch directory."""
+
+    core.set_memory_bytes(memory, quiet=True)
+    core.set_num_threads(nthread, quiet=True)
+    worker_scratch = tempfile.mkdtemp(prefix="psi4_batch_", dir=scratch)
+    core.IOManager.shared_object().set_default_path(worker_scratch)
+    # pool workers leave through multiprocessing, which skips atexit
+    multiprocessing.util.Finalize(None, shutil.rmtree, args=(worker_scratch, ), kwargs={"ignore_errors": True},
+                                  exitpriority=0)
+
+
+def _batch_worker_run(input_data: Union[Dict[str, Any], qcel.models.AtomicInput]):
+    """Run one task of :py:func:`run_qcschema_batch` in a worker process."""
+
+    ret = run_qcschema(input_data, clean=True, postclean=False)
+
+    # the output is absorbed into the result; a long-lived worker must not collect files until exit
+    scratch = core.IOManager.shared_object().get_default_path()
+    for outfile in glob.glob(os.path.join(scratch, "*.qcschema_tmpout")):
+        _quiet_remove(outfile)
+    return ret
+
+
+def run_qcschema_batch(
+    inputs: Iterable[Union[Dict[str, Any], qcel.models.AtomicInput]],
+    workers: int = 1,
+    clean: bool = True,
+    postclean: bool = True,
+) -> Iterator[Tuple[int, Union[qcel.models.AtomicResult, qcel.models.FailedOperation]]]:
+    """Run a stream of quantum chemistry jobs in |PSIfour|, yielding results as they finish.
+
+    Each job is run as by :py:func:`run_qcschema`, with options, QCVariables, and scratch
+    files reset between jobs. With more than one worker, the jobs run concurrently in that
+    many long-lived Psi4 processes, each importing Psi4 once and keeping its own scratch
+    directory; the threads and memory of this process are split evenly over the workers.
+    Jobs are handed out as workers free up, so *inputs* may be a generator. Workers are
+    started with ``spawn``, so a calling script needs an ``if __name__ == "__main__":`` guard.
+
+    Parameters
+    ----------
+    inputs
+        Quantum chemistry jobs in either AtomicInput class or dictionary form.
+    workers
+        Number of concurrent worker processes. With 1, the jobs run one after another in
+        this process.
+    clean
+        With one worker, passed to :py:func:`run_qcschema`. Worker processes always clean.
+    postclean
+        With one worker, passed to :py:func:`run_qcschema`.
+
+    Yields
+    ------
+    Tuple[int, Union[qcelemental.models.AtomicResult, qcelemental.models.FailedOperation]]
+        Position of the job in *inputs* and its record, in order of completion.
+
+    """
+    if workers <= 1:
+        for index, input_data in enumerate(inputs):
+            yield index, run_qcschema(input_data, clean=clean, postclean=postclean)
+        return
+
+    memory = core.get_memory() // workers
+    nthread = max(1, core.get_num_threads() // workers)
+    scratch = core.IOManager.shared_object().get_default_path()
+
+    # spawn, since a forked child would inherit the OpenMP and PSIO state of this process
+    context = multiprocessing.get_context("spawn")
+    with concurrent.futures.ProcessPoolExecutor(max_workers=workers,
+                                                mp_context=context,
+                                                initializer=_batch_worker_init,
+                                                initargs=(memory, nthread, scratch)) as pool:
+        stream = enumerate(inputs)
+        pending = {}
+
+        def submit_next():
+            for index, input_data in stream:
+                pending[pool.submit(_batch_worker_run, input_data)] = (index, input_data)
+                return True
+            return False
+
+        # keep two jobs queued per worker so that none idles between jobs
+        for _ in range(2 * workers):
+            if not submit_next():
+                break
+
+        while pending:
+            done, _ = concurrent.futures.wait(pending, return_when=concurrent.futures.FIRST_COMPLETED)
+            for future in done:
+                index, input_data = pending.pop(future)
+                try:
+                    ret = future.result()
+                except Exception as exc:
+                    # the worker itself died; run_qcschema reports failures of the job
+                    if not isinstance(input_data, dict):
+                        input_data = input_data.dict()
+                    ret = qcel.models.FailedOperation(input_data=input_data,
+                                                      success=False,
+                                                      error={
+                                                          'error_type': type(exc).__name__,
+                                                          'error_message': str(exc),
+                                                      })
+                submit_next()
+                yield index, ret
+
+
 def run_json(json_data: Dict[str, Any], clean: bool = True) -> Dict[str, Any]:
 
     warnings.warn(
@@ -30,11 +30,16 @@ __all__ = [
     "AtomicComputer",
     "BaseComputer",
     "EnergyGradientHessianWfnReturn",
+    "compute_tasks",
 ]
 
 import abc
+import concurrent.futures
 import copy
+import hashlib
+import json
 import logging
+import os
 from typing import Any, Dict, Optional, Tuple, Union, TYPE_CHECKING
 
 from pydantic import Field, validator
@@ -42,6 +47,7 @@ import qcelemental as qcel
 from qcelemental.models import DriverEnum, AtomicInput, AtomicResult
 qcel.models.molecule.GEOMETRY_NOISE = 13  # need more precision in geometries for high-res findif
 import qcengine as qcng
+from qcengine.exceptions import InputError, ResourceError
 
 from psi4 import core
 
@@ -52,6 +58,10 @@ logger = logging.getLogger(__name__)
 
 EnergyGradientHessianWfnReturn = Union[float, core.Matrix, Tuple[Union[float, core.Matrix], core.Wavefunction]]
 
+# Keywords that steer how a task runs but not what it computes, left out of AtomicComputer.task_hash()
+_unhashed_keywords = ["scf__orbitals_guess_file", "task_cache", "task_workers"]
+_unhashed_function_kwargs = ["write_orbitals"]
+
 
 class BaseComputer(qcel.models.ProtoModel):
     """Base class for "computers" that plan, run, and process QC tasks."""
@@ -97,9 +107,15 @@ class AtomicComputer(BaseComputer):
     def set_keywords(cls, keywords):
         return copy.deepcopy(keywords)
 
-    def plan(self) -> AtomicInput:
-        """Form QCSchema input from member data."""
+    def plan(self, psiapi: bool = True) -> AtomicInput:
+        """Form QCSchema input from member data.
+
+        Parameters
+        ----------
+        psiapi
+            Whether QCEngine runs the task in this process (True) or in a separate Psi4 process (False).
 
+        """
         atomic_model = AtomicInput(**{
             "molecule": self.molecule.to_schema(dtype=2),
             "driver": self.driver,
@@ -112,17 +128,64 @@ class AtomicComputer(BaseComputer):
                 "stdout": True,
             },
             "extras": {
-                "psiapi": True,
+                "psiapi": psiapi,
                 "wfn_qcvars_only": True,
             },
         })
 
         return atomic_model
 
+    def task_hash(self) -> str:
+        """Hash of what the task computes: molecule (including ghosts and charges), driver, method,
+        basis, and keywords. Tasks with the same hash have the same result."""
+
+        keywords = {k: v for k, v in self.keywords.items() if k.lower() not in _unhashed_keywords}
+        if "function_kwargs" in keywords:
+            keywords["function_kwargs"] = {
+                k: v
+                for k, v in keywords["function_kwargs"].items() if k not in _unhashed_function_kwargs
+            }
+
+        content = {
+            "molecule": qcel.models.Molecule(**self.molecule.to_schema(dtype=2)).get_hash(),
+            "driver": self.driver.value,
+            "method": self.method,
+            "basis": self.basis,
+            "keywords": keywords,
+        }
+        return hashlib.sha1(json.dumps(content, sort_keys=True, default=str).encode()).hexdigest()
+
+    def _load_cached(self) -> bool:
+        """Take the result from the TASK_CACHE directory, if it holds one for this task."""
+
+        fname = _task_cache_file(self)
+        if fname is None or not os.path.isfile(fname):
+            return False
+        try:
+            self.result = AtomicResult.parse_file(fname)
+        except Exception:
+            logger.warning(f"Ignoring unreadable cached result {fname}")
+            return False
+
+        core.print_out(f"\n  Reusing the cached result {fname}\n")
+        self.computed = True
+        return True
+
+    def _store_cached(self):
+        """Write the result to the TASK_CACHE directory, if one is set."""
+
+        fname = _task_cache_file(self)
+        if fname is None or not self.result.success:
+            return
+        os.makedirs(os.path.dirname(fname), exist_ok=True)
+        # through a temporary file, so concurrent jobs sharing the cache never read half a result
+        tmp = f"{fname}.{os.getpid()}.tmp"
+        with open(tmp, "w") as fp:
+            fp.write(self.result.json())
+        os.replace(tmp, fname)
+
     def compute(self, client: Optional["qcportal.client.FractalClient"] = None):
         """Run quantum chemistry."""
-        from psi4.driver import pp
-
         if self.computed:
             return
 
@@ -156,6 +219,9 @@ class AtomicComputer(BaseComputer):
 
             return
 
+        if self._load_cached():
+            return
+
         logger.info(f'<<< JSON launch ... {self.molecule.schoenflies_symbol()} {self.molecule.nuclear_repulsion_energy()}')
         gof = core.get_output_file()
 
@@ -181,6 +247,27 @@ class AtomicComputer(BaseComputer):
         #print("... JSON returns >>>")
         core.set_output_file(gof, True)
         core.reopen_outfile()
+        self._finish()
+        self._store_cached()
+
+    def _compute_subprocess(self, memory: float, ncores: int, scratch: str) -> AtomicResult:
+        """Run quantum chemistry in a separate Psi4 process with `memory` GiB and `ncores` threads.
+        Thread-safe: touches neither the options nor the output file of this process."""
+
+        return qcng.compute(
+            self.plan(psiapi=False),
+            "psi4",
+            raise_error=True,
+            task_config={
+                "memory": memory,
+                "ncores": ncores,
+                "scratch_directory": scratch,
+            },
+        )
+
+    def _finish(self):
+        from psi4.driver import pp
+
         logger.debug(pp.pformat(self.result.dict()))
         core.print_out(_drink_filter(self.result.dict()["stdout"]))
         self.computed = True
@@ -201,6 +288,85 @@ class AtomicComputer(BaseComputer):
             return self.result
 
 
+def _task_cache_file(task: AtomicComputer) -> Optional[str]:
+    """File of the result of *task* in the TASK_CACHE directory, or None when there is no cache."""
+
+    directory = core.get_global_option("TASK_CACHE")
+    if not directory:
+        return None
+    return os.path.join(os.path.abspath(os.path.expanduser(directory)), task.task_hash() + ".json")
+
+
+def _task_cost(task) -> int:
+    """Rough relative cost of a task for scheduling, from the number of atoms including ghosts."""
+
+    try:
+        return task.molecule.natom()
+    except AttributeError:
+        return 0
+
+
+def compute_tasks(tasks, client: Optional["qcportal.FractalClient"] = None):
+    """Run the tasks of a finite-difference or many-body computer.
+
+    Without a QCFractal `client` and with the TASK_WORKERS option other than 1, the
+    :py:class:`AtomicComputer` tasks run concurrently as separate Psi4 processes. The
+    threads and memory of this job are split evenly over the workers, and the tasks are
+    started largest first so the last ones to finish are small. Other tasks, and all tasks
+    when Psi4 cannot be run as a separate process, run one after another in this process.
+
+    Tasks already in the TASK_CACHE directory are not run again. A task object listed more
+    than once, as after deduplication by the task planner, runs once.
+
+    """
+    tasks = list(tasks)
+    atomic, seen = [], set()
+    for t in tasks:
+        if isinstance(t, AtomicComputer) and not t.computed and id(t) not in seen:
+            seen.add(id(t))
+            if client is None and t._load_cached():
+                continue
+            atomic.append(t)
+
+    nthread = core.get_num_threads()
+    workers = core.get_global_option("TASK_WORKERS")
+    if workers < 1:
+        min_memory = 500 * 2**20
+        workers = max(1, min(nthread, core.get_memory() // min_memory))
+    workers = min(workers, len(atomic))
+
+    if client is None and workers > 1:
+        try:
+            qcng.get_program("psi4")
+        except (InputError, ResourceError):
+            core.print_out("  Warning: Psi4 cannot be run as a separate process; running the tasks one by one.\n")
+            workers = 1
+
+    if client or workers <= 1:
+        for t in tasks:
+            t.compute(client=client)
+        return
+
+    memory = core.get_memory() / workers / 2**30
+    ncores = max(1, nthread // workers)
+    scratch = core.IOManager.shared_object().get_default_path()
+    core.print_out(f"  Running {len(atomic)} tasks on {workers} workers, {ncores} threads and {memory:.2f} GiB each.\n")
+
+    atomic.sort(key=_task_cost, reverse=True)
+    with concurrent.futures.ThreadPoolExecutor(max_workers=workers) as pool:
+        futures = {pool.submit(t._compute_subprocess, memory, ncores, scratch): t for t in atomic}
+        # Output and bookkeeping stay on this thread
+        for future in concurrent.futures.as_completed(futures):
+            t = futures[future]
+            t.result = future.result()
+            t._finish()
+            t._store_cached()
+
+    for t in tasks:
+        if not isinstance(t, AtomicComputer):
+            t.compute(client=client)
+
+
 def _drink_filter(stdout: str) -> str:
     """Don't mess up the widespread ``grep beer`` test of Psi4 doneness by printing multiple drinks per outfile."""
 
@@ -118,8 +118,58 @@ def task_planner(driver: DriverEnum, method: str, molecule: core.Molecule, **kwa
     -------
     Union[AtomicComputer, CompositeComputer, FiniteDifferenceComputer, ManyBodyComputer]
         A simple (:class:`~psi4.driver.AtomicComputer`) or layered (:class:`~psi4.driver.driver_cbs.CompositeComputer`, :class:`~psi4.driver.driver_findif.FiniteDifferenceComputer`, :class:`~psi4.driver.driver_nbody.ManyBodyComputer`) task object. Layered objects contain many and multiple types of computers in a graph.
+        Within the graph, atomic tasks with the same inputs are one shared object (see :func:`deduplicate_tasks`).
 
     """
+    plan = _task_planner(driver, method, molecule, **kwargs)
+    deduplicate_tasks(plan)
+    return plan
+
+
+def deduplicate_tasks(plan: TaskComputers) -> int:
+    """Make every :class:`~psi4.driver.AtomicComputer` in the task graph of *plan* with the same
+    :meth:`~psi4.driver.AtomicComputer.task_hash` one shared object, so that it runs once. For
+    example, the monomers of several BSSE treatments or the SCF of several CBS stages.
+
+    Returns
+    -------
+    int
+        Number of duplicate tasks removed.
+
+    """
+    unique = {}
+    nduplicate = 0
+
+    def visit(computer):
+        nonlocal nduplicate
+        task_list = getattr(computer, "task_list", None)
+        if isinstance(task_list, dict):
+            keys = list(task_list.keys())
+        elif isinstance(task_list, list):
+            keys = range(len(task_list))
+        else:
+            return
+
+        for k in keys:
+            task = task_list[k]
+            if not isinstance(task, AtomicComputer):
+                visit(task)
+                continue
+            first = unique.setdefault(task.task_hash(), task)
+            if first is not task:
+                task_list[k] = first
+                nduplicate += 1
+
+    visit(plan)
+    if nduplicate:
+        info = f"  Task planner: {nduplicate} duplicate tasks share the result of an identical task.\n"
+        core.print_out(info)
+        logger.info(info)
+    return nduplicate
+
+
+def _task_planner(driver: DriverEnum, method: str, molecule: core.Molecule, **kwargs) -> TaskComputers:
+    """Plans the task graph for :func:`task_planner`, which takes the same arguments."""
 
     # Only pull the changed options
     keywords = p4util.prepare_options_for_set_options()
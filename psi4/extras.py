@@ -270,7 +270,8 @@ def set_output_file(ofile: str, append: bool = False, *, loglevel: int = 20, exe
 
     # Create handlers, add formatters to handlers, and add handlers to logger (StreamHandler() also available)
     filemode = "a" if append else "w"
-    f_handler = logging.FileHandler(log, filemode)
+    # with several MPI ranks running the same input, only rank 0 writes the output and log files
+    f_handler = logging.FileHandler(log if core.mpi_rank() == 0 else os.devnull, filemode)
     f_handler.setLevel(logging.DEBUG)
     f_handler.setFormatter(f_format_detailed)
 
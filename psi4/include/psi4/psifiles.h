@@ -250,6 +250,7 @@
 #define PSIF_DCC_TEMP            265  /*- CEPA/CC temporary storage -*/
 #define PSIF_DCC_T2              266  /*- CEPA/CC t2 amplitudes -*/
 #define PSIF_DCC_QSO             267  /*- DFCC 3-index integrals -*/
+#define PSIF_DCC_TRIPLES         268  /*- CEPA/CC (T) checkpoint -*/
 #define PSIF_DCC_SORT_START      270  /*- CEPA/CC integral sort starting file number -*/
 
 #define PSIF_SAPT_CCD            271  /*- SAPT2+ CCD Utility File -*/
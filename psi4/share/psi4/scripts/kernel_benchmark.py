@@ -0,0 +1,243 @@
+#!/usr/bin/env python
+
+"""Time the production JK, XC, DF, and DPD kernels on generated systems.
+
+Water clusters of increasing size are built on a cubic lattice, and each
+kernel is run on them the way the SCF and correlated codes drive it:
+
+    jk:<type>     JK.compute() for DIRECT, MEM_DF, DISK_DF, COSX, and LINK
+    v:compute_V   RV.compute_V() for B3LYP
+    v:compute_Vx  RV.compute_Vx() for B3LYP
+    dfh:transform DFHelper.transform() of an (i,a) pair space
+    dpd:*         contract444, buf4_sort, and buf4 PSIO traffic
+                  (psi4.core.benchmark_dpd)
+
+Set-up (integrals, grids, AO tensors) is timed separately from the repeated
+kernel call. Results are written as JSON; pass an earlier JSON file to
+``--compare`` to flag kernels that got slower.
+
+    python kernel_benchmark.py -n 8 --memory "16 GB" --json run.json
+    python kernel_benchmark.py -n 8 --memory "16 GB" --compare run.json
+
+"""
+
+import sys
+import json
+import time
+import argparse
+import platform
+
+if sys.version_info <= (3, 0):
+    print('Much of this script needs py3')
+    sys.exit()
+
+jk_types = ['DIRECT', 'MEM_DF', 'DISK_DF', 'COSX', 'LINK']
+kernels = ['jk', 'v', 'dfh', 'dpd']
+
+
+def water_cluster(nwater):
+    """Waters on a cubic lattice with 3 A spacing, as a psi4 geometry string."""
+
+    side = 1
+    while side**3 < nwater:
+        side += 1
+
+    lines = []
+    for n in range(nwater):
+        x, y, z = 3.0 * (n % side), 3.0 * ((n // side) % side), 3.0 * (n // side**2)
+        lines.append('O  %10.6f %10.6f %10.6f' % (x, y, z))
+        lines.append('H  %10.6f %10.6f %10.6f' % (x + 0.757, y + 0.586, z))
+        lines.append('H  %10.6f %10.6f %10.6f' % (x - 0.757, y + 0.586, z))
+    lines += ['units angstrom', 'symmetry c1', 'no_reorient', 'no_com']
+    return '\n'.join(lines)
+
+
+def time_call(fn, min_time):
+    """Seconds per call of fn, repeated for at least min_time seconds."""
+
+    rounds = 0
+    t0 = time.perf_counter()
+    while True:
+        fn()
+        rounds += 1
+        elapsed = time.perf_counter() - t0
+        if elapsed >= min_time:
+            return elapsed / rounds, rounds
+
+
+def orbitals(psi4, basis, nocc):
+    """Orthonormal random occupied and virtual coefficients, reproducible from run to run."""
+
+    import numpy as np
+
+    nbf = basis.nbf()
+    rng = np.random.default_rng(0)
+    q, _ = np.linalg.qr(rng.standard_normal((nbf, nbf)))
+    return psi4.core.Matrix.from_array(q[:, :nocc]), psi4.core.Matrix.from_array(q[:, nocc:])
+
+
+def bench_jk(psi4, mol, basis, Cocc, args):
+    cases = []
+    for jk_type in args.jk_types:
+        aux = psi4.core.BasisSet.zero_ao_basis_set()
+        if jk_type != 'DIRECT':
+            aux = psi4.core.BasisSet.build(mol, 'DF_BASIS_SCF', '', 'JKFIT', args.basis)
+        psi4.core.set_global_option('SCF_TYPE', jk_type)
+
+        t0 = time.perf_counter()
+        jk = psi4.core.JK.build_JK(basis, aux)
+        jk.set_memory(args.doubles)
+        jk.initialize()
+        setup = time.perf_counter() - t0
+
+        jk.C_left_add(Cocc)
+        seconds, calls = time_call(jk.compute, args.min_time)
+        jk.C_clear()
+        cases.append({'kernel': 'jk:' + jk_type, 'setup': setup, 'seconds': seconds, 'calls': calls})
+        del jk
+    psi4.core.revoke_global_option_changed('SCF_TYPE')
+    return cases
+
+
+def bench_v(psi4, basis, Cocc, args):
+    from psi4.driver.procrouting.dft import build_superfunctional
+
+    sup = build_superfunctional('b3lyp', True, deriv=2)[0]
+
+    t0 = time.perf_counter()
+    V = psi4.core.VBase.build(basis, sup, 'RV')
+    V.initialize()
+    setup = time.perf_counter() - t0
+
+    D = psi4.core.doublet(Cocc, Cocc, False, True)
+    V.set_D([D])
+    Vmat = psi4.core.Matrix(basis.nbf(), basis.nbf())
+    seconds, calls = time_call(lambda: V.compute_V([Vmat]), args.min_time)
+    cases = [{'kernel': 'v:compute_V', 'setup': setup, 'seconds': seconds, 'calls': calls}]
+
+    Dx = psi4.core.Matrix(basis.nbf(), basis.nbf())
+    Dx.copy(D)
+    Dx.scale(0.1)
+    seconds, calls = time_call(lambda: V.compute_Vx([Dx], [Vmat]), args.min_time)
+    cases.append({'kernel': 'v:compute_Vx', 'setup': 0.0, 'seconds': seconds, 'calls': calls})
+    V.finalize()
+    return cases
+
+
+def bench_dfh(psi4, mol, basis, Cocc, Cvir, args):
+    aux = psi4.core.BasisSet.build(mol, 'DF_BASIS_MP2', '', 'RIFIT', args.basis)
+
+    t0 = time.perf_counter()
+    dfh = psi4.core.DFHelper(basis, aux)
+    dfh.set_memory(args.doubles)
+    dfh.set_method('STORE')
+    dfh.set_nthreads(args.nthread)
+    dfh.initialize()
+    dfh.add_space('i', Cocc)
+    dfh.add_space('a', Cvir)
+    dfh.add_transformation('iaQ', 'i', 'a', 'pqQ')
+    setup = time.perf_counter() - t0
+
+    seconds, calls = time_call(dfh.transform, args.min_time)
+    return [{'kernel': 'dfh:transform', 'naux': aux.nbf(), 'setup': setup, 'seconds': seconds, 'calls': calls}]
+
+
+def bench_dpd(psi4, args):
+    cases = []
+    for kernel, o, v, seconds, rate in psi4.core.benchmark_dpd(args.dpd_dim, args.min_time):
+        cases.append({'kernel': 'dpd:' + kernel.lower(), 'system': 'o%d-v%d' % (o, v), 'seconds': seconds, 'rate': rate})
+    return cases
+
+
+def compare(cases, reference, threshold):
+    """Print the kernels whose time per call grew by more than threshold relative to reference."""
+
+    ref = {(c['kernel'], c['system']): c for c in reference['cases']}
+    nslow = 0
+    for case in cases:
+        old = ref.get((case['kernel'], case['system']))
+        if old is None:
+            continue
+        # ignore kernels too short to time reliably
+        if old['seconds'] < 1.0e-3:
+            continue
+        if case['seconds'] / old['seconds'] > 1.0 + threshold:
+            nslow += 1
+            print('  SLOWER  %-16s %-16s %12.6f -> %12.6f s' % (case['kernel'], case['system'], old['seconds'],
+                                                                case['seconds']))
+    return nslow
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Timings of the JK, XC, DF, and DPD kernels on generated systems.')
+    parser.add_argument('-n', '--nthread', type=int, default=1, help='number of threads')
+    parser.add_argument('--memory', default='2 GB', help='memory for the kernels')
+    parser.add_argument('--basis', default='cc-pvdz', help='orbital basis')
+    parser.add_argument('--waters', nargs='+', type=int, default=[2, 4, 8], help='water cluster sizes')
+    parser.add_argument('--kernels', nargs='+', default=kernels, choices=kernels, help='kernel families to run')
+    parser.add_argument('--jk-types', nargs='+', default=jk_types, choices=jk_types, help='JK algorithms to run')
+    parser.add_argument('--dpd-dim', type=int, default=3, help='largest DPD size exponent, o = 2^(k+2)')
+    parser.add_argument('--min-time', type=float, default=1.0, help='minimum time per kernel and size [s]')
+    parser.add_argument('--json', help='write the results to this file')
+    parser.add_argument('--compare', help='flag kernels slower than in this earlier results file')
+    parser.add_argument('--threshold', type=float, default=0.2, help='relative slowdown flagged by --compare')
+    args = parser.parse_args()
+
+    import psi4
+
+    psi4.set_output_file('kernel_benchmark.out', False)
+    psi4.set_memory(args.memory)
+    psi4.set_num_threads(args.nthread)
+    args.doubles = psi4.core.get_memory() // 8
+
+    cases = []
+    for nwater in args.waters:
+        mol = psi4.geometry(water_cluster(nwater))
+        mol.update_geometry()
+        psi4.set_options({'basis': args.basis})
+        basis = psi4.core.BasisSet.build(mol, 'ORBITAL', args.basis)
+        Cocc, Cvir = orbitals(psi4, basis, 5 * nwater)
+        system = {'system': 'water%d' % nwater, 'natom': mol.natom(), 'nbf': basis.nbf()}
+
+        found = []
+        if 'jk' in args.kernels:
+            found += bench_jk(psi4, mol, basis, Cocc, args)
+        if 'v' in args.kernels:
+            found += bench_v(psi4, basis, Cocc, args)
+        if 'dfh' in args.kernels:
+            found += bench_dfh(psi4, mol, basis, Cocc, Cvir, args)
+        for case in found:
+            case.update(system)
+            print('%-16s %-10s %12.6f s' % (case['kernel'], case['system'], case['seconds']))
+        cases += found
+
+    if 'dpd' in args.kernels:
+        for case in bench_dpd(psi4, args):
+            print('%-16s %-10s %12.6f s' % (case['kernel'], case['system'], case['seconds']))
+            cases.append(case)
+
+    results = {
+        'host': platform.node(),
+        'nthread': args.nthread,
+        'memory': args.memory,
+        'basis': args.basis,
+        'cases': cases,
+    }
+
+    if args.json:
+        with open(args.json, 'w') as fp:
+            json.dump(results, fp, indent=2)
+    else:
+        print(json.dumps(results, indent=2))
+
+    if args.compare:
+        with open(args.compare) as fp:
+            reference = json.load(fp)
+        nslow = compare(cases, reference, args.threshold)
+        print('%d kernel(s) slower than %s by more than %.0f%%' % (nslow, args.compare, 100 * args.threshold))
+        if nslow:
+            sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
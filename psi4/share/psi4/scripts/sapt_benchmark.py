@@ -0,0 +1,319 @@
+#!/usr/bin/env python
+
+"""Time the SAPT family on a fixed set of dimers of increasing size.
+
+Every (method, dimer) pair runs in its own Python process in a scratch
+directory, so the numbers reported for it are its own: the per-term wall/CPU
+times come from the module timers that process writes to ``timer.dat``, and
+the memory high-water mark and block I/O come from the process's resource
+usage. Results are written as JSON; pass an earlier JSON file to
+``--compare`` to flag terms that got slower.
+
+    python sapt_benchmark.py -n 8 --memory "16 GB" --json run.json
+    python sapt_benchmark.py -n 8 --memory "16 GB" --compare run.json
+
+"""
+
+import os
+import re
+import sys
+import json
+import time
+import shutil
+import argparse
+import platform
+import tempfile
+import subprocess
+
+if sys.version_info <= (3, 0):
+    print('Much of this script needs py3')
+    sys.exit()
+
+dimers = {
+    'ethene-ethyne':
+    """
+0 1
+C     0.000000    -0.667578    -2.124659
+C     0.000000     0.667578    -2.124659
+H     0.923621    -1.232253    -2.126185
+H    -0.923621    -1.232253    -2.126185
+H    -0.923621     1.232253    -2.126185
+H     0.923621     1.232253    -2.126185
+--
+0 1
+C     0.000000     0.000000     2.900503
+C     0.000000     0.000000     1.693240
+H     0.000000     0.000000     0.627352
+H     0.000000     0.000000     3.963929
+units angstrom
+symmetry c1
+no_reorient
+no_com
+""",
+    'benzene-methane':
+    """
+0 1
+C     1.3932178    0.0362913   -0.6332803
+C     0.7280364   -1.1884015   -0.6333017
+C    -0.6651797   -1.2247077   -0.6332803
+C    -1.3932041   -0.0362972   -0.6333017
+C    -0.7280381    1.1884163   -0.6332803
+C     0.6651677    1.2246987   -0.6333017
+H     2.4742737    0.0644484   -0.6317240
+H     1.2929588   -2.1105409   -0.6317401
+H    -1.1813229   -2.1750081   -0.6317240
+H    -2.4742614   -0.0644647   -0.6317401
+H    -1.2929508    2.1105596   -0.6317240
+H     1.1813026    2.1750056   -0.6317401
+--
+0 1
+C     0.0000000    0.0000000    3.0826195
+H     0.5868776    0.8381742    3.4463772
+H    -1.0193189    0.0891638    3.4463772
+H     0.0000000    0.0000000    1.9966697
+H     0.4324413   -0.9273380    3.4463772
+units angstrom
+symmetry c1
+no_reorient
+no_com
+""",
+    'phenol-dimer':
+    """
+0 1
+O    -1.3885044    1.9298523   -0.4431206
+H    -0.5238121    1.9646519   -0.0064609
+C    -2.0071056    0.7638459   -0.1083509
+C    -1.4630807   -0.1519120    0.7949930
+C    -2.1475789   -1.3295094    1.0883677
+C    -3.3743208   -1.6031427    0.4895864
+C    -3.9143727   -0.6838545   -0.4091028
+C    -3.2370496    0.4929609   -0.7096126
+H    -0.5106510    0.0566569    1.2642563
+H    -1.7151135   -2.0321452    1.7878417
+H    -3.9024664   -2.5173865    0.7197947
+H    -4.8670730   -0.8822939   -0.8811319
+H    -3.6431662    1.2134345   -1.4057590
+--
+0 1
+O     1.3531168    1.9382724    0.4723133
+H     1.7842846    2.3487495    1.2297110
+C     2.0369747    0.7865043    0.1495491
+C     1.5904026    0.0696860   -0.9574153
+C     2.2417367   -1.1069765   -1.3128110
+C     3.3315674   -1.5665603   -0.5748636
+C     3.7696838   -0.8396901    0.5286439
+C     3.1224836    0.3383498    0.8960491
+H     0.7445512    0.4367983   -1.5218583
+H     1.8921463   -1.6649726   -2.1701843
+H     3.8330227   -2.4811537   -0.8566666
+H     4.6137632   -1.1850101    1.1092635
+H     3.4598854    0.9030376    1.7569489
+units angstrom
+symmetry c1
+no_reorient
+no_com
+""",
+}
+
+methods = ['sapt0', 'ssapt0', 'sapt2+', 'fisapt0']
+
+# one line of the timer.dat summary, serial or parallel timer
+_serial_timer = re.compile(r'^(.*\S)\s*:\s+([\d.]+)u\s+([\d.]+)s\s+([\d.]+)w\s+(\d+) calls')
+_parallel_timer = re.compile(r'^(.*\S)\s*:\s+([\d.]+)p\s+(\d+) calls')
+
+
+def parse_timers(fname):
+    """Per-term times from the first summary block of a timer.dat file."""
+
+    terms = {}
+    in_summary = False
+    with open(fname) as fp:
+        for line in fp:
+            if line.startswith('Module'):
+                in_summary = True
+                continue
+            if not in_summary:
+                continue
+            if line.startswith('-----'):
+                break
+
+            m = _serial_timer.match(line)
+            if m:
+                terms[m.group(1)] = {
+                    'user': float(m.group(2)),
+                    'system': float(m.group(3)),
+                    'wall': float(m.group(4)),
+                    'calls': int(m.group(5)),
+                }
+                continue
+            m = _parallel_timer.match(line)
+            if m:
+                terms[m.group(1)] = {'wall': float(m.group(2)), 'calls': int(m.group(3)), 'parallel': True}
+
+    return terms
+
+
+def run_worker(args):
+    """Run one SAPT calculation in this process and dump its sizes and energies."""
+
+    import psi4
+
+    psi4.set_output_file('output.dat', False)
+    psi4.set_memory(args.memory)
+    psi4.set_num_threads(args.nthread)
+    psi4.core.IOManager.shared_object().set_default_path(os.path.abspath('scratch'))
+
+    mol = psi4.geometry(dimers[args.dimer])
+    psi4.set_options({
+        'basis': args.basis,
+        'scf_type': 'df',
+        'freeze_core': True,
+        'guess': 'sad',
+    })
+
+    # clean_timers() writes the timers out before resetting them, so the one
+    # call after the energy makes the first block of timer.dat the one that
+    # parse_timers() reads: everything since import, i.e., this calculation
+    e, wfn = psi4.energy(args.method, molecule=mol, return_wfn=True)
+    psi4.core.clean_timers()
+
+    result = {
+        'natom': mol.natom(),
+        'nbf': wfn.basisset().nbf(),
+        'energy': e,
+        'variables': {k: v for k, v in psi4.core.variables().items() if k.startswith('SAPT') and 'ENERGY' in k},
+    }
+    with open('result.json', 'w') as fp:
+        json.dump(result, fp)
+
+
+def run_case(args, method, dimer):
+    """Run one (method, dimer) pair in a fresh process and collect its timings."""
+
+    workdir = tempfile.mkdtemp(prefix='sapt_bench_')
+    os.mkdir(os.path.join(workdir, 'scratch'))
+
+    cmd = [
+        sys.executable,
+        os.path.abspath(__file__), '--worker', '--method', method, '--dimer', dimer, '--basis', args.basis,
+        '--memory', args.memory, '-n',
+        str(args.nthread)
+    ]
+
+    t0 = time.time()
+    proc = subprocess.Popen(cmd, cwd=workdir, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    stderr = proc.stderr.read()
+    _, status, usage = os.wait4(proc.pid, 0)
+    proc.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+    wall = time.time() - t0
+
+    case = {'method': method, 'dimer': dimer, 'wall': wall, 'returncode': proc.returncode}
+
+    # ru_maxrss is in kB on Linux and in bytes on macOS
+    maxrss = usage.ru_maxrss * (1 if platform.system() == 'Darwin' else 1024)
+    case['resources'] = {
+        'user': usage.ru_utime,
+        'system': usage.ru_stime,
+        'max_rss_bytes': maxrss,
+        'block_input_ops': usage.ru_inblock,
+        'block_output_ops': usage.ru_oublock,
+    }
+
+    if proc.returncode == 0:
+        with open(os.path.join(workdir, 'result.json')) as fp:
+            case.update(json.load(fp))
+        case['terms'] = parse_timers(os.path.join(workdir, 'timer.dat'))
+    else:
+        case['error'] = stderr.decode(errors='replace')[-2000:]
+
+    if args.keep:
+        case['workdir'] = workdir
+    else:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    return case
+
+
+def compare(cases, reference, threshold):
+    """Print the terms whose wall time grew by more than threshold relative to reference."""
+
+    ref = {(c['method'], c['dimer']): c for c in reference['cases']}
+    nslow = 0
+    for case in cases:
+        old = ref.get((case['method'], case['dimer']))
+        if old is None or 'terms' not in case or 'terms' not in old:
+            continue
+        for key, term in case['terms'].items():
+            if key not in old['terms']:
+                continue
+            told = old['terms'][key]['wall']
+            tnew = term['wall']
+            # ignore terms too short to time reliably
+            if told < 0.1:
+                continue
+            if tnew / told > 1.0 + threshold:
+                nslow += 1
+                print('  SLOWER  %-8s %-16s %-36s %10.3f -> %10.3f s' % (case['method'], case['dimer'], key, told,
+                                                                         tnew))
+    return nslow
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Per-term timings of the SAPT methods on a fixed dimer set.')
+    parser.add_argument('-n', '--nthread', type=int, default=1, help='number of threads')
+    parser.add_argument('--memory', default='2 GB', help='memory per calculation')
+    parser.add_argument('--basis', default='jun-cc-pvdz', help='orbital basis')
+    parser.add_argument('--methods', nargs='+', default=methods, choices=methods, help='methods to run')
+    parser.add_argument('--dimers', nargs='+', default=list(dimers), choices=list(dimers), help='dimers to run')
+    parser.add_argument('--json', help='write the results to this file')
+    parser.add_argument('--compare', help='flag terms slower than in this earlier results file')
+    parser.add_argument('--threshold', type=float, default=0.2, help='relative slowdown flagged by --compare')
+    parser.add_argument('--keep', action='store_true', help='keep the scratch directory of each run')
+    parser.add_argument('--worker', action='store_true', help=argparse.SUPPRESS)
+    parser.add_argument('--method', help=argparse.SUPPRESS)
+    parser.add_argument('--dimer', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_worker(args)
+        return
+
+    cases = []
+    for dimer in args.dimers:
+        for method in args.methods:
+            print('Running %-8s on %-16s ...' % (method, dimer), end=' ', flush=True)
+            case = run_case(args, method, dimer)
+            cases.append(case)
+            if case['returncode'] == 0:
+                print('%10.3f s %10.1f MB' % (case['wall'], case['resources']['max_rss_bytes'] / 1024.0**2))
+            else:
+                print('FAILED')
+
+    results = {
+        'host': platform.node(),
+        'nthread': args.nthread,
+        'memory': args.memory,
+        'basis': args.basis,
+        'cases': cases,
+    }
+
+    if args.json:
+        with open(args.json, 'w') as fp:
+            json.dump(results, fp, indent=2)
+    else:
+        print(json.dumps(results, indent=2))
+
+    if args.compare:
+        with open(args.compare) as fp:
+            reference = json.load(fp)
+        nslow = compare(cases, reference, args.threshold)
+        print('%d term(s) slower than %s by more than %.0f%%' % (nslow, args.compare, 100 * args.threshold))
+        if nslow:
+            sys.exit(1)
+
+    if any(c['returncode'] != 0 for c in cases):
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -38,6 +38,8 @@
 
 #include "psi4/cc/cclambda/cclambda.h"
 #include "psi4/cc/ccwave.h"
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libdpd/dpd.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/molecule.h"
@@ -57,6 +59,10 @@
 
 #include "python_data_type.h"
 
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
 #define STRINGIFY(x) #x
 #define TOSTRING(x) STRINGIFY(x)
 
@@ -266,6 +272,12 @@ std::string to_upper(const std::string& key) {
     return nonconst_key;
 }
 
+// Rank of this process when psi4 runs the same input on several MPI ranks. Only rank 0 writes the
+// output file, the timer file and the log; the other ranks send their output to /dev/null.
+static int mpi_rank = 0;
+
+static std::string rank_outfile_name(const std::string& ofname) { return mpi_rank == 0 ? ofname : "/dev/null"; }
+
 void py_flush_outfile() {}
 
 void py_close_outfile() {
@@ -275,12 +287,12 @@ void py_close_outfile() {
 }
 
 void py_reopen_outfile() {
-    if (outfile_name == "stdout") {
+    if (outfile_name == "stdout" && mpi_rank == 0) {
         // Default constructor corresponds to stdout
         outfile = std::make_shared<PsiOutStream>();
     } else {
         auto mode = std::ostream::app;
-        outfile = std::make_shared<PsiOutStream>(outfile_name, mode);
+        outfile = std::make_shared<PsiOutStream>(rank_outfile_name(outfile_name), mode);
         if (!outfile) throw PSIEXCEPTION("Psi4: Unable to reopen output file.");
     }
 }
@@ -308,6 +320,8 @@ void py_psi_prepare_options_for_module(std::string const& name) {
     }
     // Now we've read in the defaults, make sure that user-specified options are recognized by the current module
     Process::environment.options.validate_options();
+    // Layout of the DPD files the module writes
+    dpd_set_compression(Process::environment.options);
 }
 
 int py_psi_optking() {
@@ -519,7 +533,10 @@ SharedWavefunction py_psi_psimrcc(SharedWavefunction ref_wfn) {
     return psimrcc::psimrcc(ref_wfn, Process::environment.options);
 }
 
-void py_psi_clean() { PSIOManager::shared_object()->psiclean(); }
+void py_psi_clean() {
+    PSIOManager::shared_object()->psiclean();
+    dpd_persistent_cache_clear();
+}
 
 void py_psi_print_options() { Process::environment.options.print(); }
 
@@ -1007,6 +1024,12 @@ PSI_DEPRECATED("Using core.set_legacy_wavefunction rather than passing a wavefun
         "and as soon as 1.5, it will stop working.")
 void py_psi_set_legacy_wavefunction(SharedWavefunction wfn) { Process::environment.set_legacy_wavefunction(wfn); }
 
+std::map<std::string, size_t> py_psi_block_pool_stats(bool reset) {
+    size_t hits, misses, live, peak, pooled;
+    block_pool_stats(hits, misses, live, peak, pooled, reset);
+    return {{"hits", hits}, {"misses", misses}, {"live_bytes", live}, {"peak_bytes", peak}, {"pooled_bytes", pooled}};
+}
+
 void py_psi_print_variable_map() {
     int largest_key = 0;
     for (std::map<std::string, double>::iterator it = Process::environment.globals.begin();
@@ -1042,9 +1065,23 @@ bool psi4_python_module_initialize() {
     // There should only be one of these in Psi4
     Wavefunction::initialize_singletons();
 
-    outfile = std::make_shared<PsiOutStream>();
+#ifdef ENABLE_MPI
+    // Every rank runs the same input; DirectJK splits its quartet tasks over the ranks. Scratch
+    // files get a per-rank prefix, since process ids need not differ across nodes sharing scratch.
+    int mpi_initialized = 0;
+    MPI_Initialized(&mpi_initialized);
+    if (!mpi_initialized) {
+        int provided;
+        MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &provided);
+    }
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+#endif
+
+    outfile = mpi_rank == 0 ? std::make_shared<PsiOutStream>()
+                            : std::make_shared<PsiOutStream>("/dev/null", std::ostream::app);
     outfile_name = "stdout";
     std::string fprefix = PSI_DEFAULT_FILE_PREFIX;
+    if (mpi_rank != 0) fprefix += ".rank" + std::to_string(mpi_rank);
     psi_file_prefix = strdup(fprefix.c_str());
 
     // There is only one timer:
@@ -1106,11 +1143,17 @@ void psi4_python_module_finalize() {
     py_psi_plugin_close_all();
 
     // Shut things down:
-    // There is only one timer:
-    timer_done();
+    // There is only one timer, and only rank 0 writes timer.dat
+    if (mpi_rank == 0) timer_done();
 
     outfile = std::shared_ptr<PsiOutStream>();
     psi_file_prefix = nullptr;
+
+#ifdef ENABLE_MPI
+    int mpi_finalized = 0;
+    MPI_Finalized(&mpi_finalized);
+    if (!mpi_finalized) MPI_Finalize();
+#endif
 }
 
 PYBIND11_MODULE(core, core) {
@@ -1207,6 +1250,12 @@ PYBIND11_MODULE(core, core) {
              "Sets the number of threads to use in SMP parallel computations.");
     core.def("get_num_threads", py_psi_get_n_threads,
              "Returns the number of threads to use in SMP parallel computations.");
+    core.def("set_block_pool", &set_block_pool, "limit"_a, "huge_pages"_a = false,
+             "Keeps up to *limit* bytes of freed Matrix blocks for reuse (0, the default, returns them to the system) "
+             "and optionally asks for transparent huge pages on large blocks.");
+    core.def("block_pool_stats", py_psi_block_pool_stats, "reset"_a = false,
+             "Returns the reuse counters (hits, misses) and byte counts (live, peak, pooled) of the Matrix block pool.");
+    core.def("print_block_pool", &print_block_pool, "Prints the Matrix block pool counters to the output file.");
     core.def("print_options", py_psi_print_options,
              "Prints the currently set options (to the output file) for the current module.");
     core.def("print_global_options", py_psi_print_global_options,
@@ -1365,15 +1414,16 @@ PYBIND11_MODULE(core, core) {
     core.def("get_options", py_psi_get_options, py::return_value_policy::reference, "Get options");
     core.def("set_output_file", [](const std::string ofname) {
         auto mode = std::ostream::trunc;
-        outfile = std::make_shared<PsiOutStream>(ofname, mode);
+        outfile = std::make_shared<PsiOutStream>(rank_outfile_name(ofname), mode);
         outfile_name = ofname;
     });
     core.def("set_output_file", [](const std::string ofname, bool append) {
         auto mode = append ? std::ostream::app : std::ostream::trunc;
-        outfile = std::make_shared<PsiOutStream>(ofname, mode);
+        outfile = std::make_shared<PsiOutStream>(rank_outfile_name(ofname), mode);
         outfile_name = ofname;
     }, "ofname"_a, "append"_a = false, "Set the name for output file; prefer :func:`~psi4.set_output_file`");
     core.def("get_output_file", []() { return outfile_name; }, "Returns output file name (stem + suffix, no directory). 'stdout'.");
+    core.def("mpi_rank", []() { return mpi_rank; }, "Returns the MPI rank of this process; 0 unless built with ENABLE_MPI and run on several ranks.");
     core.def("set_psi_file_prefix", []() { PyErr_SetString(PyExc_AttributeError, "psi4.core.set_psi_file_prefix removed since hasn't been working as intended."); }, ".. deprecated:: 1.4");
         // [](std::string fprefix) { psi_file_prefix = strdup(fprefix.c_str()); });  // doesn't always work
 
@@ -26,6 +26,7 @@
  * @END LICENSE
  */
 
+#include "psi4/libdpd/dpd.h"
 #include "psi4/libmints/benchmark.h"
 #include "psi4/pybind11.h"
 
@@ -45,4 +46,6 @@ using namespace pybind11::literals;
           "Perform benchmark of common double floating point operations including most of cmath. For each routine run at least *min_time* [s].");
     m.def("benchmark_integrals", &psi::benchmark_integrals, "max_am"_a, "min_time"_a,
           "Perform benchmark of psi integrals (of libmints type). Benchmark integrals called from different centers. For up to *max_am* with each shell combination run at least *min_time* [s].");
+    m.def("benchmark_dpd", &psi::benchmark_dpd, "max_dim"_a, "min_time"_a,
+          "Perform benchmark of DPD contract444, buf4_sort, and buf4 PSIO traffic on sizes o = 2^(k+2), v = 4o for k up to *max_dim*, each run at least *min_time* [s]. Returns a list of (kernel, o, v, seconds, rate) tuples.");
 }
@@ -33,6 +33,7 @@
 #include "psi4/lib3index/denominator.h"
 #include "psi4/lib3index/dftensor.h"
 #include "psi4/lib3index/dfhelper.h"
+#include "psi4/lib3index/thc.h"
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
@@ -176,6 +177,11 @@ void export_fock(py::module &m) {
         .def("get_AO_core", &DFHelper::get_AO_core)
         .def("set_MO_core", &DFHelper::set_MO_core)
         .def("get_MO_core", &DFHelper::get_MO_core)
+        .def("set_float_disk", &DFHelper::set_float_disk)
+        .def_static("set_AO_cache", &DFHelper::set_AO_cache, "Keep in-core AOs for reuse by later DFHelper objects with the same basis and geometry.")
+        .def_static("get_AO_cache", &DFHelper::get_AO_cache)
+        .def("get_AO_cache_hit", &DFHelper::get_AO_cache_hit)
+        .def("get_float_disk", &DFHelper::get_float_disk)
         .def("add_space", &DFHelper::add_space)
         .def("initialize", &DFHelper::initialize)
         .def("print_header", &DFHelper::print_header)
@@ -190,11 +196,34 @@ void export_fock(py::module &m) {
         .def("get_tensor", take_string(&DFHelper::get_tensor))
         .def("get_tensor", tensor_access3(&DFHelper::get_tensor));
 
+    py::class_<THC, std::shared_ptr<THC>>(m, "THC", "Least-squares tensor hypercontraction on an ISDF point set")
+        .def(py::init<std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>>())
+        .def("set_memory", &THC::set_memory)
+        .def("get_memory", &THC::get_memory)
+        .def("set_nthreads", &THC::set_nthreads)
+        .def("set_print_lvl", &THC::set_print_lvl)
+        .def("set_tolerance", &THC::set_tolerance)
+        .def("get_tolerance", &THC::get_tolerance)
+        .def("set_condition", &THC::set_condition)
+        .def("set_grid", &THC::set_grid, "radial_points"_a, "spherical_points"_a)
+        .def("build", &THC::build)
+        .def("print_header", &THC::print_header)
+        .def("npoint", &THC::npoint)
+        .def("X", &THC::X, "AO collocation at the interpolation points (nbf x npoint)")
+        .def("Z", &THC::Z, "Core tensor (npoint x npoint)")
+        .def("points", &THC::points, "Interpolation points (npoint x 4): x, y, z and weight")
+        .def("transform", &THC::transform, "Orbital collocation C^T X (nmo x npoint)");
+
     py::class_<MemDFJK, std::shared_ptr<MemDFJK>, JK>(m, "MemDFJK", "docstring")
         .def("dfh", &MemDFJK::dfh, "Return the DFHelper object.");
 
     py::class_<DirectJK, std::shared_ptr<DirectJK>, JK>(m, "DirectJK", "docstring")
-        .def("do_incfock_iter", &DirectJK::do_incfock_iter, "Was the last Fock build incremental?");
+        .def("do_incfock_iter", &DirectJK::do_incfock_iter, "Was the last Fock build incremental?")
+        .def("num_dropped_shells", &DirectJK::num_dropped_shells, "Number of shell quartets dropped by density screening in the last Fock build.")
+        .def("incfock_error_bound", &DirectJK::incfock_error_bound, "Accumulated bound on the contributions neglected since the last full Fock build.")
+        .def("has_early_cutoff", &DirectJK::has_early_cutoff, "Is there a looser screening threshold for the early SCF iterations?")
+        .def("screening_cutoff", &DirectJK::screening_cutoff, "Screening threshold used by the last Fock build.")
+        .def("clear_D_prev", &DirectJK::clear_D_prev, "Make the next Fock build a full one.");
 
     py::class_<DFJCOSK, std::shared_ptr<DFJCOSK>, JK>(m, "DFJCOSK", "docstring")
         .def("clear_D_prev", &DFJCOSK::clear_D_prev, "Clear previous D matrices.");
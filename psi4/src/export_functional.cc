@@ -263,6 +263,11 @@ void export_functional(py::module &m) {
         .def("build_collocation_cache", &VBase::build_collocation_cache,
              "Constructs a collocation cache to prevent recomputation.")
         .def("clear_collocation_cache", &VBase::clear_collocation_cache, "Clears the collocation cache.")
+        .def("incxc_size", &VBase::incxc_size,
+             "Doubles the incremental XC build (DFT_INCXC) stores for the current grid, 0 without it.")
+        .def("mixed_precision", &VBase::mixed_precision, "Are the XC contractions done in single precision?")
+        .def("set_mixed_precision", &VBase::set_mixed_precision,
+             "Sets whether the XC contractions are done in single precision.")
         .def("set_D", &VBase::set_D, "Sets the internal density.")
         .def("Dao", &VBase::set_D, "Returns internal AO density.")
         .def("compute_V", &VBase::compute_V, "doctsring")
@@ -304,6 +309,9 @@ void export_functional(py::module &m) {
         .def("s6", &Dispersion::get_s6, "docstring")
         .def("sr6", &Dispersion::get_sr6, "docstring")
         .def("s8", &Dispersion::get_s8, "docstring")
+        .def("cutoff", &Dispersion::get_cutoff, "Pair distance [a0] beyond which pairs are left out, 0.0 for none")
+        .def("set_cutoff", &Dispersion::set_cutoff,
+             "Leave out pairs farther apart than cutoff [a0], found with a cell list; 0.0 keeps every pair", "cutoff"_a)
         .def("a1", &Dispersion::get_a1, "docstring")
         .def("a2", &Dispersion::get_a2, "docstring")
         .def("print_out", &Dispersion::py_print, "docstring");
@@ -318,6 +326,8 @@ void export_functional(py::module &m) {
              "Projects a density from the primary AO to auxiliary AO space.")
         .def("form_unc_amplitude", &sapt::FDDS_Dispersion::form_unc_amplitude,
              "Forms the uncoupled amplitudes for either monomer.")
+        .def("form_unc_amplitudes", &sapt::FDDS_Dispersion::form_unc_amplitudes,
+             "Forms the uncoupled amplitudes of several frequencies for either monomer.")
         .def("get_tensor_pqQ", &sapt::FDDS_Dispersion::get_tensor_pqQ,
              "Debug only: fetches 3-index intermediate from disk and return as matrix.")
         .def("print_tensor_pqQ", &sapt::FDDS_Dispersion::print_tensor_pqQ,
@@ -77,6 +77,42 @@ using namespace psi;
 namespace py = pybind11;
 using namespace pybind11::literals;
 
+/** Makes the given NumPy arrays the storage of a Matrix, one array per irrep
+ * Only C-contiguous, writeable float64 arrays are taken, so that no conversion can sneak in a copy.
+ * The matrix keeps the arrays alive until it is resized or destroyed.
+ *
+ * @param m         Matrix adopting the data
+ * @param arrays    One 2D array per irrep
+ * @param symmetry  Symmetry of the matrix
+ **/
+void matrix_adopt_arrays(Matrix& m, const py::list& arrays, int symmetry) {
+    int nirrep = py::len(arrays);
+    Dimension rows(nirrep), cols(nirrep);
+    std::vector<double*> blocks(nirrep, nullptr);
+    if (nirrep && (symmetry < 0 || symmetry >= nirrep)) throw PSIEXCEPTION("Matrix.adopt: Invalid symmetry.");
+    for (int h = 0; h < nirrep; h++) {
+        if (!py::isinstance<py::array>(arrays[h])) throw PSIEXCEPTION("Matrix.adopt: Expected NumPy arrays.");
+        py::array arr = arrays[h].cast<py::array>();
+        if (arr.ndim() != 2) throw PSIEXCEPTION("Matrix.adopt: Arrays must be two-dimensional.");
+        if (arr.dtype().kind() != 'f' || arr.itemsize() != sizeof(double))
+            throw PSIEXCEPTION("Matrix.adopt: Arrays must be float64.");
+        if (!(arr.flags() & py::array::c_style)) throw PSIEXCEPTION("Matrix.adopt: Arrays must be C-contiguous.");
+        if (!arr.writeable()) throw PSIEXCEPTION("Matrix.adopt: Arrays must be writeable.");
+
+        rows[h] = arr.shape(0);
+        cols[h ^ symmetry] = arr.shape(1);
+        if (arr.size()) blocks[h] = static_cast<double*>(arr.mutable_data());
+    }
+
+    // Released from whichever thread drops the last reference, so take the GIL first
+    auto* keep = new py::object(py::tuple(arrays));
+    std::shared_ptr<void> owner(keep, [](void* obj) {
+        py::gil_scoped_acquire gil;
+        delete static_cast<py::object*>(obj);
+    });
+    m.adopt(rows, cols, blocks, owner, symmetry);
+}
+
 /** Returns a new basis set object
  * Constructs a basis set from the parsed information
  *
@@ -552,6 +588,8 @@ void export_mints(py::module& m) {
         .def("add", matrix_set4(&Matrix::add), "Increments row m and column n of irrep h's block matrix by val.", "h"_a,
              "m"_a, "n"_a, "val"_a)
         .def("axpy", &Matrix::axpy, "Add to this matrix another matrix scaled by a", "a"_a, "X"_a)
+        .def("axpby", &Matrix::axpby, "Set this matrix to a times another matrix plus b times this matrix", "a"_a,
+             "X"_a, "b"_a)
         .def("subtract", matrix_one(&Matrix::subtract), "Substract a matrix from this matrix")
         .def("accumulate_product", matrix_two(&Matrix::accumulate_product),
              "Multiplies two arguments and adds the result to this matrix")
@@ -686,7 +724,12 @@ void export_mints(py::module& m) {
 
                 return ret;
             },
-            py::return_value_policy::reference_internal);
+            py::return_value_policy::reference_internal)
+        .def("adopt", &matrix_adopt_arrays,
+             "Use the given C-contiguous float64 NumPy arrays, one per irrep, as the data of this matrix without "
+             "copying. The matrix keeps them alive until it is resized or destroyed.",
+             "arrays"_a, "symmetry"_a = 0)
+        .def("owns_data", &Matrix::owns_data, "Whether the data was allocated by this matrix rather than adopted");
 
     // Free functions
     typedef Matrix (*doublet_shared)(const Matrix&, const Matrix&, bool, bool);
@@ -1089,6 +1132,9 @@ void export_mints(py::module& m) {
     py::class_<CdSalcList, std::shared_ptr<CdSalcList>>(
         m, "CdSalcList", "Class for generating symmetry adapted linear combinations of Cartesian displacements")
         .def(py::init<std::shared_ptr<Molecule>, int, bool, bool>())
+        .def_static("build", &CdSalcList::build,
+                    "Return the SALCs of mol, shared with earlier calls for the same geometry and arguments", "mol"_a,
+                    "needed_irreps"_a = 0xFF, "project_out_translations"_a = true, "project_out_rotations"_a = true)
         .def("ncd", &CdSalcList::ncd, "Return the number of cartesian displacements SALCs")
         .def("create_matrices", &CdSalcList::create_matrices,
              "Return a vector of matrices with the SALC symmetries. Dimensions determined by factory.", "basename"_a,
@@ -1276,6 +1322,14 @@ void export_mints(py::module& m) {
         m, "TracelessQuadrupoleInt", pyOneBodyAOInt, "Computes traceless quadrupole integrals");
     py::class_<ElectricFieldInt, std::shared_ptr<ElectricFieldInt>>(m, "ElectricFieldInt", pyOneBodyAOInt,
                                                                     "Computes electric field integrals");
+    py::class_<SiteFields, std::shared_ptr<SiteFields>>(
+        m, "SiteFields", "Screened electric fields and induction operators at a fixed set of sites")
+        .def(py::init<std::shared_ptr<BasisSet>, SharedMatrix, double>(), "basis"_a, "coords"_a,
+             "screening"_a = 1.0e-12)
+        .def("field", &SiteFields::field, "Electric field of the AO density D at every site (nsite x 3)", "D"_a)
+        .def("induction_operator", &SiteFields::induction_operator,
+             "Induction operator of dipoles (nsite x 3) at the sites", "dipoles"_a)
+        .def("nsite", &SiteFields::nsite, "Number of sites");
     py::class_<KineticInt, std::shared_ptr<KineticInt>>(m, "KineticInt", pyOneBodyAOInt, "Computes kinetic integrals");
     py::class_<PotentialInt, std::shared_ptr<PotentialInt>>(m, "PotentialInt", pyOneBodyAOInt,
                                                             "Computes potential integrals");
@@ -1405,6 +1459,7 @@ void export_mints(py::module& m) {
 
     typedef SharedMatrix (MintsHelper::*erf)(double, SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix);
     typedef SharedMatrix (MintsHelper::*eri)(SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix);
+    typedef std::vector<SharedMatrix> (MintsHelper::*eri_set)(const std::vector<std::vector<SharedMatrix>>&);
     typedef SharedMatrix (MintsHelper::*normal_eri)();
     typedef SharedMatrix (MintsHelper::*normal_eri_factory)(std::shared_ptr<IntegralFactory>);
     typedef SharedMatrix (MintsHelper::*normal_eri2)(std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>,
@@ -1432,6 +1487,32 @@ void export_mints(py::module& m) {
         "An SOBasis object describes the transformation from an atomic orbital basis to a symmetry orbital basis.")
         .def("petite_list", &SOBasisSet::petite_list, "Return the PetiteList object used in creating this SO basis");
 
+    py::class_<ShellQuartetBlocks, std::shared_ptr<ShellQuartetBlocks>>(
+        m, "ShellQuartetBlocks", "Screened, symmetry-unique AO integrals stored shell quartet by shell quartet")
+        .def("basis", &ShellQuartetBlocks::basis, "The basis set of all four indices")
+        .def("nquartet", &ShellQuartetBlocks::nquartet, "Number of stored shell quartets")
+        .def("size", &ShellQuartetBlocks::size, "Number of stored integrals")
+        .def("quartet", [](const ShellQuartetBlocks& b, size_t i) {
+            const auto& q = b.quartet(i);
+            return py::make_tuple(q[0], q[1], q[2], q[3]);
+        }, "Shell indices (M, N, P, Q) of block i", "i"_a)
+        .def("find", &ShellQuartetBlocks::find,
+             "Index of the block holding a quartet, in any index order, or -1 if it was screened out", "M"_a, "N"_a,
+             "P"_a, "Q"_a)
+        .def("block", [](std::shared_ptr<ShellQuartetBlocks> b, size_t i) {
+            if (i >= b->nquartet()) throw py::index_error("ShellQuartetBlocks: block index out of range");
+            auto shape = b->shape(i);
+            return py::array_t<double>({shape[0], shape[1], shape[2], shape[3]}, b->block(i), py::cast(b));
+        }, "Writable view of block i, shaped (nm, nn, np, nq)", "i"_a)
+        .def("offsets", [](const ShellQuartetBlocks& b) {
+            std::vector<size_t> offsets(b.nquartet() + 1);
+            for (size_t i = 0; i <= b.nquartet(); ++i) offsets[i] = b.offset(i);
+            return offsets;
+        }, "Start of every block in data(), with the total size appended")
+        .def("data", [](std::shared_ptr<ShellQuartetBlocks> b) {
+            return py::array_t<double>(b->size(), b->data(), py::cast(b));
+        }, "Writable flat view of all blocks");
+
     py::class_<MintsHelper, std::shared_ptr<MintsHelper>>(m, "MintsHelper", "Computes integrals")
         .def(py::init<std::shared_ptr<BasisSet>>())
         .def(py::init<std::shared_ptr<Wavefunction>>())
@@ -1507,6 +1588,8 @@ void export_mints(py::module& m) {
         .def("ao_eri", normal_eri_factory(&MintsHelper::ao_eri), "AO ERI integrals", "factory"_a = nullptr)
         .def("ao_eri", normal_eri2(&MintsHelper::ao_eri), "AO ERI integrals", "bs1"_a, "bs2"_a, "bs3"_a, "bs4"_a)
         .def("ao_eri_shell", &MintsHelper::ao_eri_shell, "AO ERI Shell", "M"_a, "N"_a, "P"_a, "Q"_a)
+        .def("ao_eri_blocks", &MintsHelper::ao_eri_blocks,
+             "Screened, symmetry-unique AO ERI shell quartets, without forming the full tensor", "factory"_a = nullptr)
         .def("ao_erf_eri", &MintsHelper::ao_erf_eri, "AO ERF integrals", "omega"_a, "factory"_a = nullptr)
         .def("ao_f12", normal_f12(&MintsHelper::ao_f12), "AO F12 integrals", "corr"_a)
         .def("ao_f12", normal_f122(&MintsHelper::ao_f12), "AO F12 integrals", "corr"_a, "bs1"_a, "bs2"_a, "bs3"_a,
@@ -1525,6 +1608,10 @@ void export_mints(py::module& m) {
         // Two-electron MO and transformers
         .def("mo_eri", eri(&MintsHelper::mo_eri), "MO ERI Integrals. Pass appropriate MO coefficients in the AO basis.",
              "C1"_a, "C2"_a, "C3"_a, "C4"_a)
+        .def("mo_eri", eri_set(&MintsHelper::mo_eri),
+             "Several MO ERI classes from one AO integral pass, each request a [C1, C2, C3, C4] list. "
+             "Requests that share coefficient matrices share half-transformed integrals.",
+             "requests"_a)
         .def("mo_erf_eri", erf(&MintsHelper::mo_erf_eri), "MO ERFC Omega Integrals", "omega"_a, "C1"_a, "C2"_a, "C3"_a,
              "C4"_a)
         .def("mo_f12", &MintsHelper::mo_f12, "MO F12 Integrals", "corr"_a, "C1"_a, "C2"_a, "C3"_a, "C4"_a)
@@ -1633,6 +1720,9 @@ void export_mints(py::module& m) {
         .def("clear", &ExternalPotential::clear, "Reset the field to zero (eliminates all entries)")
         .def("computePotentialMatrix", &ExternalPotential::computePotentialMatrix,
              "Compute the external potential matrix in the given basis set", "basis"_a)
+        .def("set_fmm", &ExternalPotential::set_fmm,
+             "Expand the far-field point charges of computePotentialMatrix in multipoles", "fmm"_a, "order"_a = 10,
+             "ws"_a = 3.0, "box_length"_a = 6.0)
         .def("computeNuclearEnergy", &ExternalPotential::computeNuclearEnergy,
              "Compute the contribution to the nuclear repulsion energy for the given molecule")
         .def("computeExternExternInteraction", &ExternalPotential::computeExternExternInteraction,
@@ -1646,6 +1736,8 @@ void export_mints(py::module& m) {
                                                       "Class containing orbital localization procedures")
         .def_static("build", localizer_with_type(&Localizer::build), "Build the localization scheme")
         .def("localize", &Localizer::localize, "Perform the localization procedure")
+        .def("set_guess", &Localizer::set_guess, "L"_a,
+             "Start from the localized orbitals L of a previous localization, e.g., at the last geometry")
         .def_property_readonly("L", py::cpp_function(&Localizer::L), "Localized orbital coefficients")
         .def_property_readonly("U", py::cpp_function(&Localizer::U), "Orbital rotation matrix")
         .def_property_readonly("converged", py::cpp_function(&Localizer::converged),
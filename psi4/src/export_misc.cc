@@ -29,6 +29,7 @@
 #include "psi4/pybind11.h"
 
 #include "psi4/libciomr/libciomr.h"
+#include "psi4/libpsi4util/memory_manager.h"
 #include "psi4/libqt/qt.h"
 
 using namespace psi;
@@ -41,4 +42,21 @@ void export_misc(py::module &m) {
     m.def("tstart", tstart, "Start module-level timer. Only one active at once.");
     m.def("tstop", tstop, "Stop module-level timer. Prints user, system, and total times to outfile.");
     m.def("clean_timers", clean_timers, "Reinitialize timers for independent ``timer.dat`` entries. Vital when earlier independent calc finished improperly.");
+    m.def("timer_count", timer_count, "key"_a, "value"_a, "Add *value* to the counter *key* (FLOPs, bytes, ...) reported with the timers.");
+    m.def("set_timer_trace", set_timer_trace, "trace"_a, "Record every timer interval for :func:`psi4.core.timer_write_trace`. Enabling discards earlier events.");
+    m.def("timer_write_json", timer_write_json, "filename"_a, "Write the timer tree, counters, and memory high-water mark to *filename* as JSON.");
+    m.def("timer_write_trace", timer_write_trace, "filename"_a, "Write the recorded timer intervals to *filename* in Chrome trace (``chrome://tracing``, Perfetto) format.");
+
+    py::class_<MemoryBroker, std::unique_ptr<MemoryBroker, py::nodelete>>(
+        m, "MemoryBroker", "Divides the job memory between subsystems by the benefit each expects from it.")
+        .def_static("shared_object", &MemoryBroker::shared_object, py::return_value_policy::reference,
+                    "The broker of this process.")
+        .def("request", &MemoryBroker::request, "name"_a, "minimum"_a, "curve"_a,
+             "Ask for at least *minimum* bytes in the next allocate(), with the benefit *curve* given as (bytes, benefit) points.")
+        .def("allocate", &MemoryBroker::allocate, "budget"_a = 0,
+             "Grant the pending requests from at most *budget* bytes (0: all memory not granted yet). Returns the grants.")
+        .def("granted", &MemoryBroker::granted, "name"_a, "Bytes granted to *name*.")
+        .def("release", &MemoryBroker::release, "name"_a, "Give the grant of *name* back.")
+        .def("available", &MemoryBroker::available, "Job memory not granted to anyone.")
+        .def("print_out", &MemoryBroker::print, "out"_a = "outfile", "Print the current grants.");
 }
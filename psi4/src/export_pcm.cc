@@ -46,9 +46,13 @@ void export_pcm(py::module& m) {
         .value("NucAndEle", PCM::CalcType::NucAndEle)
         .value("EleOnly", PCM::CalcType::EleOnly);
 
-    pcm.def(py::init<std::string, int, std::shared_ptr<BasisSet>>())
+    pcm.def(py::init<std::string, int, std::shared_ptr<BasisSet>, double>(), "pcmsolver_parsed_fname"_a,
+            "print_level"_a, "basisset"_a, "screening"_a = 1.0e-12)
         .def("compute_PCM_terms", &PCM::compute_PCM_terms, "Compute PCM contributions to energy and Fock matrix", "D"_a,
              "type"_a)
+        .def("set_incremental", &PCM::set_incremental,
+             "Update the MEP and PCM potential of compute_PCM_terms from the previous call", "incremental"_a,
+             "full_every"_a)
         .def("compute_V", &PCM::compute_V, "Computes electronic PCM contributions due to first-order perturbed densities", "D"_a);
 }
 #endif
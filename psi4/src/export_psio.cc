@@ -59,8 +59,29 @@ void export_psio(py::module &m) {
         .def("tocscan", &PSIO::tocscan,
              "Seek string in binary file. This export is only good for catching None, as returned success object not "
              "exported.")
+        .def("filecfg_kwd",
+             [](PSIO &psio, const std::string &kwdgrp, const std::string &kwd, int unit, const std::string &kwdval) {
+                 psio.filecfg_kwd(kwdgrp.c_str(), kwd.c_str(), unit, kwdval.c_str());
+             },
+             "Set a file configuration keyword (e.g. NVOLUME, VOLUMEn, STRIPE) for a module group and unit "
+             "(-1 for all units)",
+             "kwdgrp"_a, "kwd"_a, "unit"_a, "kwdval"_a)
         .def("getpid", &PSIO::getpid, "Lookup process id")
         .def("set_pid", &PSIO::set_pid, "Set process id", "pid"_a)
+        .def("set_io_scheduler", &PSIO::set_io_scheduler,
+             "Prefetch sequential reads and write small contiguous writes behind on nthread I/O threads "
+             "(0 returns to synchronous I/O)",
+             "nthread"_a, "prefetch_bytes"_a = 16777216, "coalesce_bytes"_a = 1048576)
+        .def("io_scheduler", &PSIO::io_scheduler, "Is I/O going through the scheduler?")
+        .def("print_io_stats", &PSIO::print_io_stats, "Print per-unit I/O scheduler statistics",
+             "out"_a = "outfile")
+        .def_static("set_memory_arena", &PSIO::set_memory_arena,
+                    "Keep the pages of open units in memory up to budget bytes, spilling the least recently used "
+                    "to disk (0 writes everything back and returns to disk I/O)",
+                    "budget"_a)
+        .def_static("memory_arena", &PSIO::memory_arena, "Budget of the memory arena in bytes, 0 if there is none")
+        .def_static("print_memory_arena_stats", &PSIO::print_memory_arena_stats,
+                    "Print page hits, spills and peak residency of the memory arena", "out"_a = "outfile")
         .def_static("shared_object", &PSIO::shared_object, "Return the global shared object")
         .def_static("get_default_namespace", &PSIO::get_default_namespace,
                     "Get the default namespace (for PREFIX.NAMESPACE.UNIT file numbering)")
@@ -171,5 +171,5 @@ void export_trans(py::module& m) {
         .def("reset_so_int", &IntegralTransform::reset_so_int);
 
     m.def("fcidump_tei_helper", &fcidump::fcidump_tei_helper, "Write integrals to file in FCIDUMP format", "nirrep"_a,
-          "restricted"_a, "DPD_info"_a, "ints_tolerance"_a, "fname"_a = "INTDUMP");
+          "restricted"_a, "DPD_info"_a, "ints_tolerance"_a, "fname"_a = "INTDUMP", "binary"_a = false);
 }
@@ -333,7 +333,10 @@ void export_wavefunction(py::module& m) {
         .def("form_initial_F", &scf::HF::form_initial_F, "Forms the initial F matrix.")
         .def("form_H", &scf::HF::form_H, "Forms the core Hamiltonian")
         .def("form_Shalf", &scf::HF::form_Shalf, "Forms the S^1/2 matrix")
-        .def("form_FDSmSDF", &scf::HF::form_FDSmSDF, "Forms the residual of SCF theory")
+        .def("form_FDSmSDF", py::overload_cast<SharedMatrix, SharedMatrix>(&scf::HF::form_FDSmSDF),
+             "Forms the residual of SCF theory")
+        .def("form_FDSmSDF", py::overload_cast<SharedMatrix, SharedMatrix, SharedMatrix>(&scf::HF::form_FDSmSDF),
+             "Forms the residual of SCF theory into a preallocated (nmo x nmo) matrix", "Fso"_a, "Dso"_a, "FDSmSDF"_a)
         .def("guess", &scf::HF::guess, "Forms the guess (guarantees C, D, and E)")
         .def("initialize_gtfock_jk", &scf::HF::initialize_gtfock_jk, "Sets up a GTFock JK object")
         .def("onel_Hx", &scf::HF::onel_Hx, "One-electron Hessian-vector products.")
@@ -341,6 +344,8 @@ void export_wavefunction(py::module& m) {
         .def("cphf_Hx", &scf::HF::cphf_Hx, "CPHF Hessian-vector prodcuts (4 * J - K - K.T).")
         .def("cphf_solve", &scf::HF::cphf_solve, "x_vec"_a, "conv_tol"_a, "max_iter"_a, "print_lvl"_a = 2,
              "Solves the CPHF equations for a given set of x vectors.")
+        .def("cphf_block_solve", &scf::HF::cphf_block_solve, "x_vec"_a, "conv_tol"_a, "max_iter"_a,
+             "print_lvl"_a = 2, "Solves the CPHF equations for a given set of x vectors with block CG.")
         .def("cphf_converged", &scf::HF::cphf_converged, "Adds occupied guess alpha orbitals.")
         .def("guess_Ca", &scf::HF::guess_Ca, "Sets the guess Alpha Orbital Matrix")
         .def("guess_Cb", &scf::HF::guess_Cb, "Sets the guess Beta Orbital Matrix")
@@ -394,6 +399,8 @@ void export_wavefunction(py::module& m) {
                       "Are we to do excited-state MOM?")
         .def_property("MOM_performed_", &scf::HF::MOM_performed, &scf::HF::set_MOM_performed,
                       "MOM performed current iteration?")
+        .def_property("purify_", &scf::HF::purify, &scf::HF::set_purify,
+                      "Form the density by purification instead of diagonalization?")
         .def_property("attempt_number_", &scf::HF::attempt_number, &scf::HF::set_attempt_number,
                       "Current macroiteration (1-indexed) for stability analysis")
         .def("stability_analysis", &scf::HF::stability_analysis, "Assess wfn stability and correct if requested")
@@ -34,6 +34,8 @@
 #include <ambit/tensor.h>
 //#include <tensor/core/core.h>
 
+#include "psi4/libdpd/dpd.h"
+
 namespace ambit {
 
 namespace helpers {
@@ -98,6 +100,132 @@ void PSI_API convert(const psi::Vector &vector, ambit::Tensor *target) {
     (*target)() = local_tensor();
 }
 
+namespace {
+
+Dimension buf4_dims(const psi::dpdbuf4 *buf) {
+    Dimension dims(4, 0);
+    for (int h = 0; h < buf->params->nirreps; ++h) {
+        dims[0] += buf->params->ppi[h];
+        dims[1] += buf->params->qpi[h];
+        dims[2] += buf->params->rpi[h];
+        dims[3] += buf->params->spi[h];
+    }
+    return dims;
+}
+
+Dimension file2_dims(const psi::dpdfile2 *file) {
+    Dimension dims(2, 0);
+    for (int h = 0; h < file->params->nirreps; ++h) {
+        dims[0] += file->params->ppi[h];
+        dims[1] += file->params->qpi[h];
+    }
+    return dims;
+}
+
+void check_buf4(const psi::dpdbuf4 *buf, const Tensor &tensor) {
+    if (tensor.rank() != 4) throw std::runtime_error("convert(psi::dpdbuf4, ambit::Tensor): Tensor is not rank 4");
+    if (tensor.dims() != buf4_dims(buf))
+        throw std::runtime_error(
+            "convert(psi::dpdbuf4, ambit::Tensor): buffer "
+            "and Tensor do not have the same dimensions");
+    if (buf->params->perm_pq || buf->params->perm_rs)
+        throw std::runtime_error(
+            "convert(psi::dpdbuf4, ambit::Tensor): buffer "
+            "is packed, open it with unpacked pairs");
+}
+
+void check_file2(const psi::dpdfile2 *file, const Tensor &tensor) {
+    if (tensor.rank() != 2) throw std::runtime_error("convert(psi::dpdfile2, ambit::Tensor): Tensor is not rank 2");
+    if (tensor.dims() != file2_dims(file))
+        throw std::runtime_error(
+            "convert(psi::dpdfile2, ambit::Tensor): file "
+            "and Tensor do not have the same dimensions");
+}
+
+// Copies between the irrep blocks of buf and the dense data, to the dense data if to_dense
+void copy_buf4(psi::dpdbuf4 *buf, std::vector<double> &data, const Dimension &dims, bool to_dense) {
+    int my_irrep = buf->file.my_irrep;
+    for (int h = 0; h < buf->params->nirreps; ++h) {
+        psi::global_dpd_->buf4_mat_irrep_init(buf, h);
+        if (to_dense) psi::global_dpd_->buf4_mat_irrep_rd(buf, h);
+        for (int pq = 0; pq < buf->params->rowtot[h]; ++pq) {
+            size_t p = buf->params->roworb[h][pq][0];
+            size_t q = buf->params->roworb[h][pq][1];
+            for (int rs = 0; rs < buf->params->coltot[h ^ my_irrep]; ++rs) {
+                size_t r = buf->params->colorb[h ^ my_irrep][rs][0];
+                size_t s = buf->params->colorb[h ^ my_irrep][rs][1];
+                double &element = data[((p * dims[1] + q) * dims[2] + r) * dims[3] + s];
+                if (to_dense)
+                    element = buf->matrix[h][pq][rs];
+                else
+                    buf->matrix[h][pq][rs] = element;
+            }
+        }
+        if (!to_dense) psi::global_dpd_->buf4_mat_irrep_wrt(buf, h);
+        psi::global_dpd_->buf4_mat_irrep_close(buf, h);
+    }
+}
+
+void copy_file2(psi::dpdfile2 *file, std::vector<double> &data, const Dimension &dims, bool to_dense) {
+    int my_irrep = file->my_irrep;
+    psi::global_dpd_->file2_mat_init(file);
+    if (to_dense) psi::global_dpd_->file2_mat_rd(file);
+    for (int h = 0; h < file->params->nirreps; ++h) {
+        for (int p = 0; p < file->params->rowtot[h]; ++p) {
+            size_t P = file->params->roworb[h][p];
+            for (int q = 0; q < file->params->coltot[h ^ my_irrep]; ++q) {
+                size_t Q = file->params->colorb[h ^ my_irrep][q];
+                double &element = data[P * dims[1] + Q];
+                if (to_dense)
+                    element = file->matrix[h][p][q];
+                else
+                    file->matrix[h][p][q] = element;
+            }
+        }
+    }
+    if (!to_dense) psi::global_dpd_->file2_mat_wrt(file);
+    psi::global_dpd_->file2_mat_close(file);
+}
+
+}  // namespace
+
+void PSI_API convert(psi::dpdbuf4 *buf, ambit::Tensor *target) {
+    check_buf4(buf, *target);
+
+    Tensor local_tensor = Tensor::build(CoreTensor, "Local Data", target->dims());
+    copy_buf4(buf, local_tensor.data(), target->dims(), true);
+
+    // Splice data into the target tensor
+    (*target)() = local_tensor();
+}
+
+void PSI_API convert(psi::dpdfile2 *file, ambit::Tensor *target) {
+    check_file2(file, *target);
+
+    Tensor local_tensor = Tensor::build(CoreTensor, "Local Data", target->dims());
+    copy_file2(file, local_tensor.data(), target->dims(), true);
+
+    // Splice data into the target tensor
+    (*target)() = local_tensor();
+}
+
+void PSI_API convert(const ambit::Tensor &source, psi::dpdbuf4 *buf) {
+    check_buf4(buf, source);
+
+    // Gather the source, wherever it lives, into a local tensor
+    Tensor local_tensor = Tensor::build(CoreTensor, "Local Data", source.dims());
+    local_tensor() = source();
+    copy_buf4(buf, local_tensor.data(), source.dims(), false);
+}
+
+void PSI_API convert(const ambit::Tensor &source, psi::dpdfile2 *file) {
+    check_file2(file, source);
+
+    Tensor local_tensor = Tensor::build(CoreTensor, "Local Data", source.dims());
+    local_tensor() = source();
+    copy_file2(file, local_tensor.data(), source.dims(), false);
+}
+
 }  // namespace psi4
 
 }  // namespace helpers
@@ -36,6 +36,11 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
 
+namespace psi {
+struct dpdbuf4;
+struct dpdfile2;
+}  // namespace psi
+
 namespace ambit {
 
 class Tensor;
@@ -48,6 +53,18 @@ void convert(const psi::Matrix &matrix, ambit::Tensor *target);
 
 void convert(const psi::Vector &vector, ambit::Tensor *target);
 
+// DPD quantities <-> dense tensors over the full orbital spaces, indexed by the absolute DPD
+// orbital numbers (e.g., T2(i,j,a,b) from an <OO|VV> buffer). Blocks that are zero by symmetry are
+// zero in the tensor, and are dropped on the way back. Buffers must be unpacked (no p>q pairs).
+
+void convert(psi::dpdbuf4 *buf, ambit::Tensor *target);
+
+void convert(psi::dpdfile2 *file, ambit::Tensor *target);
+
+void convert(const ambit::Tensor &source, psi::dpdbuf4 *buf);
+
+void convert(const ambit::Tensor &source, psi::dpdfile2 *file);
+
 }  // namespace psi4
 
 }  // namespace helpers
@@ -0,0 +1,175 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup CCENERGY
+    \brief Integral-direct AO-basis particle-particle ladder
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "psi4/libdpd/dpd.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/cc/ccwave.h"
+
+namespace psi {
+namespace ccenergy {
+
+/*
+** AO_direct(): tau2(pr,ij) = sum_qs (pq|rs) tau1(qs,ij) for the C1 RHF
+** ladder, with the AO integrals computed on the fly instead of read from
+** PSIF_SO_TEI.  Each thread owns the rows of tau2 belonging to a shell
+** pair P >= R and accumulates them with one DGEMM per (p,q) of every
+** significant shell quartet (PQ|RS).  Quartets are dropped by the
+** integral sieve and when their Schwarz bound times the largest tau1
+** element of the QS block falls below INTS_TOLERANCE.  The rows with
+** P < R follow from tau2(rp,ji) = tau2(pr,ij).  Both buffers must be
+** in core.  Returns the number of shell quartets computed.
+*/
+int CCEnergyWavefunction::AO_direct(dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO) {
+    auto basis = basisset();
+    int nshell = basis->nshell();
+    int nso = basis->nbf();
+    int o2 = tau1_AO->params->coltot[0];
+    if (!o2) return 0;
+
+    double **tau1 = tau1_AO->matrix[0];
+    double **tau2 = tau2_AO->matrix[0];
+    double tolerance = Process::environment.options.get_double("INTS_TOLERANCE");
+
+    int nthreads = Process::environment.get_n_threads();
+    auto factory = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
+    ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+    for (int thread = 1; thread < nthreads; thread++) ints.push_back(std::shared_ptr<TwoBodyAOInt>(ints[0]->clone()));
+
+    // largest |tau1| in each shell-pair block of rows, for the density screening
+    std::vector<double> taumax(nshell * nshell, 0.0);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (int QS = 0; QS < nshell * nshell; QS++) {
+        int Q = QS / nshell;
+        int S = QS % nshell;
+        int q0 = basis->shell(Q).function_index();
+        int s0 = basis->shell(S).function_index();
+        int nq = basis->shell(Q).nfunction();
+        int ns = basis->shell(S).nfunction();
+        double max = 0.0;
+        for (int q = q0; q < q0 + nq; q++) {
+            double *row = tau1[tau1_AO->params->rowidx[q][s0]];
+            for (long int x = 0; x < (long int)ns * o2; x++) max = std::max(max, std::fabs(row[x]));
+        }
+        taumax[QS] = max;
+    }
+
+    std::vector<std::pair<int, int>> PR;
+    for (int P = 0; P < nshell; P++)
+        for (int R = 0; R <= P; R++) PR.push_back(std::make_pair(P, R));
+
+    int count = 0;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(+ : count)
+    for (size_t task = 0; task < PR.size(); task++) {
+        int P = PR[task].first;
+        int R = PR[task].second;
+
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        int p0 = basis->shell(P).function_index();
+        int r0 = basis->shell(R).function_index();
+        int np = basis->shell(P).nfunction();
+        int nr = basis->shell(R).nfunction();
+
+        for (int Q = 0; Q < nshell; Q++) {
+            int q0 = basis->shell(Q).function_index();
+            int nq = basis->shell(Q).nfunction();
+            for (int S = 0; S < nshell; S++) {
+                if (!ints[thread]->shell_significant(P, Q, R, S)) continue;
+                if (std::sqrt(ints[thread]->shell_ceiling2(P, Q, R, S)) * taumax[Q * nshell + S] < tolerance)
+                    continue;
+
+                int s0 = basis->shell(S).function_index();
+                int ns = basis->shell(S).nfunction();
+
+                ints[thread]->compute_shell(P, Q, R, S);
+                const double *buffer = ints[thread]->buffer();
+                count++;
+
+                // tau2(p r0..,ij) += (pq|r0.. s0..) tau1(q s0..,ij)
+                for (int p = 0; p < np; p++) {
+                    for (int q = 0; q < nq; q++) {
+                        C_DGEMM('n', 'n', nr, o2, ns, 1.0, const_cast<double *>(buffer) + (p * nq + q) * nr * ns, ns,
+                                tau1[tau1_AO->params->rowidx[q0 + q][s0]], o2, 1.0,
+                                tau2[tau2_AO->params->rowidx[p0 + p][r0]], o2);
+                    }
+                }
+            }
+        }
+    }
+
+    // tau2(rp,ij) = tau2(pr,ji) for the shell pairs with P < R
+    std::vector<int> ji(o2);
+    for (int ij = 0; ij < o2; ij++) {
+        int i = tau1_AO->params->colorb[0][ij][0];
+        int j = tau1_AO->params->colorb[0][ij][1];
+        ji[ij] = tau1_AO->params->colidx[j][i];
+    }
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (int R = 0; R < nshell; R++) {
+        int r0 = basis->shell(R).function_index();
+        int nr = basis->shell(R).nfunction();
+        for (int P = R + 1; P < nshell; P++) {
+            int p0 = basis->shell(P).function_index();
+            int np = basis->shell(P).nfunction();
+            for (int r = r0; r < r0 + nr; r++) {
+                for (int p = p0; p < p0 + np; p++) {
+                    double *rp = tau2[tau2_AO->params->rowidx[r][p]];
+                    double *pr = tau2[tau2_AO->params->rowidx[p][r]];
+                    for (int ij = 0; ij < o2; ij++) rp[ij] = pr[ji[ij]];
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+}  // namespace ccenergy
+}  // namespace psi
@@ -59,7 +59,8 @@ void CCEnergyWavefunction::BT2() {
     psio_address next;
 
     if (params_.ref == 0) { /** RHF **/
-        if (params_.df) {
+        if (params_.df || params_.abcd == "DF") {
+            timer_on("ABCD:DF");
             dpdbuf4 B;
             // Transpose, for faster DAXPY operations inside contract444_df
             global_dpd_->buf4_init(&tauIjAb, PSIF_CC_TAMPS, 0, 0, 5, 0, 5, 0, "tauIjAb");
@@ -77,6 +78,7 @@ void CCEnergyWavefunction::BT2() {
             global_dpd_->buf4_close(&Z1);
             global_dpd_->buf4_close(&B);
             global_dpd_->buf4_close(&tauIjAb);
+            timer_off("ABCD:DF");
         } else if (params_.abcd == "OLD") {
             timer_on("ABCD:old");
             global_dpd_->buf4_init(&tauIjAb, PSIF_CC_TAMPS, 0, 0, 5, 0, 5, 0, "tauIjAb");
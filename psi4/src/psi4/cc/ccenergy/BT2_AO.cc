@@ -58,7 +58,6 @@ void CCEnergyWavefunction::BT2_AO() {
     int **T2_cd_row_start, **T2_pq_row_start;
     int **T2_CD_row_start, **T2_Cd_row_start;
     dpdbuf4 tau, t2, tau1_AO, tau2_AO;
-    dpdfile4 T;
     struct iwlbuf InBuf;
     int lastbuf;
     double tolerance = 1e-14;
@@ -122,7 +121,7 @@ void CCEnergyWavefunction::BT2_AO() {
 
     if (params_.ref == 0) { /** RHF **/
 
-        if (params_.aobasis == "DISK") {
+        if (params_.aobasis == "DISK" || params_.aobasis == "DIRECT") {
             dpd_set_default(1);
             global_dpd_->buf4_init(&tau1_AO, PSIF_CC_TAMPS, 0, 0, 5, 0, 5, 0, "tauIjPq (1)");
             global_dpd_->buf4_scm(&tau1_AO, 0.0);
@@ -159,23 +158,30 @@ void CCEnergyWavefunction::BT2_AO() {
                     global_dpd_->buf4_mat_irrep_init(&tau2_AO, h);
                 }
 
-                iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
+                if (params_.aobasis == "DIRECT") {
+                    counter = AO_direct(&tau1_AO, &tau2_AO);
 
-                lastbuf = InBuf.lastbuf;
+                    if (params_.print & 2)
+                        outfile->Printf("     *** Computed %d AO shell quartets for <ab||cd> --> T2\n", counter);
+                } else {
+                    iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
 
-                counter += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-
-                while (!lastbuf) {
-                    iwl_buf_fetch(&InBuf);
                     lastbuf = InBuf.lastbuf;
 
                     counter += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-                }
 
-                iwl_buf_close(&InBuf, 1);
+                    while (!lastbuf) {
+                        iwl_buf_fetch(&InBuf);
+                        lastbuf = InBuf.lastbuf;
+
+                        counter += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+                    }
 
-                if (params_.print & 2)
-                    outfile->Printf("     *** Processed %d SO integrals for <ab||cd> --> T2\n", counter);
+                    iwl_buf_close(&InBuf, 1);
+
+                    if (params_.print & 2)
+                        outfile->Printf("     *** Processed %d SO integrals for <ab||cd> --> T2\n", counter);
+                }
 
                 for (int h = 0; h < nirreps; h++) {
                     global_dpd_->buf4_mat_irrep_wrt(&tau2_AO, h);
@@ -204,21 +210,6 @@ void CCEnergyWavefunction::BT2_AO() {
 
             global_dpd_->buf4_close(&t2);
             global_dpd_->buf4_close(&tau2_AO);
-
-        } else if (params_.aobasis == "DIRECT") {
-            global_dpd_->file4_init(&T, PSIF_CC_TAMPS, 0, 0, 5, "tauIjAb");
-            global_dpd_->file4_cache_del(&T);
-            global_dpd_->file4_close(&T);
-
-            global_dpd_->file4_init(&T, PSIF_CC_TAMPS, 0, 0, 5, "New tIjAb");
-            global_dpd_->file4_cache_del(&T);
-            global_dpd_->file4_close(&T);
-
-            /* close the CC_TAMPS file for cints to use it */
-            psio_close(PSIF_CC_TAMPS, 1);
-
-            /* re-open CCC_TAMPS for remaining terms */
-            psio_open(PSIF_CC_TAMPS, PSIO_OPEN_OLD);
         }
 
     } else if (params_.ref == 1) { /** ROHF **/
@@ -110,7 +110,8 @@ double CCEnergyWavefunction::compute_energy() {
         spaces.push_back(moinfo_.bvirtpi);
         spaces.push_back(moinfo_.bvir_sym);
         delete[] dpd_list[0];
-        dpd_list[0] = new DPD(0, moinfo_.nirreps, params_.memory, 0, cachefiles.data(), cachelist, nullptr, 4, spaces);
+        dpd_list[0] = new DPD(0, moinfo_.nirreps, params_.memory, params_.cachetype, cachefiles.data(), cachelist,
+                              nullptr, 4, spaces);
         dpd_set_default(0);
 
         if (params_.df) {
@@ -141,7 +142,7 @@ double CCEnergyWavefunction::compute_energy() {
         dpd_init(0, moinfo_.nirreps, params_.memory, params_.cachetype, cachefiles.data(), cachelist,
                  cache_priority_list_.data(), 2, spaces);
 
-        if (params_.df) {
+        if (params_.df || params_.abcd == "DF") {
             form_df_ints(options_, cachelist, cachefiles.data());
         } else if (params_.aobasis != "NONE") { /* Set up new DPD for AO-basis algorithm */
             std::vector<int *> aospaces;
@@ -317,7 +318,7 @@ double CCEnergyWavefunction::compute_energy() {
     if (!done) {
         outfile->Printf("     ** Wave function not converged to %2.1e ** \n", params_.convergence);
 
-        if (params_.aobasis != "NONE" || params_.df) dpd_close(1);
+        if (params_.aobasis != "NONE" || params_.df || params_.abcd == "DF") dpd_close(1);
         dpd_close(0);
         cleanup();
         exit_io();
@@ -474,7 +475,9 @@ double CCEnergyWavefunction::compute_energy() {
 
     if (params_.brueckner) Process::environment.globals["BRUECKNER CONVERGED"] = rotate();
 
-    if (params_.aobasis != "NONE" || params_.df) dpd_close(1);
+    if (params_.print > 0) global_dpd_->file4_cache_print_stats("outfile");
+
+    if (params_.aobasis != "NONE" || params_.df || params_.abcd == "DF") dpd_close(1);
     dpd_close(0);
 
     if (params_.ref == 2)
@@ -49,6 +49,47 @@
 namespace psi {
 namespace ccenergy {
 
+/*
+** init_df_dpd(): append the auxiliary basis (Q) and a one-function dummy
+** space (D) to the orbital spaces and initialize DPD 1 with them.  With
+** the R(O)HF spaces (O, SO, V) this is the layout of the B(VV|Q) and
+** B(OV|Q) integrals below, so later modules can read them back.
+*/
+void CCEnergyWavefunction::init_df_dpd(std::vector<int *> spaces, long int memory, int **cachelist,
+                                       int *cachefiles) {
+    std::shared_ptr<BasisSet> dfBasis = get_basisset("DF_BASIS_CC");
+    PetiteList petite(dfBasis, integral_, false);
+    SharedMatrix dfAOtoSO = petite.aotoso();
+
+    auto *dforbspi = new int[nirrep_];
+    auto *dummyorbspi = new int[nirrep_];
+    int count = 0;
+    for (int h = 0; h < nirrep_; ++h) {
+        dummyorbspi[h] = 0;
+        int norb = dfAOtoSO->coldim(h);
+        dforbspi[h] = norb;
+        count += norb;
+    }
+    dummyorbspi[0] = 1;
+    auto *dforbsym = new int[count];
+    auto *dummyorbsym = new int[1];
+    dummyorbsym[0] = 0;
+    count = 0;
+    for (int h = 0; h < nirrep_; ++h)
+        for (int orb = 0; orb < dforbspi[h]; ++orb) dforbsym[count++] = h;
+    spaces.push_back(dforbspi);
+    spaces.push_back(dforbsym);
+    spaces.push_back(dummyorbspi);
+    spaces.push_back(dummyorbsym);
+
+    dpd_init(1, nirrep_, memory, 0, cachefiles, cachelist, nullptr, spaces.size() / 2, spaces);
+
+    delete[] dforbspi;
+    delete[] dforbsym;
+    delete[] dummyorbspi;
+    delete[] dummyorbsym;
+}
+
 void CCEnergyWavefunction::form_df_ints(Options &options, int **cachelist, int *cachefiles) {
     /*
      * Set up the DF tensor machinery
@@ -107,33 +148,7 @@ void CCEnergyWavefunction::form_df_ints(Options &options, int **cachelist, int *
         aospaces.push_back(moinfo_.virtpi);
         aospaces.push_back(moinfo_.vir_sym);
     }
-    auto *dforbspi = new int[moinfo_.nirreps];
-    auto *dummyorbspi = new int[moinfo_.nirreps];
-    int count = 0;
-    for (int h = 0; h < moinfo_.nirreps; ++h) {
-        dummyorbspi[h] = 0;
-        int norb = dfAOtoSO->coldim(h);
-        dforbspi[h] = norb;
-        count += norb;
-    }
-    dummyorbspi[0] = 1;
-    auto *dforbsym = new int[count];
-    auto *dummyorbsym = new int[1];
-    dummyorbsym[0] = 0;
-    count = 0;
-    for (int h = 0; h < moinfo_.nirreps; ++h)
-        for (int orb = 0; orb < dforbspi[h]; ++orb) dforbsym[count++] = h;
-    aospaces.push_back(dforbspi);
-    aospaces.push_back(dforbsym);
-    aospaces.push_back(dummyorbspi);
-    aospaces.push_back(dummyorbsym);
-
-    dpd_init(1, moinfo_.nirreps, params_.memory, 0, cachefiles, cachelist, nullptr, aospaces.size() / 2, aospaces);
-
-    delete[] dforbspi;
-    delete[] dforbsym;
-    delete[] dummyorbspi;
-    delete[] dummyorbsym;
+    init_df_dpd(aospaces, params_.memory, cachelist, cachefiles);
 
     /*      The IDs of the spaces
      *   R(O)HF
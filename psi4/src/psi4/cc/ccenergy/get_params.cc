@@ -113,6 +113,8 @@ void CCEnergyWavefunction::get_params(Options &options) {
     params_.memory = Process::environment.get_memory();
 
     params_.aobasis = options.get_str("AO_BASIS");
+    if (params_.aobasis == "DIRECT" && (params_.ref != 0 || moinfo_.nirreps != 1))
+        throw PsiException("AO_BASIS = DIRECT requires an RHF reference in C1 symmetry", __FILE__, __LINE__);
     params_.cachelev = options.get_int("CACHELEVEL");
 
     params_.cachetype = 1;
@@ -121,10 +123,12 @@ void CCEnergyWavefunction::get_params(Options &options) {
         params_.cachetype = 1;
     else if (cachetype == "LRU")
         params_.cachetype = 0;
+    else if (cachetype == "COST")
+        params_.cachetype = 2;
     else
         throw PsiException("Error in input: invalid CACHETYPE", __FILE__, __LINE__);
 
-    if (params_.ref == 2) /* No LOW cacheing yet for UHF references */
+    if (params_.ref == 2 && params_.cachetype == 1) /* No LOW cacheing yet for UHF references */
         params_.cachetype = 0;
 
     params_.nthreads = Process::environment.get_n_threads();
@@ -135,9 +139,12 @@ void CCEnergyWavefunction::get_params(Options &options) {
     params_.t2_coupled = options.get_bool("T2_COUPLED");
     params_.prop = options.get_str("PROPERTY");
     params_.abcd = options.get_str("ABCD");
+    if (params_.abcd == "DF" && (params_.ref != 0 || params_.aobasis != "NONE"))
+        throw PsiException("ABCD = DF requires an RHF reference and AO_BASIS = NONE", __FILE__, __LINE__);
     params_.local = options.get_bool("LOCAL");
     local_.cutoff = options.get_double("LOCAL_CUTOFF");
     local_.method = options.get_str("LOCAL_METHOD");
+    local_.pno_cutoff = options.get_double("LOCAL_PNO_CUTOFF");
     local_.weakp = options.get_str("LOCAL_WEAKP");
 
     // local.filter_singles = options.get_bool("LOCAL_FILTER_SINGLES");
@@ -148,6 +155,11 @@ void CCEnergyWavefunction::get_params(Options &options) {
     local_.freeze_core = (freeze_docc != "FALSE");
 
     local_.pairdef = options.get_str("LOCAL_PAIRDEF");
+    if (params_.local && local_.method == "PNO") {
+        if (params_.ref != 0) throw PsiException("LOCAL_METHOD = PNO requires an RHF reference", __FILE__, __LINE__);
+        /* Singles span the full virtual space */
+        local_.filter_singles = 0;
+    }
     if (params_.local && params_.dertype == 3)
         local_.pairdef = "RESPONSE";
     else if (params_.local)
@@ -207,7 +219,7 @@ void CCEnergyWavefunction::get_params(Options &options) {
     outfile->Printf("    AO Basis        =     %s\n", params_.aobasis.c_str());
     outfile->Printf("    ABCD            =     %s\n", params_.abcd.c_str());
     outfile->Printf("    Cache Level     =     %1d\n", params_.cachelev);
-    outfile->Printf("    Cache Type      =    %4s\n", params_.cachetype ? "LOW" : "LRU");
+    outfile->Printf("    Cache Type      =    %4s\n", params_.cachetype == 2 ? "COST" : (params_.cachetype ? "LOW" : "LRU"));
     outfile->Printf("    Print Level     =     %1d\n", params_.print);
     outfile->Printf("    Num. of threads =     %d\n", params_.nthreads);
     outfile->Printf("    # Amps to Print =     %1d\n", params_.num_amps);
@@ -223,6 +235,7 @@ void CCEnergyWavefunction::get_params(Options &options) {
     if (params_.local) {
         outfile->Printf("    Local Cutoff       =     %3.1e\n", local_.cutoff);
         outfile->Printf("    Local Method      =     %s\n", local_.method.c_str());
+        if (local_.method == "PNO") outfile->Printf("    PNO Cutoff        =     %3.1e\n", local_.pno_cutoff);
         outfile->Printf("    Weak pairs        =     %s\n", local_.weakp.c_str());
         outfile->Printf("    Filter singles    =     %s\n", local_.filter_singles ? "Yes" : "No");
         outfile->Printf("    Local pairs       =     %s\n", local_.pairdef.c_str());
@@ -48,6 +48,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <vector>
 
 namespace psi {
 namespace ccenergy {
@@ -74,6 +75,8 @@ void CCEnergyWavefunction::local_init() {
 
     local_.weak_pair_energy = 0.0;
 
+    if (local_.method == "PNO") local_pno_init();
+
     local_.weak_pairs = init_int_array(nocc * nocc);
     psio_read_entry(PSIF_CC_INFO, "Local Weak Pairs", (char *)local_.weak_pairs,
                     sizeof(int) * local_.nocc * local_.nocc);
@@ -81,6 +84,191 @@ void CCEnergyWavefunction::local_init() {
     outfile->Printf("    Localization parameters ready.\n\n");
 }
 
+/*!
+** local_pno_init(): Build the pair natural orbitals (PNOs) of each occupied
+** pair and store them in the form local_filter_T2() reads.
+**
+** The PNOs of pair ij are the eigenvectors of the MP2 pair density
+** D(ij) = Tt(ij) T(ij)^+ + Tt(ij)^+ T(ij), with Tt = 2T - T^+ and T the
+** first-order amplitudes, as in the DLPNO-MP2 code (dlpno/mp2.cc).  Those
+** with occupation numbers below LOCAL_PNO_CUTOFF are dropped and the rest
+** are made semicanonical.  The virtual space of the pair is the MO virtual
+** space itself, so no "Local Residual Vector (V)" is written; the
+** "Local Transformation Matrix (W)" of the pair is its nvir x npno PNO
+** matrix.  Pairs left with no PNOs are weak pairs.  The PNO truncation
+** error of the MP2 energy is printed for reference.
+**
+** This is a simulation of PNO-CCSD, not a reduced-scaling method: the
+** amplitudes are still held and contracted in the dense canonical DPD
+** buffers, and local_filter_T2() adds an O(o^2 v^3) projection per
+** iteration on top of the canonical CCSD cost.
+*/
+void CCEnergyWavefunction::local_pno_init() {
+    dpdfile2 fIJ, fAB;
+    dpdbuf4 D;
+    psio_address next_w, next_e;
+
+    auto nocc = local_.nocc;
+    auto nvir = local_.nvir;
+
+    if (moinfo_.nirreps != 1) throw PsiException("LOCAL_METHOD = PNO requires C1 symmetry", __FILE__, __LINE__);
+
+    auto eps_occ = init_array(nocc);
+    auto eps_vir = init_array(nvir);
+    global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
+    global_dpd_->file2_mat_init(&fIJ);
+    global_dpd_->file2_mat_rd(&fIJ);
+    for (int i = 0; i < nocc; i++) eps_occ[i] = fIJ.matrix[0][i][i];
+    global_dpd_->file2_mat_close(&fIJ);
+    global_dpd_->file2_close(&fIJ);
+    global_dpd_->file2_init(&fAB, PSIF_CC_OEI, 0, 1, 1, "fAB");
+    global_dpd_->file2_mat_init(&fAB);
+    global_dpd_->file2_mat_rd(&fAB);
+    for (int a = 0; a < nvir; a++) eps_vir[a] = fAB.matrix[0][a][a];
+    global_dpd_->file2_mat_close(&fAB);
+    global_dpd_->file2_close(&fAB);
+
+    auto weak_pairs = init_int_array(nocc * nocc);
+    auto pairdom_len = init_int_array(nocc * nocc);
+    auto pairdom_nrlen = init_int_array(nocc * nocc);
+
+    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D <ij|ab>");
+    global_dpd_->buf4_mat_irrep_init(&D, 0);
+    global_dpd_->buf4_mat_irrep_rd(&D, 0);
+
+    auto T = block_matrix(nvir, nvir);
+    auto Tt = block_matrix(nvir, nvir);
+    auto Dens = block_matrix(nvir, nvir);
+    auto U = block_matrix(nvir, nvir);
+    auto X = block_matrix(nvir, nvir);
+    auto Fpno = block_matrix(nvir, nvir);
+    auto R = block_matrix(nvir, nvir);
+    auto W = block_matrix(nvir, nvir);
+    auto occ = init_array(nvir);
+    auto e_pno = init_array(nvir);
+
+    /* W and the PNO energies of pair ij are also those of pair ji; compute the i <= j ones */
+    std::vector<double **> W_pair(nocc * nocc, nullptr);
+    std::vector<double *> e_pair(nocc * nocc, nullptr);
+
+    double de_pno = 0.0;
+    long int npno_total = 0;
+    for (int i = 0; i < nocc; i++) {
+        for (int j = i; j < nocc; j++) {
+            int ij = i * nocc + j;
+            int ji = j * nocc + i;
+            double *K = D.matrix[0][ij];
+
+            for (int a = 0; a < nvir; a++)
+                for (int b = 0; b < nvir; b++)
+                    T[a][b] = K[a * nvir + b] / (eps_occ[i] + eps_occ[j] - eps_vir[a] - eps_vir[b]);
+            for (int a = 0; a < nvir; a++)
+                for (int b = 0; b < nvir; b++) Tt[a][b] = 2.0 * T[a][b] - T[b][a];
+
+            double e_ij = C_DDOT(nvir * nvir, K, 1, Tt[0], 1);
+
+            /* Pair density and its natural orbitals, largest occupations first */
+            C_DGEMM('n', 't', nvir, nvir, nvir, 1.0, Tt[0], nvir, T[0], nvir, 0.0, Dens[0], nvir);
+            C_DGEMM('t', 'n', nvir, nvir, nvir, 1.0, Tt[0], nvir, T[0], nvir, 1.0, Dens[0], nvir);
+            sq_rsp(nvir, nvir, Dens, occ, 3, U, 1.0e-14);
+
+            int npno = 0;
+            while (npno < nvir && std::fabs(occ[npno]) >= local_.pno_cutoff) npno++;
+
+            double e_ij_pno = 0.0;
+            if (npno) {
+                /* Semicanonicalize the kept PNOs: W = U R, where R diagonalizes U+ F U */
+                for (int p = 0; p < npno; p++)
+                    for (int q = 0; q < npno; q++) {
+                        double value = 0.0;
+                        for (int a = 0; a < nvir; a++) value += U[a][p] * eps_vir[a] * U[a][q];
+                        Fpno[p][q] = value;
+                    }
+                sq_rsp(npno, npno, Fpno, e_pno, 1, R, 1.0e-14);
+                for (int a = 0; a < nvir; a++)
+                    for (int q = 0; q < npno; q++) {
+                        double value = 0.0;
+                        for (int p = 0; p < npno; p++) value += U[a][p] * R[p][q];
+                        W[a][q] = value;
+                    }
+
+                /* MP2 pair energy within the PNO space */
+                C_DGEMM('t', 'n', npno, nvir, nvir, 1.0, W[0], nvir, K, nvir, 0.0, X[0], nvir);
+                C_DGEMM('n', 'n', npno, npno, nvir, 1.0, X[0], nvir, W[0], nvir, 0.0, Tt[0], nvir);
+                for (int p = 0; p < npno; p++)
+                    for (int q = 0; q < npno; q++)
+                        T[p][q] = Tt[p][q] / (eps_occ[i] + eps_occ[j] - e_pno[p] - e_pno[q]);
+                for (int p = 0; p < npno; p++)
+                    for (int q = 0; q < npno; q++) e_ij_pno += Tt[p][q] * (2.0 * T[p][q] - T[q][p]);
+            }
+            de_pno += (i == j ? 1.0 : 2.0) * (e_ij - e_ij_pno);
+
+            W_pair[ij] = block_matrix(nvir, npno ? npno : 1);
+            for (int a = 0; a < nvir; a++)
+                for (int q = 0; q < npno; q++) W_pair[ij][a][q] = W[a][q];
+            e_pair[ij] = init_array(npno ? npno : 1);
+            for (int q = 0; q < npno; q++) e_pair[ij][q] = e_pno[q];
+
+            pairdom_len[ij] = pairdom_len[ji] = nvir;
+            pairdom_nrlen[ij] = pairdom_nrlen[ji] = npno;
+            weak_pairs[ij] = weak_pairs[ji] = (npno == 0);
+            npno_total += (i == j ? 1 : 2) * npno;
+        }
+    }
+
+    global_dpd_->buf4_mat_irrep_close(&D, 0);
+    global_dpd_->buf4_close(&D);
+
+    for (int i = 0; i < nocc; i++)
+        if (weak_pairs[i * nocc + i])
+            throw PsiException("local_pno_init: a diagonal pair has no PNOs; lower LOCAL_PNO_CUTOFF", __FILE__,
+                               __LINE__);
+
+    /* Write the pair data in the layout local_filter_T2() reads: pairs in ij order */
+    psio_write_entry(PSIF_CC_INFO, "Local Weak Pairs", (char *)weak_pairs, sizeof(int) * nocc * nocc);
+    psio_write_entry(PSIF_CC_INFO, "Local Pair Domain Length", (char *)pairdom_len, sizeof(int) * nocc * nocc);
+    psio_write_entry(PSIF_CC_INFO, "Local Pair Domain NR Length", (char *)pairdom_nrlen, sizeof(int) * nocc * nocc);
+    psio_write_entry(PSIF_CC_INFO, "Local Occupied Orbital Energies", (char *)eps_occ, sizeof(double) * nocc);
+    next_w = PSIO_ZERO;
+    next_e = PSIO_ZERO;
+    for (int i = 0; i < nocc; i++) {
+        for (int j = 0; j < nocc; j++) {
+            int ij = i * nocc + j;
+            int src = (i <= j) ? ij : j * nocc + i;
+            int npno = pairdom_nrlen[ij];
+            if (!npno) continue;
+            psio_write(PSIF_CC_INFO, "Local Virtual Orbital Energies", (char *)e_pair[src], sizeof(double) * npno,
+                       next_e, &next_e);
+            psio_write(PSIF_CC_INFO, "Local Transformation Matrix (W)", (char *)W_pair[src][0],
+                       sizeof(double) * nvir * npno, next_w, &next_w);
+        }
+    }
+
+    outfile->Printf("    Pair natural orbitals (cutoff %3.1e):\n", local_.pno_cutoff);
+    outfile->Printf("      Average PNOs per pair     = %8.1f of %d\n", (double)npno_total / (nocc * nocc), nvir);
+    outfile->Printf("      MP2 PNO truncation error  = %15.10f\n\n", de_pno);
+
+    for (int ij = 0; ij < nocc * nocc; ij++) {
+        if (W_pair[ij] != nullptr) free_block(W_pair[ij]);
+        if (e_pair[ij] != nullptr) free(e_pair[ij]);
+    }
+    free_block(T);
+    free_block(Tt);
+    free_block(Dens);
+    free_block(U);
+    free_block(X);
+    free_block(Fpno);
+    free_block(R);
+    free_block(W);
+    free(occ);
+    free(e_pno);
+    free(weak_pairs);
+    free(pairdom_len);
+    free(pairdom_nrlen);
+    free(eps_occ);
+    free(eps_vir);
+}
+
 void CCEnergyWavefunction::local_done() { outfile->Printf("    Local parameters free.\n"); }
 
 void CCEnergyWavefunction::local_filter_T1(dpdfile2 *T1) {
@@ -185,6 +373,8 @@ void CCEnergyWavefunction::local_filter_T2(dpdbuf4 *T2) {
     auto nso = local_.nso;
     auto nocc = local_.nocc;
     auto nvir = local_.nvir;
+    /* PNO pairs span the MO virtuals directly (V = 1); see local_pno_init() */
+    bool pno = local_.method == "PNO";
 
     /*   local.weak_pairs = init_int_array(nocc*nocc); */
     local_.pairdom_len = init_int_array(nocc * nocc);
@@ -208,6 +398,10 @@ void CCEnergyWavefunction::local_filter_T2(dpdbuf4 *T2) {
     }
     next = PSIO_ZERO;
     for (int ij = 0; ij < nocc * nocc; ij++) {
+        if (pno) {
+            local_.V[ij] = nullptr;
+            continue;
+        }
         local_.V[ij] = block_matrix(nvir, local_.pairdom_len[ij]);
         psio_read(PSIF_CC_INFO, "Local Residual Vector (V)", (char *)local_.V[ij][0],
                   sizeof(double) * nvir * local_.pairdom_len[ij], next, &next);
@@ -231,15 +425,22 @@ void CCEnergyWavefunction::local_filter_T2(dpdbuf4 *T2) {
     for (int i = 0, ij = 0; i < nocc; i++) {
         for (int j = 0; j < nocc; j++, ij++) {
             if (!local_.weak_pairs[ij]) {
-                /* Transform the virtuals to the redundant projected virtual basis */
-                C_DGEMM('t', 'n', local_.pairdom_len[ij], nvir, nvir, 1.0, &(local_.V[ij][0][0]),
-                        local_.pairdom_len[ij], &(T2->matrix[0][ij][0]), nvir, 0.0, &(X1[0][0]), nvir);
-                C_DGEMM('n', 'n', local_.pairdom_len[ij], local_.pairdom_len[ij], nvir, 1.0, &(X1[0][0]), nvir,
-                        &(local_.V[ij][0][0]), local_.pairdom_len[ij], 0.0, &(T2tilde[0][0]), nso);
+                double *T2in = &(T2tilde[0][0]);
+                int ldin = nso;
+                if (pno) {
+                    T2in = &(T2->matrix[0][ij][0]);
+                    ldin = nvir;
+                } else {
+                    /* Transform the virtuals to the redundant projected virtual basis */
+                    C_DGEMM('t', 'n', local_.pairdom_len[ij], nvir, nvir, 1.0, &(local_.V[ij][0][0]),
+                            local_.pairdom_len[ij], &(T2->matrix[0][ij][0]), nvir, 0.0, &(X1[0][0]), nvir);
+                    C_DGEMM('n', 'n', local_.pairdom_len[ij], local_.pairdom_len[ij], nvir, 1.0, &(X1[0][0]), nvir,
+                            &(local_.V[ij][0][0]), local_.pairdom_len[ij], 0.0, &(T2tilde[0][0]), nso);
+                }
 
                 /* Transform the virtuals to the non-redundant virtual basis */
                 C_DGEMM('t', 'n', local_.pairdom_nrlen[ij], local_.pairdom_len[ij], local_.pairdom_len[ij], 1.0,
-                        &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], &(T2tilde[0][0]), nso, 0.0, &(X2[0][0]), nso);
+                        &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], T2in, ldin, 0.0, &(X2[0][0]), nso);
                 C_DGEMM('n', 'n', local_.pairdom_nrlen[ij], local_.pairdom_nrlen[ij], local_.pairdom_len[ij], 1.0,
                         &(X2[0][0]), nso, &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], 0.0, &(T2bar[0][0]), nvir);
 
@@ -252,6 +453,11 @@ void CCEnergyWavefunction::local_filter_T2(dpdbuf4 *T2) {
                 /* Transform the new T2's to the redundant virtual basis */
                 C_DGEMM('n', 'n', local_.pairdom_len[ij], local_.pairdom_nrlen[ij], local_.pairdom_nrlen[ij], 1.0,
                         &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], &(T2bar[0][0]), nvir, 0.0, &(X1[0][0]), nvir);
+                if (pno) {
+                    C_DGEMM('n', 't', nvir, nvir, local_.pairdom_nrlen[ij], 1.0, &(X1[0][0]), nvir,
+                            &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], 0.0, &(T2->matrix[0][ij][0]), nvir);
+                    continue;
+                }
                 C_DGEMM('n', 't', local_.pairdom_len[ij], local_.pairdom_len[ij], local_.pairdom_nrlen[ij], 1.0,
                         &(X1[0][0]), nvir, &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], 0.0, &(T2tilde[0][0]), nso);
 
@@ -276,7 +482,7 @@ void CCEnergyWavefunction::local_filter_T2(dpdbuf4 *T2) {
 
     for (int i = 0; i < nocc * nocc; i++) {
         free_block(local_.W[i]);
-        free_block(local_.V[i]);
+        if (local_.V[i] != nullptr) free_block(local_.V[i]);
         free(local_.eps_vir[i]);
     }
     free(local_.W);
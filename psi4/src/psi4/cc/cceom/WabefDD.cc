@@ -57,156 +57,17 @@ void WabefDD(int i, int C_irr) {
     dpdbuf4 CMNEF, Cmnef, CMnEf, X, F, tau, D, WM, WP, Z;
     char CMNEF_lbl[32], Cmnef_lbl[32], CMnEf_lbl[32];
     char SIJAB_lbl[32], Sijab_lbl[32], SIjAb_lbl[32], SIA_lbl[32], Sia_lbl[32];
-    char lbl_a[32], lbl_s[32];
-    dpdbuf4 tau_a, tau_s;
-    dpdbuf4 B_a, B_s;
-    dpdbuf4 S, A;
-    double **B_diag, **tau_diag;
-    int ij, Gc, C, c, cc;
-    int nbuckets, rows_per_bucket, rows_left, m, row_start, ab, cd, dc, d;
-    int nrows, ncols, nlinks;
-    psio_address next;
 
     if (params.eom_ref == 0) { /* RHF */
         /* SIjAb += WAbEf*CIjEf */
         sprintf(SIjAb_lbl, "%s %d", "SIjAb", i);
         sprintf(CMnEf_lbl, "%s %d", "CMnEf", i);
 
-        /* SIjAb += <Ab|Ef> CIjEf -- allow out of core algorithm */
-
-        timer_on("WabefDD Z");
-
-        if (params.abcd == "OLD") {
-            global_dpd_->buf4_init(&CMnEf, PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, CMnEf_lbl);
-            global_dpd_->buf4_init(&Z, PSIF_EOM_TMP, C_irr, 5, 0, 5, 0, 0, "WabefDD Z(Ab,Ij)");
-            global_dpd_->buf4_init(&B, PSIF_CC_BINTS, H_IRR, 5, 5, 5, 5, 0, "B <ab|cd>");
-            global_dpd_->contract444(&B, &CMnEf, &Z, 0, 0, 1.0, 0.0);
-            global_dpd_->buf4_close(&B);
-            global_dpd_->buf4_close(&CMnEf);
-            global_dpd_->buf4_sort(&Z, PSIF_EOM_TMP, rspq, 0, 5, "WabefDD Z(Ij,Ab)");
-            global_dpd_->buf4_close(&Z);
-
-            global_dpd_->buf4_init(&SIjAb, PSIF_EOM_SIjAb, C_irr, 0, 5, 0, 5, 0, SIjAb_lbl);
-            global_dpd_->buf4_init(&Z, PSIF_EOM_TMP, C_irr, 0, 5, 0, 5, 0, "WabefDD Z(Ij,Ab)");
-            global_dpd_->buf4_axpy(&Z, &SIjAb, 1);
-            global_dpd_->buf4_close(&Z);
-            global_dpd_->buf4_close(&SIjAb);
-        } else if (params.abcd == "NEW") {
-            sprintf(lbl_a, "CMnEf(-)(mn,ef) %d", i);
-            sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", i);
-
-            /* L_a(-)(ij,ab) (i>j, a>b) = L(ij,ab) - L(ij,ba) */
-            global_dpd_->buf4_init(&tau_a, PSIF_EOM_CMnEf, C_irr, 4, 9, 0, 5, 1, CMnEf_lbl);
-            global_dpd_->buf4_copy(&tau_a, PSIF_EOM_CMnEf, lbl_a);
-            global_dpd_->buf4_close(&tau_a);
-
-            /* L_s(+)(ij,ab) (i>=j, a>=b) = L(ij,ab) + L(ij,ba) */
-            global_dpd_->buf4_init(&tau_a, PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, CMnEf_lbl);
-            global_dpd_->buf4_copy(&tau_a, PSIF_EOM_TMP, lbl_s);
-            global_dpd_->buf4_sort_axpy(&tau_a, PSIF_EOM_TMP, pqsr, 0, 5, lbl_s, 1);
-            global_dpd_->buf4_close(&tau_a);
-            global_dpd_->buf4_init(&tau_a, PSIF_EOM_TMP, C_irr, 3, 8, 0, 5, 0, lbl_s);
-            global_dpd_->buf4_copy(&tau_a, PSIF_EOM_CMnEf, lbl_s);
-            global_dpd_->buf4_close(&tau_a);
-
-            timer_on("ABCD:S");
-            global_dpd_->buf4_init(&tau_s, PSIF_EOM_CMnEf, C_irr, 3, 8, 3, 8, 0, lbl_s);
-            global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
-            global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, "S(ab,ij)");
-            global_dpd_->contract444(&B_s, &tau_s, &S, 0, 0, 0.5, 0);
-            global_dpd_->buf4_close(&S);
-            global_dpd_->buf4_close(&B_s);
-            global_dpd_->buf4_close(&tau_s);
-            timer_off("ABCD:S");
-
-            /* L_diag(ij,c)  = 2 * L(ij,cc)*/
-
-            /* NB: Gcc = 0, and B is totally symmetric, so Gab = 0 */
-            /* But Gij = L_irr ^ Gab = L_irr */
-            global_dpd_->buf4_init(&tau, PSIF_EOM_CMnEf, C_irr, 3, 8, 3, 8, 0, lbl_s);
-            global_dpd_->buf4_mat_irrep_init(&tau, C_irr);
-            global_dpd_->buf4_mat_irrep_rd(&tau, C_irr);
-            tau_diag = global_dpd_->dpd_block_matrix(tau.params->rowtot[C_irr], moinfo.nvirt);
-            for (ij = 0; ij < tau.params->rowtot[C_irr]; ij++)
-                for (Gc = 0; Gc < moinfo.nirreps; Gc++)
-                    for (C = 0; C < moinfo.virtpi[Gc]; C++) {
-                        c = C + moinfo.vir_off[Gc];
-                        cc = tau.params->colidx[c][c];
-                        tau_diag[ij][c] = tau.matrix[C_irr][ij][cc];
-                    }
-            global_dpd_->buf4_mat_irrep_close(&tau, C_irr);
-
-            global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
-            global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, "S(ab,ij)");
-            global_dpd_->buf4_mat_irrep_init(&S, 0);
-            global_dpd_->buf4_mat_irrep_rd(&S, 0);
-
-            rows_per_bucket = dpd_memfree() / (B_s.params->coltot[0] + moinfo.nvirt);
-            if (rows_per_bucket > B_s.params->rowtot[0]) rows_per_bucket = B_s.params->rowtot[0];
-            nbuckets = (int)ceil((double)B_s.params->rowtot[0] / (double)rows_per_bucket);
-            rows_left = B_s.params->rowtot[0] % rows_per_bucket;
-
-            B_diag = global_dpd_->dpd_block_matrix(rows_per_bucket, moinfo.nvirt);
-            next = PSIO_ZERO;
-            ncols = tau.params->rowtot[C_irr];
-            nlinks = moinfo.nvirt;
-            for (m = 0; m < (rows_left ? nbuckets - 1 : nbuckets); m++) {
-                row_start = m * rows_per_bucket;
-                nrows = rows_per_bucket;
-                if (nrows && ncols && nlinks) {
-                    psio_read(PSIF_CC_BINTS, "B(+) <ab|cc>", (char *)B_diag[0], sizeof(double) * nrows * nlinks, next,
-                              &next);
-                    C_DGEMM('n', 't', nrows, ncols, nlinks, -0.25, B_diag[0], nlinks, tau_diag[0], nlinks, 1,
-                            S.matrix[0][row_start], ncols);
-                }
-            }
-            if (rows_left) {
-                row_start = m * rows_per_bucket;
-                nrows = rows_left;
-                if (nrows && ncols && nlinks) {
-                    psio_read(PSIF_CC_BINTS, "B(+) <ab|cc>", (char *)B_diag[0], sizeof(double) * nrows * nlinks, next,
-                              &next);
-                    C_DGEMM('n', 't', nrows, ncols, nlinks, -0.25, B_diag[0], nlinks, tau_diag[0], nlinks, 1,
-                            S.matrix[0][row_start], ncols);
-                }
-            }
-            global_dpd_->buf4_mat_irrep_wrt(&S, 0);
-            global_dpd_->buf4_mat_irrep_close(&S, 0);
-            global_dpd_->buf4_close(&S);
-            global_dpd_->buf4_close(&B_s);
-            global_dpd_->free_dpd_block(B_diag, rows_per_bucket, moinfo.nvirt);
-            global_dpd_->free_dpd_block(tau_diag, tau.params->rowtot[C_irr], moinfo.nvirt);
-            global_dpd_->buf4_close(&tau);
-
-            timer_on("ABCD:A");
-            global_dpd_->buf4_init(&tau_a, PSIF_EOM_CMnEf, C_irr, 4, 9, 4, 9, 0, lbl_a);
-            global_dpd_->buf4_init(&B_a, PSIF_CC_BINTS, 0, 9, 9, 9, 9, 0, "B(-) <ab|cd> - <ab|dc>");
-            global_dpd_->buf4_init(&A, PSIF_EOM_TMP, C_irr, 9, 4, 9, 4, 0, "A(ab,ij)");
-            global_dpd_->contract444(&B_a, &tau_a, &A, 0, 0, 0.5, 0);
-            global_dpd_->buf4_close(&A);
-            global_dpd_->buf4_close(&B_a);
-            global_dpd_->buf4_close(&tau_a);
-            timer_off("ABCD:A");
-
-            timer_on("ABCD:axpy");
-            global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 5, 0, 8, 3, 0, "S(ab,ij)");
-            global_dpd_->buf4_sort_axpy(&S, PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
-            global_dpd_->buf4_close(&S);
-            global_dpd_->buf4_init(&A, PSIF_EOM_TMP, C_irr, 5, 0, 9, 4, 0, "A(ab,ij)");
-            global_dpd_->buf4_sort_axpy(&A, PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
-            global_dpd_->buf4_close(&A);
-            timer_off("ABCD:axpy");
-        }
-
-        timer_off("WabefDD Z");
-
-        /* construct XIjMb = CIjEf * <mb|ef> */
-        global_dpd_->buf4_init(&X, PSIF_EOM_TMP, C_irr, 10, 0, 10, 0, 0, "WabefDD X(Mb,Ij)");
-        global_dpd_->buf4_init(&CMnEf, PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, CMnEf_lbl);
-        global_dpd_->buf4_init(&F, PSIF_CC_FINTS, H_IRR, 10, 5, 10, 5, 0, "F <ia|bc>");
-        global_dpd_->contract444(&F, &CMnEf, &X, 0, 0, 1.0, 0.0);
-        global_dpd_->buf4_close(&F);
-        global_dpd_->buf4_close(&CMnEf);
+        /* SIjAb += <Ab|Ef> CIjEf and XIjMb = CIjEf * <mb|ef> were done for all
+           new C vectors together in WabefDD_batch() */
+        char X_lbl[32];
+        sprintf(X_lbl, "WabefDD X(Mb,Ij) %d", i);
+        global_dpd_->buf4_init(&X, PSIF_EOM_TMP, C_irr, 10, 0, 10, 0, 0, X_lbl);
 
         global_dpd_->buf4_init(&Z, PSIF_EOM_TMP, C_irr, 5, 0, 5, 0, 0, "WabefDD Z(Ab,Ij)");
         global_dpd_->file2_init(&tIA, PSIF_CC_OEI, H_IRR, 0, 1, "tIA");
@@ -0,0 +1,280 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+/*! \file
+    \ingroup CCEOM
+    \brief Batched <ab|ef> and <mb|ef> contractions of WabefDD
+*/
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "psi4/libpsio/psio.h"
+#include "psi4/libqt/qt.h"
+#include "MOInfo.h"
+#include "Params.h"
+#include "Local.h"
+#define EXTERN
+#include "globals.h"
+
+namespace psi {
+namespace cceom {
+
+/* contract444_batch(): Z_k(pq,ij) = alpha B(pq,rs) C_k(ij,rs) + beta Z_k(pq,ij)
+** for every k, i.e. contract444(B, C_k, Z_k, 0, 0, alpha, beta) for all the
+** C vectors at once.  B must be totally symmetric and all C_k must belong to
+** the same irrep.  As many C_k as fit in half of the free memory are stacked
+** into one matrix, so each bucket of B rows is read once per batch and
+** contracted with a single DGEMM. */
+void contract444_batch(dpdbuf4 *B, std::vector<dpdbuf4> &C, std::vector<dpdbuf4> &Z, double alpha, double beta) {
+    int nvec = C.size();
+    if (!nvec) return;
+    int C_irr = C[0].file.my_irrep;
+
+    for (int k = 0; k < nvec; k++) global_dpd_->buf4_scm(&Z[k], beta);
+
+    for (int Gpq = 0; Gpq < B->params->nirreps; Gpq++) {
+        int Gij = Gpq ^ C_irr; /* B is totally symmetric, so Grs = Gpq */
+        long int npq = B->params->rowtot[Gpq];
+        long int nrs = B->params->coltot[Gpq];
+        long int nij = C[0].params->rowtot[Gij];
+        if (!npq || !nrs || !nij) continue;
+
+        long int per_vec = nij * nrs + npq * nij;
+        int nk = (int)std::min<long int>(nvec, std::max<long int>(1, dpd_memfree() / 2 / per_vec));
+
+        for (int k0 = 0; k0 < nvec; k0 += nk) {
+            int k1 = std::min(nvec, k0 + nk);
+            long int ncols = (k1 - k0) * nij;
+
+            double **Cpack = global_dpd_->dpd_block_matrix(ncols, nrs);
+            for (int k = k0; k < k1; k++) {
+                global_dpd_->buf4_mat_irrep_init(&C[k], Gij);
+                global_dpd_->buf4_mat_irrep_rd(&C[k], Gij);
+                C_DCOPY(nij * nrs, C[k].matrix[Gij][0], 1, Cpack[(k - k0) * nij], 1);
+                global_dpd_->buf4_mat_irrep_close(&C[k], Gij);
+                global_dpd_->buf4_mat_irrep_init(&Z[k], Gpq);
+                global_dpd_->buf4_mat_irrep_rd(&Z[k], Gpq);
+            }
+
+            long int rows_per_bucket = dpd_memfree() / (nrs + ncols);
+            rows_per_bucket = std::max<long int>(1, std::min(rows_per_bucket, npq));
+            double **Zbucket = global_dpd_->dpd_block_matrix(rows_per_bucket, ncols);
+
+            global_dpd_->buf4_mat_irrep_init_block(B, Gpq, rows_per_bucket);
+            for (long int row_start = 0; row_start < npq; row_start += rows_per_bucket) {
+                int nrows = std::min(rows_per_bucket, npq - row_start);
+                global_dpd_->buf4_mat_irrep_rd_block(B, Gpq, row_start, nrows);
+                C_DGEMM('n', 't', nrows, ncols, nrs, alpha, B->matrix[Gpq][0], nrs, Cpack[0], nrs, 0.0, Zbucket[0],
+                        ncols);
+                for (int k = k0; k < k1; k++)
+                    for (int pq = 0; pq < nrows; pq++)
+                        C_DAXPY(nij, 1.0, &Zbucket[pq][(k - k0) * nij], 1, Z[k].matrix[Gpq][row_start + pq], 1);
+            }
+            global_dpd_->buf4_mat_irrep_close_block(B, Gpq, rows_per_bucket);
+
+            global_dpd_->free_dpd_block(Zbucket, rows_per_bucket, ncols);
+            global_dpd_->free_dpd_block(Cpack, ncols, nrs);
+            for (int k = k0; k < k1; k++) {
+                global_dpd_->buf4_mat_irrep_wrt(&Z[k], Gpq);
+                global_dpd_->buf4_mat_irrep_close(&Z[k], Gpq);
+            }
+        }
+    }
+}
+
+/* WabefDD_batch(): the parts of WabefDD that read the <ab|cd> and <ia|bc>
+** integrals, done for the RHF-based C vectors first..last-1 together:
+**
+** SIjAb += <Ab|Ef> CIjEf
+** X(Mb,Ij) = <Mb|Ef> CIjEf  (finished in WabefDD)
+**
+** The B and F files are then read once per batch of vectors instead of once
+** per vector. */
+void WabefDD_batch(int first, int last, int C_irr) {
+    dpdbuf4 B, F, B_s, B_a;
+    char lbl[32], lbl_a[32], lbl_s[32];
+    int nvec = last - first;
+    std::vector<dpdbuf4> C(nvec), Z(nvec);
+
+    timer_on("WabefDD Z");
+    if (params.abcd == "OLD") {
+        for (int k = 0; k < nvec; k++) {
+            sprintf(lbl, "%s %d", "CMnEf", first + k);
+            global_dpd_->buf4_init(&C[k], PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, lbl);
+            sprintf(lbl, "WabefDD Z(Ab,Ij) %d", first + k);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 5, 0, 5, 0, 0, lbl);
+        }
+        global_dpd_->buf4_init(&B, PSIF_CC_BINTS, H_IRR, 5, 5, 5, 5, 0, "B <ab|cd>");
+        contract444_batch(&B, C, Z, 1.0, 0.0);
+        global_dpd_->buf4_close(&B);
+        for (int k = 0; k < nvec; k++) {
+            sprintf(lbl, "%s %d", "SIjAb", first + k);
+            global_dpd_->buf4_sort_axpy(&Z[k], PSIF_EOM_SIjAb, rspq, 0, 5, lbl, 1);
+            global_dpd_->buf4_close(&Z[k]);
+            global_dpd_->buf4_close(&C[k]);
+        }
+    } else if (params.abcd == "NEW") {
+        for (int k = 0; k < nvec; k++) {
+            sprintf(lbl, "%s %d", "CMnEf", first + k);
+            sprintf(lbl_a, "CMnEf(-)(mn,ef) %d", first + k);
+            sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", first + k);
+
+            /* L_a(-)(ij,ab) (i>j, a>b) = L(ij,ab) - L(ij,ba) */
+            global_dpd_->buf4_init(&C[k], PSIF_EOM_CMnEf, C_irr, 4, 9, 0, 5, 1, lbl);
+            global_dpd_->buf4_copy(&C[k], PSIF_EOM_CMnEf, lbl_a);
+            global_dpd_->buf4_close(&C[k]);
+
+            /* L_s(+)(ij,ab) (i>=j, a>=b) = L(ij,ab) + L(ij,ba) */
+            global_dpd_->buf4_init(&C[k], PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, lbl);
+            global_dpd_->buf4_copy(&C[k], PSIF_EOM_TMP, lbl_s);
+            global_dpd_->buf4_sort_axpy(&C[k], PSIF_EOM_TMP, pqsr, 0, 5, lbl_s, 1);
+            global_dpd_->buf4_close(&C[k]);
+            global_dpd_->buf4_init(&C[k], PSIF_EOM_TMP, C_irr, 3, 8, 0, 5, 0, lbl_s);
+            global_dpd_->buf4_copy(&C[k], PSIF_EOM_CMnEf, lbl_s);
+            global_dpd_->buf4_close(&C[k]);
+        }
+
+        timer_on("ABCD:S");
+        for (int k = 0; k < nvec; k++) {
+            sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", first + k);
+            global_dpd_->buf4_init(&C[k], PSIF_EOM_CMnEf, C_irr, 3, 8, 3, 8, 0, lbl_s);
+            sprintf(lbl, "S(ab,ij) %d", first + k);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, lbl);
+        }
+        global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
+        contract444_batch(&B_s, C, Z, 0.5, 0.0);
+        timer_off("ABCD:S");
+
+        /* S(ab,ij) -= 1/4 <ab|cc> L_diag(ij,c), with L_diag(ij,c) = 2 * L(ij,cc) */
+        /* NB: Gcc = 0, and B is totally symmetric, so Gab = 0, but Gij = C_irr */
+        long int nab = B_s.params->rowtot[0];
+        long int nij = C[0].params->rowtot[C_irr];
+        int nvirt = moinfo.nvirt;
+        if (nab && nij && nvirt) {
+            long int per_vec = nij * nvirt + nab * nij;
+            int nk = (int)std::min<long int>(nvec, std::max<long int>(1, dpd_memfree() / 2 / per_vec));
+            for (int k0 = 0; k0 < nvec; k0 += nk) {
+                int k1 = std::min(nvec, k0 + nk);
+                long int ncols = (k1 - k0) * nij;
+
+                double **tau_diag = global_dpd_->dpd_block_matrix(ncols, nvirt);
+                for (int k = k0; k < k1; k++) {
+                    global_dpd_->buf4_mat_irrep_init(&C[k], C_irr);
+                    global_dpd_->buf4_mat_irrep_rd(&C[k], C_irr);
+                    for (int ij = 0; ij < nij; ij++)
+                        for (int Gc = 0; Gc < moinfo.nirreps; Gc++)
+                            for (int cidx = 0; cidx < moinfo.virtpi[Gc]; cidx++) {
+                                int c = cidx + moinfo.vir_off[Gc];
+                                int cc = C[k].params->colidx[c][c];
+                                tau_diag[(k - k0) * nij + ij][c] = C[k].matrix[C_irr][ij][cc];
+                            }
+                    global_dpd_->buf4_mat_irrep_close(&C[k], C_irr);
+                    global_dpd_->buf4_mat_irrep_init(&Z[k], 0);
+                    global_dpd_->buf4_mat_irrep_rd(&Z[k], 0);
+                }
+
+                long int rows_per_bucket = dpd_memfree() / (nvirt + ncols);
+                rows_per_bucket = std::max<long int>(1, std::min(rows_per_bucket, nab));
+                double **B_diag = global_dpd_->dpd_block_matrix(rows_per_bucket, nvirt);
+                double **Zbucket = global_dpd_->dpd_block_matrix(rows_per_bucket, ncols);
+                psio_address next = PSIO_ZERO;
+                for (long int row_start = 0; row_start < nab; row_start += rows_per_bucket) {
+                    int nrows = std::min(rows_per_bucket, nab - row_start);
+                    psio_read(PSIF_CC_BINTS, "B(+) <ab|cc>", (char *)B_diag[0], sizeof(double) * nrows * nvirt, next,
+                              &next);
+                    C_DGEMM('n', 't', nrows, ncols, nvirt, -0.25, B_diag[0], nvirt, tau_diag[0], nvirt, 0.0,
+                            Zbucket[0], ncols);
+                    for (int k = k0; k < k1; k++)
+                        for (int ab = 0; ab < nrows; ab++)
+                            C_DAXPY(nij, 1.0, &Zbucket[ab][(k - k0) * nij], 1, Z[k].matrix[0][row_start + ab], 1);
+                }
+                global_dpd_->free_dpd_block(Zbucket, rows_per_bucket, ncols);
+                global_dpd_->free_dpd_block(B_diag, rows_per_bucket, nvirt);
+                global_dpd_->free_dpd_block(tau_diag, ncols, nvirt);
+                for (int k = k0; k < k1; k++) {
+                    global_dpd_->buf4_mat_irrep_wrt(&Z[k], 0);
+                    global_dpd_->buf4_mat_irrep_close(&Z[k], 0);
+                }
+            }
+        }
+        global_dpd_->buf4_close(&B_s);
+        for (int k = 0; k < nvec; k++) {
+            global_dpd_->buf4_close(&Z[k]);
+            global_dpd_->buf4_close(&C[k]);
+        }
+
+        timer_on("ABCD:A");
+        for (int k = 0; k < nvec; k++) {
+            sprintf(lbl_a, "CMnEf(-)(mn,ef) %d", first + k);
+            global_dpd_->buf4_init(&C[k], PSIF_EOM_CMnEf, C_irr, 4, 9, 4, 9, 0, lbl_a);
+            sprintf(lbl, "A(ab,ij) %d", first + k);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 9, 4, 9, 4, 0, lbl);
+        }
+        global_dpd_->buf4_init(&B_a, PSIF_CC_BINTS, 0, 9, 9, 9, 9, 0, "B(-) <ab|cd> - <ab|dc>");
+        contract444_batch(&B_a, C, Z, 0.5, 0.0);
+        global_dpd_->buf4_close(&B_a);
+        for (int k = 0; k < nvec; k++) {
+            global_dpd_->buf4_close(&Z[k]);
+            global_dpd_->buf4_close(&C[k]);
+        }
+        timer_off("ABCD:A");
+
+        timer_on("ABCD:axpy");
+        for (int k = 0; k < nvec; k++) {
+            char SIjAb_lbl[32];
+            sprintf(SIjAb_lbl, "%s %d", "SIjAb", first + k);
+            sprintf(lbl, "S(ab,ij) %d", first + k);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 5, 0, 8, 3, 0, lbl);
+            global_dpd_->buf4_sort_axpy(&Z[k], PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
+            global_dpd_->buf4_close(&Z[k]);
+            sprintf(lbl, "A(ab,ij) %d", first + k);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 5, 0, 9, 4, 0, lbl);
+            global_dpd_->buf4_sort_axpy(&Z[k], PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
+            global_dpd_->buf4_close(&Z[k]);
+        }
+        timer_off("ABCD:axpy");
+    }
+    timer_off("WabefDD Z");
+
+    /* X(Mb,Ij) = <Mb|Ef> CIjEf */
+    for (int k = 0; k < nvec; k++) {
+        sprintf(lbl, "%s %d", "CMnEf", first + k);
+        global_dpd_->buf4_init(&C[k], PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, lbl);
+        sprintf(lbl, "WabefDD X(Mb,Ij) %d", first + k);
+        global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 10, 0, 10, 0, 0, lbl);
+    }
+    global_dpd_->buf4_init(&F, PSIF_CC_FINTS, H_IRR, 10, 5, 10, 5, 0, "F <ia|bc>");
+    contract444_batch(&F, C, Z, 1.0, 0.0);
+    global_dpd_->buf4_close(&F);
+    for (int k = 0; k < nvec; k++) {
+        global_dpd_->buf4_close(&Z[k]);
+        global_dpd_->buf4_close(&C[k]);
+    }
+}
+
+}  // namespace cceom
+}  // namespace psi
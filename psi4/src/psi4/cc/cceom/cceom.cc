@@ -92,6 +92,8 @@ PsiReturnType cceom(std::shared_ptr<ccenergy::CCEnergyWavefunction> ref_wfn, Opt
     form_dpd_dp();
 
     cachefiles = init_int_array(PSIO_MAXUNIT);
+    /* There is no priority list here, so LOW runs as LRU */
+    int cachetype = (params.cachetype == 2 ? 2 : 0);
 
     if (params.ref == 2) { /* UHF */
         cachelist = cacheprep_uhf(params.cachelev, cachefiles);
@@ -106,7 +108,7 @@ PsiReturnType cceom(std::shared_ptr<ccenergy::CCEnergyWavefunction> ref_wfn, Opt
         spaces.push_back(moinfo.bocc_sym);
         spaces.push_back(moinfo.bvirtpi);
         spaces.push_back(moinfo.bvir_sym);
-        dpd_init(0, moinfo.nirreps, params.memory, 0, cachefiles, cachelist, nullptr, 4, spaces);
+        dpd_init(0, moinfo.nirreps, params.memory, cachetype, cachefiles, cachelist, nullptr, 4, spaces);
     } else { /* RHF or ROHF */
         cachelist = cacheprep_rhf(params.cachelev, cachefiles);
         /* cachelist = init_int_matrix(12,12); */
@@ -116,13 +118,14 @@ PsiReturnType cceom(std::shared_ptr<ccenergy::CCEnergyWavefunction> ref_wfn, Opt
         spaces.push_back(moinfo.occ_sym);
         spaces.push_back(moinfo.virtpi);
         spaces.push_back(moinfo.vir_sym);
-        dpd_init(0, moinfo.nirreps, params.memory, 0, cachefiles, cachelist, nullptr, 2, spaces);
+        dpd_init(0, moinfo.nirreps, params.memory, cachetype, cachefiles, cachelist, nullptr, 2, spaces);
     }
 
     if (params.local) local_init();
 
     diag(*ref_wfn);
 
+    global_dpd_->file4_cache_print_stats("outfile");
     dpd_close(0);
     if (params.local) local_done();
     cleanup();
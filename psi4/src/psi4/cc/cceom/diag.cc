@@ -93,6 +93,7 @@ void sigmaSS(int index, int irrep);
 void sigmaSD(int index, int irrep);
 void sigmaDS(int index, int irrep);
 void sigmaDD(int index, int irrep);
+void WabefDD_batch(int first, int last, int irrep);
 void sigma00(int index, int irrep);
 void sigma0S(int index, int irrep);
 void sigma0D(int index, int irrep);
@@ -323,11 +324,21 @@ void diag(ccenergy::CCEnergyWavefunction& wfn) {
                 /* Form a zeroed S vector for each C vector
                    SIA and Sia do get overwritten by sigmaSS
                    so this may only be necessary for debugging */
-                ++nsigma_evaluations;
                 if (params.full_matrix) init_S0(i);
                 init_S1(i, C_irr);
                 init_S2(i, C_irr);
+            }
+
+            /* The <ab|ef> and <mb|ef> terms of WabefDD for all new C vectors
+               at once, so the B and F integrals are read once per batch */
+            if (params.eom_ref == 0 && params.wfn != "EOM_CC2" && L > already_sigma) {
+                timer_on("WabefDD batch");
+                WabefDD_batch(already_sigma, L, C_irr);
+                timer_off("WabefDD batch");
+            }
 
+            for (int i = already_sigma; i < L; ++i) {
+                ++nsigma_evaluations;
                 sort_C(i, C_irr);
 
 /* Computing sigma vectors */
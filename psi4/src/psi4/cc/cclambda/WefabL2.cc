@@ -126,7 +126,24 @@ void WefabL2(int L_irr) {
     /* RHS += Wefab*Lijef  */
     if (params.ref == 0) { /** RHF **/
 
-        if (params.abcd == "OLD") {
+        if (params.abcd == "DF") {
+            timer_on("ABCD:DF");
+            /* Z(Ab,Ij) = (Ac|Bd) L(Cd,Ij), with (Ac|Bd) built from B(VV|Q) written by ccenergy */
+            global_dpd_->buf4_init(&LIjAb, PSIF_CC_LAMBDA, L_irr, 0, 5, 0, 5, 0, "LIjAb");
+            global_dpd_->buf4_sort(&LIjAb, PSIF_CC_TMP0, rspq, 5, 0, "LAbIj");
+            global_dpd_->buf4_close(&LIjAb);
+            global_dpd_->buf4_init(&L, PSIF_CC_TMP0, L_irr, 5, 0, 5, 0, 0, "LAbIj");
+            global_dpd_->buf4_init(&Z, PSIF_CC_TMP0, L_irr, 5, 0, 5, 0, 0, "ZAbIj");
+            dpd_set_default(1);
+            global_dpd_->buf4_init(&B, PSIF_CC_OEI, 0, 13, 43, 13, 43, 0, "B(VV|Q)");
+            dpd_set_default(0);
+            global_dpd_->contract444_df(&B, &L, &Z, 1.0, 0.0);
+            global_dpd_->buf4_close(&B);
+            global_dpd_->buf4_sort_axpy(&Z, PSIF_CC_LAMBDA, rspq, 0, 5, "New LIjAb", 1);
+            global_dpd_->buf4_close(&Z);
+            global_dpd_->buf4_close(&L);
+            timer_off("ABCD:DF");
+        } else if (params.abcd == "OLD") {
             global_dpd_->buf4_init(&LIjAb, PSIF_CC_LAMBDA, L_irr, 0, 5, 0, 5, 0, "LIjAb");
             global_dpd_->buf4_init(&Z, PSIF_CC_TMP0, L_irr, 5, 0, 5, 0, 0, "ZAbIj");
             global_dpd_->buf4_init(&B, PSIF_CC_BINTS, 0, 5, 5, 5, 5, 0, "B <ab|cd>");
@@ -157,6 +157,16 @@ double CCLambdaWavefunction::compute_energy() {
             aospaces.push_back(moinfo.sosym);
             dpd_init(1, moinfo.nirreps, params.memory, 0, cachefiles, cachelist, nullptr, 2, aospaces);
             dpd_set_default(0);
+        } else if (params.abcd == "DF") { /* Reattach the B(VV|Q) integrals from ccenergy */
+            std::vector<int *> dfspaces;
+            dfspaces.push_back(moinfo.occpi);
+            dfspaces.push_back(moinfo.occ_sym);
+            dfspaces.push_back(moinfo.sopi);
+            dfspaces.push_back(moinfo.sosym);
+            dfspaces.push_back(moinfo.virtpi);
+            dfspaces.push_back(moinfo.vir_sym);
+            init_df_dpd(dfspaces, params.memory, cachelist, cachefiles);
+            dpd_set_default(0);
         }
 
     } else if (params.ref == 2) { /** UHF **/
@@ -290,6 +300,7 @@ double CCLambdaWavefunction::compute_energy() {
         if (!done) {
             outfile->Printf("\t ** Lambda not converged to %2.1e ** \n", params.convergence);
 
+            if (params.abcd == "DF") dpd_close(1);
             dpd_close(0);
             cleanup();
             exit_io();
@@ -331,6 +342,7 @@ double CCLambdaWavefunction::compute_energy() {
 
     if (params.local) local_done();
 
+    if (params.abcd == "DF") dpd_close(1);
     dpd_close(0);
 
     if (params.ref == 2)
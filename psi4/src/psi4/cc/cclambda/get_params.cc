@@ -104,10 +104,12 @@ void CCLambdaWavefunction::get_params(Options &options) {
     params.aobasis = 0; /* AO basis code not yet working for lambda */
 
     params.abcd = options.get_str("ABCD");
-    if (params.abcd == "NEW" && params.abcd == "OLD") {
+    if (params.abcd != "NEW" && params.abcd != "OLD" && params.abcd != "DF") {
         outfile->Printf("Invalid ABCD algorithm: %s\n", params.abcd.c_str());
         throw PsiException("cclambda: error", __FILE__, __LINE__);
     }
+    if (params.abcd == "DF" && params.ref != 0)
+        throw PsiException("cclambda: ABCD = DF requires an RHF reference", __FILE__, __LINE__);
 
     params.num_amps = 10;
     params.num_amps = options.get_int("NUM_AMPS_PRINT");
@@ -34,6 +34,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <string>
+#include <vector>
 #include "psi4/libdpd/dpd.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.h"
@@ -156,5 +158,122 @@ void compute_X(const char *pert, int irrep, double omega) {
     timer_off("compute_X");
 }
 
+/* compute_X_batch(): Solve the perturbed wave-function equations for several
+** perturbations (operator/frequency pairs) in lockstep.  Each iteration
+** builds the new X1/X2 for every unconverged perturbation before moving on,
+** so the Hbar blocks read by X1_build() and X2_build() stay resident in the
+** DPD cache (and the OS page cache) across all of them instead of being
+** re-read from disk for each perturbation separately.  Converged
+** perturbations drop out of the iterations.
+*/
+void compute_X_batch(const std::vector<std::string> &perts, const std::vector<int> &irreps,
+                     const std::vector<double> &omegas) {
+    int i, iter, nleft;
+    double rms, polar, X2_norm;
+    char lbl[32];
+    dpdbuf4 X2;
+    int npert = perts.size();
+    std::vector<int> done(npert, 0);
+
+    if (npert == 1) {
+        compute_X(perts[0].c_str(), irreps[0], omegas[0]);
+        return;
+    }
+
+    timer_on("compute_X");
+
+    outfile->Printf("\n\tComputing %d Perturbed Wave Functions Simultaneously.\n", npert);
+    for (i = 0; i < npert; i++) {
+        outfile->Printf("\t  %-8s (%5.3f E_h)\n", perts[i].c_str(), omegas[i]);
+        init_X(perts[i].c_str(), irreps[i], omegas[i]);
+    }
+    outfile->Printf("\tIter   Perturbation            Pseudopolarizability       RMS \n");
+    outfile->Printf("\t----   ----------------------  --------------------   -----------\n");
+
+    for (i = 0; i < npert; i++) {
+        if (params.wfn == "CC2")
+            cc2_sort_X(perts[i].c_str(), irreps[i], omegas[i]);
+        else
+            sort_X(perts[i].c_str(), irreps[i], omegas[i]);
+        polar = -2.0 * pseudopolar(perts[i].c_str(), irreps[i], omegas[i]);
+        outfile->Printf("\t%4d   %-8s (%6.3f)       %20.12f\n", 0, perts[i].c_str(), omegas[i], polar);
+    }
+
+    nleft = npert;
+    for (iter = 1; iter <= params.maxiter && nleft; iter++) {
+        for (i = 0; i < npert; i++) {
+            if (done[i]) continue;
+            const char *pert = perts[i].c_str();
+            int irrep = irreps[i];
+            double omega = omegas[i];
+
+            if (params.wfn == "CC2") {
+                cc2_sort_X(pert, irrep, omega);
+                cc2_X1_build(pert, irrep, omega);
+                cc2_X2_build(pert, irrep, omega);
+            } else {
+                sort_X(pert, irrep, omega);
+                X1_build(pert, irrep, omega);
+                X2_build(pert, irrep, omega);
+            }
+            update_X(pert, irrep, omega);
+            rms = converged(pert, irrep, omega);
+            if (rms <= params.convergence) {
+                done[i] = 1;
+                nleft--;
+                save_X(pert, irrep, omega);
+                if (params.wfn == "CC2")
+                    cc2_sort_X(pert, irrep, omega);
+                else
+                    sort_X(pert, irrep, omega);
+                outfile->Printf("\t%4d   %-8s (%6.3f)   Converged to %4.3e\n", iter, pert, omega, rms);
+                if (params.print & 2) {
+                    sprintf(lbl, "X_%s_IjAb (%5.3f)", pert, omega);
+                    global_dpd_->buf4_init(&X2, PSIF_CC_LR, irrep, 0, 5, 0, 5, 0, lbl);
+                    X2_norm = global_dpd_->buf4_dot_self(&X2);
+                    global_dpd_->buf4_close(&X2);
+                    X2_norm = sqrt(X2_norm);
+                    outfile->Printf("\tNorm of the converged X2 amplitudes %20.15f\n", X2_norm);
+                    amp_write(pert, irrep, omega);
+                }
+                continue;
+            }
+            if (params.diis) diis(iter, pert, irrep, omega);
+            save_X(pert, irrep, omega);
+            if (params.wfn == "CC2")
+                cc2_sort_X(pert, irrep, omega);
+            else
+                sort_X(pert, irrep, omega);
+
+            polar = -2.0 * pseudopolar(pert, irrep, omega);
+            outfile->Printf("\t%4d   %-8s (%6.3f)       %20.12f    %4.3e\n", iter, pert, omega, polar, rms);
+        }
+    }
+    outfile->Printf("\t-----------------------------------------------------------------\n");
+    if (nleft) {
+        dpd_close(0);
+        cleanup();
+        exit_io();
+        throw PsiException("Failed to converge perturbed wavefunction", __FILE__, __LINE__);
+    }
+
+    /* Clean up disk space */
+    psio_close(PSIF_CC_DIIS_AMP, 0);
+    psio_close(PSIF_CC_DIIS_ERR, 0);
+
+    psio_open(PSIF_CC_DIIS_AMP, 0);
+    psio_open(PSIF_CC_DIIS_ERR, 0);
+
+    for (i = PSIF_CC_TMP; i <= PSIF_CC_TMP11; i++) {
+        psio_close(i, 0);
+        psio_open(i, 0);
+    }
+
+    if (params.analyze)
+        for (i = 0; i < npert; i++) analyze(perts[i].c_str(), irreps[i], omegas[i]);
+
+    timer_off("compute_X");
+}
+
 }  // namespace ccresponse
 }  // namespace psi
@@ -35,6 +35,8 @@
 #include <cstdlib>
 #include <cmath>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "psi4/libpsi4util/process.h"
 #include "psi4/libciomr/libciomr.h"
@@ -54,7 +56,8 @@ namespace psi {
 namespace ccresponse {
 
 void pertbar(const char *pert, int irrep, int anti);
-void compute_X(const char *pert, int irrep, double omega);
+void compute_X_batch(const std::vector<std::string> &perts, const std::vector<int> &irreps,
+                     const std::vector<double> &omegas);
 void linresp(double *tensor, double A, double B, const char *pert_x, int x_irrep, double omega_x, const char *pert_y,
              int y_irrep, double omega_y);
 
@@ -79,12 +82,22 @@ void polar(std::shared_ptr<Wavefunction> ref_wfn) {
     for (i = 0; i < params.nomega; i++) {
         sprintf(lbl, "<<Mu;Mu>_(%5.3f)", params.omega[i]);
         if (!params.restart || !psio_tocscan(PSIF_CC_INFO, lbl)) {
+            std::vector<std::string> perts;
+            std::vector<int> irreps;
+            std::vector<double> omegas;
             for (alpha = 0; alpha < 3; alpha++) {
                 sprintf(pert, "Mu_%1s", cartcomp[alpha]);
                 pertbar(pert, moinfo.mu_irreps[alpha], 0);
-                compute_X(pert, moinfo.mu_irreps[alpha], params.omega[i]);
-                if (params.omega[i] != 0.0) compute_X(pert, moinfo.mu_irreps[alpha], -params.omega[i]);
+                perts.push_back(pert);
+                irreps.push_back(moinfo.mu_irreps[alpha]);
+                omegas.push_back(params.omega[i]);
+                if (params.omega[i] != 0.0) {
+                    perts.push_back(pert);
+                    irreps.push_back(moinfo.mu_irreps[alpha]);
+                    omegas.push_back(-params.omega[i]);
+                }
             }
+            compute_X_batch(perts, irreps, omegas);
 
             outfile->Printf("\n\tComputing %s tensor.\n", lbl);
             for (alpha = 0; alpha < 3; alpha++) {
@@ -41,6 +41,8 @@
 #include <cstring>
 #include <cstdlib>
 #include <cmath>
+#include <string>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libqt/qt.h"
@@ -57,7 +59,8 @@ namespace psi {
 namespace ccresponse {
 
 void pertbar(const char *pert, int irrep, int anti);
-void compute_X(const char *pert, int irrep, double omega);
+void compute_X_batch(const std::vector<std::string> &perts, const std::vector<int> &irreps,
+                     const std::vector<double> &omegas);
 void linresp(double *tensor, double A, double B, const char *pert_x, int x_irrep, double omega_x, const char *pert_y,
              int y_irrep, double omega_y);
 
@@ -111,15 +114,20 @@ void roa(std::shared_ptr<Wavefunction> ref_wfn) {
     if (compute_pl) {
         sprintf(lbl1, "<<P;L>>_(%5.3f)", 0.0);
         if (!params.restart || !psio_tocscan(PSIF_CC_INFO, lbl1)) {
+            std::vector<std::string> perts;
+            std::vector<int> irreps;
             for (alpha = 0; alpha < 3; alpha++) {
                 sprintf(pert, "P_%1s", cartcomp[alpha]);
                 pertbar(pert, moinfo.mu_irreps[alpha], 1);
-                compute_X(pert, moinfo.mu_irreps[alpha], 0);
+                perts.push_back(pert);
+                irreps.push_back(moinfo.mu_irreps[alpha]);
 
                 sprintf(pert, "L_%1s", cartcomp[alpha]);
                 pertbar(pert, moinfo.l_irreps[alpha], 1);
-                compute_X(pert, moinfo.l_irreps[alpha], 0);
+                perts.push_back(pert);
+                irreps.push_back(moinfo.l_irreps[alpha]);
             }
+            compute_X_batch(perts, irreps, std::vector<double>(perts.size(), 0.0));
 
             outfile->Printf("\n\tComputing %s tensor.\n", lbl1);
             for (alpha = 0; alpha < 3; alpha++) {
@@ -210,34 +218,48 @@ void roa(std::shared_ptr<Wavefunction> ref_wfn) {
                 }
             }
 
+            std::vector<std::string> perts;
+            std::vector<int> irreps;
+            std::vector<double> omegas;
             for (alpha = 0; alpha < 3; alpha++) {
                 /* -omega electric-dipole CC wave functions */
                 sprintf(pert, "Mu_%1s", cartcomp[alpha]);
-                compute_X(pert, moinfo.mu_irreps[alpha], -params.omega[i]);
+                perts.push_back(pert);
+                irreps.push_back(moinfo.mu_irreps[alpha]);
+                omegas.push_back(-params.omega[i]);
 
                 /* +omega electric-dipole CC wave functions */
-                sprintf(pert, "Mu_%1s", cartcomp[alpha]);
-                compute_X(pert, moinfo.mu_irreps[alpha], +params.omega[i]);
+                perts.push_back(pert);
+                irreps.push_back(moinfo.mu_irreps[alpha]);
+                omegas.push_back(+params.omega[i]);
 
                 if (compute_pl) {
                     /* -omega velocity electric-dipole CC wave functions */
                     sprintf(pert, "P_%1s", cartcomp[alpha]);
-                    compute_X(pert, moinfo.mu_irreps[alpha], -params.omega[i]);
+                    perts.push_back(pert);
+                    irreps.push_back(moinfo.mu_irreps[alpha]);
+                    omegas.push_back(-params.omega[i]);
                 }
 
                 /* +omega magnetic-dipole CC wave functions */
                 sprintf(pert, "L_%1s", cartcomp[alpha]);
-                compute_X(pert, moinfo.l_irreps[alpha], +params.omega[i]);
+                perts.push_back(pert);
+                irreps.push_back(moinfo.l_irreps[alpha]);
+                omegas.push_back(+params.omega[i]);
             }
+            compute_X_batch(perts, irreps, omegas);
 
             /* +omega electric-quadrupole CC wave functions */
+            perts.clear();
+            irreps.clear();
             for (alpha = 0; alpha < 3; alpha++) {
                 for (beta = 0; beta < 3; beta++) {
                     sprintf(pert, "Q_%1s%1s", cartcomp[alpha], cartcomp[beta]);
-                    irrep = moinfo.mu_irreps[alpha] ^ moinfo.mu_irreps[beta];
-                    compute_X(pert, irrep, params.omega[i]);
+                    perts.push_back(pert);
+                    irreps.push_back(moinfo.mu_irreps[alpha] ^ moinfo.mu_irreps[beta]);
                 }
             }
+            compute_X_batch(perts, irreps, std::vector<double>(perts.size(), params.omega[i]));
 
             outfile->Printf("\n");
             outfile->Printf("\tComputing %s tensor.\n", lbl3);
@@ -337,23 +359,35 @@ void roa(std::shared_ptr<Wavefunction> ref_wfn) {
             }
 
             /* +omega velocity electric-dipole CC wave functions */
+            std::vector<std::string> perts;
+            std::vector<int> irreps;
+            std::vector<double> omegas;
             for (alpha = 0; alpha < 3; alpha++) {
                 if (compute_pl) {
                     sprintf(pert, "P*_%1s", cartcomp[alpha]);
-                    compute_X(pert, moinfo.mu_irreps[alpha], params.omega[i]);
+                    perts.push_back(pert);
+                    irreps.push_back(moinfo.mu_irreps[alpha]);
+                    omegas.push_back(params.omega[i]);
                 }
 
                 /* -omega magnetic-dipole CC wave functions */
                 sprintf(pert, "L*_%1s", cartcomp[alpha]);
-                compute_X(pert, moinfo.l_irreps[alpha], -params.omega[i]);
+                perts.push_back(pert);
+                irreps.push_back(moinfo.l_irreps[alpha]);
+                omegas.push_back(-params.omega[i]);
             }
+            compute_X_batch(perts, irreps, omegas);
 
+            perts.clear();
+            irreps.clear();
             for (alpha = 0; alpha < 3; alpha++) {
                 for (beta = 0; beta < 3; beta++) {
                     sprintf(pert, "Q_%1s%1s", cartcomp[alpha], cartcomp[beta]);
-                    compute_X(pert, moinfo.mu_irreps[alpha] ^ moinfo.mu_irreps[beta], -params.omega[i]);
+                    perts.push_back(pert);
+                    irreps.push_back(moinfo.mu_irreps[alpha] ^ moinfo.mu_irreps[beta]);
                 }
             }
+            compute_X_batch(perts, irreps, std::vector<double>(perts.size(), -params.omega[i]));
 
             outfile->Printf("\n");
             if (compute_rl) {
@@ -29,9 +29,11 @@
 /*! \file \ingroup CCTRIPLES
     \brief Enter brief description of file here
 */
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -45,14 +47,16 @@
 #define EXTERN
 #include "globals.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
-// MKL Header
-#ifdef USING_LAPACK_MKL
-#include <mkl.h>
-#endif
 
 namespace psi {
 namespace cctriples {
 
+/* One (T) task: an i >= j >= k triple of occupied orbitals */
+struct ET_RHF_ijk {
+    int Gi, Gj, Gk;
+    int i, j, k;
+};
+
 struct ET_RHF_thread_data {
     dpdfile2 *fIJ;
     dpdfile2 *fAB;
@@ -62,24 +66,37 @@ struct ET_RHF_thread_data {
     dpdbuf4 *Eints;
     dpdbuf4 *Dints;
     dpdbuf4 *Fints_local;
+    bool Fints_incore; /* Fints_local is the shared, fully read F buffer */
     double *ET_local;
-    int Gi;
-    int Gj;
-    int Gk;
-    int first_ijk;
-    int last_ijk;
+    const std::vector<ET_RHF_ijk> *tasks;
+    std::atomic<size_t> *next_task;
 };
 
 void ET_RHF_thread(ET_RHF_thread_data *);
 
+/* The F <id|ab> rows for P and all d of one irrep, either in the shared
+   in-core F buffer or read into the thread's own one */
+static double **ET_RHF_F_block(ET_RHF_thread_data *data, int h, int P, int nrows) {
+    dpdbuf4 *Fints = data->Fints_local;
+    if (data->Fints_incore) return nrows ? Fints->matrix[h] + Fints->row_offset[h][P] : nullptr;
+
+    Fints->matrix[h] = global_dpd_->dpd_block_matrix(nrows, Fints->params->coltot[h]);
+#pragma omp critical
+    global_dpd_->buf4_mat_irrep_rd_block(Fints, h, Fints->row_offset[h][P], nrows);
+    return Fints->matrix[h];
+}
+
+static void ET_RHF_F_release(ET_RHF_thread_data *data, double **F, int h, int nrows) {
+    if (!data->Fints_incore) global_dpd_->free_dpd_block(F, nrows, data->Fints_local->params->coltot[h]);
+}
+
 double ET_RHF() {
-    int i, j, k, I, J, K, Gi, Gj, Gk, h, nirreps, cnt;
-    int nijk, nthreads, thread, *ijk_part;
+    int i, j, k, I, J, K, Gi, Gj, Gk, h, nirreps;
+    int nijk, nthreads, thread;
     int *occpi, *virtpi, *occ_off, *vir_off;
     double ET, *ET_array;
     dpdfile2 fIJ, fAB, fIA, T1;
     dpdbuf4 T2, Eints, Dints, *Fints_array;
-    FILE *ijkfile;
 
     timer_on("ET_RHF");
 
@@ -98,8 +115,21 @@ double ET_RHF() {
         if (virtpi[h] > max_a) max_a = virtpi[h];
     long int thread_mem_estimate = 4 * max_a * max_a * max_a;
 
+    // If all of F <ia|bc> fits next to the requested threads' W intermediates, keep one
+    // shared copy in core; each thread then needs one abc-block less and reads nothing.
+    long int F_size = 0;
+    const dpdparams4 *Fparams = &(global_dpd_->params4[10][5]);
+    for (h = 0; h < nirreps; ++h) F_size += (long int)Fparams->rowtot[h] * Fparams->coltot[h];
+    long int incore_thread_mem = 3 * max_a * max_a * max_a;
+    bool Fints_incore = F_size + (nthreads + 0.5) * incore_thread_mem <= mem_avail;
+    if (Fints_incore) {
+        mem_avail -= F_size;
+        thread_mem_estimate = incore_thread_mem;
+    }
+
     outfile->Printf("    Memory available in words               : %15ld\n", mem_avail);
     outfile->Printf("    Approx. words needed per explicit thread: %15ld\n", thread_mem_estimate);
+    outfile->Printf("    F <ia|bc> integrals held in core        : %15s\n", Fints_incore ? "yes" : "no");
 
     // subtract at least 1/2 for non-abc quantities (mainly 2 ijab's + other buffers)
     double tval = (double)mem_avail / (double)thread_mem_estimate;
@@ -115,12 +145,9 @@ double ET_RHF() {
 
     outfile->Printf("    Number of threads for explicit ijk threading: %4d\n\n", nthreads);
 
-// Don't parallelize mkl if explicit threads are used; should be added for acml too.
-#ifdef USING_LAPACK_MKL
-    int old_threads = mkl_get_max_threads();
-    mkl_set_num_threads(1);
-    outfile->Printf("    MKL num_threads set to 1 for explicit threading.\n\n");
-#endif
+    // The ijk threads share what is left for their BLAS calls
+    BlasThreads blas_threads(BlasThreads::Outer, nthreads, "ET_RHF");
+    outfile->Printf("    BLAS num_threads set to %d for explicit threading.\n\n", blas_threads.blas_threads());
 
     std::vector<ET_RHF_thread_data> thread_data_array(nthreads);
 
@@ -156,12 +183,24 @@ double ET_RHF() {
     // ffile(&ijkfile,"ijk.dat", 0);
 
     /* each thread gets its own F buffer to assign memory and read blocks
-       into and its own energy double - all else shared */
-    Fints_array = (dpdbuf4 *)malloc(nthreads * sizeof(dpdbuf4));
-    for (thread = 0; thread < nthreads; ++thread)
+       into, unless the single F buffer is held in core,
+       and its own energy double - all else shared */
+    int nFints = Fints_incore ? 1 : nthreads;
+    Fints_array = (dpdbuf4 *)malloc(nFints * sizeof(dpdbuf4));
+    for (thread = 0; thread < nFints; ++thread)
         global_dpd_->buf4_init(&(Fints_array[thread]), PSIF_CC_FINTS, 0, 10, 5, 10, 5, 0, "F <ia|bc>");
+    if (Fints_incore) {
+        for (h = 0; h < nirreps; h++) {
+            global_dpd_->buf4_mat_irrep_init(&(Fints_array[0]), h);
+            global_dpd_->buf4_mat_irrep_rd(&(Fints_array[0]), h);
+        }
+    }
     ET_array = (double *)malloc(nthreads * sizeof(double));
-    ijk_part = new int[nthreads];
+
+    /* The ijk triples of all irreps form one queue, from which the threads claim
+       one triple at a time, so that no thread idles while others finish */
+    std::vector<ET_RHF_ijk> tasks;
+    std::atomic<size_t> next_task(0);
 
     for (thread = 0; thread < nthreads; ++thread) {
         thread_data_array[thread].fIJ = &fIJ;
@@ -171,8 +210,12 @@ double ET_RHF() {
         thread_data_array[thread].T2 = &T2;
         thread_data_array[thread].Eints = &Eints;
         thread_data_array[thread].Dints = &Dints;
-        thread_data_array[thread].Fints_local = &(Fints_array[thread]);
+        thread_data_array[thread].Fints_local = &(Fints_array[Fints_incore ? 0 : thread]);
+        thread_data_array[thread].Fints_incore = Fints_incore;
         thread_data_array[thread].ET_local = &(ET_array[thread]);
+        thread_data_array[thread].tasks = &tasks;
+        thread_data_array[thread].next_task = &next_task;
+        ET_array[thread] = 0.0;
     }
 
     /* Compute total number of IJK combinations */
@@ -192,7 +235,6 @@ double ET_RHF() {
                 }
     printer->Printf("Total number of IJK combinations =: %d\n", nijk);
 
-    ET = 0.0;
     for (Gi = 0; Gi < nirreps; Gi++) {
         for (Gj = 0; Gj < nirreps; Gj++) {
             for (Gk = 0; Gk < nirreps; Gk++) {
@@ -203,51 +245,30 @@ double ET_RHF() {
                         J = occ_off[Gj] + j;
                         for (k = 0; k < occpi[Gk]; k++) {
                             K = occ_off[Gk] + k;
-                            if (I >= J && J >= K) nijk++;
+                            if (I >= J && J >= K) {
+                                tasks.push_back({Gi, Gj, Gk, i, j, k});
+                                nijk++;
+                            }
                         }
                     }
                 }
                 printer->Printf("Num. of IJK with (Gi,Gj,Gk)=(%d,%d,%d) =: %d\n", Gi, Gj, Gk, nijk);
-                if (nijk == 0) continue;
-
-                for (thread = 0; thread < nthreads; ++thread) {
-                    thread_data_array[thread].Gi = Gi;
-                    thread_data_array[thread].Gj = Gj;
-                    thread_data_array[thread].Gk = Gk;
-                    ET_array[thread] = 0.0;
-                    ijk_part[thread] = nijk / nthreads;  // number of ijk for each thread
-                    if (thread < (nijk % nthreads)) ++ijk_part[thread];
-                }
-
-                cnt = 0;
-                for (thread = 0; thread < nthreads; ++thread) {
-                    if (!ijk_part[thread]) continue;  // there are more threads than nijk
-                    thread_data_array[thread].first_ijk = cnt;
-                    cnt += ijk_part[thread];
-                    thread_data_array[thread].last_ijk = cnt - 1;
-                }
-
-                /* execute threads */
-                for (thread = 0; thread < nthreads; ++thread) {
-                    if (!ijk_part[thread]) continue;
-                    printer->Printf("    thread %d: first_ijk=%d,  last_ijk=%d\n", thread,
-                                    thread_data_array[thread].first_ijk, thread_data_array[thread].last_ijk);
-                }
+            } /* Gk */
+        }     /* Gj */
+    }         /* Gi */
 
+    /* execute threads */
 #pragma omp parallel num_threads(nthreads)
-                {
-                    int ithread = 0;
+    {
+        int ithread = 0;
 #ifdef _OPENMP
-                    ithread = omp_get_thread_num();
+        ithread = omp_get_thread_num();
 #endif
-                    if (ijk_part[ithread]) ET_RHF_thread(&thread_data_array[ithread]);
-                }
-
-                for (thread = 0; thread < nthreads; ++thread) ET += ET_array[thread];
+        ET_RHF_thread(&thread_data_array[ithread]);
+    }
 
-            } /* Gk */
-        }     /* Gj */
-    }         /* Gi */
+    ET = 0.0;
+    for (thread = 0; thread < nthreads; ++thread) ET += ET_array[thread];
 
     for (h = 0; h < nirreps; h++) {
         global_dpd_->buf4_mat_irrep_close(&T2, h);
@@ -268,23 +289,20 @@ double ET_RHF() {
     global_dpd_->file2_close(&fAB);
     global_dpd_->file2_close(&fIA);
 
-    for (thread = 0; thread < nthreads; ++thread) global_dpd_->buf4_close(&(Fints_array[thread]));
+    if (Fints_incore)
+        for (h = 0; h < nirreps; h++) global_dpd_->buf4_mat_irrep_close(&(Fints_array[0]), h);
+    for (thread = 0; thread < nFints; ++thread) global_dpd_->buf4_close(&(Fints_array[thread]));
 
     free(Fints_array);
     free(ET_array);
-    delete[] ijk_part;
 
     timer_off("ET_RHF");
 
-#ifdef USING_LAPACK_MKL
-    mkl_set_num_threads(old_threads);
-#endif
-
     return ET;
 }
 
 void ET_RHF_thread(ET_RHF_thread_data *data) {
-    int h, nirreps, cnt_ijk;
+    int h, nirreps;
     int Gp, p, nump;
     int nrows, ncols, nlinks;
     int Gijk, Gid, Gkd, Gjd, Gil, Gkl, Gjl;
@@ -304,7 +322,7 @@ void ET_RHF_thread(ET_RHF_thread_data *data) {
     double ***W0, ***W1, ***V, ***X, ***Y, ***Z;
     dpdbuf4 *T2, *Eints, *Dints, *Fints;
     dpdfile2 *fIJ, *fAB, *fIA, *T1;
-    int nijk, nthreads, first_ijk, last_ijk, thr_id;
+    double **F;
 
     nirreps = moinfo.nirreps;
     occpi = moinfo.occpi;
@@ -321,11 +339,6 @@ void ET_RHF_thread(ET_RHF_thread_data *data) {
     Dints = data->Dints;
     Fints = data->Fints_local;
     ET_local = data->ET_local;  // pointer to where thread E goes
-    Gi = data->Gi;
-    Gj = data->Gj;
-    Gk = data->Gk;
-    first_ijk = data->first_ijk;
-    last_ijk = data->last_ijk;
 
     W0 = (double ***)malloc(nirreps * sizeof(double **));
     W1 = (double ***)malloc(nirreps * sizeof(double **));
@@ -334,550 +347,544 @@ void ET_RHF_thread(ET_RHF_thread_data *data) {
     Y = (double ***)malloc(nirreps * sizeof(double **));
     Z = (double ***)malloc(nirreps * sizeof(double **));
 
-    Gkj = Gjk = Gk ^ Gj;
-    Gji = Gij = Gi ^ Gj;
-    Gik = Gki = Gi ^ Gk;
-    Gijk = Gi ^ Gj ^ Gk;
-
-    cnt_ijk = -1;
-    for (i = 0; i < occpi[Gi]; i++) {
+    /* Claim ijk triples from the shared queue until it runs dry */
+    for (size_t task = data->next_task->fetch_add(1); task < data->tasks->size();
+         task = data->next_task->fetch_add(1)) {
+        const ET_RHF_ijk &ijk = (*data->tasks)[task];
+        Gi = ijk.Gi;
+        Gj = ijk.Gj;
+        Gk = ijk.Gk;
+        i = ijk.i;
+        j = ijk.j;
+        k = ijk.k;
         I = occ_off[Gi] + i;
-        for (j = 0; j < occpi[Gj]; j++) {
-            J = occ_off[Gj] + j;
-            for (k = 0; k < occpi[Gk]; k++) {
-                K = occ_off[Gk] + k;
-                if (I >= J && J >= K) {
-                    ++cnt_ijk;
-                    /* check to see if this ijk is for this thread */
-                    if ((cnt_ijk < first_ijk) || (cnt_ijk > last_ijk)) continue;
-
-                    ij = T2->params->rowidx[I][J];
-                    ji = T2->params->rowidx[J][I];
-                    ik = T2->params->rowidx[I][K];
-                    ki = T2->params->rowidx[K][I];
-                    jk = T2->params->rowidx[J][K];
-                    kj = T2->params->rowidx[K][J];
-
-                    dijk = 0.0;
-                    if (fIJ->params->rowtot[Gi]) dijk += fIJ->matrix[Gi][i][i];
-                    if (fIJ->params->rowtot[Gj]) dijk += fIJ->matrix[Gj][j][j];
-                    if (fIJ->params->rowtot[Gk]) dijk += fIJ->matrix[Gk][k][k];
-
-                    /* Malloc space for the W intermediate */
-
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
-
-                        W0[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                        W1[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                    }
-                    // timer_off("malloc");
+        J = occ_off[Gj] + j;
+        K = occ_off[Gk] + k;
 
-                    // timer_on("N7 Terms");
+        Gkj = Gjk = Gk ^ Gj;
+        Gji = Gij = Gi ^ Gj;
+        Gik = Gki = Gi ^ Gk;
+        Gijk = Gi ^ Gj ^ Gk;
 
-                    /* +F_idab * t_kjcd */
-                    for (Gd = 0; Gd < nirreps; Gd++) {
-                        Gab = Gid = Gi ^ Gd;
-                        Gc = Gkj ^ Gd;
+        ij = T2->params->rowidx[I][J];
+        ji = T2->params->rowidx[J][I];
+        ik = T2->params->rowidx[I][K];
+        ki = T2->params->rowidx[K][I];
+        jk = T2->params->rowidx[J][K];
+        kj = T2->params->rowidx[K][J];
 
-                        /* Set up F integrals */
-                        Fints->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gid]);
-#pragma omp critical
-                        global_dpd_->buf4_mat_irrep_rd_block(Fints, Gid, Fints->row_offset[Gid][I], virtpi[Gd]);
+        dijk = 0.0;
+        if (fIJ->params->rowtot[Gi]) dijk += fIJ->matrix[Gi][i][i];
+        if (fIJ->params->rowtot[Gj]) dijk += fIJ->matrix[Gj][j][j];
+        if (fIJ->params->rowtot[Gk]) dijk += fIJ->matrix[Gk][k][k];
 
-                        /* Set up T2 amplitudes */
-                        cd = T2->col_offset[Gkj][Gc];
+        /* Malloc space for the W intermediate */
 
-                        /* Set up multiplication parameters */
-                        nrows = Fints->params->coltot[Gid];
-                        ncols = virtpi[Gc];
-                        nlinks = virtpi[Gd];
+        // timer_on("malloc");
+        for (Gab = 0; Gab < nirreps; Gab++) {
+            Gc = Gab ^ Gijk;
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gid][0][0]), nrows,
-                                    &(T2->matrix[Gkj][kj][cd]), nlinks, 0.0, &(W0[Gab][0][0]), ncols);
+            W0[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
+            W1[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
+        }
+        // timer_off("malloc");
 
-                        global_dpd_->free_dpd_block(Fints->matrix[Gid], virtpi[Gd], Fints->params->coltot[Gid]);
-                    }
+        // timer_on("N7 Terms");
 
-                    /* -E_jklc * t_ilab */
-                    for (Gl = 0; Gl < nirreps; Gl++) {
-                        Gab = Gil = Gi ^ Gl;
-                        Gc = Gjk ^ Gl;
+        /* +F_idab * t_kjcd */
+        for (Gd = 0; Gd < nirreps; Gd++) {
+            Gab = Gid = Gi ^ Gd;
+            Gc = Gkj ^ Gd;
 
-                        /* Set up E integrals */
-                        lc = Eints->col_offset[Gjk][Gl];
+            /* Set up F integrals */
+            F = ET_RHF_F_block(data, Gid, I, virtpi[Gd]);
 
-                        /* Set up T2 amplitudes */
-                        il = T2->row_offset[Gil][I];
+            /* Set up T2 amplitudes */
+            cd = T2->col_offset[Gkj][Gc];
 
-                        /* Set up multiplication parameters */
-                        nrows = T2->params->coltot[Gil];
-                        ncols = virtpi[Gc];
-                        nlinks = occpi[Gl];
+            /* Set up multiplication parameters */
+            nrows = Fints->params->coltot[Gid];
+            ncols = virtpi[Gc];
+            nlinks = virtpi[Gd];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gil][il][0]), nrows,
-                                    &(Eints->matrix[Gjk][jk][lc]), ncols, 1.0, &(W0[Gab][0][0]), ncols);
-                    }
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(F[0][0]), nrows,
+                        &(T2->matrix[Gkj][kj][cd]), nlinks, 0.0, &(W0[Gab][0][0]), ncols);
 
-                    /* Sort W[ab][c] --> W[ac][b] */
-                    global_dpd_->sort_3d(W0, W1, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
-                                         Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
-                                         vir_off, virtpi, vir_off, Fints->params->colidx, acb, 0);
+            ET_RHF_F_release(data, F, Gid, virtpi[Gd]);
+        }
 
-                    /* +F_idac * t_jkbd */
-                    for (Gd = 0; Gd < nirreps; Gd++) {
-                        Gac = Gid = Gi ^ Gd;
-                        Gb = Gjk ^ Gd;
+        /* -E_jklc * t_ilab */
+        for (Gl = 0; Gl < nirreps; Gl++) {
+            Gab = Gil = Gi ^ Gl;
+            Gc = Gjk ^ Gl;
 
-                        Fints->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gid]);
-#pragma omp critical
-                        global_dpd_->buf4_mat_irrep_rd_block(Fints, Gid, Fints->row_offset[Gid][I], virtpi[Gd]);
+            /* Set up E integrals */
+            lc = Eints->col_offset[Gjk][Gl];
 
-                        bd = T2->col_offset[Gjk][Gb];
+            /* Set up T2 amplitudes */
+            il = T2->row_offset[Gil][I];
 
-                        nrows = Fints->params->coltot[Gid];
-                        ncols = virtpi[Gb];
-                        nlinks = virtpi[Gd];
+            /* Set up multiplication parameters */
+            nrows = T2->params->coltot[Gil];
+            ncols = virtpi[Gc];
+            nlinks = occpi[Gl];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gid][0][0]), nrows,
-                                    &(T2->matrix[Gjk][jk][bd]), nlinks, 1.0, &(W1[Gac][0][0]), ncols);
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gil][il][0]), nrows,
+                        &(Eints->matrix[Gjk][jk][lc]), ncols, 1.0, &(W0[Gab][0][0]), ncols);
+        }
 
-                        global_dpd_->free_dpd_block(Fints->matrix[Gid], virtpi[Gd], Fints->params->coltot[Gid]);
-                    }
+        /* Sort W[ab][c] --> W[ac][b] */
+        global_dpd_->sort_3d(W0, W1, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
+                             Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
+                             vir_off, virtpi, vir_off, Fints->params->colidx, acb, 0);
 
-                    /* -E_kjlb * t_ilac */
-                    for (Gl = 0; Gl < nirreps; Gl++) {
-                        Gac = Gil = Gi ^ Gl;
-                        Gb = Gkj ^ Gl;
+        /* +F_idac * t_jkbd */
+        for (Gd = 0; Gd < nirreps; Gd++) {
+            Gac = Gid = Gi ^ Gd;
+            Gb = Gjk ^ Gd;
 
-                        lb = Eints->col_offset[Gkj][Gl];
+            F = ET_RHF_F_block(data, Gid, I, virtpi[Gd]);
 
-                        il = T2->row_offset[Gil][I];
+            bd = T2->col_offset[Gjk][Gb];
 
-                        nrows = T2->params->coltot[Gil];
-                        ncols = virtpi[Gb];
-                        nlinks = occpi[Gl];
+            nrows = Fints->params->coltot[Gid];
+            ncols = virtpi[Gb];
+            nlinks = virtpi[Gd];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gil][il][0]), nrows,
-                                    &(Eints->matrix[Gkj][kj][lb]), ncols, 1.0, &(W1[Gac][0][0]), ncols);
-                    }
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(F[0][0]), nrows,
+                        &(T2->matrix[Gjk][jk][bd]), nlinks, 1.0, &(W1[Gac][0][0]), ncols);
 
-                    /* Sort W[ac][b] --> W[ca][b] */
-                    global_dpd_->sort_3d(W1, W0, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
-                                         Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
-                                         vir_off, virtpi, vir_off, Fints->params->colidx, bac, 0);
+            ET_RHF_F_release(data, F, Gid, virtpi[Gd]);
+        }
 
-                    /* +F_kdca * t_jibd */
-                    for (Gd = 0; Gd < nirreps; Gd++) {
-                        Gca = Gkd = Gk ^ Gd;
-                        Gb = Gji ^ Gd;
+        /* -E_kjlb * t_ilac */
+        for (Gl = 0; Gl < nirreps; Gl++) {
+            Gac = Gil = Gi ^ Gl;
+            Gb = Gkj ^ Gl;
 
-                        Fints->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gkd]);
-#pragma omp critical
-                        global_dpd_->buf4_mat_irrep_rd_block(Fints, Gkd, Fints->row_offset[Gkd][K], virtpi[Gd]);
+            lb = Eints->col_offset[Gkj][Gl];
 
-                        bd = T2->col_offset[Gji][Gb];
+            il = T2->row_offset[Gil][I];
 
-                        nrows = Fints->params->coltot[Gkd];
-                        ncols = virtpi[Gb];
-                        nlinks = virtpi[Gd];
+            nrows = T2->params->coltot[Gil];
+            ncols = virtpi[Gb];
+            nlinks = occpi[Gl];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gkd][0][0]), nrows,
-                                    &(T2->matrix[Gji][ji][bd]), nlinks, 1.0, &(W0[Gca][0][0]), ncols);
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gil][il][0]), nrows,
+                        &(Eints->matrix[Gkj][kj][lb]), ncols, 1.0, &(W1[Gac][0][0]), ncols);
+        }
 
-                        global_dpd_->free_dpd_block(Fints->matrix[Gkd], virtpi[Gd], Fints->params->coltot[Gkd]);
-                    }
+        /* Sort W[ac][b] --> W[ca][b] */
+        global_dpd_->sort_3d(W1, W0, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
+                             Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
+                             vir_off, virtpi, vir_off, Fints->params->colidx, bac, 0);
 
-                    /* -E_ijlb * t_klca */
-                    for (Gl = 0; Gl < nirreps; Gl++) {
-                        Gca = Gkl = Gk ^ Gl;
-                        Gb = Gij ^ Gl;
+        /* +F_kdca * t_jibd */
+        for (Gd = 0; Gd < nirreps; Gd++) {
+            Gca = Gkd = Gk ^ Gd;
+            Gb = Gji ^ Gd;
 
-                        lb = Eints->col_offset[Gij][Gl];
+            F = ET_RHF_F_block(data, Gkd, K, virtpi[Gd]);
 
-                        kl = T2->row_offset[Gkl][K];
+            bd = T2->col_offset[Gji][Gb];
 
-                        nrows = T2->params->coltot[Gkl];
-                        ncols = virtpi[Gb];
-                        nlinks = occpi[Gl];
+            nrows = Fints->params->coltot[Gkd];
+            ncols = virtpi[Gb];
+            nlinks = virtpi[Gd];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gkl][kl][0]), nrows,
-                                    &(Eints->matrix[Gij][ij][lb]), ncols, 1.0, &(W0[Gca][0][0]), ncols);
-                    }
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(F[0][0]), nrows,
+                        &(T2->matrix[Gji][ji][bd]), nlinks, 1.0, &(W0[Gca][0][0]), ncols);
 
-                    /* Sort W[ca][b] --> W[cb][a] */
-                    global_dpd_->sort_3d(W0, W1, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
-                                         Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
-                                         vir_off, virtpi, vir_off, Fints->params->colidx, acb, 0);
+            ET_RHF_F_release(data, F, Gkd, virtpi[Gd]);
+        }
 
-                    /* +F_kdcb * t_ijad */
-                    for (Gd = 0; Gd < nirreps; Gd++) {
-                        Gcb = Gkd = Gk ^ Gd;
-                        Ga = Gij ^ Gd;
+        /* -E_ijlb * t_klca */
+        for (Gl = 0; Gl < nirreps; Gl++) {
+            Gca = Gkl = Gk ^ Gl;
+            Gb = Gij ^ Gl;
 
-                        Fints->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gkd]);
-#pragma omp critical
-                        global_dpd_->buf4_mat_irrep_rd_block(Fints, Gkd, Fints->row_offset[Gkd][K], virtpi[Gd]);
+            lb = Eints->col_offset[Gij][Gl];
 
-                        ad = T2->col_offset[Gij][Ga];
+            kl = T2->row_offset[Gkl][K];
 
-                        nrows = Fints->params->coltot[Gkd];
-                        ncols = virtpi[Ga];
-                        nlinks = virtpi[Gd];
+            nrows = T2->params->coltot[Gkl];
+            ncols = virtpi[Gb];
+            nlinks = occpi[Gl];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gkd][0][0]), nrows,
-                                    &(T2->matrix[Gij][ij][ad]), nlinks, 1.0, &(W1[Gcb][0][0]), ncols);
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gkl][kl][0]), nrows,
+                        &(Eints->matrix[Gij][ij][lb]), ncols, 1.0, &(W0[Gca][0][0]), ncols);
+        }
 
-                        global_dpd_->free_dpd_block(Fints->matrix[Gkd], virtpi[Gd], Fints->params->coltot[Gkd]);
-                    }
+        /* Sort W[ca][b] --> W[cb][a] */
+        global_dpd_->sort_3d(W0, W1, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
+                             Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
+                             vir_off, virtpi, vir_off, Fints->params->colidx, acb, 0);
 
-                    /* -E_jila * t_klcb */
-                    for (Gl = 0; Gl < nirreps; Gl++) {
-                        Gcb = Gkl = Gk ^ Gl;
-                        Ga = Gji ^ Gl;
+        /* +F_kdcb * t_ijad */
+        for (Gd = 0; Gd < nirreps; Gd++) {
+            Gcb = Gkd = Gk ^ Gd;
+            Ga = Gij ^ Gd;
 
-                        la = Eints->col_offset[Gji][Gl];
+            F = ET_RHF_F_block(data, Gkd, K, virtpi[Gd]);
 
-                        kl = T2->row_offset[Gkl][K];
+            ad = T2->col_offset[Gij][Ga];
 
-                        nrows = T2->params->coltot[Gkl];
-                        ncols = virtpi[Ga];
-                        nlinks = occpi[Gl];
+            nrows = Fints->params->coltot[Gkd];
+            ncols = virtpi[Ga];
+            nlinks = virtpi[Gd];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gkl][kl][0]), nrows,
-                                    &(Eints->matrix[Gji][ji][la]), ncols, 1.0, &(W1[Gcb][0][0]), ncols);
-                    }
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(F[0][0]), nrows,
+                        &(T2->matrix[Gij][ij][ad]), nlinks, 1.0, &(W1[Gcb][0][0]), ncols);
 
-                    /* Sort W[cb][a] --> W[bc][a] */
-                    global_dpd_->sort_3d(W1, W0, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
-                                         Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
-                                         vir_off, virtpi, vir_off, Fints->params->colidx, bac, 0);
+            ET_RHF_F_release(data, F, Gkd, virtpi[Gd]);
+        }
 
-                    /* +F_jdbc * t_ikad */
-                    for (Gd = 0; Gd < nirreps; Gd++) {
-                        Gbc = Gjd = Gj ^ Gd;
-                        Ga = Gik ^ Gd;
+        /* -E_jila * t_klcb */
+        for (Gl = 0; Gl < nirreps; Gl++) {
+            Gcb = Gkl = Gk ^ Gl;
+            Ga = Gji ^ Gl;
 
-                        Fints->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gjd]);
-#pragma omp critical
-                        global_dpd_->buf4_mat_irrep_rd_block(Fints, Gjd, Fints->row_offset[Gjd][J], virtpi[Gd]);
+            la = Eints->col_offset[Gji][Gl];
 
-                        ad = T2->col_offset[Gik][Ga];
+            kl = T2->row_offset[Gkl][K];
 
-                        nrows = Fints->params->coltot[Gjd];
-                        ncols = virtpi[Ga];
-                        nlinks = virtpi[Gd];
+            nrows = T2->params->coltot[Gkl];
+            ncols = virtpi[Ga];
+            nlinks = occpi[Gl];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gjd][0][0]), nrows,
-                                    &(T2->matrix[Gik][ik][ad]), nlinks, 1.0, &(W0[Gbc][0][0]), ncols);
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gkl][kl][0]), nrows,
+                        &(Eints->matrix[Gji][ji][la]), ncols, 1.0, &(W1[Gcb][0][0]), ncols);
+        }
 
-                        global_dpd_->free_dpd_block(Fints->matrix[Gjd], virtpi[Gd], Fints->params->coltot[Gjd]);
-                    }
+        /* Sort W[cb][a] --> W[bc][a] */
+        global_dpd_->sort_3d(W1, W0, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
+                             Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
+                             vir_off, virtpi, vir_off, Fints->params->colidx, bac, 0);
 
-                    /* -E_kila * t_jlbc */
-                    for (Gl = 0; Gl < nirreps; Gl++) {
-                        Gbc = Gjl = Gj ^ Gl;
-                        Ga = Gki ^ Gl;
+        /* +F_jdbc * t_ikad */
+        for (Gd = 0; Gd < nirreps; Gd++) {
+            Gbc = Gjd = Gj ^ Gd;
+            Ga = Gik ^ Gd;
 
-                        la = Eints->col_offset[Gki][Gl];
+            F = ET_RHF_F_block(data, Gjd, J, virtpi[Gd]);
 
-                        jl = T2->row_offset[Gjl][J];
+            ad = T2->col_offset[Gik][Ga];
 
-                        nrows = T2->params->coltot[Gjl];
-                        ncols = virtpi[Ga];
-                        nlinks = occpi[Gl];
+            nrows = Fints->params->coltot[Gjd];
+            ncols = virtpi[Ga];
+            nlinks = virtpi[Gd];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gjl][jl][0]), nrows,
-                                    &(Eints->matrix[Gki][ki][la]), ncols, 1.0, &(W0[Gbc][0][0]), ncols);
-                    }
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(F[0][0]), nrows,
+                        &(T2->matrix[Gik][ik][ad]), nlinks, 1.0, &(W0[Gbc][0][0]), ncols);
 
-                    /* Sort W[bc][a] --> W[ba][c] */
-                    global_dpd_->sort_3d(W0, W1, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
-                                         Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
-                                         vir_off, virtpi, vir_off, Fints->params->colidx, acb, 0);
+            ET_RHF_F_release(data, F, Gjd, virtpi[Gd]);
+        }
 
-                    /* +F_jdba * t_kicd */
-                    for (Gd = 0; Gd < nirreps; Gd++) {
-                        Gba = Gjd = Gj ^ Gd;
-                        Gc = Gki ^ Gd;
+        /* -E_kila * t_jlbc */
+        for (Gl = 0; Gl < nirreps; Gl++) {
+            Gbc = Gjl = Gj ^ Gl;
+            Ga = Gki ^ Gl;
 
-                        Fints->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gjd]);
-#pragma omp critical
-                        global_dpd_->buf4_mat_irrep_rd_block(Fints, Gjd, Fints->row_offset[Gjd][J], virtpi[Gd]);
+            la = Eints->col_offset[Gki][Gl];
 
-                        cd = T2->col_offset[Gki][Gc];
+            jl = T2->row_offset[Gjl][J];
 
-                        nrows = Fints->params->coltot[Gjd];
-                        ncols = virtpi[Gc];
-                        nlinks = virtpi[Gd];
+            nrows = T2->params->coltot[Gjl];
+            ncols = virtpi[Ga];
+            nlinks = occpi[Gl];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gjd][0][0]), nrows,
-                                    &(T2->matrix[Gki][ki][cd]), nlinks, 1.0, &(W1[Gba][0][0]), ncols);
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gjl][jl][0]), nrows,
+                        &(Eints->matrix[Gki][ki][la]), ncols, 1.0, &(W0[Gbc][0][0]), ncols);
+        }
 
-                        global_dpd_->free_dpd_block(Fints->matrix[Gjd], virtpi[Gd], Fints->params->coltot[Gjd]);
-                    }
+        /* Sort W[bc][a] --> W[ba][c] */
+        global_dpd_->sort_3d(W0, W1, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
+                             Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
+                             vir_off, virtpi, vir_off, Fints->params->colidx, acb, 0);
 
-                    /* -E_iklc * t_jlba */
-                    for (Gl = 0; Gl < nirreps; Gl++) {
-                        Gba = Gjl = Gj ^ Gl;
-                        Gc = Gik ^ Gl;
+        /* +F_jdba * t_kicd */
+        for (Gd = 0; Gd < nirreps; Gd++) {
+            Gba = Gjd = Gj ^ Gd;
+            Gc = Gki ^ Gd;
 
-                        lc = Eints->col_offset[Gik][Gl];
+            F = ET_RHF_F_block(data, Gjd, J, virtpi[Gd]);
 
-                        jl = T2->row_offset[Gjl][J];
+            cd = T2->col_offset[Gki][Gc];
 
-                        nrows = T2->params->coltot[Gjl];
-                        ncols = virtpi[Gc];
-                        nlinks = occpi[Gl];
+            nrows = Fints->params->coltot[Gjd];
+            ncols = virtpi[Gc];
+            nlinks = virtpi[Gd];
 
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gjl][jl][0]), nrows,
-                                    &(Eints->matrix[Gik][ik][lc]), ncols, 1.0, &(W1[Gba][0][0]), ncols);
-                    }
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(F[0][0]), nrows,
+                        &(T2->matrix[Gki][ki][cd]), nlinks, 1.0, &(W1[Gba][0][0]), ncols);
 
-                    /* Sort W[ba][c] --> W[ab][c] */
-                    global_dpd_->sort_3d(W1, W0, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
-                                         Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
-                                         vir_off, virtpi, vir_off, Fints->params->colidx, bac, 0);
+            ET_RHF_F_release(data, F, Gjd, virtpi[Gd]);
+        }
 
-                    // timer_off("N7 Terms");
+        /* -E_iklc * t_jlba */
+        for (Gl = 0; Gl < nirreps; Gl++) {
+            Gba = Gjl = Gj ^ Gl;
+            Gc = Gik ^ Gl;
 
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
-                        global_dpd_->free_dpd_block(W1[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
+            lc = Eints->col_offset[Gik][Gl];
 
-                        V[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                    }
-                    // timer_off("malloc");
+            jl = T2->row_offset[Gjl][J];
 
-                    /* Copy W intermediate into V */
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
+            nrows = T2->params->coltot[Gjl];
+            ncols = virtpi[Gc];
+            nlinks = occpi[Gl];
 
-                        for (ab = 0; ab < Fints->params->coltot[Gab]; ab++) {
-                            for (c = 0; c < virtpi[Gc]; c++) {
-                                V[Gab][ab][c] = W0[Gab][ab][c];
-                            }
-                        }
-                    }
+            if (nrows && ncols && nlinks)
+                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2->matrix[Gjl][jl][0]), nrows,
+                        &(Eints->matrix[Gik][ik][lc]), ncols, 1.0, &(W1[Gba][0][0]), ncols);
+        }
 
-                    // timer_on("EST Terms");
+        /* Sort W[ba][c] --> W[ab][c] */
+        global_dpd_->sort_3d(W1, W0, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
+                             Fints->params->colorb, Fints->params->rsym, Fints->params->ssym, vir_off,
+                             vir_off, virtpi, vir_off, Fints->params->colidx, bac, 0);
 
-                    /* Add EST terms to V */
+        // timer_off("N7 Terms");
 
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
+        // timer_on("malloc");
+        for (Gab = 0; Gab < nirreps; Gab++) {
+            Gc = Gab ^ Gijk;
+            global_dpd_->free_dpd_block(W1[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
 
-                        for (ab = 0; ab < Fints->params->coltot[Gab]; ab++) {
-                            A = Fints->params->colorb[Gab][ab][0];
-                            Ga = Fints->params->rsym[A];
-                            a = A - vir_off[Ga];
-                            B = Fints->params->colorb[Gab][ab][1];
-                            Gb = Fints->params->ssym[B];
-                            b = B - vir_off[Gb];
+            V[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
+        }
+        // timer_off("malloc");
 
-                            Gbc = Gb ^ Gc;
-                            Gac = Ga ^ Gc;
+        /* Copy W intermediate into V */
+        for (Gab = 0; Gab < nirreps; Gab++) {
+            Gc = Gab ^ Gijk;
 
-                            for (c = 0; c < virtpi[Gc]; c++) {
-                                C = vir_off[Gc] + c;
+            for (ab = 0; ab < Fints->params->coltot[Gab]; ab++) {
+                for (c = 0; c < virtpi[Gc]; c++) {
+                    V[Gab][ab][c] = W0[Gab][ab][c];
+                }
+            }
+        }
 
-                                bc = Dints->params->colidx[B][C];
-                                ac = Dints->params->colidx[A][C];
+        // timer_on("EST Terms");
 
-                                /* +t_ia * D_jkbc + f_ia * t_jkbc */
-                                if (Gi == Ga && Gjk == Gbc) {
-                                    t_ia = D_jkbc = 0.0;
+        /* Add EST terms to V */
 
-                                    if (T1->params->rowtot[Gi] && T1->params->coltot[Gi]) {
-                                        t_ia = T1->matrix[Gi][i][a];
-                                        f_ia = fIA->matrix[Gi][i][a];
-                                    }
+        for (Gab = 0; Gab < nirreps; Gab++) {
+            Gc = Gab ^ Gijk;
 
-                                    if (Dints->params->rowtot[Gjk] && Dints->params->coltot[Gjk]) {
-                                        D_jkbc = Dints->matrix[Gjk][jk][bc];
-                                        t_jkbc = T2->matrix[Gjk][jk][bc];
-                                    }
+            for (ab = 0; ab < Fints->params->coltot[Gab]; ab++) {
+                A = Fints->params->colorb[Gab][ab][0];
+                Ga = Fints->params->rsym[A];
+                a = A - vir_off[Ga];
+                B = Fints->params->colorb[Gab][ab][1];
+                Gb = Fints->params->ssym[B];
+                b = B - vir_off[Gb];
 
-                                    V[Gab][ab][c] += t_ia * D_jkbc + f_ia * t_jkbc;
-                                }
+                Gbc = Gb ^ Gc;
+                Gac = Ga ^ Gc;
 
-                                /* +t_jb * D_ikac */
-                                if (Gj == Gb && Gik == Gac) {
-                                    t_jb = D_ikac = 0.0;
+                for (c = 0; c < virtpi[Gc]; c++) {
+                    C = vir_off[Gc] + c;
 
-                                    if (T1->params->rowtot[Gj] && T1->params->coltot[Gj]) {
-                                        t_jb = T1->matrix[Gj][j][b];
-                                        f_jb = fIA->matrix[Gj][j][b];
-                                    }
+                    bc = Dints->params->colidx[B][C];
+                    ac = Dints->params->colidx[A][C];
 
-                                    if (Dints->params->rowtot[Gik] && Dints->params->coltot[Gik]) {
-                                        D_ikac = Dints->matrix[Gik][ik][ac];
-                                        t_ikac = T2->matrix[Gik][ik][ac];
-                                    }
+                    /* +t_ia * D_jkbc + f_ia * t_jkbc */
+                    if (Gi == Ga && Gjk == Gbc) {
+                        t_ia = D_jkbc = 0.0;
 
-                                    V[Gab][ab][c] += t_jb * D_ikac + f_jb * t_ikac;
-                                }
+                        if (T1->params->rowtot[Gi] && T1->params->coltot[Gi]) {
+                            t_ia = T1->matrix[Gi][i][a];
+                            f_ia = fIA->matrix[Gi][i][a];
+                        }
 
-                                /* +t_kc * D_ijab */
-                                if (Gk == Gc && Gij == Gab) {
-                                    t_kc = D_ijab = 0.0;
+                        if (Dints->params->rowtot[Gjk] && Dints->params->coltot[Gjk]) {
+                            D_jkbc = Dints->matrix[Gjk][jk][bc];
+                            t_jkbc = T2->matrix[Gjk][jk][bc];
+                        }
 
-                                    if (T1->params->rowtot[Gk] && T1->params->coltot[Gk]) {
-                                        t_kc = T1->matrix[Gk][k][c];
-                                        f_kc = fIA->matrix[Gk][k][c];
-                                    }
+                        V[Gab][ab][c] += t_ia * D_jkbc + f_ia * t_jkbc;
+                    }
 
-                                    if (Dints->params->rowtot[Gij] && Dints->params->coltot[Gij]) {
-                                        D_ijab = Dints->matrix[Gij][ij][ab];
-                                        t_ijab = T2->matrix[Gij][ij][ab];
-                                    }
+                    /* +t_jb * D_ikac */
+                    if (Gj == Gb && Gik == Gac) {
+                        t_jb = D_ikac = 0.0;
 
-                                    V[Gab][ab][c] += t_kc * D_ijab + f_kc * t_ijab;
-                                }
+                        if (T1->params->rowtot[Gj] && T1->params->coltot[Gj]) {
+                            t_jb = T1->matrix[Gj][j][b];
+                            f_jb = fIA->matrix[Gj][j][b];
+                        }
 
-                                V[Gab][ab][c] /= (1 + (A == B) + (B == C) + (A == C));
-                            }
+                        if (Dints->params->rowtot[Gik] && Dints->params->coltot[Gik]) {
+                            D_ikac = Dints->matrix[Gik][ik][ac];
+                            t_ikac = T2->matrix[Gik][ik][ac];
                         }
+
+                        V[Gab][ab][c] += t_jb * D_ikac + f_jb * t_ikac;
                     }
 
-                    // timer_off("EST Terms");
+                    /* +t_kc * D_ijab */
+                    if (Gk == Gc && Gij == Gab) {
+                        t_kc = D_ijab = 0.0;
 
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
+                        if (T1->params->rowtot[Gk] && T1->params->coltot[Gk]) {
+                            t_kc = T1->matrix[Gk][k][c];
+                            f_kc = fIA->matrix[Gk][k][c];
+                        }
+
+                        if (Dints->params->rowtot[Gij] && Dints->params->coltot[Gij]) {
+                            D_ijab = Dints->matrix[Gij][ij][ab];
+                            t_ijab = T2->matrix[Gij][ij][ab];
+                        }
 
-                        X[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                        Y[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                        Z[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
+                        V[Gab][ab][c] += t_kc * D_ijab + f_kc * t_ijab;
                     }
-                    // timer_off("malloc");
 
-                    // timer_on("XYZ");
-                    /* Build X, Y, and Z intermediates */
+                    V[Gab][ab][c] /= (1 + (A == B) + (B == C) + (A == C));
+                }
+            }
+        }
 
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
+        // timer_off("EST Terms");
 
-                        Gba = Gab;
+        // timer_on("malloc");
+        for (Gab = 0; Gab < nirreps; Gab++) {
+            Gc = Gab ^ Gijk;
 
-                        for (ab = 0; ab < Fints->params->coltot[Gab]; ab++) {
-                            A = Fints->params->colorb[Gab][ab][0];
-                            Ga = Fints->params->rsym[A];
-                            a = A - vir_off[Ga];
-                            B = Fints->params->colorb[Gab][ab][1];
-                            Gb = Fints->params->ssym[B];
-                            b = B - vir_off[Gb];
+            X[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
+            Y[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
+            Z[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
+        }
+        // timer_off("malloc");
 
-                            Gac = Gca = Ga ^ Gc;
-                            Gbc = Gcb = Gb ^ Gc;
+        // timer_on("XYZ");
+        /* Build X, Y, and Z intermediates */
 
-                            ba = Dints->params->colidx[B][A];
+        for (Gab = 0; Gab < nirreps; Gab++) {
+            Gc = Gab ^ Gijk;
 
-                            for (c = 0; c < virtpi[Gc]; c++) {
-                                C = vir_off[Gc] + c;
+            Gba = Gab;
 
-                                ac = Dints->params->colidx[A][C];
-                                ca = Dints->params->colidx[C][A];
-                                bc = Dints->params->colidx[B][C];
-                                cb = Dints->params->colidx[C][B];
+            for (ab = 0; ab < Fints->params->coltot[Gab]; ab++) {
+                A = Fints->params->colorb[Gab][ab][0];
+                Ga = Fints->params->rsym[A];
+                a = A - vir_off[Ga];
+                B = Fints->params->colorb[Gab][ab][1];
+                Gb = Fints->params->ssym[B];
+                b = B - vir_off[Gb];
 
-                                X[Gab][ab][c] = W0[Gab][ab][c] * V[Gab][ab][c] + W0[Gac][ac][b] * V[Gac][ac][b] +
-                                                W0[Gba][ba][c] * V[Gba][ba][c] + W0[Gbc][bc][a] * V[Gbc][bc][a] +
-                                                W0[Gca][ca][b] * V[Gca][ca][b] + W0[Gcb][cb][a] * V[Gcb][cb][a];
+                Gac = Gca = Ga ^ Gc;
+                Gbc = Gcb = Gb ^ Gc;
 
-                                Y[Gab][ab][c] = V[Gab][ab][c] + V[Gbc][bc][a] + V[Gca][ca][b];
+                ba = Dints->params->colidx[B][A];
 
-                                Z[Gab][ab][c] = V[Gac][ac][b] + V[Gba][ba][c] + V[Gcb][cb][a];
-                            }
-                        }
-                    }
-                    // timer_off("XYZ");
+                for (c = 0; c < virtpi[Gc]; c++) {
+                    C = vir_off[Gc] + c;
 
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
+                    ac = Dints->params->colidx[A][C];
+                    ca = Dints->params->colidx[C][A];
+                    bc = Dints->params->colidx[B][C];
+                    cb = Dints->params->colidx[C][B];
 
-                        global_dpd_->free_dpd_block(V[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                    }
-                    // timer_off("malloc");
-
-                    // timer_on("Energy");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
-                        Gba = Gab;
-
-                        for (ab = 0; ab < Fints->params->coltot[Gab]; ab++) {
-                            A = Fints->params->colorb[Gab][ab][0];
-                            Ga = Fints->params->rsym[A];
-                            a = A - vir_off[Ga];
-                            B = Fints->params->colorb[Gab][ab][1];
-                            Gb = Fints->params->ssym[B];
-                            b = B - vir_off[Gb];
-
-                            if (A >= B) {
-                                Gac = Gca = Ga ^ Gc;
-                                Gbc = Gcb = Gb ^ Gc;
-
-                                ba = Dints->params->colidx[B][A];
-
-                                for (c = 0; c < virtpi[Gc]; c++) {
-                                    C = vir_off[Gc] + c;
-
-                                    if (B >= C) {
-                                        ac = Dints->params->colidx[A][C];
-                                        ca = Dints->params->colidx[C][A];
-                                        bc = Dints->params->colidx[B][C];
-                                        cb = Dints->params->colidx[C][B];
-
-                                        value1 = Y[Gab][ab][c] - 2.0 * Z[Gab][ab][c];
-                                        value2 = Z[Gab][ab][c] - 2.0 * Y[Gab][ab][c];
-                                        value3 = W0[Gab][ab][c] + W0[Gbc][bc][a] + W0[Gca][ca][b];
-                                        value4 = W0[Gac][ac][b] + W0[Gba][ba][c] + W0[Gcb][cb][a];
-                                        value5 = 3.0 * X[Gab][ab][c];
-                                        value6 = 2 - ((I == J) + (J == K) + (I == K));
-
-                                        denom = dijk;
-                                        if (fAB->params->rowtot[Ga]) denom -= fAB->matrix[Ga][a][a];
-                                        if (fAB->params->rowtot[Gb]) denom -= fAB->matrix[Gb][b][b];
-                                        if (fAB->params->rowtot[Gc]) denom -= fAB->matrix[Gc][c][c];
-
-                                        *ET_local += (value1 * value3 + value2 * value4 + value5) * value6 / denom;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    // timer_off("Energy");
+                    X[Gab][ab][c] = W0[Gab][ab][c] * V[Gab][ab][c] + W0[Gac][ac][b] * V[Gac][ac][b] +
+                                    W0[Gba][ba][c] * V[Gba][ba][c] + W0[Gbc][bc][a] * V[Gbc][bc][a] +
+                                    W0[Gca][ca][b] * V[Gca][ca][b] + W0[Gcb][cb][a] * V[Gcb][cb][a];
 
-                    /* Free the W and V intermediates */
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
+                    Y[Gab][ab][c] = V[Gab][ab][c] + V[Gbc][bc][a] + V[Gca][ca][b];
 
-                        global_dpd_->free_dpd_block(W0[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                        global_dpd_->free_dpd_block(X[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                        global_dpd_->free_dpd_block(Y[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                        global_dpd_->free_dpd_block(Z[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
+                    Z[Gab][ab][c] = V[Gac][ac][b] + V[Gba][ba][c] + V[Gcb][cb][a];
+                }
+            }
+        }
+        // timer_off("XYZ");
+
+        // timer_on("malloc");
+        for (Gab = 0; Gab < nirreps; Gab++) {
+            Gc = Gab ^ Gijk;
+
+            global_dpd_->free_dpd_block(V[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
+        }
+        // timer_off("malloc");
+
+        // timer_on("Energy");
+        for (Gab = 0; Gab < nirreps; Gab++) {
+            Gc = Gab ^ Gijk;
+            Gba = Gab;
+
+            for (ab = 0; ab < Fints->params->coltot[Gab]; ab++) {
+                A = Fints->params->colorb[Gab][ab][0];
+                Ga = Fints->params->rsym[A];
+                a = A - vir_off[Ga];
+                B = Fints->params->colorb[Gab][ab][1];
+                Gb = Fints->params->ssym[B];
+                b = B - vir_off[Gb];
+
+                if (A >= B) {
+                    Gac = Gca = Ga ^ Gc;
+                    Gbc = Gcb = Gb ^ Gc;
+
+                    ba = Dints->params->colidx[B][A];
+
+                    for (c = 0; c < virtpi[Gc]; c++) {
+                        C = vir_off[Gc] + c;
+
+                        if (B >= C) {
+                            ac = Dints->params->colidx[A][C];
+                            ca = Dints->params->colidx[C][A];
+                            bc = Dints->params->colidx[B][C];
+                            cb = Dints->params->colidx[C][B];
+
+                            value1 = Y[Gab][ab][c] - 2.0 * Z[Gab][ab][c];
+                            value2 = Z[Gab][ab][c] - 2.0 * Y[Gab][ab][c];
+                            value3 = W0[Gab][ab][c] + W0[Gbc][bc][a] + W0[Gca][ca][b];
+                            value4 = W0[Gac][ac][b] + W0[Gba][ba][c] + W0[Gcb][cb][a];
+                            value5 = 3.0 * X[Gab][ab][c];
+                            value6 = 2 - ((I == J) + (J == K) + (I == K));
+
+                            denom = dijk;
+                            if (fAB->params->rowtot[Ga]) denom -= fAB->matrix[Ga][a][a];
+                            if (fAB->params->rowtot[Gb]) denom -= fAB->matrix[Gb][b][b];
+                            if (fAB->params->rowtot[Gc]) denom -= fAB->matrix[Gc][c][c];
+
+                            *ET_local += (value1 * value3 + value2 * value4 + value5) * value6 / denom;
+                        }
                     }
-                    // timer_off("malloc");
                 }
-            } /* k */
-        }     /* j */
-    }         /* i */
+            }
+        }
+        // timer_off("Energy");
+
+        /* Free the W and V intermediates */
+        // timer_on("malloc");
+        for (Gab = 0; Gab < nirreps; Gab++) {
+            Gc = Gab ^ Gijk;
+
+            global_dpd_->free_dpd_block(W0[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
+            global_dpd_->free_dpd_block(X[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
+            global_dpd_->free_dpd_block(Y[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
+            global_dpd_->free_dpd_block(Z[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
+        }
+        // timer_off("malloc");
+    }
+
+    free(W0);
+    free(W1);
+    free(V);
+    free(X);
+    free(Y);
+    free(Z);
 }
 
 }  // namespace cctriples
@@ -45,10 +45,6 @@
 #define EXTERN
 #include "globals.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
-// MKL Header
-#ifdef USING_LAPACK_MKL
-#include <mkl.h>
-#endif
 
 namespace psi {
 namespace cctriples {
@@ -93,10 +89,8 @@ double EaT_RHF() {
     nthreads = params.nthreads;
     std::vector<EaT_RHF_thread_data> thread_data_array(nthreads);
 
-#ifdef USING_LAPACK_MKL
-    int old_threads = mkl_get_max_threads();
-    mkl_set_num_threads(1);
-#endif
+    // The ijk threads share what is left for their BLAS calls
+    BlasThreads blas_threads(BlasThreads::Outer, nthreads, "EaT_RHF");
 
     global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
     global_dpd_->file2_init(&fAB, PSIF_CC_OEI, 0, 1, 1, "fAB");
@@ -259,10 +253,6 @@ double EaT_RHF() {
 
     timer_off("ET_RHF");
 
-#ifdef USING_LAPACK_MKL
-    mkl_set_num_threads(old_threads);
-#endif
-
     return ET;
 }
 
@@ -58,6 +58,11 @@ class CCEnergyWavefunction : public Wavefunction {
     // (index within irrep, irrep) -> global index
     std::map<std::tuple<int, int>, int> total_indices;
 
+   protected:
+    // Set up DPD 1 on the given orbital spaces plus the DF_BASIS_CC auxiliary space, in the
+    // layout of the three-index integrals written by form_df_ints. Only implemented for R(O)HF.
+    void init_df_dpd(std::vector<int *> spaces, long int memory, int **cachelist, int *cachefiles);
+
    private:
     /* setup, info and teardown */
     void init();
@@ -176,6 +181,7 @@ class CCEnergyWavefunction : public Wavefunction {
     void local_filter_T1(dpdfile2 *T1);
     void local_filter_T2(dpdbuf4 *T2);
     void local_init();
+    void local_pno_init();
     void local_done();
 
     /* AO basis */
@@ -184,6 +190,7 @@ class CCEnergyWavefunction : public Wavefunction {
                    int **mo_row, int **so_row, int *mospi_left, int *mospi_right, int *sospi, int type, double alpha,
                    double beta);
     int AO_contribute(struct iwlbuf *InBuf, dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO);
+    int AO_direct(dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO);
 
     double rhf_energy();
     double uhf_energy();
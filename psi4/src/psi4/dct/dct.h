@@ -550,6 +550,11 @@ class DCTSolver : public Wavefunction {
     /// Form gbar<ab|cd> * lambda <ij|cd>
     void build_gbarlambda_RHF_v3mem();
     void build_gbarlambda_UHF_v3mem();
+    /// G<IJ|AB> += lambda<IJ|CD> g(AC|BD) for one spin block
+    void gbarlambda_block(dpdbuf4& L, dpdbuf4& G, const Matrix& bQac, const Dimension& vac,
+                          const std::vector<std::vector<std::pair<long int, long int>>>& block_ac, const Matrix& bQbd,
+                          const Dimension& vbd, const std::vector<std::vector<std::pair<long int, long int>>>& block_bd,
+                          const std::vector<std::vector<std::pair<long int, long int>>>& block_LG);
 
     // Density-Fitting DCT
     /// Auxiliary basis
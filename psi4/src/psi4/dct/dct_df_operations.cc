@@ -661,12 +661,14 @@ void DCTSolver::form_df_g_vooo() {
         for (int hA = 0; hA < nirrep_; ++hA) {
             int hI = h ^ hA;
             if (navirpi_[hA] > 0 && naoccpi_[hI] > 0) {
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                for (int A = 0; A < navirpi_[hA]; ++A) {
-                    for (int I = 0; I < naoccpi_[hI]; ++I) {
-                        long int IA = block_Qia[h][hI].first + I * navirpi_[hA] + A;
-                        long int AI = block_Qai[h][hA].first + A * naoccpi_[hI] + I;
-                        bQaiA_mo.set_column(h, AI, bQiaA_mo_.get_column(h, IA));
+                double** bQaiA_mo_p = bQaiA_mo.pointer(h);
+                double** bQiaA_mo_p = bQiaA_mo_.pointer(h);
+#pragma omp parallel for num_threads(nthreads)
+                for (int Q = 0; Q < nQ_; ++Q) {
+                    double* IAp = bQiaA_mo_p[Q] + block_Qia[h][hI].first;
+                    double* AIp = bQaiA_mo_p[Q] + block_Qai[h][hA].first;
+                    for (int A = 0; A < navirpi_[hA]; ++A) {
+                        for (int I = 0; I < naoccpi_[hI]; ++I) AIp[A * naoccpi_[hI] + I] = IAp[I * navirpi_[hA] + A];
                     }
                 }
             }
@@ -730,12 +732,15 @@ void DCTSolver::form_df_g_vooo() {
             for (int ha = 0; ha < nirrep_; ++ha) {
                 int hi = h ^ ha;
                 if (nbvirpi_[ha] > 0 && nboccpi_[hi] > 0) {
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                    for (int a = 0; a < nbvirpi_[ha]; ++a) {
-                        for (int i = 0; i < nboccpi_[hi]; ++i) {
-                            long int ia = block_Qia[h][hi].first + i * nbvirpi_[ha] + a;
-                            long int ai = block_Qai[h][ha].first + a * nboccpi_[hi] + i;
-                            bQaiB_mo.set_column(h, ai, bQiaB_mo_.get_column(h, ia));
+                    double** bQaiB_mo_p = bQaiB_mo.pointer(h);
+                    double** bQiaB_mo_p = bQiaB_mo_.pointer(h);
+#pragma omp parallel for num_threads(nthreads)
+                    for (int Q = 0; Q < nQ_; ++Q) {
+                        double* iap = bQiaB_mo_p[Q] + block_Qia[h][hi].first;
+                        double* aip = bQaiB_mo_p[Q] + block_Qai[h][ha].first;
+                        for (int a = 0; a < nbvirpi_[ha]; ++a) {
+                            for (int i = 0; i < nboccpi_[hi]; ++i)
+                                aip[a * nboccpi_[hi] + i] = iap[i * nbvirpi_[ha] + a];
                         }
                     }
                 }
@@ -1000,11 +1005,6 @@ void DCTSolver::build_DF_tensors_RHF() {
 void DCTSolver::build_gbarlambda_RHF_v3mem() {
     dct_timer_on("DCTSolver::DF lambda<ij|cd> gbar<ab|cd> (v3 in memory)");
 
-    int nthreads = 1;
-#ifdef _OPENMP
-    nthreads = Process::environment.get_n_threads();
-#endif
-
     // Put detailed information of b(Q|ab) block into 'block'
     std::vector<std::vector<std::pair<long int, long int>>> block;
     for (int hab = 0; hab < nirrep_; ++hab) {
@@ -1031,102 +1031,76 @@ void DCTSolver::build_gbarlambda_RHF_v3mem() {
                            "tau(temp) SF <OO|VV>");
     global_dpd_->buf4_scm(&Gaa, 0.0);
 
-    for (int hac = 0; hac < nirrep_; ++hac) {
-        for (int ha = 0; ha < nirrep_; ++ha) {
-            int hc = hac ^ ha;
-            int hbd = hac;
-            for (int hb = 0; hb < nirrep_; ++hb) {
-                int hd = hbd ^ hb;
-                int hab = ha ^ hb;
-                int hcd = hc ^ hd;
-                int hij = hcd;
-
-                if (Laa.params->rowtot[hij] > 0 && Laa.params->coltot[hcd] > 0 && Gaa.params->rowtot[hij] > 0 &&
-                    Gaa.params->coltot[hab] > 0 && navirpi_[ha] > 0 && navirpi_[hc] > 0 && navirpi_[hb] > 0 &&
-                    navirpi_[hd] > 0) {
-                    double** bQvvAp = bQabA_mo_.pointer(hac);
-
-                    global_dpd_->buf4_mat_irrep_init(&Laa, hij);
-                    global_dpd_->buf4_mat_irrep_rd(&Laa, hij);
-                    global_dpd_->buf4_mat_irrep_init(&Gaa, hij);
-                    global_dpd_->buf4_mat_irrep_rd(&Gaa, hij);
-
-                    if (hb == hd) {
-                        std::vector<SharedMatrix> CBD;
-                        for (int i = 0; i < nthreads; ++i) {
-                            CBD.push_back(
-                                std::make_shared<Matrix>("g(A'C|BD)", navirpi_[hc], navirpi_[hb] * navirpi_[hd]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[ha]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** CBDp = CBD[thread]->pointer();
-
-                            // g(A'C|BD) = b(A'C|Q) b(Q|BD)
-                            C_DGEMM('T', 'N', navirpi_[hc], navirpi_[hb] * navirpi_[hd], nQ_, 1.0,
-                                    bQvvAp[0] + block[hac][ha].first + A * navirpi_[hc], bQabA_mo_.coldim(hac),
-                                    bQvvAp[0] + block[hbd][hb].first, bQabA_mo_.coldim(hbd), 0.0, CBDp[0],
-                                    navirpi_[hb] * navirpi_[hd]);
-                            // G<IJ|A'B> = lambda<IJ|CD> g(A'C|DB)
-                            C_DGEMM('N', 'N', Gaa.params->rowtot[hij], navirpi_[hb], navirpi_[hc] * navirpi_[hd], 1.0,
-                                    Laa.matrix[hij][0] + block[hcd][hc].first, Laa.params->coltot[hij], CBDp[0],
-                                    navirpi_[hb], 1.0, Gaa.matrix[hij][0] + block[hab][ha].first + A * navirpi_[hb],
-                                    Gaa.params->coltot[hij]);
-                        }
-                    } else {
-                        std::vector<SharedMatrix> CBD, CDB;
-                        for (int i = 0; i < nthreads; ++i) {
-                            CBD.push_back(
-                                std::make_shared<Matrix>("g(A'C|BD)", navirpi_[hc], navirpi_[hb] * navirpi_[hd]));
-                            CDB.push_back(
-                                std::make_shared<Matrix>("g(A'C|DB)", navirpi_[hc], navirpi_[hd] * navirpi_[hb]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[ha]; ++A) {
-                            int thread = 0;
+    gbarlambda_block(Laa, Gaa, bQabA_mo_, navirpi_, block, bQabA_mo_, navirpi_, block, block);
+
+    global_dpd_->buf4_close(&Laa);
+    global_dpd_->buf4_close(&Gaa);
+
+    dct_timer_off("DCTSolver::DF lambda<ij|cd> gbar<ab|cd> (v3 in memory)");
+}
+
+/**
+ * G<IJ|AB> += lambda<IJ|CD> g(AC|BD) for one spin block, with g(A'C|DB) = b(A'C|Q) b(Q|DB) built for one A
+ * at a time (threaded over A).  Taking b(Q|DB) in DB order gives the layout the second DGEMM needs directly,
+ * and each irrep block of lambda and G is read and written once.
+ * block_ac/block_bd locate the irrep blocks of the pairs in b(Q|AC)/b(Q|BD); block_LG those of lambda and G.
+ */
+void DCTSolver::gbarlambda_block(dpdbuf4& L, dpdbuf4& G, const Matrix& bQac, const Dimension& vac,
+                                 const std::vector<std::vector<std::pair<long int, long int>>>& block_ac,
+                                 const Matrix& bQbd, const Dimension& vbd,
+                                 const std::vector<std::vector<std::pair<long int, long int>>>& block_bd,
+                                 const std::vector<std::vector<std::pair<long int, long int>>>& block_LG) {
+    int nthreads = 1;
 #ifdef _OPENMP
-                            thread = omp_get_thread_num();
+    nthreads = Process::environment.get_n_threads();
 #endif
-                            double** CBDp = CBD[thread]->pointer();
-
-                            // g(A'C|BD) = b(A'C|Q) b(Q|BD)
-                            C_DGEMM('T', 'N', navirpi_[hc], navirpi_[hb] * navirpi_[hd], nQ_, 1.0,
-                                    bQvvAp[0] + block[hac][ha].first + A * navirpi_[hc], bQabA_mo_.coldim(hac),
-                                    bQvvAp[0] + block[hbd][hb].first, bQabA_mo_.coldim(hbd), 0.0, CBDp[0],
-                                    navirpi_[hb] * navirpi_[hd]);
-
-                            // g(A'C|BD) -> g(A'C|DB)
-                            for (int B = 0; B < navirpi_[hb]; ++B) {
-                                for (int D = 0; D < navirpi_[hd]; ++D)
-                                    CDB[thread]->set_column(0, D * navirpi_[hb] + B,
-                                                            CBD[thread]->get_column(0, B * navirpi_[hd] + D));
-                            }
 
-                            double** CDBp = CDB[thread]->pointer();
+    for (int hIJ = 0; hIJ < nirrep_; ++hIJ) {
+        if (L.params->rowtot[hIJ] == 0 || L.params->coltot[hIJ] == 0) continue;
 
-                            // G<IJ|A'B> = lambda<IJ|CD> g(A'C|DB)
-                            C_DGEMM('N', 'N', Gaa.params->rowtot[hij], navirpi_[hb], navirpi_[hc] * navirpi_[hd], 1.0,
-                                    Laa.matrix[hij][0] + block[hcd][hc].first, Laa.params->coltot[hij], CDBp[0],
-                                    navirpi_[hb], 1.0, Gaa.matrix[hij][0] + block[hab][ha].first + A * navirpi_[hb],
-                                    Gaa.params->coltot[hij]);
-                        }
-                    }
-                    global_dpd_->buf4_mat_irrep_wrt(&Gaa, hij);
-                    global_dpd_->buf4_mat_irrep_close(&Gaa, hij);
+        global_dpd_->buf4_mat_irrep_init(&L, hIJ);
+        global_dpd_->buf4_mat_irrep_rd(&L, hIJ);
+        global_dpd_->buf4_mat_irrep_init(&G, hIJ);
+        global_dpd_->buf4_mat_irrep_rd(&G, hIJ);
 
-                    global_dpd_->buf4_mat_irrep_close(&Laa, hij);
+        for (int hAC = 0; hAC < nirrep_; ++hAC) {
+            int hBD = hAC;
+            double** bQacp = bQac.pointer(hAC);
+            double** bQbdp = bQbd.pointer(hBD);
+            for (int hA = 0; hA < nirrep_; ++hA) {
+                int hC = hAC ^ hA;
+                int hD = hC ^ hIJ;
+                int hB = hBD ^ hD;
+                if (vac[hA] == 0 || vac[hC] == 0 || vbd[hB] == 0 || vbd[hD] == 0) continue;
+
+                std::vector<SharedMatrix> CDB;
+                for (int i = 0; i < nthreads; ++i) {
+                    CDB.push_back(std::make_shared<Matrix>("g(A'C|DB)", vac[hC], vbd[hD] * vbd[hB]));
+                }
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+                for (int A = 0; A < vac[hA]; ++A) {
+                    int thread = 0;
+#ifdef _OPENMP
+                    thread = omp_get_thread_num();
+#endif
+                    double** CDBp = CDB[thread]->pointer();
+
+                    // g(A'C|DB) = b(A'C|Q) b(Q|DB)
+                    C_DGEMM('T', 'N', vac[hC], vbd[hD] * vbd[hB], nQ_, 1.0,
+                            bQacp[0] + block_ac[hAC][hA].first + A * vac[hC], bQac.coldim(hAC),
+                            bQbdp[0] + block_bd[hBD][hD].first, bQbd.coldim(hBD), 0.0, CDBp[0], vbd[hD] * vbd[hB]);
+                    // G<IJ|A'B> += lambda<IJ|CD> g(A'C|DB)
+                    C_DGEMM('N', 'N', G.params->rowtot[hIJ], vbd[hB], vac[hC] * vbd[hD], 1.0,
+                            L.matrix[hIJ][0] + block_LG[hIJ][hC].first, L.params->coltot[hIJ], CDBp[0], vbd[hB], 1.0,
+                            G.matrix[hIJ][0] + block_LG[hIJ][hA].first + A * vbd[hB], G.params->coltot[hIJ]);
                 }
             }
         }
-    }
-
-    global_dpd_->buf4_close(&Laa);
-    global_dpd_->buf4_close(&Gaa);
 
-    dct_timer_off("DCTSolver::DF lambda<ij|cd> gbar<ab|cd> (v3 in memory)");
+        global_dpd_->buf4_mat_irrep_wrt(&G, hIJ);
+        global_dpd_->buf4_mat_irrep_close(&G, hIJ);
+        global_dpd_->buf4_mat_irrep_close(&L, hIJ);
+    }
 }
 
 /**
@@ -1309,11 +1283,6 @@ void DCTSolver::build_gbarlambda_UHF_v3mem() {
     dct_timer_on("DCTSolver::DF lambda<ij|cd> gbar<ab|cd> (v3 in memory)");
 
     // Thread considerations
-    int nthreads = 1;
-#ifdef _OPENMP
-    nthreads = Process::environment.get_n_threads();
-#endif
-
     /********** Alpha-Alpha **********/
 
     // block_ab[h1][h2] is (#AB pairs of irrep h1 and A irrep *before* h2, #AB pairs of irrep h1 and A irrep *of* h2)
@@ -1344,96 +1313,7 @@ void DCTSolver::build_gbarlambda_UHF_v3mem() {
                            "tau(temp) <OO|VV>");
     global_dpd_->buf4_scm(&Gaa, 0.0);
 
-    for (int hAC = 0; hAC < nirrep_; ++hAC) {
-        for (int hA = 0; hA < nirrep_; ++hA) {
-            int hC = hAC ^ hA;
-            int hBD = hAC;
-            for (int hB = 0; hB < nirrep_; ++hB) {
-                int hD = hBD ^ hB;
-                int hAB = hA ^ hB;
-                int hCD = hC ^ hD;
-                int hIJ = hCD;
-
-                if (Laa.params->rowtot[hIJ] > 0 && Laa.params->coltot[hCD] > 0 && Gaa.params->rowtot[hIJ] > 0 &&
-                    Gaa.params->coltot[hAB] > 0 && navirpi_[hA] > 0 && navirpi_[hC] > 0 && navirpi_[hB] > 0 &&
-                    navirpi_[hD] > 0) {
-                    double** bQvvAp = bQabA_mo_.pointer(hAC);
-
-                    global_dpd_->buf4_mat_irrep_init(&Laa, hIJ);
-                    global_dpd_->buf4_mat_irrep_rd(&Laa, hIJ);
-                    global_dpd_->buf4_mat_irrep_init(&Gaa, hIJ);
-                    global_dpd_->buf4_mat_irrep_rd(&Gaa, hIJ);
-
-                    if (hB == hD) {
-                        std::vector<SharedMatrix> CBD;
-                        for (int i = 0; i < nthreads; ++i) {
-                            CBD.push_back(
-                                std::make_shared<Matrix>("g(A'C|BD)", navirpi_[hC], navirpi_[hB] * navirpi_[hD]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[hA]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** CBDp = CBD[thread]->pointer();
-                            // g(A'C|BD) = b(A'C|Q) b(Q|BD)
-                            C_DGEMM('T', 'N', navirpi_[hC], navirpi_[hB] * navirpi_[hD], nQ_, 1.0,
-                                    bQvvAp[0] + block_AB[hAC][hA].first + A * navirpi_[hC], bQabA_mo_.coldim(hAC),
-                                    bQvvAp[0] + block_AB[hBD][hB].first, bQabA_mo_.coldim(hBD), 0.0, CBDp[0],
-                                    navirpi_[hB] * navirpi_[hD]);
-                            // G<IJ|A'B> = lambda<IJ|CD> g(A'C|DB)
-                            C_DGEMM('N', 'N', Gaa.params->rowtot[hIJ], navirpi_[hB], navirpi_[hC] * navirpi_[hD], 1.0,
-                                    Laa.matrix[hIJ][0] + block_AB[hCD][hC].first, Laa.params->coltot[hIJ], CBDp[0],
-                                    navirpi_[hB], 1.0, Gaa.matrix[hIJ][0] + block_AB[hAB][hA].first + A * navirpi_[hB],
-                                    Gaa.params->coltot[hIJ]);
-                        }
-                    } else {
-                        std::vector<SharedMatrix> CBD, CDB;
-                        for (int i = 0; i < nthreads; ++i) {
-                            CBD.push_back(
-                                std::make_shared<Matrix>("g(A'C|BD)", navirpi_[hC], navirpi_[hB] * navirpi_[hD]));
-                            CDB.push_back(
-                                std::make_shared<Matrix>("g(A'C|DB)", navirpi_[hC], navirpi_[hD] * navirpi_[hB]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[hA]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** CBDp = CBD[thread]->pointer();
-
-                            // g(A'C|BD) = b(A'C|Q) b(Q|BD)
-                            C_DGEMM('T', 'N', navirpi_[hC], navirpi_[hB] * navirpi_[hD], nQ_, 1.0,
-                                    bQvvAp[0] + block_AB[hAC][hA].first + A * navirpi_[hC], bQabA_mo_.coldim(hAC),
-                                    bQvvAp[0] + block_AB[hBD][hB].first, bQabA_mo_.coldim(hBD), 0.0, CBDp[0],
-                                    navirpi_[hB] * navirpi_[hD]);
-
-                            // g(A'C|BD) -> g(A'C|DB)
-                            for (int B = 0; B < navirpi_[hB]; ++B) {
-                                for (int D = 0; D < navirpi_[hD]; ++D)
-                                    CDB[thread]->set_column(0, D * navirpi_[hB] + B,
-                                                            CBD[thread]->get_column(0, B * navirpi_[hD] + D));
-                            }
-
-                            double** CDBp = CDB[thread]->pointer();
-
-                            // G<IJ|A'B> = lambda<IJ|CD> g(A'C|DB)
-                            C_DGEMM('N', 'N', Gaa.params->rowtot[hIJ], navirpi_[hB], navirpi_[hC] * navirpi_[hD], 1.0,
-                                    Laa.matrix[hIJ][0] + block_AB[hCD][hC].first, Laa.params->coltot[hIJ], CDBp[0],
-                                    navirpi_[hB], 1.0, Gaa.matrix[hIJ][0] + block_AB[hAB][hA].first + A * navirpi_[hB],
-                                    Gaa.params->coltot[hIJ]);
-                        }
-                    }
-                    global_dpd_->buf4_mat_irrep_wrt(&Gaa, hIJ);
-                    global_dpd_->buf4_mat_irrep_close(&Gaa, hIJ);
-
-                    global_dpd_->buf4_mat_irrep_close(&Laa, hIJ);
-                }
-            }
-        }
-    }
+    gbarlambda_block(Laa, Gaa, bQabA_mo_, navirpi_, block_AB, bQabA_mo_, navirpi_, block_AB, block_AB);
 
     global_dpd_->buf4_close(&Laa);
     global_dpd_->buf4_close(&Gaa);
@@ -1467,96 +1347,7 @@ void DCTSolver::build_gbarlambda_UHF_v3mem() {
                            "tau(temp) <oo|vv>");
     global_dpd_->buf4_scm(&Gbb, 0.0);
 
-    for (int hac = 0; hac < nirrep_; ++hac) {
-        for (int ha = 0; ha < nirrep_; ++ha) {
-            int hc = hac ^ ha;
-            int hbd = hac;
-            for (int hb = 0; hb < nirrep_; ++hb) {
-                int hd = hbd ^ hb;
-                int hab = ha ^ hb;
-                int hcd = hc ^ hd;
-                int hij = hcd;
-
-                if (Lbb.params->rowtot[hij] > 0 && Lbb.params->coltot[hcd] > 0 && Gbb.params->rowtot[hij] > 0 &&
-                    Gbb.params->coltot[hab] > 0 && nbvirpi_[ha] > 0 && nbvirpi_[hc] > 0 && nbvirpi_[hb] > 0 &&
-                    nbvirpi_[hd] > 0) {
-                    double** bQvvBp = bQabB_mo_.pointer(hac);
-
-                    global_dpd_->buf4_mat_irrep_init(&Lbb, hij);
-                    global_dpd_->buf4_mat_irrep_rd(&Lbb, hij);
-                    global_dpd_->buf4_mat_irrep_init(&Gbb, hij);
-                    global_dpd_->buf4_mat_irrep_rd(&Gbb, hij);
-
-                    if (hb == hd) {
-                        std::vector<SharedMatrix> cbd;
-                        for (int i = 0; i < nthreads; ++i) {
-                            cbd.push_back(
-                                std::make_shared<Matrix>("g(a'c|bd)", nbvirpi_[hc], nbvirpi_[hb] * nbvirpi_[hd]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int a = 0; a < nbvirpi_[ha]; ++a) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** cbdp = cbd[thread]->pointer();
-                            // g(a'c|bd) = b(a'c|Q) b(Q|bd)
-                            C_DGEMM('T', 'N', nbvirpi_[hc], nbvirpi_[hb] * nbvirpi_[hd], nQ_, 1.0,
-                                    bQvvBp[0] + block_ab[hac][ha].first + a * nbvirpi_[hc], bQabB_mo_.coldim(hac),
-                                    bQvvBp[0] + block_ab[hbd][hb].first, bQabB_mo_.coldim(hbd), 0.0, cbdp[0],
-                                    nbvirpi_[hb] * nbvirpi_[hd]);
-                            // G<ij|a'b> = lambda<ij|cd> g(a'c|db)
-                            C_DGEMM('N', 'N', Gbb.params->rowtot[hij], nbvirpi_[hb], nbvirpi_[hc] * nbvirpi_[hd], 1.0,
-                                    Lbb.matrix[hij][0] + block_ab[hcd][hc].first, Lbb.params->coltot[hij], cbdp[0],
-                                    nbvirpi_[hb], 1.0, Gbb.matrix[hij][0] + block_ab[hab][ha].first + a * nbvirpi_[hb],
-                                    Gbb.params->coltot[hij]);
-                        }
-                    } else {
-                        std::vector<SharedMatrix> cbd, cdb;
-                        for (int i = 0; i < nthreads; ++i) {
-                            cbd.push_back(
-                                std::make_shared<Matrix>("g(a'c|bd)", nbvirpi_[hc], nbvirpi_[hb] * nbvirpi_[hd]));
-                            cdb.push_back(
-                                std::make_shared<Matrix>("g(a'c|db)", nbvirpi_[hc], nbvirpi_[hd] * nbvirpi_[hb]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int a = 0; a < nbvirpi_[ha]; ++a) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** cbdp = cbd[thread]->pointer();
-
-                            // g(a'c|bd) = b(a'c|Q) b(Q|bd)
-                            C_DGEMM('T', 'N', nbvirpi_[hc], nbvirpi_[hb] * nbvirpi_[hd], nQ_, 1.0,
-                                    bQvvBp[0] + block_ab[hac][ha].first + a * nbvirpi_[hc], bQabB_mo_.coldim(hac),
-                                    bQvvBp[0] + block_ab[hbd][hb].first, bQabB_mo_.coldim(hbd), 0.0, cbdp[0],
-                                    nbvirpi_[hb] * nbvirpi_[hd]);
-
-                            // g(a'c|bd) -> g(a'c|db)
-                            for (int b = 0; b < nbvirpi_[hb]; ++b) {
-                                for (int d = 0; d < nbvirpi_[hd]; ++d)
-                                    cdb[thread]->set_column(0, d * nbvirpi_[hb] + b,
-                                                            cbd[thread]->get_column(0, b * nbvirpi_[hd] + d));
-                            }
-
-                            double** cdbp = cdb[thread]->pointer();
-
-                            // G<ij|a'b> = lambda<ij|cd> g(a'c|db)
-                            C_DGEMM('N', 'N', Gbb.params->rowtot[hij], nbvirpi_[hb], nbvirpi_[hc] * nbvirpi_[hd], 1.0,
-                                    Lbb.matrix[hij][0] + block_ab[hcd][hc].first, Lbb.params->coltot[hij], cdbp[0],
-                                    nbvirpi_[hb], 1.0, Gbb.matrix[hij][0] + block_ab[hab][ha].first + a * nbvirpi_[hb],
-                                    Gbb.params->coltot[hij]);
-                        }
-                    }
-                    global_dpd_->buf4_mat_irrep_wrt(&Gbb, hij);
-                    global_dpd_->buf4_mat_irrep_close(&Gbb, hij);
-
-                    global_dpd_->buf4_mat_irrep_close(&Lbb, hij);
-                }
-            }
-        }
-    }
+    gbarlambda_block(Lbb, Gbb, bQabB_mo_, nbvirpi_, block_ab, bQabB_mo_, nbvirpi_, block_ab, block_ab);
 
     global_dpd_->buf4_close(&Lbb);
     global_dpd_->buf4_close(&Gbb);
@@ -1590,97 +1381,7 @@ void DCTSolver::build_gbarlambda_UHF_v3mem() {
                            "tau(temp) <Oo|Vv>");
     global_dpd_->buf4_scm(&Gab, 0.0);
 
-    for (int hAC = 0; hAC < nirrep_; ++hAC) {
-        for (int hA = 0; hA < nirrep_; ++hA) {
-            int hC = hAC ^ hA;
-            int hbd = hAC;
-            for (int hb = 0; hb < nirrep_; ++hb) {
-                int hd = hbd ^ hb;
-                int hAb = hA ^ hb;
-                int hCd = hC ^ hd;
-                int hIj = hCd;
-
-                if (Lab.params->rowtot[hIj] > 0 && Lab.params->coltot[hCd] > 0 && Gab.params->rowtot[hIj] > 0 &&
-                    Gab.params->coltot[hAb] > 0 && navirpi_[hA] > 0 && navirpi_[hC] > 0 && nbvirpi_[hb] > 0 &&
-                    nbvirpi_[hd] > 0) {
-                    double** bQvvAp = bQabA_mo_.pointer(hAC);
-                    double** bQvvBp = bQabB_mo_.pointer(hbd);
-
-                    global_dpd_->buf4_mat_irrep_init(&Lab, hIj);
-                    global_dpd_->buf4_mat_irrep_rd(&Lab, hIj);
-                    global_dpd_->buf4_mat_irrep_init(&Gab, hIj);
-                    global_dpd_->buf4_mat_irrep_rd(&Gab, hIj);
-
-                    if (hb == hd) {
-                        std::vector<SharedMatrix> Cbd;
-                        for (int i = 0; i < nthreads; ++i) {
-                            Cbd.push_back(
-                                std::make_shared<Matrix>("g(A'C|bd)", navirpi_[hC], nbvirpi_[hb] * nbvirpi_[hd]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[hA]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** Cbdp = Cbd[thread]->pointer();
-                            // g(A'C|bd) = b(A'C|Q) b(Q|bd)
-                            C_DGEMM('T', 'N', navirpi_[hC], nbvirpi_[hb] * nbvirpi_[hd], nQ_, 1.0,
-                                    bQvvAp[0] + block_AB[hAC][hA].first + A * navirpi_[hC], bQabA_mo_.coldim(hAC),
-                                    bQvvBp[0] + block_ab[hbd][hb].first, bQabB_mo_.coldim(hbd), 0.0, Cbdp[0],
-                                    nbvirpi_[hb] * nbvirpi_[hd]);
-                            // G<Ij|A'b> = lambda<Ij|Cd> g(A'C|db)
-                            C_DGEMM('N', 'N', Gab.params->rowtot[hIj], nbvirpi_[hb], navirpi_[hC] * nbvirpi_[hd], 1.0,
-                                    Lab.matrix[hIj][0] + block_Ab[hCd][hC].first, Lab.params->coltot[hIj], Cbdp[0],
-                                    nbvirpi_[hb], 1.0, Gab.matrix[hIj][0] + block_Ab[hAb][hA].first + A * nbvirpi_[hb],
-                                    Gab.params->coltot[hIj]);
-                        }
-                    } else {
-                        std::vector<SharedMatrix> Cbd, Cdb;
-                        for (int i = 0; i < nthreads; ++i) {
-                            Cbd.push_back(
-                                std::make_shared<Matrix>("g(A'C|bd)", navirpi_[hC], nbvirpi_[hb] * nbvirpi_[hd]));
-                            Cdb.push_back(
-                                std::make_shared<Matrix>("g(A'C|db)", navirpi_[hC], nbvirpi_[hd] * nbvirpi_[hb]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[hA]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** Cbdp = Cbd[thread]->pointer();
-
-                            // g(A'C|bd) = b(A'C|Q) b(Q|bd)
-                            C_DGEMM('T', 'N', navirpi_[hC], nbvirpi_[hb] * nbvirpi_[hd], nQ_, 1.0,
-                                    bQvvAp[0] + block_AB[hAC][hA].first + A * navirpi_[hC], bQabA_mo_.coldim(hAC),
-                                    bQvvBp[0] + block_ab[hbd][hb].first, bQabB_mo_.coldim(hbd), 0.0, Cbdp[0],
-                                    nbvirpi_[hb] * nbvirpi_[hd]);
-
-                            // g(A'C|bd) -> g(A'C|db)
-                            for (int b = 0; b < nbvirpi_[hb]; ++b) {
-                                for (int d = 0; d < nbvirpi_[hd]; ++d)
-                                    Cdb[thread]->set_column(0, d * nbvirpi_[hb] + b,
-                                                            Cbd[thread]->get_column(0, b * nbvirpi_[hd] + d));
-                            }
-
-                            double** Cdbp = Cdb[thread]->pointer();
-
-                            // G<Ij|A'b> = lambda<Ij|Cd> g(A'C|db)
-                            C_DGEMM('N', 'N', Gab.params->rowtot[hIj], nbvirpi_[hb], navirpi_[hC] * nbvirpi_[hd], 1.0,
-                                    Lab.matrix[hIj][0] + block_Ab[hCd][hC].first, Lab.params->coltot[hIj], Cdbp[0],
-                                    nbvirpi_[hb], 1.0, Gab.matrix[hIj][0] + block_Ab[hAb][hA].first + A * nbvirpi_[hb],
-                                    Gab.params->coltot[hIj]);
-                        }
-                    }
-                    global_dpd_->buf4_mat_irrep_wrt(&Gab, hIj);
-                    global_dpd_->buf4_mat_irrep_close(&Gab, hIj);
-
-                    global_dpd_->buf4_mat_irrep_close(&Lab, hIj);
-                }
-            }
-        }
-    }
+    gbarlambda_block(Lab, Gab, bQabA_mo_, navirpi_, block_AB, bQabB_mo_, nbvirpi_, block_ab, block_Ab);
 
     global_dpd_->buf4_close(&Lab);
     global_dpd_->buf4_close(&Gab);
@@ -49,6 +49,10 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <cstring>
+#include <map>
+#include <new>
+#include <vector>
 #include "psi4/pybind11.h"
 
 #include "psi4/libciomr/libciomr.h"
@@ -82,6 +86,29 @@ extern int calc_orb_diff(int cnt, unsigned char *I, unsigned char *J, int *I_alp
 #define MIN0(a, b) (((a) < (b)) ? (a) : (b))
 #define MAX0(a, b) (((a) > (b)) ? (a) : (b))
 
+namespace {
+
+/*
+** In-core replacement of the "buffer_ %d" entries of a CI vector file,
+** see CIvect::keep_in_core().  It is keyed by file unit, like libpsio,
+** so that all the logical CIvects on one file see the same data.
+*/
+struct CoreFile {
+    std::vector<double> data;   /* all buffers of the unit, contiguous */
+    std::vector<size_t> offset; /* buffer number -> offset into data */
+    std::vector<size_t> size;   /* buffer number -> length, 0 if on another unit */
+    std::vector<char> valid;    /* buffer written (or read in from disk) yet? */
+};
+
+std::map<int, CoreFile> &core_files() {
+    static std::map<int, CoreFile> files;
+    return files;
+}
+
+void buffer_key(char *key, int buf) { sprintf(key, "buffer_ %d", buf); }
+
+}  // namespace
+
 CIvect::CIvect()  // Default constructor
 {
     common_init();
@@ -724,6 +751,37 @@ double CIvect::operator*(CIvect &b) {
     return (dotprod);
 }
 
+/*
+** CIvect::vdots(): Dot products of vectors first...last-1 of this CIvect
+**    with the current vector of b, in one pass over b.  Vectors kept in
+**    core (see keep_in_core()) are used in place rather than read.
+**
+** Parameters:
+**    b     = CIvect whose current vector (cur_vect_) is dotted with
+**    first = first vector of this CIvect
+**    last  = one past the last vector of this CIvect
+**    dots  = dots[j-first] = <this[j]|b>
+*/
+void CIvect::vdots(CIvect &b, int first, int last, double *dots) {
+    int bvect = b.cur_vect_;
+
+    for (int j = first; j < last; j++) dots[j - first] = 0.0;
+
+    for (int buf = 0; buf < buf_per_vect_; buf++) {
+        b.read(bvect, buf);
+        for (int j = first; j < last; j++) {
+            double *x = core_buffer(j, buf);
+            if (x == nullptr) {
+                read(j, buf);
+                x = buffer_;
+            }
+            double tval = C_DDOT(buf_size_[buf], x, 1, b.buffer_, 1);
+            if (Ms0_ && buf_offdiag_[buf]) tval *= 2.0;
+            dots[j - first] += tval;
+        }
+    }
+}
+
 void CIvect::setarray(const double *a, size_t len) {
     double *aptr;
     size_t i;
@@ -1743,11 +1801,122 @@ void CIvect::close_io_files(int keep) {
     }
 
     for (size_t i = 0; i < nunits_; i++) {
+        /* buffers kept in memory go to disk only if the file is kept */
+        auto core = core_files().find(units_[i]);
+        if (core != core_files().end()) {
+            CoreFile &file = core->second;
+            char key[20];
+            for (int buf = 0; keep && buf < (int)file.size.size(); buf++) {
+                if (!file.size[buf] || !file.valid[buf]) continue;
+                buffer_key(key, buf);
+                psio_write_entry((size_t)units_[i], key, (char *)(file.data.data() + file.offset[buf]),
+                                 file.size[buf] * sizeof(double));
+            }
+            core_files().erase(core);
+        }
         psio_close(units_[i], keep);
     }
     fopen_ = false;
 }
 
+/*
+** CIvect::file_bytes()
+**
+** Returns: the bytes of all buffers of all vectors on this CIvect's files
+*/
+size_t CIvect::file_bytes() {
+    size_t bytes = 0;
+    for (int buf = 0; buf < buf_total_; buf++) bytes += buf_size_[buf % buf_per_vect_] * sizeof(double);
+    return bytes;
+}
+
+/*
+** CIvect::keep_in_core()
+**
+** Keep the vector buffers of this CIvect's files in memory instead of
+** writing them through libpsio, until the files are closed.  Every CIvect
+** on the same files then reads and writes the memory copy; buffers that
+** are not in memory yet (e.g., for a restart) are read from disk once.
+** close_io_files() writes the buffers to disk if the files are kept.
+** Call after init_io_files().
+**
+** Returns: 1 if the files are in core, 0 if there was not enough memory
+*/
+int CIvect::keep_in_core() {
+    for (int i = 0; i < nunits_; i++) {
+        /* another CIvect on the unit may have put it in core already; an
+           entry with a different buffer layout is stale and is rebuilt */
+        auto core = core_files().find(units_[i]);
+        if (core != core_files().end()) {
+            const CoreFile &old = core->second;
+            bool same = (int)old.size.size() == buf_total_;
+            for (int buf = 0; same && buf < buf_total_; buf++) {
+                if (file_number_[buf] == units_[i]) same = old.size[buf] == buf_size_[buf % buf_per_vect_];
+            }
+            if (same) continue;
+            core_files().erase(core);
+        }
+
+        CoreFile file;
+        file.offset.assign(buf_total_, 0);
+        file.size.assign(buf_total_, 0);
+        file.valid.assign(buf_total_, 0);
+        size_t len = 0;
+        for (int buf = 0; buf < buf_total_; buf++) {
+            if (file_number_[buf] != units_[i]) continue;
+            file.offset[buf] = len;
+            file.size[buf] = buf_size_[buf % buf_per_vect_];
+            len += file.size[buf];
+        }
+        try {
+            file.data.resize(len);
+        } catch (std::bad_alloc &) {
+            return 0;
+        }
+        core_files()[units_[i]] = std::move(file);
+    }
+    return 1;
+}
+
+/*
+** CIvect::drop_core()
+**
+** Forget the in-core buffers of this CIvect's files without writing them
+** to disk, e.g. when a calculation that kept them in core is abandoned.
+** close_io_files() does the same after writing them out.
+*/
+void CIvect::drop_core() {
+    for (int i = 0; i < nunits_; i++) core_files().erase(units_[i]);
+}
+
+/*
+** CIvect::core_buffer()
+**
+** Returns: a pointer to the in-core copy of a buffer of vector ivect, or
+**    nullptr if the buffer lives on disk (see keep_in_core())
+*/
+double *CIvect::core_buffer(int ivect, int ibuf) {
+    if (nunits_ < 1) return nullptr;
+    if (icore_ == 1) ibuf = 0;
+    int buf = ivect * buf_per_vect_ + ibuf + new_first_buf_;
+    if (buf >= buf_total_) buf -= buf_total_;
+
+    auto core = core_files().find(file_number_[buf]);
+    if (core == core_files().end()) return nullptr;
+
+    CoreFile &file = core->second;
+    if (buf >= (int)file.size.size() || file.size[buf] != buf_size_[ibuf])
+        throw PSIEXCEPTION("(CIvect::core_buffer): buffer layout does not match the in-core file");
+    double *data = file.data.data() + file.offset[buf];
+    if (!file.valid[buf]) {
+        char key[20];
+        buffer_key(key, buf);
+        psio_read_entry((size_t)file_number_[buf], key, (char *)data, file.size[buf] * sizeof(double));
+        file.valid[buf] = 1;
+    }
+    return data;
+}
+
 /*
 ** CIvect::read(): Read in a section of a CI vector from external storage.
 **
@@ -1784,13 +1953,18 @@ int CIvect::read(int ivect, int ibuf) {
 
     size = buf_size_[ibuf] * (size_t)sizeof(double);
 
-    /* translate buffer number in case we renumbered after collapse * */
-    buf += new_first_buf_;
-    if (buf >= buf_total_) buf -= buf_total_;
-    sprintf(key, "buffer_ %d", buf);
-    unit = file_number_[buf];
+    double *core = core_buffer(ivect, ibuf);
+    if (core != nullptr) {
+        memcpy(buffer_, core, size);
+    } else {
+        /* translate buffer number in case we renumbered after collapse * */
+        buf += new_first_buf_;
+        if (buf >= buf_total_) buf -= buf_total_;
+        buffer_key(key, buf);
+        unit = file_number_[buf];
 
-    psio_read_entry((size_t)unit, key, (char *)buffer_, size);
+        psio_read_entry((size_t)unit, key, (char *)buffer_, size);
+    }
 
     cur_vect_ = ivect;
     cur_buf_ = ibuf;
@@ -1837,10 +2011,19 @@ int CIvect::write(int ivect, int ibuf) {
     /* translate buffer number in case we renumbered after collapse * */
     buf += new_first_buf_;
     if (buf >= buf_total_) buf -= buf_total_;
-    sprintf(key, "buffer_ %d", buf);
     unit = file_number_[buf];
 
-    psio_write_entry((size_t)unit, key, (char *)buffer_, size);
+    auto core = core_files().find(unit);
+    if (core != core_files().end()) {
+        CoreFile &file = core->second;
+        if (buf >= (int)file.size.size() || file.size[buf] != buf_size_[ibuf])
+            throw PSIEXCEPTION("(CIvect::write): buffer layout does not match the in-core file");
+        memcpy(file.data.data() + file.offset[buf], buffer_, size);
+        file.valid[buf] = 1;
+    } else {
+        buffer_key(key, buf);
+        psio_write_entry((size_t)unit, key, (char *)buffer_, size);
+    }
 
     if (ivect >= nvect_) nvect_ = ivect + 1;
     cur_vect_ = ivect;
@@ -2150,14 +2333,22 @@ void CIvect::dcalc(int nr, int L, double **alpha, double *lambda, double *norm_a
             for (ivect = 0; ivect < L; ivect++) {
                 if (CI_Params_->update == UPDATE_DAVIDSON) { /* DAVIDSON update formula */
                     C.buf_lock(buf1);
-                    C.read(ivect, buf);
+                    double *x = C.core_buffer(ivect, buf);
+                    if (x == nullptr) {
+                        C.read(ivect, buf);
+                        x = C.buffer_;
+                    }
                     tval = -alpha[ivect][root] * lambda[root];
-                    xpeay(buffer_, tval, C.buffer_, buf_size_[buf]);
+                    xpeay(buffer_, tval, x, buf_size_[buf]);
                     C.buf_unlock();
                 }
                 S.buf_lock(buf1);
-                S.read(ivect, buf);
-                xpeay(buffer_, alpha[ivect][root], S.buffer_, buf_size_[buf]);
+                double *x = S.core_buffer(ivect, buf);
+                if (x == nullptr) {
+                    S.read(ivect, buf);
+                    x = S.buffer_;
+                }
+                xpeay(buffer_, alpha[ivect][root], x, buf_size_[buf]);
                 S.buf_unlock();
             } /* end loop over ivect */
             // dot_arr(buffer_, buffer_, buf_size_[buf], &tval);
@@ -2779,8 +2970,12 @@ void CIvect::gather(int ivec, int nvec, int nroot, double **alpha, CIvect &C) {
     for (buf = 0; buf < buf_per_vect_; buf++) {
         zero_arr(buffer_, buf_size_[buf]);
         for (oldvec = 0; oldvec < nvec; oldvec++) {
-            C.read(oldvec, buf);
-            xpeay(buffer_, alpha[oldvec][nroot], C.buffer_, buf_size_[buf]);
+            double *x = C.core_buffer(oldvec, buf);
+            if (x == nullptr) {
+                C.read(oldvec, buf);
+                x = C.buffer_;
+            }
+            xpeay(buffer_, alpha[oldvec][nroot], x, buf_size_[buf]);
             /* outfile->Printf("coef[%d][%d] = %10.7f\n",oldvec,nroot,alpha[oldvec][nroot]); */
         }
         write(ivec, buf);
@@ -161,6 +161,10 @@ class CIvect {
     void close_io_files(int keep);
     int read(int tvec, int ibuf);
     int write(int tvec, int ibuf);
+    size_t file_bytes();
+    int keep_in_core();
+    void drop_core();
+    double *core_buffer(int ivect, int ibuf);
     void buf_lock(double *a);
     void buf_unlock();
     double *buf_malloc();
@@ -172,6 +176,7 @@ class CIvect {
              int nbc, int nirr, int cdperirr, int maxvect, int nunits, int funit, int *fablk, int *lablk, int **dc);
     void print();
     double operator*(CIvect &b);
+    void vdots(CIvect &b, int first, int last, double *dots);
     void setarray(const double *a, size_t len);
     void max_abs_vals(int nval, int *iac, int *ibc, int *iaidx, int *ibidx, double *coeff, int neg_only);
     double blk_max_abs_vals(int i, int offdiag, int nval, int *iac, int *ibc, int *iaidx, int *ibidx, double *coeff,
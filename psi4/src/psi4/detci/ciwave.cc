@@ -39,6 +39,7 @@
 #include "psi4/detci/civect.h"
 #include "psi4/detci/structs.h"
 #include "psi4/detci/slaterd.h"
+#include "psi4/detci/sci.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 #include "psi4/libpsio/psio.hpp"
@@ -113,8 +114,19 @@ void CIWavefunction::common_init() {
     df_ints_init_ = false;
     mcscf_object_init_ = false;
     cleaned_up_ci_ = false;
+    first_diag_h_ = true;
     fzc_fock_computed_ = false;
 
+    name_ = "CIWavefunction";
+    module_ = "detci";
+
+    // A selected CI grows its own determinant space instead
+    if (Parameters_->diag_method == METHOD_HCI) {
+        outfile->Printf("\n   ==> Setting up selected CI <==\n\n");
+        sci_init();
+        return;
+    }
+
     // Form strings
     outfile->Printf("\n   ==> Setting up CI strings <==\n\n");
     form_strings();
@@ -122,9 +134,6 @@ void CIWavefunction::common_init() {
     // Form Bendazzoli OV arrays
     if (Parameters_->bendazzoli) form_ov();
 
-    name_ = "CIWavefunction";
-    module_ = "detci";
-
     // Init H0 block
     H0block_init(CIblks_->vectlen);
 
@@ -132,7 +141,10 @@ void CIWavefunction::common_init() {
         throw PSIEXCEPTION("CIWavefunction: Must have more than one determinant!");
     }
 }
-size_t CIWavefunction::ndet() { return (size_t)CIblks_->vectlen; }
+size_t CIWavefunction::ndet() {
+    if (sci_) return sci_->ndet();
+    return (size_t)CIblks_->vectlen;
+}
 
 double CIWavefunction::compute_energy() {
     if (Parameters_->istop) { /* Print size of space, other stuff, only   */
@@ -443,6 +455,8 @@ SharedMatrix CIWavefunction::get_tpdm(const std::string& spin, bool symmetrize)
 }
 
 void CIWavefunction::reset_ci_H0block() {
+    if (sci_) return;
+
     // Free H0block
     H0block_free();
 
@@ -466,7 +480,7 @@ void CIWavefunction::cleanup_ci() {
         if (CalcInfo_->sigma_initialized) sigma_free();
         delete SigmaData_;
 
-        free_int_matrix(CIblks_->decode);
+        if (CIblks_->decode) free_int_matrix(CIblks_->decode);
         free(CIblks_->first_iablk);
         free(CIblks_->last_iablk);
         delete CIblks_;
@@ -477,6 +491,8 @@ void CIWavefunction::cleanup_ci() {
         H0block_free();
         delete H0block_;
 
+        sci_.reset();
+
         // CalcInfo free
         free_int_matrix(CalcInfo_->ras_opi);
         for (int i = 0; i < 4; i++) {
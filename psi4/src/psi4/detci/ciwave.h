@@ -46,6 +46,7 @@ class MOSpace;
 typedef std::shared_ptr<Matrix> SharedMatrix;
 class SOMCSCF;
 class DFHelper;
+class MemoryGrant;
 
 // Well this is not ideal
 struct _SlaterDetSet;
@@ -57,6 +58,7 @@ namespace psi {
 namespace detci {
 class CIvect;
 class SlaterDeterminant;
+class SelectedCI;
 struct calcinfo;
 struct params;
 struct stringwr;
@@ -427,6 +429,7 @@ class CIWavefunction : public Wavefunction {
     void sigma_init(CIvect &C, CIvect &S);
     void sigma_free();
     void sigma(CIvect &C, CIvect &S, double *oei, double *tei, int ivec);
+    bool sigma_multi(CIvect &C, CIvect &S, double *oei, double *tei, int first, int nvec);
 
     void sigma_a(struct stringwr **alplist, struct stringwr **betlist, CIvect &C, CIvect &S, double *oei, double *tei,
                  int fci, int ivec);
@@ -437,7 +440,8 @@ class CIWavefunction : public Wavefunction {
 
     void sigma_block(struct stringwr **alplist, struct stringwr **betlist, double **cmat, double **smat, double *oei,
                      double *tei, int fci, int cblock, int sblock, int nas, int nbs, int sac, int sbc, int cac, int cbc,
-                     int cnas, int cnbs, int cnac, int cnbc, int sbirr, int cbirr, int Ms0);
+                     int cnas, int cnbs, int cnac, int cnbc, int sbirr, int cbirr, int Ms0,
+                     struct sigma_data *SD);
     void sigma_get_contrib(struct stringwr **alplist, struct stringwr **betlist, CIvect &C, CIvect &S, int **s1_contrib,
                            int **s2_contrib, int **s3_contrib);
     void form_ov();
@@ -451,13 +455,38 @@ class CIWavefunction : public Wavefunction {
     /// => MPn helpers <= //
     void mpn_generator(CIvect &Hd);
 
+    /// => Selected CI (DIAG_METHOD HCI), stands in for the strings and CI vectors <= //
+    std::shared_ptr<SelectedCI> sci_;
+    void sci_init();
+    void sci_diag(double *evals, double conv_e, double conv_rms);
+    std::vector<std::vector<SharedMatrix> > sci_opdm();
+    std::vector<SharedMatrix> sci_tpdm(std::vector<std::tuple<int, int, double> > states_vec);
+
     /// => Density Matrix helpers <= //
     std::vector<std::vector<SharedMatrix> > opdm(SharedCIVector Ivec, SharedCIVector Jvec,
                                                  std::vector<std::tuple<int, int> > states_vec);
     SharedMatrix opdm_add_inactive(SharedMatrix opdm, double value, bool virt = false);
+    void set_current_opdm(const std::vector<std::vector<SharedMatrix> > &opdm_list);
     void opdm_block(struct stringwr **alplist, struct stringwr **betlist, double **onepdm_a, double **onepdm_b,
                     double **CJ, double **CI, int Ja_list, int Jb_list, int Jnas, int Jnbs, int Ia_list, int Ib_list,
                     int Inas, int Inbs);
+    bool opdm_incore(SharedCIVector Ivec, SharedCIVector Jvec, const std::vector<std::tuple<int, int> > &states_vec,
+                     std::vector<SharedMatrix> &scratch);
+    std::vector<std::pair<int, int> > incore_root_copies(SharedCIVector Ivec, SharedCIVector Jvec,
+                                                         const std::vector<int> &Iroots,
+                                                         const std::vector<int> &Jroots, std::vector<int> &Icopy,
+                                                         std::vector<int> &Jcopy);
+    void read_incore_roots(SharedCIVector Ivec, SharedCIVector Jvec, const std::vector<std::pair<int, int> > &copies,
+                           std::vector<std::vector<double> > &data,
+                           std::vector<std::vector<std::vector<double *> > > &rows);
+    int incore_density_threads(const MemoryGrant &grant, size_t base_bytes, size_t thread_bytes, int nthread);
+
+    /// => Warm start of the first diag_h from the roots of the previous CIWavefunction <= //
+    bool first_diag_h_;
+    std::vector<size_t> ci_space_signature();
+    bool load_warm_start();
+    bool warm_start_orbitals_match(SharedMatrix Cact);
+    void save_warm_start();
 
     // OPDM holders, opdm_map holds lots of active-active opdms
     // opdm_, opdm_a_, etc are for "the" current OPDM
@@ -472,6 +501,9 @@ class CIWavefunction : public Wavefunction {
     void tpdm_block(struct stringwr **alplist, struct stringwr **betlist, int nbf, int nalplists, int nbetlists,
                     double *twopdm_aa, double *twopdm_bb, double *twopdm_ab, double **CJ, double **CI, int Ja_list,
                     int Jb_list, int Jnas, int Jnbs, int Ia_list, int Ib_list, int Inas, int Inbs, double weight);
+    bool tpdm_incore(SharedCIVector Ivec, SharedCIVector Jvec,
+                     const std::vector<std::tuple<int, int, double> > &states_vec, double *tpdm_aa, double *tpdm_bb,
+                     double *tpdm_ab);
 
     bool tpdm_called_;
     SharedMatrix tpdm_;
@@ -31,23 +31,50 @@
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libmints/basisset.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libqt/slaterdset.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libmints/molecule.h"
 
 #include "psi4/detci/structs.h"
 #include "psi4/detci/slaterd.h"
 #include "psi4/detci/civect.h"
 #include "psi4/detci/ciwave.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cmath>
 #include <cstring>
+#include <string>
+#include <vector>
 
 namespace psi {
 namespace detci {
 
+namespace {
+/*
+** Converged roots of the last CI over a CI space, kept across CIWavefunction objects so that
+**   the next calculation over the same space (the next point of a scan) can start from them.
+**   The vectors are stored buffer by buffer as CIvect keeps them on disk.
+*/
+struct WarmStartCache {
+    std::vector<size_t> signature;
+    std::string basis;
+    SharedMatrix Cact; /* active orbitals the roots were converged over, SO basis */
+    std::vector<std::vector<double> > roots;
+};
+
+/* smallest overlap between an active orbital and its counterpart of the previous CI */
+const double warm_start_min_overlap = 0.9;
+
+WarmStartCache &warm_start_cache() {
+    static WarmStartCache cache;
+    return cache;
+}
+}  // namespace
+
 /*
 ** diag_h(): Function diagonalizes the hamiltonian
 **
@@ -84,8 +111,14 @@ int CIWavefunction::diag_h(double conv_e, double conv_rms) {
 
     if (Parameters_->bendazzoli) outfile->Printf("    Bendazzoli algorithm selected for sigma3\n");
 
+    /* Selected CI --- heat-bath selection and Davidson-Liu over a sparse H */
+    if (Parameters_->diag_method == METHOD_HCI) {
+        evals = init_array(nroots);
+        sci_diag(evals, conv_e, conv_rms);
+    }
+
     /* Direct Method --- use RSP diagonalization routine */
-    if (Parameters_->diag_method == METHOD_RSP) {
+    else if (Parameters_->diag_method == METHOD_RSP) {
         double h_size = (double)(8 * size * size);
         if (h_size > (Process::environment.get_memory() * 0.4)) {
             outfile->Printf("CIWave::Requsted size of the hamiltonian is %4.2lf GB!\n", h_size / 1E9);
@@ -256,8 +289,11 @@ int CIWavefunction::diag_h(double conv_e, double conv_rms) {
 
             evals = init_array(nroots);
 
+            bool warm_start = load_warm_start();
             sem_iter(Hd, alplist_, betlist_, evals, conv_e, conv_rms, nucrep, edrc, nroots, Parameters_->maxiter,
                      Parameters_->maxnvect);
+            if (warm_start) Parameters_->guess_vector = PARM_GUESS_VEC_H0_BLOCK;
+            if (Parameters_->diag_h_converged) save_warm_start();
         }
 
         /* Mitrushenkov's Olsen Method */
@@ -277,6 +313,8 @@ int CIWavefunction::diag_h(double conv_e, double conv_rms) {
 
     } /* end the Davidson-Liu/Mitrushenkov-Olsen-Davidson section */
 
+    first_diag_h_ = false;
+
     // Check convergence
     if (!Parameters_->diag_h_converged) {
         convergence_death();
@@ -354,5 +392,108 @@ int CIWavefunction::diag_h(double conv_e, double conv_rms) {
     return Parameters_->diag_iters_taken;
 
 }  // end CIWave::diag_h
+/*
+** ci_space_signature(): Everything that fixes the layout of a CI vector on disk, and the atoms,
+**   so that roots are only carried over between equivalent calculations
+*/
+std::vector<size_t> CIWavefunction::ci_space_signature() {
+    std::vector<size_t> sig = {(size_t)Parameters_->icore,      (size_t)Parameters_->Ms0,
+                               (size_t)CalcInfo_->num_ci_orbs,  (size_t)CalcInfo_->num_alp_expl,
+                               (size_t)CalcInfo_->num_bet_expl, (size_t)CIblks_->num_blocks,
+                               CIblks_->vectlen};
+    for (int blk = 0; blk < CIblks_->num_blocks; blk++) {
+        sig.push_back(CIblks_->Ia_code[blk]);
+        sig.push_back(CIblks_->Ib_code[blk]);
+        sig.push_back(CIblks_->Ia_size[blk]);
+        sig.push_back(CIblks_->Ib_size[blk]);
+    }
+    for (int atom = 0; atom < molecule_->natom(); atom++) sig.push_back((size_t)std::lround(molecule_->Z(atom)));
+    return sig;
+}
+
+/*
+** load_warm_start(): Write the roots kept from the previous CI to the D file and switch the guess
+**   to DFILE, if the first diag_h of this object would make the default H0 block guess over the
+**   same CI space. Returns true if the guess was switched.
+*/
+bool CIWavefunction::load_warm_start() {
+    if (!Parameters_->ci_warm_start || !first_diag_h_ || Parameters_->restart || Parameters_->nodfile) return false;
+    if (Parameters_->guess_vector != PARM_GUESS_VEC_H0_BLOCK) return false;
+
+    WarmStartCache &cache = warm_start_cache();
+    int nroots = Parameters_->num_roots;
+    if (cache.roots.size() < (size_t)nroots || cache.signature != ci_space_signature()) return false;
+    if (cache.basis != basisset_->name() || !warm_start_orbitals_match(cache.Cact)) {
+        if (print_) outfile->Printf("    The active orbitals differ from the previous CI, not starting from its roots\n");
+        return false;
+    }
+
+    SharedCIVector Dvec = D_vector();
+    Dvec->init_io_files(false);
+    for (int root = 0; root < nroots; root++) {
+        const double *data = cache.roots[root].data();
+        for (int buf = 0; buf < Dvec->buf_per_vect_; buf++) {
+            std::copy(data, data + Dvec->buf_size_[buf], Dvec->buffer_);
+            Dvec->write(root, buf);
+            data += Dvec->buf_size_[buf];
+        }
+    }
+    Dvec->write_num_vecs(nroots);
+    Dvec->close_io_files(1);
+
+    if (print_) outfile->Printf("    Starting from the %d roots of the previous CI calculation\n", nroots);
+    Parameters_->guess_vector = PARM_GUESS_VEC_DFILE;
+    return true;
+}
+
+/*
+** warm_start_orbitals_match(): Whether the active orbitals Cact of the previous CI are those of this
+**   one in the same order, so its roots describe the same determinants: each orbital must overlap
+**   its counterpart by at least warm_start_min_overlap (in either phase) in the current metric
+*/
+bool CIWavefunction::warm_start_orbitals_match(SharedMatrix Cact) {
+    if (!Cact) return false;
+    SharedMatrix Cnew = get_orbitals("ACT");
+    if (Cact->nirrep() != Cnew->nirrep() || Cact->rowspi() != Cnew->rowspi() || Cact->colspi() != Cnew->colspi())
+        return false;
+    SharedMatrix O = linalg::triplet(Cact, S_, Cnew, true, false, false);
+    for (int h = 0; h < O->nirrep(); h++) {
+        for (int i = 0; i < O->rowdim(h); i++) {
+            if (std::fabs(O->get(h, i, i)) < warm_start_min_overlap) return false;
+        }
+    }
+    return true;
+}
+
+/*
+** save_warm_start(): Keep the converged roots in the D file for the next CIWavefunction, as long
+**   as they take no more than a tenth of the memory
+*/
+void CIWavefunction::save_warm_start() {
+    WarmStartCache &cache = warm_start_cache();
+    cache.signature.clear();
+    cache.basis.clear();
+    cache.Cact.reset();
+    cache.roots.clear();
+    if (!Parameters_->ci_warm_start || Parameters_->nodfile) return;
+
+    int nroots = Parameters_->num_roots;
+    if ((double)nroots * CIblks_->vectlen * sizeof(double) > 0.1 * Process::environment.get_memory()) return;
+
+    SharedCIVector Dvec = D_vector();
+    Dvec->init_io_files(true);
+    cache.roots.resize(nroots);
+    for (int root = 0; root < nroots; root++) {
+        for (int buf = 0; buf < Dvec->buf_per_vect_; buf++) {
+            Dvec->read(root, buf);
+            cache.roots[root].insert(cache.roots[root].end(), Dvec->buffer_, Dvec->buffer_ + Dvec->buf_size_[buf]);
+        }
+    }
+    Dvec->close_io_files(1);
+    cache.signature = ci_space_signature();
+    cache.basis = basisset_->name();
+    cache.Cact = get_orbitals("ACT");
+}
+
 }  // namespace detci
 }  // namespace psi
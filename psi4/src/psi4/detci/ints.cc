@@ -62,6 +62,7 @@
 #include "psi4/libfock/jk.h"
 #include "psi4/libfock/soscf.h"
 #include "psi4/libmints/basisset.h"
+#include "psi4/libmints/molecule.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions.h"
@@ -78,6 +79,23 @@
 namespace psi {
 namespace detci {
 
+namespace {
+/*
+** AO-side DF-MCSCF objects (the JK object and the DFHelper with its AO three-index tensor),
+**   kept after a run with MCSCF_DF_CACHE so the next DF-MCSCF with the same key skips building them
+*/
+struct DFMCSCFCache {
+    std::string key;
+    std::shared_ptr<JK> jk;
+    std::shared_ptr<DFHelper> dfh;
+};
+
+DFMCSCFCache &dfmcscf_cache() {
+    static DFMCSCFCache cache;
+    return cache;
+}
+}  // namespace
+
 void CIWavefunction::transform_ci_integrals() {
     outfile->Printf("\n   ==> Transforming CI integrals <==\n\n");
     // Grab orbitals
@@ -130,6 +148,27 @@ void CIWavefunction::transform_ci_integrals() {
 void CIWavefunction::setup_dfmcscf_ints() {
     outfile->Printf("\n   ==> Setting up DF-MCSCF integrals <==\n\n");
 
+    // The AO integrals only depend on the geometry, the basis sets, and the JK settings
+    std::string key = basisset_->name() + "/" + get_basisset("DF_BASIS_SCF")->name() + "/" +
+                      options_.get_str("SCF_TYPE") + "/" + std::to_string(Process::environment.get_memory());
+    Matrix geom = molecule_->geometry();
+    for (int atom = 0; atom < molecule_->natom(); atom++) {
+        char xyz[96];
+        std::snprintf(xyz, sizeof(xyz), "/%.12f,%.12f,%.12f", geom.get(atom, 0), geom.get(atom, 1), geom.get(atom, 2));
+        key += xyz;
+    }
+
+    DFMCSCFCache &cache = dfmcscf_cache();
+    if (Parameters_->mcscf_df_cache && cache.jk && cache.key == key) {
+        outfile->Printf("    Reusing the AO integrals of the previous DF-MCSCF on this geometry.\n\n");
+        jk_ = cache.jk;
+        dfh_ = cache.dfh;
+        df_ints_init_ = true;
+        return;
+    }
+    // Release any kept integrals before building new ones
+    cache = DFMCSCFCache();
+
     /// Build JK object
     size_t effective_memory = Process::environment.get_memory() * 0.8 / sizeof(double);
     jk_ = JK::build_JK(basisset_, get_basisset("DF_BASIS_SCF"), options_, false, effective_memory);
@@ -153,6 +192,11 @@ void CIWavefunction::setup_dfmcscf_ints() {
     dfh_->set_nthreads(num_threads_);
     dfh_->initialize();
 
+    if (Parameters_->mcscf_df_cache) {
+        cache.key = key;
+        cache.jk = jk_;
+        cache.dfh = dfh_;
+    }
     df_ints_init_ = true;
 }
 void CIWavefunction::transform_mcscf_integrals(bool approx_only) {
@@ -950,27 +994,9 @@ void CIWavefunction::form_gmat(SharedVector onel, SharedVector twoel, SharedVect
 }
 
 void CIWavefunction::onel_ints_from_jk() {
-    // Compute the frozen fock if needed
+    // The frozen core Fock is needed once; its JK build goes along with the first inactive one
     // This is the *only* place where the frozen fock enters
-    if ((!fzc_fock_computed_) && (CalcInfo_->frozen_docc.sum() > 0)) {
-        std::vector<SharedMatrix>& Cl = jk_->C_left();
-        std::vector<SharedMatrix>& Cr = jk_->C_right();
-        Cl.clear();
-        Cr.clear();
-
-        Cl.push_back(get_orbitals("FZC"));
-        jk_->compute();
-        Cl.clear();
-
-        const std::vector<SharedMatrix>& J = jk_->J();
-        const std::vector<SharedMatrix>& K = jk_->K();
-
-        J[0]->scale(2.0);
-        J[0]->subtract(K[0]);
-
-        CalcInfo_->fzc_so_onel_ints = J[0]->clone();
-        fzc_fock_computed_ = true;
-    }
+    bool form_fzc = (!fzc_fock_computed_) && (CalcInfo_->frozen_docc.sum() > 0);
 
     SharedMatrix Cact = get_orbitals("ACT");
     SharedMatrix Cdocc = get_orbitals("DOCC");
@@ -981,12 +1007,21 @@ void CIWavefunction::onel_ints_from_jk() {
     Cr.clear();
 
     Cl.push_back(Cdocc);
+    if (form_fzc) Cl.push_back(get_orbitals("FZC"));
     jk_->compute();
     Cl.clear();
 
     const std::vector<SharedMatrix>& J = jk_->J();
     const std::vector<SharedMatrix>& K = jk_->K();
 
+    if (form_fzc) {
+        J[1]->scale(2.0);
+        J[1]->subtract(K[1]);
+
+        CalcInfo_->fzc_so_onel_ints = J[1]->clone();
+        fzc_fock_computed_ = true;
+    }
+
     J[0]->scale(2.0);
     J[0]->subtract(K[0]);
     if (CalcInfo_->frozen_docc.sum() > 0) {
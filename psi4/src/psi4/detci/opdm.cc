@@ -40,6 +40,7 @@
 #include "psi4/psifiles.h"
 #include "psi4/physconst.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/memory_manager.h"
 
 #include "psi4/detci/structs.h"
 #include "psi4/detci/civect.h"
@@ -48,6 +49,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 namespace detci {
@@ -58,6 +64,15 @@ namespace detci {
 #define TOL 1E-14
 
 void CIWavefunction::form_opdm() {
+    if (sci_) {
+        std::vector<std::vector<SharedMatrix> > opdm_list = sci_opdm();
+        for (const auto& root_opdm : opdm_list) {
+            for (const auto& D : root_opdm) opdm_map_[D->name()] = D;
+        }
+        set_current_opdm(opdm_list);
+        return;
+    }
+
     // if we're trying to follow a root, figure out which one here
     // CDS help: Why is this here and where can we move it?
     if (Parameters_->follow_vec_num > 0) {
@@ -106,39 +121,32 @@ void CIWavefunction::form_opdm() {
     SharedCIVector Jvec = new_civector(Parameters_->num_roots, Parameters_->d_filenum);
     Jvec->init_io_files(true);
 
-    std::vector<std::vector<SharedMatrix> > opdm_list;
+    // OPDM's first, so that opdm_list[root] is the OPDM of root, then the transition-OPDM's; all in one pass
     std::vector<std::tuple<int, int> > states_vec;
-
-    // Transition-OPDM's
+    for (int i = 0; i < Parameters_->num_roots; ++i) {
+        states_vec.push_back(std::make_tuple(i, i));
+    }
     if (Parameters_->transdens) {
-        states_vec.clear();
         for (int i = 0; i < Parameters_->num_roots; ++i) {
             for (int j = i + 1; j < Parameters_->num_roots; ++j) {
                 states_vec.push_back(std::make_tuple(i, j));
             }
         }
-        opdm_list = opdm(Ivec, Jvec, states_vec);
-        for (const auto& tdm : opdm_list) {
-            opdm_map_[tdm[0]->name()] = tdm[0];
-            opdm_map_[tdm[1]->name()] = tdm[1];
-            opdm_map_[tdm[2]->name()] = tdm[2];
-        }
-    }
-
-    // OPDM's
-    states_vec.clear();
-    for (int i = 0; i < Parameters_->num_roots; ++i) {
-        states_vec.push_back(std::make_tuple(i, i));
     }
-    opdm_list = opdm(Ivec, Jvec, states_vec);
-    for (int i = 0; i < Parameters_->num_roots; i++) {
-        opdm_map_[opdm_list[i][0]->name()] = opdm_list[i][0];
-        opdm_map_[opdm_list[i][1]->name()] = opdm_list[i][1];
-        opdm_map_[opdm_list[i][2]->name()] = opdm_list[i][2];
+    std::vector<std::vector<SharedMatrix> > opdm_list = opdm(Ivec, Jvec, states_vec);
+    for (const auto& dm : opdm_list) {
+        opdm_map_[dm[0]->name()] = dm[0];
+        opdm_map_[dm[1]->name()] = dm[1];
+        opdm_map_[dm[2]->name()] = dm[2];
     }
     Ivec->close_io_files(true);  // Closes Jvec too
 
-    // Figure out which OPDM should be current
+    set_current_opdm(opdm_list);
+}
+/*
+** Makes "the" OPDM from the per-root OPDMs (state average or the followed root) and sets Da_/Db_
+*/
+void CIWavefunction::set_current_opdm(const std::vector<std::vector<SharedMatrix> >& opdm_list) {
     if (Parameters_->opdm_ave) {
         Dimension act_dim = get_dimension("ACT");
         opdm_a_ = std::make_shared<Matrix>("MO-basis Alpha OPDM", nirrep_, act_dim, act_dim);
@@ -259,6 +267,11 @@ std::vector<std::vector<SharedMatrix> > CIWavefunction::opdm(SharedCIVector Ivec
     double **scratch_ap = scratch_a->pointer();
     double **scratch_bp = scratch_b->pointer();
 
+    // With whole vectors in core all the states are done together, up front, if the copies of
+    // the roots fit in memory; otherwise the states are streamed one at a time below
+    std::vector<SharedMatrix> incore_opdm;
+    bool incore = Parameters_->icore == 1 && opdm_incore(Ivec, Jvec, states_vec, incore_opdm);
+
     for (int root_idx = 0; root_idx < states_vec.size(); root_idx++) {
         int Iroot = std::get<0>(states_vec[root_idx]);
         int Jroot = std::get<1>(states_vec[root_idx]);
@@ -347,7 +360,12 @@ std::vector<std::vector<SharedMatrix> > CIWavefunction::opdm(SharedCIVector Ivec
             }         /* end loop over Ibuf */
         }             /* end icore==0 */
 
-        else if (Parameters_->icore == 1) { /* whole vectors in-core */
+        else if (incore) { /* whole vectors in-core, all states at once */
+            scratch_a->copy(incore_opdm[2 * root_idx]);
+            scratch_b->copy(incore_opdm[2 * root_idx + 1]);
+        }
+
+        else if (Parameters_->icore == 1) { /* whole vectors in-core, one state at a time */
             Ivec->read(Iroot, 0);
             Jvec->read(Jroot, 0);
             for (Iblock = 0; Iblock < Ivec->num_blocks_; Iblock++) {
@@ -516,6 +534,141 @@ std::vector<std::vector<SharedMatrix> > CIWavefunction::opdm(SharedCIVector Ivec
     return opdm_list;
 }
 
+/*
+** opdm_incore(): The icore=1 OPDMs of all states_vec pairs in one pass over the coupled block
+** pairs, split over the threads with per-thread partial sums. Fills scratch with the alpha and
+** beta (CI order) matrices of each pair in turn; returns false, doing nothing, if the copies of
+** the roots do not fit in memory.
+*/
+bool CIWavefunction::opdm_incore(SharedCIVector Ivec, SharedCIVector Jvec,
+                                 const std::vector<std::tuple<int, int> > &states_vec,
+                                 std::vector<SharedMatrix> &scratch) {
+    int nci = CalcInfo_->num_ci_orbs;
+    size_t nstate = states_vec.size();
+
+    std::vector<int> Iroots, Jroots, Istate, Jstate;
+    for (const auto &state : states_vec) {
+        Iroots.push_back(std::get<0>(state));
+        Jroots.push_back(std::get<1>(state));
+    }
+    std::vector<std::pair<int, int> > copies = incore_root_copies(Ivec, Jvec, Iroots, Jroots, Istate, Jstate);
+
+    std::vector<std::pair<int, int> > pairs;
+    for (int Iblock = 0; Iblock < Ivec->num_blocks_; Iblock++) {
+        if (Ivec->Ia_size_[Iblock] == 0 || Ivec->Ib_size_[Iblock] == 0) continue;
+        for (int Jblock = 0; Jblock < Jvec->num_blocks_; Jblock++) {
+            if (Jvec->Ia_size_[Jblock] == 0 || Jvec->Ib_size_[Jblock] == 0) continue;
+            if (s1_contrib_[Iblock][Jblock] || s2_contrib_[Iblock][Jblock]) pairs.emplace_back(Iblock, Jblock);
+        }
+    }
+
+    size_t thread_bytes = 2 * nstate * nci * nci * sizeof(double);
+    MemoryGrant grant("DETCI OPDM scratch");
+    int nthread = incore_density_threads(grant, copies.size() * Ivec->vectlen_ * sizeof(double) + thread_bytes,
+                                         thread_bytes, std::max(1, std::min(Parameters_->nthreads, (int)pairs.size())));
+    if (!nthread) return false;
+
+    std::vector<std::vector<double> > data;
+    std::vector<std::vector<std::vector<double *> > > rows;
+    read_incore_roots(Ivec, Jvec, copies, data, rows);
+
+    std::vector<std::vector<SharedMatrix> > partial(nthread);
+    for (int thread = 0; thread < nthread; thread++) {
+        for (size_t n = 0; n < 2 * nstate; n++) partial[thread].push_back(std::make_shared<Matrix>(nci, nci));
+    }
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthread) if (nthread > 1)
+    for (size_t pair = 0; pair < pairs.size(); pair++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int Iblock = pairs[pair].first;
+        int Jblock = pairs[pair].second;
+        for (size_t state = 0; state < nstate; state++) {
+            opdm_block(alplist_, betlist_, partial[thread][2 * state]->pointer(),
+                       partial[thread][2 * state + 1]->pointer(), rows[Jstate[state]][Jblock].data(),
+                       rows[Istate[state]][Iblock].data(), Jvec->Ia_code_[Jblock], Jvec->Ib_code_[Jblock],
+                       Jvec->Ia_size_[Jblock], Jvec->Ib_size_[Jblock], Ivec->Ia_code_[Iblock], Ivec->Ib_code_[Iblock],
+                       Ivec->Ia_size_[Iblock], Ivec->Ib_size_[Iblock]);
+        }
+    }
+
+    for (int thread = 1; thread < nthread; thread++) {
+        for (size_t n = 0; n < 2 * nstate; n++) partial[0][n]->add(partial[thread][n]);
+    }
+    scratch = partial[0];
+    return true;
+}
+
+/*
+** incore_root_copies(): The root copies the icore=1 densities need for the states (Iroots[n],
+** Jroots[n]), as (0 for Ivec or 1 for Jvec, root). A root listed more than once is copied once,
+** and when Ivec and Jvec are views of the same file, as for the densities of one vector, the
+** roots of both share their copies. Icopy and Jcopy get the copy of each entry of Iroots and
+** Jroots.
+*/
+std::vector<std::pair<int, int> > CIWavefunction::incore_root_copies(SharedCIVector Ivec, SharedCIVector Jvec,
+                                                                     const std::vector<int> &Iroots,
+                                                                     const std::vector<int> &Jroots,
+                                                                     std::vector<int> &Icopy, std::vector<int> &Jcopy) {
+    bool same = Ivec == Jvec || (Ivec->units_ == Jvec->units_ && Ivec->new_first_buf_ == Jvec->new_first_buf_);
+    std::vector<std::pair<int, int> > copies;
+    auto copy_of = [&](int vec, int root) {
+        std::pair<int, int> key(same ? 0 : vec, root);
+        auto found = std::find(copies.begin(), copies.end(), key);
+        if (found != copies.end()) return (int)(found - copies.begin());
+        copies.push_back(key);
+        return (int)copies.size() - 1;
+    };
+    Icopy.clear();
+    Jcopy.clear();
+    for (int root : Iroots) Icopy.push_back(copy_of(0, root));
+    for (int root : Jroots) Jcopy.push_back(copy_of(1, root));
+    return copies;
+}
+
+/*
+** read_incore_roots(): Reads the roots listed by incore_root_copies() into copies of their own,
+** so that several roots can be worked on at once, with rows[copy][block] the row pointers of a
+** block.
+*/
+void CIWavefunction::read_incore_roots(SharedCIVector Ivec, SharedCIVector Jvec,
+                                       const std::vector<std::pair<int, int> > &copies,
+                                       std::vector<std::vector<double> > &data,
+                                       std::vector<std::vector<std::vector<double *> > > &rows) {
+    data.resize(copies.size());
+    rows.resize(copies.size());
+    for (size_t n = 0; n < copies.size(); n++) {
+        SharedCIVector vec = copies[n].first ? Jvec : Ivec;
+        vec->read(copies[n].second, 0);
+        data[n].assign(vec->buffer_, vec->buffer_ + vec->vectlen_);
+        rows[n].resize(vec->num_blocks_);
+        for (int blk = 0; blk < vec->num_blocks_; blk++) {
+            if (vec->Ia_size_[blk] == 0 || vec->Ib_size_[blk] == 0) continue;
+            for (int row = 0; row < vec->Ia_size_[blk]; row++) {
+                rows[n][blk].push_back(data[n].data() + (vec->blocks_[blk][row] - vec->buffer_));
+            }
+        }
+    }
+}
+
+/*
+** incore_density_threads(): The number of threads, at most nthread, that the icore=1 densities
+** can use within what the MemoryBroker grants under the name of grant: base_bytes (the root
+** copies and the sums of one thread) must fit, and each further thread takes thread_bytes of
+** partial sums. Returns 0 if base_bytes does not fit, and the states should be streamed.
+*/
+int CIWavefunction::incore_density_threads(const MemoryGrant &grant, size_t base_bytes, size_t thread_bytes,
+                                           int nthread) {
+    MemoryBroker &broker = MemoryBroker::shared_object();
+    broker.request(grant.name(), 0, {{base_bytes, 1.0}, {base_bytes + (nthread - 1) * thread_bytes, 1.5}});
+    size_t granted = broker.allocate()[grant.name()];
+    if (granted < base_bytes) return 0;
+    if (!thread_bytes) return nthread;
+    return (int)std::min((size_t)nthread, 1 + (granted - base_bytes) / thread_bytes);
+}
+
 void CIWavefunction::opdm_block(struct stringwr **alplist, struct stringwr **betlist, double **onepdm_a,
                                 double **onepdm_b, double **CJ, double **CI, int Ja_list, int Jb_list, int Jnas,
                                 int Jnbs, int Ia_list, int Ib_list, int Inas, int Inbs) {
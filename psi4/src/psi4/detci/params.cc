@@ -294,6 +294,8 @@ void CIWavefunction::get_parameters(Options &options) {
             Parameters_->guess_vector = PARM_GUESS_VEC_UNIT;
     }
 
+    Parameters_->ci_warm_start = options.get_bool("CI_WARM_START");
+
     Parameters_->icore = options.get_int("ICORE");
 
     if (options["HD_AVG"].has_changed()) {
@@ -330,8 +332,12 @@ void CIWavefunction::get_parameters(Options &options) {
             Parameters_->diag_method = METHOD_DAVIDSON_LIU_SEM;
         } else if (line1 == "SEM") {
             Parameters_->diag_method = METHOD_DAVIDSON_LIU_SEM;
+        } else if (line1 == "HCI") {
+            Parameters_->diag_method = METHOD_HCI;
         }
     }
+    Parameters_->hci_epsilon = options.get_double("HCI_EPSILON");
+    Parameters_->hci_maxiter = options.get_int("HCI_MAXITER");
 
     if ((Parameters_->diag_method == METHOD_RSP) & (Parameters_->icore != 1)) {
         outfile->Printf("RSP only works with icore = 1, switching.");
@@ -667,6 +673,7 @@ void CIWavefunction::get_parameters(Options &options) {
     Parameters_->diis_min_vecs = options.get_int("DIIS_MIN_VECS");
     Parameters_->diis_max_vecs = options.get_int("DIIS_MAX_VECS");
     Parameters_->mcscf_type = options_.get_str("MCSCF_TYPE");
+    Parameters_->mcscf_df_cache = options_.get_bool("MCSCF_DF_CACHE");
 }
 
 /*
@@ -710,6 +717,9 @@ void CIWavefunction::print_parameters() {
         case 3:
             outfile->Printf("%6s", "SEM");
             break;
+        case 4:
+            outfile->Printf("%6s", "HCI");
+            break;
         default:
             outfile->Printf("%6s", "???");
             break;
@@ -36,6 +36,10 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/wavefunction.h"
@@ -49,6 +53,49 @@ int form_ilist_rotf(int *Cnt, int **Ridx, signed char **Sn, int **Ij, int nas, i
 
 #define INDEX(i, j) ((i > j) ? (ioff[(i)] + (j)) : (ioff[(j)] + (i)))
 
+namespace {
+
+bool in_parallel() {
+#ifdef _OPENMP
+    return omp_in_parallel();
+#else
+    return false;
+#endif
+}
+
+/*
+** The rows (alpha strings) of one s3 block are shared out among the threads. Inside an enclosing
+** parallel region, i.e. the block loop of sigma_b(), the block is done by the calling thread alone.
+*/
+int s3_threads(int nas) {
+#ifdef _OPENMP
+    if (nas > 1 && !omp_in_parallel()) return omp_get_max_threads();
+#endif
+    return 1;
+}
+
+/* V of the calling thread: the caller's V when serial, a slice of Vthread otherwise */
+double *s3_thread_v(double *V, std::vector<double> &Vthread, int nthread, int nbs) {
+#ifdef _OPENMP
+    if (nthread > 1) return Vthread.data() + (size_t)omp_get_thread_num() * nbs;
+#endif
+    return V;
+}
+
+/* C'(I,J) = sgn(J) C(I,L(J)) */
+inline void s3_gather(double *CprimeI, const double *CI, const int *L, const double *Sgn, int jlen) {
+#pragma omp simd
+    for (int J = 0; J < jlen; J++) CprimeI[J] = CI[L[J]] * Sgn[J];
+}
+
+/* S(Ia,R(J)) += V(J); the R(J) of one ij are distinct beta strings, so no two lanes collide */
+inline void s3_scatter(double *SI, const double *V, const int *R, int jlen) {
+#pragma omp simd
+    for (int J = 0; J < jlen; J++) SI[R[J]] += V[J];
+}
+
+}  // namespace
+
 /*
 ** S3_BLOCK_VDIAG()
 **
@@ -61,19 +108,19 @@ int form_ilist_rotf(int *Cnt, int **Ridx, signed char **Sn, int **Ij, int nas, i
 **
 ** currently assumes that (ij|ij)'s have not been halved
 ** Try to get the Olsen vector version working....again!!!!
+**
+** nroot C and sigma blocks are done at once: rows r*cnas..(r+1)*cnas-1 of C
+** and r*nas..(r+1)*nas-1 of S belong to root r, and the rows of Cprime must
+** hold nroot*cnbs elements.  The roots share the string lists, and their
+** Cprime rows are laid end to end so one axpy serves all of them.
 */
 void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist, double **C, double **S, double *tei, int nas,
                     int nbs, int cnas, int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym, double **Cprime,
-                    double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym) {
-    struct stringwr *Ia;
-    size_t Ia_ex;
-    int ij, i, j, t, kl, I, J, RJ;
-    double tval, VS, *CprimeI0, *CI0;
-    int jlen, Jacnt, *Iaij, Ia_idx;
-    size_t *Iaridx;
-    signed char *Iasgn;
+                    double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym, int nroot) {
+    int ij, i, j, jlen;
     double *Tptr;
-    int npthreads, rc, status;
+    int nthread = s3_threads(nas);
+    std::vector<double> Vthread(nthread > 1 ? (size_t)nthread * nroot * nbs : 0);
 
     /* loop over i, j */
     for (i = 0; i < norbs; i++) {
@@ -87,47 +134,49 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist, double *
              */
             Tptr = tei + ioff[ij];
 
-            /* gather operation */
-            for (I = 0; I < cnas; I++) {
-                CprimeI0 = Cprime[I];
-                CI0 = C[I];
-                for (J = 0; J < jlen; J++) {
-                    tval = Sgn[J];
-                    CprimeI0[J] = CI0[L[J]] * tval;
+#pragma omp parallel num_threads(nthread) if (nthread > 1)
+            {
+                double *VI = s3_thread_v(V, Vthread, nthread, nroot * nbs);
+                int vlen = nroot * jlen;
+
+                /* gather operation */
+#pragma omp for schedule(static)
+                for (int I = 0; I < cnas; I++) {
+                    for (int r = 0; r < nroot; r++) s3_gather(Cprime[I] + r * jlen, C[r * cnas + I], L, Sgn, jlen);
                 }
-            }
 
-            for (Ia = alplist, Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
-                /* loop over excitations E^a_{kl} from |A(I_a)> */
-                Jacnt = Ia->cnt[Ja_list];
-                Iaridx = Ia->ridx[Ja_list];
-                Iasgn = Ia->sgn[Ja_list];
-                Iaij = Ia->ij[Ja_list];
-
-                zero_arr(V, jlen);
-                for (Ia_ex = 0; Ia_ex < Jacnt && (kl = *Iaij++) <= ij; Ia_ex++) {
-                    I = *Iaridx++;
-                    tval = *Iasgn++;
-                    if (ij == kl) tval *= 0.5;
-                    VS = Tptr[kl] * tval;
-                    CprimeI0 = Cprime[I];
+#pragma omp for schedule(dynamic, 8)
+                for (int Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+                    /* loop over excitations E^a_{kl} from |A(I_a)> */
+                    struct stringwr *Ia = alplist + Ia_idx;
+                    size_t Jacnt = Ia->cnt[Ja_list];
+                    size_t *Iaridx = Ia->ridx[Ja_list];
+                    signed char *Iasgn = Ia->sgn[Ja_list];
+                    int *Iaij = Ia->ij[Ja_list];
+                    int kl;
+
+                    zero_arr(VI, vlen);
+                    for (size_t Ia_ex = 0; Ia_ex < Jacnt && (kl = *Iaij++) <= ij; Ia_ex++) {
+                        double tval = *Iasgn++;
+                        if (ij == kl) tval *= 0.5;
+                        double VS = Tptr[kl] * tval;
+                        double *CprimeI0 = Cprime[*Iaridx++];
 
 #ifdef USE_BS
-                    C_DAXPY(jlen, VS, CprimeI0, 1, V, 1);
+                        C_DAXPY(vlen, VS, CprimeI0, 1, VI, 1);
 #else
-                    for (J = 0; J < jlen; J++) {
-                        V[J] += VS * CprimeI0[J];
-                    }
+#pragma omp simd
+                        for (int J = 0; J < vlen; J++) {
+                            VI[J] += VS * CprimeI0[J];
+                        }
 #endif
-                }
+                    }
 
-                /* scatter */
-                for (J = 0; J < jlen; J++) {
-                    RJ = R[J];
-                    S[Ia_idx][RJ] += V[J];
-                }
+                    /* scatter */
+                    for (int r = 0; r < nroot; r++) s3_scatter(S[r * nas + Ia_idx], VI + r * jlen, R, jlen);
 
-            } /* end loop over Ia */
+                } /* end loop over Ia */
+            }
 
         } /* end loop over j */
     }     /* end loop over i */
@@ -139,18 +188,15 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist, double *
 ** Calculate a block of the sigma3 vector in equation (9c) of
 ** Olsen, Roos, et al.  For non-diagonal blocks of s3
 **
+** nroot blocks at once, laid out as in s3_block_vdiag()
 */
 void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C, double **S, double *tei, int nas,
                 int nbs, int cnas, int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym, double **Cprime,
-                double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym) {
-    struct stringwr *Ia;
-    size_t Ia_ex;
-    int ij, i, j, kl, ijkl, I, J, RJ;
-    double tval, VS, *CprimeI0, *CI0;
-    int jlen, Ia_idx, Jacnt, *Iaij;
-    size_t *Iaridx;
-    signed char *Iasgn;
-    double *Tptr;
+                double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym, int nroot) {
+    int ij, i, j, jlen;
+    int nthread = s3_threads(nas);
+    bool timed = !in_parallel();
+    std::vector<double> Vthread(nthread > 1 ? (size_t)nthread * nroot * nbs : 0);
 
     /* loop over i, j */
     for (i = 0; i < norbs; i++) {
@@ -161,53 +207,50 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
 
             if (!jlen) continue;
 
-            Tptr = tei + ioff[ij];
+            if (timed) timer_on("CIWave: s3_mt");
+#pragma omp parallel num_threads(nthread) if (nthread > 1)
+            {
+                double *VI = s3_thread_v(V, Vthread, nthread, nroot * nbs);
+                int vlen = nroot * jlen;
 
-            /* gather operation */
-            for (I = 0; I < cnas; I++) {
-                CprimeI0 = Cprime[I];
-                CI0 = C[I];
-                for (J = 0; J < jlen; J++) {
-                    tval = Sgn[J];
-                    CprimeI0[J] = CI0[L[J]] * tval;
+                /* gather operation */
+#pragma omp for schedule(static)
+                for (int I = 0; I < cnas; I++) {
+                    for (int r = 0; r < nroot; r++) s3_gather(Cprime[I] + r * jlen, C[r * cnas + I], L, Sgn, jlen);
                 }
-            }
 
-            timer_on("CIWave: s3_mt");
-            for (Ia = alplist, Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
-                /* loop over excitations E^a_{kl} from |A(I_a)> */
-                Jacnt = Ia->cnt[Ja_list];
-                Iaridx = Ia->ridx[Ja_list];
-                Iasgn = Ia->sgn[Ja_list];
-                Iaij = Ia->ij[Ja_list];
+#pragma omp for schedule(dynamic, 8)
+                for (int Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+                    /* loop over excitations E^a_{kl} from |A(I_a)> */
+                    struct stringwr *Ia = alplist + Ia_idx;
+                    size_t Jacnt = Ia->cnt[Ja_list];
+                    size_t *Iaridx = Ia->ridx[Ja_list];
+                    signed char *Iasgn = Ia->sgn[Ja_list];
+                    int *Iaij = Ia->ij[Ja_list];
 
-                zero_arr(V, jlen);
+                    zero_arr(VI, vlen);
 
-                for (Ia_ex = 0; Ia_ex < Jacnt; Ia_ex++) {
-                    kl = *Iaij++;
-                    I = *Iaridx++;
-                    tval = *Iasgn++;
-                    ijkl = INDEX(ij, kl);
-                    VS = tval * tei[ijkl];
-                    CprimeI0 = Cprime[I];
+                    for (size_t Ia_ex = 0; Ia_ex < Jacnt; Ia_ex++) {
+                        int kl = *Iaij++;
+                        double VS = *Iasgn++ * tei[INDEX(ij, kl)];
+                        double *CprimeI0 = Cprime[*Iaridx++];
 
 #ifdef UBLAS
-                    C_DAXPY(jlen, VS, CprimeI0, 1, V, 1);
+                        C_DAXPY(vlen, VS, CprimeI0, 1, VI, 1);
 #else
-                    for (J = 0; J < jlen; J++) {
-                        V[J] += VS * CprimeI0[J];
-                    }
+#pragma omp simd
+                        for (int J = 0; J < vlen; J++) {
+                            VI[J] += VS * CprimeI0[J];
+                        }
 #endif
-                }
+                    }
 
-                /* scatter */
-                for (J = 0; J < jlen; J++) {
-                    RJ = R[J];
-                    S[Ia_idx][RJ] += V[J];
-                }
+                    /* scatter */
+                    for (int r = 0; r < nroot; r++) s3_scatter(S[r * nas + Ia_idx], VI + r * jlen, R, jlen);
 
-            } /* end loop over Ia */
-            timer_off("CIWave: s3_mt");
+                } /* end loop over Ia */
+            }
+            if (timed) timer_off("CIWave: s3_mt");
 
         } /* end loop over j */
     }     /* end loop over i */
@@ -0,0 +1,931 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DETCI
+    \brief Heat-bath selected CI in the active space
+*/
+
+#include <cmath>
+#include <algorithm>
+#include <bitset>
+#include <sstream>
+#include <unordered_set>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "psi4/libqt/qt.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/detci/structs.h"
+#include "psi4/detci/ciwave.h"
+#include "psi4/detci/sci.h"
+
+namespace psi {
+namespace detci {
+
+namespace {
+
+// Spaces up to this size are diagonalized directly
+const size_t sci_dense_max = 400;
+
+inline uint64_t obit(int p) { return uint64_t(1) << p; }
+
+inline int npop(uint64_t x) { return (int)std::bitset<64>(x).count(); }
+
+inline int lowest(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int p = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        p++;
+    }
+    return p;
+#endif
+}
+
+// Sign of a_p (or a^+_p) acting on string d
+inline double sign_below(uint64_t d, int p) { return (npop(d & (obit(p) - 1)) & 1) ? -1.0 : 1.0; }
+
+// Sign of a^+_r a_p acting on string d
+inline double single_sign(uint64_t d, int p, int r) {
+    double sgn = sign_below(d, p);
+    return sgn * sign_below(d ^ obit(p), r);
+}
+
+// Sign of a^+_r a^+_s a_q a_p acting on string d
+inline double double_sign(uint64_t d, int p, int q, int r, int s) {
+    double sgn = sign_below(d, p);
+    d ^= obit(p);
+    sgn *= sign_below(d, q);
+    d ^= obit(q);
+    sgn *= sign_below(d, s);
+    d |= obit(s);
+    return sgn * sign_below(d, r);
+}
+
+inline size_t tri(size_t i, size_t j) { return (i >= j) ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i; }
+
+inline int thread_id() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+inline int max_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+}  // namespace
+
+SelectedCI::SelectedCI(int nact, int nalpha, int nbeta, const std::vector<int> &orbsym, const SCIDet &ref, bool ms0,
+                       double epsilon, int max_select, int print)
+    : nact_(nact),
+      nalpha_(nalpha),
+      nbeta_(nbeta),
+      orbsym_(orbsym),
+      ms0_(ms0),
+      epsilon_(epsilon),
+      max_select_(max_select),
+      print_(print),
+      memory_(0),
+      nroots_(0),
+      residual_(0.0),
+      converged_(false) {
+    if (nact_ > 64) {
+        throw PSIEXCEPTION("SelectedCI: at most 64 active orbitals are supported.");
+    }
+    if (npop(ref.a) != nalpha_ || npop(ref.b) != nbeta_) {
+        throw PSIEXCEPTION("SelectedCI: reference determinant does not hold the active electrons.");
+    }
+    add_det(ref);
+}
+
+void SelectedCI::set_integrals(const double *onel, const double *twoel) {
+    const int n = nact_;
+    h_.assign((size_t)n * n, 0.0);
+    eri_.assign((size_t)n * n * n * n, 0.0);
+
+    for (int p = 0; p < n; p++)
+        for (int q = 0; q < n; q++) h_[p * n + q] = onel[tri(p, q)];
+
+#pragma omp parallel for schedule(static)
+    for (int p = 0; p < n; p++) {
+        for (int q = 0; q < n; q++) {
+            size_t pq = tri(p, q);
+            double *out = eri_.data() + ((size_t)p * n + q) * n * n;
+            for (int r = 0; r < n; r++)
+                for (int s = 0; s < n; s++) out[r * n + s] = twoel[tri(pq, tri(r, s))];
+        }
+    }
+
+    // Heat-bath lists of the double excitations out of each occupied pair
+    const double cutoff = 1.0e-12;
+    hb_same_.assign((size_t)n * n, std::vector<HBEntry>());
+    hb_opp_.assign((size_t)n * n, std::vector<HBEntry>());
+    auto by_value = [](const HBEntry &x, const HBEntry &y) { return x.value > y.value; };
+
+#pragma omp parallel for schedule(dynamic)
+    for (int pq = 0; pq < n * n; pq++) {
+        int p = pq / n;
+        int q = pq % n;
+        int pqsym = orbsym_[p] ^ orbsym_[q];
+        for (int r = 0; r < n; r++) {
+            for (int s = 0; s < n; s++) {
+                if ((orbsym_[r] ^ orbsym_[s]) != pqsym) continue;
+                if (p < q && r < s) {
+                    double v = std::fabs(eri(p, r, q, s) - eri(p, s, q, r));
+                    if (v > cutoff) hb_same_[pq].push_back({v, r, s});
+                }
+                if (r != p && s != q) {
+                    double v = std::fabs(eri(p, r, q, s));
+                    if (v > cutoff) hb_opp_[pq].push_back({v, r, s});
+                }
+            }
+        }
+        std::sort(hb_same_[pq].begin(), hb_same_[pq].end(), by_value);
+        std::sort(hb_opp_[pq].begin(), hb_opp_[pq].end(), by_value);
+    }
+}
+
+double SelectedCI::diagonal(const SCIDet &D) const {
+    double E = 0.0;
+    for (uint64_t x = D.a; x; x &= x - 1) {
+        int p = lowest(x);
+        E += h_[p * nact_ + p];
+        for (uint64_t y = x & (x - 1); y; y &= y - 1) {
+            int q = lowest(y);
+            E += eri(p, p, q, q) - eri(p, q, q, p);
+        }
+        for (uint64_t y = D.b; y; y &= y - 1) {
+            int q = lowest(y);
+            E += eri(p, p, q, q);
+        }
+    }
+    for (uint64_t x = D.b; x; x &= x - 1) {
+        int p = lowest(x);
+        E += h_[p * nact_ + p];
+        for (uint64_t y = x & (x - 1); y; y &= y - 1) {
+            int q = lowest(y);
+            E += eri(p, p, q, q) - eri(p, q, q, p);
+        }
+    }
+    return E;
+}
+
+// <D'|H|D> for D' = a^+_r a_p D within string same, other is the string of the other spin
+double SelectedCI::single(uint64_t same, uint64_t other, int p, int r) const {
+    double v = h_[p * nact_ + r];
+    for (uint64_t x = same; x; x &= x - 1) {
+        int k = lowest(x);
+        v += eri(p, r, k, k) - eri(p, k, k, r);
+    }
+    for (uint64_t x = other; x; x &= x - 1) {
+        int k = lowest(x);
+        v += eri(p, r, k, k);
+    }
+    return single_sign(same, p, r) * v;
+}
+
+double SelectedCI::matrix_element(const SCIDet &I, const SCIDet &J) const {
+    uint64_t xa = I.a ^ J.a;
+    uint64_t xb = I.b ^ J.b;
+    int da = npop(xa) / 2;
+    int db = npop(xb) / 2;
+    if (da + db > 2) return 0.0;
+    if (da + db == 0) return diagonal(I);
+
+    if (da == 1 && db == 0) return single(I.a, I.b, lowest(I.a & xa), lowest(J.a & xa));
+    if (da == 0 && db == 1) return single(I.b, I.a, lowest(I.b & xb), lowest(J.b & xb));
+    if (da == 1 && db == 1) {
+        int pa = lowest(I.a & xa), ra = lowest(J.a & xa);
+        int pb = lowest(I.b & xb), rb = lowest(J.b & xb);
+        return single_sign(I.a, pa, ra) * single_sign(I.b, pb, rb) * eri(pa, ra, pb, rb);
+    }
+
+    uint64_t d = (da == 2) ? I.a : I.b;
+    uint64_t holes = d & (xa | xb);
+    uint64_t parts = ((da == 2) ? J.a : J.b) & (xa | xb);
+    int p = lowest(holes), q = lowest(holes & (holes - 1));
+    int r = lowest(parts), s = lowest(parts & (parts - 1));
+    return double_sign(d, p, q, r, s) * (eri(p, r, q, s) - eri(p, s, q, r));
+}
+
+bool SelectedCI::add_det(const SCIDet &D) {
+    if (index_.count(D)) return false;
+    index_.emplace(D, dets_.size());
+    dets_.push_back(D);
+    return true;
+}
+
+/*
+** memory_needed(): Bytes held for a space of ndet determinants with nnz off-diagonal Hamiltonian
+**   elements: the hashed store, the diagonal, the rows, the Davidson subspace (vectors and
+**   sigmas), the Ritz vectors and residuals, and the dense matrices of small spaces.
+*/
+size_t SelectedCI::memory_needed(size_t ndet, size_t nnz) const {
+    const size_t nroots = std::max(nroots_, 1);
+    const size_t maxsub = std::max(10 * nroots, nroots + 10);
+    size_t per_det = sizeof(SCIDet) + sizeof(std::vector<std::pair<size_t, double> >) +
+                     4 * sizeof(void *) + sizeof(SCIDet) + sizeof(size_t) /* hash node and bucket */ +
+                     (2 * maxsub + 3 * nroots + 2) * sizeof(double);
+    size_t bytes = ndet * per_det + nnz * sizeof(std::pair<size_t, double>);
+    if (ndet <= sci_dense_max) bytes += 2 * ndet * ndet * sizeof(double);
+    return bytes;
+}
+
+void SelectedCI::check_memory(size_t ndet, size_t nnz) const {
+    if (!memory_) return;
+    size_t need = memory_needed(ndet, nnz);
+    if (need <= memory_) return;
+    std::stringstream msg;
+    msg << "SelectedCI: a space of " << ndet << " determinants needs about " << need / 1048576 << " MiB, more than the "
+        << memory_ / 1048576 << " MiB available. Raise HCI_EPSILON or the memory.";
+    throw PSIEXCEPTION(msg.str());
+}
+
+/*
+** select(): Add every single and double excitation of the space that passes the heat-bath
+**   criterion max_k |H_ai c_ik| > epsilon. Returns the number of determinants added.
+*/
+size_t SelectedCI::select() {
+    const int n = nact_;
+    const size_t ndet = dets_.size();
+
+    std::vector<double> cmax(ndet, 0.0);
+    for (const auto &C : coeffs_)
+        for (size_t i = 0; i < ndet; i++) cmax[i] = std::max(cmax[i], std::fabs(C[i]));
+
+    // Candidates are collected per thread; the hash store is only read in here
+    std::vector<std::unordered_set<SCIDet, SCIDetHash> > found(max_threads());
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (size_t i = 0; i < ndet; i++) {
+        if (cmax[i] == 0.0) continue;
+        auto &mine = found[thread_id()];
+        const SCIDet D = dets_[i];
+        const double cut = epsilon_ / cmax[i];
+        auto keep = [&](const SCIDet &E) {
+            if (!index_.count(E)) mine.insert(E);
+        };
+
+        // Singles need the full matrix element
+        for (int spin = 0; spin < 2; spin++) {
+            uint64_t same = spin ? D.b : D.a;
+            uint64_t other = spin ? D.a : D.b;
+            for (uint64_t x = same; x; x &= x - 1) {
+                int p = lowest(x);
+                for (int r = 0; r < n; r++) {
+                    if ((same & obit(r)) || orbsym_[r] != orbsym_[p]) continue;
+                    if (std::fabs(single(same, other, p, r)) <= cut) continue;
+                    uint64_t ex = same ^ obit(p) ^ obit(r);
+                    keep(spin ? SCIDet{D.a, ex} : SCIDet{ex, D.b});
+                }
+            }
+        }
+
+        // Same-spin doubles
+        for (int spin = 0; spin < 2; spin++) {
+            uint64_t same = spin ? D.b : D.a;
+            for (uint64_t x = same; x; x &= x - 1) {
+                int p = lowest(x);
+                for (uint64_t y = x & (x - 1); y; y &= y - 1) {
+                    int q = lowest(y);
+                    for (const auto &e : hb_same_[p * n + q]) {
+                        if (e.value <= cut) break;
+                        if (same & (obit(e.r) | obit(e.s))) continue;
+                        uint64_t ex = same ^ obit(p) ^ obit(q) ^ obit(e.r) ^ obit(e.s);
+                        keep(spin ? SCIDet{D.a, ex} : SCIDet{ex, D.b});
+                    }
+                }
+            }
+        }
+
+        // Opposite-spin doubles
+        for (uint64_t x = D.a; x; x &= x - 1) {
+            int p = lowest(x);
+            for (uint64_t y = D.b; y; y &= y - 1) {
+                int q = lowest(y);
+                for (const auto &e : hb_opp_[p * n + q]) {
+                    if (e.value <= cut) break;
+                    if ((D.a & obit(e.r)) || (D.b & obit(e.s))) continue;
+                    keep(SCIDet{D.a ^ obit(p) ^ obit(e.r), D.b ^ obit(q) ^ obit(e.s)});
+                }
+            }
+        }
+    }
+
+    // Merge in a fixed order, so the space does not depend on the thread count
+    std::vector<SCIDet> add;
+    for (auto &mine : found) {
+        add.insert(add.end(), mine.begin(), mine.end());
+        mine.clear();
+    }
+    std::sort(add.begin(), add.end(),
+              [](const SCIDet &x, const SCIDet &y) { return x.a < y.a || (x.a == y.a && x.b < y.b); });
+
+    // Check that the grown space fits before it is stored, with rows as long as the current ones
+    size_t nnz = 0;
+    for (const auto &row : hrows_) nnz += row.size();
+    size_t nmax = ndet + (ms0_ ? 2 : 1) * add.size();
+    check_memory(nmax, ndet ? nnz / ndet * nmax : 0);
+
+    size_t nadd = 0;
+    for (const auto &D : add) {
+        if (add_det(D)) nadd++;
+        // Keep the space closed under alpha <-> beta so Ms = 0 states stay spin-adapted
+        if (ms0_ && add_det(SCIDet{D.b, D.a})) nadd++;
+    }
+
+    for (auto &C : coeffs_) C.resize(dets_.size(), 0.0);
+    return nadd;
+}
+
+/*
+** build_hamiltonian(): Diagonal and sparse off-diagonal rows of H over the space. Partners of a
+**   determinant are found among the determinants that share its alpha string (beta differs by a
+**   single or double), that share its beta string, and that have an alpha string one excitation
+**   away (beta differs by a single).
+*/
+void SelectedCI::build_hamiltonian() {
+    const size_t ndet = dets_.size();
+    hdiag_.assign(ndet, 0.0);
+    hrows_.assign(ndet, std::vector<std::pair<size_t, double> >());
+
+    std::unordered_map<uint64_t, std::vector<size_t> > by_alpha, by_beta;
+    for (size_t i = 0; i < ndet; i++) {
+        by_alpha[dets_[i].a].push_back(i);
+        by_beta[dets_[i].b].push_back(i);
+    }
+
+    // Two alpha strings are one excitation apart exactly when they agree after removing one electron each
+    std::unordered_map<uint64_t, std::vector<uint64_t> > by_hole;
+    for (const auto &kv : by_alpha)
+        for (uint64_t x = kv.first; x; x &= x - 1) by_hole[kv.first ^ obit(lowest(x))].push_back(kv.first);
+    std::unordered_map<uint64_t, std::vector<uint64_t> > alpha_singles;
+    for (const auto &kv : by_hole)
+        for (uint64_t a : kv.second)
+            for (uint64_t a2 : kv.second)
+                if (a != a2) alpha_singles[a].push_back(a2);
+    by_hole.clear();
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (size_t i = 0; i < ndet; i++) {
+        const SCIDet &I = dets_[i];
+        auto &row = hrows_[i];
+        hdiag_[i] = diagonal(I);
+
+        for (size_t j : by_alpha.find(I.a)->second) {
+            if (j != i && npop(I.b ^ dets_[j].b) <= 4) row.emplace_back(j, matrix_element(I, dets_[j]));
+        }
+        for (size_t j : by_beta.find(I.b)->second) {
+            if (j != i && npop(I.a ^ dets_[j].a) <= 4) row.emplace_back(j, matrix_element(I, dets_[j]));
+        }
+        auto it = alpha_singles.find(I.a);
+        if (it == alpha_singles.end()) continue;
+        for (uint64_t a2 : it->second) {
+            for (size_t j : by_alpha.find(a2)->second) {
+                if (npop(I.b ^ dets_[j].b) == 2) row.emplace_back(j, matrix_element(I, dets_[j]));
+            }
+        }
+    }
+}
+
+// S[k] = H C[k] for k >= first
+void SelectedCI::sigma(const std::vector<std::vector<double> > &C, std::vector<std::vector<double> > &S,
+                       size_t first) const {
+    const size_t ndet = dets_.size();
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < ndet; i++) {
+        for (size_t k = first; k < C.size(); k++) {
+            double s = hdiag_[i] * C[k][i];
+            for (const auto &e : hrows_[i]) s += e.second * C[k][e.first];
+            S[k][i] = s;
+        }
+    }
+}
+
+/*
+** davidson(): Lowest nroots_ eigenpairs of H over the space, starting from coeffs_. Small spaces
+**   are diagonalized directly. Returns whether the energies and residuals converged.
+*/
+bool SelectedCI::davidson(double conv_e, double conv_rms, int maxiter, int &iters) {
+    const size_t ndet = dets_.size();
+    const int nroots = nroots_;
+    evals_.assign(nroots, 0.0);
+
+    if (ndet <= sci_dense_max) {
+        auto H = std::make_shared<Matrix>("SCI Hamiltonian", (int)ndet, (int)ndet);
+        double **Hp = H->pointer();
+        for (size_t i = 0; i < ndet; i++) {
+            Hp[i][i] = hdiag_[i];
+            for (const auto &e : hrows_[i]) Hp[i][e.first] = e.second;
+        }
+        auto evecs = std::make_shared<Matrix>("SCI Eigenvectors", (int)ndet, (int)ndet);
+        auto evals = std::make_shared<Vector>("SCI Eigenvalues", (int)ndet);
+        H->diagonalize(evecs, evals, ascending);
+
+        coeffs_.assign(nroots, std::vector<double>(ndet, 0.0));
+        for (int k = 0; k < nroots && k < (int)ndet; k++) {
+            evals_[k] = evals->get(k);
+            for (size_t i = 0; i < ndet; i++) coeffs_[k][i] = evecs->get(i, k);
+        }
+        residual_ = 0.0;
+        iters = 1;
+        return true;
+    }
+
+    // Guess: the previous vectors, or the lowest diagonal determinants
+    if ((int)coeffs_.size() != nroots) {
+        std::vector<size_t> order(ndet);
+        for (size_t i = 0; i < ndet; i++) order[i] = i;
+        std::partial_sort(order.begin(), order.begin() + nroots, order.end(),
+                          [&](size_t x, size_t y) { return hdiag_[x] < hdiag_[y]; });
+        coeffs_.assign(nroots, std::vector<double>(ndet, 0.0));
+        for (int k = 0; k < nroots; k++) coeffs_[k][order[k]] = 1.0;
+    }
+
+    const size_t maxsub = std::max(10 * nroots, nroots + 10);
+    std::vector<std::vector<double> > V, S;
+    auto add_vector = [&](std::vector<double> &v) {
+        for (int pass = 0; pass < 2; pass++) {
+            for (auto &u : V) C_DAXPY(ndet, -C_DDOT(ndet, u.data(), 1, v.data(), 1), u.data(), 1, v.data(), 1);
+        }
+        double norm = std::sqrt(C_DDOT(ndet, v.data(), 1, v.data(), 1));
+        if (norm < 1.0e-8) return;
+        C_DSCAL(ndet, 1.0 / norm, v.data(), 1);
+        V.push_back(std::move(v));
+    };
+    for (int k = 0; k < nroots; k++) {
+        std::vector<double> v = coeffs_[k];
+        add_vector(v);
+    }
+
+    std::vector<double> eold(nroots, 0.0);
+    std::vector<std::vector<double> > ritz(nroots, std::vector<double>(ndet)), resid = ritz;
+    bool converged = false;
+    for (iters = 1; iters <= maxiter; iters++) {
+        size_t nsigma = S.size();
+        S.resize(V.size(), std::vector<double>(ndet));
+        sigma(V, S, nsigma);
+
+        int L = V.size();
+        auto G = std::make_shared<Matrix>("SCI subspace H", L, L);
+        for (int i = 0; i < L; i++)
+            for (int j = 0; j <= i; j++) {
+                double v = 0.5 * (C_DDOT(ndet, V[i].data(), 1, S[j].data(), 1) +
+                                  C_DDOT(ndet, V[j].data(), 1, S[i].data(), 1));
+                G->set(i, j, v);
+                G->set(j, i, v);
+            }
+        auto alpha = std::make_shared<Matrix>("SCI subspace vectors", L, L);
+        auto theta = std::make_shared<Vector>("SCI subspace values", L);
+        G->diagonalize(alpha, theta, ascending);
+
+        converged = true;
+        double rms = 0.0;
+        for (int k = 0; k < nroots; k++) {
+            std::fill(ritz[k].begin(), ritz[k].end(), 0.0);
+            std::fill(resid[k].begin(), resid[k].end(), 0.0);
+            for (int j = 0; j < L; j++) {
+                C_DAXPY(ndet, alpha->get(j, k), V[j].data(), 1, ritz[k].data(), 1);
+                C_DAXPY(ndet, alpha->get(j, k), S[j].data(), 1, resid[k].data(), 1);
+            }
+            evals_[k] = theta->get(k);
+            C_DAXPY(ndet, -evals_[k], ritz[k].data(), 1, resid[k].data(), 1);
+            double norm = std::sqrt(C_DDOT(ndet, resid[k].data(), 1, resid[k].data(), 1));
+            rms += norm * norm;
+            if (norm > conv_rms || std::fabs(evals_[k] - eold[k]) > conv_e) converged = false;
+            eold[k] = evals_[k];
+        }
+        residual_ = std::sqrt(rms / nroots);
+        for (int k = 0; k < nroots; k++) coeffs_[k] = ritz[k];
+        if (converged || iters == maxiter) break;
+
+        // Collapse onto the current Ritz vectors
+        if (V.size() + nroots > maxsub) {
+            std::vector<std::vector<double> > Snew(nroots, std::vector<double>(ndet, 0.0));
+            for (int k = 0; k < nroots; k++)
+                for (int j = 0; j < L; j++) C_DAXPY(ndet, alpha->get(j, k), S[j].data(), 1, Snew[k].data(), 1);
+            V = ritz;
+            S = std::move(Snew);
+        }
+
+        // Davidson corrections from the diagonal preconditioner
+        size_t nold = V.size();
+        for (int k = 0; k < nroots; k++) {
+            std::vector<double> d(ndet);
+            for (size_t i = 0; i < ndet; i++) {
+                double denom = evals_[k] - hdiag_[i];
+                if (std::fabs(denom) < 1.0e-4) denom = (denom < 0.0) ? -1.0e-4 : 1.0e-4;
+                d[i] = resid[k][i] / denom;
+            }
+            add_vector(d);
+        }
+        if (V.size() == nold) break;
+    }
+    return converged;
+}
+
+int SelectedCI::compute(int nroots, double conv_e, double conv_rms, int maxiter, double eshift) {
+    if (nroots != nroots_) coeffs_.clear();
+    nroots_ = nroots;
+
+    if (print_) {
+        outfile->Printf("   Heat-bath selected CI, epsilon = %.3E\n\n", epsilon_);
+        outfile->Printf("     Iter        Dets       Added   Root       Total Energy   Davidson\n\n");
+    }
+
+    int iters;
+    build_hamiltonian();
+    bool conv = davidson(conv_e, conv_rms, maxiter, iters);
+    auto print_iter = [&](int iter, size_t nadd) {
+        if (!print_) return;
+        for (int k = 0; k < nroots; k++) {
+            outfile->Printf("   @SCI %2d:  %10zu  %10zu     %2d  %18.12lf   %4d\n", iter, dets_.size(), nadd, k,
+                            evals_[k] + eshift, iters);
+        }
+    };
+    print_iter(0, 0);
+
+    int nselect;
+    bool saturated = false;
+    for (nselect = 1; nselect <= max_select_; nselect++) {
+        size_t nadd = select();
+        if (!nadd) {
+            saturated = true;
+            break;
+        }
+        build_hamiltonian();
+        size_t nnz = 0;
+        for (const auto &row : hrows_) nnz += row.size();
+        check_memory(dets_.size(), nnz);
+        conv = davidson(conv_e, conv_rms, maxiter, iters);
+        print_iter(nselect, nadd);
+    }
+    if (print_) outfile->Printf("\n");
+
+    if ((int)dets_.size() < nroots_) {
+        throw PSIEXCEPTION("SelectedCI: the selected space holds fewer determinants than roots.");
+    }
+    converged_ = conv && saturated;
+    return std::min(nselect, max_select_);
+}
+
+void SelectedCI::opdm(int root, double *opdm_a, double *opdm_b) const {
+    const int n = nact_;
+    const size_t ndet = dets_.size();
+    const std::vector<double> &C = coeffs_[root];
+    std::fill(opdm_a, opdm_a + n * n, 0.0);
+    std::fill(opdm_b, opdm_b + n * n, 0.0);
+
+    std::vector<std::vector<double> > acc(max_threads(), std::vector<double>(2 * n * n, 0.0));
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < ndet; i++) {
+        double *a = acc[thread_id()].data();
+        double *b = a + n * n;
+        const SCIDet &I = dets_[i];
+        double w = C[i] * C[i];
+        for (uint64_t x = I.a; x; x &= x - 1) a[lowest(x) * (n + 1)] += w;
+        for (uint64_t x = I.b; x; x &= x - 1) b[lowest(x) * (n + 1)] += w;
+
+        for (const auto &e : hrows_[i]) {
+            const SCIDet &J = dets_[e.first];
+            uint64_t xa = I.a ^ J.a;
+            uint64_t xb = I.b ^ J.b;
+            if (npop(xa) + npop(xb) != 2) continue;
+            double v = C[i] * C[e.first];
+            if (xa) {
+                int p = lowest(I.a & xa), r = lowest(J.a & xa);
+                a[r * n + p] += single_sign(I.a, p, r) * v;
+            } else {
+                int p = lowest(I.b & xb), r = lowest(J.b & xb);
+                b[r * n + p] += single_sign(I.b, p, r) * v;
+            }
+        }
+    }
+    for (const auto &t : acc) {
+        for (int pq = 0; pq < n * n; pq++) {
+            opdm_a[pq] += t[pq];
+            opdm_b[pq] += t[n * n + pq];
+        }
+    }
+}
+
+void SelectedCI::tpdm(const std::vector<std::pair<int, double> > &states, double *tpdm_aa, double *tpdm_ab,
+                      double *tpdm_bb) const {
+    const size_t n = nact_;
+    const size_t n4 = n * n * n * n;
+    const size_t ndet = dets_.size();
+    std::fill(tpdm_aa, tpdm_aa + n4, 0.0);
+    std::fill(tpdm_ab, tpdm_ab + n4, 0.0);
+    std::fill(tpdm_bb, tpdm_bb + n4, 0.0);
+
+    auto idx = [n](size_t p, size_t q, size_t r, size_t s) { return ((p * n + q) * n + r) * n + s; };
+    auto weight = [&](size_t i, size_t j) {
+        double v = 0.0;
+        for (const auto &st : states) v += st.second * coeffs_[st.first][i] * coeffs_[st.first][j];
+        return v;
+    };
+
+    // Same-spin part of a single excitation p -> r with spectators in same, and its alpha-beta part
+    auto single_terms = [&](double *same_pdm, uint64_t same, uint64_t other, bool beta, int p, int r, double x) {
+        for (uint64_t y = same & ~obit(p); y; y &= y - 1) {
+            size_t k = lowest(y);
+#pragma omp atomic
+            same_pdm[idx(r, p, k, k)] += x;
+#pragma omp atomic
+            same_pdm[idx(k, k, r, p)] += x;
+#pragma omp atomic
+            same_pdm[idx(r, k, k, p)] -= x;
+#pragma omp atomic
+            same_pdm[idx(k, p, r, k)] -= x;
+        }
+        for (uint64_t y = other; y; y &= y - 1) {
+            size_t k = lowest(y);
+            size_t ab = beta ? idx(r, p, k, k) : idx(k, k, r, p);
+#pragma omp atomic
+            tpdm_ab[ab] += x;
+        }
+    };
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < ndet; i++) {
+        const SCIDet &I = dets_[i];
+
+        double w = weight(i, i);
+        for (int spin = 0; spin < 2; spin++) {
+            uint64_t same = spin ? I.b : I.a;
+            double *pdm = spin ? tpdm_bb : tpdm_aa;
+            for (uint64_t x = same; x; x &= x - 1) {
+                size_t p = lowest(x);
+                for (uint64_t y = same & ~obit(p); y; y &= y - 1) {
+                    size_t q = lowest(y);
+#pragma omp atomic
+                    pdm[idx(p, p, q, q)] += w;
+#pragma omp atomic
+                    pdm[idx(p, q, q, p)] -= w;
+                }
+            }
+        }
+        for (uint64_t x = I.b; x; x &= x - 1) {
+            size_t p = lowest(x);
+            for (uint64_t y = I.a; y; y &= y - 1) {
+                size_t r = lowest(y);
+#pragma omp atomic
+                tpdm_ab[idx(p, p, r, r)] += w;
+            }
+        }
+
+        for (const auto &e : hrows_[i]) {
+            const SCIDet &J = dets_[e.first];
+            uint64_t xa = I.a ^ J.a;
+            uint64_t xb = I.b ^ J.b;
+            int da = npop(xa) / 2;
+            int db = npop(xb) / 2;
+            double v = weight(i, e.first);
+
+            if (da + db == 1) {
+                bool beta = (db == 1);
+                uint64_t same = beta ? I.b : I.a;
+                uint64_t x = beta ? xb : xa;
+                int p = lowest(same & x);
+                int r = lowest((beta ? J.b : J.a) & x);
+                single_terms(beta ? tpdm_bb : tpdm_aa, same, beta ? I.a : I.b, beta, p, r,
+                             single_sign(same, p, r) * v);
+            } else if (da == 1 && db == 1) {
+                size_t p = lowest(I.a & xa), r = lowest(J.a & xa);
+                size_t q = lowest(I.b & xb), s = lowest(J.b & xb);
+#pragma omp atomic
+                tpdm_ab[idx(s, q, r, p)] += single_sign(I.a, p, r) * single_sign(I.b, q, s) * v;
+            } else {
+                uint64_t same = (da == 2) ? I.a : I.b;
+                uint64_t holes = same & (xa | xb);
+                uint64_t parts = ((da == 2) ? J.a : J.b) & (xa | xb);
+                size_t p = lowest(holes), q = lowest(holes & (holes - 1));
+                size_t r = lowest(parts), s = lowest(parts & (parts - 1));
+                double x = double_sign(same, p, q, r, s) * v;
+                double *pdm = (da == 2) ? tpdm_aa : tpdm_bb;
+#pragma omp atomic
+                pdm[idx(r, p, s, q)] += x;
+#pragma omp atomic
+                pdm[idx(s, q, r, p)] += x;
+#pragma omp atomic
+                pdm[idx(r, q, s, p)] -= x;
+#pragma omp atomic
+                pdm[idx(s, p, r, q)] -= x;
+            }
+        }
+    }
+}
+
+/*
+** sci_init(): Set up the selected-CI engine in place of the RAS strings. The space starts from
+**   the aufbau determinant of the DOCC/SOCC occupations within the active orbitals.
+*/
+void CIWavefunction::sci_init() {
+    int nact = CalcInfo_->num_ci_orbs;
+    if (nact > 64) {
+        throw PSIEXCEPTION("CIWavefunction: DIAG_METHOD HCI supports at most 64 active orbitals.");
+    }
+
+    std::vector<int> orbsym(nact, 0);
+    SCIDet ref{0, 0};
+    int sym = 0;
+    for (int h = 0, offset = 0; h < nirrep_; h++) {
+        int nbet = CalcInfo_->docc[h] - CalcInfo_->dropped_docc[h];
+        int nalp = nbet + CalcInfo_->socc[h];
+        for (int i = 0; i < CalcInfo_->ci_orbs[h]; i++) {
+            int p = CalcInfo_->act_reorder[offset + i];
+            orbsym[p] = h;
+            if (i < nalp) ref.a |= obit(p);
+            if (i < nbet) ref.b |= obit(p);
+            if ((i < nalp) != (i < nbet)) sym ^= h;
+        }
+        offset += CalcInfo_->ci_orbs[h];
+    }
+
+    if (Parameters_->ref_sym == -1) {
+        CalcInfo_->ref_sym = sym;
+    } else if (Parameters_->ref_sym != sym) {
+        throw PSIEXCEPTION("CIWavefunction: DIAG_METHOD HCI starts from the reference determinant, "
+                           "REFERENCE_SYM must be its irrep.");
+    } else {
+        CalcInfo_->ref_sym = sym;
+    }
+
+    bool ms0 = Parameters_->Ms0 && (CalcInfo_->num_alp_expl == CalcInfo_->num_bet_expl);
+    sci_ = std::make_shared<SelectedCI>(nact, CalcInfo_->num_alp_expl, CalcInfo_->num_bet_expl, orbsym, ref, ms0,
+                                        Parameters_->hci_epsilon, Parameters_->hci_maxiter, print_);
+    sci_->set_memory(Process::environment.get_memory());
+
+    outfile->Printf("    Active orbitals    = %6d\n", nact);
+    outfile->Printf("    Alpha electrons    = %6d\n", CalcInfo_->num_alp_expl);
+    outfile->Printf("    Beta electrons     = %6d\n", CalcInfo_->num_bet_expl);
+    outfile->Printf("    HCI epsilon        = %6.2E\n", Parameters_->hci_epsilon);
+}
+
+/*
+** sci_diag(): diag_h() for DIAG_METHOD HCI. Fills evals with the electronic energies of the
+**   roots over the current integrals.
+*/
+void CIWavefunction::sci_diag(double *evals, double conv_e, double conv_rms) {
+    sci_->set_integrals(CalcInfo_->onel_ints->pointer(), CalcInfo_->twoel_ints->pointer());
+
+    int nroots = Parameters_->num_roots;
+    int iters = sci_->compute(nroots, conv_e, conv_rms, Parameters_->maxiter, CalcInfo_->edrc + CalcInfo_->enuc);
+    for (int k = 0; k < nroots; k++) evals[k] = sci_->energy(k);
+
+    Parameters_->diag_h_converged = sci_->converged();
+    Parameters_->diag_iters_taken = iters;
+    set_scalar_variable("DETCI AVG DVEC NORM", sci_->residual());
+
+    if (print_) {
+        outfile->Printf("   Selected space holds %zu determinants.\n\n", sci_->ndet());
+        for (int k = 0; k < nroots; k++) {
+            outfile->Printf("    * ROOT %2d CI total energy = %17.13lf\n", k + 1,
+                            evals[k] + CalcInfo_->edrc + CalcInfo_->enuc);
+        }
+        outfile->Printf("\n");
+    }
+}
+
+/*
+** sci_opdm(): OPDMs of every root from the selected-CI vectors, in the layout of opdm()
+*/
+std::vector<std::vector<SharedMatrix> > CIWavefunction::sci_opdm() {
+    if (Parameters_->transdens) {
+        throw PSIEXCEPTION("CIWavefunction: transition densities are not available with DIAG_METHOD HCI.");
+    }
+
+    int nact = CalcInfo_->num_ci_orbs;
+    Dimension act_dim = get_dimension("ACT");
+    std::vector<double> scratch_a(nact * nact), scratch_b(nact * nact);
+
+    std::vector<std::vector<SharedMatrix> > opdm_list;
+    for (int root = 0; root < Parameters_->num_roots; root++) {
+        sci_->opdm(root, scratch_a.data(), scratch_b.data());
+
+        std::stringstream opdm_name;
+        opdm_name << "MO-basis Alpha OPDM <" << root << "| Etu |" << root << ">";
+        auto new_OPDM_a = std::make_shared<Matrix>(opdm_name.str(), nirrep_, act_dim, act_dim);
+        opdm_name.str(std::string());
+        opdm_name << "MO-basis Beta OPDM <" << root << "| Etu |" << root << ">";
+        auto new_OPDM_b = std::make_shared<Matrix>(opdm_name.str(), nirrep_, act_dim, act_dim);
+        opdm_name.str(std::string());
+        opdm_name << "MO-basis OPDM <" << root << "| Etu |" << root << ">";
+        auto new_OPDM = std::make_shared<Matrix>(opdm_name.str(), nirrep_, act_dim, act_dim);
+
+        for (int h = 0, offset = 0; h < nirrep_; h++) {
+            for (int i = 0; i < CalcInfo_->ci_orbs[h]; i++) {
+                int ni = CalcInfo_->act_reorder[i + offset];
+                for (int j = 0; j < CalcInfo_->ci_orbs[h]; j++) {
+                    int nj = CalcInfo_->act_reorder[j + offset];
+                    double a = scratch_a[ni * nact + nj];
+                    double b = scratch_b[ni * nact + nj];
+                    new_OPDM_a->set(h, i, j, a);
+                    new_OPDM_b->set(h, i, j, b);
+                    new_OPDM->set(h, i, j, a + b);
+                }
+            }
+            offset += CalcInfo_->ci_orbs[h];
+        }
+        opdm_list.push_back({new_OPDM_a, new_OPDM_b, new_OPDM});
+    }
+    return opdm_list;
+}
+
+/*
+** sci_tpdm(): State-averaged TPDM from the selected-CI vectors, in the layout of tpdm()
+*/
+std::vector<SharedMatrix> CIWavefunction::sci_tpdm(std::vector<std::tuple<int, int, double> > states_vec) {
+    int nact = CalcInfo_->num_ci_orbs;
+    int nact2 = nact * nact;
+
+    std::vector<std::pair<int, double> > states;
+    for (const auto &st : states_vec) states.emplace_back(std::get<0>(st), std::get<2>(st));
+
+    size_t n4 = (size_t)nact2 * nact2;
+    std::vector<double> aa(n4), ab(n4), bb(n4);
+    sci_->tpdm(states, aa.data(), ab.data(), bb.data());
+
+    auto tpdm_aam = std::make_shared<Matrix>("MO-basis TPDM AA", nact2, nact2);
+    auto tpdm_abm = std::make_shared<Matrix>("MO-basis TPDM AB", nact2, nact2);
+    auto tpdm_bbm = std::make_shared<Matrix>("MO-basis TPDM BB", nact2, nact2);
+    double **tpdm_aamp = tpdm_aam->pointer();
+    double **tpdm_abmp = tpdm_abm->pointer();
+    double **tpdm_bbmp = tpdm_bbm->pointer();
+
+    // Reorder from CI order to Pitzer order
+    for (int p = 0; p < nact; p++) {
+        for (int q = 0; q < nact; q++) {
+            int r_pq = CalcInfo_->act_order[p] * nact + CalcInfo_->act_order[q];
+            size_t pq = p * nact + q;
+            for (int r = 0; r < nact; r++) {
+                for (int s = 0; s < nact; s++) {
+                    int r_rs = CalcInfo_->act_order[r] * nact + CalcInfo_->act_order[s];
+                    size_t pqrs = pq * nact2 + r * nact + s;
+                    tpdm_aamp[r_pq][r_rs] = aa[pqrs];
+                    tpdm_abmp[r_pq][r_rs] = ab[pqrs];
+                    tpdm_bbmp[r_pq][r_rs] = bb[pqrs];
+                }
+            }
+        }
+    }
+
+    auto tpdm = std::make_shared<Matrix>("MO-basis TPDM", nact2, nact2);
+    double **tpdmp = tpdm->pointer();
+    for (int pq = 0; pq < nact2; pq++) {
+        for (int rs = 0; rs < nact2; rs++) {
+            tpdmp[pq][rs] = 0.5 * (tpdm_aamp[pq][rs] + tpdm_bbmp[pq][rs] + tpdm_abmp[pq][rs] + tpdm_abmp[rs][pq]);
+        }
+    }
+
+    std::vector<int> nshape{nact, nact, nact, nact};
+    tpdm_aam->set_numpy_shape(nshape);
+    tpdm_abm->set_numpy_shape(nshape);
+    tpdm_bbm->set_numpy_shape(nshape);
+    tpdm->set_numpy_shape(nshape);
+
+    return {tpdm_aam, tpdm_abm, tpdm_bbm, tpdm};
+}
+
+}  // namespace detci
+}  // namespace psi
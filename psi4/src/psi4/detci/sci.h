@@ -0,0 +1,164 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DETCI
+    \brief Heat-bath selected CI in the active space
+*/
+
+#ifndef _psi_src_bin_detci_sci_h
+#define _psi_src_bin_detci_sci_h
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace psi {
+namespace detci {
+
+/*
+** SCIDet: a determinant as alpha and beta occupation bitstrings over the
+**   active orbitals in CI order (bit p set = orbital p occupied)
+*/
+struct SCIDet {
+    uint64_t a;
+    uint64_t b;
+    bool operator==(const SCIDet &other) const { return a == other.a && b == other.b; }
+};
+
+struct SCIDetHash {
+    size_t operator()(const SCIDet &d) const {
+        uint64_t h = d.a * 0x9E3779B97F4A7C15ULL;
+        h ^= d.b + 0x7F4A7C159E3779B9ULL + (h << 6) + (h >> 2);
+        return (size_t)(h ^ (h >> 29));
+    }
+};
+
+/*
+** SelectedCI: heat-bath configuration interaction (Holmes, Tubman, and
+**   Umrigar, JCTC 12, 3674 (2016)) over the active orbitals.
+**
+** Starting from the reference determinant, the space grows by every single
+** and double excitation |D_a> of a determinant |D_i> in the space with
+** |H_ai c_i| > epsilon for some root. Doubles are found from integral lists
+** sorted by magnitude, so the search over a pair of occupied orbitals stops
+** at the first integral below epsilon / |c_i|. Determinants live in a hash
+** table; the Hamiltonian over the space is kept as sparse rows built from the
+** alpha- and beta-string groupings of the space and diagonalized with
+** Davidson-Liu. Everything runs over the determinants with OpenMP.
+**
+** Integrals come in the packed CI-order form of CalcInfo::onel_ints and
+** CalcInfo::twoel_ints; at most 64 active orbitals are supported.
+*/
+class SelectedCI {
+   public:
+    SelectedCI(int nact, int nalpha, int nbeta, const std::vector<int> &orbsym, const SCIDet &ref, bool ms0,
+               double epsilon, int max_select, int print);
+
+    /// Bytes the space, the Hamiltonian rows, and the Davidson vectors may take (0: no limit)
+    void set_memory(size_t bytes) { memory_ = bytes; }
+
+    /// Takes the one-electron (h_pq, lower triangle) and two-electron ((pq|rs), ioff[pq] + rs) integrals
+    void set_integrals(const double *onel, const double *twoel);
+
+    /// Grows the space until no determinant passes the selection, returns the number of selection steps.
+    /// eshift is only added to the printed energies.
+    int compute(int nroots, double conv_e, double conv_rms, int maxiter, double eshift);
+
+    size_t ndet() const { return dets_.size(); }
+    bool converged() const { return converged_; }
+    double energy(int root) const { return evals_[root]; }
+    /// RMS over the roots of the final Davidson residual norms
+    double residual() const { return residual_; }
+
+    /// Alpha and beta OPDM of a root, <a^+_p a_q>, nact x nact in CI order
+    void opdm(int root, double *opdm_a, double *opdm_b) const;
+
+    /// Weighted (root, weight) sum of the spin blocks of the TPDM, nact^4 in CI order, laid out as
+    /// the detci TPDM: aa[pq][rs] = <a^+_p a^+_r a_s a_q> (alpha), ab[pq][rs] = <E^beta_pq E^alpha_rs>
+    void tpdm(const std::vector<std::pair<int, double> > &states, double *tpdm_aa, double *tpdm_ab,
+              double *tpdm_bb) const;
+
+   private:
+    struct HBEntry {
+        double value;
+        int r;
+        int s;
+    };
+
+    int nact_;
+    int nalpha_;
+    int nbeta_;
+    std::vector<int> orbsym_;
+    bool ms0_;
+    double epsilon_;
+    int max_select_;
+    int print_;
+    size_t memory_;
+
+    // Dense integrals in CI order
+    std::vector<double> h_;
+    std::vector<double> eri_;
+    // Heat-bath double lists, sorted by decreasing |value|; same spin over p < q, opposite spin over (p, q)
+    std::vector<std::vector<HBEntry> > hb_same_;
+    std::vector<std::vector<HBEntry> > hb_opp_;
+
+    // The space, the hashed store, and the sparse Hamiltonian over it (off-diagonal, both triangles)
+    std::vector<SCIDet> dets_;
+    std::unordered_map<SCIDet, size_t, SCIDetHash> index_;
+    std::vector<double> hdiag_;
+    std::vector<std::vector<std::pair<size_t, double> > > hrows_;
+
+    // Coefficients, nroots x ndet
+    int nroots_;
+    std::vector<std::vector<double> > coeffs_;
+    std::vector<double> evals_;
+    double residual_;
+    bool converged_;
+
+    double eri(int p, int q, int r, int s) const {
+        return eri_[(((size_t)p * nact_ + q) * nact_ + r) * nact_ + s];
+    }
+    double diagonal(const SCIDet &D) const;
+    double single(uint64_t same, uint64_t other, int p, int r) const;
+    double matrix_element(const SCIDet &I, const SCIDet &J) const;
+
+    bool add_det(const SCIDet &D);
+    size_t memory_needed(size_t ndet, size_t nnz) const;
+    void check_memory(size_t ndet, size_t nnz) const;
+    size_t select();
+    void build_hamiltonian();
+    void sigma(const std::vector<std::vector<double> > &C, std::vector<std::vector<double> > &S, size_t first) const;
+    bool davidson(double conv_e, double conv_rms, int maxiter, int &iters);
+};
+
+}  // namespace detci
+}  // namespace psi
+
+#endif  // _psi_src_bin_detci_sci_h
@@ -51,16 +51,44 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/physconst.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/memory_manager.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
+#include <vector>
 
 namespace psi {
 namespace detci {
 
 #define MALPHA_TOLERANCE 1E-15
 
+namespace {
+
+/*
+** The CI vectors whose files sem_iter() keeps in core.  Their buffers are
+** dropped on every way out of sem_iter(), so that an exception cannot
+** leave them behind for the next calculation on the same units; on the
+** normal path close_io_files() has already written and dropped them.
+*/
+class CoreVectors {
+   public:
+    bool keep(CIvect &vec) {
+        if (!vec.keep_in_core()) return false;
+        vecs_.push_back(&vec);
+        return true;
+    }
+    ~CoreVectors() {
+        for (CIvect *vec : vecs_) vec->drop_core();
+    }
+
+   private:
+    std::vector<CIvect *> vecs_;
+};
+
+}  // namespace
+
 void CIWavefunction::sem_iter(CIvect &Hd, struct stringwr **alplist, struct stringwr **betlist, double *evals,
                               double conv_e, double conv_rms, double enuc, double edrc, int nroots, int maxiter,
                               int maxnvect) {
@@ -136,6 +164,38 @@ void CIWavefunction::sem_iter(CIvect &Hd, struct stringwr **alplist, struct stri
     if (Sigma.read_num_vecs() == -1) Sigma.write_num_vecs(0);
     if (Dvec.read_num_vecs() == -1) Dvec.write_num_vecs(0);
 
+    /* keep the C, sigma, and D files in core as far as half the free
+       memory allows.  What detci holds already (the two-electron
+       integrals, the I/O buffers of Hd, C, sigma, and D, and the sigma
+       scratch of each thread) is registered with the broker first, so
+       that it is not counted as free.  The other half of the free memory
+       is left for the batched sigma vectors (sigma_multi()).  C and sigma
+       are read for every subspace vector in each iteration, D about once,
+       so D comes last.
+       The grants are given back, and the in-core buffers dropped, on any
+       way out of here. */
+    size_t cs_bytes = Cvec.file_bytes() + Sigma.file_bytes();
+    size_t d_bytes = Parameters_->nodfile ? 0 : Dvec.file_bytes();
+    size_t held = (CalcInfo_->twoel_ints->dim() + 4 * Cvec.buffer_size_ +
+                   (size_t)std::max(Parameters_->nthreads, 1) * Cvec.get_max_blk_size()) *
+                  sizeof(double);
+    MemoryBroker &broker = MemoryBroker::shared_object();
+    MemoryGrant held_grant("DETCI working set");
+    MemoryGrant vecs_grant("DETCI CI vectors");
+    broker.request(held_grant.name(), std::min(held, broker.available()), {});
+    broker.allocate();
+    broker.request(vecs_grant.name(), 0, {{cs_bytes, 1.0}, {cs_bytes + d_bytes, 1.25}});
+    size_t vecs_granted = broker.allocate(broker.available() / 2)[vecs_grant.name()];
+    CoreVectors core_vecs;
+    bool cs_in_core = vecs_granted >= cs_bytes && core_vecs.keep(Cvec) && core_vecs.keep(Sigma);
+    bool d_in_core = cs_in_core && d_bytes && vecs_granted >= cs_bytes + d_bytes && core_vecs.keep(Dvec);
+    if (print_) {
+        outfile->Printf("\n   CI vector files kept in memory: %s (%.1f MiB)\n",
+                        !cs_in_core ? "none" : (d_in_core ? "C, sigma, D" : "C, sigma"),
+                        (cs_in_core ? cs_bytes + (d_in_core ? d_bytes : 0) : 0) / (1024.0 * 1024.0));
+    }
+    std::vector<double> Gdots(maxnvect);
+
     /* allocate memory */
     Dvec.h0block_buf_init();
     buffer1 = *(Hd.blockptr(0));
@@ -523,6 +583,9 @@ void CIWavefunction::sem_iter(CIvect &Hd, struct stringwr **alplist, struct stri
         Cvec.buf_lock(buffer1);
         Sigma.buf_lock(buffer2);
 
+        /* the new vectors of a multi-root iteration go through sigma together */
+        bool batched = sigma_multi(Cvec, Sigma, oei, tei, Llast, L - Llast);
+
         for (i = Llast; i < L; i++) {
             Cvec.read(i, 0);
             if (print_ > 3) {
@@ -530,7 +593,10 @@ void CIWavefunction::sem_iter(CIvect &Hd, struct stringwr **alplist, struct stri
                 Cvec.print();
             }
 
-            sigma(Cvec, Sigma, oei, tei, i);
+            if (batched)
+                Sigma.read(i, 0);
+            else
+                sigma(Cvec, Sigma, oei, tei, i);
 
             if (Parameters_->z_scale_H) {
                 Cvec.buf_unlock();
@@ -546,10 +612,8 @@ void CIWavefunction::sem_iter(CIvect &Hd, struct stringwr **alplist, struct stri
                 Sigma.print();
             }
 
-            for (j = 0; j < L; j++) {
-                Cvec.read(j, 0);
-                G[j][i] = G[i][j] = Cvec * Sigma;
-            }
+            Cvec.vdots(Sigma, 0, L, Gdots.data());
+            for (j = 0; j < L; j++) G[j][i] = G[i][j] = Gdots[j];
         }
         Sigma.write_num_vecs(L);
         Llast = L;
@@ -898,10 +962,8 @@ void CIWavefunction::sem_iter(CIvect &Hd, struct stringwr **alplist, struct stri
             /* Reforming G matrix after collapse */
             for (i = 0; i < L; i++) {
                 Cvec.read(i, 0);
-                for (j = 0; j <= i; j++) {
-                    Sigma.read(j, 0);
-                    G[j][i] = G[i][j] = Cvec * Sigma;
-                }
+                Sigma.vdots(Cvec, 0, i + 1, Gdots.data());
+                for (j = 0; j <= i; j++) G[j][i] = G[i][j] = Gdots[j];
             }
 
             /* solve the L x L eigenvalue problem G a = lambda a for M roots */
@@ -45,9 +45,15 @@
 #include <cstdlib>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/vector.h"
+#include "psi4/libpsi4util/memory_manager.h"
 #include "psi4/detci/structs.h"
 #include "psi4/detci/civect.h"
 #include "psi4/detci/ciwave.h"
@@ -87,10 +93,12 @@ extern void s2_block_vras_rotf(int *Cnt[2], int **Ij[2], int **Oij[2], int **Rid
                                unsigned char ***Occs);
 extern void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist, double **C, double **S, double *tei,
                            int nas, int nbs, int cnas, int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym,
-                           double **Cprime, double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym);
+                           double **Cprime, double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym,
+                           int nroot);
 extern void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C, double **S, double *tei, int nas,
                        int nbs, int cnas, int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym,
-                       double **Cprime, double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym);
+                       double **Cprime, double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym,
+                       int nroot);
 extern void s3_block_vrotf(int *Cnt[2], int **Ij[2], int **Ridx[2], signed char **Sn[2], double **C, double **S,
                            double *tei, int nas, int nbs, int cnas, int Ib_list, int Ja_list, int Jb_list, int Ib_sym,
                            int Jb_sym, double **Cprime, double *F, double *V, double *Sgn, int *L, int *R, int norbs,
@@ -222,6 +230,31 @@ void CIWavefunction::sigma_init(CIvect &C, CIvect &S) {
         }
     }
 
+    /*
+    ** scratch for sharing out the sigma blocks of an in-core vector among
+    ** threads (sigma_b), as long as the copies of cprime together stay
+    ** below the size of one CI vector
+    */
+    SigmaData_->nthreads = 0;
+    SigmaData_->thread = nullptr;
+    int nthreads = Parameters_->nthreads;
+    if (C.icore_ == 1 && nthreads > 1 && S.num_blocks_ > 1 && !Parameters_->repl_otf && !Parameters_->bendazzoli &&
+        print_ <= 3 && (size_t)nthreads * bufsz <= C.vectlen_) {
+        SigmaData_->nthreads = nthreads;
+        SigmaData_->thread = new sigma_data[nthreads]();
+        for (i = 0; i < nthreads; i++) {
+            struct sigma_data *SD = &SigmaData_->thread[i];
+            SD->max_dim = SigmaData_->max_dim;
+            SD->F = init_array(SD->max_dim);
+            SD->Sgn = init_array(SD->max_dim);
+            SD->V = init_array(SD->max_dim);
+            SD->L = init_int_array(SD->max_dim);
+            SD->R = init_int_array(SD->max_dim);
+            SD->cprime = (double **)malloc(maxrows * sizeof(double *));
+            SD->cprime[0] = init_array(bufsz);
+        }
+    }
+
     CalcInfo_->sigma_initialized = 1;
 }
 
@@ -243,6 +276,19 @@ void CIWavefunction::sigma_free() {
             free(SigmaData_->Jsgn[i]);
         }
     }
+    for (int t = 0; t < SigmaData_->nthreads; t++) {
+        struct sigma_data *SD = &SigmaData_->thread[t];
+        free(SD->F);
+        free(SD->Sgn);
+        free(SD->V);
+        free(SD->L);
+        free(SD->R);
+        free(SD->cprime[0]);
+        free(SD->cprime);
+    }
+    delete[] SigmaData_->thread;
+    SigmaData_->thread = nullptr;
+    SigmaData_->nthreads = 0;
     CalcInfo_->sigma_initialized = false;
     // DGAS: Not sure how to free these yet
     //      SigmaData_->Toccs = (unsigned char **) malloc (sizeof(unsigned char *) * nsingles);
@@ -367,7 +413,7 @@ void CIWavefunction::sigma_a(struct stringwr **alplist, struct stringwr **betlis
                 if (SigmaData_->cprime != nullptr) set_row_ptrs(cnas, cnbs, SigmaData_->cprime);
                 sigma_block(alplist, betlist, C.blocks_[cblock], S.blocks_[sblock], oei, tei, fci, cblock, sblock, nas,
                             nbs, sac, sbc, cac, cbc, cnas, cnbs, C.num_alpcodes_, C.num_betcodes_, sbirr, cbirr,
-                            S.Ms0_);
+                            S.Ms0_, SigmaData_);
                 did_sblock = 1;
             }
 
@@ -383,7 +429,7 @@ void CIWavefunction::sigma_a(struct stringwr **alplist, struct stringwr **betlis
                 if (SigmaData_->cprime != nullptr) set_row_ptrs(cnbs, cnas, SigmaData_->cprime);
                 sigma_block(alplist, betlist, C.blocks_[cblock2], S.blocks_[sblock], oei, tei, fci, cblock2, sblock,
                             nas, nbs, sac, sbc, cbc, cac, cnbs, cnas, C.num_alpcodes_, C.num_betcodes_, sbirr, cairr,
-                            S.Ms0_);
+                            S.Ms0_, SigmaData_);
                 did_sblock = 1;
             }
 
@@ -429,11 +475,7 @@ void CIWavefunction::sigma_a(struct stringwr **alplist, struct stringwr **betlis
 */
 void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlist, CIvect &C, CIvect &S, double *oei,
                              double *tei, int fci, int ivec) {
-    int sblock, cblock; /* id of sigma and C blocks */
-    int sac, sbc, nas, nbs;
-    int cac, cbc, cnas, cnbs;
-    int sbirr, cbirr;
-    int did_sblock = 0;
+    int nthreads = SigmaData_->nthreads;
     int phase;
 
     if (!Parameters_->Ms0)
@@ -444,31 +486,43 @@ void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlis
     S.zero();
     C.read(C.cur_vect_, 0);
 
-    /* loop over unique sigma subblocks */
-    for (sblock = 0; sblock < S.num_blocks_; sblock++) {
+    /*
+    ** loop over unique sigma subblocks
+    **
+    ** With SigmaData_->nthreads set, the sigma blocks are shared out among
+    ** the threads.  C is only read and each sigma block (including its
+    ** H0block entries) is written by the one thread that owns it, so no
+    ** locking is needed; each thread has its own F, V, ..., cprime.
+    */
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) if (nthreads > 1)
+    for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
         // if (Parameters_->cc && !cc_reqd_sblocks[sblock]) continue;
-        did_sblock = 0;
-        sac = S.Ia_code_[sblock];
-        sbc = S.Ib_code_[sblock];
-        nas = S.Ia_size_[sblock];
-        nbs = S.Ib_size_[sblock];
+        struct sigma_data *SD = SigmaData_;
+#ifdef _OPENMP
+        if (nthreads > 1) SD = &SigmaData_->thread[omp_get_thread_num()];
+#endif
+        int did_sblock = 0;
+        int sac = S.Ia_code_[sblock];
+        int sbc = S.Ib_code_[sblock];
+        int nas = S.Ia_size_[sblock];
+        int nbs = S.Ib_size_[sblock];
         if (nas == 0 || nbs == 0) continue;
         if (S.Ms0_ && sbc > sac) continue;
-        sbirr = sbc / BetaG_->subgr_per_irrep;
-        if (SigmaData_->sprime != nullptr) set_row_ptrs(nas, nbs, SigmaData_->sprime);
+        int sbirr = sbc / BetaG_->subgr_per_irrep;
+        if (SD->sprime != nullptr) set_row_ptrs(nas, nbs, SD->sprime);
 
-        for (cblock = 0; cblock < C.num_blocks_; cblock++) {
+        for (int cblock = 0; cblock < C.num_blocks_; cblock++) {
             if (C.check_zero_block(cblock)) continue;
-            cac = C.Ia_code_[cblock];
-            cbc = C.Ib_code_[cblock];
-            cnas = C.Ia_size_[cblock];
-            cnbs = C.Ib_size_[cblock];
-            cbirr = cbc / BetaG_->subgr_per_irrep;
+            int cac = C.Ia_code_[cblock];
+            int cbc = C.Ib_code_[cblock];
+            int cnas = C.Ia_size_[cblock];
+            int cnbs = C.Ib_size_[cblock];
+            int cbirr = cbc / BetaG_->subgr_per_irrep;
             if (s1_contrib_[sblock][cblock] || s2_contrib_[sblock][cblock] || s3_contrib_[sblock][cblock]) {
-                if (SigmaData_->cprime != nullptr) set_row_ptrs(cnas, cnbs, SigmaData_->cprime);
+                if (SD->cprime != nullptr) set_row_ptrs(cnas, cnbs, SD->cprime);
                 sigma_block(alplist, betlist, C.blocks_[cblock], S.blocks_[sblock], oei, tei, fci, cblock, sblock, nas,
                             nbs, sac, sbc, cac, cbc, cnas, cnbs, C.num_alpcodes_, C.num_betcodes_, sbirr, cbirr,
-                            S.Ms0_);
+                            S.Ms0_, SD);
                 did_sblock = 1;
             }
         } /* end loop over c blocks */
@@ -489,6 +543,201 @@ void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlis
     S.write(ivec, 0);
 }
 
+/*
+** sigma_multi(): Sigma vectors first...first+nvec-1 for the C vectors with
+**    the same numbers, computed together.  The C and sigma blocks of all
+**    the vectors of a batch are kept side by side, so each pass over the
+**    string replacement lists (and each s3 gather and axpy) serves every
+**    vector of the batch instead of one.  This is where the Davidson
+**    iterations of a multi-root (e.g. state-averaged CASSCF) calculation
+**    spend most of their time.
+**
+**    Only the in-core case (icore=1) without on-the-fly replacements,
+**    Bendazzoli s3, or Z-scaling is done this way; otherwise, and when the
+**    MemoryBroker cannot grant scratch for two vectors out of the memory
+**    that is still free (sem_iter() leaves half of it for this), nothing
+**    is computed and false is returned, and the caller should use sigma()
+**    one vector at a time.  C and S must already be locked to buffers.
+**
+** Returns: true if the nvec sigma vectors have been written
+*/
+bool CIWavefunction::sigma_multi(CIvect &C, CIvect &S, double *oei, double *tei, int first, int nvec) {
+    if (nvec < 2 || C.icore_ != 1 || Parameters_->repl_otf || Parameters_->bendazzoli || Parameters_->z_scale_H ||
+        print_ > 3)
+        return false;
+    if (!CalcInfo_->sigma_initialized) sigma_init(C, S);
+
+    int fci = Parameters_->fci;
+    int nthreads = std::max(SigmaData_->nthreads, 1);
+    int phase;
+
+    if (!Parameters_->Ms0)
+        phase = 1;
+    else
+        phase = ((int)Parameters_->S % 2) ? -1 : 1;
+
+    size_t vlen = 0;
+    int maxrows = 0;
+    for (int block = 0; block < C.num_blocks_; block++) {
+        vlen += (size_t)C.Ia_size_[block] * C.Ib_size_[block];
+        maxrows = std::max(maxrows, C.Ia_size_[block]);
+    }
+    size_t bufsz = C.get_max_blk_size();
+    int max_dim = SigmaData_->max_dim;
+
+    /* C and sigma copies plus each thread's cprime and V, per vector */
+    size_t per_vec = (2 * vlen + nthreads * (bufsz + max_dim)) * sizeof(double);
+    MemoryBroker &broker = MemoryBroker::shared_object();
+    MemoryGrant grant("DETCI sigma batch");
+    broker.request(grant.name(), 0, {{nvec * per_vec, 1.0}});
+    int nbatch = (int)std::min((size_t)nvec, broker.allocate()[grant.name()] / per_vec);
+    if (nbatch < 2) return false;
+
+    for (int v0 = first; v0 < first + nvec; v0 += nbatch) {
+        int nr = std::min(nbatch, first + nvec - v0);
+
+        /*
+        ** The rows of the "wide" blocks hold the nr vectors one after the
+        ** other (row Ia of root r at columns r*nbs...), which s2 sees as a
+        ** single block with nr*nbs columns.  The "stacked" row pointers
+        ** list the same rows root by root, which s1 sees as a block of
+        ** nr*nas rows and s3 as nr blocks.
+        */
+        std::vector<double> cdata(nr * vlen), sdata(nr * vlen, 0.0);
+        std::vector<std::vector<double *>> cwide(C.num_blocks_), swide(S.num_blocks_);
+        std::vector<std::vector<double *>> cstack(C.num_blocks_), sstack(S.num_blocks_);
+        size_t offset = 0;
+        for (int block = 0; block < C.num_blocks_; block++) {
+            int nas = C.Ia_size_[block];
+            int nbs = C.Ib_size_[block];
+            cwide[block].resize(nas);
+            swide[block].resize(nas);
+            cstack[block].resize((size_t)nr * nas);
+            sstack[block].resize((size_t)nr * nas);
+            for (int Ia = 0; Ia < nas; Ia++) {
+                cwide[block][Ia] = cdata.data() + offset + (size_t)Ia * nr * nbs;
+                swide[block][Ia] = sdata.data() + offset + (size_t)Ia * nr * nbs;
+                for (int r = 0; r < nr; r++) {
+                    cstack[block][r * nas + Ia] = cwide[block][Ia] + r * nbs;
+                    sstack[block][r * nas + Ia] = swide[block][Ia] + r * nbs;
+                }
+            }
+            offset += (size_t)nr * nas * nbs;
+        }
+
+        for (int r = 0; r < nr; r++) {
+            C.read(v0 + r, 0);
+            for (int block = 0; block < C.num_blocks_; block++) {
+                int nas = C.Ia_size_[block];
+                int nbs = C.Ib_size_[block];
+                for (int Ia = 0; Ia < nas; Ia++)
+                    memcpy(cstack[block][r * nas + Ia], C.blocks_[block][Ia], nbs * sizeof(double));
+            }
+        }
+
+        std::vector<int> did_sblock(S.num_blocks_, 0);
+
+        /* sigma blocks are shared out among the threads as in sigma_b() */
+#pragma omp parallel num_threads(nthreads) if (nthreads > 1)
+        {
+            struct sigma_data *SD = SigmaData_;
+#ifdef _OPENMP
+            if (nthreads > 1) SD = &SigmaData_->thread[omp_get_thread_num()];
+#endif
+            std::vector<double> cpdata(nr * bufsz), V((size_t)nr * max_dim);
+            std::vector<double *> cprime(maxrows);
+            cprime[0] = cpdata.data();
+
+#pragma omp for schedule(dynamic)
+            for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
+                int sac = S.Ia_code_[sblock];
+                int sbc = S.Ib_code_[sblock];
+                int nas = S.Ia_size_[sblock];
+                int nbs = S.Ib_size_[sblock];
+                if (nas == 0 || nbs == 0) continue;
+                if (S.Ms0_ && sbc > sac) continue;
+                int sbirr = sbc / BetaG_->subgr_per_irrep;
+                double **swblk = swide[sblock].data();
+                double **ssblk = sstack[sblock].data();
+
+                for (int cblock = 0; cblock < C.num_blocks_; cblock++) {
+                    if (C.check_zero_block(cblock)) continue;
+                    if (!s1_contrib_[sblock][cblock] && !s2_contrib_[sblock][cblock] && !s3_contrib_[sblock][cblock])
+                        continue;
+                    int cac = C.Ia_code_[cblock];
+                    int cbc = C.Ib_code_[cblock];
+                    int cnas = C.Ia_size_[cblock];
+                    int cnbs = C.Ib_size_[cblock];
+                    int cbirr = cbc / BetaG_->subgr_per_irrep;
+                    double **cwblk = cwide[cblock].data();
+                    double **csblk = cstack[cblock].data();
+
+                    if (s2_contrib_[sblock][cblock]) {
+                        if (fci)
+                            s2_block_vfci(alplist_, betlist_, cwblk, swblk, oei, tei, SD->F, C.num_alpcodes_, nas,
+                                          nr * nbs, sac, cac, cnas);
+                        else
+                            s2_block_vras(alplist_, betlist_, cwblk, swblk, oei, tei, SD->F, C.num_alpcodes_, nas,
+                                          nr * nbs, sac, cac, cnas);
+                    }
+
+                    if ((!S.Ms0_ || sac != sbc) && s1_contrib_[sblock][cblock]) {
+                        if (fci)
+                            s1_block_vfci(alplist_, betlist_, csblk, ssblk, oei, tei, SD->F, C.num_betcodes_,
+                                          nr * nas, nbs, sbc, cbc, cnbs);
+                        else
+                            s1_block_vras(alplist_, betlist_, csblk, ssblk, oei, tei, SD->F, C.num_betcodes_,
+                                          nr * nas, nbs, sbc, cbc, cnbs);
+                    }
+
+                    if (s3_contrib_[sblock][cblock]) {
+                        set_row_ptrs(cnas, nr * cnbs, cprime.data());
+                        if (!S.Ms0_ || sac != sbc)
+                            s3_block_v(alplist_[sac], betlist_[sbc], csblk, ssblk, tei, nas, nbs, cnas, sbc, cac, cbc,
+                                       sbirr, cbirr, cprime.data(), SD->F, V.data(), SD->Sgn, SD->L, SD->R,
+                                       CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs, nr);
+                        else
+                            s3_block_vdiag(alplist_[sac], betlist_[sbc], csblk, ssblk, tei, nas, nbs, cnas, sbc, cac,
+                                           cbc, sbirr, cbirr, cprime.data(), SD->F, V.data(), SD->Sgn, SD->L, SD->R,
+                                           CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs, nr);
+                    }
+                    did_sblock[sblock] = 1;
+                } /* end loop over c blocks */
+            }     /* end loop over sigma blocks */
+        }
+
+        /* finish and write each sigma vector as sigma_b() does */
+        for (int r = 0; r < nr; r++) {
+            S.zero();
+            for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
+                int sac = S.Ia_code_[sblock];
+                int sbc = S.Ib_code_[sblock];
+                int nas = S.Ia_size_[sblock];
+                int nbs = S.Ib_size_[sblock];
+                if (nas == 0 || nbs == 0) continue;
+                if (S.Ms0_ && sbc > sac) continue;
+                for (int Ia = 0; Ia < nas; Ia++)
+                    memcpy(S.blocks_[sblock][Ia], sstack[sblock][r * nas + Ia], nbs * sizeof(double));
+
+                if (did_sblock[sblock]) S.set_zero_block(sblock, 0);
+                if (S.Ms0_ && (sac == sbc)) transp_sigma(S.blocks_[sblock], nas, nbs, phase);
+                H0block_gather(S.blocks_[sblock], sac, sbc, 1, Parameters_->Ms0, phase);
+            }
+
+            if (S.Ms0_) {
+                if ((int)Parameters_->S % 2)
+                    S.symmetrize(-1.0, 0);
+                else
+                    S.symmetrize(1.0, 0);
+            }
+
+            S.write(v0 + r, 0);
+        }
+    }
+
+    return true;
+}
+
 /*
 ** sigma_c(): This function computes the sigma vector for a given C vector
 **    using the CIvector class.   Is somewhat intelligent about constructing
@@ -554,7 +803,7 @@ void CIWavefunction::sigma_c(struct stringwr **alplist, struct stringwr **betlis
                         if (SigmaData_->cprime != nullptr) set_row_ptrs(cnas, cnbs, SigmaData_->cprime);
                         sigma_block(alplist, betlist, C.blocks_[cblock], S.blocks_[sblock], oei, tei, fci, cblock,
                                     sblock, nas, nbs, sac, sbc, cac, cbc, cnas, cnbs, C.num_alpcodes_, C.num_betcodes_,
-                                    sbirr, cbirr, S.Ms0_);
+                                    sbirr, cbirr, S.Ms0_, SigmaData_);
                         did_sblock = 1;
                     }
 
@@ -567,7 +816,7 @@ void CIWavefunction::sigma_c(struct stringwr **alplist, struct stringwr **betlis
                             if (SigmaData_->cprime != nullptr) set_row_ptrs(cnbs, cnas, SigmaData_->cprime);
                             sigma_block(alplist, betlist, SigmaData_->transp_tmp, S.blocks_[sblock], oei, tei, fci,
                                         cblock2, sblock, nas, nbs, sac, sbc, cbc, cac, cnbs, cnas, C.num_alpcodes_,
-                                        C.num_betcodes_, sbirr, cairr, S.Ms0_);
+                                        C.num_betcodes_, sbirr, cairr, S.Ms0_, SigmaData_);
                             did_sblock = 1;
                         }
                     }
@@ -612,23 +861,25 @@ void CIWavefunction::sigma_c(struct stringwr **alplist, struct stringwr **betlis
 void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **betlist, double **cmat, double **smat,
                                  double *oei, double *tei, int fci, int cblock, int sblock, int nas, int nbs, int sac,
                                  int sbc, int cac, int cbc, int cnas, int cnbs, int cnac, int cnbc, int sbirr,
-                                 int cbirr, int Ms0) {
+                                 int cbirr, int Ms0, struct sigma_data *SD) {
+    /* serial timers cannot be used inside the threaded block loop of sigma_b */
+    bool timed = (SD == SigmaData_);
+
     /* SIGMA2 CONTRIBUTION */
     if (s2_contrib_[sblock][cblock]) {
-        timer_on("CIWave: s2");
+        if (timed) timer_on("CIWave: s2");
 
         if (fci) {
-            s2_block_vfci(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnac, nas, nbs, sac, cac, cnas);
+            s2_block_vfci(alplist, betlist, cmat, smat, oei, tei, SD->F, cnac, nas, nbs, sac, cac, cnas);
         } else {
             if (Parameters_->repl_otf) {
-                s2_block_vras_rotf(SigmaData_->Jcnt, SigmaData_->Jij, SigmaData_->Joij, SigmaData_->Jridx,
-                                   SigmaData_->Jsgn, SigmaData_->Toccs, cmat, smat, oei, tei, SigmaData_->F, cnac, nas,
-                                   nbs, sac, cac, cnas, AlphaG_, BetaG_, CalcInfo_, Occs_);
+                s2_block_vras_rotf(SD->Jcnt, SD->Jij, SD->Joij, SD->Jridx, SD->Jsgn, SD->Toccs, cmat, smat, oei, tei,
+                                   SD->F, cnac, nas, nbs, sac, cac, cnas, AlphaG_, BetaG_, CalcInfo_, Occs_);
             } else {
-                s2_block_vras(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnac, nas, nbs, sac, cac, cnas);
+                s2_block_vras(alplist, betlist, cmat, smat, oei, tei, SD->F, cnac, nas, nbs, sac, cac, cnas);
             }
         }
-        timer_off("CIWave: s2");
+        if (timed) timer_off("CIWave: s2");
 
     } /* end sigma2 */
 
@@ -639,24 +890,22 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
 
     /* SIGMA1 CONTRIBUTION */
     if (!Ms0 || (sac != sbc)) {
-        timer_on("CIWave: s1");
+        if (timed) timer_on("CIWave: s1");
 
         if (s1_contrib_[sblock][cblock]) {
             if (fci) {
-                s1_block_vfci(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnbc, nas, nbs, sbc, cbc, cnbs);
+                s1_block_vfci(alplist, betlist, cmat, smat, oei, tei, SD->F, cnbc, nas, nbs, sbc, cbc, cnbs);
             } else {
                 if (Parameters_->repl_otf) {
-                    s1_block_vras_rotf(SigmaData_->Jcnt, SigmaData_->Jij, SigmaData_->Joij, SigmaData_->Jridx,
-                                       SigmaData_->Jsgn, SigmaData_->Toccs, cmat, smat, oei, tei, SigmaData_->F, cnbc,
-                                       nas, nbs, sbc, cbc, cnbs, BetaG_, CalcInfo_, Occs_);
+                    s1_block_vras_rotf(SD->Jcnt, SD->Jij, SD->Joij, SD->Jridx, SD->Jsgn, SD->Toccs, cmat, smat, oei,
+                                       tei, SD->F, cnbc, nas, nbs, sbc, cbc, cnbs, BetaG_, CalcInfo_, Occs_);
                 } else {
-                    s1_block_vras(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnbc, nas, nbs, sbc, cbc,
-                                  cnbs);
+                    s1_block_vras(alplist, betlist, cmat, smat, oei, tei, SD->F, cnbc, nas, nbs, sbc, cbc, cnbs);
                 }
             }
         }
 
-        timer_off("CIWave: s1");
+        if (timed) timer_off("CIWave: s1");
     } /* end sigma1 */
 
     if (print_ > 3) {
@@ -666,46 +915,43 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
 
     /* SIGMA3 CONTRIBUTION */
     if (s3_contrib_[sblock][cblock]) {
-        timer_on("CIWave: s3");
+        if (timed) timer_on("CIWave: s3");
 
         /* zero_mat(smat, nas, nbs); */
 
         if (!Ms0 || (sac != sbc)) {
             if (Parameters_->repl_otf) {
-                b2brepl(Occs_[sac], SigmaData_->Jcnt[0], SigmaData_->Jij[0], SigmaData_->Joij[0], SigmaData_->Jridx[0],
-                        SigmaData_->Jsgn[0], AlphaG_, sac, cac, nas, CalcInfo_);
-                b2brepl(Occs_[sbc], SigmaData_->Jcnt[1], SigmaData_->Jij[1], SigmaData_->Joij[1], SigmaData_->Jridx[1],
-                        SigmaData_->Jsgn[1], BetaG_, sbc, cbc, nbs, CalcInfo_);
-                s3_block_vrotf(SigmaData_->Jcnt, SigmaData_->Jij, SigmaData_->Jridx, SigmaData_->Jsgn, cmat, smat, tei,
-                               nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr, SigmaData_->cprime, SigmaData_->F,
-                               SigmaData_->V, SigmaData_->Sgn, SigmaData_->L, SigmaData_->R, CalcInfo_->num_ci_orbs,
+                b2brepl(Occs_[sac], SD->Jcnt[0], SD->Jij[0], SD->Joij[0], SD->Jridx[0], SD->Jsgn[0], AlphaG_, sac, cac,
+                        nas, CalcInfo_);
+                b2brepl(Occs_[sbc], SD->Jcnt[1], SD->Jij[1], SD->Joij[1], SD->Jridx[1], SD->Jsgn[1], BetaG_, sbc, cbc,
+                        nbs, CalcInfo_);
+                s3_block_vrotf(SD->Jcnt, SD->Jij, SD->Jridx, SD->Jsgn, cmat, smat, tei, nas, nbs, cnas, sbc, cac, cbc,
+                               sbirr, cbirr, SD->cprime, SD->F, SD->V, SD->Sgn, SD->L, SD->R, CalcInfo_->num_ci_orbs,
                                CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
             } else {
                 s3_block_v(alplist[sac], betlist[sbc], cmat, smat, tei, nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr,
-                           SigmaData_->cprime, SigmaData_->F, SigmaData_->V, SigmaData_->Sgn, SigmaData_->L,
-                           SigmaData_->R, CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
+                           SD->cprime, SD->F, SD->V, SD->Sgn, SD->L, SD->R, CalcInfo_->num_ci_orbs,
+                           CalcInfo_->orbsym + CalcInfo_->num_drc_orbs, 1);
             }
         }
 
         else if (Parameters_->bendazzoli) {
-            s3_block_bz(sac, sbc, cac, cbc, nas, nbs, cnas, tei, cmat, smat, SigmaData_->cprime, SigmaData_->sprime,
-                        CalcInfo_, OV_);
+            s3_block_bz(sac, sbc, cac, cbc, nas, nbs, cnas, tei, cmat, smat, SD->cprime, SD->sprime, CalcInfo_, OV_);
         }
 
         else {
             if (Parameters_->repl_otf) {
-                b2brepl(Occs_[sac], SigmaData_->Jcnt[0], SigmaData_->Jij[0], SigmaData_->Joij[0], SigmaData_->Jridx[0],
-                        SigmaData_->Jsgn[0], AlphaG_, sac, cac, nas, CalcInfo_);
-                b2brepl(Occs_[sbc], SigmaData_->Jcnt[1], SigmaData_->Jij[1], SigmaData_->Joij[1], SigmaData_->Jridx[1],
-                        SigmaData_->Jsgn[1], BetaG_, sbc, cbc, nbs, CalcInfo_);
-                s3_block_vdiag_rotf(SigmaData_->Jcnt, SigmaData_->Jij, SigmaData_->Jridx, SigmaData_->Jsgn, cmat, smat,
-                                    tei, nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr, SigmaData_->cprime, SigmaData_->F,
-                                    SigmaData_->V, SigmaData_->Sgn, SigmaData_->L, SigmaData_->R,
+                b2brepl(Occs_[sac], SD->Jcnt[0], SD->Jij[0], SD->Joij[0], SD->Jridx[0], SD->Jsgn[0], AlphaG_, sac, cac,
+                        nas, CalcInfo_);
+                b2brepl(Occs_[sbc], SD->Jcnt[1], SD->Jij[1], SD->Joij[1], SD->Jridx[1], SD->Jsgn[1], BetaG_, sbc, cbc,
+                        nbs, CalcInfo_);
+                s3_block_vdiag_rotf(SD->Jcnt, SD->Jij, SD->Jridx, SD->Jsgn, cmat, smat, tei, nas, nbs, cnas, sbc, cac,
+                                    cbc, sbirr, cbirr, SD->cprime, SD->F, SD->V, SD->Sgn, SD->L, SD->R,
                                     CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
             } else {
                 s3_block_vdiag(alplist[sac], betlist[sbc], cmat, smat, tei, nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr,
-                               SigmaData_->cprime, SigmaData_->F, SigmaData_->V, SigmaData_->Sgn, SigmaData_->L,
-                               SigmaData_->R, CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
+                               SD->cprime, SD->F, SD->V, SD->Sgn, SD->L, SD->R, CalcInfo_->num_ci_orbs,
+                               CalcInfo_->orbsym + CalcInfo_->num_drc_orbs, 1);
             }
         }
 
@@ -714,7 +960,7 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
             print_mat(smat, nas, nbs, "outfile");
         }
 
-        timer_off("CIWave: s3");
+        if (timed) timer_off("CIWave: s3");
 
     } /* end sigma3 */
 }
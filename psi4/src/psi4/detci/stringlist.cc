@@ -39,6 +39,12 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/wavefunction.h"
@@ -63,45 +69,88 @@ int **sbgr_tr_out;
 int sbgr_tr_walks;
 int *sbgr_tr_alist;
 
-int *O, *U, *T;
-int **Tij, **Toij, *Tcnt;
-size_t **Tidx;
-signed char **Tsgn;
-
 extern int subgr_lex_addr(struct level *head, int *occs, int nel, int norb);
 extern int og_lex_addr(struct olsen_graph *Graph, int *occs, int nel, int *listnum);
 
+namespace {
+
+/*
+** Scratch for the single replacements of one string, one per thread.
+** T* hold the replacements into each string list in the order found.
+*/
+struct repl_temps {
+    std::vector<int> O, U, T, diagij, diagoij;
+    std::vector<int> Tcnt;
+    std::vector<std::vector<int>> Tij, Toij;
+    std::vector<std::vector<size_t>> Tidx;
+    std::vector<std::vector<signed char>> Tsgn;
+
+    repl_temps(int nel, int num_ci_orbs, int nlists)
+        : O(nel + 1),
+          /* MLL and CDS +1 in case of no virtual alpha electrons */
+          U(num_ci_orbs - nel + 1),
+          T(nel + 1),
+          diagij(nel + 1),
+          diagoij(nel + 1),
+          Tcnt(nlists),
+          /* num single replacements inc. self-repl */
+          Tij(nlists, std::vector<int>(nel * num_ci_orbs)),
+          Toij(nlists, std::vector<int>(nel * num_ci_orbs)),
+          Tidx(nlists, std::vector<size_t>(nel * num_ci_orbs)),
+          Tsgn(nlists, std::vector<signed char>(nel * num_ci_orbs)) {}
+};
+
+/*
+** The replacements found by one thread, string after string and, for each
+** string, list after list in increasing ij, before they are packed.
+*/
+struct repl_stage {
+    std::vector<int> ij, oij;
+    std::vector<size_t> ridx;
+    std::vector<signed char> sgn;
+};
+
+}  // namespace
+
 /* FUNCTION PROTOTYPES this module */
 void subgr_trav_init(struct level *head, int ci_orbs, int **outarr, int walks);
 void subgr_traverse(int i, int j);
-void form_stringwr(struct stringwr *strlist, int *occs, int N, int num_ci_orbs, struct stringgraph *subgraph,
-                   struct olsen_graph *Graph, int first_orb_active, int repl_otf);
-void og_form_repinfo(struct stringwr *string, int num_ci_orbs, struct olsen_graph *Graph, int first_orb_active);
-void init_stringwr_temps(int nel, int num_ci_orbs, int nsym);
-void free_stringwr_temps(int nsym);
+void og_form_repinfo(repl_temps &tmp, const int *occs, int num_ci_orbs, struct olsen_graph *Graph,
+                     int first_orb_active);
+void pack_stringwr(struct stringwr *strlist, int nstr, int nlists, const std::vector<int> &cnt,
+                   const std::vector<int> &stage_thread, const std::vector<size_t> &stage_offset,
+                   const std::vector<repl_stage> &stages);
 
 /*
 ** stringlist():  This function forms the list of strings with their
 **    single replacements using the Olsen Graph structures.
 **
+**    The replacements are stored list by list in compressed-row form: for
+**    string list L and replacement list J, the ridx, ij, oij, and sgn of
+**    all the strings of L share one contiguous block, string after string
+**    in address order, and each stringwr only points into it.  The sigma
+**    loops over consecutive strings thus walk through memory in order.
+**    The strings of a list are worked out in parallel.
+**
 */
 void stringlist(struct olsen_graph *Graph, struct stringwr **slist, int repl_otf, unsigned char ***Occs) {
     int i;
-    int nirreps, irrep, code, ncodes, walk, listnum, addr;
-    int nel_expl;
+    int nirreps, irrep, code, ncodes, listnum;
+    int nel_expl, nlists, nthreads = 1;
     struct stringgraph *subgraph;
-    int **outarr, *occs;
+    int **outarr;
 
     nel_expl = Graph->num_el_expl;
     ncodes = Graph->subgr_per_irrep;
     nirreps = Graph->nirreps;
+    nlists = nirreps * ncodes;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
 
     outarr = init_int_matrix(nel_expl, Graph->max_str_per_irrep);
-    occs = init_int_array(nel_expl);
 
-    if (!repl_otf) {
-        init_stringwr_temps(Graph->num_el_expl, Graph->num_orb, nirreps * ncodes);
-    } else {
+    if (repl_otf) {
         // CDS help: This effectively allocates Occs twice if alplist != betlist
         Occs = (unsigned char ***)malloc(static_cast<size_t>(nirreps) * ncodes * sizeof(unsigned char **));
     }
@@ -111,45 +160,172 @@ void stringlist(struct olsen_graph *Graph, struct stringwr **slist, int repl_otf
             if (repl_otf) Occs[listnum] = nullptr;
 
             subgraph = Graph->sg[irrep] + code;
-            if (!subgraph->num_strings) continue;
+            int nstr = subgraph->num_strings;
+            if (!nstr) continue;
 
             if (repl_otf) {
-                Occs[listnum] = (unsigned char **)malloc(subgraph->num_strings * sizeof(unsigned char *));
-                for (i = 0; i < subgraph->num_strings; i++)
-                    Occs[listnum][i] = (unsigned char *)malloc(nel_expl * sizeof(unsigned char));
+                Occs[listnum] = (unsigned char **)malloc(nstr * sizeof(unsigned char *));
+                for (i = 0; i < nstr; i++) Occs[listnum][i] = (unsigned char *)malloc(nel_expl * sizeof(unsigned char));
             }
 
-            slist[listnum] = (struct stringwr *)malloc(subgraph->num_strings * sizeof(struct stringwr));
+            struct stringwr *strlist = (struct stringwr *)malloc(nstr * sizeof(struct stringwr));
+            slist[listnum] = strlist;
+            unsigned char *occs_all = (unsigned char *)malloc(std::max((size_t)nstr * nel_expl, (size_t)1));
+            if (strlist == nullptr || occs_all == nullptr) {
+                throw PsiException("(stringlist): Malloc error", __FILE__, __LINE__);
+            }
 
             subgr_trav_init(subgraph->lvl, Graph->num_orb, outarr, 0);
             subgr_traverse(0, 0);
             free(sbgr_tr_alist);
 
-            for (walk = 0; walk < subgraph->num_strings; walk++) {
-                for (i = 0; i < nel_expl; i++) occs[i] = outarr[i][walk];
-                addr = subgr_lex_addr(subgraph->lvl, occs, nel_expl, Graph->num_orb);
+            /* replacement counts of string addr into list J at cnt[addr * nlists + J] */
+            std::vector<int> cnt(repl_otf ? 0 : (size_t)nstr * nlists);
+            std::vector<int> stage_thread(nstr, 0);
+            std::vector<size_t> stage_offset(nstr, 0);
+            std::vector<repl_stage> stages(nthreads);
+
+#pragma omp parallel num_threads(nthreads) if (nthreads > 1 && nstr > 1)
+            {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                std::vector<int> occs(nel_expl + 1);
+                std::unique_ptr<repl_temps> tmp;
+                if (!repl_otf) tmp.reset(new repl_temps(nel_expl, Graph->num_orb, nlists));
+                repl_stage &stage = stages[thread];
+
+#pragma omp for schedule(dynamic, 16)
+                for (int walk = 0; walk < nstr; walk++) {
+                    for (int e = 0; e < nel_expl; e++) occs[e] = outarr[e][walk];
+                    int addr = subgr_lex_addr(subgraph->lvl, occs.data(), nel_expl, Graph->num_orb);
+
+                    if (addr < 0) {
+                        outfile->Printf("(stringlist): Impossible string addr\n");
+                        continue;
+                    }
 
-                if (addr < 0) {
-                    outfile->Printf("(stringlist): Impossible string addr\n");
-                }
+                    struct stringwr *node = strlist + addr;
+                    node->occs = occs_all + (size_t)addr * nel_expl;
+                    for (int e = 0; e < nel_expl; e++) node->occs[e] = (unsigned char)occs[e];
 
-                if (repl_otf) {
-                    for (i = 0; i < nel_expl; i++) Occs[listnum][addr][i] = (unsigned char)occs[i];
-                }
+                    if (repl_otf) {
+                        for (int e = 0; e < nel_expl; e++) Occs[listnum][addr][e] = (unsigned char)occs[e];
+                        continue;
+                    }
 
-                form_stringwr(slist[irrep * ncodes + code], occs, nel_expl, Graph->num_orb, subgraph, Graph,
-                              Graph->num_expl_cor_orbs, repl_otf);
+                    og_form_repinfo(*tmp, occs.data(), Graph->num_orb, Graph, Graph->num_expl_cor_orbs);
+
+                    /* stage the replacements into each list in order of increasing ij */
+                    stage_thread[addr] = thread;
+                    stage_offset[addr] = stage.ij.size();
+                    for (int J = 0; J < nlists; J++) {
+                        int n = tmp->Tcnt[J];
+                        cnt[(size_t)addr * nlists + J] = n;
+                        for (int k = 0; k < n; k++) {
+                            int p = 0;
+                            for (int l = 0, q = MAXIJ; l < n; l++) {
+                                if (tmp->Tij[J][l] <= q) {
+                                    q = tmp->Tij[J][l];
+                                    p = l;
+                                }
+                            }
+                            stage.ij.push_back(tmp->Tij[J][p]);
+                            stage.oij.push_back(tmp->Toij[J][p]);
+                            stage.ridx.push_back(tmp->Tidx[J][p]);
+                            stage.sgn.push_back(tmp->Tsgn[J][p]);
+                            tmp->Tij[J][p] = MAXIJ;
+                        }
+                    }
+                }
             }
+
+            if (!repl_otf) pack_stringwr(strlist, nstr, nlists, cnt, stage_thread, stage_offset, stages);
         } /* end loop over subgraph codes */
     }     /* end loop over irreps */
 
-    /* free the stringwr scratch space */
-    if (!repl_otf) {
-        free_stringwr_temps(nirreps * ncodes);
+    free_int_matrix(outarr);
+}
+
+/*
+** pack_stringwr(): Move the staged replacements of the nstr strings of
+**    one list into their compressed-row blocks and point the stringwr
+**    entries into them.
+*/
+void pack_stringwr(struct stringwr *strlist, int nstr, int nlists, const std::vector<int> &cnt,
+                   const std::vector<int> &stage_thread, const std::vector<size_t> &stage_offset,
+                   const std::vector<repl_stage> &stages) {
+    /* row offsets of each string within the block of each replacement list */
+    std::vector<size_t> rowoff((size_t)nstr * nlists);
+    std::vector<size_t> total(nlists, 0);
+    for (int addr = 0; addr < nstr; addr++) {
+        for (int J = 0; J < nlists; J++) {
+            rowoff[(size_t)addr * nlists + J] = total[J];
+            total[J] += cnt[(size_t)addr * nlists + J];
+        }
+    }
+
+    /* one block per replacement list: ridx, then ij, oij, and sgn */
+    std::vector<size_t *> ridx_blk(nlists, nullptr);
+    std::vector<int *> ij_blk(nlists, nullptr), oij_blk(nlists, nullptr);
+    std::vector<signed char *> sgn_blk(nlists, nullptr);
+    for (int J = 0; J < nlists; J++) {
+        size_t n = total[J];
+        if (!n) continue;
+        char *blk = (char *)malloc(n * (sizeof(size_t) + 2 * sizeof(int) + sizeof(signed char)));
+        if (blk == nullptr) {
+            throw PsiException("(pack_stringwr): Malloc error", __FILE__, __LINE__);
+        }
+        ridx_blk[J] = (size_t *)blk;
+        ij_blk[J] = (int *)(blk + n * sizeof(size_t));
+        oij_blk[J] = ij_blk[J] + n;
+        sgn_blk[J] = (signed char *)(oij_blk[J] + n);
     }
 
-    free_int_matrix(outarr);
-    free(occs);
+    /* the per-string count and pointer arrays are rows of list-wide arrays */
+    int *cnt_all = init_int_array(nstr * nlists);
+    int **ij_all = (int **)malloc(sizeof(int *) * nstr * nlists);
+    int **oij_all = (int **)malloc(sizeof(int *) * nstr * nlists);
+    size_t **ridx_all = (size_t **)malloc(sizeof(size_t *) * nstr * nlists);
+    signed char **sgn_all = (signed char **)malloc(sizeof(signed char *) * nstr * nlists);
+
+#pragma omp parallel for schedule(static)
+    for (int addr = 0; addr < nstr; addr++) {
+        struct stringwr *string = strlist + addr;
+        size_t row = (size_t)addr * nlists;
+        const repl_stage &stage = stages[stage_thread[addr]];
+        size_t src = stage_offset[addr];
+
+        string->cnt = cnt_all + row;
+        string->ij = ij_all + row;
+        string->oij = oij_all + row;
+        string->ridx = ridx_all + row;
+        string->sgn = sgn_all + row;
+
+        for (int J = 0; J < nlists; J++) {
+            int n = cnt[row + J];
+            string->cnt[J] = n;
+            string->ij[J] = nullptr;
+            string->oij[J] = nullptr;
+            string->ridx[J] = nullptr;
+            string->sgn[J] = nullptr;
+            if (!n) continue;
+
+            size_t dst = rowoff[row + J];
+            string->ij[J] = ij_blk[J] + dst;
+            string->oij[J] = oij_blk[J] + dst;
+            string->ridx[J] = ridx_blk[J] + dst;
+            string->sgn[J] = sgn_blk[J] + dst;
+            for (int k = 0; k < n; k++) {
+                string->ij[J][k] = stage.ij[src + k];
+                string->oij[J][k] = stage.oij[src + k];
+                string->ridx[J][k] = stage.ridx[src + k];
+                string->sgn[J][k] = stage.sgn[src + k];
+            }
+            src += n;
+        }
+    }
 }
 
 void subgr_trav_init(struct level *head, int ci_orbs, int **outarr, int walks) {
@@ -180,63 +356,30 @@ void subgr_traverse(int i, int j) {
     if (k1) subgr_traverse(i + 1, k1 - 1);
 }
 
-/*
-** form_stringwr(): Make the string with replacements list.
-**    This version uses the Olsen Graph structures.
-**
-** Parameters:
-**   strlist          = list of strings (may be different for alpha and beta)
-**   occs             = list of occupied orbitals (N long)
-**   N                = number of electrons explicitly included
-**   num_ci_orbs      = number of active CI orbitals
-**   subgraph         = the subgraph including the given walk
-**   Graph            = the olsengraph for the alpha or beta strings
-**   first_orb_active = first alp/bet orb active
-*/
-void form_stringwr(struct stringwr *strlist, int *occs, int N, int num_ci_orbs, struct stringgraph *subgraph,
-                   struct olsen_graph *Graph, int first_orb_active, int repl_otf) {
-    unsigned char *occlist;
-    size_t addr;
-    int i;
-    struct stringwr *node;
-
-    occlist = (unsigned char *)malloc(N * sizeof(unsigned char));
-    if (occlist == nullptr) {
-        throw PsiException("(form_stringwr): Malloc error", __FILE__, __LINE__);
-    }
-
-    for (i = 0; i < N; i++) {
-        occlist[i] = occs[i];
-    }
-
-    addr = subgr_lex_addr(subgraph->lvl, occs, N, num_ci_orbs);
-
-    node = strlist + addr;
-    node->occs = occlist;
-
-    if (!repl_otf) {
-        og_form_repinfo(node, num_ci_orbs, Graph, first_orb_active);
-    }
-}
-
 /*
 ** og_form_repinfo(): This function is a slightly-modified version of the
 **    form_repinfo() function, which forms the single replacement info
 **    for each string.  This version uses the Olsen Graph structures.
 **
+**    The replacements of the string with occupied orbitals occs are left
+**    in tmp.T*, unsorted.
 */
-void og_form_repinfo(struct stringwr *string, int num_ci_orbs, struct olsen_graph *Graph, int first_orb_active) {
+void og_form_repinfo(repl_temps &tmp, const int *occs, int num_ci_orbs, struct olsen_graph *Graph,
+                     int first_orb_active) {
     int nel, p, q, i, j, k, l, ij, oij;
-    int nlists, listnum, strlistnum, nsym, jused, ndrc;
+    int nlists, listnum, strlistnum, nsym, jused;
     int diagcnt = 0;
-    static int *diagij = nullptr;
-    static int *diagoij = nullptr;
     size_t cnt, stringridx;
     int ridx;
     signed char sgn;
+    int *O = tmp.O.data();
+    int *U = tmp.U.data();
+    int *T = tmp.T.data();
+    int *diagij = tmp.diagij.data();
+    int *diagoij = tmp.diagoij.data();
+    int *Tcnt = tmp.Tcnt.data();
 
     nel = Graph->num_el_expl;
-    ndrc = Graph->num_drc_orbs;
     nsym = Graph->nirreps;
     nlists = Graph->subgr_per_irrep * nsym;
 
@@ -246,13 +389,11 @@ void og_form_repinfo(struct stringwr *string, int num_ci_orbs, struct olsen_grap
     zero_int_array(U, num_ci_orbs - nel);
     zero_int_array(T, nel);
 
-    for (i = 0; i < nel; i++) O[i] = (string->occs)[i];
+    for (i = 0; i < nel; i++) O[i] = occs[i];
     stringridx = og_lex_addr(Graph, O, nel, &strlistnum);
 
     /* set up the ij indices for the 'diagonal' entries E_ii           */
     /* this assumes that the values in array O are strictly increasing */
-    if (diagij == nullptr) diagij = init_int_array(nel);
-    if (diagoij == nullptr) diagoij = init_int_array(nel);
     for (i = 0; i < nel; i++) {
         j = O[i];
         diagij[i] = ioff[j] + j;
@@ -261,17 +402,17 @@ void og_form_repinfo(struct stringwr *string, int num_ci_orbs, struct olsen_grap
 
     /* do the inactive E_ii's first */
     for (i = 0; i < first_orb_active; i++) {
-        p = (string->occs)[i];
-        q = (string->occs)[i];
+        p = occs[i];
+        q = occs[i];
         ij = ioff[p] + q;
         oij = p * num_ci_orbs + q;
         sgn = (signed char)1;
 
         cnt = Tcnt[strlistnum];
-        Tij[strlistnum][cnt] = ij;
-        Toij[strlistnum][cnt] = oij;
-        Tidx[strlistnum][cnt] = stringridx;
-        Tsgn[strlistnum][cnt] = sgn;
+        tmp.Tij[strlistnum][cnt] = ij;
+        tmp.Toij[strlistnum][cnt] = oij;
+        tmp.Tidx[strlistnum][cnt] = stringridx;
+        tmp.Tsgn[strlistnum][cnt] = sgn;
         Tcnt[strlistnum] += 1;
         diagcnt++;
     }
@@ -308,10 +449,10 @@ void og_form_repinfo(struct stringwr *string, int num_ci_orbs, struct olsen_grap
             if (ridx >= 0) {
                 while (diagcnt < nel && ij > diagij[diagcnt]) {
                     cnt = Tcnt[strlistnum];
-                    Tij[strlistnum][cnt] = diagij[diagcnt];
-                    Toij[strlistnum][cnt] = diagoij[diagcnt];
-                    Tidx[strlistnum][cnt] = stringridx;
-                    Tsgn[strlistnum][cnt] = (signed char)1;
+                    tmp.Tij[strlistnum][cnt] = diagij[diagcnt];
+                    tmp.Toij[strlistnum][cnt] = diagoij[diagcnt];
+                    tmp.Tidx[strlistnum][cnt] = stringridx;
+                    tmp.Tsgn[strlistnum][cnt] = (signed char)1;
                     Tcnt[strlistnum] += 1;
                     diagcnt++;
                 }
@@ -329,10 +470,10 @@ void og_form_repinfo(struct stringwr *string, int num_ci_orbs, struct olsen_grap
                 sgn = ((i + l) % 2) ? -1 : 1;
 
                 cnt = Tcnt[listnum];
-                Tij[listnum][cnt] = ij;
-                Toij[listnum][cnt] = oij;
-                Tidx[listnum][cnt] = ridx;
-                Tsgn[listnum][cnt] = sgn;
+                tmp.Tij[listnum][cnt] = ij;
+                tmp.Toij[listnum][cnt] = oij;
+                tmp.Tidx[listnum][cnt] = ridx;
+                tmp.Tsgn[listnum][cnt] = sgn;
                 Tcnt[listnum] += 1;
             }
         }
@@ -343,91 +484,14 @@ void og_form_repinfo(struct stringwr *string, int num_ci_orbs, struct olsen_grap
         sgn = (signed char)1;
         listnum = strlistnum;
         cnt = Tcnt[strlistnum];
-        Tij[strlistnum][cnt] = diagij[diagcnt];
-        Toij[strlistnum][cnt] = diagoij[diagcnt];
-        Tidx[strlistnum][cnt] = stringridx;
-        Tsgn[strlistnum][cnt] = sgn;
+        tmp.Tij[strlistnum][cnt] = diagij[diagcnt];
+        tmp.Toij[strlistnum][cnt] = diagoij[diagcnt];
+        tmp.Tidx[strlistnum][cnt] = stringridx;
+        tmp.Tsgn[strlistnum][cnt] = sgn;
         Tcnt[strlistnum] += 1;
         diagcnt++;
     }
-
-    /* now write the info in the T matrices */
-    string->cnt = init_int_array(nlists);
-    string->ij = (int **)malloc(sizeof(int *) * nlists);
-    string->oij = (int **)malloc(sizeof(int *) * nlists);
-    string->ridx = (size_t **)malloc(sizeof(size_t *) * nlists);
-    string->sgn = (signed char **)malloc(sizeof(signed char *) * nlists);
-
-    for (i = 0; i < nlists; i++) {
-        string->cnt[i] = cnt = Tcnt[i];
-        string->ij[i] = nullptr;
-        string->oij[i] = nullptr;
-        string->ridx[i] = nullptr;
-        string->sgn[i] = nullptr;
-        if (cnt) {
-            string->ij[i] = init_int_array(cnt);
-            string->oij[i] = init_int_array(cnt);
-            string->ridx[i] = (size_t *)malloc(cnt * sizeof(size_t));
-            string->sgn[i] = (signed char *)malloc(cnt * sizeof(signed char));
-
-            for (k = 0; k < cnt; k++) {
-                for (l = 0, p = 0, q = MAXIJ; l < cnt; l++) {
-                    ij = Tij[i][l];
-                    if (ij <= q) {
-                        q = ij;
-                        p = l;
-                    }
-                }
-                string->ij[i][k] = Tij[i][p];
-                string->oij[i][k] = Toij[i][p];
-                string->ridx[i][k] = Tidx[i][p];
-                string->sgn[i][k] = Tsgn[i][p];
-                Tij[i][p] = MAXIJ;
-            }
-        }
-    } /* end loop over i */
-}
-
-void init_stringwr_temps(int nel, int num_ci_orbs, int nsym) {
-    int maxcnt, i;
-
-    O = init_int_array(nel + 1);
-    /*   U = init_int_array(num_ci_orbs - nel) ; */
-    /* MLL and CDS +1 in case of no virtual alpha electrons */
-    U = init_int_array(num_ci_orbs - nel + 1);
-    T = init_int_array(nel);
-    Tcnt = init_int_array(nsym);
-    maxcnt = nel * num_ci_orbs; /* num single replacements inc. self-repl */
-    Tij = (int **)malloc(sizeof(int *) * nsym);
-    Toij = (int **)malloc(sizeof(int *) * nsym);
-    Tidx = (size_t **)malloc(sizeof(size_t *) * nsym);
-    Tsgn = (signed char **)malloc(sizeof(signed char *) * nsym);
-
-    for (i = 0; i < nsym; i++) {
-        Tij[i] = init_int_array(maxcnt);
-        Toij[i] = init_int_array(maxcnt);
-        Tidx[i] = (size_t *)malloc(sizeof(size_t) * maxcnt);
-        Tsgn[i] = (signed char *)malloc(sizeof(signed char) * maxcnt);
-    }
 }
 
-void free_stringwr_temps(int nsym) {
-    int i;
-
-    free(O);
-    free(U);
-    free(T);
-    free(Tcnt);
-    for (i = 0; i < nsym; i++) {
-        free(Tij[i]);
-        free(Toij[i]);
-        free(Tidx[i]);
-        free(Tsgn[i]);
-    }
-    free(Tij);
-    free(Toij);
-    free(Tidx);
-    free(Tsgn);
-}
-}
+}  // namespace detci
 }  // namespace psi
@@ -71,6 +71,7 @@ namespace detci {
 #define METHOD_OLSEN 1
 #define METHOD_MITRUSHENKOV 2
 #define METHOD_DAVIDSON_LIU_SEM 3
+#define METHOD_HCI 4
 #define PRECON_LANCZOS 0
 #define PRECON_DAVIDSON 1
 #define PRECON_EVANGELISTI 2
@@ -408,6 +409,7 @@ struct params {
     std::string ref;                     /* reference type (RHF, ROHF); ROHF with MULTP=1
                                             is an open-shell singlet */
     std::string mcscf_type;              /*Type of MCSCF computation DF or CONV */
+    bool mcscf_df_cache;                 /* keep the DF-MCSCF AO integrals for a later run on the same geometry */
     int multp;                           /* multiplicity (2S+1) */
     int print_;                          /* Amount of information to print */
     int ex_lvl;                          /* excitation level */
@@ -464,6 +466,7 @@ struct params {
     int cc_a_ras34_max;                  /* as above but for CC */
     int cc_b_ras34_max;                  /* as above but for CC */
     int guess_vector;                    /* what kind of CI vector to start with; see #define */
+    bool ci_warm_start;                  /* start from the roots of the previous CI over the same space */
     int h0blocksize;                     /* size of H0 block in preconditioner. */
     int h0guess_size;                    /* size of H0 block for initial guess */
     int h0block_coupling_size;           /* size of coupling block in preconditioner */
@@ -491,7 +494,7 @@ struct params {
                                                 1 = Olsen
                                                 2 = Mitrushenkov
                                                 3 = Davidson/Liu SEM method
-                                                4 = Stupid test of Davidson/Liu SEM method */
+                                                4 = Heat-bath selected CI */
     int precon;                          /* preconditioner for diagonalization method
                                             0 = Lanczos
                                             1 = Davidson
@@ -510,6 +513,8 @@ struct params {
     int wigner;                          /* 1(0) if wigner formulas used in Empn series */
     int diag_iters_taken;                /* Number of diagonalization iterations taken */
     int maxnvect;                        /* maximum number of b vectors for SEM method */
+    double hci_epsilon;                  /* heat-bath selection threshold |H_ai c_i| */
+    int hci_maxiter;                     /* maximum number of heat-bath selection steps */
     int nunits;                          /* num of tmp files to use for CI vects and such */
     int collapse_size;                   /* how many vectors to collapse to in SEM */
     int lse_collapse;                    /* iterations between lst sqr ext */
@@ -641,6 +646,8 @@ struct sigma_data {
     double *V, *Sgn;
     int *L, *R;
     int max_dim;
+    int nthreads;              /* threads sharing out the sigma blocks in sigma_b, 0 if serial */
+    struct sigma_data *thread; /* F, V, Sgn, L, R, and cprime of each of those threads */
 };
 }
 }  // namespace psi
@@ -36,12 +36,18 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 /* may no longer need #include <libc.h> */
 #include "psi4/psifiles.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
+#include "psi4/libpsi4util/memory_manager.h"
 #include "psi4/detci/structs.h"
 #include "psi4/detci/civect.h"
 #include "psi4/detci/ciwave.h"
@@ -53,11 +59,6 @@ namespace detci {
 
 // DGAS this is still awkward, I think the TPDM code can be less general than the OPDM one for now.
 void CIWavefunction::form_tpdm() {
-    SharedCIVector Ivec = new_civector(Parameters_->num_roots, Parameters_->d_filenum);
-    Ivec->init_io_files(true);
-    SharedCIVector Jvec = new_civector(Parameters_->num_roots, Parameters_->d_filenum);
-    Jvec->init_io_files(true);
-
     std::vector<SharedMatrix> tpdm_list;
     std::vector<std::tuple<int, int, double> > states_vec;
     for (int root_idx = 0; root_idx < Parameters_->average_num; root_idx++) {
@@ -66,9 +67,18 @@ void CIWavefunction::form_tpdm() {
                                              Parameters_->average_weights[root_idx]));
     }
 
-    tpdm_list = tpdm(Ivec, Jvec, states_vec);
+    if (sci_) {
+        tpdm_list = sci_tpdm(states_vec);
+    } else {
+        SharedCIVector Ivec = new_civector(Parameters_->num_roots, Parameters_->d_filenum);
+        Ivec->init_io_files(true);
+        SharedCIVector Jvec = new_civector(Parameters_->num_roots, Parameters_->d_filenum);
+        Jvec->init_io_files(true);
+
+        tpdm_list = tpdm(Ivec, Jvec, states_vec);
 
-    Ivec->close_io_files(true);  // Closes Jvec too
+        Ivec->close_io_files(true);  // Closes Jvec too
+    }
 
     tpdm_aa_ = tpdm_list[0];
     tpdm_ab_ = tpdm_list[1];
@@ -232,32 +242,35 @@ std::vector<SharedMatrix> CIWavefunction::tpdm(SharedCIVector Ivec, SharedCIVect
     }             /* end icore==0 */
 
     else if (Parameters_->icore == 1) { /* whole vectors in-core */
-        for (int root_idx = 0; root_idx < states_vec.size(); root_idx++) {
-            int Iroot = std::get<0>(states_vec[root_idx]);
-            int Jroot = std::get<1>(states_vec[root_idx]);
-            double weight = std::get<2>(states_vec[root_idx]);
-
-            Ivec->read(Iroot, 0);
-            Jvec->read(Jroot, 0);
-            for (Iblock = 0; Iblock < Ivec->num_blocks_; Iblock++) {
-                Iac = Ivec->Ia_code_[Iblock];
-                Ibc = Ivec->Ib_code_[Iblock];
-                Inas = Ivec->Ia_size_[Iblock];
-                Inbs = Ivec->Ib_size_[Iblock];
-                if (Inas == 0 || Inbs == 0) continue;
-                for (Jblock = 0; Jblock < Jvec->num_blocks_; Jblock++) {
-                    Jac = Jvec->Ia_code_[Jblock];
-                    Jbc = Jvec->Ib_code_[Jblock];
-                    Jnas = Jvec->Ia_size_[Jblock];
-                    Jnbs = Jvec->Ib_size_[Jblock];
-                    if (s1_contrib_[Iblock][Jblock] || s2_contrib_[Iblock][Jblock] || s3_contrib_[Iblock][Jblock])
-                        tpdm_block(alplist_, betlist_, CalcInfo_->num_ci_orbs, Ivec->num_alpcodes_, Ivec->num_betcodes_,
-                                   tpdm_aap, tpdm_bbp, tpdm_abp, Jvec->blocks_[Jblock], Ivec->blocks_[Iblock], Jac, Jbc,
-                                   Jnas, Jnbs, Iac, Ibc, Inas, Inbs, weight);
-                }
-            } /* end loop over Iblock */
-        }     /* end loop over roots */
-    }         /* end icore==1 */
+        if (!tpdm_incore(Ivec, Jvec, states_vec, tpdm_aap, tpdm_bbp, tpdm_abp)) {
+            /* the copies of the roots do not fit: one state at a time */
+            for (size_t root_idx = 0; root_idx < states_vec.size(); root_idx++) {
+                int Iroot = std::get<0>(states_vec[root_idx]);
+                int Jroot = std::get<1>(states_vec[root_idx]);
+                double weight = std::get<2>(states_vec[root_idx]);
+
+                Ivec->read(Iroot, 0);
+                Jvec->read(Jroot, 0);
+                for (Iblock = 0; Iblock < Ivec->num_blocks_; Iblock++) {
+                    Iac = Ivec->Ia_code_[Iblock];
+                    Ibc = Ivec->Ib_code_[Iblock];
+                    Inas = Ivec->Ia_size_[Iblock];
+                    Inbs = Ivec->Ib_size_[Iblock];
+                    if (Inas == 0 || Inbs == 0) continue;
+                    for (Jblock = 0; Jblock < Jvec->num_blocks_; Jblock++) {
+                        Jac = Jvec->Ia_code_[Jblock];
+                        Jbc = Jvec->Ib_code_[Jblock];
+                        Jnas = Jvec->Ia_size_[Jblock];
+                        Jnbs = Jvec->Ib_size_[Jblock];
+                        if (s1_contrib_[Iblock][Jblock] || s2_contrib_[Iblock][Jblock] || s3_contrib_[Iblock][Jblock])
+                            tpdm_block(alplist_, betlist_, CalcInfo_->num_ci_orbs, Ivec->num_alpcodes_,
+                                       Ivec->num_betcodes_, tpdm_aap, tpdm_bbp, tpdm_abp, Jvec->blocks_[Jblock],
+                                       Ivec->blocks_[Iblock], Jac, Jbc, Jnas, Jnbs, Iac, Ibc, Inas, Inbs, weight);
+                    }
+                } /* end loop over Iblock */
+            }     /* end loop over roots */
+        }
+    } /* end icore==1 */
 
     else if (Parameters_->icore == 2) { /* icore==2 */
         for (int root_idx = 0; root_idx < states_vec.size(); root_idx++) {
@@ -447,7 +460,6 @@ void CIWavefunction::tpdm_block(struct stringwr **alplist, struct stringwr **bet
 
     double cutoff = 1.e-14;
 
-    timer_on("CIWave: TPDM Block");
     /* loop over Ia in Ia_list */
     if (Ia_list == Ja_list) {
         for (Ia_idx = 0; Ia_idx < Inas; Ia_idx++) {
@@ -607,7 +619,102 @@ void CIWavefunction::tpdm_block(struct stringwr **alplist, struct stringwr **bet
             } /* end loop over Jb */
         }     /* end loop over Ja_ex */
     }         /* end loop over Ja */
-    timer_off("CIWave: TPDM Block");
+}
+
+/*
+** tpdm_incore(): The icore=1 TPDM. Every root in states_vec is held in core at once, so the
+** coupled block pairs are visited in a single pass for all (Iroot, Jroot, weight) and are split
+** over the threads. Each thread sums into its own aa/bb/ab arrays (thread 0 into the result),
+** which are added up at the end; there are only as many threads as such arrays fit in memory.
+** Returns false, doing nothing, if the copies of the roots do not fit.
+*/
+bool CIWavefunction::tpdm_incore(SharedCIVector Ivec, SharedCIVector Jvec,
+                                 const std::vector<std::tuple<int, int, double> > &states_vec, double *tpdm_aa,
+                                 double *tpdm_bb, double *tpdm_ab) {
+    const int nact = CalcInfo_->num_ci_orbs;
+    const size_t nact2 = (size_t)nact * nact;
+    const size_t ntri2 = (nact2 * (nact2 + 1)) / 2;
+    const size_t nab = nact2 * nact2;
+
+    std::vector<int> Iroots, Jroots, Istate, Jstate;
+    for (const auto &state : states_vec) {
+        Iroots.push_back(std::get<0>(state));
+        Jroots.push_back(std::get<1>(state));
+    }
+    std::vector<std::pair<int, int> > copies = incore_root_copies(Ivec, Jvec, Iroots, Jroots, Istate, Jstate);
+
+    std::vector<std::pair<int, int> > pairs;
+    for (int Iblock = 0; Iblock < Ivec->num_blocks_; Iblock++) {
+        if (Ivec->Ia_size_[Iblock] == 0 || Ivec->Ib_size_[Iblock] == 0) continue;
+        for (int Jblock = 0; Jblock < Jvec->num_blocks_; Jblock++) {
+            if (Jvec->Ia_size_[Jblock] == 0 || Jvec->Ib_size_[Jblock] == 0) continue;
+            if (s1_contrib_[Iblock][Jblock] || s2_contrib_[Iblock][Jblock] || s3_contrib_[Iblock][Jblock])
+                pairs.emplace_back(Iblock, Jblock);
+        }
+    }
+
+    MemoryGrant grant("DETCI TPDM scratch");
+    int nthread = incore_density_threads(grant, copies.size() * Ivec->vectlen_ * sizeof(double),
+                                         (2 * ntri2 + nab) * sizeof(double),
+                                         std::max(1, std::min(Parameters_->nthreads, (int)pairs.size())));
+    if (!nthread) return false;
+
+    std::vector<std::vector<double> > data;
+    std::vector<std::vector<std::vector<double *> > > rows;
+    read_incore_roots(Ivec, Jvec, copies, data, rows);
+
+    std::vector<std::vector<double> > partial(nthread - 1);
+
+#pragma omp parallel num_threads(nthread) if (nthread > 1)
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double *aa = tpdm_aa;
+        double *bb = tpdm_bb;
+        double *ab = tpdm_ab;
+        if (thread) {
+            partial[thread - 1].assign(2 * ntri2 + nab, 0.0);
+            aa = partial[thread - 1].data();
+            bb = aa + ntri2;
+            ab = bb + ntri2;
+        }
+
+#pragma omp for schedule(dynamic, 1)
+        for (size_t pair = 0; pair < pairs.size(); pair++) {
+            int Iblock = pairs[pair].first;
+            int Jblock = pairs[pair].second;
+            int Iac = Ivec->Ia_code_[Iblock];
+            int Ibc = Ivec->Ib_code_[Iblock];
+            int Inas = Ivec->Ia_size_[Iblock];
+            int Inbs = Ivec->Ib_size_[Iblock];
+            int Jac = Jvec->Ia_code_[Jblock];
+            int Jbc = Jvec->Ib_code_[Jblock];
+            int Jnas = Jvec->Ia_size_[Jblock];
+            int Jnbs = Jvec->Ib_size_[Jblock];
+
+            for (size_t state = 0; state < states_vec.size(); state++) {
+                tpdm_block(alplist_, betlist_, nact, Ivec->num_alpcodes_, Ivec->num_betcodes_, aa, bb, ab,
+                           rows[Jstate[state]][Jblock].data(), rows[Istate[state]][Iblock].data(), Jac, Jbc, Jnas,
+                           Jnbs, Iac, Ibc, Inas, Inbs, std::get<2>(states_vec[state]));
+            }
+        }
+    }
+
+    for (const auto &buf : partial) {
+        const double *aa = buf.data();
+        const double *bb = aa + ntri2;
+        const double *ab = bb + ntri2;
+#pragma omp parallel for schedule(static) num_threads(nthread)
+        for (size_t pqrs = 0; pqrs < ntri2; pqrs++) {
+            tpdm_aa[pqrs] += aa[pqrs];
+            tpdm_bb[pqrs] += bb[pqrs];
+        }
+#pragma omp parallel for schedule(static) num_threads(nthread)
+        for (size_t pqrs = 0; pqrs < nab; pqrs++) tpdm_ab[pqrs] += ab[pqrs];
+    }
+    return true;
 }
 }
 }  // namespace psi
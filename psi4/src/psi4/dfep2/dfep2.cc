@@ -51,6 +51,57 @@
 namespace psi {
 namespace dfep2 {
 
+namespace {
+
+// Replaces the integrals I[o * npair + q][p * nE + e] of a block of nouter outer orbitals by the
+// self-energy numerators (2 I_pq - I_qp) * I_pq, where I_qp = I[o * npair + p][q * nE + e]
+void form_numerators(double** I, size_t nouter, size_t npair, size_t nE, size_t nthread) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t op = 0; op < nouter * npair; op++) {
+        size_t o = op / npair;
+        size_t p = op % npair;
+        for (size_t q = p; q < npair; q++) {
+            double* Ipq = I[o * npair + q] + p * nE;
+            double* Iqp = I[o * npair + p] + q * nE;
+            for (size_t e = 0; e < nE; e++) {
+                double pq = Ipq[e];
+                double qp = Iqp[e];
+                Ipq[e] = (2.0 * pq - qp) * pq;
+                Iqp[e] = (2.0 * qp - pq) * qp;
+            }
+        }
+    }
+}
+
+// Adds the numerators N of a block to the self-energy and its derivative of each solve orbital e, with
+// the denominators denom_E[e] - eps_pair[p] - eps_pair[q] + eps_outer[o]
+void accumulate_sigma(double** N, size_t nouter, size_t npair, size_t nE, const double* eps_outer,
+                      const double* eps_pair, const std::vector<double>& denom_E,
+                      std::vector<std::vector<double>>& sigma_temps, std::vector<std::vector<double>>& deriv_temps,
+                      size_t nthread) {
+#pragma omp parallel for schedule(static) num_threads(nthread)
+    for (size_t oq = 0; oq < nouter * npair; oq++) {
+        size_t rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        double* sigma = sigma_temps[rank].data();
+        double* deriv = deriv_temps[rank].data();
+        double shift = eps_outer[oq / npair] - eps_pair[oq % npair];
+        for (size_t p = 0; p < npair; p++) {
+            const double* Np = N[oq] + p * nE;
+            double pshift = shift - eps_pair[p];
+            for (size_t e = 0; e < nE; e++) {
+                double denom = denom_E[e] + pshift;
+                sigma[e] += Np[e] / denom;
+                deriv[e] += Np[e] / (denom * denom);
+            }
+        }
+    }
+}
+
+}  // namespace
+
 DFEP2Wavefunction::DFEP2Wavefunction(std::shared_ptr<Wavefunction> ref_wfn)
     : Wavefunction(Process::environment.options) {
     // Copy the wavefuntion then update
@@ -218,19 +269,26 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
 
     // ==> Build ERI's <== /
 
-    std::shared_ptr<PSIO> psio = PSIO::shared_object();
-    auto aio = std::make_shared<AIOHandler>(psio);
-
-    psio->open(unit_, PSIO_OPEN_OLD);
-
-    aio->zero_disk(unit_, "EP2 I_ovvE Integrals", (size_t)(nocc * nvir), (size_t)(nvir * nE));
-    aio->zero_disk(unit_, "EP2 I_vooE Integrals", (size_t)(nocc * nvir), (size_t)(nocc * nE));
-    aio->synchronize();
+    // The numerators of the self-energy, (2 Eabi - Ebai) * Eabi and (2 Eija - Ejia) * Eija, are the same
+    // at every Newton step. They overwrite the integrals in the first iteration and are kept in core when
+    // they fit, so that later iterations never touch the disk.
+    size_t ovvE_size = nocc * nvir * nvir * nE;
+    size_t vooE_size = nvir * nocc * nocc * nE;
 
     // How much memory are we working with?
     size_t E_tensor_size = nE * nvir * nQ + nE * nocc * nQ;
     size_t I_block_sizes = nvir * nvir * nE + nocc * nvir * nE + nvir * nQ;
-    size_t free_doubles = memory_doubles_ - E_tensor_size;
+    if (E_tensor_size + I_block_sizes > memory_doubles_) {
+        std::stringstream message;
+        double mem_gb = ((double)(E_tensor_size + I_block_sizes) / 1.e10);
+        message << "DF-EP2 requires at least is nvir^2 * number solve orbitals in memory." << std::endl;
+        message << "       After taxes this is " << std::setprecision(2) << mem_gb << " GB of memory.";
+
+        throw PSIEXCEPTION(message.str());
+    }
+
+    bool incore = (E_tensor_size + I_block_sizes + ovvE_size + vooE_size <= memory_doubles_);
+    size_t free_doubles = memory_doubles_ - E_tensor_size - (incore ? ovvE_size + vooE_size : 0);
 
     size_t block_size = free_doubles / I_block_sizes;
     if (block_size > nocc) block_size = nocc;
@@ -246,16 +304,24 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
         outfile->Printf("I_block_sizes   %zu\n", I_block_sizes);
         outfile->Printf("Block size      %zu\n", block_size);
         outfile->Printf("N Block         %zu\n", nblocks);
+        outfile->Printf("Incore          %d\n", (int)incore);
         outfile->Printf("\n\n");
     }
 
-    if (block_size < 1) {
-        std::stringstream message;
-        double mem_gb = ((double)(E_tensor_size + I_block_sizes) / 1.e10);
-        message << "DF-EP2 requires at least is nvir^2 * number solve orbitals in memory." << std::endl;
-        message << "       After taxes this is " << std::setprecision(2) << mem_gb << " GB of memory.";
-
-        throw PSIEXCEPTION(message.str());
+    std::shared_ptr<PSIO> psio = PSIO::shared_object();
+    SharedMatrix I_ovvE;
+    SharedMatrix I_vooE;
+    if (incore) {
+        I_ovvE = std::make_shared<Matrix>("I_ovvE", nocc * nvir, nvir * nE);
+        I_vooE = std::make_shared<Matrix>("I_vooE", nvir * nocc, nocc * nE);
+    } else {
+        auto aio = std::make_shared<AIOHandler>(psio);
+
+        psio->open(unit_, PSIO_OPEN_OLD);
+
+        aio->zero_disk(unit_, "EP2 I_ovvE Integrals", (size_t)(nocc * nvir), (size_t)(nvir * nE));
+        aio->zero_disk(unit_, "EP2 I_vooE Integrals", (size_t)(nocc * nvir), (size_t)(nocc * nE));
+        aio->synchronize();
     }
 
     // Read in part of the tensors
@@ -269,11 +335,11 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
 
     // Allocate temps
     auto block_iaQ = std::make_shared<Matrix>(block_size * nvir, nQ);
-    auto temp_ovvE = std::make_shared<Matrix>(block_size * nvir, nvir * nE);
     auto temp_ovoE = std::make_shared<Matrix>(block_size * nvir, nocc * nE);
+    SharedMatrix temp_ovvE;
+    if (!incore) temp_ovvE = std::make_shared<Matrix>(block_size * nvir, nvir * nE);
 
     psio_address ovvE_addr = psio_get_address(PSIO_ZERO, 0);
-    psio_address ovoE_addr = psio_get_address(PSIO_ZERO, 0);
     psio_address vooE_addr = psio_get_address(PSIO_ZERO, 0);
 
     for (size_t block = 0; block < nblocks; block++) {
@@ -288,20 +354,28 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
         // Read a IA block
         dfh_->fill_tensor("iaQ", block_iaQ, {bstart, bstart + block_size});
 
-        // Write out OVVE
-        temp_ovvE->gemm(false, true, 1.0, block_iaQ, aEQ, 0.0);
-        psio_->write(unit_, "EP2 I_ovvE Integrals", (char*)temp_ovvE->pointer()[0],
-                     sizeof(double) * block_size * nvir * nvir * nE, ovvE_addr, &ovvE_addr);
+        // Form OVVE, in place when in core
+        double* ovvEp = (incore ? I_ovvE->pointer()[bstart * nvir] : temp_ovvE->pointer()[0]);
+        C_DGEMM('N', 'T', block_size * nvir, nvir * nE, nQ, 1.0, block_iaQ->pointer()[0], nQ, aEQp, nQ, 0.0, ovvEp,
+                nvir * nE);
+        if (!incore) {
+            psio_->write(unit_, "EP2 I_ovvE Integrals", (char*)ovvEp, sizeof(double) * block_size * nvir * nvir * nE,
+                         ovvE_addr, &ovvE_addr);
+        }
 
-        // Write out VOOE
+        // Form VOOE
         temp_ovoE->gemm(false, true, 1.0, block_iaQ, iEQ, 0.0);
         double** temp_ovoEp = temp_ovoE->pointer();
         for (size_t a = 0; a < nvir; a++) {
             size_t local_i = 0;
             for (size_t i = bstart; i < bstart + block_size; i++) {
-                psio_address vooE_addr = psio_get_address(PSIO_ZERO, sizeof(double) * (a * nocc + i) * nocc * nE);
-                psio_->write(unit_, "EP2 I_vooE Integrals", (char*)temp_ovoEp[local_i * nvir + a],
-                             sizeof(double) * nocc * nE, vooE_addr, &vooE_addr);
+                if (incore) {
+                    C_DCOPY(nocc * nE, temp_ovoEp[local_i * nvir + a], 1, I_vooE->pointer()[a * nocc + i], 1);
+                } else {
+                    vooE_addr = psio_get_address(PSIO_ZERO, sizeof(double) * (a * nocc + i) * nocc * nE);
+                    psio_->write(unit_, "EP2 I_vooE Integrals", (char*)temp_ovoEp[local_i * nvir + a],
+                                 sizeof(double) * nocc * nE, vooE_addr, &vooE_addr);
+                }
                 local_i++;
             }
         }
@@ -315,12 +389,13 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
 
     // ==> More Sizing <== /
 
-    size_t aaE_size = memory_doubles_ / nvir * nvir * nE;
-    if (aaE_size > nocc) aaE_size = nocc;
+    size_t aaE_size = nocc;
+    size_t ooE_size = nvir;
+    if (!incore) {
+        aaE_size = std::max((size_t)1, std::min(nocc, memory_doubles_ / (nvir * nvir * nE)));
+        ooE_size = std::max((size_t)1, std::min(nvir, memory_doubles_ / (nocc * nocc * nE)));
+    }
     // aaE_size = 2;
-
-    size_t ooE_size = memory_doubles_ / nocc * nocc * nE;
-    if (ooE_size > nvir) ooE_size = nvir;
     // ooE_size = 2;
 
     size_t aaE_nblocks = 1 + ((nocc - 1) / aaE_size);
@@ -349,7 +424,6 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
     // thread info
     std::vector<std::vector<double>> deriv_temps(num_threads_, std::vector<double>(nE));
     std::vector<std::vector<double>> sigma_temps(num_threads_, std::vector<double>(nE));
-    size_t rank = 0;
 
     for (size_t iter = 0; iter < max_iter_; iter++) {
         // Reset data for loop
@@ -364,11 +438,11 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
         }
 
         // => Excitations <= //
-        // sigma <= (Eabi - Ebai) * Eabi / (E - v - v + o)
+        // sigma <= (2 Eabi - Ebai) * Eabi / (E - v - v + o)
 
         ovvE_addr = psio_get_address(PSIO_ZERO, 0);
-        auto I_ovvE = std::make_shared<Matrix>(aaE_size * nvir, nvir * nE);
-        double** I_ovvEp = I_ovvE->pointer();
+        SharedMatrix N_ovvE = (incore ? I_ovvE : std::make_shared<Matrix>(aaE_size * nvir, nvir * nE));
+        double** N_ovvEp = N_ovvE->pointer();
 
         for (size_t i_block = 0; i_block < aaE_nblocks; i_block++) {
             size_t i_start = aaE_size * i_block;
@@ -377,37 +451,29 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
                 ib_size = nocc - i_start;
             }
 
-            psio_->read(unit_, "EP2 I_ovvE Integrals", (char*)I_ovvEp[0], (sizeof(double) * ib_size * nvir * nvir * nE),
-                        ovvE_addr, &ovvE_addr);
-
-#pragma omp parallel for private(rank) schedule(dynamic, 1) collapse(2) num_threads(num_threads_)
-            for (size_t i = 0; i < ib_size; i++) {
-                for (size_t a = 0; a < nvir; a++) {
-#ifdef _OPENMP
-                    rank = omp_get_thread_num();
-#endif
-                    for (size_t b = 0; b < nvir; b++) {
-                        for (size_t e = 0; e < nE; e++) {
-                            double Eabi = I_ovvEp[i * nvir + b][a * nE + e];
-                            double Ebai = I_ovvEp[i * nvir + a][b * nE + e];
-                            double numer = (2.0 * Eabi - Ebai) * Eabi;
-                            double denom = (denom_E[e] - eps_vir[a] - eps_vir[b] + eps_occ[i_start + i]);
-
-                            sigma_temps[rank][e] += numer / denom;
-                            deriv_temps[rank][e] += numer / (denom * denom);
-                        }
-                    }
+            if (!incore) {
+                psio_address start = ovvE_addr;
+                size_t nbytes = sizeof(double) * ib_size * nvir * nvir * nE;
+                psio_->read(unit_, "EP2 I_ovvE Integrals", (char*)N_ovvEp[0], nbytes, ovvE_addr, &ovvE_addr);
+                if (iter == 0) {
+                    form_numerators(N_ovvEp, ib_size, nvir, nE, num_threads_);
+                    psio_->write(unit_, "EP2 I_ovvE Integrals", (char*)N_ovvEp[0], nbytes, start, &start);
                 }
+            } else if (iter == 0) {
+                form_numerators(N_ovvEp, nocc, nvir, nE, num_threads_);
             }
+
+            accumulate_sigma(N_ovvEp, ib_size, nvir, nE, eps_occ.data() + i_start, eps_vir.data(), denom_E, sigma_temps,
+                             deriv_temps, num_threads_);
         }
-        I_ovvE.reset();
+        N_ovvE.reset();
 
         // => De-excitations <= //
-        // sigma <= (Eija - Ejia) * Eija / (E - o - o + v)
+        // sigma <= (2 Eija - Ejia) * Eija / (E - o - o + v)
 
         vooE_addr = psio_get_address(PSIO_ZERO, 0);
-        auto I_vooE = std::make_shared<Matrix>(ooE_size * nocc, nocc * nE);
-        double** I_vooEp = I_vooE->pointer();
+        SharedMatrix N_vooE = (incore ? I_vooE : std::make_shared<Matrix>(ooE_size * nocc, nocc * nE));
+        double** N_vooEp = N_vooE->pointer();
 
         for (size_t a_block = 0; a_block < ooE_nblocks; a_block++) {
             size_t a_start = ooE_size * a_block;
@@ -416,30 +482,22 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
                 ab_size = nvir - a_start;
             }
 
-            psio_->read(unit_, "EP2 I_vooE Integrals", (char*)I_vooEp[0], sizeof(double) * ab_size * nocc * nocc * nE,
-                        vooE_addr, &vooE_addr);
-
-#pragma omp parallel for private(rank) schedule(dynamic, 1) collapse(2) num_threads(num_threads_)
-            for (size_t a = 0; a < ab_size; a++) {
-                for (size_t i = 0; i < nocc; i++) {
-#ifdef _OPENMP
-                    rank = omp_get_thread_num();
-#endif
-                    for (size_t j = 0; j < nocc; j++) {
-                        for (size_t e = 0; e < nE; e++) {
-                            double Eija = I_vooEp[a * nocc + j][i * nE + e];
-                            double Ejia = I_vooEp[a * nocc + i][j * nE + e];
-                            double numer = (2.0 * Eija - Ejia) * Eija;
-                            double denom = (denom_E[e] - eps_occ[i] - eps_occ[j] + eps_vir[a_start + a]);
-
-                            sigma_temps[rank][e] += numer / denom;
-                            deriv_temps[rank][e] += numer / (denom * denom);
-                        }
-                    }
+            if (!incore) {
+                psio_address start = vooE_addr;
+                size_t nbytes = sizeof(double) * ab_size * nocc * nocc * nE;
+                psio_->read(unit_, "EP2 I_vooE Integrals", (char*)N_vooEp[0], nbytes, vooE_addr, &vooE_addr);
+                if (iter == 0) {
+                    form_numerators(N_vooEp, ab_size, nocc, nE, num_threads_);
+                    psio_->write(unit_, "EP2 I_vooE Integrals", (char*)N_vooEp[0], nbytes, start, &start);
                 }
+            } else if (iter == 0) {
+                form_numerators(N_vooEp, nvir, nocc, nE, num_threads_);
             }
+
+            accumulate_sigma(N_vooEp, ab_size, nocc, nE, eps_vir.data() + a_start, eps_occ.data(), denom_E, sigma_temps,
+                             deriv_temps, num_threads_);
         }
-        I_vooE.reset();
+        N_vooE.reset();
 
         // Sum up thread data
         for (size_t i = 0; i < nE; i++) {
@@ -487,7 +545,9 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
         // printf("\n");
     }
     outfile->Printf("   --------------------------------------------\n\n");
-    psio->close(unit_, 0);
+    I_ovvE.reset();
+    I_vooE.reset();
+    if (!incore) psio->close(unit_, 0);
 
     // Build output array and remap symmetry
     std::vector<std::vector<std::pair<double, double>>> ret;
@@ -0,0 +1,318 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "psi4/psi4-dec.h"
+
+#include "psi4/lib3index/3index.h"
+#include "psi4/lib3index/dfhelper.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+
+#include "mp2.h"
+
+namespace psi {
+namespace dfmp2 {
+
+RLaplaceDFMP2::RLaplaceDFMP2(SharedWavefunction ref_wfn, Options& options, std::shared_ptr<PSIO> psio)
+    : RDFMP2(ref_wfn, options, psio) {
+    name_ = "LT-DF-MP2";
+    laplace_delta_ = options_.get_double("DFMP2_LAPLACE_DELTA");
+    cholesky_tol_ = options_.get_double("DFMP2_LAPLACE_CHOLESKY_TOLERANCE");
+    pair_tol_ = options_.get_double("DFMP2_LAPLACE_PAIR_TOLERANCE");
+    os_only_ = options_.get_bool("DFMP2_LAPLACE_OS_ONLY");
+    if (os_only_ && sss_ != 0.0) {
+        throw PSIEXCEPTION("DFMP2: DFMP2_LAPLACE_OS_ONLY requires MP2_SS_SCALE = 0");
+    }
+}
+RLaplaceDFMP2::~RLaplaceDFMP2() {}
+void RLaplaceDFMP2::print_header() {
+    RDFMP2::print_header();
+
+    outfile->Printf("   => Laplace Transformation <=\n\n");
+    outfile->Printf("    Quadrature Delta      = %11.3E\n", laplace_delta_);
+    outfile->Printf("    Cholesky Tolerance    = %11.3E\n", cholesky_tol_);
+    outfile->Printf("    Pair Tolerance        = %11.3E\n", pair_tol_);
+    outfile->Printf("    Opposite-Spin Only    = %11s\n\n", (os_only_ ? "TRUE" : "FALSE"));
+}
+void RLaplaceDFMP2::print_energies() {
+    if (!os_only_) {
+        DFMP2::print_energies();
+        return;
+    }
+
+    // Without the exchange-like term only the (custom) SOS-MP2 energy is defined
+    variables_["CUSTOM SCS-MP2 CORRELATION ENERGY"] = oss_ * variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] +
+                                                      variables_["MP2 SINGLES ENERGY"];
+    variables_["CUSTOM SCS-MP2 TOTAL ENERGY"] = variables_["SCF TOTAL ENERGY"] + variables_["CUSTOM SCS-MP2 CORRELATION ENERGY"];
+
+    outfile->Printf("\t-----------------------------------------------------------\n");
+    outfile->Printf("\t ===============> DF-SOS-MP2 Energies <=================== \n");
+    outfile->Printf("\t-----------------------------------------------------------\n");
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "Reference Energy", variables_["SCF TOTAL ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "Singles Energy", variables_["MP2 SINGLES ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "Opposite-Spin Energy",
+                    variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [-]\n", "SOS Opposite-Spin Scale", oss_);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "SOS Correlation Energy",
+                    variables_["CUSTOM SCS-MP2 CORRELATION ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "SOS Total Energy", variables_["CUSTOM SCS-MP2 TOTAL ENERGY"]);
+    outfile->Printf("\t-----------------------------------------------------------\n");
+    outfile->Printf("\n");
+}
+SharedMatrix RLaplaceDFMP2::compute_gradient() {
+    throw PSIEXCEPTION("DFMP2: Gradients are not available with DFMP2_LAPLACE");
+}
+void RLaplaceDFMP2::form_Aia() {
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+
+    // One budget for the whole energy: the quadrature loop keeps enough for one occupied row at full
+    // rank, and DFHelper gets the rest for the in-core AOs and the transformation blocking
+    size_t doubles = ((size_t)(options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
+    size_t nocc = Caocc_->colspi()[0];
+    size_t nvir = Cavir_->colspi()[0];
+    size_t quadrature_min = quadrature_memory(nocc, nvir, 1, nthread);
+    if (doubles < quadrature_min) {
+        throw PSIEXCEPTION("DFMP2: Insufficient memory for Iab buffers. Reduce OMP Threads or increase memory.");
+    }
+
+    // The screened (A|mn) are built once, each quadrature point only transforms them
+    dfh_ = std::make_shared<DFHelper>(basisset_, ribasis_);
+    dfh_->set_method("STORE");
+    dfh_->set_nthreads(nthread);
+    dfh_->set_memory(doubles - quadrature_min);
+    if (options_.get_double("INTS_TOLERANCE") > 0.0) dfh_->set_schwarz_cutoff(options_.get_double("INTS_TOLERANCE"));
+    dfh_->set_print_lvl(print_ > 1 ? 1 : 0);
+    dfh_->initialize();
+}
+size_t RLaplaceDFMP2::quadrature_memory(size_t no, size_t nv, size_t max_i, int nthread) const {
+    size_t naux = ribasis_->nbf();
+    // Iab per thread, Z, the pair estimates, and the B(i|Qa) and B(j|Qb) blocks
+    return nthread * nv * nv + naux * naux + no * nv + (os_only_ ? 1L : 2L) * max_i * naux * nv;
+}
+void RLaplaceDFMP2::form_Bia() {
+    // J^-1/2 is applied by DFHelper as part of each transformation
+}
+void RLaplaceDFMP2::form_Bia_Cia() { throw PSIEXCEPTION("DFMP2: Gradients are not available with DFMP2_LAPLACE"); }
+SharedMatrix RLaplaceDFMP2::pseudo_density_factor(SharedMatrix C, const double* d, const std::string& name) {
+    size_t nbf = C->rowspi()[0];
+    size_t nmo = C->colspi()[0];
+    double** Cp = C->pointer();
+
+    // X_mn = C_mi d_i C_ni
+    auto Cd = C->clone();
+    double** Cdp = Cd->pointer();
+    for (size_t m = 0; m < nbf; m++) {
+        for (size_t i = 0; i < nmo; i++) {
+            Cdp[m][i] *= d[i];
+        }
+    }
+    auto X = std::make_shared<Matrix>(name, nbf, nbf);
+    C_DGEMM('N', 'T', nbf, nbf, nmo, 1.0, Cdp[0], nmo, Cp[0], nmo, 0.0, X->pointer()[0], nbf);
+
+    double Xmax = 0.0;
+    for (size_t m = 0; m < nbf; m++) Xmax = std::max(Xmax, X->get(m, m));
+
+    // Pivoted Cholesky X = L^T L, the pivot order makes the rows of L local
+    CholeskyMatrix chol(X, cholesky_tol_ * Xmax, memory_ / 8L);
+    chol.choleskify();
+    auto L = chol.L();
+    L->set_name(name);
+
+    return L->transpose();
+}
+void RLaplaceDFMP2::form_energy() {
+    // Energy registers
+    double e_J = 0.0;
+    double e_K = 0.0;
+
+    // Sizing
+    size_t naux = ribasis_->nbf();
+
+    // Thread considerations
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+
+    // 1/(e_a + e_b - e_i - e_j) = \sum_w d_i^w d_a^w d_j^w d_b^w
+    auto denom = std::make_shared<LaplaceDenominator>(eps_aocc_, eps_avir_, laplace_delta_);
+    SharedMatrix tau_occ = denom->denominator_occ();
+    SharedMatrix tau_vir = denom->denominator_vir();
+    int nw = denom->nvector();
+
+    // ~(ia|jb) = (ia|jb) sqrt(d_i d_a d_j d_b) over the factors of the pseudo-densities,
+    // then J = \sum ~(ia|jb)^2 and K = \sum ~(ia|jb) ~(ib|ja) are invariant to the rotation
+    for (int w = 0; w < nw; w++) {
+        SharedMatrix Lo = pseudo_density_factor(Caocc_, tau_occ->pointer()[w], "Occupied Pseudo-Density Factor");
+        SharedMatrix Lv = pseudo_density_factor(Cavir_, tau_vir->pointer()[w], "Virtual Pseudo-Density Factor");
+        size_t no = Lo->colspi()[0];
+        size_t nv = Lv->colspi()[0];
+        if (!no || !nv) continue;
+
+        dfh_->clear_spaces();
+        dfh_->clear_transformations();
+        dfh_->add_space("o", Lo);
+        dfh_->add_space("v", Lv);
+        dfh_->add_transformation("B", "o", "v", "pQq");
+        dfh_->transform();
+
+        // Memory: what DFHelper holds across the quadrature (the in-core AOs and the metric) comes out
+        // of the same budget; form_Aia left at least one occupied row for the blocks
+        size_t Qa_memory = naux * nv;
+        size_t doubles = ((size_t)(options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
+        size_t held = naux * naux + (dfh_->get_AO_core() ? dfh_->get_AO_size() : 0L);
+        size_t fixed = quadrature_memory(no, nv, 0, nthread);
+        size_t remainder = (doubles > held + fixed ? doubles - held - fixed : 0L);
+        size_t max_i = remainder / ((os_only_ ? 1L : 2L) * Qa_memory);
+        max_i = (max_i > no ? no : max_i);
+        max_i = (max_i < 1L ? 1L : max_i);
+
+        // Blocks
+        std::vector<size_t> i_starts;
+        i_starts.push_back(0L);
+        for (size_t i = 0; i < no; i += max_i) {
+            if (i + max_i >= no) {
+                i_starts.push_back(no);
+            } else {
+                i_starts.push_back(i + max_i);
+            }
+        }
+
+        // Pair estimates |~(ia|jb)| <= s_ia s_jb, s_ia = sqrt(~(ia|ia))
+        auto S = std::make_shared<Matrix>("Pair Estimates", no, nv);
+        double** Sp = S->pointer();
+
+        // Tensor blocks
+        auto Bia = std::make_shared<Matrix>("B(i|Qa)", max_i, naux * nv);
+        auto Bjb = std::make_shared<Matrix>("B(j|Qb)", (os_only_ ? 0 : max_i), naux * nv);
+        auto Z = std::make_shared<Matrix>("Z(Q|R)", naux, naux);
+        double** Biap = Bia->pointer();
+        double** Bjbp = Bjb->pointer();
+        double** Zp = Z->pointer();
+
+        std::vector<SharedMatrix> Iab;
+        for (int i = 0; i < nthread; i++) {
+            Iab.push_back(std::make_shared<Matrix>("Iab", nv, nv));
+        }
+
+        // Estimates for all pairs before any screening
+        for (size_t block_i = 0; !os_only_ && block_i < i_starts.size() - 1; block_i++) {
+            size_t istart = i_starts[block_i];
+            size_t istop = i_starts[block_i + 1];
+            dfh_->fill_tensor("B", Biap[0], {istart, istop});
+            for (size_t i = istart; i < istop; i++) {
+                double* Bp = Biap[i - istart];
+                for (size_t a = 0; a < nv; a++) {
+                    Sp[i][a] = std::sqrt(C_DDOT(naux, &Bp[a], nv, &Bp[a], nv));
+                }
+            }
+        }
+
+        // Loop through pairs of blocks
+        for (size_t block_i = 0; block_i < i_starts.size() - 1; block_i++) {
+            size_t istart = i_starts[block_i];
+            size_t istop = i_starts[block_i + 1];
+            size_t ni = istop - istart;
+            dfh_->fill_tensor("B", Biap[0], {istart, istop});
+
+            // Z_QR = \sum_ia ~B_ia^Q ~B_ia^R
+            for (size_t i = 0; i < ni; i++) {
+                C_DGEMM('N', 'T', naux, naux, nv, 1.0, Biap[i], nv, Biap[i], nv, 1.0, Zp[0], naux);
+            }
+
+            // The exchange-like term is the only fifth-order step, skipped for SOS-MP2
+            for (size_t block_j = 0; !os_only_ && block_j <= block_i; block_j++) {
+                size_t jstart = i_starts[block_j];
+                size_t jstop = i_starts[block_j + 1];
+                size_t nj = jstop - jstart;
+
+                if (block_i == block_j) {
+                    ::memcpy((void*)Bjbp[0], (void*)Biap[0], sizeof(double) * (ni * naux * nv));
+                } else {
+                    dfh_->fill_tensor("B", Bjbp[0], {jstart, jstop});
+                }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread) reduction(+ : e_K)
+                for (long int ij = 0L; ij < ni * nj; ij++) {
+                    size_t i = ij / nj + istart;
+                    size_t j = ij % nj + jstart;
+                    if (j > i) continue;
+
+                    // \sum_ab |~(ia|jb) ~(ib|ja)| <= (\sum_a s_ia s_ja)^2
+                    double bound = C_DDOT(nv, Sp[i], 1, Sp[j], 1);
+                    if (bound * bound < pair_tol_) continue;
+
+                    double perm_factor = (i == j ? 1.0 : 2.0);
+
+                    int thread = 0;
+#ifdef _OPENMP
+                    thread = omp_get_thread_num();
+#endif
+                    double** Iabp = Iab[thread]->pointer();
+
+                    // ~(ia|jb) = ~B_ia^Q ~B_jb^Q
+                    C_DGEMM('T', 'N', nv, nv, naux, 1.0, Biap[i - istart], nv, Bjbp[j - jstart], nv, 0.0, Iabp[0], nv);
+
+                    double Kij = 0.0;
+                    for (size_t a = 0; a < nv; a++) {
+                        for (size_t b = 0; b < nv; b++) {
+                            Kij += Iabp[a][b] * Iabp[b][a];
+                        }
+                    }
+                    e_K += perm_factor * Kij;
+                }
+            }
+        }
+
+        e_J += Z->vector_dot(Z);
+    }
+
+    dfh_->clear_spaces();
+    dfh_->clear_transformations();
+
+    if (!os_only_) variables_["MP2 SAME-SPIN CORRELATION ENERGY"] = -(e_J - e_K);
+    variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = -e_J;
+}
+
+}  // namespace dfmp2
+}  // namespace psi
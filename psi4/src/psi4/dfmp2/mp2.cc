@@ -50,6 +50,7 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsio/aiohandler.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libqt/qt.h"
@@ -228,9 +229,14 @@ double DFMP2::compute_energy() {
     form_energy();
     timer_off("DFMP2 Energy");
     print_energies();
-    energy_ = variables_["MP2 TOTAL ENERGY"];
+    // An opposite-spin-only energy (DFMP2_LAPLACE_OS_ONLY) defines no full MP2 energy
+    if (variables_.count("MP2 TOTAL ENERGY")) {
+        energy_ = variables_["MP2 TOTAL ENERGY"];
+    } else {
+        energy_ = variables_["CUSTOM SCS-MP2 TOTAL ENERGY"];
+    }
 
-    return variables_["MP2 TOTAL ENERGY"];
+    return energy_;
 }
 SharedMatrix DFMP2::compute_gradient() {
     print_header();
@@ -283,21 +289,13 @@ SharedMatrix DFMP2::compute_gradient() {
     form_gamma();
     timer_off("DFMP2 gamma");
 
-    timer_on("DFMP2 Gia");
-    form_G_transpose();
-    timer_off("DFMP2 Gia");
-
     timer_on("DFMP2 AB^x");
     form_AB_x_terms();
     timer_off("DFMP2 AB^x");
 
-    timer_on("DFMP2 Amn^x");
-    form_Amn_x_terms();
-    timer_off("DFMP2 Amn^x");
-
-    timer_on("DFMP2 L");
-    form_L();
-    timer_off("DFMP2 L");
+    timer_on("DFMP2 Amn^x and L");
+    form_Amn_x_terms_and_L();
+    timer_off("DFMP2 Amn^x and L");
 
     timer_on("DFMP2 P");
     form_P();
@@ -565,7 +563,7 @@ void DFMP2::apply_gamma(size_t file, size_t naux, size_t nia) {
     if (doubles < 1L * Jmem) {
         throw PSIEXCEPTION("DFMP2: More memory required for gamma");
     }
-    size_t rem = (doubles - Jmem) / 2L;
+    size_t rem = (doubles - Jmem) / 3L;
     size_t max_nia = (rem / naux);
     max_nia = (max_nia > nia ? nia : max_nia);
     max_nia = (max_nia < 1L ? 1L : max_nia);
@@ -585,13 +583,24 @@ void DFMP2::apply_gamma(size_t file, size_t naux, size_t nia) {
     // Tensor blocks
     auto Gia = std::make_shared<Matrix>("G(ia|Q)", max_nia, naux);
     auto Cia = std::make_shared<Matrix>("C(ia|Q)", max_nia, naux);
+    auto Qia = std::make_shared<Matrix>("G(Q|ia)", naux, max_nia);
     auto G = std::make_shared<Matrix>("G_PQ", naux, naux);
     double** Giap = Gia->pointer();
     double** Ciap = Cia->pointer();
+    double** Qiap = Qia->pointer();
     double** Gp = G->pointer();
 
-    // Loop through blocks
     psio_->open(file, PSIO_OPEN_OLD);
+
+    // Prestripe G(Q|ia), which is written in strided pieces below
+    psio_address next_QIA = PSIO_ZERO;
+    std::vector<double> temp(nia, 0);
+    for (int Q = 0; Q < naux; Q++) {
+        psio_->write(file, "G(Q|ia)", (char*)temp.data(), sizeof(double) * nia, next_QIA, &next_QIA);
+    }
+    std::vector<double>().swap(temp); // Dirty trick to clear temp memory immediately.
+
+    // Loop through blocks; each block of G(ia|Q) is read once for both the gamma and the transpose
     psio_address next_GIA = PSIO_ZERO;
     psio_address next_CIA = PSIO_ZERO;
     for (int block = 0; block < ia_starts.size() - 1; block++) {
@@ -615,68 +624,12 @@ void DFMP2::apply_gamma(size_t file, size_t naux, size_t nia) {
         timer_on("DFMP2 g");
         C_DGEMM('T', 'N', naux, naux, ncols, 1.0, Giap[0], naux, Ciap[0], naux, 1.0, Gp[0], naux);
         timer_off("DFMP2 g");
-    }
 
-    G->save(psio_, file, Matrix::SaveType::SubBlocks);
-
-    psio_->close(file, 1);
-}
-void DFMP2::apply_G_transpose(size_t file, size_t naux, size_t nia) {
-    // Memory constraints
-    size_t doubles = (size_t)(options_.get_double("DFMP2_MEM_FACTOR") * (memory_ / 8L));
-    size_t max_nia = (doubles / naux);
-    max_nia = (max_nia > nia ? nia : max_nia);
-    max_nia = (max_nia < 1L ? 1L : max_nia);
-
-    // Block sizing
-    std::vector<size_t> ia_starts;
-    ia_starts.push_back(0);
-    for (size_t ia = 0L; ia < nia; ia += max_nia) {
-        if (ia + max_nia >= nia) {
-            ia_starts.push_back(nia);
-        } else {
-            ia_starts.push_back(ia + max_nia);
-        }
-    }
-    // block_status(ia_starts, __FILE__,__LINE__);
-
-    // Prestripe
-    psio_->open(file, PSIO_OPEN_OLD);
-    psio_address next_QIA = PSIO_ZERO;
-    std::vector<double> temp(nia, 0);
-    for (int Q = 0; Q < naux; Q++) {
-        psio_->write(file, "G(Q|ia)", (char*)temp.data(), sizeof(double) * nia, next_QIA, &next_QIA);
-    }
-    std::vector<double>().swap(temp); // Dirty trick to clear temp memory immediately.
-    next_QIA = PSIO_ZERO;
-    psio_address next_IAQ = PSIO_ZERO;
-
-    // Tensor blocks
-    auto Qia = std::make_shared<Matrix>("G (Q|ia)", naux, max_nia);
-    auto iaQ = std::make_shared<Matrix>("G (ia|Q)", max_nia, naux);
-    auto Qiap = Qia->pointer();
-    auto iaQp = iaQ->pointer();
-
-    // Loop through blocks
-    for (int block = 0; block < ia_starts.size() - 1; block++) {
-        // Sizing
-        size_t ia_start = ia_starts[block];
-        size_t ia_stop = ia_starts[block + 1];
-        size_t ncols = ia_stop - ia_start;
-
-        // Read Gia
-        timer_on("DFMP2 Gia Read");
-        psio_->read(file, "G(ia|Q)", (char*)iaQp[0], sizeof(double) * ncols * naux, next_IAQ, &next_IAQ);
-        timer_off("DFMP2 Gia Read");
-
-        // Transpose
+        // DEFINITION: G(Q|ia) := G(ia|Q)
         for (int Q = 0; Q < naux; Q++) {
-            C_DCOPY(ncols, &iaQp[0][Q], naux, Qiap[Q], 1);
+            C_DCOPY(ncols, &Giap[0][Q], naux, Qiap[Q], 1);
         }
 
-        // DEFINITION: G(Q|ia) := G(ia|Q)
-
-        // Write Gia^\dagger
         timer_on("DFMP2 aiG Write");
         for (size_t Q = 0; Q < naux; Q++) {
             next_QIA = psio_get_address(PSIO_ZERO, sizeof(double) * (Q * nia + ia_start));
@@ -684,6 +637,9 @@ void DFMP2::apply_G_transpose(size_t file, size_t naux, size_t nia) {
         }
         timer_off("DFMP2 aiG Write");
     }
+
+    G->save(psio_, file, Matrix::SaveType::SubBlocks);
+
     psio_->close(file, 1);
 }
 void DFMP2::apply_B_transpose(size_t file, size_t naux, size_t naocc, size_t navir) {
@@ -1024,7 +980,16 @@ void RDFMP2::form_energy() {
         throw PSIEXCEPTION("DFMP2: Insufficient memory for Iab buffers. Reduce OMP Threads or increase memory.");
     }
     size_t remainder = doubles - nthread * Iab_memory;
-    size_t max_i = remainder / (2L * Qa_memory);
+
+    // If all of (ia|Q) fits, it is read once into a single buffer. Otherwise three buffers rotate,
+    // so that the next block is read while the current block pair is contracted, and the blocks
+    // are as large as memory allows to keep the number of reads down.
+    int nbuffer = 1;
+    size_t max_i = remainder / Qa_memory;
+    if (max_i < naocc) {
+        nbuffer = 3;
+        max_i = remainder / (3L * Qa_memory);
+    }
     max_i = (max_i > naocc ? naocc : max_i);
     max_i = (max_i < 1L ? 1L : max_i);
 
@@ -1039,12 +1004,25 @@ void RDFMP2::form_energy() {
         }
     }
     // block_status(i_starts, __FILE__,__LINE__);
+    int nblock = i_starts.size() - 1;
+
+    // Pairs of blocks, each row in the order (i,i), (i,0), ..., (i,i-1), so that every step
+    // after the first needs exactly one block that is not in memory yet
+    std::vector<std::pair<int, int>> block_pairs;
+    for (int block_i = 0; block_i < nblock; block_i++) {
+        block_pairs.emplace_back(block_i, block_i);
+        for (int block_j = 0; block_j < block_i; block_j++) {
+            block_pairs.emplace_back(block_i, block_j);
+        }
+    }
 
     // Tensor blocks
-    auto Bia = std::make_shared<Matrix>("B(ia|Q)", max_i * (size_t)navir, naux);
-    auto Bjb = std::make_shared<Matrix>("B(jb|Q)", max_i * (size_t)navir, naux);
-    double** Biap = Bia->pointer();
-    double** Bjbp = Bjb->pointer();
+    std::vector<SharedMatrix> Bbuf;
+    std::vector<int> buffer_block(nbuffer, -1);
+    std::vector<psio_address> buffer_end(nbuffer, PSIO_ZERO);
+    for (int b = 0; b < nbuffer; b++) {
+        Bbuf.push_back(std::make_shared<Matrix>("B(ia|Q)", max_i * (size_t)navir, naux));
+    }
 
     std::vector<SharedMatrix> Iab;
     for (int i = 0; i < nthread; i++) {
@@ -1054,73 +1032,96 @@ void RDFMP2::form_energy() {
     double* eps_aoccp = eps_aocc_->pointer();
     double* eps_avirp = eps_avir_->pointer();
 
+    auto aio = std::make_shared<AIOHandler>(psio_);
+
+    // Buffer holding a block, or -1
+    auto find_block = [&](int block) {
+        for (int b = 0; b < nbuffer; b++) {
+            if (buffer_block[b] == block) return b;
+        }
+        return -1;
+    };
+
+    // Queue the read of a block into a buffer
+    auto read_block = [&](int block, int b) {
+        size_t start = i_starts[block];
+        size_t n = i_starts[block + 1] - start;
+        buffer_block[b] = block;
+        aio->read(PSIF_DFMP2_AIA, "B(ia|Q)", (char*)Bbuf[b]->pointer()[0], sizeof(double) * (n * navir * naux),
+                  psio_get_address(PSIO_ZERO, sizeof(double) * (start * navir * naux)), &buffer_end[b]);
+    };
+
     // Loop through pairs of blocks
     psio_->open(PSIF_DFMP2_AIA, PSIO_OPEN_OLD);
-    psio_address next_BIA = PSIO_ZERO;
-    for (int block_i = 0; block_i < i_starts.size() - 1; block_i++) {
+    read_block(0, 0);
+    for (size_t pair = 0; pair < block_pairs.size(); pair++) {
+        int block_i = block_pairs[pair].first;
+        int block_j = block_pairs[pair].second;
+
         // Sizing
         size_t istart = i_starts[block_i];
         size_t istop = i_starts[block_i + 1];
         size_t ni = istop - istart;
+        size_t jstart = i_starts[block_j];
+        size_t jstop = i_starts[block_j + 1];
+        size_t nj = jstop - jstart;
 
-        // Read iaQ chunk
+        // Wait for the iaQ chunks of this pair
         timer_on("DFMP2 Bia Read");
-        next_BIA = psio_get_address(PSIO_ZERO, sizeof(double) * (istart * navir * naux));
-        psio_->read(PSIF_DFMP2_AIA, "B(ia|Q)", (char*)Biap[0], sizeof(double) * (ni * navir * naux), next_BIA,
-                    &next_BIA);
+        aio->synchronize();
         timer_off("DFMP2 Bia Read");
 
-        for (int block_j = 0; block_j <= block_i; block_j++) {
-            // Sizing
-            size_t jstart = i_starts[block_j];
-            size_t jstop = i_starts[block_j + 1];
-            size_t nj = jstop - jstart;
-
-            // Read iaQ chunk (if unique)
-            timer_on("DFMP2 Bia Read");
-            if (block_i == block_j) {
-                ::memcpy((void*)Bjbp[0], (void*)Biap[0], sizeof(double) * (ni * navir * naux));
-            } else {
-                next_BIA = psio_get_address(PSIO_ZERO, sizeof(double) * (jstart * navir * naux));
-                psio_->read(PSIF_DFMP2_AIA, "B(ia|Q)", (char*)Bjbp[0], sizeof(double) * (nj * navir * naux), next_BIA,
-                            &next_BIA);
+        int buffer_i = find_block(block_i);
+        int buffer_j = find_block(block_j);
+        double** Biap = Bbuf[buffer_i]->pointer();
+        double** Bjbp = Bbuf[buffer_j]->pointer();
+
+        // Start reading the chunk the next pair is missing into a buffer this pair does not use
+        if (pair + 1 < block_pairs.size()) {
+            int next_i = block_pairs[pair + 1].first;
+            int next_j = block_pairs[pair + 1].second;
+            int missing = (find_block(next_i) < 0 ? next_i : next_j);
+            if (find_block(missing) < 0) {
+                int b = 0;
+                while (b == buffer_i || b == buffer_j) b++;
+                read_block(missing, b);
             }
-            timer_off("DFMP2 Bia Read");
+        }
 
 #pragma omp parallel for schedule(dynamic) num_threads(nthread) reduction(+ : e_ss, e_os)
-            for (long int ij = 0L; ij < ni * nj; ij++) {
-                // Sizing
-                size_t i = ij / nj + istart;
-                size_t j = ij % nj + jstart;
-                if (j > i) continue;
+        for (long int ij = 0L; ij < ni * nj; ij++) {
+            // Sizing
+            size_t i = ij / nj + istart;
+            size_t j = ij % nj + jstart;
+            if (j > i) continue;
 
-                double perm_factor = (i == j ? 1.0 : 2.0);
+            double perm_factor = (i == j ? 1.0 : 2.0);
 
-                // Which thread is this?
-                int thread = 0;
+            // Which thread is this?
+            int thread = 0;
 #ifdef _OPENMP
-                thread = omp_get_thread_num();
+            thread = omp_get_thread_num();
 #endif
-                double** Iabp = Iab[thread]->pointer();
+            double** Iabp = Iab[thread]->pointer();
 
-                // Form the integral block (ia|jb) = (ia|Q)(Q|jb)
-                C_DGEMM('N', 'T', navir, navir, naux, 1.0, Biap[(i - istart) * navir], naux, Bjbp[(j - jstart) * navir],
-                        naux, 0.0, Iabp[0], navir);
+            // Form the integral block (ia|jb) = (ia|Q)(Q|jb)
+            C_DGEMM('N', 'T', navir, navir, naux, 1.0, Biap[(i - istart) * navir], naux, Bjbp[(j - jstart) * navir],
+                    naux, 0.0, Iabp[0], navir);
 
-                // Add the MP2 energy contributions
-                for (int a = 0; a < navir; a++) {
-                    for (int b = 0; b < navir; b++) {
-                        double iajb = Iabp[a][b];
-                        double ibja = Iabp[b][a];
-                        double denom = -perm_factor / (eps_avirp[a] + eps_avirp[b] - eps_aoccp[i] - eps_aoccp[j]);
+            // Add the MP2 energy contributions
+            for (int a = 0; a < navir; a++) {
+                for (int b = 0; b < navir; b++) {
+                    double iajb = Iabp[a][b];
+                    double ibja = Iabp[b][a];
+                    double denom = -perm_factor / (eps_avirp[a] + eps_avirp[b] - eps_aoccp[i] - eps_aoccp[j]);
 
-                        e_ss += (iajb * iajb - iajb * ibja) * denom;
-                        e_os += (iajb * iajb) * denom;
-                    }
+                    e_ss += (iajb * iajb - iajb * ibja) * denom;
+                    e_os += (iajb * iajb) * denom;
                 }
             }
         }
     }
+    aio->synchronize();
     psio_->close(PSIF_DFMP2_AIA, 0);
 
     variables_["MP2 SAME-SPIN CORRELATION ENERGY"] = e_ss;
@@ -1488,9 +1489,6 @@ void RDFMP2::form_Pij() {
 void RDFMP2::form_gamma() {
     apply_gamma(PSIF_DFMP2_AIA, ribasis_->nbf(), Caocc_->colspi()[0] * (size_t)Cavir_->colspi()[0]);
 }
-void RDFMP2::form_G_transpose() {
-    apply_G_transpose(PSIF_DFMP2_AIA, ribasis_->nbf(), Caocc_->colspi()[0] * (size_t)Cavir_->colspi()[0]);
-}
 void RDFMP2::form_AB_x_terms() {
     auto naux = ribasis_->nbf();
 
@@ -1506,7 +1504,7 @@ void RDFMP2::form_AB_x_terms() {
         gradients_[kv.first] = kv.second;
     }
 }
-void RDFMP2::form_Amn_x_terms() {
+void RDFMP2::form_Amn_x_terms_and_L() {
     // => Sizing <= //
 
     int natom = basisset_->molecule()->natom();
@@ -1527,31 +1525,34 @@ void RDFMP2::form_Amn_x_terms() {
 
     IntegralFactory rifactory(ribasis_, BasisSet::zero_ao_basis_set(), basisset_, basisset_);
     std::vector<std::shared_ptr<TwoBodyAOInt> > eri;
+    std::vector<std::shared_ptr<TwoBodyAOInt> > eri_x;
     for (int t = 0; t < num_threads; t++) {
-        eri.push_back(std::shared_ptr<TwoBodyAOInt>(rifactory.eri(1)));
+        eri.push_back(std::shared_ptr<TwoBodyAOInt>(rifactory.eri()));
+        eri_x.push_back(std::shared_ptr<TwoBodyAOInt>(rifactory.eri(1)));
     }
 
     // => ERI Sieve <= //
+
     const auto& shell_pairs = eri[0]->shell_pairs();
     int npairs = shell_pairs.size();
 
-    // => Gradient Contribution <= //
-
-    gradients_["(A|mn)^x"] = std::make_shared<Matrix>("(A|mn)^x Gradient", natom, 3);
-
     // => Memory Constraints <= //
 
-    size_t memory = ((size_t)(options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
+    size_t memory = static_cast<size_t>((options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
+    memory -= static_cast<size_t>(naocc) * static_cast<size_t>(nso);
+    memory -= static_cast<size_t>(navir) * static_cast<size_t>(nso);
+    memory -= static_cast<size_t>(naocc) * static_cast<size_t>(navir);
     int max_rows;
     int maxP = ribasis_->max_function_per_shell();
     size_t row_cost = 0L;
-    row_cost += nso * (size_t)nso;
-    row_cost += nso * (size_t)naocc;
-    row_cost += naocc * (size_t)navir;
+    row_cost += static_cast<size_t>(nso)   * static_cast<size_t>(nso);
+    row_cost += static_cast<size_t>(nso)   * static_cast<size_t>(naocc);
+    row_cost += static_cast<size_t>(nso)   * static_cast<size_t>(navir);
+    row_cost += static_cast<size_t>(naocc) * static_cast<size_t>(navir);
     size_t rows = memory / row_cost;
     rows = (rows > naux ? naux : rows);
     rows = (rows < maxP ? maxP : rows);
-    max_rows = (int)rows;
+    max_rows = static_cast<int>(rows);
 
     // => Block Sizing <= //
 
@@ -1572,23 +1573,35 @@ void RDFMP2::form_Amn_x_terms() {
     // => Temporary Buffers <= //
 
     auto Gia = std::make_shared<Matrix>("Gia", max_rows, naocc * navir);
-    auto Gmi = std::make_shared<Matrix>("Gmi", max_rows, nso * naocc);
-    auto Gmn = std::make_shared<Matrix>("Gmn", max_rows, nso * (size_t)nso);
+    auto Gim = std::make_shared<Matrix>("Pim", max_rows, nso * naocc);
+    auto Gam = std::make_shared<Matrix>("Pam", max_rows, nso * navir);
+    auto Gmn = std::make_shared<Matrix>("Pmn", max_rows, nso * (size_t)nso);
 
-    double** Giap = Gia->pointer();
-    double** Gmip = Gmi->pointer();
-    double** Gmnp = Gmn->pointer();
+    auto Giap = Gia->pointer();
+    auto Gimp = Gim->pointer();
+    auto Gamp = Gam->pointer();
+    auto Gmnp = Gmn->pointer();
+
+    auto Caoccp = Caocc_->pointer();
+    auto Cavirp = Cavir_->pointer();
 
-    double** Caoccp = Caocc_->pointer();
-    double** Cavirp = Cavir_->pointer();
+    std::vector<double> temp(naocc * navir);
 
     // => Temporary Gradients <= //
 
+    gradients_["(A|mn)^x"] = std::make_shared<Matrix>("(A|mn)^x Gradient", natom, 3);
     std::vector<SharedMatrix> Ktemps;
     for (int t = 0; t < num_threads; t++) {
         Ktemps.push_back(std::make_shared<Matrix>("Ktemp", natom, 3));
     }
 
+    // => Targets <= //
+
+    auto Lmi = std::make_shared<Matrix>("L_ma", nso, naocc);
+    auto Lma = std::make_shared<Matrix>("L_mi", nso, navir);
+    auto Lmip = Lmi->pointer();
+    auto Lmap = Lma->pointer();
+
     // => PSIO <= //
 
     psio_->open(PSIF_DFMP2_AIA, PSIO_OPEN_OLD);
@@ -1607,16 +1620,18 @@ void RDFMP2::form_Amn_x_terms() {
         int pstop = (Pstop == ribasis_->nshell() ? naux : ribasis_->shell(Pstop).function_index());
         int np = pstop - pstart;
 
-        // > G_ia^P -> G_mn^P < //
+        // > G_ia^P Read < //
 
         psio_->read(PSIF_DFMP2_AIA, "G(Q|ia)", (char*)Giap[0], sizeof(double) * np * nia, next_AIA, &next_AIA);
 
+        // > G_ia^P -> G_mn^P < //
+
 #pragma omp parallel for num_threads(num_threads)
         for (int p = 0; p < np; p++) {
-            C_DGEMM('N', 'T', nso, naocc, navir, 1.0, Cavirp[0], navir, Giap[p], navir, 0.0, Gmip[p], naocc);
+            C_DGEMM('N', 'T', nso, naocc, navir, 1.0, Cavirp[0], navir, Giap[p], navir, 0.0, Gimp[p], naocc);
         }
 
-        C_DGEMM('N', 'T', np * (size_t)nso, nso, naocc, 1.0, Gmip[0], naocc, Caoccp[0], naocc, 0.0, Gmnp[0], nso);
+        C_DGEMM('N', 'T', np * (size_t)nso, nso, naocc, 1.0, Gimp[0], naocc, Caoccp[0], naocc, 0.0, Gmnp[0], nso);
 
         // On Prefactors:
         // One factor of 2 is built into the definition of the term.
@@ -1636,10 +1651,9 @@ void RDFMP2::form_Amn_x_terms() {
             int M = shell_pairs[MN].first;
             int N = shell_pairs[MN].second;
 
-            eri[thread]->compute_shell_deriv1(P, 0, M, N);
+            eri_x[thread]->compute_shell_deriv1(P, 0, M, N);
 
-            const auto buffer = eri[thread]->buffer();
-            const auto &buffers = eri[thread]->buffers();
+            const auto &buffers = eri_x[thread]->buffers();
 
             int nP = ribasis_->shell(P).nfunction();
             int cP = ribasis_->shell(P).ncartesian();
@@ -1699,126 +1713,9 @@ void RDFMP2::form_Amn_x_terms() {
                 }
             }
         }
-    }
-
-    // => Temporary Gradient Reduction <= //
-
-    for (int t = 0; t < num_threads; t++) {
-        gradients_["(A|mn)^x"]->add(Ktemps[t]);
-    }
-
-    psio_->close(PSIF_DFMP2_AIA, 1);
-}
-void RDFMP2::form_L() {
-    // => Sizing <= //
-
-    int nso = basisset_->nbf();
-    int naocc = Caocc_->colspi()[0];
-    int navir = Cavir_->colspi()[0];
-    int nia = Caocc_->colspi()[0] * Cavir_->colspi()[0];
-    int naux = ribasis_->nbf();
-
-    // => Thread Count <= //
-
-    int num_threads = 1;
-#ifdef _OPENMP
-    num_threads = Process::environment.get_n_threads();
-#endif
-
-    // => Integrals <= //
-
-    IntegralFactory rifactory(ribasis_, BasisSet::zero_ao_basis_set(), basisset_, basisset_);
-    std::vector<std::shared_ptr<TwoBodyAOInt> > eri;
-    for (int t = 0; t < num_threads; t++) {
-        eri.push_back(std::shared_ptr<TwoBodyAOInt>(rifactory.eri()));
-    }
-
-    // => ERI Sieve <= //
-
-    const auto& shell_pairs = eri[0]->shell_pairs();
-    int npairs = shell_pairs.size();
-
-    // => Memory Constraints <= //
-
-    size_t memory = static_cast<size_t>((options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
-    memory -= static_cast<size_t>(naocc) * static_cast<size_t>(nso);
-    memory -= static_cast<size_t>(navir) * static_cast<size_t>(nso);
-    memory -= static_cast<size_t>(naocc) * static_cast<size_t>(navir);
-    int max_rows;
-    int maxP = ribasis_->max_function_per_shell();
-    size_t row_cost = 0L;
-    row_cost += static_cast<size_t>(nso)   * static_cast<size_t>(nso);
-    row_cost += static_cast<size_t>(nso)   * static_cast<size_t>(naocc);
-    row_cost += static_cast<size_t>(nso)   * static_cast<size_t>(navir);
-    row_cost += static_cast<size_t>(naocc) * static_cast<size_t>(navir);
-    size_t rows = memory / row_cost;
-    rows = (rows > naux ? naux : rows);
-    rows = (rows < maxP ? maxP : rows);
-    max_rows = static_cast<int>(rows);
-
-    // => Block Sizing <= //
-
-    std::vector<int> Pstarts;
-    int counter = 0;
-    Pstarts.push_back(0);
-    for (int P = 0; P < ribasis_->nshell(); P++) {
-        int nP = ribasis_->shell(P).nfunction();
-        if (counter + nP > max_rows) {
-            counter = 0;
-            Pstarts.push_back(P);
-        }
-        counter += nP;
-    }
-    Pstarts.push_back(ribasis_->nshell());
-    // block_status(Pstarts, __FILE__,__LINE__);
-
-    // => Temporary Buffers <= //
-
-    auto Gia = std::make_shared<Matrix>("Gia", max_rows, naocc * navir);
-    auto Gim = std::make_shared<Matrix>("Pim", max_rows, nso * naocc);
-    auto Gam = std::make_shared<Matrix>("Pam", max_rows, nso * navir);
-    auto Gmn = std::make_shared<Matrix>("Pmn", max_rows, nso * (size_t)nso);
-
-    auto Giap = Gia->pointer();
-    auto Gimp = Gim->pointer();
-    auto Gamp = Gam->pointer();
-    auto Gmnp = Gmn->pointer();
-
-    auto Caoccp = Caocc_->pointer();
-    auto Cavirp = Cavir_->pointer();
-
-    std::vector<double> temp(naocc * navir);
-
-    // => Targets <= //
-
-    auto Lmi = std::make_shared<Matrix>("L_ma", nso, naocc);
-    auto Lma = std::make_shared<Matrix>("L_mi", nso, navir);
-    auto Lmip = Lmi->pointer();
-    auto Lmap = Lma->pointer();
-
-    // => PSIO <= //
-
-    psio_->open(PSIF_DFMP2_AIA, PSIO_OPEN_OLD);
-    psio_address next_AIA = PSIO_ZERO;
-
-    // => Master Loop <= //
-
-    for (int block = 0; block < Pstarts.size() - 1; block++) {
-        // > Sizing < //
-
-        int Pstart = Pstarts[block];
-        int Pstop = Pstarts[block + 1];
-        int NP = Pstop - Pstart;
-
-        int pstart = ribasis_->shell(Pstart).function_index();
-        int pstop = (Pstop == ribasis_->nshell() ? naux : ribasis_->shell(Pstop).function_index());
-        int np = pstop - pstart;
-
-        // > G_ia^P Read < //
-
-        psio_->read(PSIF_DFMP2_AIA, "G(Q|ia)", (char*)Giap[0], sizeof(double) * np * nia, next_AIA, &next_AIA);
 
         // > Integrals < //
+        // The same G(Q|ia) block now forms L; Gmn and Gim are reused for the (A|mn) integrals
         Gmn->zero();
 #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
         for (long int PMN = 0L; PMN < static_cast<long int>(NP) * npairs; PMN++) {
@@ -1888,6 +1785,12 @@ void RDFMP2::form_L() {
         C_DGEMM('T', 'N', nso, naocc, navir * (size_t)np, 1.0, Gamp[0], nso, Giap[0], naocc, 1.0, Lmip[0], naocc);
     }
 
+    // => Temporary Gradient Reduction <= //
+
+    for (int t = 0; t < num_threads; t++) {
+        gradients_["(A|mn)^x"]->add(Ktemps[t]);
+    }
+
     psio_->write_entry(PSIF_DFMP2_AIA, "L_mi", (char*)Lmip[0], sizeof(double) * nso * naocc);
     psio_->write_entry(PSIF_DFMP2_AIA, "L_ma", (char*)Lmap[0], sizeof(double) * nso * navir);
 
@@ -3234,10 +3137,8 @@ void UDFMP2::form_energy() {
 void UDFMP2::form_Pab() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
 void UDFMP2::form_Pij() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
 void UDFMP2::form_gamma() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
-void UDFMP2::form_G_transpose() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
 void UDFMP2::form_AB_x_terms() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
-void UDFMP2::form_Amn_x_terms() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
-void UDFMP2::form_L() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
+void UDFMP2::form_Amn_x_terms_and_L() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
 void UDFMP2::form_P() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
 void UDFMP2::form_W() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
 void UDFMP2::form_Z() { throw PSIEXCEPTION("UDFMP2: Gradients not yet implemented"); }
@@ -35,6 +35,7 @@
 namespace psi {
 
 class PSIO;
+class DFHelper;
 
 namespace dfmp2 {
 
@@ -73,16 +74,13 @@ class DFMP2 : public Wavefunction {
     virtual void form_Pab() = 0;
     // Form the OO block of the correlation OPDM (DiStasio 7)
     virtual void form_Pij() = 0;
-    // Form the small gamma; Eq. 3 of DiStasio
+    // Form the small gamma; Eq. 3 of DiStasio. Also writes the transposed G(Q|ia)
     virtual void form_gamma() = 0;
-    // Transpose the G
-    virtual void form_G_transpose() = 0;
     // Form the (A|B)^x contribution to the gradient; Term 2 of DiStasio 1
     virtual void form_AB_x_terms() = 0;
-    // Form the (A|mn)^x contribution to the gradient; Term 1 of DiStasio 1
-    virtual void form_Amn_x_terms() = 0;
-    // Form the L_μa and L_μi matrices; DiStasio 19 and 20
-    virtual void form_L() = 0;
+    // Form the (A|mn)^x contribution to the gradient (Term 1 of DiStasio 1) and the L_μa and L_μi
+    // matrices (DiStasio 19 and 20) in one pass over G(Q|ia)
+    virtual void form_Amn_x_terms_and_L() = 0;
     // Form the unrelaxed correlation OPDM; Compute DiStasio 6 and 9; Assemble DiStasio 6-9 into one matrix
     virtual void form_P() = 0;
     // Form part of the unrelaxed correlation EWDM; DiStasio 11-13... plus fudge factors
@@ -100,10 +98,8 @@ class DFMP2 : public Wavefunction {
     virtual void apply_fitting_grad(SharedMatrix Jm12, size_t file, size_t naux, size_t nia);
     // Form the inverse square root of the fitting metric, or read it off disk
     virtual SharedMatrix form_inverse_metric();
-    // Form an abstract gamma
+    // Form an abstract gamma, writing the transposed copy G(Q|ia) of G(ia|Q) in the same pass
     virtual void apply_gamma(size_t file, size_t naux, size_t nia);
-    // Form a transposed copy of G_ia^P
-    virtual void apply_G_transpose(size_t file, size_t naux, size_t nia);
     // Form a transposed copy of iaQ
     virtual void apply_B_transpose(size_t file, size_t naux, size_t naocc, size_t navir);
 
@@ -151,16 +147,12 @@ class RDFMP2 : public DFMP2 {
     void form_Pab() override;
     // Form the energy contributions and gradients
     void form_Pij() override;
-    // Form the small gamma
+    // Form the small gamma and G(Q|ia)
     void form_gamma() override;
-    // Transpose the G
-    void form_G_transpose() override;
     // Form the (A|B)^x contribution to the gradient
     void form_AB_x_terms() override;
-    // Form the (A|mn)^x contribution to the gradient
-    void form_Amn_x_terms() override;
-    // Form the Lma and Lmi matrices
-    void form_L() override;
+    // Form the (A|mn)^x contribution to the gradient and the Lma and Lmi matrices
+    void form_Amn_x_terms_and_L() override;
     // Form the unrelaxed OPDM
     void form_P() override;
     // Form the unrelaxed energy-weighted OPDM
@@ -175,6 +167,45 @@ class RDFMP2 : public DFMP2 {
     ~RDFMP2() override;
 };
 
+// Laplace-transformed RMP2 energies over pivoted Cholesky factors of the AO pseudo-densities
+class RLaplaceDFMP2 : public RDFMP2 {
+   protected:
+    // Screened (A|mn), fitted with J^-1/2 in each transformation
+    std::shared_ptr<DFHelper> dfh_;
+
+    // Maximum error in the quadrature of the 1/x denominator
+    double laplace_delta_;
+    // Cholesky tolerance relative to the largest pseudo-density diagonal
+    double cholesky_tol_;
+    // Exchange-like pair contributions neglected below this bound
+    double pair_tol_;
+    // Only the opposite-spin (Coulomb-like) term, which scales as O(N^4) per quadrature point
+    bool os_only_;
+
+    // Print additional header
+    void print_header() override;
+    // Build the screened (A|mn) tensor
+    void form_Aia() override;
+    // No-op, fitting is part of each transformation
+    void form_Bia() override;
+    // Gradients are not available
+    void form_Bia_Cia() override;
+    // Form the energy contributions by quadrature point
+    void form_energy() override;
+    // Print SOS-MP2 energies only if the same-spin term was skipped
+    void print_energies() override;
+    // Localized factor L (nbf x rank) of X_mn = C_mi d_i C_ni = L_mk L_nk
+    SharedMatrix pseudo_density_factor(SharedMatrix C, const double* d, const std::string& name);
+    // Doubles used by the quadrature loop for no x nv factors, blocked max_i occupied rows at a time
+    size_t quadrature_memory(size_t no, size_t nv, size_t max_i, int nthread) const;
+
+   public:
+    RLaplaceDFMP2(SharedWavefunction ref_wfn, Options& options, std::shared_ptr<PSIO> psio);
+    ~RLaplaceDFMP2() override;
+
+    SharedMatrix compute_gradient() override;
+};
+
 class UDFMP2 : public DFMP2 {
    protected:
     SharedMatrix Caocc_a_;
@@ -205,16 +236,12 @@ class UDFMP2 : public DFMP2 {
     void form_Pab() override;
     // Form the energy contributions and gradients
     void form_Pij() override;
-    // Form the small gamma
+    // Form the small gamma and G(Q|ia)
     void form_gamma() override;
-    // Transpose the G
-    void form_G_transpose() override;
     // Form the (A|B)^x contribution to the gradient
     void form_AB_x_terms() override;
-    // Form the (A|mn)^x contribution to the gradient
-    void form_Amn_x_terms() override;
-    // Form the Lma and Lmi matrices
-    void form_L() override;
+    // Form the (A|mn)^x contribution to the gradient and the Lma and Lmi matrices
+    void form_Amn_x_terms_and_L() override;
     // Form the unrelaxed OPDM
     void form_P() override;
     // Form the unrelaxed energy-weighted OPDM
@@ -53,7 +53,10 @@ SharedWavefunction dfmp2(SharedWavefunction ref_wfn, Options& options) {
     auto psio = std::make_shared<PSIO>();
 
     std::shared_ptr<Wavefunction> dfmp2;
-    if (options.get_str("REFERENCE") == "RHF" || options.get_str("REFERENCE") == "RKS") {
+    if ((options.get_str("REFERENCE") == "RHF" || options.get_str("REFERENCE") == "RKS") &&
+        options.get_bool("DFMP2_LAPLACE")) {
+        dfmp2 = std::make_shared<RLaplaceDFMP2>(ref_wfn, options, psio);
+    } else if (options.get_str("REFERENCE") == "RHF" || options.get_str("REFERENCE") == "RKS") {
         dfmp2 = std::make_shared<RDFMP2>(ref_wfn, options, psio);
     } else if (options.get_str("REFERENCE") == "UHF" || options.get_str("REFERENCE") == "UKS") {
         dfmp2 = std::make_shared<UDFMP2>(ref_wfn, options, psio);
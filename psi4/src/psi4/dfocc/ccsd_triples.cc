@@ -32,6 +32,7 @@
 #endif
 
 #include "psi4/libqt/qt.h"
+#include "psi4/fnocc/triples_checkpoint.h"
 
 #include "defines.h"
 #include "dfocc.h"
@@ -105,10 +106,16 @@ void DFOCC::ccsd_canonic_triples() {
     K->read(psio_, PSIF_DFOCC_INTS);
     Jt = std::make_shared<Tensor2d>("J[I] <A|B>=C", navirA, ntri_abAA);
 
+    // the tasks are the i blocks of the main loop
+    fnocc::TriplesCheckpoint ckpt("dfocc_triples", triples_checkpoint_, naoccA,
+                                  {0.0, (double)naoccA, (double)navirA, (double)nQ, Escf, Eccsd});
+
     // main loop
     E_t = 0.0;
     double sum = 0.0;
     for (long int i = 0; i < naoccA; ++i) {
+        if (ckpt.done(i)) continue;
+        double sum_i = sum;
         double Di = FockA->get(i + nfrzc, i + nfrzc);
 
         // Compute J[i](a,bc) = (ia|bc) = \sum(Q) B[i](aQ) * B(Q,bc)
@@ -285,6 +292,7 @@ void DFOCC::ccsd_canonic_triples() {
 
             }  // k
         }      // j
+        ckpt.finish(i, sum - sum_i);
     }          // i
     T.reset();
     J.reset();
@@ -299,7 +307,8 @@ void DFOCC::ccsd_canonic_triples() {
     I.reset();
 
     // set energy
-    E_t = sum;
+    E_t = sum + ckpt.restored_energy();
+    ckpt.remove();
     Eccsd_t = Eccsd + E_t;
 
 }  // end ccsd_canonic_triples
@@ -366,10 +375,16 @@ void DFOCC::ccsd_canonic_triples_hm() {
     // K = std::make_shared<Tensor2d>("DF_BASIS_CC B (Q|AB)", nQ, ntri_abAA);
     // K->read(psio_, PSIF_DFOCC_INTS);
 
+    // the tasks are the i blocks of the main loop
+    fnocc::TriplesCheckpoint ckpt("dfocc_triples", triples_checkpoint_, naoccA,
+                                  {1.0, (double)naoccA, (double)navirA, (double)nQ, Escf, Eccsd});
+
     // main loop
     E_t = 0.0;
     double sum = 0.0;
     for (long int i = 0; i < naoccA; ++i) {
+        if (ckpt.done(i)) continue;
+        double sum_i = sum;
         double Di = FockA->get(i + nfrzc, i + nfrzc);
         for (long int j = 0; j <= i; ++j) {
             double Dij = Di + FockA->get(j + nfrzc, j + nfrzc);
@@ -532,6 +547,7 @@ void DFOCC::ccsd_canonic_triples_hm() {
 
             }  // k
         }      // j
+        ckpt.finish(i, sum - sum_i);
     }          // i
     J1.reset();
     T.reset();
@@ -541,7 +557,8 @@ void DFOCC::ccsd_canonic_triples_hm() {
     I.reset();
 
     // set energy
-    E_t = sum;
+    E_t = sum + ckpt.restored_energy();
+    ckpt.remove();
     Eccsd_t = Eccsd + E_t;
 
 }  // end ccsd_canonic_triples_hm
@@ -633,10 +650,16 @@ void DFOCC::ccsd_canonic_triples_disk() {
     Jt.reset();
     L.reset();
 
+    // the tasks are the i blocks of the main loop
+    fnocc::TriplesCheckpoint ckpt("dfocc_triples", triples_checkpoint_, naoccA,
+                                  {2.0, (double)naoccA, (double)navirA, (double)nQ, Escf, Eccsd});
+
     // main loop
     E_t = 0.0;
     double sum = 0.0;
     for (long int i = 0; i < naoccA; ++i) {
+        if (ckpt.done(i)) continue;
+        double sum_i = sum;
         double Di = FockA->get(i + nfrzc, i + nfrzc);
 
         // Read J[i](a,bc)
@@ -816,6 +839,7 @@ void DFOCC::ccsd_canonic_triples_disk() {
 
             }  // k
         }      // j
+        ckpt.finish(i, sum - sum_i);
     }          // i
     T.reset();
     J.reset();
@@ -827,7 +851,8 @@ void DFOCC::ccsd_canonic_triples_disk() {
     I.reset();
 
     // set energy
-    E_t = sum;
+    E_t = sum + ckpt.restored_energy();
+    ckpt.remove();
     Eccsd_t = Eccsd + E_t;
 
     // Delete the (IA|BC) file
@@ -32,6 +32,7 @@
 #include "dfocc.h"
 #include "defines.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/memory_manager.h"
 #include "psi4/liboptions/liboptions.h"
 
 using namespace psi;
@@ -45,7 +46,7 @@ DFOCC::DFOCC(SharedWavefunction ref_wfn, Options &options) : Wavefunction(option
     common_init();
 }  //
 
-DFOCC::~DFOCC() {}  //
+DFOCC::~DFOCC() { tensor_pool_disable(); }  //
 
 void DFOCC::common_init() {
     print_ = options_.get_int("PRINT");
@@ -56,11 +57,13 @@ void DFOCC::common_init() {
     cc_maxiter = options_.get_int("CC_MAXITER");
     mo_maxiter = options_.get_int("MO_MAXITER");
     num_vecs = options_.get_int("MO_DIIS_NUM_VECS");
+    lbfgs_num_vecs_ = options_.get_int("MO_LBFGS_NUM_VECS");
     cc_maxdiis_ = options_.get_int("CC_DIIS_MAX_VECS");
     cc_mindiis_ = options_.get_int("CC_DIIS_MIN_VECS");
     exp_cutoff = options_.get_int("CUTOFF");
     exp_int_cutoff = options_.get_int("INTEGRAL_CUTOFF");
     pcg_maxiter = options_.get_int("PCG_MAXITER");
+    triples_checkpoint_ = options_.get_int("TRIPLES_CHECKPOINT");
 
     step_max = options_.get_double("MO_STEP_MAX");
     lshift_parameter = options_.get_double("LEVEL_SHIFT");
@@ -523,6 +526,9 @@ void DFOCC::pdm_title() {
 }  //
 
 double DFOCC::compute_energy() {
+    // Recycle the storage of the per-iteration temporaries, within the memory no other module holds
+    if (options_.get_bool("TENSOR_POOL")) tensor_pool_enable(MemoryBroker::shared_object().available());
+
     // Call the appropriate manager
     // do_cd = "FALSE";
     nincore_amp = 3;
@@ -589,6 +595,11 @@ double DFOCC::compute_energy() {
         throw PSIEXCEPTION("Unrecognized WFN_TYPE!");
     }
 
+    if (options_.get_bool("TENSOR_POOL")) {
+        if (print_ > 1) tensor_pool_print();
+        tensor_pool_disable();
+    }
+
     if (wfn_type_ == "DF-OMP2")
         Etotal = Emp2L;
     else if (wfn_type_ == "DF-CCSD")
@@ -31,6 +31,8 @@
 
 #include "tensors.h"
 
+#include <deque>
+
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libdiis/diismanager.h"
@@ -97,6 +99,11 @@ class DFOCC : public Wavefunction {
     void orb_resp_pcg_rhf();
     void orb_resp_pcg_uhf();
     void kappa_diag_hess();
+    void kappa_lbfgs();
+    void lbfgs_step(const SharedTensor1d &wog, const SharedTensor1d &kappa_bar, const SharedTensor1i &idprow,
+                    const SharedTensor1i &idpcol, int nocc, const SharedTensor2d &Avo, const SharedTensor2d &Aoo,
+                    std::deque<SharedTensor1d> &svecs, std::deque<SharedTensor1d> &yvecs, SharedTensor1d &wog_old,
+                    SharedTensor1d &kappa_bar_old, const SharedTensor1d &kappa);
     void kappa_qchf();
     void update_mo();
     void update_hfmo();
@@ -674,7 +681,9 @@ class DFOCC : public Wavefunction {
     int cc_maxiter;
     int mo_maxiter;
     int pcg_maxiter;
+    int triples_checkpoint_;  // seconds between (T) checkpoints, 0 = off
     int num_vecs;  // Number of vectors used in diis (diis order)
+    int lbfgs_num_vecs_;  // Number of step pairs kept by the orbital L-BFGS
     int do_diis_;
     int itr_diis;
     int itr_occ;
@@ -1114,6 +1123,15 @@ class DFOCC : public Wavefunction {
     SharedTensor1d kappaB;
     SharedTensor1d kappa_barA;  // vector of orb rot parameters: wrt reference MOS
     SharedTensor1d kappa_barB;
+    // L-BFGS history (OPT_METHOD LBFGS): changes of kappa_bar and of the MO gradient
+    std::deque<SharedTensor1d> lbfgs_sA_;
+    std::deque<SharedTensor1d> lbfgs_yA_;
+    std::deque<SharedTensor1d> lbfgs_sB_;
+    std::deque<SharedTensor1d> lbfgs_yB_;
+    SharedTensor1d lbfgs_wogA_;
+    SharedTensor1d lbfgs_wogB_;
+    SharedTensor1d lbfgs_kappa_barA_;
+    SharedTensor1d lbfgs_kappa_barB_;
     SharedTensor1d kappa_newA;
     SharedTensor1d kappa_newB;
     SharedTensor1d zvector;
@@ -0,0 +1,158 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "defines.h"
+#include "dfocc.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace psi;
+
+namespace psi {
+namespace dfoccwave {
+
+//=========================
+// lbfgs_step
+//=========================
+// One L-BFGS step for a single spin: the inverse Hessian is built from the last lbfgs_num_vecs_ pairs of
+// (change of kappa_bar, change of the MO gradient) on top of the diagonal Hessian guess in Avo/Aoo.
+void DFOCC::lbfgs_step(const SharedTensor1d &wog, const SharedTensor1d &kappa_bar, const SharedTensor1i &idprow,
+                       const SharedTensor1i &idpcol, int nocc, const SharedTensor2d &Avo, const SharedTensor2d &Aoo,
+                       std::deque<SharedTensor1d> &svecs, std::deque<SharedTensor1d> &yvecs,
+                       SharedTensor1d &wog_old, SharedTensor1d &kappa_bar_old, const SharedTensor1d &kappa) {
+    int nidp = wog->dim1();
+
+    if (!wog_old) {
+        wog_old = std::make_shared<Tensor1d>("L-BFGS previous MO grad vector", nidp);
+        kappa_bar_old = std::make_shared<Tensor1d>("L-BFGS previous orb rot params vector", nidp);
+    } else if (DE > 0.0) {
+        // the energy went up: the model is no longer trusted, start over from the diagonal Hessian
+        svecs.clear();
+        yvecs.clear();
+    } else {
+        // new pair from the previous step; only kept if it has positive curvature
+        auto s = std::make_shared<Tensor1d>("L-BFGS s", nidp);
+        auto y = std::make_shared<Tensor1d>("L-BFGS y", nidp);
+        s->copy(kappa_bar);
+        s->subtract(kappa_bar_old);
+        y->copy(wog);
+        y->subtract(wog_old);
+        if (y->dot(s) > 1.0e-10 * std::sqrt(y->dot(y) * s->dot(s))) {
+            svecs.push_back(s);
+            yvecs.push_back(y);
+            if ((int)svecs.size() > lbfgs_num_vecs_) {
+                svecs.pop_front();
+                yvecs.pop_front();
+            }
+        }
+    }
+    wog_old->copy(wog);
+    kappa_bar_old->copy(kappa_bar);
+
+    // two-loop recursion
+    int nvec = svecs.size();
+    std::vector<double> rho(nvec), alpha(nvec);
+    auto r = std::make_shared<Tensor1d>("L-BFGS r", nidp);
+    r->copy(wog);
+    for (int n = nvec - 1; n >= 0; n--) {
+        rho[n] = 1.0 / yvecs[n]->dot(svecs[n]);
+        alpha[n] = rho[n] * svecs[n]->dot(r);
+        r->axpy(yvecs[n], -alpha[n]);
+    }
+    for (int x = 0; x < nidp; x++) {
+        int p = idprow->get(x);
+        int q = idpcol->get(x);
+        double value = p >= nocc ? Avo->get(p - nocc, q) : Aoo->get(p - nfrzc, q);
+        r->set(x, r->get(x) / value);
+    }
+    for (int n = 0; n < nvec; n++) {
+        double beta = rho[n] * yvecs[n]->dot(r);
+        r->axpy(svecs[n], alpha[n] - beta);
+    }
+
+    // not a descent direction: drop the history and take the preconditioned gradient step
+    if (nvec > 0 && r->dot(wog) <= 0.0) {
+        svecs.clear();
+        yvecs.clear();
+        for (int x = 0; x < nidp; x++) {
+            int p = idprow->get(x);
+            int q = idpcol->get(x);
+            double value = p >= nocc ? Avo->get(p - nocc, q) : Aoo->get(p - nfrzc, q);
+            r->set(x, wog->get(x) / value);
+        }
+    }
+
+    kappa->copy(r);
+    kappa->scale(-1.0);
+
+    // Scale
+    double biggest = 0.0;
+    for (int x = 0; x < nidp; x++) biggest = std::max(biggest, std::fabs(kappa->get(x)));
+    if (biggest > step_max) kappa->scale(step_max / biggest);
+}
+
+//=========================
+// kappa_lbfgs
+//=========================
+void DFOCC::kappa_lbfgs() {
+    // Diagonal Hessian guess
+    if (hess_type == "APPROX_DIAG") {
+        approx_diag_mohess_vo();
+        if (nfrzc > 0) approx_diag_mohess_oo();
+    } else if (hess_type == "APPROX_DIAG_EKT") {
+        approx_diag_ekt_mohess_vo();
+        if (nfrzc > 0) approx_diag_ekt_mohess_oo();
+    } else if (hess_type == "DIAG") {
+        diagonal_mohess_vo();
+        if (nfrzc > 0) diagonal_mohess_oo();
+    } else {
+        approx_diag_hf_mohess_vo();
+        if (nfrzc > 0) approx_diag_hf_mohess_oo();
+    }
+
+    lbfgs_step(wogA, kappa_barA, idprowA, idpcolA, noccA, AvoA, AooA, lbfgs_sA_, lbfgs_yA_, lbfgs_wogA_,
+               lbfgs_kappa_barA_, kappaA);
+    biggest_kappaA = 0;
+    for (int i = 0; i < nidpA; i++) biggest_kappaA = std::max(biggest_kappaA, std::fabs(kappaA->get(i)));
+    rms_kappaA = kappaA->rms();
+    if (print_ > 2) kappaA->print();
+
+    if (reference_ == "UNRESTRICTED") {
+        lbfgs_step(wogB, kappa_barB, idprowB, idpcolB, noccB, AvoB, AooB, lbfgs_sB_, lbfgs_yB_, lbfgs_wogB_,
+                   lbfgs_kappa_barB_, kappaB);
+        biggest_kappaB = 0;
+        for (int i = 0; i < nidpB; i++) biggest_kappaB = std::max(biggest_kappaB, std::fabs(kappaB->get(i)));
+        rms_kappaB = kappaB->rms();
+        if (print_ > 2) kappaB->print();
+    }
+}
+}  // end kappa_lbfgs
+}  // namespace dfoccwave
+}  // namespace psi
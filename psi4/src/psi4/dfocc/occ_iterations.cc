@@ -196,7 +196,9 @@ void DFOCC::occ_iterations() {
         //========================= New orbital step ===============================================
         //==========================================================================================
         timer_on("kappa orb rot");
-        if (hess_type == "HF") {
+        if (opt_method == "LBFGS")
+            kappa_lbfgs();
+        else if (hess_type == "HF") {
             if (orb_resp_solver_ == "LINEQ")
                 kappa_orb_resp();
             else if (orb_resp_solver_ == "PCG")
@@ -27,9 +27,17 @@
  */
 
 // Latest revision on April 38, 2013.
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <cmath>
+#include <iterator>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
 #include "psi4/libqt/qt.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsio/psio.hpp"
@@ -39,10 +47,159 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
+#include "psi4/libpsi4util/exception.h"
 
 namespace psi {
 namespace dfoccwave {
 
+namespace {
+
+/*
+** Freed Tensor2d blocks are kept in size buckets while the pool is on (see tensor_pool_enable), so the many
+** temporaries of an iteration reuse the memory of the previous one instead of going back to malloc and
+** first-touch page faults. Live and pooled bytes together are kept under the limit by dropping pooled blocks.
+** Every block carries its bucket size in a cache line in front of the data; blocks below pool_min_bytes, and
+** all blocks while the pool is off, never take the lock.
+*/
+struct TensorPool {
+    std::mutex lock;
+    std::atomic<bool> enabled{false};
+    size_t limit = 0;
+    std::multimap<size_t, double *> free_blocks;  // bucket bytes -> data
+    size_t live_bytes = 0;  // blocks of pool_min_bytes and more handed out while the pool is on
+    size_t pooled_bytes = 0;
+    size_t peak_bytes = 0;
+    size_t reuses = 0;
+    size_t allocations = 0;
+};
+TensorPool tensor_pool;
+
+// Blocks below this size go straight to malloc
+const size_t pool_min_bytes = 1L << 20;
+
+// Eight buckets per power of two, at most 12.5% padding
+size_t pool_bucket(size_t bytes) {
+    if (bytes < pool_min_bytes) return bytes;
+    size_t top = 1;
+    while ((top << 1) <= bytes) top <<= 1;
+    size_t step = top / 8;
+    return ((bytes + step - 1) / step) * step;
+}
+
+// The cache line in front of the data of a block
+struct BlockHeader {
+    size_t bytes;  // bucket bytes
+    bool counted;  // in live_bytes of the pool
+};
+const size_t block_header = 64;
+
+BlockHeader *header_of(double *data) {
+    return reinterpret_cast<BlockHeader *>(reinterpret_cast<char *>(data) - block_header);
+}
+
+double *block_data_alloc(size_t bytes, bool counted) {
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, 64, block_header + bytes)) {
+        throw PSIEXCEPTION("DFOCC: trouble allocating an aligned tensor block");
+    }
+    *static_cast<BlockHeader *>(ptr) = {bytes, counted};
+    return reinterpret_cast<double *>(static_cast<char *>(ptr) + block_header);
+}
+
+void block_data_free(double *data) { free(header_of(data)); }
+
+void pool_drop_free_blocks(size_t needed) {
+    while (!tensor_pool.free_blocks.empty() &&
+           tensor_pool.live_bytes + tensor_pool.pooled_bytes + needed > tensor_pool.limit) {
+        auto it = std::prev(tensor_pool.free_blocks.end());
+        tensor_pool.pooled_bytes -= it->first;
+        block_data_free(it->second);
+        tensor_pool.free_blocks.erase(it);
+    }
+}
+
+// Like block_matrix, but the data start on a 64-byte (cache line) boundary. Free with free_aligned_block.
+double **aligned_block(size_t n, size_t m) {
+    if (!n || !m) return nullptr;
+
+    size_t bytes = pool_bucket(sizeof(double) * n * m);
+    double *data = nullptr;
+    if (bytes < pool_min_bytes || !tensor_pool.enabled) {
+        data = block_data_alloc(bytes, false);
+    } else {
+        std::lock_guard<std::mutex> guard(tensor_pool.lock);
+        auto it = tensor_pool.free_blocks.find(bytes);
+        if (it != tensor_pool.free_blocks.end()) {
+            data = it->second;
+            header_of(data)->counted = true;
+            tensor_pool.pooled_bytes -= bytes;
+            tensor_pool.free_blocks.erase(it);
+            tensor_pool.reuses++;
+        } else {
+            pool_drop_free_blocks(bytes);
+            data = block_data_alloc(bytes, true);
+            tensor_pool.allocations++;
+        }
+        tensor_pool.live_bytes += bytes;
+        tensor_pool.peak_bytes = std::max(tensor_pool.peak_bytes, tensor_pool.live_bytes);
+    }
+
+    double **A = new double *[n];
+    A[0] = data;
+    for (size_t i = 1; i < n; i++) A[i] = A[0] + i * m;
+    memset(A[0], 0, sizeof(double) * n * m);
+    return A;
+}
+
+void free_aligned_block(double **A) {
+    if (!A) return;
+
+    BlockHeader *header = header_of(A[0]);
+    size_t bytes = header->bytes;
+    if (bytes < pool_min_bytes || (!header->counted && !tensor_pool.enabled)) {
+        block_data_free(A[0]);
+    } else {
+        std::lock_guard<std::mutex> guard(tensor_pool.lock);
+        if (header->counted) tensor_pool.live_bytes -= bytes;
+        header->counted = false;
+        if (tensor_pool.enabled && tensor_pool.live_bytes + tensor_pool.pooled_bytes + bytes <= tensor_pool.limit) {
+            tensor_pool.free_blocks.emplace(bytes, A[0]);
+            tensor_pool.pooled_bytes += bytes;
+        } else {
+            block_data_free(A[0]);
+        }
+    }
+    delete[] A;
+}
+
+// Edge of the square tiles in the transposing sorts
+const int sort_tile = 32;
+
+}  // namespace
+
+void tensor_pool_enable(size_t limit) {
+    std::lock_guard<std::mutex> guard(tensor_pool.lock);
+    tensor_pool.enabled = true;
+    tensor_pool.limit = limit;
+    tensor_pool.peak_bytes = tensor_pool.live_bytes;
+    tensor_pool.reuses = 0;
+    tensor_pool.allocations = 0;
+}
+
+void tensor_pool_disable() {
+    std::lock_guard<std::mutex> guard(tensor_pool.lock);
+    tensor_pool.enabled = false;
+    for (auto &block : tensor_pool.free_blocks) block_data_free(block.second);
+    tensor_pool.free_blocks.clear();
+    tensor_pool.pooled_bytes = 0;
+}
+
+void tensor_pool_print() {
+    std::lock_guard<std::mutex> guard(tensor_pool.lock);
+    outfile->Printf("\n\tTensor pool: %zu blocks reused, %zu allocated, peak memory of pooled sizes %9.2lf MB \n",
+                    tensor_pool.reuses, tensor_pool.allocations, tensor_pool.peak_bytes / (1024.0 * 1024.0));
+}
+
 /********************************************************************************************/
 /************************** 1d array ********************************************************/
 /********************************************************************************************/
@@ -522,7 +679,7 @@ Tensor2d::Tensor2d(std::string name, int d1, int d2, int d3, int d4) {
 
     // memalloc
     if (A2d_) release();
-    A2d_ = block_matrix(dim1_, dim2_);
+    A2d_ = aligned_block(dim1_, dim2_);
     zero();
 
     // row idx
@@ -577,7 +734,7 @@ Tensor2d::Tensor2d(std::string name, int d1, int d2, int d3) {
 
     // memalloc
     if (A2d_) release();
-    A2d_ = block_matrix(dim1_, dim2_);
+    A2d_ = aligned_block(dim1_, dim2_);
     zero();
 
     // col idx
@@ -602,14 +759,14 @@ Tensor2d::~Tensor2d() { release(); }  //
 
 void Tensor2d::memalloc() {
     if (A2d_) release();
-    A2d_ = block_matrix(dim1_, dim2_);
+    A2d_ = aligned_block(dim1_, dim2_);
     zero();
 }  //
 
 void Tensor2d::release() {
     // if (!A2d_) return;
     // free_block(A2d_);
-    if (A2d_) free_block(A2d_);
+    if (A2d_) free_aligned_block(A2d_);
     if (row_idx_) free_int_matrix(row_idx_);
     if (col_idx_) free_int_matrix(col_idx_);
     if (row2d1_) delete[] row2d1_;
@@ -630,7 +787,7 @@ void Tensor2d::init(int d1, int d2) {
     dim1_ = d1;
     dim2_ = d2;
     if (A2d_) release();
-    A2d_ = block_matrix(dim1_, dim2_);
+    A2d_ = aligned_block(dim1_, dim2_);
 }  //
 
 void Tensor2d::init(std::string name, int d1, int d2) {
@@ -638,7 +795,7 @@ void Tensor2d::init(std::string name, int d1, int d2) {
     dim2_ = d2;
     name_ = name;
     if (A2d_) release();
-    A2d_ = block_matrix(dim1_, dim2_);
+    A2d_ = aligned_block(dim1_, dim2_);
 }  //
 
 void Tensor2d::zero() { memset(A2d_[0], 0, sizeof(double) * dim1_ * dim2_); }  //
@@ -2505,16 +2662,16 @@ void Tensor2d::sort(int sort_type, const SharedTensor2d &A, double alpha, double
     }
 
     else if (sort_type == 1324) {
-#pragma omp parallel for
+        // s is contiguous in both tensors, each thread owns the rows pr
+#pragma omp parallel for collapse(2)
         for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
+            for (int r = 0; r < d3; r++) {
+                double *Tpr = A2d_[row_idx_[p][r]];
+                for (int q = 0; q < d2; q++) {
+                    const double *Apq = &A->A2d_[A->row_idx_[p][q]][A->col_idx_[r][0]];
+                    double *Tprq = &Tpr[col_idx_[q][0]];
                     for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int pr = row_idx_[p][r];
-                        int qs = col_idx_[q][s];
-                        A2d_[pr][qs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pr][qs]);
+                        Tprq[s] = (alpha * Apq[s]) + (beta * Tprq[s]);
                     }
                 }
             }
@@ -2556,16 +2713,21 @@ void Tensor2d::sort(int sort_type, const SharedTensor2d &A, double alpha, double
     }
 
     else if (sort_type == 1432) {
-#pragma omp parallel for
+        // q <-> s transpose for each (p,r), in tiles so that both sides stay in cache
+#pragma omp parallel for collapse(2)
         for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    int rq = col_idx_[r][q];
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = row_idx_[p][s];
-                        A2d_[ps][rq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[ps][rq]);
+            for (int r = 0; r < d3; r++) {
+                for (int q0 = 0; q0 < d2; q0 += sort_tile) {
+                    int q1 = std::min(q0 + sort_tile, d2);
+                    for (int s0 = 0; s0 < d4; s0 += sort_tile) {
+                        int s1 = std::min(s0 + sort_tile, d4);
+                        for (int s = s0; s < s1; s++) {
+                            double *Tpsr = &A2d_[row_idx_[p][s]][col_idx_[r][0]];
+                            for (int q = q0; q < q1; q++) {
+                                double Apqrs = A->A2d_[A->row_idx_[p][q]][A->col_idx_[r][s]];
+                                Tpsr[q] = (alpha * Apqrs) + (beta * Tpsr[q]);
+                            }
+                        }
                     }
                 }
             }
@@ -2978,18 +3140,21 @@ void Tensor2d::apply_denom(int frzc, int occ, const SharedTensor2d &fock) {
     int aocc = d1_;
     int avir = d3_;
 
-#pragma omp parallel for
+    // contiguous diagonals, so that the b loop runs over unit-stride data
+    std::vector<double> eps_o(aocc), eps_v(avir);
+    for (int i = 0; i < aocc; i++) eps_o[i] = fock->A2d_[i + frzc][i + frzc];
+    for (int a = 0; a < avir; a++) eps_v[a] = fock->A2d_[a + occ][a + occ];
+
+#pragma omp parallel for collapse(2)
     for (int i = 0; i < aocc; i++) {
-        double di = fock->A2d_[i + frzc][i + frzc];
         for (int j = 0; j < aocc; j++) {
-            double dij = di + fock->A2d_[j + frzc][j + frzc];
-            int ij = row_idx_[i][j];
+            double dij = eps_o[i] + eps_o[j];
+            double *Tij = A2d_[row_idx_[i][j]];
             for (int a = 0; a < avir; a++) {
-                double dija = dij - fock->A2d_[a + occ][a + occ];
+                double dija = dij - eps_v[a];
+                double *Tija = &Tij[col_idx_[a][0]];
                 for (int b = 0; b < avir; b++) {
-                    double dijab = dija - fock->A2d_[b + occ][b + occ];
-                    int ab = col_idx_[a][b];
-                    A2d_[ij][ab] /= dijab;
+                    Tija[b] /= (dija - eps_v[b]);
                 }
             }
         }
@@ -3002,18 +3167,22 @@ void Tensor2d::apply_denom_os(int frzc, int occA, int occB, const SharedTensor2d
     int avirA = d3_;
     int avirB = d4_;
 
-#pragma omp parallel for
+    std::vector<double> eps_oA(aoccA), eps_oB(aoccB), eps_vA(avirA), eps_vB(avirB);
+    for (int i = 0; i < aoccA; i++) eps_oA[i] = fockA->A2d_[i + frzc][i + frzc];
+    for (int j = 0; j < aoccB; j++) eps_oB[j] = fockB->A2d_[j + frzc][j + frzc];
+    for (int a = 0; a < avirA; a++) eps_vA[a] = fockA->A2d_[a + occA][a + occA];
+    for (int b = 0; b < avirB; b++) eps_vB[b] = fockB->A2d_[b + occB][b + occB];
+
+#pragma omp parallel for collapse(2)
     for (int i = 0; i < aoccA; i++) {
-        double di = fockA->A2d_[i + frzc][i + frzc];
         for (int j = 0; j < aoccB; j++) {
-            double dij = di + fockB->A2d_[j + frzc][j + frzc];
-            int ij = row_idx_[i][j];
+            double dij = eps_oA[i] + eps_oB[j];
+            double *Tij = A2d_[row_idx_[i][j]];
             for (int a = 0; a < avirA; a++) {
-                double dija = dij - fockA->A2d_[a + occA][a + occA];
+                double dija = dij - eps_vA[a];
+                double *Tija = &Tij[col_idx_[a][0]];
                 for (int b = 0; b < avirB; b++) {
-                    double dijab = dija - fockB->A2d_[b + occB][b + occB];
-                    int ab = col_idx_[a][b];
-                    A2d_[ij][ab] /= dijab;
+                    Tija[b] /= (dija - eps_vB[b]);
                 }
             }
         }
@@ -3024,18 +3193,20 @@ void Tensor2d::apply_denom_chem(int frzc, int occ, const SharedTensor2d &fock) {
     int aocc = d1_;
     int avir = d2_;
 
-#pragma omp parallel for
+    std::vector<double> eps_o(aocc), eps_v(avir);
+    for (int i = 0; i < aocc; i++) eps_o[i] = fock->A2d_[i + frzc][i + frzc];
+    for (int a = 0; a < avir; a++) eps_v[a] = fock->A2d_[a + occ][a + occ];
+
+#pragma omp parallel for collapse(2)
     for (int i = 0; i < aocc; i++) {
-        double di = fock->A2d_[i + frzc][i + frzc];
         for (int a = 0; a < avir; a++) {
-            double dia = di - fock->A2d_[a + occ][a + occ];
-            int ia = row_idx_[i][a];
+            double dia = eps_o[i] - eps_v[a];
+            double *Tia = A2d_[row_idx_[i][a]];
             for (int j = 0; j < aocc; j++) {
-                double diaj = dia + fock->A2d_[j + frzc][j + frzc];
+                double diaj = dia + eps_o[j];
+                double *Tiaj = &Tia[col_idx_[j][0]];
                 for (int b = 0; b < avir; b++) {
-                    double diajb = diaj - fock->A2d_[b + occ][b + occ];
-                    int jb = col_idx_[j][b];
-                    A2d_[ia][jb] /= diajb;
+                    Tiaj[b] /= (diaj - eps_v[b]);
                 }
             }
         }
@@ -3890,12 +4061,12 @@ void Tensor2d::symm_packed(const SharedTensor2d &A) {
 #pragma omp parallel for
     for (int R = 0; R < A->d1_; R++) {
         for (int p = 0; p < A->d2_; p++) {
-            for (int q = 0; q <= p; q++) {
-                int pq = A->col_idx_[p][q];
-                int pq_sym = index2(p, q);
-                double perm = (p == q ? 1.0 : 2.0);
-                A2d_[R][pq_sym] = perm * A->get(R, pq);
+            const double *Ap = &A->A2d_[R][A->col_idx_[p][0]];
+            double *Tp = &A2d_[R][index2(p, 0)];
+            for (int q = 0; q < p; q++) {
+                Tp[q] = 2.0 * Ap[q];
             }
+            Tp[p] = Ap[p];
         }
     }
 
@@ -4076,18 +4247,20 @@ void Tensor2d::antisymm_col4(const SharedTensor2d &a) {
 }  //
 
 void Tensor2d::symm_row_packed4(const SharedTensor2d &a) {
-#pragma omp parallel for
+// rows of the lower triangle grow with i, so hand them out dynamically
+#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < a->d1_; i++) {
         for (int j = 0; j <= i; j++) {
             int ij = a->row_idx_[i][j];
             int ji = a->row_idx_[j][i];
             int ij2 = index2(i, j);
-            double perm = (i == j ? 1.0 : 2.0);
+            double perm = (i == j ? 0.5 : 1.0);
             for (int k = 0; k < a->d3_; k++) {
+                const double *Aijk = &a->A2d_[ij][a->col_idx_[k][0]];
+                const double *Ajik = &a->A2d_[ji][a->col_idx_[k][0]];
+                double *Tijk = &A2d_[ij2][index2(k, 0)];
                 for (int l = 0; l <= k; l++) {
-                    int kl = a->col_idx_[k][l];
-                    int kl2 = index2(k, l);
-                    A2d_[ij2][kl2] = 0.5 * perm * (a->get(ij, kl) + a->get(ji, kl));
+                    Tijk[l] = perm * (Aijk[l] + Ajik[l]);
                 }
             }
         }
@@ -4095,37 +4268,41 @@ void Tensor2d::symm_row_packed4(const SharedTensor2d &a) {
 }  //
 
 void Tensor2d::symm_col_packed4(const SharedTensor2d &a) {
-#pragma omp parallel for
+// rows of the lower triangle grow with i, so hand them out dynamically
+#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < a->d1_; i++) {
         for (int j = 0; j <= i; j++) {
             int ij = a->row_idx_[i][j];
             int ji = a->row_idx_[j][i];
             int ij2 = index2(i, j);
             for (int k = 0; k < a->d3_; k++) {
-                for (int l = 0; l <= k; l++) {
-                    int kl = a->col_idx_[k][l];
-                    int kl2 = index2(k, l);
-                    double perm = (k == l ? 1.0 : 2.0);
-                    A2d_[ij2][kl2] = 0.5 * perm * (a->get(ij, kl) + a->get(ji, kl));
+                const double *Aijk = &a->A2d_[ij][a->col_idx_[k][0]];
+                const double *Ajik = &a->A2d_[ji][a->col_idx_[k][0]];
+                double *Tijk = &A2d_[ij2][index2(k, 0)];
+                for (int l = 0; l < k; l++) {
+                    Tijk[l] = Aijk[l] + Ajik[l];
                 }
+                Tijk[k] = 0.5 * (Aijk[k] + Ajik[k]);
             }
         }
     }
 }  //
 
 void Tensor2d::antisymm_row_packed4(const SharedTensor2d &a) {
-#pragma omp parallel for
+// rows of the lower triangle grow with i, so hand them out dynamically
+#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < a->d1_; i++) {
         for (int j = 0; j <= i; j++) {
             int ij = a->row_idx_[i][j];
             int ji = a->row_idx_[j][i];
             int ij2 = index2(i, j);
-            double perm = (i == j ? 1.0 : 2.0);
+            double perm = (i == j ? 0.5 : 1.0);
             for (int k = 0; k < a->d3_; k++) {
+                const double *Aijk = &a->A2d_[ij][a->col_idx_[k][0]];
+                const double *Ajik = &a->A2d_[ji][a->col_idx_[k][0]];
+                double *Tijk = &A2d_[ij2][index2(k, 0)];
                 for (int l = 0; l <= k; l++) {
-                    int kl = a->col_idx_[k][l];
-                    int kl2 = index2(k, l);
-                    A2d_[ij2][kl2] = 0.5 * perm * (a->get(ij, kl) - a->get(ji, kl));
+                    Tijk[l] = perm * (Aijk[l] - Ajik[l]);
                 }
             }
         }
@@ -4133,19 +4310,21 @@ void Tensor2d::antisymm_row_packed4(const SharedTensor2d &a) {
 }  //
 
 void Tensor2d::antisymm_col_packed4(const SharedTensor2d &a) {
-#pragma omp parallel for
+// rows of the lower triangle grow with i, so hand them out dynamically
+#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < a->d1_; i++) {
         for (int j = 0; j <= i; j++) {
             int ij = a->row_idx_[i][j];
             int ji = a->row_idx_[j][i];
             int ij2 = index2(i, j);
             for (int k = 0; k < a->d3_; k++) {
-                for (int l = 0; l <= k; l++) {
-                    int kl = a->col_idx_[k][l];
-                    int kl2 = index2(k, l);
-                    double perm = (k == l ? 1.0 : 2.0);
-                    A2d_[ij2][kl2] = 0.5 * perm * (a->get(ij, kl) - a->get(ji, kl));
+                const double *Aijk = &a->A2d_[ij][a->col_idx_[k][0]];
+                const double *Ajik = &a->A2d_[ji][a->col_idx_[k][0]];
+                double *Tijk = &A2d_[ij2][index2(k, 0)];
+                for (int l = 0; l < k; l++) {
+                    Tijk[l] = Aijk[l] - Ajik[l];
                 }
+                Tijk[k] = 0.5 * (Aijk[k] - Ajik[k]);
             }
         }
     }
@@ -50,6 +50,13 @@ class Tensor1d;
 class Tensor2d;
 class Tensor3d;
 class Tensor1i;
+
+// Recycling of freed Tensor2d storage between iterations. Live and pooled memory together stay below limit bytes.
+void tensor_pool_enable(size_t limit);
+// Turn recycling off and free the pooled blocks
+void tensor_pool_disable();
+// Blocks reused and allocated since tensor_pool_enable, and peak live memory of tensors of pooled sizes
+void tensor_pool_print();
 class Tensor2i;
 class Tensor3i;
 
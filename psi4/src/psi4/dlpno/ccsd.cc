@@ -0,0 +1,1277 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "ccsd.h"
+#include "sparse.h"
+
+#include "psi4/libdiis/diismanager.h"
+#include "psi4/libfock/jk.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <tuple>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+namespace dlpno {
+
+// defined in mp2.cc
+void C_DGESV_wrapper(SharedMatrix A, SharedMatrix B);
+SharedVector flatten_mats(const std::vector<SharedMatrix>& mat_list);
+void copy_flat_mats(SharedVector flat, std::vector<SharedMatrix>& mat_list);
+
+namespace {
+
+/* C(m,n) = sum_Q A(Q,m) B(Q,n) for three-index blocks stored with the aux index slowest */
+std::vector<double> contract_aux(std::vector<double>& A, size_t m, std::vector<double>& B, size_t n, size_t naux) {
+    std::vector<double> C(m * n, 0.0);
+    C_DGEMM('T', 'N', m, n, naux, 1.0, A.data(), m, B.data(), n, 0.0, C.data(), n);
+    return C;
+}
+
+/* Split fitted (Q|pq) over a local space of o LMOs followed by v virtuals (naux x n^2) into
+ * its (Q|kl), (Q|kc), (Q|ck), and (Q|cd) blocks
+ */
+void split_local_ints(size_t o, size_t v, size_t naux, const double* B, std::vector<double>& Qoo,
+                      std::vector<double>& Qov, std::vector<double>& Qvo, std::vector<double>& Qvv) {
+    size_t n = o + v, oo = o * o, ov = o * v, vv = v * v;
+    Qoo.resize(naux * oo);
+    Qov.resize(naux * ov);
+    Qvo.resize(naux * ov);
+    Qvv.resize(naux * vv);
+    for (size_t Q = 0; Q < naux; Q++) {
+        const double* BQ = &B[Q * n * n];
+        for (size_t k = 0; k < o; k++) {
+            for (size_t l = 0; l < o; l++) Qoo[Q * oo + k * o + l] = BQ[k * n + l];
+            for (size_t c = 0; c < v; c++) {
+                Qov[Q * ov + k * v + c] = BQ[k * n + o + c];
+                Qvo[Q * ov + c * o + k] = BQ[(o + c) * n + k];
+            }
+        }
+        for (size_t c = 0; c < v; c++) {
+            for (size_t d = 0; d < v; d++) Qvv[Q * vv + c * v + d] = BQ[(o + c) * n + o + d];
+        }
+    }
+}
+
+/* (Q|pk) for a fixed LMO k of a block (Q|pq) stored as naux x np x nq, as naux x np */
+std::vector<double> fix_column(const std::vector<double>& Qpq, size_t naux, size_t np, size_t nq, size_t k) {
+    std::vector<double> Qp(naux * np);
+    for (size_t Q = 0; Q < naux; Q++) {
+        for (size_t p = 0; p < np; p++) Qp[Q * np + p] = Qpq[(Q * np + p) * nq + k];
+    }
+    return Qp;
+}
+
+/* Closed-shell CCSD residual of the LMO pair at positions (i, j) of a local space of o LMOs
+ * and v virtuals, in the T1-dressed formulation (Koch et al., JCP 100, 4393, 1994; the same
+ * terms as fnocc's DF-CCSD), with the occupied sums running over the LMOs of the space.
+ * All singles contributions enter through the dressed integrals and Fock matrix, which keep
+ * their off-diagonal occupied blocks, so the equations hold for the non-canonical LMOs.
+ *
+ *   B:  fitted (Q|pq) over the LMOs followed by the virtuals (naux x n^2, n = o + v)
+ *   F:  T1-dressed Fock matrix (n x n)
+ *   t1: singles of the LMOs (o x v); t2: doubles of the LMO pairs (o x o x v x v)
+ *
+ * The doubles residual (v x v, including the diagonal Fock terms) is returned in r2, and
+ * for i == j the singles residual of i in r1, if given.
+ */
+void pair_residual(size_t o, size_t v, size_t naux, size_t i, size_t j, const double* B, const double* F,
+                   std::vector<double>& t1, std::vector<double>& t2, std::vector<double>& r2,
+                   std::vector<double>* r1) {
+    size_t n = o + v, nn = n * n, oo = o * o, ov = o * v, vv = v * v;
+
+    r2.assign(vv, 0.0);
+    if (r1) r1->assign(v, 0.0);
+    if (v == 0) return;
+
+    //                                              //
+    // ==> T1-dressed integrals and Fock matrix <== //
+    //                                              //
+
+    // C_L = C (1 - t1^T) and C_R = C (1 + t1)
+    std::vector<double> XL(nn, 0.0), XR(nn, 0.0);
+    for (size_t p = 0; p < n; p++) XL[p * n + p] = XR[p * n + p] = 1.0;
+    for (size_t k = 0; k < o; k++) {
+        for (size_t a = 0; a < v; a++) {
+            XL[k * n + o + a] = -t1[k * v + a];
+            XR[(o + a) * n + k] = t1[k * v + a];
+        }
+    }
+
+    std::vector<double> Qoo, Qov, Qvo, Qvv;
+    {
+        std::vector<double> B_t1(naux * nn), temp(nn);
+        for (size_t Q = 0; Q < naux; Q++) {
+            C_DGEMM('T', 'N', n, n, n, 1.0, XL.data(), n, const_cast<double*>(&B[Q * nn]), n, 0.0, temp.data(), n);
+            C_DGEMM('N', 'N', n, n, n, 1.0, temp.data(), n, XR.data(), n, 0.0, &B_t1[Q * nn], n);
+        }
+        split_local_ints(o, v, naux, B_t1.data(), Qoo, Qov, Qvo, Qvv);
+    }
+
+    std::vector<double> Foo(oo), Fov(ov), Fvo(ov), Fvv(vv);
+    for (size_t k = 0; k < o; k++) {
+        for (size_t l = 0; l < o; l++) Foo[k * o + l] = F[k * n + l];
+        for (size_t a = 0; a < v; a++) {
+            Fov[k * v + a] = F[k * n + o + a];
+            Fvo[a * o + k] = F[(o + a) * n + k];
+        }
+    }
+    for (size_t a = 0; a < v; a++) {
+        for (size_t b = 0; b < v; b++) Fvv[a * v + b] = F[(o + a) * n + o + b];
+    }
+
+    // (kc|ld), and L(kc,ld) = 2 (kc|ld) - (kd|lc)
+    auto K = contract_aux(Qov, ov, Qov, ov, naux);
+    std::vector<double> L(ov * ov);
+    for (size_t k = 0; k < o; k++) {
+        for (size_t c = 0; c < v; c++) {
+            for (size_t l = 0; l < o; l++) {
+                for (size_t d = 0; d < v; d++) {
+                    L[(k * v + c) * ov + l * v + d] =
+                        2.0 * K[(k * v + c) * ov + l * v + d] - K[(k * v + d) * ov + l * v + c];
+                }
+            }
+        }
+    }
+
+    // u(kl,ab) = 2 t(kl,ab) - t(kl,ba)
+    std::vector<double> u2(oo * vv);
+    for (size_t kl = 0; kl < oo; kl++) {
+        for (size_t a = 0; a < v; a++) {
+            for (size_t b = 0; b < v; b++) {
+                u2[(kl * v + a) * v + b] = 2.0 * t2[(kl * v + a) * v + b] - t2[(kl * v + b) * v + a];
+            }
+        }
+    }
+
+    //                       //
+    // ==> Intermediates <== //
+    //                       //
+
+    // F'(bc) = F(bc) - u(kl,bd) (ld|kc)
+    std::vector<double> Fvv_t(Fvv);
+    for (size_t k = 0; k < o; k++) {
+        for (size_t l = 0; l < o; l++) {
+            C_DGEMM('N', 'N', v, v, v, -1.0, &u2[(k * o + l) * vv], v, &K[l * v * ov + k * v], ov, 1.0,
+                    Fvv_t.data(), v);
+        }
+    }
+
+    // F'(kj) = F(kj) + u(lj,cd) (kd|lc)
+    std::vector<double> Foo_t(Foo);
+    for (size_t k = 0; k < o; k++) {
+        for (size_t m = 0; m < o; m++) {
+            double val = 0.0;
+            for (size_t l = 0; l < o; l++) {
+                const double* u_lm = &u2[(l * o + m) * vv];
+                for (size_t c = 0; c < v; c++) {
+                    for (size_t d = 0; d < v; d++) val += u_lm[c * v + d] * K[(k * v + d) * ov + l * v + c];
+                }
+            }
+            Foo_t[k * o + m] += val;
+        }
+    }
+
+    // For m = i, j:
+    // X(km,ac) = (km|ac) - 1/2 t(lm,ad) (kd|lc), stored [k][a][c]
+    // Y(am,kc) = L(am,kc) + 1/2 u(ml,ad) L(ld,kc), stored [a][k][c]
+    const size_t ij_occ[2] = {i, j};
+    std::vector<double> X[2], Y[2], Qoo_m[2], Qvo_m[2];
+    for (int x = 0; x < 2; x++) {
+        size_t m = ij_occ[x];
+        Qoo_m[x] = fix_column(Qoo, naux, o, o, m);
+        Qvo_m[x] = fix_column(Qvo, naux, v, o, m);
+
+        // (km|ac)
+        std::vector<double> J(ov * v, 0.0);
+        C_DGEMM('T', 'N', o, vv, naux, 1.0, Qoo_m[x].data(), o, Qvv.data(), vv, 0.0, J.data(), vv);
+
+        X[x] = J;
+        for (size_t k = 0; k < o; k++) {
+            for (size_t l = 0; l < o; l++) {
+                C_DGEMM('N', 'N', v, v, v, -0.5, &t2[(l * o + m) * vv], v, &K[k * v * ov + l * v], ov, 1.0,
+                        &X[x][k * vv], v);
+            }
+        }
+
+        Y[x].assign(v * ov, 0.0);
+        C_DGEMM('T', 'N', v, ov, naux, 2.0, Qvo_m[x].data(), v, Qov.data(), ov, 0.0, Y[x].data(), ov);
+        for (size_t a = 0; a < v; a++) {
+            for (size_t k = 0; k < o; k++) {
+                for (size_t c = 0; c < v; c++) Y[x][a * ov + k * v + c] -= J[k * vv + a * v + c];
+            }
+        }
+        for (size_t l = 0; l < o; l++) {
+            C_DGEMM('N', 'N', v, ov, v, 0.5, &u2[(m * o + l) * vv], v, &L[l * v * ov], ov, 1.0, Y[x].data(), ov);
+        }
+    }
+
+    // W(kl,ij) = (ki|lj) + t(ij,cd) (kc|ld)
+    std::vector<double> W(oo, 0.0);
+    C_DGEMM('T', 'N', o, o, naux, 1.0, Qoo_m[0].data(), o, Qoo_m[1].data(), o, 0.0, W.data(), o);
+    const double* t_ij = &t2[(i * o + j) * vv];
+    for (size_t k = 0; k < o; k++) {
+        for (size_t l = 0; l < o; l++) {
+            double val = 0.0;
+            for (size_t c = 0; c < v; c++) {
+                for (size_t d = 0; d < v; d++) val += t_ij[c * v + d] * K[(k * v + c) * ov + l * v + d];
+            }
+            W[k * o + l] += val;
+        }
+    }
+
+    //                          //
+    // ==> Doubles residual <== //
+    //                          //
+
+    // Z(pq,ab) = -1/2 t(kq,bc) X(kp,ac) - t(kp,bc) X(kq,ac) + 1/2 u(qk,bc) Y(ap,kc)
+    //            + t(pq,ac) F'(bc) - t(pk,ab) F'(kq)
+    auto Z = [&](int x, int y) {
+        size_t p = ij_occ[x], q = ij_occ[y];
+        std::vector<double> Zpq(vv, 0.0);
+        for (size_t k = 0; k < o; k++) {
+            C_DGEMM('N', 'T', v, v, v, -0.5, &X[x][k * vv], v, &t2[(k * o + q) * vv], v, 1.0, Zpq.data(), v);
+            C_DGEMM('N', 'T', v, v, v, -1.0, &X[y][k * vv], v, &t2[(k * o + p) * vv], v, 1.0, Zpq.data(), v);
+            C_DGEMM('N', 'T', v, v, v, 0.5, &Y[x][k * v], ov, &u2[(q * o + k) * vv], v, 1.0, Zpq.data(), v);
+            C_DAXPY(vv, -Foo_t[k * o + q], &t2[(p * o + k) * vv], 1, Zpq.data(), 1);
+        }
+        C_DGEMM('N', 'T', v, v, v, 1.0, &t2[(p * o + q) * vv], v, Fvv_t.data(), v, 1.0, Zpq.data(), v);
+        return Zpq;
+    };
+
+    // R(ij,ab) = (ai|bj) + t(ij,cd) (ac|bd) + t(kl,ab) W(kl,ij) + Z(ij,ab) + Z(ji,ba)
+    C_DGEMM('T', 'N', v, v, naux, 1.0, Qvo_m[0].data(), v, Qvo_m[1].data(), v, 0.0, r2.data(), v);
+
+    std::vector<double> temp(vv);
+    for (size_t Q = 0; Q < naux; Q++) {
+        C_DGEMM('N', 'N', v, v, v, 1.0, &Qvv[Q * vv], v, &t2[(i * o + j) * vv], v, 0.0, temp.data(), v);
+        C_DGEMM('N', 'T', v, v, v, 1.0, temp.data(), v, &Qvv[Q * vv], v, 1.0, r2.data(), v);
+    }
+
+    for (size_t kl = 0; kl < oo; kl++) C_DAXPY(vv, W[kl], &t2[kl * vv], 1, r2.data(), 1);
+
+    auto Z_ij = Z(0, 1);
+    auto Z_ji = Z(1, 0);
+    for (size_t a = 0; a < v; a++) {
+        for (size_t b = 0; b < v; b++) r2[a * v + b] += Z_ij[a * v + b] + Z_ji[b * v + a];
+    }
+
+    //                          //
+    // ==> Singles residual <== //
+    //                          //
+
+    if (!r1 || i != j) return;
+
+    // R(i,a) = F(ai) + u(ik,dc) (ad|kc) - u(kl,ac) (ki|lc) + F(kc) u(ik,ac)
+    std::vector<double>& R1 = *r1;
+    for (size_t a = 0; a < v; a++) R1[a] = Fvo[a * o + i];
+
+    // G(Q,d) = (Q|kc) u(ik,dc)
+    std::vector<double> U_i(ov * v), G(naux * v, 0.0);
+    for (size_t k = 0; k < o; k++) {
+        for (size_t c = 0; c < v; c++) {
+            for (size_t d = 0; d < v; d++) U_i[(k * v + c) * v + d] = u2[(i * o + k) * vv + d * v + c];
+        }
+    }
+    C_DGEMM('N', 'N', naux, v, ov, 1.0, Qov.data(), ov, U_i.data(), v, 0.0, G.data(), v);
+    for (size_t Q = 0; Q < naux; Q++) {
+        for (size_t a = 0; a < v; a++) {
+            for (size_t d = 0; d < v; d++) R1[a] += Qvv[Q * vv + a * v + d] * G[Q * v + d];
+        }
+    }
+
+    // M(k,lc) = (ki|lc)
+    std::vector<double> M(o * ov, 0.0);
+    C_DGEMM('T', 'N', o, ov, naux, 1.0, Qoo_m[0].data(), o, Qov.data(), ov, 0.0, M.data(), ov);
+    for (size_t kl = 0; kl < oo; kl++) {
+        size_t k = kl / o, l = kl % o;
+        for (size_t a = 0; a < v; a++) {
+            for (size_t c = 0; c < v; c++) R1[a] -= u2[(kl * v + a) * v + c] * M[k * ov + l * v + c];
+        }
+    }
+
+    for (size_t k = 0; k < o; k++) {
+        for (size_t a = 0; a < v; a++) {
+            for (size_t c = 0; c < v; c++) R1[a] += Fov[k * v + c] * u2[((i * o + k) * v + a) * v + c];
+        }
+    }
+}
+
+/* Semicanonical (T0) energy of the distinct orderings of the LMO triple at positions pos of a
+ * local space of o LMOs and v virtuals with orbital energies e_vir: the (T) energy of Rendell,
+ * Lee, and Komornicki (CPL 178, 462, 1991) with the off-diagonal occupied Fock couplings
+ * neglected, so that the LMO triples decouple.
+ *
+ *   B:  fitted (Q|pq) over the LMOs followed by the virtuals (naux x n^2, n = o + v)
+ *   f:  Fock diagonals of the three LMOs
+ *   t1, t2: amplitudes as in pair_residual, only those of pairs with one of the three LMOs are used
+ */
+double triples_energy(size_t o, size_t v, size_t naux, const size_t pos[3], const double f[3], const double* B,
+                      const double* e_vir, std::vector<double>& t1, std::vector<double>& t2) {
+    size_t oo = o * o, vv = v * v, vvv = vv * v;
+    if (v == 0) return 0.0;
+
+    std::vector<double> Qoo, Qov, Qvo, Qvv;
+    split_local_ints(o, v, naux, B, Qoo, Qov, Qvo, Qvv);
+    Qov.clear();
+
+    // (Q|ap), (Q|pl), (ap|bd) as [a][b][d], and t(pl,ab) as [ab][l] for the three LMOs p
+    std::vector<double> Qvo_p[3], Qoo_p[3], A_p[3], T_p[3];
+    for (int x = 0; x < 3; x++) {
+        size_t p = pos[x];
+        Qvo_p[x] = fix_column(Qvo, naux, v, o, p);
+        Qoo_p[x].resize(naux * o);
+        for (size_t Q = 0; Q < naux; Q++) {
+            for (size_t l = 0; l < o; l++) Qoo_p[x][Q * o + l] = Qoo[Q * oo + p * o + l];
+        }
+        A_p[x].assign(vvv, 0.0);
+        C_DGEMM('T', 'N', v, vv, naux, 1.0, Qvo_p[x].data(), v, Qvv.data(), vv, 0.0, A_p[x].data(), vv);
+        T_p[x].resize(vv * o);
+        for (size_t l = 0; l < o; l++) {
+            for (size_t ab = 0; ab < vv; ab++) T_p[x][ab * o + l] = t2[(p * o + l) * vv + ab];
+        }
+    }
+    Qvv.clear();
+
+    // simultaneous permutations of (ia), (jb), (kc)
+    const int perms[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+
+    // W(ijk,abc) = P [ (ai|bd) t(kj,cd) - (ck|jl) t(il,ab) ]
+    std::vector<double> W(vvv, 0.0), X(vvv), C(v * o);
+    for (const auto& perm : perms) {
+        size_t q = pos[perm[1]], r = pos[perm[2]];
+        C_DGEMM('N', 'T', vv, v, v, 1.0, A_p[perm[0]].data(), v, &t2[(r * o + q) * vv], v, 0.0, X.data(), v);
+        std::fill(C.begin(), C.end(), 0.0);
+        C_DGEMM('T', 'N', v, o, naux, 1.0, Qvo_p[perm[2]].data(), v, Qoo_p[perm[1]].data(), o, 0.0, C.data(), o);
+        C_DGEMM('N', 'T', vv, v, o, -1.0, T_p[perm[0]].data(), o, C.data(), o, 1.0, X.data(), v);
+        for (size_t a = 0; a < v; a++) {
+            for (size_t b = 0; b < v; b++) {
+                for (size_t c = 0; c < v; c++) {
+                    size_t abc[3] = {a, b, c};
+                    W[(a * v + b) * v + c] += X[(abc[perm[0]] * v + abc[perm[1]]) * v + abc[perm[2]]];
+                }
+            }
+        }
+    }
+
+    // V(ijk,abc) = W(ijk,abc) + (bj|ck) t(i,a) + (ai|ck) t(j,b) + (ai|bj) t(k,c)
+    std::vector<double> I_jk(vv, 0.0), I_ik(vv, 0.0), I_ij(vv, 0.0);
+    C_DGEMM('T', 'N', v, v, naux, 1.0, Qvo_p[1].data(), v, Qvo_p[2].data(), v, 0.0, I_jk.data(), v);
+    C_DGEMM('T', 'N', v, v, naux, 1.0, Qvo_p[0].data(), v, Qvo_p[2].data(), v, 0.0, I_ik.data(), v);
+    C_DGEMM('T', 'N', v, v, naux, 1.0, Qvo_p[0].data(), v, Qvo_p[1].data(), v, 0.0, I_ij.data(), v);
+    const double* t_i = &t1[pos[0] * v];
+    const double* t_j = &t1[pos[1] * v];
+    const double* t_k = &t1[pos[2] * v];
+    std::vector<double>& V = X;
+    for (size_t a = 0; a < v; a++) {
+        for (size_t b = 0; b < v; b++) {
+            for (size_t c = 0; c < v; c++) {
+                V[(a * v + b) * v + c] = W[(a * v + b) * v + c] + I_jk[b * v + c] * t_i[a] +
+                                         I_ik[a * v + c] * t_j[b] + I_ij[a * v + b] * t_k[c];
+            }
+        }
+    }
+
+    // W and V of the ordering (pos[perm[0]], pos[perm[1]], pos[perm[2]]) at (y0, y1, y2) are those
+    // of (pos[0], pos[1], pos[2]) at x, with x[perm[m]] = y[m]
+    double e_t = 0.0;
+    double denom_occ = f[0] + f[1] + f[2];
+    std::vector<std::vector<size_t>> seen;
+    for (const auto& perm : perms) {
+        std::vector<size_t> ordering = {pos[perm[0]], pos[perm[1]], pos[perm[2]]};
+        if (std::find(seen.begin(), seen.end(), ordering) != seen.end()) continue;
+        seen.push_back(ordering);
+
+        auto index = [&](size_t y0, size_t y1, size_t y2) {
+            size_t x[3];
+            x[perm[0]] = y0;
+            x[perm[1]] = y1;
+            x[perm[2]] = y2;
+            return (x[0] * v + x[1]) * v + x[2];
+        };
+        for (size_t a = 0; a < v; a++) {
+            for (size_t b = 0; b < v; b++) {
+                for (size_t c = 0; c < v; c++) {
+                    double denom = denom_occ - e_vir[a] - e_vir[b] - e_vir[c];
+                    e_t += (4.0 * W[index(a, b, c)] + W[index(b, c, a)] + W[index(c, a, b)]) *
+                           (V[index(a, b, c)] - V[index(c, b, a)]) / (3.0 * denom);
+                }
+            }
+        }
+    }
+    return e_t;
+}
+
+}  // namespace
+
+DLPNOCCSD::DLPNOCCSD(SharedWavefunction ref_wfn, Options& options) : DLPNOMP2(ref_wfn, options) {
+    compute_triples_ = (options_.get_str("DLPNO_METHOD") == "CCSD_T");
+    // the CCSD iterations need every pair, and the (iu|Q) integrals of all of them
+    distribute_pairs_ = false;
+}
+DLPNOCCSD::~DLPNOCCSD() {}
+
+size_t DLPNOCCSD::cc_memory_doubles() {
+    size_t held = S_pno_data_.size();
+    for (const auto* mats : {&K_iajb_, &T_iajb_, &Tt_iajb_, &T_ia_, &B_pair_}) {
+        for (const auto& mat : *mats) held += mat ? mat->size() : 0;
+    }
+    for (const auto& S_ij : S_pair_) {
+        for (const auto& S : S_ij) held += S ? S->size() : 0;
+    }
+    for (const auto& mat : {G_ref_, F_t1_}) held += mat ? mat->size() : 0;
+
+    size_t total = memory_ / sizeof(double);
+    return (total > held) ? total - held : 0;
+}
+
+DLPNOCCSD::LocalSpace DLPNOCCSD::pair_space(int ij) {
+    LocalSpace space;
+    space.lmos = lmopair_to_lmos_[ij];
+    space.paos = lmopair_to_paos_[ij];
+    space.X = X_pno_[ij];
+    space.e_vir = e_pno_[ij];
+    space.ribfs = lmopair_to_ribfs_[ij];
+    space.riatoms = lmopair_to_riatoms_[ij];
+    return space;
+}
+
+DLPNOCCSD::LocalSpace DLPNOCCSD::triple_space(int i, int j, int k) {
+    const int pairs[3] = {i_j_to_ij_[i][j], i_j_to_ij_[j][k], i_j_to_ij_[i][k]};
+
+    LocalSpace space;
+    for (int l : lmopair_to_lmos_[pairs[0]]) {
+        if (i_j_to_ij_[k][l] != -1) space.lmos.push_back(l);
+    }
+    for (int ij : pairs) {
+        space.paos = merge_lists(space.paos, lmopair_to_paos_[ij]);
+        space.ribfs = merge_lists(space.ribfs, lmopair_to_ribfs_[ij]);
+        space.riatoms = merge_lists(space.riatoms, lmopair_to_riatoms_[ij]);
+    }
+
+    // the PNOs of the three pairs, in the PAOs of the triple
+    int npao = space.paos.size();
+    int nunion = n_pno_[pairs[0]] + n_pno_[pairs[1]] + n_pno_[pairs[2]];
+    auto C_union = std::make_shared<Matrix>("PNOs of ij, jk, and ik", npao, nunion);
+    for (int x = 0, offset = 0; x < 3; offset += n_pno_[pairs[x]], x++) {
+        int ij = pairs[x];
+        for (size_t u_ij = 0; u_ij < lmopair_to_paos_[ij].size(); u_ij++) {
+            int u = std::lower_bound(space.paos.begin(), space.paos.end(), lmopair_to_paos_[ij][u_ij]) -
+                    space.paos.begin();
+            for (int a = 0; a < n_pno_[ij]; a++) C_union->set(u, offset + a, X_pno_[ij]->get(u_ij, a));
+        }
+    }
+
+    if (nunion == 0) {
+        space.X = C_union;
+        space.e_vir = std::make_shared<Vector>("eigenvalues", 0);
+        return space;
+    }
+
+    // orthonormal, semicanonical virtuals spanning the union
+    auto S_pao = submatrix_rows_and_cols(*S_pao_, space.paos, space.paos);
+    auto F_pao = submatrix_rows_and_cols(*F_pao_, space.paos, space.paos);
+    SharedMatrix X_union;
+    std::tie(X_union, space.e_vir) = orthocanonicalizer(linalg::triplet(C_union, S_pao, C_union, true, false, false),
+                                                        linalg::triplet(C_union, F_pao, C_union, true, false, false));
+    space.X = linalg::doublet(C_union, X_union, false, false);
+    return space;
+}
+
+SharedMatrix DLPNOCCSD::space_overlap(const LocalSpace& space, int kl) {
+    auto S_pao = submatrix_rows_and_cols(*S_pao_, space.paos, lmopair_to_paos_[kl]);
+    return linalg::triplet(space.X, S_pao, X_pno_[kl], true, false, false);
+}
+
+std::vector<SharedMatrix> DLPNOCCSD::local_df_ints(const std::vector<LocalSpace>& spaces) {
+    int nbf = basisset_->nbf();
+    int natom = molecule_->natom();
+    int npao = C_pao_->colspi(0);
+    size_t nspace = spaces.size();
+
+    size_t nthread = 1;
+#ifdef _OPENMP
+    nthread = omp_get_max_threads();
+#endif
+
+    std::shared_ptr<IntegralFactory> factory =
+        std::make_shared<IntegralFactory>(ribasis_, BasisSet::zero_ao_basis_set(), basisset_, basisset_);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> eris(nthread);
+
+    eris[0] = std::shared_ptr<TwoBodyAOInt>(factory->eri());
+    for (size_t thread = 1; thread < nthread; thread++) {
+        eris[thread] = std::shared_ptr<TwoBodyAOInt>(eris.front()->clone());
+    }
+
+    // unfitted (Q|pq) of each space, and the spaces that need the aux functions of each atom
+    std::vector<SharedMatrix> B(nspace);
+    std::vector<SharedMatrix> T_space(nspace);  // LMOs and PAOs of the space -> LMOs and virtuals
+    std::vector<std::vector<int>> riatom_to_spaces(natom);
+    for (size_t s = 0; s < nspace; s++) {
+        int nlmo = spaces[s].lmos.size(), npao_s = spaces[s].paos.size(), nvir = spaces[s].X->colspi(0);
+        B[s] = std::make_shared<Matrix>("(Q|pq)", spaces[s].ribfs.size(), (nlmo + nvir) * (nlmo + nvir));
+        T_space[s] = std::make_shared<Matrix>("T", nlmo + npao_s, nlmo + nvir);
+        for (int l = 0; l < nlmo; l++) T_space[s]->set(l, l, 1.0);
+        for (int u = 0; u < npao_s; u++) {
+            for (int a = 0; a < nvir; a++) T_space[s]->set(nlmo + u, nlmo + a, spaces[s].X->get(u, a));
+        }
+        for (int centerQ : spaces[s].riatoms) riatom_to_spaces[centerQ].push_back(s);
+    }
+
+    // orbital basis functions near the extended domain of each aux atom, and the coefficients of its
+    // LMOs (refit to these functions, as in compute_df_ints) followed by its PAOs
+    auto SC_lmo = linalg::doublet(reference_wavefunction_->S(), C_lmo_, false, false);
+    std::vector<std::vector<int>> riatom_to_bfs(natom), riatom_to_shells(natom), riatom_to_pao_index(natom);
+    std::vector<SharedMatrix> C_slices(natom);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int centerQ = 0; centerQ < natom; centerQ++) {
+        if (riatom_to_spaces[centerQ].empty()) continue;
+
+        riatom_to_bfs[centerQ] = merge_lists(riatom_to_bfs1_[centerQ], riatom_to_bfs2_[centerQ]);
+        riatom_to_shells[centerQ] = merge_lists(riatom_to_shells1_[centerQ], riatom_to_shells2_[centerQ]);
+
+        auto C_lmo_slice = submatrix_rows_and_cols(*SC_lmo, riatom_to_bfs[centerQ], riatom_to_lmos_ext_[centerQ]);
+        auto S_aa =
+            submatrix_rows_and_cols(*reference_wavefunction_->S(), riatom_to_bfs[centerQ], riatom_to_bfs[centerQ]);
+        C_DGESV_wrapper(S_aa, C_lmo_slice);
+        auto C_pao_slice = submatrix_rows_and_cols(*C_pao_, riatom_to_bfs[centerQ], riatom_to_paos_ext_[centerQ]);
+        C_slices[centerQ] = linalg::horzcat({C_lmo_slice, C_pao_slice});
+
+        riatom_to_pao_index[centerQ] = std::vector<int>(npao, -1);
+        for (size_t u_ind = 0; u_ind < riatom_to_paos_ext_[centerQ].size(); u_ind++) {
+            riatom_to_pao_index[centerQ][riatom_to_paos_ext_[centerQ][u_ind]] = u_ind;
+        }
+    }
+
+    std::vector<int> shells;
+    for (int centerQ = 0; centerQ < natom; centerQ++) {
+        if (riatom_to_spaces[centerQ].empty()) continue;
+        shells.insert(shells.end(), atom_to_rishell_[centerQ].begin(), atom_to_rishell_[centerQ].end());
+    }
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int Q_ind = 0; Q_ind < (int)shells.size(); Q_ind++) {
+        int Q = shells[Q_ind];
+        int nq = ribasis_->shell(Q).nfunction();
+        int qstart = ribasis_->shell(Q).function_index();
+        int centerQ = ribasis_->shell_to_center(Q);
+
+        size_t thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        const auto& bf_map = riatom_to_bfs[centerQ];
+        int nbf_Q = bf_map.size();
+        int nlmo_Q = riatom_to_lmos_ext_[centerQ].size();
+        int nmo_Q = C_slices[centerQ]->colspi(0);
+
+        std::vector<int> bf_map_inv(nbf, -1);
+        for (int m_ind = 0; m_ind < nbf_Q; m_ind++) bf_map_inv[bf_map[m_ind]] = m_ind;
+
+        // (mn|Q) for all functions q of this shell, stored as [q][m][n]
+        std::vector<double> mnQ((size_t)nq * nbf_Q * nbf_Q, 0.0);
+        for (int M : riatom_to_shells[centerQ]) {
+            int nm = basisset_->shell(M).nfunction();
+            int mstart = basisset_->shell(M).function_index();
+            for (int N : riatom_to_shells[centerQ]) {
+                if (N > M) break;
+                int nn = basisset_->shell(N).nfunction();
+                int nstart = basisset_->shell(N).function_index();
+
+                eris[thread]->compute_shell(Q, 0, M, N);
+                const double* buffer = eris[thread]->buffer();
+
+                for (int q = 0, index = 0; q < nq; q++) {
+                    double* mnq = &mnQ[(size_t)q * nbf_Q * nbf_Q];
+                    for (int m = 0; m < nm; m++) {
+                        for (int n = 0; n < nn; n++, index++) {
+                            int m_ind = bf_map_inv[mstart + m], n_ind = bf_map_inv[nstart + n];
+                            mnq[(size_t)m_ind * nbf_Q + n_ind] = buffer[index];
+                            mnq[(size_t)n_ind * nbf_Q + m_ind] = buffer[index];
+                        }
+                    }
+                }
+            }
+        }
+
+        // C^T (mn|q) C over the LMOs and PAOs of the aux atom, gathered into each space
+        double** Cp = C_slices[centerQ]->pointer();
+        std::vector<double> temp((size_t)nbf_Q * nmo_Q), pq((size_t)nmo_Q * nmo_Q);
+        for (int q = 0; q < nq; q++) {
+            C_DGEMM('N', 'N', nbf_Q, nmo_Q, nbf_Q, 1.0, &mnQ[(size_t)q * nbf_Q * nbf_Q], nbf_Q, Cp[0], nmo_Q, 0.0,
+                    temp.data(), nmo_Q);
+            C_DGEMM('T', 'N', nmo_Q, nmo_Q, nbf_Q, 1.0, Cp[0], nmo_Q, temp.data(), nmo_Q, 0.0, pq.data(), nmo_Q);
+
+            for (int s : riatom_to_spaces[centerQ]) {
+                const auto& space = spaces[s];
+                auto row = std::lower_bound(space.ribfs.begin(), space.ribfs.end(), qstart + q);
+                if (row == space.ribfs.end() || *row != qstart + q) continue;
+
+                // LMOs and PAOs of the space, as indices into pq (-1 outside the extended domain)
+                std::vector<int> index;
+                for (int l : space.lmos) index.push_back(riatom_to_lmos_ext_dense_[centerQ][l]);
+                for (int u : space.paos) {
+                    int u_ind = riatom_to_pao_index[centerQ][u];
+                    index.push_back(u_ind == -1 ? -1 : nlmo_Q + u_ind);
+                }
+                int nsel = index.size();
+                auto pq_sel = std::make_shared<Matrix>(nsel, nsel);
+                for (int p = 0; p < nsel; p++) {
+                    if (index[p] == -1) continue;
+                    for (int r = 0; r < nsel; r++) {
+                        if (index[r] != -1) pq_sel->set(p, r, pq[(size_t)index[p] * nmo_Q + index[r]]);
+                    }
+                }
+                auto pq_space = linalg::triplet(T_space[s], pq_sel, T_space[s], true, false, false);
+                ::memcpy(B[s]->pointer()[row - space.ribfs.begin()], pq_space->pointer()[0],
+                         sizeof(double) * pq_space->size());
+            }
+        }
+    }
+
+    // B(Q|pq) = (Q|P)^-1/2 (P|pq) in the aux domain of each space
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t s = 0; s < nspace; s++) {
+        auto metric = submatrix_rows_and_cols(*full_metric_, spaces[s].ribfs, spaces[s].ribfs);
+        metric->power(-0.5, 1.0e-12);
+        B[s] = linalg::doublet(metric, B[s], false, false);
+    }
+
+    return B;
+}
+
+void DLPNOCCSD::project_amplitudes(const LocalSpace& space, const std::vector<SharedMatrix>& S,
+                                   const std::vector<int>& focus, std::vector<double>& t1, std::vector<double>& t2) {
+    size_t o = space.lmos.size(), v = space.X->colspi(0), vv = v * v;
+
+    t1.assign(o * v, 0.0);
+    t2.assign(o * o * vv, 0.0);
+    if (v == 0) return;
+
+    std::vector<bool> in_focus(o, focus.empty());
+    for (int k : focus) in_focus[k] = true;
+
+    for (size_t k = 0; k < o; k++) {
+        for (size_t l = 0; l <= k; l++) {
+            if (!in_focus[k] && !in_focus[l]) continue;
+            int kl = i_j_to_ij_[space.lmos[k]][space.lmos[l]];
+            if (kl == -1 || n_pno_[kl] == 0) continue;
+
+            auto S_kl = S.empty() ? space_overlap(space, kl) : S[k * o + l];
+            auto t_kl = linalg::triplet(S_kl, T_iajb_[kl], S_kl, false, false, true);
+            double** tp = t_kl->pointer();
+            for (size_t a = 0; a < v; a++) {
+                for (size_t b = 0; b < v; b++) {
+                    t2[(k * o + l) * vv + a * v + b] = tp[a][b];
+                    t2[(l * o + k) * vv + b * v + a] = tp[a][b];
+                }
+            }
+
+            if (k == l) {
+                auto t_k = linalg::doublet(S_kl, T_ia_[space.lmos[k]], false, false);
+                for (size_t a = 0; a < v; a++) t1[k * v + a] = t_k->get(a, 0);
+            }
+        }
+    }
+}
+
+void DLPNOCCSD::setup_cc() {
+    int n_lmo_pairs = ij_to_i_j_.size();
+
+    size_t nthread = 1;
+#ifdef _OPENMP
+    nthread = omp_get_max_threads();
+#endif
+
+    naocc_ = C_lmo_->colspi(0);
+
+    // the LMO/PAO integrals and PNO overlaps of DLPNO-MP2 are not needed anymore
+    qia_.clear();
+    qia_.shrink_to_fit();
+    S_pno_data_.clear();
+    S_pno_data_.shrink_to_fit();
+
+    // singles live in the PNOs of the diagonal pair
+    T_ia_.resize(naocc_);
+    for (int i = 0; i < naocc_; ++i) {
+        int ii = i_j_to_ij_[i][i];
+        if (ii == -1) throw PSIEXCEPTION("DLPNO-CCSD: diagonal LMO pair was screened out");
+        T_ia_[i] = std::make_shared<Matrix>("T1", n_pno_[ii], 1);
+    }
+
+    lmopair_to_lmos_.resize(n_lmo_pairs);
+    cc_pairs_.clear();
+    for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+        for (int k = 0; k < naocc_; ++k) {
+            if (i_j_to_ij_[i][k] != -1 && i_j_to_ij_[j][k] != -1) lmopair_to_lmos_[ij].push_back(k);
+        }
+        if (i <= j && n_pno_[ij] > 0) cc_pairs_.push_back(ij);
+    }
+
+    //                                        //
+    // ==> JK object for the dressed Fock <== //
+    //                                        //
+
+    // the DF-JK object gets at most a quarter of the memory, and keeps the rest of (Q|mn) on disk
+    jk_ = JK::build_JK(basisset_, ribasis_, options_, "DISK_DF");
+    size_t jk_memory = std::min(jk_->memory_estimate(), cc_memory_doubles() / 4);
+    jk_->set_memory(jk_memory);
+    jk_->set_do_J(true);
+    jk_->set_do_K(true);
+    jk_->set_print(0);
+    jk_->initialize();
+
+    auto C_docc = linalg::horzcat({reference_wavefunction_->Ca_subset("AO", "FROZEN_OCC"), C_lmo_});
+    jk_->C_left().clear();
+    jk_->C_right().clear();
+    jk_->C_left().push_back(C_docc);
+    jk_->C_right().push_back(C_docc);
+    jk_->compute();
+    G_ref_ = jk_->J()[0]->clone();
+    G_ref_->scale(2.0);
+    G_ref_->subtract(jk_->K()[0]);
+
+    F_t1_ = std::make_shared<Matrix>("T1-dressed Fock", naocc_ + C_pao_->colspi(0), naocc_ + C_pao_->colspi(0));
+
+    //                                                          //
+    // ==> Pair integrals and overlaps within the memory limit <== //
+    //                                                          //
+
+    size_t npairs = cc_pairs_.size();
+    std::vector<size_t> ints_size(npairs), overlap_size(npairs);
+    size_t ints_total = 0, overlap_total = 0, work_max = 0;
+    for (size_t n = 0; n < npairs; ++n) {
+        int ij = cc_pairs_[n];
+        size_t o = lmopair_to_lmos_[ij].size(), v = n_pno_[ij], nmo = o + v;
+        size_t naux = lmopair_to_ribfs_[ij].size();
+
+        ints_size[n] = naux * nmo * nmo;
+        overlap_size[n] = 0;
+        for (size_t k = 0; k < o; k++) {
+            for (size_t l = 0; l <= k; l++) {
+                int kl = i_j_to_ij_[lmopair_to_lmos_[ij][k]][lmopair_to_lmos_[ij][l]];
+                if (kl != -1) overlap_size[n] += v * n_pno_[kl];
+            }
+        }
+        ints_total += ints_size[n];
+        overlap_total += overlap_size[n];
+
+        // dressed integrals and their blocks, (kc|ld) and L(kc,ld), t2 and u2, the X and Y intermediates
+        work_max = std::max(work_max, 2 * ints_size[n] + 4 * o * o * v * v + 4 * o * v * v + 10 * nmo * nmo);
+    }
+    size_t work_total = nthread * work_max;
+    size_t available = cc_memory_doubles();
+    available -= std::min(available, jk_memory);
+
+    bool store_overlaps = (ints_total + overlap_total + work_total <= available);
+    bool store_ints = store_overlaps || (ints_total + work_total <= available);
+    if (!store_ints) store_overlaps = (overlap_total + work_total <= available / 2);
+    if (options_.get_str("DLPNO_CC_ALGORITHM") == "DIRECT") store_ints = store_overlaps = false;
+
+    size_t batch_memory = available - std::min(available, work_total + (store_overlaps ? overlap_total : 0));
+    pair_batch_ = npairs;
+    if (!store_ints) {
+        size_t ints_max = *std::max_element(ints_size.begin(), ints_size.end());
+        if (ints_max > batch_memory) {
+            throw PSIEXCEPTION("DLPNO-CCSD: not enough memory for the integrals of a single LMO pair (" +
+                               std::to_string((ints_max + work_total) * sizeof(double) / (1024 * 1024) + 1) +
+                               " MiB needed beyond the DLPNO-MP2 amplitudes)");
+        }
+        // a fixed number of pairs per batch, so that the batches of every iteration are the same
+        size_t batch_size = 0;
+        pair_batch_ = 0;
+        for (size_t n = 0; n < npairs; ++n) {
+            if (batch_size + ints_size[n] > batch_memory) break;
+            batch_size += ints_size[n];
+            pair_batch_++;
+        }
+        pair_batch_ = std::max((size_t)1, std::min(pair_batch_, batch_memory / ints_max));
+    }
+
+    if (store_overlaps) {
+        S_pair_.assign(n_lmo_pairs, {});
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t n = 0; n < npairs; ++n) {
+            int ij = cc_pairs_[n];
+            const auto& lmos = lmopair_to_lmos_[ij];
+            size_t o = lmos.size();
+            S_pair_[ij].resize(o * o);
+            for (size_t k = 0; k < o; k++) {
+                for (size_t l = 0; l <= k; l++) {
+                    int kl = i_j_to_ij_[lmos[k]][lmos[l]];
+                    if (kl != -1) S_pair_[ij][k * o + l] = pno_overlap(ij, kl);
+                }
+            }
+        }
+    }
+
+    if (store_ints) {
+        std::vector<LocalSpace> spaces;
+        for (int ij : cc_pairs_) spaces.push_back(pair_space(ij));
+        B_pair_ = local_df_ints(spaces);
+    }
+
+    outfile->Printf("\n  ==> Preparing Local CCSD <==\n\n");
+    outfile->Printf("    Active LMOs:             %5d\n", naocc_);
+    outfile->Printf("    LMO pairs (i <= j):      %5zu\n", npairs);
+    outfile->Printf("    Memory available:        %8.1f MiB\n", available * sizeof(double) / (1024.0 * 1024.0));
+    outfile->Printf("    Pair integrals:          %8.1f MiB, %s\n", ints_total * sizeof(double) / (1024.0 * 1024.0),
+                    store_ints ? "stored" : "recomputed each iteration");
+    if (!store_ints) outfile->Printf("      (%zu pairs per batch)\n", pair_batch_);
+    outfile->Printf("    PNO overlaps:            %8.1f MiB, %s\n", overlap_total * sizeof(double) / (1024.0 * 1024.0),
+                    store_overlaps ? "stored" : "computed on the fly");
+}
+
+/* T1-dressed Fock matrix F(pq) = h(p~ q~) + sum_k 2 (p~ q~|k~ k~) - (p~ k~|k~ q~), in the LMOs and PAOs,
+ * with C_L = C (1 - t1^T) and C_R = C (1 + t1). The singles are taken to the AO basis, tau_i = C_pno t_i,
+ * so that C_L(lmo) = C_lmo, C_L(pao) = C_pao - C_lmo tau^T S C_pao, C_R(lmo) = C_lmo + tau, and C_R(pao) = C_pao.
+ * The reference Fock matrix is dressed exactly; only the change of G enters through the fitted integrals.
+ */
+void DLPNOCCSD::dress_fock() {
+    int nbf = basisset_->nbf();
+
+    auto tau = std::make_shared<Matrix>("AO singles", nbf, naocc_);
+    for (int i = 0; i < naocc_; ++i) {
+        int ii = i_j_to_ij_[i][i];
+        if (n_pno_[ii] == 0) continue;
+        auto C_pno = linalg::doublet(submatrix_cols(*C_pao_, lmopair_to_paos_[ii]), X_pno_[ii], false, false);
+        auto tau_i = linalg::doublet(C_pno, T_ia_[i], false, false);
+        for (int m = 0; m < nbf; ++m) tau->set(m, i, tau_i->get(m, 0));
+    }
+
+    auto C_focc = reference_wavefunction_->Ca_subset("AO", "FROZEN_OCC");
+    auto C_lmo_t1 = C_lmo_->clone();
+    C_lmo_t1->add(tau);
+
+    jk_->C_left().clear();
+    jk_->C_right().clear();
+    jk_->C_left().push_back(linalg::horzcat({C_focc, C_lmo_t1}));
+    jk_->C_right().push_back(linalg::horzcat({C_focc, C_lmo_}));
+    jk_->compute();
+
+    auto F_ao = reference_wavefunction_->Fa()->clone();
+    F_ao->axpy(2.0, jk_->J()[0]);
+    F_ao->subtract(jk_->K()[0]);
+    F_ao->subtract(G_ref_);
+
+    auto SC_pao = linalg::doublet(reference_wavefunction_->S(), C_pao_, false, false);
+    auto C_pao_left = C_pao_->clone();
+    C_pao_left->subtract(linalg::triplet(C_lmo_, tau, SC_pao, false, true, false));
+
+    auto C_left = linalg::horzcat({C_lmo_, C_pao_left});
+    auto C_right = linalg::horzcat({C_lmo_t1, C_pao_});
+    F_t1_ = linalg::triplet(C_left, F_ao, C_right, true, false, false);
+}
+
+void DLPNOCCSD::compute_residuals(size_t first, size_t last, const std::vector<SharedMatrix>& B,
+                                  std::vector<SharedMatrix>& R_iajb, std::vector<SharedMatrix>& R_ia) {
+    double** Fp = F_t1_->pointer();
+    const std::vector<SharedMatrix> no_overlaps;
+
+    // Threads run over pairs here, and the per-pair BLAS calls are too small to share
+    BlasThreads blas_threads(BlasThreads::Outer, Process::environment.get_n_threads(), "DLPNO-CCSD pairs");
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t n = first; n < last; ++n) {
+        int ij = cc_pairs_[n];
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+        auto space = pair_space(ij);
+        size_t o = space.lmos.size(), v = n_pno_[ij], nmo = o + v;
+        size_t naux = space.ribfs.size();
+
+        std::vector<double> t1, t2;
+        project_amplitudes(space, S_pair_.empty() ? no_overlaps : S_pair_[ij], {}, t1, t2);
+
+        // dressed Fock matrix over the LMOs and PNOs of the pair
+        std::vector<int> index(space.lmos);
+        for (int u : space.paos) index.push_back(naocc_ + u);
+        auto F_sel = std::make_shared<Matrix>(index.size(), index.size());
+        for (size_t p = 0; p < index.size(); p++) {
+            for (size_t q = 0; q < index.size(); q++) F_sel->set(p, q, Fp[index[p]][index[q]]);
+        }
+        auto T = std::make_shared<Matrix>(index.size(), nmo);
+        for (size_t k = 0; k < o; k++) T->set(k, k, 1.0);
+        for (size_t u = 0; u < space.paos.size(); u++) {
+            for (size_t a = 0; a < v; a++) T->set(o + u, o + a, space.X->get(u, a));
+        }
+        auto F_pair = linalg::triplet(T, F_sel, T, true, false, false);
+
+        size_t i_pos = std::lower_bound(space.lmos.begin(), space.lmos.end(), i) - space.lmos.begin();
+        size_t j_pos = std::lower_bound(space.lmos.begin(), space.lmos.end(), j) - space.lmos.begin();
+
+        std::vector<double> r2, r1;
+        pair_residual(o, v, naux, i_pos, j_pos, B[n - first]->pointer()[0], F_pair->pointer()[0], t1, t2, r2,
+                      (i == j) ? &r1 : nullptr);
+
+        R_iajb[ij] = std::make_shared<Matrix>("Residual", v, v);
+        if (v) ::memcpy(R_iajb[ij]->pointer()[0], r2.data(), sizeof(double) * v * v);
+        if (i == j) {
+            R_ia[i] = std::make_shared<Matrix>("Residual", v, 1);
+            for (size_t a = 0; a < v; a++) R_ia[i]->set(a, 0, r1[a]);
+        }
+    }
+}
+
+/* E = [2 (ia|jb) - (ib|ja)] [t(ij,ab) + t(i,a) t(j,b)] over the pairs, in the PNOs of each pair. The
+ * singles term 2 F(ia) t(i,a) vanishes, since the LMO/PAO block of the reference Fock matrix is zero.
+ */
+double DLPNOCCSD::compute_cc_energy() {
+    double e_cc = 0.0;
+
+#pragma omp parallel for schedule(dynamic, 1) reduction(+ : e_cc)
+    for (size_t n = 0; n < cc_pairs_.size(); ++n) {
+        int ij = cc_pairs_[n];
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+        int ii = i_j_to_ij_[i][i], jj = i_j_to_ij_[j][j];
+
+        auto tau_ij = T_iajb_[ij]->clone();
+        if (n_pno_[ii] > 0 && n_pno_[jj] > 0) {
+            auto t_i = linalg::doublet(pno_overlap(ij, ii), T_ia_[i], false, false);
+            auto t_j = linalg::doublet(pno_overlap(ij, jj), T_ia_[j], false, false);
+            tau_ij->add(linalg::doublet(t_i, t_j, false, true));
+        }
+
+        auto L_ij = K_iajb_[ij]->clone();
+        L_ij->scale(2.0);
+        L_ij->subtract(K_iajb_[ij]->transpose());
+
+        e_cc += (i == j ? 1.0 : 2.0) * L_ij->vector_dot(tau_ij);
+    }
+    return e_cc;
+}
+
+void DLPNOCCSD::lccsd_iterations() {
+    int n_lmo_pairs = ij_to_i_j_.size();
+    size_t npairs = cc_pairs_.size();
+
+    outfile->Printf("\n  ==> Local CCSD <==\n\n");
+    outfile->Printf("    E_CONVERGENCE = %.2e\n", options_.get_double("E_CONVERGENCE"));
+    outfile->Printf("    R_CONVERGENCE = %.2e\n\n", options_.get_double("R_CONVERGENCE"));
+    outfile->Printf("                     Corr. Energy    Delta E     Max R\n");
+
+    std::vector<SharedMatrix> R_ia(naocc_);
+    std::vector<SharedMatrix> R_iajb(n_lmo_pairs);
+    for (int ij = 0; ij < n_lmo_pairs; ++ij) R_iajb[ij] = std::make_shared<Matrix>("Residual", n_pno_[ij], n_pno_[ij]);
+    for (int i = 0; i < naocc_; ++i) R_ia[i] = std::make_shared<Matrix>("Residual", n_pno_[i_j_to_ij_[i][i]], 1);
+
+    // amplitudes of the pairs i <= j and singles, in the same order, for DIIS
+    std::vector<SharedMatrix> T_all;
+    for (int ij : cc_pairs_) T_all.push_back(T_iajb_[ij]);
+    T_all.insert(T_all.end(), T_ia_.begin(), T_ia_.end());
+
+    int iteration = 0, max_iteration = options_.get_int("DLPNO_MAXITER");
+    double e_curr = 0.0, e_prev = 0.0, r_curr = 0.0;
+    bool e_converged = false, r_converged = false;
+    DIISManager diis(options_.get_int("DIIS_MAX_VECS"), "LCCSD DIIS", DIISManager::RemovalPolicy::LargestError,
+                     DIISManager::StoragePolicy::InCore);
+
+    while (!(e_converged && r_converged)) {
+        dress_fock();
+
+        for (size_t first = 0; first < npairs; first += pair_batch_) {
+            size_t last = std::min(npairs, first + pair_batch_);
+            if (!B_pair_.empty()) {
+                compute_residuals(first, last, B_pair_, R_iajb, R_ia);
+                continue;
+            }
+            std::vector<LocalSpace> spaces;
+            for (size_t n = first; n < last; ++n) spaces.push_back(pair_space(cc_pairs_[n]));
+            compute_residuals(first, last, local_df_ints(spaces), R_iajb, R_ia);
+        }
+
+        // evaluate convergence using current amplitudes and residuals
+        e_prev = e_curr;
+        e_curr = compute_cc_energy();
+        r_curr = 0.0;
+        for (int ij : cc_pairs_) r_curr = std::max(r_curr, R_iajb[ij]->rms());
+        for (int i = 0; i < naocc_; ++i) {
+            if (R_ia[i]->size()) r_curr = std::max(r_curr, R_ia[i]->rms());
+        }
+
+        r_converged = (fabs(r_curr) < options_.get_double("R_CONVERGENCE"));
+        e_converged = (fabs(e_curr - e_prev) < options_.get_double("E_CONVERGENCE"));
+
+        // use residuals to get next amplitudes
+#pragma omp parallel for schedule(static, 1)
+        for (size_t n = 0; n < npairs; ++n) {
+            int ij = cc_pairs_[n];
+            int i, j;
+            std::tie(i, j) = ij_to_i_j_[ij];
+            for (int a = 0; a < n_pno_[ij]; ++a) {
+                for (int b = 0; b < n_pno_[ij]; ++b) {
+                    T_iajb_[ij]->add(a, b, -R_iajb[ij]->get(a, b) / ((e_pno_[ij]->get(a) + e_pno_[ij]->get(b)) -
+                                                                    (F_lmo_->get(i, i) + F_lmo_->get(j, j))));
+                }
+            }
+        }
+
+        for (int i = 0; i < naocc_; ++i) {
+            int ii = i_j_to_ij_[i][i];
+            for (int a = 0; a < n_pno_[ii]; ++a) {
+                T_ia_[i]->add(a, 0, -R_ia[i]->get(a, 0) / (e_pno_[ii]->get(a) - F_lmo_->get(i, i)));
+            }
+        }
+
+        // DIIS extrapolation
+        std::vector<SharedMatrix> R_all;
+        for (int ij : cc_pairs_) R_all.push_back(R_iajb[ij]);
+        R_all.insert(R_all.end(), R_ia.begin(), R_ia.end());
+
+        auto T_flat = flatten_mats(T_all);
+        auto R_flat = flatten_mats(R_all);
+
+        if (iteration == 0) {
+            diis.set_error_vector_size(R_flat.get());
+            diis.set_vector_size(T_flat.get());
+        }
+
+        diis.add_entry(R_flat.get(), T_flat.get());
+        diis.extrapolate(T_flat.get());
+
+        copy_flat_mats(T_flat, T_all);
+
+        for (int ij : cc_pairs_) {
+            int i, j;
+            std::tie(i, j) = ij_to_i_j_[ij];
+            if (i != j) T_iajb_[ij_to_ji_[ij]] = T_iajb_[ij]->transpose();
+        }
+
+        outfile->Printf("  @LCCSD iter %3d: %16.12f %10.3e %10.3e\n", iteration, e_curr, e_curr - e_prev, r_curr);
+
+        iteration++;
+
+        if (iteration > max_iteration) {
+            throw PSIEXCEPTION("Maximum DLPNO iterations exceeded.");
+        }
+    }
+
+    e_lccsd_ = compute_cc_energy();
+
+#pragma omp parallel for schedule(static, 1)
+    for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        Tt_iajb_[ij]->copy(T_iajb_[ij]);
+        Tt_iajb_[ij]->scale(2.0);
+        Tt_iajb_[ij]->subtract(T_iajb_[ij]->transpose());
+    }
+}
+
+/* Semicanonical (T0) in the union of the PNOs of the three pairs of each LMO triple (i <= j <= k),
+ * with the sums over LMOs restricted to those coupled to all three.  The triples are batched so that
+ * their integrals fit in memory.
+ */
+void DLPNOCCSD::compute_triples() {
+    size_t nthread = 1;
+#ifdef _OPENMP
+    nthread = omp_get_max_threads();
+#endif
+
+    outfile->Printf("\n  ==> Semicanonical (T0) Correction <==\n\n");
+
+    // the CCSD integrals, overlaps, and JK object are not needed anymore
+    B_pair_.clear();
+    S_pair_.clear();
+    jk_.reset();
+
+    // triples of significant pairs, with upper bounds to the size of their integrals and work arrays
+    std::vector<std::tuple<int, int, int>> triples;
+    std::vector<size_t> ints_size, work_size;
+    for (int i = 0; i < naocc_; ++i) {
+        for (int j = i; j < naocc_; ++j) {
+            int ij = i_j_to_ij_[i][j];
+            if (ij == -1) continue;
+            for (int k = j; k < naocc_; ++k) {
+                int jk = i_j_to_ij_[j][k], ik = i_j_to_ij_[i][k];
+                if (jk == -1 || ik == -1) continue;
+
+                size_t o = 0, v = n_pno_[ij] + n_pno_[jk] + n_pno_[ik];
+                for (int l : lmopair_to_lmos_[ij]) o += (i_j_to_ij_[k][l] != -1);
+                size_t naux = merge_lists(merge_lists(lmopair_to_ribfs_[ij], lmopair_to_ribfs_[jk]),
+                                          lmopair_to_ribfs_[ik]).size();
+                triples.emplace_back(i, j, k);
+                ints_size.push_back(naux * (o + v) * (o + v));
+                work_size.push_back(2 * ints_size.back() + 5 * v * v * v + 3 * o * v * v + o * o * v * v);
+            }
+        }
+    }
+
+    size_t ntriples = triples.size();
+    size_t available = cc_memory_doubles();
+    size_t work_max = ntriples ? *std::max_element(work_size.begin(), work_size.end()) : 0;
+    size_t ints_max = ntriples ? *std::max_element(ints_size.begin(), ints_size.end()) : 0;
+    if (ints_max + nthread * work_max > available) {
+        throw PSIEXCEPTION("DLPNO-CCSD(T): not enough memory for the integrals of a single LMO triple (" +
+                           std::to_string((ints_max + nthread * work_max) * sizeof(double) / (1024 * 1024) + 1) +
+                           " MiB needed beyond the DLPNO-CCSD amplitudes)");
+    }
+    size_t batch_memory = available - nthread * work_max;
+
+    double e_t = 0.0;
+    size_t nbatch = 0;
+
+    for (size_t first = 0; first < ntriples; nbatch++) {
+        size_t last = first, batch_size = 0;
+        while (last < ntriples && batch_size + ints_size[last] <= batch_memory) batch_size += ints_size[last++];
+
+        std::vector<LocalSpace> spaces(last - first);
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t n = first; n < last; ++n) {
+            int i, j, k;
+            std::tie(i, j, k) = triples[n];
+            spaces[n - first] = triple_space(i, j, k);
+        }
+
+        auto B = local_df_ints(spaces);
+
+        BlasThreads blas_threads(BlasThreads::Outer, Process::environment.get_n_threads(), "DLPNO-(T0) triples");
+
+#pragma omp parallel for schedule(dynamic, 1) reduction(+ : e_t)
+        for (size_t n = first; n < last; ++n) {
+            const auto& space = spaces[n - first];
+            int ijk[3];
+            std::tie(ijk[0], ijk[1], ijk[2]) = triples[n];
+
+            size_t pos[3];
+            double f[3];
+            for (int x = 0; x < 3; x++) {
+                pos[x] = std::lower_bound(space.lmos.begin(), space.lmos.end(), ijk[x]) - space.lmos.begin();
+                f[x] = F_lmo_->get(ijk[x], ijk[x]);
+            }
+
+            std::vector<double> t1, t2;
+            project_amplitudes(space, {}, {(int)pos[0], (int)pos[1], (int)pos[2]}, t1, t2);
+
+            e_t += triples_energy(space.lmos.size(), space.X->colspi(0), space.ribfs.size(), pos, f,
+                                  B[n - first]->pointer()[0], space.e_vir->pointer(), t1, t2);
+        }
+
+        first = last;
+    }
+
+    e_lccsd_t_ = e_t;
+
+    outfile->Printf("    LMO triples:  %zu (%zu batches)\n", ntriples, nbatch);
+    outfile->Printf("    (T0) energy = %.12f\n", e_lccsd_t_);
+}
+
+double DLPNOCCSD::compute_energy() {
+    // DLPNO-MP2 supplies the LMO pairs, the PNOs, the guess amplitudes, and the energy
+    // corrections for screened pairs and PNO truncation
+    DLPNOMP2::compute_energy();
+
+    timer_on(compute_triples_ ? "DLPNO-CCSD(T)" : "DLPNO-CCSD");
+
+    print_cc_header();
+
+    timer_on("Setup CC");
+    setup_cc();
+    timer_off("Setup CC");
+
+    timer_on("LCCSD");
+    lccsd_iterations();
+    timer_off("LCCSD");
+
+    e_lccsd_t_ = 0.0;
+    if (compute_triples_) {
+        timer_on("(T0)");
+        compute_triples();
+        timer_off("(T0)");
+    }
+
+    print_cc_results();
+
+    timer_off(compute_triples_ ? "DLPNO-CCSD(T)" : "DLPNO-CCSD");
+
+    double e_scf = reference_wavefunction_->energy();
+    double e_ccsd_corr = e_lccsd_ + de_dipole_ + de_pno_total_;
+    double e_ccsd_total = e_scf + e_ccsd_corr;
+
+    set_scalar_variable("CCSD CORRELATION ENERGY", e_ccsd_corr);
+    set_scalar_variable("CCSD TOTAL ENERGY", e_ccsd_total);
+    set_scalar_variable("CURRENT CORRELATION ENERGY", e_ccsd_corr);
+    set_scalar_variable("CURRENT ENERGY", e_ccsd_total);
+
+    if (compute_triples_) {
+        set_scalar_variable("(T) CORRECTION ENERGY", e_lccsd_t_);
+        set_scalar_variable("CCSD(T) CORRELATION ENERGY", e_ccsd_corr + e_lccsd_t_);
+        set_scalar_variable("CCSD(T) TOTAL ENERGY", e_ccsd_total + e_lccsd_t_);
+        set_scalar_variable("CURRENT CORRELATION ENERGY", e_ccsd_corr + e_lccsd_t_);
+        set_scalar_variable("CURRENT ENERGY", e_ccsd_total + e_lccsd_t_);
+    }
+
+    name_ = compute_triples_ ? "DLPNO-CCSD(T)" : "DLPNO-CCSD";
+    energy_ = scalar_variable("CURRENT ENERGY");
+
+    return energy_;
+}
+
+void DLPNOCCSD::print_cc_header() {
+    outfile->Printf("\n   --------------------------------------------\n");
+    outfile->Printf("                  %s                 \n", compute_triples_ ? "DLPNO-CCSD(T)" : "DLPNO-CCSD");
+    outfile->Printf("   --------------------------------------------\n\n");
+    outfile->Printf("  Local CCSD in the PNO basis of the DLPNO-MP2 pairs, with the integrals\n");
+    outfile->Printf("  and intermediates of each pair formed in its own LMO, PNO, and aux domains.\n");
+    outfile->Printf("  Screened pairs and PNO truncation are corrected at the MP2 level.\n");
+}
+
+void DLPNOCCSD::print_cc_results() {
+    outfile->Printf("  \n");
+    outfile->Printf("  Total DLPNO-CCSD Correlation Energy: %16.12f \n", e_lccsd_ + de_pno_total_ + de_dipole_);
+    outfile->Printf("    CCSD Correlation Energy:           %16.12f \n", e_lccsd_);
+    outfile->Printf("    LMO Truncation Correction:         %16.12f \n", de_dipole_);
+    outfile->Printf("    PNO Truncation Correction:         %16.12f \n", de_pno_total_);
+    if (compute_triples_) {
+        outfile->Printf("    (T0) Correction:                   %16.12f \n", e_lccsd_t_);
+        outfile->Printf("  Total DLPNO-CCSD(T) Correlation Energy: %16.12f \n",
+                        e_lccsd_ + de_pno_total_ + de_dipole_ + e_lccsd_t_);
+    }
+}
+
+}  // namespace dlpno
+}  // namespace psi
@@ -0,0 +1,147 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef PSI4_SRC_DLPNO_CCSD_H_
+#define PSI4_SRC_DLPNO_CCSD_H_
+
+#include "mp2.h"
+#include "sparse.h"
+
+#include <vector>
+
+namespace psi {
+
+class JK;
+
+namespace dlpno {
+
+// Local CCSD in the PNO basis of the DLPNO-MP2 pairs, followed by the semicanonical (T0)
+// correction (Riplinger et al., JCP 139, 134101, 2013; DOI: 10.1063/1.4821834)
+
+class DLPNOCCSD : public DLPNOMP2 {
+   protected:
+    /// A local correlation space: a list of LMOs, semicanonical virtuals expanded in a
+    /// PAO domain, and the auxiliary functions that fit products of the two
+    struct LocalSpace {
+        std::vector<int> lmos;
+        std::vector<int> paos;
+        SharedMatrix X;        ///< PAO domain -> local virtuals (npao x nvir)
+        SharedVector e_vir;    ///< orbital energies of the local virtuals
+        std::vector<int> ribfs;
+        std::vector<int> riatoms;
+    };
+
+    /// compute the (T0) correction after the CCSD iterations?
+    bool compute_triples_;
+
+    /// number of active LMOs
+    int naocc_;
+
+    /// LMOs k coupled to both LMOs of a pair (ik and jk are both significant)
+    SparseMap lmopair_to_lmos_;
+
+    /// pairs ij with i <= j that carry PNOs; the residual of ji is the transpose of that of ij
+    std::vector<int> cc_pairs_;
+    /// number of pairs in cc_pairs_ whose integrals are formed together
+    size_t pair_batch_;
+    /// fitted (Q|pq) of each pair in cc_pairs_, over its LMOs followed by its PNOs
+    /// (naux_ij x (nlmo_ij + npno_ij)^2); empty if they are rebuilt in every iteration
+    std::vector<SharedMatrix> B_pair_;
+    /// S(ij, kl) between the PNOs of pair ij and those of the pairs of its LMOs, at the
+    /// positions (k, l <= k) of the LMOs in lmopair_to_lmos_[ij]; empty if computed on the fly
+    std::vector<std::vector<SharedMatrix>> S_pair_;
+
+    /// density-fitted JK object for the T1-dressed Fock matrix
+    std::shared_ptr<JK> jk_;
+    /// two-electron part of the reference Fock matrix, from jk_ (AO basis)
+    SharedMatrix G_ref_;
+    /// T1-dressed Fock matrix over the LMOs followed by the PAOs
+    SharedMatrix F_t1_;
+
+    /// singles amplitudes of LMO i, in the PNO basis of the diagonal pair ii
+    std::vector<SharedMatrix> T_ia_;
+
+    // final energies
+    double e_lccsd_; ///< raw (uncorrected) local CCSD correlation energy
+    double e_lccsd_t_; ///< (T0) correction
+
+    /// doubles of the memory limit not held by the DLPNO-MP2 amplitudes and the CC arrays
+    size_t cc_memory_doubles();
+
+    /// LMOs, PNOs, and auxiliary domain of pair ij
+    LocalSpace pair_space(int ij);
+    /// LMOs coupled to i, j, and k, orthocanonicalized union of the PNOs of ij, jk, and ik
+    LocalSpace triple_space(int i, int j, int k);
+
+    /// overlap between the virtuals of a local space and the PNOs of pair kl
+    SharedMatrix space_overlap(const LocalSpace& space, int kl);
+
+    /// fitted (Q|pq) over the LMOs followed by the virtuals of each space (naux_s x nmo_s^2),
+    /// from (mn|Q) of the aux shells in the spaces' domains
+    std::vector<SharedMatrix> local_df_ints(const std::vector<LocalSpace>& spaces);
+
+    /// amplitudes of the LMOs of a space (t1: nlmo x nvir, t2: nlmo x nlmo x nvir x nvir), projected
+    /// onto its virtuals with the overlaps S (empty: computed here). If focus is not empty, only
+    /// pairs with one of the LMOs at these positions are projected.
+    void project_amplitudes(const LocalSpace& space, const std::vector<SharedMatrix>& S,
+                            const std::vector<int>& focus, std::vector<double>& t1, std::vector<double>& t2);
+
+    /// LMO neighbor lists, JK object, pair integrals and overlaps within the memory limit
+    void setup_cc();
+
+    /// T1-dressed Fock matrix from the current singles amplitudes
+    void dress_fock();
+
+    /// CCSD residuals of the pairs cc_pairs_[first, last) (and the singles of their diagonal pairs),
+    /// given the integrals B of these pairs
+    void compute_residuals(size_t first, size_t last, const std::vector<SharedMatrix>& B,
+                           std::vector<SharedMatrix>& R_iajb, std::vector<SharedMatrix>& R_ia);
+
+    /// CCSD correlation energy from the PNO amplitudes
+    double compute_cc_energy();
+
+    /// iteratively solve the CCSD equations in the PNO basis
+    void lccsd_iterations();
+
+    /// semicanonical (T0) correction from the converged amplitudes, in the union of the PNOs of each LMO triple
+    void compute_triples();
+
+    void print_cc_header();
+    void print_cc_results();
+
+   public:
+    DLPNOCCSD(SharedWavefunction ref_wfn, Options& options);
+    ~DLPNOCCSD() override;
+
+    double compute_energy() override;
+};
+
+}  // namespace dlpno
+}  // namespace psi
+
+#endif //PSI4_SRC_DLPNO_CCSD_H_
@@ -47,11 +47,22 @@
 #include "psi4/libqt/qt.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <numeric>
+#include <string>
+#include <unordered_map>
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
 namespace psi {
 namespace dlpno {
 
@@ -74,6 +85,10 @@ void DLPNOMP2::common_init() {
     bool T_CUT_DO_changed = options_["T_CUT_DO"].has_changed();
 
     // if not, values are determined by the user-friendly "PNO_CONVERGENCE"
+    distribute_pairs_ = true;
+    rank_ = 0;
+    nrank_ = 1;
+
     if (options_.get_str("PNO_CONVERGENCE") == "LOOSE") {
         if (!T_CUT_PNO_changed) T_CUT_PNO_ = 1e-7;
         if (!T_CUT_DO_changed) T_CUT_DO_ = 2e-2;
@@ -161,6 +176,248 @@ void copy_flat_mats(SharedVector flat, std::vector<SharedMatrix>& mat_list) {
     }
 }
 
+namespace {
+
+/* Bounded least-recently-used store of PNO overlap blocks, keyed by their offset in the
+ * (virtual) overlap arena. One per thread, so no locking is needed.
+ */
+class PNOOverlapCache {
+    typedef std::pair<size_t, std::vector<double>> Entry;
+    std::list<Entry> entries_;  // most recently used at the front
+    std::unordered_map<size_t, std::list<Entry>::iterator> lookup_;
+    size_t capacity_;  // in doubles
+    size_t used_ = 0;
+
+   public:
+    size_t hits = 0;
+    size_t misses = 0;
+
+    PNOOverlapCache(size_t capacity) : capacity_(capacity) {}
+
+    /* Returns the block with key, computing it with compute() on a miss. The pointer is
+     * valid until the next call.
+     */
+    template <typename F>
+    double* get(size_t key, F compute) {
+        auto it = lookup_.find(key);
+        if (it != lookup_.end()) {
+            hits++;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->second.data();
+        }
+        misses++;
+
+        SharedMatrix block = compute();
+        size_t size = block->size();
+        while (!entries_.empty() && used_ + size > capacity_) {
+            used_ -= entries_.back().second.size();
+            lookup_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+
+        entries_.emplace_front(key, std::vector<double>(block->pointer()[0], block->pointer()[0] + size));
+        lookup_[key] = entries_.begin();
+        used_ += size;
+        return entries_.front().second.data();
+    }
+};
+
+/* LMOs of earlier DLPNO computations in this process, keyed by a signature of the system
+ * (atoms, basis, active orbitals). With DLPNO_REUSE_LMOS, the localization of a later
+ * computation on the same system (an optimization step, a repeated n-body fragment) starts
+ * from them, and converges in a few sweeps.
+ */
+struct PreviousLMOs {
+    std::string signature;
+    Matrix geometry;
+    SharedMatrix C_lmo;
+};
+std::list<PreviousLMOs> previous_lmos;
+const size_t max_previous_lmos = 32;
+
+// cost of fitting (ia|jb) and diagonalizing in the PAO domain of a pair
+double pno_transform_cost(double npao_ij, double naux_ij) {
+    return naux_ij * naux_ij * (naux_ij + npao_ij) + npao_ij * npao_ij * (naux_ij + npao_ij);
+}
+
+#ifdef ENABLE_MPI
+
+// MPI counts are ints, so long buffers go in pieces
+const size_t mpi_chunk = size_t(1) << 28;
+
+// As in DirectJK: without a live MPI environment (libdlpno embedded elsewhere), one rank.
+void mpi_layout(int& rank, int& nrank) {
+    rank = 0;
+    nrank = 1;
+    int initialized = 0;
+    int finalized = 0;
+    MPI_Initialized(&initialized);
+    MPI_Finalized(&finalized);
+    if (!initialized || finalized) return;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nrank);
+}
+
+/* Sends send[r] to rank r and receives recv[r] from rank r, for all r. The receive buffers
+ * must already have their final sizes.
+ */
+void mpi_exchange(const std::vector<std::vector<double>>& send, std::vector<std::vector<double>>& recv) {
+    std::vector<MPI_Request> requests;
+    for (int r = 0; r < (int)recv.size(); ++r) {
+        for (size_t offset = 0, chunk = 0; offset < recv[r].size(); offset += mpi_chunk, ++chunk) {
+            requests.emplace_back();
+            MPI_Irecv(recv[r].data() + offset, (int)std::min(mpi_chunk, recv[r].size() - offset), MPI_DOUBLE, r,
+                      (int)chunk, MPI_COMM_WORLD, &requests.back());
+        }
+    }
+    for (int r = 0; r < (int)send.size(); ++r) {
+        for (size_t offset = 0, chunk = 0; offset < send[r].size(); offset += mpi_chunk, ++chunk) {
+            requests.emplace_back();
+            MPI_Isend(send[r].data() + offset, (int)std::min(mpi_chunk, send[r].size() - offset), MPI_DOUBLE, r,
+                      (int)chunk, MPI_COMM_WORLD, &requests.back());
+        }
+    }
+    MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+
+/* DIIS over amplitudes that are divided between the ranks. Each rank keeps its own part of
+ * every vector; only the dot products of the error vectors are summed, so every rank solves
+ * the same (bordered) DIIS equations and extrapolates its part with the same coefficients.
+ * Removes the vector with the largest error, like the LMP2 DIISManager.
+ */
+class DistributedDIIS {
+    std::vector<SharedVector> T_;
+    std::vector<SharedVector> R_;
+    std::vector<std::vector<double>> B_;  // error dot products
+    int max_vecs_;
+    std::function<void(double*, int)> sum_;
+
+   public:
+    DistributedDIIS(int max_vecs, std::function<void(double*, int)> sum) : max_vecs_(max_vecs), sum_(sum) {}
+
+    void add_entry(SharedVector R, SharedVector T) {
+        if (max_vecs_ == 0) return;
+        if ((int)T_.size() == max_vecs_) {
+            int worst = 0;
+            for (int k = 1; k < (int)T_.size(); ++k) {
+                if (B_[k][k] > B_[worst][worst]) worst = k;
+            }
+            T_.erase(T_.begin() + worst);
+            R_.erase(R_.begin() + worst);
+            B_.erase(B_.begin() + worst);
+            for (auto& row : B_) row.erase(row.begin() + worst);
+        }
+
+        // extrapolate() overwrites T in place, so keep a copy
+        T_.push_back(std::make_shared<Vector>(*T));
+        R_.push_back(R);
+
+        int n = T_.size();
+        std::vector<double> dots(n);
+        for (int k = 0; k < n; ++k) dots[k] = R->vector_dot(*R_[k]);
+        sum_(dots.data(), n);
+        for (int k = 0; k < n - 1; ++k) B_[k].push_back(dots[k]);
+        B_.push_back(dots);
+    }
+
+    void extrapolate(SharedVector T) {
+        int n = T_.size();
+        if (n < 2) return;
+
+        // scale by the diagonal, as the errors shrink by orders of magnitude
+        std::vector<double> scale(n + 1, 1.0);
+        for (int k = 0; k < n; ++k) {
+            if (B_[k][k] > 0.0) scale[k] = 1.0 / std::sqrt(B_[k][k]);
+        }
+
+        auto B = std::make_shared<Matrix>("DIIS B", n + 1, n + 1);
+        for (int k = 0; k < n; ++k) {
+            for (int l = 0; l < n; ++l) B->set(k, l, scale[k] * B_[k][l] * scale[l]);
+            B->set(k, n, -scale[k]);
+            B->set(n, k, -scale[k]);
+        }
+
+        // the right-hand side is (0, ..., 0, -1)
+        int nremoved = 0;
+        auto B_inv = B->pseudoinverse(1.0e-14, nremoved);
+        T->zero();
+        for (int k = 0; k < n; ++k) T->axpy(-B_inv->get(k, n) * scale[k], *T_[k]);
+    }
+};
+
+#endif
+
+}  // namespace
+
+void DLPNOMP2::bcast_from_root(const std::vector<SharedMatrix>& mats) {
+    if (nrank_ == 1) return;
+#ifdef ENABLE_MPI
+    for (const auto& mat : mats) {
+        if (mat->size() == 0) continue;
+        double* data = mat->get_pointer();
+        for (size_t offset = 0; offset < mat->size(); offset += mpi_chunk) {
+            MPI_Bcast(data + offset, (int)std::min(mpi_chunk, mat->size() - offset), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        }
+    }
+#endif
+}
+
+// Reduced to the root and sent back, rather than MPI_Allreduce, which may round differently on
+// different ranks; the convergence tests must come out the same everywhere.
+void DLPNOMP2::sum_over_ranks(double* data, int n) {
+    if (nrank_ == 1 || n == 0) return;
+#ifdef ENABLE_MPI
+    MPI_Reduce((rank_ == 0) ? MPI_IN_PLACE : data, data, n, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Bcast(data, n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
+}
+
+void DLPNOMP2::sum_over_ranks(int* data, int n) {
+    if (nrank_ == 1 || n == 0) return;
+#ifdef ENABLE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, data, n, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+}
+
+void DLPNOMP2::share_halo_pairs(std::vector<SharedMatrix>& mats,
+                                const std::function<std::pair<int, int>(int)>& shape) {
+    if (nrank_ == 1) return;
+#ifdef ENABLE_MPI
+    // Pairs go in the (sorted) order of the halo lists on both sides, so no index is sent
+    std::vector<std::vector<double>> send(nrank_);
+    for (int r = 0; r < nrank_; ++r) {
+        for (int kl : halo_pairs_[r]) {
+            if (pair_to_rank_[kl] != rank_ || mats[kl]->size() == 0) continue;
+            const double* data = mats[kl]->get_pointer();
+            send[r].insert(send[r].end(), data, data + mats[kl]->size());
+        }
+    }
+
+    std::vector<size_t> recv_size(nrank_, 0);
+    for (int kl : halo_pairs_[rank_]) {
+        auto dims = shape(kl);
+        recv_size[pair_to_rank_[kl]] += (size_t)dims.first * dims.second;
+    }
+    std::vector<std::vector<double>> recv(nrank_);
+    for (int r = 0; r < nrank_; ++r) recv[r].resize(recv_size[r]);
+
+    mpi_exchange(send, recv);
+
+    std::vector<size_t> recv_offset(nrank_, 0);
+    for (int kl : halo_pairs_[rank_]) {
+        int owner = pair_to_rank_[kl];
+        auto dims = shape(kl);
+        if (!mats[kl] || mats[kl]->rowspi(0) != dims.first || mats[kl]->colspi(0) != dims.second) {
+            mats[kl] = std::make_shared<Matrix>(dims.first, dims.second);
+        }
+        size_t size = mats[kl]->size();
+        if (size == 0) continue;
+        ::memcpy(mats[kl]->get_pointer(), &recv[owner][recv_offset[owner]], sizeof(double) * size);
+        recv_offset[owner] += size;
+    }
+#endif
+}
+
 /* Args: orthonormal orbitals C (ao x mo) and fock matrix F (ao x ao)
  * Return: transformation matrix X (mo x mo) and energy vector e (mo)
  *
@@ -465,6 +722,7 @@ void DLPNOMP2::prep_sparsity() {
 
     lmo_to_paos_.resize(naocc);
     lmo_to_paoatoms_.resize(naocc);
+#pragma omp parallel for schedule(static, 1)
     for (size_t i = 0; i < naocc; ++i) {
         // PAO domains determined by differential overlap integral
         std::vector<int> lmo_to_paos_temp;
@@ -475,7 +733,7 @@ void DLPNOMP2::prep_sparsity() {
         }
 
         // if any PAO on an atom is in the list, we take all of the PAOs on that atom
-        lmo_to_paos_[i] = contract_lists(lmo_to_paos_temp, atom_to_bf_);
+        lmo_to_paos_[i] = contract_lists(lmo_to_paos_temp, atom_to_bf_, bf_to_atom);
 
         // contains the same information as previous map
         lmo_to_paoatoms_[i] = block_list(lmo_to_paos_[i], bf_to_atom);
@@ -617,6 +875,68 @@ void DLPNOMP2::prep_sparsity() {
     }
 }
 
+void DLPNOMP2::assign_pair_ranks() {
+    int naocc = i_j_to_ij_.size();
+    int n_lmo_pairs = ij_to_i_j_.size();
+
+    pair_to_rank_.assign(n_lmo_pairs, 0);
+    halo_pairs_.assign(nrank_, {});
+    if (nrank_ == 1) return;
+
+    // LMOs in order of the mean index of the atoms in their fitting domains. Inputs list bonded
+    // atoms close together, so a stretch of this order is a region of the molecule, and the pairs
+    // of one region share most of their aux atoms, (iu|Q) integrals, and coupled pairs.
+    std::vector<double> lmo_position(naocc, 0.0);
+    for (int i = 0; i < naocc; ++i) {
+        for (int atom : lmo_to_riatoms_[i]) lmo_position[i] += atom;
+        if (!lmo_to_riatoms_[i].empty()) lmo_position[i] /= lmo_to_riatoms_[i].size();
+    }
+    std::vector<int> lmo_order(naocc);
+    std::iota(lmo_order.begin(), lmo_order.end(), 0);
+    std::stable_sort(lmo_order.begin(), lmo_order.end(),
+                     [&lmo_position](int i, int j) { return lmo_position[i] < lmo_position[j]; });
+    std::vector<int> lmo_rank_order(naocc);
+    for (int n = 0; n < naocc; ++n) lmo_rank_order[lmo_order[n]] = n;
+
+    // A pair goes with whichever of its LMOs comes first, and the LMOs are dealt out in
+    // contiguous stretches of about equal PNO construction cost
+    auto pair_lead = [&](int ij) {
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+        return (lmo_rank_order[i] <= lmo_rank_order[j]) ? i : j;
+    };
+    std::vector<double> pair_cost(n_lmo_pairs, 0.0);
+    std::vector<double> lmo_cost(naocc, 0.0);
+    for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+        if (i > j) continue;  // formed together with ij
+        pair_cost[ij] = pno_transform_cost(lmopair_to_paos_[ij].size(), lmopair_to_ribfs_[ij].size());
+        lmo_cost[pair_lead(ij)] += pair_cost[ij];
+    }
+    double total_cost = std::accumulate(lmo_cost.begin(), lmo_cost.end(), 0.0);
+
+    std::vector<int> lmo_to_rank(naocc, 0);
+    double cost_before = 0.0;
+    for (int n = 0; n < naocc; ++n) {
+        int i = lmo_order[n];
+        double midpoint = cost_before + 0.5 * lmo_cost[i];
+        lmo_to_rank[i] = (total_cost > 0.0) ? std::min(nrank_ - 1, (int)(midpoint * nrank_ / total_cost)) : n % nrank_;
+        cost_before += lmo_cost[i];
+    }
+
+    std::vector<double> rank_cost(nrank_, 0.0);
+    for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        pair_to_rank_[ij] = lmo_to_rank[pair_lead(ij)];
+        rank_cost[pair_to_rank_[ij]] += pair_cost[ij];
+    }
+
+    double cost_max = *std::max_element(rank_cost.begin(), rank_cost.end());
+    outfile->Printf("\n    LMO pairs distributed over %d MPI ranks\n", nrank_);
+    outfile->Printf("      Predicted load (max / mean): %6.3f\n",
+                    (total_cost > 0.0) ? cost_max * nrank_ / total_cost : 1.0);
+}
+
 void DLPNOMP2::compute_df_ints() {
     timer_on("(mn|K) -> (ia|K)");
 
@@ -646,33 +966,71 @@ void DLPNOMP2::compute_df_ints() {
 
     qia_.resize(naux);
 
+    int natom = molecule_->natom();
+    int npao = C_pao_->colspi(0);
+
+    // With the pairs divided over MPI ranks, only the aux atoms in the fitting domains of this
+    // rank's pairs are needed
+    int n_lmo_pairs = ij_to_i_j_.size();
+    std::vector<bool> riatom_needed(natom, nrank_ == 1);
+    for (int ij = 0; ij < n_lmo_pairs && nrank_ > 1; ++ij) {
+        if (!owns_pair(ij)) continue;
+        for (int centerQ : lmopair_to_riatoms_[ij]) riatom_needed[centerQ] = true;
+    }
+
+    // LMO and PAO coefficients of the domain of each aux atom, shared by all shells on that atom
+    std::vector<SharedMatrix> C_lmo_slices(natom);
+    std::vector<SharedMatrix> C_pao_slices(natom);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int centerQ = 0; centerQ < natom; centerQ++) {
+        if (atom_to_rishell_[centerQ].empty() || !riatom_needed[centerQ]) continue;
+
+        C_pao_slices[centerQ] = submatrix_rows(*C_pao_, riatom_to_bfs2_[centerQ]);  // TODO: PAO slices
+
+        //// Here we'll refit the coefficients of C_lmo_slice to minimize residual from unscreened orbitals
+        //// This lets us get away with agressive coefficient screening
+        //// Boughton and Pulay 1992 JCC, Equation 3
+
+        // Solve for C_lmo_slice such that S[local,local] @ C_lmo_slice ~= S[local,all] @ C_lmo_
+        auto C_lmo_slice =
+            submatrix_rows_and_cols(*SC_lmo, riatom_to_bfs1_[centerQ], riatom_to_lmos_ext_[centerQ]);
+        auto S_aa =
+            submatrix_rows_and_cols(*reference_wavefunction_->S(), riatom_to_bfs1_[centerQ], riatom_to_bfs1_[centerQ]);
+        C_DGESV_wrapper(S_aa, C_lmo_slice);
+        C_lmo_slices[centerQ] = C_lmo_slice;
+    }
+
 #pragma omp parallel for schedule(dynamic, 1)
     for (int Q = 0; Q < ribasis_->nshell(); Q++) {
         int nq = ribasis_->shell(Q).nfunction();
         int qstart = ribasis_->shell(Q).function_index();
         int centerQ = ribasis_->shell_to_center(Q);
+        if (!riatom_needed[centerQ]) continue;
 
         size_t thread = 0;
 #ifdef _OPENMP
         thread = omp_get_thread_num();
 #endif
         // sparse lists of non-screened basis functions
-        auto bf_map1 = riatom_to_bfs1_[centerQ];
-        auto bf_map2 = riatom_to_bfs2_[centerQ];
+        const auto& bf_map1 = riatom_to_bfs1_[centerQ];
+        const auto& bf_map2 = riatom_to_bfs2_[centerQ];
+        int nbf1 = bf_map1.size();
+        int nbf2 = bf_map2.size();
+        int nlmo = riatom_to_lmos_ext_[centerQ].size();
 
         // inverse map, from global (non-screened) bf-index to Q-specific (screened) index
         std::vector<int> bf_map1_inv(nbf, -1);
         std::vector<int> bf_map2_inv(nbf, -1);
-        for (int m_ind = 0; m_ind < bf_map1.size(); m_ind++) {
+        for (int m_ind = 0; m_ind < nbf1; m_ind++) {
             bf_map1_inv[bf_map1[m_ind]] = m_ind;
         }
-        for (int n_ind = 0; n_ind < bf_map2.size(); n_ind++) {
+        for (int n_ind = 0; n_ind < nbf2; n_ind++) {
             bf_map2_inv[bf_map2[n_ind]] = n_ind;
         }
 
-        for (size_t q = 0; q < nq; q++) {
-            qia_[qstart + q] = std::make_shared<Matrix>("(mn|Q)", bf_map1.size(), bf_map2.size());
-        }
+        // (mn|Q) for all functions q of this shell, stored contiguously as [q][m][n]
+        std::vector<double> mnQ((size_t)nq * nbf1 * nbf2, 0.0);
 
         for (int M : riatom_to_shells1_[centerQ]) {
             int nm = basisset_->shell(M).nfunction();
@@ -695,9 +1053,11 @@ void DLPNOMP2::compute_df_ints() {
                 const double* buffer = eris[thread]->buffer();
 
                 for (int q = 0, index = 0; q < nq; q++) {
+                    double* mnq = &mnQ[(size_t)q * nbf1 * nbf2];
                     for (int m = 0; m < nm; m++) {
+                        double* mnq_m = &mnq[(size_t)bf_map1_inv[mstart + m] * nbf2];
                         for (int n = 0; n < nn; n++, index++) {
-                            qia_[qstart + q]->set(bf_map1_inv[mstart + m], bf_map2_inv[nstart + n], buffer[index]);
+                            mnq_m[bf_map2_inv[nstart + n]] = buffer[index];
                         }
                     }
                 }
@@ -705,9 +1065,10 @@ void DLPNOMP2::compute_df_ints() {
                 // (MN|Q) <-> (NM|Q) symmetry
                 if (N > M && MN_symmetry) {
                     for (int q = 0, index = 0; q < nq; q++) {
+                        double* mnq = &mnQ[(size_t)q * nbf1 * nbf2];
                         for (int m = 0; m < nm; m++) {
                             for (int n = 0; n < nn; n++, index++) {
-                                qia_[qstart + q]->set(bf_map1_inv[nstart + n], bf_map2_inv[mstart + m], buffer[index]);
+                                mnq[(size_t)bf_map1_inv[nstart + n] * nbf2 + bf_map2_inv[mstart + m]] = buffer[index];
                             }
                         }
                     }
@@ -716,22 +1077,20 @@ void DLPNOMP2::compute_df_ints() {
             }  // N loop
         }      // M loop
 
-        auto C_pao_slice = submatrix_rows(*C_pao_, riatom_to_bfs2_[centerQ]);  // TODO: PAO slices
+        for (size_t q = 0; q < nq; q++) {
+            qia_[qstart + q] = std::make_shared<Matrix>("(iu|Q)", nlmo, npao);
+        }
+        if (nbf1 == 0 || nbf2 == 0 || nlmo == 0 || npao == 0) continue;
 
-        //// Here we'll refit the coefficients of C_lmo_slice to minimize residual from unscreened orbitals
-        //// This lets us get away with agressive coefficient screening
-        //// Boughton and Pulay 1992 JCC, Equation 3
+        // (mn|Q) C_nu -> (mu|Q), one GEMM for the whole shell
+        std::vector<double> muQ((size_t)nq * nbf1 * npao);
+        C_DGEMM('N', 'N', nq * nbf1, npao, nbf2, 1.0, mnQ.data(), nbf2, C_pao_slices[centerQ]->pointer()[0], npao, 0.0,
+                muQ.data(), npao);
 
-        // Solve for C_lmo_slice such that S[local,local] @ C_lmo_slice ~= S[local,all] @ C_lmo_
-        auto C_lmo_slice =
-            submatrix_rows_and_cols(*SC_lmo, riatom_to_bfs1_[centerQ], riatom_to_lmos_ext_[centerQ]);
-        auto S_aa =
-            submatrix_rows_and_cols(*reference_wavefunction_->S(), riatom_to_bfs1_[centerQ], riatom_to_bfs1_[centerQ]);
-        C_DGESV_wrapper(S_aa, C_lmo_slice);
-
-        // (mn|Q) C_mi C_nu -> (iu|Q)
+        // C_mi (mu|Q) -> (iu|Q)
         for (size_t q = 0; q < nq; q++) {
-            qia_[qstart + q] = linalg::triplet(C_lmo_slice, qia_[qstart + q], C_pao_slice, true, false, false);
+            C_DGEMM('T', 'N', nlmo, npao, nbf1, 1.0, C_lmo_slices[centerQ]->pointer()[0], nlmo,
+                    &muQ[q * nbf1 * npao], npao, 0.0, qia_[qstart + q]->pointer()[0], npao);
         }
 
     }  // Q loop
@@ -760,18 +1119,30 @@ void DLPNOMP2::pno_transform() {
     X_pno_.resize(n_lmo_pairs);    // global PAOs -> canonical PNOs
     e_pno_.resize(n_lmo_pairs);    // PNO orbital energies
 
-    n_pno_.resize(n_lmo_pairs);   // number of pnos
-    de_pno_.resize(n_lmo_pairs);  // PNO truncation error
-    de_pno_os_.resize(n_lmo_pairs);  // opposite-spin contributions to de_pno_
-    de_pno_ss_.resize(n_lmo_pairs);  // same-spin contributions to de_pno_
+    // zeroed, since each rank fills in its own pairs and the ranks sum them
+    n_pno_.assign(n_lmo_pairs, 0);       // number of pnos
+    de_pno_.assign(n_lmo_pairs, 0.0);    // PNO truncation error
+    de_pno_os_.assign(n_lmo_pairs, 0.0);  // opposite-spin contributions to de_pno_
+    de_pno_ss_.assign(n_lmo_pairs, 0.0);  // same-spin contributions to de_pno_
 
-#pragma omp parallel for schedule(dynamic, 1)
+    // pairs ordered by the cost of fitting (ia|jb) and diagonalizing in the PAO domain, largest first
+    std::vector<double> pair_cost(n_lmo_pairs, 0.0);
     for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+        if (i > j || !owns_pair(ij)) continue;
+        pair_cost[ij] = pno_transform_cost(lmopair_to_paos_[ij].size(), lmopair_to_ribfs_[ij].size());
+    }
+    std::vector<int> pair_order = sort_by_cost(pair_cost);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int ij_task = 0; ij_task < n_lmo_pairs; ++ij_task) {
+        int ij = pair_order[ij_task];
         int i, j;
         std::tie(i, j) = ij_to_i_j_[ij];
         int ji = ij_to_ji_[ij];
 
-        if (i > j) continue;
+        if (i > j || !owns_pair(ij)) continue;
 
         //                                                   //
         // ==> Assemble (ia|jb) for pair ij in PAO basis <== //
@@ -912,6 +1283,11 @@ void DLPNOMP2::pno_transform() {
         }
     }
 
+    sum_over_ranks(n_pno_.data(), n_lmo_pairs);
+    sum_over_ranks(de_pno_.data(), n_lmo_pairs);
+    sum_over_ranks(de_pno_os_.data(), n_lmo_pairs);
+    sum_over_ranks(de_pno_ss_.data(), n_lmo_pairs);
+
     int pno_count_total = 0, pno_count_min = nbf, pno_count_max = 0;
     de_pno_total_ = 0.0, de_pno_total_os_ = 0.0, de_pno_total_ss_ = 0.0;
     for (int ij = 0; ij < n_lmo_pairs; ++ij) {
@@ -933,55 +1309,153 @@ void DLPNOMP2::pno_transform() {
 
 #pragma omp parallel for schedule(static, 1)
     for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        if (!owns_pair(ij)) continue;
         Tt_iajb_[ij] = T_iajb_[ij]->clone();
         Tt_iajb_[ij]->scale(2.0);
         Tt_iajb_[ij]->subtract(T_iajb_[ij]->transpose());
     }
 }
 
+SharedMatrix DLPNOMP2::pno_overlap(int ij, int kl) {
+    auto S_pno = submatrix_rows_and_cols(*S_pao_, lmopair_to_paos_[ij], lmopair_to_paos_[kl]);
+    return linalg::triplet(X_pno_[ij], S_pno, X_pno_[kl], true, false, false);
+}
+
 void DLPNOMP2::compute_pno_overlaps() {
     int n_lmo_pairs = ij_to_i_j_.size();
     int naocc = nalpha_ - nfrzc();
+    double F_CUT = options_.get_double("F_CUT");
 
-    S_pno_ij_kj_.resize(n_lmo_pairs);
-    S_pno_ij_ik_.resize(n_lmo_pairs);
+    // Which pairs kj and ik couple to pair ij? Blocks are laid out in pair order for the
+    // pairs with i >= j; pair ji reuses them, since S(ji, ki) = S(ij, ik).
+    S_pno_ij_kj_ = BlockIndex();
+    S_pno_ij_ik_ = BlockIndex();
+    S_pno_ij_kj_.start.push_back(0);
+    S_pno_ij_ik_.start.push_back(0);
 
-#pragma omp parallel for schedule(dynamic, 1)
+    size_t arena_size = 0;
+    for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+
+        if (n_pno_[ij] > 0) {
+            for (int k = 0; k < naocc; ++k) {
+                int kj = i_j_to_ij_[k][j];
+                if (kj != -1 && i != k && fabs(F_lmo_->get(i, k)) > F_CUT && n_pno_[kj] > 0) {
+                    S_pno_ij_kj_.key.push_back(k);
+                    S_pno_ij_kj_.offset.push_back(arena_size);
+                    if (i >= j && owns_pair(ij)) arena_size += (size_t)n_pno_[ij] * n_pno_[kj];
+                }
+            }
+            for (int k = 0; k < naocc; ++k) {
+                int ik = i_j_to_ij_[i][k];
+                if (ik != -1 && j != k && fabs(F_lmo_->get(k, j)) > F_CUT && n_pno_[ik] > 0) {
+                    S_pno_ij_ik_.key.push_back(k);
+                    S_pno_ij_ik_.offset.push_back(arena_size);
+                    if (i >= j && owns_pair(ij)) arena_size += (size_t)n_pno_[ij] * n_pno_[ik];
+                }
+            }
+        }
+
+        S_pno_ij_kj_.start.push_back(S_pno_ij_kj_.key.size());
+        S_pno_ij_ik_.start.push_back(S_pno_ij_ik_.key.size());
+    }
+
+    // the kj blocks of ji are the ik blocks of ij, and vice versa (same k, in the same order)
     for (int ij = 0; ij < n_lmo_pairs; ++ij) {
         int i, j;
         std::tie(i, j) = ij_to_i_j_[ij];
         int ji = ij_to_ji_[ij];
+        if (i <= j) continue;
+        std::copy(S_pno_ij_ik_.offset.begin() + S_pno_ij_ik_.start[ij],
+                  S_pno_ij_ik_.offset.begin() + S_pno_ij_ik_.start[ij + 1],
+                  S_pno_ij_kj_.offset.begin() + S_pno_ij_kj_.start[ji]);
+        std::copy(S_pno_ij_kj_.offset.begin() + S_pno_ij_kj_.start[ij],
+                  S_pno_ij_kj_.offset.begin() + S_pno_ij_kj_.start[ij + 1],
+                  S_pno_ij_ik_.offset.begin() + S_pno_ij_ik_.start[ji]);
+    }
 
-        if (n_pno_[ij] == 0) continue;
-        if (i < j) continue;
+    // The coupled pairs owned by other ranks are each rank's halo; their PNOs are needed for the
+    // overlaps, and their amplitudes in every iteration
+    halo_pairs_.assign(nrank_, {});
+    for (int ij = 0; ij < n_lmo_pairs && nrank_ > 1; ++ij) {
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+        int rank = pair_to_rank_[ij];
+        for (size_t n = S_pno_ij_kj_.start[ij]; n < S_pno_ij_kj_.start[ij + 1]; ++n) {
+            int kj = i_j_to_ij_[S_pno_ij_kj_.key[n]][j];
+            if (pair_to_rank_[kj] != rank) halo_pairs_[rank].push_back(kj);
+        }
+        for (size_t n = S_pno_ij_ik_.start[ij]; n < S_pno_ij_ik_.start[ij + 1]; ++n) {
+            int ik = i_j_to_ij_[i][S_pno_ij_ik_.key[n]];
+            if (pair_to_rank_[ik] != rank) halo_pairs_[rank].push_back(ik);
+        }
+    }
+    for (auto& halo : halo_pairs_) {
+        std::sort(halo.begin(), halo.end());
+        halo.erase(std::unique(halo.begin(), halo.end()), halo.end());
+    }
+    share_halo_pairs(X_pno_, [this](int kl) {
+        return std::make_pair((int)lmopair_to_paos_[kl].size(), n_pno_[kl]);
+    });
+    if (nrank_ > 1) {
+        outfile->Printf("\n    Halo of rank 0: %zu pairs owned by other ranks\n", halo_pairs_[0].size());
+    }
 
-        S_pno_ij_kj_[ij] = std::vector<SharedMatrix>(naocc);
-        S_pno_ij_ik_[ij] = std::vector<SharedMatrix>(naocc);
+    S_pno_direct_ = (options_.get_str("PNO_OVERLAP_ALGORITHM") == "DIRECT");
+    if (S_pno_direct_) {
+        S_pno_data_.clear();
+        outfile->Printf("\n    PNO overlaps: %zu blocks, %.1f MiB, computed on the fly\n",
+                        S_pno_ij_kj_.key.size() + S_pno_ij_ik_.key.size(), arena_size * sizeof(double) / (1024.0 * 1024.0));
+        return;
+    }
 
-        for (int k = 0; k < naocc; ++k) {
-            int kj = i_j_to_ij_[k][j];
-            if (kj != -1 && i != k && fabs(F_lmo_->get(i, k)) > options_.get_double("F_CUT") && n_pno_[kj] > 0) {
-                S_pno_ij_kj_[ij][k] = submatrix_rows_and_cols(*S_pao_, lmopair_to_paos_[ij], lmopair_to_paos_[kj]);
-                S_pno_ij_kj_[ij][k] = linalg::triplet(X_pno_[ij], S_pno_ij_kj_[ij][k], X_pno_[kj], true, false, false);
-            }
+    S_pno_data_.assign(arena_size, 0.0);
 
-            int ik = i_j_to_ij_[i][k];
-            if (ik != -1 && j != k && fabs(F_lmo_->get(k, j)) > options_.get_double("F_CUT") && n_pno_[ik] > 0) {
-                S_pno_ij_ik_[ij][k] = submatrix_rows_and_cols(*S_pao_, lmopair_to_paos_[ij], lmopair_to_paos_[ik]);
-                S_pno_ij_ik_[ij][k] = linalg::triplet(X_pno_[ij], S_pno_ij_ik_[ij][k], X_pno_[ik], true, false, false);
-            }
+    // pairs ordered by the cost of their overlap blocks, largest first
+    std::vector<double> pair_cost(n_lmo_pairs, 0.0);
+    for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+        if (i < j || !owns_pair(ij)) continue;
+        double npao_ij = lmopair_to_paos_[ij].size();
+        for (size_t n = S_pno_ij_kj_.start[ij]; n < S_pno_ij_kj_.start[ij + 1]; ++n) {
+            int kj = i_j_to_ij_[S_pno_ij_kj_.key[n]][j];
+            pair_cost[ij] += npao_ij * lmopair_to_paos_[kj].size() * (n_pno_[ij] + n_pno_[kj]);
+        }
+        for (size_t n = S_pno_ij_ik_.start[ij]; n < S_pno_ij_ik_.start[ij + 1]; ++n) {
+            int ik = i_j_to_ij_[i][S_pno_ij_ik_.key[n]];
+            pair_cost[ij] += npao_ij * lmopair_to_paos_[ik].size() * (n_pno_[ij] + n_pno_[ik]);
+        }
+    }
+    std::vector<int> pair_order = sort_by_cost(pair_cost);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int ij_task = 0; ij_task < n_lmo_pairs; ++ij_task) {
+        int ij = pair_order[ij_task];
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+
+        if (n_pno_[ij] == 0) continue;
+        if (i < j || !owns_pair(ij)) continue;
+
+        for (size_t n = S_pno_ij_kj_.start[ij]; n < S_pno_ij_kj_.start[ij + 1]; ++n) {
+            auto S_pno = pno_overlap(ij, i_j_to_ij_[S_pno_ij_kj_.key[n]][j]);
+            ::memcpy(&S_pno_data_[S_pno_ij_kj_.offset[n]], S_pno->pointer()[0], sizeof(double) * S_pno->size());
         }
 
-        if (i > j) {
-            S_pno_ij_kj_[ji] = S_pno_ij_ik_[ij];
-            S_pno_ij_ik_[ji] = S_pno_ij_kj_[ij];
+        for (size_t n = S_pno_ij_ik_.start[ij]; n < S_pno_ij_ik_.start[ij + 1]; ++n) {
+            auto S_pno = pno_overlap(ij, i_j_to_ij_[i][S_pno_ij_ik_.key[n]]);
+            ::memcpy(&S_pno_data_[S_pno_ij_ik_.offset[n]], S_pno->pointer()[0], sizeof(double) * S_pno->size());
         }
     }
+
+    outfile->Printf("\n    PNO overlaps: %zu blocks, %.1f MiB\n", S_pno_ij_kj_.key.size() + S_pno_ij_ik_.key.size(),
+                    arena_size * sizeof(double) / (1024.0 * 1024.0));
 }
 
 void DLPNOMP2::lmp2_iterations() {
     int n_lmo_pairs = ij_to_i_j_.size();
-    int naocc = nalpha_ - nfrzc();
 
     outfile->Printf("\n  ==> Local MP2 <==\n\n");
     outfile->Printf("    E_CONVERGENCE = %.2e\n", options_.get_double("E_CONVERGENCE"));
@@ -994,54 +1468,132 @@ void DLPNOMP2::lmp2_iterations() {
     double e_curr = 0.0, e_prev = 0.0, r_curr = 0.0;
     bool e_converged = false, r_converged = false;
     DIISManager diis(options_.get_int("DIIS_MAX_VECS"), "LMP2 DIIS", DIISManager::RemovalPolicy::LargestError, DIISManager::StoragePolicy::InCore);
+#ifdef ENABLE_MPI
+    DistributedDIIS diis_mpi(options_.get_int("DIIS_MAX_VECS"),
+                             [this](double* data, int n) { sum_over_ranks(data, n); });
+#endif
+
+    // residuals and scratch for the coupling terms are allocated once
+    int max_pno = 0;
+    std::vector<SharedMatrix> T_owned, R_owned;  // the pairs of this rank, for DIIS
+    for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        max_pno = std::max(max_pno, n_pno_[ij]);
+        if (!owns_pair(ij)) continue;
+        R_iajb[ij] = std::make_shared<Matrix>("Residual", n_pno_[ij], n_pno_[ij]);
+        T_owned.push_back(T_iajb_[ij]);
+        R_owned.push_back(R_iajb[ij]);
+    }
+    auto T_shape = [this](int kl) { return std::make_pair(n_pno_[kl], n_pno_[kl]); };
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = omp_get_max_threads();
+#endif
+    std::vector<std::vector<double>> ST_scratch(nthread, std::vector<double>((size_t)max_pno * max_pno));
+
+    // The residual of pair ij costs O(npno_ij^2 npno_kj) per coupled pair kj. Pairs are assigned
+    // to threads once, balancing the predicted cost, so that each thread keeps its pairs (and
+    // their cached overlaps) across iterations.
+    std::vector<double> pair_cost(n_lmo_pairs, 0.0);
+    for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+        int i, j;
+        std::tie(i, j) = ij_to_i_j_[ij];
+        if (!owns_pair(ij)) continue;
+        double npno_ij = n_pno_[ij];
+        pair_cost[ij] = npno_ij * npno_ij;
+        for (size_t n = S_pno_ij_kj_.start[ij]; n < S_pno_ij_kj_.start[ij + 1]; ++n) {
+            double npno_kj = n_pno_[i_j_to_ij_[S_pno_ij_kj_.key[n]][j]];
+            pair_cost[ij] += npno_ij * npno_kj * (npno_ij + npno_kj);
+        }
+        for (size_t n = S_pno_ij_ik_.start[ij]; n < S_pno_ij_ik_.start[ij + 1]; ++n) {
+            double npno_ik = n_pno_[i_j_to_ij_[i][S_pno_ij_ik_.key[n]]];
+            pair_cost[ij] += npno_ij * npno_ik * (npno_ij + npno_ik);
+        }
+    }
+    std::vector<std::vector<int>> thread_to_pairs = partition_by_cost(pair_cost, nthread);
+    std::vector<double> thread_time(nthread, 0.0);
+
+    // with PNO_OVERLAP_ALGORITHM DIRECT, each thread keeps its recently used overlaps
+    size_t cache_doubles = (size_t)options_.get_int("PNO_OVERLAP_CACHE") * 1024 * 1024 / sizeof(double);
+    std::vector<PNOOverlapCache> S_pno_cache(nthread, PNOOverlapCache(cache_doubles / nthread));
 
     while (!(e_converged && r_converged)) {
         // RMS of residual per LMO pair, for assessing convergence
         std::vector<double> R_iajb_rms(n_lmo_pairs, 0.0);
 
-        // Calculate residuals from current amplitudes
-#pragma omp parallel for schedule(static, 1)
-        for (int ij = 0; ij < n_lmo_pairs; ++ij) {
-            int i, j;
-            std::tie(i, j) = ij_to_i_j_[ij];
+        // current amplitudes of the coupled pairs of other ranks
+        share_halo_pairs(T_iajb_, T_shape);
 
-            R_iajb[ij] = std::make_shared<Matrix>("Residual", n_pno_[ij], n_pno_[ij]);
-
-            if (n_pno_[ij] == 0) continue;
+        // Calculate residuals from current amplitudes
+#pragma omp parallel
+        {
+            int thread_id = 0, nthread_active = 1;
+#ifdef _OPENMP
+            thread_id = omp_get_thread_num();
+            nthread_active = omp_get_num_threads();
+#endif
+            for (int thread = thread_id; thread < nthread; thread += nthread_active) {
+                auto t_start = std::chrono::steady_clock::now();
+                for (int ij : thread_to_pairs[thread]) {
+                    int i, j;
+                    std::tie(i, j) = ij_to_i_j_[ij];
+
+                    if (n_pno_[ij] == 0 || !owns_pair(ij)) continue;
+
+                    double* ST = ST_scratch[thread].data();
+                    double** Rp = R_iajb[ij]->pointer();
+                    int npno_ij = n_pno_[ij];
+
+                    for (int a = 0; a < n_pno_[ij]; ++a) {
+                        for (int b = 0; b < n_pno_[ij]; ++b) {
+                            R_iajb[ij]->set(a, b,
+                                            K_iajb_[ij]->get(a, b) + (e_pno_[ij]->get(a) + e_pno_[ij]->get(b) -
+                                                                      F_lmo_->get(i, i) - F_lmo_->get(j, j)) *
+                                                                         T_iajb_[ij]->get(a, b));
+                        }
+                    }
 
-            for (int a = 0; a < n_pno_[ij]; ++a) {
-                for (int b = 0; b < n_pno_[ij]; ++b) {
-                    R_iajb[ij]->set(a, b,
-                                    K_iajb_[ij]->get(a, b) +
-                                        (e_pno_[ij]->get(a) + e_pno_[ij]->get(b) - F_lmo_->get(i, i) - F_lmo_->get(j, j)) *
-                                            T_iajb_[ij]->get(a, b));
-                }
-            }
+                    // R_ij -= F_ik S(ij, kj) T_kj S(ij, kj)^T
+                    for (size_t n = S_pno_ij_kj_.start[ij]; n < S_pno_ij_kj_.start[ij + 1]; ++n) {
+                        int k = S_pno_ij_kj_.key[n];
+                        int kj = i_j_to_ij_[k][j];
+                        int npno_kj = n_pno_[kj];
+                        size_t offset = S_pno_ij_kj_.offset[n];
+                        double* S = S_pno_direct_
+                                        ? S_pno_cache[thread].get(offset, [&] { return pno_overlap(ij, kj); })
+                                        : &S_pno_data_[offset];
+                        C_DGEMM('N', 'N', npno_ij, npno_kj, npno_kj, 1.0, S, npno_kj, T_iajb_[kj]->pointer()[0],
+                                npno_kj, 0.0, ST, npno_kj);
+                        C_DGEMM('N', 'T', npno_ij, npno_ij, npno_kj, -1.0 * F_lmo_->get(i, k), ST, npno_kj, S,
+                                npno_kj, 1.0, Rp[0], npno_ij);
+                    }
 
-            for (int k = 0; k < naocc; ++k) {
-                int kj = i_j_to_ij_[k][j];
-                int ik = i_j_to_ij_[i][k];
+                    // R_ij -= F_kj S(ij, ik) T_ik S(ij, ik)^T
+                    for (size_t n = S_pno_ij_ik_.start[ij]; n < S_pno_ij_ik_.start[ij + 1]; ++n) {
+                        int k = S_pno_ij_ik_.key[n];
+                        int ik = i_j_to_ij_[i][k];
+                        int npno_ik = n_pno_[ik];
+                        size_t offset = S_pno_ij_ik_.offset[n];
+                        double* S = S_pno_direct_
+                                        ? S_pno_cache[thread].get(offset, [&] { return pno_overlap(ij, ik); })
+                                        : &S_pno_data_[offset];
+                        C_DGEMM('N', 'N', npno_ij, npno_ik, npno_ik, 1.0, S, npno_ik, T_iajb_[ik]->pointer()[0],
+                                npno_ik, 0.0, ST, npno_ik);
+                        C_DGEMM('N', 'T', npno_ij, npno_ij, npno_ik, -1.0 * F_lmo_->get(k, j), ST, npno_ik, S,
+                                npno_ik, 1.0, Rp[0], npno_ij);
+                    }
 
-                if (kj != -1 && i != k && fabs(F_lmo_->get(i, k)) > options_.get_double("F_CUT") && n_pno_[kj] > 0) {
-                    auto temp =
-                        linalg::triplet(S_pno_ij_kj_[ij][k], T_iajb_[kj], S_pno_ij_kj_[ij][k], false, false, true);
-                    temp->scale(-1.0 * F_lmo_->get(i, k));
-                    R_iajb[ij]->add(temp);
-                }
-                if (ik != -1 && j != k && fabs(F_lmo_->get(k, j)) > options_.get_double("F_CUT") && n_pno_[ik] > 0) {
-                    auto temp =
-                        linalg::triplet(S_pno_ij_ik_[ij][k], T_iajb_[ik], S_pno_ij_ik_[ij][k], false, false, true);
-                    temp->scale(-1.0 * F_lmo_->get(k, j));
-                    R_iajb[ij]->add(temp);
+                    R_iajb_rms[ij] = R_iajb[ij]->rms();
                 }
+                std::chrono::duration<double> t_thread = std::chrono::steady_clock::now() - t_start;
+                thread_time[thread] += t_thread.count();
             }
-
-            R_iajb_rms[ij] = R_iajb[ij]->rms();
         }
 
         // evaluate convergence using current amplitudes and residuals
         e_prev = e_curr;
         e_curr = compute_iteration_energy(R_iajb);
+        sum_over_ranks(R_iajb_rms.data(), n_lmo_pairs);  // each pair has one owner
         r_curr = *max_element(R_iajb_rms.begin(), R_iajb_rms.end());
 
         r_converged = (fabs(r_curr) < options_.get_double("R_CONVERGENCE"));
@@ -1052,6 +1604,7 @@ void DLPNOMP2::lmp2_iterations() {
         for (int ij = 0; ij < n_lmo_pairs; ++ij) {
             int i, j;
             std::tie(i, j) = ij_to_i_j_[ij];
+            if (!owns_pair(ij)) continue;
             for (int a = 0; a < n_pno_[ij]; ++a) {
                 for (int b = 0; b < n_pno_[ij]; ++b) {
                     T_iajb_[ij]->add(a, b, -R_iajb[ij]->get(a, b) / ((e_pno_[ij]->get(a) + e_pno_[ij]->get(b)) -
@@ -1061,21 +1614,29 @@ void DLPNOMP2::lmp2_iterations() {
         }
 
         // DIIS extrapolation
-        auto T_iajb_flat = flatten_mats(T_iajb_);
-        auto R_iajb_flat = flatten_mats(R_iajb);
+        auto T_iajb_flat = flatten_mats(T_owned);
+        auto R_iajb_flat = flatten_mats(R_owned);
 
-        if (iteration == 0) {
-            diis.set_error_vector_size(R_iajb_flat.get());
-            diis.set_vector_size(T_iajb_flat.get());
-        }
+        if (nrank_ == 1) {
+            if (iteration == 0) {
+                diis.set_error_vector_size(R_iajb_flat.get());
+                diis.set_vector_size(T_iajb_flat.get());
+            }
 
-        diis.add_entry(R_iajb_flat.get(), T_iajb_flat.get());
-        diis.extrapolate(T_iajb_flat.get());
+            diis.add_entry(R_iajb_flat.get(), T_iajb_flat.get());
+            diis.extrapolate(T_iajb_flat.get());
+        } else {
+#ifdef ENABLE_MPI
+            diis_mpi.add_entry(R_iajb_flat, T_iajb_flat);
+            diis_mpi.extrapolate(T_iajb_flat);
+#endif
+        }
 
-        copy_flat_mats(T_iajb_flat, T_iajb_);
+        copy_flat_mats(T_iajb_flat, T_owned);
 
 #pragma omp parallel for schedule(static, 1)
         for (int ij = 0; ij < n_lmo_pairs; ++ij) {
+            if (!owns_pair(ij)) continue;
             Tt_iajb_[ij]->copy(T_iajb_[ij]);
             Tt_iajb_[ij]->scale(2.0);
             Tt_iajb_[ij]->subtract(T_iajb_[ij]->transpose());
@@ -1090,12 +1651,39 @@ void DLPNOMP2::lmp2_iterations() {
         }
     }
 
+    if (print_ > 1) {
+        double load_max = 0.0, load_sum = 0.0, time_max = 0.0, time_sum = 0.0;
+        for (int thread = 0; thread < nthread; ++thread) {
+            double load = 0.0;
+            for (int ij : thread_to_pairs[thread]) load += pair_cost[ij];
+            load_max = std::max(load_max, load);
+            load_sum += load;
+            time_max = std::max(time_max, thread_time[thread]);
+            time_sum += thread_time[thread];
+        }
+        outfile->Printf("\n    Residual load balance over %d threads (max / mean):\n", nthread);
+        outfile->Printf("      Predicted: %6.3f\n", (load_sum > 0.0) ? load_max * nthread / load_sum : 1.0);
+        outfile->Printf("      Measured:  %6.3f (%.3f s per thread)\n",
+                        (time_sum > 0.0) ? time_max * nthread / time_sum : 1.0, time_sum / nthread);
+    }
+
+    if (S_pno_direct_) {
+        size_t hits = 0, misses = 0;
+        for (const auto& cache : S_pno_cache) {
+            hits += cache.hits;
+            misses += cache.misses;
+        }
+        outfile->Printf("\n    PNO overlap cache: %zu hits, %zu misses\n", hits, misses);
+    }
+
     e_lmp2_ = e_curr;
 
     e_lmp2_os_ = 0.0;
     for (int ij = 0; ij < T_iajb_.size(); ++ij) {
+        if (!owns_pair(ij)) continue;
         e_lmp2_os_ += K_iajb_[ij]->vector_dot(T_iajb_[ij]);
     }
+    sum_over_ranks(&e_lmp2_os_, 1);
     e_lmp2_ss_ = e_curr - e_lmp2_os_;
 
 }
@@ -1103,9 +1691,11 @@ void DLPNOMP2::lmp2_iterations() {
 double DLPNOMP2::compute_iteration_energy(const std::vector<SharedMatrix> &R_iajb) {
     double e_mp2 = 0.0;
     for (int ij = 0; ij < Tt_iajb_.size(); ++ij) {
+        if (!owns_pair(ij)) continue;
         e_mp2 += K_iajb_[ij]->vector_dot(Tt_iajb_[ij]);
         e_mp2 += R_iajb[ij]->vector_dot(Tt_iajb_[ij]);
     }
+    sum_over_ranks(&e_mp2, 1);
     return e_mp2;
 }
 
@@ -1118,17 +1708,55 @@ void DLPNOMP2::setup_orbitals() {
     int naocc = nalpha_ - nfrzc();
 
     auto C_occ = reference_wavefunction_->Ca_subset("AO", "OCC");
+    auto C_act = reference_wavefunction_->Ca_subset("AO", "ACTIVE_OCC");
 
     timer_on("Local MOs");
+
+    std::string signature = options_.get_str("DLPNO_LOCAL_ORBITALS") + " " + basisset_->name() + " " +
+                            std::to_string(nbf) + " " + std::to_string(naocc);
+    for (int A = 0; A < natom; A++) signature += " " + std::to_string(molecule_->Z(A));
+    Matrix geometry = molecule_->geometry();
+
+    // Start from the LMOs of a previous computation on this system, projected onto the current
+    // active occupied space, if the atoms have not moved too far
+    bool reuse_lmos = options_.get_bool("DLPNO_REUSE_LMOS");
+    for (auto it = previous_lmos.begin(); reuse_lmos && it != previous_lmos.end(); ++it) {
+        if (it->signature != signature) continue;
+
+        double max_displacement = 0.0;
+        for (int A = 0; A < natom; A++) {
+            double dx = geometry.get(A, 0) - it->geometry.get(A, 0);
+            double dy = geometry.get(A, 1) - it->geometry.get(A, 1);
+            double dz = geometry.get(A, 2) - it->geometry.get(A, 2);
+            max_displacement = std::max(max_displacement, std::sqrt(dx * dx + dy * dy + dz * dz));
+        }
+        if (max_displacement > options_.get_double("DLPNO_REUSE_MAX_DISPLACEMENT")) break;
+
+        // rotation of the active orbitals closest to the previous LMOs, U (U^T U)^-1/2
+        auto U = linalg::triplet(C_act, reference_wavefunction_->S(), it->C_lmo, true, false, false);
+        auto UtU = linalg::doublet(U, U, true, false);
+        auto UtU_evecs = std::make_shared<Matrix>("eigenvectors", naocc, naocc);
+        Vector UtU_evals("eigenvalues", naocc);
+        UtU->diagonalize(*UtU_evecs, UtU_evals, ascending);
+        if (naocc == 0 || UtU_evals.get(0) < 0.5) break;
+
+        UtU->power(-0.5);
+        C_act = linalg::triplet(C_act, U, UtU, false, false, false);
+
+        outfile->Printf("\n    Starting localization from the LMOs of a previous computation\n");
+        outfile->Printf("      (max. atomic displacement %.2e bohr)\n", max_displacement);
+        break;
+    }
+
     // Localize active occupied orbitals
     if (options_.get_str("DLPNO_LOCAL_ORBITALS") == "BOYS") {
-        BoysLocalizer localizer = BoysLocalizer(basisset_, reference_wavefunction_->Ca_subset("AO", "ACTIVE_OCC"));
+        BoysLocalizer localizer = BoysLocalizer(basisset_, C_act);
         localizer.set_convergence(options_.get_double("LOCAL_CONVERGENCE"));
         localizer.set_maxiter(options_.get_int("LOCAL_MAXITER"));
         localizer.localize();
         C_lmo_ = localizer.L();
     } else if (options_.get_str("DLPNO_LOCAL_ORBITALS") == "PIPEK_MEZEY") {
-        PMLocalizer localizer = PMLocalizer(basisset_, reference_wavefunction_->Ca_subset("AO", "ACTIVE_OCC"));
+        PMLocalizer localizer = PMLocalizer(basisset_, C_act);
         localizer.set_convergence(options_.get_double("LOCAL_CONVERGENCE"));
         localizer.set_maxiter(options_.get_int("LOCAL_MAXITER"));
         localizer.localize();
@@ -1136,6 +1764,13 @@ void DLPNOMP2::setup_orbitals() {
     } else {
         throw PSIEXCEPTION("Invalid option for DLPNO_LOCAL_ORBITALS");
     }
+
+    if (reuse_lmos) {
+        previous_lmos.remove_if([&signature](const PreviousLMOs& entry) { return entry.signature == signature; });
+        previous_lmos.push_front(PreviousLMOs{signature, geometry, C_lmo_->clone()});
+        if (previous_lmos.size() > max_previous_lmos) previous_lmos.pop_back();
+    }
+
     timer_off("Local MOs");
 
     F_lmo_ = linalg::triplet(C_lmo_, reference_wavefunction_->Fa(), C_lmo_, true, false, false);
@@ -1186,37 +1821,52 @@ double DLPNOMP2::compute_energy() {
 
     print_header();
 
+#ifdef ENABLE_MPI
+    if (distribute_pairs_) mpi_layout(rank_, nrank_);
+#endif
+
+    // With the pairs divided over MPI ranks, every rank must build the same domains, so the
+    // orbitals and screening integrals of the root are used everywhere
     timer_on("Setup Orbitals");
     setup_orbitals();
+    bcast_from_root({C_lmo_, F_lmo_, C_pao_, S_pao_, F_pao_});
     timer_off("Setup Orbitals");
 
     timer_on("Overlap Ints");
     compute_overlap_ints();
+    bcast_from_root({DOI_ij_, DOI_iu_});
     timer_off("Overlap Ints");
 
     timer_on("Dipole Ints");
     compute_dipole_ints();
+    bcast_from_root({dipole_pair_e_, dipole_pair_e_bound_});
     timer_off("Dipole Ints");
 
     timer_on("Sparsity");
     prep_sparsity();
+    assign_pair_ranks();
     timer_off("Sparsity");
 
     timer_on("DF Ints");
     compute_df_ints();
     timer_off("DF Ints");
 
-    timer_on("PNO Transform");
-    pno_transform();
-    timer_off("PNO Transform");
+    {
+        // Threads run over pairs here, and the per-pair BLAS calls are too small to share
+        BlasThreads blas_threads(BlasThreads::Outer, Process::environment.get_n_threads(), "DLPNO-MP2 pairs");
+
+        timer_on("PNO Transform");
+        pno_transform();
+        timer_off("PNO Transform");
 
-    timer_on("PNO Overlaps");
-    compute_pno_overlaps();
-    timer_off("PNO Overlaps");
+        timer_on("PNO Overlaps");
+        compute_pno_overlaps();
+        timer_off("PNO Overlaps");
 
-    timer_on("LMP2");
-    lmp2_iterations();
-    timer_off("LMP2");
+        timer_on("LMP2");
+        lmp2_iterations();
+        timer_off("LMP2");
+    }
 
     print_results();
 
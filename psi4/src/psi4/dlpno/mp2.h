@@ -33,6 +33,8 @@
 
 #include "psi4/libmints/wavefunction.h"
 
+#include <functional>
+
 namespace psi {
 namespace dlpno {
 
@@ -82,8 +84,12 @@ class DLPNOMP2 : public Wavefunction {
     std::vector<double> de_pno_;   ///< PNO truncation energy error
     std::vector<double> de_pno_os_;   ///< opposite-spin contributions to de_pno_
     std::vector<double> de_pno_ss_;   ///< same-spin contributions to de_pno_
-    std::vector<std::vector<SharedMatrix>> S_pno_ij_kj_; ///< pno overlaps
-    std::vector<std::vector<SharedMatrix>> S_pno_ij_ik_; ///< pnooverlaps
+    /// PNO/PNO overlaps of the pairs coupled through the off-diagonal LMO Fock matrix,
+    /// stored back to back in pair order. Blocks are (npno_ij x npno_kj), row-major.
+    std::vector<double> S_pno_data_;
+    BlockIndex S_pno_ij_kj_; ///< S(ij, kj) blocks of pair ij, keyed by k
+    BlockIndex S_pno_ij_ik_; ///< S(ij, ik) blocks of pair ij, keyed by k
+    bool S_pno_direct_; ///< compute the blocks in the residual loop instead of storing them?
 
     // final energies
     double de_dipole_; ///< energy correction for distant (LMO, LMO) pairs
@@ -128,6 +134,17 @@ class DLPNOMP2 : public Wavefunction {
     SparseMap riatom_to_shells2_; ///< which shells of orbital BFs are needed for DF int transform (second index)
     SparseMap riatom_to_bfs2_; ///< which orbital BFs are needed for DF int transform (second index)
 
+    // => MPI Distribution <= //
+
+    // Every rank runs the SCF and the domain construction; the LMO pairs are divided. A rank
+    // keeps the (iu|Q) integrals, PNOs, and amplitudes of its own pairs, plus the PNOs and
+    // amplitudes of the pairs its residuals couple to.
+    bool distribute_pairs_; ///< divide the pairs over MPI ranks? (off for methods needing all of them)
+    int rank_;
+    int nrank_;
+    std::vector<int> pair_to_rank_; ///< which rank owns LMO pair ij? ij and ji share a rank
+    std::vector<std::vector<int>> halo_pairs_; ///< pairs owned elsewhere that each rank's residuals couple to
+
     // Dense analogues of some sparse maps for quick lookup
     std::vector<std::vector<int>> riatom_to_lmos_ext_dense_;
     std::vector<std::vector<bool>> riatom_to_atoms1_dense_;
@@ -153,12 +170,31 @@ class DLPNOMP2 : public Wavefunction {
     /// three-index integrals.
     void prep_sparsity();
 
+    /// Divide the LMO pairs over the MPI ranks, by regions of the molecule
+    void assign_pair_ranks();
+
+    bool owns_pair(int ij) const { return pair_to_rank_[ij] == rank_; }
+
+    /// Give every rank the root's copy of mats, which must have the same shapes on all ranks
+    void bcast_from_root(const std::vector<SharedMatrix>& mats);
+
+    /// Send the mats of owned pairs to the ranks that have them in their halo; shape(kl) gives
+    /// the dimensions of a received pair
+    void share_halo_pairs(std::vector<SharedMatrix>& mats, const std::function<std::pair<int, int>(int)>& shape);
+
+    /// Sums over all ranks, identical on every rank
+    void sum_over_ranks(double* data, int n);
+    void sum_over_ranks(int* data, int n);
+
     /// Compute three-index integrals in LMO/PAO basis with linear scaling (EQ 11)
     void compute_df_ints();
 
     /// form pair exch operators (EQ 15) and SC amplitudes (EQ 18); transform to PNO basis
     void pno_transform();
 
+    /// overlap between the PNOs of pairs ij and kl
+    SharedMatrix pno_overlap(int ij, int kl);
+
     /// compute PNO/PNO overlap matrices
     void compute_pno_overlaps();
 
@@ -30,36 +30,54 @@
 
 #include "psi4/libqt/qt.h"
 
-#include <tuple>
 #include <algorithm>
+#include <iterator>
+#include <tuple>
 
 namespace psi {
 
-std::vector<int> merge_lists(const std::vector<int> &l1, const std::vector<int> &l2) {
+namespace {
 
-    std::vector<int> l12;
+/* Largest value in any list of a SparseMap, plus one */
+int map_range(const std::vector<std::vector<int>> &x_to_y) {
+
+    int ny = 0;
+    for(const auto &ys : x_to_y) {
+        for(int y : ys) ny = std::max(ny, y + 1);
+    }
+    return ny;
 
-    int i1 = 0, i2 = 0;
-    while(i1 < l1.size() || i2 < l2.size()) {
-        if(i1 == l1.size()) {
-            l12.push_back(l2[i2]);
-            ++i2;
-        } else if(i2 == l2.size()) {
-            l12.push_back(l1[i1]);
-            ++i1;
-        } else if(l1[i1] == l2[i2]) {
-            l12.push_back(l1[i1]);
-            ++i1;
-            ++i2;
-        } else if(l1[i1] < l2[i2]) {
-            l12.push_back(l1[i1]);
-            ++i1;
-        } else {
-            l12.push_back(l2[i2]);
-            ++i2;
+}
+
+/* Sorted union of the lists x_to_y[x] for x in xs. seen (one flag per y value, all false) marks
+ * values already collected and is reset before returning, so each list element is touched once
+ * and only the (unique) result is sorted.
+ */
+std::vector<int> union_of_lists(const std::vector<int> &xs, const std::vector<std::vector<int>> &x_to_y,
+                                std::vector<char> &seen) {
+
+    std::vector<int> ys;
+    for(int x : xs) {
+        for(int y : x_to_y[x]) {
+            if(!seen[y]) {
+                seen[y] = 1;
+                ys.push_back(y);
+            }
         }
     }
+    for(int y : ys) seen[y] = 0;
+    std::sort(ys.begin(), ys.end());
+    return ys;
+
+}
 
+} // namespace
+
+std::vector<int> merge_lists(const std::vector<int> &l1, const std::vector<int> &l2) {
+
+    std::vector<int> l12;
+    l12.reserve(l1.size() + l2.size());
+    std::set_union(l1.begin(), l1.end(), l2.begin(), l2.end(), std::back_inserter(l12));
     return l12;
 
 }
@@ -92,6 +110,26 @@ std::vector<int> contract_lists(const std::vector<int> &y, const std::vector<std
 
 }
 
+std::vector<int> contract_lists(const std::vector<int> &y, const std::vector<std::vector<int>> &A_to_y,
+                                const std::vector<int> &y_to_A) {
+
+    std::vector<int> As;
+    for(int y_val : y) {
+        int a = y_to_A[y_val];
+        if(As.empty() || As.back() != a) As.push_back(a);
+    }
+    std::sort(As.begin(), As.end());
+    As.erase(std::unique(As.begin(), As.end()), As.end());
+
+    std::vector<int> yA;
+    for(int a : As) {
+        yA.insert(yA.end(), A_to_y[a].begin(), A_to_y[a].end());
+    }
+
+    return yA;
+
+}
+
 std::vector<int> block_list(const std::vector<int> &x_list, const std::vector<int> &x_to_y_map) {
 
     std::vector<int> y_list;
@@ -114,6 +152,12 @@ std::vector<std::vector<int>> invert_map(const std::vector<std::vector<int>> &x_
     int nx = x_to_y.size();
     std::vector<std::vector<int>> y_to_x(ny);
 
+    std::vector<size_t> y_count(ny, 0);
+    for(int x = 0; x < nx; x++) {
+        for(auto y : x_to_y[x]) y_count[y]++;
+    }
+    for(int y = 0; y < ny; y++) y_to_x[y].reserve(y_count[y]);
+
     for(int x = 0; x < nx; x++) {
         for(auto y : x_to_y[x]) {
             y_to_x[y].push_back(x);
@@ -127,16 +171,16 @@ std::vector<std::vector<int>> invert_map(const std::vector<std::vector<int>> &x_
 std::vector<std::vector<int>> chain_maps(const std::vector<std::vector<int>> &x_to_y, const std::vector<std::vector<int>> &y_to_z) {
 
     int nx = x_to_y.size();
+    int nz = map_range(y_to_z);
     std::vector<std::vector<int>> x_to_z(nx);
 
-    for(int x = 0; x < nx; x++) {
-        for(auto y : x_to_y[x]) {
-            for(auto z : y_to_z[y]) {
-                x_to_z[x].push_back(z);
-            }
+#pragma omp parallel
+    {
+        std::vector<char> seen(nz, 0);
+#pragma omp for schedule(dynamic, 1)
+        for(int x = 0; x < nx; x++) {
+            x_to_z[x] = union_of_lists(x_to_y[x], y_to_z, seen);
         }
-        std::sort(x_to_z[x].begin(), x_to_z[x].end());
-        x_to_z[x].erase(std::unique(x_to_z[x].begin(), x_to_z[x].end()), x_to_z[x].end());
     }
 
     return x_to_z;
@@ -146,12 +190,24 @@ std::vector<std::vector<int>> chain_maps(const std::vector<std::vector<int>> &x_
 std::vector<std::vector<int>> extend_maps(const std::vector<std::vector<int>> &x_to_y, const std::vector<std::pair<int,int>> &xpairs) {
 
     int nx = x_to_y.size();
+    int ny = map_range(x_to_y);
     std::vector<std::vector<int>> xext_to_y(nx);
 
+    // partners x2 of each x1
+    std::vector<std::vector<int>> x_to_partners(nx);
     for(auto xpair : xpairs) {
-        size_t x1, x2;
+        int x1, x2;
         std::tie(x1,x2) = xpair;
-        xext_to_y[x1] = merge_lists(xext_to_y[x1], x_to_y[x2]);
+        x_to_partners[x1].push_back(x2);
+    }
+
+#pragma omp parallel
+    {
+        std::vector<char> seen(ny, 0);
+#pragma omp for schedule(dynamic, 1)
+        for(int x1 = 0; x1 < nx; x1++) {
+            xext_to_y[x1] = union_of_lists(x_to_partners[x1], x_to_y, seen);
+        }
     }
 
     return xext_to_y;
@@ -195,5 +251,29 @@ SharedMatrix submatrix_rows_and_cols(const Matrix &mat, const std::vector<int> &
     return mat_new;
 }
 
+std::vector<int> sort_by_cost(const std::vector<double> &cost) {
+
+    std::vector<int> order(cost.size());
+    for(int x = 0; x < order.size(); x++) order[x] = x;
+    std::stable_sort(order.begin(), order.end(), [&cost](int x1, int x2) { return cost[x1] > cost[x2]; });
+    return order;
+
+}
+
+std::vector<std::vector<int>> partition_by_cost(const std::vector<double> &cost, int nthread) {
+
+    std::vector<std::vector<int>> thread_to_tasks(nthread);
+    std::vector<double> load(nthread, 0.0);
+
+    for(int x : sort_by_cost(cost)) {
+        int t = std::min_element(load.begin(), load.end()) - load.begin();
+        thread_to_tasks[t].push_back(x);
+        load[t] += cost[x];
+    }
+
+    return thread_to_tasks;
+
+}
+
 } // namespace psi
 
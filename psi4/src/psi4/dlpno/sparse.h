@@ -35,6 +35,15 @@
 
 typedef std::vector<std::vector<int>> SparseMap;
 
+/* Blocks of a contiguous arena, grouped by row in CSR fashion: the blocks of row r are
+ * entries [start[r], start[r + 1]), labeled by key and located at data + offset
+ */
+struct BlockIndex {
+    std::vector<size_t> start;
+    std::vector<int> key;
+    std::vector<size_t> offset;
+};
+
 namespace psi{
 
 /* Args: sorted lists l1 and l2
@@ -47,6 +56,12 @@ std::vector<int> merge_lists(const std::vector<int> &l1, const std::vector<int>
  */
 std::vector<int> contract_lists(const std::vector<int> &y, const std::vector<std::vector<int>> &A_to_y);
 
+/* Same as above, but with the inverse map y_to_A (e.g. basis function to atom) the runtime is
+ * proportional to the size of the lists involved rather than to the size of A_to_y
+ */
+std::vector<int> contract_lists(const std::vector<int> &y, const std::vector<std::vector<int>> &A_to_y,
+                                const std::vector<int> &y_to_A);
+
 /* Args: x is a list of values (sorted), y is a map from values of x to values of y
  * Returns: a list of y values
  *
@@ -78,6 +93,16 @@ SharedMatrix submatrix_cols(const Matrix &mat, const std::vector<int> &col_inds)
 /* Args: Matrix, list of row and column indices */
 SharedMatrix submatrix_rows_and_cols(const Matrix &mat, const std::vector<int> &row_inds, const std::vector<int> &col_inds);
 
+/* Args: estimated cost of each task
+ * Returns: task indices ordered by decreasing cost, for dynamic scheduling of uneven loops
+ */
+std::vector<int> sort_by_cost(const std::vector<double> &cost);
+
+/* Args: estimated cost of each task, number of threads
+ * Returns: the tasks of each thread (largest first), each task going to the least-loaded thread
+ */
+std::vector<std::vector<int>> partition_by_cost(const std::vector<double> &cost, int nthread);
+
 } // namespace psi
 
 #endif // PSI4_SRC_DLPNO_SPARSE_H_
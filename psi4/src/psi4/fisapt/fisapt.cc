@@ -1409,82 +1409,20 @@ void FISAPT::exch() {
     std::shared_ptr<Matrix> Cocc_A = matrices_["Cocc_A"];
     std::shared_ptr<Matrix> Cocc_B = matrices_["Cocc_B"];
 
-    // ==> Exchange Terms (S^2, MCBS or DCBS) <== //
+    // ==> Generalized Densities <== //
 
-    std::shared_ptr<Matrix> C_O = linalg::triplet(D_B, S, Cocc_A);
-    std::vector<SharedMatrix>& Cl = jk_->C_left();
-    std::vector<SharedMatrix>& Cr = jk_->C_right();
-    const std::vector<SharedMatrix>& J = jk_->J();
-    const std::vector<SharedMatrix>& K = jk_->K();
-    Cl.clear();
-    Cr.clear();
-    Cl.push_back(Cocc_A);
-    Cr.push_back(C_O);
-    jk_->compute();
-    std::shared_ptr<Matrix> K_O = K[0];
+    // All J/K builds of this routine are independent of each other, so their densities
+    // go into a single multi-density JK call below
 
-    double Exch10_2M = 0.0;
-    std::vector<double> Exch10_2M_terms;
-    Exch10_2M_terms.resize(6);
-    Exch10_2M_terms[0] -= 2.0 * D_A->vector_dot(K_B);
-    Exch10_2M_terms[1] -= 2.0 * linalg::triplet(D_A, S, D_B)->vector_dot(V_A);
-    Exch10_2M_terms[1] -= 4.0 * linalg::triplet(D_A, S, D_B)->vector_dot(J_A);
-    Exch10_2M_terms[1] += 2.0 * linalg::triplet(D_A, S, D_B)->vector_dot(K_A);
-    Exch10_2M_terms[2] -= 2.0 * linalg::triplet(D_B, S, D_A)->vector_dot(V_B);
-    Exch10_2M_terms[2] -= 4.0 * linalg::triplet(D_B, S, D_A)->vector_dot(J_B);
-    Exch10_2M_terms[2] += 2.0 * linalg::triplet(D_B, S, D_A)->vector_dot(K_B);
-    Exch10_2M_terms[3] += 2.0 * linalg::triplet(linalg::triplet(D_B, S, D_A), S, D_B)->vector_dot(V_A);
-    Exch10_2M_terms[3] += 4.0 * linalg::triplet(linalg::triplet(D_B, S, D_A), S, D_B)->vector_dot(J_A);
-    Exch10_2M_terms[4] += 2.0 * linalg::triplet(linalg::triplet(D_A, S, D_B), S, D_A)->vector_dot(V_B);
-    Exch10_2M_terms[4] += 4.0 * linalg::triplet(linalg::triplet(D_A, S, D_B), S, D_A)->vector_dot(J_B);
-    Exch10_2M_terms[5] -= 2.0 * linalg::triplet(D_A, S, D_B)->vector_dot(K_O);
-    for (int k = 0; k < Exch10_2M_terms.size(); k++) {
-        Exch10_2M += Exch10_2M_terms[k];
-    }
-    // for (int k = 0; k < Exch10_2M_terms.size(); k++) {
-    //    outfile->Printf("    Exch10(S^2) (%1d)     = %18.12lf [Eh]\n",k+1,Exch10_2M_terms[k]);
-    //}
-    // scalars_["Exch10(S^2)"] = Exch10_2;
-    // outfile->Printf("    Exch10(S^2) [MCBS]  = %18.12lf [Eh]\n",Exch10_2M);
-    // outfile->Printf("    Exch10(S^2)         = %18.12lf [Eh]\n",Exch10_2M);
-    // fflush(outfile);
+    // => K_O (S^2, MCBS or DCBS) <= //
 
-    // ==> Exchange Terms (S^2, DCBS only) <== //
+    std::shared_ptr<Matrix> C_O = linalg::triplet(D_B, S, Cocc_A);
 
-    // => K_AS <= //
+    // => K_AS (S^2, DCBS only) <= //
 
     std::shared_ptr<Matrix> C_AS = linalg::triplet(P_B, S, Cocc_A);
-    Cl.clear();
-    Cr.clear();
-    Cl.push_back(Cocc_A);
-    Cr.push_back(C_AS);
-    jk_->compute();
-    std::shared_ptr<Matrix> K_AS = K[0];
-
-    // => Accumulation <= //
-
-    double Exch10_2 = 0.0;
-    std::vector<double> Exch10_2_terms;
-    Exch10_2_terms.resize(3);
-    Exch10_2_terms[0] -= 2.0 * linalg::triplet(linalg::triplet(D_A, S, D_B), S, P_A)->vector_dot(V_B);
-    Exch10_2_terms[0] -= 4.0 * linalg::triplet(linalg::triplet(D_A, S, D_B), S, P_A)->vector_dot(J_B);
-    Exch10_2_terms[1] -= 2.0 * linalg::triplet(linalg::triplet(D_B, S, D_A), S, P_B)->vector_dot(V_A);
-    Exch10_2_terms[1] -= 4.0 * linalg::triplet(linalg::triplet(D_B, S, D_A), S, P_B)->vector_dot(J_A);
-    Exch10_2_terms[2] -= 2.0 * linalg::triplet(P_A, S, D_B)->vector_dot(K_AS);
-    for (int k = 0; k < Exch10_2_terms.size(); k++) {
-        Exch10_2 += Exch10_2_terms[k];
-    }
-    // for (int k = 0; k < Exch10_2_terms.size(); k++) {
-    //    outfile->Printf("    Exch10(S^2) (%1d)     = %18.12lf [Eh]\n",k+1,Exch10_2_terms[k]);
-    //}
-    scalars_["Exch10(S^2)"] = Exch10_2;
-    // outfile->Printf("    Exch10(S^2) [DCBS]  = %18.12lf [Eh]\n",Exch10_2);
-    outfile->Printf("    Exch10(S^2)         = %18.12lf [Eh]\n", Exch10_2);
-    // fflush(outfile);
-
-    // ==> Exchange Terms (S^\infty, MCBS or DCBS) <== //
 
-    // => T Matrix <= //
+    // => T Matrix (S^\infty, MCBS or DCBS) <= //
 
     int na = matrices_["Cocc0A"]->colspi()[0];
     int nb = matrices_["Cocc0B"]->colspi()[0];
@@ -1522,10 +1460,20 @@ void FISAPT::exch() {
     C_DGEMM('N', 'N', nbf, na, nb, 1.0, matrices_["Cocc0B"]->pointer()[0], nb, &Tp[na][0], na + nb, 0.0,
             C_T_AB_n->pointer()[0], na);
 
-    // => K Terms <= //
+    // => J/K Builds <= //
 
+    std::vector<SharedMatrix>& Cl = jk_->C_left();
+    std::vector<SharedMatrix>& Cr = jk_->C_right();
+    const std::vector<SharedMatrix>& J = jk_->J();
+    const std::vector<SharedMatrix>& K = jk_->K();
     Cl.clear();
     Cr.clear();
+    // K_O
+    Cl.push_back(Cocc_A);
+    Cr.push_back(C_O);
+    // K_AS
+    Cl.push_back(Cocc_A);
+    Cr.push_back(C_AS);
     // J/K[T^A, S^\infty]
     Cl.push_back(matrices_["Cocc0A"]);
     Cr.push_back(C_T_A_n);
@@ -1535,10 +1483,72 @@ void FISAPT::exch() {
 
     jk_->compute();
 
-    std::shared_ptr<Matrix> J_T_A_n = J[0];
-    std::shared_ptr<Matrix> K_T_A_n = K[0];
-    std::shared_ptr<Matrix> J_T_AB_n = J[1];
-    std::shared_ptr<Matrix> K_T_AB_n = K[1];
+    std::shared_ptr<Matrix> K_O = K[0];
+    std::shared_ptr<Matrix> K_AS = K[1];
+    std::shared_ptr<Matrix> J_T_A_n = J[2];
+    std::shared_ptr<Matrix> K_T_A_n = K[2];
+    std::shared_ptr<Matrix> J_T_AB_n = J[3];
+    std::shared_ptr<Matrix> K_T_AB_n = K[3];
+
+    // => Density Products <= //
+
+    std::shared_ptr<Matrix> D_ASD_B = linalg::triplet(D_A, S, D_B);
+    std::shared_ptr<Matrix> D_BSD_A = linalg::triplet(D_B, S, D_A);
+
+    // ==> Exchange Terms (S^2, MCBS or DCBS) <== //
+
+    double Exch10_2M = 0.0;
+    std::vector<double> Exch10_2M_terms;
+    Exch10_2M_terms.resize(6);
+    Exch10_2M_terms[0] -= 2.0 * D_A->vector_dot(K_B);
+    Exch10_2M_terms[1] -= 2.0 * D_ASD_B->vector_dot(V_A);
+    Exch10_2M_terms[1] -= 4.0 * D_ASD_B->vector_dot(J_A);
+    Exch10_2M_terms[1] += 2.0 * D_ASD_B->vector_dot(K_A);
+    Exch10_2M_terms[2] -= 2.0 * D_BSD_A->vector_dot(V_B);
+    Exch10_2M_terms[2] -= 4.0 * D_BSD_A->vector_dot(J_B);
+    Exch10_2M_terms[2] += 2.0 * D_BSD_A->vector_dot(K_B);
+    std::shared_ptr<Matrix> D_BSD_ASD_B = linalg::triplet(D_BSD_A, S, D_B);
+    Exch10_2M_terms[3] += 2.0 * D_BSD_ASD_B->vector_dot(V_A);
+    Exch10_2M_terms[3] += 4.0 * D_BSD_ASD_B->vector_dot(J_A);
+    std::shared_ptr<Matrix> D_ASD_BSD_A = linalg::triplet(D_ASD_B, S, D_A);
+    Exch10_2M_terms[4] += 2.0 * D_ASD_BSD_A->vector_dot(V_B);
+    Exch10_2M_terms[4] += 4.0 * D_ASD_BSD_A->vector_dot(J_B);
+    Exch10_2M_terms[5] -= 2.0 * D_ASD_B->vector_dot(K_O);
+    for (int k = 0; k < Exch10_2M_terms.size(); k++) {
+        Exch10_2M += Exch10_2M_terms[k];
+    }
+    // for (int k = 0; k < Exch10_2M_terms.size(); k++) {
+    //    outfile->Printf("    Exch10(S^2) (%1d)     = %18.12lf [Eh]\n",k+1,Exch10_2M_terms[k]);
+    //}
+    // scalars_["Exch10(S^2)"] = Exch10_2;
+    // outfile->Printf("    Exch10(S^2) [MCBS]  = %18.12lf [Eh]\n",Exch10_2M);
+    // outfile->Printf("    Exch10(S^2)         = %18.12lf [Eh]\n",Exch10_2M);
+    // fflush(outfile);
+
+    // ==> Exchange Terms (S^2, DCBS only) <== //
+
+    double Exch10_2 = 0.0;
+    std::vector<double> Exch10_2_terms;
+    Exch10_2_terms.resize(3);
+    std::shared_ptr<Matrix> D_ASD_BSP_A = linalg::triplet(D_ASD_B, S, P_A);
+    Exch10_2_terms[0] -= 2.0 * D_ASD_BSP_A->vector_dot(V_B);
+    Exch10_2_terms[0] -= 4.0 * D_ASD_BSP_A->vector_dot(J_B);
+    std::shared_ptr<Matrix> D_BSD_ASP_B = linalg::triplet(D_BSD_A, S, P_B);
+    Exch10_2_terms[1] -= 2.0 * D_BSD_ASP_B->vector_dot(V_A);
+    Exch10_2_terms[1] -= 4.0 * D_BSD_ASP_B->vector_dot(J_A);
+    Exch10_2_terms[2] -= 2.0 * linalg::triplet(P_A, S, D_B)->vector_dot(K_AS);
+    for (int k = 0; k < Exch10_2_terms.size(); k++) {
+        Exch10_2 += Exch10_2_terms[k];
+    }
+    // for (int k = 0; k < Exch10_2_terms.size(); k++) {
+    //    outfile->Printf("    Exch10(S^2) (%1d)     = %18.12lf [Eh]\n",k+1,Exch10_2_terms[k]);
+    //}
+    scalars_["Exch10(S^2)"] = Exch10_2;
+    // outfile->Printf("    Exch10(S^2) [DCBS]  = %18.12lf [Eh]\n",Exch10_2);
+    outfile->Printf("    Exch10(S^2)         = %18.12lf [Eh]\n", Exch10_2);
+    // fflush(outfile);
+
+    // ==> Exchange Terms (S^\infty, MCBS or DCBS) <== //
 
     std::shared_ptr<Matrix> T_A_n = linalg::doublet(matrices_["Cocc0A"], C_T_A_n, false, true);
     std::shared_ptr<Matrix> T_B_n = linalg::doublet(matrices_["Cocc0B"], C_T_B_n, false, true);
@@ -3329,16 +3339,19 @@ void FISAPT::felst() {
     dfh_->transform();
 
     size_t nQ = dfh_->get_naux();
+    // gather the diagonal (aa|Q) and (bb|Q) rows straight from views of the tensors
     auto QaC = std::make_shared<Matrix>("QaC", na, nQ);
     double** QaCp = QaC->pointer();
+    auto Aaa = dfh_->view_tensor("Aaa");
     for (size_t a = 0; a < na; a++) {
-        dfh_->fill_tensor("Aaa", QaCp[a], {a, a + 1}, {a, a + 1});
+        std::copy_n(Aaa.row(a, a), nQ, QaCp[a]);
     }
 
     auto QbC = std::make_shared<Matrix>("QbC", nb, nQ);
     double** QbCp = QbC->pointer();
+    auto Abb = dfh_->view_tensor("Abb");
     for (size_t b = 0; b < nb; b++) {
-        dfh_->fill_tensor("Abb", QbCp[b], {b, b + 1}, {b, b + 1});
+        std::copy_n(Abb.row(b, b), nQ, QbCp[b]);
     }
 
     std::shared_ptr<Matrix> Elst10_3 = linalg::doublet(QaC, QbC, false, true);
@@ -3356,26 +3369,41 @@ void FISAPT::felst() {
 
     // => Nuclear Part (PITA) <= //
     auto Vfact2 = std::make_shared<IntegralFactory>(primary_);
-    std::shared_ptr<PotentialInt> Vint2(static_cast<PotentialInt*>(Vfact2->ao_potential()));
-    auto Vtemp2 = std::make_shared<Matrix>("Vtemp2", nn, nn);
+    std::vector<std::shared_ptr<PotentialInt> > Vint2;
+    std::vector<std::shared_ptr<Matrix> > Vtemp2;
+    for (int t = 0; t < nT; t++) {
+        Vint2.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(Vfact2->ao_potential())));
+        Vtemp2.push_back(std::make_shared<Matrix>("Vtemp2", nn, nn));
+    }
 
+    // Only the diagonal of Locc^T V Locc is needed, and each atom owns its own row/column of Ep
+    std::shared_ptr<Matrix> Locc0A = matrices_["Locc0A"];
+    std::shared_ptr<Matrix> Locc0B = matrices_["Locc0B"];
+    double** LAp = Locc0A->pointer();
+    double** LBp = Locc0B->pointer();
 
     // => A <-> b <= //
 
+    double Elst10_Ab = 0.0;
+#pragma omp parallel for schedule(dynamic) num_threads(nT) reduction(+ : Elst10_Ab)
     for (int A = 0; A < nA; A++) {
         if (ZAp[A] == 0.0) continue;
-        Vtemp2->zero();
-        Vint2->set_charge_field({{ZAp[A], {mol->x(A), mol->y(A), mol->z(A)}}});
-        Vint2->compute(Vtemp2);
-        std::shared_ptr<Matrix> Vbb =
-            linalg::triplet(matrices_["Locc0B"], Vtemp2, matrices_["Locc0B"], true, false, false);
-        double** Vbbp = Vbb->pointer();
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        Vtemp2[thread]->zero();
+        Vint2[thread]->set_charge_field({{ZAp[A], {mol->x(A), mol->y(A), mol->z(A)}}});
+        Vint2[thread]->compute(Vtemp2[thread]);
+        std::shared_ptr<Matrix> VLb = linalg::doublet(Vtemp2[thread], Locc0B);
+        double** VLbp = VLb->pointer();
         for (int b = 0; b < nb; b++) {
-            double E = 2.0 * Vbbp[b][b];
-            Elst10_terms[1] += E;
+            double E = 2.0 * C_DDOT(nn, &LBp[0][b], nb, &VLbp[0][b], nb);
+            Elst10_Ab += E;
             Ep[A][b + nB] += E;
         }
     }
+    Elst10_terms[1] += Elst10_Ab;
 
     // Add Extern-A - Orbital b interaction
     if (reference_->has_potential_variable("A")) {
@@ -3391,20 +3419,26 @@ void FISAPT::felst() {
 
     // => a <-> B <= //
 
+    double Elst10_aB = 0.0;
+#pragma omp parallel for schedule(dynamic) num_threads(nT) reduction(+ : Elst10_aB)
     for (int B = 0; B < nB; B++) {
         if (ZBp[B] == 0.0) continue;
-        Vtemp2->zero();
-        Vint2->set_charge_field({{ZBp[B], {mol->x(B), mol->y(B), mol->z(B)}}});
-        Vint2->compute(Vtemp2);
-        std::shared_ptr<Matrix> Vaa =
-            linalg::triplet(matrices_["Locc0A"], Vtemp2, matrices_["Locc0A"], true, false, false);
-        double** Vaap = Vaa->pointer();
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        Vtemp2[thread]->zero();
+        Vint2[thread]->set_charge_field({{ZBp[B], {mol->x(B), mol->y(B), mol->z(B)}}});
+        Vint2[thread]->compute(Vtemp2[thread]);
+        std::shared_ptr<Matrix> VLa = linalg::doublet(Vtemp2[thread], Locc0A);
+        double** VLap = VLa->pointer();
         for (int a = 0; a < na; a++) {
-            double E = 2.0 * Vaap[a][a];
-            Elst10_terms[0] += E;
+            double E = 2.0 * C_DDOT(nn, &LAp[0][a], na, &VLap[0][a], na);
+            Elst10_aB += E;
             Ep[a + nA][B] += E;
         }
     }
+    Elst10_terms[0] += Elst10_aB;
 
     // Add Extern-B - Orbital a interaction
     if (reference_->has_potential_variable("B")) {
@@ -3594,11 +3628,12 @@ void FISAPT::fexch() {
     auto E_exch3 = std::make_shared<Matrix>("E_exch [a <x-x> b]", na, nb);
     double** E_exch3p = E_exch3->pointer();
 
+    // (ba|Q) is read one Q row at a time, so view it in place rather than copying each row
+    auto Bba = dfh_->view_tensor("Bba");
     for (size_t a = 0; a < na; a++) {
         dfh_->fill_tensor("Bab", TbQ, {a, a + 1});
         for (size_t b = 0; b < nb; b++) {
-            dfh_->fill_tensor("Bba", TaQ, {b, b + 1}, {a, a + 1});
-            E_exch3p[a][b] -= 2.0 * C_DDOT(nQ, TbQp[b], 1, TaQp[0], 1);
+            E_exch3p[a][b] -= 2.0 * C_DDOT(nQ, TbQp[b], 1, Bba.row(b, a), 1);
         }
     }
 
@@ -3697,27 +3732,58 @@ void FISAPT::find() {
 
     // => Nuclear Part (PITA) <= //
 
+    // The per-atom potentials are built nT atoms at a time, one per thread, and written in order.
+    // Ghost atoms carry no charge, so their (zero) slices skip the integrals.
+
     auto Vfact2 = std::make_shared<IntegralFactory>(primary_);
-    std::shared_ptr<PotentialInt> Vint2(static_cast<PotentialInt*>(Vfact2->ao_potential()));
-    auto Vtemp2 = std::make_shared<Matrix>("Vtemp2", nn, nn);
+    std::vector<std::shared_ptr<PotentialInt> > Vint2;
+    std::vector<std::shared_ptr<Matrix> > Vtemp2;
+    for (int t = 0; t < nT; t++) {
+        Vint2.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(Vfact2->ao_potential())));
+        Vtemp2.push_back(std::make_shared<Matrix>("Vtemp2", nn, nn));
+    }
+    std::vector<std::shared_ptr<Matrix> > Wslices(nT);
 
     double* ZAp = vectors_["ZA"]->pointer();
-    for (size_t A = 0; A < nA; A++) {
-        Vtemp2->zero();
-        Vint2->set_charge_field({{ZAp[A], {mol->x(A), mol->y(A), mol->z(A)}}});
-        Vint2->compute(Vtemp2);
-        std::shared_ptr<Matrix> Vbs = linalg::triplet(Cocc_B, Vtemp2, Cvir_B, true, false, false);
-        dfh_->write_disk_tensor("WAbs", Vbs, {A, A + 1});
+    for (size_t Astart = 0; Astart < nA; Astart += nT) {
+        size_t nAblock = std::min((size_t)nT, nA - Astart);
+#pragma omp parallel for num_threads(nT)
+        for (size_t t = 0; t < nAblock; t++) {
+            size_t A = Astart + t;
+            if (ZAp[A] == 0.0) {
+                Wslices[t] = std::make_shared<Matrix>("Vbs", Cocc_B->colspi()[0], ns);
+                continue;
+            }
+            Vtemp2[t]->zero();
+            Vint2[t]->set_charge_field({{ZAp[A], {mol->x(A), mol->y(A), mol->z(A)}}});
+            Vint2[t]->compute(Vtemp2[t]);
+            Wslices[t] = linalg::triplet(Cocc_B, Vtemp2[t], Cvir_B, true, false, false);
+        }
+        for (size_t t = 0; t < nAblock; t++) {
+            dfh_->write_disk_tensor("WAbs", Wslices[t], {Astart + t, Astart + t + 1});
+        }
     }
 
     double* ZBp = vectors_["ZB"]->pointer();
-    for (size_t B = 0; B < nB; B++) {
-        Vtemp2->zero();
-        Vint2->set_charge_field({{ZBp[B], {mol->x(B), mol->y(B), mol->z(B)}}});
-        Vint2->compute(Vtemp2);
-        std::shared_ptr<Matrix> Var = linalg::triplet(Cocc_A, Vtemp2, Cvir_A, true, false, false);
-        dfh_->write_disk_tensor("WBar", Var, {B, B + 1});
+    for (size_t Bstart = 0; Bstart < nB; Bstart += nT) {
+        size_t nBblock = std::min((size_t)nT, nB - Bstart);
+#pragma omp parallel for num_threads(nT)
+        for (size_t t = 0; t < nBblock; t++) {
+            size_t B = Bstart + t;
+            if (ZBp[B] == 0.0) {
+                Wslices[t] = std::make_shared<Matrix>("Var", Cocc_A->colspi()[0], nr);
+                continue;
+            }
+            Vtemp2[t]->zero();
+            Vint2[t]->set_charge_field({{ZBp[B], {mol->x(B), mol->y(B), mol->z(B)}}});
+            Vint2[t]->compute(Vtemp2[t]);
+            Wslices[t] = linalg::triplet(Cocc_A, Vtemp2[t], Cvir_A, true, false, false);
+        }
+        for (size_t t = 0; t < nBblock; t++) {
+            dfh_->write_disk_tensor("WBar", Wslices[t], {Bstart + t, Bstart + t + 1});
+        }
     }
+    Wslices.clear();
 
     // ==> DFHelper Setup (JKFIT Type, in Full Basis) <== //
 
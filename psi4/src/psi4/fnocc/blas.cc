@@ -56,6 +56,13 @@ void PSI_API F_DGEMM(char transa, char transb, integer m, integer n, integer k,
                      integer lda, doublereal* B, integer ldb, doublereal beta, doublereal* C, integer ldc) {
     DGEMM(transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 }
+/**
+ * fortran-ordered sgemm
+ */
+void PSI_API F_SGEMM(char transa, char transb, integer m, integer n, integer k, float alpha, float* A, integer lda,
+                     float* B, integer ldb, float beta, float* C, integer ldc) {
+    SGEMM(transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
 
 /**
  *  Diagonalize a real symmetric matrix
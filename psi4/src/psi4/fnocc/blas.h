@@ -53,6 +53,12 @@ void PSI_API F_DGEMV(char trans, integer m, integer n, doublereal alpha, doubler
 void PSI_API F_DGEMM(char transa, char transb, integer m, integer n, integer k, doublereal alpha, doublereal *A,
                      integer lda, doublereal *B, integer ldb, doublereal beta, doublereal *C, integer ldc);
 
+/**
+ * fortran-ordered sgemm
+ */
+void PSI_API F_SGEMM(char transa, char transb, integer m, integer n, integer k, float alpha, float *A, integer lda,
+                     float *B, integer ldb, float beta, float *C, integer ldc);
+
 /**
  * name mangling for fortran-ordered dgemv
  */
@@ -75,6 +81,17 @@ inline void DGEMM(char &transa, char &transb, integer &m, integer &n, integer &k
                   integer &lda, doublereal *B, integer &ldb, doublereal &beta, doublereal *C, integer &ldc) {
     dgemm(transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 };
+/**
+ * name mangling for fortran-ordered sgemm
+ */
+extern "C" {
+void sgemm(char &transa, char &transb, integer &m, integer &n, integer &k, float &alpha, float *A, integer &lda,
+           float *B, integer &ldb, float &beta, float *C, integer &ldc);
+};
+inline void SGEMM(char &transa, char &transb, integer &m, integer &n, integer &k, float &alpha, float *A,
+                  integer &lda, float *B, integer &ldb, float &beta, float *C, integer &ldc) {
+    sgemm(transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+};
 /**
  * name mangling dcopy
  */
@@ -41,6 +41,7 @@
 #include "FCMangle.h"
 #define dgemv FC_GLOBAL(dgemv, DGEMV)
 #define dgemm FC_GLOBAL(dgemm, DGEMM)
+#define sgemm FC_GLOBAL(sgemm, SGEMM)
 #define dcopy FC_GLOBAL(dcopy, DCOPY)
 #define daxpy FC_GLOBAL(daxpy, DAXPY)
 #define dnrm2 FC_GLOBAL(drnm2, DRNM2)
@@ -53,6 +54,7 @@
 #if FC_SYMBOL == 2
 #define dgemv dgemv_
 #define dgemm dgemm_
+#define sgemm sgemm_
 #define dcopy dcopy_
 #define daxpy daxpy_
 #define dnrm2 drnm2_
@@ -64,6 +66,7 @@
 #elif FC_SYMBOL == 1
 #define dgemv dgemv
 #define dgemm dgemm
+#define sgemm sgemm
 #define dcopy dcopy
 #define daxpy daxpy
 #define dnrm2 drnm2
@@ -75,6 +78,7 @@
 #elif FC_SYMBOL == 3
 #define dgemv DGEMV
 #define dgemm DGEMM
+#define sgemm SGEMM
 #define dcopy DCOPY
 #define daxpy DAXPY
 #define dnrm2 DRNM2
@@ -86,6 +90,7 @@
 #elif FC_SYMBOL == 4
 #define dgemv DGEMV_
 #define dgemm DGEMM_
+#define sgemm SGEMM_
 #define dcopy DCOPY_
 #define daxpy DAXPY_
 #define dnrm2 DRNM2_
@@ -246,6 +246,12 @@ class PSI_API DFCoupledCluster : public CoupledCluster {
 
     /// v^4 CC diagram
     virtual void Vabcd1();
+    /// v^4 CC diagram with single-precision integrals and amplitudes
+    void Vabcd1SinglePrecision();
+
+    /// use Vabcd1SinglePrecision() until |d(T)| drops below the threshold
+    bool single_precision_;
+    double single_precision_threshold_;
 
     /// workspace buffers.
     double *Abij, *Sbij;
@@ -26,7 +26,9 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <ctime>
+#include <vector>
 #ifdef _OPENMP
 #include <omp.h>
 #else
@@ -57,6 +59,8 @@ void DefineQuadraticTasks();
 
 // coupled cluster constructor
 DFCoupledCluster::DFCoupledCluster(SharedWavefunction ref_wfn, Options &options) : CoupledCluster(ref_wfn, options) {
+    single_precision_ = false;
+    single_precision_threshold_ = 0.0;
     common_init();
 }
 
@@ -311,10 +315,24 @@ PsiReturnType DFCoupledCluster::CCSDIterations() {
     T1Fock();
     T1Integrals();
 
+    // early iterations may use single-precision v^4 contractions
+    single_precision_threshold_ = options_.get_double("SINGLE_PRECISION_THRESHOLD");
+    single_precision_ = single_precision_threshold_ > 0.0;
+
     outfile->Printf("\n");
+    if (single_precision_) {
+        outfile->Printf("  Single-precision (ac|bd) contractions until |d(T)| < %5.3le\n", single_precision_threshold_);
+        outfile->Printf("\n");
+    }
     outfile->Printf("  Begin singles and doubles coupled cluster iterations\n\n");
     outfile->Printf("   Iter  DIIS          Energy       d(Energy)          |d(T)|     time\n");
 
+    // single precision is also given up if |d(T)| stops decreasing: float round-off
+    // in the ladder term can leave it above the threshold for good
+    double sp_best_nrm = 1.0e99;
+    int sp_stalled = 0;
+    const int sp_max_stalled = 3;
+
     memset((void *)diisvec, '\0', (maxdiis + 1) * sizeof(double));
     // => Perform CCSD iterations <= //
     while (iter < maxiter) {
@@ -388,8 +406,27 @@ PsiReturnType DFCoupledCluster::CCSDIterations() {
             SCS_MP2();
         }
 
+        // switch to double precision once the residual is small.  an
+        // iteration done in single precision never counts as converged.
+        bool converged = std::fabs(eccsd - Eold) < e_conv && nrm < r_conv;
+        if (single_precision_ && iter > 1) {
+            if (nrm < 0.9 * sp_best_nrm)
+                sp_stalled = 0;
+            else
+                sp_stalled++;
+            sp_best_nrm = std::min(sp_best_nrm, nrm);
+        }
+        if (single_precision_ && (converged || nrm < single_precision_threshold_ || sp_stalled >= sp_max_stalled)) {
+            single_precision_ = false;
+            if (sp_stalled >= sp_max_stalled)
+                outfile->Printf("        |d(T)| stagnated; switching to double-precision (ac|bd) contractions.\n");
+            else
+                outfile->Printf("        Switching to double-precision (ac|bd) contractions.\n");
+            continue;
+        }
+
         // energy and amplitude convergence check
-        if (std::fabs(eccsd - Eold) < e_conv && nrm < r_conv) break;
+        if (converged) break;
     }
 
     times(&total_tmstime);
@@ -800,6 +837,11 @@ void DFCoupledCluster::Vabcd1() {
     long int otri = o * (o + 1) / 2;
     long int vtri = v * (v + 1) / 2;
 
+    if (single_precision_) {
+        Vabcd1SinglePrecision();
+        return;
+    }
+
     auto psio = std::make_shared<PSIO>();
 
     if (t2_on_disk) {
@@ -828,33 +870,164 @@ void DFCoupledCluster::Vabcd1() {
     psio->open(PSIF_DCC_R2, PSIO_OPEN_OLD);
     psio->read_entry(PSIF_DCC_R2, "residual", (char *)&tempv[0], o * o * v * v * sizeof(double));
 
-    int nthreads = Process::environment.get_n_threads();
+    // the (a,b>=a) pairs are processed in blocks of at most npair, so the tail of the a loop (few b per a)
+    // still gives wide DGEMMs.  per pair: (ac|bd) v^2, V+ and V- vtri each, in integrals (at least 2v^3);
+    // Abij and Sbij hold v pairs.
+    long int npair = nQ * v * v > 2L * v * v * v ? nQ * v * v : 2L * v * v * v;
+    npair = npair / (v * v + 2 * vtri);
+    if (npair > v) npair = v;
+    if (npair < 1) npair = 1;
+
+    // qvv transpose
+#pragma omp parallel for schedule(static)
+    for (int q = 0; q < nQ; q++) {
+        C_DCOPY(v * v, Qvv + q * v * v, 1, integrals + q, nQ);
+    }
+    C_DCOPY(nQ * v * v, integrals, 1, Qvv, 1);
 
     double *Vcdb = integrals;
-    double *Vm = integrals + v * v * v;
-    double *Vp = Vm;
+    double *Vp = Vcdb + npair * v * v;
+    double *Vm = Vp + npair * vtri;
+
+    std::vector<long int> pa(npair), pb(npair);
+    long int a0 = 0;
+    long int b0 = 0;
+    while (a0 < v) {
+        // next block of pairs
+        long int np = 0;
+        while (np < npair && a0 < v) {
+            long int nb = std::min(v - b0, npair - np);
+            F_DGEMM('t', 'n', v, v * nb, nQ, 1.0, Qvv + a0 * v * nQ, nQ, Qvv + b0 * v * nQ, nQ, 0.0,
+                    Vcdb + np * v * v, v);
+            for (long int b = b0; b < b0 + nb; b++, np++) {
+                pa[np] = a0;
+                pb[np] = b;
+            }
+            b0 += nb;
+            if (b0 == v) {
+                a0++;
+                b0 = a0;
+            }
+        }
 
-// qvv transpose
+        // V+ and V- in one pass over (ac|bd)
+#pragma omp parallel for schedule(static)
+        for (long int p = 0; p < np; p++) {
+            double *Vcd = Vcdb + p * v * v;
+            double *Vpp = Vp + p * vtri;
+            double *Vmp = Vm + p * vtri;
+            long int cd = 0;
+            for (long int c = 0; c < v; c++) {
+                for (long int d = 0; d <= c; d++) {
+                    Vpp[cd] = Vcd[d * v + c] + Vcd[c * v + d];
+                    Vmp[cd] = Vcd[d * v + c] - Vcd[c * v + d];
+                    cd++;
+                }
+            }
+        }
+
+        F_DGEMM('n', 'n', otri, np, vtri, 0.5, tempt, otri, Vp, vtri, 0.0, Abij, otri);
+        F_DGEMM('n', 'n', otri, np, vtri, 0.5, tempt + otri * vtri, otri, Vm, vtri, 0.0, Sbij, otri);
+
+        // contribute to residual
+#pragma omp parallel for schedule(static)
+        for (long int p = 0; p < np; p++) {
+            long int a = pa[p];
+            long int b = pb[p];
+            for (long int i = 0; i < o; i++) {
+                for (long int j = 0; j < o; j++) {
+                    int sg = (i > j) ? 1 : -1;
+                    tempv[a * oo * v + b * oo + i * o + j] +=
+                        Abij[p * otri + Position(i, j)] + sg * Sbij[p * otri + Position(i, j)];
+                    if (a != b) {
+                        tempv[b * oov + a * oo + i * o + j] +=
+                            Abij[p * otri + Position(i, j)] - sg * Sbij[p * otri + Position(i, j)];
+                    }
+                }
+            }
+        }
+    }
+
+    // contribute to residual
+    psio->write_entry(PSIF_DCC_R2, "residual", (char *)&tempv[0], o * o * v * v * sizeof(double));
+    psio->close(PSIF_DCC_R2, 1);
+
+// qvv un-transpose
 #pragma omp parallel for schedule(static)
     for (int q = 0; q < nQ; q++) {
-        C_DCOPY(v * v, Qvv + q * v * v, 1, integrals + q, nQ);
+        C_DCOPY(v * v, Qvv + q, nQ, integrals + q * v * v, 1);
     }
     C_DCOPY(nQ * v * v, integrals, 1, Qvv, 1);
+}
+
+/**
+ *  Vabcd1 with the (Q|ab) integrals, the packed amplitudes, and the
+ *  intermediates in single precision.  The float buffers overlay the
+ *  existing double workspace (integrals, tempt, Abij, Sbij), so no extra
+ *  memory is needed; only the accumulation into the residual is done in
+ *  double precision.
+ */
+void DFCoupledCluster::Vabcd1SinglePrecision() {
+    long int o = ndoccact;
+    long int v = nvirt;
+    long int oov = o * o * v;
+    long int oo = o * o;
+    long int otri = o * (o + 1) / 2;
+    long int vtri = v * (v + 1) / 2;
+
+    auto psio = std::make_shared<PSIO>();
+
+    if (t2_on_disk) {
+        psio->open(PSIF_DCC_T2, PSIO_OPEN_OLD);
+        psio->read_entry(PSIF_DCC_T2, "t2", (char *)&tempv[0], o * o * v * v * sizeof(double));
+        psio->close(PSIF_DCC_T2, 1);
+        tb = tempv;
+    }
+
+    float *tempt_sp = (float *)tempt;
+#pragma omp parallel for schedule(static)
+    for (long int i = 0; i < o; i++) {
+        for (long int j = i; j < o; j++) {
+            long int ij = Position(i, j);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = a; b < v; b++) {
+                    tempt_sp[Position(a, b) * otri + ij] =
+                        (float)(tb[a * oov + b * oo + i * o + j] + tb[b * oov + a * oo + i * o + j]);
+                    tempt_sp[Position(a, b) * otri + ij + vtri * otri] =
+                        (float)(tb[a * oov + b * oo + i * o + j] - tb[b * oov + a * oo + i * o + j]);
+                }
+                tempt_sp[Position(a, a) * otri + ij] = (float)tb[a * oov + a * oo + i * o + j];
+            }
+        }
+    }
+
+    psio->open(PSIF_DCC_R2, PSIO_OPEN_OLD);
+    psio->read_entry(PSIF_DCC_R2, "residual", (char *)&tempv[0], o * o * v * v * sizeof(double));
+
+    // transposed qvv, Vcdb, and Vp/Vm: nQv^2 + 2v^3 floats fit in integrals
+    float *Qvv_sp = (float *)integrals;
+    float *Vcdb = Qvv_sp + nQ * v * v;
+    float *Vm = Vcdb + v * v * v;
+    float *Vp = Vm;
+    float *Abij_sp = (float *)Abij;
+    float *Sbij_sp = (float *)Sbij;
+
+#pragma omp parallel for schedule(static)
+    for (long int cd = 0; cd < v * v; cd++) {
+        for (long int q = 0; q < nQ; q++) {
+            Qvv_sp[cd * nQ + q] = (float)Qvv[q * v * v + cd];
+        }
+    }
 
-    double time1 = 0.0;
-    double time2 = 0.0;
-    double time3 = 0.0;
     for (long int a = 0; a < v; a++) {
-        double start1 = omp_get_wtime();
         int nb = v - a;
-        F_DGEMM('t', 'n', v, v * nb, nQ, 1.0, Qvv + a * v * nQ, nQ, Qvv + a * v * nQ, nQ, 0.0, Vcdb, v);
+        F_SGEMM('t', 'n', v, v * nb, nQ, 1.0f, Qvv_sp + a * v * nQ, nQ, Qvv_sp + a * v * nQ, nQ, 0.0f, Vcdb, v);
 
 #pragma omp parallel for schedule(static)
         for (long int b = a; b < v; b++) {
             long int cd = 0;
             long int ind1 = (b - a) * vtri;
             long int ind2 = (b - a) * v * v;
-            long int v1, v2;
             for (long int c = 0; c < v; c++) {
                 for (long int d = 0; d <= c; d++) {
                     Vp[ind1 + cd] = Vcdb[ind2 + d * v + c] + Vcdb[ind2 + c * v + d];
@@ -862,16 +1035,12 @@ void DFCoupledCluster::Vabcd1() {
                 }
             }
         }
-        double end1 = omp_get_wtime();
-
-        double start2 = omp_get_wtime();
-        F_DGEMM('n', 'n', otri, nb, vtri, 0.5, tempt, otri, Vp, vtri, 0.0, Abij, otri);
+        F_SGEMM('n', 'n', otri, nb, vtri, 0.5f, tempt_sp, otri, Vp, vtri, 0.0f, Abij_sp, otri);
 #pragma omp parallel for schedule(static)
         for (long int b = a; b < v; b++) {
             long int cd = 0;
             long int ind1 = (b - a) * vtri;
             long int ind2 = (b - a) * v * v;
-            long int v1, v2;
             for (long int c = 0; c < v; c++) {
                 for (long int d = 0; d <= c; d++) {
                     Vm[ind1 + cd] = Vcdb[ind2 + d * v + c] - Vcdb[ind2 + c * v + d];
@@ -879,42 +1048,27 @@ void DFCoupledCluster::Vabcd1() {
                 }
             }
         }
-        F_DGEMM('n', 'n', otri, nb, vtri, 0.5, tempt + otri * vtri, otri, Vm, vtri, 0.0, Sbij, otri);
-        double end2 = omp_get_wtime();
+        F_SGEMM('n', 'n', otri, nb, vtri, 0.5f, tempt_sp + otri * vtri, otri, Vm, vtri, 0.0f, Sbij_sp, otri);
 
         // contribute to residual
-        double start3 = omp_get_wtime();
 #pragma omp parallel for schedule(static)
         for (long int b = a; b < v; b++) {
             for (long int i = 0; i < o; i++) {
                 for (long int j = 0; j < o; j++) {
                     int sg = (i > j) ? 1 : -1;
-                    tempv[a * oo * v + b * oo + i * o + j] +=
-                        Abij[(b - a) * otri + Position(i, j)] + sg * Sbij[(b - a) * otri + Position(i, j)];
+                    double A = Abij_sp[(b - a) * otri + Position(i, j)];
+                    double S = Sbij_sp[(b - a) * otri + Position(i, j)];
+                    tempv[a * oo * v + b * oo + i * o + j] += A + sg * S;
                     if (a != b) {
-                        tempv[b * oov + a * oo + i * o + j] +=
-                            Abij[(b - a) * otri + Position(i, j)] - sg * Sbij[(b - a) * otri + Position(i, j)];
+                        tempv[b * oov + a * oo + i * o + j] += A - sg * S;
                     }
                 }
             }
         }
-        double end3 = omp_get_wtime();
-
-        time1 += end1 - start1;
-        time2 += end2 - start2;
-        time3 += end3 - start3;
     }
 
-    // contribute to residual
     psio->write_entry(PSIF_DCC_R2, "residual", (char *)&tempv[0], o * o * v * v * sizeof(double));
     psio->close(PSIF_DCC_R2, 1);
-
-// qvv un-transpose
-#pragma omp parallel for schedule(static)
-    for (int q = 0; q < nQ; q++) {
-        C_DCOPY(v * v, Qvv + q, nQ, integrals + q * v * v, 1);
-    }
-    C_DCOPY(nQ * v * v, integrals, 1, Qvv, 1);
 }
 }  // namespace fnocc
 }  // namespace psi
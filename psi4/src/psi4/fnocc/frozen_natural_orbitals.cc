@@ -557,6 +557,7 @@ void DFFrozenNO::ThreeIndexIntegrals() {
         psio->open(PSIF_DCC_QSO, PSIO_OPEN_OLD);
         psio->write_entry(PSIF_DCC_QSO, "Qso CC", (char*)&Qso[0][0], nQ * nso * nso * sizeof(double));
         psio->close(PSIF_DCC_QSO, 1);
+        if (options_.get_bool("NAT_ORBS")) Qso_cc_ = tmp;
         outfile->Printf("    Number of auxiliary functions:       %5li\n", nQ);
 
         // stick nQ in process environment so ccsd can know it
@@ -597,6 +598,7 @@ void DFFrozenNO::ThreeIndexIntegrals() {
             psio->open(PSIF_DCC_QSO, PSIO_OPEN_OLD);
             psio->write_entry(PSIF_DCC_QSO, "Qso CC", (char*)&Lp[0][0], nQ * nso * nso * sizeof(double));
             psio->close(PSIF_DCC_QSO, 1);
+            if (options_.get_bool("NAT_ORBS")) Qso_cc_ = L;
         } else {
             // generate Cholesky 3-index integrals
             outfile->Printf("        Generating Cholesky vectors ...\n");
@@ -612,6 +614,7 @@ void DFFrozenNO::ThreeIndexIntegrals() {
             psio->open(PSIF_DCC_QSO, PSIO_OPEN_OLD);
             psio->write_entry(PSIF_DCC_QSO, "Qso CC", (char*)&Lp[0][0], nQ * nso * nso * sizeof(double));
             psio->close(PSIF_DCC_QSO, 1);
+            if (options_.get_bool("NAT_ORBS")) Qso_cc_ = L;
             outfile->Printf("        Cholesky decomposition threshold: %8.2le\n", tol);
             outfile->Printf("        Number of Cholesky vectors:          %5li\n", nQ);
         }
@@ -708,17 +711,20 @@ void DFFrozenNO::ComputeNaturalOrbitals() {
 
     auto psio = std::make_shared<PSIO>();
 
-    // read in 3-index integrals specific to the CC method:
-    double* tmp2 = (double*)malloc(nso * nso * nQ * sizeof(double));
-    psio->open(PSIF_DCC_QSO, PSIO_OPEN_OLD);
-    psio->read_entry(PSIF_DCC_QSO, "Qso CC", (char*)&tmp2[0], nQ * nso * nso * sizeof(double));
-    psio->close(PSIF_DCC_QSO, 1);
-
-    // transform Qso -> Qov:
-    TransformQ(nQ, tmp2);
+    // transform Qso -> Qov.  the 3-index integrals specific to the CC method are still in
+    // memory when ThreeIndexIntegrals ran in this job; otherwise read them in
     double* Qov = (double*)malloc(o * v * nQ * sizeof(double));
-    C_DCOPY(o * v * nQ, tmp2, 1, Qov, 1);
-    free(tmp2);
+    if (Qso_cc_) {
+        TransformQ(nQ, Qso_cc_->pointer()[0], Qov);
+        Qso_cc_.reset();
+    } else {
+        double* tmp2 = (double*)malloc(nso * nso * nQ * sizeof(double));
+        psio->open(PSIF_DCC_QSO, PSIO_OPEN_OLD);
+        psio->read_entry(PSIF_DCC_QSO, "Qso CC", (char*)&tmp2[0], nQ * nso * nso * sizeof(double));
+        psio->close(PSIF_DCC_QSO, 1);
+        TransformQ(nQ, tmp2, Qov);
+        free(tmp2);
+    }
 
     if (memory < 8L * (o * o * v * v + o * v * nQ)) {
         throw PsiException("not enough memory (fno)", __FILE__, __LINE__);
@@ -966,34 +972,21 @@ void DFFrozenNO::ModifyCa_occ(double* Dij) {
     }
 }
 
-void DFFrozenNO::TransformQ(long int nQ, double* Qso) {
+void DFFrozenNO::TransformQ(long int nQ, const double* Qso, double* Qov) {
     long int o = ndoccact;
     long int v = nvirt;
+    long int nmo = Ca()->colspi()[0];
 
     double** Cap = Ca()->pointer();
     double* tmp = (double*)malloc(nso * o * nQ * sizeof(double));
 
-    for (int q = 0; q < nQ; q++) {
-        for (int mu = 0; mu < nso; mu++) {
-            for (int i = 0; i < o; i++) {
-                double dum = 0.0;
-                for (int nu = 0; nu < nso; nu++) {
-                    dum += Qso[q * nso * nso + mu * nso + nu] * Cap[nu][nfzc + i];
-                }
-                tmp[q * nso * o + i * nso + mu] = dum;
-            }
-        }
-    }
-    for (int q = 0; q < nQ; q++) {
-        for (int i = 0; i < o; i++) {
-            for (int a = 0; a < v; a++) {
-                double dum = 0.0;
-                for (int nu = 0; nu < nso; nu++) {
-                    dum += tmp[q * nso * o + i * nso + nu] * Cap[nu][nfzc + o + a];
-                }
-                Qso[q * v * o + i * v + a] = dum;
-            }
-        }
+    // tmp(q,mu,i) = sum_nu Qso(q,mu,nu) C(nu,i)
+    F_DGEMM('n', 'n', o, nQ * nso, nso, 1.0, &Cap[0][nfzc], nmo, (double*)Qso, nso, 0.0, tmp, o);
+
+    // Qov(q,i,a) = sum_mu tmp(q,mu,i) C(mu,a)
+#pragma omp parallel for schedule(static)
+    for (long int q = 0; q < nQ; q++) {
+        F_DGEMM('n', 't', v, o, nso, 1.0, &Cap[0][nfzc + o], nmo, tmp + q * nso * o, o, 0.0, Qov + q * o * v, v);
     }
 
     free(tmp);
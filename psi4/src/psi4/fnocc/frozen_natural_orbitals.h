@@ -71,7 +71,11 @@ class PSI_API DFFrozenNO : public FrozenNO {
     void ModifyCa(const std::vector<double>& Dab);
     void ModifyCa_occ(double* Dij);
     void BuildFock(long int nQ, double* Qso, double* F);
-    void TransformQ(long int nQ, double* Qso);
+    /// Qov(Q,i,a) from the AO integrals Qso(Q,mu,nu)
+    void TransformQ(long int nQ, const double* Qso, double* Qov);
+
+    /// the CC AO 3-index integrals, kept by ThreeIndexIntegrals for ComputeNaturalOrbitals
+    SharedMatrix Qso_cc_;
 };
 }
 }
@@ -38,6 +38,7 @@
 
 #include "blas.h"
 #include "ccsd.h"
+#include "triples_checkpoint.h"
 
 namespace psi {
 namespace fnocc {
@@ -233,6 +234,10 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
     outfile->Printf("        Number of abc combinations: %li\n", nabc);
     outfile->Printf("\n");
 
+    double ecorr = ccmethod <= 1 ? eccsd : emp2 + emp3 + emp4_sd + emp4_q;
+    TriplesCheckpoint ckpt(std::string("fnocc_") + name, options_.get_int("TRIPLES_CHECKPOINT"), nabc,
+                           {0.0, (double)o, (double)v, (double)nabc, escf, ecorr});
+
     for (int i = 0; i < nthreads; i++) etrip[i] = 0.0;
 
     outfile->Printf("        Computing (T) correction...\n");
@@ -252,6 +257,8 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
     if (threaded) {
 #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
         for (long int ind = 0; ind < nabc; ind++) {
+            if (ckpt.done(ind)) continue;
+
             long int a = abc[ind][0];
             long int b = abc[ind][1];
             long int c = abc[ind][2];
@@ -381,7 +388,7 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
                 }
                 tripval += dum;
             }
-            etrip[thread] += 3.0 * tripval * abcfac;
+            double eabc = 3.0 * tripval * abcfac;
 
             // Z3(ijk) = -2(Z(ijk) + jki + kij) + ikj + jik + kji
             for (long int i = 0; i < o; i++) {
@@ -421,7 +428,7 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
                 }
                 tripval += dum;
             }
-            etrip[thread] += tripval * abcfac;
+            eabc += tripval * abcfac;
 
             // the second bit
             for (long int i = 0; i < o; i++) {
@@ -461,7 +468,9 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
                 }
                 tripval += dum;
             }
-            etrip[thread] += tripval * abcfac;
+            eabc += tripval * abcfac;
+            etrip[thread] += eabc;
+            ckpt.finish(ind, eabc);
 
             // print out update
             if (thread == 0) {
@@ -522,8 +531,9 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
         mypsio[i]->close(PSIF_DCC_ABCI4, 1);
     }
 
-    double myet = 0.0;
+    double myet = ckpt.restored_energy();
     for (int i = 0; i < nthreads; i++) myet += etrip[i];
+    ckpt.remove();
 
     // ccsd(t) or qcisd(t)
     if (ccmethod <= 1) {
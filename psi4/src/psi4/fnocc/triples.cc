@@ -26,7 +26,10 @@
  * @END LICENSE
  */
 
+#include <algorithm>
+#include <array>
 #include <ctime>
+#include <vector>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -38,10 +41,298 @@
 
 #include "blas.h"
 #include "ccsd.h"
+#include "triples_checkpoint.h"
 
 namespace psi {
 namespace fnocc {
 
+/*
+ * The (T) energy contribution of one i >= j >= k triple, given the connected
+ * triples W(ijk)abc in Z.  Z2 and W are v^3 scratch space.
+ */
+static double triples_ijk_energy(long int i, long int j, long int k, long int o, long int v, double fac, double *t1,
+                                 double *E2klcd, double *F, double *Z, double *Z2, double *W) {
+    long int vo = v * o;
+    long int vv = v * v;
+    long int vvo = v * v * o;
+    long int vvv = v * v * v;
+    double energy = 0.0;
+
+    C_DCOPY(vvv, Z, 1, Z2, 1);
+    for (long int a = 0; a < v; a++) {
+        double tai = t1[a * o + i];
+        for (long int b = 0; b < v; b++) {
+            long int ab = 1 + (a == b);
+            double tbj = t1[b * o + j];
+            double E2iajb = E2klcd[i * vvo + a * vo + j * v + b];
+            for (long int c = 0; c < v; c++) {
+                Z2[a * vv + b * v + c] +=
+                    fac * (tai * E2klcd[j * vvo + b * vo + k * v + c] + tbj * E2klcd[i * vvo + a * vo + k * v + c] +
+                           t1[c * o + k] * E2iajb);
+                Z2[a * vv + b * v + c] /= (ab + (b == c) + (a == c));
+            }
+        }
+    }
+
+    for (long int a = 0; a < v; a++) {
+        for (long int b = 0; b < v; b++) {
+            for (long int c = 0; c < v; c++) {
+                long int abc = a * vv + b * v + c;
+                long int bac = b * vv + a * v + c;
+                long int acb = a * vv + c * v + b;
+                long int cba = c * vv + b * v + a;
+
+                W[abc] = Z2[acb] + Z2[bac] + Z2[cba];
+            }
+        }
+    }
+    double dijk = F[i] + F[j] + F[k];
+    long int ijkfac = (2 - ((i == j) + (j == k) + (i == k)));
+    // separate out these bits to save v^3 storage
+    double tripval = 0.0;
+    for (long int a = 0; a < v; a++) {
+        double dijka = dijk - F[a + o];
+        for (long int b = 0; b <= a; b++) {
+            double dijkab = dijka - F[b + o];
+            for (long int c = 0; c <= b; c++) {
+                long int abc = a * vv + b * v + c;
+                long int bca = b * vv + c * v + a;
+                long int cab = c * vv + a * v + b;
+                long int acb = a * vv + c * v + b;
+                long int bac = b * vv + a * v + c;
+                long int cba = c * vv + b * v + a;
+                double dum = Z[abc] * Z2[abc] + Z[acb] * Z2[acb] +
+                             Z[bac] * Z2[bac] + Z[bca] * Z2[bca] +
+                             Z[cab] * Z2[cab] + Z[cba] * Z2[cba];
+
+                dum = (W[abc]) * ((Z[abc] + Z[bca] + Z[cab]) * -2.0 +
+                                               (Z[acb] + Z[bac] + Z[cba])) +
+                      3.0 * dum;
+                double denom = dijkab - F[c + o];
+                tripval += dum / denom;
+            }
+        }
+    }
+    energy += tripval * ijkfac;
+    // the second bit
+    for (long int a = 0; a < v; a++) {
+        for (long int b = 0; b < v; b++) {
+            for (long int c = 0; c < v; c++) {
+                long int abc = a * vv + b * v + c;
+                long int bca = b * vv + c * v + a;
+                long int cab = c * vv + a * v + b;
+
+                W[abc] = Z2[abc] + Z2[bca] + Z2[cab];
+            }
+        }
+    }
+    tripval = 0.0;
+    for (long int a = 0; a < v; a++) {
+        double dijka = dijk - F[a + o];
+        for (long int b = 0; b <= a; b++) {
+            double dijkab = dijka - F[b + o];
+            for (long int c = 0; c <= b; c++) {
+                long int abc = a * vv + b * v + c;
+                long int bca = b * vv + c * v + a;
+                long int cab = c * vv + a * v + b;
+                long int acb = a * vv + c * v + b;
+                long int bac = b * vv + a * v + c;
+                long int cba = c * vv + b * v + a;
+
+                double dum = (W[abc]) * (Z[abc] + Z[bca] + Z[cab] +
+                                                      (Z[acb] + Z[bac] + Z[cba]) * -2.0);
+
+                double denom = dijkab - F[c + o];
+                tripval += dum / denom;
+            }
+        }
+    }
+    energy += tripval * ijkfac;
+
+    return energy;
+}
+
+/*
+ * Multiplies the E2abci block A into nblocks v x v amplitude blocks with one DGEMM,
+ * leaving block n of the result at C + n * v^3, exactly as one DGEMM per block would.
+ * pack holds nblocks * v^2 doubles.
+ */
+static void triples_gemm_blocks(long int v, double *A, double **blocks, long int nblocks, double *pack, double *C) {
+    long int vv = v * v;
+    long int ldb = nblocks * v;
+    for (long int n = 0; n < nblocks; n++) {
+        for (long int c = 0; c < v; c++) {
+            C_DCOPY(v, blocks[n] + c * v, 1, pack + n * v + c * ldb, 1);
+        }
+    }
+    F_DGEMM('t', 't', vv, ldb, v, 1.0, A, v, pack, ldb, 0.0, C, vv);
+}
+
+/*
+ * The (T) energy from batches of i >= j >= k triples sharing j and k.  Each batch reads
+ * E2abci for k and j once rather than once per triple, and contracts each of them with
+ * the amplitudes of the whole batch in a single DGEMM; the E2abci blocks for i and the
+ * E2ijak terms follow per triple.  Needs (4 nbatch + 5) v^3 + 2 nbatch v^2 doubles per thread.
+ * Batches already finished in ckpt are skipped.
+ */
+static double batched_triples(long int o, long int v, long int nbatch, int nthreads, double fac, double *t1,
+                              double *E2klcd, double *E2ijak, double *tempt, double *F, TriplesCheckpoint &ckpt) {
+    long int vo = v * o;
+    long int vv = v * v;
+    long int voo = v * o * o;
+    long int vvo = v * v * o;
+    long int vvv = v * v * v;
+
+    // (j, k, first i) of each batch, largest batches first
+    std::vector<std::array<long int, 3>> batches;
+    for (long int j = 0; j < o; j++) {
+        for (long int k = 0; k <= j; k++) {
+            for (long int i0 = j; i0 < o; i0 += nbatch) batches.push_back({j, k, i0});
+        }
+    }
+    std::stable_sort(batches.begin(), batches.end(),
+                     [&](const std::array<long int, 3> &x, const std::array<long int, 3> &y) {
+                         return std::min(nbatch, o - x[2]) > std::min(nbatch, o - y[2]);
+                     });
+
+    long int bufsize = (4L * nbatch + 5L) * vvv + 2L * nbatch * vv;
+    std::vector<std::vector<double>> buffers(nthreads, std::vector<double>(bufsize));
+    std::vector<double> etrip(nthreads, 0.0);
+
+    auto read_E2abci = [&](PSIO *mypsio, long int i, double *buffer) {
+        psio_address addr = psio_get_address(PSIO_ZERO, i * vvv * sizeof(double));
+        mypsio->read(PSIF_DCC_ABCI, "E2abci", (char *)buffer, vvv * sizeof(double), addr, &addr);
+    };
+
+    std::time_t start = std::time(nullptr);
+    long int nbatches = batches.size();
+    int pct = 0;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (long int ind = 0; ind < nbatches; ind++) {
+        if (ckpt.done(ind)) continue;
+
+        long int j = batches[ind][0];
+        long int k = batches[ind][1];
+        long int i0 = batches[ind][2];
+        long int nb = std::min(nbatch, o - i0);
+
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        double *Ek = buffers[thread].data();
+        double *Ej = Ek + vvv;
+        double *Ei = Ej + vvv;
+        double *Ci = Ei + vvv;
+        double *Ck = Ci + 2L * vvv;
+        double *Cj = Ck + 2L * nbatch * vvv;
+        double *pack = Cj + 2L * nbatch * vvv;
+        std::vector<double *> blocks(2L * nb);
+
+        auto mypsio = std::make_shared<PSIO>();
+        mypsio->open(PSIF_DCC_ABCI, PSIO_OPEN_OLD);
+
+        read_E2abci(mypsio.get(), k, Ek);
+        if (j == k)
+            Ej = Ek;
+        else
+            read_E2abci(mypsio.get(), j, Ej);
+
+        // E2abci(k) with t(ji) and t(ij), E2abci(j) with t(ki) and t(ik), for every i in the batch
+        for (long int n = 0; n < nb; n++) {
+            long int i = i0 + n;
+            blocks[2 * n] = tempt + j * vvo + i * vv;
+            blocks[2 * n + 1] = tempt + i * vvo + j * vv;
+        }
+        triples_gemm_blocks(v, Ek, blocks.data(), 2 * nb, pack, Ck);
+        for (long int n = 0; n < nb; n++) {
+            long int i = i0 + n;
+            blocks[2 * n] = tempt + k * vvo + i * vv;
+            blocks[2 * n + 1] = tempt + i * vvo + k * vv;
+        }
+        triples_gemm_blocks(v, Ej, blocks.data(), 2 * nb, pack, Cj);
+
+        double ebatch = 0.0;
+        for (long int n = 0; n < nb; n++) {
+            long int i = i0 + n;
+            double *E = Ei;
+            if (i == j)
+                E = Ej;
+            else if (i == k)
+                E = Ek;
+            else
+                read_E2abci(mypsio.get(), i, Ei);
+
+            // E2abci(i) with t(jk) and t(kj)
+            blocks[0] = tempt + j * vvo + k * vv;
+            blocks[1] = tempt + k * vvo + j * vv;
+            triples_gemm_blocks(v, E, blocks.data(), 2, pack, Ci);
+
+            double *Z = Ck + 2L * n * vvv;
+            double *Zij = Z + vvv;
+            double *Zjk = Cj + 2L * n * vvv;
+            double *Zikj = Zjk + vvv;
+            double *Zik = Ci;
+            double *Zijk = Ci + vvv;
+
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + j * voo + k * vo, v, tempt + i * vvo, vv, 1.0, Z, v);
+            //(ab)(ij)
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + i * voo + k * vo, v, tempt + j * vvo, vv, 1.0, Zij, v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Zij + b * vv + a * v, 1, Z + a * vv + b * v, 1);
+                }
+            }
+            //(bc)(jk)
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + k * voo + j * vo, v, tempt + i * vvo, vv, 1.0, Zjk, v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Zjk + a * vv + b, v, Z + a * vv + b * v, 1);
+                }
+            }
+            //(ikj)(acb)
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + i * voo + j * vo, v, tempt + k * vvo, vv, 1.0, Zikj, v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Zikj + a * v + b, vv, Z + a * vv + b * v, 1);
+                }
+            }
+            //(ac)(ik)
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + j * voo + i * vo, v, tempt + k * vvo, vv, 1.0, Zik, v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Zik + b * v + a, vv, Z + a * vv + b * v, 1);
+                }
+            }
+            //(ijk)(abc)
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + k * voo + i * vo, v, tempt + j * vvo, vv, 1.0, Zijk, v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Zijk + b * vv + a, v, Z + a * vv + b * v, 1);
+                }
+            }
+
+            ebatch += triples_ijk_energy(i, j, k, o, v, fac, t1, E2klcd, F, Z, Zij, Zjk);
+        }
+        mypsio->close(PSIF_DCC_ABCI, 1);
+        etrip[thread] += ebatch;
+        ckpt.finish(ind, ebatch);
+
+        // print out update
+        if (thread == 0 && 10 * ind / nbatches > pct) {
+            pct = 10 * ind / nbatches;
+            std::time_t stop = std::time(nullptr);
+            outfile->Printf("              %3.1lf  %8d s\n", 100.0 * ind / nbatches, (int)stop - (int)start);
+        }
+    }
+
+    double et = 0.0;
+    for (int i = 0; i < nthreads; i++) et += etrip[i];
+    return et;
+}
+
 PsiReturnType CoupledCluster::triples() {
     auto *name = new char[10];
     auto *space = new char[10];
@@ -101,6 +392,12 @@ PsiReturnType CoupledCluster::triples() {
     outfile->Printf("        num_threads:              %9i\n", nthreads);
     outfile->Printf("        available memory:      %9.2lf mb\n", (double)memory / 1024. / 1024.);
     outfile->Printf("        memory requirements:   %9.2lf mb\n", (double)memory_reqd / 1024. / 1024.);
+
+    // Batch the triples over i if there is room for at least two per batch
+    long int thread_words = (memory - 8L * (2L * vvoo + vooo + vo)) / 8L / nthreads;
+    long int nbatch = std::min(std::min(o, 8L), (thread_words / vvv - 5L) / 4L);
+    while (nbatch > 1 && (4L * nbatch + 5L) * vvv + 2L * nbatch * vv > thread_words) nbatch--;
+    if (nbatch > 1) outfile->Printf("        triples per batch:        %9ld\n", nbatch);
     outfile->Printf("\n");
 
     long int nijk = 0;
@@ -127,15 +424,26 @@ PsiReturnType CoupledCluster::triples() {
     outfile->Printf("        Number of ijk combinations: %ld\n", nijk);
     outfile->Printf("\n");
 
+    // the tasks are triples, or batches of them
+    long int ntasks = nijk;
+    if (nbatch > 1) {
+        ntasks = 0;
+        for (long int j = 0; j < o; j++) ntasks += (j + 1) * ((o - j + nbatch - 1) / nbatch);
+    }
+    double ecorr = ccmethod <= 1 ? eccsd : emp2 + emp3 + emp4_sd + emp4_q;
+    TriplesCheckpoint ckpt(std::string("fnocc_") + name, options_.get_int("TRIPLES_CHECKPOINT"), ntasks,
+                           {(double)nbatch, (double)o, (double)v, (double)ntasks, escf, ecorr});
+
     E2abci = (double **)malloc(nthreads * sizeof(double *));
     // some v^3 intermediates
     double **Z = (double **)malloc(nthreads * sizeof(double *));
     double **Z2 = (double **)malloc(nthreads * sizeof(double *));
 
+    // (the batched algorithm keeps its own)
     for (int i = 0; i < nthreads; i++) {
-        E2abci[i] = (double *)malloc(vvv * sizeof(double));
-        Z[i] = (double *)malloc(vvv * sizeof(double));
-        Z2[i] = (double *)malloc(vvv * sizeof(double));
+        E2abci[i] = nbatch > 1 ? nullptr : (double *)malloc(vvv * sizeof(double));
+        Z[i] = nbatch > 1 ? nullptr : (double *)malloc(vvv * sizeof(double));
+        Z2[i] = nbatch > 1 ? nullptr : (double *)malloc(vvv * sizeof(double));
     }
 
     auto psio = std::make_shared<PSIO>();
@@ -173,212 +481,132 @@ PsiReturnType CoupledCluster::triples() {
     int pct10, pct20, pct30, pct40, pct50, pct60, pct70, pct80, pct90;
     pct10 = pct20 = pct30 = pct40 = pct50 = pct60 = pct70 = pct80 = pct90 = 0;
 
-/**
-  *  if there is enough memory to explicitly thread, do so
-  */
+    if (nbatch > 1) {
+        etrip[0] = batched_triples(o, v, nbatch, nthreads, fac, t1, E2klcd, E2ijak, tempt, F, ckpt);
+    } else {
+    /**
+      *  if there is enough memory to explicitly thread, do so
+      */
 #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-    for (long int ind = 0; ind < nijk; ind++) {
-        long int i = ijk[ind][0];
-        long int j = ijk[ind][1];
-        long int k = ijk[ind][2];
+        for (long int ind = 0; ind < nijk; ind++) {
+            if (ckpt.done(ind)) continue;
 
-        int thread = 0;
+            long int i = ijk[ind][0];
+            long int j = ijk[ind][1];
+            long int k = ijk[ind][2];
+
+            int thread = 0;
 #ifdef _OPENMP
-        thread = omp_get_thread_num();
+            thread = omp_get_thread_num();
 #endif
 
-        auto mypsio = std::make_shared<PSIO>();
-        mypsio->open(PSIF_DCC_ABCI, PSIO_OPEN_OLD);
-
-        psio_address addr = psio_get_address(PSIO_ZERO, k * vvv * sizeof(double));
-        mypsio->read(PSIF_DCC_ABCI, "E2abci", (char *)&E2abci[thread][0], vvv * sizeof(double), addr, &addr);
-        F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + j * vvo + i * vv, v, 0.0, Z[thread], v * v);
-        F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + j * o * o * v + k * o * v, v, tempt + i * vvo, vv, 1.0, Z[thread],
-                v);
-
-        //(ab)(ij)
-        F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + i * vvo + j * vv, v, 0.0, Z2[thread], v * v);
-        F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + i * o * o * v + k * o * v, v, tempt + j * vvo, vv, 1.0, Z2[thread],
-                v);
-        for (long int a = 0; a < v; a++) {
-            for (long int b = 0; b < v; b++) {
-                C_DAXPY(v, 1.0, Z2[thread] + b * vv + a * v, 1, Z[thread] + a * vv + b * v, 1);
-            }
-        }
-
-        //(bc)(jk)
-        addr = psio_get_address(PSIO_ZERO, (long int)j * vvv * sizeof(double));
-        mypsio->read(PSIF_DCC_ABCI, "E2abci", (char *)&E2abci[thread][0], vvv * sizeof(double), addr, &addr);
-        F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + k * v * v * o + i * v * v, v, 0.0, Z2[thread],
-                v * v);
-        F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + k * voo + j * vo, v, tempt + i * vvo, vv, 1.0, Z2[thread], v);
-        for (long int a = 0; a < v; a++) {
-            for (long int b = 0; b < v; b++) {
-                C_DAXPY(v, 1.0, Z2[thread] + a * vv + b, v, Z[thread] + a * vv + b * v, 1);
-            }
-        }
-
-        //(ikj)(acb)
-        F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + i * vvo + k * vv, v, 0.0, Z2[thread], vv);
-        F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + i * voo + j * vo, v, tempt + k * vvo, vv, 1.0, Z2[thread], v);
-        for (long int a = 0; a < v; a++) {
-            for (long int b = 0; b < v; b++) {
-                C_DAXPY(v, 1.0, Z2[thread] + a * v + b, vv, Z[thread] + a * vv + b * v, 1);
+            auto mypsio = std::make_shared<PSIO>();
+            mypsio->open(PSIF_DCC_ABCI, PSIO_OPEN_OLD);
+
+            psio_address addr = psio_get_address(PSIO_ZERO, k * vvv * sizeof(double));
+            mypsio->read(PSIF_DCC_ABCI, "E2abci", (char *)&E2abci[thread][0], vvv * sizeof(double), addr, &addr);
+            F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + j * vvo + i * vv, v, 0.0, Z[thread], v * v);
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + j * o * o * v + k * o * v, v, tempt + i * vvo, vv, 1.0,
+                    Z[thread], v);
+
+            //(ab)(ij)
+            F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + i * vvo + j * vv, v, 0.0, Z2[thread], v * v);
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + i * o * o * v + k * o * v, v, tempt + j * vvo, vv, 1.0,
+                    Z2[thread], v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Z2[thread] + b * vv + a * v, 1, Z[thread] + a * vv + b * v, 1);
+                }
             }
-        }
 
-        //(ac)(ik)
-        addr = psio_get_address(PSIO_ZERO, i * vvv * sizeof(double));
-        mypsio->read(PSIF_DCC_ABCI, "E2abci", (char *)&E2abci[thread][0], vvv * sizeof(double), addr, &addr);
-        F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + j * vvo + k * vv, v, 0.0, Z2[thread], vv);
-        F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + j * voo + i * vo, v, tempt + k * vvo, vv, 1.0, Z2[thread], v);
-        for (long int a = 0; a < v; a++) {
-            for (long int b = 0; b < v; b++) {
-                C_DAXPY(v, 1.0, Z2[thread] + b * v + a, vv, Z[thread] + a * vv + b * v, 1);
+            //(bc)(jk)
+            addr = psio_get_address(PSIO_ZERO, (long int)j * vvv * sizeof(double));
+            mypsio->read(PSIF_DCC_ABCI, "E2abci", (char *)&E2abci[thread][0], vvv * sizeof(double), addr, &addr);
+            F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + k * v * v * o + i * v * v, v, 0.0, Z2[thread],
+                    v * v);
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + k * voo + j * vo, v, tempt + i * vvo, vv, 1.0, Z2[thread], v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Z2[thread] + a * vv + b, v, Z[thread] + a * vv + b * v, 1);
+                }
             }
-        }
 
-        //(ijk)(abc)
-        F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + k * vvo + j * vv, v, 0.0, Z2[thread], vv);
-        F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + k * voo + i * vo, v, tempt + j * vvo, vv, 1.0, Z2[thread], v);
-        for (long int a = 0; a < v; a++) {
-            for (long int b = 0; b < v; b++) {
-                C_DAXPY(v, 1.0, Z2[thread] + b * vv + a, v, Z[thread] + a * vv + b * v, 1);
-            }
-        }
-
-        C_DCOPY(vvv, Z[thread], 1, Z2[thread], 1);
-        for (long int a = 0; a < v; a++) {
-            double tai = t1[a * o + i];
-            for (long int b = 0; b < v; b++) {
-                long int ab = 1 + (a == b);
-                double tbj = t1[b * o + j];
-                double E2iajb = E2klcd[i * vvo + a * vo + j * v + b];
-                for (long int c = 0; c < v; c++) {
-                    Z2[thread][a * vv + b * v + c] +=
-                        fac * (tai * E2klcd[j * vvo + b * vo + k * v + c] + tbj * E2klcd[i * vvo + a * vo + k * v + c] +
-                               t1[c * o + k] * E2iajb);
-                    Z2[thread][a * vv + b * v + c] /= (ab + (b == c) + (a == c));
+            //(ikj)(acb)
+            F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + i * vvo + k * vv, v, 0.0, Z2[thread], vv);
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + i * voo + j * vo, v, tempt + k * vvo, vv, 1.0, Z2[thread], v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Z2[thread] + a * v + b, vv, Z[thread] + a * vv + b * v, 1);
                 }
             }
-        }
 
-        for (long int a = 0; a < v; a++) {
-            for (long int b = 0; b < v; b++) {
-                for (long int c = 0; c < v; c++) {
-                    long int abc = a * vv + b * v + c;
-                    long int bac = b * vv + a * v + c;
-                    long int acb = a * vv + c * v + b;
-                    long int cba = c * vv + b * v + a;
-
-                    E2abci[thread][abc] = Z2[thread][acb] + Z2[thread][bac] + Z2[thread][cba];
+            //(ac)(ik)
+            addr = psio_get_address(PSIO_ZERO, i * vvv * sizeof(double));
+            mypsio->read(PSIF_DCC_ABCI, "E2abci", (char *)&E2abci[thread][0], vvv * sizeof(double), addr, &addr);
+            F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + j * vvo + k * vv, v, 0.0, Z2[thread], vv);
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + j * voo + i * vo, v, tempt + k * vvo, vv, 1.0, Z2[thread], v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Z2[thread] + b * v + a, vv, Z[thread] + a * vv + b * v, 1);
                 }
             }
-        }
-        double dijk = F[i] + F[j] + F[k];
-        long int ijkfac = (2 - ((i == j) + (j == k) + (i == k)));
-        // separate out these bits to save v^3 storage
-        double tripval = 0.0;
-        for (long int a = 0; a < v; a++) {
-            double dijka = dijk - F[a + o];
-            for (long int b = 0; b <= a; b++) {
-                double dijkab = dijka - F[b + o];
-                for (long int c = 0; c <= b; c++) {
-                    long int abc = a * vv + b * v + c;
-                    long int bca = b * vv + c * v + a;
-                    long int cab = c * vv + a * v + b;
-                    long int acb = a * vv + c * v + b;
-                    long int bac = b * vv + a * v + c;
-                    long int cba = c * vv + b * v + a;
-                    double dum = Z[thread][abc] * Z2[thread][abc] + Z[thread][acb] * Z2[thread][acb] +
-                                 Z[thread][bac] * Z2[thread][bac] + Z[thread][bca] * Z2[thread][bca] +
-                                 Z[thread][cab] * Z2[thread][cab] + Z[thread][cba] * Z2[thread][cba];
-
-                    dum = (E2abci[thread][abc]) * ((Z[thread][abc] + Z[thread][bca] + Z[thread][cab]) * -2.0 +
-                                                   (Z[thread][acb] + Z[thread][bac] + Z[thread][cba])) +
-                          3.0 * dum;
-                    double denom = dijkab - F[c + o];
-                    tripval += dum / denom;
+
+            //(ijk)(abc)
+            F_DGEMM('t', 't', vv, v, v, 1.0, E2abci[thread], v, tempt + k * vvo + j * vv, v, 0.0, Z2[thread], vv);
+            F_DGEMM('n', 't', v, vv, o, -1.0, E2ijak + k * voo + i * vo, v, tempt + j * vvo, vv, 1.0, Z2[thread], v);
+            for (long int a = 0; a < v; a++) {
+                for (long int b = 0; b < v; b++) {
+                    C_DAXPY(v, 1.0, Z2[thread] + b * vv + a, v, Z[thread] + a * vv + b * v, 1);
                 }
             }
-        }
-        etrip[thread] += tripval * ijkfac;
-        // the second bit
-        for (long int a = 0; a < v; a++) {
-            for (long int b = 0; b < v; b++) {
-                for (long int c = 0; c < v; c++) {
-                    long int abc = a * vv + b * v + c;
-                    long int bca = b * vv + c * v + a;
-                    long int cab = c * vv + a * v + b;
-
-                    E2abci[thread][abc] = Z2[thread][abc] + Z2[thread][bca] + Z2[thread][cab];
+
+            double eijk = triples_ijk_energy(i, j, k, o, v, fac, t1, E2klcd, F, Z[thread], Z2[thread], E2abci[thread]);
+            etrip[thread] += eijk;
+            ckpt.finish(ind, eijk);
+            // print out update
+            if (thread == 0) {
+                int print = 0;
+                stop = std::time(nullptr);
+                if ((double)ind / nijk >= 0.1 && !pct10) {
+                    pct10 = 1;
+                    print = 1;
+                } else if ((double)ind / nijk >= 0.2 && !pct20) {
+                    pct20 = 1;
+                    print = 1;
+                } else if ((double)ind / nijk >= 0.3 && !pct30) {
+                    pct30 = 1;
+                    print = 1;
+                } else if ((double)ind / nijk >= 0.4 && !pct40) {
+                    pct40 = 1;
+                    print = 1;
+                } else if ((double)ind / nijk >= 0.5 && !pct50) {
+                    pct50 = 1;
+                    print = 1;
+                } else if ((double)ind / nijk >= 0.6 && !pct60) {
+                    pct60 = 1;
+                    print = 1;
+                } else if ((double)ind / nijk >= 0.7 && !pct70) {
+                    pct70 = 1;
+                    print = 1;
+                } else if ((double)ind / nijk >= 0.8 && !pct80) {
+                    pct80 = 1;
+                    print = 1;
+                } else if ((double)ind / nijk >= 0.9 && !pct90) {
+                    pct90 = 1;
+                    print = 1;
                 }
-            }
-        }
-        tripval = 0.0;
-        for (long int a = 0; a < v; a++) {
-            double dijka = dijk - F[a + o];
-            for (long int b = 0; b <= a; b++) {
-                double dijkab = dijka - F[b + o];
-                for (long int c = 0; c <= b; c++) {
-                    long int abc = a * vv + b * v + c;
-                    long int bca = b * vv + c * v + a;
-                    long int cab = c * vv + a * v + b;
-                    long int acb = a * vv + c * v + b;
-                    long int bac = b * vv + a * v + c;
-                    long int cba = c * vv + b * v + a;
-
-                    double dum = (E2abci[thread][abc]) * (Z[thread][abc] + Z[thread][bca] + Z[thread][cab] +
-                                                          (Z[thread][acb] + Z[thread][bac] + Z[thread][cba]) * -2.0);
-
-                    double denom = dijkab - F[c + o];
-                    tripval += dum / denom;
+                if (print) {
+                    outfile->Printf("              %3.1lf  %8d s\n", 100.0 * ind / nijk, (int)stop - (int)start);
                 }
             }
+            mypsio->close(PSIF_DCC_ABCI, 1);
+            mypsio.reset();
         }
-        etrip[thread] += tripval * ijkfac;
-        // print out update
-        if (thread == 0) {
-            int print = 0;
-            stop = std::time(nullptr);
-            if ((double)ind / nijk >= 0.1 && !pct10) {
-                pct10 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.2 && !pct20) {
-                pct20 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.3 && !pct30) {
-                pct30 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.4 && !pct40) {
-                pct40 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.5 && !pct50) {
-                pct50 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.6 && !pct60) {
-                pct60 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.7 && !pct70) {
-                pct70 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.8 && !pct80) {
-                pct80 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.9 && !pct90) {
-                pct90 = 1;
-                print = 1;
-            }
-            if (print) {
-                outfile->Printf("              %3.1lf  %8d s\n", 100.0 * ind / nijk, (int)stop - (int)start);
-            }
-        }
-        mypsio->close(PSIF_DCC_ABCI, 1);
-        mypsio.reset();
     }
 
-    double myet = 0.0;
+    double myet = ckpt.restored_energy();
     for (int i = 0; i < nthreads; i++) myet += etrip[i];
+    ckpt.remove();
 
     // ccsd(t) or qcisd(t)
     if (ccmethod <= 1) {
@@ -0,0 +1,121 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "psi4/psifiles.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/psi4-dec.h"
+
+#include "triples_checkpoint.h"
+
+namespace psi {
+namespace fnocc {
+
+TriplesCheckpoint::TriplesCheckpoint(const std::string &tag, int interval, long int ntasks,
+                                     const std::vector<double> &key)
+    : interval_(interval), ntasks_(ntasks), key_(key), ndone_(0), energy_(0.0), restored_(0.0) {
+    if (interval_ <= 0) return;
+
+    done_.assign(ntasks_, 0);
+    last_ = std::time(nullptr);
+
+    // the file name must not depend on the process id, or a rerun would never find it
+    psio_ = std::make_shared<PSIO>();
+    psio_->set_pid(tag);
+    psio_->open(PSIF_DCC_TRIPLES, PSIO_OPEN_OLD);
+
+    if (!psio_->tocentry_exists(PSIF_DCC_TRIPLES, "Key")) {
+        psio_->close(PSIF_DCC_TRIPLES, 1);
+        return;
+    }
+
+    bool match = psio_->tocentry_exists(PSIF_DCC_TRIPLES, "Progress");
+    if (match) {
+        std::vector<double> oldkey(key_.size());
+        psio_->read_entry(PSIF_DCC_TRIPLES, "Key", (char *)oldkey.data(), oldkey.size() * sizeof(double));
+        for (size_t n = 0; n < key_.size(); n++) {
+            if (std::fabs(oldkey[n] - key_[n]) > 1.0e-8) match = false;
+        }
+    }
+    if (!match) {
+        outfile->Printf("        Discarding (T) checkpoint from a different calculation.\n");
+        outfile->Printf("\n");
+        psio_->close(PSIF_DCC_TRIPLES, 0);
+        return;
+    }
+
+    std::vector<char> progress(sizeof(double) + sizeof(long int) + ntasks_);
+    psio_->read_entry(PSIF_DCC_TRIPLES, "Progress", progress.data(), progress.size());
+    memcpy(&energy_, progress.data(), sizeof(double));
+    memcpy(&ndone_, progress.data() + sizeof(double), sizeof(long int));
+    memcpy(done_.data(), progress.data() + sizeof(double) + sizeof(long int), ntasks_);
+    restored_ = energy_;
+    psio_->close(PSIF_DCC_TRIPLES, 1);
+
+    outfile->Printf("        Resuming (T) from checkpoint: %ld of %ld tasks done.\n", ndone_, ntasks_);
+    outfile->Printf("\n");
+}
+
+void TriplesCheckpoint::finish(long int task, double energy) {
+    if (interval_ <= 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_[task] = 1;
+    ndone_++;
+    energy_ += energy;
+
+    std::time_t now = std::time(nullptr);
+    if (now - last_ >= interval_) {
+        write();
+        last_ = now;
+    }
+}
+
+void TriplesCheckpoint::write() {
+    std::vector<char> progress(sizeof(double) + sizeof(long int) + ntasks_);
+    memcpy(progress.data(), &energy_, sizeof(double));
+    memcpy(progress.data() + sizeof(double), &ndone_, sizeof(long int));
+    memcpy(progress.data() + sizeof(double) + sizeof(long int), done_.data(), ntasks_);
+
+    // the toc only reaches the disk on close, so close after every write
+    psio_->open(PSIF_DCC_TRIPLES, PSIO_OPEN_OLD);
+    psio_->write_entry(PSIF_DCC_TRIPLES, "Key", (char *)key_.data(), key_.size() * sizeof(double));
+    psio_->write_entry(PSIF_DCC_TRIPLES, "Progress", progress.data(), progress.size());
+    psio_->close(PSIF_DCC_TRIPLES, 1);
+}
+
+void TriplesCheckpoint::remove() {
+    if (interval_ <= 0) return;
+    psio_->open(PSIF_DCC_TRIPLES, PSIO_OPEN_OLD);
+    psio_->close(PSIF_DCC_TRIPLES, 0);
+}
+}
+}  // end of namespaces
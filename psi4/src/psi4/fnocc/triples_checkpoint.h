@@ -0,0 +1,84 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef FNOCC_TRIPLES_CHECKPOINT_H
+#define FNOCC_TRIPLES_CHECKPOINT_H
+
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace psi {
+
+class PSIO;
+
+namespace fnocc {
+
+/*
+ * Progress of a (T) loop over independent tasks (ijk triples, batches of
+ * them, or abc triples): which tasks are finished and the energy they
+ * contributed.  The record is rewritten through psio every "interval"
+ * seconds under a process-independent file name in the scratch directory,
+ * so a job that is killed and rerun with the same scratch directory only
+ * does the remaining tasks.  The key identifies the calculation; a record
+ * with a different key is discarded.
+ */
+class TriplesCheckpoint {
+   public:
+    /// interval <= 0 disables checkpointing
+    TriplesCheckpoint(const std::string &tag, int interval, long int ntasks, const std::vector<double> &key);
+
+    /// was this task finished by an earlier run?
+    bool done(long int task) const { return interval_ > 0 && done_[task]; }
+    /// energy of the tasks finished by earlier runs
+    double restored_energy() const { return restored_; }
+    /// record a finished task and its energy; thread-safe
+    void finish(long int task, double energy);
+    /// the loop is complete: delete the record
+    void remove();
+
+   private:
+    void write();
+
+    int interval_;
+    long int ntasks_;
+    std::vector<double> key_;
+    std::vector<char> done_;
+    long int ndone_;
+    double energy_;
+    double restored_;
+    std::time_t last_;
+    std::mutex mutex_;
+    std::shared_ptr<PSIO> psio_;
+};
+}
+}  // end of namespaces
+
+#endif
@@ -33,7 +33,10 @@ PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 PRAGMA_WARNING_POP
 #include "psi4/libqt/qt.h"
 #include <cmath>
+#include <algorithm>
 #include <limits>
+#include <map>
+#include <numeric>
 #include <vector>
 #include "cholesky.h"
 #include "psi4/psifiles.h"
@@ -44,14 +47,21 @@ PRAGMA_WARNING_POP
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/twobody.h"
+#include "psi4/libpsi4util/process.h"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 namespace psi {
 
-Cholesky::Cholesky(double delta, size_t memory) : delta_(delta), memory_(memory), Q_(0) {}
+Cholesky::Cholesky(double delta, size_t memory)
+    : delta_(delta), memory_(memory), Q_(0), block_size_(16), nthread_(Process::environment.get_n_threads()) {}
 Cholesky::~Cholesky() {}
+void Cholesky::compute_rows(const std::vector<size_t>& rows, double** targets) {
+    for (size_t i = 0; i < rows.size(); i++) {
+        compute_row(rows[i], targets[i]);
+    }
+}
 void Cholesky::choleskify() {
     // Initial dimensions
     size_t n = N();
@@ -67,77 +77,177 @@ void Cholesky::choleskify() {
     auto* diag = new double[n];
     compute_diagonal(diag);
 
-    // Temporary cholesky factor
-    std::vector<double*> L;
+    // Temporary cholesky factor, one contiguous (rows x n) block per sweep
+    std::vector<std::unique_ptr<double[]>> L;
+    std::vector<size_t> Lrows;
 
     // List of selected pivots
-    std::vector<int> pivots;
+    std::vector<size_t> pivots;
+
+    // Candidate rows of the current sweep. The first npend are the residual rows of candidates
+    // left over from the previous sweep, already updated for every pivot taken so far.
+    size_t block = std::min(block_size_, n);
+    std::unique_ptr<double[]> R(new double[block * n]);
+    std::vector<double*> Rp(block);
+    std::vector<size_t> order(n);
+    std::vector<size_t> cand;
+    std::vector<bool> pending(n, false);
 
     // Cholesky procedure
-    while (Q_ < n) {
-        // Select the pivot
-        size_t pivot = 0;
-        double Dmax = diag[0];
-        for (size_t P = 0; P < n; P++) {
-            if (Dmax < diag[P]) {
-                Dmax = diag[P];
-                pivot = P;
+    bool converged = false;
+    while (Q_ < n && !converged) {
+        // Left-over candidates whose diagonal fell below the cutoff can never be pivots
+        size_t npend = 0;
+        for (size_t c = 0; c < cand.size(); c++) {
+            pending[cand[c]] = false;
+            if (diag[cand[c]] < delta_) continue;
+            if (npend != c) {
+                ::memcpy(static_cast<void*>(&R[npend * n]), static_cast<void*>(&R[c * n]), n * sizeof(double));
             }
+            cand[npend++] = cand[c];
+        }
+        cand.resize(npend);
+        for (size_t c = 0; c < npend; c++) pending[cand[c]] = true;
+
+        // The largest other diagonals are the likely next pivots (ties go to the lower index, as below).
+        // A sweep takes at least one pivot, so npend < block and there is room for the largest of them.
+        std::iota(order.begin(), order.end(), 0);
+        size_t nnew = std::min(block - npend, n - Q_ - npend);
+        std::partial_sort(order.begin(), order.begin() + nnew, order.end(), [&diag, &pending](size_t P, size_t Q) {
+            if (pending[P] != pending[Q]) return static_cast<bool>(pending[Q]);
+            return diag[P] > diag[Q] || (diag[P] == diag[Q] && P < Q);
+        });
+        for (size_t c = 0; c < nnew && diag[order[c]] >= delta_; c++) cand.push_back(order[c]);
+        size_t ncand = cand.size();
+        if (!ncand) break;
+        nnew = ncand - npend;
+
+        // (m|Q) for the new candidates at once
+        for (size_t c = 0; c < ncand; c++) Rp[c] = &R[c * n];
+        if (nnew) {
+            std::vector<size_t> fresh(cand.begin() + npend, cand.end());
+            compute_rows(fresh, Rp.data() + npend);
         }
 
-        // Check to see if convergence reached
-        if (Dmax < delta_ || Dmax < 0.0) break;
+        // [(m|Q) - L_m^P L_Q^P] for the pivots of earlier sweeps
+        for (size_t b = 0; nnew && b < L.size(); b++) {
+            size_t nb = Lrows[b];
+            std::vector<double> G(nnew * nb);
+            for (size_t c = 0; c < nnew; c++) {
+                for (size_t P = 0; P < nb; P++) {
+                    G[c * nb + P] = L[b][P * n + cand[npend + c]];
+                }
+            }
+            C_DGEMM('N', 'N', nnew, n, nb, -1.0, G.data(), nb, L[b].get(), n, 1.0, Rp[npend], n);
+        }
 
-        // If here, we're trying to add this row
-        pivots.push_back(pivot);
-        double L_QQ = sqrt(Dmax);
+        // Take pivots one at a time while the largest diagonal is one we already have the row for
+        std::unique_ptr<double[]> Lb(new double[ncand * n]);
+        std::vector<bool> used(ncand, false);
+        size_t nacc = 0;
+        while (nacc < ncand) {
+            // Select the pivot
+            size_t pivot = 0;
+            double Dmax = diag[0];
+            for (size_t P = 0; P < n; P++) {
+                if (Dmax < diag[P]) {
+                    Dmax = diag[P];
+                    pivot = P;
+                }
+            }
 
-        // Check to see if memory constraints are OK
-        if (Q_ > max_rows) {
-            throw PSIEXCEPTION("Cholesky: Memory constraints exceeded. Fire your theorist.");
-        }
+            // Check to see if convergence reached
+            if (Dmax < delta_ || Dmax < 0.0) {
+                converged = true;
+                break;
+            }
 
-        // If here, we're really going to add this row
-        L.push_back(new double[n]);
+            // Not a candidate: start a new sweep
+            size_t c = 0;
+            for (; c < ncand; c++) {
+                if (cand[c] == pivot && !used[c]) break;
+            }
+            if (c == ncand) break;
 
-        // (m|Q)
-        compute_row(pivot, L[Q_]);
+            // If here, we're trying to add this row
+            pivots.push_back(pivot);
+            double L_QQ = sqrt(Dmax);
 
-        // [(m|Q) - L_m^P L_Q^P]
-        for (size_t P = 0; P < Q_; P++) {
-            C_DAXPY(n, -L[P][pivots[Q_]], L[P], 1, L[Q_], 1);
-        }
+            // Check to see if memory constraints are OK
+            if (Q_ > max_rows) {
+                throw PSIEXCEPTION("Cholesky: Memory constraints exceeded. Fire your theorist.");
+            }
 
-        // 1/L_QQ [(m|Q) - L_m^P L_Q^P]
-        C_DSCAL(n, 1.0 / L_QQ, L[Q_], 1);
+            // If here, we're really going to add this row
+            double* Lq = &Lb[nacc * n];
+            ::memcpy(static_cast<void*>(Lq), static_cast<void*>(Rp[c]), n * sizeof(double));
+            used[c] = true;
 
-        // Zero the upper triangle
-        for (size_t P = 0; P < pivots.size(); P++) {
-            L[Q_][pivots[P]] = 0.0;
-        }
+            // [(m|Q) - L_m^P L_Q^P] for the pivots of this sweep
+            for (size_t P = 0; P < nacc; P++) {
+                C_DAXPY(n, -Lb[P * n + pivot], &Lb[P * n], 1, Lq, 1);
+            }
 
-        // Set the pivot factor
-        L[Q_][pivot] = L_QQ;
+            // 1/L_QQ [(m|Q) - L_m^P L_Q^P]
+            C_DSCAL(n, 1.0 / L_QQ, Lq, 1);
 
-        // Update the Schur complement diagonal
-        for (size_t P = 0; P < n; P++) {
-            diag[P] -= L[Q_][P] * L[Q_][P];
-        }
+            // Zero the upper triangle
+            for (size_t P = 0; P < pivots.size(); P++) {
+                Lq[pivots[P]] = 0.0;
+            }
+
+            // Set the pivot factor
+            Lq[pivot] = L_QQ;
+
+            // Update the Schur complement diagonal
+            for (size_t P = 0; P < n; P++) {
+                diag[P] -= Lq[P] * Lq[P];
+            }
 
-        // Force truly zero elements to zero
-        for (size_t P = 0; P < pivots.size(); P++) {
-            diag[pivots[P]] = 0.0;
+            // Force truly zero elements to zero
+            for (size_t P = 0; P < pivots.size(); P++) {
+                diag[pivots[P]] = 0.0;
+            }
+
+            nacc++;
+            Q_++;
         }
 
-        Q_++;
+        // Candidates not taken keep their rows for the next sweep, updated for the pivots of this one
+        size_t nleft = 0;
+        for (size_t c = 0; c < ncand; c++) {
+            if (used[c]) continue;
+            for (size_t P = 0; P < nacc; P++) {
+                C_DAXPY(n, -Lb[P * n + cand[c]], &Lb[P * n], 1, Rp[c], 1);
+            }
+            if (nleft != c) ::memcpy(static_cast<void*>(Rp[nleft]), static_cast<void*>(Rp[c]), n * sizeof(double));
+            cand[nleft++] = cand[c];
+        }
+        cand.resize(nleft);
+
+        if (nacc) {
+            // Only the taken rows stay resident in the factor
+            if (nacc < ncand) {
+                std::unique_ptr<double[]> Lc(new double[nacc * n]);
+                ::memcpy(static_cast<void*>(Lc.get()), static_cast<void*>(Lb.get()), nacc * n * sizeof(double));
+                Lb = std::move(Lc);
+            }
+            L.push_back(std::move(Lb));
+            Lrows.push_back(nacc);
+        }
     }
+    delete[] diag;
+    R.reset();
+    pivots_ = pivots;
+
     // Copy into a more permanant Matrix object
     L_ = std::make_shared<Matrix>("Partial Cholesky", Q_, n);
     double** Lp = L_->pointer();
 
-    for (size_t Q = 0; Q < Q_; Q++) {
-        ::memcpy(static_cast<void*>(Lp[Q]), static_cast<void*>(L[Q]), n * sizeof(double));
-        delete[] L[Q];
+    for (size_t b = 0, Q = 0; b < L.size(); b++) {
+        ::memcpy(static_cast<void*>(Lp[Q]), static_cast<void*>(L[b].get()), Lrows[b] * n * sizeof(double));
+        Q += Lrows[b];
+        L[b].reset();
     }
 }
 
@@ -164,56 +274,102 @@ CholeskyERI::CholeskyERI(std::shared_ptr<TwoBodyAOInt> integral, double schwarz,
 }
 CholeskyERI::~CholeskyERI() {}
 size_t CholeskyERI::N() { return static_cast<size_t>(basisset_->nbf()) * basisset_->nbf(); }
+void CholeskyERI::build_ints() {
+    if (ints_.size() == static_cast<size_t>(nthread_)) return;
+    ints_.clear();
+    ints_.push_back(integral_);
+    for (int thread = 1; thread < nthread_; thread++) {
+        ints_.push_back(std::shared_ptr<TwoBodyAOInt>(integral_->clone()));
+    }
+}
 void CholeskyERI::compute_diagonal(double* target) {
-    for (size_t M = 0; M < basisset_->nshell(); M++) {
-        for (size_t N = 0; N < basisset_->nshell(); N++) {
-            integral_->compute_shell(M, N, M, N);
-            const double* buffer = integral_->buffer();
-
-            size_t nM = basisset_->shell(M).nfunction();
-            size_t nN = basisset_->shell(N).nfunction();
-            size_t mstart = basisset_->shell(M).function_index();
-            size_t nstart = basisset_->shell(N).function_index();
-
-            for (size_t om = 0; om < nM; om++) {
-                for (size_t on = 0; on < nN; on++) {
-                    target[(om + mstart) * basisset_->nbf() + (on + nstart)] =
-                        buffer[om * nN * nM * nN + on * nM * nN + om * nN + on];
-                }
+    build_ints();
+    size_t nshell = basisset_->nshell();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (size_t MN = 0; MN < nshell * nshell; MN++) {
+        size_t M = MN / nshell;
+        size_t N = MN % nshell;
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        ints_[rank]->compute_shell(M, N, M, N);
+        const double* buffer = ints_[rank]->buffer();
+
+        size_t nM = basisset_->shell(M).nfunction();
+        size_t nN = basisset_->shell(N).nfunction();
+        size_t mstart = basisset_->shell(M).function_index();
+        size_t nstart = basisset_->shell(N).function_index();
+
+        for (size_t om = 0; om < nM; om++) {
+            for (size_t on = 0; on < nN; on++) {
+                target[(om + mstart) * basisset_->nbf() + (on + nstart)] =
+                    buffer[om * nN * nM * nN + on * nM * nN + om * nN + on];
             }
         }
     }
 }
 void CholeskyERI::compute_row(int row, double* target) {
-    size_t r = row / basisset_->nbf();
-    size_t s = row % basisset_->nbf();
-    size_t R = basisset_->function_to_shell(r);
-    size_t S = basisset_->function_to_shell(s);
-
-    size_t nR = basisset_->shell(R).nfunction();
-    size_t nS = basisset_->shell(S).nfunction();
-    size_t rstart = basisset_->shell(R).function_index();
-    size_t sstart = basisset_->shell(S).function_index();
-
-    size_t oR = r - rstart;
-    size_t os = s - sstart;
-    int nshell = basisset_->nshell();
-
-    for (size_t M = 0; M < basisset_->nshell(); M++) {
-        for (size_t N = M; N < basisset_->nshell(); N++) {
-            integral_->compute_shell(M, N, R, S);
-            const double* buffer = integral_->buffer();
-
-            size_t nM = basisset_->shell(M).nfunction();
-            size_t nN = basisset_->shell(N).nfunction();
-            size_t mstart = basisset_->shell(M).function_index();
-            size_t nstart = basisset_->shell(N).function_index();
-
-            for (size_t om = 0; om < nM; om++) {
-                for (size_t on = 0; on < nN; on++) {
-                    target[(om + mstart) * basisset_->nbf() + (on + nstart)] =
-                        target[(on + nstart) * basisset_->nbf() + (om + mstart)] =
+    std::vector<size_t> rows(1, row);
+    compute_rows(rows, &target);
+}
+void CholeskyERI::compute_rows(const std::vector<size_t>& rows, double** targets) {
+    build_ints();
+    size_t nbf = basisset_->nbf();
+    size_t nshell = basisset_->nshell();
+
+    // Group the rows by their (RS) shell pair, each (MN|RS) quartet then serves all of them
+    std::map<std::pair<size_t, size_t>, std::vector<size_t>> RS_rows;
+    for (size_t i = 0; i < rows.size(); i++) {
+        size_t R = basisset_->function_to_shell(rows[i] / nbf);
+        size_t S = basisset_->function_to_shell(rows[i] % nbf);
+        RS_rows[std::make_pair(R, S)].push_back(i);
+        ::memset(static_cast<void*>(targets[i]), '\0', nbf * nbf * sizeof(double));
+    }
+
+    // Significant (MN| shell pairs, M <= N
+    std::vector<std::pair<size_t, size_t>> MN_pairs;
+    for (size_t M = 0; M < nshell; M++) {
+        for (size_t N = M; N < nshell; N++) {
+            if (integral_->shell_pair_significant(M, N)) MN_pairs.emplace_back(M, N);
+        }
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (size_t MN = 0; MN < MN_pairs.size(); MN++) {
+        size_t M = MN_pairs[MN].first;
+        size_t N = MN_pairs[MN].second;
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        size_t nM = basisset_->shell(M).nfunction();
+        size_t nN = basisset_->shell(N).nfunction();
+        size_t mstart = basisset_->shell(M).function_index();
+        size_t nstart = basisset_->shell(N).function_index();
+
+        for (const auto& RS : RS_rows) {
+            size_t R = RS.first.first;
+            size_t S = RS.first.second;
+            if (!ints_[rank]->shell_significant(M, N, R, S)) continue;
+            ints_[rank]->compute_shell(M, N, R, S);
+            const double* buffer = ints_[rank]->buffer();
+
+            size_t nR = basisset_->shell(R).nfunction();
+            size_t nS = basisset_->shell(S).nfunction();
+            size_t rstart = basisset_->shell(R).function_index();
+            size_t sstart = basisset_->shell(S).function_index();
+
+            for (size_t i : RS.second) {
+                size_t oR = rows[i] / nbf - rstart;
+                size_t os = rows[i] % nbf - sstart;
+                double* target = targets[i];
+                for (size_t om = 0; om < nM; om++) {
+                    for (size_t on = 0; on < nN; on++) {
+                        target[(om + mstart) * nbf + (on + nstart)] = target[(on + nstart) * nbf + (om + mstart)] =
                             buffer[om * nN * nR * nS + on * nR * nS + oR * nS + os];
+                    }
                 }
             }
         }
@@ -32,6 +32,8 @@
 #include "psi4/pragma.h"
 #include "psi4/libmints/typedefs.h"
 
+#include <vector>
+
 namespace psi {
 
 class Vector;
@@ -48,6 +50,12 @@ class Cholesky {
     SharedMatrix L_;
     /// Number of columns required, if choleskify() called
     size_t Q_;
+    /// Selected pivots, in order, if choleskify() called
+    std::vector<size_t> pivots_;
+    /// Maximum number of candidate rows computed together per pivot sweep
+    size_t block_size_;
+    /// Number of threads available to compute_rows
+    int nthread_;
 
    public:
     /*!
@@ -66,15 +74,29 @@ class Cholesky {
     SharedMatrix L() const { return L_; }
     /// Number of columns required to reach accuracy delta, if choleskify() called
     size_t Q() const { return Q_; }
+    /// Rows of the original tensor selected as pivots, in order, if choleskify() called
+    const std::vector<size_t>& pivots() const { return pivots_; }
     /// Dimension of the original square tensor, provided by the subclass
     virtual size_t N() = 0;
     /// Maximum Chebyshev error allowed in the decomposition
     double delta() const { return delta_; }
 
+    /*!
+     * Number of rows requested from compute_rows per sweep (default 16).
+     * Pivots are still accepted in order of the largest residual diagonal,
+     * so the decomposition is the same as for a block size of 1.
+     **/
+    void set_block_size(size_t block_size) { block_size_ = (block_size ? block_size : 1); }
+    size_t block_size() const { return block_size_; }
+    /// Number of threads used to generate rows (default Process::environment.get_n_threads())
+    void set_nthread(int nthread) { nthread_ = nthread; }
+
     /// Diagonal of the original square tensor, provided by the subclass
     virtual void compute_diagonal(double* target) = 0;
     /// Row row of the original square tensor, provided by the subclass
     virtual void compute_row(int row, double* target) = 0;
+    /// Rows rows[i] of the original square tensor into targets[i], by default one compute_row call each
+    virtual void compute_rows(const std::vector<size_t>& rows, double** targets);
 };
 
 class CholeskyMatrix : public Cholesky {
@@ -95,6 +117,9 @@ class PSI_API CholeskyERI : public Cholesky {
     double schwarz_;
     std::shared_ptr<BasisSet> basisset_;
     std::shared_ptr<TwoBodyAOInt> integral_;
+    /// Per-thread integral objects, [0] is integral_
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints_;
+    void build_ints();
 
    public:
     CholeskyERI(std::shared_ptr<TwoBodyAOInt> integral, double schwarz, double delta, size_t memory);
@@ -103,6 +128,8 @@ class PSI_API CholeskyERI : public Cholesky {
     size_t N() override;
     void compute_diagonal(double* target) override;
     void compute_row(int row, double* target) override;
+    /// Rows sharing a shell pair reuse the same quartets; significant (MN| pairs are split over threads
+    void compute_rows(const std::vector<size_t>& rows, double** targets) override;
 };
 
 class CholeskyMP2 : public Cholesky {
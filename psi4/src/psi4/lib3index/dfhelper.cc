@@ -29,11 +29,15 @@
 #include "dfhelper.h"
 
 #include <algorithm>
+#include <numeric>
 #include <cstdlib>
 #ifdef _MSC_VER
 #include <process.h>
 #define SYSTEM_GETPID ::_getpid
 #else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #define SYSTEM_GETPID ::getpid
 #endif
@@ -41,7 +45,14 @@
 #include <omp.h>
 #endif
 
+#include <atomic>
+#include <cstring>
+#include <iomanip>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <future>
 #include "psi4/psi4-dec.h"
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libfock/jk.h"
@@ -70,7 +81,39 @@ DFHelper::DFHelper(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet>
     prepare_blocking();
 }
 
-DFHelper::~DFHelper() { clear_all(); }
+#ifndef _MSC_VER
+// Shared AO segments published by this process. Whatever is left at exit, e.g. from a DFHelper
+// that is never destroyed, is unlinked then, so no segment outlives its publisher.
+static std::mutex shared_AO_segments_mutex;
+static std::set<std::string>& shared_AO_segments() {
+    static std::set<std::string> segments;
+    return segments;
+}
+static void unlink_shared_AO_segments() {
+    std::lock_guard<std::mutex> lock(shared_AO_segments_mutex);
+    for (const auto& name : shared_AO_segments()) shm_unlink(name.c_str());
+    shared_AO_segments().clear();
+}
+static void register_shared_AO_segment(const std::string& name) {
+    static std::once_flag at_exit;
+    std::call_once(at_exit, [] { std::atexit(unlink_shared_AO_segments); });
+    std::lock_guard<std::mutex> lock(shared_AO_segments_mutex);
+    shared_AO_segments().insert(name);
+}
+static void unlink_shared_AO_segment(const std::string& name) {
+    std::lock_guard<std::mutex> lock(shared_AO_segments_mutex);
+    shm_unlink(name.c_str());
+    shared_AO_segments().erase(name);
+}
+#endif
+
+DFHelper::~DFHelper() {
+    clear_all();
+#ifndef _MSC_VER
+    // attached processes keep their mappings, new ones will build their own AOs
+    if (!shared_AO_owned_.empty()) unlink_shared_AO_segment(shared_AO_owned_);
+#endif
+}
 
 void DFHelper::prepare_blocking() {
     Qshells_ = aux_->nshell();
@@ -106,6 +149,10 @@ std::string DFHelper::start_filename(std::string start) {
     return name;
 }
 
+void DFHelper::mark_float_file(std::string name) {
+    float_files_.insert(std::get<0>(files_[name]));
+    float_files_.insert(std::get<1>(files_[name]));
+}
 void DFHelper::filename_maker(std::string name, size_t Q, size_t p, size_t q, size_t op) {
     auto pfilename = start_filename("dfh.p" + name);
     auto filename = start_filename("dfh" + name);
@@ -152,10 +199,11 @@ void DFHelper::initialize() {
     direct_iaQ_ = (!method_.compare("DIRECT_iaQ") ? true : false);
     direct_ = (!method_.compare("DIRECT") ? true : false);
 
-    // did we get enough memory for at least the metric?
-    if (naux_ * naux_ > memory_) {
+    // did we get enough memory for at least the metric (and the float staging buffers)?
+    if (naux_ * naux_ + (float_disk_ ? float_chunk_ : 0) > memory_) {
         std::stringstream error;
-        error << "DFHelper: The Coulomb metric requires at least " << naux_ * naux_ * 8 / (1024 * 1024 * 1024.0)
+        error << "DFHelper: The Coulomb metric requires at least "
+              << (naux_ * naux_ + (float_disk_ ? float_chunk_ : 0)) * 8 / (1024 * 1024 * 1024.0)
               << "[GiB].  We need that plus some more, but we only got " << memory_ * 8 / (1024 * 1024 * 1024.0)
               << "[GiB].";
         throw PSIEXCEPTION(error.str().c_str());
@@ -181,14 +229,30 @@ void DFHelper::initialize() {
         outfile->Printf("%s in-core AOs.\n\n", AO_core_ ? "Using" : "Turning off");
     }
 
+    if (pair_fitting_ && (!AO_core_ || direct_ || direct_iaQ_ || do_wK_)) {
+        throw PSIEXCEPTION("DFHelper: pair fitting requires the STORE method with in-core AOs, and no wK.");
+    }
+
     // prepare AOs for STORE method
     if (AO_core_) {
         if (do_wK_) {
             prepare_AO_wK_core();
+        } else if (pair_fitting_) {
+            prepare_pair_fitting();
+        } else if (!direct_ && !direct_iaQ_ && get_AO_cache() && attach_cached_AO()) {
+            // an earlier instance in this process built these exact AOs
+        } else if (shared_AO_ && !direct_ && !direct_iaQ_) {
+            // another process may already have built these exact AOs
+            if (!attach_shared_AO()) {
+                prepare_AO_core();
+                publish_shared_AO();
+            }
+            if (get_AO_cache()) publish_cached_AO();
         } else {  // It is possible to reformulate the expression for the
             //   coulomb matrix to save memory in case do_wK_ is
             //   is true, but do_K_ is false. This code isn't written
             prepare_AO_core();
+            if (get_AO_cache() && !direct_ && !direct_iaQ_) publish_cached_AO();
         }
     } else if (!direct_ && !direct_iaQ_) {
         prepare_AO();
@@ -218,6 +282,11 @@ void DFHelper::AO_core() {
         // total size of sparse AOs.
         // yes, a nested ternary operator
         required_core_size_ = (do_wK_ ? ( wcombine_ ? 2 * big_skips_[nbf_] : 3 * big_skips_[nbf_] ) : big_skips_[nbf_]);
+        // pair fitting keeps the block-compressed coefficients next to the unfitted AOs
+        if (pair_fitting_) {
+            prepare_pair_blocks();
+            required_core_size_ += pair_block_size_;
+        }
     }
 
     // Auxiliary metric
@@ -229,6 +298,16 @@ void DFHelper::AO_core() {
     // Tmp buffers
     required_core_size_ += 3 * nbf_ * nbf_ * Qshell_max_;
 
+    // pair-fitting K: per thread buffers of the first transform and the metric product, and the
+    // X and Y intermediates in blocks of pair_K_rows_ rows, as many as the memory left allows
+    if (pair_fitting_ && !direct_iaQ_) {
+        size_t row = naux_ * nbf_;
+        required_core_size_ += nthreads_ * (nbf_ * nbf_ + row);
+        size_t left = (memory_ > required_core_size_ ? memory_ - required_core_size_ : 0);
+        pair_K_rows_ = std::max((size_t)1, std::min(nbf_, left / (2 * row)));
+        required_core_size_ += 2 * pair_K_rows_ * row;
+    }
+
     // a fraction of memory to use, do we want it as an option?
     AO_core_ = true;
     if (memory_ < required_core_size_) AO_core_ = false;
@@ -543,6 +622,181 @@ void DFHelper::prepare_AO_core() {
     }
     // outfile->Printf("\n    ==> End AO Blocked Construction <==");
 }
+// Layout of a shared AO segment: this header, the full AO_key, padding to a multiple of 64 bytes,
+// then the fitted AOs. The segment name is only a hash of the key, so attaching compares the key.
+struct SharedAOHeader {
+    uint64_t magic;
+    uint64_t size;
+    uint64_t key_size;
+    uint64_t ready;
+};
+static constexpr uint64_t shared_AO_magic = 0x70733464666831ULL;
+static size_t shared_AO_offset(const std::string& key) {
+    return ((sizeof(SharedAOHeader) + key.size() + 63) / 64) * 64;
+}
+
+std::string DFHelper::AO_key() {
+    // everything that determines the contents of the fitted, screened AO tensor. Nuclear charges
+    // do not enter the integrals, so ghosted subsets in the full basis share a key.
+    std::stringstream key;
+    key << std::setprecision(12);
+    for (auto basis : {primary_, aux_}) {
+        key << basis->name() << ":" << basis->nbf() << ":" << basis->nshell() << ":";
+        for (int P = 0; P < basis->nshell(); P++) {
+            const GaussianShell& shell = basis->shell(P);
+            key << shell.am() << "," << shell.nprimitive() << "," << shell.exp(0) << "," << shell.coef(0) << ";";
+        }
+    }
+    auto mol = primary_->molecule();
+    for (int A = 0; A < mol->natom(); A++) {
+        key << mol->x(A) << "," << mol->y(A) << "," << mol->z(A) << ";";
+    }
+    key << cutoff_ << ":" << condition_ << ":" << mpower_ << ":" << big_skips_[nbf_];
+    return key.str();
+}
+std::string DFHelper::shared_AO_key() {
+    std::stringstream name;
+    name << "/psi4_dfh_" << std::hex << std::hash<std::string>{}(AO_key());
+    return name.str();
+}
+
+// The process-wide AO cache holds the most recently published tensor only
+struct AOCache {
+    bool enabled = false;
+    std::string key;
+    size_t size = 0;
+    std::shared_ptr<double> data;
+};
+static AOCache& AO_cache() {
+    static AOCache cache;
+    return cache;
+}
+void DFHelper::set_AO_cache(bool cache) {
+    AO_cache().enabled = cache;
+    if (!cache) {
+        AO_cache().key.clear();
+        AO_cache().size = 0;
+        AO_cache().data.reset();
+    }
+}
+bool DFHelper::get_AO_cache() { return AO_cache().enabled; }
+bool DFHelper::attach_cached_AO() {
+    AOCache& cache = AO_cache();
+    if (!cache.data) return false;
+
+    std::string key = AO_key();
+    if (cache.key != key || cache.size != big_skips_[nbf_]) {
+        // a different basis or geometry, do not hold two tensors at once
+        cache.key.clear();
+        cache.size = 0;
+        cache.data.reset();
+        return false;
+    }
+
+    // the instance keeps the tensor alive even if the cache moves on
+    std::shared_ptr<double> data = cache.data;
+    Ppq_ = std::unique_ptr<double[], std::function<void(double*)>>(data.get(), [data](double*) {});
+    AO_cache_hit_ = true;
+
+    if (print_lvl_ > 0) outfile->Printf("  DFHelper: Reusing cached in-core AOs.\n\n");
+    return true;
+}
+void DFHelper::publish_cached_AO() {
+    AOCache& cache = AO_cache();
+
+    // hand ownership of Ppq_ to the cache, whatever its deleter
+    auto deleter = Ppq_.get_deleter();
+    std::shared_ptr<double> data(Ppq_.release(), deleter);
+    Ppq_ = std::unique_ptr<double[], std::function<void(double*)>>(data.get(), [data](double*) {});
+
+    cache.key = AO_key();
+    cache.size = big_skips_[nbf_];
+    cache.data = data;
+}
+bool DFHelper::attach_shared_AO() {
+#ifdef _MSC_VER
+    return false;
+#else
+    std::string key = AO_key();
+    std::string name = shared_AO_key();
+    size_t size = big_skips_[nbf_];
+    size_t offset = shared_AO_offset(key);
+    size_t bytes = offset + size * sizeof(double);
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) || (size_t)st.st_size != bytes) {
+        close(fd);
+        return false;
+    }
+    void* base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    // the publisher sets ready last, so a ready segment is complete; a segment whose key differs
+    // (a hash collision, or a stale segment of another build) is left alone
+    auto header = static_cast<const SharedAOHeader*>(base);
+    const char* stored_key = static_cast<const char*>(base) + sizeof(SharedAOHeader);
+    bool ready = (header->magic == shared_AO_magic) && (header->size == size) &&
+                 __atomic_load_n(&header->ready, __ATOMIC_ACQUIRE) && (header->key_size == key.size()) &&
+                 !std::memcmp(stored_key, key.data(), key.size());
+    if (!ready) {
+        munmap(base, bytes);
+        return false;
+    }
+
+    // the mapping is read-only; the STORE method never writes its AOs after building them
+    double* data = reinterpret_cast<double*>(static_cast<char*>(base) + offset);
+    Ppq_ = std::unique_ptr<double[], std::function<void(double*)>>(data, [base, bytes](double*) { munmap(base, bytes); });
+    shared_AO_attached_ = true;
+
+    if (print_lvl_ > 0) outfile->Printf("  DFHelper: Attached in-core AOs from shared memory segment %s.\n\n", name.c_str());
+    return true;
+#endif
+}
+void DFHelper::publish_shared_AO() {
+#ifndef _MSC_VER
+    std::string key = AO_key();
+    std::string name = shared_AO_key();
+    size_t size = big_skips_[nbf_];
+    size_t offset = shared_AO_offset(key);
+    size_t bytes = offset + size * sizeof(double);
+
+    // if another process got there first, keep our private copy
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return;
+
+    register_shared_AO_segment(name);
+    if (ftruncate(fd, bytes)) {
+        close(fd);
+        unlink_shared_AO_segment(name);
+        return;
+    }
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        unlink_shared_AO_segment(name);
+        return;
+    }
+
+    auto header = static_cast<SharedAOHeader*>(base);
+    header->magic = shared_AO_magic;
+    header->size = size;
+    header->key_size = key.size();
+    std::memcpy(static_cast<char*>(base) + sizeof(SharedAOHeader), key.data(), key.size());
+    double* data = reinterpret_cast<double*>(static_cast<char*>(base) + offset);
+    std::memcpy(data, Ppq_.get(), size * sizeof(double));
+    __atomic_store_n(&header->ready, 1, __ATOMIC_RELEASE);
+
+    // drop the private copy, so that the node holds a single copy of the AOs
+    Ppq_ = std::unique_ptr<double[], std::function<void(double*)>>(data, [base, bytes](double*) { munmap(base, bytes); });
+    shared_AO_owned_ = name;
+
+    if (print_lvl_ > 0) outfile->Printf("  DFHelper: Published in-core AOs to shared memory segment %s.\n\n", name.c_str());
+#endif
+}
 void DFHelper::prepare_AO_wK_core() {
     // get each thread an eri object
     std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
@@ -765,8 +1019,23 @@ std::pair<size_t, size_t> DFHelper::Qshell_blocks_for_transform(const size_t mem
 
     return std::make_pair(largest, block_size);
 }
+bool DFHelper::JK_AO_prefetch_fits(size_t max_nocc, bool lr_symmetric) {
+    // same temporaries as Qshell_blocks_for_JK_build
+    size_t T1 = nbf_ * max_nocc;
+    size_t T2 = (lr_symmetric ? nbf_ * nbf_ : nbf_ * max_nocc);
+    size_t T3 = std::max(nthreads_ * nbf_ * nbf_, nthreads_ * nbf_ * max_nocc);
+
+    for (size_t i = 0; i < Qshells_; i++) {
+        size_t nQ = Qshell_aggs_[i + 1] - Qshell_aggs_[i];
+        size_t constraint = 2 * nQ * small_skips_[nbf_] + T1 * nQ + T3;
+        constraint += (lr_symmetric ? T2 : T2 * nQ);
+        if (constraint > memory_) return false;
+    }
+    return true;
+}
 std::tuple<size_t, size_t> DFHelper::Qshell_blocks_for_JK_build(std::vector<std::pair<size_t, size_t>>& b,
-                                                                size_t max_nocc, bool lr_symmetric) {
+                                                                size_t max_nocc, bool lr_symmetric,
+                                                                size_t nAO_buffers) {
     // strategy here:
     // 1. depending on lr_symmetric, T2 can either be the same as T1 or
     // it can just be used as a Jtmp.
@@ -794,7 +1063,7 @@ std::tuple<size_t, size_t> DFHelper::Qshell_blocks_for_JK_build(std::vector<std:
         tmpbs += end - begin + 1;
 
         // compute total memory used by aggregate block
-        size_t constraint = total_AO_buffer + T1 * tmpbs + T3;
+        size_t constraint = total_AO_buffer * (AO_core_ ? 1 : nAO_buffers) + T1 * tmpbs + T3;
         constraint += (lr_symmetric ? T2 : T2 * tmpbs);
 
         if (constraint > memory_ || i == Qshells_ - 1) {
@@ -905,43 +1174,54 @@ void DFHelper::put_tensor(std::string file, double* Mp, const size_t start1, con
                           const size_t stop2, std::string op) {
     size_t a0 = stop1 - start1 + 1;
     size_t a1 = stop2 - start2 + 1;
-    size_t A0 = std::get<0>(sizes_[file]);
     size_t A1 = std::get<1>(sizes_[file]) * std::get<2>(sizes_[file]);
     size_t st = A1 - a1;
 
+    // views handed out before this write keep their mapping, new ones map the file again
+    mapped_files_.erase(file);
+
     // begin stream
     FILE* fp = stream_check(file, op);
 
-    // adjust position
-    fseek(fp, (start1 * A1 + start2) * sizeof(double), SEEK_SET);
-
-    // is everything contiguous?
-    if (st == 0) {
-        size_t s = fwrite(&Mp[0], sizeof(double), a0 * a1, fp);
+    // single-precision files are narrowed here, in whichever thread does the write,
+    // through a staging buffer of at most float_chunk_ values (counted in float_io_memory)
+    bool narrow = float_files_.count(file);
+    size_t esize = (narrow ? sizeof(float) : sizeof(double));
+    std::vector<float> fbuf;
+    auto write = [&](const double* src, size_t n) {
+        size_t s = 1;
+        if (narrow) {
+            fbuf.resize(std::min(n, float_chunk_));
+            for (size_t done = 0; done < n && s; done += fbuf.size()) {
+                size_t m = std::min(n - done, fbuf.size());
+                std::copy_n(src + done, m, fbuf.data());
+                s = fwrite(fbuf.data(), sizeof(float), m, fp);
+            }
+        } else {
+            s = fwrite(src, sizeof(double), n, fp);
+        }
         if (!s) {
             std::stringstream error;
             error << "DFHelper:put_tensor: write error";
             throw PSIEXCEPTION(error.str().c_str());
         }
+    };
+
+    // adjust position
+    fseek(fp, (start1 * A1 + start2) * esize, SEEK_SET);
+
+    // is everything contiguous?
+    if (st == 0) {
+        write(&Mp[0], a0 * a1);
     } else {
-        for (size_t i = start1; i < stop1; i++) {
+        for (size_t i = 0; i < a0 - 1; i++) {
             // write
-            size_t s = fwrite(&Mp[i * a1], sizeof(double), a1, fp);
-            if (!s) {
-                std::stringstream error;
-                error << "DFHelper:put_tensor: write error";
-                throw PSIEXCEPTION(error.str().c_str());
-            }
+            write(&Mp[i * a1], a1);
             // advance stream
-            fseek(fp, st * sizeof(double), SEEK_CUR);
+            fseek(fp, st * esize, SEEK_CUR);
         }
         // manual last one
-        size_t s = fwrite(&Mp[(a0 - 1) * a1], sizeof(double), a1, fp);
-        if (!s) {
-            std::stringstream error;
-            error << "DFHelper:put_tensor: write error";
-            throw PSIEXCEPTION(error.str().c_str());
-        }
+        write(&Mp[(a0 - 1) * a1], a1);
     }
 }
 void DFHelper::put_tensor_AO(std::string file, double* Mp, size_t size, size_t start, std::string op) {
@@ -1015,51 +1295,66 @@ void DFHelper::get_tensor_(std::string file, double* b, const size_t start1, con
     std::tuple<size_t, size_t, size_t> sizes;
     sizes = (tsizes_.find(file) != tsizes_.end() ? tsizes_[file] : sizes_[file]);
 
-    size_t A0 = std::get<0>(sizes);
     size_t A1 = std::get<1>(sizes) * std::get<2>(sizes);
     size_t st = A1 - a1;
 
     // check stream
     FILE* fp = stream_check(file, "rb");
 
-    // adjust position
-    fseek(fp, (start1 * A1 + start2) * sizeof(double), SEEK_SET);
-
-    // is everything contiguous?
-    if (st == 0) {
-        size_t s = fread(&b[0], sizeof(double), a0 * a1, fp);
+    // single-precision files are widened here, in whichever thread does the read,
+    // through a staging buffer of at most float_chunk_ values (counted in float_io_memory)
+    bool widen = float_files_.count(file);
+    size_t esize = (widen ? sizeof(float) : sizeof(double));
+    std::vector<float> fbuf;
+    auto read = [&](double* dst, size_t n) {
+        size_t s = 1;
+        if (widen) {
+            fbuf.resize(std::min(n, float_chunk_));
+            for (size_t done = 0; done < n && s; done += fbuf.size()) {
+                size_t m = std::min(n - done, fbuf.size());
+                s = fread(fbuf.data(), sizeof(float), m, fp);
+                std::copy_n(fbuf.data(), m, dst + done);
+            }
+        } else {
+            s = fread(dst, sizeof(double), n, fp);
+        }
         if (!s) {
             std::stringstream error;
             error << "DFHelper:get_tensor: read error";
             throw PSIEXCEPTION(error.str().c_str());
         }
+    };
+
+    // adjust position
+    fseek(fp, (start1 * A1 + start2) * esize, SEEK_SET);
+
+    // is everything contiguous?
+    if (st == 0) {
+        read(&b[0], a0 * a1);
     } else {
         for (size_t i = 0; i < a0 - 1; i++) {
             // read
-            size_t s = fread(&b[i * a1], sizeof(double), a1, fp);
-            if (!s) {
-                std::stringstream error;
-                error << "DFHelper:get_tensor: read error";
-                throw PSIEXCEPTION(error.str().c_str());
-            }
+            read(&b[i * a1], a1);
             // advance stream
-            s = fseek(fp, st * sizeof(double), SEEK_CUR);
-            if (s) {
+            if (fseek(fp, st * esize, SEEK_CUR)) {
                 std::stringstream error;
                 error << "DFHelper:get_tensor: read error";
                 throw PSIEXCEPTION(error.str().c_str());
             }
         }
         // manual last one
-        size_t s = fread(&b[(a0 - 1) * a1], sizeof(double), a1, fp);
-        if (!s) {
-            std::stringstream error;
-            error << "DFHelper:get_tensor: read error";
-            throw PSIEXCEPTION(error.str().c_str());
-        }
+        read(&b[(a0 - 1) * a1], a1);
     }
 }
 
+std::vector<size_t> DFHelper::aux_shells_by_am(const size_t start, const size_t stop) {
+    std::vector<size_t> Pshells(stop - start + 1);
+    std::iota(Pshells.begin(), Pshells.end(), start);
+    std::stable_sort(Pshells.begin(), Pshells.end(),
+                     [this](size_t P, size_t Q) { return aux_->shell(P).am() < aux_->shell(Q).am(); });
+    return Pshells;
+}
+
 void DFHelper::compute_dense_Qpq_blocking_Q(const size_t start, const size_t stop, double* Mp,
                                             std::vector<std::shared_ptr<TwoBodyAOInt>> eri) {
     // Here, we compute dense AO integrals in the Qpq memory layout.
@@ -1086,6 +1381,9 @@ void DFHelper::compute_dense_Qpq_blocking_Q(const size_t start, const size_t sto
         buffer[rank] = eri[rank]->buffer();
     }
 
+    std::vector<size_t> Pshells = aux_shells_by_am(start, stop);
+
+    // Only NU <= MU is computed; each (MU, NU) pair also owns the (nu, mu) elements, so threads never collide
 #pragma omp parallel for schedule(guided) num_threads(nthreads_)
     for (size_t MU = 0; MU < pshells_; MU++) {
         int rank = 0;
@@ -1093,12 +1391,12 @@ void DFHelper::compute_dense_Qpq_blocking_Q(const size_t start, const size_t sto
         rank = omp_get_thread_num();
 #endif
         size_t nummu = primary_->shell(MU).nfunction();
-        for (size_t NU = 0; NU < pshells_; NU++) {
+        for (size_t NU = 0; NU <= MU; NU++) {
             size_t numnu = primary_->shell(NU).nfunction();
             if (!schwarz_shell_mask_[MU * pshells_ + NU]) {
                 continue;
             }
-            for (size_t Pshell = start; Pshell <= stop; Pshell++) {
+            for (size_t Pshell : Pshells) {
                 size_t PHI = aux_->shell(Pshell).function_index();
                 size_t numP = aux_->shell(Pshell).nfunction();
                 eri[rank]->compute_shell(Pshell, 0, MU, NU);
@@ -1110,10 +1408,11 @@ void DFHelper::compute_dense_Qpq_blocking_Q(const size_t start, const size_t sto
                         if (!schwarz_fun_index_[omu * nbf_ + onu]) {
                             continue;
                         }
+                        double* Mmn = Mp + (PHI - begin) * nbf_ * nbf_ + omu * nbf_ + onu;
+                        double* Mnm = Mp + (PHI - begin) * nbf_ * nbf_ + onu * nbf_ + omu;
+                        const double* buf = buffer[rank] + mu * numnu + nu;
                         for (size_t P = 0; P < numP; P++) {
-                            Mp[(PHI + P - begin) * nbf_ * nbf_ + omu * nbf_ + onu] =
-                                Mp[(PHI + P - begin) * nbf_ * nbf_ + onu * nbf_ + omu] =
-                                    buffer[rank][P * nummu * numnu + mu * numnu + nu];
+                            Mmn[P * nbf_ * nbf_] = Mnm[P * nbf_ * nbf_] = buf[P * nummu * numnu];
                         }
                     }
                 }
@@ -1142,6 +1441,10 @@ void DFHelper::compute_sparse_pQq_blocking_Q(const size_t start, const size_t st
         buffer[rank] = eri[rank]->buffer();
     }
 
+    std::vector<size_t> Pshells = aux_shells_by_am(start, stop);
+
+    // Only NU <= MU is computed, and each integral is written straight into both of its pruned slots;
+    // the (nu, mu) slots belong to this (MU, NU) pair alone, so threads never collide
 #pragma omp parallel for schedule(guided) num_threads(nthreads_)
     for (size_t MU = 0; MU < pshells_; MU++) {
         int rank = 0;
@@ -1149,12 +1452,12 @@ void DFHelper::compute_sparse_pQq_blocking_Q(const size_t start, const size_t st
         rank = omp_get_thread_num();
 #endif
         size_t nummu = primary_->shell(MU).nfunction();
-        for (size_t NU = 0; NU < pshells_; NU++) {
+        for (size_t NU = 0; NU <= MU; NU++) {
             size_t numnu = primary_->shell(NU).nfunction();
             if (!schwarz_shell_mask_[MU * pshells_ + NU]) {
                 continue;
             }
-            for (size_t Pshell = start; Pshell <= stop; Pshell++) {
+            for (size_t Pshell : Pshells) {
                 size_t PHI = aux_->shell(Pshell).function_index();
                 size_t numP = aux_->shell(Pshell).nfunction();
                 eri[rank]->compute_shell(Pshell, 0, MU, NU);
@@ -1163,13 +1466,22 @@ void DFHelper::compute_sparse_pQq_blocking_Q(const size_t start, const size_t st
                     size_t omu = primary_->shell(MU).function_index() + mu;
                     for (size_t nu = 0; nu < numnu; nu++) {
                         size_t onu = primary_->shell(NU).function_index() + nu;
-                        if (!schwarz_fun_index_[omu * nbf_ + onu]) {
-                            continue;
+                        size_t mn = schwarz_fun_index_[omu * nbf_ + onu];
+                        size_t nm = schwarz_fun_index_[onu * nbf_ + omu];
+                        const double* buf = buffer[rank] + mu * numnu + nu;
+                        if (mn) {
+                            double* Mmn = Mp + (big_skips_[omu] * block_size) / naux_ +
+                                          (PHI - begin) * small_skips_[omu] + mn - 1;
+                            for (size_t P = 0; P < numP; P++) {
+                                Mmn[P * small_skips_[omu]] = buf[P * nummu * numnu];
+                            }
                         }
-                        for (size_t P = 0; P < numP; P++) {
-                            Mp[(big_skips_[omu] * block_size) / naux_ + (PHI + P - begin) * small_skips_[omu] +
-                               schwarz_fun_index_[omu * nbf_ + onu] - 1] =
-                                buffer[rank][P * nummu * numnu + mu * numnu + nu];
+                        if (nm && omu != onu) {
+                            double* Mnm = Mp + (big_skips_[onu] * block_size) / naux_ +
+                                          (PHI - begin) * small_skips_[onu] + nm - 1;
+                            for (size_t P = 0; P < numP; P++) {
+                                Mnm[P * small_skips_[onu]] = buf[P * nummu * numnu];
+                            }
                         }
                     }
                 }
@@ -1522,19 +1834,26 @@ void DFHelper::contract_metric_Qpq(std::string file, double* metp, double* Mp, d
 
     std::string op = "wb";
     std::vector<std::pair<size_t, size_t>> steps;
-    metric_contraction_blocking(steps, l, Q * r, total_mem, 2, naux_ * naux_);
-
-    for (size_t i = 0; i < steps.size(); i++) {
-        size_t begin = std::get<0>(steps[i]);
-        size_t end = std::get<1>(steps[i]);
-        size_t bs = end - begin + 1;
 
-        get_tensor_(getf, Mp, 0, Q - 1, begin * r, (end + 1) * r - 1);
-        timer_on("DFH: Total Workflow");
-        C_DGEMM('T', 'N', bs * r, Q, Q, 1.0, Mp, bs * r, metp, Q, 0.0, Fp, Q);
-        timer_off("DFH: Total Workflow");
-        put_tensor(putf, Fp, begin, end, 0, r * Q - 1, op);
+    // overlap the disk traffic with the contractions if a block still fits in half the buffers
+    bool double_buffer = (l > 1 && Q * r <= total_mem / 2);
+    metric_contraction_blocking(steps, l, Q * r, (double_buffer ? total_mem / 2 : total_mem), 2, naux_ * naux_);
+    double_buffer = double_buffer && steps.size() > 1;
+    if (double_buffer) {
+        stream_check(getf, "rb");
+        stream_check(putf, op);
     }
+
+    pipeline_metric_steps(
+        steps, Mp, Fp, total_mem / 2, double_buffer,
+        [&](size_t begin, size_t end, double* M) { get_tensor_(getf, M, 0, Q - 1, begin * r, (end + 1) * r - 1); },
+        [&](size_t begin, size_t end, double* M, double* F) {
+            size_t bs = end - begin + 1;
+            timer_on("DFH: Total Workflow");
+            C_DGEMM('T', 'N', bs * r, Q, Q, 1.0, M, bs * r, metp, Q, 0.0, F, Q);
+            timer_off("DFH: Total Workflow");
+        },
+        [&](size_t begin, size_t end, double* F) { put_tensor(putf, F, begin, end, 0, r * Q - 1, op); });
 }
 
 void DFHelper::contract_metric(std::string file, double* metp, double* Mp, double* Fp, const size_t total_mem) {
@@ -1547,51 +1866,101 @@ void DFHelper::contract_metric(std::string file, double* metp, double* Mp, doubl
     std::string op = "wb";
     std::vector<std::pair<size_t, size_t>> steps;
 
+    // overlap the disk traffic with the contractions if a block still fits in half the buffers
+    size_t blocking_index = (std::get<2>(transf_[file]) ? a0 : a1);
+    size_t block_sizes = (std::get<2>(transf_[file]) ? a1 * a2 : a0 * a2);
+    bool double_buffer = (blocking_index > 1 && block_sizes <= total_mem / 2);
+    size_t step_mem = (double_buffer ? total_mem / 2 : total_mem);
+
     // contract in steps
     if (std::get<2>(transf_[file])) {
         // determine blocking
         // both pqQ and pQq formats block through p, which is index 0
-        metric_contraction_blocking(steps, a0, a1 * a2, total_mem, 2, naux_ * naux_);
+        metric_contraction_blocking(steps, a0, a1 * a2, step_mem, 2, naux_ * naux_);
+    } else {
+        // determine blocking
+        // the Qpq format blocks through p, which is index 1
+        metric_contraction_blocking(steps, a1, a0 * a2, step_mem, 2, naux_ * naux_);
+    }
+    double_buffer = double_buffer && steps.size() > 1;
+    if (double_buffer) {
+        stream_check(getf, "rb");
+        stream_check(putf, op);
+    }
 
+    if (std::get<2>(transf_[file])) {
         // grab val, the inner contractions are different depending on the form
         size_t val = std::get<2>(transf_[file]);
-        for (size_t i = 0; i < steps.size(); i++) {
-            size_t begin = std::get<0>(steps[i]);
-            size_t end = std::get<1>(steps[i]);
-            size_t bs = end - begin + 1;
-
-            get_tensor_(getf, Mp, begin, end, 0, a1 * a2 - 1);
-            timer_on("DFH: Total Workflow");
+        pipeline_metric_steps(
+            steps, Mp, Fp, total_mem / 2, double_buffer,
+            [&](size_t begin, size_t end, double* M) { get_tensor_(getf, M, begin, end, 0, a1 * a2 - 1); },
+            [&](size_t begin, size_t end, double* M, double* F) {
+                size_t bs = end - begin + 1;
+                timer_on("DFH: Total Workflow");
 
-            if (val == 2) {
-                C_DGEMM('N', 'N', bs * a1, a2, a2, 1.0, Mp, a2, metp, a2, 0.0, Fp, a2);
-            } else {
+                if (val == 2) {
+                    C_DGEMM('N', 'N', bs * a1, a2, a2, 1.0, M, a2, metp, a2, 0.0, F, a2);
+                } else {
 #pragma omp parallel for num_threads(nthreads_)
-                for (size_t i = 0; i < bs; i++) {
-                    C_DGEMM('N', 'N', a1, a2, a1, 1.0, metp, a1, &Mp[i * a1 * a2], a2, 0.0, &Fp[i * a1 * a2], a2);
+                    for (size_t i = 0; i < bs; i++) {
+                        C_DGEMM('N', 'N', a1, a2, a1, 1.0, metp, a1, &M[i * a1 * a2], a2, 0.0, &F[i * a1 * a2], a2);
+                    }
                 }
-            }
-            timer_off("DFH: Total Workflow");
-            put_tensor(putf, Fp, begin, end, 0, a1 * a2 - 1, op);
-        }
+                timer_off("DFH: Total Workflow");
+            },
+            [&](size_t begin, size_t end, double* F) { put_tensor(putf, F, begin, end, 0, a1 * a2 - 1, op); });
 
     } else {
-        // determine blocking
-        // the Qpq format blocks through p, which is index 1
-        metric_contraction_blocking(steps, a1, a0 * a2, total_mem, 2, naux_ * naux_);
+        pipeline_metric_steps(
+            steps, Mp, Fp, total_mem / 2, double_buffer,
+            [&](size_t begin, size_t end, double* M) {
+                get_tensor_(getf, M, 0, a0 - 1, begin * a2, (end + 1) * a2 - 1);
+            },
+            [&](size_t begin, size_t end, double* M, double* F) {
+                size_t bs = end - begin + 1;
+                timer_on("DFH: Total Workflow");
+                C_DGEMM('N', 'N', a0, bs * a2, a0, 1.0, metp, a0, M, bs * a2, 0.0, F, bs * a2);
+                timer_off("DFH: Total Workflow");
+            },
+            [&](size_t begin, size_t end, double* F) {
+                put_tensor(putf, F, 0, a0 - 1, begin * a2, (end + 1) * a2 - 1, op);
+            });
+    }
+}
 
-        for (size_t i = 0; i < steps.size(); i++) {
-            size_t begin = std::get<0>(steps[i]);
-            size_t end = std::get<1>(steps[i]);
-            size_t bs = end - begin + 1;
+void DFHelper::pipeline_metric_steps(const std::vector<std::pair<size_t, size_t>>& steps, double* Mp, double* Fp,
+                                     size_t half, bool double_buffer,
+                                     const std::function<void(size_t, size_t, double*)>& get,
+                                     const std::function<void(size_t, size_t, double*, double*)>& contract,
+                                     const std::function<void(size_t, size_t, double*)>& put) {
+    if (!double_buffer) {
+        for (const auto& step : steps) {
+            get(step.first, step.second, Mp);
+            contract(step.first, step.second, Mp, Fp);
+            put(step.first, step.second, Fp);
+        }
+        return;
+    }
 
-            get_tensor_(getf, Mp, 0, a0 - 1, begin * a2, (end + 1) * a2 - 1);
-            timer_on("DFH: Total Workflow");
-            C_DGEMM('N', 'N', a0, bs * a2, a0, 1.0, metp, a0, Mp, bs * a2, 0.0, Fp, bs * a2);
-            timer_off("DFH: Total Workflow");
-            put_tensor(putf, Fp, 0, a0 - 1, begin * a2, (end + 1) * a2 - 1, op);
+    // block i is read into M[i % 2] and contracted into F[i % 2]. The read of block i + 1 and the
+    // write of block i - 1 touch the other halves, and futures carry any I/O errors back here.
+    double* M[2] = {Mp, Mp + half};
+    double* F[2] = {Fp, Fp + half};
+    std::future<void> reader, writer;
+
+    get(steps[0].first, steps[0].second, M[0]);
+    for (size_t i = 0; i < steps.size(); i++) {
+        if (reader.valid()) reader.get();
+        if (i + 1 < steps.size()) {
+            reader = std::async(std::launch::async, get, steps[i + 1].first, steps[i + 1].second, M[(i + 1) % 2]);
         }
+
+        contract(steps[i].first, steps[i].second, M[i % 2], F[i % 2]);
+
+        if (writer.valid()) writer.get();
+        writer = std::async(std::launch::async, put, steps[i].first, steps[i].second, F[i % 2]);
     }
+    writer.get();
 }
 
 void DFHelper::contract_metric_AO_core(double* Qpq, double* metp) {
@@ -1704,6 +2073,7 @@ void DFHelper::add_transformation(std::string name, std::string key1, std::strin
     size_t a1 = std::get<1>(spaces_[key1]);
     size_t a2 = std::get<1>(spaces_[key2]);
     filename_maker(name, naux_, a1, a2, op);
+    if (float_disk_) mark_float_file(name);
 }
 void DFHelper::clear_spaces() {
     // clear spaces
@@ -1734,6 +2104,7 @@ void DFHelper::clear_all() {
     files_.clear();
     sizes_.clear();
     tsizes_.clear();
+    float_files_.clear();
     clear_transformations();
 }
 
@@ -1829,9 +2200,20 @@ void DFHelper::transform() {
 
     // get Q blocking scheme
     std::vector<std::pair<size_t, size_t>> Qsteps;
-    std::pair<size_t, size_t> Qlargest = Qshell_blocks_for_transform(memory_, wtmp, wfinal, Qsteps);
+    size_t mem = memory_ - float_io_memory();
+    std::pair<size_t, size_t> Qlargest = Qshell_blocks_for_transform(mem, wtmp, wfinal, Qsteps);
     size_t max_block = std::get<1>(Qlargest);
 
+    // read the next AO block on a helper thread while the current one is transformed, if a second copy fits
+    size_t extra = (hold_met_ ? naux_ * naux_ : 0);
+    bool prefetch_AOs = !direct_iaQ_ && !direct_ && !AO_core_ && Qsteps.size() > 1 &&
+                        2 * std::get<0>(Qlargest) + (wtmp * nbf_ + 2 * wfinal) * max_block + extra <= mem;
+
+    // the MO streams must exist before the helper thread looks up the AO stream
+    if (prefetch_AOs && !MO_core_) {
+        for (const auto& name : order_) stream_check(std::get<1>(files_[name]), "wb");
+    }
+
     // prepare eri and C buffers per thread
     size_t nthread = nthreads_;
     std::vector<std::vector<double>> C_buffers(nthreads_);
@@ -1850,11 +2232,27 @@ void DFHelper::transform() {
         if (rank) eri[rank] = std::shared_ptr<TwoBodyAOInt>(eri.front()->clone());
     }
 
+    // With in-core MOs and unfitted AOs, each Q block is contracted with the metric as soon as it is
+    // transformed and accumulated into the final tensors, instead of a second pass over a full copy
+    bool fused_metric = MO_core_ && (direct_ || direct_iaQ_);
+    std::unique_ptr<double[]> fused_metric_buffer;
+    double* metp = nullptr;
+    if (fused_metric) {
+        if (!hold_met_) {
+            fused_metric_buffer = std::unique_ptr<double[]>(new double[naux_ * naux_]);
+            metp = fused_metric_buffer.get();
+            std::string filename = return_metfile(mpower_);
+            get_tensor_(std::get<0>(files_[filename]), metp, 0, naux_ - 1, 0, naux_ - 1);
+        } else
+            metp = metric_prep_core(mpower_);
+    }
+
     // allocate in-core transformed integrals if necessary
     if (MO_core_) {
         for (auto& kv : transf_) {
             size_t size = std::get<1>(spaces_[std::get<0>(kv.second)]) * std::get<1>(spaces_[std::get<1>(kv.second)]);
             transf_core_[kv.first] = std::unique_ptr<double[]>(new double[size * naux_]);
+            if (fused_metric) fill(transf_core_[kv.first].get(), size * naux_, 0.0);
         }
     }
 
@@ -1867,7 +2265,7 @@ void DFHelper::transform() {
         double* Tp = T.get();
         double* Fp = F.get();
         double* Np;
-        if (!MO_core_) {
+        if (!MO_core_ || fused_metric) {
             N = std::unique_ptr<double[]>(new double[max_block * wfinal]);
             Np = N.get();
         }
@@ -1882,6 +2280,15 @@ void DFHelper::transform() {
             Mp = Ppq_.get();
         }
 
+        // second AO buffer, filled by the prefetch thread; its future carries read errors back here
+        std::unique_ptr<double[]> M_next;
+        double* M_nextp = nullptr;
+        std::future<void> prefetch;
+        if (prefetch_AOs) {
+            M_next = std::unique_ptr<double[]>(new double[std::get<0>(Qlargest)]);
+            M_nextp = M_next.get();
+        }
+
         // transform in steps, blocking over the auxiliary basis (Q blocks)
         for (size_t j = 0, bcount = 0, block_size; j < Qsteps.size(); j++, bcount += block_size) {
             // Qshell step info
@@ -1906,6 +2313,20 @@ void DFHelper::transform() {
                 timer_on("DFH: Total Workflow");
                 compute_sparse_pQq_blocking_Q(start, stop, Mp, eri);
                 timer_off("DFH: Total Workflow");
+            } else if (prefetch_AOs) {
+                timer_on("DFH: Grabbing AOs");
+                // wait for this block, then start on the next one
+                if (prefetch.valid()) {
+                    prefetch.get();
+                    std::swap(Mp, M_nextp);
+                } else {
+                    grab_AO(start, stop, Mp);
+                }
+                if (j + 1 < Qsteps.size()) {
+                    prefetch = std::async(std::launch::async, &DFHelper::grab_AO, this, std::get<0>(Qsteps[j + 1]),
+                                          std::get<1>(Qsteps[j + 1]), M_nextp);
+                }
+                timer_off("DFH: Grabbing AOs");
             } else {
                 timer_on("DFH: Grabbing AOs");
                 grab_AO(start, stop, Mp);
@@ -1951,7 +2372,9 @@ void DFHelper::transform() {
                     size_t wsize = std::get<1>(I);
 
                     // grab in-core pointer
-                    if (direct_iaQ_ && MO_core_) {
+                    if (fused_metric) {
+                        ;  // blocks stay in F/N until the metric contraction
+                    } else if (direct_iaQ_ && MO_core_) {
                         Fp = transf_core_[order_[count + k]].get();
                     } else if (MO_core_) {
                         Np = transf_core_[order_[count + k]].get();
@@ -1963,7 +2386,7 @@ void DFHelper::transform() {
                     timer_on("DFH: Total Transform");
                     timer_on("DFH: 2nd Contraction");
                     if (direct_iaQ_) {
-                        size_t bump = (MO_core_ ? begin * wsize * bsize : 0);
+                        size_t bump = (MO_core_ && !fused_metric ? begin * wsize * bsize : 0);
                         // (pw)(Q|pb)->(Q|bw)
                         if (bleft) {
 #pragma omp parallel for num_threads(nthreads_)
@@ -1989,6 +2412,12 @@ void DFHelper::transform() {
                     timer_off("DFH: Total Workflow");
 
                     // put the transformations away
+                    if (fused_metric) {
+                        timer_on("DFH: Metric Contractions");
+                        contract_metric_block(begin, block_size, wsize, bsize, metp, Fp, Np, count + k, bleft);
+                        timer_off("DFH: Metric Contractions");
+                        continue;
+                    }
                     timer_on("DFH: MO to disk, " + transf_name);
                     if (direct_iaQ_) {
                         put_transformations_Qpq(begin, end, wsize, bsize, Fp, count + k, bleft);
@@ -2012,10 +2441,10 @@ void DFHelper::transform() {
         Ppq_.reset();
     }
 
-    if (direct_iaQ_ || direct_) {
+    // with in-core MOs the metric was already applied block by block
+    if ((direct_iaQ_ || direct_) && !fused_metric) {
         // prepare metric
         std::unique_ptr<double[]> metric;
-        double* metp;
         if (!hold_met_) {
             metric = std::unique_ptr<double[]>(new double[naux_ * naux_]);
             metp = metric.get();
@@ -2024,89 +2453,81 @@ void DFHelper::transform() {
         } else
             metp = metric_prep_core(mpower_);
 
-        if (direct_iaQ_) {
-            if (MO_core_) {
-                std::unique_ptr<double[]> N(new double[naux_ * wfinal]);
-                double* Np = N.get();
-
-                for (auto& kv : transf_core_) {
-                    size_t l = std::get<0>(sizes_[std::get<1>(files_[kv.first])]);
-                    size_t r = std::get<1>(sizes_[std::get<1>(files_[kv.first])]);
-                    size_t Q = std::get<2>(sizes_[std::get<1>(files_[kv.first])]);
-
-                    double* Lp = kv.second.get();
-                    C_DCOPY(l * r * Q, Lp, 1, Np, 1);
+        // total size allowed, in doubles, less the float staging buffers.
+        // note that memory - naux_2 cannot be negative (handled in init)
+        size_t AO_mem = (direct_iaQ_ ? naux_ * nbf_ * nbf_ : big_skips_[nbf_]);
+        size_t rem_mem = memory_ - float_io_memory() - (AO_core_ && !release_core_AO_before_metric_ ? AO_mem : 0);
+        size_t total_mem =
+            (rem_mem > wfinal * naux_ * 2 + naux_ * naux_ ? wfinal * naux_ : (rem_mem - naux_ * naux_) / 2);
 
-                    // (Q|ia) (PQ) -> (ia|Q)
-                    C_DGEMM('T', 'N', l * r, Q, Q, 1.0, Np, l * r, metp, Q, 0.0, Lp, Q);
-                }
+        std::unique_ptr<double[]> M(new double[total_mem]);
+        std::unique_ptr<double[]> F(new double[total_mem]);
+        double* Mp = M.get();
+        double* Fp = F.get();
 
+        for (std::vector<std::string>::iterator itr = order_.begin(); itr != order_.end(); itr++) {
+            if (direct_iaQ_) {
+                contract_metric_Qpq(*itr, metp, Mp, Fp, total_mem);
             } else {
-                // total size allowed, in doubles
-                size_t rem_mem = memory_ - (AO_core_ && !release_core_AO_before_metric_ ? naux_ * nbf_ * nbf_ : 0);
-                size_t total_mem =
-                    (rem_mem > wfinal * naux_ * 2 + naux_ * naux_ ? wfinal * naux_ : (rem_mem - naux_ * naux_) / 2);
-
-                std::unique_ptr<double[]> M(new double[total_mem]);
-                std::unique_ptr<double[]> F(new double[total_mem]);
-                double* Mp = M.get();
-                double* Fp = F.get();
-                for (std::vector<std::string>::iterator itr = order_.begin(); itr != order_.end(); itr++)
-                    contract_metric_Qpq(*itr, metp, Mp, Fp, total_mem);
+                contract_metric(*itr, metp, Mp, Fp, total_mem);
             }
+        }
+    }
+    timer_off("DFH: Metric Contractions");
+    timer_off("DFH: transform()");
+    transformed_ = true;
 
-        } else if (direct_) {
-            if (!MO_core_) {
-                // total size allowed, in doubles.
-                // note that memory - naux_2 cannot be negative (handled in init)
-                size_t rem_mem = memory_ - (AO_core_ && !release_core_AO_before_metric_ ? big_skips_[nbf_] : 0);
-                size_t total_mem =
-                    (rem_mem > wfinal * naux_ * 2 + naux_ * naux_ ? wfinal * naux_ : (rem_mem - naux_ * naux_) / 2);
-
-                std::unique_ptr<double[]> M(new double[total_mem]);
-                std::unique_ptr<double[]> F(new double[total_mem]);
-                double* Mp = M.get();
-                double* Fp = F.get();
-
-                for (std::vector<std::string>::iterator itr = order_.begin(); itr != order_.end(); itr++)
-                    contract_metric(*itr, metp, Mp, Fp, total_mem);
-
-            } else {
-                std::unique_ptr<double[]> N(new double[naux_ * wfinal]);
-                double* Np = N.get();
-
-                for (auto& kv : transf_core_) {
-                    size_t a0 = std::get<0>(sizes_[std::get<1>(files_[kv.first])]);
-                    size_t a1 = std::get<1>(sizes_[std::get<1>(files_[kv.first])]);
-                    size_t a2 = std::get<2>(sizes_[std::get<1>(files_[kv.first])]);
+    if (debug_) {
+        outfile->Printf("Exiting DFHelper::transform\n");
+    }
+}
 
-                    double* Lp = kv.second.get();
-                    C_DCOPY(a0 * a1 * a2, Lp, 1, Np, 1);
+void DFHelper::contract_metric_block(size_t begin, size_t block_size, size_t wsize, size_t bsize, double* metp,
+                                     double* Fp, double* Np, size_t ind, bool bleft) {
+    double* Lp = transf_core_[order_[ind]].get();
 
-                    // the following differs depending on the form being outputted
-                    // 0 : Qpq -- 1 : pQq -- 2 : pqQ
+    if (direct_iaQ_) {
+        // (Q|pq) block (QP) -> (pq|P)
+        size_t pq = wsize * bsize;
+        C_DGEMM('T', 'N', pq, naux_, block_size, 1.0, Fp, pq, &metp[begin * naux_], naux_, 1.0, Lp, naux_);
+        return;
+    }
 
-                    if (std::get<2>(transf_[kv.first]) == 2) {
-                        C_DGEMM('N', 'N', a0 * a1, a2, a2, 1.0, Np, a2, metp, a2, 0.0, Lp, a2);
-                    } else if (std::get<2>(transf_[kv.first]) == 0) {
-                        C_DGEMM('N', 'N', a0, a1 * a2, a0, 1.0, metp, naux_, Np, a1 * a2, 0.0, Lp, a1 * a2);
-                    } else {
+    // (w|Qb) -> the requested form with block_size in place of naux
+    size_t np = (bleft ? bsize : wsize);
+    size_t nq = (bleft ? wsize : bsize);
+    size_t form = std::get<2>(transf_[order_[ind]]);
 #pragma omp parallel for num_threads(nthreads_)
-                        for (size_t i = 0; i < a0; i++) {
-                            C_DGEMM('N', 'N', a1, a2, a1, 1.0, metp, naux_, &Np[i * a1 * a2], a2, 0.0, &Lp[i * a1 * a2],
-                                    a2);
-                        }
-                    }
+    for (size_t z = 0; z < wsize; z++) {
+        for (size_t x = 0; x < block_size; x++) {
+            for (size_t y = 0; y < bsize; y++) {
+                size_t p = (bleft ? y : z);
+                size_t q = (bleft ? z : y);
+                size_t target;
+                if (form == 0) {
+                    target = x * np * nq + p * nq + q;
+                } else if (form == 1) {
+                    target = p * block_size * nq + x * nq + q;
+                } else {
+                    target = p * nq * block_size + q * block_size + x;
                 }
+                Np[target] = Fp[z * block_size * bsize + x * bsize + y];
             }
         }
     }
-    timer_off("DFH: Metric Contractions");
-    timer_off("DFH: transform()");
-    transformed_ = true;
 
-    if (debug_) {
-        outfile->Printf("Exiting DFHelper::transform\n");
+    // accumulate (PQ) over the Q of this block
+    if (form == 0) {
+        C_DGEMM('N', 'N', naux_, np * nq, block_size, 1.0, &metp[begin], naux_, Np, np * nq, 1.0, Lp, np * nq);
+    } else if (form == 2) {
+        C_DGEMM('N', 'N', np * nq, naux_, block_size, 1.0, Np, block_size, &metp[begin * naux_], naux_, 1.0, Lp,
+                naux_);
+    } else {
+#pragma omp parallel for num_threads(nthreads_)
+        for (size_t p = 0; p < np; p++) {
+            C_DGEMM('N', 'N', naux_, nq, block_size, 1.0, &metp[begin], naux_, &Np[p * block_size * nq], nq, 1.0,
+                    &Lp[p * naux_ * nq], nq);
+        }
     }
 }
 
@@ -2136,6 +2557,73 @@ void DFHelper::first_transform_pQq(size_t bsize, size_t bcount, size_t block_siz
     }
 }
 
+void DFHelper::first_transform_pQq_sparse(size_t bsize, size_t bcount, size_t block_size, double* Mp, double* Tp,
+                                          double* Bp, std::vector<std::vector<double>>& C_buffers) {
+    // As first_transform_pQq, but only the columns of B with a coefficient above K_sparse_tol_
+    // on the significant partners of p enter the contraction. The skipped columns of (Qb) are zero.
+    std::vector<std::vector<double>> T_buffers(nthreads_);
+    std::vector<std::vector<size_t>> active_buffers(nthreads_);
+
+#pragma omp parallel num_threads(nthreads_)
+    {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        T_buffers[rank].resize(block_size * bsize);
+        active_buffers[rank].reserve(bsize);
+
+#pragma omp for schedule(guided)
+        for (size_t k = 0; k < nbf_; k++) {
+            size_t sp_size = small_skips_[k];
+            size_t jump = (AO_core_ ? big_skips_[k] + bcount * sp_size : (big_skips_[k] * block_size) / naux_);
+
+            // find the columns of B that touch the significant partners of k
+            std::vector<double> col_max(bsize, 0.0);
+            for (size_t m = 0; m < nbf_; m++) {
+                if (schwarz_fun_index_[k * nbf_ + m]) {
+                    for (size_t b = 0; b < bsize; b++) col_max[b] = std::max(col_max[b], std::fabs(Bp[m * bsize + b]));
+                }
+            }
+            auto& active = active_buffers[rank];
+            active.clear();
+            for (size_t b = 0; b < bsize; b++) {
+                if (col_max[b] > K_sparse_tol_) active.push_back(b);
+            }
+            size_t nactive = active.size();
+
+            double* Tkp = &Tp[k * block_size * bsize];
+            if (!nactive) {
+                std::fill_n(Tkp, block_size * bsize, 0.0);
+                continue;
+            }
+
+            // gather the truncated, compacted transformation matrix
+            for (size_t m = 0, sp_count = 0; m < nbf_; m++) {
+                if (schwarz_fun_index_[k * nbf_ + m]) {
+                    for (size_t b = 0; b < nactive; b++) {
+                        C_buffers[rank][sp_count * nactive + b] = Bp[m * bsize + active[b]];
+                    }
+                    sp_count++;
+                }
+            }
+
+            // (Qm)(mb)->(Qb), for the active b only
+            double* T2kp = T_buffers[rank].data();
+            C_DGEMM('N', 'N', block_size, nactive, sp_size, 1.0, &Mp[jump], sp_size, &C_buffers[rank][0], nactive, 0.0,
+                    T2kp, nactive);
+
+            // scatter back out to the dense (Qb) layout
+            std::fill_n(Tkp, block_size * bsize, 0.0);
+            for (size_t Q = 0; Q < block_size; Q++) {
+                for (size_t b = 0; b < nactive; b++) {
+                    Tkp[Q * bsize + active[b]] = T2kp[Q * nactive + b];
+                }
+            }
+        }
+    }
+}
+
 void DFHelper::put_transformations_Qpq(int begin, int end, int wsize, int bsize, double* Fp, int ind, bool bleft) {
     // incoming transformed integrals to this function are in a Qpq format.
     // if MO_core is on, do nothing
@@ -2509,6 +2997,106 @@ SharedMatrix DFHelper::get_tensor(std::string name, std::vector<size_t> t0, std:
     return M;
 }
 
+// Return a zero-copy view
+DFHelper::TensorView DFHelper::view_tensor(std::string name) {
+    check_file_key(name);
+    std::string filename = std::get<1>(files_[name]);
+    std::tuple<size_t, size_t, size_t> sizes;
+    sizes = (tsizes_.find(filename) != tsizes_.end() ? tsizes_[filename] : sizes_[filename]);
+
+    return view_tensor(name, {0, std::get<0>(sizes)}, {0, std::get<1>(sizes)}, {0, std::get<2>(sizes)});
+}
+DFHelper::TensorView DFHelper::view_tensor(std::string name, std::vector<size_t> a1) {
+    check_file_key(name);
+    std::string filename = std::get<1>(files_[name]);
+    std::tuple<size_t, size_t, size_t> sizes;
+    sizes = (tsizes_.find(filename) != tsizes_.end() ? tsizes_[filename] : sizes_[filename]);
+
+    return view_tensor(name, a1, {0, std::get<1>(sizes)}, {0, std::get<2>(sizes)});
+}
+DFHelper::TensorView DFHelper::view_tensor(std::string name, std::vector<size_t> a1, std::vector<size_t> a2) {
+    check_file_key(name);
+    std::string filename = std::get<1>(files_[name]);
+    std::tuple<size_t, size_t, size_t> sizes;
+    sizes = (tsizes_.find(filename) != tsizes_.end() ? tsizes_[filename] : sizes_[filename]);
+
+    return view_tensor(name, a1, a2, {0, std::get<2>(sizes)});
+}
+DFHelper::TensorView DFHelper::view_tensor(std::string name, std::vector<size_t> t0, std::vector<size_t> t1,
+                                           std::vector<size_t> t2) {
+    if (t0.size() != 2 || t1.size() != 2 || t2.size() != 2) {
+        std::stringstream error;
+        error << "DFHelper:view_tensor:  tensor indexing vectors must have 2 elements!";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+
+    check_file_key(name);
+    std::string filename = std::get<1>(files_[name]);
+    std::tuple<size_t, size_t, size_t> sizes;
+    sizes = (tsizes_.find(filename) != tsizes_.end() ? tsizes_[filename] : sizes_[filename]);
+
+    // be pythonic - adjust stops
+    std::pair<size_t, size_t> i0 = std::make_pair(t0[0], t0[1] - 1);
+    std::pair<size_t, size_t> i1 = std::make_pair(t1[0], t1[1] - 1);
+    std::pair<size_t, size_t> i2 = std::make_pair(t2[0], t2[1] - 1);
+    check_file_tuple(name, i0, i1, i2);
+
+    size_t a1 = std::get<1>(sizes);
+    size_t a2 = std::get<2>(sizes);
+    std::array<size_t, 3> shape = {{t0[1] - t0[0], t1[1] - t1[0], t2[1] - t2[0]}};
+    std::array<size_t, 3> strides = {{a1 * a2, a2, 1}};
+    size_t offset = t0[0] * a1 * a2 + t1[0] * a2 + t2[0];
+
+    // in-core tensors are owned by this DFHelper, so the view does not extend their lifetime
+    std::shared_ptr<const double> base;
+    if (MO_core_ && transf_core_.count(name)) {
+        base = std::shared_ptr<const double>(transf_core_[name].get(), [](const double*) {});
+    } else {
+        if (float_files_.count(filename)) {
+            throw PSIEXCEPTION("DFHelper:view_tensor: tensor is stored in single precision, use fill_tensor.");
+        }
+        base = map_file(filename);
+    }
+
+    return TensorView(base, base.get() + offset, shape, strides);
+}
+std::shared_ptr<const double> DFHelper::map_file(std::string filename) {
+    auto it = mapped_files_.find(filename);
+    if (it != mapped_files_.end()) return it->second;
+
+#ifdef _MSC_VER
+    throw PSIEXCEPTION("DFHelper:view_tensor: memory-mapped disk tensors are not available on this platform.");
+#else
+    // flush anything still buffered in our own stream
+    if (file_streams_.count(filename) && file_streams_[filename]->open_) fflush(file_streams_[filename]->fp_);
+
+    size_t bytes = std::get<0>(sizes_[filename]) * std::get<1>(sizes_[filename]) * std::get<2>(sizes_[filename]) *
+                   sizeof(double);
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) || (size_t)st.st_size < bytes) {
+        if (fd >= 0) close(fd);
+        std::stringstream error;
+        error << "DFHelper:view_tensor: cannot map " << filename << ", has the tensor been written?";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+    void* base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::stringstream error;
+        error << "DFHelper:view_tensor: mmap of " << filename << " failed";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+
+    // the mapping outlives the unlink in ~StreamStruct and is released with the last view
+    std::shared_ptr<const double> mapping(static_cast<const double*>(base),
+                                          [base, bytes](const double*) { munmap(base, bytes); });
+    mapped_files_[filename] = mapping;
+    return mapping;
+#endif
+}
+
 // Add a disk tensor
 void DFHelper::add_disk_tensor(std::string key, std::tuple<size_t, size_t, size_t> dimensions) {
     if (files_.count(key)) {
@@ -2518,6 +3106,7 @@ void DFHelper::add_disk_tensor(std::string key, std::tuple<size_t, size_t, size_
     }
 
     filename_maker(key, std::get<0>(dimensions), std::get<1>(dimensions), std::get<2>(dimensions));
+    if (float_disk_) mark_float_file(key);
 }
 
 // Write to a disk tensor from Sharedmatrix
@@ -2798,7 +3387,7 @@ void DFHelper::transpose_disk(std::string name, std::tuple<size_t, size_t, size_
     for (size_t i = 0; i < M0; i++) {
         current += M1 * M2;
         count++;
-        if ((current * 2 > memory_) || (i == M0 - 1)) {  //
+        if ((current * 2 > memory_ - float_io_memory()) || (i == M0 - 1)) {  //
             if (count == 1 && i != M0 - 1) {
                 std::stringstream error;
                 error << "DFHelper:transpose_disk: not enough memory.";
@@ -2853,6 +3442,7 @@ void DFHelper::transpose_disk(std::string name, std::tuple<size_t, size_t, size_
     std::string new_file = "newfilefortransposition";
     filename_maker(new_file, std::get<0>(sizes), std::get<1>(sizes), std::get<2>(sizes));
     std::string new_filename = std::get<1>(files_[new_file]);
+    if (float_files_.count(filename)) float_files_.insert(new_filename);
 
     for (size_t m = 0; m < steps.size(); m++) {
         std::string op = (m ? "r+b" : "wb");
@@ -2933,6 +3523,8 @@ void DFHelper::transpose_disk(std::string name, std::tuple<size_t, size_t, size_
     file_streams_[filename] = file_streams_[new_filename];
     stream_check(filename, "rb");
     file_streams_.erase(new_filename);
+    float_files_.erase(new_filename);
+    mapped_files_.erase(filename);
 
     // keep tsizes_ separate and do not ovwrt sizes_ in case of STORE directive
     files_.erase(new_file);
@@ -3009,10 +3601,39 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     // the strided disk reads for the AOs will result in a definite loss to DiskDFJK in the disk-bound realm
     // 2. we could allocate the buffers only once, instead of every time compute_JK() is called
 
+    // For the sparse K path, K = C C^T is unchanged if the occupied orbitals are replaced by the
+    // Cholesky vectors of D = C C^T, which are localized and therefore have sparse coefficients.
+    // The factorization stops once every remaining pivot of D is below the tolerance, so no element
+    // of the dropped remainder exceeds it either
+    if (do_K && lr_symmetric && K_sparse_tol_ > 0.0) {
+        std::vector<SharedMatrix> Clocal;
+        for (size_t i = 0; i < Cleft.size(); i++) {
+            if (!Cleft[i]->colspi()[0]) {
+                Clocal.push_back(Cleft[i]);
+                continue;
+            }
+            auto Docc = linalg::doublet(Cleft[i], Cleft[i], false, true);
+            Clocal.push_back(Docc->partial_cholesky_factorize(K_sparse_tol_));
+        }
+        Cleft = Clocal;
+        Cright = Clocal;
+        max_nocc = 0;
+        for (const auto& C : Clocal) max_nocc = std::max(max_nocc, (size_t)C->colspi()[0]);
+    }
+
+    if (pair_fitting_) {
+        compute_JK_pair_fitting(Cleft, Cright, D, J, K, max_nocc, do_J, do_K);
+        return;
+    }
+
+    // If the AOs are on disk and two blocks of them fit in memory, the next block is read on
+    // a helper thread while the current one is contracted, hiding the disk reads behind the J/K work
+    bool prefetch_AOs = !AO_core_ && !wcombine_ && JK_AO_prefetch_fits(max_nocc, lr_symmetric);
+
     // Each element of Qsteps specifies the endpoints of a batch of auxiliary shells.
     // We'll treat all (PN|Q) for Q in this batch at once.
     std::vector<std::pair<size_t, size_t>> Qsteps;
-    std::tuple<size_t, size_t> info = Qshell_blocks_for_JK_build(Qsteps, max_nocc, lr_symmetric);
+    std::tuple<size_t, size_t> info = Qshell_blocks_for_JK_build(Qsteps, max_nocc, lr_symmetric, (prefetch_AOs ? 2 : 1));
     size_t tots = std::get<0>(info);
     size_t totsb = std::get<1>(info);
 
@@ -3065,6 +3686,15 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     } else
         if (!wcombine_) {Mp = Ppq_.get();}
 
+    // second AO buffer, filled by the prefetch thread; its future carries read errors back here
+    std::unique_ptr<double[]> M_next;
+    double* M_nextp = nullptr;
+    std::future<void> prefetch;
+    if (prefetch_AOs) {
+        M_next = std::make_unique<double[]>(tots);
+        M_nextp = M_next.get();
+    }
+
     double* M1p;
     if (wcombine_) {
         M1p = m1Ppq_.get();
@@ -3072,17 +3702,29 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
 
     // Transform a single batch of integrals
     size_t bcount = 0;
-    for (const auto& Qstep :Qsteps) {
+    for (size_t step = 0; step < Qsteps.size(); step++) {
         // Qshell step info
-        auto start = std::get<0>(Qstep);
-        auto stop = std::get<1>(Qstep);
+        auto start = std::get<0>(Qsteps[step]);
+        auto stop = std::get<1>(Qsteps[step]);
         auto begin = Qshell_aggs_[start];
         auto end = Qshell_aggs_[stop + 1] - 1;
         auto block_size = end - begin + 1;
 
         // get AO chunk according to directive
         timer_on("DFH: Grabbing AOs");
-        if (!AO_core_) {
+        if (prefetch_AOs) {
+            // wait for this block, then start on the next one
+            if (prefetch.valid()) {
+                prefetch.get();
+                std::swap(Mp, M_nextp);
+            } else {
+                grab_AO(start, stop, Mp);
+            }
+            if (step + 1 < Qsteps.size()) {
+                prefetch = std::async(std::launch::async, &DFHelper::grab_AO, this, std::get<0>(Qsteps[step + 1]),
+                                      std::get<1>(Qsteps[step + 1]), M_nextp);
+            }
+        } else if (!AO_core_) {
             grab_AO(start, stop, Mp);
         }
         timer_off("DFH: Grabbing AOs");
@@ -3108,8 +3750,368 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
 
         bcount += block_size;
     }
+
+    // compute_K only accumulated the lower triangle of symmetric K
+    if (do_K && lr_symmetric) {
+        for (auto& Kmat : K) {
+            Kmat->copy_lower_to_upper();
+        }
+    }
     // outfile->Printf("\n     ==> DFHelper:--End J/K Builds (disk)<==\n\n");
 }
+void DFHelper::prepare_pair_blocks() {
+    if (!pair_row_blocks_.empty()) return;
+
+    // aux functions of an atom are contiguous
+    int natom = primary_->molecule()->natom();
+    std::vector<size_t> Qstart(natom, naux_), Qcount(natom, 0);
+    for (size_t P = 0; P < naux_; P++) {
+        int c = aux_->function_to_center(P);
+        Qstart[c] = std::min(Qstart[c], P);
+        Qcount[c]++;
+    }
+
+    pair_blocks_.clear();
+    pair_row_blocks_.assign(nbf_ + 1, 0);
+    for (size_t m = 0; m < nbf_; m++) {
+        int a = primary_->function_to_center(m);
+        pair_row_blocks_[m] = pair_blocks_.size();
+        for (size_t n = 0, pos = 0; n < nbf_; n++) {
+            if (!schwarz_fun_index_[m * nbf_ + n]) continue;
+            int b = primary_->function_to_center(n);
+            if (pair_blocks_.size() == pair_row_blocks_[m] || pair_blocks_.back().partner != b) {
+                int lo = std::min(a, b);
+                int hi = std::max(a, b);
+                PairBlock block;
+                block.m = m;
+                block.partner = b;
+                block.col0 = pos;
+                block.offset = 0;
+                block.Q0[0] = Qstart[lo];
+                block.nQ[0] = Qcount[lo];
+                block.Q0[1] = Qstart[hi];
+                block.nQ[1] = (hi == lo ? 0 : Qcount[hi]);
+                pair_blocks_.push_back(block);
+            }
+            pair_blocks_.back().cols.push_back(n);
+            pos++;
+        }
+    }
+    pair_row_blocks_[nbf_] = pair_blocks_.size();
+
+    pair_block_size_ = 0;
+    for (auto& block : pair_blocks_) {
+        block.offset = pair_block_size_;
+        pair_block_size_ += (block.nQ[0] + block.nQ[1]) * block.cols.size();
+    }
+}
+void DFHelper::prepare_pair_fitting() {
+    // get each thread an eri object
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    auto rifactory = std::make_shared<IntegralFactory>(aux_, zero, primary_, primary_);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> eri(nthreads_);
+    eri[0] = std::shared_ptr<TwoBodyAOInt>(rifactory->eri());
+#pragma omp parallel num_threads(nthreads_)
+    {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        if (rank) eri[rank] = std::shared_ptr<TwoBodyAOInt>(eri.front()->clone());
+    }
+
+    // unfitted (P|mn)
+    Ppq_ = std::unique_ptr<double[]>(new double[big_skips_[nbf_]]);
+    timer_on("DFH: AO Construction");
+    compute_sparse_pQq_blocking_p(0, pshells_ - 1, &Ppq_[0], eri);
+    timer_off("DFH: AO Construction");
+
+    timer_on("DFH: metric construction");
+    FittingMetric metric(aux_, true);
+    metric.form_fitting_metric();
+    pair_metric_ = metric.get_metric();
+    timer_off("DFH: metric construction");
+    double** metp = pair_metric_->pointer();
+
+    // functions by atom
+    int natom = primary_->molecule()->natom();
+    std::vector<std::vector<size_t>> pfuns(natom), Qfuns(natom);
+    for (size_t m = 0; m < nbf_; m++) pfuns[primary_->function_to_center(m)].push_back(m);
+    for (size_t P = 0; P < naux_; P++) Qfuns[aux_->function_to_center(P)].push_back(P);
+
+    prepare_pair_blocks();
+    Cpq_ = std::unique_ptr<double[]>(new double[pair_block_size_]);
+    fill(Cpq_.get(), pair_block_size_, 0.0);
+    if (print_lvl_ > 0) {
+        outfile->Printf("  DFHelper: Pair fitting coefficients stored in %zu blocks, %.1f%% of the screened AOs.\n\n",
+                        pair_blocks_.size(), 100.0 * pair_block_size_ / (double)big_skips_[nbf_]);
+    }
+
+    // C_mn^P = [(P|Q)_ab]^-1 (Q|mn) for m on a, n on b, P and Q on a or b
+    timer_on("DFH: pair fitting");
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (int ab = 0; ab < natom * natom; ab++) {
+        int a = ab / natom;
+        int b = ab % natom;
+        if (b < a) continue;
+
+        std::vector<size_t> Qab(Qfuns[a]);
+        if (b != a) Qab.insert(Qab.end(), Qfuns[b].begin(), Qfuns[b].end());
+        size_t nQ = Qab.size();
+        if (!nQ) continue;
+
+        // significant pairs of this atom pair, as (row function, position in its sparse row)
+        std::vector<std::pair<size_t, size_t>> pairs;
+        for (int side = 0; side < (a == b ? 1 : 2); side++) {
+            const auto& rows = (side ? pfuns[b] : pfuns[a]);
+            const auto& cols = (side ? pfuns[a] : pfuns[b]);
+            for (size_t m : rows) {
+                for (size_t n : cols) {
+                    size_t ind = schwarz_fun_index_[m * nbf_ + n];
+                    if (ind) pairs.emplace_back(m, ind - 1);
+                }
+            }
+        }
+        if (pairs.empty()) continue;
+
+        auto Jab = std::make_shared<Matrix>("Pair Metric", nQ, nQ);
+        double** Jabp = Jab->pointer();
+        for (size_t P = 0; P < nQ; P++) {
+            for (size_t Q = 0; Q < nQ; Q++) {
+                Jabp[P][Q] = metp[Qab[P]][Qab[Q]];
+            }
+        }
+        Jab->power(-1.0, condition_);
+
+        // gather, fit, scatter
+        size_t npair = pairs.size();
+        std::vector<double> A(nQ * npair), C(nQ * npair);
+        for (size_t Q = 0; Q < nQ; Q++) {
+            for (size_t x = 0; x < npair; x++) {
+                size_t m = pairs[x].first;
+                A[Q * npair + x] = Ppq_[big_skips_[m] + Qab[Q] * small_skips_[m] + pairs[x].second];
+            }
+        }
+        C_DGEMM('N', 'N', nQ, npair, nQ, 1.0, Jabp[0], nQ, A.data(), npair, 0.0, C.data(), npair);
+
+        // the blocks of an (a, b) pair run over exactly the Qab functions, in the same order
+        for (size_t x = 0; x < npair; x++) {
+            size_t m = pairs[x].first;
+            size_t pos = pairs[x].second;
+            for (size_t blk = pair_row_blocks_[m]; blk < pair_row_blocks_[m + 1]; blk++) {
+                const PairBlock& block = pair_blocks_[blk];
+                size_t ncol = block.cols.size();
+                if (pos < block.col0 || pos >= block.col0 + ncol) continue;
+                for (size_t P = 0; P < nQ; P++) {
+                    Cpq_[block.offset + P * ncol + pos - block.col0] = C[P * npair + x];
+                }
+                break;
+            }
+        }
+    }
+    timer_off("DFH: pair fitting");
+}
+void DFHelper::contract_pQq_density(double* Mp, double* Dp, double* vp, std::vector<std::vector<double>>& D_buffers) {
+    std::vector<double> T(nthreads_ * naux_, 0.0);
+
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+    for (size_t k = 0; k < nbf_; k++) {
+        size_t sp_size = small_skips_[k];
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        for (size_t m = 0, sp_count = -1; m < nbf_; m++) {
+            if (schwarz_fun_index_[k * nbf_ + m]) {
+                sp_count++;
+                D_buffers[rank][sp_count] = Dp[nbf_ * k + m];
+            }
+        }
+        // (Qm)(m) -> (Q)
+        C_DGEMV('N', naux_, sp_size, 1.0, &Mp[big_skips_[k]], sp_size, &D_buffers[rank][0], 1, 1.0, &T[rank * naux_],
+                1);
+    }
+
+    // reduce
+    for (size_t l = 0; l < naux_; l++) vp[l] = T[l];
+    for (size_t k = 1; k < nthreads_; k++) {
+        for (size_t l = 0; l < naux_; l++) vp[l] += T[k * naux_ + l];
+    }
+}
+void DFHelper::expand_pQq_density(double* Mp, double* vp, double* Jp, double* Tp) {
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+    for (size_t k = 0; k < nbf_; k++) {
+        size_t sp_size = small_skips_[k];
+        C_DGEMV('T', naux_, sp_size, 1.0, &Mp[big_skips_[k]], sp_size, vp, 1, 0.0, &Tp[k * nbf_], 1);
+    }
+
+    // unpack from sparse to dense
+    for (size_t k = 0; k < nbf_; k++) {
+        for (size_t m = 0, count = -1; m < nbf_; m++) {
+            if (schwarz_fun_index_[k * nbf_ + m]) {
+                count++;
+                Jp[k * nbf_ + m] += Tp[k * nbf_ + count];
+            }
+        }
+    }
+}
+void DFHelper::contract_pair_density(double* Dp, double* vp) {
+    std::vector<double> T(nthreads_ * naux_, 0.0);
+    std::vector<std::vector<double>> Dv(nthreads_, std::vector<double>(nbf_));
+
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+    for (size_t m = 0; m < nbf_; m++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        for (size_t blk = pair_row_blocks_[m]; blk < pair_row_blocks_[m + 1]; blk++) {
+            const PairBlock& block = pair_blocks_[blk];
+            size_t ncol = block.cols.size();
+            for (size_t c = 0; c < ncol; c++) Dv[rank][c] = Dp[m * nbf_ + block.cols[c]];
+
+            // (Qn)(n) -> (Q), for the aux functions of each atom
+            double* Cb = &Cpq_[block.offset];
+            for (int s = 0; s < 2; s++) {
+                if (!block.nQ[s]) continue;
+                C_DGEMV('N', block.nQ[s], ncol, 1.0, Cb, ncol, Dv[rank].data(), 1, 1.0, &T[rank * naux_ + block.Q0[s]], 1);
+                Cb += block.nQ[s] * ncol;
+            }
+        }
+    }
+
+    // reduce
+    for (size_t l = 0; l < naux_; l++) vp[l] = T[l];
+    for (size_t k = 1; k < nthreads_; k++) {
+        for (size_t l = 0; l < naux_; l++) vp[l] += T[k * naux_ + l];
+    }
+}
+void DFHelper::expand_pair_density(double* vp, double* Jp) {
+    std::vector<std::vector<double>> Tv(nthreads_, std::vector<double>(nbf_));
+
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+    for (size_t m = 0; m < nbf_; m++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        for (size_t blk = pair_row_blocks_[m]; blk < pair_row_blocks_[m + 1]; blk++) {
+            const PairBlock& block = pair_blocks_[blk];
+            size_t ncol = block.cols.size();
+            double* Cb = &Cpq_[block.offset];
+            double beta = 0.0;
+            for (int s = 0; s < 2; s++) {
+                if (!block.nQ[s]) continue;
+                C_DGEMV('T', block.nQ[s], ncol, 1.0, Cb, ncol, &vp[block.Q0[s]], 1, beta, Tv[rank].data(), 1);
+                Cb += block.nQ[s] * ncol;
+                beta = 1.0;
+            }
+            for (size_t c = 0; c < ncol; c++) Jp[m * nbf_ + block.cols[c]] += Tv[rank][c];
+        }
+    }
+}
+void DFHelper::first_transform_pair(size_t bcols, double* Bp, double* Fp, size_t m0, size_t nm) {
+    std::vector<std::vector<double>> G(nthreads_, std::vector<double>(nbf_ * bcols));
+
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+    for (size_t m = m0; m < m0 + nm; m++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        double* Fm = &Fp[(m - m0) * naux_ * bcols];
+        std::fill(Fm, Fm + naux_ * bcols, 0.0);
+
+        for (size_t blk = pair_row_blocks_[m]; blk < pair_row_blocks_[m + 1]; blk++) {
+            const PairBlock& block = pair_blocks_[blk];
+            size_t ncol = block.cols.size();
+            for (size_t c = 0; c < ncol; c++) {
+                C_DCOPY(bcols, &Bp[block.cols[c] * bcols], 1, &G[rank][c * bcols], 1);
+            }
+
+            // (Qn)(nb) -> (Qb), for the aux functions of each atom
+            double* Cb = &Cpq_[block.offset];
+            for (int s = 0; s < 2; s++) {
+                if (!block.nQ[s]) continue;
+                C_DGEMM('N', 'N', block.nQ[s], bcols, ncol, 1.0, Cb, ncol, G[rank].data(), bcols, 1.0,
+                        &Fm[block.Q0[s] * bcols], bcols);
+                Cb += block.nQ[s] * ncol;
+            }
+        }
+    }
+}
+void DFHelper::compute_JK_pair_fitting(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
+                                       std::vector<SharedMatrix> D, std::vector<SharedMatrix> J,
+                                       std::vector<SharedMatrix> K, size_t max_nocc, bool do_J, bool do_K) {
+    double* metp = pair_metric_->pointer()[0];
+    double* Bp = Ppq_.get();
+
+    std::vector<std::vector<double>> C_buffers(nthreads_);
+#pragma omp parallel num_threads(nthreads_)
+    {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        C_buffers[rank] = std::vector<double>(nbf_ * std::max(max_nocc, nbf_));
+    }
+
+    if (do_J) {
+        timer_on("DFH: compute_J");
+        // robust fitting: J = (mn|P) d_P + C_mn^P [g_P - (P|Q) d_Q], d = C D, g = (P|ls) D_ls
+        std::vector<double> d(naux_), r(naux_), T(nbf_ * nbf_);
+        for (size_t i = 0; i < J.size(); i++) {
+            double* Dp = D[i]->pointer()[0];
+            double* Jp = J[i]->pointer()[0];
+            contract_pair_density(Dp, d.data());
+            contract_pQq_density(Bp, Dp, r.data(), C_buffers);
+            C_DGEMV('N', naux_, naux_, -1.0, metp, naux_, d.data(), 1, 1.0, r.data(), 1);
+            expand_pQq_density(Bp, d.data(), Jp, T.data());
+            expand_pair_density(r.data(), Jp);
+        }
+        timer_off("DFH: compute_J");
+    }
+
+    if (do_K) {
+        timer_on("DFH: compute_K");
+        // K_mn = (C_ml^P C_li) (P|Q) (C_ns^Q C_si), with X = C_ml^P C_li and Y = (P|Q) C_ns^Q C_si
+        // built for blocks of rows; AO_core() budgeted pair_K_rows_ rows of nbf occupied columns
+        size_t rows = std::min(nbf_, pair_K_rows_ * nbf_ / std::max(max_nocc, (size_t)1));
+        rows = std::max(rows, (size_t)1);
+        std::vector<double> X(rows * naux_ * max_nocc), Y(rows * naux_ * max_nocc);
+        std::vector<std::vector<double>> W(nthreads_, std::vector<double>(naux_ * max_nocc));
+        for (size_t i = 0; i < K.size(); i++) {
+            size_t nocc = Cleft[i]->colspi()[0];
+            if (!nocc) continue;
+
+            double* Kp = K[i]->pointer()[0];
+            for (size_t n0 = 0; n0 < nbf_; n0 += rows) {
+                size_t nn = std::min(rows, nbf_ - n0);
+                first_transform_pair(nocc, Cright[i]->pointer()[0], Y.data(), n0, nn);
+
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+                for (size_t k = 0; k < nn; k++) {
+                    int rank = 0;
+#ifdef _OPENMP
+                    rank = omp_get_thread_num();
+#endif
+                    double* Yk = &Y[k * naux_ * nocc];
+                    C_DGEMM('N', 'N', naux_, nocc, naux_, 1.0, metp, naux_, Yk, nocc, 0.0, W[rank].data(), nocc);
+                    C_DCOPY(naux_ * nocc, W[rank].data(), 1, Yk, 1);
+                }
+
+                // with a single block X is built once
+                for (size_t m0 = 0; m0 < nbf_; m0 += rows) {
+                    size_t nm = std::min(rows, nbf_ - m0);
+                    first_transform_pair(nocc, Cleft[i]->pointer()[0], X.data(), m0, nm);
+                    C_DGEMM('N', 'T', nm, nn, naux_ * nocc, 1.0, X.data(), naux_ * nocc, Y.data(), naux_ * nocc, 1.0,
+                            &Kp[m0 * nbf_ + n0], nbf_);
+                }
+            }
+        }
+        timer_off("DFH: compute_K");
+    }
+}
 void DFHelper::compute_J_symm(std::vector<SharedMatrix> D, std::vector<SharedMatrix> J, double* Mp, double* T1p,
                               double* T2p, std::vector<std::vector<double>>& D_buffers, size_t bcount,
                               size_t block_size) {
@@ -3301,6 +4303,11 @@ void DFHelper::compute_J_combined(std::vector<SharedMatrix> D, std::vector<Share
 void DFHelper::compute_K(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> K,
                          double* T1p, double* T2p, double* Mp, size_t bcount, size_t block_size,
                          std::vector<std::vector<double>>& C_buffers, bool lr_symmetric) {
+    // Batched right-hand sides (e.g. CPHF products) usually share one C_left, and sometimes one C_right.
+    // The half-transformed tensors are kept from the previous density when its C matrix is the same object.
+    Matrix* T1_source = nullptr;
+    Matrix* T2_source = nullptr;
+
     for (size_t i = 0; i < K.size(); i++) {
         size_t nocc = Cleft[i]->colspi()[0];
         if (!nocc) {
@@ -3312,18 +4319,33 @@ void DFHelper::compute_K(std::vector<SharedMatrix> Cleft, std::vector<SharedMatr
         double* Kp = K[i]->pointer()[0];
 
         // compute first tmp
-        first_transform_pQq(nocc, bcount, block_size, Mp, T1p, Clp, C_buffers);
+        if (Cleft[i].get() != T1_source) {
+            if (lr_symmetric && K_sparse_tol_ > 0.0) {
+                first_transform_pQq_sparse(nocc, bcount, block_size, Mp, T1p, Clp, C_buffers);
+            } else {
+                first_transform_pQq(nocc, bcount, block_size, Mp, T1p, Clp, C_buffers);
+            }
+            T1_source = Cleft[i].get();
+        }
 
-        // compute second tmp
         if (lr_symmetric) {
-            T2p = T1p;
+            // compute the lower triangle of K; the upper triangle is filled in by compute_JK
+            // once all auxiliary blocks have been accumulated, halving the cost of the contraction
+            C_DSYRK('L', 'N', nbf_, nocc * block_size, 1.0, T1p, nocc * block_size, 1.0, Kp, nbf_);
         } else {
-            first_transform_pQq(nocc, bcount, block_size, Mp, T2p, Crp, C_buffers);
-        }
+            // compute second tmp
+            double* T2ip = T2p;
+            if (Cright[i].get() == Cleft[i].get()) {
+                T2ip = T1p;
+            } else if (Cright[i].get() != T2_source) {
+                first_transform_pQq(nocc, bcount, block_size, Mp, T2p, Crp, C_buffers);
+                T2_source = Cright[i].get();
+            }
 
-        // compute K
-        C_DGEMM('N', 'T', nbf_, nbf_, nocc * block_size, 1.0, T1p, nocc * block_size, T2p, nocc * block_size, 1.0, Kp,
-                nbf_);
+            // compute K
+            C_DGEMM('N', 'T', nbf_, nbf_, nocc * block_size, 1.0, T1p, nocc * block_size, T2ip, nocc * block_size, 1.0,
+                    Kp, nbf_);
+        }
     }
 }
 void DFHelper::compute_wK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
@@ -33,7 +33,10 @@
 #include <psi4/libmints/typedefs.h>
 #include "psi4/libpsi4util/exception.h"
 
+#include <array>
+#include <functional>
 #include <map>
+#include <set>
 #include <list>
 #include <vector>
 #include <tuple>
@@ -50,6 +53,40 @@ class TwoBodyAOInt;
 // lr_symmetric: Are the two C matrices in our J/K-esque contraction equal?
 
 class PSI_API DFHelper {
+   public:
+    ///
+    /// A read-only, zero-copy view of a slice of a 3-index tensor.
+    /// Disk tensors are memory-mapped and in-core (MO_core) tensors are viewed in place.
+    /// A view keeps its mapping alive, but writing to the same tensor afterwards
+    /// (write_disk_tensor, transpose, transform) may change or invalidate what it sees.
+    ///
+    class TensorView {
+       public:
+        TensorView() = default;
+        TensorView(std::shared_ptr<const double> base, const double* data, std::array<size_t, 3> shape,
+                   std::array<size_t, 3> strides)
+            : base_(base), data_(data), shape_(shape), strides_(strides) {}
+
+        /// element (i, j, k) of the slice
+        double operator()(size_t i, size_t j, size_t k) const {
+            return data_[i * strides_[0] + j * strides_[1] + k];
+        }
+        /// pointer to the contiguous row (i, j, :) of the slice
+        const double* row(size_t i, size_t j) const { return data_ + i * strides_[0] + j * strides_[1]; }
+        /// pointer to element (0, 0, 0) of the slice
+        const double* data() const { return data_; }
+        /// extent of the slice along axis
+        size_t shape(size_t axis) const { return shape_[axis]; }
+        /// distance (in doubles) between consecutive indices along axis; 1 for axis 2
+        size_t stride(size_t axis) const { return strides_[axis]; }
+
+       private:
+        std::shared_ptr<const double> base_;
+        const double* data_ = nullptr;
+        std::array<size_t, 3> shape_{{0, 0, 0}};
+        std::array<size_t, 3> strides_{{0, 0, 1}};
+    };
+
    public:
     DFHelper(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> aux);
     ~DFHelper();
@@ -190,6 +227,61 @@ class PSI_API DFHelper {
     void set_omega_beta(double beta) { omega_beta_ = beta; }
     double get_omega_beta() { return omega_beta_; }
 
+    ///
+    /// Sets the tolerance for the sparse K half-transform. For symmetric K builds the occupied
+    /// orbitals are replaced by Cholesky-localized ones, truncated where the pivot of the occupied
+    /// density falls below this tolerance, and orbitals whose coefficients on the significant
+    /// partners of a basis function all fall below it are skipped.
+    /// @param tol: pivot and coefficient tolerance, 0.0 disables the sparse path
+    ///
+    void set_K_sparse_tolerance(double tol) { K_sparse_tol_ = tol; }
+    double get_K_sparse_tolerance() { return K_sparse_tol_; }
+
+    ///
+    /// Use pair-atomic (local) fitting in build_JK: the coefficients of each AO pair (mn)
+    /// only span the auxiliary functions on the atoms of m and n, so only atom-pair blocks of
+    /// the metric are inverted. J uses the robust formula; K the C (P|Q) C form.
+    /// Requires the STORE method with in-core AOs, and no wK.
+    /// @param pair_fitting: use pair-atomic fitting?
+    ///
+    void set_pair_fitting(bool pair_fitting) { pair_fitting_ = pair_fitting; }
+    bool get_pair_fitting() { return pair_fitting_; }
+
+    ///
+    /// Share the in-core AOs of the STORE method between processes on one node (POSIX only).
+    /// The fitted AO tensor is published in a shared-memory segment named from a hash of the
+    /// basis sets, geometry and screening settings; later instances with the same key attach
+    /// to it read-only instead of building their own copy.
+    /// @param shared: publish/attach the in-core AOs?
+    ///
+    void set_shared_AO(bool shared) { shared_AO_ = shared; }
+    bool get_shared_AO() { return shared_AO_; }
+    /// Were the in-core AOs attached from a segment published by another process?
+    bool get_shared_AO_attached() { return shared_AO_attached_; }
+
+    ///
+    /// Keep the in-core AOs of the STORE method for later DFHelper instances in this process,
+    /// keyed as for set_shared_AO. Counterpoise-corrected n-body subsets all run in the
+    /// full-cluster basis at one geometry, so only the first of them builds its AOs.
+    /// Only the most recent tensor is kept, and disabling the cache releases it.
+    /// @param cache: reuse and keep in-core AOs?
+    ///
+    static void set_AO_cache(bool cache);
+    static bool get_AO_cache();
+    /// Were the in-core AOs taken from the process cache?
+    bool get_AO_cache_hit() { return AO_cache_hit_; }
+
+    ///
+    /// Store transformed and user-added disk tensors as 32-bit floats.
+    /// Halves their footprint and I/O at ~6E-8 relative error; values are widened
+    /// back to double on read. AO and metric files are always kept in double.
+    /// Only affects tensors added after the call; not compatible with view_tensor.
+    /// Call before initialize(): the conversion buffers take 512 KiB of the memory budget.
+    /// @param float_disk: write single-precision disk tensors?
+    ///
+    void set_float_disk(bool float_disk) { float_disk_ = float_disk; }
+    bool get_float_disk() { return float_disk_; }
+
     ///
     /// set the printing verbosity parameter
     /// @param print_lvl indicating verbosity
@@ -267,6 +359,16 @@ class PSI_API DFHelper {
     SharedMatrix get_tensor(std::string name, std::vector<size_t> a1, std::vector<size_t> a2);
     SharedMatrix get_tensor(std::string name, std::vector<size_t> a1, std::vector<size_t> a2, std::vector<size_t> a3);
 
+    ///
+    /// return a read-only view of a slice, sliced the same way as fill_tensor, without copying it.
+    /// Disk tensors are memory-mapped, so repeated passes are cached by the OS.
+    /// For example, view_tensor("ia", (0, 15))(i, a, Q) is ia[i, a, Q] for i < 15
+    ///
+    TensorView view_tensor(std::string name);
+    TensorView view_tensor(std::string name, std::vector<size_t> a1);
+    TensorView view_tensor(std::string name, std::vector<size_t> a1, std::vector<size_t> a2);
+    TensorView view_tensor(std::string name, std::vector<size_t> a1, std::vector<size_t> a2, std::vector<size_t> a3);
+
     ///
     /// Add a 3-index disk tensor (that is not a transformation)
     /// @param name name of tensor - used to be accessed later
@@ -354,6 +456,7 @@ class PSI_API DFHelper {
     bool ordered_ = false;
     bool do_wK_ = false;
     bool wcombine_ = false;
+    double K_sparse_tol_ = 0.0;
     double omega_;
     double omega_alpha_;
     double omega_beta_;
@@ -364,17 +467,74 @@ class PSI_API DFHelper {
 
     // => in-core machinery <=
     void AO_core();
-    std::unique_ptr<double[]> Ppq_;
+    // the deleter lets Ppq_ point into a shared-memory mapping
+    std::unique_ptr<double[], std::function<void(double*)>> Ppq_;
     // Maps x -> (P|Q) ^ x.
     std::map<double, SharedMatrix> metrics_;
 
+    // => pair-atomic fitting machinery <=
+    bool pair_fitting_ = false;
+    // fitting coefficients C_mn^P, block-compressed (see PairBlock); Ppq_ holds the unfitted (P|mn)
+    std::unique_ptr<double[]> Cpq_;
+    // For m on atom a, the significant n of one partner atom b form a contiguous run of the sparse
+    // row of m. C_mn^P of that run is stored as one (P x n) block, with P running over the aux
+    // functions of the lower then the higher of a and b only.
+    struct PairBlock {
+        size_t m;
+        int partner;
+        size_t col0;    // position of the first n in the sparse row of m
+        size_t offset;  // start of the block in Cpq_
+        size_t Q0[2];   // aux ranges [Q0, Q0 + nQ) of the two atoms, nQ[1] is 0 if a == b
+        size_t nQ[2];
+        std::vector<size_t> cols;  // the n of each column
+    };
+    std::vector<PairBlock> pair_blocks_;
+    // blocks of row m are [pair_row_blocks_[m], pair_row_blocks_[m + 1])
+    std::vector<size_t> pair_row_blocks_;
+    size_t pair_block_size_ = 0;
+    // rows m of the K intermediates (Q x i) held at once, for nbf occupied columns; set by AO_core()
+    size_t pair_K_rows_ = 0;
+    void prepare_pair_blocks();
+    // full Coulomb metric (P|Q), needed for the robust J and for K
+    SharedMatrix pair_metric_;
+    void prepare_pair_fitting();
+    void compute_JK_pair_fitting(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
+                                 std::vector<SharedMatrix> D, std::vector<SharedMatrix> J,
+                                 std::vector<SharedMatrix> K, size_t max_nocc, bool do_J, bool do_K);
+    // v_P = M_mn^P D_mn and J_mn += M_mn^P v_P over the in-core sparse layout
+    void contract_pQq_density(double* Mp, double* Dp, double* vp, std::vector<std::vector<double>>& D_buffers);
+    void expand_pQq_density(double* Mp, double* vp, double* Jp, double* Tp);
+    // the same contractions, and the pQq first transform, over the blocks of Cpq_; zero blocks are never visited
+    void contract_pair_density(double* Dp, double* vp);
+    void expand_pair_density(double* vp, double* Jp);
+    // rows [m0, m0 + nm) of the first transform
+    void first_transform_pair(size_t bcols, double* Bp, double* Fp, size_t m0, size_t nm);
+
     // => in-core wK machinery <=
     std::unique_ptr<double[]> wPpq_;  // if do_wK_ holds (A|w|mn)
     std::unique_ptr<double[]> m1Ppq_;
 
+    // => shared-memory AO machinery <=
+    bool shared_AO_ = false;
+    bool shared_AO_attached_ = false;
+    // name of the segment this instance published, unlinked on destruction
+    std::string shared_AO_owned_;
+    std::string AO_key();
+    std::string shared_AO_key();
+    bool attach_shared_AO();
+    void publish_shared_AO();
+
+    // => process-wide AO cache <=
+    bool AO_cache_hit_ = false;
+    bool attach_cached_AO();
+    void publish_cached_AO();
+
     // => AO building machinery <=
     void prepare_AO();
     void prepare_AO_core();
+    // aux shells start..stop, ordered by angular momentum so that consecutive (P|mn) calls reuse the engine's
+    // AM-specific setup
+    std::vector<size_t> aux_shells_by_am(const size_t start, const size_t stop);
     void compute_dense_Qpq_blocking_Q(const size_t start, const size_t stop, double* Mp,
                                       std::vector<std::shared_ptr<TwoBodyAOInt>> eri);
     void compute_sparse_pQq_blocking_Q(const size_t start, const size_t stop, double* Mp,
@@ -399,6 +559,12 @@ class PSI_API DFHelper {
     void copy_upper_lower_wAO_core_symm(double* Qpq, double* Ppq, size_t begin, size_t end);
 
     // first integral transforms
+    void first_transform_pQq_sparse(size_t bsize, size_t bcount, size_t block_size, double* Mp, double* Tp,
+                                    double* Bp, std::vector<std::vector<double>>& C_buffers);
+    // contract one transformed Q block (in Fp) with rows begin.. of the metric, accumulating into the in-core
+    // tensor of transformation ind; Np is a block-sized scratch buffer
+    void contract_metric_block(size_t begin, size_t block_size, size_t wsize, size_t bsize, double* metp, double* Fp,
+                               double* Np, size_t ind, bool bleft);
     void first_transform_pQq(size_t bsize, size_t bcount, size_t block_size, double* Mp, double* Tp, double* Bp,
                              std::vector<std::vector<double>>& C_buffers);
 
@@ -467,6 +633,14 @@ class PSI_API DFHelper {
     // => metric operations <=
     void contract_metric_Qpq(std::string file, double* metp, double* Mp, double* Fp, const size_t tots);
     void contract_metric(std::string file, double* metp, double* Mp, double* Fp, const size_t tots);
+    // Runs get -> contract -> put over steps. With double_buffer, Mp and Fp are split into halves of
+    // size half, and the next block is read and the previous one written on helper threads while
+    // the current block is contracted. The get and put streams must already exist.
+    void pipeline_metric_steps(const std::vector<std::pair<size_t, size_t>>& steps, double* Mp, double* Fp,
+                               size_t half, bool double_buffer,
+                               const std::function<void(size_t, size_t, double*)>& get,
+                               const std::function<void(size_t, size_t, double*, double*)>& contract,
+                               const std::function<void(size_t, size_t, double*)>& put);
     void contract_metric_core(std::string file);
     void contract_metric_AO(double* Mp);
     void contract_metric_AO_core(double* Qpq, double* metp);
@@ -507,6 +681,20 @@ class PSI_API DFHelper {
     std::map<std::string, std::shared_ptr<Stream>> file_streams_;
     FILE* stream_check(std::string filename, std::string op);
 
+    // read-only mappings of disk tensors handed out by view_tensor, by filename.
+    // put_tensor drops a file's entry, so the next view maps what was written.
+    std::map<std::string, std::shared_ptr<const double>> mapped_files_;
+    std::shared_ptr<const double> map_file(std::string filename);
+
+    // files written as float rather than double (see set_float_disk)
+    bool float_disk_ = false;
+    std::set<std::string> float_files_;
+    void mark_float_file(std::string name);
+    // float staging buffers of put_tensor/get_tensor_ hold at most float_chunk_ values each
+    static constexpr size_t float_chunk_ = 65536;
+    // doubles to hold back for the staging buffers: one reader and one writer may be busy at once
+    size_t float_io_memory() { return (float_disk_ || !float_files_.empty() ? std::min(memory_, float_chunk_) : 0); }
+
     // => FILE IO machinery <=
     void put_tensor(std::string file, double* b, std::pair<size_t, size_t> a1, std::pair<size_t, size_t> a2,
                     std::pair<size_t, size_t> a3, std::string op);
@@ -572,8 +760,11 @@ class PSI_API DFHelper {
                    double* Tp, double* Jtmp, double* Mp, size_t bcount, size_t block_size,
                    std::vector<std::vector<double>>& C_buffers, bool lr_symmetric);
     // returns tuple(largest AO buffer size, largest Q block size)
+    // @param nAO_buffers : number of AO buffers of the largest block that must fit in memory
     std::tuple<size_t, size_t> Qshell_blocks_for_JK_build(std::vector<std::pair<size_t, size_t>>& b, size_t max_nocc,
-                                                          bool lr_symmetric);
+                                                          bool lr_symmetric, size_t nAO_buffers = 1);
+    // can every auxiliary shell be double buffered from disk in a JK build?
+    bool JK_AO_prefetch_fits(size_t max_nocc, bool lr_symmetric);
     void compute_wK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> wK,
                     size_t max_nocc, bool do_J, bool do_K, bool do_wK);
 
@@ -0,0 +1,312 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "thc.h"
+#include "cholesky.h"
+#include "dfhelper.h"
+
+#include "psi4/libfock/cubature.h"
+#include "psi4/libfock/points.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/liboptions/liboptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+namespace {
+
+// Gram matrix of the weighted orbital products on the grid, G_gh = (phi_g . phi_h)^2
+class CholeskyISDF : public Cholesky {
+   protected:
+    SharedMatrix phi_;
+
+   public:
+    CholeskyISDF(SharedMatrix phi, double delta, size_t memory) : Cholesky(delta, memory), phi_(phi) {}
+    ~CholeskyISDF() override {}
+
+    size_t N() override { return phi_->rowspi()[0]; }
+    void compute_diagonal(double* target) override {
+        size_t n = N();
+        size_t nbf = phi_->colspi()[0];
+        double** phip = phi_->pointer();
+        for (size_t g = 0; g < n; g++) {
+            double val = C_DDOT(nbf, phip[g], 1, phip[g], 1);
+            target[g] = val * val;
+        }
+    }
+    void compute_row(int row, double* target) override {
+        size_t n = N();
+        size_t nbf = phi_->colspi()[0];
+        double** phip = phi_->pointer();
+        C_DGEMV('N', n, nbf, 1.0, phip[0], nbf, phip[row], 1, 0.0, target, 1);
+        for (size_t h = 0; h < n; h++) target[h] *= target[h];
+    }
+    void compute_rows(const std::vector<size_t>& rows, double** targets) override {
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (size_t r = 0; r < rows.size(); r++) {
+            compute_row(rows[r], targets[r]);
+        }
+    }
+};
+
+}  // namespace
+
+THC::THC(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> aux) : primary_(primary), aux_(aux) {
+    nbf_ = primary_->nbf();
+    naux_ = aux_->nbf();
+}
+THC::~THC() {}
+
+void THC::print_header() {
+    outfile->Printf("  ==> THC (LS-THC on an ISDF point set) <==\n");
+    outfile->Printf("    NBF:                     %11zu\n", nbf_);
+    outfile->Printf("    NAux:                    %11zu\n", naux_);
+    outfile->Printf("    Grid (radial x sph.):    %5d x %5d\n", radial_points_, spherical_points_);
+    outfile->Printf("    ISDF Tolerance:          %11.0E\n", tolerance_);
+    outfile->Printf("    Fitting Condition:       %11.0E\n", condition_);
+    outfile->Printf("    THC Avail. Memory [GiB]: %11.3f\n", (memory_ * 8L) / ((double)(1024L * 1024L * 1024L)));
+    outfile->Printf("    OpenMP threads:          %11d\n", nthreads_);
+    if (built_) outfile->Printf("    Interpolation points:    %11zu\n", npoint_);
+    outfile->Printf("\n\n");
+}
+
+std::shared_ptr<DFTGrid> THC::build_grid() {
+    std::map<std::string, std::string> grid_str_options = {
+        {"DFT_PRUNING_SCHEME", "ROBUST"},
+        {"DFT_RADIAL_SCHEME",  "TREUTLER"},
+        {"DFT_NUCLEAR_SCHEME", "TREUTLER"},
+        {"DFT_GRID_NAME",      ""},
+        {"DFT_BLOCK_SCHEME",   "OCTREE"},
+    };
+    std::map<std::string, int> grid_int_options = {
+        {"DFT_SPHERICAL_POINTS", spherical_points_},
+        {"DFT_RADIAL_POINTS",    radial_points_},
+        {"DFT_BLOCK_MIN_POINTS", 100},
+        {"DFT_BLOCK_MAX_POINTS", 256},
+    };
+    std::map<std::string, double> grid_float_options = {
+        {"DFT_BASIS_TOLERANCE",   1.0E-12},
+        {"DFT_BS_RADIUS_ALPHA",   1.0},
+        {"DFT_PRUNING_ALPHA",     1.0},
+        {"DFT_BLOCK_MAX_RADIUS",  3.0},
+        {"DFT_WEIGHTS_TOLERANCE", 1e-15},
+    };
+    return std::make_shared<DFTGrid>(primary_->molecule(), primary_, grid_int_options, grid_str_options,
+                                     grid_float_options, Process::environment.options);
+}
+
+SharedMatrix THC::compute_collocation(std::shared_ptr<DFTGrid> grid, SharedMatrix xyzw) {
+    size_t ngrid = grid->npoints();
+    auto phi = std::make_shared<Matrix>("THC Grid Collocation", ngrid, nbf_);
+    double** phip = phi->pointer();
+    double** xyzwp = xyzw->pointer();
+
+    const auto& blocks = grid->blocks();
+    std::vector<size_t> offsets(blocks.size() + 1, 0);
+    for (size_t b = 0; b < blocks.size(); b++) offsets[b + 1] = offsets[b] + blocks[b]->npoints();
+
+    std::vector<std::shared_ptr<BasisFunctions>> bf_computers(nthreads_);
+    for (int thread = 0; thread < nthreads_; thread++) {
+        bf_computers[thread] = std::make_shared<BasisFunctions>(primary_, grid->max_points(), grid->max_functions());
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t b = 0; b < blocks.size(); b++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        const auto& block = blocks[b];
+        size_t npoints_block = block->npoints();
+        size_t nbf_block = block->local_nbf();
+        const auto& bf_map = block->functions_local_to_global();
+        double* x = block->x();
+        double* y = block->y();
+        double* z = block->z();
+        double* w = block->w();
+
+        bf_computers[rank]->compute_functions(block);
+        double** point_values = bf_computers[rank]->basis_values()["PHI"]->pointer();
+
+        for (size_t p = 0; p < npoints_block; p++) {
+            size_t g = offsets[b] + p;
+            xyzwp[g][0] = x[p];
+            xyzwp[g][1] = y[p];
+            xyzwp[g][2] = z[p];
+            xyzwp[g][3] = w[p];
+            // Points with no quadrature weight never become pivots
+            double scale = (w[p] > 0.0 ? std::pow(w[p], 0.25) : 0.0);
+            for (size_t k = 0; k < nbf_block; k++) {
+                phip[g][bf_map[k]] = scale * point_values[p][k];
+            }
+        }
+    }
+
+    return phi;
+}
+
+void THC::select_points(SharedMatrix phi, SharedMatrix xyzw) {
+    size_t ngrid = phi->rowspi()[0];
+    double** phip = phi->pointer();
+
+    // The ISDF tolerance is relative to the largest weighted pair density
+    double Gmax = 0.0;
+    for (size_t g = 0; g < ngrid; g++) {
+        double val = C_DDOT(nbf_, phip[g], 1, phip[g], 1);
+        Gmax = std::max(Gmax, val * val);
+    }
+    if (Gmax == 0.0) throw PSIEXCEPTION("THC: the collocation grid is empty.");
+
+    CholeskyISDF isdf(phi, tolerance_ * Gmax, memory_);
+    isdf.set_nthread(nthreads_);
+    isdf.choleskify();
+
+    const auto& pivots = isdf.pivots();
+    npoint_ = pivots.size();
+
+    X_ = std::make_shared<Matrix>("THC X", nbf_, npoint_);
+    points_ = std::make_shared<Matrix>("THC Points", npoint_, 4);
+    double** Xp = X_->pointer();
+    double** Pp = points_->pointer();
+    double** xyzwp = xyzw->pointer();
+    for (size_t P = 0; P < npoint_; P++) {
+        for (size_t m = 0; m < nbf_; m++) Xp[m][P] = phip[pivots[P]][m];
+        for (size_t k = 0; k < 4; k++) Pp[P][k] = xyzwp[pivots[P]][k];
+    }
+}
+
+void THC::build_core() {
+    // => Point metric S_PQ = (X^T X)_PQ^2 and its pseudoinverse <= //
+    auto S = linalg::doublet(X_, X_, true, false);
+    double** Sp = S->pointer();
+    for (size_t P = 0; P < npoint_; P++) {
+        for (size_t Q = 0; Q < npoint_; Q++) Sp[P][Q] *= Sp[P][Q];
+    }
+    S->power(-1.0, condition_);
+
+    // => Fitted AO tensor B^A_mn <= //
+    auto dfh = std::make_shared<DFHelper>(primary_, aux_);
+    // Half of the workspace for DFHelper, half for the blocks of B below
+    dfh->set_memory(memory_ / 2);
+    dfh->set_nthreads(nthreads_);
+    dfh->set_print_lvl(0);
+    dfh->initialize();
+    auto I = std::make_shared<Matrix>("I", nbf_, nbf_);
+    I->identity();
+    dfh->add_space("m", I);
+    dfh->add_transformation("B", "m", "m", "Qpq");
+    dfh->transform();
+
+    // => E_AP = sum_mn B^A_mn X_mP X_nP, in blocks of A <= //
+    auto E = std::make_shared<Matrix>("THC E", naux_, npoint_);
+    double** Ep = E->pointer();
+    double** Xp = X_->pointer();
+
+    size_t per_A = nbf_ * nbf_;
+    size_t scratch = nthreads_ * nbf_ * npoint_;
+    size_t max_A = (memory_ / 2 > scratch + per_A ? (memory_ / 2 - scratch) / per_A : 1);
+    max_A = std::max<size_t>(1, std::min(max_A, naux_));
+
+    std::vector<double> Bbuf(max_A * per_A);
+    std::vector<SharedMatrix> T(nthreads_);
+    for (int thread = 0; thread < nthreads_; thread++) T[thread] = std::make_shared<Matrix>("T", nbf_, npoint_);
+
+    for (size_t A0 = 0; A0 < naux_; A0 += max_A) {
+        size_t nA = std::min(max_A, naux_ - A0);
+        dfh->fill_tensor("B", Bbuf.data(), {A0, A0 + nA});
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+        for (size_t A = 0; A < nA; A++) {
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            double** Tp = T[rank]->pointer();
+            C_DGEMM('N', 'N', nbf_, npoint_, nbf_, 1.0, &Bbuf[A * per_A], nbf_, Xp[0], npoint_, 0.0, Tp[0],
+                    npoint_);
+            double* EAp = Ep[A0 + A];
+            for (size_t P = 0; P < npoint_; P++) EAp[P] = 0.0;
+            for (size_t m = 0; m < nbf_; m++) {
+                for (size_t P = 0; P < npoint_; P++) EAp[P] += Xp[m][P] * Tp[m][P];
+            }
+        }
+    }
+    dfh->clear_all();
+
+    // => Z = S^-1 E^T E S^-1 = W^T W, W = E S^-1 <= //
+    auto W = linalg::doublet(E, S, false, false);
+    Z_ = linalg::doublet(W, W, true, false);
+    Z_->set_name("THC Z");
+}
+
+void THC::build() {
+    timer_on("THC: build");
+    if (print_lvl_ > 0) print_header();
+
+    auto grid = build_grid();
+    auto xyzw = std::make_shared<Matrix>("THC Grid", grid->npoints(), 4);
+
+    timer_on("THC: collocation");
+    auto phi = compute_collocation(grid, xyzw);
+    timer_off("THC: collocation");
+
+    timer_on("THC: ISDF points");
+    select_points(phi, xyzw);
+    timer_off("THC: ISDF points");
+    phi.reset();
+
+    timer_on("THC: core");
+    build_core();
+    timer_off("THC: core");
+
+    built_ = true;
+    if (print_lvl_ > 0) {
+        outfile->Printf("    Selected %zu interpolation points from %d grid points (%.2f per basis function).\n\n",
+                        npoint_, grid->npoints(), npoint_ / (double)nbf_);
+    }
+    timer_off("THC: build");
+}
+
+SharedMatrix THC::transform(SharedMatrix C) const {
+    if (!built_) throw PSIEXCEPTION("THC: call build() before transform().");
+    return linalg::doublet(C, X_, true, false);
+}
+
+}  // namespace psi
@@ -0,0 +1,129 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef three_index_thc
+#define three_index_thc
+
+#include "psi4/pragma.h"
+#include "psi4/libmints/typedefs.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace psi {
+
+class BasisSet;
+class DFTGrid;
+
+///
+/// Least-squares tensor hypercontraction of the density-fitted ERIs,
+///   (mn|ls) ~= X_mP X_nP Z_PQ X_lQ X_sQ,
+/// with the interpolation points P chosen from a DFTGrid by interpolative separable
+/// density fitting (ISDF): a pivoted Cholesky decomposition of the grid Gram matrix of
+/// the weighted orbital products, G_gh = (sum_m X_mg X_mh)^2. Only the collocation
+/// matrix X (nbf x npoint) and the core Z (npoint x npoint) are kept.
+///
+class PSI_API THC {
+   protected:
+    // => Basis and sizes <= //
+    std::shared_ptr<BasisSet> primary_;
+    std::shared_ptr<BasisSet> aux_;
+    size_t nbf_;
+    size_t naux_;
+    size_t npoint_ = 0;
+
+    // => Control <= //
+    size_t memory_ = 256000000L;
+    int nthreads_ = 1;
+    int print_lvl_ = 1;
+    /// Pivots are taken while the residual Gram diagonal exceeds tolerance_ times its largest value
+    double tolerance_ = 1.0E-6;
+    /// Relative eigenvalue cutoff for the pseudoinverse of the point metric
+    double condition_ = 1.0E-12;
+    int radial_points_ = 50;
+    int spherical_points_ = 110;
+
+    // => Factors <= //
+    /// Collocation at the interpolation points (nbf x npoint), scaled by w^(1/4)
+    SharedMatrix X_;
+    /// Core tensor (npoint x npoint)
+    SharedMatrix Z_;
+    /// Interpolation points (npoint x 4): x, y, z and quadrature weight
+    SharedMatrix points_;
+    bool built_ = false;
+
+    /// Build the grid used as the ISDF candidate set
+    std::shared_ptr<DFTGrid> build_grid();
+    /// Weighted collocation of the full grid (ngrid x nbf)
+    SharedMatrix compute_collocation(std::shared_ptr<DFTGrid> grid, SharedMatrix xyzw);
+    /// Select the interpolation points and fill X_ and points_
+    void select_points(SharedMatrix phi, SharedMatrix xyzw);
+    /// Fit the core Z_ against the DF tensor
+    void build_core();
+
+   public:
+    THC(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> aux);
+    ~THC();
+
+    ///
+    /// Specify workspace in doubles, bounds the ISDF decomposition and the DF blocks
+    ///
+    void set_memory(size_t doubles) { memory_ = doubles; }
+    size_t get_memory() const { return memory_; }
+    void set_nthreads(int nthreads) { nthreads_ = nthreads; }
+    void set_print_lvl(int print_lvl) { print_lvl_ = print_lvl; }
+    /// Relative ISDF pivot tolerance (default 1.0E-6), tighter means more points
+    void set_tolerance(double tolerance) { tolerance_ = tolerance; }
+    double get_tolerance() const { return tolerance_; }
+    void set_condition(double condition) { condition_ = condition; }
+    /// Candidate grid size (default 50 radial x 110 spherical points per atom)
+    void set_grid(int radial_points, int spherical_points) {
+        radial_points_ = radial_points;
+        spherical_points_ = spherical_points;
+    }
+
+    /// Build X and Z
+    void build();
+    void print_header();
+
+    // => Accessors <= //
+    /// Number of interpolation points
+    size_t npoint() const { return npoint_; }
+    /// AO collocation at the interpolation points (nbf x npoint)
+    SharedMatrix X() const { return X_; }
+    /// Core tensor (npoint x npoint)
+    SharedMatrix Z() const { return Z_; }
+    /// Interpolation points (npoint x 4): x, y, z and weight
+    SharedMatrix points() const { return points_; }
+    /// Collocation of the orbitals C (nbf x nmo) at the interpolation points, C^T X (nmo x npoint)
+    SharedMatrix transform(SharedMatrix C) const;
+};
+
+}  // namespace psi
+#endif
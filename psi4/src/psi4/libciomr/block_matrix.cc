@@ -38,6 +38,7 @@
 #include "psi4/psifiles.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libciomr/libciomr.h"
 #ifdef _POSIX_MEMLOCK
 #include <sys/mman.h>
 #endif
@@ -54,6 +55,8 @@ namespace psi {
 ** returns the pointer to the first row pointer.  This allows transparent
 ** 2d-array style access, but keeps memory together such that the matrix
 ** could be used in conjunction with FORTRAN matrix routines.
+** The data block comes from block_pool_alloc() and starts on a cache line
+** while the block pool is on, and from new[] otherwise.
 **
 ** Allocates memory for an n x m matrix and returns a pointer to the
 ** first row.
@@ -87,13 +90,7 @@ PSI_API double **block_matrix(size_t n, size_t m, bool memlock) {
         exit(PSI_RETURN_FAILURE);
     }
 
-    B = new double[n * m];
-    if (B == nullptr) {
-        outfile->Printf("block_matrix: trouble allocating memory \n");
-        outfile->Printf("m = %ld\n", m);
-        exit(PSI_RETURN_FAILURE);
-    }
-    memset(static_cast<void *>(B), 0, m * n * sizeof(double));
+    B = (block_pool_enabled() ? block_pool_alloc(n * m) : new double[n * m]());
 
     for (i = 0; i < n; i++) {
         A[i] = &(B[i * m]);
@@ -147,7 +144,7 @@ PSI_API double **block_matrix(size_t n, size_t m, bool memlock) {
 */
 void PSI_API free_block(double **array) {
     if (array == nullptr) return;
-    delete[] array[0];
+    if (!block_pool_free(array[0])) delete[] array[0];
     delete[] array;
 }
 }
@@ -0,0 +1,279 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+\file
+\brief Aligned, pooled storage behind block_matrix() and Matrix
+\ingroup CIOMR
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/psi4-dec.h"
+
+namespace psi {
+
+namespace {
+
+/*
+** Data blocks of block_matrix() and Matrix come from here. Every block starts on a cache line, and
+** blocks are rounded up to size classes so that a freed block can serve the next request of similar
+** size. Freed blocks are only kept while the pool has a nonzero limit (see set_block_pool), and the
+** kept bytes never exceed it; otherwise they go straight back to the system.
+**
+** The pool is off until set_block_pool() asks for a limit or huge pages. While it is off,
+** block_matrix() and Matrix allocate as they did before the pool and never take its lock, and
+** block_pool_free() turns away every block without a lookup once no pooled block is left.
+*/
+struct BlockPool {
+    std::mutex lock;
+    size_t limit = 0;
+    bool huge_pages = false;
+    std::atomic<bool> enabled{false};
+    std::atomic<size_t> nlive{0};  // blocks in live
+    std::multimap<size_t, double *> free_blocks;  // class bytes -> data
+    std::unordered_map<double *, size_t> live;    // data -> class bytes
+    size_t live_bytes = 0;
+    size_t pooled_bytes = 0;
+    size_t peak_bytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+// Never destroyed, so Matrix objects released during interpreter shutdown still find it
+BlockPool &block_pool() {
+    static BlockPool *pool = new BlockPool;
+    return *pool;
+}
+
+const size_t cache_line = 64;
+const size_t huge_page = 2L << 20;
+
+// Blocks at least this large are zeroed by all threads, so their pages land on the NUMA node of the
+// thread that will later work on them under a static schedule
+const size_t parallel_touch_bytes = 4L << 20;
+
+// Cache lines up to 4 kB, then four classes per power of two (at most 25% padding)
+size_t block_class(size_t bytes) {
+    if (bytes <= 4096) return ((bytes + cache_line - 1) / cache_line) * cache_line;
+    size_t top = 1;
+    while ((top << 1) <= bytes) top <<= 1;
+    size_t step = top / 4;
+    return ((bytes + step - 1) / step) * step;
+}
+
+void drop_free_blocks(BlockPool &pool, size_t needed) {
+    while (!pool.free_blocks.empty() && pool.pooled_bytes + needed > pool.limit) {
+        auto it = std::prev(pool.free_blocks.end());
+        pool.pooled_bytes -= it->first;
+        ::free(it->second);
+        pool.free_blocks.erase(it);
+    }
+}
+
+void zero_block(double *data, size_t n) {
+#ifdef _OPENMP
+    if (n * sizeof(double) >= parallel_touch_bytes && !omp_in_parallel()) {
+#pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < n; i++) data[i] = 0.0;
+        return;
+    }
+#endif
+    ::memset(static_cast<void *>(data), 0, n * sizeof(double));
+}
+
+}  // namespace
+
+/*!
+** block_pool_enabled(): Whether set_block_pool() turned the pool on
+**
+** Callers allocate their blocks without the pool while it is off.
+**
+** \ingroup CIOMR
+*/
+bool block_pool_enabled() { return block_pool().enabled.load(std::memory_order_relaxed); }
+
+/*!
+** block_pool_alloc(): Allocate n zeroed doubles starting on a cache line
+**
+** The memory must be returned with block_pool_free().
+**
+** \ingroup CIOMR
+*/
+double *block_pool_alloc(size_t n) {
+    if (!n) return nullptr;
+
+    BlockPool &pool = block_pool();
+    size_t bytes = block_class(n * sizeof(double));
+    double *data = nullptr;
+    bool huge = false;
+    {
+        std::lock_guard<std::mutex> guard(pool.lock);
+        auto it = pool.free_blocks.find(bytes);
+        if (it != pool.free_blocks.end()) {
+            data = it->second;
+            pool.pooled_bytes -= bytes;
+            pool.free_blocks.erase(it);
+            pool.hits++;
+        } else {
+            pool.misses++;
+            huge = pool.huge_pages && bytes >= huge_page;
+        }
+    }
+
+    if (!data) {
+        void *ptr = nullptr;
+        if (posix_memalign(&ptr, huge ? huge_page : cache_line, bytes)) {
+            throw PSIEXCEPTION("block_pool_alloc: trouble allocating memory");
+        }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (huge) madvise(ptr, bytes, MADV_HUGEPAGE);
+#endif
+        data = static_cast<double *>(ptr);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(pool.lock);
+        pool.live[data] = bytes;
+        pool.nlive++;
+        pool.live_bytes += bytes;
+        pool.peak_bytes = std::max(pool.peak_bytes, pool.live_bytes);
+    }
+
+    zero_block(data, n);
+    return data;
+}
+
+/*!
+** block_pool_free(): Return a block from block_pool_alloc()
+**
+** Returns false, and leaves the memory alone, if the block did not come from block_pool_alloc().
+**
+** \ingroup CIOMR
+*/
+bool block_pool_free(double *data) {
+    if (data == nullptr) return true;
+
+    BlockPool &pool = block_pool();
+    if (!pool.nlive.load()) return false;
+    std::lock_guard<std::mutex> guard(pool.lock);
+    auto it = pool.live.find(data);
+    if (it == pool.live.end()) return false;
+
+    size_t bytes = it->second;
+    pool.live.erase(it);
+    pool.nlive--;
+    pool.live_bytes -= bytes;
+    if (bytes <= pool.limit) {
+        drop_free_blocks(pool, bytes);
+        pool.free_blocks.emplace(bytes, data);
+        pool.pooled_bytes += bytes;
+    } else {
+        ::free(data);
+    }
+    return true;
+}
+
+/*!
+** set_block_pool(): Set how many bytes of freed blocks are kept for reuse
+**
+** \param limit = bytes of freed blocks kept; 0 returns every freed block to the system
+** \param huge_pages = ask for transparent huge pages on blocks of 2 MB and more (Linux only)
+**
+** With a limit of 0 and no huge pages the pool is off: new blocks bypass it, and the blocks
+** it still hands out go back to the system when freed.
+**
+** \ingroup CIOMR
+*/
+void set_block_pool(size_t limit, bool huge_pages) {
+    BlockPool &pool = block_pool();
+    std::lock_guard<std::mutex> guard(pool.lock);
+    pool.limit = limit;
+    pool.huge_pages = huge_pages;
+    pool.enabled = (limit || huge_pages);
+    drop_free_blocks(pool, 0);
+}
+
+/*!
+** block_pool_stats(): Reuse counters of the block pool
+**
+** Blocks allocated while the pool is off are not counted.
+**
+** \param hits = allocations served by a freed block
+** \param misses = allocations that went to the system
+** \param live_bytes = bytes currently handed out
+** \param peak_bytes = largest live_bytes since the last call with reset
+** \param pooled_bytes = bytes of freed blocks currently kept
+** \param reset = zero the counters and the peak afterwards
+**
+** \ingroup CIOMR
+*/
+void block_pool_stats(size_t &hits, size_t &misses, size_t &live_bytes, size_t &peak_bytes, size_t &pooled_bytes,
+                      bool reset) {
+    BlockPool &pool = block_pool();
+    std::lock_guard<std::mutex> guard(pool.lock);
+    hits = pool.hits;
+    misses = pool.misses;
+    live_bytes = pool.live_bytes;
+    peak_bytes = pool.peak_bytes;
+    pooled_bytes = pool.pooled_bytes;
+    if (reset) {
+        pool.hits = 0;
+        pool.misses = 0;
+        pool.peak_bytes = pool.live_bytes;
+    }
+}
+
+/*!
+** print_block_pool(): Print the reuse counters of the block pool to the output file
+**
+** \ingroup CIOMR
+*/
+void print_block_pool() {
+    size_t hits, misses, live, peak, pooled;
+    block_pool_stats(hits, misses, live, peak, pooled, false);
+    outfile->Printf("\n  Block pool: %zu blocks reused, %zu allocated, %.2f MB live, %.2f MB peak, %.2f MB kept\n",
+                    hits, misses, live / (1024.0 * 1024.0), peak / (1024.0 * 1024.0), pooled / (1024.0 * 1024.0));
+}
+
+}  // namespace psi
@@ -112,6 +112,15 @@ PSI_API size_t *init_size_t_array(int size);
 PSI_API double **block_matrix(size_t n, size_t m, bool mlock = false);
 PSI_API void free_block(double **array);
 
+/* Functions in block_pool.cc */
+PSI_API bool block_pool_enabled();
+PSI_API double *block_pool_alloc(size_t n);
+PSI_API bool block_pool_free(double *data);
+PSI_API void set_block_pool(size_t limit, bool huge_pages = false);
+PSI_API void block_pool_stats(size_t &hits, size_t &misses, size_t &live_bytes, size_t &peak_bytes,
+                              size_t &pooled_bytes, bool reset = false);
+PSI_API void print_block_pool();
+
 /* Functions in fndcor */
 PSI_API void fndcor(long int *maxcrb, std::string out_fname);
 }  // namespace psi
@@ -158,6 +158,7 @@ void CubicScalarGrid::populate_grid() {
     nxyz_ = std::llround(pow((double)max_points, 1.0 / 3.0));
 
     blocks_.clear();
+    block_offsets_.clear();
     size_t offset = 0L;
     for (int istart = 0L; istart <= N_[0]; istart += nxyz_) {
         int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
@@ -166,6 +167,7 @@ void CubicScalarGrid::populate_grid() {
             for (int kstart = 0L; kstart <= N_[2]; kstart += nxyz_) {
                 int nk = (kstart + nxyz_ > N_[2] ? (N_[2] + 1) - kstart : nxyz_);
 
+                block_offsets_.push_back(offset);
                 double* xp = &x_[offset];
                 double* yp = &y_[offset];
                 double* zp = &z_[offset];
@@ -198,6 +200,16 @@ void CubicScalarGrid::populate_grid() {
 
     points_ = std::make_shared<RKSFunctions>(primary_, max_points, max_functions);
     points_->set_ansatz(0);
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+#endif
+    thread_points_.clear();
+    for (int thread = 0; thread < nthreads; thread++) {
+        thread_points_.push_back(std::make_shared<RKSFunctions>(primary_, max_points, max_functions));
+        thread_points_.back()->set_ansatz(0);
+    }
 }
 void CubicScalarGrid::print_header() {
     outfile->Printf("  ==> CubicScalarGrid <==\n\n");
@@ -225,13 +237,13 @@ void CubicScalarGrid::write_gen_file(double* v, const std::string& name, const s
                                      const std::string& comment) {
     if (type == "CUBE") {
         write_cube_file(v, name, comment);
+    } else if (type == "RAW") {
+        write_raw_file(v, name, comment);
     } else {
         throw PSIEXCEPTION("CubicScalarGrid: Unrecognized output file type");
     }
 }
-void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const std::string& comment) {
-    // => Reorder the grid <= //
-
+std::vector<double> CubicScalarGrid::cube_ordered(double* v) {
     auto v2 = std::vector<double>(npoints_);
     size_t offset = 0L;
     for (int istart = 0L; istart <= N_[0]; istart += nxyz_) {
@@ -252,6 +264,12 @@ void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const
             }
         }
     }
+    return v2;
+}
+void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const std::string& comment) {
+    // => Reorder the grid <= //
+
+    auto v2 = cube_ordered(v);
 
     // => Drop the grid out <= //
 
@@ -292,17 +310,62 @@ void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const
 
     fclose(fh);
 }
+void CubicScalarGrid::write_raw_file(double* v, const std::string& name, const std::string& comment) {
+    // => Reorder the grid <= //
+
+    auto v2 = cube_ordered(v);
+    std::vector<float> vf(v2.begin(), v2.end());
+
+    // => Drop the grid out (layout documented with CUBEPROP_FORMAT) <= //
+
+    std::stringstream ss;
+    ss << filepath_ << "/" << name << ".raw";
+
+    // Is filepath a valid directory?
+    if (filesystem::path(filepath_).make_absolute().is_directory() == false) {
+        printf("Filepath \"%s\" is not valid.  Please create this directory.\n", filepath_.c_str());
+        outfile->Printf("Filepath \"%s\" is not valid.  Please create this directory.\n", filepath_.c_str());
+        exit(Failure);
+    }
+
+    FILE* fh = fopen(ss.str().c_str(), "wb");
+    fwrite("PSI4RAW1", 1, 8, fh);
+
+    int32_t npts[3] = {N_[0] + 1, N_[1] + 1, N_[2] + 1};
+    fwrite(npts, sizeof(int32_t), 3, fh);
+    fwrite(O_.data(), sizeof(double), 3, fh);
+    fwrite(D_.data(), sizeof(double), 3, fh);
+
+    int32_t natom = mol_->natom();
+    fwrite(&natom, sizeof(int32_t), 1, fh);
+    for (int A = 0; A < natom; A++) {
+        double atom[4] = {(double)mol_->true_atomic_number(A), mol_->x(A), mol_->y(A), mol_->z(A)};
+        fwrite(atom, sizeof(double), 4, fh);
+    }
+
+    std::string property = "Property: " + name + comment;
+    int32_t ncomment = property.size();
+    fwrite(&ncomment, sizeof(int32_t), 1, fh);
+    fwrite(property.data(), 1, ncomment, fh);
+
+    fwrite(vf.data(), sizeof(float), vf.size(), fh);
+    fclose(fh);
+}
 void CubicScalarGrid::add_density(double* v, std::shared_ptr<Matrix> D) {
-    points_->set_pointers(D);
-    std::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    double* rhop = rho->pointer();
+    for (auto& worker : thread_points_) worker->set_pointers(D);
 
-    size_t offset = 0L;
+    // Blocks write disjoint ranges of v
+#pragma omp parallel for schedule(dynamic) num_threads(thread_points_.size())
     for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        auto& worker = thread_points_[thread];
+        worker->compute_points(blocks_[ind]);
+        double* rhop = worker->point_value("RHO_A")->pointer();
         size_t npoints = blocks_[ind]->npoints();
-        C_DAXPY(npoints, 0.5, rhop, 1, &v[offset], 1);
-        offset += npoints;
+        C_DAXPY(npoints, 0.5, rhop, 1, &v[block_offsets_[ind]], 1);
     }
 }
 void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::vector<double>& nuc_weights) {
@@ -500,20 +563,24 @@ void CubicScalarGrid::add_basis_functions(double** v, const std::vector<int>& in
 void CubicScalarGrid::add_orbitals(double** v, std::shared_ptr<Matrix> C) {
     int na = C->colspi()[0];
 
-    points_->set_Cs(C);
-    std::shared_ptr<Matrix> psi = points_->orbital_value("PSI_A");
-    double** psip = psi->pointer();
+    for (auto& worker : thread_points_) worker->set_Cs(C);
 
-    size_t offset = 0L;
+    // All orbitals of a block are evaluated in one pass; blocks write disjoint ranges of v
+#pragma omp parallel for schedule(dynamic) num_threads(thread_points_.size())
     for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_orbitals(blocks_[ind]);
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        auto& worker = thread_points_[thread];
+        worker->compute_orbitals(blocks_[ind]);
+        double** psip = worker->orbital_value("PSI_A")->pointer();
 
         size_t npoints = blocks_[ind]->npoints();
+        size_t offset = block_offsets_[ind];
         for (int a = 0; a < na; a++) {
             C_DAXPY(npoints, 1.0, psip[a], 1, &v[a][offset], 1);
         }
-
-        offset += npoints;
     }
 }
 void CubicScalarGrid::add_LOL(double* v, std::shared_ptr<Matrix> D) {
@@ -577,14 +644,37 @@ void CubicScalarGrid::add_ELF(double* v, std::shared_ptr<Matrix> D) {
 void CubicScalarGrid::compute_density(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type) {
     auto v = std::vector<double>(npoints_, 0);
     add_density(v.data(), D);
+    write_density(v.data(), name, type);
+}
+void CubicScalarGrid::compute_spin_densities(std::shared_ptr<Matrix> Da, std::shared_ptr<Matrix> Db,
+                                             const std::string& type) {
+    auto va = std::vector<double>(npoints_, 0);
+    auto vb = std::vector<double>(npoints_, 0);
+    add_density(va.data(), Da);
+    add_density(vb.data(), Db);
+
+    // The grid values are linear in D, so Dt and Ds need no further collocation
+    auto vt = std::vector<double>(npoints_);
+    auto vs = std::vector<double>(npoints_);
+    for (size_t P = 0L; P < npoints_; P++) {
+        vt[P] = va[P] + vb[P];
+        vs[P] = va[P] - vb[P];
+    }
+
+    write_density(vt.data(), "Dt", type);
+    write_density(vs.data(), "Ds", type);
+    write_density(va.data(), "Da", type);
+    write_density(vb.data(), "Db", type);
+}
+void CubicScalarGrid::write_density(double* v, const std::string& name, const std::string& type) {
     // Get adaptive isocountour range
-    std::pair<double, double> isocontour_range = compute_isocontour_range(v.data(), 1.0);
+    std::pair<double, double> isocontour_range = compute_isocontour_range(v, 1.0);
     double density_percent = 100.0 * options_.get_double("CUBEPROP_ISOCONTOUR_THRESHOLD");
     std::stringstream comment;
     comment << " [e/a0^3]. Isocontour range for " << density_percent << "% of the density: (" << isocontour_range.first
             << "," << isocontour_range.second << ")." << ecp_header();
     // Write to disk
-    write_gen_file(v.data(), name, type, comment.str());
+    write_gen_file(v, name, type, comment.str());
 }
 void CubicScalarGrid::compute_esp(std::shared_ptr<Matrix> D, const std::vector<double>& w, const std::string& name,
                                   const std::string& type) {
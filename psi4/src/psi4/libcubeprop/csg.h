@@ -91,11 +91,17 @@ class CubicScalarGrid {
     std::shared_ptr<BasisExtents> extents_;
     /// RKS points object
     std::shared_ptr<RKSFunctions> points_;
+    /// RKS points objects, one per thread, for the block-parallel densities and orbitals
+    std::vector<std::shared_ptr<RKSFunctions> > thread_points_;
+    /// Offset of each block in the fast ordering
+    std::vector<size_t> block_offsets_;
 
     // => Helper Routines <= //
 
     /// Setup grid from info in N_, D_, O_
     void populate_grid();
+    /// Scalar field v (in fast ordering) in cube ordering (x slowest, z fastest)
+    std::vector<double> cube_ordered(double* v);
 
    public:
     // => Constructors <= //
@@ -155,6 +161,8 @@ class CubicScalarGrid {
     void write_gen_file(double* v, const std::string& name, const std::string& type, const std::string& comment = "");
     /// Write a Gaussian cube file of the scalar field v (in fast ordering) to filepath/name.cube
     void write_cube_file(double* v, const std::string& name, const std::string& comment = "");
+    /// Write a binary single-precision file of the scalar field v (in fast ordering) to filepath/name.raw
+    void write_raw_file(double* v, const std::string& name, const std::string& comment = "");
 
     // => Low-Level Scalar Field Computation (Use only if you know what you are doing) <= //
 
@@ -175,6 +183,10 @@ class CubicScalarGrid {
 
     /// Compute a density-type property and drop a file corresponding to name and type
     void compute_density(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type = "CUBE");
+    /// Compute the total, spin, alpha and beta densities (Dt, Ds, Da, Db) from two collocation passes
+    void compute_spin_densities(std::shared_ptr<Matrix> Da, std::shared_ptr<Matrix> Db, const std::string& type = "CUBE");
+    /// Drop a file of an already computed density-type property v, corresponding to name and type
+    void write_density(double* v, const std::string& name, const std::string& type = "CUBE");
     /// Compute an ESP-type property and drop a file corresponding to name and type
     void compute_esp(std::shared_ptr<Matrix> D, const std::vector<double>& nuc_weights, const std::string& name,
                      const std::string& type = "CUBE");
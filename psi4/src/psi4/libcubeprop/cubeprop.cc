@@ -107,16 +107,7 @@ void CubeProperties::raw_compute_properties() {
         std::string task = options_["CUBEPROP_TASKS"][ind].to_string();
 
         if (task == "DENSITY") {
-            std::shared_ptr<Matrix> Dt(Da_->clone());
-            std::shared_ptr<Matrix> Ds(Da_->clone());
-            Dt->copy(Da_);
-            Ds->copy(Da_);
-            Dt->add(Db_);
-            Ds->subtract(Db_);
-            compute_density(Dt, "Dt");
-            compute_density(Ds, "Ds");
-            compute_density(Da_, "Da");
-            compute_density(Db_, "Db");
+            grid_->compute_spin_densities(Da_, Db_, options_.get_str("CUBEPROP_FORMAT"));
         } else if (task == "ESP") {
             std::shared_ptr<Matrix> Dt(Da_->clone());
             Dt->copy(Da_);
@@ -235,23 +226,27 @@ void CubeProperties::raw_compute_properties() {
     }
 }
 void CubeProperties::compute_density(std::shared_ptr<Matrix> D, const std::string& key) {
-    grid_->compute_density(D, key);
+    grid_->compute_density(D, key, options_.get_str("CUBEPROP_FORMAT"));
 }
 void CubeProperties::compute_esp(std::shared_ptr<Matrix> Dt, const std::vector<double>& w) {
-    grid_->compute_density(Dt, "Dt");
-    grid_->compute_esp(Dt, w, "ESP");
+    grid_->compute_density(Dt, "Dt", options_.get_str("CUBEPROP_FORMAT"));
+    grid_->compute_esp(Dt, w, "ESP", options_.get_str("CUBEPROP_FORMAT"));
 }
 void CubeProperties::compute_orbitals(std::shared_ptr<Matrix> C, const std::vector<int>& indices,
                                       const std::vector<std::string>& labels, const std::string& key) {
-    grid_->compute_orbitals(C, indices, labels, key);
+    grid_->compute_orbitals(C, indices, labels, key, options_.get_str("CUBEPROP_FORMAT"));
 }
 void CubeProperties::compute_difference(std::shared_ptr<Matrix> C, const std::vector<int>& indices,
                                       const std::string& label, bool square) {
-    grid_->compute_difference(C, indices, label, square);
+    grid_->compute_difference(C, indices, label, square, options_.get_str("CUBEPROP_FORMAT"));
 }
 void CubeProperties::compute_basis_functions(const std::vector<int>& indices, const std::string& key) {
-    grid_->compute_basis_functions(indices, key);
+    grid_->compute_basis_functions(indices, key, options_.get_str("CUBEPROP_FORMAT"));
+}
+void CubeProperties::compute_LOL(std::shared_ptr<Matrix> D, const std::string& key) {
+    grid_->compute_LOL(D, key, options_.get_str("CUBEPROP_FORMAT"));
+}
+void CubeProperties::compute_ELF(std::shared_ptr<Matrix> D, const std::string& key) {
+    grid_->compute_ELF(D, key, options_.get_str("CUBEPROP_FORMAT"));
 }
-void CubeProperties::compute_LOL(std::shared_ptr<Matrix> D, const std::string& key) { grid_->compute_LOL(D, key); }
-void CubeProperties::compute_ELF(std::shared_ptr<Matrix> D, const std::string& key) { grid_->compute_ELF(D, key); }
 }  // namespace psi
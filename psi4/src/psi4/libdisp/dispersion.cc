@@ -51,6 +51,14 @@
 #include <sstream>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
@@ -164,9 +172,44 @@ void Dispersion::print(std::string out, int level) const {
     printer->Printf("    S6  = %14.6E\n", s6_);
     if ((name_ == "-D1") || (name_ == "-D2") || (name_ == "-CHG") || (name_ == "-D2GR"))
         printer->Printf("    A6  = %14.6E\n", d_);
+    if (cutoff_ > 0.0) printer->Printf("    Cutoff = %14.6E [a0]\n", cutoff_);
     printer->Printf("\n");
 }
 
+std::vector<std::vector<int>> Dispersion::lower_neighbors(const Matrix &geom) const {
+    // Cubic cells of edge cutoff_, so the partners of an atom are in its own or the 26 adjacent cells
+    int natom = geom.rowdim();
+    std::map<std::array<long, 3>, std::vector<int>> cells;
+    std::vector<std::array<long, 3>> cell_of(natom);
+    for (int i = 0; i < natom; i++) {
+        for (int x = 0; x < 3; x++) cell_of[i][x] = (long)std::floor(geom.get(i, x) / cutoff_);
+        cells[cell_of[i]].push_back(i);
+    }
+
+    double cutoff2 = cutoff_ * cutoff_;
+    std::vector<std::vector<int>> neighbors(natom);
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < natom; i++) {
+        const std::array<long, 3> &c = cell_of[i];
+        for (long dx = -1; dx <= 1; dx++) {
+            for (long dy = -1; dy <= 1; dy++) {
+                for (long dz = -1; dz <= 1; dz++) {
+                    auto it = cells.find({c[0] + dx, c[1] + dy, c[2] + dz});
+                    if (it == cells.end()) continue;
+                    for (int j : it->second) {
+                        if (j >= i) continue;
+                        double R2 = 0.0;
+                        for (int x = 0; x < 3; x++) R2 += std::pow(geom.get(j, x) - geom.get(i, x), 2);
+                        if (R2 <= cutoff2) neighbors[i].push_back(j);
+                    }
+                }
+            }
+        }
+        std::sort(neighbors[i].begin(), neighbors[i].end());
+    }
+    return neighbors;
+}
+
 std::string Dispersion::print_energy(std::shared_ptr<Molecule> m) {
     double e = compute_energy(m);
     std::stringstream s;
@@ -323,13 +366,26 @@ double Dispersion::compute_energy(std::shared_ptr<Molecule> m) {
     } else {
         std::shared_ptr<Vector> atom_list = set_atom_list(m);
         double *atom_list_p = atom_list->pointer();
-        for (int i = 0; i < m->natom(); i++) {
-            for (int j = 0; j < i; j++) {
+        if (C6_type_ != C6_arit && C6_type_ != C6_geom) throw PSIEXCEPTION("Unrecognized C6 Type");
+        if (Damping_type_ != Damping_D1 && Damping_type_ != Damping_CHG)
+            throw PSIEXCEPTION("Unrecognized Damping Function");
+
+        // Coordinates are read once, outside the threaded loop
+        Matrix geom = m->geometry();
+        double **xyz = geom.pointer();
+        std::vector<std::vector<int>> neighbors;
+        if (cutoff_ > 0.0) neighbors = lower_neighbors(geom);
+        int natom = m->natom();
+#pragma omp parallel for schedule(dynamic) reduction(+ : E)
+        for (int i = 0; i < natom; i++) {
+            int npartner = (cutoff_ > 0.0) ? neighbors[i].size() : i;
+            for (int jj = 0; jj < npartner; jj++) {
+                int j = (cutoff_ > 0.0) ? neighbors[i][jj] : jj;
                 double C6, Rm6, f;
 
-                double dx = m->x(j) - m->x(i);
-                double dy = m->y(j) - m->y(i);
-                double dz = m->z(j) - m->z(i);
+                double dx = xyz[j][0] - xyz[i][0];
+                double dy = xyz[j][1] - xyz[i][1];
+                double dz = xyz[j][2] - xyz[i][2];
 
                 double R2 = dx * dx + dy * dy + dz * dz;
                 double R = sqrt(R2);
@@ -339,20 +395,16 @@ double Dispersion::compute_energy(std::shared_ptr<Molecule> m) {
                 if (C6_type_ == C6_arit) {
                     C6 = 2.0 * C6_[(int)atom_list_p[i]] * C6_[(int)atom_list_p[j]] /
                          (C6_[(int)atom_list_p[i]] + C6_[(int)atom_list_p[j]]);
-                } else if (C6_type_ == C6_geom) {
-                    C6 = sqrt(C6_[(int)atom_list_p[i]] * C6_[(int)atom_list_p[j]]);
                 } else {
-                    throw PSIEXCEPTION("Unrecognized C6 Type");
+                    C6 = sqrt(C6_[(int)atom_list_p[i]] * C6_[(int)atom_list_p[j]]);
                 }
 
                 if (Damping_type_ == Damping_D1) {
                     double RvdW = (RvdW_[(int) atom_list_p[i]] + RvdW_[(int) atom_list_p[j]]) / 1.1;
                     f = 1.0 / (1.0 + exp(-d_ * (R / (sr6_ * RvdW) - 1)));
-                } else if (Damping_type_ == Damping_CHG) {
+                } else {
                     double RvdW = RvdW_[(int)atom_list_p[i]] + RvdW_[(int)atom_list_p[j]];
                     f = 1.0 / (1.0 + d_ * pow((R / RvdW), -12.0));
-                } else {
-                    throw PSIEXCEPTION("Unrecognized Damping Function");
                 }
 
                 E += C6 * Rm6 * f;
@@ -366,14 +418,42 @@ double Dispersion::compute_energy(std::shared_ptr<Molecule> m) {
 
 SharedMatrix Dispersion::compute_gradient(std::shared_ptr<Molecule> m) {
     auto G = std::make_shared<Matrix>("Dispersion Gradient", m->natom(), 3);
-    double **Gp = G->pointer();
 
     if (Damping_type_ == Damping_TT) {
         throw PSIEXCEPTION("+Das Gradients not yet implemented");
     }
-
-    for (int i = 0; i < m->natom(); i++) {
-        for (int j = 0; j < i; j++) {
+    if (C6_type_ != C6_arit && C6_type_ != C6_geom) throw PSIEXCEPTION("Unrecognized C6 Type");
+    if (Damping_type_ != Damping_D1 && Damping_type_ != Damping_CHG)
+        throw PSIEXCEPTION("Unrecognized Damping Function");
+
+    // Coordinates and charges are read once, outside the threaded loop
+    Matrix geom = m->geometry();
+    double **xyz = geom.pointer();
+    int natom = m->natom();
+    std::vector<int> Z(natom);
+    for (int i = 0; i < natom; i++) Z[i] = (int)m->Z(i);
+    std::vector<std::vector<int>> neighbors;
+    if (cutoff_ > 0.0) neighbors = lower_neighbors(geom);
+
+    // Each thread adds into its own copy of the gradient
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = omp_get_max_threads();
+#endif
+    std::vector<SharedMatrix> Gt(nthread);
+    Gt[0] = G;
+    for (int t = 1; t < nthread; t++) Gt[t] = std::make_shared<Matrix>("Dispersion Gradient", natom, 3);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < natom; i++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double **Gp = Gt[thread]->pointer();
+        int npartner = (cutoff_ > 0.0) ? neighbors[i].size() : i;
+        for (int jj = 0; jj < npartner; jj++) {
+            int j = (cutoff_ > 0.0) ? neighbors[i][jj] : jj;
             double C6, Rm6, f;
             double C6_R, Rm6_R, f_R;
 
@@ -381,9 +461,9 @@ SharedMatrix Dispersion::compute_gradient(std::shared_ptr<Molecule> m) {
             double R_xi, R_yi, R_zi;
             double R_xj, R_yj, R_zj;
 
-            double dx = m->x(j) - m->x(i);
-            double dy = m->y(j) - m->y(i);
-            double dz = m->z(j) - m->z(i);
+            double dx = xyz[j][0] - xyz[i][0];
+            double dy = xyz[j][1] - xyz[i][1];
+            double dz = xyz[j][2] - xyz[i][2];
 
             double R2 = dx * dx + dy * dy + dz * dz;
             R = sqrt(R2);
@@ -399,27 +479,21 @@ SharedMatrix Dispersion::compute_gradient(std::shared_ptr<Molecule> m) {
             Rm6 = 1.0 / R6;
             Rm6_R = -6.0 * Rm6 / R;
 
-            double RvdW = RvdW_[(int)m->Z(i)] + RvdW_[(int)m->Z(j)];
+            double RvdW = RvdW_[Z[i]] + RvdW_[Z[j]];
 
             if (C6_type_ == C6_arit) {
-                C6 = 2.0 * C6_[(int)m->Z(i)] * C6_[(int)m->Z(j)] / (C6_[(int)m->Z(i)] + C6_[(int)m->Z(j)]);
-                C6_R = 0.0;
-            } else if (C6_type_ == C6_geom) {
-                C6 = sqrt(C6_[(int)m->Z(i)] * C6_[(int)m->Z(j)]);
+                C6 = 2.0 * C6_[Z[i]] * C6_[Z[j]] / (C6_[Z[i]] + C6_[Z[j]]);
                 C6_R = 0.0;
             } else {
-                throw PSIEXCEPTION("Unrecognized C6 Type");
+                C6 = sqrt(C6_[Z[i]] * C6_[Z[j]]);
+                C6_R = 0.0;
             }
             if (Damping_type_ == Damping_D1) {
                 f = 1.0 / (1.0 + exp(-d_ * (R / RvdW - 1.0)));
                 f_R = -f * f * exp(-d_ * (R / RvdW - 1.0)) * (-d_ / RvdW);
-            } else if (Damping_type_ == Damping_CHG) {
+            } else {
                 f = 1.0 / (1.0 + d_ * pow((R / RvdW), -12.0));
                 f_R = -f * f * d_ * (-12.0) * pow((R / RvdW), -13.0) * (1.0 / RvdW);
-            } else if (Damping_type_ == Damping_TT) {
-                throw PSIEXCEPTION("+Das Gradients not yet implemented");
-            } else {
-                throw PSIEXCEPTION("Unrecognized Damping Function");
             }
 
             double E_R = C6_R * Rm6 * f + C6 * Rm6_R * f + C6 * Rm6 * f_R;
@@ -432,6 +506,7 @@ SharedMatrix Dispersion::compute_gradient(std::shared_ptr<Molecule> m) {
             Gp[j][2] += E_R * R_zj;
         }
     }
+    for (int t = 1; t < nthread; t++) G->add(Gt[t]);
 
     G->scale(-s6_);
     return G;
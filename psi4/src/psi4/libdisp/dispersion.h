@@ -37,10 +37,12 @@
 ***********************************************************/
 #include "psi4/psi4-dec.h"
 #include <string>
+#include <vector>
 
 namespace psi {
 
 class Molecule;
+class Matrix;
 
 class Dispersion {
    public:
@@ -72,6 +74,12 @@ class Dispersion {
     const double *A_;
     const double *Beta_;
 
+    /// Pairs farther apart than this [a0] are left out; 0.0 keeps every pair
+    double cutoff_ = 0.0;
+
+    /// For each atom, the atoms j < i within cutoff_ of it, found with a cell list
+    std::vector<std::vector<int>> lower_neighbors(const Matrix &geom) const;
+
    public:
     Dispersion();
     virtual ~Dispersion();
@@ -103,6 +111,8 @@ class Dispersion {
     void set_s8(double s8) { s8_ = s8; }
     void set_a1(double a1) { a1_ = a1; }
     void set_a2(double a2) { a2_ = a2; }
+    double get_cutoff() const { return cutoff_; }
+    void set_cutoff(double cutoff) { cutoff_ = cutoff; }
 
     std::string print_energy(std::shared_ptr<Molecule> m);
     std::string print_gradient(std::shared_ptr<Molecule> m);
@@ -0,0 +1,155 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Timings of the DPD kernels on generated amplitude-like buffers
+*/
+
+#include <chrono>
+#include <functional>
+#include <tuple>
+
+#include "psi4/libdpd/dpd.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+
+namespace psi {
+
+namespace {
+
+// Seconds per call of op, repeated until min_time has passed (at least once)
+double time_op(double min_time, const std::function<void()> &op) {
+    size_t rounds = 0;
+    double T = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    while (!rounds || T < min_time) {
+        op();
+        rounds++;
+        T = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return T / rounds;
+}
+
+void fill_buf4(DPD &dpd, dpdbuf4 *Buf) {
+    dpd.buf4_mat_irrep_init(Buf, 0);
+    for (int pq = 0; pq < Buf->params->rowtot[0]; pq++)
+        for (int rs = 0; rs < Buf->params->coltot[0]; rs++)
+            Buf->matrix[0][pq][rs] = 1.0 / (1.0 + pq + 2.0 * rs);
+    dpd.buf4_mat_irrep_wrt(Buf, 0);
+    dpd.buf4_mat_irrep_close(Buf, 0);
+}
+
+}  // namespace
+
+/*!
+** benchmark_dpd(): Time contract444, buf4_sort, and the PSIO traffic of a buf4 on
+** amplitude-like buffers with o = 2^(k+2) occupied and v = 4o virtual orbitals, k = 1..N, in C1
+** symmetry. The largest size needs about 3 o^2 v^2 doubles of memory.
+**
+** Each kernel is repeated for at least min_time seconds. The DPD library is set up for the
+** benchmark and closed afterwards, so this must not be called while a module has a DPD open.
+**
+** Returns one (kernel, o, v, seconds per call, rate) tuple per kernel and size; the rate is in
+** GFLOP/s for contract444 and in GB/s for the others.
+**
+** \ingroup DPD
+*/
+std::vector<std::tuple<std::string, int, int, double, double>> benchmark_dpd(int N, double min_time) {
+    outfile->Printf("\n");
+    outfile->Printf("                              ------------------------------ \n");
+    outfile->Printf("                              ======> DPD BENCHMARKS <====== \n");
+    outfile->Printf("                              ------------------------------ \n");
+    outfile->Printf("\n");
+    outfile->Printf("  Parameters:\n");
+    outfile->Printf("   -Minimum runtime (per operation, per size): %14.10f [s].\n", min_time);
+    outfile->Printf("   -Maximum size exponent N: %d. o = 2^(k+2), v = 4 o for k = 1..N.\n", N);
+    outfile->Printf("\n");
+    outfile->Printf("  Operations:\n");
+    outfile->Printf("   -CONTRACT444: Z(ij,ab) = W(ij,kl) T(kl,ab), rate in GFLOP/s.\n");
+    outfile->Printf("   -SORT: T(ij,ab) -> T(ia,jb) with buf4_sort, rate in GB/s of T.\n");
+    outfile->Printf("   -READ/WRITE: T(ij,ab) through PSIO in one irrep block, rate in GB/s.\n");
+    outfile->Printf("\n");
+
+    std::vector<std::tuple<std::string, int, int, double, double>> results;
+    std::shared_ptr<PSIO> psio = PSIO::shared_object();
+    const int nirreps = 1;
+    const int filenum = PSIF_CC_TMP;
+
+    outfile->Printf("  %-14s %6s %6s %14s %14s\n", "Operation", "o", "v", "Time [s]", "Rate");
+    for (int k = 1; k <= N; k++) {
+        int o = 1 << (k + 2);
+        int v = 4 * o;
+        std::vector<int> occpi(1, o), virtpi(1, v), occsym(o, 0), virsym(v, 0);
+        std::vector<int *> spaces = {occpi.data(), occsym.data(), virtpi.data(), virsym.data()};
+        std::vector<int> cachefiles(PSIO_MAXUNIT, 0);
+
+        // [O,O] = 0, [V,V] = 5, [O,V] = 10 for two orbital spaces
+        DPD dpd(0, nirreps, Process::environment.get_memory(), 0, cachefiles.data(), nullptr, nullptr, 2, spaces);
+        psio->open(filenum, PSIO_OPEN_NEW);
+
+        dpdbuf4 W, T, Z;
+        dpd.buf4_init(&W, filenum, 0, 0, 0, 0, 0, 0, "W (ij,kl)");
+        dpd.buf4_init(&T, filenum, 0, 0, 5, 0, 5, 0, "T (ij,ab)");
+        dpd.buf4_init(&Z, filenum, 0, 0, 5, 0, 5, 0, "Z (ij,ab)");
+        fill_buf4(dpd, &W);
+        fill_buf4(dpd, &T);
+
+        double gb = (double)o * o * v * v * sizeof(double) / 1.0e9;
+        double gflop = 2.0 * o * o * o * o * v * v / 1.0e9;
+
+        double t = time_op(min_time, [&]() { dpd.contract444(&W, &T, &Z, 0, 1, 1.0, 0.0); });
+        results.emplace_back("CONTRACT444", o, v, t, gflop / t);
+
+        t = time_op(min_time, [&]() { dpd.buf4_sort(&T, filenum, prqs, 10, 10, "T (ia,jb)"); });
+        results.emplace_back("SORT", o, v, t, gb / t);
+
+        dpd.buf4_mat_irrep_init(&T, 0);
+        t = time_op(min_time, [&]() { dpd.buf4_mat_irrep_wrt(&T, 0); });
+        results.emplace_back("WRITE", o, v, t, gb / t);
+        t = time_op(min_time, [&]() { dpd.buf4_mat_irrep_rd(&T, 0); });
+        results.emplace_back("READ", o, v, t, gb / t);
+        dpd.buf4_mat_irrep_close(&T, 0);
+
+        dpd.buf4_close(&Z);
+        dpd.buf4_close(&T);
+        dpd.buf4_close(&W);
+        psio->close(filenum, 0);
+
+        for (size_t i = results.size() - 4; i < results.size(); i++) {
+            outfile->Printf("  %-14s %6d %6d %14.6E %14.6E\n", std::get<0>(results[i]).c_str(), o, v,
+                            std::get<3>(results[i]), std::get<4>(results[i]));
+        }
+    }
+    outfile->Printf("\n");
+
+    return results;
+}
+
+}  // namespace psi
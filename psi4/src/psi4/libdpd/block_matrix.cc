@@ -97,6 +97,15 @@ double **DPD::dpd_block_matrix(size_t n, size_t m) {
             }
         }
 
+        /* Cost-per-byte cache */
+        else if (dpd_main.cachetype == 2) {
+            if (file4_cache_del_cost()) {
+                file4_cache_print("outfile");
+                outfile->Printf("dpd_block_matrix: n = %zd  m = %zd\n", n, m);
+                dpd_error("dpd_block_matrix: No memory left.", "outfile");
+            }
+        }
+
         /* Least-recently-used cache */
         else if (dpd_main.cachetype == 0) {
             if (file4_cache_del_lru()) {
@@ -140,6 +149,15 @@ double **DPD::dpd_block_matrix(size_t n, size_t m) {
             }
         }
 
+        /* Cost-per-byte cache */
+        else if (dpd_main.cachetype == 2) {
+            if (file4_cache_del_cost()) {
+                file4_cache_print("outfile");
+                outfile->Printf("dpd_block_matrix: n = %zd  m = %zd\n", n, m);
+                dpd_error("dpd_block_matrix: No memory left.", "outfile");
+            }
+        }
+
         /* Least-recently-used cache */
         else if (dpd_main.cachetype == 0) {
             if (file4_cache_del_lru()) {
@@ -54,6 +54,7 @@ double DPD::buf4_dot_self(dpdbuf4 *BufX) {
         buf4_mat_irrep_init(BufX, h);
         buf4_mat_irrep_rd(BufX, h);
 
+#pragma omp parallel for private(col) reduction(+ : alpha) schedule(static)
         for (row = 0; row < BufX->params->rowtot[h]; row++)
             for (col = 0; col < BufX->params->coltot[h ^ my_irrep]; col++)
                 alpha += BufX->matrix[h][row][col] * BufX->matrix[h][row][col];
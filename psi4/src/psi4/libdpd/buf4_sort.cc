@@ -36,14 +36,107 @@
 #include "psi4/libqt/qt.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <future>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using std::string;
 namespace psi {
 
+namespace {
+
+/* TRUE if buf4_mat_irrep_wrt_block() would hand this buffer's rows straight
+** to file4_mat_irrep_wrt_block() (no packing/unpacking through the DPD) */
+bool buf4_sort_plain_write(const dpdbuf4 *Buf) {
+    return !Buf->anti && !Buf->file.incore && Buf->params->perm_pq == Buf->file.params->perm_pq &&
+           Buf->params->perm_rs == Buf->file.params->perm_rs && Buf->params->peq == Buf->file.params->peq &&
+           Buf->params->res == Buf->file.params->res;
+}
+
+/*
+** SortBucketWriter: Writes finished out-of-core buckets of the target
+** buffer on a helper thread while the caller fills the next bucket.
+**
+** A second block of the same shape is allocated up front and swapped
+** into Buf->matrix[h] on each write, so the sort loops keep filling
+** Buf->matrix[h] exactly as before.  Only the file write runs on the
+** helper thread; all DPD allocations stay on the calling thread.  If
+** async is false or there is no memory for the spare block, write()
+** falls back to a plain buf4_mat_irrep_wrt_block().  An error of the
+** helper thread is rethrown by the next write() or by finish().
+*/
+class SortBucketWriter {
+   public:
+    SortBucketWriter(DPD *dpd, dpdbuf4 *Buf, int h, int rows, bool async)
+        : dpd_(dpd), buf_(Buf), h_(h), rows_(rows), spare_(nullptr), block_(Buf->matrix[h]) {
+        coltot_ = Buf->params->coltot[h ^ Buf->file.my_irrep];
+        if (async && rows_ && coltot_ && ((long int)rows_) * coltot_ <= dpd_memfree())
+            spare_ = dpd_->dpd_block_matrix(rows_, coltot_);
+        if (spare_ != nullptr) {
+            file_ = Buf->file;
+            matrix_.assign(Buf->params->nirreps, nullptr);
+            file_.matrix = matrix_.data();
+        }
+    }
+    ~SortBucketWriter() {
+        // unwinding: let the write land, but leave its error to the exception in flight
+        if (writer_.valid()) writer_.wait();
+        release();
+    }
+
+    void write(int start_pq, int num_pq) {
+        if (spare_ == nullptr) {
+            dpd_->buf4_mat_irrep_wrt_block(buf_, h_, start_pq, num_pq);
+            return;
+        }
+        wait();
+        matrix_[h_] = buf_->matrix[h_];
+        writer_ = std::async(std::launch::async, [this, start_pq, num_pq]() {
+            dpd_->file4_mat_irrep_wrt_block(&file_, h_, start_pq, num_pq);
+        });
+        buf_->matrix[h_] = (buf_->matrix[h_] == block_) ? spare_ : block_;
+    }
+
+    /* Wait for the last write and hand the original block back to the caller */
+    void finish() {
+        wait();
+        release();
+    }
+
+   private:
+    void wait() {
+        if (writer_.valid()) writer_.get();
+    }
+
+    void release() {
+        if (spare_ != nullptr) {
+            buf_->matrix[h_] = block_;
+            dpd_->free_dpd_block(spare_, rows_, coltot_);
+            spare_ = nullptr;
+        }
+    }
+
+    DPD *dpd_;
+    dpdbuf4 *buf_;
+    int h_;
+    int rows_;
+    int coltot_;
+    double **spare_;
+    double **block_;
+    dpdfile4 file_;
+    std::vector<double **> matrix_;
+    std::future<void> writer_;
+};
+
+}  // namespace
+
 /*
 ** dpd_buf4_sort(): A general DPD buffer sorting function that will
 ** (eventually) handle all 24 possible permutations of four-index
@@ -127,6 +220,9 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
     int out_rows_per_bucket, out_nbuckets, out_rows_left, out_row_start, n;
     int in_rows_per_bucket, in_nbuckets, in_rows_left, in_row_start, m;
     int rows_per_bucket, nbuckets, rows_left;
+    bool async_out;
+    int nblocks;
+    int nthreads = Process::environment.get_n_threads();
 
     nirreps = InBuf->params->nirreps;
     my_irrep = InBuf->file.my_irrep;
@@ -216,6 +312,13 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
     }
 #endif
 
+    /* Out-of-core sorts write each finished bucket while the next one is
+    ** filled, if the target is a plain file on a different unit.  The spare
+    ** output bucket takes a third of the memory otherwise split between the
+    ** input and output buckets. */
+    async_out = !incore && outfilenum != InBuf->file.filenum && buf4_sort_plain_write(&OutBuf);
+    nblocks = async_out ? 3 : 2;
+
     /* Init input and output buffers and read in all blocks of the input */
     if (incore) {
         for (h = 0; h < nirreps; h++) {
@@ -242,6 +345,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(p, q, row, rs, r, s, sr)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -262,7 +366,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 
                 for (Gpq = 0; Gpq < nirreps; Gpq++) {
                     Grs = Gpq ^ my_irrep;
-                    rows_per_bucket = dpd_memfree() / 2 / InBuf->params->coltot[Grs];
+                    rows_per_bucket = dpd_memfree() / nblocks / InBuf->params->coltot[Grs];
 
                     if (rows_per_bucket > InBuf->params->rowtot[Gpq]) rows_per_bucket = InBuf->params->rowtot[Gpq];
                     if (!rows_per_bucket) dpd_error("buf4_sort_pqsr: Not enough memory for one row!", "outfile");
@@ -275,6 +379,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 
                     buf4_mat_irrep_init_block(InBuf, Gpq, rows_per_bucket);
                     buf4_mat_irrep_init_block(&OutBuf, Gpq, rows_per_bucket);
+                    SortBucketWriter writer(this, &OutBuf, Gpq, rows_per_bucket, async_out);
 
                     for (n = 0; n < (rows_left ? nbuckets - 1 : nbuckets); n++) {
                         buf4_mat_irrep_rd_block(InBuf, Gpq, n * rows_per_bucket, rows_per_bucket);
@@ -290,7 +395,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             }
                         }
 
-                        buf4_mat_irrep_wrt_block(&OutBuf, Gpq, n * rows_per_bucket, rows_per_bucket);
+                        writer.write(n * rows_per_bucket, rows_per_bucket);
                     }
                     if (rows_left) {
                         buf4_mat_irrep_rd_block(InBuf, Gpq, n * rows_per_bucket, rows_left);
@@ -306,10 +411,11 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             }
                         }
 
-                        buf4_mat_irrep_wrt_block(&OutBuf, Gpq, n * rows_per_bucket, rows_left);
+                        writer.write(n * rows_per_bucket, rows_left);
                     }
 
                     buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
+                    writer.finish();
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
                 }
             }
@@ -339,6 +445,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gpr = Gp ^ Gr;
                             Gqs = Gq ^ Gs;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, pr, s, S, rs, qs) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -367,7 +474,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (Gpq = 0; Gpq < nirreps; Gpq++) {
                     Grs = Gpq ^ my_irrep;
 
-                    out_rows_per_bucket = dpd_memfree() / (2 * OutBuf.params->coltot[Grs]);
+                    out_rows_per_bucket = dpd_memfree() / (nblocks * OutBuf.params->coltot[Grs]);
                     if (out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
                         out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
                     out_nbuckets = (int)ceil((double)OutBuf.params->rowtot[Gpq] / (double)out_rows_per_bucket);
@@ -378,6 +485,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 
                     /* allocate space for the bucket of rows */
                     buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
+                    SortBucketWriter writer(this, &OutBuf, Gpq, out_rows_per_bucket, async_out);
 
                     for (n = 0; n < (out_rows_left ? out_nbuckets - 1 : out_nbuckets); n++) {
                         out_row_start = n * out_rows_per_bucket;
@@ -456,7 +564,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             }
                             buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                         }
-                        buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_per_bucket);
+                        writer.write(out_row_start, out_rows_per_bucket);
                     }
                     if (out_rows_left) {
                         out_row_start = n * out_rows_per_bucket;
@@ -536,9 +644,10 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                         }
 
-                        buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_left);
+                        writer.write(out_row_start, out_rows_left);
                     }
 
+                    writer.finish();
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
                 }
             }
@@ -568,6 +677,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gps = Gp ^ Gs;
                             Gqr = Gq ^ Gr;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, qr, s, S, rs, ps) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -596,7 +706,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                     Grs = Gpq ^ my_irrep;
 
                     /* determine how many rows of OutBuf we can store in half of the core */
-                    out_rows_per_bucket = dpd_memfree() / (2 * OutBuf.params->coltot[Grs]);
+                    out_rows_per_bucket = dpd_memfree() / (nblocks * OutBuf.params->coltot[Grs]);
                     if (out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
                         out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
                     out_nbuckets = (int)ceil((double)OutBuf.params->rowtot[Gpq] / (double)out_rows_per_bucket);
@@ -607,6 +717,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 
                     /* allocate space for the bucket of rows */
                     buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
+                    SortBucketWriter writer(this, &OutBuf, Gpq, out_rows_per_bucket, async_out);
 
                     for (n = 0; n < (out_rows_left ? out_nbuckets - 1 : out_nbuckets); n++) {
                         out_row_start = n * out_rows_per_bucket;
@@ -685,7 +796,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             }
                             buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                         }
-                        buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_per_bucket);
+                        writer.write(out_row_start, out_rows_per_bucket);
                     }
                     if (out_rows_left) {
                         out_row_start = n * out_rows_per_bucket;
@@ -766,9 +877,10 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                         }
 
-                        buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_left);
+                        writer.write(out_row_start, out_rows_left);
                     }
 
+                    writer.finish();
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
                 }
             }
@@ -798,6 +910,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gpr = Gp ^ Gr;
                             Gsq = Gs ^ Gq;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, pr, s, S, rs, sq) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -851,6 +964,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gps = Gp ^ Gs;
                             Grq = Gr ^ Gq;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, rq, s, S, rs, ps) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -896,6 +1010,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(p, q, qp, rs, r, s, col)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -916,7 +1031,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                     Grs = Gpq ^ my_irrep;
 
                     /* determine how many rows of OutBuf/InBuf we can store in half the core */
-                    rows_per_bucket = dpd_memfree() / (2 * OutBuf.params->coltot[Grs]);
+                    rows_per_bucket = dpd_memfree() / (nblocks * OutBuf.params->coltot[Grs]);
                     if (rows_per_bucket > OutBuf.params->rowtot[Gpq]) rows_per_bucket = OutBuf.params->rowtot[Gpq];
                     nbuckets = (int)ceil((double)OutBuf.params->rowtot[Gpq] / (double)rows_per_bucket);
                     if (nbuckets == 1)
@@ -926,6 +1041,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 
                     /* allocate space for the bucket of rows */
                     buf4_mat_irrep_init_block(&OutBuf, Gpq, rows_per_bucket);
+                    SortBucketWriter writer(this, &OutBuf, Gpq, rows_per_bucket, async_out);
                     buf4_mat_irrep_init_block(InBuf, Gpq, rows_per_bucket);
 
                     for (n = 0; n < (rows_left ? nbuckets - 1 : nbuckets); n++) {
@@ -961,7 +1077,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             }
                         }
 
-                        buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_per_bucket);
+                        writer.write(out_row_start, rows_per_bucket);
 
                     } /* n */
                     if (rows_left) {
@@ -998,8 +1114,9 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                         }
                     }
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_left);
+                    writer.write(out_row_start, rows_left);
                     buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
+                    writer.finish();
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
                 } /* Gpq */
             }
@@ -1020,6 +1137,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(p, q, qp, rs, r, s, sr)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -1039,7 +1157,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                     Grs = Gpq ^ my_irrep;
 
                     /* determine how many rows of OutBuf/InBuf we can store in half the core */
-                    rows_per_bucket = dpd_memfree() / (2 * OutBuf.params->coltot[Grs]);
+                    rows_per_bucket = dpd_memfree() / (nblocks * OutBuf.params->coltot[Grs]);
                     if (rows_per_bucket > OutBuf.params->rowtot[Gpq]) rows_per_bucket = OutBuf.params->rowtot[Gpq];
                     nbuckets = (int)ceil((double)OutBuf.params->rowtot[Gpq] / (double)rows_per_bucket);
                     if (nbuckets == 1)
@@ -1049,6 +1167,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 
                     /* allocate space for the bucket of rows */
                     buf4_mat_irrep_init_block(&OutBuf, Gpq, rows_per_bucket);
+                    SortBucketWriter writer(this, &OutBuf, Gpq, rows_per_bucket, async_out);
                     buf4_mat_irrep_init_block(InBuf, Gpq, rows_per_bucket);
 
                     for (n = 0; n < (rows_left ? nbuckets - 1 : nbuckets); n++) {
@@ -1093,7 +1212,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             }
                         }
 
-                        buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_per_bucket);
+                        writer.write(out_row_start, rows_per_bucket);
 
                     } /* n */
                     if (rows_left) {
@@ -1139,9 +1258,10 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                         }
                     }
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_left);
+                    writer.write(out_row_start, rows_left);
 
                     buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
+                    writer.finish();
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
 
                 } /* Gpq */
@@ -1171,6 +1291,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Grp = Gr ^ Gp;
                             Gqs = Gq ^ Gs;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, rp, s, S, rs, qs) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1224,6 +1345,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gsp = Gs ^ Gp;
                             Gqr = Gq ^ Gr;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, qr, s, S, rs, sp) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1276,6 +1398,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Grp = Gr ^ Gp;
                             Gsq = Gs ^ Gq;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, rp, s, S, rs, sq) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1328,6 +1451,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gsp = Gs ^ Gp;
                             Grq = Gr ^ Gq;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, rq, s, S, rs, sp) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1381,6 +1505,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Grq = Gr ^ Gq;
                             Gps = Gp ^ Gs;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, rq, s, S, rs, ps) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1434,6 +1559,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gsq = Gs ^ Gq;
                             Gpr = Gp ^ Gr;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, pr, s, S, rs, sq) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1487,6 +1613,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gqr = Gq ^ Gr;
                             Gps = Gp ^ Gs;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, qr, s, S, rs, ps) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1540,6 +1667,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gqs = Gq ^ Gs;
                             Gpr = Gp ^ Gr;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, pr, s, S, rs, qs) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1585,6 +1713,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(p, q, col, rs, r, s, row)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -1623,6 +1752,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(p, q, col, rs, r, s, row)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -1644,7 +1774,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                     Grs = Gpq ^ my_irrep;
 
                     out_rows_per_bucket =
-                        (dpd_memfree() - OutBuf.params->coltot[Grs]) / (2 * OutBuf.params->coltot[Grs]);
+                        (dpd_memfree() - OutBuf.params->coltot[Grs]) / (nblocks * OutBuf.params->coltot[Grs]);
                     if (out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
                         out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
                     out_nbuckets = (int)ceil((double)OutBuf.params->rowtot[Gpq] / (double)out_rows_per_bucket);
@@ -1654,7 +1784,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                         out_rows_left = OutBuf.params->rowtot[Gpq] % out_rows_per_bucket;
 
                     in_rows_per_bucket =
-                        (dpd_memfree() - InBuf->params->coltot[Gpq]) / (2 * InBuf->params->coltot[Gpq]);
+                        (dpd_memfree() - InBuf->params->coltot[Gpq]) / (nblocks * InBuf->params->coltot[Gpq]);
                     if (in_rows_per_bucket > InBuf->params->rowtot[Grs])
                         in_rows_per_bucket = InBuf->params->rowtot[Grs];
                     in_nbuckets = (int)ceil((double)InBuf->params->rowtot[Grs] / (double)in_rows_per_bucket);
@@ -1679,6 +1809,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 #endif
 
                     buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
+                    SortBucketWriter writer(this, &OutBuf, Gpq, out_rows_per_bucket, async_out);
                     buf4_mat_irrep_init_block(InBuf, Grs, in_rows_per_bucket);
 
                     for (n = 0; n < out_nbuckets; n++) {
@@ -1698,10 +1829,10 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             }
                         }
 
-                        buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start,
-                                                 (n == out_nbuckets - 1 ? out_rows_left : out_rows_per_bucket));
+                        writer.write(out_row_start, (n == out_nbuckets - 1 ? out_rows_left : out_rows_per_bucket));
                     }
 
+                    writer.finish();
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
                     buf4_mat_irrep_close_block(InBuf, Grs, in_rows_per_bucket);
 
@@ -1733,6 +1864,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gsq = Gs ^ Gq;
                             Grp = Gr ^ Gp;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, rp, s, S, rs, sq) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1783,6 +1915,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(p, q, col, rs, r, s, row)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -1820,6 +1953,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(p, q, col, rs, r, s, row)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -1866,6 +2000,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gqr = Gq ^ Gr;
                             Gsp = Gs ^ Gp;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, qr, s, S, rs, sp) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1919,6 +2054,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gqs = Gq ^ Gs;
                             Grp = Gr ^ Gp;
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(P, q, Q, pq, r, R, rp, s, S, rs, qs) if (!OutBuf.params->perm_pq)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
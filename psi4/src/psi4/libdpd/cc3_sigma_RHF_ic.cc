@@ -44,10 +44,6 @@
 #include "dpd.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
-// MKL Header
-#ifdef USING_LAPACK_MKL
-#include <mkl.h>
-#endif
 
 namespace psi {
 
@@ -93,10 +89,8 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, int d
 
     std::vector<thread_data> thread_data_array(nthreads);
 
-#ifdef USING_LAPACK_MKL
-    int old_threads = mkl_get_max_threads();
-    mkl_set_num_threads(1);
-#endif
+    // The ijk threads share what is left for their BLAS calls
+    BlasThreads blas_threads(BlasThreads::Outer, nthreads, "CC3 sigma");
 
     nirreps = CIjAb->params->nirreps;
     /* these are sent to T3 function */
@@ -299,10 +293,6 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, int d
             buf4_mat_irrep_close(SIjAb, h);
         }
     }
-
-#ifdef USING_LAPACK_MKL
-    mkl_set_num_threads(old_threads);
-#endif
 }
 
 void cc3_sigma_RHF_ic_thread(thread_data &data) {
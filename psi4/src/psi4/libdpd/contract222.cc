@@ -125,6 +125,10 @@ int DPD::contract222(dpdfile2 *X, dpdfile2 *Y, dpdfile2 *Z, int target_X, int ta
     }
 #endif
 
+    /* The irrep blocks are independent products, done as one batch */
+    std::vector<DGEMMTask> gemms;
+    gemms.reserve(nirreps);
+
     /* loop over row irreps of X */
     for (Hx = 0; Hx < nirreps; Hx++) {
         if ((!Xtrans) && (!Ytrans)) {
@@ -142,10 +146,10 @@ int DPD::contract222(dpdfile2 *X, dpdfile2 *Y, dpdfile2 *Z, int target_X, int ta
         }
 
         if (Z->params->rowtot[Hz] && Z->params->coltot[Hz ^ GZ] && numlinks[Hx ^ symlink]) {
-            C_DGEMM(Xtrans ? 't' : 'n', Ytrans ? 't' : 'n', Z->params->rowtot[Hz], Z->params->coltot[Hz ^ GZ],
-                    numlinks[Hx ^ symlink], alpha, &(X->matrix[Hx][0][0]), X->params->coltot[Hx ^ GX],
-                    &(Y->matrix[Hy][0][0]), Y->params->coltot[Hy ^ GY], beta, &(Z->matrix[Hz][0][0]),
-                    Z->params->coltot[Hz ^ GZ]);
+            gemms.push_back({Xtrans ? 't' : 'n', Ytrans ? 't' : 'n', Z->params->rowtot[Hz], Z->params->coltot[Hz ^ GZ],
+                             numlinks[Hx ^ symlink], alpha, &(X->matrix[Hx][0][0]), X->params->coltot[Hx ^ GX],
+                             &(Y->matrix[Hy][0][0]), Y->params->coltot[Hy ^ GY], beta, &(Z->matrix[Hz][0][0]),
+                             Z->params->coltot[Hz ^ GZ]});
         }
         /*
     newmm(X->matrix[Hx], Xtrans, Y->matrix[Hy], Ytrans, Z->matrix[Hz],
@@ -153,6 +157,7 @@ int DPD::contract222(dpdfile2 *X, dpdfile2 *Y, dpdfile2 *Z, int target_X, int ta
         alpha, beta);
     */
     }
+    C_DGEMM_BATCH(gemms);
 
     file2_mat_wrt(Z);
     file2_mat_close(X);
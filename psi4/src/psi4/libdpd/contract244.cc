@@ -380,7 +380,10 @@ int DPD::contract244(dpdfile2 *X, dpdbuf4 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
             buf4_mat_irrep_row_init(Y, hybuf);
             buf4_mat_irrep_row_init(Z, hzbuf);
 
-            /* Loop over rows of the Y factor and the target */
+            /* Loop over rows of the Y factor and the target; the small per-irrep
+               products of a row go to BLAS as one batch */
+            std::vector<DGEMMTask> row_gemms;
+            row_gemms.reserve(nirreps);
             for (pq = 0; pq < Z->params->rowtot[hzbuf]; pq++) {
                 buf4_mat_irrep_row_zero(Y, hybuf, pq);
                 buf4_mat_irrep_row_rd(Y, hybuf, pq);
@@ -389,6 +392,7 @@ int DPD::contract244(dpdfile2 *X, dpdbuf4 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
 
                 if (std::fabs(beta) > 0.0) buf4_mat_irrep_row_rd(Z, hzbuf, pq);
 
+                row_gemms.clear();
                 for (Gs = 0; Gs < nirreps; Gs++) {
                     GrY = Gs ^ hybuf ^ GY;
                     GrZ = Gs ^ hzbuf ^ GZ;
@@ -403,12 +407,13 @@ int DPD::contract244(dpdfile2 *X, dpdbuf4 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
                     colz = Z->params->spi[Gs];
 
                     if (nrows && ncols && nlinks) {
-                        C_DGEMM(Xtrans ? 't' : 'n', 'n', nrows, ncols, nlinks, alpha,
-                                &(X->matrix[Xtrans ? GrY : GrZ][0][0]), Xtrans ? nrows : nlinks,
-                                &(Y->matrix[hybuf][0][Y->col_offset[hybuf][GrY]]), ncols, 1.0,
-                                &(Z->matrix[hzbuf][0][Z->col_offset[hzbuf][GrZ]]), ncols);
+                        row_gemms.push_back({Xtrans ? 't' : 'n', 'n', nrows, ncols, nlinks, alpha,
+                                             &(X->matrix[Xtrans ? GrY : GrZ][0][0]), Xtrans ? nrows : nlinks,
+                                             &(Y->matrix[hybuf][0][Y->col_offset[hybuf][GrY]]), ncols, 1.0,
+                                             &(Z->matrix[hzbuf][0][Z->col_offset[hzbuf][GrZ]]), ncols});
                     }
                 }
+                C_DGEMM_BATCH(row_gemms);
                 buf4_mat_irrep_row_wrt(Z, hzbuf, pq);
             }
 
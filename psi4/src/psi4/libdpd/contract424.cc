@@ -36,6 +36,10 @@
 #include "psi4/libqt/qt.h"
 #include "dpd.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
@@ -82,6 +86,10 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
     memoryd = dpd_main.memory;
     incore = 1; /* default */
 
+    /* The sub-irrep products of one buffer irrep touch disjoint blocks of X and Z,
+       so they run side by side rather than one threaded DGEMM at a time */
+    int nthreads = Process::environment.get_n_threads();
+
     file2_mat_init(Y);
     file2_mat_rd(Y);
 
@@ -258,7 +266,8 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
 #endif
             }
 
-            if (rking)
+            if (rking) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(Hx, Hy) if (nirreps > 1)
                 for (Hz = 0; Hz < nirreps; Hz++) {
                     if (!Xtrans && !Ytrans) {
                         Hx = Hz;
@@ -285,7 +294,8 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
                     newmm_rking(Xmat[Hx], Xtrans, Y->matrix[Hy], Ytrans, Zmat[Hz], numrows[Hz], numlinks[Hy ^ symlink],
                                 numcols[Hz], alpha, 1.0);
                 }
-            else
+            } else {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) private(Hx, Hy) if (nirreps > 1)
                 for (Hz = 0; Hz < nirreps; Hz++) {
                     if (!Xtrans && !Ytrans) {
                         Hx = Hz;
@@ -327,6 +337,7 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
                         }
                     }
                 }
+            }
 
             if (sum_X == 0)
                 buf4_mat_irrep_close(X, hxbuf);
@@ -355,7 +366,10 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
             buf4_mat_irrep_row_init(X, hxbuf);
             buf4_mat_irrep_row_init(Z, hzbuf);
 
-            /* Loop over rows of the X factor and the target */
+            /* Loop over rows of the X factor and the target; the small per-irrep
+               products of a row go to BLAS as one batch */
+            std::vector<DGEMMTask> row_gemms;
+            row_gemms.reserve(nirreps);
             for (pq = 0; pq < Z->params->rowtot[hzbuf]; pq++) {
                 buf4_mat_irrep_row_zero(X, hxbuf, pq);
                 buf4_mat_irrep_row_rd(X, hxbuf, pq);
@@ -365,6 +379,7 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
                 if (std::fabs(beta) > 0.0) buf4_mat_irrep_row_rd(Z, hzbuf, pq);
 
                 xcount = zcount = 0;
+                row_gemms.clear();
 
                 for (Gr = 0; Gr < nirreps; Gr++) {
                     GsX = Gr ^ hxbuf ^ GX;
@@ -376,14 +391,16 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
                     colz = Z->params->spi[GsZ];
 
                     if (rowx && colx && colz) {
-                        C_DGEMM('n', Ytrans ? 't' : 'n', rowx, colz, colx, alpha, &(X->matrix[hxbuf][0][xcount]), colx,
-                                &(Y->matrix[Ytrans ? GsZ : GsX][0][0]), Ytrans ? colx : colz, 1.0,
-                                &(Z->matrix[hzbuf][0][zcount]), colz);
+                        row_gemms.push_back({'n', Ytrans ? 't' : 'n', rowx, colz, colx, alpha,
+                                             &(X->matrix[hxbuf][0][xcount]), colx,
+                                             &(Y->matrix[Ytrans ? GsZ : GsX][0][0]), Ytrans ? colx : colz, 1.0,
+                                             &(Z->matrix[hzbuf][0][zcount]), colz});
                     }
 
                     xcount += rowx * colx;
                     zcount += rowz * colz;
                 }
+                C_DGEMM_BATCH(row_gemms);
 
                 buf4_mat_irrep_row_wrt(Z, hzbuf, pq);
             }
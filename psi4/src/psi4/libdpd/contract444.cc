@@ -32,6 +32,8 @@
 */
 #include <cstdio>
 #include <cmath>
+#include <cstring>
+#include <future>
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.h"
 #include "dpd.h"
@@ -39,6 +41,25 @@
 
 namespace psi {
 
+namespace {
+/* Irreps of the Y and Z blocks that go with irrep Hx of X */
+void contract444_irreps(int Hx, int Xtrans, int Ytrans, int GX, int GY, int *Hy, int *Hz) {
+    if ((!Xtrans) && (!Ytrans)) {
+        *Hy = Hx ^ GX;
+        *Hz = Hx;
+    } else if ((!Xtrans) && (Ytrans)) {
+        *Hy = Hx ^ GX ^ GY;
+        *Hz = Hx;
+    } else if ((Xtrans) && (!Ytrans)) {
+        *Hy = Hx;
+        *Hz = Hx ^ GX;
+    } else /* (( Xtrans)&&( Ytrans))*/ {
+        *Hy = Hx ^ GY;
+        *Hz = Hx ^ GX;
+    }
+}
+}  // namespace
+
 /* dpd_contract444(): Contracts a pair of four-index quantities to
 ** give a product four-index quantity.
 **
@@ -69,6 +90,9 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
     double byte_conv;
 #endif
 
+    timer_on("DPD: contract444");
+    double flops = 0.0;
+
     nirreps = X->params->nirreps;
     GX = X->file.my_irrep;
     GY = Y->file.my_irrep;
@@ -115,20 +139,17 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
     }
 #endif
 
+    /* The next irrep's blocks can be read on a helper thread while this irrep's DGEMM runs,
+       unless the target shares a file with a factor (its writes must precede the next reads)
+       or two of the buffers are the same object. */
+    bool same_file_ZX = (Z->file.filenum == X->file.filenum) && !strcmp(Z->file.label, X->file.label);
+    bool same_file_ZY = (Z->file.filenum == Y->file.filenum) && !strcmp(Z->file.label, Y->file.label);
+    bool can_prefetch = (X != Y) && (X != Z) && (Y != Z) && !same_file_ZX && !same_file_ZY;
+    int prefetched = -1; /* irrep whose in-core blocks are already read */
+    std::future<void> reader; /* get() rethrows an I/O error of the helper thread here */
+
     for (Hx = 0; Hx < nirreps; Hx++) {
-        if ((!Xtrans) && (!Ytrans)) {
-            Hy = Hx ^ GX;
-            Hz = Hx;
-        } else if ((!Xtrans) && (Ytrans)) {
-            Hy = Hx ^ GX ^ GY;
-            Hz = Hx;
-        } else if ((Xtrans) && (!Ytrans)) {
-            Hy = Hx;
-            Hz = Hx ^ GX;
-        } else /* (( Xtrans)&&( Ytrans))*/ {
-            Hy = Hx ^ GY;
-            Hz = Hx ^ GX;
-        }
+        contract444_irreps(Hx, Xtrans, Ytrans, GX, GY, &Hy, &Hz);
 
         size_Y = ((long)Y->params->rowtot[Hy]) * ((long)Y->params->coltot[Hy ^ GY]);
         size_Z = ((long)Z->params->rowtot[Hz]) * ((long)Z->params->coltot[Hz ^ GZ]);
@@ -136,7 +157,9 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
 
         memoryd = dpd_memfree() - (size_Y + size_Z + size_file_X_row);
 
-        if (X->params->rowtot[Hx] && X->params->coltot[Hx ^ GX]) {
+        if (prefetched == Hx) {
+            incore = 1;
+        } else if (X->params->rowtot[Hx] && X->params->coltot[Hx ^ GX]) {
             if (X->params->coltot[Hx ^ GX])
                 rows_per_bucket = memoryd / X->params->coltot[Hx ^ GX];
             else
@@ -148,7 +171,13 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
 
             nbuckets = (int)ceil((double)X->params->rowtot[Hx] / (double)rows_per_bucket);
 
-            rows_left = X->params->rowtot[Hx] % rows_per_bucket;
+            /* Two buckets in memory let the next one be read during the DGEMM */
+            if (nbuckets > 1 && rows_per_bucket > 1) {
+                rows_per_bucket /= 2;
+                nbuckets = (int)ceil((double)X->params->rowtot[Hx] / (double)rows_per_bucket);
+            }
+
+            rows_left = X->params->rowtot[Hx] - (nbuckets - 1) * rows_per_bucket;
 
             incore = 1;
             if (nbuckets > 1) incore = 0;
@@ -182,21 +211,47 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
     */
 
         if (incore) {
-            buf4_mat_irrep_init(X, Hx);
-            buf4_mat_irrep_rd(X, Hx);
+            if (prefetched != Hx) {
+                buf4_mat_irrep_init(X, Hx);
+                buf4_mat_irrep_rd(X, Hx);
+
+                buf4_mat_irrep_init(Y, Hy);
+                buf4_mat_irrep_rd(Y, Hy);
+                buf4_mat_irrep_init(Z, Hz);
+                if (std::fabs(beta) > 0.0) buf4_mat_irrep_rd(Z, Hz);
+            }
 
-            buf4_mat_irrep_init(Y, Hy);
-            buf4_mat_irrep_rd(Y, Hy);
-            buf4_mat_irrep_init(Z, Hz);
-            if (std::fabs(beta) > 0.0) buf4_mat_irrep_rd(Z, Hz);
+            /* Start reading the next irrep if it also fits in core next to this one */
+            int Hn = Hx + 1, Hyn, Hzn;
+            if (can_prefetch && Hn < nirreps) {
+                contract444_irreps(Hn, Xtrans, Ytrans, GX, GY, &Hyn, &Hzn);
+                long int size_Xn = ((long)X->params->rowtot[Hn]) * ((long)X->params->coltot[Hn ^ GX]);
+                long int size_Yn = ((long)Y->params->rowtot[Hyn]) * ((long)Y->params->coltot[Hyn ^ GY]);
+                long int size_Zn = ((long)Z->params->rowtot[Hzn]) * ((long)Z->params->coltot[Hzn ^ GZ]);
+                if (size_Xn + size_Yn + size_Zn + 2 * size_file_X_row <= dpd_memfree()) {
+                    /* allocations stay on this thread; only the reads move */
+                    buf4_mat_irrep_init(X, Hn);
+                    buf4_mat_irrep_init(Y, Hyn);
+                    buf4_mat_irrep_init(Z, Hzn);
+                    reader = std::async(std::launch::async, [=]() {
+                        buf4_mat_irrep_rd(X, Hn);
+                        buf4_mat_irrep_rd(Y, Hyn);
+                        if (std::fabs(beta) > 0.0) buf4_mat_irrep_rd(Z, Hzn);
+                    });
+                    prefetched = Hn;
+                }
+            }
 
             if (Z->params->rowtot[Hz] && Z->params->coltot[Hz ^ GZ] && numlinks[Hx ^ symlink]) {
+                flops += 2.0 * Z->params->rowtot[Hz] * Z->params->coltot[Hz ^ GZ] * numlinks[Hx ^ symlink];
                 C_DGEMM(Xtrans ? 't' : 'n', Ytrans ? 't' : 'n', Z->params->rowtot[Hz], Z->params->coltot[Hz ^ GZ],
                         numlinks[Hx ^ symlink], alpha, &(X->matrix[Hx][0][0]), X->params->coltot[Hx ^ GX],
                         &(Y->matrix[Hy][0][0]), Y->params->coltot[Hy ^ GY], beta, &(Z->matrix[Hz][0][0]),
                         Z->params->coltot[Hz ^ GZ]);
             }
 
+            if (reader.valid()) reader.get();
+
             buf4_mat_irrep_close(X, Hx);
 
             buf4_mat_irrep_wrt(Z, Hz);
@@ -209,25 +264,35 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
                 dpd_error("contract444", "outfile");
             }
 
+            /* Bucket n is multiplied while bucket n+1 is read into the other block */
+            double **blocks[2];
             buf4_mat_irrep_init_block(X, Hx, rows_per_bucket);
+            blocks[0] = X->matrix[Hx];
+            blocks[1] = dpd_block_matrix(rows_per_bucket, X->params->coltot[Hx ^ GX]);
 
             buf4_mat_irrep_init(Y, Hy);
             buf4_mat_irrep_rd(Y, Hy);
             buf4_mat_irrep_init(Z, Hz);
             if (std::fabs(beta) > 0.0) buf4_mat_irrep_rd(Z, Hz);
 
+            auto read_bucket = [=](int bucket) {
+                X->matrix[Hx] = blocks[bucket % 2];
+                buf4_mat_irrep_rd_block(X, Hx, bucket * rows_per_bucket,
+                                        bucket < (nbuckets - 1) ? rows_per_bucket : rows_left);
+            };
+            read_bucket(0);
+
             for (n = 0; n < nbuckets; n++) {
-                if (n < (nbuckets - 1))
-                    buf4_mat_irrep_rd_block(X, Hx, n * rows_per_bucket, rows_per_bucket);
-                else
-                    buf4_mat_irrep_rd_block(X, Hx, n * rows_per_bucket, rows_left);
+                double **Xblock = blocks[n % 2];
+                if (n + 1 < nbuckets) reader = std::async(std::launch::async, read_bucket, n + 1);
 
                 if (!Xtrans && Ytrans) {
                     nrows = n < (nbuckets - 1) ? rows_per_bucket : rows_left;
                     ncols = Z->params->coltot[Hz ^ GZ];
                     nlinks = numlinks[Hx ^ symlink];
+                    if (nrows && ncols && nlinks) flops += 2.0 * nrows * ncols * nlinks;
                     if (nrows && ncols && nlinks)
-                        C_DGEMM('n', 't', nrows, ncols, nlinks, alpha, &(X->matrix[Hx][0][0]), numlinks[Hx ^ symlink],
+                        C_DGEMM('n', 't', nrows, ncols, nlinks, alpha, &(Xblock[0][0]), numlinks[Hx ^ symlink],
                                 &(Y->matrix[Hy][0][0]), numlinks[Hx ^ symlink], beta,
                                 &(Z->matrix[Hz][n * rows_per_bucket][0]), Z->params->coltot[Hz ^ GZ]);
                 } else if (Xtrans && !Ytrans) {
@@ -238,14 +303,19 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
                     nrows = Z->params->rowtot[Hz];
                     ncols = Z->params->coltot[Hz ^ GZ];
                     nlinks = n < (nbuckets - 1) ? rows_per_bucket : rows_left;
+                    if (nrows && ncols && nlinks) flops += 2.0 * nrows * ncols * nlinks;
                     if (nrows && ncols && nlinks)
-                        C_DGEMM('t', 'n', nrows, ncols, nlinks, alpha, &(X->matrix[Hx][0][0]),
+                        C_DGEMM('t', 'n', nrows, ncols, nlinks, alpha, &(Xblock[0][0]),
                                 X->params->coltot[Hx ^ GX], &(Y->matrix[Hy][n * rows_per_bucket][0]),
                                 Y->params->coltot[Hy ^ GY], (n == 0 ? beta : 1.0), &(Z->matrix[Hz][0][0]),
                                 Z->params->coltot[Hz ^ GZ]);
                 }
+
+                if (reader.valid()) reader.get();
             }
 
+            free_dpd_block(blocks[1], rows_per_bucket, X->params->coltot[Hx ^ GX]);
+            X->matrix[Hx] = blocks[0];
             buf4_mat_irrep_close_block(X, Hx, rows_per_bucket);
 
             buf4_mat_irrep_close(Y, Hy);
@@ -255,6 +325,9 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
         }  // !incore
     }      // Hx
 
+    timer_count("DPD: contract444 flops", flops);
+    timer_off("DPD: contract444");
+
     return 0;
 }
 
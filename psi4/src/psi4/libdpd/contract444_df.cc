@@ -74,14 +74,17 @@ int DPD::contract444_df(dpdbuf4 *B, dpdbuf4 *tau_in, dpdbuf4 *tau_out, double al
     nthreadz = Process::environment.get_n_threads();
 #endif
 
+    // The amplitudes need not be totally symmetric; B is, so tau_in and tau_out share an irrep
+    int Gtau = tau_in->file.my_irrep;
+
     // Create accumulation buffers
     std::vector<double ***> arrays;
     arrays.push_back(tau_out->matrix);
     for (int thread = 1; thread < nthreadz; ++thread) {
         auto ***arr = new double **[tau_out->params->nirreps];
         for (int h = 0; h < tau_out->params->nirreps; ++h) {
-            if (tau_out->params->rowtot[h] && tau_out->params->coltot[h])
-                arr[h] = block_matrix(tau_out->params->rowtot[h], tau_out->params->coltot[h]);
+            if (tau_out->params->rowtot[h] && tau_out->params->coltot[h ^ Gtau])
+                arr[h] = block_matrix(tau_out->params->rowtot[h], tau_out->params->coltot[h ^ Gtau]);
         }
         arrays.push_back(arr);
     }
@@ -133,7 +136,7 @@ int DPD::contract444_df(dpdbuf4 *B, dpdbuf4 *tau_in, dpdbuf4 *tau_out, double al
                 int ps = tau_out->params->rowidx[p][s];
                 int sp = tau_out->params->rowidx[s][p];
 
-                len = tau_in->params->coltot[Gpq];
+                len = tau_in->params->coltot[Gpq ^ Gtau];
                 if (len) {
                     // T_pq_ij <- (pr|qs) T_rs_ij
                     C_DAXPY(len, prqs, tau_in->matrix[Gpq][rs], 1, arr[Gpq][pq], 1);
@@ -144,7 +147,7 @@ int DPD::contract444_df(dpdbuf4 *B, dpdbuf4 *tau_in, dpdbuf4 *tau_out, double al
                     // T_sr_ij <- (sq|rp) T_qp_ij
                     C_DAXPY(len, prqs, tau_in->matrix[Grs][qp], 1, arr[Grs][sr], 1);
                 }
-                len = tau_in->params->coltot[Grq];
+                len = tau_in->params->coltot[Grq ^ Gtau];
                 if (len) {
                     // T_rq_ij <- (rp|qs) T_ps_ij
                     C_DAXPY(len, prqs, tau_in->matrix[Grq][ps], 1, arr[Grq][rq], 1);
@@ -174,14 +177,14 @@ int DPD::contract444_df(dpdbuf4 *B, dpdbuf4 *tau_in, dpdbuf4 *tau_out, double al
             // Build the integral
             double prqs = alpha * C_DDOT(len, B->matrix[Gpr][pr], 1, B->matrix[Gpr][pr], 1);
 
-            len = tau_in->params->coltot[Gpq];
+            len = tau_in->params->coltot[Gpq ^ Gtau];
             if (len) {
                 // T_pq_ij <- (pr|qs) T_rs_ij
                 C_DAXPY(len, prqs, tau_in->matrix[Gpq][rs], 1, arr[Gpq][pq], 1);
                 // T_rs_ij <- (rp|sq) T_pq_ij
                 C_DAXPY(len, prqs, tau_in->matrix[Grs][pq], 1, arr[Grs][rs], 1);
             }
-            len = tau_in->params->coltot[Grq];
+            len = tau_in->params->coltot[Grq ^ Gtau];
             if (len) {
                 // T_rq_ij <- (rp|qs) T_ps_ij
                 C_DAXPY(len, prqs, tau_in->matrix[Grq][ps], 1, arr[Grq][rq], 1);
@@ -198,9 +201,9 @@ int DPD::contract444_df(dpdbuf4 *B, dpdbuf4 *tau_in, dpdbuf4 *tau_out, double al
         double ***arr = arrays[thread];
         for (int h = 0; h < tau_out->params->nirreps; ++h) {
             for (int row = 0; row < tau_out->params->rowtot[h]; ++row)
-                for (int col = 0; col < tau_out->params->coltot[h]; ++col)
+                for (int col = 0; col < tau_out->params->coltot[h ^ Gtau]; ++col)
                     tau_out->matrix[h][row][col] += arr[h][row][col];
-            if (tau_out->params->rowtot[h] && tau_out->params->coltot[h]) free_block(arr[h]);
+            if (tau_out->params->rowtot[h] && tau_out->params->coltot[h ^ Gtau]) free_block(arr[h]);
         }
         delete[] arrays[thread];
         arrays.push_back(arr);
@@ -42,6 +42,7 @@ PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 #include <memory>
 PRAGMA_WARNING_POP
+#include <tuple>
 #include <vector>
 #include "psi4/psi4-dec.h"
 
@@ -51,6 +52,8 @@ PRAGMA_WARNING_POP
 namespace psi {
 
 class Matrix;
+class Options;
+struct dpd_file4_zcache;
 
 #define T3_TIMER_ON (0)
 
@@ -95,6 +98,7 @@ struct dpdfile4 {
     dpdparams4 *params;
     int incore;
     double ***matrix;
+    dpd_file4_zcache *zcache; /* Companion table and row offsets of a compressed file4 */
 };
 
 struct dpdshift4 {
@@ -171,6 +175,9 @@ struct dpd_file4_cache_entry {
     size_t priority;             /* priority level */
     int lock;                    /* auto-deletion allowed? */
     int clean;                   /* has this file4 changed? */
+    size_t added;                /* access time when read into the cache */
+    size_t hits;                 /* number of file4_init() calls served from the cache */
+    double load_time;            /* measured seconds to read the entry from disk */
     dpd_file4_cache_entry *next; /* pointer to next cache entry */
     dpd_file4_cache_entry *last; /* pointer to previous cache entry */
 };
@@ -253,14 +260,32 @@ struct dpd_gbl {
           file4_cache_most_recent(0),
           file4_cache_least_recent(1),
           file4_cache_lru_del(0),
-          file4_cache_low_del(0) {}
+          file4_cache_low_del(0),
+          file4_cache_cost_del(0),
+          file4_cache_hits(0),
+          file4_cache_misses(0),
+          file4_cache_saved_bytes(0),
+          file4_cache_saved_time(0.0),
+          file4_cache_load_time(0.0),
+          compression(0),
+          compression_bits(52),
+          file4_cache_closing(0) {}
     dpd_file2_cache_entry *file2_cache;
     dpd_file4_cache_entry *file4_cache;
     size_t file4_cache_most_recent;
     size_t file4_cache_least_recent;
     size_t file4_cache_lru_del;
     size_t file4_cache_low_del;
-    int cachetype;
+    size_t file4_cache_cost_del;
+    size_t file4_cache_hits;
+    size_t file4_cache_misses;
+    size_t file4_cache_saved_bytes; /* disk reads avoided by cache hits */
+    double file4_cache_saved_time;  /* ... and their estimated cost in seconds */
+    double file4_cache_load_time;   /* seconds spent reading entries into the cache */
+    int cachetype; /* 0 = LRU, 1 = LOW (priority list), 2 = COST (adaptive) */
+    int compression;      /* file4 irrep blocks on disk: 0 = fixed layout, 1 = lossless, 2 = lossy */
+    int compression_bits; /* mantissa bits kept by lossy compression */
+    int file4_cache_closing; /* set while file4_cache_close() empties the cache */
     int *cachefiles;
     int **cachelist;
     dpd_file4_cache_entry *file4_cache_priority;
@@ -383,6 +408,11 @@ class PSI_API DPD {
     int file4_print(dpdfile4 *File, std::string out_fname);
     int file4_mat_irrep_rd_block(dpdfile4 *File, int irrep, int start_pq, int num_pq);
     int file4_mat_irrep_wrt_block(dpdfile4 *File, int irrep, int start_pq, int num_pq);
+    bool file4_on_disk(dpdfile4 *File);
+    int file4_mat_irrep_zrd(dpdfile4 *File, int irrep, int start_pq, int num_pq, double *buffer);
+    int file4_mat_irrep_zwrt(dpdfile4 *File, int irrep);
+    void file4_zexpand(dpdfile4 *File);
+    void file4_zclose(dpdfile4 *File);
 
     int buf4_init(dpdbuf4 *Buf, int inputfile, int irrep, int pqnum, int rsnum, int file_pqnum, int file_rsnum,
                   int anti, const std::string& label);
@@ -445,12 +475,15 @@ class PSI_API DPD {
     int file2_cache_add(dpdfile2 *File);
     int file2_cache_del(dpdfile2 *File);
     int file4_cache_del_low();
+    int file4_cache_del_cost();
+    void file4_cache_del_entry(dpd_file4_cache_entry *entry);
     void file2_cache_dirty(dpdfile2 *File);
 
     void file4_cache_init();
     void file4_cache_close();
     void file4_cache_print(std::string out_fname);
     void file4_cache_print_screen();
+    void file4_cache_print_stats(std::string out_fname);
     int file4_cache_get_priority(dpdfile4 *File);
 
     dpd_file4_cache_entry *file4_cache_scan(int filenum, int irrep, int pqnum, int rsnum, const char *label,
@@ -463,6 +496,9 @@ class PSI_API DPD {
     void file4_cache_dirty(dpdfile4 *File);
     void file4_cache_lock(dpdfile4 *File);
     void file4_cache_unlock(dpdfile4 *File);
+    int file4_persist_put(dpdfile4 *File);
+    int file4_persist_get(dpdfile4 *File);
+    void file4_persist_seal();
 
     void sort_3d(double ***Win, double ***Wout, int nirreps, int h, int *rowtot, int **rowidx, int ***roworb, int *asym,
                  int *bsym, int *aoff, int *boff, int *cpi, int *coff, int **rowidx_out, enum pattern index, int sum);
@@ -533,6 +569,12 @@ extern int dpd_init(int dpd_num, int nirreps, long int memory, int cachetype, in
 extern int dpd_close(int dpd_num);
 extern long int PSI_API dpd_memfree();
 extern void dpd_memset(long int memory);
+extern PSI_API void dpd_set_compression(int type, int bits);
+extern PSI_API void dpd_set_compression(Options &options);
+extern PSI_API void dpd_set_persistent_cache(size_t bytes);
+extern PSI_API void dpd_persistent_cache_clear();
+extern PSI_API void dpd_persistent_cache_print(std::string out = "outfile");
+PSI_API std::vector<std::tuple<std::string, int, int, double, double>> benchmark_dpd(int N, double min_time);
 
 }  // Namespace psi
 
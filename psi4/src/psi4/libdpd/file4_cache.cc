@@ -30,6 +30,7 @@
     \ingroup DPD
     \brief Enter brief description of file here
 */
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -44,35 +45,50 @@ void DPD::file4_cache_init() {
     dpd_main.file4_cache_least_recent = 1;
     dpd_main.file4_cache_lru_del = 0;
     dpd_main.file4_cache_low_del = 0;
+    dpd_main.file4_cache_cost_del = 0;
 }
 
 void DPD::file4_cache_close() {
-    int dpdnum;
     dpd_file4_cache_entry *this_entry, *next_entry;
-    dpdfile4 Outfile;
 
     this_entry = dpd_main.file4_cache;
 
-    /* save the current dpd_default */
-    dpdnum = dpd_default;
-
+    dpd_main.file4_cache_closing = 1;
     while (this_entry != nullptr) {
-        dpd_set_default(this_entry->dpdnum);
-
-        /* Clean out each file4_cache entry */
-        file4_init(&Outfile, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
-                   this_entry->label);
-
         next_entry = this_entry->next;
 
-        file4_cache_del(&Outfile);
-        file4_close(&Outfile);
+        /* Clean out each file4_cache entry */
+        file4_cache_del_entry(this_entry);
 
         this_entry = next_entry;
     }
+    dpd_main.file4_cache_closing = 0;
+    file4_persist_seal();
+}
+
+/* Write back and delete a cache entry picked by the cache itself. The file4_init() needed for
+   this must not count as a cache hit, so the hit statistics are restored afterwards. */
+void DPD::file4_cache_del_entry(dpd_file4_cache_entry *this_entry) {
+    int dpdnum;
+    dpdfile4 File;
+    size_t hits = dpd_main.file4_cache_hits;
+    size_t saved_bytes = dpd_main.file4_cache_saved_bytes;
+    double saved_time = dpd_main.file4_cache_saved_time;
+
+    /* save the current dpd_default */
+    dpdnum = dpd_default;
+    dpd_set_default(this_entry->dpdnum);
+
+    file4_init(&File, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum, this_entry->label);
+    file4_cache_del(&File);
+    file4_close(&File);
 
     /* return the dpd_default to its original value */
     dpd_set_default(dpdnum);
+
+    dpd_main.file4_cache_hits = hits;
+    dpd_main.file4_cache_saved_bytes = saved_bytes;
+    dpd_main.file4_cache_saved_time = saved_time;
 }
 
 dpd_file4_cache_entry *DPD::file4_cache_scan(int filenum, int irrep, int pqnum, int rsnum, const char *label,
@@ -137,6 +153,12 @@ int DPD::file4_cache_add(dpdfile4 *File, size_t priority) {
     } else if (this_entry != nullptr && File->incore) {
         /* We already have this one in cache, but change its priority level */
         this_entry->priority = priority;
+
+        /* Count the disk read this saved */
+        this_entry->hits++;
+        dpd_main.file4_cache_hits++;
+        dpd_main.file4_cache_saved_bytes += static_cast<size_t>(this_entry->size) * sizeof(double);
+        dpd_main.file4_cache_saved_time += this_entry->load_time;
         return 0;
     } else if (this_entry == nullptr && !(File->incore)) { /* New cache entry */
 
@@ -146,13 +168,21 @@ int DPD::file4_cache_add(dpdfile4 *File, size_t priority) {
         dpdnum = dpd_default;
         dpd_set_default(File->dpdnum);
 
-        /* Read all data into core */
+        /* Read all data into core, timing the reads for the COST policy */
+        auto t0 = std::chrono::steady_clock::now();
         this_entry->size = 0;
-        for (h = 0; h < File->params->nirreps; h++) {
+        for (h = 0; h < File->params->nirreps; h++)
             this_entry->size += File->params->rowtot[h] * File->params->coltot[h ^ (File->my_irrep)];
-            file4_mat_irrep_init(File, h);
-            file4_mat_irrep_rd(File, h);
+        /* A previous module may have left the blocks behind; see file4_persist.cc */
+        if (!file4_persist_get(File)) {
+            for (h = 0; h < File->params->nirreps; h++) {
+                file4_mat_irrep_init(File, h);
+                file4_mat_irrep_rd(File, h);
+            }
         }
+        this_entry->load_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        dpd_main.file4_cache_load_time += this_entry->load_time;
+        dpd_main.file4_cache_misses++;
 
         this_entry->dpdnum = File->dpdnum;
         this_entry->filenum = File->filenum;
@@ -176,6 +206,8 @@ int DPD::file4_cache_add(dpdfile4 *File, size_t priority) {
 
         /* initialize the usage counter */
         this_entry->usage = 1;
+        this_entry->added = dpd_main.file4_cache_most_recent;
+        this_entry->hits = 0;
 
         /* Set the clean flag */
         this_entry->clean = 1;
@@ -219,11 +251,11 @@ int DPD::file4_cache_del(dpdfile4 *File) {
 
         File->incore = 0;
 
-        /* Write all the data to disk and free the memory */
-        for (h = 0; h < File->params->nirreps; h++) {
+        /* Write all the data to disk and free the memory, or keep it for the next DPD */
+        for (h = 0; h < File->params->nirreps; h++)
             if (!(this_entry->clean)) file4_mat_irrep_wrt(File, h);
-            file4_mat_irrep_close(File, h);
-        }
+        if (!(dpd_main.file4_cache_closing && file4_persist_put(File)))
+            for (h = 0; h < File->params->nirreps; h++) file4_mat_irrep_close(File, h);
 
         next_entry = this_entry->next;
         last_entry = this_entry->last;
@@ -267,8 +299,8 @@ void DPD::file4_cache_print_screen() {
     outfile->Printf("--------------------------------------------------------------------------------\n");
     outfile->Printf("Total cached: %9.1f kB; MRU = %6zu; LRU = %6zu\n", (total_size * sizeof(double)) / 1e3,
                     dpd_main.file4_cache_most_recent, dpd_main.file4_cache_least_recent);
-    outfile->Printf("#LRU deletions = %6zu; #Low-priority deletions = %6zu\n", dpd_main.file4_cache_lru_del,
-                    dpd_main.file4_cache_low_del);
+    outfile->Printf("#LRU deletions = %6zu; #Low-priority deletions = %6zu; #Cost deletions = %6zu\n",
+                    dpd_main.file4_cache_lru_del, dpd_main.file4_cache_low_del, dpd_main.file4_cache_cost_del);
     outfile->Printf("Core max size:  %9.1f kB\n", (dpd_main.memory) * sizeof(double) / 1e3);
     outfile->Printf("Core used:      %9.1f kB\n", (dpd_main.memused) * sizeof(double) / 1e3);
     outfile->Printf("Core available: %9.1f kB\n", dpd_memfree() * sizeof(double) / 1e3);
@@ -299,8 +331,8 @@ void DPD::file4_cache_print(std::string out) {
     printer->Printf("--------------------------------------------------------------------------------\n");
     printer->Printf("Total cached: %8.1f kB; MRU = %6zu; LRU = %6zu\n", (total_size * sizeof(double)) / 1e3,
                     dpd_main.file4_cache_most_recent, dpd_main.file4_cache_least_recent);
-    printer->Printf("#LRU deletions = %6zu; #Low-priority deletions = %6zu\n", dpd_main.file4_cache_lru_del,
-                    dpd_main.file4_cache_low_del);
+    printer->Printf("#LRU deletions = %6zu; #Low-priority deletions = %6zu; #Cost deletions = %6zu\n",
+                    dpd_main.file4_cache_lru_del, dpd_main.file4_cache_low_del, dpd_main.file4_cache_cost_del);
     printer->Printf("Core max size:  %9.1f kB\n", (dpd_main.memory) * sizeof(double) / 1e3);
     printer->Printf("Core used:      %9.1f kB\n", (dpd_main.memused) * sizeof(double) / 1e3);
     printer->Printf("Core available: %9.1f kB\n", dpd_memfree() * sizeof(double) / 1e3);
@@ -343,8 +375,6 @@ dpd_file4_cache_entry *DPD::file4_cache_find_lru() {
 }
 
 int DPD::file4_cache_del_lru() {
-    int dpdnum;
-    dpdfile4 File;
     dpd_file4_cache_entry *this_entry;
 
 #ifdef DPD_TIMER
@@ -368,18 +398,7 @@ int DPD::file4_cache_del_lru() {
         /* increment the global LRU deletion counter */
         dpd_main.file4_cache_lru_del++;
 
-        /* Save the current dpd_default */
-        dpdnum = dpd_default;
-        dpd_set_default(this_entry->dpdnum);
-
-        file4_init(&File, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
-                   this_entry->label);
-
-        file4_cache_del(&File);
-        file4_close(&File);
-
-        /* Return the default DPD to its original value */
-        dpd_set_default(dpdnum);
+        file4_cache_del_entry(this_entry);
 
 #ifdef DPD_TIMER
         timer_off("cache_lru");
@@ -446,8 +465,6 @@ dpd_file4_cache_entry *dpd_file4_cache_find_low() {
 }
 
 int DPD::file4_cache_del_low() {
-    int dpdnum;
-    dpdfile4 File;
     dpd_file4_cache_entry *this_entry;
 
 #ifdef DPD_TIMER
@@ -471,25 +488,85 @@ int DPD::file4_cache_del_low() {
         /* increment the global LOW deletion counter */
         dpd_main.file4_cache_low_del++;
 
-        /* save the current dpd default value */
-        dpdnum = dpd_default;
+        file4_cache_del_entry(this_entry);
+
+#ifdef DPD_TIMER
+        timer_off("cache_low");
+#endif
 
-        dpd_set_default(this_entry->dpdnum);
+        return 0;
+    }
+}
 
-        file4_init(&File, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
-                   this_entry->label);
-        file4_cache_del(&File);
-        file4_close(&File);
+/* Value per byte of keeping an entry: how often it is reused since it was read in, times what
+   reading it again would cost (twice that for a dirty entry, which must be written back first).
+   A small size term breaks ties between entries too fast to time. */
+static double dpd_file4_cache_value(const dpd_file4_cache_entry *this_entry) {
+    const double bytes = static_cast<double>(this_entry->size) * sizeof(double) + 1.0;
+    const double age = static_cast<double>(dpd_main.file4_cache_most_recent - this_entry->added) + 1.0;
+    const double rate = (this_entry->hits + 1.0) / age;
+    const double cost = (this_entry->clean ? 1.0 : 2.0) * this_entry->load_time + 1.0e-10 * bytes;
+    return rate * cost / bytes;
+}
 
-        /* return the default dpd to its original value */
-        dpd_set_default(dpdnum);
+dpd_file4_cache_entry *dpd_file4_cache_find_cost() {
+    dpd_file4_cache_entry *this_entry, *low_entry = nullptr;
+    double low_value = 0.0;
+
+    for (this_entry = dpd_main.file4_cache; this_entry != nullptr; this_entry = this_entry->next) {
+        if (this_entry->lock) continue;
+        double value = dpd_file4_cache_value(this_entry);
+        if (low_entry == nullptr || value < low_value) {
+            low_entry = this_entry;
+            low_value = value;
+        }
+    }
+
+    return low_entry;
+}
+
+int DPD::file4_cache_del_cost() {
+    dpd_file4_cache_entry *this_entry;
 
 #ifdef DPD_TIMER
-        timer_off("cache_low");
+    timer_on("cache_cost");
 #endif
 
-        return 0;
+    this_entry = dpd_file4_cache_find_cost();
+
+    if (this_entry == nullptr) {
+#ifdef DPD_TIMER
+        timer_off("cache_cost");
+#endif
+        return 1; /* there is no cache or everything is locked */
     }
+
+    /* increment the global cost-based deletion counter */
+    dpd_main.file4_cache_cost_del++;
+
+    file4_cache_del_entry(this_entry);
+
+#ifdef DPD_TIMER
+    timer_off("cache_cost");
+#endif
+
+    return 0;
+}
+
+void DPD::file4_cache_print_stats(std::string out) {
+    std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
+    const size_t lookups = dpd_main.file4_cache_hits + dpd_main.file4_cache_misses;
+    if (!lookups) return;
+
+    printer->Printf("\n    DPD File4 Cache Statistics (%s policy):\n",
+                    dpd_main.cachetype == 2 ? "COST" : (dpd_main.cachetype == 1 ? "LOW" : "LRU"));
+    printer->Printf("      Hits / misses    = %zu / %zu (%.1f%% hits)\n", dpd_main.file4_cache_hits,
+                    dpd_main.file4_cache_misses, 100.0 * dpd_main.file4_cache_hits / lookups);
+    printer->Printf("      Deletions        = %zu LRU, %zu low-priority, %zu cost\n", dpd_main.file4_cache_lru_del,
+                    dpd_main.file4_cache_low_del, dpd_main.file4_cache_cost_del);
+    printer->Printf("      Read into cache  = %.3f s\n", dpd_main.file4_cache_load_time);
+    printer->Printf("      I/O saved        = %.1f MB, est. %.3f s\n", dpd_main.file4_cache_saved_bytes / 1e6,
+                    dpd_main.file4_cache_saved_time);
 }
 
 void DPD::file4_cache_lock(dpdfile4 *File) {
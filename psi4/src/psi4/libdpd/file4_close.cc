@@ -44,6 +44,7 @@ namespace psi {
 
 int DPD::file4_close(dpdfile4 *File) {
     file4_cache_unlock(File);
+    file4_zclose(File);
 
     free(File->lfiles);
 
@@ -0,0 +1,325 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Optional compressed storage of file4 irrep blocks
+*/
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "dpd.h"
+
+/*
+** When dpd_main.compression is set, whole-irrep writes of a file4 go to a companion TOC
+** entry, "[z] <label>", instead of the usual fixed-offset layout.  The companion starts with
+** a table of {offset, bytes, capacity} per irrep followed by the next free offset; each
+** irrep block is a list of row offsets followed by the independently encoded rows, so that
+** single rows and row blocks can still be read without decoding the whole irrep.
+**
+** A row is encoded value by value as the XOR with the previous value, stored as a header
+** byte holding the number of leading and trailing zero bytes followed by the remaining
+** bytes; exact zeros are a single byte.  Rows that would not shrink are stored verbatim.  With lossy
+** compression the low mantissa bits are dropped first, keeping dpd_main.compression_bits
+** of the 52, so the relative error of each element is below 2^-compression_bits.
+**
+** Partial writes (rows or row blocks) need the fixed layout, so they first move any
+** compressed irreps of the file back to it.
+**
+** Reads follow whatever is on disk, whatever dpd_main.compression is now.  Each dpdfile4
+** keeps the companion table, and the row offsets of the irreps it has read, in File->zcache;
+** any compressed write or expansion bumps a generation count, which makes every handle
+** reload them.  A row read is then a single psio_read.
+*/
+
+namespace psi {
+
+/* Per-handle copy of the companion table, valid while generation is current */
+struct dpd_file4_zcache {
+    size_t generation;
+    bool compressed; /* the companion entry exists */
+    std::vector<size_t> table;
+    std::vector<std::vector<size_t>> rowoff; /* per irrep, empty until first read */
+};
+
+namespace {
+
+std::mutex zlock;
+size_t zgeneration = 0; /* bumped by every change to any companion entry, under zlock */
+
+/* The companion TOC entry holding the compressed irreps; false if the label is too long */
+bool zkey(const dpdfile4 *File, char *key) {
+    if (std::strlen(File->label) + 5 > PSIO_KEYLEN) return false;
+    std::sprintf(key, "[z] %s", File->label);
+    return true;
+}
+
+/* Byte offsets within the companion entry */
+psio_address zaddress(size_t offset) { return psio_get_address(PSIO_ZERO, offset); }
+
+const unsigned char zzero = 0xf0; /* header of an exact zero, which doesn't reset the predictor */
+
+/* Append the encoding of n doubles to out; rows that don't shrink are stored as they are */
+void zencode(const double *data, size_t n, int bits, std::vector<unsigned char> &out) {
+    uint64_t mask = bits < 52 ? ~((uint64_t(1) << (52 - bits)) - 1) : ~uint64_t(0);
+    uint64_t prev = 0;
+    size_t start = out.size();
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(double));
+        word &= mask;
+        if (word == 0) {
+            out.push_back(zzero);
+            continue;
+        }
+        uint64_t x = word ^ prev;
+        prev = word;
+        int lead = 0, trail = 0;
+        if (x == 0) {
+            lead = 8;
+        } else {
+            while (!(x >> (56 - 8 * lead) & 0xff)) ++lead;
+            while (!(x >> (8 * trail) & 0xff)) ++trail;
+        }
+        out.push_back((unsigned char)(lead << 4 | trail));
+        for (int b = trail; b < 8 - lead; ++b) out.push_back((unsigned char)(x >> (8 * b) & 0xff));
+        if (out.size() - start >= n * sizeof(double)) break;
+    }
+    if (out.size() - start >= n * sizeof(double)) {
+        out.resize(start + n * sizeof(double));
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(double));
+            word &= mask;
+            std::memcpy(&out[start + i * sizeof(double)], &word, sizeof(double));
+        }
+    }
+}
+
+/* Decode n doubles from the len bytes at in */
+void zdecode(const unsigned char *in, size_t len, size_t n, double *data) {
+    if (len == n * sizeof(double)) {
+        std::memcpy(data, in, len);
+        return;
+    }
+    uint64_t prev = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (*in == zzero) {
+            data[i] = 0.0;
+            ++in;
+            continue;
+        }
+        int lead = *in >> 4;
+        int trail = *in++ & 0xf;
+        uint64_t x = 0;
+        for (int b = trail; b < 8 - lead; ++b) x |= uint64_t(*in++) << (8 * b);
+        prev ^= x;
+        std::memcpy(data + i, &prev, sizeof(double));
+    }
+}
+
+/* The companion table: offset, bytes, capacity for each irrep, then the next free offset */
+bool zread_table(const dpdfile4 *File, const char *key, std::vector<size_t> &table) {
+    if (psio_tocscan(File->filenum, key) == nullptr) return false;
+    psio_address next;
+    table.resize(3 * File->params->nirreps + 1);
+    psio_read(File->filenum, key, (char *)table.data(), table.size() * sizeof(size_t), PSIO_ZERO, &next);
+    return true;
+}
+
+void zwrite_table(const dpdfile4 *File, const char *key, const std::vector<size_t> &table) {
+    psio_address next;
+    psio_write(File->filenum, key, (char *)table.data(), table.size() * sizeof(size_t), PSIO_ZERO, &next);
+}
+
+/* The cached companion table of File, reloaded if stale; call with zlock held */
+dpd_file4_zcache *zcached(dpdfile4 *File, const char *key) {
+    if (File->zcache != nullptr && File->zcache->generation == zgeneration) return File->zcache;
+    if (File->zcache == nullptr) File->zcache = new dpd_file4_zcache;
+    dpd_file4_zcache *cache = File->zcache;
+    cache->generation = zgeneration;
+    cache->compressed = zread_table(File, key, cache->table);
+    cache->rowoff.assign(File->params->nirreps, std::vector<size_t>());
+    return cache;
+}
+
+/* The number of bytes of the fixed layout on disk from entry-relative address start */
+size_t zfixed_bytes(const dpdfile4 *File, psio_address start) {
+    psio_tocentry *entry = psio_tocscan(File->filenum, File->label);
+    if (entry == nullptr) return 0;
+    psio_address data = psio_get_address(entry->sadd, sizeof(psio_tocentry) - 2 * sizeof(psio_tocentry *));
+    psio_address first = psio_get_global_address(data, start);
+    psio_address eadd = entry->eadd;
+    if (first.page > eadd.page || (first.page == eadd.page && first.offset >= eadd.offset)) return 0;
+    return (eadd.page - first.page) * PSIO_PAGELEN + eadd.offset - first.offset;
+}
+
+}  // namespace
+
+/* file4_on_disk(): Whether any irrep of this file4 has been written to disk,
+** in either the fixed or the compressed layout.
+*/
+bool DPD::file4_on_disk(dpdfile4 *File) {
+    if (psio_tocscan(File->filenum, File->label) != nullptr) return true;
+    char key[PSIO_KEYLEN];
+    if (!zkey(File, key)) return false;
+    std::lock_guard<std::mutex> guard(zlock);
+    return zcached(File, key)->compressed;
+}
+
+/* file4_zclose(): Releases the cached companion table of this file4. */
+void DPD::file4_zclose(dpdfile4 *File) {
+    delete File->zcache;
+    File->zcache = nullptr;
+}
+
+/* file4_mat_irrep_zwrt(): Writes File->matrix[irrep] in the compressed layout.
+** Returns 1 if compression is off or not possible for this file, in which case
+** the caller writes the fixed layout as usual.
+*/
+int DPD::file4_mat_irrep_zwrt(dpdfile4 *File, int irrep) {
+    char key[PSIO_KEYLEN];
+    if (!dpd_main.compression || !zkey(File, key)) return 1;
+
+    size_t rowtot = File->params->rowtot[irrep];
+    size_t coltot = File->params->coltot[irrep ^ File->my_irrep];
+    int bits = dpd_main.compression == 2 ? dpd_main.compression_bits : 52;
+
+    std::vector<unsigned char> data;
+    std::vector<size_t> rowoff(rowtot + 1, 0);
+    data.reserve(rowtot * coltot * sizeof(double) / 2);
+    if (coltot) {
+        for (size_t row = 0; row < rowtot; ++row) {
+            zencode(File->matrix[irrep][row], coltot, bits, data);
+            rowoff[row + 1] = data.size();
+        }
+    }
+    size_t bytes = rowoff.size() * sizeof(size_t) + data.size();
+
+    std::lock_guard<std::mutex> guard(zlock);
+    std::vector<size_t> table;
+    if (!zread_table(File, key, table)) {
+        table.assign(3 * File->params->nirreps + 1, 0);
+        table.back() = table.size() * sizeof(size_t);
+    }
+    size_t *entry = &table[3 * irrep];
+    if (bytes > entry[2]) {
+        /* Doesn't fit where this irrep was before; append it */
+        entry[0] = table.back();
+        entry[2] = bytes;
+        table.back() += bytes;
+    }
+    entry[1] = bytes;
+
+    psio_address next;
+    zwrite_table(File, key, table);
+    psio_write(File->filenum, key, (char *)rowoff.data(), rowoff.size() * sizeof(size_t), zaddress(entry[0]), &next);
+    if (data.size()) psio_write(File->filenum, key, (char *)data.data(), data.size(), next, &next);
+    ++zgeneration;
+
+    return 0;
+}
+
+/* file4_mat_irrep_zrd(): Reads rows start_pq to start_pq + num_pq - 1 of irrep into buffer,
+** if that irrep is stored compressed.  Returns 1 otherwise, in which case the caller reads
+** the fixed layout as usual.
+*/
+int DPD::file4_mat_irrep_zrd(dpdfile4 *File, int irrep, int start_pq, int num_pq, double *buffer) {
+    char key[PSIO_KEYLEN];
+    if (!zkey(File, key)) return 1;
+
+    std::lock_guard<std::mutex> guard(zlock);
+    dpd_file4_zcache *cache = zcached(File, key);
+    if (!cache->compressed || !cache->table[3 * irrep + 1]) return 1;
+
+    size_t offset = cache->table[3 * irrep];
+    size_t rowtot = File->params->rowtot[irrep];
+    size_t coltot = File->params->coltot[irrep ^ File->my_irrep];
+    if (!num_pq || !coltot) return 0;
+
+    psio_address next;
+    std::vector<size_t> &rowoff = cache->rowoff[irrep];
+    if (rowoff.empty()) {
+        rowoff.resize(rowtot + 1);
+        psio_read(File->filenum, key, (char *)rowoff.data(), rowoff.size() * sizeof(size_t), zaddress(offset),
+                  &next);
+    }
+    const size_t *off = rowoff.data() + start_pq;
+
+    std::vector<unsigned char> data(off[num_pq] - off[0]);
+    if (data.size())
+        psio_read(File->filenum, key, (char *)data.data(), data.size(),
+                  zaddress(offset + (rowtot + 1) * sizeof(size_t) + off[0]), &next);
+    for (int row = 0; row < num_pq; ++row)
+        zdecode(data.data() + off[row] - off[0], off[row + 1] - off[row], coltot, buffer + row * coltot);
+
+    return 0;
+}
+
+/* file4_zexpand(): Moves every compressed irrep of this file4 back to the fixed layout,
+** so that rows and row blocks can be written in place.  Irreps never written are zeroed.
+*/
+void DPD::file4_zexpand(dpdfile4 *File) {
+    char key[PSIO_KEYLEN];
+    if (!zkey(File, key)) return;
+
+    std::vector<size_t> table;
+    {
+        std::lock_guard<std::mutex> guard(zlock);
+        if (!zread_table(File, key, table)) return;
+    }
+    bool compressed = false;
+    for (int h = 0; h < File->params->nirreps; ++h) compressed |= table[3 * h + 1] != 0;
+    if (!compressed) return;
+
+    for (int h = 0; h < File->params->nirreps; ++h) {
+        size_t rowtot = File->params->rowtot[h];
+        size_t coltot = File->params->coltot[h ^ File->my_irrep];
+        if (!rowtot || !coltot) continue;
+        std::vector<double> block(rowtot * coltot, 0.0);
+        psio_address next;
+        if (file4_mat_irrep_zrd(File, h, 0, rowtot, block.data())) {
+            /* Not compressed: keep whatever part of it is already in the fixed layout */
+            size_t have = zfixed_bytes(File, File->lfiles[h]);
+            if (have >= block.size() * sizeof(double)) continue;
+            if (have) psio_read(File->filenum, File->label, (char *)block.data(), have, File->lfiles[h], &next);
+        }
+        psio_write(File->filenum, File->label, (char *)block.data(), block.size() * sizeof(double), File->lfiles[h],
+                   &next);
+    }
+
+    std::lock_guard<std::mutex> guard(zlock);
+    for (int h = 0; h < File->params->nirreps; ++h) table[3 * h + 1] = 0;
+    zwrite_table(File, key, table);
+    ++zgeneration;
+}
+
+}  // namespace psi
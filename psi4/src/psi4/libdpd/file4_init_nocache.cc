@@ -67,6 +67,7 @@ int DPD::file4_init_nocache(dpdfile4 *File, int filenum, int irrep, int pqnum, i
     strcpy(File->label, label);
     File->filenum = filenum;
     File->my_irrep = irrep;
+    File->zcache = nullptr;
 
     this_entry = file4_cache_scan(filenum, irrep, pqnum, rsnum, label, dpd_default);
     if (this_entry != nullptr) {
@@ -31,6 +31,7 @@
     \brief Enter brief description of file here
 */
 #include <cstdio>
+#include <cstring>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libqt/qt.h"
 #include "dpd.h"
@@ -45,7 +46,7 @@ int DPD::file4_mat_irrep_rd(dpdfile4 *File, int irrep) {
     if (File->incore) return 0; /* We already have this data in core */
 
     /* If the data doesn't actually exist on disk, we just leave */
-    if (psio_tocscan(File->filenum, File->label) == nullptr) return 1;
+    if (!file4_on_disk(File)) return 1;
 
 #ifdef DPD_TIMER
     timer_on("file4_rd");
@@ -57,9 +58,15 @@ int DPD::file4_mat_irrep_rd(dpdfile4 *File, int irrep) {
     coltot = File->params->coltot[irrep ^ my_irrep];
     size = ((long)rowtot) * ((long)coltot);
 
-    if (rowtot && coltot)
-        psio_read(File->filenum, File->label, (char *)File->matrix[irrep][0], size * ((long)sizeof(double)), irrep_ptr,
-                  &next_address);
+    /* A compressed irrep is decoded straight into the matrix; anything else is in the fixed layout,
+       and an irrep in neither (only other irreps were written, compressed) reads as zero */
+    if (rowtot && coltot && file4_mat_irrep_zrd(File, irrep, 0, rowtot, File->matrix[irrep][0])) {
+        if (psio_tocscan(File->filenum, File->label) != nullptr)
+            psio_read(File->filenum, File->label, (char *)File->matrix[irrep][0], size * ((long)sizeof(double)),
+                      irrep_ptr, &next_address);
+        else
+            ::memset(File->matrix[irrep][0], 0, size * sizeof(double));
+    }
 
 #ifdef DPD_TIMER
     timer_off("file4_rd");
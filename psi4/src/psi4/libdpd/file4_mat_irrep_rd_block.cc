@@ -52,6 +52,8 @@ int DPD::file4_mat_irrep_rd_block(dpdfile4 *File, int irrep, int start_pq, int n
 
     size = ((long)rowtot) * ((long)coltot);
 
+    if (rowtot && coltot && !file4_mat_irrep_zrd(File, irrep, start_pq, num_pq, File->matrix[irrep][0])) return 0;
+
     /* Advance file pointer to current row --- careful about overflows! */
     if (coltot) {
         seek_block = DPD_BIGNUM / (coltot * sizeof(double)); /* no. of rows for which we can compute the address */
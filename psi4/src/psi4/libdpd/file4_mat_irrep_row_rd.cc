@@ -53,6 +53,13 @@ int DPD::file4_mat_irrep_row_rd(dpdfile4 *File, int irrep, int row) {
     row_ptr = File->lfiles[irrep];
     coltot = File->params->coltot[irrep ^ my_irrep];
 
+    if (coltot && !file4_mat_irrep_zrd(File, irrep, row, 1, File->matrix[irrep][0])) {
+#ifdef DPD_TIMER
+        timer_off("f4_rowrd");
+#endif
+        return 0;
+    }
+
     /* Advance file pointer to current row --- careful about overflows! */
     if (coltot) {
         seek_block = DPD_BIGNUM / (coltot * sizeof(double)); /* no. of rows for which we can compute the address */
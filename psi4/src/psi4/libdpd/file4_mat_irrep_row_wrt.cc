@@ -46,6 +46,9 @@ int DPD::file4_mat_irrep_row_wrt(dpdfile4 *File, int irrep, int row) {
         return 0;                /* We're keeping the data in core */
     }
 
+    /* Rows are written in place, so the file has to be in the fixed layout */
+    file4_zexpand(File);
+
     my_irrep = File->my_irrep;
 
     row_ptr = File->lfiles[irrep];
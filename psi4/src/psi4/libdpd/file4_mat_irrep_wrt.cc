@@ -51,7 +51,7 @@ int DPD::file4_mat_irrep_wrt(dpdfile4 *File, int irrep) {
     coltot = File->params->coltot[irrep ^ my_irrep];
     size = ((long)rowtot) * ((long)coltot);
 
-    if (rowtot && coltot)
+    if (rowtot && coltot && file4_mat_irrep_zwrt(File, irrep))
         psio_write(File->filenum, File->label, (char *)File->matrix[irrep][0], size * ((long)sizeof(double)), irrep_ptr,
                    &next_address);
 
@@ -49,6 +49,9 @@ int DPD::file4_mat_irrep_wrt_block(dpdfile4 *File, int irrep, int start_pq, int
         return 0;                /* We're keeping this data in core */
     }
 
+    /* Rows are written in place, so the file has to be in the fixed layout */
+    file4_zexpand(File);
+
     my_irrep = File->my_irrep;
     irrep_ptr = File->lfiles[irrep];
     rowtot = num_pq;
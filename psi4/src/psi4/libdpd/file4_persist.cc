@@ -0,0 +1,245 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Process-wide store of file4 cache entries that outlives a DPD instance
+*/
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <string>
+#include <vector>
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/psi4-dec.h"
+#include "dpd.h"
+
+namespace psi {
+
+/*
+** When a module calls dpd_close(), the file4 cache is emptied: dirty entries
+** are written back and every block is freed, and the next module (cchbar ->
+** cclambda -> cceom -> ccdensity) reads the same Hbar blocks, integrals and
+** amplitudes from disk again.  With a budget set by dpd_set_persistent_cache(),
+** file4_cache_close() instead hands the blocks of each entry to the store
+** below, and file4_cache_add() takes them back on a miss.
+**
+** An entry is keyed by unit, label, irrep and pair indices, and is only
+** reused if the DPD layout of the reader has the same block dimensions and
+** the unit has not been written, cleaned or removed since the cache was
+** closed (PSIO::generation()).  The generation is taken once the whole cache
+** has been emptied, because the write-back of other dirty entries of the same
+** unit during file4_cache_close() does not touch the stored blocks.  Stale
+** entries and, past the budget, the least recently stored ones are freed.
+*/
+
+namespace {
+
+struct PersistEntry {
+    int filenum;
+    int irrep;
+    int pqnum;
+    int rsnum;
+    std::string label;
+    std::string ns;
+    size_t generation;
+    bool sealed; /* generation is set; see file4_persist_seal() */
+    std::vector<int> rowtot;
+    std::vector<int> coltot;
+    std::vector<double **> matrix;
+    size_t size;
+};
+
+/* Most recently stored at the front */
+std::list<PersistEntry> persist_store;
+size_t persist_budget = 0;
+size_t persist_used = 0;
+size_t persist_hits = 0;
+size_t persist_hit_bytes = 0;
+
+void persist_free(PersistEntry &entry) {
+    for (double **block : entry.matrix) {
+        if (block == nullptr) continue;
+        free(block[0]);
+        free(block);
+    }
+    persist_used -= entry.size;
+}
+
+/* Free stale entries, then the oldest ones until extra more doubles fit in the budget */
+void persist_trim(size_t extra) {
+    for (auto it = persist_store.begin(); it != persist_store.end();) {
+        if (it->sealed && it->generation != PSIO::generation(it->filenum)) {
+            persist_free(*it);
+            it = persist_store.erase(it);
+        } else
+            ++it;
+    }
+    while (!persist_store.empty() && (persist_used + extra) * sizeof(double) > persist_budget) {
+        persist_free(persist_store.back());
+        persist_store.pop_back();
+    }
+}
+
+}  // namespace
+
+/* dpd_set_persistent_cache(): Sets the memory, in bytes, of file4 blocks kept
+** between DPD instances.  Zero frees the store and turns it off.
+*/
+extern void dpd_set_persistent_cache(size_t bytes) {
+    persist_budget = bytes;
+    persist_trim(0);
+}
+
+/* dpd_persistent_cache_clear(): Frees every stored block, e.g. when the
+** scratch files are removed.
+*/
+extern void dpd_persistent_cache_clear() {
+    for (auto &entry : persist_store) persist_free(entry);
+    persist_store.clear();
+}
+
+/* file4_persist_put(): Moves the in-core blocks of File into the store.  Called
+** from file4_cache_del() after any write-back, so the blocks match the disk.
+** Returns 1 if the blocks were taken (File->matrix no longer owns them), 0 if
+** the caller must free them as usual.
+*/
+int DPD::file4_persist_put(dpdfile4 *File) {
+    int h, nirreps = File->params->nirreps;
+    size_t size = 0;
+
+    if (!persist_budget) return 0;
+
+    for (h = 0; h < nirreps; h++)
+        size += static_cast<size_t>(File->params->rowtot[h]) * File->params->coltot[h ^ File->my_irrep];
+    if (!size || size * sizeof(double) > persist_budget) return 0;
+
+    /* Drop an older copy of the same quantity */
+    for (auto it = persist_store.begin(); it != persist_store.end(); ++it) {
+        if (it->filenum == File->filenum && it->irrep == File->my_irrep && it->pqnum == File->params->pqnum &&
+            it->rsnum == File->params->rsnum && it->label == File->label) {
+            persist_free(*it);
+            persist_store.erase(it);
+            break;
+        }
+    }
+    persist_trim(size);
+
+    PersistEntry entry;
+    entry.filenum = File->filenum;
+    entry.irrep = File->my_irrep;
+    entry.pqnum = File->params->pqnum;
+    entry.rsnum = File->params->rsnum;
+    entry.label = File->label;
+    entry.ns = PSIO::get_default_namespace();
+    entry.generation = 0;
+    entry.sealed = false;
+    entry.size = size;
+    for (h = 0; h < nirreps; h++) {
+        int rowtot = File->params->rowtot[h];
+        int coltot = File->params->coltot[h ^ File->my_irrep];
+        entry.rowtot.push_back(rowtot);
+        entry.coltot.push_back(coltot);
+        entry.matrix.push_back(rowtot && coltot ? File->matrix[h] : nullptr);
+        File->matrix[h] = nullptr;
+        /* The block leaves this DPD's memory accounting */
+        if (rowtot && coltot) dpd_main.memused -= static_cast<long int>(rowtot) * coltot;
+    }
+    persist_used += size;
+    persist_store.push_front(std::move(entry));
+
+    return 1;
+}
+
+/* file4_persist_seal(): Stamps the entries stored by the file4_cache_close()
+** that just finished with the current generation of their units.
+*/
+void DPD::file4_persist_seal() {
+    for (auto &entry : persist_store) {
+        if (entry.sealed) continue;
+        entry.generation = PSIO::generation(entry.filenum);
+        entry.sealed = true;
+    }
+}
+
+/* file4_persist_get(): Fills the freshly allocated blocks of File from a
+** current stored entry.  Returns 1 on success, 0 if File must be read from disk.
+*/
+int DPD::file4_persist_get(dpdfile4 *File) {
+    int h, nirreps = File->params->nirreps;
+
+    if (persist_store.empty()) return 0;
+
+    for (auto it = persist_store.begin(); it != persist_store.end(); ++it) {
+        if (it->filenum != File->filenum || it->irrep != File->my_irrep || it->pqnum != File->params->pqnum ||
+            it->rsnum != File->params->rsnum || it->label != File->label)
+            continue;
+
+        bool valid = it->sealed && it->generation == PSIO::generation(File->filenum) &&
+                     it->ns == PSIO::get_default_namespace() && it->rowtot.size() == static_cast<size_t>(nirreps);
+        for (h = 0; valid && h < nirreps; h++)
+            valid = it->rowtot[h] == File->params->rowtot[h] &&
+                    it->coltot[h] == File->params->coltot[h ^ File->my_irrep];
+        if (!valid) {
+            persist_free(*it);
+            persist_store.erase(it);
+            return 0;
+        }
+
+        for (h = 0; h < nirreps; h++) {
+            file4_mat_irrep_init(File, h);
+            if (it->matrix[h] != nullptr)
+                ::memcpy(File->matrix[h][0], it->matrix[h][0],
+                         static_cast<size_t>(it->rowtot[h]) * it->coltot[h] * sizeof(double));
+        }
+        persist_hits++;
+        persist_hit_bytes += it->size * sizeof(double);
+
+        /* The DPD cache owns the data now */
+        persist_free(*it);
+        persist_store.erase(it);
+        return 1;
+    }
+
+    return 0;
+}
+
+/* dpd_persistent_cache_print(): Summary of the store and of the reads it saved. */
+extern void dpd_persistent_cache_print(std::string out) {
+    std::shared_ptr<psi::PsiOutStream> printer =
+        (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out, std::ostream::app));
+    printer->Printf("\n\tDPD Persistent File4 Cache:\n");
+    printer->Printf("\t  Budget:        %10.1f MiB\n", persist_budget / 1048576.0);
+    printer->Printf("\t  Resident:      %10.1f MiB in %zu entries\n", persist_used * sizeof(double) / 1048576.0,
+                    persist_store.size());
+    printer->Printf("\t  Reuses:        %10zu (%.1f MiB not re-read)\n", persist_hits,
+                    persist_hit_bytes / 1048576.0);
+}
+
+}  // namespace psi
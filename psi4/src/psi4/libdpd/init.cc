@@ -37,6 +37,8 @@
 #include "psi4/libciomr/libciomr.h"
 #include "dpd.h"
 #include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/liboptions/liboptions.h"
 
 namespace psi {
 
@@ -87,6 +89,22 @@ extern long int dpd_memfree() {
 
 extern void dpd_memset(long int memory) { dpd_main.memory = memory; }
 
+/* dpd_set_compression(): Selects the on-disk layout of file4 irrep blocks written
+** from now on: 0 = fixed layout, 1 = lossless compression, 2 = lossy compression
+** keeping bits of the 52 mantissa bits.  See file4_compress.cc.
+*/
+extern void dpd_set_compression(int type, int bits) {
+    dpd_main.compression = type;
+    dpd_main.compression_bits = bits < 0 ? 0 : (bits > 52 ? 52 : bits);
+}
+
+/* dpd_set_compression(): As above, from DPD_COMPRESSION and DPD_COMPRESSION_BITS. */
+extern void dpd_set_compression(Options &options) {
+    std::string compression = options.get_str("DPD_COMPRESSION");
+    int type = compression == "LOSSLESS" ? 1 : (compression == "LOSSY" ? 2 : 0);
+    dpd_set_compression(type, options.get_int("DPD_COMPRESSION_BITS"));
+}
+
 DPD::DPD()
     : nirreps(0),
       num_subspaces(0),
@@ -168,11 +186,24 @@ int DPD::init(int dpd_num_in, int nirreps_in, long int memory_in, int cachetype_
     dpd_main.memcache = 0;                        /* At first... */
     dpd_main.memlocked = 0;                       /* At first... */
 
+    /* File4 cache statistics cover the whole run, across file4_cache_init() calls */
+    dpd_main.file4_cache_hits = 0;
+    dpd_main.file4_cache_misses = 0;
+    dpd_main.file4_cache_saved_bytes = 0;
+    dpd_main.file4_cache_saved_time = 0.0;
+    dpd_main.file4_cache_load_time = 0.0;
+
     dpd_main.cachetype = cachetype_in;
     dpd_main.cachelist = cachelist_in;
     dpd_main.cachefiles = cachefiles_in;
     dpd_main.file4_cache_priority = priority_in;
 
+    /* File4 blocks kept in memory from one module's DPD to the next */
+    Options &options = Process::environment.options;
+    if (options.exists_in_global("DPD_PERSISTENT_CACHE"))
+        dpd_set_persistent_cache(static_cast<size_t>(options.get_global("DPD_PERSISTENT_CACHE").to_integer()) *
+                                 1048576);
+
     /* Construct binary direct product array */
     dp = (int ***)malloc(nirreps * sizeof(int **));
     for (h = 0; h < nirreps; h++) {
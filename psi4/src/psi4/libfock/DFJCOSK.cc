@@ -145,6 +145,34 @@ Matrix compute_esp_bound(const BasisSet &primary) {
 
 }
 
+std::shared_ptr<DFTGrid> DFJCOSK::build_grid(std::shared_ptr<BasisSet> primary, Options& options, bool final_grid,
+                                             bool atomic_blocks) {
+
+    // TODO: specify bool "DFT_REMOVE_DISTANT_POINTS" in the DFTGrid constructors
+
+    std::map<std::string, std::string> grid_str_options = {
+        {"DFT_PRUNING_SCHEME", options.get_str("COSX_PRUNING_SCHEME")},
+        {"DFT_RADIAL_SCHEME",  "TREUTLER"},
+        {"DFT_NUCLEAR_SCHEME", "TREUTLER"},
+        {"DFT_GRID_NAME",      ""},
+        {"DFT_BLOCK_SCHEME",   atomic_blocks ? "ATOMIC" : options.get_str("COSX_BLOCK_SCHEME")},
+    };
+    std::map<std::string, int> grid_int_options = {
+        {"DFT_SPHERICAL_POINTS", options.get_int(final_grid ? "COSX_SPHERICAL_POINTS_FINAL" : "COSX_SPHERICAL_POINTS_INITIAL")},
+        {"DFT_RADIAL_POINTS",    options.get_int(final_grid ? "COSX_RADIAL_POINTS_FINAL" : "COSX_RADIAL_POINTS_INITIAL")},
+        {"DFT_BLOCK_MIN_POINTS", 100},
+        {"DFT_BLOCK_MAX_POINTS", 256},
+    };
+    std::map<std::string, double> grid_float_options = {
+        {"DFT_BASIS_TOLERANCE",   options.get_double("COSX_BASIS_TOLERANCE")},
+        {"DFT_BS_RADIUS_ALPHA",   1.0},
+        {"DFT_PRUNING_ALPHA",     1.0},
+        {"DFT_BLOCK_MAX_RADIUS",  3.0},
+        {"DFT_WEIGHTS_TOLERANCE", 1e-15},
+    };
+    return std::make_shared<DFTGrid>(primary->molecule(), primary, grid_int_options, grid_str_options, grid_float_options, options);
+}
+
 DFJCOSK::DFJCOSK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, Options& options) : JK(primary), auxiliary_(auxiliary), options_(options) { 
     timer_on("DFJCOSK::Setup");
     common_init(); 
@@ -189,53 +217,11 @@ void DFJCOSK::common_init() {
 
     timer_on("Grid Construction");
 
-    // TODO: specify bool "DFT_REMOVE_DISTANT_POINTS" in the DFTGrid constructors
-
     // Create a small DFTGrid for the initial SCF iterations
-    std::map<std::string, std::string> grid_init_str_options = {
-        {"DFT_PRUNING_SCHEME", options_.get_str("COSX_PRUNING_SCHEME")},
-        {"DFT_RADIAL_SCHEME",  "TREUTLER"},
-        {"DFT_NUCLEAR_SCHEME", "TREUTLER"},
-        {"DFT_GRID_NAME",      ""},
-        {"DFT_BLOCK_SCHEME",   "OCTREE"},
-    };
-    std::map<std::string, int> grid_init_int_options = {
-        {"DFT_SPHERICAL_POINTS", options_.get_int("COSX_SPHERICAL_POINTS_INITIAL")}, 
-        {"DFT_RADIAL_POINTS",    options_.get_int("COSX_RADIAL_POINTS_INITIAL")},
-        {"DFT_BLOCK_MIN_POINTS", 100},
-        {"DFT_BLOCK_MAX_POINTS", 256},
-    };
-    std::map<std::string, double> grid_init_float_options = {
-        {"DFT_BASIS_TOLERANCE",   options_.get_double("COSX_BASIS_TOLERANCE")}, 
-        {"DFT_BS_RADIUS_ALPHA",   1.0},
-        {"DFT_PRUNING_ALPHA",     1.0},
-        {"DFT_BLOCK_MAX_RADIUS",  3.0},
-        {"DFT_WEIGHTS_TOLERANCE", 1e-15},
-    };
-    grid_init_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, grid_init_int_options, grid_init_str_options, grid_init_float_options, options_);
+    grid_init_ = build_grid(primary_, options_, false);
 
     // Create a large DFTGrid for the final SCF iteration
-    std::map<std::string, std::string> grid_final_str_options = {
-        {"DFT_PRUNING_SCHEME", options_.get_str("COSX_PRUNING_SCHEME")},
-        {"DFT_RADIAL_SCHEME",  "TREUTLER"},
-        {"DFT_NUCLEAR_SCHEME", "TREUTLER"},
-        {"DFT_GRID_NAME",      ""},
-        {"DFT_BLOCK_SCHEME",   "OCTREE"},
-    };
-    std::map<std::string, int> grid_final_int_options = {
-        {"DFT_SPHERICAL_POINTS", options_.get_int("COSX_SPHERICAL_POINTS_FINAL")}, 
-        {"DFT_RADIAL_POINTS",    options_.get_int("COSX_RADIAL_POINTS_FINAL")},
-        {"DFT_BLOCK_MIN_POINTS", 100},
-        {"DFT_BLOCK_MAX_POINTS", 256},
-    };
-    std::map<std::string, double> grid_final_float_options = {
-        {"DFT_BASIS_TOLERANCE",   options_.get_double("COSX_BASIS_TOLERANCE")}, 
-        {"DFT_BS_RADIUS_ALPHA",   1.0},
-        {"DFT_PRUNING_ALPHA",     1.0},
-        {"DFT_BLOCK_MAX_RADIUS",  3.0},
-        {"DFT_WEIGHTS_TOLERANCE", 1e-15},
-    };
-    grid_final_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, grid_final_int_options, grid_final_str_options, grid_final_float_options, options_);
+    grid_final_ = build_grid(primary_, options_, true);
 
     timer_off("Grid Construction");
 
@@ -283,8 +269,22 @@ void DFJCOSK::common_init() {
 
 }
 
+size_t DFJCOSK::fixed_memory() const {
+    size_t nbf = primary_->nbf();
+    size_t naux = auxiliary_->nbf();
+    // Coulomb metric, Q_init_ and Q_final_
+    size_t memory = naux * naux + 2 * nbf * nbf;
+    // x, y, z and w of the points of both grids
+    memory += 4L * (grid_init_->npoints() + grid_final_->npoints());
+    return memory;
+}
+
 size_t DFJCOSK::memory_estimate() {
-    return 0;  // Memory is O(N^2), which psi4 counts as effectively 0
+    // enough to cache the collocation of every block of the larger (final) grid,
+    // doubled with overlap fitting for the X Q products
+    size_t collocation = grid_final_->collocation_size();
+    if (options_.get_bool("COSX_OVERLAP_FITTING")) collocation *= 2;
+    return fixed_memory() + collocation;
 }
 
 void DFJCOSK::print_header() const {
@@ -597,6 +597,43 @@ void DFJCOSK::build_J(std::vector<std::shared_ptr<Matrix>>& D, std::vector<std::
 
 }
 
+void DFJCOSK::setup_collocation_cache(std::shared_ptr<DFTGrid> grid, bool overlap_fitted) {
+
+    // the cache is already set up for this grid
+    if (cache_grid_ == grid) return;
+
+    // the grid changes at most once per SCF (grid_init_ -> grid_final_), so the old cache is dropped
+    cache_grid_ = grid;
+    X_cache_.clear();
+    QX_cache_.clear();
+
+    const auto& blocks = grid->blocks();
+    X_cache_.resize(blocks.size());
+    QX_cache_.resize(blocks.size());
+
+    // mark the blocks to be cached with an allocated matrix, in block order until the part of memory_
+    // not held by fixed_memory() is used up; the values themselves are filled in by the first build_K() on this grid
+    size_t fixed = fixed_memory();
+    size_t available = (memory_ > fixed ? memory_ - fixed : 0);
+    size_t cached_size = 0;
+    size_t ncached = 0;
+    for (size_t bi = 0; bi < blocks.size(); bi++) {
+        size_t block_size = (size_t)blocks[bi]->npoints() * blocks[bi]->local_nbf() * (overlap_fitted ? 2 : 1);
+        if (cached_size + block_size > available) break;
+        X_cache_[bi] = std::make_shared<Matrix>("X Block", blocks[bi]->npoints(), blocks[bi]->local_nbf());
+        if (overlap_fitted) {
+            QX_cache_[bi] = std::make_shared<Matrix>("QX Block", blocks[bi]->npoints(), blocks[bi]->local_nbf());
+        }
+        cached_size += block_size;
+        ncached++;
+    }
+
+    if (print_ > 1) {
+        outfile->Printf("  DFJCOSK: Caching collocation for %zu of %zu grid blocks (%.1f MiB)\n\n", ncached,
+                        blocks.size(), (cached_size * 8.0) / (1024.0 * 1024.0));
+    }
+}
+
 void DFJCOSK::build_K(std::vector<std::shared_ptr<Matrix>>& D, std::vector<std::shared_ptr<Matrix>>& K) {
 
     // => Sizing <= //
@@ -616,6 +653,11 @@ void DFJCOSK::build_K(std::vector<std::shared_ptr<Matrix>>& D, std::vector<std::
     auto grid = early_screening_ ? grid_init_ : grid_final_;
     auto Q = early_screening_ ? Q_init_ : Q_final_;
 
+    // the basis function values on the grid do not depend on the density, so they are kept
+    // across SCF iterations for as many blocks as memory_ allows
+    bool first_pass = (cache_grid_ != grid);
+    setup_collocation_cache(grid, overlap_fitted);
+
     // => Initialization <= //
 
     // per-thread ElectrostaticInt object (for computing one-electron "pseudospectral" integrals)
@@ -665,6 +707,25 @@ void DFJCOSK::build_K(std::vector<std::shared_ptr<Matrix>>& D, std::vector<std::
         }
     }
 
+    // lists of all basis functions and shells
+    // These are the same for every grid block, so they are built once outside the grid loop
+    std::vector<int> bf_map_all;
+    std::vector<int> shell_map_all;
+    for (size_t bf = 0; bf < nbf; bf++) bf_map_all.push_back(bf);
+    for (size_t s = 0; s < nshell; s++) shell_map_all.push_back(s);
+    int nbf_block_all = bf_map_all.size();
+    int ns_block_all = shell_map_all.size();
+
+    // map index in shell_map_all to first index in bf_map_all
+    std::vector<int> shell_map_all_to_bf_map_all;
+    if (shell_map_all.size() > 0) {
+        shell_map_all_to_bf_map_all.push_back(0);
+        for(size_t shell_map_ind = 0; (shell_map_ind + 1) < shell_map_all.size(); shell_map_ind++) {
+            size_t MU = shell_map_all[shell_map_ind];
+            shell_map_all_to_bf_map_all.push_back(primary_->shell(MU).nfunction() + shell_map_all_to_bf_map_all.back());
+        }
+    }
+
     // => Integral Computation <= //
     
     // benchmarking statistics
@@ -697,30 +758,8 @@ void DFJCOSK::build_K(std::vector<std::shared_ptr<Matrix>>& D, std::vector<std::
         int nbf_block = bf_map.size();
         int ns_block = shell_map.size();
 
-        // lists of all basis functions and shells
-        //
-        // The use of these "all" lists adds O(N^2) cost to the COSK grid loop (w/ small prefactor)
-        // This cost is negligible relative to the esp integral computation, which is O(N) (w/ a much larger prefactor),
-        // but future COSK work could remove this potential bottleneck
-        std::vector<int> bf_map_all;
-        std::vector<int> shell_map_all;
-        for (size_t bf = 0; bf < nbf; bf++) bf_map_all.push_back(bf);
-        for (size_t s = 0; s < nshell; s++) shell_map_all.push_back(s);
-        int nbf_block_all = bf_map_all.size();
-        int ns_block_all = shell_map_all.size();
-
         // => Bookkeeping <= //
 
-        // map index in shell_map_all to first index in bf_map_all
-        std::vector<int> shell_map_all_to_bf_map_all;
-        if (shell_map_all.size() > 0) {
-            shell_map_all_to_bf_map_all.push_back(0);
-            for(size_t shell_map_ind = 0; (shell_map_ind + 1) < shell_map_all.size(); shell_map_ind++) {
-                size_t MU = shell_map_all[shell_map_ind];
-                shell_map_all_to_bf_map_all.push_back(primary_->shell(MU).nfunction() + shell_map_all_to_bf_map_all.back());
-            }
-        }
-        
         // map index in shell_map to first index in bf_map
         std::vector<int> shell_map_to_bf_map;
         if (shell_map.size() > 0) {
@@ -798,18 +837,26 @@ void DFJCOSK::build_K(std::vector<std::shared_ptr<Matrix>>& D, std::vector<std::
 
         // DOI 10.1016/j.chemphys.2008.10.036, EQ. 4
 
-        // compute basis functions at these grid points
-        bf_computers[rank]->compute_functions(block);
-        auto point_values = bf_computers[rank]->basis_values()["PHI"];
-
-        // resize the buffer of basis function values
-        auto X_block = std::make_shared<Matrix>(npoints_block, nbf_block);  // points x nbf_block
-        auto X_blockp = X_block->pointer();
-        for (size_t p = 0; p < npoints_block; p++) {
-            for (size_t k = 0; k < nbf_block; k++) {
-                X_blockp[p][k] = point_values->get(p, k) * std::sqrt(w[p]);
+        // basis function values at these grid points, from the cache if this block has been seen before
+        bool cached = (X_cache_[bi] != nullptr);
+        SharedMatrix X_block;
+        if (cached && !first_pass) {
+            X_block = X_cache_[bi];
+        } else {
+            // compute basis functions at these grid points
+            bf_computers[rank]->compute_functions(block);
+            auto point_values = bf_computers[rank]->basis_values()["PHI"];
+
+            // resize the buffer of basis function values
+            X_block = (cached ? X_cache_[bi] : std::make_shared<Matrix>(npoints_block, nbf_block));  // points x nbf_block
+            auto X_blockp = X_block->pointer();
+            for (size_t p = 0; p < npoints_block; p++) {
+                for (size_t k = 0; k < nbf_block; k++) {
+                    X_blockp[p][k] = point_values->get(p, k) * std::sqrt(w[p]);
+                }
             }
         }
+        auto X_blockp = X_block->pointer();
 
         // absmax of X matrix over basis functions (row maximum) needed for screening
         Vector X_block_bfmax(npoints_block);
@@ -859,18 +906,25 @@ void DFJCOSK::build_K(std::vector<std::shared_ptr<Matrix>>& D, std::vector<std::
 
         // DOI 10.1063/1.3646921, EQ. 18
 
-        // slice of overlap metric (Q) made up of significant basis functions at this grid point
-        auto Q_block = std::make_shared<Matrix>(nbf_block, nbf_block);
-        for(size_t mu_local = 0; mu_local < nbf_block; mu_local++) {
-            size_t mu = bf_map[mu_local];
-            for(size_t nu_local = 0; nu_local < nbf_block; nu_local++) {
-                size_t nu = bf_map[nu_local];
-                Q_block->set(mu_local, nu_local, Q->get(mu, nu));
+        // only needed for overlap fitting, and also density-independent
+        SharedMatrix Q_block;
+        if (overlap_fitted && cached && !first_pass) {
+            Q_block = QX_cache_[bi];
+        } else if (overlap_fitted) {
+            // slice of overlap metric (Q) made up of significant basis functions at this grid point
+            Q_block = std::make_shared<Matrix>(nbf_block, nbf_block);
+            for(size_t mu_local = 0; mu_local < nbf_block; mu_local++) {
+                size_t mu = bf_map[mu_local];
+                for(size_t nu_local = 0; nu_local < nbf_block; nu_local++) {
+                    size_t nu = bf_map[nu_local];
+                    Q_block->set(mu_local, nu_local, Q->get(mu, nu));
+                }
             }
-        }
 
-        // now Q_block agrees with EQ. 18 (see note about Q_init_ and Q_final_ in common_init())
-        Q_block = linalg::doublet(X_block, Q_block, false, true);
+            // now Q_block agrees with EQ. 18 (see note about Q_init_ and Q_final_ in common_init())
+            Q_block = linalg::doublet(X_block, Q_block, false, true);
+            if (cached) QX_cache_[bi]->copy(Q_block);
+        }
 
         // => G Matrix <= //
 
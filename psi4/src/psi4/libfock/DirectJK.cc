@@ -40,12 +40,15 @@
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/twobody.h"
 #include "psi4/libmints/integral.h"
+#include "psi4/libmints/petitelist.h"
 #include "psi4/lib3index/cholesky.h"
 #include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions.h"
 
 #include <algorithm>
 #include <limits>
+#include <mutex>
+#include <numeric>
 #include <sstream>
 #include <unordered_set>
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -72,8 +75,34 @@ extern brianInt brianRestrictionType;
 
 #endif
 
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
 using namespace psi;
 
+#ifdef ENABLE_MPI
+namespace {
+
+// Every rank runs the same input with the SCF replicated; only the quartet tasks of the J/K build
+// are divided. MPI is brought up (funneled) and shut down with the psi4 module, which also sends
+// the output of all ranks but 0 to /dev/null. Without it, e.g. when libfock is embedded elsewhere,
+// the build runs on one rank. Called from the master thread only.
+void mpi_layout(int& rank, int& nrank) {
+    rank = 0;
+    nrank = 1;
+    int initialized = 0;
+    int finalized = 0;
+    MPI_Initialized(&initialized);
+    MPI_Finalized(&finalized);
+    if (!initialized || finalized) return;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nrank);
+}
+
+}  // namespace
+#endif
+
 namespace psi {
 
 DirectJK::DirectJK(std::shared_ptr<BasisSet> primary, Options& options) : JK(primary), options_(options) { common_init(); }
@@ -91,9 +120,22 @@ void DirectJK::common_init() {
     if (options_.get_int("INCFOCK_FULL_FOCK_EVERY") <= 0) {
         throw PSIEXCEPTION("Invalid input for option INCFOCK_FULL_FOCK_EVERY (<= 0)");
     }
+    incfock_adaptive_ = options_.get_bool("INCFOCK_ADAPTIVE");
+    incfock_reset_tolerance_ = options_.get_double("INCFOCK_RESET_TOLERANCE");
     density_screening_ = options_.get_str("SCREENING") == "DENSITY";
 
+    skeleton_ = options_.get_bool("SKELETON_FOCK");
+    if (skeleton_ && AO2USO_->nirrep() > 1) {
+        auto integral = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+        PetiteList petite(primary_, integral);
+        shell_images_.assign(petite.order(), std::vector<int>(primary_->nshell()));
+        for (int g = 0; g < petite.order(); g++) {
+            for (int P = 0; P < primary_->nshell(); P++) shell_images_[g][P] = petite.shell_map(P, g);
+        }
+    }
+
     set_cutoff(options_.get_double("INTS_TOLERANCE"));
+    early_cutoff_ = options_.get_double("INTS_TOLERANCE_EARLY");
 }
 size_t DirectJK::num_computed_shells() { 
     return num_computed_shells_; 
@@ -112,10 +154,18 @@ void DirectJK::print_header() const {
         outfile->Printf("    wK tasked:         %11s\n", (do_wK_ ? "Yes" : "No"));
         if (do_wK_) outfile->Printf("    Omega:             %11.3E\n", omega_);
         outfile->Printf("    Integrals threads: %11d\n", df_ints_num_threads_);
+#ifdef ENABLE_MPI
+        int rank, nrank;
+        mpi_layout(rank, nrank);
+        outfile->Printf("    MPI ranks:         %11d\n", nrank);
+#endif
         // outfile->Printf( "    Memory [MiB]:      %11ld\n", (memory_ *8L) / (1024L * 1024L));
         outfile->Printf("    Screening Type:    %11s\n", screen_type.c_str());
         outfile->Printf("    Screening Cutoff:  %11.0E\n", cutoff_);
+        if (has_early_cutoff()) outfile->Printf("    Early Cutoff:      %11.0E\n", early_cutoff_);
         outfile->Printf("    Incremental Fock:  %11s\n", incfock_ ? "Yes" : "No");
+        if (incfock_ && incfock_adaptive_) outfile->Printf("    INCFOCK Reset:     %11.0E\n", incfock_reset_tolerance_);
+        outfile->Printf("    Skeleton Fock:     %11s\n", !shell_images_.empty() ? "Yes" : "No");
         outfile->Printf("\n");
     }
 }
@@ -382,13 +432,40 @@ void DirectJK::compute_JK() {
         int reset = options_.get_int("INCFOCK_FULL_FOCK_EVERY");
         double incfock_conv = options_.get_double("INCFOCK_CONVERGENCE");
         double Dnorm = Process::environment.globals["SCF D NORM"];
+        // Is a full build due? Contributions dropped by the density screening of each incremental
+        // build are never recovered, so either rebuild on a fixed cadence or once their accumulated
+        // bound becomes too large
+        bool reset_due = incfock_adaptive_ ? (incfock_error_bound_ >= incfock_reset_tolerance_)
+                                           : (incfock_count_ % reset == reset - 1);
         // Do IFB on this iteration?
-        do_incfock_iter_ = (Dnorm >= incfock_conv) && !initial_iteration_ && (incfock_count_ % reset != reset - 1);
-        
+        do_incfock_iter_ = (Dnorm >= incfock_conv) && !initial_iteration_ && !reset_due;
+        if (!do_incfock_iter_) incfock_error_bound_ = 0.0;
+
         if (!initial_iteration_ && (Dnorm >= incfock_conv)) incfock_count_ += 1;
         timer_off("DirectJK: INCFOCK Preprocessing");
     }
 
+    num_dropped_shells_ = 0;
+    dropped_shells_bound_ = 0.0;
+
+    // A skeleton build is only valid for densities that are totally symmetric in the point group
+    do_skeleton_iter_ = !shell_images_.empty();
+    for (size_t N = 0; N < D_.size() && do_skeleton_iter_; N++) {
+        if (!input_symmetry_cast_map_[N] || D_[N]->symmetry() != 0) do_skeleton_iter_ = false;
+    }
+
+    // While early screening is on, the integral error is kept a fixed factor below the
+    // latest RMS density change, which is all the accuracy the next step can use
+    screening_cutoff_ = cutoff_;
+    bool loosened = false;
+    if (early_screening_ && has_early_cutoff()) {
+        const double early_scale = 1.0E-2;
+        double Dnorm = Process::environment.globals["SCF D NORM"];
+        screening_cutoff_ = initial_iteration_ ? early_cutoff_ : std::min(early_cutoff_, early_scale * Dnorm);
+        screening_cutoff_ = std::max(cutoff_, screening_cutoff_);
+        loosened = screening_cutoff_ > cutoff_;
+    }
+
     auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
     
     std::vector<SharedMatrix>& D_ref = (do_incfock_iter_ ? delta_D_ao_ : D_ao_);
@@ -403,6 +480,7 @@ void DirectJK::compute_JK() {
         std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
         for (int thread = 0; thread < df_ints_num_threads_; thread++) {
             ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega_)));
+            if (loosened) ints[thread]->set_screening_threshold(screening_cutoff_);
             if (density_screening_) ints[thread]->update_density(D_ref);
         }
         if (do_J_) {
@@ -415,6 +493,7 @@ void DirectJK::compute_JK() {
     if (do_J_ || do_K_) {
         std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
         ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+        if (loosened) ints[0]->set_screening_threshold(screening_cutoff_);
         if (density_screening_) ints[0]->update_density(D_ref);
         for (int thread = 1; thread < df_ints_num_threads_; thread++) {
             ints.push_back(std::shared_ptr<TwoBodyAOInt>(ints[0]->clone()));
@@ -428,8 +507,21 @@ void DirectJK::compute_JK() {
         }
     }
 
+    if (do_skeleton_iter_) {
+        timer_on("DirectJK: Skeleton Symmetrization");
+        if (do_J_) symmetrize_skeleton(J_ref);
+        if (do_K_) symmetrize_skeleton(K_ref);
+        if (do_wK_) symmetrize_skeleton(wK_ref);
+        timer_off("DirectJK: Skeleton Symmetrization");
+    }
+
     if (incfock_) {
         timer_on("DirectJK: INCFOCK Postprocessing");
+        if (do_incfock_iter_) incfock_error_bound_ += dropped_shells_bound_;
+        if (debug_) {
+            outfile->Printf("  DirectJK: %zu shell quartets dropped by density screening, bound %11.3E, accumulated %11.3E\n",
+                            num_dropped_shells_, dropped_shells_bound_, incfock_error_bound_);
+        }
         incfock_postiter();
         timer_off("DirectJK: INCFOCK Postprocessing");
     }
@@ -438,6 +530,50 @@ void DirectJK::compute_JK() {
 }
 void DirectJK::postiterations() {}
 
+int DirectJK::skeleton_weight(int P, int Q, int R, int S) const {
+    // Quartets are canonical as in build_JK_matrices: P >= Q, R >= S, and PQ >= RS. The orbit is
+    // represented by its quartet with the largest (PQ, RS), which stands in for all |G| / |stabilizer|
+    // of its images.
+    long int nshell = primary_->nshell();
+    long int PQ = P * nshell + Q;
+    long int RS = R * nshell + S;
+    int nstab = 0;
+    for (const auto& images : shell_images_) {
+        int P1 = images[P], Q1 = images[Q], R1 = images[R], S1 = images[S];
+        long int PQ1 = std::max(P1, Q1) * nshell + std::min(P1, Q1);
+        long int RS1 = std::max(R1, S1) * nshell + std::min(R1, S1);
+        long int hi = std::max(PQ1, RS1);
+        long int lo = std::min(PQ1, RS1);
+        if (hi > PQ || (hi == PQ && lo > RS)) return 0;
+        if (hi == PQ && lo == RS) nstab++;
+    }
+    return shell_images_.size() / nstab;
+}
+
+void DirectJK::symmetrize_skeleton(std::vector<SharedMatrix>& mats) const {
+    // For a totally symmetric density, the full matrix is the group average of the skeleton one,
+    // which is its projection sum_h U_h U_h^T M U_h U_h^T onto the blocks of the orthogonal AO2USO
+    int nao = AO2USO_->rowspi()[0];
+    int maxso = AO2USO_->max_ncol();
+    std::vector<double> temp((size_t)nao * maxso);
+    std::vector<double> so((size_t)maxso * maxso);
+    for (auto& M : mats) {
+        auto full = std::make_shared<Matrix>(M->name(), nao, nao);
+        double** Mp = M->pointer();
+        double** Fp = full->pointer();
+        for (int h = 0; h < AO2USO_->nirrep(); h++) {
+            int nso = AO2USO_->colspi()[h];
+            if (!nso) continue;
+            double** Up = AO2USO_->pointer(h);
+            C_DGEMM('N', 'N', nao, nso, nao, 1.0, Mp[0], nao, Up[0], nso, 0.0, temp.data(), nso);
+            C_DGEMM('T', 'N', nso, nso, nao, 1.0, Up[0], nso, temp.data(), nso, 0.0, so.data(), nso);
+            C_DGEMM('N', 'N', nao, nso, nso, 1.0, Up[0], nso, so.data(), nso, 0.0, temp.data(), nso);
+            C_DGEMM('N', 'T', nao, nao, nso, 1.0, temp.data(), nso, Up[0], nso, 1.0, Fp[0], nao);
+        }
+        M->copy(full);
+    }
+}
+
 void DirectJK::build_JK_matrices(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, const std::vector<SharedMatrix>& D,
                         std::vector<SharedMatrix>& J, std::vector<SharedMatrix>& K) {
 
@@ -462,6 +598,20 @@ void DirectJK::build_JK_matrices(std::vector<std::shared_ptr<TwoBodyAOInt>>& int
     int nshell = primary_->nshell();
     int nthread = df_ints_num_threads_;
 
+    // => Distribution <= //
+
+    // Quartet tasks are dealt out round robin over the ranks in order of decreasing cost, and the
+    // partial J and K are summed over the ranks at the end. Rank 0's densities are the reference,
+    // so round-off differences between the replicated SCFs cannot make the ranks drift apart.
+    int rank = 0;
+    int nrank = 1;
+#ifdef ENABLE_MPI
+    mpi_layout(rank, nrank);
+    if (nrank > 1) {
+        for (const auto& Dmat : D) MPI_Bcast(Dmat->get_pointer(), (int)Dmat->size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+#endif
+
     // => Task Blocking <= //
 
     std::vector<int> task_shells;
@@ -539,6 +689,47 @@ void DirectJK::build_JK_matrices(std::vector<std::shared_ptr<TwoBodyAOInt>>& int
     size_t ntask_pair = task_pairs.size();
     size_t ntask_pair2 = ntask_pair * ntask_pair;
 
+    // => Task Pair Costs <= //
+
+    // The cost of a task pair is estimated from the size and contraction depth of its significant
+    // shell pairs, and the cost of a quartet task is the product of its two task pair costs. Handing
+    // the task pairs out in order of decreasing cost places the heavy, high angular momentum blocks
+    // at the head of the dynamic schedule, so the cheap blocks fill in the tail instead of idle threads.
+
+    std::vector<double> pair_costs(ntask_pair, 0.0);
+    for (size_t task_pair = 0; task_pair < ntask_pair; task_pair++) {
+        int Ptask = task_pairs[task_pair].first;
+        int Qtask = task_pairs[task_pair].second;
+        double cost = 0.0;
+        for (int P2 = task_starts[Ptask]; P2 < task_starts[Ptask + 1]; P2++) {
+            for (int Q2 = task_starts[Qtask]; Q2 < task_starts[Qtask + 1]; Q2++) {
+                if (Q2 > P2) continue;
+                int P = task_shells[P2];
+                int Q = task_shells[Q2];
+                if (!ints[0]->shell_pair_significant(P, Q)) continue;
+                const GaussianShell& Pshell = primary_->shell(P);
+                const GaussianShell& Qshell = primary_->shell(Q);
+                cost += (double)Pshell.nfunction() * Qshell.nfunction() * Pshell.nprimitive() * Qshell.nprimitive();
+            }
+        }
+        pair_costs[task_pair] = cost;
+    }
+
+    std::vector<size_t> task_pair_order(ntask_pair);
+    std::iota(task_pair_order.begin(), task_pair_order.end(), 0L);
+    std::stable_sort(task_pair_order.begin(), task_pair_order.end(),
+                     [&pair_costs](size_t a, size_t b) { return pair_costs[a] > pair_costs[b]; });
+
+    if (debug_) {
+        outfile->Printf("  ==> DirectJK: Task Pair Costs <==\n\n");
+        for (size_t ind = 0; ind < ntask_pair; ind++) {
+            size_t task_pair = task_pair_order[ind];
+            outfile->Printf("  Task Pair: (%3d|%3d), Estimated Cost: %11.3E\n", task_pairs[task_pair].first,
+                            task_pairs[task_pair].second, pair_costs[task_pair]);
+        }
+        outfile->Printf("\n");
+    }
+
     // => Intermediate Buffers <= //
 
     // Intermediate J buffer per thread
@@ -567,17 +758,54 @@ void DirectJK::build_JK_matrices(std::vector<std::shared_ptr<TwoBodyAOInt>>& int
         }
     }
     
+    // => Tile Locks <= //
+
+    // Each thread's task intermediates are striped out into J and K one atom-pair tile at a time,
+    // under a lock for that tile, rather than element by element with atomics. Tiles are hashed
+    // onto a fixed pool of locks, so the lock storage does not grow with the number of atom pairs.
+    size_t ntile_lock = std::min(ntask * ntask, (size_t)64 * nthread);
+    std::vector<std::mutex> tile_locks(ntile_lock);
+
+    // Adds the (Mtask, Ntask) block of an intermediate with leading dimension ldT into the tile of M
+    auto stripe_tile = [&](double** Mp, const double* Tp, int Mtask, int Ntask, int ldT) {
+        std::lock_guard<std::mutex> lock(tile_locks[(Mtask * ntask + Ntask) % ntile_lock]);
+        int M2start = task_starts[Mtask];
+        int N2start = task_starts[Ntask];
+        for (int M2 = M2start; M2 < task_starts[Mtask + 1]; M2++) {
+            for (int N2 = N2start; N2 < task_starts[Ntask + 1]; N2++) {
+                int Mshell = task_shells[M2];
+                int Nshell = task_shells[N2];
+                int Msize = primary_->shell(Mshell).nfunction();
+                int Nsize = primary_->shell(Nshell).nfunction();
+                int Moff = primary_->shell(Mshell).function_index();
+                int Noff = primary_->shell(Nshell).function_index();
+                int Moff2 = task_offsets[M2] - task_offsets[M2start];
+                int Noff2 = task_offsets[N2] - task_offsets[N2start];
+                for (int m = 0; m < Msize; m++) {
+                    const double* T2p = &Tp[(m + Moff2) * ldT + Noff2];
+                    double* M2p = &Mp[m + Moff][Noff];
+                    for (int n = 0; n < Nsize; n++) {
+                        M2p[n] += T2p[n];
+                    }
+                }
+            }
+        }
+    };
+
     // => Benchmarks <= //
 
     num_computed_shells_ = 0L;
     size_t computed_shells = 0L;
+    size_t dropped_shells = 0L;
+    double dropped_bound = 0.0;
 
 // ==> Master Task Loop <== //
 
-#pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+ : computed_shells)
+#pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+ : computed_shells, dropped_shells, dropped_bound)
     for (size_t task = 0L; task < ntask_pair2; task++) {
-        size_t task1 = task / ntask_pair;
-        size_t task2 = task % ntask_pair;
+        if (task % nrank != (size_t)rank) continue;
+        size_t task1 = task_pair_order[task / ntask_pair];
+        size_t task2 = task_pair_order[task % ntask_pair];
 
         int Ptask = task_pairs[task1].first;
         int Qtask = task_pairs[task1].second;
@@ -629,7 +857,19 @@ void DirectJK::build_JK_matrices(std::vector<std::shared_ptr<TwoBodyAOInt>>& int
                         int S = task_shells[S2];
                         if (R2 * nshell + S2 > P2 * nshell + Q2) continue;
                         if (!ints[0]->shell_pair_significant(R, S)) continue;
-                        if (!ints[0]->shell_significant(P, Q, R, S)) continue;
+                        // A skeleton build computes one quartet per orbit, weighted by the orbit size
+                        int weight = 1;
+                        if (do_skeleton_iter_) {
+                            weight = skeleton_weight(P, Q, R, S);
+                            if (!weight) continue;
+                        }
+                        if (!ints[0]->shell_significant(P, Q, R, S)) {
+                            if (density_screening_) {
+                                dropped_shells++;
+                                dropped_bound += ints[0]->shell_density_bound(P, Q, R, S);
+                            }
+                            continue;
+                        }
 
                         // printf("Quartet: %2d %2d %2d %2d\n", P, Q, R, S);
                         // if (thread == 0) timer_on("JK: Ints");
@@ -714,7 +954,7 @@ void DirectJK::build_JK_matrices(std::vector<std::shared_ptr<TwoBodyAOInt>>& int
                                 }
                             }
 
-                            double prefactor = 1.0;
+                            double prefactor = weight;
                             if (P == Q) prefactor *= 0.5;
                             if (R == S) prefactor *= 0.5;
                             if (P == R && Q == S) prefactor *= 0.5;
@@ -772,195 +1012,33 @@ void DirectJK::build_JK_matrices(std::vector<std::shared_ptr<TwoBodyAOInt>>& int
 
         // if (thread == 0) timer_on("JK: Atomic");
         for (size_t ind = 0; ind < D.size(); ind++) {
-            double** JTp;
-            double** KTp;
-            double** Jp;
-            double** Kp;
-
-            if (build_J) {
-                JTp = JT[thread][ind]->pointer();
-                Jp = J[ind]->pointer();
-            }
-            
-            if (build_K) {
-                KTp = KT[thread][ind]->pointer();
-                Kp = K[ind]->pointer();
-            }
-
-            double* J1p;
-            double* J2p;
-            double* K1p;
-            double* K2p;
-            double* K3p;
-            double* K4p;
-            double* K5p;
-            double* K6p;
-            double* K7p;
-            double* K8p;
-
-            if (build_J) {
-                J1p = JTp[0L * max_task];
-                J2p = JTp[1L * max_task];
-            }
-
-            if (build_K) {
-                K1p = KTp[0L * max_task];
-                K2p = KTp[1L * max_task];
-                K3p = KTp[2L * max_task];
-                K4p = KTp[3L * max_task];
-                if (!lr_symmetric_) {
-                    K5p = KTp[4L * max_task];
-                    K6p = KTp[5L * max_task];
-                    K7p = KTp[6L * max_task];
-                    K8p = KTp[7L * max_task];
-                }
-            }
-
             if (build_J) {
+                double** JTp = JT[thread][ind]->pointer();
+                double** Jp = J[ind]->pointer();
 
                 // > J_PQ < //
-
-                for (int P2 = 0; P2 < nPtask; P2++) {
-                    for (int Q2 = 0; Q2 < nQtask; Q2++) {
-                        int P = task_shells[P2start + P2];
-                        int Q = task_shells[Q2start + Q2];
-                        int Psize = primary_->shell(P).nfunction();
-                        int Qsize = primary_->shell(Q).nfunction();
-                        int Poff = primary_->shell(P).function_index();
-                        int Qoff = primary_->shell(Q).function_index();
-                        int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                        int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                        for (int p = 0; p < Psize; p++) {
-                            for (int q = 0; q < Qsize; q++) {
-#pragma omp atomic
-                                Jp[p + Poff][q + Qoff] += J1p[(p + Poff2) * dQsize + q + Qoff2];
-                            }
-                        }
-                    }
-                }
+                stripe_tile(Jp, JTp[0L * max_task], Ptask, Qtask, dQsize);
 
                 // > J_RS < //
-
-                for (int R2 = 0; R2 < nRtask; R2++) {
-                    for (int S2 = 0; S2 < nStask; S2++) {
-                        int R = task_shells[R2start + R2];
-                        int S = task_shells[S2start + S2];
-                        int Rsize = primary_->shell(R).nfunction();
-                        int Ssize = primary_->shell(S).nfunction();
-                        int Roff = primary_->shell(R).function_index();
-                        int Soff = primary_->shell(S).function_index();
-                        int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                        int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                        for (int r = 0; r < Rsize; r++) {
-                            for (int s = 0; s < Ssize; s++) {
-#pragma omp atomic
-                                Jp[r + Roff][s + Soff] += J2p[(r + Roff2) * dSsize + s + Soff2];
-                            }
-                        }
-                    }
-                }
+                stripe_tile(Jp, JTp[1L * max_task], Rtask, Stask, dSsize);
             }
 
             if (build_K) {
+                double** KTp = KT[thread][ind]->pointer();
+                double** Kp = K[ind]->pointer();
 
-                // > K_PR < //
-
-                for (int P2 = 0; P2 < nPtask; P2++) {
-                    for (int R2 = 0; R2 < nRtask; R2++) {
-                        int P = task_shells[P2start + P2];
-                        int R = task_shells[R2start + R2];
-                        int Psize = primary_->shell(P).nfunction();
-                        int Rsize = primary_->shell(R).nfunction();
-                        int Poff = primary_->shell(P).function_index();
-                        int Roff = primary_->shell(R).function_index();
-                        int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                        int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                        for (int p = 0; p < Psize; p++) {
-                            for (int r = 0; r < Rsize; r++) {
-#pragma omp atomic
-                                Kp[p + Poff][r + Roff] += K1p[(p + Poff2) * dRsize + r + Roff2];
-                                if (!lr_symmetric_) {
-#pragma omp atomic
-                                    Kp[r + Roff][p + Poff] += K5p[(r + Roff2) * dPsize + p + Poff2];
-                                }
-                            }
-                        }
-                    }
-                }
-
-                // > K_PS < //
-
-                for (int P2 = 0; P2 < nPtask; P2++) {
-                    for (int S2 = 0; S2 < nStask; S2++) {
-                        int P = task_shells[P2start + P2];
-                        int S = task_shells[S2start + S2];
-                        int Psize = primary_->shell(P).nfunction();
-                        int Ssize = primary_->shell(S).nfunction();
-                        int Poff = primary_->shell(P).function_index();
-                        int Soff = primary_->shell(S).function_index();
-                        int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                        int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                        for (int p = 0; p < Psize; p++) {
-                            for (int s = 0; s < Ssize; s++) {
-#pragma omp atomic
-                                Kp[p + Poff][s + Soff] += K2p[(p + Poff2) * dSsize + s + Soff2];
-                                if (!lr_symmetric_) {
-#pragma omp atomic
-                                    Kp[s + Soff][p + Poff] += K6p[(s + Soff2) * dPsize + p + Poff2];
-                                }
-                            }
-                        }
-                    }
-                }
-
-                // > K_QR < //
-
-                for (int Q2 = 0; Q2 < nQtask; Q2++) {
-                    for (int R2 = 0; R2 < nRtask; R2++) {
-                        int Q = task_shells[Q2start + Q2];
-                        int R = task_shells[R2start + R2];
-                        int Qsize = primary_->shell(Q).nfunction();
-                        int Rsize = primary_->shell(R).nfunction();
-                        int Qoff = primary_->shell(Q).function_index();
-                        int Roff = primary_->shell(R).function_index();
-                        int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                        int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                        for (int q = 0; q < Qsize; q++) {
-                            for (int r = 0; r < Rsize; r++) {
-#pragma omp atomic
-                                Kp[q + Qoff][r + Roff] += K3p[(q + Qoff2) * dRsize + r + Roff2];
-                                if (!lr_symmetric_) {
-#pragma omp atomic
-                                    Kp[r + Roff][q + Qoff] += K7p[(r + Roff2) * dQsize + q + Qoff2];
-                                }
-                            }
-                        }
-                    }
-                }
-
-                // > K_QS < //
+                // > K_PR, K_PS, K_QR, K_QS < //
+                stripe_tile(Kp, KTp[0L * max_task], Ptask, Rtask, dRsize);
+                stripe_tile(Kp, KTp[1L * max_task], Ptask, Stask, dSsize);
+                stripe_tile(Kp, KTp[2L * max_task], Qtask, Rtask, dRsize);
+                stripe_tile(Kp, KTp[3L * max_task], Qtask, Stask, dSsize);
 
-                for (int Q2 = 0; Q2 < nQtask; Q2++) {
-                    for (int S2 = 0; S2 < nStask; S2++) {
-                        int Q = task_shells[Q2start + Q2];
-                        int S = task_shells[S2start + S2];
-                        int Qsize = primary_->shell(Q).nfunction();
-                        int Ssize = primary_->shell(S).nfunction();
-                        int Qoff = primary_->shell(Q).function_index();
-                        int Soff = primary_->shell(S).function_index();
-                        int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                        int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                        for (int q = 0; q < Qsize; q++) {
-                            for (int s = 0; s < Ssize; s++) {
-#pragma omp atomic
-                                Kp[q + Qoff][s + Soff] += K4p[(q + Qoff2) * dSsize + s + Soff2];
-                                if (!lr_symmetric_) {
-#pragma omp atomic
-                                    Kp[s + Soff][q + Qoff] += K8p[(s + Soff2) * dQsize + q + Qoff2];
-                                }
-                            }
-                        }
-                    }
+                // > K_RP, K_SP, K_RQ, K_SQ < //
+                if (!lr_symmetric_) {
+                    stripe_tile(Kp, KTp[4L * max_task], Rtask, Ptask, dPsize);
+                    stripe_tile(Kp, KTp[5L * max_task], Stask, Ptask, dPsize);
+                    stripe_tile(Kp, KTp[6L * max_task], Rtask, Qtask, dQsize);
+                    stripe_tile(Kp, KTp[7L * max_task], Stask, Qtask, dQsize);
                 }
             }
 
@@ -969,6 +1047,20 @@ void DirectJK::build_JK_matrices(std::vector<std::shared_ptr<TwoBodyAOInt>>& int
 
     }  // End master task list
 
+#ifdef ENABLE_MPI
+    if (nrank > 1) {
+        for (auto& Jmat : J)
+            MPI_Allreduce(MPI_IN_PLACE, Jmat->get_pointer(), (int)Jmat->size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        for (auto& Kmat : K)
+            MPI_Allreduce(MPI_IN_PLACE, Kmat->get_pointer(), (int)Kmat->size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        unsigned long counts[2] = {computed_shells, dropped_shells};
+        MPI_Allreduce(MPI_IN_PLACE, counts, 2, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+        computed_shells = counts[0];
+        dropped_shells = counts[1];
+        MPI_Allreduce(MPI_IN_PLACE, &dropped_bound, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    }
+#endif
+
     for (auto& Jmat : J) {
         Jmat->scale(2.0);
         Jmat->hermitivitize();
@@ -982,6 +1074,8 @@ void DirectJK::build_JK_matrices(std::vector<std::shared_ptr<TwoBodyAOInt>>& int
     }
 
     num_computed_shells_ = computed_shells;
+    num_dropped_shells_ += dropped_shells;
+    dropped_shells_bound_ += dropped_bound;
     if (get_bench()) {
         computed_shells_per_iter_.push_back(num_computed_shells());
     }
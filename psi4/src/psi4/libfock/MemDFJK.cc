@@ -64,6 +64,7 @@ void MemDFJK::common_init() { dfh_ = std::make_shared<DFHelper>(primary_, auxili
 size_t MemDFJK::memory_estimate() {
     dfh_->set_nthreads(omp_nthread_);
     dfh_->set_schwarz_cutoff(cutoff_);
+    dfh_->set_pair_fitting(pair_fitting_);
     return dfh_->get_core_size();
 }
 
@@ -87,6 +88,9 @@ void MemDFJK::preiterations() {
     }
     dfh_->set_omega_alpha(omega_alpha_);
     dfh_->set_omega_beta(omega_beta_);
+    dfh_->set_K_sparse_tolerance(K_sparse_tol_);
+    dfh_->set_shared_AO(shared_AO_);
+    dfh_->set_pair_fitting(pair_fitting_);
 
     // we need to prepare the AOs here, and that's it.
     // DFHelper takes care of all the housekeeping
@@ -98,6 +102,8 @@ void MemDFJK::compute_JK() {
     // zero out J, K, and wK matrices
     zero();
 
+    // the thread count may have been changed since preiterations, e.g. to overlap with an XC build
+    dfh_->set_nthreads(omp_nthread_);
     dfh_->build_JK(C_left_ao_, C_right_ao_, D_ao_, J_ao_, K_ao_, wK_ao_, max_nocc(), do_J_, do_K_, do_wK_,
                    lr_symmetric_);
     if (lr_symmetric_) {
@@ -121,8 +127,11 @@ void MemDFJK::print_header() const {
         outfile->Printf("    OpenMP threads:     %11d\n", omp_nthread_);
         outfile->Printf("    Memory [MiB]:       %11ld\n", (memory_ * 8L) / (1024L * 1024L));
         outfile->Printf("    Algorithm:          %11s\n", (dfh_->get_AO_core() ? "Core" : "Disk"));
+        if (shared_AO_) outfile->Printf("    Shared AOs:         %11s\n", (dfh_->get_shared_AO_attached() ? "Attached" : "Yes"));
         outfile->Printf("    Schwarz Cutoff:     %11.0E\n", cutoff_);
         outfile->Printf("    Mask sparsity (%%):  %11.4f\n", 100. * dfh_->ao_sparsity());
+        if (K_sparse_tol_ > 0.0) outfile->Printf("    Sparse K Cutoff:    %11.0E\n", K_sparse_tol_);
+        if (pair_fitting_) outfile->Printf("    Fitting:            %11s\n", "Pair-Atomic");
         outfile->Printf("    Fitting Condition:  %11.0E\n\n", condition_);
 
         outfile->Printf("   => Auxiliary Basis Set <=\n\n");
@@ -652,14 +652,10 @@ void PKWrkrReord::write(std::vector<size_t> min_ind, std::vector<size_t> max_ind
     // Update the buffer being written into
     ++buf_;
     if (buf_ >= nbuf()) buf_ = 0;
-    // Make sure the buffer has been written to disk and we can erase it
-    for (int i = 0; i < jobID_J_[buf_].size(); ++i) {
-        AIO()->wait_for_job(jobID_J_[buf_][i]);
-    }
+    // Make sure the buffer has been written to disk and we can erase it.
+    // AIO runs the jobs in order, so the last K job completing covers all of them.
+    if (!jobID_K_[buf_].empty()) AIO()->wait_for_job(jobID_K_[buf_].back());
     jobID_J_[buf_].clear();
-    for (int i = 0; i < jobID_K_[buf_].size(); ++i) {
-        AIO()->wait_for_job(jobID_K_[buf_][i]);
-    }
     jobID_K_[buf_].clear();
     // We can delete the labels for these buffers
     for (int i = 0; i < labels_J_[buf_].size(); ++i) {
@@ -723,9 +719,7 @@ void PKWrkrReord::write_wK(std::vector<size_t> min_ind, std::vector<size_t> max_
     ++buf_;
     if (buf_ >= nbuf()) buf_ = 0;
     // Make sure the next buffer has been written to disk and we can erase it
-    for (int i = 0; i < jobID_wK_[buf_].size(); ++i) {
-        AIO()->wait_for_job(jobID_wK_[buf_][i]);
-    }
+    if (!jobID_wK_[buf_].empty()) AIO()->wait_for_job(jobID_wK_[buf_].back());
     jobID_wK_[buf_].clear();
     // We can delete the labels for these buffers
     for (int i = 0; i < labels_wK_[buf_].size(); ++i) {
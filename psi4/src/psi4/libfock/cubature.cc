@@ -40,6 +40,8 @@
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/matrix.h"
 
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -47,6 +49,8 @@
 #include <limits>
 #include <cctype>
 #include <cassert>
+#include <mutex>
+#include <tuple>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -2951,9 +2955,20 @@ double NuclearWeightMgr::computeNuclearWeight(MassPoint mp, int A, double stratm
     if (scheme_ == STRATMANN && distToAtom(mp, A) <= stratmannCutoff) return 1;
 
     int natom = molecule_->natom();
-    // Find the distance from point mp to each atom in the molecule.
+    // Find the distance from point mp to each atom in the molecule, and the nearest atom.
     std::vector<double> dist(natom);
-    for (int l = 0; l < natom; l++) dist[l] = distToAtom(mp, l);
+    int nearest = 0;
+    for (int l = 0; l < natom; l++) {
+        dist[l] = distToAtom(mp, l);
+        if (dist[l] < dist[nearest]) nearest = l;
+    }
+
+    // Under the Stratmann scheme (where nu == mu) the cell function of atom i vanishes as soon as
+    // mu(i, nearest) > 0.64, so only the atoms near the point have to be visited.
+    auto screened = [&](int i) {
+        return (scheme_ == STRATMANN && i != nearest && (dist[i] - dist[nearest]) * inv_dist_[i][nearest] > 0.64);
+    };
+    if (screened(A)) return 0;
 
     double (*stepFunction)(double) = (scheme_ == STRATMANN) ? StratmannStepFunction : BeckeStepFunction;
     double (*muFunction)(double, double, double) = (scheme_ == SBECKE) ? SmoothBeckeMu : BeckeMu;
@@ -2961,9 +2976,12 @@ double NuclearWeightMgr::computeNuclearWeight(MassPoint mp, int A, double stratm
     double numerator = NAN;
     double denominator = 0;
     for (int i = 0; i < natom; i++) {
+        if (screened(i)) continue;
         double prod = 1;
-        for (int j = 0; j < natom; j++) {
-            if (i == j) continue;
+        // Start with the nearest atom, which is the most likely to zero the product
+        for (int jj = -1; jj < natom; jj++) {
+            int j = (jj < 0 ? nearest : jj);
+            if (i == j || (jj >= 0 && j == nearest)) continue;
             // if ( dist[j] >= (dist[i]+RCut) ) continue; // sugested cutoff
             double mu = muFunction(dist[i], dist[j], inv_dist_[i][j]);
             double nu = mu + amatrix_[i][j] * (1 - mu * mu);  // Adjust for ratios between atomic radii
@@ -3718,6 +3736,64 @@ int RadialPruneMgr::ShellPruning(int ri, int Z, int radial_pts) {
     return LebedevGridMgr::findNPointsByOrder_roundUp(pruned_order);
 }
 
+// The radial grid and pruned spherical point counts of one element, which only depend on Z and the grid options
+struct AtomGridTemplate {
+    double alpha;
+    std::vector<double> r;
+    std::vector<double> wr;
+    std::vector<int> nangpts;
+};
+
+// Keeps the atomic grid templates between grid builds, e.g. along a geometry optimization
+class AtomGridTemplateMgr {
+    typedef std::tuple<int, int, int, short, short, double, double, std::string, std::string> Key;
+    static std::map<Key, std::shared_ptr<const AtomGridTemplate>> templates_;
+    static std::mutex mutex_;
+
+   public:
+    static std::shared_ptr<const AtomGridTemplate> get(MolecularGrid::MolecularGridOptions const &opt, int Z,
+                                                       RadialPruneMgr &prune);
+};
+
+std::map<AtomGridTemplateMgr::Key, std::shared_ptr<const AtomGridTemplate>> AtomGridTemplateMgr::templates_;
+std::mutex AtomGridTemplateMgr::mutex_;
+
+std::shared_ptr<const AtomGridTemplate> AtomGridTemplateMgr::get(MolecularGrid::MolecularGridOptions const &opt,
+                                                                 int Z, RadialPruneMgr &prune) {
+    Key key(Z, opt.nradpts, opt.nangpts, opt.radscheme, opt.prunefunction, opt.bs_radius_alpha, opt.pruning_alpha,
+            opt.prunescheme, opt.prunetype);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = templates_.find(key);
+    if (it != templates_.end()) return it->second;
+
+    auto tmpl = std::make_shared<AtomGridTemplate>();
+    tmpl->alpha = GetBSRadius(Z) * opt.bs_radius_alpha;
+    tmpl->r.resize(opt.nradpts);
+    tmpl->wr.resize(opt.nradpts);
+    RadialGridMgr::makeRadialGrid(opt.nradpts, RadialGridMgr::MuraKnowlesHack(opt.radscheme, Z), tmpl->r.data(),
+                                  tmpl->wr.data(), tmpl->alpha);
+
+    tmpl->nangpts.resize(opt.nradpts);
+    for (int i = 0; i < opt.nradpts; i++) {
+        int numAngPts = 0;
+        if (opt.prunetype == "REGION") {
+            if (opt.prunescheme == "TREUTLER") {
+                numAngPts = prune.TreutlerShellPruning(i, Z, opt.nradpts);
+            } else if (opt.prunescheme == "ROBUST") {
+                numAngPts = prune.ShellPruning(i, Z, opt.nradpts);
+            }
+        } else if (opt.prunetype == "FUNCTION" || opt.prunescheme == "NONE") {
+            numAngPts = prune.GetPrunedNumAngPts(tmpl->r[i] / tmpl->alpha);
+        }
+        assert(numAngPts > 0);
+        tmpl->nangpts[i] = numAngPts;
+    }
+
+    templates_[key] = tmpl;
+    return tmpl;
+}
+
 void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
     options_ = opt;  // Save a copy
     atomic_grids_.clear();
@@ -3744,12 +3820,16 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
 #endif
 
     // Check grid per-atom first so throws happen outside threaded block
+    // This also fetches the (cached) radial grid and pruning of each atom
+    std::vector<std::shared_ptr<const AtomGridTemplate>> templates(molecule_->natom());
     for (int A = 0; A < molecule_->natom(); A++) {
         int Z = molecule_->true_atomic_number(A);
 
         if (opt.namedGrid != -1) {  // Using a named grid
             assert(opt.namedGrid == 0 || opt.namedGrid == 1);
             int npts = (opt.namedGrid == 0) ? StandardGridMgr::GetSG0size(Z) : StandardGridMgr::GetSG1size(Z);
+        } else {
+            templates[A] = AtomGridTemplateMgr::get(opt, Z, prune);
         }
     }
 
@@ -3767,29 +3847,19 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
 #endif
 
         if (opt.namedGrid == -1) {  // Not using a named grid
-            std::vector<double> r(opt.nradpts), wr(opt.nradpts);
-            double alpha = GetBSRadius(Z) * opt.bs_radius_alpha;
-            RadialGridMgr::makeRadialGrid(opt.nradpts, RadialGridMgr::MuraKnowlesHack(opt.radscheme, Z), r.data(),
-                                          wr.data(), alpha);
+            const std::vector<double> &r = templates[A]->r;
+            const std::vector<double> &wr = templates[A]->wr;
+            double alpha = templates[A]->alpha;
 
             // RMP: Want this stuff too
-            radial_grids_[A] = RadialGrid::build("Unknown", opt.nradpts, r.data(), wr.data(), alpha, Z);
+            radial_grids_[A] = RadialGrid::build("Unknown", opt.nradpts, const_cast<double *>(r.data()),
+                                                 const_cast<double *>(wr.data()), alpha, Z);
             std::vector<std::shared_ptr<SphericalGrid>> spheres;
             spherical_grids_[A] = spheres;
 
             int currentBlockIndex = -1;
             for (int i = 0; i < opt.nradpts; i++) {
-                int numAngPts = 0;
-                if (opt.prunetype == "REGION") {
-                    if (opt.prunescheme == "TREUTLER") {
-                        numAngPts = prune.TreutlerShellPruning(i, Z, opt.nradpts);
-                    } else if (opt.prunescheme == "ROBUST") {
-                        numAngPts = prune.ShellPruning(i, Z, opt.nradpts);
-                    }
-                } else if (opt.prunetype == "FUNCTION" || opt.prunescheme == "NONE") {
-                    numAngPts = prune.GetPrunedNumAngPts(r[i] / alpha);
-                }
-                assert(numAngPts > 0);
+                int numAngPts = templates[A]->nangpts[i];
                 const MassPoint *anggrid = LebedevGridMgr::findGridByNPoints(numAngPts);
 
 #ifdef USING_BrianQC
@@ -4449,6 +4519,8 @@ void MolecularGrid::block(int max_points, int min_points, double max_radius) {
         blocker = std::make_shared<NaiveGridBlocker>(npoints_, x_, y_, z_, w_, max_points, min_points, max_radius, extents_);
     } else if (options_.blockscheme == "OCTREE") {
         blocker = std::make_shared<OctreeGridBlocker>(npoints_, x_, y_, z_, w_, max_points, min_points, max_radius, extents_);
+    } else if (options_.blockscheme == "HILBERT") {
+        blocker = std::make_shared<HilbertGridBlocker>(npoints_, x_, y_, z_, w_, max_points, min_points, max_radius, extents_);
     } else if (options_.blockscheme == "ATOMIC") {
         blocker = std::make_shared<AtomicGridBlocker>(npoints_, x_, y_, z_, w_, max_points, min_points, max_radius, extents_, molecule_, atomic_grids_);
     }
@@ -4860,6 +4932,8 @@ void OctreeGridBlocker::block() {
         if (completed) break;
     }
 
+    order_leaves(completed_tree);
+
     // Move stuff over
     x_ = new double[npoints_];
     y_ = new double[npoints_];
@@ -4952,6 +5026,88 @@ void OctreeGridBlocker::block() {
     }
 }
 
+HilbertGridBlocker::HilbertGridBlocker(const int npoints_ref, double const *x_ref, double const *y_ref,
+                                       double const *z_ref, double const *w_ref, const int max_points,
+                                       const int min_points, const double max_radius,
+                                       std::shared_ptr<BasisExtents> extents)
+    : OctreeGridBlocker(npoints_ref, x_ref, y_ref, z_ref, w_ref, max_points, min_points, max_radius, extents) {}
+HilbertGridBlocker::~HilbertGridBlocker() {}
+void HilbertGridBlocker::order_leaves(std::vector<std::vector<int>> &leaves) {
+    // Bits per dimension of the Hilbert curve, 3 * 21 bits fit into the 64 bit key
+    const int nbits = 21;
+    const uint64_t nmax = (uint64_t(1) << nbits) - 1;
+
+    // Leaf centroids and their bounding box
+    std::vector<std::array<double, 3>> centers(leaves.size(), {0.0, 0.0, 0.0});
+    double lo[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                    std::numeric_limits<double>::max()};
+    double hi[3] = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(),
+                    std::numeric_limits<double>::lowest()};
+    for (size_t A = 0; A < leaves.size(); A++) {
+        if (!leaves[A].size()) continue;
+        for (int Q : leaves[A]) {
+            centers[A][0] += x_ref_[Q];
+            centers[A][1] += y_ref_[Q];
+            centers[A][2] += z_ref_[Q];
+        }
+        for (int k = 0; k < 3; k++) {
+            centers[A][k] /= leaves[A].size();
+            lo[k] = std::min(lo[k], centers[A][k]);
+            hi[k] = std::max(hi[k], centers[A][k]);
+        }
+    }
+
+    // Hilbert index of each centroid (Skilling's transposed-axes algorithm)
+    std::vector<std::pair<uint64_t, size_t>> keys(leaves.size());
+    for (size_t A = 0; A < leaves.size(); A++) {
+        uint64_t X[3] = {0, 0, 0};
+        if (leaves[A].size()) {
+            for (int k = 0; k < 3; k++) {
+                double span = hi[k] - lo[k];
+                X[k] = (span > 0.0 ? (uint64_t)((centers[A][k] - lo[k]) / span * nmax) : 0);
+            }
+        }
+
+        // Inverse undo
+        for (uint64_t M = uint64_t(1) << (nbits - 1); M > 1; M >>= 1) {
+            uint64_t P = M - 1;
+            for (int k = 0; k < 3; k++) {
+                if (X[k] & M) {
+                    X[0] ^= P;
+                } else {
+                    uint64_t t = (X[0] ^ X[k]) & P;
+                    X[0] ^= t;
+                    X[k] ^= t;
+                }
+            }
+        }
+        // Gray encode
+        X[1] ^= X[0];
+        X[2] ^= X[1];
+        uint64_t t = 0;
+        for (uint64_t M = uint64_t(1) << (nbits - 1); M > 1; M >>= 1) {
+            if (X[2] & M) t ^= M - 1;
+        }
+        for (int k = 0; k < 3; k++) X[k] ^= t;
+
+        // Interleave the transposed bits into a single key
+        uint64_t key = 0;
+        for (int b = nbits - 1; b >= 0; b--) {
+            for (int k = 0; k < 3; k++) {
+                key = (key << 1) | ((X[k] >> b) & 1);
+            }
+        }
+        keys[A] = std::make_pair(key, A);
+    }
+    std::stable_sort(keys.begin(), keys.end());
+
+    std::vector<std::vector<int>> ordered(leaves.size());
+    for (size_t A = 0; A < leaves.size(); A++) {
+        ordered[A] = std::move(leaves[keys[A].second]);
+    }
+    leaves = std::move(ordered);
+}
+
 RadialGrid::RadialGrid() : npoints_(0) {}
 RadialGrid::~RadialGrid() {
     if (npoints_) {
@@ -41,6 +41,7 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 #ifdef _OPENMP
@@ -170,8 +171,23 @@ inline void rks_integrator(std::shared_ptr<BlockOPoints> block, std::shared_ptr<
     }
 
     // Collect V terms
-    C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tp[0], max_functions, 0.0, V2p[0],
-            max_functions);
+    if (pworker->mixed_precision() && ansatz < 2) {
+        // Single-precision contraction with the PHI copy made by compute_points
+        std::vector<float>& temp = pworker->float_temp();
+        float* Tf = temp.data();
+        float* Vf = Tf + (size_t)npoints * nlocal;
+        for (int P = 0; P < npoints; P++) {
+            std::copy(Tp[P], Tp[P] + nlocal, Tf + (size_t)P * nlocal);
+        }
+        C_SGEMM('T', 'N', nlocal, nlocal, npoints, 1.0f, pworker->phi_float().data(), nlocal, Tf, nlocal, 0.0f, Vf,
+                nlocal);
+        for (int m = 0; m < nlocal; m++) {
+            std::copy(Vf + (size_t)m * nlocal, Vf + (size_t)(m + 1) * nlocal, V2p[m]);
+        }
+    } else {
+        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tp[0], max_functions, 0.0, V2p[0],
+                max_functions);
+    }
 
     for (int m = 0; m < nlocal; m++) {
         for (int n = 0; n <= m; n++) {
@@ -141,6 +141,26 @@ class OctreeGridBlocker : public GridBlocker {
     ~OctreeGridBlocker() override;
 
     void block() override;
+
+   protected:
+    /// Hook to reorder the finished leaves (lists of reference point indices) before the blocks are built
+    virtual void order_leaves(std::vector<std::vector<int>>& leaves) {}
+};
+
+/**
+ * Octree-based blocking with the leaves ordered along a Hilbert curve
+ * through their centroids, so that neighboring blocks share significant
+ * basis functions and the local density gathers stay in cache
+ */
+class HilbertGridBlocker : public OctreeGridBlocker {
+   protected:
+    void order_leaves(std::vector<std::vector<int>>& leaves) override;
+
+   public:
+    HilbertGridBlocker(const int npoints_ref, double const* x_ref, double const* y_ref, double const* z_ref,
+                       double const* w_ref, const int max_points, const int min_points, const double max_radius,
+                       std::shared_ptr<BasisExtents> extents);
+    ~HilbertGridBlocker() override;
 };
 }  // namespace psi
 #endif
@@ -116,6 +116,10 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         jk->set_wcombine(false);
         _set_dfjk_options<MemDFJK>(jk, options);
         if (options["WCOMBINE"].has_changed()) { jk->set_wcombine(options.get_bool("WCOMBINE")); }
+        if (options["MEMDF_SPARSE_K_TOLERANCE"].has_changed())
+            jk->set_K_sparse_tolerance(options.get_double("MEMDF_SPARSE_K_TOLERANCE"));
+        if (options["MEMDF_SHARED_AO"].has_changed()) jk->set_shared_AO(options.get_bool("MEMDF_SHARED_AO"));
+        if (options["MEMDF_PAIR_FITTING"].has_changed()) jk->set_pair_fitting(options.get_bool("MEMDF_PAIR_FITTING"));
 
         return std::shared_ptr<JK>(jk);
     } else if (jk_type == "PK") {
@@ -408,20 +412,46 @@ void JK::USO2AO() {
         }
     }
 
-    // Always reallocate C matrices, the occupations are tricky
+    // The C matrices are rebuilt every call, the occupations are tricky, but the AO copies of
+    // the previous call are recycled when their shape still fits (each one at most once).
+    // Consecutive densities that share a C object share the AO copy, so the algorithms
+    // can recognize the shared factor (e.g. C_occ in CPHF products) and transform it once
+    std::vector<SharedMatrix> spare(C_left_ao_);
+    spare.insert(spare.end(), C_right_ao_.begin(), C_right_ao_.end());
+    auto C_ao = [&](const std::string& name, int ncol) {
+        int nao = AO2USO_->rowspi()[0];
+        for (auto& M : spare) {
+            if (M && M->rowspi()[0] == nao && M->colspi()[0] == ncol) {
+                SharedMatrix ret = M;
+                for (auto& alias : spare) {
+                    if (alias == ret) alias.reset();
+                }
+                ret->set_name(name);
+                return ret;
+            }
+        }
+        return std::make_shared<Matrix>(name, nao, ncol);
+    };
+
     C_left_ao_.clear();
     C_right_ao_.clear();
     for (size_t N = 0; N < D_.size(); ++N) {
+        if (N > 0 && C_left_[N].get() == C_left_[N - 1].get()) {
+            C_left_ao_.push_back(C_left_ao_.back());
+            continue;
+        }
         std::stringstream s;
         s << "C Left " << N << " (AO)";
-        int ncol = C_left_[N]->colspi().sum();
-        C_left_ao_.push_back(std::make_shared<Matrix>(s.str(), AO2USO_->rowspi()[0], ncol));
+        C_left_ao_.push_back(C_ao(s.str(), C_left_[N]->colspi().sum()));
     }
     for (size_t N = 0; (N < D_.size()) && (!lr_symmetric_); ++N) {
+        if (N > 0 && C_right_[N].get() == C_right_[N - 1].get()) {
+            C_right_ao_.push_back(C_right_ao_.back());
+            continue;
+        }
         std::stringstream s;
         s << "C Right " << N << " (AO)";
-        int ncol = C_right_[N]->colspi().sum();
-        C_right_ao_.push_back(std::make_shared<Matrix>(s.str(), AO2USO_->rowspi()[0], ncol));
+        C_right_ao_.push_back(C_ao(s.str(), C_right_[N]->colspi().sum()));
     }
 
     // Alias pointers if lr_symmetric_
@@ -462,6 +492,9 @@ void JK::USO2AO() {
 
     // Transform C_left. Assumed totally symmetric.
     for (size_t N = 0; N < D_.size(); ++N) {
+        // Shared with the previous density, already transformed
+        if (N > 0 && C_left_ao_[N].get() == C_left_ao_[N - 1].get()) continue;
+
         // Input is already C1
         if (!input_symmetry_cast_map_[N]) {
             C_left_ao_[N]->copy(C_left_[N]);
@@ -485,6 +518,9 @@ void JK::USO2AO() {
 
     // Transform C_right. Not assumed totally symmetric.
     for (size_t N = 0; (N < D_.size()) && (!lr_symmetric_); ++N) {
+        // Shared with the previous density, already transformed
+        if (N > 0 && C_right_ao_[N].get() == C_right_ao_[N - 1].get()) continue;
+
         // Input is already C1
         if (!input_symmetry_cast_map_[N]) {
             C_right_ao_[N]->copy(C_right_[N]);
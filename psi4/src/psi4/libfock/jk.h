@@ -748,6 +748,31 @@ class PSI_API DirectJK : public JK {
     /// The number of times INCFOCK has been performed (includes resets)
     int incfock_count_;
     bool do_incfock_iter_;
+    /// Reset the incremental build from an accumulated error bound, instead of every INCFOCK_FULL_FOCK_EVERY builds?
+    bool incfock_adaptive_;
+    /// A full Fock build is forced once incfock_error_bound_ reaches this value
+    double incfock_reset_tolerance_;
+    /// Accumulated bound on the contributions dropped by incremental builds since the last full build
+    double incfock_error_bound_ = 0.0;
+
+    /// Number of shell quartets passing the Schwarz sieve but dropped by density screening in the last compute_JK
+    size_t num_dropped_shells_ = 0;
+    /// Sum of the density-weighted bounds of those dropped shell quartets
+    double dropped_shells_bound_ = 0.0;
+
+    /// Loosest screening threshold of the early SCF iterations (INTS_TOLERANCE_EARLY), used while early_screening_
+    double early_cutoff_;
+    /// Screening threshold of the last compute_JK
+    double screening_cutoff_ = 0.0;
+
+    // => Skeleton Fock build variables <= //
+
+    /// Build from the symmetry-unique shell quartets when the densities allow it? (SKELETON_FOCK)
+    bool skeleton_;
+    /// Is the current compute_JK a skeleton build?
+    bool do_skeleton_iter_ = false;
+    /// shell_images_[g][P] is the shell P maps into under operation g of the point group
+    std::vector<std::vector<int>> shell_images_;
 
     /// D, J, K, wK Matrices from previous iteration, used in Incremental Fock Builds
     std::vector<SharedMatrix> prev_D_ao_;
@@ -783,6 +808,11 @@ class PSI_API DirectJK : public JK {
     /// Post-iteration Incfock processing
     void incfock_postiter();
 
+    /// Orbit size of shell quartet (PQ|RS) if it represents its orbit under the point group, else 0
+    int skeleton_weight(int P, int Q, int R, int S) const;
+    /// Turn skeleton J/K matrices into the full ones by projecting onto the totally symmetric irrep
+    void symmetrize_skeleton(std::vector<SharedMatrix>& mats) const;
+
     /**
      * @brief The standard J and K matrix builds for this integral class
      *
@@ -826,6 +856,16 @@ class PSI_API DirectJK : public JK {
 
     // => Accessors <= //
     bool do_incfock_iter() { return do_incfock_iter_; }
+    /// Number of shell quartets dropped by density screening in the last compute call
+    size_t num_dropped_shells() const { return num_dropped_shells_; }
+    /// Accumulated bound on the contributions neglected since the last full Fock build
+    double incfock_error_bound() const { return incfock_error_bound_; }
+    /// Screening threshold used by the last compute call
+    double screening_cutoff() const { return screening_cutoff_; }
+    /// Is there a looser screening threshold for the early SCF iterations?
+    bool has_early_cutoff() const { return early_cutoff_ > cutoff_; }
+    /// Make the next build a full one, e.g. after the screening threshold changed
+    void clear_D_prev() { initial_iteration_ = true; }
 
     /**
     * Print header information regarding JK
@@ -1120,6 +1160,12 @@ class PSI_API MemDFJK : public JK {
     int df_ints_num_threads_;
     /// Condition cutoff in fitting metric, defaults to 1.0E-12
     double condition_ = 1.0E-12;
+    /// Coefficient tolerance for the sparse K half-transform, 0.0 (dense) by default
+    double K_sparse_tol_ = 0.0;
+    /// Share the in-core AOs with other processes through POSIX shared memory?
+    bool shared_AO_ = false;
+    /// Restrict the fitting of each AO pair to the auxiliary functions on its two atoms?
+    bool pair_fitting_ = false;
 
     // => Required Algorithm-Specific Methods <= //
 
@@ -1166,6 +1212,28 @@ class PSI_API MemDFJK : public JK {
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
 
+    /**
+     * Coefficient tolerance for the sparse K build. Symmetric K builds
+     * then use Cholesky-localized occupied orbitals and skip negligible ones.
+     * @param tol coefficient tolerance, 0.0 (dense K) by default
+     */
+    void set_K_sparse_tolerance(double tol) { K_sparse_tol_ = tol; }
+
+    /**
+     * Publish the in-core AOs to, or attach them from, a shared-memory
+     * segment keyed by basis, geometry and screening settings.
+     * @param shared share the AOs between processes? defaults to false
+     */
+    void set_shared_AO(bool shared) { shared_AO_ = shared; }
+
+    /**
+     * Pair-atomic fitting: each AO pair is fitted only with the auxiliary
+     * functions on its two atoms, so only atom-pair metric blocks are inverted.
+     * J is built with the robust formula.
+     * @param pair_fitting use pair-atomic fitting? defaults to false
+     */
+    void set_pair_fitting(bool pair_fitting) { pair_fitting_ = pair_fitting; }
+
     /**
  * A set_do_wK function that affects the dfhelper object.
  * used to control wK workflow.
@@ -1225,6 +1293,20 @@ class PSI_API DFJCOSK : public JK {
     /// Overlap fitting metric for grid_final_
     SharedMatrix Q_final_;
 
+    // => Collocation Cache <= //
+
+    /// The grid whose density-independent block quantities are held in X_cache_ and QX_cache_
+    std::shared_ptr<DFTGrid> cache_grid_;
+    /// Weighted basis function values (X) on each block of cache_grid_, nullptr if not cached
+    std::vector<SharedMatrix> X_cache_;
+    /// X contracted with the overlap fitting metric on each block of cache_grid_, nullptr if not cached
+    std::vector<SharedMatrix> QX_cache_;
+
+    /// Choose which blocks of grid to cache within memory_, releasing any cache of another grid
+    void setup_collocation_cache(std::shared_ptr<DFTGrid> grid, bool overlap_fitted);
+    /// Memory (doubles) held for the whole SCF: Coulomb metric, overlap fitting metrics and grid points
+    size_t fixed_memory() const;
+
     std::string name() override { return "DFJCOSK"; }
     size_t memory_estimate() override;
 
@@ -1276,8 +1358,19 @@ class PSI_API DFJCOSK : public JK {
      * Clear D_prev_
      */
     void clear_D_prev() { D_prev_.clear();}
+
+    /**
+     * Build the COSX integration grid described by the COSX_* options
+     * @param final_grid the large grid of the final SCF iteration (true) or the initial grid (false)
+     * @param atomic_blocks block the points by their parent atom (ATOMIC) instead of COSX_BLOCK_SCHEME
+     */
+    static std::shared_ptr<DFTGrid> build_grid(std::shared_ptr<BasisSet> primary, Options& options, bool final_grid,
+                                               bool atomic_blocks = false);
 };
 
+/// Loose shell-pair bound on the ESP integrals used to screen the COSX grid loops
+PSI_API Matrix compute_esp_bound(const BasisSet& primary);
+
 /**
  * Class DFJLinK
  *
@@ -38,10 +38,14 @@
 
 #include "gau2grid/gau2grid.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace psi {
 
+// Size in doubles of the tile of T = phi D that RKSFunctions::compute_points keeps in cache (256 KiB)
+static constexpr int points_tile_doubles = 32768;
+
 SAPFunctions::SAPFunctions(std::shared_ptr<BasisSet> primary, int max_points, int max_functions)
     : PointFunctions(primary, max_points, max_functions) {
     current_basis_map_ = &basis_values_;
@@ -60,13 +64,7 @@ void SAPFunctions::allocate() {
 }
 void SAPFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    load_basis_values(block, force_compute);
 }
 void SAPFunctions::print(std::string out, int print) const {
     std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
@@ -153,13 +151,7 @@ void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
     if (!D_AO_) throw PSIEXCEPTION("RKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    load_basis_values(block, force_compute);
 
     // => Global information <= //
     int npoints = block->npoints();
@@ -185,62 +177,128 @@ void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
         }
     }
 
-    // => Build LSDA quantities <= //
+    // => Point tiling <= //
+    // The points are processed in tiles that keep T = phi D in cache, so that each tile of T is
+    // consumed by the dot products right after the DGEMM instead of a full npoints x nlocal
+    // intermediate being written out and streamed back for every quantity.
+    int tile = std::max(16, std::min(npoints, (int)(points_tile_doubles / std::max(nlocal, 1))));
+
     double** phip = basis_value("PHI")->pointer();
     double* rhoap = point_value("RHO_A")->pointer();
     size_t coll_funcs = basis_value("PHI")->ncol();
 
-    // Rho_a = 2.0 * D_xy phi_xa phi_ya
-    C_DGEMM('N', 'N', npoints, nlocal, nlocal, 2.0, phip[0], coll_funcs, D2p[0], nglobal, 0.0, Tp[0], nglobal);
-    for (int P = 0; P < npoints; P++) {
-        rhoap[P] = C_DDOT(nlocal, phip[P], 1, Tp[P], 1);
+    double** phixp = nullptr;
+    double** phiyp = nullptr;
+    double** phizp = nullptr;
+    double* rhoaxp = nullptr;
+    double* rhoayp = nullptr;
+    double* rhoazp = nullptr;
+    double* gammaaap = nullptr;
+    double* taup = nullptr;
+    if (ansatz_ >= 1) {
+        phixp = basis_value("PHI_X")->pointer();
+        phiyp = basis_value("PHI_Y")->pointer();
+        phizp = basis_value("PHI_Z")->pointer();
+        rhoaxp = point_value("RHO_AX")->pointer();
+        rhoayp = point_value("RHO_AY")->pointer();
+        rhoazp = point_value("RHO_AZ")->pointer();
+        gammaaap = point_value("GAMMA_AA")->pointer();
+    }
+    if (ansatz_ >= 2) {
+        taup = point_value("TAU_A")->pointer();
     }
 
-    // => Build GGA quantities <= //
-    // Rho^l_a = D_xy phi_xa phi^l_ya
-    if (ansatz_ >= 1) {
-        double** phixp = basis_value("PHI_X")->pointer();
-        double** phiyp = basis_value("PHI_Y")->pointer();
-        double** phizp = basis_value("PHI_Z")->pointer();
-        double* rhoaxp = point_value("RHO_AX")->pointer();
-        double* rhoayp = point_value("RHO_AY")->pointer();
-        double* rhoazp = point_value("RHO_AZ")->pointer();
-        double* gammaaap = point_value("GAMMA_AA")->pointer();
+    // => Mixed precision <= //
+    // T = 2 phi D is formed in single precision, the dot products with T are accumulated in double
+    if (mixed_precision()) {
+        phi_float_.resize((size_t)npoints * nlocal);
+        float_temp_.resize((size_t)max_points_ * max_functions_ + (size_t)nlocal * nlocal);
+        float* phif = phi_float_.data();
+        float* Tf = float_temp_.data();
+        float* Df = Tf + (size_t)max_points_ * max_functions_;
+        for (int P = 0; P < npoints; P++) {
+            std::copy(phip[P], phip[P] + nlocal, phif + (size_t)P * nlocal);
+        }
+        for (int ml = 0; ml < nlocal; ml++) {
+            std::copy(D2p[ml], D2p[ml] + nlocal, Df + (size_t)ml * nlocal);
+        }
+
+        C_SGEMM('N', 'N', npoints, nlocal, nlocal, 2.0f, phif, nlocal, Df, nlocal, 0.0f, Tf, nlocal);
 
         for (int P = 0; P < npoints; P++) {
-            // 2.0 for Px D P + P D Px
-            double rho_x = 2.0 * C_DDOT(nlocal, phixp[P], 1, Tp[P], 1);
-            double rho_y = 2.0 * C_DDOT(nlocal, phiyp[P], 1, Tp[P], 1);
-            double rho_z = 2.0 * C_DDOT(nlocal, phizp[P], 1, Tp[P], 1);
-            rhoaxp[P] = rho_x;
-            rhoayp[P] = rho_y;
-            rhoazp[P] = rho_z;
-            gammaaap[P] = rho_x * rho_x + rho_y * rho_y + rho_z * rho_z;
+            const float* TPf = Tf + (size_t)P * nlocal;
+            double rho = 0.0;
+            for (int m = 0; m < nlocal; m++) rho += phip[P][m] * TPf[m];
+            rhoap[P] = rho;
+
+            if (ansatz_ >= 1) {
+                double rho_x = 0.0;
+                double rho_y = 0.0;
+                double rho_z = 0.0;
+                for (int m = 0; m < nlocal; m++) {
+                    rho_x += phixp[P][m] * TPf[m];
+                    rho_y += phiyp[P][m] * TPf[m];
+                    rho_z += phizp[P][m] * TPf[m];
+                }
+                // 2.0 for Px D P + P D Px
+                rho_x *= 2.0;
+                rho_y *= 2.0;
+                rho_z *= 2.0;
+                rhoaxp[P] = rho_x;
+                rhoayp[P] = rho_y;
+                rhoazp[P] = rho_z;
+                gammaaap[P] = rho_x * rho_x + rho_y * rho_y + rho_z * rho_z;
+            }
         }
+        return;
     }
 
-    // => Build Meta quantities <= //
-    if (ansatz_ >= 2) {
-        double** phixp = basis_value("PHI_X")->pointer();
-        double** phiyp = basis_value("PHI_Y")->pointer();
-        double** phizp = basis_value("PHI_Z")->pointer();
-        double* taup = point_value("TAU_A")->pointer();
+    for (int P0 = 0; P0 < npoints; P0 += tile) {
+        int ntile = std::min(tile, npoints - P0);
 
-        std::fill(taup, taup + npoints, 0.0);
+        // => Build LSDA quantities <= //
+        // Rho_a = 2.0 * D_xy phi_xa phi_ya
+        C_DGEMM('N', 'N', ntile, nlocal, nlocal, 2.0, phip[P0], coll_funcs, D2p[0], nglobal, 0.0, Tp[0], nglobal);
+        for (int P = 0; P < ntile; P++) {
+            rhoap[P0 + P] = C_DDOT(nlocal, phip[P0 + P], 1, Tp[P], 1);
+        }
 
-        double** phi[3];
-        phi[0] = phixp;
-        phi[1] = phiyp;
-        phi[2] = phizp;
+        // => Build GGA quantities <= //
+        // Rho^l_a = D_xy phi_xa phi^l_ya
+        if (ansatz_ >= 1) {
+            for (int P = 0; P < ntile; P++) {
+                // 2.0 for Px D P + P D Px
+                double rho_x = 2.0 * C_DDOT(nlocal, phixp[P0 + P], 1, Tp[P], 1);
+                double rho_y = 2.0 * C_DDOT(nlocal, phiyp[P0 + P], 1, Tp[P], 1);
+                double rho_z = 2.0 * C_DDOT(nlocal, phizp[P0 + P], 1, Tp[P], 1);
+                rhoaxp[P0 + P] = rho_x;
+                rhoayp[P0 + P] = rho_y;
+                rhoazp[P0 + P] = rho_z;
+                gammaaap[P0 + P] = rho_x * rho_x + rho_y * rho_y + rho_z * rho_z;
+            }
+        }
 
-        for (int x = 0; x < 3; x++) {
-            double** phic = phi[x];
-            C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phic[0], coll_funcs, D2p[0], nglobal, 0.0, Tp[0], nglobal);
-            for (int P = 0; P < npoints; P++) {
-                taup[P] += C_DDOT(nlocal, phic[P], 1, Tp[P], 1);
+        // => Build Meta quantities <= //
+        if (ansatz_ >= 2) {
+            std::fill(taup + P0, taup + P0 + ntile, 0.0);
+
+            double** phi[3];
+            phi[0] = phixp;
+            phi[1] = phiyp;
+            phi[2] = phizp;
+
+            for (int x = 0; x < 3; x++) {
+                double** phic = phi[x];
+                C_DGEMM('N', 'N', ntile, nlocal, nlocal, 1.0, phic[P0], coll_funcs, D2p[0], nglobal, 0.0, Tp[0],
+                        nglobal);
+                for (int P = 0; P < ntile; P++) {
+                    taup[P0 + P] += C_DDOT(nlocal, phic[P0 + P], 1, Tp[P], 1);
+                }
             }
         }
+    }
 
+    if (ansatz_ >= 2) {
         // Kinetic terms
         // double** phixxp = basis_value("PHI_XX")->pointer();
         // double** phixyp = basis_value("PHI_XY")->pointer();
@@ -298,13 +356,7 @@ void RKSFunctions::set_Cs(SharedMatrix /*Ca_AO*/, SharedMatrix /*Cb_AO*/) {
 }
 void RKSFunctions::compute_orbitals(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    load_basis_values(block, force_compute);
     // timer_off("Functions: Points");
 
     // => Global information <= //
@@ -422,13 +474,7 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
     if (!Da_AO_) throw PSIEXCEPTION("UKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    load_basis_values(block, force_compute);
 
     // => Global information <= //
     int npoints = block->npoints();
@@ -568,13 +614,7 @@ void UKSFunctions::set_Cs(SharedMatrix Ca_AO, SharedMatrix Cb_AO) {
 }
 void UKSFunctions::compute_orbitals(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    load_basis_values(block, force_compute);
 
     // => Global information <= //
 
@@ -643,6 +683,42 @@ PointFunctions::PointFunctions(std::shared_ptr<BasisSet> primary, int max_points
     set_ansatz(0);
 }
 PointFunctions::~PointFunctions() {}
+void PointFunctions::load_basis_values(std::shared_ptr<BlockOPoints> block, bool force_compute) {
+    block_index_ = block->index();
+
+    // A cached block is only usable if it holds every derivative this worker needs
+    if (!force_compute && cache_map_) {
+        auto cached = cache_map_->find(block->index());
+        if (cached != cache_map_->end() && cached->second.size() >= basis_values_.size()) {
+            current_basis_map_ = &cached->second;
+            return;
+        }
+    }
+
+    current_basis_map_ = &basis_values_;
+
+    if (!force_compute && float_cache_map_) {
+        auto cached = float_cache_map_->find(block->index());
+        if (cached != float_cache_map_->end() && cached->second.size() >= basis_values_.size()) {
+            // Expand back to double into the upper left rectangle of the registers
+            size_t npoints = block->npoints();
+            size_t nlocal = block->local_nbf();
+            for (auto& kv : basis_values_) {
+                // find, not operator[]: the cache is shared by every thread and must not change here
+                const float* sourcep = cached->second.at(kv.first).data();
+                double** valuesp = kv.second->pointer();
+                for (size_t P = 0; P < npoints; P++) {
+                    for (size_t k = 0; k < nlocal; k++) {
+                        valuesp[P][k] = sourcep[P * nlocal + k];
+                    }
+                }
+            }
+            return;
+        }
+    }
+
+    BasisFunctions::compute_functions(block);
+}
 SharedVector PointFunctions::point_value(const std::string& key) { return point_values_[key]; }
 
 SharedMatrix PointFunctions::orbital_value(const std::string& key) { return orbital_values_[key]; }
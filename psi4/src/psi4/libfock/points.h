@@ -111,9 +111,22 @@ class PointFunctions : public BasisFunctions {
     // Contains a map to the cache the global basis_values
     std::unordered_map<size_t, std::map<std::string, SharedMatrix>>* cache_map_ = nullptr;
 
+    // Contains a map to the single-precision cache of the global basis_values (npoints x nlocal, packed)
+    std::unordered_map<size_t, std::map<std::string, std::vector<float>>>* float_cache_map_ = nullptr;
+
     // Contains a pointer to the current map to use for basis_values
     std::map<std::string, SharedMatrix>* current_basis_map_ = nullptr;
 
+    /// Points current_basis_map_ at the cached basis values of block if possible, else computes them
+    void load_basis_values(std::shared_ptr<BlockOPoints> block, bool force_compute);
+
+    /// Do the density and potential contractions in single precision (LSDA and GGA)?
+    bool mixed_precision_ = false;
+    /// Single-precision PHI of the current block (npoints x nlocal), built by compute_points if mixed_precision_
+    std::vector<float> phi_float_;
+    /// Single-precision scratch for the contractions
+    std::vector<float> float_temp_;
+
     /// Ansatz (0 - LSDA, 1 - GGA, 2 - Meta-GGA)
     int ansatz_;
     /// Map of value names to Vectors containing values
@@ -134,10 +147,18 @@ class PointFunctions : public BasisFunctions {
     void set_cache_map(std::unordered_map<size_t, std::map<std::string, SharedMatrix>>* cache_map) {
         cache_map_ = cache_map;
     }
+    void set_float_cache_map(std::unordered_map<size_t, std::map<std::string, std::vector<float>>>* float_cache_map) {
+        float_cache_map_ = float_cache_map;
+    }
+    void set_mixed_precision(bool mixed_precision) { mixed_precision_ = mixed_precision; }
 
     // => Computers <= //
 
     virtual void compute_points(std::shared_ptr<BlockOPoints> block, bool force_compute = true) = 0;
+    /// Loads (from the cache if possible) or computes only the basis function values of block
+    void compute_basis_values(std::shared_ptr<BlockOPoints> block, bool force_compute = true) {
+        load_basis_values(block, force_compute);
+    }
 
     // => Accessors <= //
 
@@ -152,6 +173,13 @@ class PointFunctions : public BasisFunctions {
 
     int ansatz() const { return ansatz_; }
 
+    /// Is the contraction of the current block in single precision?
+    bool mixed_precision() const { return mixed_precision_ && ansatz_ < 2; }
+    /// Single-precision PHI of the current block (mixed precision only)
+    std::vector<float>& phi_float() { return phi_float_; }
+    /// Single-precision scratch, at least max_points x max_functions
+    std::vector<float>& float_temp() { return float_temp_; }
+
     // => Setters <= //
 
     void set_ansatz(int ansatz) {
@@ -126,6 +126,7 @@ size_t CGRSolver::memory_estimate() {
 }
 void CGRSolver::initialize() {
     finalize();
+    x_.clear();
 
     int nvec = b_.size();
     for (int N = 0; N < nvec; ++N) {
@@ -219,14 +220,29 @@ void CGRSolver::setup() {
     }
 
 }
+void CGRSolver::set_guess(const std::vector<std::shared_ptr<Vector>>& x) {
+    x_guess_.clear();
+    for (size_t N = 0; N < x.size(); ++N) {
+        // Copies, so the guesses survive the caller reusing x() as the next solution
+        x_guess_.push_back(std::make_shared<Vector>(*x[N]));
+    }
+}
 void CGRSolver::guess() {
+    if (x_guess_.size() == b_.size()) {
+        for (size_t N = 0; N < b_.size(); ++N) {
+            x_[N]->copy(*x_guess_[N]);
+        }
+        x_guess_.clear();
+        return;
+    }
+
     for (size_t N = 0; N < b_.size(); ++N) {
         for (int h = 0; h < b_[N]->nirrep(); ++h) {
             int n = b_[N]->dimpi()[h];
             if (!n) continue;
-            auto bp = b_[N]->pointer();
-            auto xp = x_[N]->pointer();
-            auto dp = diag_->pointer();
+            auto bp = b_[N]->pointer(h);
+            auto xp = x_[N]->pointer(h);
+            auto dp = diag_->pointer(h);
             if (precondition_ == "JACOBI") {
                 double lambda = shifts_[h][N];
                 for (int i = 0; i < n; ++i) {
@@ -406,9 +422,9 @@ void CGRSolver::update_z() {
         for (int h = 0; h < b_[N]->nirrep(); ++h) {
             int n = b_[N]->dimpi()[h];
             if (!n) continue;
-            double* zp = z_[N]->pointer();
-            double* rp = r_[N]->pointer();
-            double* dp = diag_->pointer();
+            double* zp = z_[N]->pointer(h);
+            double* rp = r_[N]->pointer(h);
+            double* dp = diag_->pointer(h);
             if (precondition_ == "JACOBI") {
                 double lambda = shifts_[h][N];
                 for (int i = 0; i < n; ++i) {
@@ -436,8 +452,8 @@ void CGRSolver::beta() {
         for (int h = 0; h < b_[N]->nirrep(); ++h) {
             int n = b_[N]->dimpi()[h];
             if (!n) continue;
-            double* rp = r_[N]->pointer();
-            double* zp = z_[N]->pointer();
+            double* rp = r_[N]->pointer(h);
+            double* zp = z_[N]->pointer(h);
             zr += C_DDOT(n, rp, 1, zp, 1);
         }
         beta_[N] = zr / z_r_[N];
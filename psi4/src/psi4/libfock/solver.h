@@ -197,6 +197,8 @@ class CGRSolver : public RSolver {
     std::vector<std::vector<double> > shifts_;
     /// Number of guess vectors to use for subspace preconditioner
     int nguess_;
+    /// Starting vectors replacing the Jacobi guess, e.g. the solutions at a nearby shift
+    std::vector<std::shared_ptr<Vector> > x_guess_;
 
     /// Initializes shifts_ to 0
     void setup();
@@ -235,6 +237,9 @@ class CGRSolver : public RSolver {
         A_inds_ = inds;
     }
     void set_nguess(int nguess) { nguess_ = nguess; }
+    /// Start the next solve from these vectors (one per force vector) instead of the Jacobi guess.
+    /// Passing the converged x() of one set of shifts makes a scan over nearby shifts cheap.
+    void set_guess(const std::vector<std::shared_ptr<Vector> >& x);
 };
 }
 #endif
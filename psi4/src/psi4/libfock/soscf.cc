@@ -28,6 +28,7 @@
 
 #include "soscf.h"
 
+#include <algorithm>
 #include <cmath>
 #include <ctime>
 
@@ -70,6 +71,11 @@ SharedMatrix SOMCSCF::compute_Qk(SharedMatrix TPDM, SharedMatrix U, SharedMatrix
     throw PSIEXCEPTION("The SOMCSCF object must be initialized as a DF or Disk object.");
 }
 void SOMCSCF::set_act_MO() { throw PSIEXCEPTION("The SOMCSCF object must be initialized as a DF or Disk object."); }
+SharedMatrix SOMCSCF::current_Q(SharedMatrix TPDM) {
+    // Every Hessian product needs Q of the same TPDM, which update() has already formed
+    if (TPDM == matrices_["TPDM"] && matrices_["Q"]) return matrices_["Q"];
+    return compute_Q(TPDM);
+}
 void SOMCSCF::set_ras(std::vector<Dimension> ras_spaces) {
     ras_spaces_ = ras_spaces;
     casscf_ = false;
@@ -754,8 +760,7 @@ SharedMatrix SOMCSCF::solve(int max_iter, double conv, bool print) {
 
         double beta = r->vector_dot(z) / rzpre;
         // if (beta > 0.15) beta = 0.15;
-        p->scale(beta);
-        p->add(z);
+        p->axpby(1.0, z, beta);
 
     }  // End iterations
 
@@ -818,9 +823,29 @@ void SOMCSCF::zero_ras(SharedMatrix vector) {
 DFSOMCSCF::DFSOMCSCF(std::shared_ptr<JK> jk, std::shared_ptr<DFHelper> df, SharedMatrix AOTOSO, SharedMatrix H)
     : SOMCSCF(jk, AOTOSO, H) {
     dfh_ = df;
+    df_tensor_doubles_ = 0;
 }
 DFSOMCSCF::~DFSOMCSCF() {}
+SharedMatrix DFSOMCSCF::df_tensor(const std::string& name, size_t rows) {
+    auto kept = df_tensors_.find(name);
+    if (kept != df_tensors_.end()) return kept->second;
+
+    size_t nQ = dfh_->get_naux();
+    auto T = std::make_shared<Matrix>(name, rows, nQ);
+    dfh_->fill_tensor(name, T);
+    if (df_tensor_doubles_ + rows * nQ <= memory_ / 2) {
+        df_tensors_[name] = T;
+        df_tensor_doubles_ += rows * nQ;
+    }
+    return T;
+}
+void DFSOMCSCF::clear_df_tensors() {
+    df_tensors_.clear();
+    df_tensor_doubles_ = 0;
+}
 void DFSOMCSCF::transform(bool approx_only) {
+    clear_df_tensors();
+
     // => AO C matrices <= //
     // We want a pitzer order C matrix with appended Cact
     SharedMatrix Cocc = matrices_["Cocc"];
@@ -888,13 +913,12 @@ void DFSOMCSCF::transform(bool approx_only) {
     dfh_->transform();
 }
 void DFSOMCSCF::set_act_MO() {
-    // Build (aa|aa)
-    size_t nQ = dfh_->get_naux();
+    // Called by update() with new orbitals, so the kept tensors are stale
+    clear_df_tensors();
 
-    auto aaQ = std::make_shared<Matrix>("aaQ", nact_ * nact_, nQ);
-    dfh_->fill_tensor("aaQ", aaQ);
+    // Build (aa|aa)
+    SharedMatrix aaQ = df_tensor("aaQ", nact_ * nact_);
     matrices_["actMO"] = linalg::doublet(aaQ, aaQ, false, true);
-    aaQ.reset();
 }
 SharedMatrix DFSOMCSCF::compute_Q(SharedMatrix TPDM) {
     timer_on("SOMCSCF: DF-Q matrix");
@@ -915,9 +939,8 @@ SharedMatrix DFSOMCSCF::compute_Q(SharedMatrix TPDM) {
     }
 
     // Load aaQ
-    auto aaQ = std::make_shared<Matrix>("aaQ", nact_ * nact_, nQ);
+    SharedMatrix aaQ = df_tensor("aaQ", nact_ * nact_);
     double* aaQp = aaQ->pointer()[0];
-    dfh_->fill_tensor("aaQ", aaQ);
 
     // d_vwxy I_xyQ -> d_vwQ (Qa^4)
     auto vwQ = std::make_shared<Matrix>("vwQ", nact_ * nact_, nQ);
@@ -926,9 +949,8 @@ SharedMatrix DFSOMCSCF::compute_Q(SharedMatrix TPDM) {
     aaQ.reset();
 
     // Load NaQ
-    auto NaQ = std::make_shared<Matrix>("NaQ", nmo_ * nact_, nQ);
+    SharedMatrix NaQ = df_tensor("RaQ", nmo_ * nact_);
     double* NaQp = NaQ->pointer()[0];
-    dfh_->fill_tensor("RaQ", NaQ);
 
     // d_vwQ I_NwQ -> Q_vN (NQa^2)
     auto denQ = std::make_shared<Matrix>("Dense Qvn", nact_, nmo_);
@@ -988,9 +1010,8 @@ SharedMatrix DFSOMCSCF::compute_Qk(SharedMatrix TPDM, SharedMatrix U, SharedMatr
     }
 
     // Read NaQ
-    auto NaQ = std::make_shared<Matrix>("RaQ", nmo_ * nact_, nQ);
+    SharedMatrix NaQ = df_tensor("RaQ", nmo_ * nact_);
     double* NaQp = NaQ->pointer()[0];
-    dfh_->fill_tensor("RaQ", NaQ);
 
     auto xyQ = std::make_shared<Matrix>("xyQ", nact_ * nact_, nQ);
     double* xyQp = xyQ->pointer()[0];
@@ -1024,28 +1045,36 @@ SharedMatrix DFSOMCSCF::compute_Qk(SharedMatrix TPDM, SharedMatrix U, SharedMatr
     C_DGEMM('N', 'T', nact_, nmo_, nact3, 1.0, TPDMp, nact3, Gnwxyp, nact3, 0.0, dQkp[0], nmo_);
 
     // wo,onQ->wnQ (aU, NNQ) QN^2a^2 (rate determining)
-    // Read and gemm in chunks, need to do blocking later
-    size_t memory_avail = memory_ - nact_ * nmo_ * nQ;
-    size_t chunk_size = memory_avail / (nmo_ * nQ);
-
     auto wnQ = std::make_shared<Matrix>("nwQ", nact_ * nmo_, nQ);
     double** wnQp = wnQ->pointer();
-    auto NNQ = std::make_shared<Matrix>("RRQ", chunk_size * nmo_, nQ);
-    double** NNQp = NNQ->pointer();
 
-    for (size_t start = 0; start < nmo_; start += chunk_size) {
-        size_t block = (start + chunk_size > nmo_ ? nmo_ - start : chunk_size);
-
-        dfh_->fill_tensor("RRQ", NNQ, {start, start + block});
-        C_DGEMM('N', 'N', nact_, nmo_ * nQ, block, 1.0, dUactp[0] + start, nmo_, NNQp[0], nmo_ * nQ, 1.0, wnQp[0],
+    size_t rrq_doubles = nmo_ * nmo_ * nQ;
+    if (df_tensors_.count("RRQ") || df_tensor_doubles_ + rrq_doubles <= memory_ / 2) {
+        // All of RRQ, kept for the following Hessian products
+        SharedMatrix NNQ = df_tensor("RRQ", nmo_ * nmo_);
+        C_DGEMM('N', 'N', nact_, nmo_ * nQ, nmo_, 1.0, dUactp[0], nmo_, NNQ->pointer()[0], nmo_ * nQ, 0.0, wnQp[0],
                 nmo_ * nQ);
+    } else {
+        // Read and gemm in chunks, need to do blocking later
+        size_t memory_used = df_tensor_doubles_ + nact_ * nmo_ * nQ;
+        size_t memory_avail = (memory_ > memory_used ? memory_ - memory_used : 0);
+        size_t chunk_size = std::max(memory_avail / (nmo_ * nQ), (size_t)1);
+
+        auto NNQ = std::make_shared<Matrix>("RRQ", chunk_size * nmo_, nQ);
+        double** NNQp = NNQ->pointer();
+
+        for (size_t start = 0; start < nmo_; start += chunk_size) {
+            size_t block = (start + chunk_size > nmo_ ? nmo_ - start : chunk_size);
+
+            dfh_->fill_tensor("RRQ", NNQ, {start, start + block});
+            C_DGEMM('N', 'N', nact_, nmo_ * nQ, block, 1.0, dUactp[0] + start, nmo_, NNQp[0], nmo_ * nQ, 1.0,
+                    wnQp[0], nmo_ * nQ);
+        }
     }
-    NNQ.reset();
 
     // Read aaQ
-    auto aaQ = std::make_shared<Matrix>("aaQ", nact_ * nact_, nQ);
+    SharedMatrix aaQ = df_tensor("aaQ", nact_ * nact_);
     double* aaQp = aaQ->pointer()[0];
-    dfh_->fill_tensor("aaQ", aaQ);
 
     // wnQ,xyQ => tmp_wnxy (wNQ, aaQ) NQa^3
     C_DGEMM('N', 'T', nmo_ * nact_, nact2, nQ, 1.0, wnQp[0], nQ, aaQp, nQ, 0.0, Gnwxyp, nact2);
@@ -1072,7 +1101,7 @@ SharedMatrix DFSOMCSCF::compute_Qk(SharedMatrix TPDM, SharedMatrix U, SharedMatr
     C_DGEMM('N', 'T', nact_, nmo_, nact3, 1.0, TPDMp, nact3, Gleftp, nact3, 1.0, dQkp[0], nmo_);
 
     // Symm block Qk
-    SharedMatrix tQ = compute_Q(TPDM);
+    SharedMatrix tQ = current_Q(TPDM);
     SharedMatrix Qk = linalg::doublet(tQ, U, false, true);
     // dQk->print();
 
@@ -1365,7 +1394,7 @@ SharedMatrix DiskSOMCSCF::compute_Qk(SharedMatrix TPDMmat, SharedMatrix U, Share
 
     // Qkmat->print();
     // Transform last index
-    SharedMatrix Qmat = compute_Q(TPDMmat);
+    SharedMatrix Qmat = current_Q(TPDMmat);
     Qkmat->gemm(false, false, -1.0, Qmat, U, 1.0);
     if (debug) {
         Qkmat->print();
@@ -180,6 +180,13 @@ class SOMCSCF {
      */
     virtual SharedMatrix compute_Qk(SharedMatrix TPDM, SharedMatrix U, SharedMatrix Uact);
 
+    /**
+     * The Q matrix of TPDM; the one formed in update() when TPDM is the current TPDM
+     * @param  TPDM Dense nact*nact by nact*nact symmetrized TPDM
+     * @return      The symmetry blocked Q matrix, not to be modified
+     */
+    SharedMatrix current_Q(SharedMatrix TPDM);
+
     /**
      * Computes the Q matrix AFock_pq = (pq|uv) - 0.5 (pu|qv) \gamma_{uv}
      * @param  OPDM Dense nact*nact by nact*nact symmetrized OPDM
@@ -276,6 +283,15 @@ class DFSOMCSCF : public SOMCSCF {
 
    protected:
     std::shared_ptr<DFHelper> dfh_;
+
+    /// aaQ, RaQ, and RRQ of the current orbitals, kept from one Hessian product to the next
+    /// while together within half the memory
+    std::map<std::string, SharedMatrix> df_tensors_;
+    size_t df_tensor_doubles_;
+    /// The (rows x naux) tensor name, from df_tensors_ or read (and kept if it fits); not to be modified
+    SharedMatrix df_tensor(const std::string& name, size_t rows);
+    void clear_df_tensors();
+
     void transform(bool approx_only) override;
     void set_act_MO() override;
     SharedMatrix compute_Q(SharedMatrix TPDM) override;
@@ -47,7 +47,9 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <chrono>
 #include <cstdlib>
+#include <limits>
 #include <numeric>
 #include <sstream>
 #include <string>
@@ -92,6 +94,9 @@ extern bool brianBuildingNLCGrid;
 
 namespace psi {
 
+// Largest number of perturbation densities contracted together in RV::compute_Vx
+static constexpr int vx_batch_max = 16;
+
 VBase::VBase(std::shared_ptr<SuperFunctional> functional, std::shared_ptr<BasisSet> primary, Options& options)
     : options_(options), primary_(primary), functional_(functional) {
     common_init();
@@ -100,14 +105,20 @@ VBase::~VBase() {}
 void VBase::common_init() {
     print_ = options_.get_int("PRINT");
     debug_ = options_.get_int("DEBUG");
+    bench_ = options_.get_int("BENCH");
     v2_rho_cutoff_ = options_.get_double("DFT_V2_RHO_CUTOFF");
     vv10_rho_cutoff_ = options_.get_double("DFT_VV10_RHO_CUTOFF");
     grac_initialized_ = false;
     cache_map_deriv_ = -1;
+    cache_float_ = options_.get_bool("DFT_COLLOCATION_CACHE_FLOAT");
+    incxc_ = options_.get_bool("DFT_INCXC");
+    incxc_tol_ = options_.get_double("DFT_INCXC_TOLERANCE");
+    mixed_precision_ = options_.get_bool("DFT_MIXED_PRECISION");
     num_threads_ = 1;
 #ifdef _OPENMP
     num_threads_ = omp_get_max_threads();
 #endif
+    compute_threads_ = num_threads_;
 }
 std::shared_ptr<VBase> VBase::build_V(std::shared_ptr<BasisSet> primary, std::shared_ptr<SuperFunctional> functional,
                                       Options& options, const std::string& type) {
@@ -135,6 +146,10 @@ void VBase::set_D(std::vector<SharedMatrix> Dvec) {
         throw PSIEXCEPTION("VBase::set_D: Can only set up to two D vectors.");
     }
 
+    // The block densities and kernels belong to the previous D
+    block_rho_max_.clear();
+    vx_kernel_cache_.clear();
+
     // Build AO2USO matrix, if needed
     if (!AO2USO_ && (Dvec[0]->nirrep() != 1)) {
         auto integral = std::make_shared<IntegralFactory>(primary_);
@@ -167,6 +182,9 @@ void VBase::set_D(std::vector<SharedMatrix> Dvec) {
     }
 }
 void VBase::initialize() {
+    clear_incxc();
+    vx_kernel_cache_.clear();
+
     timer_on("V: Grid");
     grid_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, options_);
     timer_off("V: Grid");
@@ -712,6 +730,7 @@ void VBase::set_grac_shift(double grac_shift) {
     functional_->set_lock(false);
     functional_->set_grac_shift(grac_shift);
     functional_->set_lock(true);
+    clear_incxc();
     for (size_t i = 0; i < num_threads_; i++) {
         functional_workers_[i]->set_lock(false);
         functional_workers_[i]->set_grac_shift(grac_shift);
@@ -723,10 +742,35 @@ void VBase::print_header() const {
     functional_->print("outfile", print_);
     grid_->print("outfile", print_);
     if (print_ > 2) grid_->print_details("outfile", print_);
+    if (incxc_) outfile->Printf("  Incremental XC build, tolerance %11.3E\n\n", incxc_tol_);
+    if (mixed_precision_ && functional_->is_unpolarized()) outfile->Printf("  Mixed-precision XC contractions\n\n");
+}
+double VBase::xc_density_cutoff() {
+    // The GRAC shift makes V_RHO nonzero even where the density vanishes
+    if (functional_->needs_grac()) return 0.0;
+
+    // LibXC zeroes all outputs of a functional below its density threshold
+    double cutoff = std::numeric_limits<double>::max();
+    for (auto& func : functional_->x_functionals()) cutoff = std::min(cutoff, func->query_density_cutoff());
+    for (auto& func : functional_->c_functionals()) cutoff = std::min(cutoff, func->query_density_cutoff());
+    return (cutoff == std::numeric_limits<double>::max() ? 0.0 : cutoff);
 }
 std::shared_ptr<BlockOPoints> VBase::get_block(int block) { return grid_->blocks()[block]; }
 size_t VBase::nblocks() { return grid_->blocks().size(); }
-void VBase::finalize() { grid_.reset(); }
+void VBase::set_mixed_precision(bool mixed_precision) {
+    // Stored block contributions were computed at the old precision
+    if (mixed_precision != mixed_precision_) {
+        clear_incxc();
+        vx_kernel_cache_.clear();
+    }
+    mixed_precision_ = mixed_precision;
+    for (auto& pworker : point_workers_) pworker->set_mixed_precision(mixed_precision_);
+}
+void VBase::finalize() {
+    grid_.reset();
+    clear_incxc();
+    vx_kernel_cache_.clear();
+}
 void VBase::build_collocation_cache(size_t memory) {
     // Figure out many blocks to skip
 
@@ -737,15 +781,18 @@ void VBase::build_collocation_cache(size_t memory) {
     if (functional_->ansatz() == 2) {
         collocation_size *= 10;  // For gradients and Hessians
     }
+    // memory is in doubles, a float takes half of one
+    double element_size = (cache_float_ ? 0.5 : 1.0);
 
     // Figure out stride as closest whole number to amount we need
-    size_t stride = (size_t)(std::ceil(collocation_size / (double)memory));
+    size_t stride = (size_t)(std::ceil(element_size * collocation_size / (double)memory));
 
     // More memory than needed
     if (stride == 0) {
         stride = 1;
     }
     cache_map_.clear();
+    float_cache_map_.clear();
 
     // Effectively zero blocks saved.
     if (stride > grid_->blocks().size()) {
@@ -754,10 +801,19 @@ void VBase::build_collocation_cache(size_t memory) {
 
     cache_map_deriv_ = point_workers_[0]->deriv();
     auto saved_size_rank = std::vector<size_t>(num_threads_, 0);
+
+    // Every entry is made here, so the threads below only fill in their own and never rehash the maps
+    for (size_t Q = 0; Q < grid_->blocks().size(); Q += stride) {
+        size_t index = grid_->blocks()[Q]->index();
+        if (cache_float_)
+            float_cache_map_[index];
+        else
+            cache_map_[index];
+    }
     auto ncomputed_rank = std::vector<size_t>(num_threads_, 0);
 
 // Loop over the blocks
-#pragma omp parallel for schedule(guided) num_threads(num_threads_)
+#pragma omp parallel for schedule(guided) num_threads(compute_threads_)
     for (size_t Q = 0; Q < grid_->blocks().size(); Q += stride) {
         // Get thread info
         int rank = 0;
@@ -775,6 +831,25 @@ void VBase::build_collocation_cache(size_t memory) {
         size_t ncols = block->local_nbf();
         std::map<std::string, SharedMatrix> collocation_map;
 
+        if (cache_float_) {
+            std::map<std::string, std::vector<float>> float_collocation_map;
+            for (auto& kv : pworker->basis_values()) {
+                std::vector<float> coll(nrows * ncols);
+                double** sourcep = kv.second->pointer();
+                for (size_t i = 0; i < nrows; i++) {
+                    for (size_t j = 0; j < ncols; j++) {
+                        coll[i * ncols + j] = (float)sourcep[i][j];
+                    }
+                }
+                float_collocation_map[kv.first] = std::move(coll);
+
+                saved_size_rank[rank] += nrows * ncols;
+            }
+            ncomputed_rank[rank]++;
+            float_cache_map_.find(block->index())->second = std::move(float_collocation_map);
+            continue;
+        }
+
         // Loop over components PHI, PHI_X, PHI_Y, ...
         for (auto& kv : pworker->basis_values()) {
             auto coll = std::make_shared<Matrix>(kv.second->name(), nrows, ncols);
@@ -791,14 +866,13 @@ void VBase::build_collocation_cache(size_t memory) {
             saved_size_rank[rank] += nrows * ncols;
         }
         ncomputed_rank[rank]++;
-#pragma omp critical
-        cache_map_[block->index()] = collocation_map;
+        cache_map_.find(block->index())->second = collocation_map;
     }
 
     size_t saved_size = std::accumulate(saved_size_rank.begin(), saved_size_rank.end(), 0.0);
     size_t ncomputed = std::accumulate(ncomputed_rank.begin(), ncomputed_rank.end(), 0.0);
 
-    double gib_saved = 8.0 * (double)saved_size / 1024.0 / 1024.0 / 1024.0;
+    double gib_saved = (cache_float_ ? 4.0 : 8.0) * (double)saved_size / 1024.0 / 1024.0 / 1024.0;
     double fraction = (double)ncomputed / grid_->blocks().size() * 100;
     if (print_) {
         outfile->Printf("  Cached %.1lf%% of DFT collocation blocks in %.3lf [GiB].\n\n", fraction, gib_saved);
@@ -826,7 +900,7 @@ void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D,
     std::vector<std::map<std::string, SharedVector>> vv10_tmp_cache;
     vv10_tmp_cache.resize(nlgrid.blocks().size());
 
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_)
     for (size_t Q = 0; Q < nlgrid.blocks().size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -919,7 +993,7 @@ double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
 
 // => Compute the kernel <=
 // -11.948063
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_)
     for (size_t Q = 0; Q < nlgrid.blocks().size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -1010,7 +1084,7 @@ SharedMatrix VBase::vv10_nlc_gradient(SharedMatrix D) {
     }
 
 // => Compute the kernel <=
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_)
     for (size_t Q = 0; Q < nlgrid.blocks().size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -1097,6 +1171,7 @@ void SAP::initialize() {
         // This is like LDA
         point_tmp->set_ansatz(0);
         point_tmp->set_cache_map(&cache_map_);
+        point_tmp->set_float_cache_map(&float_cache_map_);
         point_workers_.push_back(point_tmp);
     }
 
@@ -1152,7 +1227,7 @@ void SAP::compute_V(std::vector<SharedMatrix> ret) {
     }
 
 // Traverse the blocks of points
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_)
     for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -1248,11 +1323,23 @@ void RV::initialize() {
         auto point_tmp = std::make_shared<RKSFunctions>(primary_, max_points, max_functions);
         point_tmp->set_ansatz(functional_->ansatz());
         point_tmp->set_cache_map(&cache_map_);
+        point_tmp->set_float_cache_map(&float_cache_map_);
+        point_tmp->set_mixed_precision(mixed_precision_);
         point_workers_.push_back(point_tmp);
     }
 }
 void RV::finalize() { VBase::finalize(); }
 void RV::print_header() const { VBase::print_header(); }
+size_t RV::incxc_size() {
+    if (!incxc_ || !grid_) return 0;
+    // a local density and a local V per block, and the quadrature values
+    size_t size = 0;
+    for (const auto& block : grid_->blocks()) {
+        size_t nlocal = block->functions_local_to_global().size();
+        size += 2 * nlocal * nlocal + 6;
+    }
+    return size;
+}
 void RV::compute_V(std::vector<SharedMatrix> ret) {
     timer_on("RV: Form V");
     
@@ -1304,13 +1391,32 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
     }
 
     // Per thread temporaries
+    // Each thread scatters its blocks into its own V_AO, avoiding one atomic per element of V
     std::vector<SharedMatrix> V_local;
+    std::vector<SharedMatrix> V_AO_local;
     for (size_t i = 0; i < num_threads_; i++) {
         V_local.push_back(std::make_shared<Matrix>("V Temp", max_functions, max_functions));
+        V_AO_local.push_back(std::make_shared<Matrix>("V AO Thread Temp", nbf_, nbf_));
     }
 
     auto V_AO = std::make_shared<Matrix>("V AO Temp", nbf_, nbf_);
-    auto Vp = V_AO->pointer();
+
+    // Per thread time breakdown [s], reported if bench_. Each section is timed once: into these
+    // sums with BENCH, otherwise with the parallel timers.
+    std::vector<double> properties_time(num_threads_);
+    std::vector<double> functional_time(num_threads_);
+    std::vector<double> vxc_time(num_threads_);
+    using clock = std::chrono::steady_clock;
+    auto section_on = [&](const char* key, int rank) {
+        if (!bench_) parallel_timer_on(key, rank);
+        return clock::now();
+    };
+    auto section_off = [&](const char* key, int rank, clock::time_point start, std::vector<double>& time) {
+        if (bench_)
+            time[rank] += std::chrono::duration<double>(clock::now() - start).count();
+        else
+            parallel_timer_off(key, rank);
+    };
 
     std::vector<double> functionalq(num_threads_);
     std::vector<double> rhoaq(num_threads_);
@@ -1318,10 +1424,40 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
     std::vector<double> rhoayq(num_threads_);
     std::vector<double> rhoazq(num_threads_);
 
+    // Blocks whose densest point is below the functional's cutoff contribute nothing
+    double rho_cutoff = xc_density_cutoff();
+    block_rho_max_.assign(grid_->blocks().size(), 0.0);
+    size_t nskipped = 0;
+
+    // Incremental build: blocks keep the density and contribution of their last evaluation
+    size_t nreused = 0;
+    if (incxc_ && incxc_D_block_.size() != grid_->blocks().size()) {
+        clear_incxc();
+        incxc_D_block_.resize(grid_->blocks().size());
+        incxc_V_block_.resize(grid_->blocks().size());
+        incxc_q_block_.resize(grid_->blocks().size());
+    }
+    double** Dp = D_AO_[0]->pointer();
+
+    // Adds a block's local V to the thread's V_AO
+    auto scatter_V = [&](double** V2p, const std::vector<int>& function_map, int rank) {
+        auto Vp = V_AO_local[rank]->pointer();
+        int nlocal = function_map.size();
+        for (int ml = 0; ml < nlocal; ml++) {
+            int mg = function_map[ml];
+            for (int nl = 0; nl < ml; nl++) {
+                int ng = function_map[nl];
+                Vp[mg][ng] += V2p[ml][nl];
+                Vp[ng][mg] += V2p[ml][nl];
+            }
+            Vp[mg][mg] += V2p[ml][ml];
+        }
+    };
+
 // VV10 kernel data if requested
 
 // Traverse the blocks of points
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_) reduction(+ : nskipped, nreused)
     for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -1332,23 +1468,75 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
         auto block = grid_->blocks()[Q];
         auto fworker = functional_workers_[rank];
         auto pworker = point_workers_[rank];
+        const auto& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+
+        // => Incremental reuse <= //
+        if (incxc_) {
+            SharedMatrix& Dref = incxc_D_block_[Q];
+            if (Dref) {
+                double** Drefp = Dref->pointer();
+                double dmax = 0.0;
+                for (int ml = 0; ml < nlocal; ml++) {
+                    for (int nl = 0; nl <= ml; nl++) {
+                        dmax = std::max(dmax, std::fabs(Dp[function_map[ml]][function_map[nl]] - Drefp[ml][nl]));
+                    }
+                }
+                if (dmax < incxc_tol_) {
+                    const auto& qvals = incxc_q_block_[Q];
+                    functionalq[rank] += qvals[0];
+                    rhoaq[rank] += qvals[1];
+                    rhoaxq[rank] += qvals[2];
+                    rhoayq[rank] += qvals[3];
+                    rhoazq[rank] += qvals[4];
+                    block_rho_max_[Q] = qvals[5];
+                    if (incxc_V_block_[Q]) scatter_V(incxc_V_block_[Q]->pointer(), function_map, rank);
+                    nreused++;
+                    continue;
+                }
+            } else {
+                Dref = std::make_shared<Matrix>("INCXC D Block", nlocal, nlocal);
+            }
+            double** Drefp = Dref->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                for (int nl = 0; nl < nlocal; nl++) {
+                    Drefp[ml][nl] = Dp[function_map[ml]][function_map[nl]];
+                }
+            }
+            incxc_V_block_[Q].reset();
+            incxc_q_block_[Q] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        }
 
         // Compute Rho, Phi, etc
-        parallel_timer_on("Properties", rank);
+        auto t0 = section_on("Properties", rank);
         pworker->compute_points(block, false);
-        parallel_timer_off("Properties", rank);
+        section_off("Properties", rank, t0, properties_time);
+
+        // => Density screening <= //
+        double* rho_block = pworker->point_value("RHO_A")->pointer();
+        double rho_max = 0.0;
+        for (int P = 0; P < block->npoints(); P++) {
+            rho_max = std::max(rho_max, std::fabs(rho_block[P]));
+        }
+        block_rho_max_[Q] = rho_max;
+        if (incxc_) incxc_q_block_[Q][5] = rho_max;
+
+        if (rho_max < rho_cutoff) {
+            nskipped++;
+            continue;
+        }
 
         // Compute functional values
-        parallel_timer_on("Functional", rank);
+        auto t1 = section_on("Functional", rank);
         fworker->compute_functional(pworker->point_values());
-        parallel_timer_off("Functional", rank);
+        section_off("Functional", rank, t1, functional_time);
 
         if (debug_ > 4) {
             block->print("outfile", debug_);
             pworker->print("outfile", debug_);
         }
 
-        parallel_timer_on("V_xc", rank);
+        auto t2 = section_on("V_xc", rank);
 
         // => Compute quadrature <= //
         auto qvals = dft_integrators::rks_quadrature_integrate(block, fworker, pworker);
@@ -1363,22 +1551,36 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
 
         // => Unpacking <= //
         auto V2p = V_local[rank]->pointer();
-        const auto& function_map = block->functions_local_to_global();
-        int nlocal = function_map.size();
+        scatter_V(V2p, function_map, rank);
 
-        for (int ml = 0; ml < nlocal; ml++) {
-            int mg = function_map[ml];
-            for (int nl = 0; nl < ml; nl++) {
-                int ng = function_map[nl];
-#pragma omp atomic update
-                Vp[mg][ng] += V2p[ml][nl];
-#pragma omp atomic update
-                Vp[ng][mg] += V2p[ml][nl];
+        if (incxc_) {
+            for (int i = 0; i < 5; i++) incxc_q_block_[Q][i] = qvals[i];
+            auto Vblock = std::make_shared<Matrix>("INCXC V Block", nlocal, nlocal);
+            double** Vblockp = Vblock->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                std::copy(V2p[ml], V2p[ml] + nlocal, Vblockp[ml]);
             }
-#pragma omp atomic update
-            Vp[mg][mg] += V2p[ml][ml];
+            incxc_V_block_[Q] = Vblock;
         }
-        parallel_timer_off("V_xc", rank);
+        section_off("V_xc", rank, t2, vxc_time);
+    }
+
+    // Reduce the per-thread contributions
+    for (size_t i = 0; i < num_threads_; i++) {
+        V_AO->add(V_AO_local[i]);
+    }
+
+    if (bench_) {
+        outfile->Printf("   => RV::compute_V Time Breakdown (summed over threads) <=\n\n");
+        outfile->Printf("    Properties:         %11.3f [s]\n",
+                        std::accumulate(properties_time.begin(), properties_time.end(), 0.0));
+        outfile->Printf("    Functional:         %11.3f [s]\n",
+                        std::accumulate(functional_time.begin(), functional_time.end(), 0.0));
+        outfile->Printf("    V Contraction:      %11.3f [s]\n", std::accumulate(vxc_time.begin(), vxc_time.end(), 0.0));
+        outfile->Printf("    Screened Blocks:    %11zu of %zu\n", nskipped, grid_->blocks().size());
+        outfile->Printf("    Reused Blocks:      %11zu of %zu\n\n", nreused, grid_->blocks().size());
+    } else if (incxc_ && print_ > 1) {
+        outfile->Printf("    Incremental XC: reused %zu of %zu blocks\n", nreused, grid_->blocks().size());
     }
 
     // Do we need VV10?
@@ -1475,7 +1677,7 @@ std::vector<SharedMatrix> RV::compute_fock_derivatives() {
     }
 
 // Traverse the blocks of points
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_)
     for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -1709,20 +1911,32 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         }
     }
 
+    // Perturbations are contracted in batches, with one GEMM per block for all of a batch
+    size_t nbatch = std::min(Dx_vec.size(), (size_t)vx_batch_max);
+    int ldb = nbatch * max_functions;
+
+    // Ground-state kernel per block, reused while D stays the same (e.g. over Davidson iterations)
+    int nkernel = (ansatz >= 1 ? 8 : 2);
+    if (vx_kernel_cache_.size() != grid_->blocks().size()) {
+        vx_kernel_cache_.clear();
+        vx_kernel_cache_.resize(grid_->blocks().size());
+    }
+
     // Per [R]ank quantities
-    std::vector<SharedMatrix> R_Vx_local, R_Dx_local;
+    std::vector<SharedMatrix> R_Vx_local, R_Dx_local, R_T;
     std::vector<std::shared_ptr<Vector>> R_rho_k, R_rho_k_x, R_rho_k_y, R_rho_k_z, R_gamma_k;
     for (size_t i = 0; i < num_threads_; i++) {
-        R_Vx_local.push_back(std::make_shared<Matrix>("Vx Temp", max_functions, max_functions));
-        R_Dx_local.push_back(std::make_shared<Matrix>("Dk Temp", max_functions, max_functions));
+        R_Vx_local.push_back(std::make_shared<Matrix>("Vx Temp", max_functions, ldb));
+        R_Dx_local.push_back(std::make_shared<Matrix>("Dk Temp", max_functions, ldb));
+        R_T.push_back(std::make_shared<Matrix>("T Temp", max_points, ldb));
 
-        R_rho_k.push_back(std::make_shared<Vector>("Rho K Temp", max_points));
+        R_rho_k.push_back(std::make_shared<Vector>("Rho K Temp", nbatch * max_points));
 
         if (ansatz >= 1) {
-            R_rho_k_x.push_back(std::make_shared<Vector>("RHO K X Temp", max_points));
-            R_rho_k_y.push_back(std::make_shared<Vector>("RHO K Y Temp", max_points));
-            R_rho_k_z.push_back(std::make_shared<Vector>("Rho K Z Temp", max_points));
-            R_gamma_k.push_back(std::make_shared<Vector>("Gamma K Temp", max_points));
+            R_rho_k_x.push_back(std::make_shared<Vector>("RHO K X Temp", nbatch * max_points));
+            R_rho_k_y.push_back(std::make_shared<Vector>("RHO K Y Temp", nbatch * max_points));
+            R_rho_k_z.push_back(std::make_shared<Vector>("Rho K Z Temp", nbatch * max_points));
+            R_gamma_k.push_back(std::make_shared<Vector>("Gamma K Temp", nbatch * max_points));
         }
 
         functional_workers_[i]->set_deriv(2);
@@ -1735,8 +1949,10 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         Vx_AO.push_back(std::make_shared<Matrix>("Vx AO Temp", nbf_, nbf_));
     }
 
+    bool use_block_mask = (block_rho_max_.size() == grid_->blocks().size());
+
 // Traverse the blocks of points
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_)
     for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -1750,7 +1966,7 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         double** Dx_localp = R_Dx_local[rank]->pointer();
 
         // => Compute blocks <= //
-        double** Tp = pworker->scratch()[0]->pointer();
+        double** Tp = R_T[rank]->pointer();
 
         std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
         int npoints = block->npoints();
@@ -1758,155 +1974,193 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
 
-        // Compute Rho, Phi, etc
-        parallel_timer_on("Properties", rank);
-        pworker->compute_points(block);
-        parallel_timer_off("Properties", rank);
+        // The kernel vanishes below DFT_V2_RHO_CUTOFF, so blocks that were below it at the
+        // last compute_V (same D) are skipped without computing anything
+        if (use_block_mask && block_rho_max_[Q] < v2_rho_cutoff_) continue;
+
+        // => Ground-state kernel <= //
+        // Layout: RHO_A, V_RHO_A_RHO_A[, RHO_AX, RHO_AY, RHO_AZ, V_GAMMA_AA, V_GAMMA_AA_GAMMA_AA, V_RHO_A_GAMMA_AA]
+        std::vector<double>& kernel = vx_kernel_cache_[Q];
+        if (kernel.size() == (size_t)nkernel * npoints) {
+            // Only the basis functions are needed
+            parallel_timer_on("Properties", rank);
+            pworker->compute_basis_values(block, false);
+            parallel_timer_off("Properties", rank);
+        } else {
+            // Compute Rho, Phi, etc
+            parallel_timer_on("Properties", rank);
+            pworker->compute_points(block, false);
+            parallel_timer_off("Properties", rank);
 
-        // Compute functional values
+            // Compute functional values
+            parallel_timer_on("Functional", rank);
+            std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+            parallel_timer_off("Functional", rank);
 
-        parallel_timer_on("Functional", rank);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
-        parallel_timer_off("Functional", rank);
+            std::vector<double*> sources = {pworker->point_value("RHO_A")->pointer(), vals["V_RHO_A_RHO_A"]->pointer()};
+            if (ansatz >= 1) {
+                sources.push_back(pworker->point_value("RHO_AX")->pointer());
+                sources.push_back(pworker->point_value("RHO_AY")->pointer());
+                sources.push_back(pworker->point_value("RHO_AZ")->pointer());
+                sources.push_back(vals["V_GAMMA_AA"]->pointer());
+                sources.push_back(vals["V_GAMMA_AA_GAMMA_AA"]->pointer());
+                sources.push_back(vals["V_RHO_A_GAMMA_AA"]->pointer());
+            }
+            kernel.resize((size_t)nkernel * npoints);
+            for (int k = 0; k < nkernel; k++) {
+                std::copy(sources[k], sources[k] + npoints, kernel.data() + (size_t)k * npoints);
+            }
+        }
 
         // => Grab quantities <= //
         // LDA
         double** phi = pworker->basis_value("PHI")->pointer();
-        double* rho_a = pworker->point_value("RHO_A")->pointer();
-        double* v2_rho2 = vals["V_RHO_A_RHO_A"]->pointer();
-        double* rho_k = R_rho_k[rank]->pointer();
+        double* rho_a = kernel.data();
+        double* v2_rho2 = kernel.data() + npoints;
         size_t coll_funcs = pworker->basis_value("PHI")->ncol();
 
         // GGA
-        double* rho_k_x;
-        double* rho_k_y;
-        double* rho_k_z;
-        double* gamma_k;
         double** phi_x;
         double** phi_y;
         double** phi_z;
         double* rho_x;
         double* rho_y;
         double* rho_z;
+        double* v_gamma;
+        double* v2_gamma_gamma;
+        double* v2_rho_gamma;
         if (ansatz >= 1) {
-            rho_k_x = R_rho_k_x[rank]->pointer();
-            rho_k_y = R_rho_k_y[rank]->pointer();
-            rho_k_z = R_rho_k_z[rank]->pointer();
-            gamma_k = R_gamma_k[rank]->pointer();
             phi_x = pworker->basis_value("PHI_X")->pointer();
             phi_y = pworker->basis_value("PHI_Y")->pointer();
             phi_z = pworker->basis_value("PHI_Z")->pointer();
-            rho_x = pworker->point_value("RHO_AX")->pointer();
-            rho_y = pworker->point_value("RHO_AY")->pointer();
-            rho_z = pworker->point_value("RHO_AZ")->pointer();
+            rho_x = kernel.data() + 2 * npoints;
+            rho_y = kernel.data() + 3 * npoints;
+            rho_z = kernel.data() + 4 * npoints;
+            v_gamma = kernel.data() + 5 * npoints;
+            v2_gamma_gamma = kernel.data() + 6 * npoints;
+            v2_rho_gamma = kernel.data() + 7 * npoints;
         }
 
         // Meta
         // Forget that!
 
-        // Loop over perturbation tensors
-        for (size_t dindex = 0; dindex < Dx_vec.size(); dindex++) {
-            double** Dxp = Dx_vec[dindex]->pointer();
+        // Loop over batches of perturbation tensors
+        for (size_t d0 = 0; d0 < Dx_vec.size(); d0 += nbatch) {
+            int nb = std::min(nbatch, Dx_vec.size() - d0);
 
             // => Build Rotated Densities <= //
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < nlocal; nl++) {
-                    int ng = function_map[nl];
-                    Dx_localp[ml][nl] = Dxp[mg][ng];
+            // Dx + Dx^T of each perturbation, side by side
+            for (int d = 0; d < nb; d++) {
+                double** Dxp = Dx_vec[d0 + d]->pointer();
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int mg = function_map[ml];
+                    for (int nl = 0; nl < nlocal; nl++) {
+                        int ng = function_map[nl];
+                        Dx_localp[ml][d * nlocal + nl] = Dxp[mg][ng] + Dxp[ng][mg];
+                    }
                 }
             }
 
             parallel_timer_on("Derivative Properties", rank);
             // Rho_a = D^k_xy phi_xa phi_ya
-            C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dx_localp[0], max_functions, 0.0, Tp[0],
-                    max_functions);
-            C_DGEMM('N', 'T', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dx_localp[0], max_functions, 1.0, Tp[0],
-                    max_functions);
-
-            for (int P = 0; P < npoints; P++) {
-                rho_k[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tp[P], 1);
-            }
+            C_DGEMM('N', 'N', npoints, nb * nlocal, nlocal, 1.0, phi[0], coll_funcs, Dx_localp[0], ldb, 0.0, Tp[0],
+                    ldb);
 
-            // Rho^d_k and gamma_k
-            if (ansatz >= 1) {
+            for (int d = 0; d < nb; d++) {
+                double* rho_k = R_rho_k[rank]->pointer() + d * max_points;
                 for (int P = 0; P < npoints; P++) {
-                    rho_k_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tp[P], 1);
-                    rho_k_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tp[P], 1);
-                    rho_k_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tp[P], 1);
-                    gamma_k[P] = rho_k_x[P] * rho_x[P];
-                    gamma_k[P] += rho_k_y[P] * rho_y[P];
-                    gamma_k[P] += rho_k_z[P] * rho_z[P];
-                    gamma_k[P] *= 2;
+                    rho_k[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tp[P] + d * nlocal, 1);
+                }
+
+                // Rho^d_k and gamma_k
+                if (ansatz >= 1) {
+                    double* rho_k_x = R_rho_k_x[rank]->pointer() + d * max_points;
+                    double* rho_k_y = R_rho_k_y[rank]->pointer() + d * max_points;
+                    double* rho_k_z = R_rho_k_z[rank]->pointer() + d * max_points;
+                    double* gamma_k = R_gamma_k[rank]->pointer() + d * max_points;
+                    for (int P = 0; P < npoints; P++) {
+                        rho_k_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tp[P] + d * nlocal, 1);
+                        rho_k_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tp[P] + d * nlocal, 1);
+                        rho_k_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tp[P] + d * nlocal, 1);
+                        gamma_k[P] = rho_k_x[P] * rho_x[P];
+                        gamma_k[P] += rho_k_y[P] * rho_y[P];
+                        gamma_k[P] += rho_k_z[P] * rho_z[P];
+                        gamma_k[P] *= 2;
+                    }
                 }
             }
             parallel_timer_off("Derivative Properties", rank);
 
-            // => LSDA contribution (symmetrized) <= //
             parallel_timer_on("V_XCd", rank);
-            // parallel_timer_on("LSDA", rank);
-            for (int P = 0; P < npoints; P++) {
-                std::fill(Tp[P], Tp[P] + nlocal, 0.0);
-                if (rho_a[P] < v2_rho_cutoff_) continue;
-                C_DAXPY(nlocal, 0.5 * v2_rho2[P] * w[P] * rho_k[P], phi[P], 1, Tp[P], 1);
-            }
-            // parallel_timer_off("LSDA", rank);
-
-            // => GGA contribution <= //
-            // parallel_timer_on("GGA", rank);
-            if (ansatz >= 1) {
-                double* v_gamma = vals["V_GAMMA_AA"]->pointer();
-                double* v2_gamma_gamma = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
-                double* v2_rho_gamma = vals["V_RHO_A_GAMMA_AA"]->pointer();
-                double tmp_val = 0.0, v2_val = 0.0;
+            for (int d = 0; d < nb; d++) {
+                double* rho_k = R_rho_k[rank]->pointer() + d * max_points;
 
+                // => LSDA contribution (symmetrized) <= //
                 for (int P = 0; P < npoints; P++) {
+                    double* TPd = Tp[P] + d * nlocal;
+                    std::fill(TPd, TPd + nlocal, 0.0);
                     if (rho_a[P] < v2_rho_cutoff_) continue;
+                    C_DAXPY(nlocal, 0.5 * v2_rho2[P] * w[P] * rho_k[P], phi[P], 1, TPd, 1);
+                }
 
-                    // V contributions
-                    C_DAXPY(nlocal, (0.5 * w[P] * v2_rho_gamma[P] * gamma_k[P]), phi[P], 1, Tp[P], 1);
+                // => GGA contribution <= //
+                if (ansatz >= 1) {
+                    double* rho_k_x = R_rho_k_x[rank]->pointer() + d * max_points;
+                    double* rho_k_y = R_rho_k_y[rank]->pointer() + d * max_points;
+                    double* rho_k_z = R_rho_k_z[rank]->pointer() + d * max_points;
+                    double* gamma_k = R_gamma_k[rank]->pointer() + d * max_points;
+                    double tmp_val = 0.0, v2_val = 0.0;
 
-                    // W contributions
-                    v2_val = (v2_rho_gamma[P] * rho_k[P] + v2_gamma_gamma[P] * gamma_k[P]);
+                    for (int P = 0; P < npoints; P++) {
+                        if (rho_a[P] < v2_rho_cutoff_) continue;
+                        double* TPd = Tp[P] + d * nlocal;
 
-                    tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_x[P] + v2_val * rho_x[P]);
-                    C_DAXPY(nlocal, tmp_val, phi_x[P], 1, Tp[P], 1);
+                        // V contributions
+                        C_DAXPY(nlocal, (0.5 * w[P] * v2_rho_gamma[P] * gamma_k[P]), phi[P], 1, TPd, 1);
 
-                    tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_y[P] + v2_val * rho_y[P]);
-                    C_DAXPY(nlocal, tmp_val, phi_y[P], 1, Tp[P], 1);
+                        // W contributions
+                        v2_val = (v2_rho_gamma[P] * rho_k[P] + v2_gamma_gamma[P] * gamma_k[P]);
 
-                    tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_z[P] + v2_val * rho_z[P]);
-                    C_DAXPY(nlocal, tmp_val, phi_z[P], 1, Tp[P], 1);
+                        tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_x[P] + v2_val * rho_x[P]);
+                        C_DAXPY(nlocal, tmp_val, phi_x[P], 1, TPd, 1);
+
+                        tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_y[P] + v2_val * rho_y[P]);
+                        C_DAXPY(nlocal, tmp_val, phi_y[P], 1, TPd, 1);
+
+                        tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_z[P] + v2_val * rho_z[P]);
+                        C_DAXPY(nlocal, tmp_val, phi_z[P], 1, TPd, 1);
+                    }
                 }
             }
-            // parallel_timer_off("GGA", rank);
 
             // Put it all together
-            // parallel_timer_on("LSDA", rank);
-            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tp[0], max_functions, 0.0, Vx_localp[0],
-                    max_functions);
-            // parallel_timer_off("LSDA", rank);
+            C_DGEMM('T', 'N', nlocal, nb * nlocal, npoints, 1.0, phi[0], coll_funcs, Tp[0], ldb, 0.0, Vx_localp[0],
+                    ldb);
 
-            // Symmetrization (V is *always* Hermitian)
-            for (int m = 0; m < nlocal; m++) {
-                for (int n = 0; n <= m; n++) {
-                    Vx_localp[m][n] = Vx_localp[n][m] = Vx_localp[m][n] + Vx_localp[n][m];
+            for (int d = 0; d < nb; d++) {
+                int c = d * nlocal;
+
+                // Symmetrization (V is *always* Hermitian)
+                for (int m = 0; m < nlocal; m++) {
+                    for (int n = 0; n <= m; n++) {
+                        Vx_localp[m][c + n] = Vx_localp[n][c + m] = Vx_localp[m][c + n] + Vx_localp[n][c + m];
+                    }
                 }
-            }
 
-            // => Unpacking <= //
-            double** Vxp = Vx_AO[dindex]->pointer();
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < ml; nl++) {
-                    int ng = function_map[nl];
+                // => Unpacking <= //
+                double** Vxp = Vx_AO[d0 + d]->pointer();
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int mg = function_map[ml];
+                    for (int nl = 0; nl < ml; nl++) {
+                        int ng = function_map[nl];
 #pragma omp atomic update
-                    Vxp[mg][ng] += Vx_localp[ml][nl];
+                        Vxp[mg][ng] += Vx_localp[ml][c + nl];
 #pragma omp atomic update
-                    Vxp[ng][mg] += Vx_localp[ml][nl];
-                }
+                        Vxp[ng][mg] += Vx_localp[ml][c + nl];
+                    }
 #pragma omp atomic update
-                Vxp[mg][mg] += Vx_localp[ml][ml];
+                    Vxp[mg][mg] += Vx_localp[ml][c + ml];
+                }
             }
             parallel_timer_off("V_XCd", rank);
         }
@@ -1971,7 +2225,7 @@ SharedMatrix RV::compute_gradient() {
     std::vector<double> rhoazq(num_threads_);
 
 // Traverse the blocks of points
-#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(compute_threads_)
     for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -1984,7 +2238,7 @@ SharedMatrix RV::compute_gradient() {
         auto pworker = point_workers_[rank];
 
         parallel_timer_on("Properties", rank);
-        pworker->compute_points(block);
+        pworker->compute_points(block, false);
         parallel_timer_off("Properties", rank);
 
         parallel_timer_on("Functional", rank);
@@ -2397,6 +2651,7 @@ void UV::initialize() {
         std::shared_ptr<PointFunctions> point_tmp = std::make_shared<UKSFunctions>(primary_, max_points, max_functions);
         point_tmp->set_ansatz(functional_->ansatz());
         point_tmp->set_cache_map(&cache_map_);
+        point_tmp->set_float_cache_map(&float_cache_map_);
         point_workers_.push_back(point_tmp);
     }
 }
@@ -2805,7 +3060,7 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
     }
 
 // Traverse the blocks of points
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_)
     for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -2832,7 +3087,7 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
 
         // Compute Rho, Phi, etc
         parallel_timer_on("Properties", rank);
-        pworker->compute_points(block);
+        pworker->compute_points(block, false);
         parallel_timer_off("Properties", rank);
 
         // Compute functional values
@@ -3268,7 +3523,7 @@ SharedMatrix UV::compute_gradient() {
 
         // Compute grid and functional
         parallel_timer_on("Properties", rank);
-        pworker->compute_points(block);
+        pworker->compute_points(block, false);
         parallel_timer_off("Properties", rank);
 
         parallel_timer_on("Functional", rank);
@@ -3529,4 +3784,355 @@ SharedMatrix UV::compute_gradient() {
 
     return G;
 }
+
+std::vector<SharedMatrix> UV::compute_fock_derivatives() {
+    timer_on("UV: Form Fx");
+
+    if (D_AO_.size() != 2) {
+        throw PSIEXCEPTION("DFT Hessian: UKS should have two D Matrices");
+    }
+    if (functional_->needs_vv10()) {
+        throw PSIEXCEPTION("DFT Hessian: UKS cannot compute VV10 Fx contribution.");
+    }
+    if (functional_->ansatz() >= 1) {
+        throw PSIEXCEPTION("DFT Hessian: UKS does not support GGAs or MGGAs yet");
+    }
+
+    // Alpha derivatives first, then beta
+    int natoms = primary_->molecule()->natom();
+    std::vector<SharedMatrix> Vx(6 * natoms);
+    for (int n = 0; n < 6 * natoms; ++n) {
+        Vx[n] = std::make_shared<Matrix>((n < 3 * natoms ? "Vax for Perturbation " : "Vbx for Perturbation ") +
+                                             std::to_string(n % (3 * natoms)),
+                                         nbf_, nbf_);
+    }
+
+    int rank = 0;
+    int old_point_deriv = point_workers_[0]->deriv();
+    int old_func_deriv = functional_->deriv();
+    int max_functions = grid_->max_functions();
+    int max_points = grid_->max_points();
+
+    for (size_t i = 0; i < num_threads_; i++) {
+        point_workers_[i]->set_pointers(D_AO_[0], D_AO_[1]);
+        point_workers_[i]->set_deriv(1);
+        functional_workers_[i]->set_deriv(2);
+        functional_workers_[i]->allocate();
+    }
+
+    // Per [R]ank quantities
+    std::vector<SharedMatrix> R_Vx_local;
+    std::vector<std::shared_ptr<Vector>> R_rho_d;
+    for (size_t i = 0; i < num_threads_; i++) {
+        R_Vx_local.push_back(std::make_shared<Matrix>("Vx Temp", max_functions, max_functions));
+        R_rho_d.push_back(std::make_shared<Vector>("rho_d Temp", 6 * max_points));
+    }
+
+// Traverse the blocks of points
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_)
+    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
+// Get thread info
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
+        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+        double** Vx_localp = R_Vx_local[rank]->pointer();
+        double** Tp[2] = {pworker->scratch()[0]->pointer(), pworker->scratch()[1]->pointer()};
+        double** Dp[2] = {pworker->D_scratch()[0]->pointer(), pworker->D_scratch()[1]->pointer()};
+
+        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
+        int npoints = block->npoints();
+        double* w = block->w();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+
+        parallel_timer_on("Properties", rank);
+        pworker->compute_points(block);
+        parallel_timer_off("Properties", rank);
+
+        parallel_timer_on("Functional", rank);
+        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+        parallel_timer_off("Functional", rank);
+
+        double** phi = pworker->basis_value("PHI")->pointer();
+        double** phi_d[3] = {pworker->basis_value("PHI_X")->pointer(), pworker->basis_value("PHI_Y")->pointer(),
+                             pworker->basis_value("PHI_Z")->pointer()};
+        double* rho_a = pworker->point_value("RHO_A")->pointer();
+        double* rho_b = pworker->point_value("RHO_B")->pointer();
+        double* v_rho[2] = {vals["V_RHO_A"]->pointer(), vals["V_RHO_B"]->pointer()};
+        double* v2_rho2[2][2] = {{vals["V_RHO_A_RHO_A"]->pointer(), vals["V_RHO_A_RHO_B"]->pointer()},
+                                 {vals["V_RHO_A_RHO_B"]->pointer(), vals["V_RHO_B_RHO_B"]->pointer()}};
+        for (int P = 0; P < npoints; P++) {
+            if (std::fabs(rho_a[P] + rho_b[P]) < v2_rho_cutoff_) {
+                for (int s = 0; s < 2; s++) {
+                    v_rho[s][P] = 0.0;
+                    v2_rho2[s][0][P] = 0.0;
+                    v2_rho2[s][1][P] = 0.0;
+                }
+            }
+        }
+        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
+        // rho_d[3 * s + d][P]: derivative of rho_s with respect to the atom in direction d, over -2
+        double* rho_d = R_rho_d[rank]->pointer();
+
+        for (int atom = 0; atom < natoms; ++atom) {
+            // First and last basis functions of this block on this atom
+            auto first_func_iter = std::find_if(function_map.begin(), function_map.end(),
+                                                [&](int i) { return primary_->function_to_center(i) == atom; });
+            if (first_func_iter == function_map.end()) continue;
+            auto last_func_riter = std::find_if(function_map.rbegin(), function_map.rend(),
+                                                [&](int i) { return primary_->function_to_center(i) == atom; });
+            auto last_func_iter = last_func_riter.base();
+            int first_func_addr = std::distance(function_map.begin(), first_func_iter);
+            int nfuncs = std::distance(first_func_iter, last_func_iter);
+
+            // T_s = ɸ D_s over the functions on the atom, ρ_s,d = T_s ɸ_d^t
+            for (int s = 0; s < 2; s++) {
+                C_DGEMM('N', 'N', npoints, nfuncs, nlocal, 1.0, phi[0], coll_funcs, &Dp[s][0][first_func_addr],
+                        max_functions, 0.0, Tp[s][0], max_functions);
+                for (int d = 0; d < 3; d++) {
+                    for (int P = 0; P < npoints; P++) {
+                        rho_d[(3 * s + d) * max_points + P] =
+                            C_DDOT(nfuncs, Tp[s][P], 1, &phi_d[d][P][first_func_addr], 1);
+                    }
+                }
+            }
+
+            for (int d = 0; d < 3; d++) {
+                for (int s = 0; s < 2; s++) {
+                    //        /  |   ∂^2 F            \       /    | ∂ F
+                    // T <- | ɸ | Σ  ------- ρ_t,d  | + | ɸ_d | ----
+                    //        \  |  t ∂ρ_s ∂ρ_t        /       \    | ∂ρ_s
+                    double** Up = Tp[0];
+                    for (int P = 0; P < npoints; P++) {
+                        double f = v2_rho2[s][0][P] * rho_d[d * max_points + P] +
+                                   v2_rho2[s][1][P] * rho_d[(3 + d) * max_points + P];
+                        std::fill(Up[P], Up[P] + nlocal, 0.0);
+                        C_DAXPY(nlocal, -0.5 * f * w[P], phi[P], 1, Up[P], 1);
+                        C_DAXPY(nfuncs, -0.5 * v_rho[s][P] * w[P], &phi_d[d][P][first_func_addr], 1,
+                                &Up[P][first_func_addr], 1);
+                    }
+                    C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Up[0], max_functions, phi[0], coll_funcs, 0.0,
+                            Vx_localp[0], max_functions);
+
+                    double** Vxp = Vx[3 * natoms * s + 3 * atom + d]->pointer();
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        int mg = function_map[ml];
+                        for (int nl = 0; nl < nlocal; nl++) {
+                            int ng = function_map[nl];
+                            double result = Vx_localp[ml][nl] + Vx_localp[nl][ml];
+#pragma omp atomic update
+                            Vxp[mg][ng] += result;
+#pragma omp atomic update
+                            Vxp[ng][mg] += result;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Reset the workers
+    for (size_t i = 0; i < num_threads_; i++) {
+        point_workers_[i]->set_deriv(old_point_deriv);
+        functional_workers_[i]->set_deriv(old_func_deriv);
+        functional_workers_[i]->allocate();
+    }
+    timer_off("UV: Form Fx");
+    return Vx;
+}
+
+SharedMatrix UV::compute_hessian() {
+    if (functional_->is_gga() || functional_->is_meta())
+        throw PSIEXCEPTION("Hessians for GGA and meta GGA functionals are not yet implemented.");
+
+    if ((D_AO_.size() != 2)) throw PSIEXCEPTION("V: UKS should have two D Matrices");
+
+    if (functional_->needs_vv10()) {
+        throw PSIEXCEPTION("V: UKS cannot compute VV10 Hessian contribution.");
+    }
+
+    // Build the target Hessian Matrix
+    int natom = primary_->molecule()->natom();
+    auto H = std::make_shared<Matrix>("XC Hessian", 3 * natom, 3 * natom);
+
+    int rank = 0;
+    int old_deriv = point_workers_[0]->deriv();
+    int old_func_deriv = functional_->deriv();
+    int max_functions = grid_->max_functions();
+    int max_points = grid_->max_points();
+
+    functional_->set_deriv(2);
+    for (size_t i = 0; i < num_threads_; i++) {
+        point_workers_[i]->set_pointers(D_AO_[0], D_AO_[1]);
+        point_workers_[i]->set_deriv(2);
+        functional_workers_[i]->set_deriv(2);
+        functional_workers_[i]->allocate();
+    }
+
+    // Per thread Hessians and scratch: U, L (points x functions), R_d, W and the nine
+    // (d, d') blocks of the local Hessian (functions x functions)
+    std::vector<SharedMatrix> H_local;
+    std::vector<std::vector<SharedMatrix>> scratch(num_threads_);
+    for (size_t i = 0; i < num_threads_; i++) {
+        H_local.push_back(std::make_shared<Matrix>("XC Hessian Temp", 3 * natom, 3 * natom));
+        for (int k = 0; k < 5; k++) scratch[i].push_back(std::make_shared<Matrix>("PF", max_points, max_functions));
+        for (int k = 0; k < 10; k++) scratch[i].push_back(std::make_shared<Matrix>("FF", max_functions, max_functions));
+    }
+
+    const std::vector<std::shared_ptr<BlockOPoints>>& blocks = grid_->blocks();
+
+#pragma omp parallel for private(rank) schedule(guided) num_threads(compute_threads_)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
+        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+        double** Hp = H_local[rank]->pointer();
+        double** Tp[2] = {pworker->scratch()[0]->pointer(), pworker->scratch()[1]->pointer()};
+        double** Dp[2] = {pworker->D_scratch()[0]->pointer(), pworker->D_scratch()[1]->pointer()};
+        double** Up = scratch[rank][0]->pointer();
+        double** Lp = scratch[rank][1]->pointer();
+        double** Rp[3] = {scratch[rank][2]->pointer(), scratch[rank][3]->pointer(), scratch[rank][4]->pointer()};
+        double** Wp = scratch[rank][5]->pointer();
+        double** HBp[9];
+        for (int k = 0; k < 9; k++) HBp[k] = scratch[rank][6 + k]->pointer();
+
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        int npoints = block->npoints();
+        double* w = block->w();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+
+        pworker->compute_points(block);
+        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+
+        double** phi = pworker->basis_value("PHI")->pointer();
+        double** phi_d[3] = {pworker->basis_value("PHI_X")->pointer(), pworker->basis_value("PHI_Y")->pointer(),
+                             pworker->basis_value("PHI_Z")->pointer()};
+        double** phi_xx = pworker->basis_value("PHI_XX")->pointer();
+        double** phi_xy = pworker->basis_value("PHI_XY")->pointer();
+        double** phi_xz = pworker->basis_value("PHI_XZ")->pointer();
+        double** phi_yy = pworker->basis_value("PHI_YY")->pointer();
+        double** phi_yz = pworker->basis_value("PHI_YZ")->pointer();
+        double** phi_zz = pworker->basis_value("PHI_ZZ")->pointer();
+        double** phi_dd[3][3] = {{phi_xx, phi_xy, phi_xz}, {phi_xy, phi_yy, phi_yz}, {phi_xz, phi_yz, phi_zz}};
+        double* rho_a = pworker->point_value("RHO_A")->pointer();
+        double* rho_b = pworker->point_value("RHO_B")->pointer();
+        double* v_rho[2] = {vals["V_RHO_A"]->pointer(), vals["V_RHO_B"]->pointer()};
+        double* v2_rho2[2][2] = {{vals["V_RHO_A_RHO_A"]->pointer(), vals["V_RHO_A_RHO_B"]->pointer()},
+                                 {vals["V_RHO_A_RHO_B"]->pointer(), vals["V_RHO_B_RHO_B"]->pointer()}};
+        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
+
+        // Points below the density cutoff do not contribute
+        std::vector<double> wc(w, w + npoints);
+        for (int P = 0; P < npoints; P++) {
+            if (std::fabs(rho_a[P] + rho_b[P]) < v2_rho_cutoff_) wc[P] = 0.0;
+        }
+
+        // T_s = ɸ D_s
+        for (int s = 0; s < 2; s++) {
+            C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dp[s][0], max_functions, 0.0,
+                    Tp[s][0], max_functions);
+        }
+        for (int k = 0; k < 9; k++) {
+            for (int ml = 0; ml < nlocal; ml++) std::fill(HBp[k][ml], HBp[k][ml] + nlocal, 0.0);
+        }
+
+        /*
+         *                             mn  ∂ F
+         *  H_mn <- 2 Σ_s D^s_ab ɸ_a ɸ_b   ----
+         *                                 ∂ρ_s
+         */
+        for (int P = 0; P < npoints; P++) {
+            for (int ml = 0; ml < nlocal; ml++) {
+                Up[P][ml] = 2.0 * wc[P] * (v_rho[0][P] * Tp[0][P][ml] + v_rho[1][P] * Tp[1][P][ml]);
+            }
+        }
+        for (int ml = 0; ml < nlocal; ml++) {
+            int A = primary_->function_to_center(function_map[ml]);
+            for (int d = 0; d < 3; d++) {
+                for (int d2 = 0; d2 < 3; d2++) {
+                    Hp[3 * A + d][3 * A + d2] +=
+                        C_DDOT(npoints, &Up[0][ml], max_functions, &phi_dd[d][d2][0][ml], coll_funcs);
+                }
+            }
+        }
+
+        /*
+         *                                m                n   ∂^2 F
+         *  H_mn <- 4 Σ_st D^s_ab ɸ_a ɸ_b  D^t_cd ɸ_c ɸ_d   ---------
+         *                                                     ∂ρ_s ∂ρ_t
+         */
+        for (int t = 0; t < 2; t++) {
+            for (int d2 = 0; d2 < 3; d2++) {
+                for (int P = 0; P < npoints; P++) {
+                    for (int ml = 0; ml < nlocal; ml++) Rp[d2][P][ml] = Tp[t][P][ml] * phi_d[d2][P][ml];
+                }
+            }
+            for (int P = 0; P < npoints; P++) {
+                double fa = 4.0 * wc[P] * v2_rho2[0][t][P];
+                double fb = 4.0 * wc[P] * v2_rho2[1][t][P];
+                for (int ml = 0; ml < nlocal; ml++) Up[P][ml] = fa * Tp[0][P][ml] + fb * Tp[1][P][ml];
+            }
+            for (int d = 0; d < 3; d++) {
+                for (int P = 0; P < npoints; P++) {
+                    for (int ml = 0; ml < nlocal; ml++) Lp[P][ml] = Up[P][ml] * phi_d[d][P][ml];
+                }
+                for (int d2 = 0; d2 < 3; d2++) {
+                    C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Lp[0], max_functions, Rp[d2][0], max_functions,
+                            1.0, HBp[3 * d + d2][0], max_functions);
+                }
+            }
+        }
+
+        /*
+         *                          m    n  ∂ F
+         *  H_mn <- 2 Σ_s D^s_ab ɸ_a  ɸ_b   ----
+         *                                  ∂ρ_s
+         */
+        for (int s = 0; s < 2; s++) {
+            for (int d2 = 0; d2 < 3; d2++) {
+                for (int P = 0; P < npoints; P++) {
+                    double f = 2.0 * wc[P] * v_rho[s][P];
+                    for (int ml = 0; ml < nlocal; ml++) Up[P][ml] = f * phi_d[d2][P][ml];
+                }
+                for (int d = 0; d < 3; d++) {
+                    C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_d[d][0], coll_funcs, Up[0], max_functions,
+                            0.0, Wp[0], max_functions);
+                    double** HB = HBp[3 * d + d2];
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        for (int nl = 0; nl < nlocal; nl++) HB[ml][nl] += Wp[ml][nl] * Dp[s][ml][nl];
+                    }
+                }
+            }
+        }
+
+        // Accumulate contributions to the full Hessian: N.B. these terms are not symmetric!
+        for (int ml = 0; ml < nlocal; ml++) {
+            int A = primary_->function_to_center(function_map[ml]);
+            for (int nl = 0; nl < nlocal; nl++) {
+                int B = primary_->function_to_center(function_map[nl]);
+                for (int d = 0; d < 3; d++) {
+                    for (int d2 = 0; d2 < 3; d2++) Hp[3 * A + d][3 * B + d2] += HBp[3 * d + d2][ml][nl];
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < num_threads_; i++) {
+        H->add(H_local[i]);
+        point_workers_[i]->set_deriv(old_deriv);
+        functional_workers_[i]->set_deriv(old_func_deriv);
+        functional_workers_[i]->allocate();
+    }
+    functional_->set_deriv(old_func_deriv);
+
+    H->hermitivitize();
+    return H;
+}
 }  // namespace psi
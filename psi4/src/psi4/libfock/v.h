@@ -30,6 +30,8 @@
 #define LIBFOCK_DFT_H
 #include "psi4/libmints/typedefs.h"
 #include "psi4/pragma.h"
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -58,8 +60,12 @@ class PSI_API VBase {
     int debug_;
     /// Print flag
     int print_;
+    /// Benchmark flag, prints the V build time breakdown if > 0
+    int bench_;
     /// Number of threads
     int num_threads_;
+    /// Number of threads the integration loops run on, at most num_threads_
+    int compute_threads_;
     /// Number of basis functions;
     int nbf_;
     /// Rho threshold for the second derivative;
@@ -82,7 +88,33 @@ class PSI_API VBase {
     std::map<std::string, double> quad_values_;
     // Caches collocation grids
     std::unordered_map<size_t, std::map<std::string, SharedMatrix>> cache_map_;
+    // Single-precision collocation cache, used instead of cache_map_ if DFT_COLLOCATION_CACHE_FLOAT
+    std::unordered_map<size_t, std::map<std::string, std::vector<float>>> float_cache_map_;
     int cache_map_deriv_;
+    /// Store the collocation cache in single precision?
+    bool cache_float_;
+
+    /// Largest density on each grid block at the last compute_V, empty after set_D
+    std::vector<double> block_rho_max_;
+    /// Density below which every part of the functional vanishes, 0.0 if there is none (e.g. GRAC)
+    double xc_density_cutoff();
+
+    /// Build the XC potential incrementally (DFT_INCXC)?
+    bool incxc_;
+    /// Largest local density change for which a block contribution is reused
+    double incxc_tol_;
+    /// Per block local density each stored contribution was computed with
+    std::vector<SharedMatrix> incxc_D_block_;
+    /// Per block local V contribution, nullptr for screened blocks
+    std::vector<SharedMatrix> incxc_V_block_;
+    /// Per block quadrature values (functional, rho, rho * r) and largest density
+    std::vector<std::array<double, 6>> incxc_q_block_;
+
+    /// Contract densities and potentials in single precision (DFT_MIXED_PRECISION, RKS only)?
+    bool mixed_precision_;
+
+    /// Per block ground-state density and kernel of RV::compute_Vx, empty after set_D
+    std::vector<std::vector<double>> vx_kernel_cache_;
 
     /// AO2USO matrix (if not C1)
     SharedMatrix AO2USO_;
@@ -122,7 +154,21 @@ class PSI_API VBase {
 
     // Creates a collocation cache map based on stride
     void build_collocation_cache(size_t memory);
-    void clear_collocation_cache() { cache_map_.clear(); }
+    bool mixed_precision() const { return mixed_precision_; }
+    /// Switch the single-precision contractions on or off
+    void set_mixed_precision(bool mixed_precision);
+    /// Doubles the incremental XC build stores for the current grid (DFT_INCXC), 0 without it
+    virtual size_t incxc_size() { return 0; }
+    /// Drop the stored block contributions of the incremental XC build
+    void clear_incxc() {
+        incxc_D_block_.clear();
+        incxc_V_block_.clear();
+        incxc_q_block_.clear();
+    }
+    void clear_collocation_cache() {
+        cache_map_.clear();
+        float_cache_map_.clear();
+    }
 
     // Set the D matrix, get it back if needed
     void set_D(std::vector<SharedMatrix> Dvec);
@@ -140,6 +186,9 @@ class PSI_API VBase {
 
     void set_print(int print) { print_ = print; }
     void set_debug(int debug) { debug_ = debug; }
+    /// Run the integration loops on fewer threads than the per-thread workers were built for
+    void set_compute_threads(int nthread) { compute_threads_ = std::max(1, std::min(nthread, num_threads_)); }
+    int compute_threads() const { return compute_threads_; }
 
     virtual void initialize();
     virtual void finalize();
@@ -175,6 +224,7 @@ class RV : public VBase {
     std::vector<SharedMatrix> compute_fock_derivatives() override;
     SharedMatrix compute_gradient() override;
     SharedMatrix compute_hessian() override;
+    size_t incxc_size() override;
 
     void print_header() const override;
 };
@@ -190,7 +240,10 @@ class UV : public VBase {
 
     void compute_V(std::vector<SharedMatrix> ret) override;
     void compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret) override;
+    /// The 3N alpha derivative matrices, then the 3N beta ones (LSDA only)
+    std::vector<SharedMatrix> compute_fock_derivatives() override;
     SharedMatrix compute_gradient() override;
+    SharedMatrix compute_hessian() override;
 
     void print_header() const override;
 };
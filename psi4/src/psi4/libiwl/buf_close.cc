@@ -44,8 +44,12 @@ IWL::~IWL() { close(); }
 
 void IWL::close() {
     if (psio_->open_check(itap_)) psio_->close(itap_, keep_);
-    if (labels_) delete[](labels_);
-    if (values_) delete[](values_);
+    if (block_) delete[](block_);
+    if (ahead_) delete[](ahead_);
+    block_ = nullptr;
+    ahead_ = nullptr;
+    ahead_count_ = 0;
+    ahead_idx_ = 0;
     labels_ = nullptr;
     values_ = nullptr;
 }
@@ -61,7 +65,9 @@ void IWL::close() {
 */
 void PSI_API iwl_buf_close(struct iwlbuf *Buf, int keep) {
     psio_close(Buf->itap, keep ? 1 : 0);
-    free(Buf->labels);
-    free(Buf->values);
+    free(Buf->block);
+    Buf->block = nullptr;
+    Buf->labels = nullptr;
+    Buf->values = nullptr;
 }
 }
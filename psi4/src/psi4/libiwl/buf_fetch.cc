@@ -31,20 +31,74 @@
   \ingroup IWL
 */
 #include <cstdio>
+#include <cstring>
 #include "psi4/libpsio/psio.h"
 #include "iwl.h"
 #include "iwl.hpp"
 
 namespace psi {
 
+namespace {
+
+/* Bytes of IWL buffer data stored at or beyond the entry-relative address pos */
+size_t iwl_bytes_left(PSIO *psio, int itap, psio_address pos) {
+    psio_tocentry *entry = psio->tocscan(itap, IWL_KEY_BUF);
+    if (entry == nullptr) return 0;
+
+    size_t tocentry_size = sizeof(psio_tocentry) - 2 * sizeof(psio_tocentry *);
+    psio_address here = psio_get_global_address(psio_get_address(entry->sadd, tocentry_size), pos);
+    size_t end_byte = entry->eadd.page * PSIO_PAGELEN + entry->eadd.offset;
+    size_t here_byte = here.page * PSIO_PAGELEN + here.offset;
+
+    return (end_byte > here_byte) ? end_byte - here_byte : 0;
+}
+
+}  // namespace
+
+/*
+** Buffers are read IWL_BUFS_PER_READ at a time into ahead_ and handed
+** out one by one.  bufpos_ still advances one buffer per fetch(), so
+** put() and seek() see the same file position as before.
+*/
 void IWL::fetch() {
-    psio_->read(itap_, IWL_KEY_BUF, (char *)&(lastbuf_), sizeof(int), bufpos_, &bufpos_);
-    psio_->read(itap_, IWL_KEY_BUF, (char *)&(inbuf_), sizeof(int), bufpos_, &bufpos_);
-    psio_->read(itap_, IWL_KEY_BUF, (char *)labels_, ints_per_buf_ * 4 * sizeof(Label), bufpos_, &bufpos_);
-    psio_->read(itap_, IWL_KEY_BUF, (char *)values_, ints_per_buf_ * sizeof(Value), bufpos_, &bufpos_);
+    if (ahead_idx_ == ahead_count_) {
+        size_t nbuf = iwl_bytes_left(psio_, itap_, bufpos_) / bufszc_;
+        if (nbuf > IWL_BUFS_PER_READ) nbuf = IWL_BUFS_PER_READ;
+        if (nbuf < 1) nbuf = 1; /* let libpsio report a read past the end */
+
+        psio_address next;
+        if (nbuf == 1) {
+            psio_->read(itap_, IWL_KEY_BUF, block_, bufszc_, bufpos_, &bufpos_);
+            ahead_count_ = ahead_idx_ = 0;
+            std::memcpy(&lastbuf_, block_, sizeof(int));
+            std::memcpy(&inbuf_, block_ + sizeof(int), sizeof(int));
+            idx_ = 0;
+            return;
+        }
+
+        if (ahead_ == nullptr) ahead_ = new char[IWL_BUFS_PER_READ * (size_t)bufszc_];
+        psio_->read(itap_, IWL_KEY_BUF, ahead_, nbuf * bufszc_, bufpos_, &next);
+        ahead_count_ = nbuf;
+        ahead_idx_ = 0;
+    }
+
+    std::memcpy(block_, ahead_ + ahead_idx_ * (size_t)bufszc_, bufszc_);
+    ahead_idx_++;
+    bufpos_ = psio_get_address(bufpos_, bufszc_);
+
+    std::memcpy(&lastbuf_, block_, sizeof(int));
+    std::memcpy(&inbuf_, block_ + sizeof(int), sizeof(int));
     idx_ = 0;
 }
 
+size_t IWL::nbuffers() { return iwl_bytes_left(psio_, itap_, PSIO_ZERO) / bufszc_; }
+
+void IWL::seek(size_t buf) {
+    bufpos_ = psio_get_address(PSIO_ZERO, buf * bufszc_);
+    ahead_count_ = ahead_idx_ = 0;
+    fetch();
+}
+
 /*!
 ** iwl_buf_fetch()
 **
@@ -53,12 +107,9 @@ void IWL::fetch() {
 ** \ingroup IWL
 */
 void PSI_API iwl_buf_fetch(struct iwlbuf *Buf) {
-    psio_read(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->lastbuf), sizeof(int), Buf->bufpos, &Buf->bufpos);
-    psio_read(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->inbuf), sizeof(int), Buf->bufpos, &Buf->bufpos);
-    psio_read(Buf->itap, IWL_KEY_BUF, (char *)Buf->labels, Buf->ints_per_buf * 4 * sizeof(Label), Buf->bufpos,
-              &Buf->bufpos);
-    psio_read(Buf->itap, IWL_KEY_BUF, (char *)Buf->values, Buf->ints_per_buf * sizeof(Value), Buf->bufpos,
-              &Buf->bufpos);
+    psio_read(Buf->itap, IWL_KEY_BUF, Buf->block, Buf->bufszc, Buf->bufpos, &Buf->bufpos);
+    std::memcpy(&(Buf->lastbuf), Buf->block, sizeof(int));
+    std::memcpy(&(Buf->inbuf), Buf->block + sizeof(int), sizeof(int));
     Buf->idx = 0;
 }
 }
@@ -51,6 +51,12 @@ IWL::IWL() {
     lastbuf_ = 0;
     inbuf_ = 0;
     idx_ = 0;
+    labels_ = nullptr;
+    values_ = nullptr;
+    block_ = nullptr;
+    ahead_ = nullptr;
+    ahead_count_ = 0;
+    ahead_idx_ = 0;
 }
 
 IWL::IWL(PSIO *psio, int it, double coff, int oldfile, int readflag) : keep_(true) {
@@ -70,11 +76,13 @@ void IWL::init(PSIO *psio, int it, double coff, int oldfile, int readflag) {
     inbuf_ = 0;
     idx_ = 0;
 
-    /*! make room in the buffer */
-    // labels_ = (Label *) malloc (4 * ints_per_buf_ * sizeof(Label));
-    // values_ = (Value *) malloc (ints_per_buf_ * sizeof(Value));
-    labels_ = new Label[4 * ints_per_buf_];
-    values_ = new Value[ints_per_buf_];
+    /*! make room in the buffer, laid out as it is on disk so put/fetch move it in one piece */
+    block_ = new char[bufszc_]();
+    labels_ = (Label *)(block_ + 2 * sizeof(int));
+    values_ = (Value *)(block_ + 2 * sizeof(int) + ints_per_buf_ * 4 * sizeof(Label));
+    ahead_ = nullptr;
+    ahead_count_ = 0;
+    ahead_idx_ = 0;
 
     /*! open the output file */
     /*! Note that we assume that if oldfile isn't set, we O_CREAT the file */
@@ -118,9 +126,10 @@ void PSI_API iwl_buf_init(struct iwlbuf *Buf, int itape, double cutoff, int oldf
     Buf->inbuf = 0;
     Buf->idx = 0;
 
-    /*! make room in the buffer */
-    Buf->labels = (Label *)malloc(4 * Buf->ints_per_buf * sizeof(Label));
-    Buf->values = (Value *)malloc(Buf->ints_per_buf * sizeof(Value));
+    /*! make room in the buffer, laid out as it is on disk */
+    Buf->block = (char *)calloc(Buf->bufszc, 1);
+    Buf->labels = (Label *)(Buf->block + 2 * sizeof(int));
+    Buf->values = (Value *)(Buf->block + 2 * sizeof(int) + Buf->ints_per_buf * 4 * sizeof(Label));
 
     /*! open the output file */
     /*! Note that we assume that if oldfile isn't set, we O_CREAT the file */
@@ -31,6 +31,7 @@
   \ingroup IWL
 */
 #include <cstdio>
+#include <cstring>
 #include "psi4/libpsio/psio.h"
 #include "iwl.h"
 #include "iwl.hpp"
@@ -38,10 +39,12 @@
 namespace psi {
 
 void IWL::put() {
-    psio_->write(itap_, IWL_KEY_BUF, (char *)&(lastbuf_), sizeof(int), bufpos_, &(bufpos_));
-    psio_->write(itap_, IWL_KEY_BUF, (char *)&(inbuf_), sizeof(int), bufpos_, &(bufpos_));
-    psio_->write(itap_, IWL_KEY_BUF, (char *)labels_, ints_per_buf_ * 4 * sizeof(Label), bufpos_, &(bufpos_));
-    psio_->write(itap_, IWL_KEY_BUF, (char *)values_, ints_per_buf_ * sizeof(Value), bufpos_, &(bufpos_));
+    /* labels_ and values_ already sit in block_; add the header and write it in one go */
+    std::memcpy(block_, &lastbuf_, sizeof(int));
+    std::memcpy(block_ + sizeof(int), &inbuf_, sizeof(int));
+    psio_->write(itap_, IWL_KEY_BUF, block_, bufszc_, bufpos_, &(bufpos_));
+    /* anything read ahead past this point is stale now */
+    ahead_count_ = ahead_idx_ = 0;
 }
 
 /*!
@@ -52,11 +55,8 @@ void IWL::put() {
 ** \ingroup IWL
 */
 void iwl_buf_put(struct iwlbuf *Buf) {
-    psio_write(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->lastbuf), sizeof(int), Buf->bufpos, &(Buf->bufpos));
-    psio_write(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->inbuf), sizeof(int), Buf->bufpos, &(Buf->bufpos));
-    psio_write(Buf->itap, IWL_KEY_BUF, (char *)Buf->labels, Buf->ints_per_buf * 4 * sizeof(Label), Buf->bufpos,
-               &(Buf->bufpos));
-    psio_write(Buf->itap, IWL_KEY_BUF, (char *)Buf->values, Buf->ints_per_buf * sizeof(Value), Buf->bufpos,
-               &(Buf->bufpos));
+    std::memcpy(Buf->block, &(Buf->lastbuf), sizeof(int));
+    std::memcpy(Buf->block + sizeof(int), &(Buf->inbuf), sizeof(int));
+    psio_write(Buf->itap, IWL_KEY_BUF, Buf->block, Buf->bufszc, Buf->bufpos, &(Buf->bufpos));
 }
 }
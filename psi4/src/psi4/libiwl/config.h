@@ -38,6 +38,9 @@ typedef double Value;
 #define IWL_KEY_ONEL "IWL One-electron matrix elements"
 
 #define IWL_INTS_PER_BUF 2980
+
+/* Number of buffers IWL::fetch() pulls in with a single read */
+#define IWL_BUFS_PER_READ 16
 }
 
 #endif
@@ -55,6 +55,7 @@ struct iwlbuf {
     int idx;             /* index of integral in current buffer */
     Label *labels;       /* pointer to where integral values begin */
     Value *values;       /* integral values */
+    char *block;         /* on-disk image of the buffer; labels and values point into it */
 };
 
 void PSI_API iwl_buf_fetch(struct iwlbuf *Buf);
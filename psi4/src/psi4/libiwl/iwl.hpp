@@ -46,6 +46,10 @@ class PSI_API IWL {
     int idx_;             /* index of integral in current buffer */
     Label *labels_;       /* pointer to where integral values begin */
     Value *values_;       /* integral values */
+    char *block_;         /* on-disk image of the buffer; labels_ and values_ point into it */
+    char *ahead_;         /* buffers read ahead by fetch() */
+    int ahead_count_;     /* how many buffers in ahead_? */
+    int ahead_idx_;       /* next buffer in ahead_ to hand out */
     /*! Instance of libpsio to use */
     PSIO *psio_;
     /*! Flag indicating whether to keep the IWL file or not */
@@ -77,6 +81,11 @@ class PSI_API IWL {
     void fetch();
     void put();
 
+    /// Number of complete buffers currently stored in the file
+    size_t nbuffers();
+    /// Position the file at buffer \p buf and fetch it
+    void seek(size_t buf);
+
     static void read_one(PSIO *psio, int itap, const char *label, double *ints, int ntri, int erase, int printflg,
                          std::string OutFileRMR);
     static void write_one(PSIO *psio, int itap, const char *label, int ntri, double *onel_ints);
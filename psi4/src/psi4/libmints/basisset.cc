@@ -50,6 +50,7 @@
 #include "pointgrp.h"
 #include "wavefunction.h"
 #include "coordentry.h"
+#include "shellpair.h"
 #include "psi4/libpsi4util/process.h"
 
 #include <memory>
@@ -60,6 +61,7 @@
 #include <cmath>
 #include <map>
 #include <list>
+#include <mutex>
 
 using namespace psi;
 
@@ -614,6 +616,20 @@ const GaussianShell &BasisSet::ecp_shell(int si) const {
     return ecp_shells_[si];
 }
 
+std::shared_ptr<ShellPairStore> BasisSet::shell_pair_store(std::shared_ptr<BasisSet> other, double ln_prec) const {
+    static std::mutex store_mutex;
+    std::lock_guard<std::mutex> lock(store_mutex);
+
+    auto key = std::make_pair(static_cast<const BasisSet *>(other.get()), ln_prec);
+    auto it = shell_pair_stores_.find(key);
+    // A partner that went away may have left its address to a new basis set
+    if (it != shell_pair_stores_.end() && it->second->partner() == other) return it->second;
+
+    auto store = std::make_shared<ShellPairStore>(this, other, ln_prec);
+    shell_pair_stores_[key] = store;
+    return store;
+}
+
 const libint2::Shell &BasisSet::l2_shell(int si) const {
     if (si < 0 || si > nshell()) {
         outfile->Printf("Libint2 BasisSet::shell(si = %d), requested a shell out-of-bound.\n", si);
@@ -58,6 +58,7 @@ class GaussianShell;
 class BasisSetParser;
 class SOBasisSet;
 class IntegralFactory;
+class ShellPairStore;
 
 /*! \ingroup MINTS */
 
@@ -166,6 +167,9 @@ class PSI_API BasisSet {
     /// The flattened list of Cartesian coordinates for each atom
     std::vector<double> xyz_;
 
+    /// Libint2 shell-pair data with partner basis sets, keyed on the partner and the log of the precision
+    mutable std::map<std::pair<const BasisSet*, double>, std::shared_ptr<ShellPairStore>> shell_pair_stores_;
+
    public:
     BasisSet();
 
@@ -284,6 +288,12 @@ class PSI_API BasisSet {
      */
     const libint2::Shell &l2_shell(int si) const;
 
+    /** The store of Libint2 shell-pair data between this (bra) basis and other, built to precision
+     *  exp(ln_prec). The store is created on first use and shared read-only by every integral object
+     *  on this pair of basis sets, so clones and per-thread engines do not rebuild the primitive pairs.
+     */
+    std::shared_ptr<ShellPairStore> shell_pair_store(std::shared_ptr<BasisSet> other, double ln_prec) const;
+
     /** Return the i'th Gaussian shell on center
      *  @param center atomic center
      *  @param si Shell number
@@ -38,6 +38,9 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 
 #include <algorithm>
+#include <cmath>
+#include <list>
+#include <mutex>
 
 ;
 
@@ -171,21 +174,11 @@ CdSalcList::CdSalcList(std::shared_ptr<Molecule> mol, int needed_irreps, bool pr
 
     // constraints_ortho.print();
 
-    auto salc = std::vector<double>(ncd_);
-
     // Obtain handy reference to point group.
     const PointGroup &pg = *molecule_->point_group().get();
     const CharacterTable char_table = pg.char_table();
     nirrep_ = char_table.nirrep();
 
-    // I don't know up front how many I have per irrep
-    // I'll resize afterwards
-    Dimension dim(nirrep_);
-    for (int i = 0; i < nirrep_; ++i) dim[i] = ncd_;
-
-    Matrix salcs("Requested SALCs", dim, dim);
-    auto salcirrep = std::vector<int>(ncd_);
-
     // We know how many atom_salcs_ we have.
     for (int i = 0; i < natom; ++i) atom_salcs_.push_back(CdSalcWRTAtom());
 
@@ -193,7 +186,9 @@ CdSalcList::CdSalcList(std::shared_ptr<Molecule> mol, int needed_irreps, bool pr
     int **atom_map = compute_atom_map(molecule_);
     memset(cdsalcpi_, 0, sizeof(int) * 8);
 
-    int nsalc = 0;
+    // The raw SALCs are orthonormal and only live on the images of one atom, so they are kept as
+    // (cd, coef) lists, in order of unique atom and direction within each irrep.
+    std::vector<std::vector<std::vector<std::pair<int, double>>>> raw(nirrep_);
     for (int uatom = 0; uatom < molecule_->nunique(); ++uatom) {
         int atom = molecule_->unique(uatom);
 
@@ -201,8 +196,9 @@ CdSalcList::CdSalcList(std::shared_ptr<Molecule> mol, int needed_irreps, bool pr
         for (int xyz = 0; xyz < 3; ++xyz) {
             // on each irrep
             for (int irrep = 0; irrep < nirrep_; ++irrep) {
+                if (!((1 << irrep) & needed_irreps)) continue;
                 IrreducibleRepresentation gamma = char_table.gamma(irrep);
-                memset(salc.data(), 0, sizeof(double) * ncd_);
+                std::vector<std::pair<int, double>> salc;
 
                 // This is the order of the atom stabilizer
                 // ...how many times the symmetry operation keeps the atom the same
@@ -223,64 +219,103 @@ CdSalcList::CdSalcList(std::shared_ptr<Molecule> mol, int needed_irreps, bool pr
                     double coeff = so(xyz, xyz) * gamma.character(G);
 
                     // Add this contribution to the salc.
-                    salc[Gcd] += coeff;
+                    auto it = std::find_if(salc.begin(), salc.end(),
+                                           [Gcd](const std::pair<int, double> &c) { return c.first == Gcd; });
+                    if (it == salc.end())
+                        salc.emplace_back(Gcd, coeff);
+                    else
+                        it->second += coeff;
                 }
 
                 if (stab_order == 0)
                     throw PSIEXCEPTION("CdSalcList::CdSalcList: Stabilizer order is 0 this is not possible.");
 
-                bool nonzero = false;
-                for (int cd = 0; cd < ncd_; ++cd) {
-                    // Normalize the salc
-                    salc[cd] /= sqrt((double)nirrep_ * stab_order);
-
-                    // Count number of nonzeros
-                    if (std::fabs(salc[cd]) > 1e-10) nonzero = true;
+                // Normalize the salc and keep the nonzeros
+                double norm = sqrt((double)nirrep_ * stab_order);
+                std::vector<std::pair<int, double>> nonzeros;
+                for (const auto &c : salc) {
+                    if (std::fabs(c.second / norm) > 1e-10) nonzeros.emplace_back(c.first, c.second / norm);
                 }
+                std::sort(nonzeros.begin(), nonzeros.end());
 
-                // We're only interested in doing the following if there are nonzeros
-                // AND the irrep that we're on is what the user wants.
-                if (nonzero && (1 << irrep) & needed_irreps) {
-                    // Store the salc so we can project out constraints below
-                    salcs.copy_to_row(irrep, cdsalcpi_[irrep], salc.data());
-                    salcirrep[nsalc] = irrep;
-                    ++cdsalcpi_[irrep];
-                    nsalc++;
-                }
+                if (!nonzeros.empty()) raw[irrep].push_back(nonzeros);
             }
         }
     }
 
-    // Raw - non-projected cartesian displacements
-    // salcs.print("outfile", "Raw, Nonprojected Cartesian Displacements");
-
-    // Project out any constraints
-    salcs.project_out(constraints_ortho);
-    salcs.set_name("Resulting SALCs after projections");
-    // salcs.print();
-
-    // Walk through the new salcs and populate our sparse vectors.
-    int new_cdsalcpi[8];
-    memset(new_cdsalcpi, 0, sizeof(int) * 8);
+    // Project out the constraints and Schmidt orthogonalize, as Matrix::project_out() would. With
+    // orthonormal raw SALCs s_i and orthonormal constraints C, the overlap of an earlier result u_j
+    // with the projected s_i is -b_j.a_i, where a_i = C s_i and b_j = C x_j for u_j = (1 - C^T C) x_j.
+    // The Schmidt step is then u_i ~ (1 - C^T C) s_i + Z a_i with Z = sum_j u_j b_j^T, which costs
+    // O(ncd) per SALC instead of O(ncd^2), and SALCs that do not touch the constraints stay sparse.
+    const int ncart = 3 * natom;
+    std::vector<double> v(ncart);
     for (int h = 0; h < nirrep_; ++h) {
-        for (int i = 0; i < cdsalcpi_[h]; ++i) {
-            bool added = false;
+        std::vector<double> Z;
+        double B[6][6] = {};
+
+        for (const auto &s : raw[h]) {
+            double a[6];
+            double amax = 0.0;
+            for (int k = 0; k < 6; ++k) {
+                a[k] = 0.0;
+                for (const auto &c : s) a[k] += c.second * constraints_ortho(k, c.first);
+                amax = std::max(amax, std::fabs(a[k]));
+            }
+
             CdSalc new_salc(h);
-            for (int cd = 0; cd < ncd_; ++cd) {
-                if (std::fabs(salcs(h, i, cd)) > 1.0e-10) {
-                    added = true;
-                    new_salc.add(salcs(h, i, cd), cd / 3, cd % 3);
-                    atom_salcs_[cd / 3].add(cd % 3, salcs(h, i, cd), h, salcs_.size());
+            if (amax < 1.0e-14) {
+                for (const auto &c : s) {
+                    new_salc.add(c.second, c.first / 3, c.first % 3);
+                    atom_salcs_[c.first / 3].add(c.first % 3, c.second, h, salcs_.size());
                 }
-            }
-            if (added) {
                 salcs_.push_back(new_salc);
-                new_cdsalcpi[h]++;
+                cdsalcpi_[h]++;
+                continue;
             }
+
+            // v = (1 - C^T C) s, dropped if nothing is left of it
+            for (int cd = 0; cd < ncart; ++cd) {
+                double val = 0.0;
+                for (int k = 0; k < 6; ++k) val -= a[k] * constraints_ortho(k, cd);
+                v[cd] = val;
+            }
+            for (const auto &c : s) v[c.first] += c.second;
+            double n1 = sqrt(C_DDOT(ncart, v.data(), 1, v.data(), 1));
+            if (n1 * n1 <= 1.0e-10) continue;
+
+            // Schmidt step against the earlier SALCs of this irrep, dropped if linearly dependent
+            if (!Z.empty()) {
+                for (int cd = 0; cd < ncart; ++cd) {
+                    for (int k = 0; k < 6; ++k) v[cd] += Z[6 * cd + k] * a[k];
+                }
+            }
+            double nv = sqrt(C_DDOT(ncart, v.data(), 1, v.data(), 1));
+            if (nv / n1 <= 1.0e-5) continue;
+
+            double b[6];
+            for (int k = 0; k < 6; ++k) {
+                b[k] = a[k];
+                for (int l = 0; l < 6; ++l) b[k] += B[k][l] * a[l];
+                b[k] /= nv;
+            }
+            for (int k = 0; k < 6; ++k)
+                for (int l = 0; l < 6; ++l) B[k][l] += b[k] * b[l];
+
+            if (Z.empty()) Z.assign(6 * (size_t)ncart, 0.0);
+            for (int cd = 0; cd < ncart; ++cd) {
+                double u = v[cd] / nv;
+                for (int k = 0; k < 6; ++k) Z[6 * cd + k] += u * b[k];
+                if (std::fabs(u) > 1.0e-10) {
+                    new_salc.add(u, cd / 3, cd % 3);
+                    atom_salcs_[cd / 3].add(cd % 3, u, h, salcs_.size());
+                }
+            }
+            salcs_.push_back(new_salc);
+            cdsalcpi_[h]++;
         }
     }
     ncd_ = salcs_.size();
-    memcpy(cdsalcpi_, new_cdsalcpi, sizeof(int) * 8);
 
     // Free memory.
     delete_atom_map(atom_map, molecule_);
@@ -288,6 +323,37 @@ CdSalcList::CdSalcList(std::shared_ptr<Molecule> mol, int needed_irreps, bool pr
 
 CdSalcList::~CdSalcList() {}
 
+std::shared_ptr<CdSalcList> CdSalcList::build(std::shared_ptr<Molecule> mol, int needed_irreps,
+                                              bool project_out_translations, bool project_out_rotations) {
+    // Everything the SALCs depend on, symmetry frame first
+    std::vector<double> key;
+    key.push_back(mol->point_group() ? mol->point_group()->bits() : -1.0);
+    key.push_back(needed_irreps & 0xFF);
+    key.push_back(project_out_translations);
+    key.push_back(project_out_rotations);
+    for (int i = 0; i < mol->natom(); ++i) {
+        key.push_back(mol->mass(i));
+        for (int xyz = 0; xyz < 3; ++xyz) key.push_back(mol->xyz(i, xyz));
+    }
+
+    static std::mutex lock;
+    static std::list<std::pair<std::vector<double>, std::shared_ptr<CdSalcList>>> cache;
+    const size_t max_cached = 4;
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+        if (it->first == key) {
+            cache.splice(cache.begin(), cache, it);
+            return cache.front().second;
+        }
+    }
+
+    auto salcs = std::make_shared<CdSalcList>(mol, needed_irreps, project_out_translations, project_out_rotations);
+    cache.emplace_front(key, salcs);
+    if (cache.size() > max_cached) cache.pop_back();
+    return salcs;
+}
+
 std::vector<SharedMatrix> CdSalcList::create_matrices(const std::string &basename, const MatrixFactory &factory) const {
     std::vector<SharedMatrix> matrices;
     std::string name;
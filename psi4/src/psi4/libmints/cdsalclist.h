@@ -153,6 +153,13 @@ class PSI_API CdSalcList {
                bool project_out_rotations = true);
     ~CdSalcList();
 
+    /*! Returns the SALCs of mol, shared with earlier calls for the same point group, masses,
+     *  geometry, and arguments. The last few distinct requests are kept, so the findif driver,
+     *  the vibrational analysis, and the derivative code build them once per geometry.
+     */
+    static std::shared_ptr<CdSalcList> build(SharedMolecule mol, int needed_irreps = 0xFF,
+                                             bool project_out_translations = true, bool project_out_rotations = true);
+
     /*! Returns the number of SALCs. It may not be 3n-5 or 3n-6. The value
      *  returned depends on needed_irreps and the project_out* settings.
      */
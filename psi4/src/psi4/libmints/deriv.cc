@@ -124,7 +124,8 @@ class PSI_API CorrelatedFunctor {
 
 Deriv::Deriv(const std::shared_ptr<Wavefunction> &wave, char needed_irreps, bool project_out_translations,
              bool project_out_rotations)
-    : wfn_(wave), cdsalcs_(wave->molecule(), needed_irreps, project_out_translations, project_out_rotations) {
+    : wfn_(wave),
+      cdsalcs_(*CdSalcList::build(wave->molecule(), needed_irreps, project_out_translations, project_out_rotations)) {
     integral_ = wave->integral();
     basis_ = wave->basisset();
     sobasis_ = wave->sobasisset();
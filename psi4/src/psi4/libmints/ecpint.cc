@@ -47,14 +47,30 @@
 #include <algorithm>
 #include <functional>
 #include <map>
+#include <mutex>
+#include <tuple>
 #include <vector>
 
 namespace psi {
 
+namespace {
+// Constructing a libecpint engine tabulates the angular integrals up to the maximum angular momenta, which
+// is a large part of the cost of an ECPInt for heavy elements.  One prototype per (basis AM, ECP AM, deriv)
+// is built and every ECPInt, including the per-thread copies made by the drivers, starts from a copy of it.
+libecpint::ECPIntegral ecp_engine(int max_am, int max_ecp_am, int deriv) {
+    static std::mutex mutex;
+    static std::map<std::tuple<int, int, int>, std::shared_ptr<const libecpint::ECPIntegral>> prototypes;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &prototype = prototypes[std::make_tuple(max_am, max_ecp_am, deriv)];
+    if (!prototype) prototype = std::make_shared<const libecpint::ECPIntegral>(max_am, max_ecp_am, deriv);
+    return *prototype;
+}
+}  // namespace
+
 
 ECPInt::ECPInt(std::vector<SphericalTransform> &st, std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2,
                int deriv)
-    : OneBodyAOInt(st, bs1, bs2, deriv), engine_(bs1->max_am(), bs1->max_ecp_am(), deriv) {
+    : OneBodyAOInt(st, bs1, bs2, deriv), engine_(ecp_engine(bs1->max_am(), bs1->max_ecp_am(), deriv)) {
     int maxam1 = bs1->max_am();
     int maxam2 = bs2->max_am();
 
@@ -197,7 +213,16 @@ void ECPInt::compute_shell_deriv2(int s1, int s2) {
     const libecpint::GaussianShell &LibECPShell2 = libecp_shells2_[s2];
     const size_t size = LibECPShell1.ncartesian() * LibECPShell2.ncartesian();
     memset(buffer_, 0, 45 * size * sizeof(double));
-    for (const auto &center_and_ecp : centers_and_libecp_ecps_){
+    // Inside a setup_hessian_iterations() / next_hessian_ecp() loop only the current ECP contributes, since
+    // the caller assigns the C derivatives to that center; otherwise all ECPs are summed
+    auto first = centers_and_libecp_ecps_.cbegin();
+    auto last = centers_and_libecp_ecps_.cend();
+    if (current_ecp_iterator_ >= 0 && current_ecp_iterator_ < (int)centers_and_libecp_ecps_.size()) {
+        first += current_ecp_iterator_;
+        last = first + 1;
+    }
+    for (auto it = first; it != last; ++it) {
+        const auto &center_and_ecp = *it;
         std::array<libecpint::TwoIndex<double>, 45> results;
         engine_.compute_shell_pair_second_derivative(center_and_ecp.second, LibECPShell1, LibECPShell2, results);
         // Accumulate the results into buffer_
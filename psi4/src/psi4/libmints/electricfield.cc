@@ -29,6 +29,9 @@
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <vector>
 #include "psi4/libciomr/libciomr.h"
@@ -198,3 +201,200 @@ void ElectricFieldInt::compute_with_functor(ContractionFunctor functor, SharedMa
 template void ElectricFieldInt::compute_with_functor(ContractOverDipolesFunctor, SharedMatrix);
 template void ElectricFieldInt::compute_with_functor(ContractOverDensityFieldFunctor, SharedMatrix);
 
+namespace {
+const size_t site_batch_size = 32;
+}
+
+SiteFields::SiteFields(std::shared_ptr<BasisSet> basis, SharedMatrix coords, double screening)
+    : basis_(basis), screening_(screening) {
+    if (coords->coldim() != 3) throw PSIEXCEPTION("SiteFields: coordinates must have 3 columns.");
+    for (int site = 0; site < coords->rowdim(); ++site)
+        sites_.emplace_back(coords->get(site, 0), coords->get(site, 1), coords->get(site, 2));
+
+    int nshell = basis_->nshell();
+    for (int P = 0; P < nshell; ++P) {
+        for (int Q = 0; Q <= P; ++Q) {
+            const libint2::Shell &s1 = basis_->l2_shell(P);
+            const libint2::Shell &s2 = basis_->l2_shell(Q);
+            Vector3 A(s1.O[0], s1.O[1], s1.O[2]);
+            Vector3 B(s2.O[0], s2.O[1], s2.O[2]);
+            double AB2 = A.distance(B) * A.distance(B);
+            double overlap = 0.0;
+            double pmax = 0.0;
+            double amin = s1.alpha[0];
+            double bmin = s2.alpha[0];
+            for (size_t i = 0; i < s1.alpha.size(); ++i) {
+                amin = std::min(amin, s1.alpha[i]);
+                for (size_t j = 0; j < s2.alpha.size(); ++j) {
+                    double a = s1.alpha[i], b = s2.alpha[j], p = a + b;
+                    overlap += std::fabs(s1.contr[0].coeff[i] * s2.contr[0].coeff[j]) * std::pow(M_PI / p, 1.5) *
+                               std::exp(-a * b / p * AB2);
+                    pmax = std::max(pmax, p);
+                }
+            }
+            for (size_t j = 0; j < s2.alpha.size(); ++j) bmin = std::min(bmin, s2.alpha[j]);
+
+            ShellPair pair;
+            pair.P = P;
+            pair.Q = Q;
+            pair.center = (A * amin + B * bmin) / (amin + bmin);
+            // where the most diffuse product, times the angular factors, has decayed below 1e-10
+            pair.extent = std::sqrt((23.0 + s1.contr[0].l + s2.contr[0].l) / (amin + bmin));
+            // both triangles of an off-diagonal pair
+            pair.bound = (P == Q ? 1.0 : 2.0) * overlap;
+            // the field of a unit Gaussian charge of exponent p never exceeds p / 2
+            pair.rmin = std::sqrt(2.0 / pmax);
+            // a hundredfold margin for density elements and dipoles above one
+            if (100.0 * pair.bound / (pair.rmin * pair.rmin) < screening_) continue;
+            pairs_.push_back(pair);
+        }
+    }
+
+    size_t npairs = pairs_.size();
+    size_t nsite = sites_.size();
+    nbatch_ = (nsite + site_batch_size - 1) / site_batch_size;
+    batch_estimate_.assign(nbatch_ * npairs, 0.0f);
+#pragma omp parallel for schedule(dynamic) num_threads(Process::environment.get_n_threads())
+    for (size_t batch = 0; batch < nbatch_; ++batch) {
+        size_t start = batch * site_batch_size;
+        size_t stop = std::min(start + site_batch_size, nsite);
+        // Bounding sphere of the batch
+        Vector3 middle(0.0, 0.0, 0.0);
+        for (size_t site = start; site < stop; ++site) middle += sites_[site];
+        middle /= (double)(stop - start);
+        double radius = 0.0;
+        for (size_t site = start; site < stop; ++site) radius = std::max(radius, middle.distance(sites_[site]));
+
+        float *estimate = &batch_estimate_[batch * npairs];
+        for (size_t ij = 0; ij < npairs; ++ij) {
+            const ShellPair &pair = pairs_[ij];
+            double d = std::max(pair.center.distance(middle) - radius - pair.extent, pair.rmin);
+            estimate[ij] = static_cast<float>(pair.bound / (d * d));
+        }
+    }
+}
+
+SharedMatrix SiteFields::field(SharedMatrix D) const {
+    if (D->rowdim() != basis_->nbf() || D->coldim() != basis_->nbf())
+        throw PSIEXCEPTION("SiteFields::field: density does not match the basis.");
+    double **Dp = D->pointer();
+    size_t npairs = pairs_.size();
+    size_t nsite = sites_.size();
+
+    // Largest density element of each pair, in either triangle
+    std::vector<double> Dmax(npairs, 0.0);
+    for (size_t ij = 0; ij < npairs; ++ij) {
+        const ShellPair &pair = pairs_[ij];
+        int o1 = basis_->shell(pair.P).function_index();
+        int o2 = basis_->shell(pair.Q).function_index();
+        int n1 = basis_->shell(pair.P).nfunction();
+        int n2 = basis_->shell(pair.Q).nfunction();
+        for (int p = 0; p < n1; ++p)
+            for (int q = 0; q < n2; ++q)
+                Dmax[ij] = std::max({Dmax[ij], std::fabs(Dp[o1 + p][o2 + q]), std::fabs(Dp[o2 + q][o1 + p])});
+    }
+
+    auto efields = std::make_shared<Matrix>("efields", nsite, 3);
+    double **Fp = efields->pointer();
+#pragma omp parallel num_threads(Process::environment.get_n_threads())
+    {
+        libint2::Engine engine(libint2::Operator::nuclear, basis_->max_nprimitive(), basis_->max_am(), 1);
+        const auto &buf = engine.results();
+        std::vector<std::pair<double, std::array<double, 3>>> charges;
+
+#pragma omp for schedule(dynamic)
+        for (size_t batch = 0; batch < nbatch_; ++batch) {
+            size_t start = batch * site_batch_size;
+            size_t stop = std::min(start + site_batch_size, nsite);
+            charges.clear();
+            for (size_t site = start; site < stop; ++site)
+                charges.push_back({-1.0, {sites_[site][0], sites_[site][1], sites_[site][2]}});
+            engine.set_params(charges);
+
+            const float *estimate = &batch_estimate_[batch * npairs];
+            for (size_t ij = 0; ij < npairs; ++ij) {
+                if (Dmax[ij] * estimate[ij] < screening_) continue;
+                const ShellPair &pair = pairs_[ij];
+                engine.compute(basis_->l2_shell(pair.P), basis_->l2_shell(pair.Q));
+                int o1 = basis_->shell(pair.P).function_index();
+                int o2 = basis_->shell(pair.Q).function_index();
+                int n1 = basis_->shell(pair.P).nfunction();
+                int n2 = basis_->shell(pair.Q).nfunction();
+                for (size_t site = start; site < stop; ++site) {
+                    // the derivatives with respect to the charge positions follow the bra and ket centers
+                    for (int x = 0; x < 3; ++x) {
+                        const double *ints = buf[3 * (2 + site - start) + x];
+                        if (ints == nullptr) continue;
+                        double value = 0.0;
+                        for (int p = 0, pq = 0; p < n1; ++p) {
+                            for (int q = 0; q < n2; ++q, ++pq) {
+                                double Dpq = Dp[o1 + p][o2 + q];
+                                if (pair.P != pair.Q) Dpq += Dp[o2 + q][o1 + p];
+                                value += Dpq * ints[pq];
+                            }
+                        }
+                        Fp[site][x] += value;
+                    }
+                }
+            }
+        }
+    }
+    return efields;
+}
+
+SharedMatrix SiteFields::induction_operator(SharedMatrix dipoles) const {
+    size_t nsite = sites_.size();
+    if (dipoles->rowdim() != (int)nsite || dipoles->coldim() != 3)
+        throw PSIEXCEPTION("SiteFields::induction_operator: dipoles must be nsite x 3.");
+    double **mu = dipoles->pointer();
+    size_t npairs = pairs_.size();
+
+    std::vector<std::vector<std::pair<double, std::array<double, 3>>>> charges(nbatch_);
+    std::vector<double> weight(nbatch_, 0.0);
+    for (size_t batch = 0; batch < nbatch_; ++batch) {
+        size_t start = batch * site_batch_size;
+        size_t stop = std::min(start + site_batch_size, nsite);
+        for (size_t site = start; site < stop; ++site) {
+            charges[batch].push_back({-1.0, {sites_[site][0], sites_[site][1], sites_[site][2]}});
+            weight[batch] += std::fabs(mu[site][0]) + std::fabs(mu[site][1]) + std::fabs(mu[site][2]);
+        }
+    }
+
+    auto mat = std::make_shared<Matrix>("Induction operator", basis_->nbf(), basis_->nbf());
+    double **Vp = mat->pointer();
+    // Pairs own their blocks of the operator, so they are spread over the threads
+#pragma omp parallel num_threads(Process::environment.get_n_threads())
+    {
+        libint2::Engine engine(libint2::Operator::nuclear, basis_->max_nprimitive(), basis_->max_am(), 1);
+        const auto &buf = engine.results();
+
+#pragma omp for schedule(dynamic)
+        for (size_t ij = 0; ij < npairs; ++ij) {
+            const ShellPair &pair = pairs_[ij];
+            int o1 = basis_->shell(pair.P).function_index();
+            int o2 = basis_->shell(pair.Q).function_index();
+            int n1 = basis_->shell(pair.P).nfunction();
+            int n2 = basis_->shell(pair.Q).nfunction();
+            for (size_t batch = 0; batch < nbatch_; ++batch) {
+                if (weight[batch] * batch_estimate_[batch * npairs + ij] < screening_) continue;
+                engine.set_params(charges[batch]);
+                engine.compute(basis_->l2_shell(pair.P), basis_->l2_shell(pair.Q));
+                size_t start = batch * site_batch_size;
+                for (size_t site = start; site < start + charges[batch].size(); ++site) {
+                    for (int x = 0; x < 3; ++x) {
+                        const double *ints = buf[3 * (2 + site - start) + x];
+                        if (ints == nullptr || mu[site][x] == 0.0) continue;
+                        for (int p = 0, pq = 0; p < n1; ++p) {
+                            for (int q = 0; q < n2; ++q, ++pq) {
+                                Vp[o1 + p][o2 + q] -= mu[site][x] * ints[pq];
+                                if (pair.P != pair.Q) Vp[o2 + q][o1 + p] -= mu[site][x] * ints[pq];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return mat;
+}
+
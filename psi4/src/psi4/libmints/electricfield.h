@@ -72,6 +72,47 @@ class ElectricFieldInt : public OneBodyAOInt {
     void set_origin(const Vector3& _origin) override;
 };
 
+/*! \ingroup MINTS
+ *  \class SiteFields
+ *  \brief Electric field of a density at a fixed set of sites, and the induction operator of dipoles there.
+ *
+ *  The significant shell pairs, and for each batch of sites a bound on every pair's field there,
+ *  are found once. Repeated evaluations, as in the induction iterations of EFP and PE, only pay
+ *  for the integrals that survive screening against the current density or dipoles. Batches of
+ *  sites (field) or shell pairs (operator) are spread over threads.
+ */
+class SiteFields {
+   public:
+    /// Sites are the rows of coords (nsite x 3, bohr); contributions below screening are skipped
+    SiteFields(std::shared_ptr<BasisSet> basis, SharedMatrix coords, double screening = 1.0e-12);
+
+    /// Field of the AO density D at every site, nsite x 3
+    SharedMatrix field(SharedMatrix D) const;
+    /// Induction operator -sum_s mu_s . E_s(r) of the dipoles (nsite x 3), nbf x nbf
+    SharedMatrix induction_operator(SharedMatrix dipoles) const;
+
+    size_t nsite() const { return sites_.size(); }
+
+   private:
+    struct ShellPair {
+        int P;
+        int Q;
+        Vector3 center;
+        double extent;
+        double bound;
+        double rmin;
+    };
+
+    std::shared_ptr<BasisSet> basis_;
+    std::vector<Vector3> sites_;
+    double screening_;
+    /// Shell pairs P >= Q with a non-negligible charge distribution
+    std::vector<ShellPair> pairs_;
+    size_t nbatch_;
+    /// For each batch of sites and pair, a bound on the pair's field over the batch
+    std::vector<float> batch_estimate_;
+};
+
 class ContractOverDipolesFunctor {
     /**
     Contracts the electric field integrals with a matrix of dipoles,
@@ -242,6 +242,15 @@ class Libint2TwoElectronInt : public TwoBodyAOInt {
     //! Shell pair information
     ShellPairData pairs12_, pairs34_;
 
+    /// Index of each shell pair (s1 * nshell2 + s2) into pairs12_, or -1 if sieved out
+    std::vector<long int> pair_index12_;
+    /// Index of each shell pair (s3 * nshell4 + s4) into pairs34_, or -1 if sieved out
+    std::vector<long int> pair_index34_;
+
+    /// Looks up the precomputed shell pair data for a quartet, leaving nullptr where none is available
+    void find_shell_pairs(int s1, int s2, int s3, int s4, const libint2::ShellPair *&sp12,
+                          const libint2::ShellPair *&sp34) const;
+
     /// The type of shell combo to be handled by this object
     libint2::BraKet braket_;
 
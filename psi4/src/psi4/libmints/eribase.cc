@@ -43,6 +43,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
@@ -1664,10 +1665,22 @@ static void handle_reordering12(PermutedOrder permutation, Libderiv_t &libderiv_
  */
 static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, const L1ShellPair &sp12, const L1ShellPair &sp34,
                                   int am, bool sh1eqsh2, bool sh3eqsh4, int deriv_lvl) {
-    double zeta, eta, ooze, rho, poz, coef1, PQx, PQy, PQz, PQ2, Wx, Wy, Wz, o12, o34, T, *F;
+    double zeta, eta, ooze, rho, poz, coef1, PQx, PQy, PQz, PQ2, Wx, Wy, Wz, o12, o34, T;
     double a1, a2, a3, a4;
     int p12, p34, i;
     size_t nprim = 0L;
+
+    // Boys function arguments of all primitive quartets, evaluated in one batch at the end
+    thread_local std::vector<double> T_batch, rho_batch, coef_batch, F_batch;
+    size_t max_nprim = sp12.nonzeroPrimPairs.size() * sp34.nonzeroPrimPairs.size();
+    int nF = am + deriv_lvl + 1;
+    if (T_batch.size() < max_nprim) {
+        T_batch.resize(max_nprim);
+        rho_batch.resize(max_nprim);
+        coef_batch.resize(max_nprim);
+    }
+    if (F_batch.size() < max_nprim * nF) F_batch.resize(max_nprim * nF);
+
     for (p12 = 0; p12 < sp12.nonzeroPrimPairs.size(); ++p12) {
         const PrimPair &pp12 = sp12.nonzeroPrimPairs[p12];
         a1 = pp12.ai;
@@ -1749,14 +1762,19 @@ static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, const L1Shel
             PrimQuartet[nprim].U[5][2] = Wz - PCDz;
 
             T = rho * PQ2;
-            fjt->set_rho(rho);
-            F = fjt->values(am + deriv_lvl, T);
-
-            for (i = 0; i <= am + deriv_lvl; ++i) PrimQuartet[nprim].F[i] = F[i] * coef1;
+            T_batch[nprim] = T;
+            rho_batch[nprim] = rho;
+            coef_batch[nprim] = coef1;
 
             nprim++;
         }
     }
+
+    fjt->batch_values(am + deriv_lvl, nprim, T_batch.data(), rho_batch.data(), F_batch.data());
+    for (size_t n = 0; n < nprim; ++n) {
+        const double *F = &F_batch[n * nF];
+        for (i = 0; i < nF; ++i) PrimQuartet[n].F[i] = F[i] * coef_batch[n];
+    }
     return nprim;
 }
 #endif  // ENABLE_Libint1t
@@ -3092,6 +3110,8 @@ Libint2TwoElectronInt::Libint2TwoElectronInt(const Libint2TwoElectronInt &rhs)
 {
     pairs12_ = rhs.pairs12_;
     pairs34_ = rhs.pairs34_;
+    pair_index12_ = rhs.pair_index12_;
+    pair_index34_ = rhs.pair_index34_;
     zero_vec_ = rhs.zero_vec_;
     for (const auto &e : rhs.engines_) engines_.emplace_back(e);
 }
@@ -3141,26 +3161,40 @@ void Libint2TwoElectronInt::common_init() {
     create_blocks();
     const auto max_engine_precision = std::numeric_limits<double>::epsilon() * screening_threshold_;
 
-    size_t npairs = shell_pairs_bra_.size();
-    pairs12_.resize(npairs);
-//#pragma omp parallel for
-    for (int pair = 0; pair < npairs; ++pair) {
-        auto s1 = shell_pairs_bra_[pair].first;
-        auto s2 = shell_pairs_bra_[pair].second;
-        pairs12_[pair] = std::make_shared<libint2::ShellPair>(basis1()->l2_shell(s1), basis2()->l2_shell(s2),
-                                                              std::log(max_engine_precision));
-    }
-    npairs = shell_pairs_ket_.size();
-    pairs34_.resize(npairs);
-//#pragma omp parallel for
-    for (int pair = 0; pair < npairs; ++pair) {
-        auto s3 = shell_pairs_ket_[pair].first;
-        auto s4 = shell_pairs_ket_[pair].second;
-        pairs34_[pair] = std::make_shared<libint2::ShellPair>(basis3()->l2_shell(s3), basis4()->l2_shell(s4),
-                                                              std::log(max_engine_precision));
+    // The primitive pair data is shared with every other engine on the same basis sets and precision
+    pairs12_ = basis1()->shell_pair_store(basis2(), std::log(max_engine_precision))->get(shell_pairs_bra_);
+    pairs34_ = basis3()->shell_pair_store(basis4(), std::log(max_engine_precision))->get(shell_pairs_ket_);
+
+    // Reverse lookup, so that single quartets requested through compute_shell can reuse the
+    // primitive pair data above instead of having the engine rebuild it for every quartet
+    if (use_shell_pairs_) {
+        const auto nshell2 = basis2()->nshell();
+        const auto nshell4 = basis4()->nshell();
+        pair_index12_.assign((size_t)basis1()->nshell() * nshell2, -1L);
+        for (size_t pair = 0; pair < shell_pairs_bra_.size(); ++pair) {
+            pair_index12_[shell_pairs_bra_[pair].first * nshell2 + shell_pairs_bra_[pair].second] = pair;
+        }
+        pair_index34_.assign((size_t)basis3()->nshell() * nshell4, -1L);
+        for (size_t pair = 0; pair < shell_pairs_ket_.size(); ++pair) {
+            pair_index34_[shell_pairs_ket_[pair].first * nshell4 + shell_pairs_ket_[pair].second] = pair;
+        }
     }
 }
 
+void Libint2TwoElectronInt::find_shell_pairs(int s1, int s2, int s3, int s4, const libint2::ShellPair *&sp12,
+                                             const libint2::ShellPair *&sp34) const {
+    sp12 = nullptr;
+    sp34 = nullptr;
+    if (pair_index12_.empty() || pair_index34_.empty()) return;
+    long int pair12 = pair_index12_[(size_t)s1 * original_bs2_->nshell() + s2];
+    long int pair34 = pair_index34_[(size_t)s3 * original_bs4_->nshell() + s4];
+    // Only hand over pair data when Libint2 will not reorder the shells within the pair
+    if (pair12 >= 0 && original_bs1_->l2_shell(s1).contr[0].l >= original_bs2_->l2_shell(s2).contr[0].l)
+        sp12 = pairs12_[pair12].get();
+    if (pair34 >= 0 && original_bs3_->l2_shell(s3).contr[0].l >= original_bs4_->l2_shell(s4).contr[0].l)
+        sp34 = pairs34_[pair34].get();
+}
+
 Libint2TwoElectronInt::~Libint2TwoElectronInt() { libint2::finalize(); }
 
 size_t Libint2TwoElectronInt::compute_shell(const AOShellCombinationsIterator &shellIter) {
@@ -3204,7 +3238,9 @@ size_t Libint2TwoElectronInt::compute_shell(int s1, int s2, int s3, int s4) {
     const auto &sh3 = bs3_->l2_shell(s3);
     const auto &sh4 = bs4_->l2_shell(s4);
 
-    libint2_wrapper0(sh1, sh2, sh3, sh4);
+    const libint2::ShellPair *sp12, *sp34;
+    find_shell_pairs(s1, s2, s3, s4, sp12, sp34);
+    libint2_wrapper0(sh1, sh2, sh3, sh4, sp12, sp34);
 
     size_t ntot = sh1.size() * sh2.size() * sh3.size() * sh4.size();
 
@@ -3232,7 +3268,9 @@ size_t Libint2TwoElectronInt::compute_shell_deriv1(int s1, int s2, int s3, int s
     const auto &sh3 = bs3_->l2_shell(s3);
     const auto &sh4 = bs4_->l2_shell(s4);
 
-    libint2_wrapper1(sh1, sh2, sh3, sh4);
+    const libint2::ShellPair *sp12, *sp34;
+    find_shell_pairs(s1, s2, s3, s4, sp12, sp34);
+    libint2_wrapper1(sh1, sh2, sh3, sh4, sp12, sp34);
 
 
     size_t ntot = 0;
@@ -3264,7 +3302,9 @@ size_t Libint2TwoElectronInt::compute_shell_deriv2(int s1, int s2, int s3, int s
     const auto &sh3 = bs3_->l2_shell(s3);
     const auto &sh4 = bs4_->l2_shell(s4);
 
-    libint2_wrapper2(sh1, sh2, sh3, sh4);
+    const libint2::ShellPair *sp12, *sp34;
+    find_shell_pairs(s1, s2, s3, s4, sp12, sp34);
+    libint2_wrapper2(sh1, sh2, sh3, sh4, sp12, sp34);
 
     size_t ntot = 0;
     bool none_computed = engines_[2].results()[0] == nullptr;
@@ -32,6 +32,8 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/potential.h"
+#include "psi4/libmints/mcmurchiedavidson.h"
+#include "psi4/libmints/vector3.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/physconst.h"
@@ -42,9 +44,249 @@
 #include <omp.h>
 #endif
 
+#include <array>
+#include <cmath>
+#include <map>
+
+using namespace mdintegrals;
+
 namespace psi {
 
-ExternalPotential::ExternalPotential() : debug_(0), print_(1) {}
+namespace {
+
+/// Index of the Cartesian component x^t y^u z^v in the CCA ordering used by MultipoleInt (all orders stacked)
+inline int cart_index(int t, int u, int v) {
+    int L = t + u + v;
+    int i = L - t;
+    return (L ? cumulative_cart_dim(L - 1) : 0) + i * (i + 1) / 2 + v;
+}
+
+/// Derivatives T[cart_index(t,u,v)] = d^t/dX^t d^u/dY^u d^v/dZ^v 1/|R| for t + u + v <= order, from the
+/// McMurchie-Davidson Hermite recursion in the point-charge limit. comps holds the (t,u,v) of every cart_index,
+/// R is scratch of (order + 1) * ncart
+void coulomb_derivatives(int order, const std::vector<std::array<int, 3>>& comps, const std::array<double, 3>& D,
+                         std::vector<double>& R, double* T) {
+    int ncart = cumulative_cart_dim(order);
+    double r2 = D[0] * D[0] + D[1] * D[1] + D[2] * D[2];
+    double g = 1.0 / std::sqrt(r2);
+
+    // R^(n)_000 = ((1/r) d/dr)^n 1/r
+    for (int n = 0; n <= order; n++) {
+        R[n * ncart] = g;
+        g *= -(2 * n + 1) / r2;
+    }
+    for (int n = order - 1; n >= 0; n--) {
+        double* Rn = &R[n * ncart];
+        const double* Rn1 = &R[(n + 1) * ncart];
+        for (int ind = 1; ind < cumulative_cart_dim(order - n); ind++) {
+            const auto& [t, u, v] = comps[ind];
+            if (t) {
+                Rn[ind] = D[0] * Rn1[cart_index(t - 1, u, v)] + (t > 1 ? (t - 1) * Rn1[cart_index(t - 2, u, v)] : 0.0);
+            } else if (u) {
+                Rn[ind] = D[1] * Rn1[cart_index(t, u - 1, v)] + (u > 1 ? (u - 1) * Rn1[cart_index(t, u - 2, v)] : 0.0);
+            } else {
+                Rn[ind] = D[2] * Rn1[cart_index(t, u, v - 1)] + (v > 1 ? (v - 1) * Rn1[cart_index(t, u, v - 2)] : 0.0);
+            }
+        }
+    }
+    std::copy(R.begin(), R.begin() + ncart, T);
+}
+
+/// A cubic box of the FMM partition: center, radius enclosing all members, and member indices
+struct FMMBox {
+    std::array<double, 3> center;
+    double radius;
+    std::vector<int> members;
+};
+
+/// Sort points into cubic boxes of edge length h. Returns the boxes with their centers set
+std::vector<FMMBox> partition_boxes(const std::vector<std::array<double, 3>>& xyz, double h) {
+    std::map<std::array<long, 3>, int> key_to_box;
+    std::vector<FMMBox> boxes;
+    for (int ind = 0; ind < xyz.size(); ind++) {
+        std::array<long, 3> key;
+        for (int k = 0; k < 3; k++) key[k] = (long)std::floor(xyz[ind][k] / h);
+        auto it = key_to_box.find(key);
+        if (it == key_to_box.end()) {
+            it = key_to_box.insert({key, boxes.size()}).first;
+            FMMBox box;
+            for (int k = 0; k < 3; k++) box.center[k] = (key[k] + 0.5) * h;
+            box.radius = 0.0;
+            boxes.push_back(box);
+        }
+        boxes[it->second].members.push_back(ind);
+    }
+    return boxes;
+}
+
+inline double distance(const std::array<double, 3>& A, const std::array<double, 3>& B) {
+    return std::sqrt((A[0] - B[0]) * (A[0] - B[0]) + (A[1] - B[1]) * (A[1] - B[1]) + (A[2] - B[2]) * (A[2] - B[2]));
+}
+
+/// Far field of a set of point charges, as seen by each box of shell pairs
+struct FMMField {
+    /// All (t,u,v) components up to the expansion order, in cart_index order
+    std::vector<std::array<int, 3>> comps;
+    /// Boxes of shell pairs (members index the shell-pair list)
+    std::vector<FMMBox> pair_boxes;
+    /// Local expansion L_a about each pair-box center, Phi(O + s) = sum_a L_a s^a
+    std::vector<std::vector<double>> local;
+    /// Charges integrated exactly by each pair box
+    std::vector<std::vector<std::pair<double, std::array<double, 3>>>> near;
+    /// Number of charge boxes
+    size_t ncharge_boxes = 0L;
+    /// Charge-pair box interactions through multipoles, charge expansions and exact integrals
+    size_t nmult = 0L;
+    size_t nfar = 0L;
+    size_t nnear = 0L;
+};
+
+// The potential of all charges around the center O of a box of shell pairs is the local expansion
+//   Phi(O + s) = sum_a L_a s^a,  L_a = (-1)^|a| / a! sum_C q_C d^a (1/|C - O|),
+// valid for charges farther from O than the box radius. Boxes of charges that are well separated from
+// the pair box enter through their multipoles M_b = sum_C q_C (C - Q)^b about the charge box center Q,
+//   d^a (1/|C - O|) = sum_b M_b / b! d^(a+b) (1/|Q - O|) (truncated at |a| + |b| <= order),
+// remaining charges farther than ws box radii enter individually, and only the near charges are integrated.
+FMMField build_fmm_field(std::shared_ptr<BasisSet> basis, const std::vector<std::pair<int, int>>& ij_pairs,
+                         const std::vector<std::tuple<double, double, double, double>>& charges, int order,
+                         double ws, double h, int nthreads) {
+    FMMField field;
+    int ncart = cumulative_cart_dim(order);
+    for (int L = 0; L <= order; L++) {
+        for (const auto& comp : generate_am_components_cca(L)) field.comps.push_back(comp);
+    }
+    const auto& comps = field.comps;
+    std::vector<double> inv_fact(order + 1, 1.0);
+    for (int k = 1; k <= order; k++) inv_fact[k] = inv_fact[k - 1] / k;
+
+    // => Boxes of shell pairs, centered on the product of the most diffuse primitives <= //
+
+    // Product distributions are taken to end where exp(-p r^2) drops below this
+    const double extent_cutoff = -std::log(1.0E-10);
+
+    std::vector<std::array<double, 3>> pair_centers(ij_pairs.size());
+    std::vector<double> pair_extents(ij_pairs.size());
+    for (size_t p = 0; p < ij_pairs.size(); ++p) {
+        const GaussianShell& Pshell = basis->shell(ij_pairs[p].first);
+        const GaussianShell& Qshell = basis->shell(ij_pairs[p].second);
+        double a = Pshell.exp(0);
+        double b = Qshell.exp(0);
+        for (int K = 1; K < Pshell.nprimitive(); K++) a = std::min(a, Pshell.exp(K));
+        for (int K = 1; K < Qshell.nprimitive(); K++) b = std::min(b, Qshell.exp(K));
+        const double* A = Pshell.center();
+        const double* B = Qshell.center();
+        for (int k = 0; k < 3; k++) pair_centers[p][k] = (a * A[k] + b * B[k]) / (a + b);
+        pair_extents[p] = std::sqrt(extent_cutoff / (a + b));
+    }
+    field.pair_boxes = partition_boxes(pair_centers, h);
+    for (auto& box : field.pair_boxes) {
+        for (int p : box.members) {
+            box.radius = std::max(box.radius, distance(pair_centers[p], box.center) + pair_extents[p]);
+        }
+    }
+
+    // => Boxes of charges and their multipoles (divided by b!) <= //
+
+    std::vector<std::array<double, 3>> charge_xyz(charges.size());
+    for (size_t C = 0; C < charges.size(); C++) {
+        charge_xyz[C] = {std::get<1>(charges[C]), std::get<2>(charges[C]), std::get<3>(charges[C])};
+    }
+    std::vector<FMMBox> charge_boxes = partition_boxes(charge_xyz, h);
+    field.ncharge_boxes = charge_boxes.size();
+
+    std::vector<std::vector<double>> charge_mult(charge_boxes.size(), std::vector<double>(ncart, 0.0));
+    for (size_t c = 0; c < charge_boxes.size(); c++) {
+        auto& box = charge_boxes[c];
+        for (int C : box.members) {
+            box.radius = std::max(box.radius, distance(charge_xyz[C], box.center));
+            double q = std::get<0>(charges[C]);
+            std::array<double, 3> d = {charge_xyz[C][0] - box.center[0], charge_xyz[C][1] - box.center[1],
+                                       charge_xyz[C][2] - box.center[2]};
+            for (int ind = 0; ind < ncart; ind++) {
+                const auto& [t, u, v] = comps[ind];
+                charge_mult[c][ind] += q * std::pow(d[0], t) * std::pow(d[1], u) * std::pow(d[2], v) * inv_fact[t] *
+                                       inv_fact[u] * inv_fact[v];
+            }
+        }
+    }
+
+    // => Local expansions, box by box <= //
+
+    field.local.resize(field.pair_boxes.size());
+    field.near.resize(field.pair_boxes.size());
+    size_t nmult = 0L;
+    size_t nfar = 0L;
+    size_t nnear = 0L;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(+ : nmult, nfar, nnear)
+    for (size_t b = 0; b < field.pair_boxes.size(); b++) {
+        const auto& box = field.pair_boxes[b];
+        std::vector<double> R((order + 1) * ncart);
+        std::vector<double> T(ncart);
+        std::vector<double>& L = field.local[b];
+        L.assign(ncart, 0.0);
+        auto& near = field.near[b];
+
+        for (size_t c = 0; c < charge_boxes.size(); c++) {
+            const auto& cbox = charge_boxes[c];
+            std::array<double, 3> D = {cbox.center[0] - box.center[0], cbox.center[1] - box.center[1],
+                                       cbox.center[2] - box.center[2]};
+            if (std::sqrt(D[0] * D[0] + D[1] * D[1] + D[2] * D[2]) >= ws * (box.radius + cbox.radius)) {
+                // Multipoles to local expansion
+                coulomb_derivatives(order, comps, D, R, T.data());
+                for (int a = 0; a < ncart; a++) {
+                    const auto& [ta, ua, va] = comps[a];
+                    int La = ta + ua + va;
+                    double val = 0.0;
+                    for (int bb = 0; bb < cumulative_cart_dim(order - La); bb++) {
+                        const auto& [tb, ub, vb] = comps[bb];
+                        val += charge_mult[c][bb] * T[cart_index(ta + tb, ua + ub, va + vb)];
+                    }
+                    L[a] += val;
+                }
+                nmult += cbox.members.size();
+                continue;
+            }
+            for (int C : cbox.members) {
+                std::array<double, 3> d = {charge_xyz[C][0] - box.center[0], charge_xyz[C][1] - box.center[1],
+                                           charge_xyz[C][2] - box.center[2]};
+                double q = std::get<0>(charges[C]);
+                if (std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) >= ws * box.radius) {
+                    // Charge to local expansion
+                    coulomb_derivatives(order, comps, d, R, T.data());
+                    for (int a = 0; a < ncart; a++) L[a] += q * T[a];
+                    nfar++;
+                } else {
+                    near.push_back({q, charge_xyz[C]});
+                    nnear++;
+                }
+            }
+        }
+
+        // Fold in (-1)^|a| / a!
+        for (int a = 0; a < ncart; a++) {
+            const auto& [t, u, v] = comps[a];
+            L[a] *= ((t + u + v) % 2 ? -1.0 : 1.0) * inv_fact[t] * inv_fact[u] * inv_fact[v];
+        }
+    }
+
+    field.nmult = nmult;
+    field.nfar = nfar;
+    field.nnear = nnear;
+    return field;
+}
+
+void print_fmm_field(const FMMField& field, int order) {
+    outfile->Printf("  External Potential FMM: order %d, %zu pair boxes, %zu charge boxes\n", order,
+                    field.pair_boxes.size(), field.ncharge_boxes);
+    outfile->Printf("    Charge-box interactions: %zu multipole, %zu far, %zu near (charges x pair boxes)\n\n",
+                    field.nmult, field.nfar, field.nnear);
+}
+
+}  // namespace
+
+ExternalPotential::ExternalPotential()
+    : debug_(0), print_(1), fmm_(false), fmm_order_(10), fmm_ws_(3.0), fmm_box_(6.0) {}
 
 ExternalPotential::~ExternalPotential() {}
 
@@ -104,56 +346,61 @@ SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr<BasisSet>
 #endif
 
     // Monopoles
-    std::vector<std::pair<double, std::array<double, 3>>> Zxyz;
-    for (size_t i=0; i< charges_.size(); ++i) {
-        Zxyz.push_back({std::get<0>(charges_[i]),{{std::get<1>(charges_[i]),
-                                                   std::get<2>(charges_[i]),
-                                                   std::get<3>(charges_[i])}}});
-    }
+    if (fmm_ && charges_.size()) {
+        // Far-field boxes of charges through multipole expansions
+        V->add(computeChargePotentialFMM(basis));
+    } else {
+        std::vector<std::pair<double, std::array<double, 3>>> Zxyz;
+        for (size_t i=0; i< charges_.size(); ++i) {
+            Zxyz.push_back({std::get<0>(charges_[i]),{{std::get<1>(charges_[i]),
+                                                       std::get<2>(charges_[i]),
+                                                       std::get<3>(charges_[i])}}});
+        }
 
-    std::vector<SharedMatrix> V_charge;
-    std::vector<std::shared_ptr<PotentialInt> > pot;
-    for (size_t t = 0; t < nthreads; ++t) {
-        V_charge.push_back(std::make_shared<Matrix>("External Potential (Charges)", n, n));
-        V_charge[t]->zero();
-        pot.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt *>(fact->ao_potential())));
-        pot[t]->set_charge_field(Zxyz);
-    }
+        std::vector<SharedMatrix> V_charge;
+        std::vector<std::shared_ptr<PotentialInt> > pot;
+        for (size_t t = 0; t < nthreads; ++t) {
+            V_charge.push_back(std::make_shared<Matrix>("External Potential (Charges)", n, n));
+            V_charge[t]->zero();
+            pot.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt *>(fact->ao_potential())));
+            pot[t]->set_charge_field(Zxyz);
+        }
 
-    // Monopole potential is symmetric, so generate unique pairs of shells
-    const auto& ij_pairs = pot[0]->shellpairs();
+        // Monopole potential is symmetric, so generate unique pairs of shells
+        const auto& ij_pairs = pot[0]->shellpairs();
 
-    // Calculate monopole potential
+        // Calculate monopole potential
 #pragma omp parallel for schedule(guided) num_threads(nthreads)
-    for (size_t p = 0; p < ij_pairs.size(); ++p) {
-        size_t i = ij_pairs[p].first;
-        size_t j = ij_pairs[p].second;
-        size_t ni = basis->shell(i).nfunction();
-        size_t nj = basis->shell(j).nfunction();
-        size_t index_i = basis->shell(i).function_index();
-        size_t index_j = basis->shell(j).function_index();
-
-        size_t rank = 0;
+        for (size_t p = 0; p < ij_pairs.size(); ++p) {
+            size_t i = ij_pairs[p].first;
+            size_t j = ij_pairs[p].second;
+            size_t ni = basis->shell(i).nfunction();
+            size_t nj = basis->shell(j).nfunction();
+            size_t index_i = basis->shell(i).function_index();
+            size_t index_j = basis->shell(j).function_index();
+
+            size_t rank = 0;
 #ifdef _OPENMP
-        rank = omp_get_thread_num();
+            rank = omp_get_thread_num();
 #endif
 
-        double **Vp = V_charge[rank]->pointer();
-        pot[rank]->compute_shell(i, j);
-        const auto* buffer = pot[rank]->buffers()[0];
+            double **Vp = V_charge[rank]->pointer();
+            pot[rank]->compute_shell(i, j);
+            const auto* buffer = pot[rank]->buffers()[0];
 
-        size_t index = 0;
-        for (size_t ii = index_i; ii < (index_i + ni); ++ii) {
-            for (size_t jj = index_j; jj < (index_j + nj); ++jj) {
-                Vp[ii][jj] = Vp[jj][ii] = buffer[index++];
+            size_t index = 0;
+            for (size_t ii = index_i; ii < (index_i + ni); ++ii) {
+                for (size_t jj = index_j; jj < (index_j + nj); ++jj) {
+                    Vp[ii][jj] = Vp[jj][ii] = buffer[index++];
+                }
             }
-        }
-    } // p
+        } // p
 
-    for (size_t t = 0; t < nthreads; ++t) {
-        V->add(V_charge[t]);
-        V_charge[t].reset();
-        pot[t].reset();
+        for (size_t t = 0; t < nthreads; ++t) {
+            V->add(V_charge[t]);
+            V_charge[t].reset();
+            pot[t].reset();
+        }
     }
 
     // Diffuse Bases
@@ -197,6 +444,93 @@ SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr<BasisSet>
     return V;
 }
 
+SharedMatrix ExternalPotential::computeChargePotentialFMM(std::shared_ptr<BasisSet> basis) {
+    // With the local expansions L_a of the far field, V_mn = -L_0 S_mn - sum_a L_a <m|s^a|n>
+
+    int n = basis->nbf();
+    int order = std::max(fmm_order_, 0);
+    int ncart = cumulative_cart_dim(order);
+    auto V = std::make_shared<Matrix>("External Potential (Charges)", n, n);
+    auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+
+    // Thread count
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+#endif
+
+    std::vector<SharedMatrix> V_charge;
+    std::vector<std::shared_ptr<PotentialInt> > pot;
+    std::vector<std::shared_ptr<OneBodyAOInt> > overlap;
+    std::vector<std::shared_ptr<OneBodyAOInt> > mult;
+    for (size_t t = 0; t < nthreads; ++t) {
+        V_charge.push_back(std::make_shared<Matrix>("External Potential (Charges)", n, n));
+        pot.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(fact->ao_potential())));
+        overlap.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_overlap()));
+        if (order > 0) mult.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_multipoles(order)));
+    }
+    const auto& ij_pairs = pot[0]->shellpairs();
+
+    FMMField field = build_fmm_field(basis, ij_pairs, charges_, order, fmm_ws_, fmm_box_, nthreads);
+
+    // Pair boxes are disjoint, so each shell pair is written by one thread
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (size_t b = 0; b < field.pair_boxes.size(); b++) {
+        size_t rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        const auto& box = field.pair_boxes[b];
+        const auto& L = field.local[b];
+        const auto& near = field.near[b];
+
+        if (near.size()) pot[rank]->set_charge_field(near);
+        if (order > 0) mult[rank]->set_origin(Vector3(box.center[0], box.center[1], box.center[2]));
+        double** Vp = V_charge[rank]->pointer();
+
+        for (int p : box.members) {
+            size_t i = ij_pairs[p].first;
+            size_t j = ij_pairs[p].second;
+            size_t ni = basis->shell(i).nfunction();
+            size_t nj = basis->shell(j).nfunction();
+            size_t index_i = basis->shell(i).function_index();
+            size_t index_j = basis->shell(j).function_index();
+
+            std::vector<double> buffer(ni * nj, 0.0);
+            if (near.size()) {
+                pot[rank]->compute_shell(i, j);
+                const auto* Vbuf = pot[rank]->buffers()[0];
+                for (size_t ind = 0; ind < ni * nj; ind++) buffer[ind] = Vbuf[ind];
+            }
+            overlap[rank]->compute_shell(i, j);
+            C_DAXPY(ni * nj, -L[0], const_cast<double*>(overlap[rank]->buffers()[0]), 1, buffer.data(), 1);
+            if (order > 0) {
+                // MultipoleInt carries the electron charge, -<m|s^a|n>
+                mult[rank]->compute_shell(i, j);
+                const auto& Mbufs = mult[rank]->buffers();
+                for (int a = 1; a < ncart; a++) {
+                    C_DAXPY(ni * nj, L[a], const_cast<double*>(Mbufs[a - 1]), 1, buffer.data(), 1);
+                }
+            }
+
+            size_t index = 0;
+            for (size_t ii = index_i; ii < (index_i + ni); ++ii) {
+                for (size_t jj = index_j; jj < (index_j + nj); ++jj) {
+                    Vp[ii][jj] = Vp[jj][ii] = buffer[index++];
+                }
+            }
+        }
+    }
+
+    for (size_t t = 0; t < nthreads; ++t) {
+        V->add(V_charge[t]);
+    }
+
+    if (print_ > 1) print_fmm_field(field, order);
+
+    return V;
+}
+
 SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisSet> basis, std::shared_ptr<Matrix> Dt) {
     // This will be easy to implement, I think, but just throw for now.
     if (bases_.size()) throw PSIEXCEPTION("Gradients with blurred external charges are not implemented yet.");
@@ -214,8 +548,15 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
                                                    std::get<3>(charges_[i])}}});
     }
 
+    // Thread count
+    int threads = 1;
+#ifdef _OPENMP
+    threads = Process::environment.get_n_threads();
+#endif
+
     // Start with the nuclear contribution
     grad->zero();
+#pragma omp parallel for schedule(static) num_threads(threads)
     for (int cen = 0; cen < natom; ++cen) {
         double xc = mol->x(cen);
         double yc = mol->y(cen);
@@ -237,12 +578,6 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
     // Now the electronic contribution.
     auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
 
-    // Thread count
-    int threads = 1;
-#ifdef _OPENMP
-    threads = Process::environment.get_n_threads();
-#endif
-
     // Potential derivatives
     std::vector<std::shared_ptr<PotentialInt> > Vint;
     std::vector<SharedMatrix> Vtemps;
@@ -255,19 +590,10 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
 
     // Lower Triangle
     const auto &PQ_pairs = Vint[0]->shellpairs();
+    double **Dp = Dt->pointer();
 
-#pragma omp parallel for schedule(dynamic) num_threads(threads)
-    for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
-        int P = PQ_pairs[PQ].first;
-        int Q = PQ_pairs[PQ].second;
-
-        int thread = 0;
-#ifdef _OPENMP
-        thread = omp_get_thread_num();
-#endif
-        Vint[thread]->compute_shell_deriv1(P, Q);
-        const auto& buffers = Vint[thread]->buffers();
-
+    // Contract the six derivative buffers (Ax, Ay, Az, Bx, By, Bz) of the pair P, Q, scaled by fac
+    auto contract = [&](int thread, int P, int Q, const double *const *buffers, double fac) {
         int cP = basis->shell(P).ncenter();
         int nP = basis->shell(P).nfunction();
         int oP = basis->shell(P).function_index();
@@ -276,10 +602,9 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
         int nQ = basis->shell(Q).nfunction();
         int oQ = basis->shell(Q).function_index();
 
-        double perm = (P == Q ? 1.0 : 2.0);
+        double perm = fac * (P == Q ? 1.0 : 2.0);
 
         double **Vp = Vtemps[thread]->pointer();
-        double **Dp = Dt->pointer();
         const double *ref0 = buffers[0];
         const double *ref1 = buffers[1];
         const double *ref2 = buffers[2];
@@ -297,6 +622,67 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
                 Vp[cQ][2] += Vval * (*ref5++);
             }
         }
+    };
+
+    if (fmm_ && nextc) {
+        // Far field through the same local expansions as computePotentialMatrix. The box centers stay put,
+        // so only the basis functions in -L_0 S_mn - sum_a L_a <m|s^a|n> are differentiated
+        int order = std::max(fmm_order_, 0);
+        int ncart = cumulative_cart_dim(order);
+        FMMField field = build_fmm_field(basis, PQ_pairs, charges_, order, fmm_ws_, fmm_box_, threads);
+
+        std::vector<std::shared_ptr<OneBodyAOInt> > Sint;
+        std::vector<std::shared_ptr<OneBodyAOInt> > Mint;
+        for (int t = 0; t < threads; t++) {
+            Sint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_overlap(1)));
+            if (order > 0) Mint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_multipoles(order, 1)));
+        }
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+        for (size_t b = 0; b < field.pair_boxes.size(); b++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            const auto& box = field.pair_boxes[b];
+            const auto& L = field.local[b];
+            const auto& near = field.near[b];
+
+            if (near.size()) Vint[thread]->set_charge_field(near);
+            if (order > 0) Mint[thread]->set_origin(Vector3(box.center[0], box.center[1], box.center[2]));
+
+            for (int PQ : box.members) {
+                int P = PQ_pairs[PQ].first;
+                int Q = PQ_pairs[PQ].second;
+                if (near.size()) {
+                    Vint[thread]->compute_shell_deriv1(P, Q);
+                    contract(thread, P, Q, Vint[thread]->buffers().data(), 1.0);
+                }
+                Sint[thread]->compute_shell_deriv1(P, Q);
+                contract(thread, P, Q, Sint[thread]->buffers().data(), -L[0]);
+                if (order > 0) {
+                    // Unlike the integrals themselves, the multipole derivatives carry no electron charge
+                    Mint[thread]->compute_shell_deriv1(P, Q);
+                    const auto& buffers = Mint[thread]->buffers();
+                    for (int a = 1; a < ncart; a++) {
+                        contract(thread, P, Q, &buffers[6 * (a - 1)], -L[a]);
+                    }
+                }
+            }
+        }
+    } else {
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+        for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
+            int P = PQ_pairs[PQ].first;
+            int Q = PQ_pairs[PQ].second;
+
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            Vint[thread]->compute_shell_deriv1(P, Q);
+            contract(thread, P, Q, Vint[thread]->buffers().data(), 1.0);
+        }
     }
 
     for (int t = 0; t < threads; t++) {
@@ -316,6 +702,7 @@ double ExternalPotential::computeNuclearEnergy(std::shared_ptr<Molecule> mol) {
         double ZA = mol->Z(A);
 
         if (ZA > 0) { // skip Ghost interaction
+#pragma omp parallel for schedule(static) reduction(+ : E) num_threads(Process::environment.get_n_threads())
             for (size_t B = 0; B < charges_.size(); B++) {
                 double ZB = std::get<0>(charges_[B]);
                 double xB = std::get<1>(charges_[B]);
@@ -364,13 +751,15 @@ double ExternalPotential::computeExternExternInteraction(std::shared_ptr<Externa
     double E = 0.0;
 
     // charge-charge interaction
-    for (auto self_charge: charges_) {
-        double ZA = std::get<0>(self_charge);
-        double xA = std::get<1>(self_charge);
-        double yA = std::get<2>(self_charge);
-        double zA = std::get<3>(self_charge);
-
-        for (auto other_charge: other_extern->charges_) {
+    const auto& other_charges = other_extern->charges_;
+#pragma omp parallel for schedule(static) reduction(+ : E) num_threads(Process::environment.get_n_threads())
+    for (size_t A = 0; A < charges_.size(); A++) {
+        double ZA = std::get<0>(charges_[A]);
+        double xA = std::get<1>(charges_[A]);
+        double yA = std::get<2>(charges_[A]);
+        double zA = std::get<3>(charges_[A]);
+
+        for (const auto& other_charge : other_charges) {
             double ZB = std::get<0>(other_charge);
             double xB = std::get<1>(other_charge);
             double yB = std::get<2>(other_charge);
@@ -62,6 +62,18 @@ class PSI_API ExternalPotential {
     /// Auxiliary basis sets (with accompanying molecules and coefs) of diffuse charges
     std::vector<std::pair<std::shared_ptr<BasisSet>, SharedVector> > bases_;
 
+    /// Expand the far-field charges in computePotentialMatrix?
+    bool fmm_;
+    /// Order of the multipole and local expansions
+    int fmm_order_;
+    /// Well-separatedness ratio (distance over the sum of the box radii)
+    double fmm_ws_;
+    /// Edge length of the shell-pair and charge boxes [a0]
+    double fmm_box_;
+
+    /// Potential matrix of the point charges, with far-field boxes of charges treated by multipole expansions
+    SharedMatrix computeChargePotentialFMM(std::shared_ptr<BasisSet> basis);
+
    public:
     /// Constructur, does nothing
     ExternalPotential();
@@ -111,6 +123,13 @@ class PSI_API ExternalPotential {
     void set_print(int print) { print_ = print; }
     /// Debug flag
     void set_debug(int debug) { debug_ = debug; }
+    /// Expand the far-field point charges of computePotentialMatrix in multipoles of the given order
+    void set_fmm(bool fmm, int order = 10, double ws = 3.0, double box_length = 6.0) {
+        fmm_ = fmm;
+        fmm_order_ = order;
+        fmm_ws_ = ws;
+        fmm_box_ = box_length;
+    }
 };
 
 }  // namespace psi
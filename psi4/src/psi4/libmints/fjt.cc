@@ -62,6 +62,7 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <array>
 #include <cmath>
 
 using namespace psi;
@@ -70,6 +71,17 @@ using namespace psi;
 const double oon[] = {0.0,       1.0,       1.0 / 2.0, 1.0 / 3.0, 1.0 / 4.0,  1.0 / 5.0,
                       1.0 / 6.0, 1.0 / 7.0, 1.0 / 8.0, 1.0 / 9.0, 1.0 / 10.0, 1.0 / 11.0};
 
+namespace {
+/// 1/k! for the Taylor interpolation, generated at compile time
+constexpr std::array<double, TAYLOR_INTERPOLATION_ORDER + 1> make_taylor_coefficients() {
+    std::array<double, TAYLOR_INTERPOLATION_ORDER + 1> coef{};
+    coef[0] = 1.0;
+    for (int k = 1; k <= TAYLOR_INTERPOLATION_ORDER; ++k) coef[k] = coef[k - 1] / k;
+    return coef;
+}
+constexpr auto taylor_coefficients = make_taylor_coefficients();
+}  // namespace
+
 #define SOFT_ZERO 1e-6
 
 #ifndef M_SQRT_PI
@@ -83,6 +95,14 @@ const double oon[] = {0.0,       1.0,       1.0 / 2.0, 1.0 / 3.0, 1.0 / 4.0,  1.
 Fjt::Fjt() {}
 Fjt::~Fjt() {}
 
+void Fjt::batch_values(int J, size_t n, const double* T, const double* rho, double* F) {
+    for (size_t i = 0; i < n; ++i) {
+        if (rho) set_rho(rho[i]);
+        const double* Fi = values(J, T[i]);
+        for (int j = 0; j <= J; ++j) F[i * (J + 1) + j] = Fi[j];
+    }
+}
+
 double Taylor_Fjt::relative_zero_(1e-6);
 
 /*------------------------------------------------------
@@ -326,6 +346,47 @@ And then do downward recursion in j
     return F_;
 }
 
+void Taylor_Fjt::batch_values(int J, size_t n, const double* T, const double* /*rho*/, double* F) {
+#if TAYLOR_INTERPOLATION_AND_RECURSION
+    // The interpolation-plus-recursion variant has no batched form
+    Fjt::batch_values(J, n, T, nullptr, F);
+#else
+    const int ncol = J + 1;
+    const double T_crit = T_crit_[J];
+    for (size_t i = 0; i < n; ++i) {
+        double* Fi = F + i * ncol;
+        const double Ti = T[i];
+        if (Ti > T_crit) {
+            /*--- Asymptotic formula, upward in j ---*/
+            double X = 0.5 / Ti;
+            double dffac = 1.0;
+            double jfac = 1.0;
+            const double F0 = M_SQRT_PI_2 * std::sqrt(X);
+            for (int j = 0; j < ncol; ++j) {
+                Fi[j] = jfac * F0;
+                jfac *= dffac * X;
+                dffac += 2.0;
+            }
+        } else {
+            /*--- Taylor interpolation, F_j(T) = sum_k h^k / k! F_{j+k}(T_ind), independent in j ---*/
+            const int T_ind = (int)std::floor(0.5 + Ti * oodelT_);
+            const double h = T_ind * delT_ - Ti;
+            const double* F_row = grid_[T_ind];
+            std::array<double, TAYLOR_INTERPOLATION_ORDER + 1> hk;
+            hk[0] = 1.0;
+            for (int k = 1; k <= TAYLOR_INTERPOLATION_ORDER; ++k) hk[k] = hk[k - 1] * h;
+            for (int k = 0; k <= TAYLOR_INTERPOLATION_ORDER; ++k) hk[k] *= taylor_coefficients[k];
+#pragma omp simd
+            for (int j = 0; j < ncol; ++j) {
+                double val = 0.0;
+                for (int k = 0; k <= TAYLOR_INTERPOLATION_ORDER; ++k) val += hk[k] * F_row[j + k];
+                Fi[j] = val;
+            }
+        }
+    }
+#endif
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 /* Tablesize should always be at least 121. */
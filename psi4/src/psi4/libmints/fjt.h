@@ -58,6 +58,8 @@
 
 #include "psi4/pragma.h"
 
+#include <cstddef>
+
 namespace psi {
 
 class CorrelationFactor;
@@ -73,6 +75,10 @@ class Fjt {
         The pointer will be invalidated after the call to ~Fjt. */
     virtual double* values(int J, double T) = 0;
     virtual void set_rho(double /*rho*/) {}
+    /** Computes F_j(T_i) for every 0 <= j <= J and n arguments T_i, into F[i * (J + 1) + j].
+        rho holds the rho of each argument for the fundamentals that depend on it (may be nullptr otherwise).
+        The default evaluates the arguments one at a time through values(). */
+    virtual void batch_values(int J, size_t n, const double* T, const double* rho, double* F);
 };
 
 #define TAYLOR_INTERPOLATION_ORDER 6
@@ -89,6 +95,8 @@ class Taylor_Fjt : public Fjt {
     ~Taylor_Fjt() override;
     /// Implements Fjt::values()
     double* values(int J, double T) override;
+    /// Implements Fjt::batch_values(), with the Taylor sums of each argument vectorized over j
+    void batch_values(int J, size_t n, const double* T, const double* rho, double* F) override;
 
    private:
     double** grid_;    /* Table of "exact" Fm(T) values. Row index corresponds to
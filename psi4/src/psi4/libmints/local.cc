@@ -44,6 +44,46 @@ using namespace psi;
 
 namespace psi {
 
+namespace {
+
+// Rounds of disjoint pairs covering every pair of players once (round-robin tournament, circle method)
+std::vector<std::vector<std::pair<int, int> > > tournament_rounds(std::vector<int> players) {
+    if (players.size() % 2) players.push_back(-1);
+    size_t n = players.size();
+
+    std::vector<std::vector<std::pair<int, int> > > rounds;
+    for (size_t r = 0; r + 1 < n; r++) {
+        std::vector<std::pair<int, int> > round;
+        for (size_t k = 0; k < n / 2; k++) {
+            int i = players[k];
+            int j = players[n - 1 - k];
+            if (i >= 0 && j >= 0) round.emplace_back(i, j);
+        }
+        rounds.push_back(round);
+        // the first player stays, the others move one seat
+        std::rotate(players.begin() + 1, players.end() - 1, players.end());
+    }
+    return rounds;
+}
+
+// Seeded random permutation of 0 .. n-1
+std::vector<int> random_order(int n) {
+    std::vector<int> order;
+    for (int i = 0; i < n; i++) {
+        order.push_back(i);
+    }
+    std::vector<int> order2;
+    for (int i = 0; i < n; i++) {
+        int pivot = (1L * (n - i) * rand()) / RAND_MAX;
+        int i2 = order[pivot];
+        order[pivot] = order[n - i - 1];
+        order2.push_back(i2);
+    }
+    return order2;
+}
+
+}  // namespace
+
 Localizer::Localizer(std::shared_ptr<BasisSet> primary, std::shared_ptr<Matrix> C) : primary_(primary), C_(C) {
     if (C->nirrep() != 1) {
         throw PSIEXCEPTION("Localizer: C matrix is not C1");
@@ -62,6 +102,32 @@ void Localizer::common_init() {
     maxiter_ = 50;
     converged_ = false;
 }
+std::shared_ptr<Matrix> Localizer::initial_rotation() const {
+    int nso = C_->rowspi()[0];
+    int nmo = C_->colspi()[0];
+
+    auto U = std::make_shared<Matrix>("U", nmo, nmo);
+    if (!guess_) {
+        U->identity();
+        return U;
+    }
+    if (guess_->nirrep() != 1 || guess_->rowspi()[0] != nso || guess_->colspi()[0] != nmo) {
+        throw PSIEXCEPTION("Localizer: guess orbitals do not match the C matrix");
+    }
+
+    auto fact = std::make_shared<IntegralFactory>(primary_);
+    std::shared_ptr<OneBodyAOInt> Sint(fact->ao_overlap());
+    auto S = std::make_shared<Matrix>("S", nso, nso);
+    Sint->compute(S);
+
+    // Project the guess onto the span of C and orthonormalize (Lowdin) to the closest rotation
+    U = linalg::triplet(C_, S, guess_, true, false, false);
+    auto M = linalg::doublet(U, U, true, false);
+    M->power(-0.5);
+    U = linalg::doublet(U, M);
+    U->set_name("U");
+    return U;
+}
 std::shared_ptr<Localizer> Localizer::build(const std::string& type, std::shared_ptr<BasisSet> primary,
                                             std::shared_ptr<Matrix> C, Options& options) {
     std::shared_ptr<Localizer> local;
@@ -187,6 +253,18 @@ void BoysLocalizer::localize() {
 
     if (nmo < 1) return;
 
+    // => Warm start, U_ holds the transpose of the rotation until the end <= //
+
+    if (guess_) {
+        outfile->Printf("    Starting from the guess orbitals.\n\n");
+        auto U0 = initial_rotation();
+        for (int xyz = 0; xyz < 3; xyz++) {
+            Dmo[xyz] = linalg::triplet(U0, Dmo[xyz], U0, true, false, false);
+        }
+        U_ = U0->transpose();
+        U_->set_name("U");
+    }
+
     // => Pointers <= //
 
     std::vector<double**> Dp;
@@ -215,88 +293,76 @@ void BoysLocalizer::localize() {
 
     // ==> Master Loop <== //
 
-    double Ad, Ao, a, b, c, Hd, Ho, theta, cc, ss;
-
     for (int iter = 1; iter <= maxiter_; iter++) {
-        // => Random Permutation <= //
-
-        std::vector<int> order;
-        for (int i = 0; i < nmo; i++) {
-            order.push_back(i);
-        }
-        std::vector<int> order2;
-        for (int i = 0; i < nmo; i++) {
-            int pivot = (1L * (nmo - i) * rand()) / RAND_MAX;
-            int i2 = order[pivot];
-            order[pivot] = order[nmo - i - 1];
-            order2.push_back(i2);
-        }
+        // => Jacobi sweep, in rounds of disjoint pairs over a random permutation <= //
 
-        // => Jacobi sweep <= //
+        for (const auto& round : tournament_rounds(random_order(nmo))) {
+            int npair = round.size();
+            std::vector<double> cs(npair), sn(npair);
 
-        for (int i2 = 0; i2 < nmo - 1; i2++) {
-            for (int j2 = i2 + 1; j2 < nmo; j2++) {
-                int i = order2[i2];
-                int j = order2[j2];
-
-                // > Compute the rotation < //
+            // > Compute each rotation and apply it to the rows of A^k and Q < //
+#pragma omp parallel for schedule(static)
+            for (int p = 0; p < npair; p++) {
+                int i = round[p].first;
+                int j = round[p].second;
 
                 // H elements
-                a = 0.0;
-                b = 0.0;
-                c = 0.0;
+                double a = 0.0;
+                double b = 0.0;
+                double c = 0.0;
                 for (int xyz = 0; xyz < 3; xyz++) {
                     double** Ak = Dp[xyz];
-                    Ad = (Ak[i][i] - Ak[j][j]);
-                    Ao = 2.0 * Ak[i][j];
+                    double Ad = (Ak[i][i] - Ak[j][j]);
+                    double Ao = 2.0 * Ak[i][j];
                     a += Ad * Ad;
                     b += Ao * Ao;
                     c += Ad * Ao;
                 }
 
                 // Theta
-                Hd = a - b;
-                Ho = 2.0 * c;
-                theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
+                double Hd = a - b;
+                double Ho = 2.0 * c;
+                double theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
 
                 // Check for trivial (maximal) rotation, which might be better with theta = pi/4
                 if (std::fabs(theta) < 1.0E-8) {
                     double O0 = 0.0;
                     double O1 = 0.0;
-                    ;
                     for (int xyz = 0; xyz < 3; xyz++) {
                         double** Ak = Dp[xyz];
                         O0 += Ak[i][j] * Ak[i][j];
                         O1 += 0.25 * (Ak[j][j] - Ak[i][i]) * (Ak[j][j] - Ak[i][i]);
                     }
-                    if (O1 < O0) {
-                        theta = M_PI / 4.0;
-                        if (debug_ > 3) {
-                            outfile->Printf("@Break\n");
-                        }
-                    }
+                    if (O1 < O0) theta = M_PI / 4.0;
                 }
 
                 // Givens rotation
-                cc = cos(theta);
-                ss = sin(theta);
+                cs[p] = cos(theta);
+                sn[p] = sin(theta);
 
-                if (debug_ > 3) {
-                    outfile->Printf("@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", i, j, theta);
-                    outfile->Printf("@Info, a = %24.16E, b = %24.16E, c = %24.16E\n", a, b, c);
+                for (int xyz = 0; xyz < 3; xyz++) {
+                    double** Ak = Dp[xyz];
+                    C_DROT(nmo, &Ak[i][0], 1, &Ak[j][0], 1, cs[p], sn[p]);
                 }
+                C_DROT(nmo, Up[i], 1, Up[j], 1, cs[p], sn[p]);
+            }
 
-                // > Apply the rotation < //
-
-                // rows and columns of A^k
+            // > Then to the columns of A^k, once no pair reads them anymore < //
+#pragma omp parallel for schedule(static)
+            for (int p = 0; p < npair; p++) {
+                int i = round[p].first;
+                int j = round[p].second;
                 for (int xyz = 0; xyz < 3; xyz++) {
                     double** Ak = Dp[xyz];
-                    C_DROT(nmo, &Ak[i][0], 1, &Ak[j][0], 1, cc, ss);
-                    C_DROT(nmo, &Ak[0][i], nmo, &Ak[0][j], nmo, cc, ss);
+                    C_DROT(nmo, &Ak[0][i], nmo, &Ak[0][j], nmo, cs[p], sn[p]);
                 }
+            }
 
-                // Q
-                C_DROT(nmo, Up[i], 1, Up[j], 1, cc, ss);
+            if (debug_ > 3) {
+                for (int p = 0; p < npair; p++) {
+                    outfile->Printf("@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", round[p].first, round[p].second,
+                                    atan2(sn[p], cs[p]));
+                }
             }
         }
 
@@ -373,6 +439,17 @@ void PMLocalizer::localize() {
 
     if (nmo < 1) return;
 
+    // => Warm start, U_ holds the transpose of the rotation until the end <= //
+
+    if (guess_) {
+        outfile->Printf("    Starting from the guess orbitals.\n\n");
+        auto U0 = initial_rotation();
+        L_ = linalg::doublet(C_, U0);
+        L_->set_name("L");
+        U_ = U0->transpose();
+        U_->set_name("U");
+    }
+
     // => Pointers <= //
 
     double** Lp = L_->pointer();
@@ -419,87 +496,56 @@ void PMLocalizer::localize() {
 
     // ==> Master Loop <== //
 
-    double Aii, Ajj, Aij, Ad, Ao, a, b, c, Hd, Ho, theta, cc, ss;
-
     for (int iter = 1; iter <= maxiter_; iter++) {
-        // => Random Permutation <= //
+        // => Jacobi sweep, in rounds of disjoint pairs over a random permutation <= //
 
-        std::vector<int> order;
-        for (int i = 0; i < nmo; i++) {
-            order.push_back(i);
-        }
-        std::vector<int> order2;
-        for (int i = 0; i < nmo; i++) {
-            int pivot = (1L * (nmo - i) * rand()) / RAND_MAX;
-            int i2 = order[pivot];
-            order[pivot] = order[nmo - i - 1];
-            order2.push_back(i2);
-        }
+        for (const auto& round : tournament_rounds(random_order(nmo))) {
+            int npair = round.size();
+            std::vector<double> thetas(npair);
 
-        // => Jacobi sweep <= //
-
-        for (int i2 = 0; i2 < nmo - 1; i2++) {
-            for (int j2 = i2 + 1; j2 < nmo; j2++) {
-                int i = order2[i2];
-                int j = order2[j2];
+            // Each pair only touches its own columns of LS and L and rows of Q
+#pragma omp parallel for schedule(static)
+            for (int p = 0; p < npair; p++) {
+                int i = round[p].first;
+                int j = round[p].second;
 
                 // > Compute the rotation < //
 
                 // H elements
-                a = 0.0;
-                b = 0.0;
-                c = 0.0;
+                double a = 0.0;
+                double b = 0.0;
+                double c = 0.0;
+                double O0 = 0.0;
+                double O1 = 0.0;
                 for (int A = 0; A < nA; A++) {
                     int nm = Astarts[A + 1] - Astarts[A];
                     int off = Astarts[A];
-                    Aii = C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][i], nmo);
-                    Ajj = C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][j], nmo);
-                    Aij = 0.5 * C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][j], nmo) +
-                          0.5 * C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][i], nmo);
+                    double Aii = C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][i], nmo);
+                    double Ajj = C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][j], nmo);
+                    double Aij = 0.5 * C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][j], nmo) +
+                                 0.5 * C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][i], nmo);
 
-                    Ad = (Aii - Ajj);
-                    Ao = 2.0 * Aij;
+                    double Ad = (Aii - Ajj);
+                    double Ao = 2.0 * Aij;
                     a += Ad * Ad;
                     b += Ao * Ao;
                     c += Ad * Ao;
+                    O0 += Aij * Aij;
+                    O1 += 0.25 * (Ajj - Aii) * (Ajj - Aii);
                 }
 
                 // Theta
-                Hd = a - b;
-                Ho = 2.0 * c;
-                theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
+                double Hd = a - b;
+                double Ho = 2.0 * c;
+                double theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
 
                 // Check for trivial (maximal) rotation, which might be better with theta = pi/4
-                if (std::fabs(theta) < 1.0E-8) {
-                    double O0 = 0.0;
-                    double O1 = 0.0;
-                    ;
-                    for (int A = 0; A < nA; A++) {
-                        int nm = Astarts[A + 1] - Astarts[A];
-                        int off = Astarts[A];
-                        Aii = C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][i], nmo);
-                        Ajj = C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][j], nmo);
-                        Aij = 0.5 * C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][j], nmo) +
-                              0.5 * C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][i], nmo);
-                        O0 += Aij * Aij;
-                        O1 += 0.25 * (Ajj - Aii) * (Ajj - Aii);
-                    }
-                    if (O1 < O0) {
-                        theta = M_PI / 4.0;
-                        if (debug_ > 3) {
-                            outfile->Printf("@Break\n");
-                        }
-                    }
-                }
+                if (std::fabs(theta) < 1.0E-8 && O1 < O0) theta = M_PI / 4.0;
+                thetas[p] = theta;
 
                 // Givens rotation
-                cc = cos(theta);
-                ss = sin(theta);
-
-                if (debug_ > 3) {
-                    outfile->Printf("@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", i, j, theta);
-                    outfile->Printf("@Info, a = %24.16E, b = %24.16E, c = %24.16E\n", a, b, c);
-                }
+                double cc = cos(theta);
+                double ss = sin(theta);
 
                 // > Apply the rotation < //
 
@@ -510,6 +556,13 @@ void PMLocalizer::localize() {
                 // Q
                 C_DROT(nmo, Up[i], 1, Up[j], 1, cc, ss);
             }
+
+            if (debug_ > 3) {
+                for (int p = 0; p < npair; p++) {
+                    outfile->Printf("@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", round[p].first, round[p].second,
+                                    thetas[p]);
+                }
+            }
         }
 
         // => Metric <= //
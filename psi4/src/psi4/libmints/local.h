@@ -62,6 +62,8 @@ class PSI_API Localizer {
     std::shared_ptr<BasisSet> primary_;
     /// Delocalized Orbitals
     std::shared_ptr<Matrix> C_;
+    /// Localized orbitals of a previous, similar localization to start from (optional)
+    std::shared_ptr<Matrix> guess_;
 
     // => Targets <= //
 
@@ -75,6 +77,9 @@ class PSI_API Localizer {
     /// Set defaults
     void common_init();
 
+    /// Starting MO -> LO rotation: C^T S guess_, orthonormalized, or the identity without a guess
+    std::shared_ptr<Matrix> initial_rotation() const;
+
    public:
     // => Constructors <= //
 
@@ -122,6 +127,9 @@ class PSI_API Localizer {
     void set_convergence(double convergence) { convergence_ = convergence; }
 
     void set_maxiter(int maxiter) { maxiter_ = maxiter; }
+
+    /// Start from the localized orbitals L (nso x nmo) of a previous localization, e.g., the last geometry
+    void set_guess(std::shared_ptr<Matrix> L) { guess_ = L; }
 };
 
 class PSI_API BoysLocalizer : public Localizer {
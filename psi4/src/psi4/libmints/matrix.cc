@@ -434,10 +434,46 @@ void Matrix::release() {
     if (!matrix_) return;
 
     for (int h = 0; h < nirrep_; ++h) {
-        if (matrix_[h]) linalg::detail::free(matrix_[h]);
+        if (!matrix_[h]) continue;
+        // Adopted blocks belong to external_, only the row pointers are ours
+        if (external_)
+            ::free(matrix_[h]);
+        else
+            linalg::detail::free(matrix_[h]);
     }
     ::free(matrix_);
     matrix_ = nullptr;
+    external_.reset();
+}
+
+void Matrix::adopt(const Dimension &rows, const Dimension &cols, const std::vector<double *> &blocks,
+                   std::shared_ptr<void> owner, int symmetry) {
+    if (rows.n() != cols.n() || (size_t)rows.n() != blocks.size())
+        throw PSIEXCEPTION("Matrix::adopt: Dimensions and blocks must have one entry per irrep.");
+    for (int h = 0; h < rows.n(); ++h) {
+        if (rows[h] != 0 && cols[h ^ symmetry] != 0 && blocks[h] == nullptr)
+            throw PSIEXCEPTION("Matrix::adopt: Nonempty block without data.");
+    }
+
+    release();
+    nirrep_ = rows.n();
+    symmetry_ = symmetry;
+    rowspi_ = rows;
+    colspi_ = cols;
+    if (!nirrep_) return;
+
+    matrix_ = (double ***)malloc(sizeof(double ***) * nirrep_);
+    for (int h = 0; h < nirrep_; ++h) {
+        int nrow = rowspi_[h];
+        int ncol = colspi_[h ^ symmetry_];
+        if (nrow == 0 || ncol == 0) {
+            matrix_[h] = nullptr;
+            continue;
+        }
+        matrix_[h] = (double **)malloc(sizeof(double *) * nrow);
+        for (int r = 0; r < nrow; ++r) matrix_[h][r] = blocks[h] + r * (size_t)ncol;
+    }
+    external_ = std::move(owner);
 }
 
 void Matrix::copy_from(double ***c) {
@@ -1319,6 +1355,7 @@ void Matrix::gemm(const char &transa, const char &transb, const std::vector<int>
     if (nirrep_ != a->nirrep_ || nirrep_ != b->nirrep_)
         throw PSIEXCEPTION("Matrix::Advanced GEMM: Number of irreps do not equal.");
 
+    std::vector<DGEMMTask> gemms;
     for (int h = 0; h < nirrep_; ++h) {
         if (!k[h] || !m[h] || !n[h]) continue;
 
@@ -1328,9 +1365,10 @@ void Matrix::gemm(const char &transa, const char &transb, const std::vector<int>
         offb = offset_b.size() == 0 ? 0 : offset_b[h];
         offc = offset_c.size() == 0 ? 0 : offset_c[h];
 
-        C_DGEMM(transa, transb, m[h], n[h], k[h], alpha, &a->matrix_[h][0][offa], lda[h], &b->matrix_[h][0][offb],
-                ldb[h], beta, &matrix_[h][0][offc], ldc[h]);
+        gemms.push_back({transa, transb, m[h], n[h], k[h], alpha, &a->matrix_[h][0][offa], lda[h],
+                         &b->matrix_[h][0][offb], ldb[h], beta, &matrix_[h][0][offc], ldc[h]});
     }
+    C_DGEMM_BATCH(gemms);
 }
 
 void Matrix::gemm(const char &transa, const char &transb, const int &m, const int &n, const int &k, const double &alpha,
@@ -1362,6 +1400,8 @@ void Matrix::gemm(bool transa, bool transb, double alpha, const Matrix *const a,
     int symlink = (!transa ? a->symmetry() : 0);
     auto nlink = (!transa ? a->colspi() : a->rowspi());
 
+    // The irrep blocks are independent products, done as one batch
+    std::vector<DGEMMTask> gemms;
     for (int Ha = 0; Ha < nirrep_; ++Ha) {
         int Hb = Ha ^ (transa ? 0 : a->symmetry()) ^ (transb ? b->symmetry() : 0);
         int Hc = Ha ^ (transa ? a->symmetry() : 0);
@@ -1389,10 +1429,11 @@ void Matrix::gemm(bool transa, bool transb, double alpha, const Matrix *const a,
             throw PSIEXCEPTION("Matrix::gemm error: Number of rows and columns do not match.");
         }
         if (m && n && k) {
-            C_DGEMM(ta, tb, m, n, k, alpha, &(a->matrix_[Ha][0][0]), lda, &(b->matrix_[Hb][0][0]), ldb, beta,
-                    &(matrix_[Hc][0][0]), ldc);
+            gemms.push_back({ta, tb, m, n, k, alpha, &(a->matrix_[Ha][0][0]), lda, &(b->matrix_[Hb][0][0]), ldb, beta,
+                             &(matrix_[Hc][0][0]), ldc});
         }
     }
+    C_DGEMM_BATCH(gemms);
 }
 
 void Matrix::gemm(bool transa, bool transb, double alpha, const SharedMatrix &a, const SharedMatrix &b, double beta) {
@@ -1429,6 +1470,28 @@ void Matrix::axpy(double a, SharedMatrix X) {
     }
 }
 
+void Matrix::axpby(double a, SharedMatrix X, double b) {
+    if (nirrep_ != X->nirrep()) {
+        throw PSIEXCEPTION("Matrix::axpby: Matrices do not have the same nirreps");
+    }
+    for (int h = 0; h < nirrep_; h++) {
+        size_t size = colspi_[h ^ symmetry()] * (size_t)rowspi_[h];
+        size_t size_X = X->colspi()[h ^ X->symmetry()] * (size_t)X->rowspi()[h];
+        if (size != size_X) {
+            throw PSIEXCEPTION("Matrix::axpby: Matrices sizes do not match.");
+        }
+        if (size) {
+            double *Xp = X->pointer(h)[0];
+            double *Yp = matrix_[h][0];
+            if (b == 1.0) {
+                C_DAXPY(size, a, Xp, 1, Yp, 1);
+            } else {
+                for (size_t i = 0; i < size; i++) Yp[i] = a * Xp[i] + b * Yp[i];
+            }
+        }
+    }
+}
+
 SharedVector Matrix::gemv(bool transa, double alpha, const Vector& A) {
     auto return_vec = std::make_shared<Vector>(transa ? colspi_ : rowspi_);
     return_vec->gemv(transa, alpha, *this, A, 0);
@@ -1550,9 +1613,13 @@ bool Matrix::add_and_orthogonalize_row(const SharedVector v) {
     size_t n = colspi_[0] * (size_t)rowspi_[0] * sizeof(double);
     if (n) {
         ::memcpy(mat[0], matrix_[0][0], n);
-        linalg::detail::free(matrix_[0]);
+        if (external_)
+            ::free(matrix_[0]);
+        else
+            linalg::detail::free(matrix_[0]);
     }
     matrix_[0] = mat;
+    external_.reset();
     bool ret = schmidt_add_row(0, rowspi_[0], v_copy);
     rowspi_[0]++;
     return ret;
@@ -3543,16 +3610,20 @@ namespace detail {
 /// allocate a block matrix -- analogous to libciomr's block_matrix
 double **matrix(int nrow, int ncol) {
     double **mat = (double **)malloc(sizeof(double *) * nrow);
-    const size_t size = sizeof(double) * nrow * (size_t)ncol;
-    mat[0] = (double *)malloc(size);
-    ::memset((void *)mat[0], 0, size);
+    if (block_pool_enabled()) {
+        mat[0] = block_pool_alloc(nrow * (size_t)ncol);
+    } else {
+        const size_t size = sizeof(double) * nrow * (size_t)ncol;
+        mat[0] = (double *)malloc(size);
+        ::memset((void *)mat[0], 0, size);
+    }
     for (int r = 1; r < nrow; ++r) mat[r] = mat[r - 1] + ncol;
     return mat;
 }
 
 /// free a (block) matrix -- analogous to libciomr's free_block
 void free(double **Block) {
-    ::free(Block[0]);
+    if (!block_pool_free(Block[0])) ::free(Block[0]);
     ::free(Block);
 }
 }  // namespace detail
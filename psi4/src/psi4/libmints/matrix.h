@@ -143,6 +143,9 @@ class PSI_API Matrix : public std::enable_shared_from_this<Matrix> {
     /// Numpy Shape
     std::vector<int> numpy_shape_;
 
+    /// Keeps adopted storage alive (see adopt()); matrix_ blocks then point into it and are not freed here
+    std::shared_ptr<void> external_;
+
    public:
     /// Default constructor, zeros everything out
     Matrix();
@@ -843,6 +846,14 @@ class PSI_API Matrix : public std::enable_shared_from_this<Matrix> {
      */
     void axpy(double a, SharedMatrix X);
 
+    /**
+     * Fused scale and AXPY with support for irreps Y = a * X + b * Y, in one pass over Y
+     * @param a Scaling parameter of X
+     * @param X Matrix to be be added
+     * @param b Scaling parameter of this matrix
+     */
+    void axpby(double a, SharedMatrix X, double b);
+
     /**
      * General matrix vector multiplication into this, alpha * AX + beta Y -> Y
      *
@@ -1143,6 +1154,22 @@ class PSI_API Matrix : public std::enable_shared_from_this<Matrix> {
     void set_numpy_shape(std::vector<int> shape) { numpy_shape_ = shape; }
     std::vector<int> numpy_shape() { return numpy_shape_; }
 
+    /**
+     * Uses external storage as the data of this matrix instead of copying it.
+     * Block h is the row-major rows[h] x cols[h ^ symmetry] array at blocks[h]
+     * (may be nullptr if empty). The matrix holds on to owner until the data is
+     * released, so the storage outlives every use through this object.
+     * @param rows - rows per irrep
+     * @param cols - columns per irrep
+     * @param blocks - first element of each irrep block
+     * @param owner - keeps the storage alive
+     * @param symmetry - symmetry of the matrix
+     */
+    void adopt(const Dimension& rows, const Dimension& cols, const std::vector<double*>& blocks,
+               std::shared_ptr<void> owner, int symmetry = 0);
+    /// Whether the data was allocated by this matrix rather than adopted
+    bool owns_data() const { return !external_; }
+
     /**
      * Rotates columns i and j in irrep h, by an angle theta
      * @param h - the irrep in which the rotation will be applied
@@ -51,6 +51,7 @@
 #include "psi4/libpsi4util/process.h"
 #include "electricfield.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <cmath>
@@ -798,12 +799,21 @@ SharedMatrix MintsHelper::ao_helper(const std::string &label, std::shared_ptr<Tw
     auto I = std::make_shared<Matrix>(label, nbf1 * nbf2, nbf3 * nbf4);
     double **Ip = I->pointer();
 
+    std::vector<std::shared_ptr<TwoBodyAOInt>> tb(1, ints);
+    for (int i = 1; i < nthread_; ++i) tb.push_back(std::shared_ptr<TwoBodyAOInt>(ints->clone()));
+
+    // Each (M,N) bra pair owns its rows of I, so threads never write to the same element
+#pragma omp parallel for collapse(2) schedule(dynamic) num_threads(nthread_)
     for (int M = 0; M < bs1->nshell(); M++) {
         for (int N = 0; N < bs2->nshell(); N++) {
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
             for (int P = 0; P < bs3->nshell(); P++) {
                 for (int Q = 0; Q < bs4->nshell(); Q++) {
-                    ints->compute_shell(M, N, P, Q);
-                    const double *buffer = ints->buffer();
+                    tb[rank]->compute_shell(M, N, P, Q);
+                    const double *buffer = tb[rank]->buffer();
 
                     for (int m = 0, index = 0; m < bs1->shell(M).nfunction(); m++) {
                         for (int n = 0; n < bs2->shell(N).nfunction(); n++) {
@@ -828,6 +838,100 @@ SharedMatrix MintsHelper::ao_helper(const std::string &label, std::shared_ptr<Tw
     return I;
 }
 
+ShellQuartetBlocks::ShellQuartetBlocks(std::shared_ptr<BasisSet> basis, std::vector<std::array<int, 4>> quartets)
+    : basis_(basis), quartets_(std::move(quartets)) {
+    offsets_.resize(quartets_.size() + 1);
+    offsets_[0] = 0;
+    for (size_t i = 0; i < quartets_.size(); ++i) {
+        const auto &q = quartets_[i];
+        size_t size = 1;
+        for (int k = 0; k < 4; ++k) size *= basis_->shell(q[k]).nfunction();
+        offsets_[i + 1] = offsets_[i] + size;
+        index_[key(q[0], q[1], q[2], q[3])] = i;
+    }
+    data_.resize(offsets_.back(), 0.0);
+}
+
+size_t ShellQuartetBlocks::key(int M, int N, int P, int Q) const {
+    size_t nshell = basis_->nshell();
+    return ((M * nshell + N) * nshell + P) * nshell + Q;
+}
+
+std::array<size_t, 4> ShellQuartetBlocks::shape(size_t i) const {
+    const auto &q = quartets_[i];
+    return {{(size_t)basis_->shell(q[0]).nfunction(), (size_t)basis_->shell(q[1]).nfunction(),
+             (size_t)basis_->shell(q[2]).nfunction(), (size_t)basis_->shell(q[3]).nfunction()}};
+}
+
+long int ShellQuartetBlocks::find(int M, int N, int P, int Q) const {
+    if (M < N) std::swap(M, N);
+    if (P < Q) std::swap(P, Q);
+    if (M * (M + 1L) / 2 + N < P * (P + 1L) / 2 + Q) {
+        std::swap(M, P);
+        std::swap(N, Q);
+    }
+    auto it = index_.find(key(M, N, P, Q));
+    return it == index_.end() ? -1L : (long int)it->second;
+}
+
+std::shared_ptr<ShellQuartetBlocks> MintsHelper::ao_eri_blocks(std::shared_ptr<IntegralFactory> input_factory) {
+    std::shared_ptr<IntegralFactory> factory;
+    if (input_factory) {
+        factory = input_factory;
+    } else {
+        factory = integral_;
+    }
+
+    std::vector<std::shared_ptr<TwoBodyAOInt>> tb;
+    tb.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+    std::shared_ptr<BasisSet> bs = tb[0]->basis1();
+    if (tb[0]->basis2() != bs || tb[0]->basis3() != bs || tb[0]->basis4() != bs) {
+        throw PSIEXCEPTION("MintsHelper::ao_eri_blocks: all four basis sets must be the same.");
+    }
+    for (int i = 1; i < nthread_; ++i) tb.push_back(std::shared_ptr<TwoBodyAOInt>(tb[0]->clone()));
+
+    // Screen first, so that the storage is laid out once
+    const auto &pairs = tb[0]->shell_pairs();
+    size_t npairs = pairs.size();
+    std::vector<std::vector<std::array<int, 4>>> thread_quartets(nthread_);
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (size_t MN = 0; MN < npairs; MN++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        int M = pairs[MN].first;
+        int N = pairs[MN].second;
+        for (size_t PQ = 0; PQ <= MN; PQ++) {
+            int P = pairs[PQ].first;
+            int Q = pairs[PQ].second;
+            if (tb[rank]->shell_significant(M, N, P, Q)) thread_quartets[rank].push_back({{M, N, P, Q}});
+        }
+    }
+
+    std::vector<std::array<int, 4>> quartets;
+    for (const auto &list : thread_quartets) quartets.insert(quartets.end(), list.begin(), list.end());
+    thread_quartets.clear();
+    std::sort(quartets.begin(), quartets.end());
+
+    auto blocks = std::make_shared<ShellQuartetBlocks>(bs, std::move(quartets));
+    size_t nquartet = blocks->nquartet();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (size_t i = 0; i < nquartet; i++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        const auto &q = blocks->quartet(i);
+        if (tb[rank]->compute_shell(q[0], q[1], q[2], q[3]) == 0) continue;
+        const double *buffer = tb[rank]->buffer();
+        std::copy(buffer, buffer + (blocks->offset(i + 1) - blocks->offset(i)), blocks->block(i));
+    }
+
+    return blocks;
+}
+
 SharedMatrix MintsHelper::ao_shell_getter(const std::string &label, std::shared_ptr<TwoBodyAOInt> ints, int M, int N,
                                           int P, int Q) {
     int mfxn = basisset_->shell(M).nfunction();
@@ -1041,7 +1145,7 @@ SharedMatrix MintsHelper::mo_f12_double_commutator(std::vector<std::pair<double,
 }
 
 SharedMatrix MintsHelper::mo_eri(SharedMatrix C1, SharedMatrix C2, SharedMatrix C3, SharedMatrix C4) {
-    SharedMatrix mo_ints = mo_eri_helper(ao_eri(), C1, C2, C3, C4);
+    SharedMatrix mo_ints = mo_eri_direct(std::shared_ptr<TwoBodyAOInt>(integral_->eri()), C1, C2, C3, C4);
     mo_ints->set_name("MO ERI Tensor");
     return mo_ints;
 }
@@ -1053,11 +1157,182 @@ SharedMatrix MintsHelper::mo_erf_eri(double omega, SharedMatrix Co, SharedMatrix
 }
 
 SharedMatrix MintsHelper::mo_eri(SharedMatrix Co, SharedMatrix Cv) {
-    SharedMatrix mo_ints = mo_eri_helper(ao_eri(), Co, Cv);
+    SharedMatrix mo_ints = mo_eri_direct(std::shared_ptr<TwoBodyAOInt>(integral_->eri()), Co, Cv, Co, Cv);
     mo_ints->set_name("MO ERI Tensor");
     return mo_ints;
 }
 
+SharedMatrix MintsHelper::mo_eri_direct(std::shared_ptr<TwoBodyAOInt> ints, SharedMatrix C1, SharedMatrix C2,
+                                        SharedMatrix C3, SharedMatrix C4) {
+    return mo_eri_direct(ints, std::vector<std::vector<SharedMatrix>>{{C1, C2, C3, C4}})[0];
+}
+
+std::vector<SharedMatrix> MintsHelper::mo_eri(const std::vector<std::vector<SharedMatrix>> &requests) {
+    std::vector<SharedMatrix> mo_ints = mo_eri_direct(std::shared_ptr<TwoBodyAOInt>(integral_->eri()), requests);
+    for (auto &I : mo_ints) I->set_name("MO ERI Tensor");
+    return mo_ints;
+}
+
+std::vector<SharedMatrix> MintsHelper::mo_eri_direct(std::shared_ptr<TwoBodyAOInt> ints,
+                                                     const std::vector<std::vector<SharedMatrix>> &requests) {
+    std::shared_ptr<BasisSet> bs = ints->basis1();
+    int nbf = bs->nbf();
+    size_t nreq = requests.size();
+    for (const auto &req : requests) {
+        if (req.size() != 4) throw PSIEXCEPTION("MintsHelper::mo_eri: each request needs four coefficient matrices.");
+    }
+
+    // Plan: (ij|kl) = (kl|ij), so a request is flipped when only its bra pair is already somebody's ket.
+    // Each distinct ket (C3, C4) is half-transformed once; distinct C4 are stacked so the first quarter
+    // transformation of all kets is a single GEMM per AO shell quartet.
+    using Pair = std::pair<Matrix *, Matrix *>;
+    std::vector<Pair> kets;
+    std::vector<bool> flip(nreq, false);
+    std::vector<int> req_ket(nreq);
+    auto find_ket = [&kets](const Pair &p) { return std::find(kets.begin(), kets.end(), p) - kets.begin(); };
+    for (size_t r = 0; r < nreq; r++) {
+        Pair bra(requests[r][0].get(), requests[r][1].get());
+        Pair ket(requests[r][2].get(), requests[r][3].get());
+        if (find_ket(ket) == (long)kets.size() && find_ket(bra) < (long)kets.size()) flip[r] = true;
+        Pair use = flip[r] ? bra : ket;
+        req_ket[r] = find_ket(use);
+        if (req_ket[r] == (int)kets.size()) kets.push_back(use);
+    }
+    size_t nket = kets.size();
+
+    std::vector<Matrix *> C4s;
+    std::vector<int> C4_off(nket);
+    int n4all = 0;
+    for (size_t k = 0; k < nket; k++) {
+        auto it = std::find(C4s.begin(), C4s.end(), kets[k].second);
+        if (it == C4s.end()) {
+            C4_off[k] = n4all;
+            C4s.push_back(kets[k].second);
+            n4all += kets[k].second->colspi()[0];
+        } else {
+            int off = 0;
+            for (auto jt = C4s.begin(); jt != it; ++jt) off += (*jt)->colspi()[0];
+            C4_off[k] = off;
+        }
+    }
+    auto C4all = std::make_shared<Matrix>("Stacked C4", nbf, n4all);
+    for (size_t c = 0, off = 0; c < C4s.size(); c++) {
+        int n = C4s[c]->colspi()[0];
+        for (int m = 0; m < nbf; m++) std::copy_n(C4s[c]->pointer()[m], n, C4all->pointer()[m] + off);
+        off += n;
+    }
+    double **C4p = C4all->pointer();
+
+    std::vector<std::shared_ptr<TwoBodyAOInt>> tb(1, ints);
+    for (int i = 1; i < nthread_; ++i) tb.push_back(std::shared_ptr<TwoBodyAOInt>(ints->clone()));
+
+    // (mn|kl) for each ket, ket transformed; each significant bra shell pair owns its rows
+    std::vector<SharedMatrix> Ihalf(nket);
+    for (size_t k = 0; k < nket; k++) {
+        size_t n34 = kets[k].first->colspi()[0] * (size_t)kets[k].second->colspi()[0];
+        Ihalf[k] = std::make_shared<Matrix>("MO ERI Tensor", nbf * nbf, n34);
+    }
+
+    const auto &pairs = ints->shell_pairs();
+    size_t npairs = pairs.size();
+    size_t maxf = bs->max_function_per_shell();
+    // (mn|p l) for one bra shell pair, l over all stacked C4
+    std::vector<std::vector<double>> Z(nthread_, std::vector<double>(maxf * maxf * nbf * n4all));
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (size_t MN = 0; MN < npairs; MN++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        int M = pairs[MN].first;
+        int N = pairs[MN].second;
+        int nM = bs->shell(M).nfunction();
+        int nN = bs->shell(N).nfunction();
+        int oM = bs->shell(M).function_index();
+        int oN = bs->shell(N).function_index();
+
+        double *Zp = Z[rank].data();
+        std::fill_n(Zp, nM * nN * (size_t)nbf * n4all, 0.0);
+
+        for (size_t PQ = 0; PQ < npairs; PQ++) {
+            int P = pairs[PQ].first;
+            int Q = pairs[PQ].second;
+            if (!tb[rank]->shell_significant(M, N, P, Q)) continue;
+            if (tb[rank]->compute_shell(M, N, P, Q) == 0) continue;
+            double *buffer = const_cast<double *>(tb[rank]->buffer());
+
+            int nP = bs->shell(P).nfunction();
+            int nQ = bs->shell(Q).nfunction();
+            int oP = bs->shell(P).function_index();
+            int oQ = bs->shell(Q).function_index();
+            for (int mn = 0; mn < nM * nN; mn++) {
+                double *B = buffer + mn * nP * nQ;
+                double *Zmn = Zp + mn * (size_t)nbf * n4all;
+                C_DGEMM('N', 'N', nP, n4all, nQ, 1.0, B, nQ, C4p[oQ], n4all, 1.0, Zmn + oP * (size_t)n4all, n4all);
+                if (P != Q)
+                    C_DGEMM('T', 'N', nQ, n4all, nP, 1.0, B, nQ, C4p[oP], n4all, 1.0, Zmn + oQ * (size_t)n4all,
+                            n4all);
+            }
+        }
+
+        for (size_t k = 0; k < nket; k++) {
+            double **C3p = kets[k].first->pointer();
+            int n3 = kets[k].first->colspi()[0];
+            int n4 = kets[k].second->colspi()[0];
+            size_t n34 = n3 * (size_t)n4;
+            double **Ihp = Ihalf[k]->pointer();
+            for (int m = 0; m < nM; m++) {
+                for (int n = 0; n < nN; n++) {
+                    double *Zmn = Zp + (m * nN + n) * (size_t)nbf * n4all;
+                    double *row = Ihp[(oM + m) * nbf + oN + n];
+                    C_DGEMM('T', 'N', n3, n4, nbf, 1.0, C3p[0], n3, Zmn + C4_off[k], n4all, 0.0, row, n4);
+                    if (M != N) std::copy(row, row + n34, Ihp[(oN + n) * nbf + oM + m]);
+                }
+            }
+        }
+    }
+    Z.clear();
+    tb.clear();
+
+    // Bra transformations, ket by ket, releasing each half-transformed block after its last request
+    std::vector<SharedMatrix> results(nreq);
+    for (size_t k = 0; k < nket; k++) {
+        double **Ihp = Ihalf[k]->pointer();
+        size_t n34 = Ihalf[k]->coldim();
+        for (size_t r = 0; r < nreq; r++) {
+            if (req_ket[r] != (int)k) continue;
+            Matrix *C1 = (flip[r] ? requests[r][2] : requests[r][0]).get();
+            Matrix *C2 = (flip[r] ? requests[r][3] : requests[r][1]).get();
+            double **C1p = C1->pointer();
+            double **C2p = C2->pointer();
+            int n1 = C1->colspi()[0];
+            int n2 = C2->colspi()[0];
+
+            // (in|kl), then (ij|kl) one i at a time
+            auto Iq = std::make_shared<Matrix>("MO ERI Tensor", n1, nbf * n34);
+            double **Iqp = Iq->pointer();
+            C_DGEMM('T', 'N', n1, nbf * n34, nbf, 1.0, C1p[0], n1, Ihp[0], nbf * n34, 0.0, Iqp[0], nbf * n34);
+
+            auto Imo = std::make_shared<Matrix>("MO ERI Tensor", n1 * n2, n34);
+            double **Imop = Imo->pointer();
+            for (int i = 0; i < n1; i++) {
+                C_DGEMM('T', 'N', n2, n34, nbf, 1.0, C2p[0], n2, Iqp[i], n34, 0.0, Imop[i * n2], n34);
+            }
+            if (flip[r]) Imo = Imo->transpose();
+
+            // Build numpy and final matrix shape
+            std::vector<int> nshape;
+            for (int c = 0; c < 4; c++) nshape.push_back(requests[r][c]->colspi()[0]);
+            Imo->set_numpy_shape(nshape);
+            results[r] = Imo;
+        }
+        Ihalf[k].reset();
+    }
+
+    return results;
+}
+
 SharedMatrix MintsHelper::mo_eri_helper(SharedMatrix Iso, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3,
                                         SharedMatrix C4) {
     int nso = basisset_->nbf();
@@ -1202,7 +1477,7 @@ SharedMatrix MintsHelper::mo_eri_helper(SharedMatrix Iso, SharedMatrix Co, Share
 SharedMatrix MintsHelper::mo_spin_eri(SharedMatrix Co, SharedMatrix Cv) {
     int n1 = Co->colspi()[0];
     int n2 = Cv->colspi()[0];
-    SharedMatrix mo_ints = mo_eri_helper(ao_eri(), Co, Cv);
+    SharedMatrix mo_ints = mo_eri_direct(std::shared_ptr<TwoBodyAOInt>(integral_->eri()), Co, Cv, Co, Cv);
     SharedMatrix mo_spin_ints = mo_spin_eri_helper(mo_ints, n1, n2);
     mo_ints.reset();
     mo_spin_ints->set_name("MO Spin ERI Tensor");
@@ -1465,7 +1740,7 @@ void MintsHelper::compute_so_x2c_ints(bool include_perturbations) {
 
     X2CInt x2cint;
     x2cint.compute(molecule_, basisset_, get_basisset("BASIS_RELATIVISTIC"), so_overlap_x2c, so_kinetic_x2c,
-                   so_potential_x2c, lambda);
+                   so_potential_x2c, lambda, options_.get_str("X2C_DECOUPLING") == "DLU");
 
     // Overwrite cached integrals
     cached_oe_ints_[std::make_pair(PSIF_SO_S, include_perturbations)] = so_overlap_x2c;
@@ -1717,23 +1992,11 @@ std::vector<SharedMatrix> MintsHelper::electric_field(const std::vector<double>
 }
 
 SharedMatrix MintsHelper::induction_operator(SharedMatrix coords, SharedMatrix moments) {
-    SharedMatrix mat = std::make_shared<Matrix>("Induction operator", basisset_->nbf(), basisset_->nbf());
-    ContractOverDipolesFunctor dipfun(moments, mat);
-    auto field_integrals_ = static_cast<ElectricFieldInt *>(integral_->electric_field());
-    field_integrals_->compute_with_functor(dipfun, coords);
-    mat->scale(-1.0);
-
-    return mat;
+    return SiteFields(basisset_, coords).induction_operator(moments);
 }
 
 SharedMatrix MintsHelper::electric_field_value(SharedMatrix coords, SharedMatrix D) {
-    auto field_integrals_ = static_cast<ElectricFieldInt *>(integral_->electric_field());
-
-    SharedMatrix efields = std::make_shared<Matrix>("efields", coords->nrow(), 3);
-    auto fieldfun = ContractOverDensityFieldFunctor(efields, D);
-    field_integrals_->compute_with_functor(fieldfun, coords);
-
-    return efields;
+    return SiteFields(basisset_, coords).field(D);
 }
 
 std::vector<SharedMatrix> MintsHelper::ao_nabla() {
@@ -1752,7 +2015,7 @@ std::vector<SharedMatrix> MintsHelper::ao_nabla() {
 
 std::shared_ptr<CdSalcList> MintsHelper::cdsalcs(int needed_irreps, bool project_out_translations,
                                                  bool project_out_rotations) {
-    return std::make_shared<CdSalcList>(molecule_, needed_irreps, project_out_translations, project_out_rotations);
+    return CdSalcList::build(molecule_, needed_irreps, project_out_translations, project_out_rotations);
 }
 
 SharedMatrix MintsHelper::mo_transform(SharedMatrix Iso, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3,
@@ -33,6 +33,8 @@
 #include "psi4/libmints/multipolesymmetry.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <array>
+#include <unordered_map>
 #include <vector>
 
 namespace psi {
@@ -44,6 +46,47 @@ class PetiteList;
 class ThreeCenterOverlapInt;
 class OneBodyAOInt;
 
+/**
+ * Screened AO two-electron integrals stored shell quartet by shell quartet.
+ *
+ * Only the canonical quartets (M >= N, P >= Q, MN >= PQ) that survive the
+ * integral screening are kept. Block i holds the integrals of quartet(i) in
+ * the usual (mn|pq) row-major order, starting at data() + offset(i).
+ **/
+class PSI_API ShellQuartetBlocks {
+   protected:
+    std::shared_ptr<BasisSet> basis_;
+    /// Shell indices of each stored quartet
+    std::vector<std::array<int, 4>> quartets_;
+    /// Start of each block in data_, with a trailing entry for the total size
+    std::vector<size_t> offsets_;
+    std::vector<double> data_;
+    /// Canonical quartet key -> block index
+    std::unordered_map<size_t, size_t> index_;
+
+    size_t key(int M, int N, int P, int Q) const;
+
+   public:
+    ShellQuartetBlocks(std::shared_ptr<BasisSet> basis, std::vector<std::array<int, 4>> quartets);
+
+    std::shared_ptr<BasisSet> basis() const { return basis_; }
+    /// Number of stored shell quartets
+    size_t nquartet() const { return quartets_.size(); }
+    /// Number of stored integrals
+    size_t size() const { return data_.size(); }
+    const std::array<int, 4>& quartet(size_t i) const { return quartets_[i]; }
+    /// Start of block i in data(); offset(nquartet()) is the total size
+    size_t offset(size_t i) const { return offsets_[i]; }
+    /// Dimensions of block i, (nm, nn, np, nq)
+    std::array<size_t, 4> shape(size_t i) const;
+    double* data() { return data_.data(); }
+    const double* data() const { return data_.data(); }
+    double* block(size_t i) { return data_.data() + offsets_[i]; }
+    /// Block index of a quartet in any index order, or -1 if it was screened out.
+    /// The block itself is always laid out in the canonical order of quartet(i).
+    long int find(int M, int N, int P, int Q) const;
+};
+
 /**
  * The MintsHelper object, places molecular integrals
  * (and later derivative integrals) on disk
@@ -82,6 +125,13 @@ class PSI_API MintsHelper {
     SharedMatrix mo_spin_eri_helper(SharedMatrix Iso, int n1, int n2);
 
     SharedMatrix ao_helper(const std::string& label, std::shared_ptr<TwoBodyAOInt> ints);
+    /// Threaded, screened (12|34) transformation that never holds more than a shell row of AO integrals
+    SharedMatrix mo_eri_direct(std::shared_ptr<TwoBodyAOInt> ints, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3,
+                               SharedMatrix C4);
+    /// mo_eri_direct for several (12|34) requests from one pass over the AO integrals; requests that share
+    /// a ket (34) pair, also after swapping bra and ket, share its half-transformed integrals
+    std::vector<SharedMatrix> mo_eri_direct(std::shared_ptr<TwoBodyAOInt> ints,
+                                            const std::vector<std::vector<SharedMatrix>>& requests);
     SharedMatrix ao_shell_getter(const std::string& label, std::shared_ptr<TwoBodyAOInt> ints, int M, int N, int P,
                                  int Q);
 
@@ -184,6 +234,8 @@ class PSI_API MintsHelper {
                         std::shared_ptr<BasisSet> bs4);
     /// AO ERI Shell
     SharedMatrix ao_eri_shell(int M, int N, int P, int Q);
+    /// Screened, symmetry-unique AO ERI shell quartets of the orbital basis
+    std::shared_ptr<ShellQuartetBlocks> ao_eri_blocks(std::shared_ptr<IntegralFactory> = nullptr);
 
     // Derivatives of OEI in AO and MO basis
     std::vector<SharedMatrix> ao_oei_deriv1(const std::string& oei_type, int atom);
@@ -250,6 +302,9 @@ class PSI_API MintsHelper {
     SharedMatrix mo_eri(SharedMatrix Cocc, SharedMatrix Cvir);
     /// Non Symmetric MO ERI Omega Integrals, (12|34) type  (Full matrix, N^5, not recommended for large systems)
     SharedMatrix mo_eri(SharedMatrix C1, SharedMatrix C2, SharedMatrix C3, SharedMatrix C4);
+    /// Several (12|34) MO ERI classes, each request being {C1, C2, C3, C4}, e.g. (ov|ov), (oo|vv), and (ov|vv)
+    /// together. The AO integrals are computed once and common half-transformed blocks are shared.
+    std::vector<SharedMatrix> mo_eri(const std::vector<std::vector<SharedMatrix>>& requests);
     /// MO ERI Omega Integrals (Full matrix, not recommended for large systems)
     SharedMatrix mo_erf_eri(double omega, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3, SharedMatrix C4);
     /// MO ERFC Omega Integrals
@@ -1448,45 +1448,89 @@ RotorType Molecule::rotor_type(double zero_tol) const {
 //
 // Symmetry
 //
-bool Molecule::has_inversion(Vector3 &origin, double tol) const {
-    for (int i = 0; i < natom(); ++i) {
-        Vector3 inverted = origin - (xyz(i) - origin);
-        int atom = atom_at_position2(inverted, tol);
-        if (atom < 0 || !atoms_[atom]->is_equivalent_to(atoms_[i])) {
-            return false;
+namespace {
+
+// Atoms sorted by x, so that the atom at a position is only looked for in a slab of width 2 tol
+// instead of the whole molecule. find() gives the same result as Molecule::atom_at_position2.
+class AtomLocator {
+   public:
+    AtomLocator(const Molecule &mol, double tol) : mol_(mol), tol_(tol), by_x_(mol.natom()) {
+        for (int i = 0; i < mol.natom(); i++) by_x_[i] = std::make_pair(mol.x(i), i);
+        std::sort(by_x_.begin(), by_x_.end());
+    }
+
+    int find(const Vector3 &b) const {
+        int found = -1;
+        auto first = std::lower_bound(by_x_.begin(), by_x_.end(), std::make_pair(b[0] - tol_, -1));
+        for (auto it = first; it != by_x_.end() && it->first < b[0] + tol_; ++it) {
+            if (b.distance(mol_.xyz(it->second)) < tol_) {
+                if (found >= 0)
+                    throw PSIEXCEPTION(
+                        "More than one atom within tolerance distance! The geometry either has one or more atoms "
+                        "extremely close to each other, or the tolerance distance has been set too large.");
+                found = it->second;
+            }
         }
+        return found;
     }
-    return true;
-}
 
-bool Molecule::is_plane(Vector3 &origin, Vector3 &uperp, double tol) const {
-    for (int i = 0; i < natom(); ++i) {
-        Vector3 A = xyz(i) - origin;
-        Vector3 Apar = uperp.dot(A) * uperp;
-        Vector3 Aperp = A - Apar;
-        A = (Aperp - Apar) + origin;
-        int atom = atom_at_position2(A, tol);
-        if (atom < 0 || !atoms_[atom]->is_equivalent_to(atoms_[i])) {
-            return false;
+    // Does every atom land on an equivalent atom under op?
+    template <typename Op>
+    bool is_symmetric(Op op) const {
+        for (int i = 0; i < mol_.natom(); ++i) {
+            int atom = find(op(mol_.xyz(i)));
+            if (atom < 0 || !mol_.atom_entry(atom)->is_equivalent_to(mol_.atom_entry(i))) {
+                return false;
+            }
         }
+        return true;
     }
-    return true;
-}
 
-bool Molecule::is_axis(Vector3 &origin, Vector3 &axis, int order, double tol) const {
-    for (int i = 0; i < natom(); ++i) {
-        Vector3 A = xyz(i) - origin;
+    bool has_inversion(const Vector3 &origin) const {
+        return is_symmetric([&](const Vector3 &r) { return origin - (r - origin); });
+    }
+
+    bool is_plane(const Vector3 &origin, const Vector3 &uperp) const {
+        return is_symmetric([&](const Vector3 &r) {
+            Vector3 A = r - origin;
+            Vector3 Apar = uperp.dot(A) * uperp;
+            Vector3 Aperp = A - Apar;
+            return (Aperp - Apar) + origin;
+        });
+    }
+
+    bool is_axis(const Vector3 &origin, const Vector3 &axis, int order) const {
+        // Vector3::rotate takes a non-const axis
+        Vector3 u = axis;
         for (int j = 1; j < order; ++j) {
-            Vector3 R = A;
-            R.rotate(j * 2.0 * M_PI / order, axis);
-            R += origin;
-            int atom = atom_at_position2(R, tol);
-            if (atom < 0 || !atoms_[atom]->is_equivalent_to(atoms_[i])) {
-                return false;
-            }
+            bool symmetric = is_symmetric([&](const Vector3 &r) {
+                Vector3 R = r - origin;
+                R.rotate(j * 2.0 * M_PI / order, u);
+                return R + origin;
+            });
+            if (!symmetric) return false;
         }
+        return true;
     }
-    return true;
+
+   private:
+    const Molecule &mol_;
+    double tol_;
+    std::vector<std::pair<double, int>> by_x_;
+};
+
+}  // namespace
+
+bool Molecule::has_inversion(Vector3 &origin, double tol) const {
+    return AtomLocator(*this, tol).has_inversion(origin);
+}
+
+bool Molecule::is_plane(Vector3 &origin, Vector3 &uperp, double tol) const {
+    return AtomLocator(*this, tol).is_plane(origin, uperp);
+}
+
+bool Molecule::is_axis(Vector3 &origin, Vector3 &axis, int order, double tol) const {
+    return AtomLocator(*this, tol).is_axis(origin, axis, order);
 }
 
 enum AxisName { XAxis, YAxis, ZAxis };
@@ -1577,7 +1621,7 @@ int Molecule::max_nequivalent() const {
 }
 
 std::shared_ptr<Matrix> Molecule::symmetry_frame(double tol) {
-    int i, j;
+    int i;
 
     Vector3 com = center_of_mass();
 
@@ -1588,7 +1632,27 @@ std::shared_ptr<Matrix> Molecule::symmetry_frame(double tol) {
     bool linear, planar;
     is_linear_planar(linear, planar, tol);
 
-    bool have_inversion = has_inversion(com, tol);
+    AtomLocator locator(*this, tol);
+    bool have_inversion = locator.has_inversion(com);
+
+    // Atoms sorted by their distance from the com. An operation through the com keeps that distance, and the
+    // image of atom i must lie within tol of atom j, so symmetry-equivalent atoms differ in it by less than
+    // tol. (Their squared distances may differ by about 2 r tol, so those cannot be compared to tol.) The pair
+    // searches below only visit those pairs, in the original order.
+    std::vector<std::pair<double, int>> by_r(natom());
+    for (i = 0; i < natom(); ++i) by_r[i] = std::make_pair(xyz(i).distance(com), i);
+    std::sort(by_r.begin(), by_r.end());
+    // Atoms j <= jmax, in increasing order, at the same distance from the com as atom i
+    auto shell_partners = [&](int iatom, int jmax) {
+        double r = xyz(iatom).distance(com);
+        std::vector<int> partners;
+        auto first = std::lower_bound(by_r.begin(), by_r.end(), std::make_pair(r - tol, -1));
+        for (auto it = first; it != by_r.end() && it->first <= r + tol; ++it) {
+            if (it->second <= jmax) partners.push_back(it->second);
+        }
+        std::sort(partners.begin(), partners.end());
+        return partners;
+    };
 
     // check for C2 axis
     Vector3 c2axis;
@@ -1621,18 +1685,15 @@ std::shared_ptr<Matrix> Molecule::symmetry_frame(double tol) {
         // loop through pairs of atoms o find c2 axis candidates
         for (i = 0; i < natom(); ++i) {
             Vector3 A = xyz(i) - com;
-            double AdotA = A.dot(A);
-            for (j = 0; j <= i; ++j) {
+            for (int j : shell_partners(i, i)) {
                 // the atoms must be identical
                 if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
                 Vector3 B = xyz(j) - com;
-                // the atoms must be the same distance from the com
-                if (std::fabs(AdotA - B.dot(B)) > tol) continue;
                 Vector3 axis = A + B;
                 // atoms colinear with the com don't work
                 if (axis.norm() < tol) continue;
                 axis.normalize();
-                if (is_axis(com, axis, 2, tol)) {
+                if (locator.is_axis(com, axis, 2)) {
                     have_c2axis = true;
                     c2axis = axis;
                     goto symmframe_found_c2axis;
@@ -1665,20 +1726,17 @@ symmframe_found_c2axis:
             // loop through paris of atoms to find c2 axis candidates
             for (i = 0; i < natom(); ++i) {
                 Vector3 A = xyz(i) - com;
-                double AdotA = A.dot(A);
-                for (j = 0; j < i; ++j) {
+                for (int j : shell_partners(i, i - 1)) {
                     // the atoms must be identical
                     if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
                     Vector3 B = xyz(j) - com;
-                    // the atoms must be the same distance from the com
-                    if (std::fabs(AdotA - B.dot(B)) > tol) continue;
                     Vector3 axis = A + B;
                     // atoms colinear with the com don't work
                     if (axis.norm() < tol) continue;
                     axis.normalize();
                     // if axis is not perp continue
                     if (std::fabs(axis.dot(c2axis)) > tol) continue;
-                    if (is_axis(com, axis, 2, tol)) {
+                    if (locator.is_axis(com, axis, 2)) {
                         have_c2axisperp = true;
                         c2axisperp = axis;
                         goto symmframe_found_c2axisperp;
@@ -1737,15 +1795,12 @@ symmframe_found_c2axisperp:
             // candidates
             for (i = 0; i < natom(); ++i) {
                 Vector3 A = xyz(i) - com;
-                double AdotA = A.dot(A);
                 // the second atom can equal i because i might be
                 // in the plane
-                for (j = 0; j <= i; ++j) {
+                for (int j : shell_partners(i, i)) {
                     // the atoms must be identical
                     if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
                     Vector3 B = xyz(j) - com;
-                    // the atoms must be the same distance from the com
-                    if (std::fabs(AdotA - B.dot(B)) > tol) continue;
                     Vector3 inplane = B + A;
                     double norm_inplane = inplane.norm();
                     if (norm_inplane < tol) continue;
@@ -1754,7 +1809,7 @@ symmframe_found_c2axisperp:
                     double norm_perp = perp.norm();
                     if (norm_perp < tol) continue;
                     perp *= 1.0 / norm_perp;
-                    if (is_plane(com, perp, tol)) {
+                    if (locator.is_plane(com, perp)) {
                         have_sigmav = true;
                         sigmav = perp;
                         goto symmframe_found_sigmav;
@@ -1803,19 +1858,15 @@ symmframe_found_sigmav:
             // loop through pairs of atoms to contruct trial planes
             for (i = 0; i < natom(); ++i) {
                 Vector3 A = xyz(i) - com;
-                double AdotA = A.dot(A);
-                for (j = 0; j < i; ++j) {
+                for (int j : shell_partners(i, i - 1)) {
                     // the atomsmust be identical
                     if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
                     Vector3 B = xyz(j) - com;
-                    double BdotB = B.dot(B);
-                    // the atoms must be the same distance from the com
-                    if (std::fabs(AdotA - BdotB) > tol) continue;
                     Vector3 perp = B - A;
                     double norm_perp = perp.norm();
                     if (norm_perp < tol) continue;
                     perp *= 1.0 / norm_perp;
-                    if (is_plane(com, perp, tol)) {
+                    if (locator.is_plane(com, perp)) {
                         have_sigma = true;
                         sigma = perp;
                         goto found_sigma;
@@ -1904,6 +1955,7 @@ std::shared_ptr<PointGroup> Molecule::find_highest_point_group(double tol) const
                         &SymmetryOperation::sigma_yz};
 
     SymmetryOperation symop;
+    AtomLocator locator(*this, tol);
 
     int matching_atom = -1;
     // Only needs to detect the 8 symmetry operations
@@ -1919,7 +1971,7 @@ std::shared_ptr<PointGroup> Molecule::find_highest_point_group(double tol) const
             Vector3 op(symop(0, 0), symop(1, 1), symop(2, 2));
             Vector3 pos = xyz(i) * op;
 
-            if ((matching_atom = atom_at_position2(pos, tol)) >= 0) {
+            if ((matching_atom = locator.find(pos)) >= 0) {
                 if (atoms_[i]->is_equivalent_to(atoms_[matching_atom]) == false) {
                     found = false;
                     break;
@@ -2032,17 +2084,7 @@ void Molecule::set_point_group(std::shared_ptr<PointGroup> pg) {
 }
 
 bool Molecule::has_symmetry_element(Vector3 &op, double tol) const {
-    for (int i = 0; i < natom(); ++i) {
-        Vector3 result = xyz(i) * op;
-        int atom = atom_at_position2(result, tol);
-
-        if (atom != -1) {
-            if (!atoms_[atom]->is_equivalent_to(atoms_[i])) return false;
-        } else
-            return false;
-    }
-
-    return true;
+    return AtomLocator(*this, tol).is_symmetric([&](const Vector3 &r) { return r * op; });
 }
 
 void Molecule::symmetrize(double tol, bool suppress_mol_print_in_exc) {
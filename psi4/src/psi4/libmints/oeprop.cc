@@ -58,6 +58,11 @@
 #include "psi4/libfock/cubature.h"
 #include "psi4/libfock/points.h"
 
+#include <libint2/engine.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <iostream>
 #include <cstdlib>
 #include <cstdio>
@@ -71,6 +76,8 @@
 #include <memory>
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <array>
 
 namespace psi {
 
@@ -1033,6 +1040,257 @@ class PSI_API GridIterator {
     ~GridIterator() { gridfile_.close(); }
 };
 
+namespace {
+
+/*
+ * A significant shell pair of the ESP and field grid evaluations. The center and extent are those of the
+ * product of the most diffuse primitives; bound is max |D| over the pair times the summed primitive overlap
+ * magnitudes, and q, mu are the electron count and dipole of the pair about its center for the far field.
+ */
+struct GridShellPair {
+    int P;
+    int Q;
+    double factor;
+    Vector3 center;
+    double extent;
+    double bound;
+    double rmin;
+    double q;
+    Vector3 mu;
+};
+
+// Estimated magnitude of the ESP of pair at distance r from its center
+double grid_pair_estimate(const GridShellPair& pair, double r) {
+    double d = r - pair.extent;
+    return pair.bound / std::max(d, pair.rmin);
+}
+
+/*
+ * Electronic ESP (esp, length N) and electric field (field, N x 3) of the AO density D at N points in bohr,
+ * either of which may be null. Points are processed in batches across threads. A shell pair is skipped for
+ * a batch when its estimated contribution is below ESP_GRID_SCREENING; with ESP_GRID_FAR_FIELD > 0, pairs
+ * farther than that beyond their extent contribute through their charge and dipole.
+ */
+void electronic_esp_and_field(std::shared_ptr<BasisSet> basis, SharedMatrix D, const std::vector<Vector3>& points,
+                              double* esp, double** field) {
+    Options& options = Process::environment.options;
+    const double screening = options.get_double("ESP_GRID_SCREENING");
+    const double far_field = options.get_double("ESP_GRID_FAR_FIELD");
+
+    const size_t npoints = points.size();
+    const int nshell = basis->nshell();
+    const int max_am = basis->max_am();
+    const int max_nprim = basis->max_nprimitive();
+    double** Dp = D->pointer();
+
+    // Significant shell pairs, P >= Q
+    std::vector<GridShellPair> pairs;
+    libint2::Engine multipoles(libint2::Operator::emultipole1, max_nprim, max_am, 0);
+    for (int P = 0; P < nshell; P++) {
+        for (int Q = 0; Q <= P; Q++) {
+            const libint2::Shell& s1 = basis->l2_shell(P);
+            const libint2::Shell& s2 = basis->l2_shell(Q);
+            const GaussianShell& g1 = basis->shell(P);
+            const GaussianShell& g2 = basis->shell(Q);
+            int n1 = g1.nfunction();
+            int n2 = g2.nfunction();
+            int o1 = g1.function_index();
+            int o2 = g2.function_index();
+
+            double Dmax = 0.0;
+            for (int p = 0; p < n1; p++)
+                for (int q = 0; q < n2; q++) Dmax = std::max(Dmax, std::fabs(Dp[o1 + p][o2 + q]));
+            if (Dmax == 0.0) continue;
+
+            Vector3 A(s1.O[0], s1.O[1], s1.O[2]);
+            Vector3 B(s2.O[0], s2.O[1], s2.O[2]);
+            double AB2 = A.distance(B) * A.distance(B);
+            double overlap = 0.0;
+            double pmax = 0.0;
+            double amin = s1.alpha[0], bmin = s2.alpha[0];
+            for (size_t i = 0; i < s1.alpha.size(); i++) {
+                amin = std::min(amin, s1.alpha[i]);
+                for (size_t j = 0; j < s2.alpha.size(); j++) {
+                    double a = s1.alpha[i], b = s2.alpha[j], p = a + b;
+                    overlap += std::fabs(s1.contr[0].coeff[i] * s2.contr[0].coeff[j]) * std::pow(M_PI / p, 1.5) *
+                               std::exp(-a * b / p * AB2);
+                    pmax = std::max(pmax, p);
+                }
+            }
+            for (size_t j = 0; j < s2.alpha.size(); j++) bmin = std::min(bmin, s2.alpha[j]);
+
+            GridShellPair pair;
+            pair.P = P;
+            pair.Q = Q;
+            pair.factor = (P == Q) ? 1.0 : 2.0;
+            pair.center = (A * amin + B * bmin) / (amin + bmin);
+            // where the most diffuse product, times the angular factors, has decayed below 1e-10
+            pair.extent = std::sqrt((23.0 + s1.contr[0].l + s2.contr[0].l) / (amin + bmin));
+            pair.bound = pair.factor * Dmax * overlap;
+            // the ESP of a unit Gaussian charge of exponent p never exceeds 2 (p / pi)^1/2
+            pair.rmin = 0.5 * std::sqrt(M_PI / pmax);
+            if (pair.bound / pair.rmin < screening) continue;
+
+            pair.q = 0.0;
+            pair.mu = Vector3(0.0, 0.0, 0.0);
+            if (far_field > 0.0) {
+                // emultipole1 about the center gives <a|b> and <a|center - r|b>
+                multipoles.set_params(std::array<double, 3>{pair.center[0], pair.center[1], pair.center[2]});
+                multipoles.compute(s1, s2);
+                const auto& buf = multipoles.results();
+                for (int p = 0, pq = 0; p < n1; p++) {
+                    for (int q = 0; q < n2; q++, pq++) {
+                        double Dpq = pair.factor * Dp[o1 + p][o2 + q];
+                        pair.q += Dpq * buf[0][pq];
+                        for (int x = 0; x < 3; x++) pair.mu[x] -= Dpq * buf[1 + x][pq];
+                    }
+                }
+            }
+            pairs.push_back(pair);
+        }
+    }
+
+    const size_t batch_size = 64;
+    const size_t nbatch = (npoints + batch_size - 1) / batch_size;
+    if (esp) std::fill(esp, esp + npoints, 0.0);
+    if (field) std::fill(field[0], field[0] + 3 * npoints, 0.0);
+
+#pragma omp parallel num_threads(Process::environment.get_n_threads())
+    {
+        libint2::Engine potential(libint2::Operator::nuclear, max_nprim, max_am, 0);
+        libint2::Engine gradient(libint2::Operator::nuclear, max_nprim, max_am, 1);
+        std::vector<std::pair<double, std::array<double, 3>>> charges;
+
+#pragma omp for schedule(dynamic)
+        for (size_t batch = 0; batch < nbatch; batch++) {
+            size_t start = batch * batch_size;
+            size_t nb = std::min(batch_size, npoints - start);
+
+            // Bounding sphere of the batch
+            Vector3 middle(0.0, 0.0, 0.0);
+            for (size_t k = 0; k < nb; k++) middle += points[start + k];
+            middle /= (double)nb;
+            double radius = 0.0;
+            for (size_t k = 0; k < nb; k++) radius = std::max(radius, middle.distance(points[start + k]));
+
+            if (field) {
+                charges.clear();
+                for (size_t k = 0; k < nb; k++) {
+                    const Vector3& C = points[start + k];
+                    charges.push_back({-1.0, {C[0], C[1], C[2]}});
+                }
+                gradient.set_params(charges);
+            }
+
+            for (const GridShellPair& pair : pairs) {
+                double r = std::max(pair.center.distance(middle) - radius, 0.0);
+                if (grid_pair_estimate(pair, r) < screening) continue;
+
+                if (far_field > 0.0 && r - pair.extent > far_field) {
+                    for (size_t k = 0; k < nb; k++) {
+                        Vector3 R = points[start + k] - pair.center;
+                        double R2 = R.dot(R);
+                        double R1 = std::sqrt(R2);
+                        double R3 = R1 * R2;
+                        double muR = pair.mu.dot(R);
+                        if (esp) esp[start + k] -= pair.q / R1 + muR / R3;
+                        if (field) {
+                            for (int x = 0; x < 3; x++) {
+                                field[start + k][x] += (pair.mu[x] - pair.q * R[x] - 3.0 * muR * R[x] / R2) / R3;
+                            }
+                        }
+                    }
+                    continue;
+                }
+
+                const libint2::Shell& s1 = basis->l2_shell(pair.P);
+                const libint2::Shell& s2 = basis->l2_shell(pair.Q);
+                int n1 = basis->shell(pair.P).nfunction();
+                int n2 = basis->shell(pair.Q).nfunction();
+                int o1 = basis->shell(pair.P).function_index();
+                int o2 = basis->shell(pair.Q).function_index();
+
+                if (esp) {
+                    for (size_t k = 0; k < nb; k++) {
+                        const Vector3& C = points[start + k];
+                        if (grid_pair_estimate(pair, pair.center.distance(C)) < screening) continue;
+                        potential.set_params(std::vector<std::pair<double, std::array<double, 3>>>{
+                            {1.0, {C[0], C[1], C[2]}}});
+                        potential.compute(s1, s2);
+                        const double* buf = potential.results()[0];
+                        if (buf == nullptr) continue;
+                        double V = 0.0;
+                        for (int p = 0, pq = 0; p < n1; p++)
+                            for (int q = 0; q < n2; q++, pq++) V += Dp[o1 + p][o2 + q] * buf[pq];
+                        esp[start + k] += pair.factor * V;
+                    }
+                }
+
+                if (field) {
+                    gradient.compute(s1, s2);
+                    const auto& results = gradient.results();
+                    // bra and ket center derivatives come first, then those of each point
+                    for (size_t k = 0; k < nb; k++) {
+                        for (int x = 0; x < 3; x++) {
+                            const double* buf = results[3 * (2 + k) + x];
+                            if (buf == nullptr) continue;
+                            double E = 0.0;
+                            for (int p = 0, pq = 0; p < n1; p++)
+                                for (int q = 0; q < n2; q++, pq++) E += Dp[o1 + p][o2 + q] * buf[pq];
+                            field[start + k][x] += pair.factor * E;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Grid points of grid.dat, in bohr
+std::vector<Vector3> read_grid_points(std::shared_ptr<Molecule> mol) {
+    std::vector<Vector3> points;
+    GridIterator griditer("grid.dat");
+    for (griditer.first(); !griditer.last(); griditer.next()) {
+        Vector3 origin(griditer.gridpoints());
+        if (mol->units() == Molecule::Angstrom) origin /= pc_bohr2angstroms;
+        points.push_back(origin);
+    }
+    return points;
+}
+
+// Grid points of an N x 3 matrix, in bohr
+std::vector<Vector3> matrix_grid_points(SharedMatrix input_grid, std::shared_ptr<Molecule> mol) {
+    // We only want a plain matrix to work with here:
+    if (input_grid->nirrep() != 1) {
+        throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with, i.e. nirrep == 1.");
+    }
+    if (input_grid->coldim() != 3) {
+        throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with a dimension of N (rows) x 3 (cols)");
+    }
+
+    bool convert = mol->units() == Molecule::Angstrom;
+    std::vector<Vector3> points(input_grid->rowdim());
+    for (int i = 0; i < input_grid->rowdim(); ++i) {
+        points[i] = Vector3(input_grid->get(i, 0), input_grid->get(i, 1), input_grid->get(i, 2));
+        if (convert) points[i] /= pc_bohr2angstroms;
+    }
+    return points;
+}
+
+// Nuclear ESP at origin
+double nuclear_esp(const Vector3& origin, std::shared_ptr<Molecule> mol) {
+    double Vnuc = 0.0;
+    int natom = mol->natom();
+    for (int i = 0; i < natom; i++) {
+        Vector3 dR = origin - mol->xyz(i);
+        double r = dR.norm();
+        if (r > 1.0E-8) Vnuc += mol->Z(i) / r;
+    }
+    return Vnuc;
+}
+
+}  // namespace
+
 ESPPropCalc::ESPPropCalc(std::shared_ptr<Wavefunction> wfn) : Prop(wfn) {}
 
 ESPPropCalc::~ESPPropCalc() {}
@@ -1042,8 +1300,6 @@ void OEProp::compute_esp_over_grid() { epc_.compute_esp_over_grid(true); }
 void ESPPropCalc::compute_esp_over_grid(bool print_output) {
     auto mol = basisset_->molecule();
 
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
     if (print_output) {
         outfile->Printf("\n Electrostatic potential computed on the grid and written to grid_esp.dat\n");
     }
@@ -1055,46 +1311,22 @@ void ESPPropCalc::compute_esp_over_grid(bool print_output) {
         Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
     }
 
-    int nbf = basisset_->nbf();
-    auto ints = std::make_shared<Matrix>("Ex integrals", nbf, nbf);
+    std::vector<Vector3> points = read_grid_points(mol);
+    Vvals_.assign(points.size(), 0.0);
+    electronic_esp_and_field(basisset_, Dtot, points, Vvals_.data(), nullptr);
 
-    Vvals_.clear();
     FILE* gridout = fopen("grid_esp.dat", "w");
     if (!gridout) throw PSIEXCEPTION("Unable to write to grid_esp.dat");
-    GridIterator griditer("grid.dat");
-    for (griditer.first(); !griditer.last(); griditer.next()) {
-        Vector3 origin(griditer.gridpoints());
-        if (mol->units() == Molecule::Angstrom) origin /= pc_bohr2angstroms;
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
-        double Vnuc = 0.0;
-        int natom = mol->natom();
-        for (int i = 0; i < natom; i++) {
-            Vector3 dR = origin - mol->xyz(i);
-            double r = dR.norm();
-            if (r > 1.0E-8) Vnuc += mol->Z(i) / r;
-        }
-        Vvals_.push_back(Velec + Vnuc);
-        fprintf(gridout, "%16.10f\n", Velec + Vnuc);
+    for (size_t i = 0; i < points.size(); i++) {
+        Vvals_[i] += nuclear_esp(points[i], mol);
+        fprintf(gridout, "%16.10f\n", Vvals_[i]);
     }
     fclose(gridout);
 }
 
 SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_grid) const {
-    // We only want a plain matrix to work with here:
-    if (input_grid->nirrep() != 1) {
-        throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with, i.e. nirrep == 1.");
-    }
-    if (input_grid->coldim() != 3) {
-        throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with a dimension of N (rows) x 3 (cols)");
-    }
-
-    int number_of_grid_points = input_grid->rowdim();
-    SharedVector output = std::make_shared<Vector>(number_of_grid_points);
-
     std::shared_ptr<Molecule> mol = basisset_->molecule();
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
+    std::vector<Vector3> points = matrix_grid_points(input_grid, mol);
 
     SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
     if (same_dens_) {
@@ -1103,26 +1335,11 @@ SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_gri
         Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
     }
 
-    int const nbf = basisset_->nbf();
-
-    bool convert = mol->units() == Molecule::Angstrom;
-
+    int number_of_grid_points = points.size();
+    SharedVector output = std::make_shared<Vector>(number_of_grid_points);
+    electronic_esp_and_field(basisset_, Dtot, points, output->pointer(), nullptr);
     for (int i = 0; i < number_of_grid_points; ++i) {
-        Vector3 origin(input_grid->get(i, 0), input_grid->get(i, 1), input_grid->get(i, 2));
-        if (convert) origin /= pc_bohr2angstroms;
-        auto ints = std::make_shared<Matrix>(nbf, nbf);
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
-        double Vnuc = 0.0;
-        int natom = mol->natom();
-        for (int iat = 0; iat < natom; iat++) {
-            Vector3 dR = origin - mol->xyz(iat);
-            double r = dR.norm();
-            if (r > 1.0E-8) Vnuc += mol->Z(iat) / r;
-        }
-        double Vtot = Velec + Vnuc;
-        (*output)[i] = Vtot;
+        (*output)[i] += nuclear_esp(points[i], mol);
     }
     return output;
 }
@@ -1132,8 +1349,6 @@ void OEProp::compute_field_over_grid() { epc_.compute_field_over_grid(true); }
 void ESPPropCalc::compute_field_over_grid(bool print_output) {
     std::shared_ptr<Molecule> mol = basisset_->molecule();
 
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
     if (print_output) {
         outfile->Printf("\n Field computed on the grid and written to grid_field.dat\n");
     }
@@ -1145,13 +1360,10 @@ void ESPPropCalc::compute_field_over_grid(bool print_output) {
         Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
     }
 
-    std::shared_ptr<ElectricFieldInt> field_ints(dynamic_cast<ElectricFieldInt*>(wfn_->integral()->electric_field()));
-
-    int nbf = basisset_->nbf();
-    std::vector<SharedMatrix> intmats;
-    intmats.push_back(std::make_shared<Matrix>("Ex integrals", nbf, nbf));
-    intmats.push_back(std::make_shared<Matrix>("Ey integrals", nbf, nbf));
-    intmats.push_back(std::make_shared<Matrix>("Ez integrals", nbf, nbf));
+    std::vector<Vector3> points = read_grid_points(mol);
+    int number_of_grid_points = points.size();
+    auto efield = std::make_shared<Matrix>("efield", number_of_grid_points, 3);
+    electronic_esp_and_field(basisset_, Dtot, points, nullptr, efield->pointer());
 
     Exvals_.clear();
     Eyvals_.clear();
@@ -1159,35 +1371,22 @@ void ESPPropCalc::compute_field_over_grid(bool print_output) {
 
     FILE* gridout = fopen("grid_field.dat", "w");
     if (!gridout) throw PSIEXCEPTION("Unable to write to grid_field.dat");
-    GridIterator griditer("grid.dat");
-    for (griditer.first(); !griditer.last(); griditer.next()) {
-        Vector3 origin(griditer.gridpoints());
-        if (mol->units() == Molecule::Angstrom) origin /= pc_bohr2angstroms;
-        field_ints->set_origin(origin);
-        for (int m = 0; m < 3; ++m) intmats[m]->zero();
-        field_ints->compute(intmats);
-        double Ex = Dtot->vector_dot(intmats[0]);
-        double Ey = Dtot->vector_dot(intmats[1]);
-        double Ez = Dtot->vector_dot(intmats[2]);
-        Vector3 nuc = field_ints->nuclear_contribution(origin, mol);
-        Exvals_.push_back(Ex + nuc[0]);
-        Eyvals_.push_back(Ey + nuc[1]);
-        Ezvals_.push_back(Ez + nuc[2]);
-        fprintf(gridout, "%16.10f %16.10f %16.10f\n", Ex + nuc[0], Ey + nuc[1], Ez + nuc[2]);
+    for (int i = 0; i < number_of_grid_points; ++i) {
+        Vector3 nuc = ElectricFieldInt::nuclear_contribution(points[i], mol);
+        double Ex = efield->get(i, 0) + nuc[0];
+        double Ey = efield->get(i, 1) + nuc[1];
+        double Ez = efield->get(i, 2) + nuc[2];
+        Exvals_.push_back(Ex);
+        Eyvals_.push_back(Ey);
+        Ezvals_.push_back(Ez);
+        fprintf(gridout, "%16.10f %16.10f %16.10f\n", Ex, Ey, Ez);
     }
     fclose(gridout);
 }
 
 SharedMatrix ESPPropCalc::compute_field_over_grid_in_memory(SharedMatrix input_grid) const {
-    // We only want a plain matrix to work with here:
-    if (input_grid->nirrep() != 1) {
-        throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with, i.e. nirrep == 1.");
-    }
-    if (input_grid->coldim() != 3) {
-        throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with a dimension of N (rows) x 3 (cols)");
-    }
-
     std::shared_ptr<Molecule> mol = basisset_->molecule();
+    std::vector<Vector3> points = matrix_grid_points(input_grid, mol);
 
     SharedMatrix Dtot = wfn_->Da_subset("AO");
     if (same_dens_) {
@@ -1196,28 +1395,14 @@ SharedMatrix ESPPropCalc::compute_field_over_grid_in_memory(SharedMatrix input_g
         Dtot->add(wfn_->Db_subset("AO"));
     }
 
-    std::shared_ptr<ElectricFieldInt> field_ints(dynamic_cast<ElectricFieldInt*>(wfn_->integral()->electric_field()));
-
-    // Scale the coordinates if needed
-    auto coords = input_grid;
-
-    if (mol->units() == Molecule::Angstrom) {
-        coords = input_grid->clone();
-        coords->scale(1.0 / pc_bohr2angstroms);
-    }
-
     // Compute the electric field at all grid points.
-    int number_of_grid_points = coords->rowdim();
-
+    int number_of_grid_points = points.size();
     SharedMatrix efield = std::make_shared<Matrix>("efield", number_of_grid_points, 3);
-
-    auto field_functor = ContractOverDensityFieldFunctor(efield, Dtot);
-    field_ints->compute_with_functor(field_functor, coords);
+    electronic_esp_and_field(basisset_, Dtot, points, nullptr, efield->pointer());
 
     // Add the nuclear contribution.
     for (int i = 0; i < number_of_grid_points; ++i) {
-        Vector3 origin(coords->get(i, 0), coords->get(i, 1), coords->get(i, 2));
-        Vector3 nuc = field_ints->nuclear_contribution(origin, mol);
+        Vector3 nuc = ElectricFieldInt::nuclear_contribution(points[i], mol);
         efield->set(i, 0, efield->get(i, 0) + nuc[0]);
         efield->set(i, 1, efield->get(i, 1) + nuc[1]);
         efield->set(i, 2, efield->get(i, 2) + nuc[2]);
@@ -1746,25 +1931,20 @@ std::tuple<SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix> PopulationAna
 
     if (print_output && debug >= 1) grid->print();
 
-    int nbf = basisset_->nbf();
     int num_atoms = mol->natom();
     size_t total_points = grid->npoints();
 
     SharedMatrix Da = wfn_->Da_subset("AO");
-    SharedMatrix Db;
-    auto point_func = (std::shared_ptr<PointFunctions>)(std::make_shared<RKSFunctions>(basisset_, total_points, nbf));
-
-    if (same_dens_) {
-        Db = Da->clone();
-        point_func->set_pointers(Da);
-    } else {
-        Db = wfn_->Db_subset("AO");
-        point_func = (std::shared_ptr<PointFunctions>)(std::make_shared<UKSFunctions>(basisset_, total_points, nbf));
-        point_func->set_pointers(Da, Db);
-    }
+    SharedMatrix Db = same_dens_ ? Da->clone() : wfn_->Db_subset("AO");
 
     std::vector<std::shared_ptr<BlockOPoints>> blocks = grid->blocks();
-    size_t running_points = 0;
+    size_t num_blocks = blocks.size();
+
+    // Offset of each block in the point arrays, and its bounding sphere for the proatom cutoffs
+    std::vector<size_t> block_start(num_blocks + 1, 0);
+    for (size_t b = 0; b < num_blocks; b++) block_start[b + 1] = block_start[b] + blocks[b]->npoints();
+    std::vector<Vector3> block_center(num_blocks);
+    std::vector<double> block_radius(num_blocks, 0.0);
 
     // Coordinates, weights, and rho (molecular electron density) at each grid point
     std::vector<double> x_points(total_points, 0.0);
@@ -1773,19 +1953,34 @@ std::tuple<SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix> PopulationAna
     std::vector<double> weights(total_points, 0.0);
     std::vector<double> rho(total_points, 0.0);
 
-    for (int b = 0; b < blocks.size(); b++) {
+    int nthread = Process::environment.get_n_threads();
+    std::vector<std::shared_ptr<PointFunctions>> point_funcs;
+    for (int t = 0; t < nthread; t++) {
+        std::shared_ptr<PointFunctions> point_func;
+        if (same_dens_) {
+            point_func = std::make_shared<RKSFunctions>(basisset_, grid->max_points(), grid->max_functions());
+            point_func->set_pointers(Da);
+        } else {
+            point_func = std::make_shared<UKSFunctions>(basisset_, grid->max_points(), grid->max_functions());
+            point_func->set_pointers(Da, Db);
+        }
+        point_funcs.push_back(point_func);
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t b = 0; b < num_blocks; b++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
         std::shared_ptr<BlockOPoints> block = blocks[b];
-        SharedVector rho_block;
+        std::shared_ptr<PointFunctions> point_func = point_funcs[rank];
         size_t num_points = block->npoints();
+        size_t running_points = block_start[b];
 
-        point_func->set_max_functions(block->local_nbf());
-        point_func->set_max_points(num_points);
         point_func->compute_points(block);
-        rho_block = point_func->point_values()["RHO_A"];
-
-        if (!same_dens_) {
-            rho_block->add(*point_func->point_values()["RHO_B"]);
-        }
+        SharedVector rho_block = point_func->point_values()["RHO_A"];
+        const double* rho_b = same_dens_ ? nullptr : point_func->point_values()["RHO_B"]->pointer();
 
         auto x = block->x();
         auto y = block->y();
@@ -1797,10 +1992,13 @@ std::tuple<SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix> PopulationAna
             y_points[running_points + p] = y[p];
             z_points[running_points + p] = z[p];
             weights[running_points + p] = w[p];
-            rho[running_points + p] = rho_block->get(p);
+            rho[running_points + p] = rho_block->get(p) + (rho_b ? rho_b[p] : 0.0);
         }
 
-        running_points += num_points;
+        block_center[b] = block->center();
+        for (size_t p = 0; p < num_points; p++) {
+            block_radius[b] = std::max(block_radius[b], block_center[b].distance(Vector3(x[p], y[p], z[p])));
+        }
     }
 
     // Electron count via numerical interagration
@@ -1907,19 +2105,49 @@ std::tuple<SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix> PopulationAna
     std::vector<double> rho_0_points_next(total_points, 0.0);
     std::vector<double> rho_a_0_points_next(num_atoms * total_points, 0.0);
 
-// Calculate initial proatom and promolecule density at all points
-#pragma omp parallel for
-    for (size_t point = 0; point < total_points; point++) {
-        rho_0_points[point] = 0.0;
+    // Grid blocks on which each proatom is above 1e-14, from its widest shell (rho_ai_0 ~ exp(-r / S))
+    std::vector<std::vector<size_t>> local_blocks(num_atoms);
+    auto find_local_blocks = [&](const std::vector<std::vector<double>>& N, const std::vector<std::vector<double>>& S) {
+#pragma omp parallel for num_threads(nthread)
         for (int atom = 0; atom < num_atoms; atom++) {
-            rho_a_0_points[atom * total_points + point] = 0.0;
+            double cutoff = 0.0;
             for (int m = 0; m < mA[atom]; m++) {
-                rho_a_0_points[atom * total_points + point] +=
-                    rho_ai_0(Nai[atom][m], Sai[atom][m], distances[atom * total_points + point]);
+                double peak = N[atom][m] / (std::pow(S[atom][m], 3) * 8 * M_PI);
+                cutoff = std::max(cutoff, S[atom][m] * std::max(0.0, std::log(peak) + 32.2));
+            }
+            local_blocks[atom].clear();
+            for (size_t b = 0; b < num_blocks; b++) {
+                double gap = block_center[b].distance(mol->xyz(atom)) - block_radius[b];
+                if (gap < cutoff) local_blocks[atom].push_back(b);
             }
-            rho_0_points[point] += rho_a_0_points[atom * total_points + point];
         }
-    }
+    };
+
+    // Proatom densities on their local blocks (zero elsewhere), and the promolecule density
+    auto proatom_densities = [&](const std::vector<std::vector<double>>& N, const std::vector<std::vector<double>>& S,
+                                 std::vector<double>& rho_a_0, std::vector<double>& rho_0) {
+        find_local_blocks(N, S);
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+        for (int atom = 0; atom < num_atoms; atom++) {
+            double* rho_atom = rho_a_0.data() + atom * total_points;
+            std::fill(rho_atom, rho_atom + total_points, 0.0);
+            for (size_t b : local_blocks[atom]) {
+                for (size_t point = block_start[b]; point < block_start[b + 1]; point++) {
+                    for (int m = 0; m < mA[atom]; m++) {
+                        rho_atom[point] += rho_ai_0(N[atom][m], S[atom][m], distances[atom * total_points + point]);
+                    }
+                }
+            }
+        }
+#pragma omp parallel for num_threads(nthread)
+        for (size_t point = 0; point < total_points; point++) {
+            rho_0[point] = 0.0;
+            for (int atom = 0; atom < num_atoms; atom++) rho_0[point] += rho_a_0[atom * total_points + point];
+        }
+    };
+
+    // Calculate initial proatom and promolecule density at all points
+    proatom_densities(Nai, Sai, rho_a_0_points, rho_0_points);
 
     // => Main Stockholder Loop <= //
 
@@ -1929,19 +2157,22 @@ std::tuple<SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix> PopulationAna
 
     if (print_output && debug >= 1) outfile->Printf("                     Delta D\n");
     while (iter < max_iter) {
-// Self-consistent update of population and density
-#pragma omp parallel for
+// Self-consistent update of population and density, per atom over its local blocks
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
         for (int atom = 0; atom < num_atoms; atom++) {
             for (int m = 0; m < mA[atom]; m++) {
                 double sum_n = 0.0;
                 double sum_s = 0.0;
 
-                for (int point = 0; point < total_points; point++) {
-                    double rho_ai_0_point =
-                        rho_ai_0(Nai[atom][m], Sai[atom][m], distances[atom * total_points + point]);
-                    sum_n += weights[point] * rho[point] * rho_ai_0_point / rho_0_points[point];
-                    sum_s += weights[point] * distances[atom * total_points + point] * rho[point] * rho_ai_0_point /
-                             rho_0_points[point];
+                for (size_t b : local_blocks[atom]) {
+                    for (size_t point = block_start[b]; point < block_start[b + 1]; point++) {
+                        if (rho_0_points[point] == 0.0) continue;
+                        double rho_ai_0_point =
+                            rho_ai_0(Nai[atom][m], Sai[atom][m], distances[atom * total_points + point]);
+                        double share = weights[point] * rho[point] * rho_ai_0_point / rho_0_points[point];
+                        sum_n += share;
+                        sum_s += distances[atom * total_points + point] * share;
+                    }
                 }
 
                 Nai_next[atom][m] = sum_n;
@@ -1949,24 +2180,12 @@ std::tuple<SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix> PopulationAna
             }
         }
 
-        std::fill(rho_0_points_next.begin(), rho_0_points_next.end(), 0.0);
-        std::fill(rho_a_0_points_next.begin(), rho_a_0_points_next.end(), 0.0);
-
-#pragma omp parallel for
-        for (size_t point = 0; point < total_points; point++) {
-            for (int atom = 0; atom < num_atoms; atom++) {
-                for (int m = 0; m < mA[atom]; m++) {
-                    rho_a_0_points_next[atom * total_points + point] +=
-                        rho_ai_0(Nai_next[atom][m], Sai_next[atom][m], distances[atom * total_points + point]);
-                }
-                rho_0_points_next[point] += rho_a_0_points_next[atom * total_points + point];
-            }
-        }
+        proatom_densities(Nai_next, Sai_next, rho_a_0_points_next, rho_0_points_next);
 
         // Convergence check (Equation 20 in Verstraelen et al.) and update of pro-densities
         std::vector<double> delta_rho_atoms_0(num_atoms, 0.0);
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(nthread)
         for (int atom = 0; atom < num_atoms; atom++) {
             double delta;
             for (size_t point = 0; point < total_points; point++) {
@@ -1984,8 +2203,8 @@ std::tuple<SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix> PopulationAna
         // Update populations, widths, and densities
         Nai = Nai_next;
         Sai = Sai_next;
-        rho_0_points = rho_0_points_next;
-        rho_a_0_points = rho_a_0_points_next;
+        std::swap(rho_0_points, rho_0_points_next);
+        std::swap(rho_a_0_points, rho_a_0_points_next);
 
         if (print_output && debug >= 1) outfile->Printf("   @MBIS iter %3d:  %.3e\n", iter, delta_rho_max_0);
 
@@ -2008,6 +2227,7 @@ std::tuple<SharedMatrix, SharedMatrix, SharedMatrix, SharedMatrix> PopulationAna
 #pragma omp parallel for
     for (int atom = 0; atom < num_atoms; atom++) {
         for (size_t point = 0; point < total_points; point++) {
+            if (rho_0_points[point] == 0.0) continue;
             rho_a[atom * total_points + point] =
                 rho[point] * rho_a_0_points[atom * total_points + point] / rho_0_points[point];
         }
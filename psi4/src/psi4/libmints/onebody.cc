@@ -85,71 +85,18 @@ static void transform1e_2(int am, SphericalTransformIter &sti, double *s, double
 }  // namespace
 
 std::vector<std::pair<int, int>> build_shell_pair_list_no_spdata(std::shared_ptr<BasisSet> bs1,
-                                                                 std::shared_ptr<BasisSet> bs2, double threshold) {
+                                                                 std::shared_ptr<BasisSet> bs2) {
     const auto nsh1 = bs1->nshell();
     const auto nsh2 = bs2->nshell();
     const auto bs1_equiv_bs2 = (bs1 == bs2);
-    auto nthreads = Process::environment.get_n_threads();
-
-    // construct the 2-electron repulsion integrals engine
-    using libint2::Engine;
-    std::vector<Engine> engines;
-    engines.reserve(nthreads);
-    engines.emplace_back(libint2::Operator::overlap, std::max(bs1->max_nprimitive(), bs2->max_nprimitive()),
-                         std::max(bs1->max_am(), bs2->max_am()), 0);
-    for (size_t i = 1; i != nthreads; ++i) {
-        engines.push_back(engines[0]);
-    }
-    std::vector<std::vector<std::pair<int, int>>> threads_sp_list(nthreads);
-
-    threshold *= threshold;
-    //TODO: Eventually we need to make sure we set the threshold appropriately.  When set to zero, all pairs
-    // are considered, as they were previously.  Turning this to some function of the integral screening
-    // threshold will start to screen out some integrals, breaking some of the more sensitive test cases in
-    // the process.  Therefore this should be done separately from the integral rewrite.
-    threshold = 0.0;
-
-#pragma omp parallel num_threads(nthreads)
-    {
-        int thread_id = 0;
-#ifdef _OPENMP
-        thread_id = omp_get_thread_num();
-#endif
-        auto &engine = engines[thread_id];
-        const auto &buf = engine.results();
-
-        // loop over permutationally-unique set of shells
-        for (auto s1 = 0l, s12 = 0l; s1 != nsh1; ++s1) {
-            auto n1 = bs1->shell(s1).nfunction();
-
-            auto s2_max = bs1_equiv_bs2 ? s1 : nsh2 - 1;
-            for (auto s2 = 0; s2 <= s2_max; ++s2, ++s12) {
-                if (s12 % nthreads != thread_id) continue;
-
-                auto on_same_center = (bs1->shell(s1).center() == bs2->shell(s2).center());
-                bool significant = on_same_center;
-                if (!on_same_center) {
-                    auto n2 = bs2->shell(s2).nfunction();
-                    engines[thread_id].compute(bs1->l2_shell(s1), bs2->l2_shell(s2));
-                    double normsq = std::inner_product(buf[0], buf[0] + n1 * n2, buf[0], 0.0);
-                    significant = (normsq >= threshold);
-                }
 
-                if (significant) {
-                    threads_sp_list[thread_id].push_back(std::make_pair(s1, s2));
-                }
-            }
-        }
-    }  // end of compute
-
-    for (int thread = 1; thread < nthreads; ++thread) {
-        for (const auto &pair : threads_sp_list[thread]) {
-            threads_sp_list[0].push_back(pair);
-        }
+    std::vector<std::pair<int, int>> pairs;
+    for (int s1 = 0; s1 < nsh1; ++s1) {
+        auto s2_max = bs1_equiv_bs2 ? s1 : nsh2 - 1;
+        for (int s2 = 0; s2 <= s2_max; ++s2) pairs.push_back(std::make_pair(s1, s2));
     }
-
-    return threads_sp_list[0];
-};
+    return pairs;
+}
 
 OneBodyAOInt::OneBodyAOInt(std::vector<SphericalTransform> &spherical_transforms, std::shared_ptr<BasisSet> bs1,
                            std::shared_ptr<BasisSet> bs2, int deriv)
@@ -162,9 +109,8 @@ OneBodyAOInt::OneBodyAOInt(std::vector<SphericalTransform> &spherical_transforms
     tformbuf_ = new double[buffsize];
     target_ = new double[buffsize];
 
-    auto threshold = Process::environment.options.get_double("INTS_TOLERANCE");
     libint2::initialize();
-    shellpairs_ = build_shell_pair_list_no_spdata(bs1, bs2, threshold);
+    shellpairs_ = build_shell_pair_list_no_spdata(bs1, bs2);
 }
 
 OneBodyAOInt::~OneBodyAOInt() {
@@ -166,11 +166,11 @@ class PSI_API OneBodyAOInt {
 
 typedef std::shared_ptr<OneBodyAOInt> SharedOneBodyAOInt;
 
-/// For a pair of basis sets, provides a list of integer pairs that index all significant (i.e. whose overlap is
-/// above the threshold) pairs that exist.  If the basis sets are different, the full Cartesian product is considered
-/// but if they are the same, only the lower triangular significant pairs are returned.
+/// For a pair of basis sets, provides a list of integer pairs that index all shell pairs.  If the basis sets are
+/// different, the full Cartesian product is returned, but if they are the same, only the lower triangular pairs.
+/// One-body integrals are not screened: dropping pairs by overlap breaks the more sensitive test cases.
 std::vector<std::pair<int, int>> build_shell_pair_list_no_spdata(std::shared_ptr<BasisSet> bs1,
-                                                                 std::shared_ptr<BasisSet> bs2, double threshold);
+                                                                 std::shared_ptr<BasisSet> bs2);
 
 }  // namespace psi
 
@@ -65,6 +65,9 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
+#include <vector>
+
 ;
 
 namespace psi {
@@ -257,6 +260,12 @@ int **compute_atom_map(const Molecule *molecule, double tol, bool suppress_mol_p
     double np[3];
     SymmetryOperation so;
 
+    // Atoms sorted by x, so each image is only compared with the atoms in a slab of width 2 tol
+    // instead of the whole molecule
+    std::vector<std::pair<double, int>> by_x(natom);
+    for (int i = 0; i < natom; i++) by_x[i] = std::make_pair(mol.x(i), i);
+    std::sort(by_x.begin(), by_x.end());
+
     // loop over all centers
     for (int i = 0; i < natom; i++) {
         Vector3 ac(mol.xyz(i));
@@ -271,7 +280,20 @@ int **compute_atom_map(const Molecule *molecule, double tol, bool suppress_mol_p
                 for (int jj = 0; jj < 3; jj++) np[ii] += so(ii, jj) * ac[jj];
             }
 
-            atom_map[i][g] = mol.atom_at_position1(np, tol);
+            // Same result as mol.atom_at_position1(np, tol)
+            Vector3 image(np);
+            int found = -1;
+            auto first = std::lower_bound(by_x.begin(), by_x.end(), std::make_pair(np[0] - tol, -1));
+            for (auto it = first; it != by_x.end() && it->first < np[0] + tol; ++it) {
+                if (image.distance(mol.xyz(it->second)) < tol) {
+                    if (found >= 0)
+                        throw PSIEXCEPTION(
+                            "More than one atom within tolerance distance! The geometry either has one or more atoms "
+                            "extremely close to each other, or the tolerance distance has been set too large.");
+                    found = it->second;
+                }
+            }
+            atom_map[i][g] = found;
             if (atom_map[i][g] < 0) {
                 outfile->Printf("\tERROR: Symmetry operation %d did not map atom %d to another atom:\n", g, i + 1);
                 if (!suppress_mol_print_in_exc) {
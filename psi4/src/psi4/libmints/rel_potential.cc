@@ -84,10 +84,17 @@ void RelPotentialInt::compute_pair(const libint2::Shell& s1, const libint2::Shel
     // AyBx AyBy AyBz AyCx AyCy AyCz AzAz AzBx AzBy AzBz ....
     //
     const auto &results = engine2_->results();
-    for (int A = 0; A < bs1_->molecule()->natom(); A++) {
-        const auto &mol = *bs1_->molecule();
+    const auto &mol = *bs1_->molecule();
+    int ncharge = Zxyz_ ? Zxyz_->rowdim() : mol.natom();
+    for (int A = 0; A < ncharge; A++) {
         // Setup the initial field of partial charges
-        engine2_->set_params(std::vector<std::pair<double, std::array<double, 3>>>{{mol.Z(A),{mol.x(A), mol.y(A), mol.z(A)}}});
+        if (Zxyz_) {
+            engine2_->set_params(std::vector<std::pair<double, std::array<double, 3>>>{
+                {Zxyz_->get(A, 0), {Zxyz_->get(A, 1), Zxyz_->get(A, 2), Zxyz_->get(A, 3)}}});
+        } else {
+            engine2_->set_params(
+                std::vector<std::pair<double, std::array<double, 3>>>{{mol.Z(A), {mol.x(A), mol.y(A), mol.z(A)}}});
+        }
         engine2_->compute(s1, s2);
         // Add AxBx
         std::transform(buffer_, buffer_+size, results[3], buffer_, std::plus<>{});
@@ -58,12 +58,12 @@ class RelPotentialInt : public OneBodyAOInt {
     /// Computes integrals between two shell objects.
     void compute_pair(const libint2::Shell&, const libint2::Shell&) override;
    public:
-    /// Constructor. Assumes nuclear centers/charges as the potential
+    /// Constructor. Assumes nuclear centers/charges as the potential, until a charge field is set
     RelPotentialInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>,
                     int deriv = 0);
     ~RelPotentialInt() override;
 
-    /// Set the field of charges
+    /// Set the field of charges, one (Z, x, y, z) row per charge
     void set_charge_field(SharedMatrix Zxyz) { Zxyz_ = Zxyz; }
 
     /// Get the field of charges
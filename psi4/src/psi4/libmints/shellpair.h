@@ -3,10 +3,18 @@
 
 // This should be included from libint2 itself eventually, but a workaround is to include it here
 #include <system_error>
+#include <algorithm>
+#include <numeric>
+#include <mutex>
 #include "psi4/libmints/basisset.h"
+#include "psi4/libpsi4util/process.h"
 #include "libint2/shell.h"
 #include "libint2/engine.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 
     typedef std::vector<std::pair<int, int>> ShellPairBlock;
@@ -111,5 +119,70 @@ namespace psi {
     }
     };
 
+    /*! \ingroup MINTS
+     *  \class ShellPairStore
+     *  \brief Libint2 shell-pair data of two basis sets at a fixed precision, shared by all engines.
+     *
+     *  Pairs are built the first time any engine asks for them and are immutable afterwards, so the
+     *  shared_ptr handed out can be read concurrently. Obtain stores through BasisSet::shell_pair_store.
+     */
+    class ShellPairStore {
+        /// The bra basis (owns this store)
+        const BasisSet* bs1_;
+        /// The ket basis
+        std::weak_ptr<BasisSet> bs2_;
+        /// Number of shells in the ket basis
+        int nshell2_;
+        /// Log of the precision the primitive pairs were screened to
+        double ln_prec_;
+        /// Pair data, indexed s1 * nshell2 + s2; null until first requested
+        std::vector<std::shared_ptr<libint2::ShellPair>> pairs_;
+        /// Guards filling pairs_
+        std::mutex mutex_;
+
+       public:
+        ShellPairStore(const BasisSet* bs1, std::shared_ptr<BasisSet> bs2, double ln_prec)
+            : bs1_(bs1), bs2_(bs2), nshell2_(bs2->nshell()), ln_prec_(ln_prec),
+              pairs_((size_t)bs1->nshell() * bs2->nshell()) {}
+
+        /// The ket basis, or nullptr if it no longer exists
+        std::shared_ptr<BasisSet> partner() const { return bs2_.lock(); }
+
+        /// The pair data of each requested (s1, s2), building the missing ones in parallel
+        ShellPairData get(const std::vector<std::pair<int, int>>& shell_pairs) {
+            auto bs2 = bs2_.lock();
+
+            // Only the lookups hold the lock; the pairs are built outside it
+            std::vector<size_t> missing;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (const auto& pair : shell_pairs) {
+                    size_t index = (size_t)pair.first * nshell2_ + pair.second;
+                    if (!pairs_[index]) missing.push_back(index);
+                }
+            }
+            std::sort(missing.begin(), missing.end());
+            missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+
+            ShellPairData built(missing.size());
+#pragma omp parallel for schedule(dynamic) num_threads(Process::environment.get_n_threads())
+            for (size_t ind = 0; ind < missing.size(); ++ind) {
+                size_t index = missing[ind];
+                built[ind] = std::make_shared<libint2::ShellPair>(bs1_->l2_shell(index / nshell2_),
+                                                                  bs2->l2_shell(index % nshell2_), ln_prec_);
+            }
+
+            // A pair built meanwhile by another caller wins, so that every engine shares one copy
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t ind = 0; ind < missing.size(); ++ind) {
+                if (!pairs_[missing[ind]]) pairs_[missing[ind]] = built[ind];
+            }
+            ShellPairData spdata;
+            spdata.reserve(shell_pairs.size());
+            for (const auto& pair : shell_pairs) spdata.push_back(pairs_[(size_t)pair.first * nshell2_ + pair.second]);
+            return spdata;
+        }
+    };
+
 } // namespace psi4
 #endif /* header guard */
@@ -116,6 +116,12 @@ TwoBodyAOInt::TwoBodyAOInt(const TwoBodyAOInt &rhs) : TwoBodyAOInt(rhs.integral_
 
 TwoBodyAOInt::~TwoBodyAOInt() {}
 
+void TwoBodyAOInt::set_screening_threshold(double threshold) {
+    if (screening_type_ == ScreeningType::None) return;
+    screening_threshold_ = threshold;
+    screening_threshold_squared_ = threshold * threshold;
+}
+
 // Haser 1989, Equation 7 
 void TwoBodyAOInt::update_density(const std::vector<SharedMatrix>& D) {
 
@@ -167,7 +173,7 @@ double TwoBodyAOInt::shell_pair_max_density(int M, int N) const {
 }
 
 // Haser 1989 Equations 6 to 14
-bool TwoBodyAOInt::shell_significant_density(int M, int N, int R, int S) {
+double TwoBodyAOInt::shell_max_density(int M, int N, int R, int S) const {
 
     // Maximum density matrix equation
     double max_density = 0.0;
@@ -191,6 +197,17 @@ bool TwoBodyAOInt::shell_significant_density(int M, int N, int R, int S) {
         max_density = std::max({2.0 * D_MN, 2.0 * D_RS, D_MR, D_MS, D_NR, D_NS});
     }
 
+    return max_density;
+}
+
+double TwoBodyAOInt::shell_density_bound(int M, int N, int R, int S) const {
+    return std::sqrt(shell_pair_values_[N * nshell_ + M] * shell_pair_values_[S * nshell_ + R]) *
+           shell_max_density(M, N, R, S);
+}
+
+bool TwoBodyAOInt::shell_significant_density(int M, int N, int R, int S) {
+    double max_density = shell_max_density(M, N, R, S);
+
     // Square of Cauchy-Schwarz Q_MN terms (Eq. 13)
     double mn_mn = shell_pair_values_[N * nshell_ + M];
     double rs_rs = shell_pair_values_[S * nshell_ + R];
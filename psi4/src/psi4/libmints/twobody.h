@@ -205,6 +205,11 @@ class PSI_API TwoBodyAOInt {
      */
     /// Update max_dens_shell_pair_ given an updated density matrix (Haser 1989)
     void update_density(const std::vector<SharedMatrix>& D);
+    /// Change the threshold of the quartet screening. The significant pair lists keep the threshold
+    /// they were built with, so this is only meant for loosening it.
+    void set_screening_threshold(double threshold);
+    /// The current screening threshold
+    double screening_threshold() const { return screening_threshold_; }
     /// Ask the built in sieve whether this quartet contributes
     bool shell_significant(int M, int N, int R, int S) const { return sieve_impl_(M, N, R, S); };
     /// Are any of the quartets within a given shellpair list significant
@@ -225,6 +230,10 @@ class PSI_API TwoBodyAOInt {
     double shell_pair_value(int m, int n) { return shell_pair_values_[m * nshell_ + n]; };
     /// Return the maximum density matrix element per shell pair. Maximum is over density matrices, if multiple set
     double shell_pair_max_density(int M, int N) const;
+    /// The largest density factor that can multiply an integral of shell quartet (MN|RS) in J or K (Haser 1989)
+    double shell_max_density(int M, int N, int R, int S) const;
+    /// Density-weighted Schwarz bound on the J/K contribution of shell quartet (MN|RS) (Haser 1989, Eq. 6)
+    double shell_density_bound(int M, int N, int R, int S) const;
 
     /// For a given PQ shellpair index, what's the first RS pair that should be processed such
     /// that loops may be processed generating only permutationally unique PQ<=RS.  For engines
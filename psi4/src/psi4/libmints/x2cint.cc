@@ -41,33 +41,148 @@
 #include "psi4/libmints/factory.h"
 #include "psi4/libmints/sobasis.h"
 #include "psi4/libmints/basisset.h"
+#include "psi4/libmints/petitelist.h"
+#include "psi4/libmints/potential.h"
+#include "psi4/libmints/molecule.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <cstdio>
+#include <map>
+
 namespace psi {
 
+namespace {
+
+/// Atomic X and R blocks of the DLU decoupling, by element and atomic basis
+std::map<std::string, std::pair<SharedMatrix, SharedMatrix>> &local_x2c_cache() {
+    static std::map<std::string, std::pair<SharedMatrix, SharedMatrix>> cache;
+    return cache;
+}
+
+/// Identifies an atom by its nuclear charge and the shells on it
+std::string atom_key(const Molecule &mol, const BasisSet &basis, int A) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.10g:%d", mol.Z(A), basis.has_puream());
+    std::string key(buf);
+    for (int i = 0; i < basis.nshell_on_center(A); ++i) {
+        const GaussianShell &shell = basis.shell(basis.shell_on_center(A, i));
+        std::snprintf(buf, sizeof(buf), "|%d", shell.am());
+        key += buf;
+        for (int k = 0; k < shell.nprimitive(); ++k) {
+            std::snprintf(buf, sizeof(buf), ",%.14e,%.14e", shell.exp(k), shell.original_coef(k));
+            key += buf;
+        }
+    }
+    return key;
+}
+
+/// The AA block of a one-electron operator over the shells on atom A
+SharedMatrix atom_block(OneBodyAOInt &ints, const BasisSet &basis, int A, int offset, int n) {
+    auto M = std::make_shared<Matrix>(n, n);
+    for (int i = 0; i < basis.nshell_on_center(A); ++i) {
+        int P = basis.shell_on_center(A, i);
+        int p0 = basis.shell_to_basis_function(P) - offset;
+        int np = basis.shell(P).nfunction();
+        for (int j = 0; j < basis.nshell_on_center(A); ++j) {
+            int Q = basis.shell_on_center(A, j);
+            int q0 = basis.shell_to_basis_function(Q) - offset;
+            int nq = basis.shell(Q).nfunction();
+            ints.compute_shell(P, Q);
+            const double *buffer = ints.buffers()[0];
+            for (int p = 0; p < np; ++p)
+                for (int q = 0; q < nq; ++q) M->set(p0 + p, q0 + q, buffer[p * nq + q]);
+        }
+    }
+    return M;
+}
+
+/// X and R of one atom from its own modified Dirac equation, as in form_dirac_h() through form_R()
+void atomic_X_R(SharedMatrix S, SharedMatrix T, SharedMatrix V, SharedMatrix W, SharedMatrix &X, SharedMatrix &R) {
+    int n = S->rowdim();
+    double c2 = pc_c_au * pc_c_au;
+
+    auto D = std::make_shared<Matrix>("Atomic Dirac Hamiltonian", 2 * n, 2 * n);
+    auto SX = std::make_shared<Matrix>("Atomic SX Hamiltonian", 2 * n, 2 * n);
+    for (int p = 0; p < n; ++p) {
+        for (int q = 0; q < n; ++q) {
+            double Tpq = T->get(p, q);
+            SX->set(p, q, S->get(p, q));
+            SX->set(p + n, q + n, 0.5 * Tpq / c2);
+            D->set(p, q, V->get(p, q));
+            D->set(p + n, q, Tpq);
+            D->set(p, q + n, Tpq);
+            D->set(p + n, q + n, 0.25 * W->get(p, q) / c2 - Tpq);
+        }
+    }
+
+    auto evecs = std::make_shared<Matrix>(2 * n, 2 * n);
+    auto evals = std::make_shared<Vector>(2 * n);
+    SX->power(-1.0 / 2.0);
+    D->transform(SX);
+    D->diagonalize(evecs, evals);
+    auto C = std::make_shared<Matrix>(2 * n, 2 * n);
+    C->gemm(false, false, 1.0, SX, evecs, 0.0);
+
+    // X = C_small (C_large)^{-1} over the positive energy states
+    auto CL = std::make_shared<Matrix>(n, n);
+    auto CS = std::make_shared<Matrix>(n, n);
+    for (int p = 0; p < n; ++p) {
+        for (int q = 0; q < n; ++q) {
+            CL->set(p, q, C->get(p, q + n));
+            CS->set(p, q, C->get(p + n, q + n));
+        }
+    }
+    CL->general_invert();
+    X = std::make_shared<Matrix>("Atomic X", n, n);
+    X->gemm(false, false, 1.0, CS, CL, 0.0);
+
+    // R = S^{-1/2} (S^{-1/2} S_tilde S^{-1/2})^{-1/2} S^{1/2}, S_tilde = S + X^ T X / 2c**2
+    auto S_tilde = std::make_shared<Matrix>(n, n);
+    S_tilde->transform(X, T, X);
+    S_tilde->scale(1.0 / (2.0 * c2));
+    S_tilde->add(S);
+    SharedMatrix S_inv_half = S->clone();
+    S_inv_half->power(-1.0 / 2.0);
+    auto sTmp1 = std::make_shared<Matrix>(n, n);
+    sTmp1->transform(S_tilde, S_inv_half);
+    sTmp1->power(-1.0 / 2.0);
+    auto sTmp2 = std::make_shared<Matrix>(n, n);
+    sTmp2->gemm(false, false, 1.0, S_inv_half, sTmp1, 0.0);
+    S_inv_half->general_invert();
+    R = std::make_shared<Matrix>("Atomic R", n, n);
+    R->gemm(false, false, 1.0, sTmp2, S_inv_half, 0.0);
+}
+
+}  // namespace
+
 X2CInt::X2CInt() {}
 
 X2CInt::~X2CInt() {}
 
 void X2CInt::compute(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> basis,
                      std::shared_ptr<BasisSet> x2c_basis, SharedMatrix S, SharedMatrix T, SharedMatrix V,
-                     const std::vector<double> lambda) {
+                     const std::vector<double> lambda, bool local) {
     // tstart();
     molecule_ = molecule;
     lambda_ = lambda;
     setup(basis, x2c_basis);
     compute_integrals();
-    form_dirac_h();
-    diagonalize_dirac_h();
-    form_X();
-    form_R();
+    if (local) {
+        form_local_X_R();
+    } else {
+        form_dirac_h();
+        diagonalize_dirac_h();
+        form_X();
+        form_R();
+    }
     form_h_FW_plus();
 
     if (do_project_) {
         project();
     }
 
-    test_h_FW_plus();
+    // The DLU Hamiltonian is not meant to reproduce the molecular Dirac eigenvalues
+    if (!local) test_h_FW_plus();
 
     S->copy(S_x2c_);
     T->copy(T_x2c_);
@@ -365,6 +480,74 @@ void X2CInt::form_R() {
 #endif
 }
 
+void X2CInt::form_local_X_R() {
+    /*
+     * Diagonal local unitary (DLU) decoupling (Peng and Reiher, J. Chem. Phys. 136, 244108 (2012)):
+     * X and R are direct sums of atomic blocks X_A and R_A, each from the Dirac equation of atom A
+     * in its own basis functions with only its own nucleus.  The molecular S, T, V, and W still
+     * enter h^{FW}_{+} in form_h_FW_plus().  The atomic problems only depend on the element and
+     * the atomic basis, so they are solved once per process and reused.
+     */
+    auto &cache = local_x2c_cache();
+    int nbf = aoBasis_->nbf();
+    auto xAO = std::make_shared<Matrix>("X matrix (AO)", nbf, nbf);
+    auto rAO = std::make_shared<Matrix>("R matrix (AO)", nbf, nbf);
+
+    std::unique_ptr<OneBodyAOInt> sInt(integral_->ao_overlap());
+    std::unique_ptr<OneBodyAOInt> tInt(integral_->ao_kinetic());
+    std::unique_ptr<OneBodyAOInt> vInt(integral_->ao_potential());
+    std::unique_ptr<OneBodyAOInt> wInt(integral_->ao_rel_potential());
+    auto potential = dynamic_cast<PotentialInt *>(vInt.get());
+    auto rel_potential = dynamic_cast<RelPotentialInt *>(wInt.get());
+
+    int nsolved = 0;
+    for (int A = 0; A < molecule_->natom(); ++A) {
+        int nshell = aoBasis_->nshell_on_center(A);
+        if (nshell == 0) continue;
+        int offset = aoBasis_->shell_to_basis_function(aoBasis_->shell_on_center(A, 0));
+        int n = 0;
+        for (int i = 0; i < nshell; ++i) n += aoBasis_->shell(aoBasis_->shell_on_center(A, i)).nfunction();
+
+        std::string key = atom_key(*molecule_, *aoBasis_, A);
+        auto it = cache.find(key);
+        if (it == cache.end()) {
+            double Z = molecule_->Z(A);
+            Vector3 xyz = molecule_->xyz(A);
+            potential->set_charge_field({{Z, {xyz[0], xyz[1], xyz[2]}}});
+            auto Zxyz = std::make_shared<Matrix>("Atomic charge", 1, 4);
+            Zxyz->set(0, 0, Z);
+            for (int x = 0; x < 3; ++x) Zxyz->set(0, x + 1, xyz[x]);
+            rel_potential->set_charge_field(Zxyz);
+
+            SharedMatrix X, R;
+            atomic_X_R(atom_block(*sInt, *aoBasis_, A, offset, n), atom_block(*tInt, *aoBasis_, A, offset, n),
+                       atom_block(*vInt, *aoBasis_, A, offset, n), atom_block(*wInt, *aoBasis_, A, offset, n), X, R);
+            it = cache.emplace(key, std::make_pair(X, R)).first;
+            nsolved++;
+        }
+
+        for (int p = 0; p < n; ++p) {
+            for (int q = 0; q < n; ++q) {
+                xAO->set(offset + p, offset + q, it->second.first->get(p, q));
+                rAO->set(offset + p, offset + q, it->second.second->get(p, q));
+            }
+        }
+    }
+
+    outfile->Printf("\n    Local (DLU) decoupling: %d atomic Dirac problems solved, %d atoms taken from the cache\n",
+                    nsolved, molecule_->natom() - nsolved);
+
+    // The atomic blocks commute with the point group operations, so they map onto the SO blocks
+    auto petite = std::make_shared<PetiteList>(aoBasis_, integral_);
+    SharedMatrix aotoso = petite->aotoso();
+    xMat = SharedMatrix(soFactory_->create_matrix("X matrix"));
+    xMat->apply_symmetry(xAO, aotoso);
+    rMat = SharedMatrix(soFactory_->create_matrix("R matrix"));
+    rMat->apply_symmetry(rAO, aotoso);
+    xrMat = SharedMatrix(soFactory_->create_matrix("XR matrix"));
+    xrMat->gemm(false, false, 1.0, xMat, rMat, 0.0);
+}
+
 void X2CInt::form_h_FW_plus() {
     // Check if the matrices are allocated and have the correct size
     S_x2c_ = SharedMatrix(soFactory_->create_matrix(PSIF_SO_S));
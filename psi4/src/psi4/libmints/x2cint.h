@@ -57,10 +57,11 @@ class PSI_API X2CInt {
      * @param T Shared matrix object that will hold the X2C kinetic energy integrals.
      * @param V Shared matrix object that will hold the X2C potential energy integrals.
      * @param options an Options object used to read basis set information.
+     * @param local decouple each atom on its own (DLU) instead of the whole molecule.
      */
     void compute(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> basis,
                  std::shared_ptr<BasisSet> x2c_basis, SharedMatrix S, SharedMatrix T, SharedMatrix V,
-                 const std::vector<double> lambda);
+                 const std::vector<double> lambda, bool local = false);
     /*! @} */
 
    private:
@@ -137,6 +138,9 @@ class PSI_API X2CInt {
     void form_X();
     /// Form the matrices R and XR
     void form_R();
+    /// Form X, R, and XR as direct sums of atomic blocks (DLU), each from the Dirac equation of
+    /// the atom alone; the blocks are cached by element and atomic basis
+    void form_local_X_R();
     /// Form the FW Hamiltonian for positive energy states
     void form_h_FW_plus();
     /// Write the FW Hamiltonian for positive energy states
@@ -26,6 +26,7 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <string>
@@ -37,6 +38,8 @@
 #include "psi4/psi4-dec.h"
 #include "memory_manager.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
 namespace psi {
 
 double bytes_to_MiB(size_t n) {
@@ -206,4 +209,101 @@ void MemoryManager::MemCheck(std::string out) {
     printer->Printf("\n  ==============================================================================\n");
 }
 
+MemoryBroker &MemoryBroker::shared_object() {
+    static MemoryBroker broker;
+    return broker;
+}
+
+void MemoryBroker::request(const std::string &name, size_t minimum, const Curve &curve) {
+    std::lock_guard<std::mutex> guard(lock_);
+    grants_.erase(name);
+    pending_[name] = Request{minimum, curve};
+}
+
+std::map<std::string, size_t> MemoryBroker::allocate(size_t budget) {
+    std::lock_guard<std::mutex> guard(lock_);
+    size_t avail = available_unlocked();
+    if (budget == 0 || budget > avail) budget = avail;
+
+    std::map<std::string, size_t> grants;
+    size_t used = 0;
+    for (const auto &kv : pending_) {
+        grants[kv.first] = kv.second.minimum;
+        used += kv.second.minimum;
+    }
+    if (used > budget) {
+        throw PSIEXCEPTION("MemoryBroker: the minimum requests (" + std::to_string(used) +
+                           " bytes) exceed the memory available (" + std::to_string(budget) + " bytes).");
+    }
+
+    // Curve segments above each minimum, best benefit per byte first
+    struct Segment {
+        std::string name;
+        size_t bytes;
+        double density;
+    };
+    std::vector<Segment> segments;
+    for (const auto &kv : pending_) {
+        size_t prev_bytes = 0;
+        double prev_benefit = 0.0;
+        for (const auto &point : kv.second.curve) {
+            size_t start = std::max(prev_bytes, kv.second.minimum);
+            if (point.first > start) {
+                double density = (point.second - prev_benefit) / static_cast<double>(point.first - prev_bytes);
+                segments.push_back(Segment{kv.first, point.first - start, density});
+            }
+            prev_bytes = std::max(prev_bytes, point.first);
+            prev_benefit = point.second;
+        }
+    }
+    std::stable_sort(segments.begin(), segments.end(),
+                     [](const Segment &a, const Segment &b) { return a.density > b.density; });
+
+    for (const auto &segment : segments) {
+        if (used == budget || segment.density <= 0.0) break;
+        size_t take = std::min(segment.bytes, budget - used);
+        grants[segment.name] += take;
+        used += take;
+    }
+
+    for (const auto &kv : grants) grants_[kv.first] = kv.second;
+    pending_.clear();
+    return grants;
+}
+
+size_t MemoryBroker::granted(const std::string &name) const {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto it = grants_.find(name);
+    return it == grants_.end() ? 0 : it->second;
+}
+
+void MemoryBroker::release(const std::string &name) {
+    std::lock_guard<std::mutex> guard(lock_);
+    grants_.erase(name);
+    pending_.erase(name);
+}
+
+size_t MemoryBroker::available() const {
+    std::lock_guard<std::mutex> guard(lock_);
+    return available_unlocked();
+}
+
+size_t MemoryBroker::available_unlocked() const {
+    size_t total = Process::environment.get_memory();
+    size_t used = 0;
+    for (const auto &kv : grants_) used += kv.second;
+    return used < total ? total - used : 0;
+}
+
+void MemoryBroker::print(const std::string &out) const {
+    std::shared_ptr<psi::PsiOutStream> printer =
+        (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out, std::ostream::app));
+    std::lock_guard<std::mutex> guard(lock_);
+    printer->Printf("  ==> Memory Grants <==\n\n");
+    for (const auto &kv : grants_) {
+        printer->Printf("    %-32s %12.1f MiB\n", kv.first.c_str(), bytes_to_MiB(kv.second));
+    }
+    printer->Printf("    %-32s %12.1f MiB\n\n", "Not granted", bytes_to_MiB(available_unlocked()));
+}
+
 } /* End Namespace */
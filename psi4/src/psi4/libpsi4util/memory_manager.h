@@ -30,9 +30,13 @@
 #define _psi_src_bin_psimrccmemory_managerh_
 
 #include <map>
+#include <mutex>
+#include <utility>
 #include <vector>
 #include <string>
 
+#include "psi4/pragma.h"
+
 namespace psi {
 
 /*
@@ -98,6 +102,62 @@ class MemoryManager {
     std::map<void *, AllocationEntry> AllocationTable;
 };
 
+/*
+ * Divides the memory of the job between subsystems that can trade memory for speed (the JK
+ * object, the DFT collocation cache, DIIS storage, ...). A subsystem states the memory it cannot
+ * run without and a benefit curve: (bytes, benefit) points, bytes increasing, with the benefit in
+ * any unit shared by all subsystems (e.g., seconds saved). allocate() grants every pending request
+ * its minimum and hands out the rest curve segment by curve segment in order of benefit per byte,
+ * which maximizes the total benefit for concave curves. Grants are held until released, so memory
+ * is reclaimed at the end of each phase for the subsystems of the next.
+ */
+class PSI_API MemoryBroker {
+   public:
+    typedef std::vector<std::pair<size_t, double>> Curve;
+
+    static MemoryBroker &shared_object();
+
+    /// Ask for memory in the next allocate(); replaces an earlier request or grant of the same name
+    void request(const std::string &name, size_t minimum, const Curve &curve);
+    /// Grant the pending requests from at most budget bytes (0: all the job memory not granted yet)
+    std::map<std::string, size_t> allocate(size_t budget = 0);
+    /// Bytes granted to name, 0 if none
+    size_t granted(const std::string &name) const;
+    /// Give the grant of name back
+    void release(const std::string &name);
+    /// Job memory not granted to anyone
+    size_t available() const;
+    void print(const std::string &out = "outfile") const;
+
+   private:
+    struct Request {
+        size_t minimum;
+        Curve curve;
+    };
+    mutable std::mutex lock_;
+    std::map<std::string, Request> pending_;
+    std::map<std::string, size_t> grants_;
+
+    size_t available_unlocked() const;
+};
+
+/**
+ * Gives the MemoryBroker grant of a name back when it goes out of scope, so
+ * that a grant does not outlive an exception thrown while it is in use.
+ */
+class PSI_API MemoryGrant {
+   public:
+    explicit MemoryGrant(const std::string &name) : name_(name) {}
+    ~MemoryGrant() { MemoryBroker::shared_object().release(name_); }
+    MemoryGrant(const MemoryGrant &) = delete;
+    MemoryGrant &operator=(const MemoryGrant &) = delete;
+
+    const std::string &name() const { return name_; }
+
+   private:
+    std::string name_;
+};
+
 template <typename T>
 void MemoryManager::allocate(const char *type, T *&matrix, size_t size, const char *variableName, const char *fileName,
                              size_t lineNumber) {
@@ -31,11 +31,7 @@
 #include "psi4/libmints/extern.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
-
-// MKL Header
-#ifdef USING_LAPACK_MKL
-#include <mkl.h>
-#endif
+#include "psi4/libqt/qt.h"
 
 // OpenMP Header
 //_OPENMP is defined by the compiler if it exists
@@ -66,9 +62,7 @@ void Process::Environment::set_n_threads(int nthread) {
 #ifdef _OPENMP
     omp_set_num_threads(nthread_);
 #endif
-#ifdef USING_LAPACK_MKL
-    mkl_set_num_threads(nthread_);
-#endif
+    blas_set_num_threads(nthread_);
 
     // HACK: TODO: CC-pthread codes should ask us how many threads
     // No, this didn't work, back this out for now (and we won't need
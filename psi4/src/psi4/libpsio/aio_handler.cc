@@ -47,6 +47,7 @@ namespace psi {
 AIOHandler::AIOHandler(std::shared_ptr<PSIO> psio) : psio_(psio) {
     locked_ = new std::mutex();
     uniqueID_ = 0;
+    completed_ = 0;
 }
 AIOHandler::~AIOHandler() {
     synchronize();
@@ -74,7 +75,7 @@ size_t AIOHandler::read(size_t unit, const char *key, char *buffer, size_t size,
     size_.push(size);
     start_.push(start);
     end_.push(end);
-    jobID_.push_back(uniqueID_);
+    jobID_.push(uniqueID_);
 
     if (job_.size() > 1) return uniqueID_;
 
@@ -98,7 +99,7 @@ size_t AIOHandler::write(size_t unit, const char *key, char *buffer, size_t size
     size_.push(size);
     start_.push(start);
     end_.push(end);
-    jobID_.push_back(uniqueID_);
+    jobID_.push(uniqueID_);
 
     // printf("Adding a write to the queue\n");
 
@@ -123,7 +124,7 @@ size_t AIOHandler::read_entry(size_t unit, const char *key, char *buffer, size_t
     key_.push(key);
     buffer_.push(buffer);
     size_.push(size);
-    jobID_.push_back(uniqueID_);
+    jobID_.push(uniqueID_);
 
     if (job_.size() > 1) return uniqueID_;
 
@@ -144,7 +145,7 @@ size_t AIOHandler::write_entry(size_t unit, const char *key, char *buffer, size_
     key_.push(key);
     buffer_.push(buffer);
     size_.push(size);
-    jobID_.push_back(uniqueID_);
+    jobID_.push(uniqueID_);
 
     if (job_.size() > 1) return uniqueID_;
 
@@ -169,7 +170,7 @@ size_t AIOHandler::read_discont(size_t unit, const char *key, double **matrix, s
     col_length_.push(col_length);
     col_skip_.push(col_skip);
     start_.push(start);
-    jobID_.push_back(uniqueID_);
+    jobID_.push(uniqueID_);
 
     if (job_.size() > 1) return uniqueID_;
 
@@ -194,7 +195,7 @@ size_t AIOHandler::write_discont(size_t unit, const char *key, double **matrix,
     col_length_.push(col_length);
     col_skip_.push(col_skip);
     start_.push(start);
-    jobID_.push_back(uniqueID_);
+    jobID_.push(uniqueID_);
 
     if (job_.size() > 1) return uniqueID_;
 
@@ -215,7 +216,7 @@ size_t AIOHandler::zero_disk(size_t unit, const char *key, size_t rows, size_t c
     key_.push(key);
     row_length_.push(rows);
     col_length_.push(cols);
-    jobID_.push_back(uniqueID_);
+    jobID_.push(uniqueID_);
 
     if (job_.size() > 1) return uniqueID_;
 
@@ -242,7 +243,7 @@ size_t AIOHandler::write_iwl(size_t unit, const char *key, size_t nints, int las
     nints_.push(nints);
     lastbuf_.push(lastbuf);
     address_.push(address);
-    jobID_.push_back(uniqueID_);
+    jobID_.push(uniqueID_);
 
     if (job_.size() > 1) return uniqueID_;
 
@@ -457,8 +458,9 @@ void AIOHandler::call_aio() {
         // Only pop the job once the work is actually done and we are gonna leave the loop.
         // This way, job_.size() == 0 indicates there is no active thread.
         job_.pop();
-        // We also pop the jobID so that external threads may check that the job completed
-        jobID_.pop_front();
+        // We also pop the jobID and publish it so that external threads may check that the job completed
+        completed_.store(jobID_.front(), std::memory_order_release);
+        jobID_.pop();
         // Once it is popped, notify waiting threads to check again for their jobid.
         condition_.notify_all();
     }
@@ -466,17 +468,14 @@ void AIOHandler::call_aio() {
 }
 
 void AIOHandler::wait_for_job(size_t jobid) {
-    std::deque<size_t>::iterator it;
+    // Producers such as the PK workers call this for every buffer they recycle, usually for
+    // jobs that are long done: answer those without touching the lock
+    if (jobid <= completed_.load(std::memory_order_acquire)) return;
 
     std::unique_lock<std::mutex> lock(*locked_);
-    it = std::find(jobID_.begin(), jobID_.end(), jobid);
-    bool found = it != jobID_.end();
-    while (found) {
+    while (jobid > completed_.load(std::memory_order_acquire)) {
         condition_.wait(lock);
-        it = std::find(jobID_.begin(), jobID_.end(), jobid);
-        found = it != jobID_.end();
     }
-    return;
 }
 
 }  // Namespace psi
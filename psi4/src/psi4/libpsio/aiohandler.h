@@ -29,6 +29,7 @@
 #ifndef AIOHANDLER_H
 #define AIOHANDLER_H
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -45,7 +46,10 @@ class AIOHandler {
     /// What is the job type?
     std::queue<size_t> job_;
     /// Unique job ID to check for job completion. Should NEVER be 0.
-    std::deque<size_t> jobID_;
+    std::queue<size_t> jobID_;
+    /// ID of the last completed job. Jobs run in submission order, so every job with a
+    /// smaller or equal ID is done; waiters check this without taking the lock.
+    std::atomic<size_t> completed_;
     /// Unit number argument
     std::queue<size_t> unit_;
     /// Entry Key (80-char) argument
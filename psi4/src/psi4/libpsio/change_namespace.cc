@@ -31,6 +31,7 @@
  \ingroup PSIO
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -48,32 +49,33 @@ void PSIO::change_file_namespace(size_t unit, const std::string& ns1, const std:
     char *old_name, *new_name, *old_fullpath, *new_fullpath;
     _default_psio_lib_->get_filename(unit, &old_name, true);
     _default_psio_lib_->get_filename(unit, &new_name, true);
-    //_default_psio_lib_->get_volpath(unit, 0, &path);
-    std::string tpath = PSIOManager::shared_object()->get_file_path(unit);
-    const char* path = tpath.c_str();
 
-    old_fullpath = (char*)malloc((strlen(path) + strlen(old_name) + 80) * sizeof(char));
-    new_fullpath = (char*)malloc((strlen(path) + strlen(new_name) + 80) * sizeof(char));
+    /* Every volume of a striped unit moves */
+    size_t numvols = std::max<size_t>(1, _default_psio_lib_->get_numvols(unit));
+    for (size_t i = 0; i < numvols; i++) {
+        std::string tpath = _default_psio_lib_->get_voldir(unit, i);
+        const char* path = tpath.c_str();
 
-    if (ns1 == "") {
-        sprintf(old_fullpath, "%s%s.%zu", path, old_name, unit);
-    } else {
-        sprintf(old_fullpath, "%s%s.%s.%zu", path, old_name, ns1.c_str(), unit);
-    }
-    if (ns2 == "") {
-        sprintf(new_fullpath, "%s%s.%zu", path, new_name, unit);
-    } else {
-        sprintf(new_fullpath, "%s%s.%s.%zu", path, new_name, ns2.c_str(), unit);
-    }
+        old_fullpath = (char*)malloc((strlen(path) + strlen(old_name) + 80) * sizeof(char));
+        new_fullpath = (char*)malloc((strlen(path) + strlen(new_name) + 80) * sizeof(char));
 
-    // printf("%s\n",old_fullpath);
-    // printf("%s\n",new_fullpath);
+        if (ns1 == "") {
+            sprintf(old_fullpath, "%s%s.%zu", path, old_name, unit);
+        } else {
+            sprintf(old_fullpath, "%s%s.%s.%zu", path, old_name, ns1.c_str(), unit);
+        }
+        if (ns2 == "") {
+            sprintf(new_fullpath, "%s%s.%zu", path, new_name, unit);
+        } else {
+            sprintf(new_fullpath, "%s%s.%s.%zu", path, new_name, ns2.c_str(), unit);
+        }
 
-    PSIOManager::shared_object()->move_file(std::string(old_fullpath), std::string(new_fullpath));
-    ::rename(old_fullpath, new_fullpath);
+        PSIOManager::shared_object()->move_file(std::string(old_fullpath), std::string(new_fullpath));
+        ::rename(old_fullpath, new_fullpath);
 
-    free(old_fullpath);
-    free(new_fullpath);
+        free(old_fullpath);
+        free(new_fullpath);
+    }
 }
 
 }  // namespace psi
@@ -36,6 +36,8 @@
 #include <cstdlib>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/io_scheduler.h"
+#include "psi4/libpsio/memory_arena.h"
 #include "psi4/psi4-dec.h"
 namespace psi {
 
@@ -49,8 +51,21 @@ void PSIO::close(size_t unit, int keep) {
     /* First check to see if this unit is already closed */
     if (this_unit->vol[0].stream == -1) psio_error(unit, PSIO_ERROR_RECLOSE);
 
+    /* A held unit stays open; only its TOC goes back */
+    if (keep && held_.count(unit)) {
+        tocwrite(unit);
+        return;
+    }
+
     /* Dump the current TOC back out to disk */
     tocwrite(unit);
+    if (!keep) generation_[unit]++;
+
+    /* Resident pages go to disk only if the unit is kept */
+    if (arena_) arena_->release(this, unit, keep);
+
+    /* Everything written behind must be on disk before the volumes close */
+    if (scheduler_) scheduler_->sync(unit);
 
     /* Free the TOC */
     this_entry = this_unit->toc;
@@ -78,10 +93,20 @@ void PSIO::close(size_t unit, int keep) {
 
     /* Reset the global page stats to zero */
     this_unit->numvols = 0;
+    this_unit->stripe = 1;
     this_unit->toclen = 0;
     this_unit->toc = nullptr;
 }
 
+void PSIO::set_hold(size_t unit, bool hold) {
+    if (hold) {
+        held_.insert(unit);
+        return;
+    }
+    held_.erase(unit);
+    if (open_check(unit)) close(unit, 1);
+}
+
 int psio_close(size_t unit, int keep) {
     _default_psio_lib_->close(unit, keep);
     return 0;
@@ -85,6 +85,8 @@ typedef struct psio_entry {
 
 struct psio_ud {
     size_t numvols;
+    /// pages per stripe over the volumes
+    size_t stripe;
     psio_vol vol[PSIO_MAXVOL];
     size_t toclen;
     psio_tocentry *toc;
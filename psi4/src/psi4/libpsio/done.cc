@@ -39,6 +39,8 @@ PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 PRAGMA_WARNING_POP
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/io_scheduler.h"
+#include "psi4/libpsio/memory_arena.h"
 
 #ifdef PSIO_STATS
 #include <ctime>
@@ -47,6 +49,10 @@ PRAGMA_WARNING_POP
 namespace psi {
 
 PSIO::~PSIO() {
+    // write back resident pages and drain the I/O threads while the units still exist
+    if (arena_) arena_->flush(this);
+    scheduler_.reset();
+
 #ifdef PSIO_STATS
     int i;
     size_t total_read = 0, total_write = 0;
@@ -83,9 +83,16 @@ void PSIOManager::set_specific_retention(int fileno, bool retain) {
         specific_retains_.insert(fileno);
     } else {
         specific_retains_.erase(fileno);
-        std::string filenum = std::to_string((long long)fileno);
-        retained_files_.erase(
-            (get_file_path(fileno) + "psi." + pid_ + "." + PSIO::get_default_namespace() + "." + filenum).c_str());
+        // Striped units have one file per volume, each in its own directory, so match the name ending
+        std::string ns = PSIO::get_default_namespace();
+        std::string tail = "." + pid_ + (ns.empty() ? "" : "." + ns) + "." + std::to_string(fileno);
+        for (auto it = retained_files_.begin(); it != retained_files_.end();) {
+            const std::string& file = *it;
+            if (file.size() > tail.size() && file.compare(file.size() - tail.size(), tail.size(), tail) == 0)
+                it = retained_files_.erase(it);
+            else
+                ++it;
+        }
     }
     mirror_to_disk();
 }
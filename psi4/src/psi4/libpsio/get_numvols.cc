@@ -37,6 +37,7 @@ PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 #include <memory>
 PRAGMA_WARNING_POP
 #include <cstdio>
+#include <algorithm>
 #include <cstdlib>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
@@ -57,4 +58,17 @@ size_t PSIO::get_numvols(size_t unit) {
     // assume that the default has been provided already
     abort();
 }
+
+size_t PSIO::get_stripe(size_t unit) {
+    // STRIPE is given in bytes and rounded up to whole pages; one page without it
+    std::string charnum;
+    charnum = filecfg_kwd("PSI", "STRIPE", unit);
+    if (charnum.empty()) charnum = filecfg_kwd("PSI", "STRIPE", -1);
+    if (charnum.empty()) charnum = filecfg_kwd("DEFAULT", "STRIPE", unit);
+    if (charnum.empty()) charnum = filecfg_kwd("DEFAULT", "STRIPE", -1);
+    if (charnum.empty()) return 1;
+
+    size_t bytes = (size_t)atoll(charnum.c_str());
+    return std::max<size_t>(1, (bytes + PSIO_PAGELEN - 1) / PSIO_PAGELEN);
+}
 }  // namespace psi
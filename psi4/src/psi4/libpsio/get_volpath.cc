@@ -69,4 +69,17 @@ void PSIO::get_volpath(size_t unit, size_t volume, char **path) {
     // assume default has been provided
     abort();
 }
+
+std::string PSIO::get_voldir(size_t unit, size_t volume) {
+    std::string scratch = PSIOManager::shared_object()->get_file_path(unit);
+    if (get_numvols(unit) <= 1) return scratch;
+
+    char *path;
+    get_volpath(unit, volume, &path);
+    std::string dir(path);
+    free(path);
+    if (dir.empty() || dir[0] != '/') dir = scratch + dir;
+    if (dir.back() != '/') dir += "/";
+    return dir;
+}
 }  // namespace psi
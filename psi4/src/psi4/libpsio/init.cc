@@ -50,6 +50,7 @@ namespace psi {
 std::shared_ptr<PSIO> _default_psio_lib_;
 std::shared_ptr<PSIOManager> _default_psio_manager_;
 std::string PSIO::default_namespace_;
+std::atomic<size_t> PSIO::generation_[PSIO_MAXUNIT];
 
 int PSIO::_error_exit_code_ = 1;
 psio_address PSIO_ZERO = {0, 0};
@@ -74,6 +75,7 @@ PSIO::PSIO() {
         psio_readlen[i] = psio_writlen[i] = 0;
 #endif
         psio_unit[i].numvols = 0;
+        psio_unit[i].stripe = 1;
         for (j = 0; j < PSIO_MAXVOL; j++) {
             psio_unit[i].vol[j].path = nullptr;
             psio_unit[i].vol[j].stream = -1;
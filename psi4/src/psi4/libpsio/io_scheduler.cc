@@ -0,0 +1,279 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include "io_scheduler.h"
+
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/psi4-dec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace psi {
+
+namespace {
+size_t global_address(psio_address address) { return address.page * PSIO_PAGELEN + address.offset; }
+psio_address psio_address_of(size_t global) {
+    psio_address address;
+    address.page = global / PSIO_PAGELEN;
+    address.offset = global % PSIO_PAGELEN;
+    return address;
+}
+double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+}  // namespace
+
+void IOScheduler::Transfer::wait() {
+    std::unique_lock<std::mutex> guard(lock);
+    cv.wait(guard, [this] { return done; });
+}
+void IOScheduler::Transfer::finish(size_t bytes, double time) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        moved = bytes;
+        seconds = time;
+        done = true;
+    }
+    cv.notify_all();
+}
+
+IOScheduler::IOScheduler(PSIO* psio, size_t nthread, size_t prefetch_bytes, size_t coalesce_bytes)
+    : psio_(psio), prefetch_bytes_(prefetch_bytes), coalesce_bytes_(coalesce_bytes) {
+    units_ = std::unique_ptr<UnitState[]>(new UnitState[PSIO_MAXUNIT]);
+    for (size_t i = 0; i < std::max<size_t>(nthread, 1); i++) workers_.emplace_back(&IOScheduler::work, this);
+}
+IOScheduler::~IOScheduler() {
+    sync_all();
+    {
+        std::lock_guard<std::mutex> guard(jobs_lock_);
+        stop_ = true;
+    }
+    jobs_cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+void IOScheduler::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> guard(jobs_lock_);
+        jobs_.push_back(std::move(job));
+    }
+    jobs_cv_.notify_one();
+}
+void IOScheduler::work() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> guard(jobs_lock_);
+            jobs_cv_.wait(guard, [this] { return stop_ || !jobs_.empty(); });
+            if (jobs_.empty()) return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+void IOScheduler::submit(size_t unit, std::shared_ptr<Transfer> transfer) {
+    PSIO* psio = psio_;
+    enqueue([psio, unit, transfer]() {
+        auto t0 = std::chrono::steady_clock::now();
+        size_t bytes = psio->prw(unit, transfer->data.data(), psio_address_of(transfer->start), transfer->data.size(),
+                                 transfer->write);
+        transfer->finish(bytes, seconds_since(t0));
+    });
+}
+
+void IOScheduler::flush_pending(size_t unit) {
+    UnitState& u = units_[unit];
+    if (u.pending.empty()) return;
+
+    auto transfer = std::make_shared<Transfer>();
+    transfer->start = u.pending_start;
+    transfer->write = true;
+    transfer->data.swap(u.pending);
+    u.pending.clear();
+
+    // an overlapping block still in flight must land first
+    wait_writes(unit, transfer->start, transfer->start + transfer->data.size());
+
+    u.stats.flushes++;
+    u.inflight.push_back(transfer);
+    submit(unit, transfer);
+}
+
+void IOScheduler::wait_writes(size_t unit, size_t start, size_t stop) {
+    UnitState& u = units_[unit];
+    std::vector<std::shared_ptr<Transfer>> keep;
+    std::shared_ptr<Transfer> failed;
+    for (auto& transfer : u.inflight) {
+        size_t tstop = transfer->start + transfer->data.size();
+        if (transfer->start >= stop || tstop <= start) {
+            keep.push_back(transfer);
+            continue;
+        }
+        transfer->wait();
+        u.stats.write_time += transfer->seconds;
+        if (transfer->moved != transfer->data.size() && !failed) failed = transfer;
+    }
+    u.inflight.swap(keep);
+
+    if (failed) {
+        psio_error(unit, PSIO_ERROR_WRITE,
+                   "WRITE failed. A block written behind by the PSIO I/O scheduler did not reach the disk.");
+    }
+}
+
+void IOScheduler::sync(size_t unit) {
+    UnitState& u = units_[unit];
+    flush_pending(unit);
+    wait_writes(unit);
+    u.prefetch.reset();
+    u.has_last = false;
+}
+void IOScheduler::sync_all() {
+    for (size_t unit = 0; unit < PSIO_MAXUNIT; unit++) {
+        UnitState& u = units_[unit];
+        if (!u.pending.empty() || !u.inflight.empty() || u.prefetch) sync(unit);
+    }
+}
+
+void IOScheduler::read(size_t unit, char* buffer, psio_address address, size_t size) {
+    UnitState& u = units_[unit];
+    size_t start = global_address(address);
+
+    // reads must see every earlier write
+    flush_pending(unit);
+    wait_writes(unit);
+
+    bool hit = false;
+    if (u.prefetch) {
+        std::shared_ptr<Transfer> prefetch = u.prefetch;
+        prefetch->wait();
+        if (start >= prefetch->start && start + size <= prefetch->start + prefetch->moved) {
+            ::memcpy(buffer, prefetch->data.data() + (start - prefetch->start), size);
+            u.stats.prefetch_hits++;
+            hit = true;
+        }
+    }
+    if (!hit) {
+        auto t0 = std::chrono::steady_clock::now();
+        psio_->rw_direct(unit, buffer, address, size, 0);
+        u.stats.read_time += seconds_since(t0);
+    }
+    u.stats.reads++;
+    u.stats.read_bytes += size;
+
+    bool sequential = u.has_last && (start == u.last_end);
+    u.last_end = start + size;
+    u.has_last = true;
+    if (!sequential || !size || size > prefetch_bytes_) return;
+
+    // read ahead as many reads of this size as fit, unless the buffer already holds the next one
+    if (u.prefetch && u.last_end >= u.prefetch->start &&
+        u.last_end + size <= u.prefetch->start + u.prefetch->moved)
+        return;
+    if (u.prefetch) u.stats.read_time += u.prefetch->seconds;
+
+    auto transfer = std::make_shared<Transfer>();
+    transfer->start = u.last_end;
+    transfer->data.resize((prefetch_bytes_ / size) * size);
+    u.stats.prefetch_bytes += transfer->data.size();
+    u.prefetch = transfer;
+    submit(unit, transfer);
+}
+
+void IOScheduler::write(size_t unit, char* buffer, psio_address address, size_t size) {
+    UnitState& u = units_[unit];
+    size_t start = global_address(address);
+
+    // a read-ahead may hold the old contents
+    u.prefetch.reset();
+    u.stats.writes++;
+    u.stats.write_bytes += size;
+
+    if (size < coalesce_bytes_) {
+        if (!u.pending.empty() && start == u.pending_start + u.pending.size() &&
+            u.pending.size() + size <= coalesce_bytes_) {
+            u.pending.insert(u.pending.end(), buffer, buffer + size);
+            u.stats.coalesced_writes++;
+            return;
+        }
+        flush_pending(unit);
+        u.pending_start = start;
+        u.pending.assign(buffer, buffer + size);
+        return;
+    }
+
+    flush_pending(unit);
+    wait_writes(unit);
+    auto t0 = std::chrono::steady_clock::now();
+    psio_->rw_direct(unit, buffer, address, size, 1);
+    u.stats.write_time += seconds_since(t0);
+}
+
+void IOScheduler::print_stats(std::string out) const {
+    auto printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
+    const double MiB = 1024.0 * 1024.0;
+
+    printer->Printf("  ==> PSIO I/O Scheduler <==\n\n");
+    printer->Printf("    Threads: %zu, read-ahead chunk: %.1f MiB, write block: %.1f MiB\n\n", workers_.size(),
+                    prefetch_bytes_ / MiB, coalesce_bytes_ / MiB);
+    printer->Printf("    Unit   Read [MiB]  Hits/Reads   Read [MiB/s]   Write [MiB]  Blocks/Writes  Write [MiB/s]\n");
+    printer->Printf("    ---------------------------------------------------------------------------------------\n");
+    for (size_t unit = 0; unit < PSIO_MAXUNIT; unit++) {
+        const UnitStats& s = units_[unit].stats;
+        if (!s.reads && !s.writes) continue;
+        double rbw = (s.read_time > 0.0 ? s.read_bytes / MiB / s.read_time : 0.0);
+        double wbw = (s.write_time > 0.0 ? s.write_bytes / MiB / s.write_time : 0.0);
+        printer->Printf("    %4zu %12.1f %5zu/%-6zu %14.1f %13.1f %6zu/%-7zu %14.1f\n", unit, s.read_bytes / MiB,
+                        s.prefetch_hits, s.reads, rbw, s.write_bytes / MiB, s.flushes, s.writes, wbw);
+    }
+    printer->Printf("\n");
+}
+
+void PSIO::set_io_scheduler(size_t nthread, size_t prefetch_bytes, size_t coalesce_bytes) {
+    // the old scheduler drains its units on destruction
+    scheduler_.reset();
+#ifndef _MSC_VER
+    if (nthread) scheduler_ = std::make_shared<IOScheduler>(this, nthread, prefetch_bytes, coalesce_bytes);
+#endif
+}
+void PSIO::print_io_stats(std::string out) {
+    if (scheduler_) scheduler_->print_stats(out);
+}
+
+}  // namespace psi
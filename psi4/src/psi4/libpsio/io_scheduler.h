@@ -0,0 +1,148 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_io_scheduler_h_
+#define _psi_src_lib_libpsio_io_scheduler_h_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "config.h"
+
+namespace psi {
+
+class PSIO;
+
+/**
+    IOScheduler sits under PSIO::rw and speeds up disk traffic without changes to the callers.
+
+    - Reads continuing exactly where the previous read of the unit stopped (as DPD buf4 row
+      reads do) trigger a read-ahead of the following chunk on the scheduler's thread pool.
+    - Small writes are collected per unit while they stay contiguous, and the collected block
+      is written behind on the pool.
+    - Any read, direct write, TOC-length access or close of a unit first drains its pending and
+      in-flight writes, and every write drops the unit's read-ahead buffer, so the file contents
+      seen by PSIO are those of synchronous I/O.
+
+    The pool uses positional reads and writes, so it never moves the file offsets that the
+    synchronous path seeks. Per-unit byte counts and bandwidths are kept for print_stats().
+    Not available on Windows.
+   */
+class IOScheduler {
+   public:
+    struct UnitStats {
+        size_t read_bytes = 0;
+        size_t reads = 0;
+        size_t prefetch_hits = 0;
+        size_t prefetch_bytes = 0;
+        size_t write_bytes = 0;
+        size_t writes = 0;
+        size_t coalesced_writes = 0;
+        size_t flushes = 0;
+        /// Seconds spent in disk transfers, on either side
+        double read_time = 0.0;
+        double write_time = 0.0;
+    };
+
+    /**
+     * @param psio           the PSIO object whose units are scheduled
+     * @param nthread        size of the I/O thread pool
+     * @param prefetch_bytes largest read-ahead chunk; longer reads are not prefetched
+     * @param coalesce_bytes largest collected write block; longer writes go straight to disk
+     */
+    IOScheduler(PSIO* psio, size_t nthread, size_t prefetch_bytes, size_t coalesce_bytes);
+    /// Drains every unit and joins the pool
+    ~IOScheduler();
+
+    void read(size_t unit, char* buffer, psio_address address, size_t size);
+    void write(size_t unit, char* buffer, psio_address address, size_t size);
+
+    /// Write out everything pending on unit, wait for it, and drop the read-ahead
+    void sync(size_t unit);
+    void sync_all();
+
+    const UnitStats& stats(size_t unit) const { return units_[unit].stats; }
+    void print_stats(std::string out = "outfile") const;
+
+   private:
+    /// One asynchronous transfer, owned jointly by the unit and the pool job
+    struct Transfer {
+        size_t start = 0;
+        std::vector<char> data;
+        bool write = false;
+        bool done = false;
+        /// bytes actually moved
+        size_t moved = 0;
+        double seconds = 0.0;
+        std::mutex lock;
+        std::condition_variable cv;
+        void wait();
+        void finish(size_t bytes, double time);
+    };
+
+    struct UnitState {
+        /// End (global byte address) of the last read, for sequential detection
+        size_t last_end = 0;
+        bool has_last = false;
+        std::shared_ptr<Transfer> prefetch;
+        std::vector<std::shared_ptr<Transfer>> inflight;
+        std::vector<char> pending;
+        size_t pending_start = 0;
+        UnitStats stats;
+    };
+
+    PSIO* psio_;
+    size_t prefetch_bytes_;
+    size_t coalesce_bytes_;
+    std::unique_ptr<UnitState[]> units_;
+
+    // => thread pool <=
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex jobs_lock_;
+    std::condition_variable jobs_cv_;
+    bool stop_ = false;
+    void enqueue(std::function<void()> job);
+    void work();
+
+    void submit(size_t unit, std::shared_ptr<Transfer> transfer);
+    /// Hand the collected writes of unit to the pool
+    void flush_pending(size_t unit);
+    /// Wait for the in-flight writes of unit overlapping [start, stop), all of them by default
+    void wait_writes(size_t unit, size_t start = 0, size_t stop = (size_t)-1);
+};
+
+}  // namespace psi
+
+#endif
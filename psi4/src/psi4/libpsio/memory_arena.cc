@@ -0,0 +1,215 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include "memory_arena.h"
+
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/io_scheduler.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/psi4-dec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace psi {
+
+std::shared_ptr<MemoryArena> PSIO::arena_;
+
+namespace {
+psio_address psio_address_of(size_t global) {
+    psio_address address;
+    address.page = global / PSIO_PAGELEN;
+    address.offset = global % PSIO_PAGELEN;
+    return address;
+}
+}  // namespace
+
+bool MemoryArena::Key::operator<(const Key& other) const {
+    if (psio != other.psio) return std::less<const PSIO*>()(psio, other.psio);
+    if (unit != other.unit) return unit < other.unit;
+    return page < other.page;
+}
+
+MemoryArena::MemoryArena(size_t budget) : budget_pages_(std::max<size_t>(1, budget / PSIO_PAGELEN)) {}
+
+size_t MemoryArena::resident() const {
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+    return lru_.size() * PSIO_PAGELEN;
+}
+
+MemoryArena::Page& MemoryArena::fetch(PSIO* psio, size_t unit, size_t page, bool whole) {
+    Key key = {psio, unit, page};
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        stats_.hits++;
+        lru_.splice(lru_.begin(), lru_, found->second);
+        return lru_.front();
+    }
+
+    stats_.misses++;
+    lru_.emplace_front();
+    Page& fresh = lru_.front();
+    fresh.key = key;
+    fresh.psio = psio;
+    fresh.data.assign(PSIO_PAGELEN, 0);
+    if (!whole) {
+        // the scheduler may still hold writes of this range
+        if (psio->scheduler_) psio->scheduler_->sync(unit);
+        psio_address start = {page, 0};
+        stats_.loaded_bytes += psio->prw(unit, fresh.data.data(), start, PSIO_PAGELEN, 0);
+    }
+    index_[key] = lru_.begin();
+    stats_.peak_pages = std::max(stats_.peak_pages, lru_.size());
+    return fresh;
+}
+
+void MemoryArena::spill(Page& page) {
+    if (page.dirty_lo >= page.dirty_hi) return;
+    psio_address start = {page.key.page, page.dirty_lo};
+    page.psio->rw_disk(page.key.unit, &(page.data[page.dirty_lo]), start, page.dirty_hi - page.dirty_lo, 1);
+    stats_.spills++;
+    stats_.spilled_bytes += page.dirty_hi - page.dirty_lo;
+    page.dirty_lo = PSIO_PAGELEN;
+    page.dirty_hi = 0;
+}
+
+void MemoryArena::evict() {
+    // the front page is the one being worked on, and is kept
+    while (lru_.size() > budget_pages_ && lru_.size() > 1) {
+        Page& victim = lru_.back();
+        spill(victim);
+        index_.erase(victim.key);
+        lru_.pop_back();
+    }
+}
+
+void MemoryArena::spill_range(PSIO* psio, size_t unit, size_t first, size_t last, bool drop) {
+    Key lo = {psio, unit, first};
+    auto it = index_.lower_bound(lo);
+    while (it != index_.end() && it->first.psio == psio && it->first.unit == unit && it->first.page <= last) {
+        spill(*(it->second));
+        if (drop) {
+            lru_.erase(it->second);
+            it = index_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MemoryArena::rw(PSIO* psio, size_t unit, char* buffer, psio_address address, size_t size, int wrt) {
+    if (!size) return;
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+
+    const size_t start = address.page * PSIO_PAGELEN + address.offset;
+    const size_t first = address.page;
+    const size_t last = (start + size - 1) / PSIO_PAGELEN;
+
+    if (4 * size > budget()) {
+        spill_range(psio, unit, first, last, wrt);
+        psio->rw_disk(unit, buffer, address, size, wrt);
+        stats_.bypass_bytes += size;
+        return;
+    }
+
+    size_t done = 0;
+    while (done < size) {
+        psio_address here = psio_address_of(start + done);
+        const size_t length = std::min(size - done, (size_t)PSIO_PAGELEN - here.offset);
+        Page& page = fetch(psio, unit, here.page, wrt && length == PSIO_PAGELEN);
+        if (wrt) {
+            std::memcpy(&(page.data[here.offset]), &(buffer[done]), length);
+            page.dirty_lo = std::min(page.dirty_lo, here.offset);
+            page.dirty_hi = std::max(page.dirty_hi, here.offset + length);
+        } else {
+            std::memcpy(&(buffer[done]), &(page.data[here.offset]), length);
+        }
+        evict();
+        done += length;
+    }
+}
+
+void MemoryArena::release(PSIO* psio, size_t unit, bool keep) {
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+    Key lo = {psio, unit, 0};
+    auto it = index_.lower_bound(lo);
+    while (it != index_.end() && it->first.psio == psio && it->first.unit == unit) {
+        if (keep) spill(*(it->second));
+        lru_.erase(it->second);
+        it = index_.erase(it);
+    }
+}
+
+void MemoryArena::flush(PSIO* psio) {
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+    for (auto it = index_.begin(); it != index_.end();) {
+        if (psio && it->first.psio != psio) {
+            ++it;
+            continue;
+        }
+        spill(*(it->second));
+        lru_.erase(it->second);
+        it = index_.erase(it);
+    }
+}
+
+void MemoryArena::print_stats(std::string out) const {
+    auto printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
+    const double MiB = 1024.0 * 1024.0;
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+
+    printer->Printf("  ==> PSIO Memory Arena <==\n\n");
+    printer->Printf("    Budget:           %12.1f MiB\n", budget() / MiB);
+    printer->Printf("    Resident:         %12.1f MiB\n", lru_.size() * PSIO_PAGELEN / MiB);
+    printer->Printf("    Peak resident:    %12.1f MiB\n", stats_.peak_pages * PSIO_PAGELEN / MiB);
+    printer->Printf("    Page hits/misses: %12zu / %zu\n", stats_.hits, stats_.misses);
+    printer->Printf("    Read in:          %12.1f MiB\n", stats_.loaded_bytes / MiB);
+    printer->Printf("    Spilled:          %12.1f MiB in %zu writes\n", stats_.spilled_bytes / MiB, stats_.spills);
+    printer->Printf("    Straight to disk: %12.1f MiB\n\n", stats_.bypass_bytes / MiB);
+}
+
+void PSIO::set_memory_arena(size_t budget) {
+    // everything resident goes back to the files before the arena changes
+    if (arena_) arena_->flush();
+    arena_.reset();
+#ifndef _MSC_VER
+    if (budget) arena_ = std::make_shared<MemoryArena>(budget);
+#endif
+}
+size_t PSIO::memory_arena() { return (arena_ ? arena_->budget() : 0); }
+void PSIO::print_memory_arena_stats(std::string out) {
+    if (arena_) arena_->print_stats(out);
+}
+
+}  // namespace psi
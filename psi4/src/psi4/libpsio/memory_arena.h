@@ -0,0 +1,124 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_memory_arena_h_
+#define _psi_src_lib_libpsio_memory_arena_h_
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "config.h"
+
+namespace psi {
+
+class PSIO;
+
+/**
+    MemoryArena keeps the pages of open PSIO units in memory, up to a fixed budget shared by
+    every PSIO object in the process, and spills the least recently used pages to disk.
+
+    - rw() on a unit is served from its resident pages; a missing page is read in from disk,
+      or zero-filled where the file does not reach yet.
+    - Only the byte range of a page written since it became resident is written back, on
+      eviction or when the unit closes with keep. Units closed without keep are never written.
+    - Requests larger than a quarter of the budget go straight to disk, after the overlapping
+      resident pages have been written back (and, for writes, dropped), so one large sweep
+      does not wash out the small, hot entries.
+
+    Small jobs then never write their scratch units to disk, and large jobs slow down to disk
+    speed instead of outgrowing RAM. Not available on Windows.
+   */
+class MemoryArena {
+   public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t loaded_bytes = 0;
+        size_t spills = 0;
+        size_t spilled_bytes = 0;
+        size_t bypass_bytes = 0;
+        size_t peak_pages = 0;
+    };
+
+    /// @param budget bytes of page memory, at least one page
+    explicit MemoryArena(size_t budget);
+
+    size_t budget() const { return budget_pages_ * PSIO_PAGELEN; }
+    size_t resident() const;
+
+    void rw(PSIO* psio, size_t unit, char* buffer, psio_address address, size_t size, int wrt);
+
+    /// Write back the dirty pages of psio's unit if keep, then forget all its pages
+    void release(PSIO* psio, size_t unit, bool keep);
+    /// Write back and forget every page owned by psio, or by any PSIO object if nullptr
+    void flush(PSIO* psio = nullptr);
+
+    const Stats& stats() const { return stats_; }
+    void print_stats(std::string out = "outfile") const;
+
+   private:
+    struct Key {
+        const PSIO* psio;
+        size_t unit;
+        size_t page;
+        bool operator<(const Key& other) const;
+    };
+    struct Page {
+        Key key;
+        PSIO* psio;
+        std::vector<char> data;
+        /// Written byte range [dirty_lo, dirty_hi) within the page, empty if clean
+        size_t dirty_lo = PSIO_PAGELEN;
+        size_t dirty_hi = 0;
+    };
+    typedef std::list<Page>::iterator PageIter;
+
+    size_t budget_pages_;
+    /// Most recently used at the front
+    std::list<Page> lru_;
+    std::map<Key, PageIter> index_;
+    Stats stats_;
+    /// Recursive: a failed read raises psio_error, which writes every TOC back through rw()
+    mutable std::recursive_mutex lock_;
+
+    /// Resident page of psio's unit, read in unless the caller overwrites all of it
+    Page& fetch(PSIO* psio, size_t unit, size_t page, bool whole);
+    /// Write back the dirty range of page
+    void spill(Page& page);
+    /// Spill and drop pages from the back of the LRU list until the budget holds
+    void evict();
+    /// Spill the resident pages of psio's unit in [first, last], dropping them if drop
+    void spill_range(PSIO* psio, size_t unit, size_t first, size_t last, bool drop);
+};
+
+}  // namespace psi
+
+#endif
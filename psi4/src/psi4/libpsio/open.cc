@@ -45,7 +45,7 @@ namespace psi {
 
 void PSIO::open(size_t unit, int status) {
     size_t i;
-    char *name, *path;
+    char* name;
     psio_ud* this_unit;
 
     /* check for too large unit */
@@ -53,10 +53,19 @@ void PSIO::open(size_t unit, int status) {
 
     this_unit = &(psio_unit[unit]);
 
+    /* A held unit that was closed with keep is still open */
+    if (held_.count(unit) && this_unit->vol[0].stream != -1) {
+        if (status == PSIO_OPEN_OLD) return;
+        close(unit, 0);
+    }
+
+    if (status == PSIO_OPEN_NEW) generation_[unit]++;
+
     /* Get number of volumes to stripe across */
     this_unit->numvols = get_numvols(unit);
     if (this_unit->numvols > PSIO_MAXVOL) psio_error(unit, PSIO_ERROR_MAXVOL);
     if (!(this_unit->numvols)) this_unit->numvols = 1;
+    this_unit->stripe = get_stripe(unit);
 
     /* Check to see if this unit is already open */
     for (i = 0; i < this_unit->numvols; i++) {
@@ -73,24 +82,21 @@ void PSIO::open(size_t unit, int status) {
         Names names;
         for (i = 0; i < this_unit->numvols; i++) {
             std::ostringstream oss;
-            get_volpath(unit, i, &path);
-            oss << path << name << "." << unit;
+            oss << get_voldir(unit, i) << name << "." << unit;
             const std::string fullpath = oss.str();
             typedef Names::const_iterator citer;
             citer n = names.find(fullpath);
             if (n != names.end()) psio_error(unit, PSIO_ERROR_IDENTVOLPATH);
             names[fullpath] = 1;
-            free(path);
         }
     }
 
     /* Build the name for each volume and open the file */
     for (i = 0; i < this_unit->numvols; i++) {
         char* fullpath;
-        get_volpath(unit, i, &path);
 
-        // A bit of a hack in psio open at the moment, breaks volumes and some error checking
-        std::string spath2 = PSIOManager::shared_object()->get_file_path(unit);
+        // A single volume goes where PSIOManager puts the unit; striped volumes use their VOLUMEn paths
+        std::string spath2 = get_voldir(unit, i);
         const char* path2 = spath2.c_str();
 
         fullpath = (char*)malloc((strlen(path2) + strlen(name) + 80) * sizeof(char));
@@ -110,8 +116,6 @@ void PSIO::open(size_t unit, int status) {
             psio_error(unit, PSIO_ERROR_OSTAT);
 
         if (this_unit->vol[i].stream == -1) psio_error(unit, PSIO_ERROR_OPEN);
-
-        free(path);
     }
 
     if (status == PSIO_OPEN_OLD)
@@ -131,7 +135,7 @@ void PSIO::open(size_t unit, int status) {
 // status needs is assumed PSIO_OPEN_OLD if this is called
 bool PSIO::exists(size_t unit) {
     size_t i;
-    char *name, *path;
+    char* name;
     psio_ud* this_unit;
 
     if (unit > PSIO_MAXUNIT) psio_error(unit, PSIO_ERROR_MAXUNIT);
@@ -162,14 +166,12 @@ bool PSIO::exists(size_t unit) {
         Names names;
         for (i = 0; i < this_unit->numvols; i++) {
             std::ostringstream oss;
-            get_volpath(unit, i, &path);
-            oss << path << name << "." << unit;
+            oss << get_voldir(unit, i) << name << "." << unit;
             const std::string fullpath = oss.str();
             typedef Names::const_iterator citer;
             citer n = names.find(fullpath);
             if (n != names.end()) psio_error(unit, PSIO_ERROR_IDENTVOLPATH);
             names[fullpath] = 1;
-            free(path);
         }
     }
 
@@ -178,10 +180,9 @@ bool PSIO::exists(size_t unit) {
     for (i = 0; i < this_unit->numvols; i++) {
         char* fullpath;
         int stream;
-        get_volpath(unit, i, &path);
 
-        // A bit of a hack in psio open at the moment, breaks volumes and some error checking
-        std::string spath2 = PSIOManager::shared_object()->get_file_path(unit);
+        // As in open(): striped volumes use their VOLUMEn paths
+        std::string spath2 = get_voldir(unit, i);
         const char* path2 = spath2.c_str();
 
         fullpath = (char*)malloc((strlen(path2) + strlen(name) + 80) * sizeof(char));
@@ -198,7 +199,6 @@ bool PSIO::exists(size_t unit) {
             file_exists = false;
         }
 
-        free(path);
         free(fullpath);
     }
 
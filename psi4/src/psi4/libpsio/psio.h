@@ -73,6 +73,7 @@ std::string psio_getpid();
 PSI_API psio_address psio_get_address(psio_address start, size_t shift);
 psio_address psio_get_global_address(psio_address entry_start, psio_address rel_address);
 void psio_volseek(const psio_vol *vol, size_t page, const size_t offset, const size_t numvols, const size_t unit);
+size_t psio_volpos(size_t page, size_t offset, size_t numvols, size_t stripe, size_t *vol);
 
 int psio_tocwrite(size_t unit);
 void psio_tocprint(size_t unit);  // debug printing
@@ -29,6 +29,7 @@
 #ifndef _psi_src_lib_libpsio_psio_hpp_
 #define _psi_src_lib_libpsio_psio_hpp_
 
+#include <atomic>
 #include <string>
 #include <map>
 #include <set>
@@ -41,6 +42,8 @@ namespace psi {
 
 class PSIO;
 class PSIOManager;
+class IOScheduler;
+class MemoryArena;
 extern PSI_API std::shared_ptr<PSIO> _default_psio_lib_;
 extern PSI_API std::shared_ptr<PSIOManager> _default_psio_manager_;
 
@@ -228,6 +231,15 @@ public:
     void open(size_t unit, int status);
     /// close unit. if keep == 0, will remove the file, else keep it
     void close(size_t unit, int keep);
+    /**
+       Keep unit open across close(unit, 1) until the hold is lifted, for modules that open and
+       close a unit around every step. Such a close only writes the TOC back; a following
+       open(unit, PSIO_OPEN_OLD) does nothing, and open(unit, PSIO_OPEN_NEW) or close(unit, 0)
+       remove the unit as usual.
+       \param unit the unit number
+       \param hold false lifts the hold, closing the unit with keep if it is still open
+       */
+    void set_hold(size_t unit, bool hold);
     /// lookup process id
     std::string getpid();
     /// sync up the object to the file on disk by closing and opening the file, if necessary
@@ -288,6 +300,36 @@ public:
        */
     void rw(size_t unit, char *buffer, psio_address address, size_t size,
             int wrt);
+    /**
+       Route rw() through an I/O scheduler with its own thread pool: sequential reads of a
+       unit are prefetched, and small contiguous writes are collected and written behind.
+       File contents are the same as with synchronous I/O. POSIX only.
+       \param nthread        number of I/O threads; 0 returns to synchronous I/O
+       \param prefetch_bytes largest read-ahead chunk, in bytes
+       \param coalesce_bytes largest collected write block, in bytes
+       */
+    void set_io_scheduler(size_t nthread, size_t prefetch_bytes = 16777216, size_t coalesce_bytes = 1048576);
+    /// Is rw() going through the I/O scheduler?
+    bool io_scheduler() const { return (bool)scheduler_; }
+    /// Print per-unit traffic, read-ahead hits and bandwidths of the I/O scheduler
+    void print_io_stats(std::string out = "outfile");
+    /**
+       Keep the pages of open units in memory, up to budget bytes shared by all PSIO objects,
+       spilling the least recently used pages to disk. Units closed with keep are written out;
+       scratch units that fit are never written. POSIX only.
+       \param budget bytes of page memory; 0 writes everything back and returns to disk I/O
+       */
+    static void set_memory_arena(size_t budget);
+    /// Budget of the memory arena in bytes, 0 if there is none
+    static size_t memory_arena();
+    /// Print page hits, spills and peak residency of the memory arena
+    static void print_memory_arena_stats(std::string out = "outfile");
+    /**
+       Count of the data writes, TOC deletions and removals of unit by any PSIO object in the
+       process. While it is unchanged, data read from the unit earlier is still current.
+       \param unit the unit number
+       */
+    static size_t generation(size_t unit) { return generation_[unit].load(); }
 
     /// Delete all TOC entries after the given key. If a blank key is given, the entire TOC will be wiped.
     void tocclean(size_t unit, const char *key);
@@ -345,10 +387,28 @@ private:
 
     /// Library state variable
     int state_;
+    /// Units under set_hold()
+    std::set<size_t> held_;
+    /// Optional read-ahead/write-behind layer under rw()
+    std::shared_ptr<IOScheduler> scheduler_;
+    /// Optional process-wide page cache above the disk
+    static std::shared_ptr<MemoryArena> arena_;
+    /// Per-unit modification counters behind generation()
+    static std::atomic<size_t> generation_[PSIO_MAXUNIT];
+    /// rw() on the files, through the scheduler if there is one
+    void rw_disk(size_t unit, char *buffer, psio_address address, size_t size, int wrt);
+    /// Synchronous rw(), underneath the scheduler
+    void rw_direct(size_t unit, char *buffer, psio_address address, size_t size, int wrt);
+    /// Positional rw() used by the scheduler threads; returns the number of bytes moved
+    size_t prw(size_t unit, char *buffer, psio_address address, size_t size, int wrt);
     /// return the number of volumes over which unit will be striped
     size_t get_numvols(size_t unit);
+    /// return the stripe of unit over its volumes, in pages (keyword STRIPE, in bytes)
+    size_t get_stripe(size_t unit);
     /// grab the path to volume of unit and strdup into path.
     void get_volpath(size_t unit, size_t volume, char **path);
+    /// directory of volume of unit: the PSIOManager path for one volume, else VOLUMEn under that path if relative
+    std::string get_voldir(size_t unit, size_t volume);
     /// return the last TOC entry
     psio_tocentry *toclast(size_t unit);
 
@@ -359,6 +419,8 @@ private:
     void tocread(size_t unit);
 
     friend class AIO_Handler;
+    friend class IOScheduler;
+    friend class MemoryArena;
 
 public:
     void set_pid(const std::string &pid) { pid_ = pid; }
@@ -31,13 +31,110 @@
  \ingroup PSIO
  */
 
+#include <algorithm>
 #include <cstdio>
+#include <thread>
+#include <vector>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/io_scheduler.h"
+#include "psi4/libpsio/memory_arena.h"
+#include "psi4/libqt/qt.h"
 #include "psi4/psi4-dec.h"
 
 namespace psi {
 
+namespace {
+
+/// One contiguous piece of a read/write, within a single volume
+struct psio_segment {
+    size_t buf_offset;
+    size_t position;
+    size_t length;
+};
+
+/// Outcome of the transfers on one volume; errcod is -1 for a failed call, the byte count for a short one
+struct psio_vol_status {
+    bool ok = true;
+    long errcod = 0;
+    int saved_errno = 0;
+};
+
+/// Split [address, address + size) into per-volume segments following the unit's stripe layout
+void psio_segments(const psio_ud *this_unit, psio_address address, size_t size,
+                   std::vector<std::vector<psio_segment>> &segments) {
+    const size_t stripe_bytes = this_unit->stripe * PSIO_PAGELEN;
+    segments.assign(this_unit->numvols, std::vector<psio_segment>());
+
+    size_t page = address.page;
+    size_t offset = address.offset;
+    size_t buf_offset = 0;
+    while (buf_offset < size) {
+        size_t vol;
+        const size_t position = psio_volpos(page, offset, this_unit->numvols, this_unit->stripe, &vol);
+        // the rest of this stripe is contiguous in its volume
+        const size_t stripe_left = stripe_bytes - ((page % this_unit->stripe) * PSIO_PAGELEN + offset);
+        const size_t length = std::min(size - buf_offset, stripe_left);
+
+        auto &list = segments[vol];
+        if (!list.empty() && list.back().position + list.back().length == position &&
+            list.back().buf_offset + list.back().length == buf_offset) {
+            list.back().length += length;
+        } else {
+            list.push_back({buf_offset, position, length});
+        }
+
+        buf_offset += length;
+        const size_t global = page * PSIO_PAGELEN + offset + length;
+        page = global / PSIO_PAGELEN;
+        offset = global % PSIO_PAGELEN;
+    }
+}
+
+/// Transfer the segments of one volume, stopping at the first failure
+psio_vol_status psio_vol_transfer(const psio_vol *vol, char *buffer, const std::vector<psio_segment> &segments,
+                                  int wrt) {
+    psio_vol_status status;
+    for (const auto &segment : segments) {
+#ifdef _MSC_VER
+        if (SYSTEM_LSEEK(vol->stream, segment.position, SEEK_SET) == -1) {
+            status.ok = false;
+            status.errcod = -1;
+            status.saved_errno = errno;
+            return status;
+        }
+        const long errcod = (wrt ? SYSTEM_WRITE(vol->stream, &(buffer[segment.buf_offset]), segment.length)
+                                 : SYSTEM_READ(vol->stream, &(buffer[segment.buf_offset]), segment.length));
+#else
+        const long errcod =
+            (wrt ? ::pwrite(vol->stream, &(buffer[segment.buf_offset]), segment.length, (off_t)segment.position)
+                 : ::pread(vol->stream, &(buffer[segment.buf_offset]), segment.length, (off_t)segment.position));
+#endif
+        if (errcod != (long)segment.length) {
+            status.ok = false;
+            status.errcod = errcod;
+            status.saved_errno = errno;
+            return status;
+        }
+    }
+    return status;
+}
+
+}  // namespace
+
+/*!
+ ** PSIO_VOLPOS(): Volume and byte position within it of a unit's global page/offset.
+ ** Stripes of `stripe` pages go round-robin over the volumes; a stripe of one page is
+ ** the original page-interleaved layout.
+ **
+ ** \ingroup PSIO
+ */
+size_t psio_volpos(size_t page, size_t offset, size_t numvols, size_t stripe, size_t *vol) {
+    const size_t stripe_index = page / stripe;
+    *vol = stripe_index % numvols;
+    return ((stripe_index / numvols) * stripe + page % stripe) * PSIO_PAGELEN + offset;
+}
+
 /*!
  ** PSIO_RW(): Central function for all reads and writes on a PSIO unit.
  **
@@ -50,127 +147,119 @@ namespace psi {
  ** \ingroup PSIO
  */
 void PSIO::rw(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
-    size_t i;
-    size_t errcod_uli;
-    size_t page, offset;
-    size_t buf_offset;
-    size_t this_page, this_page_max, this_page_total;
-    size_t first_vol, this_vol, numvols;
-    size_t bytes_left, num_full_pages;
-    psio_ud *this_unit;
-
-    this_unit = &(psio_unit[unit]);
-    numvols = this_unit->numvols;
-    page = address.page;
-    offset = address.offset;
-
-    /* Seek all volumes to correct starting positions */
-    first_vol = page % numvols;
-    psio_volseek(&(this_unit->vol[first_vol]), page, offset, numvols, unit);
-    for (i = 1, this_page = page + 1; i < numvols; i++, this_page++) {
-        this_vol = this_page % numvols;
-        psio_volseek(&(this_unit->vol[this_vol]), this_page, (size_t)0, numvols, unit);
+    timer_count(wrt ? "PSIO: bytes written" : "PSIO: bytes read", (double)size);
+    if (arena_) {
+        arena_->rw(this, unit, buffer, address, size, wrt);
+        return;
     }
+    rw_disk(unit, buffer, address, size, wrt);
+}
 
-    /* Number of bytes left on the first page */
-    this_page_max = PSIO_PAGELEN - offset;
-
-    /* If we have enough room on this page, use it */
-    if (size <= this_page_max)
-        this_page_total = size;
-    else
-        this_page_total = this_page_max;
-    buf_offset = 0;
-    if (wrt) {
-        errcod_uli = SYSTEM_WRITE(this_unit->vol[first_vol].stream, &(buffer[buf_offset]), this_page_total);
-        const int saved_errno = errno;
-        if (errcod_uli != this_page_total) {
-            const std::string beginning =
-                (errcod_uli == -1) ? "WRITE failed." : "WRITE failed. Only some of the bytes were written!";
-            const std::string context = "Error writing the first partial page";
-            const std::string errmsg = (errcod_uli == -1) ? psio_compose_err_msg(beginning, context, unit, saved_errno)
-                                                          : psio_compose_err_msg(beginning, context, unit);
-            psio_error(unit, PSIO_ERROR_WRITE, errmsg);
+/*!
+ ** PSIO_RW_DISK(): Read or write on the files of a PSIO unit, below the memory arena.
+ ** Arguments as for PSIO::rw().
+ **
+ ** \ingroup PSIO
+ */
+void PSIO::rw_disk(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
+    if (scheduler_) {
+        if (wrt)
+            scheduler_->write(unit, buffer, address, size);
+        else
+            scheduler_->read(unit, buffer, address, size);
+        return;
+    }
+    rw_direct(unit, buffer, address, size, wrt);
+}
+
+/*!
+ ** PSIO_RW_DIRECT(): Synchronous read or write on a PSIO unit, bypassing the I/O scheduler.
+ ** Arguments as for PSIO::rw(). When the request spans several volumes, each volume is
+ ** served by its own thread, so volumes on separate devices are read or written concurrently.
+ **
+ ** \ingroup PSIO
+ */
+void PSIO::rw_direct(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
+    psio_ud *this_unit = &(psio_unit[unit]);
+    if (!size) return;
+
+    std::vector<std::vector<psio_segment>> segments;
+    psio_segments(this_unit, address, size, segments);
+
+    std::vector<size_t> vols;
+    for (size_t i = 0; i < this_unit->numvols; i++) {
+        if (!segments[i].empty()) vols.push_back(i);
+    }
+
+    std::vector<psio_vol_status> status(this_unit->numvols);
+#ifndef _MSC_VER
+    if (vols.size() > 1) {
+        std::vector<std::thread> threads;
+        for (size_t v = 1; v < vols.size(); v++) {
+            const size_t i = vols[v];
+            threads.emplace_back([&, i]() { status[i] = psio_vol_transfer(&(this_unit->vol[i]), buffer, segments[i], wrt); });
         }
-    } else {
-        errcod_uli = SYSTEM_READ(this_unit->vol[first_vol].stream, &(buffer[buf_offset]), this_page_total);
-        const int saved_errno = errno;
-        if (errcod_uli != this_page_total) {
-            const std::string beginning =
-                (errcod_uli == -1) ? "READ failed." : "READ failed. Only some of the bytes were read!";
-            const std::string context = "Error reading the first partial page";
-            const std::string errmsg = (errcod_uli == -1) ? psio_compose_err_msg(beginning, context, unit, saved_errno)
-                                                          : psio_compose_err_msg(beginning, context, unit);
-            psio_error(unit, PSIO_ERROR_READ, errmsg);
+        status[vols[0]] = psio_vol_transfer(&(this_unit->vol[vols[0]]), buffer, segments[vols[0]], wrt);
+        for (auto &thread : threads) thread.join();
+    } else
+#endif
+    {
+        for (size_t i : vols) {
+            status[i] = psio_vol_transfer(&(this_unit->vol[i]), buffer, segments[i], wrt);
+            if (!status[i].ok) break;
         }
     }
 
-    /* Total number of bytes remaining to be read/written */
-    bytes_left = size - this_page_total;
-
-    /* Read/Write all the full pages */
-    num_full_pages = bytes_left / PSIO_PAGELEN;
-    buf_offset += this_page_total;
-    for (i = 0, this_page = page + 1; i < num_full_pages; i++, this_page++) {
-        this_vol = this_page % numvols;
-        this_page_total = PSIO_PAGELEN;
-        if (wrt) {
-            errcod_uli = SYSTEM_WRITE(this_unit->vol[this_vol].stream, &(buffer[buf_offset]), this_page_total);
-            const int saved_errno = errno;
-            if (errcod_uli != this_page_total) {
-                const std::string beginning =
-                    (errcod_uli == -1) ? "WRITE failed." : "WRITE failed. Only some of the bytes were written!";
-                const std::string context = "Error writing a full page";
-                const std::string errmsg = (errcod_uli == -1)
-                                               ? psio_compose_err_msg(beginning, context, unit, saved_errno)
-                                               : psio_compose_err_msg(beginning, context, unit);
-                psio_error(unit, PSIO_ERROR_WRITE, errmsg);
-            }
-        } else {
-            errcod_uli = SYSTEM_READ(this_unit->vol[this_vol].stream, &(buffer[buf_offset]), this_page_total);
-            const int saved_errno = errno;
-            if (errcod_uli != this_page_total) {
-                const std::string beginning =
-                    (errcod_uli == -1) ? "READ failed." : "READ failed. Only some of the bytes were read!";
-                const std::string context = "Error reading a full page";
-                const std::string errmsg = (errcod_uli == -1)
-                                               ? psio_compose_err_msg(beginning, context, unit, saved_errno)
-                                               : psio_compose_err_msg(beginning, context, unit);
-                psio_error(unit, PSIO_ERROR_READ, errmsg);
-            }
-        }
-        buf_offset += this_page_total;
+    for (size_t i : vols) {
+        if (status[i].ok) continue;
+        const bool failed = (status[i].errcod == -1);
+        const std::string beginning =
+            (wrt ? (failed ? "WRITE failed." : "WRITE failed. Only some of the bytes were written!")
+                 : (failed ? "READ failed." : "READ failed. Only some of the bytes were read!"));
+        const std::string context = std::string(wrt ? "Error writing" : "Error reading") + " volume " +
+                                    std::to_string(i + 1) + " of " + std::to_string(this_unit->numvols);
+        const std::string errmsg = failed ? psio_compose_err_msg(beginning, context, unit, status[i].saved_errno)
+                                          : psio_compose_err_msg(beginning, context, unit);
+        psio_error(unit, wrt ? PSIO_ERROR_WRITE : PSIO_ERROR_READ, errmsg);
     }
+}
 
-    /* Read/Write the final partial page */
-    bytes_left -= num_full_pages * PSIO_PAGELEN;
-    this_vol = this_page % numvols;
-    if (bytes_left) {
-        if (wrt) {
-            errcod_uli = SYSTEM_WRITE(this_unit->vol[this_vol].stream, &(buffer[buf_offset]), bytes_left);
-            const int saved_errno = errno;
-            if (errcod_uli != bytes_left) {
-                const std::string beginning =
-                    (errcod_uli == -1) ? "WRITE failed." : "WRITE failed. Only some of the bytes were written!";
-                const std::string context = "Error writing the last partial page";
-                const std::string errmsg = (errcod_uli == -1)
-                                               ? psio_compose_err_msg(beginning, context, unit, saved_errno)
-                                               : psio_compose_err_msg(beginning, context, unit);
-                psio_error(unit, PSIO_ERROR_WRITE, errmsg);
-            }
-        } else {
-            errcod_uli = SYSTEM_READ(this_unit->vol[this_vol].stream, &(buffer[buf_offset]), bytes_left);
-            const int saved_errno = errno;
-            if (errcod_uli != bytes_left) {
-                const std::string beginning =
-                    (errcod_uli == -1) ? "READ failed." : "READ failed. Only some of the bytes were read!";
-                const std::string context = "Error reading the last partial page";
-                const std::string errmsg = (errcod_uli == -1)
-                                               ? psio_compose_err_msg(beginning, context, unit, saved_errno)
-                                               : psio_compose_err_msg(beginning, context, unit);
-                psio_error(unit, PSIO_ERROR_READ, errmsg);
-            }
-        }
+/*!
+ ** PSIO_PRW(): Positional read or write on a PSIO unit, for the I/O scheduler's threads.
+ ** The file offsets used by rw_direct() are left untouched, and errors are not raised:
+ ** the number of bytes moved before the first short transfer is returned instead.
+ **
+ ** \ingroup PSIO
+ */
+size_t PSIO::prw(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
+#ifdef _MSC_VER
+    return 0;
+#else
+    const psio_ud *this_unit = &(psio_unit[unit]);
+    std::vector<std::vector<psio_segment>> segments;
+    psio_segments(this_unit, address, size, segments);
+
+    // segments are cut in buffer order, so walk the stripes in that order
+    std::vector<std::pair<size_t, const psio_segment *>> order;
+    for (size_t i = 0; i < this_unit->numvols; i++) {
+        for (const auto &segment : segments[i]) order.emplace_back(i, &segment);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<size_t, const psio_segment *> &a,
+                                             const std::pair<size_t, const psio_segment *> &b) {
+        return a.second->buf_offset < b.second->buf_offset;
+    });
+
+    size_t moved = 0;
+    for (const auto &item : order) {
+        const psio_segment &segment = *item.second;
+        const int stream = this_unit->vol[item.first].stream;
+        const ssize_t errcod = (wrt ? ::pwrite(stream, &(buffer[segment.buf_offset]), segment.length, (off_t)segment.position)
+                                    : ::pread(stream, &(buffer[segment.buf_offset]), segment.length, (off_t)segment.position));
+        if (errcod < 0) return moved;
+        moved += errcod;
+        if ((size_t)errcod != segment.length) return moved;
     }
+    return moved;
+#endif
 }
 }  // namespace psi
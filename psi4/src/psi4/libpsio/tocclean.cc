@@ -53,6 +53,7 @@ void PSIO::tocclean(size_t unit, const char *key) {
     psio_ud *this_unit;
 
     this_unit = &(psio_unit[unit]);
+    generation_[unit]++;
 
     this_entry = tocscan(unit, key);
     if (this_entry == nullptr) {
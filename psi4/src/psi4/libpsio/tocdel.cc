@@ -49,6 +49,7 @@ bool PSIO::tocdel(size_t unit, const char *key) {
     psio_tocentry *this_entry = tocscan(unit, key);
 
     if (this_entry == nullptr) return false;
+    generation_[unit]++;
 
     psio_tocentry *last_entry = this_entry->last;
     psio_tocentry *next_entry = this_entry->next;
@@ -36,6 +36,7 @@
 #include "psi4/libpsi4util/exception.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/io_scheduler.h"
 #include "psi4/psi4-dec.h"
 namespace psi {
 
@@ -76,6 +77,7 @@ void PSIO::rewind_toclen(const size_t unit) {
 /// @return length of the TOC for a given unit
 size_t PSIO::rd_toclen(const size_t unit) {
     if (!open_check(unit)) psio_error(unit, PSIO_ERROR_UNOPENED);
+    if (scheduler_) scheduler_->sync(unit);
     // Seek to the beginning
     rewind_toclen(unit);
     // Read the value
@@ -99,6 +101,7 @@ size_t PSIO::rd_toclen(const size_t unit) {
 /// @param len  : length value to write
 void PSIO::wt_toclen(const size_t unit, const size_t len) {
     if (!open_check(unit)) psio_error(unit, PSIO_ERROR_UNOPENED);
+    if (scheduler_) scheduler_->sync(unit);
     // Seek to the beginning
     rewind_toclen(unit);
     // Write the value
@@ -51,6 +51,7 @@ void PSIO::write(size_t unit, const char *key, char *buffer, size_t size, psio_a
     int dirty = 0;
 
     this_unit = &(psio_unit[unit]);
+    generation_[unit]++;
 
     /* Find the entry in the TOC */
     this_entry = tocscan(unit, key);
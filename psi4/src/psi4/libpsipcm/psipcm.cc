@@ -37,14 +37,16 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/petitelist.h"
-#include "psi4/libmints/potentialint.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 #include <PCMSolver/PCMInput.h>
+#include <libint2/engine.h>
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
@@ -52,6 +54,10 @@
 
 namespace psi {
 
+namespace {
+const size_t tess_batch_size = 64;
+}
+
 namespace detail {
 std::pair<std::vector<double>, std::vector<double>> collect_atoms(std::shared_ptr<Molecule> molecule) {
     int nat = molecule->natom();
@@ -138,8 +144,15 @@ std::shared_ptr<pcmsolver_context_t> init_PCMSolver(const std::string &pcmsolver
 }
 }  // namespace detail
 
-PCM::PCM(const std::string &pcmsolver_parsed_fname, int print_level, std::shared_ptr<BasisSet> basisset)
-    : pcmsolver_parsed_fname_(pcmsolver_parsed_fname), pcm_print_(print_level), basisset_(basisset) {
+PCM::PCM(const std::string &pcmsolver_parsed_fname, int print_level, std::shared_ptr<BasisSet> basisset,
+         double screening)
+    : screening_(screening),
+      incremental_(false),
+      full_every_(1),
+      nbuild_(0),
+      basisset_(basisset),
+      pcmsolver_parsed_fname_(pcmsolver_parsed_fname),
+      pcm_print_(print_level) {
     if (!pcmsolver_is_compatible_library()) throw PSIEXCEPTION("Incompatible PCMSolver library version.");
 
     std::shared_ptr<Molecule> molecule = basisset_->molecule();
@@ -149,8 +162,6 @@ PCM::PCM(const std::string &pcmsolver_parsed_fname, int print_level, std::shared
     PetiteList petite(basisset, integrals, true);
     my_aotoso_ = petite.aotoso();
 
-    potential_int_ = static_cast<PCMPotentialInt *>(integrals->pcm_potentialint());
-
     context_ = detail::init_PCMSolver(pcmsolver_parsed_fname_, molecule);
     outfile->Printf("  **PSI4:PCMSOLVER Interface Active**\n");
     pcmsolver_print(context_.get());
@@ -165,6 +176,7 @@ PCM::PCM(const std::string &pcmsolver_parsed_fname, int print_level, std::shared
     double **ptess_Zxyz = tess_Zxyz_->pointer();
     // Set the tesserae's coordinates (note the loop bounds; this function is 1-based)
     for (int tess = 1; tess <= ntess_; ++tess) pcmsolver_get_center(context_.get(), tess, &(ptess_Zxyz[tess - 1][1]));
+    build_screening();
 
     int natom = molecule->natom();
     std::vector<double> charges(natom), coordinates(3 * natom);
@@ -209,23 +221,163 @@ PCM::PCM(const PCM *other) {
     MEP_n_ = std::make_shared<Vector>(std::move(other->MEP_n_->clone()));
     basisset_ = other->basisset_;
     my_aotoso_ = other->my_aotoso_->clone();
-    potential_int_ = other->potential_int_;
+    pairs_ = other->pairs_;
+    nbatch_ = other->nbatch_;
+    batch_estimate_ = other->batch_estimate_;
+    screening_ = other->screening_;
+    incremental_ = other->incremental_;
+    full_every_ = other->full_every_;
+    nbuild_ = 0;
     context_ = detail::init_PCMSolver(other->pcmsolver_parsed_fname_, basisset_->molecule());
     pcm_print_ = other->pcm_print_;
 }
 
+void PCM::set_incremental(bool incremental, int full_every) {
+    if (full_every <= 0) throw PSIEXCEPTION("PCM: full_every must be positive.");
+    incremental_ = incremental;
+    full_every_ = full_every;
+    nbuild_ = 0;
+    D_prev_.reset();
+    MEP_e_prev_.reset();
+    ASC_prev_.reset();
+    V_prev_.reset();
+}
+
+void PCM::build_screening() {
+    int nshell = basisset_->nshell();
+    pairs_.clear();
+    for (int P = 0; P < nshell; ++P) {
+        for (int Q = 0; Q <= P; ++Q) {
+            const libint2::Shell &s1 = basisset_->l2_shell(P);
+            const libint2::Shell &s2 = basisset_->l2_shell(Q);
+            double AB2 = 0.0;
+            for (int x = 0; x < 3; ++x) AB2 += (s1.O[x] - s2.O[x]) * (s1.O[x] - s2.O[x]);
+            double overlap = 0.0;
+            double pmax = 0.0;
+            double amin = s1.alpha[0];
+            double bmin = s2.alpha[0];
+            for (size_t i = 0; i < s1.alpha.size(); ++i) {
+                amin = std::min(amin, s1.alpha[i]);
+                for (size_t j = 0; j < s2.alpha.size(); ++j) {
+                    double a = s1.alpha[i], b = s2.alpha[j], p = a + b;
+                    overlap += std::fabs(s1.contr[0].coeff[i] * s2.contr[0].coeff[j]) * std::pow(M_PI / p, 1.5) *
+                               std::exp(-a * b / p * AB2);
+                    pmax = std::max(pmax, p);
+                }
+            }
+            for (size_t j = 0; j < s2.alpha.size(); ++j) bmin = std::min(bmin, s2.alpha[j]);
+
+            ShellPair pair;
+            pair.P = P;
+            pair.Q = Q;
+            for (int x = 0; x < 3; ++x) pair.center[x] = (s1.O[x] * amin + s2.O[x] * bmin) / (amin + bmin);
+            // where the most diffuse product, times the angular factors, has decayed below 1e-10
+            pair.extent = std::sqrt((23.0 + s1.contr[0].l + s2.contr[0].l) / (amin + bmin));
+            // both triangles of an off-diagonal pair
+            pair.bound = (P == Q ? 1.0 : 2.0) * overlap;
+            // the potential of a unit Gaussian charge of exponent p never exceeds 2 (p / pi)^1/2
+            pair.rmin = 0.5 * std::sqrt(M_PI / pmax);
+            // a hundredfold margin for density elements and summed charges above one
+            if (100.0 * pair.bound / pair.rmin < screening_) continue;
+            pairs_.push_back(pair);
+        }
+    }
+
+    double **pZxyz = tess_Zxyz_->pointer();
+    size_t npairs = pairs_.size();
+    nbatch_ = (ntess_ + tess_batch_size - 1) / tess_batch_size;
+    batch_estimate_.assign(nbatch_ * npairs, 0.0f);
+#pragma omp parallel for schedule(dynamic) num_threads(Process::environment.get_n_threads())
+    for (size_t batch = 0; batch < nbatch_; ++batch) {
+        size_t start = batch * tess_batch_size;
+        size_t stop = std::min(start + tess_batch_size, (size_t)ntess_);
+        // Bounding sphere of the batch
+        double middle[3] = {0.0, 0.0, 0.0};
+        for (size_t tess = start; tess < stop; ++tess)
+            for (int x = 0; x < 3; ++x) middle[x] += pZxyz[tess][1 + x] / (stop - start);
+        double radius = 0.0;
+        for (size_t tess = start; tess < stop; ++tess) {
+            double r2 = 0.0;
+            for (int x = 0; x < 3; ++x) r2 += (pZxyz[tess][1 + x] - middle[x]) * (pZxyz[tess][1 + x] - middle[x]);
+            radius = std::max(radius, std::sqrt(r2));
+        }
+        float *estimate = &batch_estimate_[batch * npairs];
+        for (size_t ij = 0; ij < npairs; ++ij) {
+            const ShellPair &pair = pairs_[ij];
+            double r2 = 0.0;
+            for (int x = 0; x < 3; ++x) r2 += (pair.center[x] - middle[x]) * (pair.center[x] - middle[x]);
+            double d = std::sqrt(r2) - radius - pair.extent;
+            estimate[ij] = static_cast<float>(pair.bound / std::max(d, pair.rmin));
+        }
+    }
+
+    if (pcm_print_ > 1) {
+        outfile->Printf("  PCM: %zu significant shell pairs over %zu batches of tesserae.\n", npairs, nbatch_);
+    }
+}
+
 SharedVector PCM::compute_electronic_MEP(const SharedMatrix &D) const {
     double **pZxyz = tess_Zxyz_->pointer();
-    std::vector<std::pair<double, std::array<double, 3>>> field;
-    for (int tess = 0; tess < ntess_; ++tess) {
-        field.push_back({1.0, {pZxyz[tess][1], pZxyz[tess][2], pZxyz[tess][3]}});
+    double **Dp = D->pointer();
+    size_t npairs = pairs_.size();
+    int max_am = basisset_->max_am();
+    int max_nprim = basisset_->max_nprimitive();
+
+    // Largest density element of each pair, in either triangle
+    std::vector<double> Dmax(npairs, 0.0);
+    for (size_t ij = 0; ij < npairs; ++ij) {
+        const ShellPair &pair = pairs_[ij];
+        int o1 = basisset_->shell(pair.P).function_index();
+        int o2 = basisset_->shell(pair.Q).function_index();
+        int n1 = basisset_->shell(pair.P).nfunction();
+        int n2 = basisset_->shell(pair.Q).nfunction();
+        for (int p = 0; p < n1; ++p)
+            for (int q = 0; q < n2; ++q)
+                Dmax[ij] = std::max({Dmax[ij], std::fabs(Dp[o1 + p][o2 + q]), std::fabs(Dp[o2 + q][o1 + p])});
     }
-    potential_int_->set_charge_field(field);
 
     auto MEP = std::make_shared<Vector>(tesspi_);
-    ContractOverDensityFunctor contract_density_functor(ntess_, MEP->pointer(0), D);
+    double *pMEP = MEP->pointer(0);
     // Add in the electronic contribution to the potential at each tessera
-    potential_int_->compute(contract_density_functor);
+#pragma omp parallel num_threads(Process::environment.get_n_threads())
+    {
+        libint2::Engine engine(libint2::Operator::nuclear, max_nprim, max_am, 0);
+        const auto &buf = engine.results();
+        std::vector<size_t> significant;
+
+#pragma omp for schedule(dynamic)
+        for (size_t batch = 0; batch < nbatch_; ++batch) {
+            const float *estimate = &batch_estimate_[batch * npairs];
+            significant.clear();
+            for (size_t ij = 0; ij < npairs; ++ij)
+                if (Dmax[ij] * estimate[ij] >= screening_) significant.push_back(ij);
+
+            size_t start = batch * tess_batch_size;
+            size_t stop = std::min(start + tess_batch_size, (size_t)ntess_);
+            for (size_t tess = start; tess < stop; ++tess) {
+                engine.set_params(std::vector<std::pair<double, std::array<double, 3>>>{
+                    {1.0, {pZxyz[tess][1], pZxyz[tess][2], pZxyz[tess][3]}}});
+                double value = 0.0;
+                for (size_t ij : significant) {
+                    const ShellPair &pair = pairs_[ij];
+                    engine.compute(basisset_->l2_shell(pair.P), basisset_->l2_shell(pair.Q));
+                    if (buf[0] == nullptr) continue;
+                    int o1 = basisset_->shell(pair.P).function_index();
+                    int o2 = basisset_->shell(pair.Q).function_index();
+                    int n1 = basisset_->shell(pair.P).nfunction();
+                    int n2 = basisset_->shell(pair.Q).nfunction();
+                    for (int p = 0, pq = 0; p < n1; ++p) {
+                        for (int q = 0; q < n2; ++q, ++pq) {
+                            double Dpq = Dp[o1 + p][o2 + q];
+                            if (pair.P != pair.Q) Dpq += Dp[o2 + q][o1 + p];
+                            value += Dpq * buf[0][pq];
+                        }
+                    }
+                }
+                pMEP[tess] = value;
+            }
+        }
+    }
 
     // A little debug info
     if (pcm_print_ > 2) {
@@ -237,9 +389,25 @@ SharedVector PCM::compute_electronic_MEP(const SharedMatrix &D) const {
     return MEP;
 }
 
-std::pair<double, SharedMatrix> PCM::compute_PCM_terms(const SharedMatrix &D, CalcType type) const {
+std::pair<double, SharedMatrix> PCM::compute_PCM_terms(const SharedMatrix &D, CalcType type) {
+    // An incremental step works on the change in D and in the ASC since the previous call
+    bool full = !incremental_ || !D_prev_ || (nbuild_ % full_every_ == 0);
+    SharedVector MEP_e;
+    if (full) {
+        MEP_e = compute_electronic_MEP(D);
+    } else {
+        auto dD = D->clone();
+        dD->subtract(D_prev_);
+        MEP_e = compute_electronic_MEP(dD);
+        MEP_e->add(*MEP_e_prev_);
+    }
+    if (incremental_) {
+        D_prev_ = D->clone();
+        // the energy functions below add in the nuclear MEP
+        MEP_e_prev_ = std::make_shared<Vector>(std::move(MEP_e->clone()));
+    }
+
     double upcm = 0.0;
-    auto MEP_e = compute_electronic_MEP(D);
     auto ASC = std::make_shared<Vector>(tesspi_);
     switch (type) {
         case CalcType::Total:
@@ -257,7 +425,22 @@ std::pair<double, SharedMatrix> PCM::compute_PCM_terms(const SharedMatrix &D, Ca
         default:
             throw PSIEXCEPTION("Unknown PCM calculation type.");
     }
-    return std::make_pair(upcm, compute_Vpcm(ASC));
+
+    SharedMatrix V_pcm;
+    if (full || !ASC_prev_) {
+        V_pcm = compute_Vpcm(ASC);
+    } else {
+        auto dASC = std::make_shared<Vector>(std::move(ASC->clone()));
+        dASC->subtract(*ASC_prev_);
+        V_pcm = compute_Vpcm(dASC);
+        V_pcm->add(V_prev_);
+    }
+    if (incremental_) {
+        ASC_prev_ = ASC;
+        V_prev_ = V_pcm->clone();
+        nbuild_++;
+    }
+    return std::make_pair(upcm, V_pcm);
 }
 
 SharedMatrix PCM::compute_V(const SharedMatrix &D) {
@@ -370,8 +553,53 @@ double PCM::compute_E_electronic(const SharedVector &MEP_e) const {
 
 SharedMatrix PCM::compute_Vpcm(const SharedVector &ASC) const {
     auto V_pcm = std::make_shared<Matrix>("PCM potential cart", basisset_->nbf(), basisset_->nbf());
-    ContractOverChargesFunctor contract_charges_functor(ASC->pointer(0), V_pcm);
-    potential_int_->compute(contract_charges_functor);
+    double **Vp = V_pcm->pointer();
+    double **pZxyz = tess_Zxyz_->pointer();
+    size_t npairs = pairs_.size();
+    int max_am = basisset_->max_am();
+    int max_nprim = basisset_->max_nprimitive();
+
+    // Each batch of tesserae enters the integrals as one set of point charges
+    std::vector<std::vector<std::pair<double, std::array<double, 3>>>> charges(nbatch_);
+    std::vector<double> weight(nbatch_, 0.0);
+    for (size_t batch = 0; batch < nbatch_; ++batch) {
+        size_t start = batch * tess_batch_size;
+        size_t stop = std::min(start + tess_batch_size, (size_t)ntess_);
+        for (size_t tess = start; tess < stop; ++tess) {
+            double q = ASC->get(0, tess);
+            if (q == 0.0) continue;
+            charges[batch].push_back({q, {pZxyz[tess][1], pZxyz[tess][2], pZxyz[tess][3]}});
+            weight[batch] += std::fabs(q);
+        }
+    }
+
+    // Pairs own their blocks of V, so they are spread over the threads
+#pragma omp parallel num_threads(Process::environment.get_n_threads())
+    {
+        libint2::Engine engine(libint2::Operator::nuclear, max_nprim, max_am, 0);
+        const auto &buf = engine.results();
+
+#pragma omp for schedule(dynamic)
+        for (size_t ij = 0; ij < npairs; ++ij) {
+            const ShellPair &pair = pairs_[ij];
+            int o1 = basisset_->shell(pair.P).function_index();
+            int o2 = basisset_->shell(pair.Q).function_index();
+            int n1 = basisset_->shell(pair.P).nfunction();
+            int n2 = basisset_->shell(pair.Q).nfunction();
+            for (size_t batch = 0; batch < nbatch_; ++batch) {
+                if (weight[batch] * batch_estimate_[batch * npairs + ij] < screening_) continue;
+                engine.set_params(charges[batch]);
+                engine.compute(basisset_->l2_shell(pair.P), basisset_->l2_shell(pair.Q));
+                if (buf[0] == nullptr) continue;
+                for (int p = 0, pq = 0; p < n1; ++p) {
+                    for (int q = 0; q < n2; ++q, ++pq) {
+                        Vp[o1 + p][o2 + q] += buf[0][pq];
+                        if (pair.P != pair.Q) Vp[o2 + q][o1 + p] += buf[0][pq];
+                    }
+                }
+            }
+        }
+    }
     return V_pcm;
 }
 }  // namespace psi
@@ -43,21 +43,29 @@
 namespace psi {
 class BasisSet;
 class Options;
-class PCMPotentialInt;
 
 class PCM final {
    public:
     enum class CalcType : int { Total, NucAndEle, EleOnly };
     PCM() = default;
-    PCM(const std::string &pcmsolver_parsed_fname, int print_level, std::shared_ptr<BasisSet> basisset);
+    PCM(const std::string &pcmsolver_parsed_fname, int print_level, std::shared_ptr<BasisSet> basisset,
+        double screening = 1.0e-12);
     PCM(const PCM *);
     ~PCM() {}
     /*! \brief Compute polarization energy and Fock matrix contribution
      *  \param[in] D density matrix
      *  \param[in] type how to treat MEP and ASC
+     *
+     *  With set_incremental, the MEP and the PCM potential are updated from the change in D
+     *  and in the ASC since the previous call.
      */
-    std::pair<double, SharedMatrix> compute_PCM_terms(const SharedMatrix &D, CalcType type = CalcType::Total) const;
+    std::pair<double, SharedMatrix> compute_PCM_terms(const SharedMatrix &D, CalcType type = CalcType::Total);
     SharedMatrix compute_V(const SharedMatrix &D);
+    /*! \brief Update the MEP and PCM potential of compute_PCM_terms incrementally
+     *  \param[in] incremental whether to update from the previous call
+     *  \param[in] full_every rebuild from scratch every full_every calls
+     */
+    void set_incremental(bool incremental, int full_every);
 
    private:
     /// The number of tesserae in PCMSolver.
@@ -69,6 +77,36 @@ class PCM final {
     SharedMatrix tess_Zxyz_;
     /// Nucler MEP at cavity points
     SharedVector MEP_n_;
+
+    /// A shell pair P >= Q of the basis, with the extent and overlap bound of its charge distribution
+    struct ShellPair {
+        int P;
+        int Q;
+        double center[3];
+        double extent;
+        double bound;
+        double rmin;
+    };
+    /// Shell pairs with a non-negligible charge distribution
+    std::vector<ShellPair> pairs_;
+    /// Number of batches of tesserae
+    size_t nbatch_;
+    /// For each batch and pair, a bound on |(pq|1/r_C)| over the tesserae C of the batch
+    std::vector<float> batch_estimate_;
+    /// Pair contributions below this, for the largest density element or summed charge, are skipped
+    double screening_;
+    /// Tabulate pairs_ and batch_estimate_
+    void build_screening();
+
+    /// Incremental updates of the MEP and the potential in compute_PCM_terms
+    bool incremental_;
+    int full_every_;
+    int nbuild_;
+    SharedMatrix D_prev_;
+    SharedVector MEP_e_prev_;
+    SharedVector ASC_prev_;
+    SharedMatrix V_prev_;
+
     /// Computes electronic MEP at cavity points
     SharedVector compute_electronic_MEP(const SharedMatrix &D) const;
     /// Calculate energy using total charges and potentials
@@ -90,9 +128,6 @@ class PCM final {
     /// matrices between pure and Cartesian representations.
     SharedMatrix my_aotoso_;
 
-    /// Factory for the electrostatic integrals
-    PCMPotentialInt *potential_int_;
-
     /// Handle to stuff provided by PCMSolver
     std::shared_ptr<pcmsolver_context_t> context_;
 
@@ -53,9 +53,24 @@
 #include <cstdio>
 #include <climits>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
 
 #include "psi4/pragma.h"
+#include "psi4/libqt/qt.h"
 #include "psi4/libqt/blas_intfc_mangle.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 extern "C" {
 
@@ -78,6 +93,11 @@ extern double F_DDOT(int *n, const double *x, int *incx, const double *y, int *i
 extern double F_DNRM2(int *n, double *x, int *incx);
 extern double F_DASUM(int *n, double *x, int *incx);
 extern int F_IDAMAX(int *n, double *x, int *incx);
+
+#ifdef USING_LAPACK_OPENBLAS
+extern void openblas_set_num_threads(int num_threads);
+extern int openblas_get_num_threads(void);
+#endif
 }
 
 namespace psi {
@@ -314,4 +334,98 @@ size_t C_IDAMAX(size_t length, double *x, int inc_x) {
     return reg;
 }
 
+namespace {
+
+// Without a runtime API we can only remember what was asked for
+std::atomic<int> generic_blas_threads(1);
+
+// Threads put to work by the live BlasThreads regions, besides the threads that opened them
+std::atomic<int> claimed_threads(0);
+
+std::mutex warned_lock;
+std::set<std::string> warned_labels;
+
+bool in_parallel() {
+#ifdef _OPENMP
+    return omp_in_parallel();
+#else
+    return false;
+#endif
+}
+
+}  // namespace
+
+/*!
+ * Returns the number of threads BLAS calls from the calling thread will use.
+ *
+ * \ingroup QT
+ */
+int blas_get_num_threads() {
+#if defined(USING_LAPACK_MKL)
+    return mkl_get_max_threads();
+#elif defined(USING_LAPACK_OPENBLAS)
+    return openblas_get_num_threads();
+#else
+    return generic_blas_threads;
+#endif
+}
+
+/*!
+ * Sets the number of threads of all later BLAS calls, through the runtime API of the BLAS in use.
+ *
+ * \ingroup QT
+ */
+void blas_set_num_threads(int nthread) {
+    nthread = std::max(1, nthread);
+#if defined(USING_LAPACK_MKL)
+    mkl_set_num_threads(nthread);
+#elif defined(USING_LAPACK_OPENBLAS)
+    openblas_set_num_threads(nthread);
+#endif
+    generic_blas_threads = nthread;
+}
+
+BlasThreads::BlasThreads(Parallelism mode, int nthread, const std::string &label)
+    : local_(in_parallel()), previous_(0) {
+    int total = std::max(1, Process::environment.get_n_threads());
+    if (mode == Outer) {
+        nthread = std::max(1, nthread);
+        blas_nthread_ = std::max(1, total / nthread);
+        claimed_ = nthread * blas_nthread_ - 1;
+    } else {
+        blas_nthread_ = (nthread > 0) ? nthread : total;
+        claimed_ = blas_nthread_ - 1;
+    }
+
+    int in_use = 1 + (claimed_threads += claimed_);
+    if (in_use > total) {
+        std::lock_guard<std::mutex> guard(warned_lock);
+        if (warned_labels.insert(label).second) {
+            outfile->Printf("    Warning: %s puts %d threads to work on %d threads (BLAS threads per call: %d).\n",
+                            label.c_str(), in_use, total, blas_nthread_);
+        }
+    }
+
+    if (local_) {
+        // Other threads of the team keep their own setting
+#ifdef USING_LAPACK_MKL
+        previous_ = mkl_set_num_threads_local(blas_nthread_);
+#endif
+    } else {
+        previous_ = blas_get_num_threads();
+        blas_set_num_threads(blas_nthread_);
+    }
+}
+
+BlasThreads::~BlasThreads() {
+    claimed_threads -= claimed_;
+    if (local_) {
+#ifdef USING_LAPACK_MKL
+        mkl_set_num_threads_local(previous_);
+#endif
+    } else {
+        blas_set_num_threads(previous_);
+    }
+}
+
 }  // namespace psi
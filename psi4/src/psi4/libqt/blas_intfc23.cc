@@ -36,6 +36,13 @@
 */
 
 #include <stdexcept>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
 
 #include "psi4/pragma.h"
 #include "psi4/libqt/blas_intfc23_mangle.h"
@@ -44,6 +51,7 @@
 extern "C" {
 extern void F_DGBMV(char*, int*, int*, int*, int*, double*, double*, int*, double*, int*, double*, double*, int*);
 extern void F_DGEMM(char*, char*, int*, int*, int*, double*, double*, int*, double*, int*, double*, double*, int*);
+extern void F_SGEMM(char*, char*, int*, int*, int*, float*, float*, int*, float*, int*, float*, float*, int*);
 extern void F_DGEMV(char*, int*, int*, double*, double*, int*, double*, int*, double*, double*, int*);
 extern void F_DGER(int*, int*, double*, double*, int*, double*, int*, double*, int*);
 extern void F_DSBMV(char*, int*, int*, double*, double*, int*, double*, int*, double*, double*, int*);
@@ -327,6 +335,135 @@ PSI_API void C_DGEMM(char transa, char transb, int m, int n, int k, double alpha
     ::F_DGEMM(&transb, &transa, &n, &m, &k, &alpha, b, &ldb, a, &lda, &beta, c, &ldc);
 }
 
+/**
+ * Single-precision C_DGEMM (same row-major conventions), for mixed-precision kernels
+ **/
+PSI_API void C_SGEMM(char transa, char transb, int m, int n, int k, float alpha, float* a, int lda, float* b,
+                     int ldb, float beta, float* c, int ldc) {
+    if (m == 0 || n == 0 || k == 0) return;
+    ::F_SGEMM(&transb, &transa, &n, &m, &k, &alpha, b, &ldb, a, &lda, &beta, c, &ldc);
+}
+
+namespace {
+
+// Products up to this many multiply-adds skip the BLAS call overhead
+const size_t small_gemm_size = 24 * 24 * 24;
+
+// A batch holding a product at least this large gets threaded BLAS, one product after the other
+const size_t large_gemm_size = 128 * 128 * 128;
+
+// A batch with less work than this in all is not worth starting an OpenMP team for
+const size_t spread_batch_size = 64 * 64 * 64;
+
+size_t gemm_size(const DGEMMTask& t) { return (size_t)t.m * t.n * t.k; }
+
+// Row-major C = alpha op(A) op(B) + beta C with plain loops, for products too small for BLAS to pay off
+void small_dgemm(const DGEMMTask& t) {
+    bool ta = (t.transa == 't' || t.transa == 'T');
+    bool tb = (t.transb == 't' || t.transb == 'T');
+    for (int i = 0; i < t.m; i++) {
+        double* ci = t.c + (size_t)i * t.ldc;
+        if (t.beta == 0.0) {
+            std::fill(ci, ci + t.n, 0.0);
+        } else if (t.beta != 1.0) {
+            for (int j = 0; j < t.n; j++) ci[j] *= t.beta;
+        }
+        if (!tb) {
+            for (int l = 0; l < t.k; l++) {
+                double ail = t.alpha * (ta ? t.a[(size_t)l * t.lda + i] : t.a[(size_t)i * t.lda + l]);
+                const double* bl = t.b + (size_t)l * t.ldb;
+                for (int j = 0; j < t.n; j++) ci[j] += ail * bl[j];
+            }
+        } else {
+            for (int j = 0; j < t.n; j++) {
+                const double* bj = t.b + (size_t)j * t.ldb;
+                double sum = 0.0;
+                for (int l = 0; l < t.k; l++) {
+                    sum += (ta ? t.a[(size_t)l * t.lda + i] : t.a[(size_t)i * t.lda + l]) * bj[l];
+                }
+                ci[j] += t.alpha * sum;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+/**
+ * Runs a batch of independent C_DGEMM products as one call. The products may differ in shape and
+ * arguments, but no two may write the same C. Products with m, n, or k zero are skipped, as in C_DGEMM.
+ *
+ * With MKL the batch goes to cblas_dgemm_batch. Otherwise tiny products are done with plain loops, and
+ * the batch is spread over the OpenMP threads when there is enough work in all and no product is large
+ * enough to be better off with all BLAS threads to itself; other batches run serially.
+ *
+ * @param tasks The products, row-major as in C_DGEMM
+ *
+ * @ingroup QT
+ */
+PSI_API void C_DGEMM_BATCH(const std::vector<DGEMMTask>& tasks) {
+    std::vector<const DGEMMTask*> work;
+    work.reserve(tasks.size());
+    size_t largest = 0;
+    size_t total = 0;
+    for (const auto& t : tasks) {
+        if (t.m == 0 || t.n == 0 || t.k == 0) continue;
+        work.push_back(&t);
+        largest = std::max(largest, gemm_size(t));
+        total += gemm_size(t);
+    }
+    if (work.empty()) return;
+    if (work.size() == 1) {
+        const DGEMMTask& t = *work[0];
+        C_DGEMM(t.transa, t.transb, t.m, t.n, t.k, t.alpha, t.a, t.lda, t.b, t.ldb, t.beta, t.c, t.ldc);
+        return;
+    }
+
+#ifdef USING_LAPACK_MKL
+    size_t ntask = work.size();
+    std::vector<CBLAS_TRANSPOSE> transa(ntask), transb(ntask);
+    std::vector<MKL_INT> m(ntask), n(ntask), k(ntask), lda(ntask), ldb(ntask), ldc(ntask), group_size(ntask, 1);
+    std::vector<double> alpha(ntask), beta(ntask);
+    std::vector<const double*> a(ntask), b(ntask);
+    std::vector<double*> c(ntask);
+    for (size_t i = 0; i < ntask; i++) {
+        const DGEMMTask& t = *work[i];
+        transa[i] = (t.transa == 't' || t.transa == 'T') ? CblasTrans : CblasNoTrans;
+        transb[i] = (t.transb == 't' || t.transb == 'T') ? CblasTrans : CblasNoTrans;
+        m[i] = t.m;
+        n[i] = t.n;
+        k[i] = t.k;
+        alpha[i] = t.alpha;
+        beta[i] = t.beta;
+        a[i] = t.a;
+        b[i] = t.b;
+        c[i] = t.c;
+        lda[i] = t.lda;
+        ldb[i] = t.ldb;
+        ldc[i] = t.ldc;
+    }
+    cblas_dgemm_batch(CblasRowMajor, transa.data(), transb.data(), m.data(), n.data(), k.data(), alpha.data(),
+                      a.data(), lda.data(), b.data(), ldb.data(), beta.data(), c.data(), ldc.data(), (MKL_INT)ntask,
+                      group_size.data());
+#else
+    auto run = [](const DGEMMTask& t) {
+        if (gemm_size(t) <= small_gemm_size)
+            small_dgemm(t);
+        else
+            C_DGEMM(t.transa, t.transb, t.m, t.n, t.k, t.alpha, t.a, t.lda, t.b, t.ldb, t.beta, t.c, t.ldc);
+    };
+
+#ifdef _OPENMP
+    if (largest < large_gemm_size && total >= spread_batch_size && omp_get_max_threads() > 1 && !omp_in_parallel()) {
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t i = 0; i < work.size(); i++) run(*work[i]);
+        return;
+    }
+#endif
+    for (const auto* t : work) run(*t);
+#endif
+}
+
 /**
  *  Purpose
  *  =======
@@ -62,7 +62,8 @@ void dirprd_block(double **A, double **B, int rows, int cols) {
     a = A[0];
     b = B[0];
 
-    for (i = 0; i < size; i++, a++, b++) (*b) = (*a) * (*b);
+#pragma omp parallel for schedule(static) if (size >= 65536)
+    for (i = 0; i < size; i++) b[i] = a[i] * b[i];
 }
 
 }  // namespace psi
@@ -39,6 +39,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "psi4/pragma.h"
 #include "psi4/psi4-dec.h"
@@ -90,6 +91,10 @@ void parallel_timer_off(const std::string& key, int thread_rank);
 void start_skip_timers();
 void stop_skip_timers();
 void clean_timers();
+void timer_count(const std::string& key, double value);
+void set_timer_trace(bool trace);
+void timer_write_json(const std::string& filename);
+void timer_write_trace(const std::string& filename);
 
 void print_block(double*, int, int, FILE*);
 
@@ -104,6 +109,42 @@ double*** init_3d_array(int p, int q, int r);
 
 #define MAX_RAS_SPACES 4
 
+// BLAS threading
+PSI_API
+int blas_get_num_threads();
+PSI_API
+void blas_set_num_threads(int nthread);
+
+/*! \ingroup QT
+ *  \class BlasThreads
+ *  \brief Sets the BLAS thread count for the lifetime of the object and restores it afterwards.
+ *
+ *  An Outer region runs a parallel loop over nthread tasks, each of which calls BLAS with an even
+ *  share of the threads that are left. An Inner region makes large BLAS calls from one thread with
+ *  nthread BLAS threads (0 for all of them). Inside a parallel region only the calling thread is
+ *  affected, where the BLAS allows it (MKL). A region that would put more threads to work than
+ *  NUM_THREADS prints a warning once per label.
+ */
+class PSI_API BlasThreads {
+   public:
+    enum Parallelism { Outer, Inner };
+
+    BlasThreads(Parallelism mode, int nthread, const std::string& label);
+    ~BlasThreads();
+
+    /// BLAS threads per call within the region
+    int blas_threads() const { return blas_nthread_; }
+
+   private:
+    /// Set with a thread-local call, so restored the same way
+    bool local_;
+    /// BLAS threads before the region
+    int previous_;
+    int blas_nthread_;
+    /// Threads this region puts to work besides the calling one
+    int claimed_;
+};
+
 // BLAS 1 Double routines
 void C_DROT(size_t ntot, double* x, int incx, double* y, int incy, double costheta, double sintheta);
 void C_DSWAP(size_t length, double* x, int incx, double* y, int inc_y);
@@ -143,6 +184,28 @@ void C_DTRSM(char side, char uplo, char transa, char diag, int m, int n, double
 PSI_API
 void C_DGEMM(char transa, char transb, int m, int n, int k, double alpha, double* a, int lda, double* b, int ldb,
              double beta, double* c, int ldc);
+PSI_API
+void C_SGEMM(char transa, char transb, int m, int n, int k, float alpha, float* a, int lda, float* b, int ldb,
+             float beta, float* c, int ldc);
+
+/// One product C = alpha op(A) op(B) + beta C of a batch, with the arguments of C_DGEMM
+struct DGEMMTask {
+    char transa;
+    char transb;
+    int m;
+    int n;
+    int k;
+    double alpha;
+    double* a;
+    int lda;
+    double* b;
+    int ldb;
+    double beta;
+    double* c;
+    int ldc;
+};
+PSI_API
+void C_DGEMM_BATCH(const std::vector<DGEMMTask>& tasks);
 void C_DSYMM(char side, char uplo, int m, int n, double alpha, double* a, int lda, double* b, int ldb, double beta,
              double* c, int ldc);
 void C_DTRMM(char side, char uplo, char transa, char diag, int m, int n, double alpha, double* a, int lda, double* b,
@@ -72,6 +72,13 @@
 ** Implemented timer for OpenMP parallism.
 **
 ** Tianyuan Zhang, June 2017
+**
+** The timer tree can also be written as JSON (timer_write_json()), and,
+** while set_timer_trace(true) is in effect, every timer_on/timer_off pair
+** is recorded as an event for a Chrome trace (timer_write_trace(), to be
+** opened in chrome://tracing or Perfetto). Named counters (timer_count(),
+** e.g. bytes moved by libpsio or flops of DPD contractions) are kept
+** alongside the timers and appear in both.
 */
 
 #include <cstdio>
@@ -88,11 +95,17 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <list>
 #include <map>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
+#ifndef _MSC_VER
+#include <sys/resource.h>
+#endif
 #ifdef _OPENMP
 #include <omp.h>
 #else
@@ -477,6 +490,7 @@ class Timer_Structure {
         }
         return wtime_;
     }
+    const std::vector<Timer_thread> &get_thread_timers() const { return thread_timers_; }
     const std::list<Timer_Structure> &get_children() const { return children_; }
     bool all_children_off() {
         for (auto child_iter = children_.begin(), end_iter = children_.end(); child_iter != end_iter; ++child_iter) {
@@ -935,6 +949,127 @@ std::time_t timer_start, timer_end;
 bool skip_timers;
 static omp_lock_t lock_timer;
 
+// One complete ('X') or counter ('C') event of the Chrome trace, times in microseconds since trace_origin
+struct Trace_Event {
+    std::string name;
+    char phase;
+    int tid;
+    double ts;
+    double dur;
+};
+bool trace_timers = false;
+clock::time_point trace_origin;
+std::vector<Trace_Event> trace_events;
+std::map<std::pair<int, std::string>, clock::time_point> trace_open;
+
+// Counters are bumped from threads that never hold lock_timer (e.g. the psio I/O scheduler)
+std::mutex lock_counters;
+std::map<std::string, double> timer_counters;
+std::map<std::string, double> traced_counters;
+
+double trace_time(clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(t - trace_origin).count();
+}
+
+void trace_begin(const std::string &key, int tid) {
+    if (trace_timers) trace_open[std::make_pair(tid, key)] = clock::now();
+}
+
+void trace_end(const std::string &key, int tid) {
+    if (!trace_timers) return;
+    auto open = trace_open.find(std::make_pair(tid, key));
+    if (open == trace_open.end()) return;
+    clock::time_point now = clock::now();
+    double ts = trace_time(open->second);
+    trace_events.push_back({key, 'X', tid, ts, trace_time(now) - ts});
+    trace_open.erase(open);
+
+    // Counters that moved since the last event
+    std::lock_guard<std::mutex> guard(lock_counters);
+    for (const auto &counter : timer_counters) {
+        double &last = traced_counters[counter.first];
+        if (counter.second == last) continue;
+        last = counter.second;
+        trace_events.push_back({counter.first, 'C', 0, trace_time(now), counter.second});
+    }
+}
+
+/// High-water mark of the resident memory of this process, in bytes (0 where unknown)
+size_t max_rss_bytes() {
+#ifdef _MSC_VER
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return 1024 * (size_t)usage.ru_maxrss;
+#endif
+#endif
+}
+
+std::string json_string(const std::string &str) {
+    std::string out = "\"";
+    for (char c : str) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char)c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+void json_timer(const Timer_Structure &timer, std::ostringstream &out, const std::string &indent) {
+    clock::duration wtime = timer.get_total_wtime();
+    if (timer.get_status() == ON) wtime += clock::now() - timer.get_wall_start();
+    out << indent << "{\"name\": " << json_string(timer.get_key()) << ", \"calls\": " << timer.get_n_calls()
+        << ", \"wall\": " << std::chrono::duration_cast<std::chrono::duration<double>>(wtime).count();
+    if (timer.get_status() == PARALLEL) {
+        out << ", \"thread_wall\": [";
+        const std::vector<Timer_thread> &threads = timer.get_thread_timers();
+        for (size_t i = 0; i < threads.size(); ++i) {
+            out << (i ? ", " : "")
+                << std::chrono::duration_cast<std::chrono::duration<double>>(threads[i].get_wtime()).count();
+        }
+        out << "]";
+    } else {
+        out << ", \"user\": " << timer.get_utime() << ", \"system\": " << timer.get_stime();
+    }
+    const std::list<Timer_Structure> &children = timer.get_children();
+    out << ", \"children\": [";
+    if (!children.empty()) {
+        out << "\n";
+        for (auto child_iter = children.begin(), end_iter = children.end(); child_iter != end_iter; ++child_iter) {
+            if (child_iter != children.begin()) out << ",\n";
+            json_timer(*child_iter, out, indent + "  ");
+        }
+        out << "\n" << indent;
+    }
+    out << "]}";
+}
+
+void write_text(const std::string &filename, const std::string &text) {
+    std::ofstream file(filename);
+    if (!file) throw PSIEXCEPTION("Unable to open " + filename + " for writing.");
+    file << text;
+}
+
 void print_timer(const Timer_Structure &timer, std::shared_ptr<PsiOutStream> printer, int align_key_width) {
     std::string key = timer.get_key();
     if (key.length() < align_key_width) {
@@ -1047,9 +1182,106 @@ void clean_timers() {
     extern Timer_Structure root_timer, parallel_timer;
     root_timer = new_root_timer;
     parallel_timer = new_parallel_timer;
+    {
+        std::lock_guard<std::mutex> guard(lock_counters);
+        timer_counters.clear();
+        traced_counters.clear();
+    }
     timer_init();
 }
 
+/*!
+** timer_count(): Add value to the counter with the given name. Thread safe,
+** and may be called inside OpenMP parallel sections.
+**
+** \param key = Name of counter
+** \param value = Amount to add
+**
+** \ingroup QT
+*/
+PSI_API void timer_count(const std::string &key, double value) {
+    std::lock_guard<std::mutex> guard(lock_counters);
+    timer_counters[key] += value;
+}
+
+/*!
+** set_timer_trace(): Start (discarding earlier events) or stop recording
+** timer events for timer_write_trace().
+**
+** \param trace = Record events?
+**
+** \ingroup QT
+*/
+PSI_API void set_timer_trace(bool trace) {
+    omp_set_lock(&lock_timer);
+    if (trace && !trace_timers) {
+        trace_events.clear();
+        trace_open.clear();
+        trace_origin = clock::now();
+        std::lock_guard<std::mutex> guard(lock_counters);
+        traced_counters.clear();
+    }
+    trace_timers = trace;
+    omp_unset_lock(&lock_timer);
+}
+
+/*!
+** timer_write_json(): Write the timer tree, counters, and memory high-water
+** mark as JSON. Timers still on are reported with the time up to now,
+** parallel timers with the time of each thread.
+**
+** \param filename = File to (over)write
+**
+** \ingroup QT
+*/
+PSI_API void timer_write_json(const std::string &filename) {
+    std::ostringstream out;
+    out.precision(9);
+    omp_set_lock(&lock_timer);
+    out << "{\n\"timers\":\n";
+    json_timer(root_timer, out, "");
+    omp_unset_lock(&lock_timer);
+    out << ",\n\"counters\": {";
+    {
+        std::lock_guard<std::mutex> guard(lock_counters);
+        for (auto iter = timer_counters.begin(); iter != timer_counters.end(); ++iter) {
+            out << (iter == timer_counters.begin() ? "" : ", ") << json_string(iter->first) << ": " << iter->second;
+        }
+    }
+    out << "},\n\"max_rss_bytes\": " << max_rss_bytes() << "\n}\n";
+    write_text(filename, out.str());
+}
+
+/*!
+** timer_write_trace(): Write the events recorded since set_timer_trace(true)
+** in the Chrome trace event format. Thread ranks of parallel timers become
+** the tids of the trace.
+**
+** \param filename = File to (over)write
+**
+** \ingroup QT
+*/
+PSI_API void timer_write_trace(const std::string &filename) {
+    std::ostringstream out;
+    out.precision(15);
+    out << "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"max_rss_bytes\": " << max_rss_bytes()
+        << "},\n\"traceEvents\": [";
+    omp_set_lock(&lock_timer);
+    for (size_t i = 0; i < trace_events.size(); ++i) {
+        const Trace_Event &event = trace_events[i];
+        out << (i ? ",\n" : "\n") << "{\"name\": " << json_string(event.name) << ", \"ph\": \"" << event.phase
+            << "\", \"pid\": 0, \"tid\": " << event.tid << ", \"ts\": " << event.ts;
+        if (event.phase == 'X') {
+            out << ", \"dur\": " << event.dur << "}";
+        } else {
+            out << ", \"args\": {\"value\": " << event.dur << "}}";
+        }
+    }
+    omp_unset_lock(&lock_timer);
+    out << "\n]}\n";
+    write_text(filename, out.str());
+}
+
 void start_skip_timers() {
     omp_set_lock(&lock_timer);
     extern bool skip_timers;
@@ -1097,6 +1329,7 @@ PSI_API void timer_on(const std::string &key) {
         ser_on_timers.push_back(top_timer_ptr);
         top_timer_ptr->turn_on();
     }
+    trace_begin(key, 0);
     omp_unset_lock(&lock_timer);
 }
 
@@ -1168,6 +1401,7 @@ PSI_API void timer_off(const std::string &key) {
             parent_ptr = on_child_ptr;
         }
     }
+    trace_end(key, 0);
     omp_unset_lock(&lock_timer);
 }
 
@@ -1211,6 +1445,7 @@ void parallel_timer_on(const std::string &key, int thread_rank) {
             top_timer_ptr->turn_on(thread_rank);
         }
     }
+    trace_begin(key, thread_rank);
     omp_unset_lock(&lock_timer);
 }
 
@@ -1286,6 +1521,7 @@ void parallel_timer_off(const std::string &key, int thread_rank) {
             parent_ptr = on_child_ptr;
         }
     }
+    trace_end(key, thread_rank);
     if (parallel_timer.get_parent() != nullptr && empty_parallel()) {
         parallel_timer.get_parent()->merge_move_all(&parallel_timer);
         parallel_timer.set_parent(nullptr);
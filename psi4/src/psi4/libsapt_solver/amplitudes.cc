@@ -927,12 +927,11 @@ void SAPT2p3::Y3_2(double **yAR, int intfile, const char *ARlabel, const char *R
 
     psio_address next_DF_RR = PSIO_ZERO;
 
-    for (int r1 = 0, r1r2 = 0; r1 < nvirA; r1++) {
-        for (int r2 = 0; r2 <= r1; r2++, r1r2++) {
-            next_DF_RR = psio_get_address(PSIO_ZERO, sizeof(double) * (r1 * nvirA + r2) * (ndf_ + 3));
-            psio_->read(intfile, RRlabel, (char *)&(B_p_RR[r1r2][0]), sizeof(double) * (ndf_ + 3), next_DF_RR,
-                        &next_DF_RR);
-        }
+    // The (r1,r2<=r1) entries of one row are contiguous on disk, read them in one go
+    for (int r1 = 0; r1 < nvirA; r1++) {
+        next_DF_RR = psio_get_address(PSIO_ZERO, sizeof(double) * (r1 * nvirA) * (ndf_ + 3));
+        psio_->read(intfile, RRlabel, (char *)&(B_p_RR[ioff_[r1]][0]), sizeof(double) * (r1 + 1) * (ndf_ + 3),
+                    next_DF_RR, &next_DF_RR);
     }
 
     for (int a = 0; a < aoccA; a++) {
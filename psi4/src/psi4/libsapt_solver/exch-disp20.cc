@@ -106,6 +106,14 @@ void SAPT0::exch_disp20_n5() {
     double **tabRS = block_matrix(nthreads, nvirA_ * nvirB_);
     double **vabRS = block_matrix(nthreads, nvirA_ * nvirB_);
 
+    // Virtual part of the dispersion denominators, e_r + e_s, shared by every ab pair
+    double *evalsRS = init_array((long int)nvirA_ * nvirB_);
+    for (int r = 0, rs = 0; r < nvirA_; r++) {
+        for (int s = 0; s < nvirB_; s++, rs++) {
+            evalsRS[rs] = evalsA_[r + noccA_] + evalsB_[s + noccB_];
+        }
+    }
+
     double **T_AR = block_matrix(A_chunk * nvirA_, ndf_);
     double **T_BS = block_matrix(B_chunk * nvirB_, ndf_);
     double **V_BR = block_matrix(B_chunk * nvirA_, ndf_ + 3);
@@ -184,15 +192,17 @@ void SAPT0::exch_disp20_n5() {
                     C_DGEMM('N', 'T', nvirA_, nvirB_, ndf_, 1.0, T_AR[arel * nvirA_], ndf_, T_BS[brel * nvirB_], ndf_,
                             0.0, tabRS[rank], nvirB_);
 
-                    for (int r = 0, rs = 0; r < nvirA_; r++) {
-                        for (int s = 0; s < nvirB_; s++, rs++) {
-                            double denom = evalsA_[aabs + foccA_] + evalsB_[babs + foccB_] - evalsA_[r + noccA_] -
-                                           evalsB_[s + noccB_];
-                            double tval = tabRS[rank][rs];
-                            tabRS[rank][rs] /= denom;
-                            e_disp20 += 4.0 * tval * tval / denom;
-                        }
+                    // Divide by the denominator and accumulate the energy in the same pass
+                    double eab = evalsA_[aabs + foccA_] + evalsB_[babs + foccB_];
+                    double *tabp = tabRS[rank];
+                    double e_ab = 0.0;
+                    for (int rs = 0; rs < nvirA_ * nvirB_; rs++) {
+                        double vval = tabp[rs];
+                        double tval = vval / (eab - evalsRS[rs]);
+                        tabp[rs] = tval;
+                        e_ab += vval * tval;
                     }
+                    e_disp20 += 4.0 * e_ab;
 
                     C_DGEMM('N', 'T', nvirA_, nvirB_, ndf_ + 3, 1.0, V_BR[brel * nvirA_], ndf_ + 3, V_AS[arel * nvirB_],
                             ndf_ + 3, 0.0, vabRS[rank], nvirB_);
@@ -214,6 +224,7 @@ void SAPT0::exch_disp20_n5() {
 
     free_block(tabRS);
     free_block(vabRS);
+    free(evalsRS);
 
     free_block(T_AR);
     free_block(T_BS);
@@ -441,6 +441,10 @@ std::vector<SharedMatrix> FDDS_Dispersion::project_densities(std::vector<SharedM
 }
 
 SharedMatrix FDDS_Dispersion::form_unc_amplitude(std::string monomer, double omega) {
+    return form_unc_amplitudes(monomer, {omega})[0];
+}
+
+std::vector<SharedMatrix> FDDS_Dispersion::form_unc_amplitudes(std::string monomer, std::vector<double> omegas) {
     // ==> Configuration <==
     SharedVector eps_occ, eps_vir;
     std::string ovQ_tensor_name;
@@ -462,10 +466,12 @@ SharedMatrix FDDS_Dispersion::form_unc_amplitude(std::string monomer, double ome
     size_t nocc = eps_occ->dim(0);
     size_t nvir = eps_vir->dim(0);
     size_t naux = auxiliary_->nbf();
+    size_t nomega = omegas.size();
 
     // Check on memory real quick
     size_t doubles = Process::environment.get_memory() * 0.8 / sizeof(double);
-    size_t mem_size = 2 * naux * nvir + naux * naux + nvir * nocc;
+    size_t static_size = nomega * (naux * naux + nvir * nocc);
+    size_t mem_size = 2 * naux * nvir + static_size;
     if (mem_size > doubles) {
         std::stringstream message;
         double mem_gb = ((double)(mem_size) / 0.8 * sizeof(double));
@@ -475,32 +481,38 @@ SharedMatrix FDDS_Dispersion::form_unc_amplitude(std::string monomer, double ome
     }
 
     // ==> Uncoupled Amplitudes <==
-    auto amp = std::make_shared<Matrix>(nocc, nvir);
-
-    double** ampp = amp->pointer();
+    std::vector<SharedMatrix> amps;
     double* eoccp = eps_occ->pointer();
     double* evirp = eps_vir->pointer();
 
+    for (size_t w = 0; w < nomega; w++) {
+        double omega = omegas[w];
+        auto amp = std::make_shared<Matrix>(nocc, nvir);
+        double** ampp = amp->pointer();
+
 #pragma omp parallel for
-    for (size_t i = 0; i < nocc; i++) {
-        for (size_t a = 0; a < nvir; a++) {
-            double val = -1.0 * (eoccp[i] - evirp[a]);
-            double tmp = 4.0 * val / (val * val + omega * omega);
-            // Lets see how stable this is, should be fine
-            if (tmp < 1.e-14) {
-                ampp[i][a] = 0.0;
-            } else {
-                ampp[i][a] = std::pow(tmp, 0.5);
+        for (size_t i = 0; i < nocc; i++) {
+            for (size_t a = 0; a < nvir; a++) {
+                double val = -1.0 * (eoccp[i] - evirp[a]);
+                double tmp = 4.0 * val / (val * val + omega * omega);
+                // Lets see how stable this is, should be fine
+                if (tmp < 1.e-14) {
+                    ampp[i][a] = 0.0;
+                } else {
+                    ampp[i][a] = std::pow(tmp, 0.5);
+                }
             }
         }
+        amps.push_back(amp);
     }
 
     // amp->print();
 
     // ==> Contract <==
 
-    size_t dmem = doubles - naux * naux - nvir * nocc;
-    size_t bsize = dmem / (naux * nvir);
+    // Each (ar|Q) block is read once and contracted for every frequency
+    size_t dmem = doubles - static_size;
+    size_t bsize = dmem / (2 * naux * nvir);
     if (bsize > nocc) {
         bsize = nocc;
     }
@@ -509,17 +521,19 @@ SharedMatrix FDDS_Dispersion::form_unc_amplitude(std::string monomer, double ome
     // printf("dmem:    %zu\n", dmem);
     // printf("bsize:   %zu\n", bsize);
 
-
-    auto ret = std::make_shared<Matrix>("UNC Amplitude", naux, naux);
+    std::vector<SharedMatrix> ret;
+    for (size_t w = 0; w < nomega; w++) {
+        ret.push_back(std::make_shared<Matrix>("UNC Amplitude", naux, naux));
+    }
     auto tmp = std::make_shared<Matrix>("arQ tmp", bsize * nvir, naux);
+    auto scaled = std::make_shared<Matrix>("arQ scaled", bsize * nvir, naux);
 
     double** tmpp = tmp->pointer();
+    double** scaledp = scaled->pointer();
 
-    ret->zero();
-    size_t rstat, osize;
+    size_t osize;
     for (size_t block = 0, bcount = 0; block < nblocks; block++) {
         // printf("Block %zu\n", block);
-        tmp->zero();
         if (((block + 1) * bsize) > nocc) {
             osize = nocc - block * bsize;
         } else {
@@ -529,21 +543,35 @@ SharedMatrix FDDS_Dispersion::form_unc_amplitude(std::string monomer, double ome
         dfh_->fill_tensor(ovQ_tensor_name, tmp, {bcount, bcount + osize});
         size_t shift_i = block * bsize;
 
+        for (size_t w = 0; w < nomega; w++) {
+            double** ampp = amps[w]->pointer();
+
 #pragma omp parallel for collapse(2)
-        for (size_t i = 0; i < osize; i++) {
-            for (size_t a = 0; a < nvir; a++) {
-                double val = ampp[i + shift_i][a];
+            for (size_t i = 0; i < osize; i++) {
+                for (size_t a = 0; a < nvir; a++) {
+                    double val = ampp[i + shift_i][a];
 #pragma omp simd
-                for (size_t Q = 0; Q < naux; Q++) {
-                    tmpp[i * nvir + a][Q] *= val;
+                    for (size_t Q = 0; Q < naux; Q++) {
+                        scaledp[i * nvir + a][Q] = val * tmpp[i * nvir + a][Q];
+                    }
                 }
             }
-        }
 
-        ret->gemm(true, false, 1.0, tmp, tmp, 1.0);
+            // Lower triangle only, filled in below
+            C_DSYRK('L', 'T', naux, osize * nvir, 1.0, scaledp[0], naux, 1.0, ret[w]->pointer()[0], naux);
+        }
         bcount += osize;
     }
 
+    for (size_t w = 0; w < nomega; w++) {
+        double** retp = ret[w]->pointer();
+        for (size_t P = 0; P < naux; P++) {
+            for (size_t Q = 0; Q < P; Q++) {
+                retp[Q][P] = retp[P][Q];
+            }
+        }
+    }
+
     return ret;
 }
 
@@ -99,6 +99,14 @@ class FDDS_Dispersion {
      */
     SharedMatrix form_unc_amplitude(std::string monomer, double omega);
 
+    /**
+     * Forms the uncoupled amplitudes of several frequencies, reading the (ov|Q) integrals once
+     * @param  monomer Monomer "A" or "B"
+     * @param  omegas  Time dependent values
+     * @return         "PQ" amplitude for each omega
+     */
+    std::vector<SharedMatrix> form_unc_amplitudes(std::string monomer, std::vector<double> omegas);
+
     /**
      * Forms the uncoupled amplitude and other PQ matrices in hybrid FDDS dispersion
      * @param  monomer Monomer "A" or "B"
@@ -28,6 +28,7 @@
 
 #include "usapt0.h"
 
+#include <algorithm>
 #include <ctime>
 
 #include "psi4/physconst.h"
@@ -1759,16 +1760,20 @@ std::map<std::string, std::shared_ptr<Matrix> > CPKS_USAPT0::product(
 
     std::map<std::string, std::shared_ptr<Matrix> > s;
 
-    bool do_A = b.count("Aa") || b.count("Ab");
-    bool do_B = b.count("Ba") || b.count("Bb");
-    bool alpha_A, alpha_B, beta_A, beta_B;
-    if (do_A) {
-        alpha_A = (b["Aa"]->nrow() > 0) && (b["Aa"]->ncol() > 0);
-        beta_A = (b["Ab"]->nrow() > 0) && (b["Ab"]->ncol() > 0);
-    }
-    if (do_B) {
-        alpha_B = (b["Ba"]->nrow() > 0) && (b["Ba"]->ncol() > 0);
-        beta_B = (b["Bb"]->nrow() > 0) && (b["Bb"]->ncol() > 0);
+    // Spin blocks of both monomers; all active trial vectors go through a single JK call
+    const std::vector<std::string> keys = {"Aa", "Ab", "Ba", "Bb"};
+    std::map<std::string, std::shared_ptr<Matrix> > Cocc = {
+        {"Aa", Cocca_A_}, {"Ab", Coccb_A_}, {"Ba", Cocca_B_}, {"Bb", Coccb_B_}};
+    std::map<std::string, std::shared_ptr<Matrix> > Cvir = {
+        {"Aa", Cvira_A_}, {"Ab", Cvirb_A_}, {"Ba", Cvira_B_}, {"Bb", Cvirb_B_}};
+    std::map<std::string, std::shared_ptr<Vector> > eps_occ = {
+        {"Aa", eps_occa_A_}, {"Ab", eps_occb_A_}, {"Ba", eps_occa_B_}, {"Bb", eps_occb_B_}};
+    std::map<std::string, std::shared_ptr<Vector> > eps_vir = {
+        {"Aa", eps_vira_A_}, {"Ab", eps_virb_A_}, {"Ba", eps_vira_B_}, {"Bb", eps_virb_B_}};
+
+    std::vector<std::string> active;
+    for (const auto& key : keys) {
+        if (b.count(key) && b[key]->nrow() > 0 && b[key]->ncol() > 0) active.push_back(key);
     }
 
     std::vector<SharedMatrix>& Cl = jk_->C_left();
@@ -1776,233 +1781,71 @@ std::map<std::string, std::shared_ptr<Matrix> > CPKS_USAPT0::product(
     Cl.clear();
     Cr.clear();
 
-    if (do_A) {
-        if (alpha_A) {
-            Cl.push_back(Cocca_A_);
-            size_t no = b["Aa"]->nrow();
-            size_t nv = b["Aa"]->ncol();
-            size_t nso = Cvira_A_->nrow();
-            double** Cp = Cvira_A_->pointer();
-            double** bp = b["Aa"]->pointer();
-            auto T = std::make_shared<Matrix>("T", nso, no);
-            double** Tp = T->pointer();
-            C_DGEMM('N', 'T', nso, no, nv, 1.0, Cp[0], nv, bp[0], nv, 0.0, Tp[0], no);
-            Cr.push_back(T);
-        }
-        if (beta_A) {
-            Cl.push_back(Coccb_A_);
-            size_t no = b["Ab"]->nrow();
-            size_t nv = b["Ab"]->ncol();
-            size_t nso = Cvirb_A_->nrow();
-            double** Cp = Cvirb_A_->pointer();
-            double** bp = b["Ab"]->pointer();
-            auto T = std::make_shared<Matrix>("T", nso, no);
-            double** Tp = T->pointer();
-            C_DGEMM('N', 'T', nso, no, nv, 1.0, Cp[0], nv, bp[0], nv, 0.0, Tp[0], no);
-            Cr.push_back(T);
-        }
-    }
-
-    if (do_B) {
-        if (alpha_B) {
-            Cl.push_back(Cocca_B_);
-            size_t no = b["Ba"]->nrow();
-            size_t nv = b["Ba"]->ncol();
-            size_t nso = Cvira_B_->nrow();
-            double** Cp = Cvira_B_->pointer();
-            double** bp = b["Ba"]->pointer();
-            auto T = std::make_shared<Matrix>("T", nso, no);
-            double** Tp = T->pointer();
-            C_DGEMM('N', 'T', nso, no, nv, 1.0, Cp[0], nv, bp[0], nv, 0.0, Tp[0], no);
-            Cr.push_back(T);
-        }
-        if (beta_B) {
-            Cl.push_back(Coccb_B_);
-            size_t no = b["Bb"]->nrow();
-            size_t nv = b["Bb"]->ncol();
-            size_t nso = Cvirb_B_->nrow();
-            double** Cp = Cvirb_B_->pointer();
-            double** bp = b["Bb"]->pointer();
-            auto T = std::make_shared<Matrix>("T", nso, no);
-            double** Tp = T->pointer();
-            C_DGEMM('N', 'T', nso, no, nv, 1.0, Cp[0], nv, bp[0], nv, 0.0, Tp[0], no);
-            Cr.push_back(T);
-        }
+    for (const auto& key : active) {
+        Cl.push_back(Cocc[key]);
+        size_t no = b[key]->nrow();
+        size_t nv = b[key]->ncol();
+        size_t nso = Cvir[key]->nrow();
+        double** Cp = Cvir[key]->pointer();
+        double** bp = b[key]->pointer();
+        auto T = std::make_shared<Matrix>("T", nso, no);
+        double** Tp = T->pointer();
+        C_DGEMM('N', 'T', nso, no, nv, 1.0, Cp[0], nv, bp[0], nv, 0.0, Tp[0], no);
+        Cr.push_back(T);
     }
 
-    jk_->compute();
+    if (!active.empty()) jk_->compute();
 
     const std::vector<SharedMatrix>& J = jk_->J();
     const std::vector<SharedMatrix>& K = jk_->K();
 
-    int ind_jk = 0;
-
-    if (do_A) {
-        std::shared_ptr<Matrix> Jva;
-        std::shared_ptr<Matrix> Jvb;
-        std::shared_ptr<Matrix> Kva;
-        std::shared_ptr<Matrix> Kvb;
-        std::shared_ptr<Matrix> T;
-        if (alpha_A) {
-            Jva = J[ind_jk];
-            Kva = K[ind_jk];
-            ++ind_jk;
-            Jva->scale(2.0);
-            T = Jva->clone();
-        }
-        if (beta_A) {
-            Jvb = J[ind_jk];
-            Kvb = K[ind_jk];
-            ++ind_jk;
-            Jvb->scale(2.0);
-            if (alpha_A) {
-                T->add(Jvb);
-            } else {
-                T = Jvb->clone();
-            }
-        }
-        if (alpha_A) {
-            Jva->copy(T);
-            Jva->subtract(Kva);
-            Jva->subtract(Kva->transpose());
-        }
-        if (beta_A) {
-            Jvb->copy(T);
-            Jvb->subtract(Kvb);
-            Jvb->subtract(Kvb->transpose());
-        }
-
-        int no = b["Aa"]->nrow();
-        int nv = b["Aa"]->ncol();
-        s["Aa"] = std::make_shared<Matrix>("SAa", no, nv);
-        if (alpha_A) {
-            int nso = Cvira_A_->nrow();
-            T = std::make_shared<Matrix>("T", no, nso);
-            double** Cop = Cocca_A_->pointer();
-            double** Cvp = Cvira_A_->pointer();
-            double** Jp = Jva->pointer();
-            double** Tp = T->pointer();
-            double** Sp = s["Aa"]->pointer();
-            C_DGEMM('T', 'N', no, nso, nso, 1.0, Cop[0], no, Jp[0], nso, 0.0, Tp[0], nso);
-            C_DGEMM('N', 'N', no, nv, nso, 1.0, Tp[0], nso, Cvp[0], nv, 0.0, Sp[0], nv);
-
-            double** bp = b["Aa"]->pointer();
-            double* op = eps_occa_A_->pointer();
-            double* vp = eps_vira_A_->pointer();
-            for (int i = 0; i < no; i++) {
-                for (int a = 0; a < nv; a++) {
-                    Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
-                }
-            }
-        }
-        // Reproduce the above for the beta part.
-
-        no = b["Ab"]->nrow();
-        nv = b["Ab"]->ncol();
-        s["Ab"] = std::make_shared<Matrix>("SAb", no, nv);
-        if (beta_A) {
-            int nso = Cvirb_A_->nrow();
-            T = std::make_shared<Matrix>("T", no, nso);
-            double** Cop = Coccb_A_->pointer();
-            double** Cvp = Cvirb_A_->pointer();
-            double** Jp = Jvb->pointer();
-            double** Tp = T->pointer();
-            double** Sp = s["Ab"]->pointer();
-            C_DGEMM('T', 'N', no, nso, nso, 1.0, Cop[0], no, Jp[0], nso, 0.0, Tp[0], nso);
-            C_DGEMM('N', 'N', no, nv, nso, 1.0, Tp[0], nso, Cvp[0], nv, 0.0, Sp[0], nv);
-
-            double** bp = b["Ab"]->pointer();
-            double* op = eps_occb_A_->pointer();
-            double* vp = eps_virb_A_->pointer();
-            for (int i = 0; i < no; i++) {
-                for (int a = 0; a < nv; a++) {
-                    Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
-                }
-            }
+    // Coulomb kernel 2 (J_alpha + J_beta) of each monomer, shared by both of its spin blocks
+    std::map<char, std::shared_ptr<Matrix> > Jtot;
+    for (size_t ind = 0; ind < active.size(); ind++) {
+        char monomer = active[ind][0];
+        if (!Jtot.count(monomer)) {
+            Jtot[monomer] = std::make_shared<Matrix>("Jtot", J[ind]->nrow(), J[ind]->ncol());
         }
+        Jtot[monomer]->axpy(2.0, J[ind]);
     }
 
-    if (do_B) {
-        std::shared_ptr<Matrix> Jva;
-        std::shared_ptr<Matrix> Kva;
-        std::shared_ptr<Matrix> Jvb;
-        std::shared_ptr<Matrix> Kvb;
-        std::shared_ptr<Matrix> T;
-        if (alpha_B) {
-            Jva = J[ind_jk];
-            Kva = K[ind_jk];
-            ind_jk++;
-            Jva->scale(2.0);
-            T = Jva->clone();
-        }
-        if (beta_B) {
-            Jvb = J[ind_jk];
-            Kvb = K[ind_jk];
-            Jvb->scale(2.0);
-            if (alpha_B) {
-                T->add(Jvb);
-            } else {
-                T = Jvb->clone();
-            }
-        }
-        if (alpha_B) {
-            Jva->copy(T);
-            Jva->subtract(Kva);
-            Jva->subtract(Kva->transpose());
-        }
-        if (beta_B) {
-            Jvb->copy(T);
-            Jvb->subtract(Kvb);
-            Jvb->subtract(Kvb->transpose());
-        }
+    for (const auto& key : keys) {
+        if (!b.count(key)) continue;
 
-        int no = b["Ba"]->nrow();
-        int nv = b["Ba"]->ncol();
-        s["Ba"] = std::make_shared<Matrix>("SBa", no, nv);
-        if (alpha_B) {
-            int nso = Cvira_B_->nrow();
-            T = std::make_shared<Matrix>("T", no, nso);
-            double** Cop = Cocca_B_->pointer();
-            double** Cvp = Cvira_B_->pointer();
-            double** Jp = Jva->pointer();
-            double** Tp = T->pointer();
-            double** Sp = s["Ba"]->pointer();
-            C_DGEMM('T', 'N', no, nso, nso, 1.0, Cop[0], no, Jp[0], nso, 0.0, Tp[0], nso);
-            C_DGEMM('N', 'N', no, nv, nso, 1.0, Tp[0], nso, Cvp[0], nv, 0.0, Sp[0], nv);
-
-            double** bp = b["Ba"]->pointer();
-            double* op = eps_occa_B_->pointer();
-            double* vp = eps_vira_B_->pointer();
-            for (int i = 0; i < no; i++) {
-                for (int a = 0; a < nv; a++) {
-                    Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
-                }
+        int no = b[key]->nrow();
+        int nv = b[key]->ncol();
+        s[key] = std::make_shared<Matrix>("S" + key, no, nv);
+
+        auto it = std::find(active.begin(), active.end(), key);
+        if (it == active.end()) continue;
+        size_t ind = it - active.begin();
+
+        // G = Jtot - K - K^T, formed in place of this block's (no longer needed) J
+        int nso = Cvir[key]->nrow();
+        double** Gp = J[ind]->pointer();
+        double** Jtp = Jtot[key[0]]->pointer();
+        double** Kp = K[ind]->pointer();
+#pragma omp parallel for
+        for (int m = 0; m < nso; m++) {
+            for (int n = 0; n < nso; n++) {
+                Gp[m][n] = Jtp[m][n] - Kp[m][n] - Kp[n][m];
             }
         }
 
-        // Reproduce the above for the beta part
-
-        no = b["Bb"]->nrow();
-        nv = b["Bb"]->ncol();
-        s["Bb"] = std::make_shared<Matrix>("SBb", no, nv);
-        if (beta_B) {
-            int nso = Cvirb_B_->nrow();
-            T = std::make_shared<Matrix>("T", no, nso);
-            double** Cop = Coccb_B_->pointer();
-            double** Cvp = Cvirb_B_->pointer();
-            double** Jp = Jvb->pointer();
-            double** Tp = T->pointer();
-            double** Sp = s["Bb"]->pointer();
-            C_DGEMM('T', 'N', no, nso, nso, 1.0, Cop[0], no, Jp[0], nso, 0.0, Tp[0], nso);
-            C_DGEMM('N', 'N', no, nv, nso, 1.0, Tp[0], nso, Cvp[0], nv, 0.0, Sp[0], nv);
-
-            double** bp = b["Bb"]->pointer();
-            double* op = eps_occb_B_->pointer();
-            double* vp = eps_virb_B_->pointer();
-            for (int i = 0; i < no; i++) {
-                for (int a = 0; a < nv; a++) {
-                    Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
-                }
+        auto T = std::make_shared<Matrix>("T", no, nso);
+        double** Cop = Cocc[key]->pointer();
+        double** Cvp = Cvir[key]->pointer();
+        double** Tp = T->pointer();
+        double** Sp = s[key]->pointer();
+        C_DGEMM('T', 'N', no, nso, nso, 1.0, Cop[0], no, Gp[0], nso, 0.0, Tp[0], nso);
+        C_DGEMM('N', 'N', no, nv, nso, 1.0, Tp[0], nso, Cvp[0], nv, 0.0, Sp[0], nv);
+
+        double** bp = b[key]->pointer();
+        double* op = eps_occ[key]->pointer();
+        double* vp = eps_vir[key]->pointer();
+        for (int i = 0; i < no; i++) {
+            for (int a = 0; a < nv; a++) {
+                Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
             }
         }
     }
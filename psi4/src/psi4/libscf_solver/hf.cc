@@ -30,6 +30,8 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <ctime>
+#include <exception>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -257,6 +259,8 @@ void HF::common_init() {
 
     MOM_performed_ = false;  // duplicated py-side (needed before iterate)
 
+    purify_ = false;
+
     if (print_) {
         print_header();
     }
@@ -287,6 +291,12 @@ void HF::common_init() {
     // CPHF info
     cphf_nfock_builds_ = 0;
     cphf_converged_ = false;
+
+    // Concurrent J/K and XC builds, thread split decided after the first one
+    jk_xc_overlap_ = options_.get_bool("SCF_JK_XC_OVERLAP");
+    nthread_xc_ = 0;
+    jk_cost_ = 0.0;
+    xc_cost_ = 0.0;
 }
 
 void HF::damping_update(double damping_percentage) {
@@ -318,10 +328,351 @@ std::vector<SharedMatrix> HF::cphf_solve(std::vector<SharedMatrix> x_vec, double
                                          int print_lvl) {
     throw PSIEXCEPTION("Sorry, the base HF wavefunction cannot solve CPHF equations.");
 }
+std::vector<SharedMatrix> HF::cphf_block_solve(std::vector<SharedMatrix> x_vec, double conv_tol, int max_iter,
+                                               int print_lvl) {
+    throw PSIEXCEPTION("Sorry, the base HF wavefunction cannot solve CPHF equations.");
+}
+
+namespace {
+
+// Number of elements of M, irrep blocks one after the other
+size_t packed_size(const SharedMatrix& M) {
+    size_t n = 0;
+    for (int h = 0; h < M->nirrep(); h++) n += (size_t)M->rowspi()[h] * M->colspi()[h ^ M->symmetry()];
+    return n;
+}
+
+void pack_matrix(const SharedMatrix& M, double* dst) {
+    for (int h = 0; h < M->nirrep(); h++) {
+        size_t n = (size_t)M->rowspi()[h] * M->colspi()[h ^ M->symmetry()];
+        if (n) std::copy_n(M->pointer(h)[0], n, dst);
+        dst += n;
+    }
+}
+
+void unpack_matrix(const double* src, const SharedMatrix& M) {
+    for (int h = 0; h < M->nirrep(); h++) {
+        size_t n = (size_t)M->rowspi()[h] * M->colspi()[h ^ M->symmetry()];
+        if (n) std::copy_n(src, n, M->pointer(h)[0]);
+        src += n;
+    }
+}
+
+}  // namespace
+
+/*
+ * Block CG over all equations at once (O'Leary, Lin. Alg. Appl. 29, 293 (1980)), with the
+ * directions orthonormalized every iteration so that the block can shrink instead of breaking
+ * down (breakdown-free block CG of Ji and Li, 2017). Each iteration is a single cphf_Hx call over the current
+ * directions, and every equation is minimized over all of them rather than over its own, so for
+ * the 3N nuclear perturbations of a Hessian far fewer iterations are needed than with one CG per
+ * equation. Converged equations leave the block; their residuals no longer generate directions.
+ *
+ * The equations are packed as the rows of dense blocks (X, R, P, A P), so that the updates are
+ * DGEMMs and only the small (directions x directions) matrices go through Matrix.
+ */
+std::vector<SharedMatrix> HF::cphf_block_cg(const std::vector<SharedMatrix>& x_vec,
+                                            const std::vector<SharedMatrix>& precon, double conv_tol, int max_iter,
+                                            int print_lvl) {
+    std::time_t start, stop;
+    start = std::time(nullptr);
+    cphf_converged_ = false;
+    cphf_nfock_builds_ = 0;
+
+    // => Packed layout, one row of n elements per equation <= //
+    size_t nspin = precon.size();
+    size_t neq = x_vec.size() / nspin;
+    if (neq * nspin != x_vec.size()) {
+        throw PSIEXCEPTION("HF::cphf_block_cg: number of matrices is not a multiple of the number of spins.");
+    }
+    std::vector<size_t> offset(nspin + 1, 0);
+    for (size_t s = 0; s < nspin; s++) offset[s + 1] = offset[s] + packed_size(precon[s]);
+    size_t n = offset[nspin];
+    for (size_t k = 0; k < neq; k++) {
+        for (size_t s = 0; s < nspin; s++) {
+            if (packed_size(x_vec[k * nspin + s]) != offset[s + 1] - offset[s]) {
+                throw PSIEXCEPTION("HF::cphf_block_cg: equations do not match the preconditioner.");
+            }
+        }
+    }
+
+    std::vector<double> denom(n);
+    for (size_t s = 0; s < nspin; s++) pack_matrix(precon[s], denom.data() + offset[s]);
+
+    // Hessian-vector products of the first nv rows of V
+    auto hessian_product = [&](const std::vector<double>& V, size_t nv, std::vector<double>& AV) {
+        std::vector<SharedMatrix> vecs;
+        for (size_t k = 0; k < nv; k++) {
+            for (size_t s = 0; s < nspin; s++) {
+                auto M = x_vec[s]->clone();
+                unpack_matrix(V.data() + k * n + offset[s], M);
+                vecs.push_back(M);
+            }
+        }
+        auto Avecs = cphf_Hx(vecs);
+        vecs.clear();
+        AV.resize(nv * n);
+        for (size_t k = 0; k < nv; k++) {
+            for (size_t s = 0; s < nspin; s++) pack_matrix(Avecs[k * nspin + s], AV.data() + k * n + offset[s]);
+        }
+        cphf_nfock_builds_ += nv;
+    };
+
+    auto apply_denominator = [&](double* V, size_t nv) {
+#pragma omp parallel for schedule(static)
+        for (size_t k = 0; k < nv; k++) {
+            double* Vk = V + k * n;
+            for (size_t p = 0; p < n; p++) Vk[p] /= denom[p];
+        }
+    };
+
+    // => Header <= //
+    if (print_lvl) {
+        outfile->Printf("\n");
+        outfile->Printf("   ==> Coupled-Perturbed %s Block Solver <==\n\n", options_.get_str("REFERENCE").c_str());
+        outfile->Printf("    Maxiter             = %11d\n", max_iter);
+        outfile->Printf("    Convergence         = %11.3E\n", conv_tol);
+        outfile->Printf("    Number of equations = %11zu\n", neq);
+        outfile->Printf("   -------------------------------------------------------------\n");
+        outfile->Printf("     %4s %14s %12s  %6s  %6s  %6s\n", "Iter", "Residual RMS", "Max RMS", "Remain", "Space",
+                        "Time [s]");
+        outfile->Printf("   -------------------------------------------------------------\n");
+    }
+
+    // => Initial guess and residual <= //
+    // Rows of X and R are kept with the unconverged equations first
+    std::vector<double> X(neq * n), R(neq * n), Z, P, Q;
+    std::vector<double> bnorm(neq), rms(neq, 0.0);
+    std::vector<size_t> eq_of_row(neq);
+    for (size_t k = 0; k < neq; k++) {
+        for (size_t s = 0; s < nspin; s++) pack_matrix(x_vec[k * nspin + s], R.data() + k * n + offset[s]);
+        // Prevent rel denom from being too small
+        bnorm[k] = std::max(C_DDOT(n, R.data() + k * n, 1, R.data() + k * n, 1), 1.e-14);
+        eq_of_row[k] = k;
+    }
+    X = R;
+    apply_denominator(X.data(), neq);
+    hessian_product(X, neq, Q);
+    C_DAXPY(neq * n, -1.0, Q.data(), 1, R.data(), 1);
+
+    size_t nactive = neq;
+    double mean_rms, max_rms;
+    // Residual norms; converged equations are moved behind the active ones
+    auto check_residuals = [&]() {
+        for (size_t r = 0; r < nactive;) {
+            double* Rr = R.data() + r * n;
+            double rr = std::sqrt(C_DDOT(n, Rr, 1, Rr, 1) / bnorm[r]);
+            rms[eq_of_row[r]] = rr;
+            if (rr < conv_tol) {
+                nactive--;
+                if (r != nactive) {
+                    std::swap_ranges(X.begin() + r * n, X.begin() + (r + 1) * n, X.begin() + nactive * n);
+                    std::swap_ranges(R.begin() + r * n, R.begin() + (r + 1) * n, R.begin() + nactive * n);
+                    std::swap(bnorm[r], bnorm[nactive]);
+                    std::swap(eq_of_row[r], eq_of_row[nactive]);
+                }
+            } else {
+                r++;
+            }
+        }
+        mean_rms = 0.0;
+        max_rms = 0.0;
+        for (size_t k = 0; k < neq; k++) {
+            mean_rms += rms[k];
+            max_rms = std::max(max_rms, rms[k]);
+        }
+        mean_rms /= (neq ? neq : 1);
+    };
+
+    // New directions: the preconditioned active residuals, A-conjugate to the last directions P
+    // (Q = A P, PQinv = (P^T A P)^-1), orthonormalized; linearly dependent ones are dropped
+    size_t ndir = 0;
+    SharedMatrix PQinv;
+    auto update_directions = [&]() {
+        Z.assign(R.begin(), R.begin() + nactive * n);
+        apply_denominator(Z.data(), nactive);
+        if (ndir) {
+            auto QZ = std::make_shared<Matrix>("QZ", ndir, nactive);
+            C_DGEMM('N', 'T', ndir, nactive, n, 1.0, Q.data(), n, Z.data(), n, 0.0, QZ->pointer()[0], nactive);
+            auto beta = linalg::doublet(PQinv, QZ);
+            C_DGEMM('T', 'N', nactive, n, ndir, -1.0, beta->pointer()[0], nactive, P.data(), n, 1.0, Z.data(), n);
+        }
+        for (size_t r = 0; r < nactive; r++) {
+            double norm = std::sqrt(C_DDOT(n, Z.data() + r * n, 1, Z.data() + r * n, 1));
+            if (norm > 0.0) C_DSCAL(n, 1.0 / norm, Z.data() + r * n, 1);
+        }
+
+        auto G = std::make_shared<Matrix>("Z Z^T", nactive, nactive);
+        C_DGEMM('N', 'T', nactive, nactive, n, 1.0, Z.data(), n, Z.data(), n, 0.0, G->pointer()[0], nactive);
+        auto V = std::make_shared<Matrix>("V", nactive, nactive);
+        auto lambda = std::make_shared<Vector>("lambda", nactive);
+        G->diagonalize(V, lambda, descending);
+        ndir = 0;
+        while (ndir < nactive && lambda->get(ndir) > 1.0e-10) ndir++;
+
+        // P = T^T Z, T = V lambda^-1/2 over the kept eigenvectors
+        std::vector<double> T(nactive * ndir);
+        for (size_t i = 0; i < nactive; i++) {
+            for (size_t j = 0; j < ndir; j++) T[i * ndir + j] = V->get(i, j) / std::sqrt(lambda->get(j));
+        }
+        P.resize(ndir * n);
+        if (ndir) C_DGEMM('T', 'N', ndir, n, nactive, 1.0, T.data(), ndir, Z.data(), n, 0.0, P.data(), n);
+    };
+
+    check_residuals();
+    if (nactive) update_directions();
+
+    stop = std::time(nullptr);
+    if (print_lvl > 1) {
+        outfile->Printf("    %5s %14.3e %12.3e %7zu %7zu %9ld\n", "Guess", mean_rms, max_rms, nactive, ndir,
+                        stop - start);
+    }
+
+    // => Block CG iterations <= //
+    for (int cg_iter = 1; cg_iter < max_iter && nactive && ndir; cg_iter++) {
+        hessian_product(P, ndir, Q);
+
+        auto PQ = std::make_shared<Matrix>("P^T A P", ndir, ndir);
+        C_DGEMM('N', 'T', ndir, ndir, n, 1.0, P.data(), n, Q.data(), n, 0.0, PQ->pointer()[0], ndir);
+        PQ->hermitivitize();
+        if (!std::isfinite(PQ->trace())) {
+            outfile->Printf("HF::CPHF Warning block CG subspace is not finite. Stopping.\n");
+            break;
+        }
+        PQinv = PQ->clone();
+        PQinv->power(-1.0, 1.e-14);
+
+        // X += P alpha, R -= A P alpha, alpha = (P^T A P)^-1 P^T R
+        auto PR = std::make_shared<Matrix>("P^T R", ndir, nactive);
+        C_DGEMM('N', 'T', ndir, nactive, n, 1.0, P.data(), n, R.data(), n, 0.0, PR->pointer()[0], nactive);
+        auto alpha = linalg::doublet(PQinv, PR);
+        C_DGEMM('T', 'N', nactive, n, ndir, 1.0, alpha->pointer()[0], nactive, P.data(), n, 1.0, X.data(), n);
+        C_DGEMM('T', 'N', nactive, n, ndir, -1.0, alpha->pointer()[0], nactive, Q.data(), n, 1.0, R.data(), n);
+
+        size_t nspace = ndir;
+        check_residuals();
+        if (nactive) update_directions();
+
+        stop = std::time(nullptr);
+        if (print_lvl) {
+            outfile->Printf("    %5d %14.3e %12.3e %7zu %7zu %9ld\n", cg_iter, mean_rms, max_rms, nactive, nspace,
+                            stop - start);
+        }
+    }
+
+    // Convergence
+    if (!nactive) {
+        cphf_converged_ = true;
+    }
+
+    // Print out tail
+    if (print_lvl > 1) {
+        outfile->Printf("   -------------------------------------------------------------\n");
+        outfile->Printf("\n");
+        if (nactive) {
+            outfile->Printf("    Warning! %zu equations did not converge!\n\n", nactive);
+        } else {
+            outfile->Printf("    Solver has converged.\n\n");
+        }
+    }
+
+    std::vector<SharedMatrix> ret_vec(x_vec.size());
+    for (size_t r = 0; r < neq; r++) {
+        size_t k = eq_of_row[r];
+        for (size_t s = 0; s < nspin; s++) {
+            ret_vec[k * nspin + s] = x_vec[k * nspin + s]->clone();
+            unpack_matrix(X.data() + r * n + offset[s], ret_vec[k * nspin + s]);
+        }
+    }
+    return ret_vec;
+}
 void HF::save_density_and_energy() {
     throw PSIEXCEPTION("Sorry, the base HF wavefunction does not understand a density equation.");
 }
 void HF::form_G() { throw PSIEXCEPTION("Sorry, the base HF wavefunction does not understand."); }
+void HF::form_JK_and_V() {
+    bool needs_xc = functional_->needs_xc();
+    int nthread = Process::environment.get_n_threads();
+
+    bool overlap = jk_xc_overlap_ && needs_xc && nthread > 1;
+#ifndef _OPENMP
+    overlap = false;
+#endif
+    if (!overlap) {
+        if (needs_xc) form_V();
+        jk_->compute();
+        return;
+    }
+
+#ifdef _OPENMP
+
+    // Give each build a share of the threads proportional to its thread-seconds in the last
+    // overlapped build, so that both finish at about the same time; split evenly the first time
+    if (jk_cost_ > 0.0 && xc_cost_ > 0.0) {
+        nthread_xc_ = (int)std::lround(nthread * xc_cost_ / (jk_cost_ + xc_cost_));
+    } else {
+        nthread_xc_ = nthread / 2;
+    }
+    nthread_xc_ = std::max(1, std::min(nthread - 1, nthread_xc_));
+    int nthread_jk = nthread - nthread_xc_;
+
+    int jk_omp_nthread = jk_->get_omp_nthread();
+    int max_levels = omp_get_max_active_levels();
+    jk_->set_omp_nthread(nthread_jk);
+    potential_->set_compute_threads(nthread_xc_);
+    omp_set_max_active_levels(std::max(2, max_levels));
+
+    // The serial timers are a single stack and cannot be driven from two threads at once.
+    // An exception may not leave a section, so each is caught there and rethrown once the
+    // threads and timers are back as they were.
+    double jk_time = 0.0, xc_time = 0.0;
+    std::exception_ptr jk_error, xc_error;
+    timer_on("HF: Overlapped JK/V");
+    start_skip_timers();
+#pragma omp parallel sections num_threads(2)
+    {
+#pragma omp section
+        {
+            try {
+                omp_set_num_threads(nthread_jk);
+                BlasThreads blas_threads(BlasThreads::Inner, nthread_jk, "HF: Overlapped JK");
+                double start = omp_get_wtime();
+                jk_->compute();
+                jk_time = omp_get_wtime() - start;
+            } catch (...) {
+                jk_error = std::current_exception();
+            }
+        }
+#pragma omp section
+        {
+            try {
+                omp_set_num_threads(nthread_xc_);
+                BlasThreads blas_threads(BlasThreads::Inner, nthread_xc_, "HF: Overlapped V");
+                double start = omp_get_wtime();
+                form_V();
+                xc_time = omp_get_wtime() - start;
+            } catch (...) {
+                xc_error = std::current_exception();
+            }
+        }
+    }
+    stop_skip_timers();
+    timer_off("HF: Overlapped JK/V");
+
+    omp_set_max_active_levels(max_levels);
+    potential_->set_compute_threads(nthread);
+    jk_->set_omp_nthread(jk_omp_nthread);
+    if (jk_error) std::rethrow_exception(jk_error);
+    if (xc_error) std::rethrow_exception(xc_error);
+
+    jk_cost_ = jk_time * nthread_jk;
+    xc_cost_ = xc_time * nthread_xc_;
+    if (print_ > 2) {
+        outfile->Printf("    J/K build %8.3f s on %d threads, XC build %8.3f s on %d threads\n", jk_time, nthread_jk,
+                        xc_time, nthread_xc_);
+    }
+#endif
+}
 void HF::form_F() { throw PSIEXCEPTION("Sorry, the base HF wavefunction does not understand Roothan."); }
 double HF::compute_E() { throw PSIEXCEPTION("Sorry, the base HF wavefunction does not understand Hall."); }
 void HF::rotate_orbitals(SharedMatrix C, const SharedMatrix x) {
@@ -398,6 +749,9 @@ void HF::finalize() {
 
     // Sphalf_.reset();
     X_.reset();
+    FDSmSDF_temp1_.reset();
+    FDSmSDF_temp2_.reset();
+    FDSmSDF_temp3_.reset();
     T_.reset();
 }
 
@@ -657,6 +1011,9 @@ void HF::form_H() {
         if (options_.get_bool("EXTERNAL_POTENTIAL_SYMMETRY") == false && H_->nirrep() != 1)
             throw PSIEXCEPTION("SCF: External Fields are not consistent with symmetry. Set symmetry c1.");
 
+        external_pot_->set_fmm(options_.get_bool("EXTERNAL_POTENTIAL_FMM"), options_.get_int("EXTERNAL_POTENTIAL_FMM_ORDER"),
+                               options_.get_double("EXTERNAL_POTENTIAL_FMM_WS"),
+                               options_.get_double("EXTERNAL_POTENTIAL_FMM_BOX"));
         auto Vprime = external_pot_->computePotentialMatrix(basisset_);
 
         if (options_.get_bool("EXTERNAL_POTENTIAL_SYMMETRY")) {
@@ -1330,15 +1687,41 @@ SharedMatrix HF::form_Fia(SharedMatrix Fso, SharedMatrix Cso, int* noccpi) {
     return Fia;
 }
 SharedMatrix HF::form_FDSmSDF(SharedMatrix Fso, SharedMatrix Dso) {
-    auto FDSmSDF = linalg::triplet(Fso, Dso, S_, false, false, false);
-    auto SDF = FDSmSDF->transpose();
-    FDSmSDF->subtract(SDF);
+    auto FDSmSDF = std::make_shared<Matrix>("FDS-SDF", X_->colspi(), X_->colspi());
+    form_FDSmSDF(Fso, Dso, FDSmSDF);
+    return FDSmSDF;
+}
+void HF::form_FDSmSDF(SharedMatrix Fso, SharedMatrix Dso, SharedMatrix FDSmSDF) {
+    if (FDSmSDF->rowspi() != X_->colspi() || FDSmSDF->colspi() != X_->colspi()) {
+        throw PSIEXCEPTION("HF::form_FDSmSDF: the output matrix must be nmo x nmo.");
+    }
 
-    SDF.reset();
+    if (!FDSmSDF_temp1_ || FDSmSDF_temp1_->rowspi() != X_->rowspi() ||
+        FDSmSDF_temp3_->rowspi() != X_->colspi()) {
+        FDSmSDF_temp1_ = std::make_shared<Matrix>("FD", X_->rowspi(), X_->rowspi());
+        FDSmSDF_temp2_ = std::make_shared<Matrix>("FDS", X_->rowspi(), X_->rowspi());
+        FDSmSDF_temp3_ = std::make_shared<Matrix>("X'(FDS - SDF)", X_->colspi(), X_->rowspi());
+    }
 
-    FDSmSDF->transform(X_);
+    FDSmSDF_temp1_->gemm(false, false, 1.0, Fso, Dso, 0.0);
+    FDSmSDF_temp2_->gemm(false, false, 1.0, FDSmSDF_temp1_, S_, 0.0);
 
-    return FDSmSDF;
+    // F, D and S are symmetric, so SDF = (FDS)'
+    for (int h = 0; h < nirrep_; h++) {
+        int n = FDSmSDF_temp2_->rowspi()[h];
+        double** Wp = FDSmSDF_temp2_->pointer(h);
+        for (int i = 0; i < n; i++) {
+            Wp[i][i] = 0.0;
+            for (int j = 0; j < i; j++) {
+                double val = Wp[i][j] - Wp[j][i];
+                Wp[i][j] = val;
+                Wp[j][i] = -val;
+            }
+        }
+    }
+
+    FDSmSDF_temp3_->gemm(true, false, 1.0, X_, FDSmSDF_temp2_, 0.0);
+    FDSmSDF->gemm(false, false, 1.0, FDSmSDF_temp3_, X_, 0.0);
 }
 
 void HF::print_stability_analysis(std::vector<std::pair<double, int> >& vec) const {
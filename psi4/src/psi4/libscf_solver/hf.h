@@ -63,6 +63,10 @@ class HF : public Wavefunction {
     SharedMatrix Vb_;
     /// The orthogonalization matrix (symmetric or canonical)
     SharedMatrix X_;
+    /// Workspace of form_FDSmSDF (FD and FDS, then X'(FDS - SDF)), kept between iterations
+    SharedMatrix FDSmSDF_temp1_;
+    SharedMatrix FDSmSDF_temp2_;
+    SharedMatrix FDSmSDF_temp3_;
     /// List of external potentials to add to Fock matrix and updated at every iteration
     /// e.g. PCM potential
     std::vector<SharedMatrix> external_potentials_;
@@ -140,6 +144,9 @@ class HF : public Wavefunction {
 
     /// Frac started? (Same thing as frac_performed_)
     bool frac_performed_;
+
+    /// Form the density by purification instead of diagonalizing F?
+    bool purify_;
     /// The orbitals _before_ scaling needed for Frac
     SharedMatrix unscaled_Ca_;
     SharedMatrix unscaled_Cb_;
@@ -169,6 +176,12 @@ class HF : public Wavefunction {
     int cphf_nfock_builds_;
     bool cphf_converged_;
 
+    /// Preconditioned block CG on the CPHF equations. Each equation is precon.size() consecutive
+    /// matrices of x_vec (alpha, beta for UHF) shaped like precon; all equations share one search space.
+    std::vector<SharedMatrix> cphf_block_cg(const std::vector<SharedMatrix>& x_vec,
+                                            const std::vector<SharedMatrix>& precon, double conv_tol, int max_iter,
+                                            int print_lvl);
+
     /// Edit matrices if we are doing canonical orthogonalization
     virtual void prepare_canonical_orthogonalization() { return; }
 
@@ -198,6 +211,14 @@ class HF : public Wavefunction {
     /// analysis, where we want to retry SCF without going through all of the setup
     int attempt_number_;
 
+    /// Build J/K and the XC potential concurrently, on two parts of the thread pool?
+    bool jk_xc_overlap_;
+    /// Threads given to the XC build in the last overlapped build
+    int nthread_xc_;
+    /// Thread-seconds spent in the last overlapped J/K and XC builds, used to split the threads
+    double jk_cost_;
+    double xc_cost_;
+
     /// The number of electrons
     int nelectron_;
 
@@ -251,6 +272,10 @@ class HF : public Wavefunction {
     bool MOM_performed() const { return MOM_performed_; }
     void set_MOM_performed(bool tf) { MOM_performed_ = tf; }
 
+    /// Density purification in place of diagonalization?
+    bool purify() const { return purify_; }
+    void set_purify(bool tf) { purify_ = tf; }
+
     // Q: MOM_started_ was ditched b/c same info as MOM_performed_
 
     /// Which set of iterations we're on in this computation, e.g., for stability
@@ -377,9 +402,13 @@ class HF : public Wavefunction {
 
     /** Forms the G matrix */
     virtual void form_G();
+    /** Runs jk_->compute() and, if the functional needs it, form_V(); concurrently if SCF_JK_XC_OVERLAP */
+    void form_JK_and_V();
 
     /** Form X'(FDS - SDF)X (for DIIS) **/
     virtual SharedMatrix form_FDSmSDF(SharedMatrix Fso, SharedMatrix Dso);
+    /** Form X'(FDS - SDF)X into FDSmSDF (nmo x nmo), reusing the workspace of previous calls **/
+    void form_FDSmSDF(SharedMatrix Fso, SharedMatrix Dso, SharedMatrix FDSmSDF);
 
     /** Rotates orbitals inplace C' = C exp(U), U = antisymmetric matrix from x */
     void rotate_orbitals(SharedMatrix C, const SharedMatrix x);
@@ -391,6 +420,10 @@ class HF : public Wavefunction {
     virtual std::vector<SharedMatrix> cphf_Hx(std::vector<SharedMatrix> x);
     virtual std::vector<SharedMatrix> cphf_solve(std::vector<SharedMatrix> x_vec, double conv_tol = 1.e-4,
                                                  int max_iter = 10, int print_lvl = 1);
+    /// As cphf_solve, but with block CG: fewer iterations when there are many equations (e.g. 3N nuclear
+    /// perturbations), each iteration being one batched Hx over the whole search space
+    virtual std::vector<SharedMatrix> cphf_block_solve(std::vector<SharedMatrix> x_vec, double conv_tol = 1.e-4,
+                                                       int max_iter = 10, int print_lvl = 1);
 
     // CPHF data
     bool cphf_converged() { return cphf_converged_; }
@@ -30,6 +30,7 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <vector>
 #include <utility>
@@ -112,6 +113,10 @@ void RHF::common_init() {
 
     same_a_b_dens_ = true;
     same_a_b_orbs_ = true;
+
+    // Purification keeps the occupations of the previous diagonalization, which MOM and Frac change
+    purify_ = (options_.get_str("DENSITY_PURIFICATION") == "TC2") && (options_.get_int("MOM_START") == 0) &&
+              (options_.get_int("FRAC_START") == 0);
 }
 
 void RHF::finalize() {
@@ -176,20 +181,19 @@ void RHF::form_V() {
     Vb_ = Va_;
 }
 void RHF::form_G() {
-    if (functional_->needs_xc()) {
-        form_V();
-        G_->copy(Va_);
-    } else {
-        G_->zero();
-    }
-
     /// Push the C matrix on
     std::vector<SharedMatrix>& C = jk_->C_left();
     C.clear();
     C.push_back(Ca_subset("SO", "OCC"));
 
-    // Run the JK object
-    jk_->compute();
+    // Run the JK object and the XC potential
+    form_JK_and_V();
+
+    if (functional_->needs_xc()) {
+        G_->copy(Va_);
+    } else {
+        G_->zero();
+    }
 
     // Pull the J and K matrices off
     const std::vector<SharedMatrix>& J = jk_->J();
@@ -252,6 +256,9 @@ void RHF::form_F() {
 }
 
 void RHF::form_C(double shift) {
+    // The occupations per irrep come from the last diagonalization, so the first one is always done
+    if (shift == 0.0 && purify_ && iteration_ > 0 && form_C_purified()) return;
+
     if (shift == 0.0) {
         diagonalize_F(Fa_, Ca_, epsilon_a_);
     } else {
@@ -267,6 +274,91 @@ void RHF::form_C(double shift) {
     find_occupation();
 }
 
+bool RHF::form_C_purified() {
+    const int maxiter = 100;
+    const double idempotency_tolerance = 1.0E-11;
+
+    // F' = X'FX, as in diagonalize_F
+    auto Fp = linalg::triplet(X_, Fa_, X_, true, false, false);
+
+    std::vector<SharedMatrix> Cocc(nirrep_);
+    for (int h = 0; h < nirrep_; ++h) {
+        int nmo = nmopi_[h];
+        int na = nalphapi_[h];
+        if (nmo == 0 || na == 0) continue;
+
+        auto P = std::make_shared<Matrix>("P", nmo, nmo);
+        auto P2 = std::make_shared<Matrix>("P^2", nmo, nmo);
+        double** Fhp = Fp->pointer(h);
+        double** Pp = P->pointer();
+        double** P2p = P2->pointer();
+
+        // Gershgorin bounds on the spectrum of F'
+        double emin = Fhp[0][0], emax = Fhp[0][0];
+        for (int i = 0; i < nmo; i++) {
+            double radius = 0.0;
+            for (int j = 0; j < nmo; j++) {
+                if (j != i) radius += std::fabs(Fhp[i][j]);
+            }
+            emin = std::min(emin, Fhp[i][i] - radius);
+            emax = std::max(emax, Fhp[i][i] + radius);
+        }
+
+        // P0 = (emax - F') / (emax - emin) has its spectrum in [0, 1], ordered like that of -F'
+        for (int i = 0; i < nmo; i++) {
+            for (int j = 0; j < nmo; j++) Pp[i][j] = -Fhp[i][j] / (emax - emin);
+            Pp[i][i] += emax / (emax - emin);
+        }
+
+        // TC2 (Niklasson, PRB 66, 155115, 2002): P <- P^2 pulls eigenvalues down, P <- 2P - P^2 pushes
+        // them up; take whichever step brings the trace closer to the number of occupied orbitals
+        bool converged = false;
+        for (int iter = 0; iter < maxiter; iter++) {
+            C_DGEMM('N', 'N', nmo, nmo, nmo, 1.0, Pp[0], nmo, Pp[0], nmo, 0.0, P2p[0], nmo);
+            double trP = P->trace();
+            double trP2 = P2->trace();
+            if (std::fabs(trP - trP2) < idempotency_tolerance * nmo) {
+                converged = true;
+                break;
+            }
+            if (std::fabs(trP2 - na) < std::fabs(2.0 * trP - trP2 - na)) {
+                P->copy(P2);
+            } else {
+                P->scale(2.0);
+                P->subtract(P2);
+            }
+        }
+        if (!converged) {
+            outfile->Printf("  Density purification did not converge in irrep %d, diagonalizing F instead.\n", h);
+            return false;
+        }
+
+        // P is idempotent with rank na, so its pivoted Cholesky factor has na columns
+        auto U = P->partial_cholesky_factorize(1.0E-8);
+        if (U->colspi(0) != na) {
+            outfile->Printf("  Purified density of irrep %d has rank %d instead of %d, diagonalizing F instead.\n", h,
+                            U->colspi(0), na);
+            return false;
+        }
+
+        Cocc[h] = std::make_shared<Matrix>("Cocc", nsopi_[h], na);
+        C_DGEMM('N', 'N', nsopi_[h], na, nmo, 1.0, X_->pointer(h)[0], nmo, U->pointer()[0], na, 0.0,
+                Cocc[h]->pointer()[0], na);
+    }
+
+    // Only the occupied columns are replaced: the virtual orbitals and orbital energies are those of the last
+    // diagonalization until the final one after convergence
+    for (int h = 0; h < nirrep_; ++h) {
+        if (!Cocc[h]) continue;
+        int na = nalphapi_[h];
+        double** Cp = Ca_->pointer(h);
+        double** Coccp = Cocc[h]->pointer();
+        for (int mu = 0; mu < nsopi_[h]; mu++) ::memcpy(Cp[mu], Coccp[mu], sizeof(double) * na);
+    }
+
+    return true;
+}
+
 void RHF::form_D() {
     Da_->zero();
 
@@ -375,27 +467,30 @@ std::vector<SharedMatrix> RHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
         }
     }
 
-    SharedMatrix Cocc_ao, Cvir_ao, F_ao, Cocc_so, Cvir_so;
+    // Fij is the same for every vector, so it is formed once per basis
+    SharedMatrix Cocc_ao, Cvir_ao, F_ao, Foo_ao, Cocc_so, Cvir_so, Foo_so;
     if (needs_ao) {
         Cocc_ao = Ca_subset("AO", "OCC");
         Cvir_ao = Ca_subset("AO", "VIR");
         F_ao = matrix_subset_helper(Fa_, Ca_, "AO", "Fock");
+        Foo_ao = linalg::triplet(Cocc_ao, F_ao, Cocc_ao, true, false, false);
     }
     if (needs_so) {
         Cocc_so = Ca_subset("SO", "OCC");
         Cvir_so = Ca_subset("SO", "VIR");
+        Foo_so = linalg::triplet(Cocc_so, Fa_, Cocc_so, true, false, false);
     }
 
     // Compute Fij x_ia - Fab x_ia
     std::vector<SharedMatrix> ret;
-    SharedMatrix F, Co, Cv;
+    SharedMatrix F, Foo, Cv;
     for (size_t i = 0; i < x_vec.size(); i++) {
         if (c1_input_[i]) {
             if ((x_vec[i]->rowspi()[0] != nalpha_) || (x_vec[i]->colspi()[0] != (nmo_ - nalpha_))) {
                 throw PSIEXCEPTION("SCF::onel_Hx incoming rotation matrices must have shape (occ x vir).");
             }
             F = F_ao;
-            Co = Cocc_ao;
+            Foo = Foo_ao;
             Cv = Cvir_ao;
 
         } else {
@@ -403,12 +498,11 @@ std::vector<SharedMatrix> RHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
                 throw PSIEXCEPTION("SCF::onel_Hx incoming rotation matrices must have shape (occ x vir).");
             }
             F = Fa_;
-            Co = Cocc_so;
+            Foo = Foo_so;
             Cv = Cvir_so;
         }
 
-        auto tmp1 = linalg::triplet(Co, F, Co, true, false, false);
-        auto result = linalg::doublet(tmp1, x_vec[i], false, false);
+        auto result = linalg::doublet(Foo, x_vec[i], false, false);
 
         auto tmp2 = linalg::triplet(x_vec[i], Cv, F, false, true, false);
         result->gemm(false, false, -1.0, tmp2, Cv, 1.0);
@@ -599,6 +693,55 @@ std::vector<SharedMatrix> RHF::cphf_Hx(std::vector<SharedMatrix> x_vec) {
 
     return onel;
 }
+std::vector<SharedMatrix> RHF::cphf_preconditioner(bool c1) {
+    if (c1) {
+        // MO (C1) Fock Matrix (Inactive Fock in Helgaker's language)
+        auto Cocc_ao = Ca_subset("AO", "ALL");
+        auto F_ao = matrix_subset_helper(Fa_, Ca_, "AO", "Fock");
+        auto IFock_ao = linalg::triplet(Cocc_ao, F_ao, Cocc_ao, true, false, false);
+        auto Precon_ao = std::make_shared<Matrix>("Precon", nalpha_, nmo_ - nalpha_);
+
+        auto denomp = Precon_ao->pointer()[0];
+        auto fp = IFock_ao->pointer();
+
+        for (size_t i = 0, target = 0; i < nalpha_; i++) {
+            for (size_t a = nalpha_; a < nmo_; a++) {
+                denomp[target++] = -fp[i][i] + fp[a][a];
+            }
+        }
+        return {Precon_ao};
+    }
+
+    // MO Fock Matrix (Inactive Fock in Helgaker's language)
+    auto virpi = nmopi_ - nalphapi_;
+    auto IFock_so = linalg::triplet(Ca_, Fa_, Ca_, true, false, false);
+    auto Precon_so = std::make_shared<Matrix>("Precon", nirrep_, nalphapi_, virpi);
+
+    for (size_t h = 0; h < nirrep_; h++) {
+        if (!nalphapi_[h] || !virpi[h]) continue;
+        auto denomp = Precon_so->pointer(h)[0];
+        auto fp = IFock_so->pointer(h);
+
+        for (size_t i = 0, target = 0; i < nalphapi_[h]; i++) {
+            for (size_t a = nalphapi_[h]; a < nmopi_[h]; a++) {
+                denomp[target++] = -fp[i][i] + fp[a][a];
+            }
+        }
+    }
+    return {Precon_so};
+}
+std::vector<SharedMatrix> RHF::cphf_block_solve(std::vector<SharedMatrix> x_vec, double conv_tol, int max_iter,
+                                                int print_lvl) {
+    if (x_vec.empty()) return {};
+
+    // The block solver needs every equation in the same basis
+    bool c1 = (x_vec[0]->nirrep() == 1) && (nirrep_ != 1);
+    for (const auto& x : x_vec) {
+        if (((x->nirrep() == 1) && (nirrep_ != 1)) != c1) return cphf_solve(x_vec, conv_tol, max_iter, print_lvl);
+    }
+
+    return cphf_block_cg(x_vec, cphf_preconditioner(c1), conv_tol, max_iter, print_lvl);
+}
 std::vector<SharedMatrix> RHF::cphf_solve(std::vector<SharedMatrix> x_vec, double conv_tol, int max_iter,
                                           int print_lvl) {
     std::time_t start, stop;
@@ -624,42 +767,8 @@ std::vector<SharedMatrix> RHF::cphf_solve(std::vector<SharedMatrix> x_vec, doubl
 
     // => Build preconditioner <= //
     SharedMatrix Precon_ao, Precon_so;
-
-    if (needs_ao) {
-        // MO (C1) Fock Matrix (Inactive Fock in Helgaker's language)
-        auto Cocc_ao = Ca_subset("AO", "ALL");
-        auto F_ao = matrix_subset_helper(Fa_, Ca_, "AO", "Fock");
-        auto IFock_ao = linalg::triplet(Cocc_ao, F_ao, Cocc_ao, true, false, false);
-        Precon_ao = std::make_shared<Matrix>("Precon", nalpha_, nmo_ - nalpha_);
-
-        auto denomp = Precon_ao->pointer()[0];
-        auto fp = IFock_ao->pointer();
-
-        for (size_t i = 0, target = 0; i < nalpha_; i++) {
-            for (size_t a = nalpha_; a < nmo_; a++) {
-                denomp[target++] = -fp[i][i] + fp[a][a];
-            }
-        }
-    }
-
-    if (needs_so) {
-        // MO Fock Matrix (Inactive Fock in Helgaker's language)
-        auto virpi = nmopi_ - nalphapi_;
-        auto IFock_so = linalg::triplet(Ca_, Fa_, Ca_, true, false, false);
-        Precon_so = std::make_shared<Matrix>("Precon", nirrep_, nalphapi_, virpi);
-
-        for (size_t h = 0; h < nirrep_; h++) {
-            if (!nalphapi_[h] || !virpi[h]) continue;
-            auto denomp = Precon_so->pointer(h)[0];
-            auto fp = IFock_so->pointer(h);
-
-            for (size_t i = 0, target = 0; i < nalphapi_[h]; i++) {
-                for (size_t a = nalphapi_[h]; a < nmopi_[h]; a++) {
-                    denomp[target++] = -fp[i][i] + fp[a][a];
-                }
-            }
-        }
-    }
+    if (needs_ao) Precon_ao = cphf_preconditioner(true)[0];
+    if (needs_so) Precon_so = cphf_preconditioner(false)[0];
 
     // => Header <= //
     if (print_lvl) {
@@ -815,8 +924,7 @@ std::vector<SharedMatrix> RHF::cphf_solve(std::vector<SharedMatrix> x_vec, doubl
 
             double beta = r_vec[i]->vector_dot(z_vec[i]) / rzpre[i];
 
-            p_vec[i]->scale(beta);
-            p_vec[i]->add(z_vec[i]);
+            p_vec[i]->axpby(1.0, z_vec[i], beta);
         }
     }
 
@@ -49,8 +49,15 @@ class RHF : public HF {
 
     double compute_initial_E() override;
 
+    /// Occupied orbitals of the TC2-purified density of Fa_, without diagonalizing it;
+    /// false (and nothing changed) if the purification did not converge
+    bool form_C_purified();
+
     void common_init();
 
+    /// Orbital energy differences e_a - e_i (occ x vir), in the C1 (AO) or the SO basis
+    std::vector<SharedMatrix> cphf_preconditioner(bool c1);
+
    public:
     RHF(SharedWavefunction ref_wfn, std::shared_ptr<SuperFunctional> functional);
     RHF(SharedWavefunction ref_wfn, std::shared_ptr<SuperFunctional> functional, Options& options,
@@ -81,6 +88,8 @@ class RHF : public HF {
     std::vector<SharedMatrix> cphf_Hx(std::vector<SharedMatrix> x) override;
     std::vector<SharedMatrix> cphf_solve(std::vector<SharedMatrix> x_vec, double conv_tol = 1.e-4, int max_iter = 10,
                                          int print_lvl = 1) override;
+    std::vector<SharedMatrix> cphf_block_solve(std::vector<SharedMatrix> x_vec, double conv_tol = 1.e-4,
+                                               int max_iter = 10, int print_lvl = 1) override;
 
     std::shared_ptr<RHF> c1_deep_copy(std::shared_ptr<BasisSet> basis);
 };
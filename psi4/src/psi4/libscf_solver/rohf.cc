@@ -909,8 +909,7 @@ int ROHF::soscf_update(double soscf_conv, int soscf_min_iter, int soscf_max_iter
 
         double beta = r->vector_dot(z) / rzpre;
 
-        p->scale(beta);
-        p->add(z);
+        p->axpby(1.0, z, beta);
     }
 
     if (soscf_print) {
@@ -38,6 +38,8 @@
 #include <cstdio>
 #include <cmath>
 #include <algorithm>
+#include <map>
+#include <sstream>
 #include <vector>
 #include <utility>
 
@@ -83,6 +85,53 @@ static bool SAD_use_fitting(const Options& opt) {
     throw PSIEXCEPTION("SAD_SCF_TYPE " + opt.get_str("SAD_SCF_TYPE") + " not implemented.\n");
 }
 
+// Converged atomic UHF results, kept for the lifetime of the process so that repeated SAD
+// guesses (optimizations, scans, many-body expansions) only ever solve each kind of atom once.
+struct SADAtomicResult {
+    SharedMatrix D;
+    SharedMatrix Chu;
+    SharedVector Ehu;
+};
+static std::map<std::string, SADAtomicResult> SAD_atomic_cache;
+
+// Everything that enters an atomic UHF: the shells (exponents and contraction coefficients are
+// written exactly, as hex floats), the nuclear charge, the occupations and the solver settings.
+static void SAD_key_basis(std::ostringstream& key, const std::shared_ptr<BasisSet>& bas) {
+    key << "nbf " << bas->nbf() << " ecp " << bas->n_ecp_core() << '\n';
+    for (int s = 0; s < bas->nshell(); s++) {
+        const GaussianShell& shell = bas->shell(s);
+        key << shell.am() << (shell.is_pure() ? 'p' : 'c');
+        for (int p = 0; p < shell.nprimitive(); p++) key << ' ' << shell.exp(p) << ' ' << shell.original_coef(p);
+        key << '\n';
+    }
+    for (int s = 0; s < bas->n_ecp_shell(); s++) {
+        const GaussianShell& shell = bas->ecp_shell(s);
+        key << "ecp " << shell.am();
+        for (int p = 0; p < shell.nprimitive(); p++) key << ' ' << shell.exp(p) << ' ' << shell.coef(p);
+        key << '\n';
+    }
+}
+
+static std::string SAD_atomic_key(const Options& opt, const std::shared_ptr<BasisSet>& bas,
+                                  const std::shared_ptr<BasisSet>& fit, const SharedVector& occ_a,
+                                  const SharedVector& occ_b) {
+    std::ostringstream key;
+    key << std::hexfloat;
+    key << "Z " << bas->molecule()->Z(0) << '\n';
+    key << "occ_a";
+    for (int i = 0; i < occ_a->dim(); i++) key << ' ' << occ_a->get(i);
+    key << "\nocc_b";
+    for (int i = 0; i < occ_b->dim(); i++) key << ' ' << occ_b->get(i);
+    key << '\n' << opt.get_str("SAD_SCF_TYPE") << ' ' << opt.get_double("SAD_E_CONVERGENCE") << ' '
+        << opt.get_double("SAD_D_CONVERGENCE") << ' ' << opt.get_int("SAD_MAXITER") << ' '
+        << opt.get_bool("DIIS_RMS_ERROR") << '\n';
+    key << "basis\n";
+    SAD_key_basis(key, bas);
+    key << "fit\n";
+    SAD_key_basis(key, fit);
+    return key.str();
+}
+
 SADGuess::SADGuess(std::shared_ptr<BasisSet> basis, std::vector<std::shared_ptr<BasisSet>> atomic_bases,
                    Options& options)
     : basis_(basis), atomic_bases_(atomic_bases), options_(options) {
@@ -328,14 +377,23 @@ void SADGuess::run_atomic_calculations(SharedMatrix& DAO, SharedMatrix& HuckelC,
         atomic_Chu[uniA] = std::make_shared<Matrix>("Atomic Huckel C", nbf, nhu);
         atomic_Ehu[uniA] = std::make_shared<Vector>("Atomic Huckel E", nhu);
 
-        if (SAD_use_fitting(options_)) {
-            get_uhf_atomic_density(atomic_bases_[index], atomic_fit_bases_[index], occ_a, occ_b, atomic_D[uniA],
-                                   atomic_Chu[uniA], atomic_Ehu[uniA]);
-        } else {
-            std::shared_ptr<BasisSet> zbas = BasisSet::zero_ao_basis_set();
-            get_uhf_atomic_density(atomic_bases_[index], zbas, occ_a, occ_b, atomic_D[uniA], atomic_Chu[uniA],
-                                   atomic_Ehu[uniA]);
+        std::shared_ptr<BasisSet> fit_basis =
+            SAD_use_fitting(options_) ? atomic_fit_bases_[index] : BasisSet::zero_ao_basis_set();
+
+        std::string key = SAD_atomic_key(options_, atomic_bases_[index], fit_basis, occ_a, occ_b);
+        auto cached = SAD_atomic_cache.find(key);
+        if (cached != SAD_atomic_cache.end()) {
+            atomic_D[uniA]->copy(cached->second.D);
+            atomic_Chu[uniA]->copy(cached->second.Chu);
+            atomic_Ehu[uniA]->copy(*cached->second.Ehu);
+            if (print_ > 1) outfile->Printf("  Reusing the UHF solution of an identical earlier atom.\n");
+            continue;
         }
+
+        get_uhf_atomic_density(atomic_bases_[index], fit_basis, occ_a, occ_b, atomic_D[uniA], atomic_Chu[uniA],
+                               atomic_Ehu[uniA]);
+        SAD_atomic_cache[key] = {atomic_D[uniA]->clone(), atomic_Chu[uniA]->clone(),
+                                 std::make_shared<Vector>(*atomic_Ehu[uniA])};
         if (print_ > 1) outfile->Printf("Finished UHF Computation!\n");
     }
     if (print_) outfile->Printf("\n");
@@ -174,22 +174,21 @@ void UHF::form_V() {
     // Vb_ = Va_;
 }
 void UHF::form_G() {
+    // Push the C matrix on
+    std::vector<SharedMatrix>& C = jk_->C_left();
+    C.clear();
+    C.push_back(Ca_subset("SO", "OCC"));
+    C.push_back(Cb_subset("SO", "OCC"));
+    // Run the JK object and the XC potential
+    form_JK_and_V();
+
     if (functional_->needs_xc()) {
-        form_V();
         Ga_->copy(Va_);
         Gb_->copy(Vb_);
     } else {
         Ga_->zero();
         Gb_->zero();
     }
-
-    // Push the C matrix on
-    std::vector<SharedMatrix>& C = jk_->C_left();
-    C.clear();
-    C.push_back(Ca_subset("SO", "OCC"));
-    C.push_back(Cb_subset("SO", "OCC"));
-    // Run the JK object
-    jk_->compute();
     // Pull the J and K matrices off
     const std::vector<SharedMatrix>& J = jk_->J();
     const std::vector<SharedMatrix>& K = jk_->K();
@@ -438,8 +437,9 @@ std::vector<SharedMatrix> UHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
         }
     }
 
-    SharedMatrix Caocc_ao, Cavir_ao, Fa_ao, Caocc_so, Cavir_so;
-    SharedMatrix Cbocc_ao, Cbvir_ao, Fb_ao, Cbocc_so, Cbvir_so;
+    // Fij is the same for every vector, so it is formed once per basis and spin
+    SharedMatrix Caocc_ao, Cavir_ao, Fa_ao, Faoo_ao, Caocc_so, Cavir_so, Faoo_so;
+    SharedMatrix Cbocc_ao, Cbvir_ao, Fb_ao, Fboo_ao, Cbocc_so, Cbvir_so, Fboo_so;
 
     if (needs_ao) {
         Caocc_ao = Ca_subset("AO", "OCC");
@@ -448,6 +448,8 @@ std::vector<SharedMatrix> UHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
         Cbvir_ao = Cb_subset("AO", "VIR");
         Fa_ao = matrix_subset_helper(Fa_, Ca_, "AO", "Fock");
         Fb_ao = matrix_subset_helper(Fb_, Cb_, "AO", "Fock");
+        Faoo_ao = linalg::triplet(Caocc_ao, Fa_ao, Caocc_ao, true, false, false);
+        Fboo_ao = linalg::triplet(Cbocc_ao, Fb_ao, Cbocc_ao, true, false, false);
     }
 
     if (needs_so) {
@@ -455,10 +457,12 @@ std::vector<SharedMatrix> UHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
         Cavir_so = Ca_subset("SO", "VIR");
         Cbocc_so = Cb_subset("SO", "OCC");
         Cbvir_so = Cb_subset("SO", "VIR");
+        Faoo_so = linalg::triplet(Caocc_so, Fa_, Caocc_so, true, false, false);
+        Fboo_so = linalg::triplet(Cbocc_so, Fb_, Cbocc_so, true, false, false);
     }
 
     // Compute Fij x_ia - Fab x_ia
-    SharedMatrix Fa, Fb, Cao, Cbo, Cav, Cbv;
+    SharedMatrix Fa, Fb, Faoo, Fboo, Cav, Cbv;
     std::vector<SharedMatrix> ret;
     for (size_t i = 0; i < x_vec.size() / 2; i++) {
         if (c1_input_[i]) {
@@ -467,9 +471,9 @@ std::vector<SharedMatrix> UHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
             }
             Fa = Fa_ao;
             Fb = Fb_ao;
+            Faoo = Faoo_ao;
+            Fboo = Fboo_ao;
 
-            Cao = Caocc_ao;
-            Cbo = Cbocc_ao;
             Cav = Cavir_ao;
             Cbv = Cbvir_ao;
 
@@ -480,15 +484,14 @@ std::vector<SharedMatrix> UHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
             }
             Fa = Fa_;
             Fb = Fb_;
+            Faoo = Faoo_so;
+            Fboo = Fboo_so;
 
-            Cao = Caocc_so;
-            Cbo = Cbocc_so;
             Cav = Cavir_so;
             Cbv = Cbvir_so;
         }
         // Alpha
-        SharedMatrix tmp1 = linalg::triplet(Cao, Fa, Cao, true, false, false);
-        SharedMatrix result = linalg::doublet(tmp1, x_vec[2 * i], false, false);
+        SharedMatrix result = linalg::doublet(Faoo, x_vec[2 * i], false, false);
 
         SharedMatrix tmp2 = linalg::triplet(x_vec[2 * i], Cav, Fa, false, true, false);
         result->gemm(false, false, -1.0, tmp2, Cav, 1.0);
@@ -496,8 +499,7 @@ std::vector<SharedMatrix> UHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
         ret.push_back(result);
 
         // Beta
-        tmp1 = linalg::triplet(Cbo, Fb, Cbo, true, false, false);
-        result = linalg::doublet(tmp1, x_vec[2 * i + 1], false, false);
+        result = linalg::doublet(Fboo, x_vec[2 * i + 1], false, false);
 
         tmp2 = linalg::triplet(x_vec[2 * i + 1], Cbv, Fb, false, true, false);
         result->gemm(false, false, -1.0, tmp2, Cbv, 1.0);
@@ -748,6 +750,84 @@ std::vector<SharedMatrix> UHF::cphf_Hx(std::vector<SharedMatrix> x_vec) {
 
     return onel;
 }
+std::vector<SharedMatrix> UHF::cphf_preconditioner(bool c1) {
+    if (c1) {
+        // MO (C1) Fock Matrix (Inactive Fock in Helgaker's language)
+        auto Caocc_ao = Ca_subset("AO", "ALL");
+        auto Cbocc_ao = Cb_subset("AO", "ALL");
+        auto Fa_ao = matrix_subset_helper(Fa_, Ca_, "AO", "Fock");
+        auto Fb_ao = matrix_subset_helper(Fb_, Cb_, "AO", "Fock");
+        auto IFock_ao_a = linalg::triplet(Caocc_ao, Fa_ao, Caocc_ao, true, false, false);
+        auto IFock_ao_b = linalg::triplet(Cbocc_ao, Fb_ao, Cbocc_ao, true, false, false);
+        auto Precon_ao_a = std::make_shared<Matrix>("Precon", nalpha_, nmo_ - nalpha_);
+        auto Precon_ao_b = std::make_shared<Matrix>("Precon", nbeta_, nmo_ - nbeta_);
+
+        auto denom_ap = Precon_ao_a->pointer()[0];
+        auto f_ap = IFock_ao_a->pointer();
+        for (size_t i = 0, target = 0; i < nalpha_; i++) {
+            for (size_t a = nalpha_; a < nmo_; a++) {
+                denom_ap[target++] = -f_ap[i][i] + f_ap[a][a];
+            }
+        }
+
+        auto denom_bp = Precon_ao_b->pointer()[0];
+        auto f_bp = IFock_ao_b->pointer();
+        for (size_t i = 0, target = 0; i < nbeta_; i++) {
+            for (size_t a = nbeta_; a < nmo_; a++) {
+                denom_bp[target++] = -f_bp[i][i] + f_bp[a][a];
+            }
+        }
+        return {Precon_ao_a, Precon_ao_b};
+    }
+
+    // Grab occ and vir orbitals
+    Dimension virpi_a = nmopi_ - nalphapi_;
+    Dimension virpi_b = nmopi_ - nbetapi_;
+
+    // MO Fock Matrix (Inactive Fock in Helgaker's language)
+    SharedMatrix IFock_a = linalg::triplet(Ca_, Fa_, Ca_, true, false, false);
+    SharedMatrix IFock_b = linalg::triplet(Cb_, Fb_, Cb_, true, false, false);
+    auto Precon_so_a = std::make_shared<Matrix>("Alpha Precon", nirrep_, nalphapi_, virpi_a);
+    auto Precon_so_b = std::make_shared<Matrix>("Beta Precon", nirrep_, nbetapi_, virpi_b);
+
+    for (size_t h = 0; h < nirrep_; h++) {
+        if (virpi_a[h] && nalphapi_[h]) {
+            double* denom_ap = Precon_so_a->pointer(h)[0];
+            double** f_ap = IFock_a->pointer(h);
+            for (size_t i = 0, target = 0, max_i = nalphapi_[h], max_a = nmopi_[h]; i < max_i; i++) {
+                for (size_t a = max_i; a < max_a; a++) {
+                    denom_ap[target++] = -f_ap[i][i] + f_ap[a][a];
+                }
+            }
+        }
+
+        if (virpi_b[h] && nbetapi_[h]) {
+            double* denom_bp = Precon_so_b->pointer(h)[0];
+            double** f_bp = IFock_b->pointer(h);
+            for (size_t i = 0, target = 0, max_i = nbetapi_[h], max_a = nmopi_[h]; i < max_i; i++) {
+                for (size_t a = max_i; a < max_a; a++) {
+                    denom_bp[target++] = -f_bp[i][i] + f_bp[a][a];
+                }
+            }
+        }
+    }
+    return {Precon_so_a, Precon_so_b};
+}
+std::vector<SharedMatrix> UHF::cphf_block_solve(std::vector<SharedMatrix> x_vec, double conv_tol, int max_iter,
+                                                int print_lvl) {
+    if ((x_vec.size() % 2) != 0) {
+        throw PSIEXCEPTION("UHF::cphf_block_solve expect incoming vector to alternate A/B");
+    }
+    if (x_vec.empty()) return {};
+
+    // The block solver needs every equation in the same basis
+    bool c1 = (x_vec[0]->nirrep() == 1) && (nirrep_ != 1);
+    for (const auto& x : x_vec) {
+        if (((x->nirrep() == 1) && (nirrep_ != 1)) != c1) return cphf_solve(x_vec, conv_tol, max_iter, print_lvl);
+    }
+
+    return cphf_block_cg(x_vec, cphf_preconditioner(c1), conv_tol, max_iter, print_lvl);
+}
 std::vector<SharedMatrix> UHF::cphf_solve(std::vector<SharedMatrix> x_vec, double conv_tol, int max_iter,
                                           int print_lvl) {
     if ((x_vec.size() % 2) != 0) {
@@ -777,67 +857,15 @@ std::vector<SharedMatrix> UHF::cphf_solve(std::vector<SharedMatrix> x_vec, doubl
 
     // => Build preconditioner <= //
     SharedMatrix Precon_ao_a, Precon_ao_b, Precon_so_a, Precon_so_b;
-
     if (needs_ao) {
-        // MO (C1) Fock Matrix (Inactive Fock in Helgaker's language)
-        auto Caocc_ao = Ca_subset("AO", "ALL");
-        auto Cbocc_ao = Cb_subset("AO", "ALL");
-        auto Fa_ao = matrix_subset_helper(Fa_, Ca_, "AO", "Fock");
-        auto Fb_ao = matrix_subset_helper(Fb_, Cb_, "AO", "Fock");
-        auto IFock_ao_a = linalg::triplet(Caocc_ao, Fa_ao, Caocc_ao, true, false, false);
-        auto IFock_ao_b = linalg::triplet(Cbocc_ao, Fb_ao, Cbocc_ao, true, false, false);
-        Precon_ao_a = std::make_shared<Matrix>("Precon", nalpha_, nmo_ - nalpha_);
-        Precon_ao_b = std::make_shared<Matrix>("Precon", nbeta_, nmo_ - nbeta_);
-
-        auto denom_ap = Precon_ao_a->pointer()[0];
-        auto f_ap = IFock_ao_a->pointer();
-        for (size_t i = 0, target = 0; i < nalpha_; i++) {
-            for (size_t a = nalpha_; a < nmo_; a++) {
-                denom_ap[target++] = -f_ap[i][i] + f_ap[a][a];
-            }
-        }
-
-        auto denom_bp = Precon_ao_b->pointer()[0];
-        auto f_bp = IFock_ao_b->pointer();
-        for (size_t i = 0, target = 0; i < nbeta_; i++) {
-            for (size_t a = nbeta_; a < nmo_; a++) {
-                denom_bp[target++] = -f_bp[i][i] + f_bp[a][a];
-            }
-        }
+        auto precon = cphf_preconditioner(true);
+        Precon_ao_a = precon[0];
+        Precon_ao_b = precon[1];
     }
-
     if (needs_so) {
-        // Grab occ and vir orbitals
-        Dimension virpi_a = nmopi_ - nalphapi_;
-        Dimension virpi_b = nmopi_ - nbetapi_;
-
-        // MO Fock Matrix (Inactive Fock in Helgaker's language)
-        SharedMatrix IFock_a = linalg::triplet(Ca_, Fa_, Ca_, true, false, false);
-        SharedMatrix IFock_b = linalg::triplet(Cb_, Fb_, Cb_, true, false, false);
-        Precon_so_a = std::make_shared<Matrix>("Alpha Precon", nirrep_, nalphapi_, virpi_a);
-        Precon_so_b = std::make_shared<Matrix>("Beta Precon", nirrep_, nbetapi_, virpi_b);
-
-        for (size_t h = 0; h < nirrep_; h++) {
-            if (virpi_a[h] && nalphapi_[h]) {
-                double* denom_ap = Precon_so_a->pointer(h)[0];
-                double** f_ap = IFock_a->pointer(h);
-                for (size_t i = 0, target = 0, max_i = nalphapi_[h], max_a = nmopi_[h]; i < max_i; i++) {
-                    for (size_t a = max_i; a < max_a; a++) {
-                        denom_ap[target++] = -f_ap[i][i] + f_ap[a][a];
-                    }
-                }
-            }
-
-            if (virpi_b[h] && nbetapi_[h]) {
-                double* denom_bp = Precon_so_b->pointer(h)[0];
-                double** f_bp = IFock_b->pointer(h);
-                for (size_t i = 0, target = 0, max_i = nbetapi_[h], max_a = nmopi_[h]; i < max_i; i++) {
-                    for (size_t a = max_i; a < max_a; a++) {
-                        denom_bp[target++] = -f_bp[i][i] + f_bp[a][a];
-                    }
-                }
-            }
-        }
+        auto precon = cphf_preconditioner(false);
+        Precon_so_a = precon[0];
+        Precon_so_b = precon[1];
     }
 
     // => Header <= //
@@ -1026,11 +1054,8 @@ std::vector<SharedMatrix> UHF::cphf_solve(std::vector<SharedMatrix> x_vec, doubl
             tmp_numer += r_vec[2 * i + 1]->vector_dot(z_vec[2 * i + 1]);
             double beta = tmp_numer / rzpre[i];
 
-            p_vec[2 * i]->scale(beta);
-            p_vec[2 * i]->add(z_vec[2 * i]);
-
-            p_vec[2 * i + 1]->scale(beta);
-            p_vec[2 * i + 1]->add(z_vec[2 * i + 1]);
+            p_vec[2 * i]->axpby(1.0, z_vec[2 * i], beta);
+            p_vec[2 * i + 1]->axpby(1.0, z_vec[2 * i + 1], beta);
         }
     }
 
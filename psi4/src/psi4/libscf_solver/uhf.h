@@ -57,6 +57,9 @@ class UHF : public HF {
     // Compute UHF NOs
     void compute_nos();
 
+    /// Alpha and beta orbital energy differences e_a - e_i (occ x vir), in the C1 (AO) or the SO basis
+    std::vector<SharedMatrix> cphf_preconditioner(bool c1);
+
     // Second-order convergence code
     void Hx(SharedMatrix x_a, SharedMatrix IFock_a, SharedMatrix Cocc_a, SharedMatrix Cvir_a, SharedMatrix ret_a,
             SharedMatrix x_b, SharedMatrix IFock_b, SharedMatrix Cocc_b, SharedMatrix Cvir_b, SharedMatrix ret_b);
@@ -90,6 +93,8 @@ class UHF : public HF {
     std::vector<SharedMatrix> cphf_Hx(std::vector<SharedMatrix> x) override;
     std::vector<SharedMatrix> cphf_solve(std::vector<SharedMatrix> x_vec, double conv_tol = 1.e-4, int max_iter = 10,
                                          int print_lvl = 1) override;
+    std::vector<SharedMatrix> cphf_block_solve(std::vector<SharedMatrix> x_vec, double conv_tol = 1.e-4,
+                                               int max_iter = 10, int print_lvl = 1) override;
 
     std::shared_ptr<UHF> c1_deep_copy(std::shared_ptr<BasisSet> basis);
 };
@@ -28,11 +28,17 @@
 
 #include "fcidump_helper.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "psi4/psi4-dec.h"
 #include "psi4/psifiles.h"
@@ -42,6 +48,8 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libqt/qt.h"
 #include "psi4/libtrans/integraltransform.h"
@@ -49,11 +57,11 @@
 namespace psi {
 namespace fcidump {
 void fcidump_tei_helper(int nirrep, bool restricted, std::map<std::string, int> DPD_info, double ints_tolerance,
-                        std::string fname) {
+                        std::string fname, bool binary) {
     outfile->Printf("Writing TEI integrals in FCIDUMP format to " + fname + "\n");
     // Append to the file created by the fcidump function Python-side
-    auto mode = std::ostream::app;
-    auto intdump = std::make_shared<PsiOutStream>(fname.c_str(), mode);
+    std::ofstream intdump(fname, std::ios_base::app | std::ios_base::binary);
+    if (!intdump) throw PSIEXCEPTION("FCIDUMP: could not open " + fname);
 
     // Use the IntegralTransform object's DPD instance, for convenience
     dpd_set_default(DPD_info["instance_id"]);
@@ -69,7 +77,7 @@ void fcidump_tei_helper(int nirrep, bool restricted, std::map<std::string, int>
         // DPD_info["alpha_MO"] is DPD_ID("[A>=A]+")
         global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, DPD_info["alpha_MO"], DPD_info["alpha_MO"],
                                DPD_info["alpha_MO"], DPD_info["alpha_MO"], 0, "MO Ints (AA|AA)");
-        detail::write_tei_to_disk(intdump, nirrep, K, ints_tolerance, mo_index, mo_index);
+        detail::write_tei_to_disk(intdump, nirrep, K, ints_tolerance, mo_index, mo_index, binary);
         global_dpd_->buf4_close(&K);
     } else {
         /* Convert an alpha spin-orbital index [0,1,...] to [1,3,...] (i.e. from
@@ -85,42 +93,87 @@ void fcidump_tei_helper(int nirrep, bool restricted, std::map<std::string, int>
         // alpha-alpha
         global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, DPD_info["alpha_MO"], DPD_info["alpha_MO"],
                                DPD_info["alpha_MO"], DPD_info["alpha_MO"], 0, "MO Ints (AA|AA)");
-        detail::write_tei_to_disk(intdump, nirrep, K, ints_tolerance, alpha_index, alpha_index);
+        detail::write_tei_to_disk(intdump, nirrep, K, ints_tolerance, alpha_index, alpha_index, binary);
         global_dpd_->buf4_close(&K);
         // beta-beta
         global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, DPD_info["beta_MO"], DPD_info["beta_MO"], DPD_info["beta_MO"],
                                DPD_info["beta_MO"], 0, "MO Ints (aa|aa)");
-        detail::write_tei_to_disk(intdump, nirrep, K, ints_tolerance, beta_index, beta_index);
+        detail::write_tei_to_disk(intdump, nirrep, K, ints_tolerance, beta_index, beta_index, binary);
         global_dpd_->buf4_close(&K);
         // alpha-beta
         global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, DPD_info["alpha_MO"], DPD_info["beta_MO"],
                                DPD_info["alpha_MO"], DPD_info["beta_MO"], 0, "MO Ints (AA|aa)");
-        detail::write_tei_to_disk(intdump, nirrep, K, ints_tolerance, alpha_index, beta_index);
+        detail::write_tei_to_disk(intdump, nirrep, K, ints_tolerance, alpha_index, beta_index, binary);
         global_dpd_->buf4_close(&K);
     }
     _default_psio_lib_->close(PSIF_LIBTRANS_DPD, 1);
 }
 
 namespace detail {
-void write_tei_to_disk(std::shared_ptr<PsiOutStream> intdump, int nirrep, dpdbuf4& K, double ints_tolerance,
-                       OrbitalIndexing indx1, OrbitalIndexing indx2) {
+static_assert(sizeof(BinaryRecord) == 24, "FCIDUMP binary records must not be padded");
+
+/*
+ * The rows of each irrep block are formatted in batches, every thread filling its own
+ * part of the batch, and the parts are then written in row order. The output is the
+ * same as a serial write, and at most one batch of text is held in memory.
+ */
+void write_tei_to_disk(std::ofstream& intdump, int nirrep, dpdbuf4& K, double ints_tolerance, OrbitalIndexing indx1,
+                       OrbitalIndexing indx2, bool binary) {
+    int nthread = Process::environment.get_n_threads();
+    const int rows_per_thread = 64;
+
+    std::vector<std::string> text(nthread);
+    std::vector<std::vector<BinaryRecord>> records(nthread);
+
     for (int h = 0; h < nirrep; ++h) {
         global_dpd_->buf4_mat_irrep_init(&K, h);
         global_dpd_->buf4_mat_irrep_rd(&K, h);
-        for (int pq = 0; pq < K.params->rowtot[h]; ++pq) {
-            int p = K.params->roworb[h][pq][0];
-            int q = K.params->roworb[h][pq][1];
-            for (int rs = 0; rs < K.params->coltot[h]; ++rs) {
-                int r = K.params->colorb[h][rs][0];
-                int s = K.params->colorb[h][rs][1];
-
-                if (std::abs(K.matrix[h][pq][rs]) > ints_tolerance)
-                    intdump->Printf("%28.20E%4d%4d%4d%4d\n", K.matrix[h][pq][rs], indx1(p), indx1(q), indx2(r),
-                                    indx2(s));
+        int nrows = K.params->rowtot[h];
+        int ncols = K.params->coltot[h];
+        for (int batch = 0; batch < nrows; batch += nthread * rows_per_thread) {
+            int batch_end = std::min(nrows, batch + nthread * rows_per_thread);
+#pragma omp parallel num_threads(nthread)
+            {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                std::string& my_text = text[thread];
+                std::vector<BinaryRecord>& my_records = records[thread];
+                my_text.clear();
+                my_records.clear();
+                char line[64];
+                int first = batch + thread * rows_per_thread;
+                int last = std::min(batch_end, first + rows_per_thread);
+                for (int pq = first; pq < last; ++pq) {
+                    int p = indx1(K.params->roworb[h][pq][0]);
+                    int q = indx1(K.params->roworb[h][pq][1]);
+                    for (int rs = 0; rs < ncols; ++rs) {
+                        double value = K.matrix[h][pq][rs];
+                        if (std::abs(value) <= ints_tolerance) continue;
+                        int r = indx2(K.params->colorb[h][rs][0]);
+                        int s = indx2(K.params->colorb[h][rs][1]);
+                        if (binary) {
+                            my_records.push_back({value, {p, q, r, s}});
+                        } else {
+                            int len = std::snprintf(line, sizeof(line), "%28.20E%4d%4d%4d%4d\n", value, p, q, r, s);
+                            my_text.append(line, len);
+                        }
+                    }
+                }
+            }
+            for (int thread = 0; thread < nthread; ++thread) {
+                if (binary) {
+                    intdump.write(reinterpret_cast<const char*>(records[thread].data()),
+                                  records[thread].size() * sizeof(BinaryRecord));
+                } else {
+                    intdump.write(text[thread].data(), text[thread].size());
+                }
             }
         }
         global_dpd_->buf4_mat_irrep_close(&K, h);
     }
+    if (!intdump) throw PSIEXCEPTION("FCIDUMP: error while writing the two-electron integrals");
 }
 }  // End namespace detail
 }  // End namespace fcidump
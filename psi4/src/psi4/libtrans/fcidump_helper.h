@@ -28,13 +28,13 @@
 
 #pragma once
 
+#include <cstdint>
+#include <fstream>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
 
-#include "psi4/libpsi4util/PsiOutStream.h"
-
 namespace psi {
 class Wavefunction;
 class Matrix;
@@ -42,22 +42,31 @@ struct dpdbuf4;
 namespace fcidump {
 /*!  \fn void fcidump_tei_helper(int nirrep, bool restricted, std::map<std::string, int> DPD_info, double
  * ints_tolerance,
- *                  std::string fname = "INTDUMP")
+ *                  std::string fname = "INTDUMP", bool binary = false)
  *  \brief Write integrals to file in FCIDUMP format
  *  \param[in] nirrep number of irreps
  *  \param[in] bool whether RHF or UHF
  *  \param[in] DPD_info DPD instance and MO spaces IDs
  *  \param[in] ints_tolerance tolerance for integrals to be written to file
  *  \param[in] fname name of the FCIDUMP file
+ *  \param[in] binary write fixed-size binary records instead of text lines, see detail::BinaryRecord
  */
 void fcidump_tei_helper(int nirrep, bool restricted, std::map<std::string, int> DPD_info, double ints_tolerance,
-                        std::string fname = "INTDUMP");
+                        std::string fname = "INTDUMP", bool binary = false);
 
 namespace detail {
 using OrbitalIndexing = std::function<int(const int)>;
 
-void write_tei_to_disk(std::shared_ptr<PsiOutStream> intdump, int nirrep, dpdbuf4& K, double ints_tolerance,
-                       OrbitalIndexing indx1, OrbitalIndexing indx2);
+/*! A line of a binary FCIDUMP: the integral and its four one-based indices, little-endian on all
+ *  supported platforms. The namelist header stays text; the records start right after "&END\n".
+ */
+struct BinaryRecord {
+    double value;
+    int32_t index[4];
+};
+
+void write_tei_to_disk(std::ofstream& intdump, int nirrep, dpdbuf4& K, double ints_tolerance, OrbitalIndexing indx1,
+                       OrbitalIndexing indx2, bool binary);
 }  // End namespace detail
 }  // End namespace fcidump
 }  // End namespace psi
@@ -103,6 +103,10 @@ IntegralTransform::IntegralTransform(std::shared_ptr<Wavefunction> wfn, SpaceVec
     nalphapi_ = wfn->nalphapi();
     nbetapi_ = wfn->nbetapi();
     frozen_core_energy_ = 0.0;
+    // The auxiliary basis stays on the wavefunction, so a later CONV transformation must not pick it up
+    bool df_tei = Process::environment.options.get_str("TRANSFORM_TEI_TYPE") == "DF";
+    if (df_tei && wfn->basisset_exists("DF_BASIS_TRANSFORM"))
+        set_df_basisset(wfn->basisset(), wfn->get_basisset("DF_BASIS_TRANSFORM"), wfn->aotoso());
 
     common_initialize();
 
@@ -49,6 +49,8 @@ class Dimension;
 class Wavefunction;
 class PSIO;
 class SOBasisSet;
+class BasisSet;
+struct dpdfile4;
 
 typedef std::vector<std::shared_ptr<MOSpace> > SpaceVec;
 
@@ -171,6 +173,8 @@ class PSI_API IntegralTransform {
 
     /// Sets the SO IWL file to read the TEIs from.
     void set_so_tei_file(int so_tei_file) { soIntTEIFile_ = so_tei_file; }
+    /// Build the SO TEIs by density fitting in the given auxiliary basis, instead of reading the IWL file
+    void set_df_basisset(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> aux, SharedMatrix aotoso);
     /// Set whether to write a DPD formatted SO basis TPDM to disk after density transformations
     void set_write_dpd_so_tpdm(bool t_f) { write_dpd_so_tpdm_ = t_f; }
     /// Set the level of printing used during transformations (0 -> 6)
@@ -248,6 +252,7 @@ class PSI_API IntegralTransform {
 
     void process_eigenvectors();
     void process_spaces();
+    void presort_so_tei_df(dpdfile4 *I, const double *aFzcD, const double *bFzcD, double *aFzcOp, double *bFzcOp);
     void presort_mo_tpdm_restricted();
     void presort_mo_tpdm_unrestricted();
     void setup_tpdm_buffer(const dpdbuf4 *D);
@@ -308,6 +313,12 @@ class PSI_API IntegralTransform {
     int dpdIntFile_;
     // The file from which IWL SO TEIs are read
     int soIntTEIFile_;
+    // The orbital basis, used when the SO TEIs are density fitted
+    std::shared_ptr<BasisSet> primary_;
+    // The auxiliary basis for density fitting the SO TEIs; null for the conventional IWL presort
+    std::shared_ptr<BasisSet> dfBasis_;
+    // The AO to SO transformation, used when the SO TEIs are density fitted
+    SharedMatrix aotoso_;
     // The file containing alpha half-transformed integrals in DPD format
     int aHtIntFile_;
     // The file containing beta half-transformed integrals in DPD format
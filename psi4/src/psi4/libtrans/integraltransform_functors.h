@@ -37,6 +37,11 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/exception.h"
 
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 
 class FrozenCoreRestrictedFunctor {
@@ -405,16 +410,19 @@ class DPDFillerFunctor {
     int **bucket_offset_;
     bool symmetrize_;
     bool have_bra_ket_sym_;
+    /// Whether several threads may call this functor at once
+    bool atomic_;
 
    public:
     DPDFillerFunctor(dpdfile4 *file, int this_bucket, int **bucket_map, int **bucket_offset, bool symmetrize,
-                     bool have_bra_ket_sym)
+                     bool have_bra_ket_sym, bool atomic = false)
         : file_(file),
           this_bucket_(this_bucket),
           bucket_map_(bucket_map),
           bucket_offset_(bucket_offset),
           symmetrize_(symmetrize),
-          have_bra_ket_sym_(have_bra_ket_sym) {
+          have_bra_ket_sym_(have_bra_ket_sym),
+          atomic_(atomic) {
         params_ = file_->params;
     }
     void operator()(int p, int q, int r, int s, double value) {
@@ -442,7 +450,12 @@ class DPDFillerFunctor {
             int offset = bucket_offset_[this_bucket_][pq_sym];
             if ((pq - offset >= params_->rowtot[pq_sym]) || (rs >= params_->coltot[rs_sym]))
                 error("MP Params_make: pq, rs", p, q, r, s, pq, rs, pq_sym, rs_sym);
-            file_->matrix[pq_sym][pq - offset][rs] += value;
+            if (atomic_) {
+#pragma omp atomic
+                file_->matrix[pq_sym][pq - offset][rs] += value;
+            } else {
+                file_->matrix[pq_sym][pq - offset][rs] += value;
+            }
         }
 
         /*
@@ -457,7 +470,12 @@ class DPDFillerFunctor {
             int offset = bucket_offset_[this_bucket_][rs_sym];
             if ((rs - offset >= params_->rowtot[rs_sym]) || (pq >= params_->coltot[pq_sym]))
                 error("MP Params_make: rs, pq", p, q, r, s, rs, pq, rs_sym, pq_sym);
-            file_->matrix[rs_sym][rs - offset][pq] += value;
+            if (atomic_) {
+#pragma omp atomic
+                file_->matrix[rs_sym][rs - offset][pq] += value;
+            } else {
+                file_->matrix[rs_sym][rs - offset][pq] += value;
+            }
         }
     }
 
@@ -505,5 +523,39 @@ void iwl_integrals(IWL *iwl, DPDFunctor &dpd, FockFunctor &fock) {
     iwl->set_keep_flag(true);
 }
 
+/*
+ * Threaded version of the above: every IWL buffer is split over fock.size() threads.  The DPD functor
+ * is shared, so it has to be safe to call concurrently; fock holds one functor per thread, each of
+ * which should accumulate into storage of its own that the caller reduces afterwards.
+ */
+template <class DPDFunctor, class FockFunctor>
+void iwl_integrals(IWL *iwl, DPDFunctor &dpd, std::vector<FockFunctor> &fock) {
+    auto lblptr = iwl->labels();
+    auto valptr = iwl->values();
+    int nthreads = fock.size();
+    bool lastBuffer;
+    do {
+        lastBuffer = iwl->last_buffer();
+        int count = iwl->buffer_count();
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (int index = 0; index < count; ++index) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            int labelIndex = 4 * index;
+            int p = std::abs((int)lblptr[labelIndex++]);
+            int q = (int)lblptr[labelIndex++];
+            int r = (int)lblptr[labelIndex++];
+            int s = (int)lblptr[labelIndex++];
+            double value = (double)valptr[index];
+            dpd(p, q, r, s, value);
+            fock[thread](p, q, r, s, 0, 0, 0, 0, 0, 0, 0, 0, value);
+        } /* end loop through current buffer */
+        if (!lastBuffer) iwl->fetch();
+    } while (!lastBuffer);
+    iwl->set_keep_flag(true);
+}
+
 }  // namespace psi
 #endif  // INTEGRALTRANSFORM_FUNCTORS_H
@@ -37,6 +37,7 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/psifiles.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 #include <cmath>
 #include <numeric>
@@ -226,126 +227,160 @@ void IntegralTransform::presort_so_tei() {
     global_dpd_->file4_init(&I, PSIF_SO_PRESORT, 0, DPD_ID("[n>=n]+"), DPD_ID("[n>=n]+"), "SO Ints (nn|nn)");
 
     size_t memoryd = memory_ / sizeof(double);
+    int nthreads = Process::environment.get_n_threads();
 
-    int nump = 0, numq = 0;
-    for (int h = 0; h < nirreps_; ++h) {
-        nump += I.params->ppi[h];
-        numq += I.params->qpi[h];
-    }
-    int **bucketMap = init_int_matrix(nump, numq);
-
-    /* Room for one bucket to begin with */
-    int **bucketOffset = (int **)malloc(sizeof(int *));
-    bucketOffset[0] = init_int_array(nirreps_);
-    int **bucketRowDim = (int **)malloc(sizeof(int *));
-    bucketRowDim[0] = init_int_array(nirreps_);
-    long int **bucketSize = (long int **)malloc(sizeof(long int *));
-    bucketSize[0] = init_long_int_array(nirreps_);
-
-    /* Figure out how many passes we need and where each p,q goes */
-    int nBuckets = 1;
-    size_t coreLeft = memoryd;
-    psio_address next;
-    for (int h = 0; h < nirreps_; ++h) {
-        size_t rowLength = (size_t)I.params->coltot[h ^ (I.my_irrep)];
-        for (int row = 0; row < I.params->rowtot[h]; ++row) {
-            if (coreLeft >= rowLength) {
-                coreLeft -= rowLength;
-                bucketRowDim[nBuckets - 1][h]++;
-                bucketSize[nBuckets - 1][h] += rowLength;
-            } else {
-                nBuckets++;
-                coreLeft = memoryd - rowLength;
-                /* Make room for another bucket */
-                int **p;
-
-                p = static_cast<int **>(realloc(static_cast<void *>(bucketOffset), nBuckets * sizeof(int *)));
-                if (p == nullptr) {
-                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+    if (dfBasis_) {
+        // Build the presorted integrals from density fitting; the IWL SO integral file is not read
+        presort_so_tei_df(&I, aFzcD.data(), bFzcD.data(), aFzcOp.data(), bFzcOp.data());
+    } else {
+        int nump = 0, numq = 0;
+        for (int h = 0; h < nirreps_; ++h) {
+            nump += I.params->ppi[h];
+            numq += I.params->qpi[h];
+        }
+        int **bucketMap = init_int_matrix(nump, numq);
+
+        /* Room for one bucket to begin with */
+        int **bucketOffset = (int **)malloc(sizeof(int *));
+        bucketOffset[0] = init_int_array(nirreps_);
+        int **bucketRowDim = (int **)malloc(sizeof(int *));
+        bucketRowDim[0] = init_int_array(nirreps_);
+        long int **bucketSize = (long int **)malloc(sizeof(long int *));
+        bucketSize[0] = init_long_int_array(nirreps_);
+
+        /* Figure out how many passes we need and where each p,q goes */
+        int nBuckets = 1;
+        size_t coreLeft = memoryd;
+        psio_address next;
+        for (int h = 0; h < nirreps_; ++h) {
+            size_t rowLength = (size_t)I.params->coltot[h ^ (I.my_irrep)];
+            for (int row = 0; row < I.params->rowtot[h]; ++row) {
+                if (coreLeft >= rowLength) {
+                    coreLeft -= rowLength;
+                    bucketRowDim[nBuckets - 1][h]++;
+                    bucketSize[nBuckets - 1][h] += rowLength;
                 } else {
-                    bucketOffset = p;
+                    nBuckets++;
+                    coreLeft = memoryd - rowLength;
+                    /* Make room for another bucket */
+                    int **p;
+
+                    p = static_cast<int **>(realloc(static_cast<void *>(bucketOffset), nBuckets * sizeof(int *)));
+                    if (p == nullptr) {
+                        throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+                    } else {
+                        bucketOffset = p;
+                    }
+                    bucketOffset[nBuckets - 1] = init_int_array(nirreps_);
+                    bucketOffset[nBuckets - 1][h] = row;
+
+                    p = static_cast<int **>(realloc(static_cast<void *>(bucketRowDim), nBuckets * sizeof(int *)));
+                    if (p == nullptr) {
+                        throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+                    } else {
+                        bucketRowDim = p;
+                    }
+                    bucketRowDim[nBuckets - 1] = init_int_array(nirreps_);
+                    bucketRowDim[nBuckets - 1][h] = 1;
+
+                    long int **pp;
+                    pp = static_cast<long int **>(
+                        realloc(static_cast<void *>(bucketSize), nBuckets * sizeof(long int *)));
+                    if (pp == nullptr) {
+                        throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+                    } else {
+                        bucketSize = pp;
+                    }
+                    bucketSize[nBuckets - 1] = init_long_int_array(nirreps_);
+                    bucketSize[nBuckets - 1][h] = rowLength;
                 }
-                bucketOffset[nBuckets - 1] = init_int_array(nirreps_);
-                bucketOffset[nBuckets - 1][h] = row;
+                int p = I.params->roworb[h][row][0];
+                int q = I.params->roworb[h][row][1];
+                bucketMap[p][q] = nBuckets - 1;
+            }
+        }
 
-                p = static_cast<int **>(realloc(static_cast<void *>(bucketRowDim), nBuckets * sizeof(int *)));
-                if (p == nullptr) {
-                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
-                } else {
-                    bucketRowDim = p;
-                }
-                bucketRowDim[nBuckets - 1] = init_int_array(nirreps_);
-                bucketRowDim[nBuckets - 1][h] = 1;
+        if (print_) {
+            outfile->Printf("\tSorting File: %s nbuckets = %d\n", I.label, nBuckets);
+        }
 
-                long int **pp;
-                pp = static_cast<long int **>(realloc(static_cast<void *>(bucketSize), nBuckets * sizeof(long int *)));
-                if (pp == nullptr) {
-                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+        next = PSIO_ZERO;
+        for (int n = 0; n < nBuckets; ++n) { /* nbuckets = number of passes */
+            /* Prepare target matrix */
+            for (int h = 0; h < nirreps_; h++) {
+                I.matrix[h] = block_matrix(bucketRowDim[n][h], I.params->coltot[h]);
+            }
+
+            DPDFillerFunctor dpdfiller(&I, n, bucketMap, bucketOffset, false, true, nthreads > 1);
+            NullFunctor null;
+            IWL *iwl = new IWL(psio_.get(), soIntTEIFile_, tolerance_, 1, 1);
+            // We need to feed the IWL integrals to construct the frozen core operator only once
+            // If we're not on the first DPD bucket, skip it for efficiency.
+            if (nthreads > 1) {
+                // Split each IWL buffer over the threads.  Every thread builds its own share of the
+                // frozen core operator(s), which are summed into the full ones afterwards.
+                if (n) {
+                    std::vector<NullFunctor> nulls(nthreads);
+                    iwl_integrals(iwl, dpdfiller, nulls);
+                } else if (transformationType_ == TransformationType::Restricted) {
+                    std::vector<std::vector<double>> aFz(nthreads, std::vector<double>(nTriSo_, 0.0));
+                    std::vector<FrozenCoreRestrictedFunctor> frozencore;
+                    for (int t = 0; t < nthreads; ++t) frozencore.emplace_back(aFzcD.data(), aFz[t].data());
+                    iwl_integrals(iwl, dpdfiller, frozencore);
+                    for (int t = 0; t < nthreads; ++t)
+                        for (int pq = 0; pq < nTriSo_; ++pq) aFzcOp[pq] += aFz[t][pq];
                 } else {
-                    bucketSize = pp;
+                    std::vector<std::vector<double>> aFz(nthreads, std::vector<double>(nTriSo_, 0.0));
+                    std::vector<std::vector<double>> bFz(nthreads, std::vector<double>(nTriSo_, 0.0));
+                    std::vector<FrozenCoreUnrestrictedFunctor> frozencore;
+                    for (int t = 0; t < nthreads; ++t)
+                        frozencore.emplace_back(aFzcD.data(), bFzcD.data(), aFz[t].data(), bFz[t].data());
+                    iwl_integrals(iwl, dpdfiller, frozencore);
+                    for (int t = 0; t < nthreads; ++t) {
+                        for (int pq = 0; pq < nTriSo_; ++pq) {
+                            aFzcOp[pq] += aFz[t][pq];
+                            bFzcOp[pq] += bFz[t][pq];
+                        }
+                    }
                 }
-                bucketSize[nBuckets - 1] = init_long_int_array(nirreps_);
-                bucketSize[nBuckets - 1][h] = rowLength;
+            } else if (transformationType_ == TransformationType::Restricted) {
+                FrozenCoreRestrictedFunctor frozencore(aFzcD.data(), aFzcOp.data());
+                if (n)
+                    iwl_integrals(iwl, dpdfiller, null);
+                else
+                    iwl_integrals(iwl, dpdfiller, frozencore);
+            } else {
+                FrozenCoreUnrestrictedFunctor frozencore(aFzcD.data(), bFzcD.data(), aFzcOp.data(), bFzcOp.data());
+                if (n)
+                    iwl_integrals(iwl, dpdfiller, null);
+                else
+                    iwl_integrals(iwl, dpdfiller, frozencore);
             }
-            int p = I.params->roworb[h][row][0];
-            int q = I.params->roworb[h][row][1];
-            bucketMap[p][q] = nBuckets - 1;
-        }
-    }
+            delete iwl;
 
-    if (print_) {
-        outfile->Printf("\tSorting File: %s nbuckets = %d\n", I.label, nBuckets);
-    }
+            for (int h = 0; h < nirreps_; ++h) {
+                if (bucketSize[n][h])
+                    psio_->write(I.filenum, I.label, (char *)I.matrix[h][0],
+                                 bucketSize[n][h] * ((long int)sizeof(double)), next, &next);
+                free_block(I.matrix[h]);
+            }
+        } /* end loop over buckets/passes */
 
-    next = PSIO_ZERO;
-    for (int n = 0; n < nBuckets; ++n) { /* nbuckets = number of passes */
-        /* Prepare target matrix */
-        for (int h = 0; h < nirreps_; h++) {
-            I.matrix[h] = block_matrix(bucketRowDim[n][h], I.params->coltot[h]);
-        }
+        /* Get rid of the input integral file */
+        psio_->open(soIntTEIFile_, PSIO_OPEN_OLD);
+        psio_->close(soIntTEIFile_, keepIwlSoInts_);
 
-        DPDFillerFunctor dpdfiller(&I, n, bucketMap, bucketOffset, false, true);
-        NullFunctor null;
-        IWL *iwl = new IWL(psio_.get(), soIntTEIFile_, tolerance_, 1, 1);
-        // We need to feed the IWL integrals to construct the frozen core operator only once
-        // If we're not on the first DPD bucket, skip it for efficiency.
-        if (transformationType_ == TransformationType::Restricted) {
-            FrozenCoreRestrictedFunctor frozencore(aFzcD.data(), aFzcOp.data());
-            if (n)
-                iwl_integrals(iwl, dpdfiller, null);
-            else
-                iwl_integrals(iwl, dpdfiller, frozencore);
-        } else {
-            FrozenCoreUnrestrictedFunctor frozencore(aFzcD.data(), bFzcD.data(), aFzcOp.data(), bFzcOp.data());
-            if (n)
-                iwl_integrals(iwl, dpdfiller, null);
-            else
-                iwl_integrals(iwl, dpdfiller, frozencore);
-        }
-        delete iwl;
+        free_int_matrix(bucketMap);
 
-        for (int h = 0; h < nirreps_; ++h) {
-            if (bucketSize[n][h])
-                psio_->write(I.filenum, I.label, (char *)I.matrix[h][0], bucketSize[n][h] * ((long int)sizeof(double)),
-                             next, &next);
-            free_block(I.matrix[h]);
+        for (int n = 0; n < nBuckets; ++n) {
+            free(bucketOffset[n]);
+            free(bucketRowDim[n]);
+            free(bucketSize[n]);
         }
-    } /* end loop over buckets/passes */
-
-    /* Get rid of the input integral file */
-    psio_->open(soIntTEIFile_, PSIO_OPEN_OLD);
-    psio_->close(soIntTEIFile_, keepIwlSoInts_);
-
-    free_int_matrix(bucketMap);
-
-    for (int n = 0; n < nBuckets; ++n) {
-        free(bucketOffset[n]);
-        free(bucketRowDim[n]);
-        free(bucketSize[n]);
+        free(bucketOffset);
+        free(bucketRowDim);
+        free(bucketSize);
     }
-    free(bucketOffset);
-    free(bucketRowDim);
-    free(bucketSize);
 
     if (print_) outfile->Printf("\tConstructing frozen core operators\n");
     if (transformationType_ == TransformationType::Restricted) {
@@ -0,0 +1,165 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2022 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "integraltransform_functors.h"
+#include "integraltransform.h"
+
+#include "psi4/lib3index/dfhelper.h"
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libdpd/dpd.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace psi;
+
+void IntegralTransform::set_df_basisset(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> aux,
+                                        SharedMatrix aotoso) {
+    primary_ = primary;
+    dfBasis_ = aux;
+    aotoso_ = aotoso;
+    alreadyPresorted_ = false;
+}
+
+/**
+ * Fills the presorted SO integral file, I, from density-fitted integrals
+ *
+ *     (pq|rs) = sum_Q B(Q|pq) B(Q|rs),    B = (Q|P)^-1/2 (P|pq)
+ *
+ * instead of reading the IWL SO integral file.  The B tensors come from DFHelper in the SO
+ * basis; for each irrep the pair block B(Q|pq) is kept in core and each bucket of I rows is
+ * then a single DGEMM, written to disk in the same order as the conventional presort.  The
+ * frozen core operators are accumulated from the same unique integrals the conventional
+ * presort sees.  bFzcD and bFzcOp are only used for unrestricted transformations.
+ */
+void IntegralTransform::presort_so_tei_df(dpdfile4 *I, const double *aFzcD, const double *bFzcD, double *aFzcOp,
+                                          double *bFzcOp) {
+    size_t memoryd = memory_ / sizeof(double);
+    int nthreads = Process::environment.get_n_threads();
+    size_t nao = primary_->nbf();
+    size_t naux = dfBasis_->nbf();
+
+    // Pair offsets of each irrep's block within the packed B storage
+    std::vector<size_t> pairOffset(nirreps_ + 1, 0);
+    for (int h = 0; h < nirreps_; ++h) pairOffset[h + 1] = pairOffset[h] + I->params->rowtot[h];
+    size_t bSize = naux * pairOffset[nirreps_];
+    if (bSize + (size_t)nso_ * nso_ > memoryd / 2)
+        throw PSIEXCEPTION("IntegralTransform: not enough memory to hold the SO basis DF integrals; need " +
+                           std::to_string(8 * (bSize + (size_t)nso_ * nso_) / 500000) + " MB.");
+
+    if (print_) {
+        outfile->Printf("\tBuilding SO-basis two-electron integrals from density fitting.\n");
+        outfile->Printf("\tAuxiliary basis: %s, %zu functions\n", dfBasis_->name().c_str(), naux);
+    }
+
+    // B(Q|pq) for the pairs of each irrep, stored as naux x rowtot[h] blocks
+    std::vector<double> B(bSize);
+    {
+        // The AO to SO transformation, with the SOs in Pitzer order (all of irrep 0, then 1, ...)
+        auto U = std::make_shared<Matrix>("AO to SO", nao, nso_);
+        for (int h = 0, offset = 0; h < nirreps_; ++h) {
+            for (size_t mu = 0; mu < nao; ++mu)
+                for (int p = 0; p < sopi_[h]; ++p) U->set(mu, offset + p, aotoso_->get(h, mu, p));
+            offset += sopi_[h];
+        }
+
+        auto dfh = std::make_shared<DFHelper>(primary_, dfBasis_);
+        dfh->set_memory(memoryd / 2 - bSize);
+        dfh->set_method("STORE");
+        dfh->set_nthreads(nthreads);
+        dfh->set_print_lvl(print_ > 1 ? 1 : 0);
+        dfh->initialize();
+        dfh->add_space("s", U);
+        dfh->add_transformation("SSQ", "s", "s", "Qpq");
+        dfh->transform();
+
+        // Pull B out a few auxiliary functions at a time and scatter it into the pair blocks
+        size_t nsq = (size_t)nso_ * nso_;
+        size_t qBlock = std::max<size_t>(1, std::min(naux, (memoryd / 2 - bSize) / (2 * nsq)));
+        std::vector<double> slice(qBlock * nsq);
+        for (size_t Q0 = 0; Q0 < naux; Q0 += qBlock) {
+            size_t nQ = std::min(qBlock, naux - Q0);
+            dfh->fill_tensor("SSQ", slice.data(), {Q0, Q0 + nQ});
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+            for (int h = 0; h < nirreps_; ++h) {
+                size_t npairs = I->params->rowtot[h];
+                double *Bh = B.data() + naux * pairOffset[h];
+                for (size_t pq = 0; pq < npairs; ++pq) {
+                    int p = I->params->roworb[h][pq][0];
+                    int q = I->params->roworb[h][pq][1];
+                    for (size_t Q = 0; Q < nQ; ++Q) Bh[(Q0 + Q) * npairs + pq] = slice[Q * nsq + p * nso_ + q];
+                }
+            }
+        }
+    }
+
+    // Now the integral buckets: rows of I for each irrep, as many as fit in the remaining memory
+    psio_address next = PSIO_ZERO;
+    FrozenCoreRestrictedFunctor rfrozencore(aFzcD, aFzcOp);
+    FrozenCoreUnrestrictedFunctor ufrozencore(aFzcD, bFzcD, aFzcOp, bFzcOp);
+    for (int h = 0; h < nirreps_; ++h) {
+        size_t npairs = I->params->rowtot[h];
+        size_t coltot = I->params->coltot[h ^ I->my_irrep];
+        if (!npairs || !coltot) continue;
+        size_t rowsPerBucket = std::min(npairs, std::max<size_t>(1, (memoryd - bSize) / coltot));
+        double *Bh = B.data() + naux * pairOffset[h];
+        double **Ih = block_matrix(rowsPerBucket, coltot);
+
+        for (size_t row0 = 0; row0 < npairs; row0 += rowsPerBucket) {
+            size_t nrows = std::min(rowsPerBucket, npairs - row0);
+            C_DGEMM('T', 'N', nrows, coltot, naux, 1.0, Bh + row0, npairs, Bh, npairs, 0.0, Ih[0], coltot);
+
+            // Feed each unique integral to the frozen core operator, as the IWL presort does
+            for (size_t pq = 0; pq < nrows; ++pq) {
+                int p = I->params->roworb[h][row0 + pq][0];
+                int q = I->params->roworb[h][row0 + pq][1];
+                size_t PQ = INDEX(p, q);
+                for (size_t rs = 0; rs < coltot; ++rs) {
+                    int r = I->params->colorb[h][rs][0];
+                    int s = I->params->colorb[h][rs][1];
+                    size_t RS = INDEX(r, s);
+                    if (RS > PQ) continue;
+                    if (transformationType_ == TransformationType::Restricted)
+                        rfrozencore(p, q, r, s, 0, 0, 0, 0, 0, 0, 0, 0, Ih[pq][rs]);
+                    else
+                        ufrozencore(p, q, r, s, 0, 0, 0, 0, 0, 0, 0, 0, Ih[pq][rs]);
+                }
+            }
+
+            psio_->write(I->filenum, I->label, (char *)Ih[0], nrows * coltot * sizeof(double), next, &next);
+        }
+        free_block(Ih);
+    }
+}
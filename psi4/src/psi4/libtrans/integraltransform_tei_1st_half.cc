@@ -37,10 +37,15 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/psifiles.h"
 #include "psi4/libdpd/dpd.h"
+#include "psi4/libpsi4util/process.h"
 
 #include <cmath>
 #include <cctype>
 #include <cstdio>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace psi;
 
@@ -73,7 +78,11 @@ void IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace>
     size_t rowsLeft;
     size_t memFree;
 
-    double **TMP = block_matrix(nso_, nso_);
+    // One scratch block per thread for the row-by-row half transforms.  They come out of the
+    // DPD memory, so the bucket sizes below already leave room for them.
+    int nthreads = Process::environment.get_n_threads();
+    std::vector<double **> TMPs(nthreads);
+    for (int t = 0; t < nthreads; ++t) TMPs[t] = global_dpd_->dpd_block_matrix(sopi_.max(), nso_);
 
     /*** AA/AB two-electron integral transformation ***/
 
@@ -131,7 +140,13 @@ void IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace>
             else
                 thisBucketRows = (n < nBuckets - 1) ? rowsPerBucket : rowsLeft;
             global_dpd_->buf4_mat_irrep_rd_block(&J, h, n * rowsPerBucket, thisBucketRows);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
             for (int pq = 0; pq < thisBucketRows; pq++) {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                double **TMP = TMPs[thread];
                 for (int Gr = 0; Gr < nirreps_; Gr++) {
                     // Transform ( n n | n n ) -> ( n n | n S2 )
                     int Gs = h ^ Gr;
@@ -239,7 +254,13 @@ void IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace>
                 else
                     thisBucketRows = (n < nBuckets - 1) ? rowsPerBucket : rowsLeft;
                 global_dpd_->buf4_mat_irrep_rd_block(&J, h, n * rowsPerBucket, thisBucketRows);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
                 for (int pq = 0; pq < thisBucketRows; pq++) {
+                    int thread = 0;
+#ifdef _OPENMP
+                    thread = omp_get_thread_num();
+#endif
+                    double **TMP = TMPs[thread];
                     for (int Gr = 0; Gr < nirreps_; Gr++) {
                         // Transform ( n n | n n ) -> ( n n | n s2 )
                         int Gs = h ^ Gr;
@@ -299,7 +320,7 @@ void IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace>
 
     psio_->close(PSIF_SO_PRESORT, keepDpdSoInts_);
 
-    free_block(TMP);
+    for (int t = 0; t < nthreads; ++t) global_dpd_->free_dpd_block(TMPs[t], sopi_.max(), nso_);
     delete[] label;
 
     if (print_) {
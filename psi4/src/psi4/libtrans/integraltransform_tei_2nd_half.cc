@@ -37,10 +37,15 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/psifiles.h"
 #include "psi4/libdpd/dpd.h"
+#include "psi4/libpsi4util/process.h"
 
 #include <cmath>
 #include <cctype>
 #include <cstdio>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace psi;
 
@@ -88,7 +93,11 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
     size_t memFree;
     dpdbuf4 J, K;
 
-    double **TMP = block_matrix(nso_, nso_);
+    // One scratch block per thread for the row-by-row half transforms.  They come out of the
+    // DPD memory, so the bucket sizes below already leave room for them.
+    int nthreads = Process::environment.get_n_threads();
+    std::vector<double **> TMPs(nthreads);
+    for (int t = 0; t < nthreads; ++t) TMPs[t] = global_dpd_->dpd_block_matrix(sopi_.max(), nso_);
 
     if (print_) {
         if (transformationType_ == TransformationType::Restricted) {
@@ -155,7 +164,13 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
             else
                 thisBucketRows = (n < nBuckets - 1) ? rowsPerBucket : rowsLeft;
             global_dpd_->buf4_mat_irrep_rd_block(&J, h, n * rowsPerBucket, thisBucketRows);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
             for (int pq = 0; pq < thisBucketRows; pq++) {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                double **TMP = TMPs[thread];
                 for (int Gr = 0; Gr < nirreps_; Gr++) {
                     // Transform ( S1 S2 | n n ) -> ( S1 S2 | n S4 )
                     int Gs = h ^ Gr;
@@ -180,7 +195,9 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
                                 &K.matrix[h][pq][rs], ncols);
                     // TODO else if s3->label() == MOSPACE_NIL, copy buffer...
                 } /* Gr */
-                if (useIWL_) {
+            } /* pq */
+            if (useIWL_) {
+                for (int pq = 0; pq < thisBucketRows; pq++) {
                     int P = aIndex1[K.params->roworb[h][pq + n * rowsPerBucket][0]];
                     int Q = aIndex2[K.params->roworb[h][pq + n * rowsPerBucket][1]];
                     size_t PQ = INDEX(P, Q);
@@ -196,8 +213,8 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
                         if ((RS < PQ) && bra_ket_sym) continue;
                         iwl->write_value(P, Q, R, S, K.matrix[h][pq][rs], printTei_, "outfile", 0);
                     } /* rs */
-                }
-            } /* pq */
+                } /* pq */
+            }
             global_dpd_->buf4_mat_irrep_wrt_block(&K, h, n * rowsPerBucket, thisBucketRows);
         }
         global_dpd_->buf4_mat_irrep_close_block(&J, h, rowsPerBucket);
@@ -272,7 +289,13 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
                 else
                     thisBucketRows = (n < nBuckets - 1) ? rowsPerBucket : rowsLeft;
                 global_dpd_->buf4_mat_irrep_rd_block(&J, h, n * rowsPerBucket, thisBucketRows);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
                 for (int pq = 0; pq < thisBucketRows; pq++) {
+                    int thread = 0;
+#ifdef _OPENMP
+                    thread = omp_get_thread_num();
+#endif
+                    double **TMP = TMPs[thread];
                     for (int Gr = 0; Gr < nirreps_; Gr++) {
                         // Transform ( S1 S2 | n n ) -> ( S1 S2 | n s4 )
                         int Gs = h ^ Gr;
@@ -297,7 +320,9 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
                                     &K.matrix[h][pq][rs], ncols);
                         // TODO else if s3->label() == MOSPACE_NIL, copy buffer...
                     } /* Gr */
-                    if (useIWL_) {
+                } /* pq */
+                if (useIWL_) {
+                    for (int pq = 0; pq < thisBucketRows; pq++) {
                         int P = aIndex1[K.params->roworb[h][pq + n * rowsPerBucket][0]];
                         int Q = aIndex2[K.params->roworb[h][pq + n * rowsPerBucket][1]];
                         // dpd is smart enough to index only unique pairs in the bra
@@ -310,8 +335,8 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
                             if ((R < S) && ket_sym) continue;
                             iwl->write_value(P, Q, R, S, K.matrix[h][pq][rs], printTei_, "outfile", 0);
                         } /* rs */
-                    }
-                } /* pq */
+                    } /* pq */
+                }
                 global_dpd_->buf4_mat_irrep_wrt_block(&K, h, n * rowsPerBucket, thisBucketRows);
             }
             global_dpd_->buf4_mat_irrep_close_block(&J, h, rowsPerBucket);
@@ -390,7 +415,13 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
                 else
                     thisBucketRows = (n < nBuckets - 1) ? rowsPerBucket : rowsLeft;
                 global_dpd_->buf4_mat_irrep_rd_block(&J, h, n * rowsPerBucket, thisBucketRows);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
                 for (int pq = 0; pq < thisBucketRows; pq++) {
+                    int thread = 0;
+#ifdef _OPENMP
+                    thread = omp_get_thread_num();
+#endif
+                    double **TMP = TMPs[thread];
                     for (int Gr = 0; Gr < nirreps_; Gr++) {
                         // Transform ( s1 s2 | n n ) -> ( s1 s2 | n s4 )
                         int Gs = h ^ Gr;
@@ -413,7 +444,9 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
                             C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, pc3b[0], nrows, TMP[0], nso_, 0.0,
                                     &K.matrix[h][pq][rs], ncols);
                     } /* Gr */
-                    if (useIWL_) {
+                } /* pq */
+                if (useIWL_) {
+                    for (int pq = 0; pq < thisBucketRows; pq++) {
                         int P = bIndex1[K.params->roworb[h][pq + n * rowsPerBucket][0]];
                         int Q = bIndex2[K.params->roworb[h][pq + n * rowsPerBucket][1]];
                         // dpd is smart enough to index only unique pairs in the bra
@@ -429,8 +462,8 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
                             if ((RS < PQ) && bra_ket_sym) continue;
                             iwl->write_value(P, Q, R, S, K.matrix[h][pq][rs], printTei_, "outfile", 0);
                         } /* rs */
-                    }
-                } /* pq */
+                    } /* pq */
+                }
                 global_dpd_->buf4_mat_irrep_wrt_block(&K, h, n * rowsPerBucket, thisBucketRows);
             }
             global_dpd_->buf4_mat_irrep_close_block(&J, h, rowsPerBucket);
@@ -453,7 +486,7 @@ void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace>
     psio_->close(dpdIntFile_, 1);
     psio_->close(aHtIntFile_, keepHtInts_);
 
-    free_block(TMP);
+    for (int t = 0; t < nthreads; ++t) global_dpd_->free_dpd_block(TMPs[t], sopi_.max(), nso_);
     delete[] label;
 
     if (print_) {
@@ -37,6 +37,9 @@
 #include "psi4/libmints/molecule.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/memory_manager.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/psifiles.h"
 #include "psi4/liboptions/liboptions.h"
 
 #include "occwave.h"
@@ -49,9 +52,11 @@ namespace occwave {
 OCCWave::OCCWave(SharedWavefunction ref_wfn, Options &options) : Wavefunction(options) {
     shallow_copy(ref_wfn);
     reference_wavefunction_ = ref_wfn;
+    dpd_incore_ = false;
+    own_arena_ = false;
 }  //
 
-OCCWave::~OCCWave() {}  //
+OCCWave::~OCCWave() { dpd_incore_done(); }  //
 
 void OCCWave::common_init() {
     // print title and options
@@ -61,6 +66,7 @@ void OCCWave::common_init() {
     module_ = "occ";
     wfn_type_ = options_.get_str("WFN_TYPE");
     orb_opt_ = options_.get_str("ORB_OPT");
+    dpd_incore_type_ = options_.get_str("DPD_INCORE");
     title();
 
     tol_Eod = options_.get_double("E_CONVERGENCE");
@@ -197,6 +203,7 @@ void OCCWave::common_init() {
 
     cutoff = pow(10.0, -exp_cutoff);
     get_moinfo();
+    dpd_incore_init();
 
     if (reference_ == "RESTRICTED") {
         // Memory allocation
@@ -402,6 +409,12 @@ void OCCWave::title() {
 double OCCWave::compute_energy() {
     common_init();
 
+    // Let go of the DPD units, the arena, and its memory grant also when a manager throws
+    struct DPDInCoreGuard {
+        OCCWave *wfn;
+        ~DPDInCoreGuard() { wfn->dpd_incore_done(); }
+    } dpd_incore_guard{this};
+
     // Warnings
     if (nfrzc != 0 && orb_opt_ == "TRUE") {
         mem_release();
@@ -584,8 +597,63 @@ void OCCWave::nbo() {
     diag->print();
 }  // end of nbo
 
+void OCCWave::dpd_incore_init() {
+    dpd_incore_ = false;
+    own_arena_ = false;
+    if (dpd_incore_type_ == "FALSE") return;
+
+    // The integrals over all MO pairs, times three spin cases for UHF, and as much again for the
+    // amplitudes, intermediates, and the half-transformed integrals of libtrans
+    size_t npair2 = 0;
+    for (int h = 0; h < nirrep_; h++) {
+        size_t npair = 0;
+        for (int h1 = 0; h1 < nirrep_; h1++) npair += (size_t)nmopi_[h1] * nmopi_[h1 ^ h];
+        npair2 += npair * npair;
+    }
+    size_t dpd_bytes = 2 * npair2 * sizeof(double) * (reference_ == "RESTRICTED" ? 1 : 3);
+    outfile->Printf("\n\tDPD files are estimated at %6lu MB \n", dpd_bytes / 1000000L);
+
+    if (!PSIO::memory_arena()) {
+        // The arena takes at most half of the memory nobody holds yet, the rest is left to the
+        // in-core arrays of OCC; with TRUE whatever does not fit spills to disk
+        MemoryBroker &broker = MemoryBroker::shared_object();
+        dpd_grant_.reset(new MemoryGrant("OCC DPD files"));
+        broker.request(dpd_grant_->name(), 0, {{dpd_bytes, 1.0}});
+        broker.allocate(broker.available() / 2);
+        size_t budget = broker.granted(dpd_grant_->name());
+        if (budget == 0 || (dpd_incore_type_ == "AUTO" && budget < dpd_bytes)) {
+            dpd_grant_.reset();
+            outfile->Printf("\tKeeping the DPD files on disk..\n");
+            return;
+        }
+        PSIO::set_memory_arena(budget);
+        own_arena_ = true;
+    } else if (dpd_incore_type_ == "AUTO" && PSIO::memory_arena() < dpd_bytes) {
+        outfile->Printf("\tKeeping the DPD files on disk..\n");
+        return;
+    }
+    psio_->set_hold(PSIF_LIBTRANS_DPD, true);
+    psio_->set_hold(PSIF_OCC_DPD, true);
+    psio_->set_hold(PSIF_OCC_DENSITY, true);
+    dpd_incore_ = true;
+    outfile->Printf("\tKeeping the DPD files in core (%lu MB)..\n", PSIO::memory_arena() / 1000000L);
+}
+
+void OCCWave::dpd_incore_done() {
+    if (!dpd_incore_) return;
+    psio_->set_hold(PSIF_LIBTRANS_DPD, false);
+    psio_->set_hold(PSIF_OCC_DPD, false);
+    psio_->set_hold(PSIF_OCC_DENSITY, false);
+    if (print_ > 1) PSIO::print_memory_arena_stats();
+    if (own_arena_) PSIO::set_memory_arena(0);
+    dpd_grant_.reset();
+    dpd_incore_ = false;
+    own_arena_ = false;
+}
+
 void OCCWave::mem_release() {
     delete ints;
+    dpd_incore_done();
     delete[] pitzer2symblk;
     delete[] pitzer2symirrep;
     delete[] PitzerOffset;
@@ -40,6 +40,7 @@ namespace psi {
 
 class DIISManager;
 class IntegralTransform;
+class MemoryGrant;
 
 namespace occwave {
 
@@ -57,6 +58,8 @@ class OCCWave : public Wavefunction {
 
     // General
     void mem_release();
+    void dpd_incore_init();
+    void dpd_incore_done();
     void mograd();
     void compute_orbital_step();
     void update_mo_spincase(SpinType);
@@ -240,6 +243,9 @@ class OCCWave : public Wavefunction {
     size_t memory_mb_;
     size_t cost_iabc_;  // Mem required for the <ia|bc> integrals
     size_t cost_abcd_;  // Mem required for the <ab|cd> integrals
+    bool dpd_incore_;   // DPD units held open in the PSIO memory arena
+    bool own_arena_;    // The arena was set up for this computation
+    std::unique_ptr<MemoryGrant> dpd_grant_;  // MemoryBroker grant of the arena set up here
 
     // Common
     double Enuc;
@@ -370,6 +376,7 @@ class OCCWave : public Wavefunction {
     std::string ekt_ip_;
     std::string ekt_ea_;
     std::string orb_opt_;
+    std::string dpd_incore_type_;
     std::string relaxed_;
     std::string sym_gfm_;
     std::string oeprop_;
@@ -66,7 +66,7 @@ void CCBLAS::cleanup() {
 
 void CCBLAS::free_work() {
     if (work.size()) {
-        wfn_->free_memory_ += sizeof(double) * options_.get_int("CC_NUM_THREADS") * work[0].size();
+        wfn_->free_memory_ += sizeof(double) * work[0].size();
     }
 }
 
@@ -85,16 +85,16 @@ void CCBLAS::allocate_work() {
         sort(dimension.begin(), dimension.end());
         work_size += dimension[2] * dimension[1];
     }
-    // Allocate the temporary work space
+    // Allocate the temporary work space. The threads split the loops of a single operation, so one copy is enough.
     free_work();
-    wfn_->free_memory_ -= sizeof(double) * options_.get_int("CC_NUM_THREADS") * work_size;
-    work = std::vector<std::vector<double>>(options_.get_int("CC_NUM_THREADS"), std::vector<double>(work_size, 0));
+    wfn_->free_memory_ -= sizeof(double) * work_size;
+    work = std::vector<std::vector<double>>(1, std::vector<double>(work_size, 0));
     outfile->Printf("\n  Allocated work array of size %.2f MiB", work_size * sizeof(double) / 1048576.0);
 }
 
 void CCBLAS::free_buffer() {
     if (buffer.size()) {
-        wfn_->free_memory_ += sizeof(double) * options_.get_int("CC_NUM_THREADS") * buffer[0].size();
+        wfn_->free_memory_ += sizeof(double) * buffer[0].size();
     }
 }
 
@@ -105,8 +105,8 @@ void CCBLAS::allocate_buffer() {
                                       static_cast<double>(wfn_->free_memory_) / static_cast<double>(sizeof(double)));
 
     // Allocate the temporary buffer space
-    buffer = std::vector<std::vector<double>>(options_.get_int("CC_NUM_THREADS"), std::vector<double>(buffer_size, 0));
-    wfn_->free_memory_ -= sizeof(double) * options_.get_int("CC_NUM_THREADS") * buffer_size;
+    buffer = std::vector<std::vector<double>>(1, std::vector<double>(buffer_size, 0));
+    wfn_->free_memory_ -= sizeof(double) * buffer_size;
     outfile->Printf("\n  Allocated buffer array of size %.2f MiB", buffer_size * sizeof(double) / 1048576.0);
 }
 
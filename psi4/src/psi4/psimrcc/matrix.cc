@@ -36,6 +36,7 @@
 
 #include "index.h"
 #include "matrix.h"
+#include "psimrcc_wfn.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 namespace psi {
 
@@ -123,7 +124,8 @@ void CCMatrix::add_numerical_factor(double factor) {
 void CCMatrix::add_numerical_factor(double factor, int h) {
     if (block_sizepi[h] > 0) {
         double* matrix_block = &matrix[h][0][0];
-        for (size_t i = 0; i != block_sizepi[h]; ++i) matrix_block[i] += factor;
+#pragma omp parallel for schedule(static) num_threads(wfn_->nthreads_) if (block_sizepi[h] > parallel_min_size)
+        for (size_t i = 0; i < block_sizepi[h]; ++i) matrix_block[i] += factor;
     }
 }
 
@@ -134,7 +136,8 @@ void CCMatrix::scale(double factor) {
 void CCMatrix::scale(double factor, int h) {
     if (block_sizepi[h] > 0) {
         double* matrix_block = &matrix[h][0][0];
-        for (size_t i = 0; i != block_sizepi[h]; ++i) matrix_block[i] *= factor;
+#pragma omp parallel for schedule(static) num_threads(wfn_->nthreads_) if (block_sizepi[h] > parallel_min_size)
+        for (size_t i = 0; i < block_sizepi[h]; ++i) matrix_block[i] *= factor;
     }
 }
 
@@ -214,6 +217,7 @@ void CCMatrix::element_by_element_product(double factor, CCMatrix* B_Matrix, CCM
         double* A_matrix = &(matrix[h][0][0]);
         double* B_matrix = &(B_Matrix->get_matrix()[h][0][0]);
         double* C_matrix = &(C_Matrix->get_matrix()[h][0][0]);
+#pragma omp parallel for schedule(static) num_threads(wfn_->nthreads_) if (block_sizepi[h] > parallel_min_size)
         for (size_t i = 0; i < block_sizepi[h]; i++) A_matrix[i] += factor * B_matrix[i] * C_matrix[i];
     }
 }
@@ -223,6 +227,7 @@ void CCMatrix::element_by_element_division(double factor, CCMatrix* B_Matrix, CC
         double* A_matrix = &(matrix[h][0][0]);
         double* B_matrix = &(B_Matrix->get_matrix()[h][0][0]);
         double* C_matrix = &(C_Matrix->get_matrix()[h][0][0]);
+#pragma omp parallel for schedule(static) num_threads(wfn_->nthreads_) if (block_sizepi[h] > parallel_min_size)
         for (size_t i = 0; i < block_sizepi[h]; i++) A_matrix[i] += factor * B_matrix[i] / C_matrix[i];
     }
 }
@@ -231,6 +236,7 @@ void CCMatrix::element_by_element_addition(double factor, CCMatrix* B_Matrix, in
     if (block_sizepi[h] > 0) {
         double* A_matrix = &(matrix[h][0][0]);
         double* B_matrix = &(B_Matrix->get_matrix()[h][0][0]);
+#pragma omp parallel for schedule(static) num_threads(wfn_->nthreads_) if (block_sizepi[h] > parallel_min_size)
         for (size_t i = 0; i < block_sizepi[h]; i++) A_matrix[i] += factor * B_matrix[i];
     }
 }
@@ -244,19 +250,26 @@ void CCMatrix::tensor_product(std::string& reindexing, double factor, CCMatrix*
     for (int i = 0; i < reindexing.size(); i++) reindexing_array[i] = pairs[i].second;
 
     // This assumes that the reindexing starts from 1 !!! This can cost you an headache
-    auto* pqrs = new short[4];
-    auto* pq = new short[2];
-    auto* rs = new short[2];
+    // Every (pq,rs) pair lands on a different element of this matrix, so the elements of B are split over the threads
     auto B_matrix = B_Matrix->get_matrix();
     auto C_matrix = C_Matrix->get_matrix();
-    double value;
     for (int b_n = 0; b_n < wfn_->moinfo()->get_nirreps(); b_n++) {
         for (int c_n = 0; c_n < wfn_->moinfo()->get_nirreps(); c_n++) {
-            for (int b_i = 0; b_i < B_Matrix->get_left_pairpi(b_n); b_i++) {
-                for (int b_j = 0; b_j < B_Matrix->get_right_pairpi(b_n); b_j++) {
+            int b_rows = B_Matrix->get_left_pairpi(b_n);
+            int b_cols = B_Matrix->get_right_pairpi(b_n);
+            size_t c_size = C_Matrix->get_block_sizepi(c_n);
+#pragma omp parallel for collapse(2) schedule(static) num_threads(wfn_->nthreads_) \
+    if (b_rows * b_cols * c_size > parallel_min_size)
+            for (int b_i = 0; b_i < b_rows; b_i++) {
+                for (int b_j = 0; b_j < b_cols; b_j++) {
+                    short pqrs[4];
+                    short pq_array[2];
+                    short rs_array[2];
+                    short* pq = pq_array;
+                    short* rs = rs_array;
                     for (int c_i = 0; c_i < C_Matrix->get_left_pairpi(c_n); c_i++) {
                         for (int c_j = 0; c_j < C_Matrix->get_right_pairpi(c_n); c_j++) {
-                            value = factor * B_matrix[b_n][b_i][b_j] * C_matrix[c_n][c_i][c_j];
+                            double value = factor * B_matrix[b_n][b_i][b_j] * C_matrix[c_n][c_i][c_j];
                             B_Matrix->get_two_indices(pq, b_n, b_i, b_j);
                             C_Matrix->get_two_indices(rs, c_n, c_i, c_j);
                             pqrs[0] = pq[0];
@@ -271,9 +284,6 @@ void CCMatrix::tensor_product(std::string& reindexing, double factor, CCMatrix*
             }
         }
     }
-    delete[] pqrs;
-    delete[] pq;
-    delete[] rs;
     delete[] reindexing_array;
 }
 
@@ -281,9 +291,10 @@ double CCMatrix::dot_product(CCMatrix* B_Matrix, CCMatrix* C_Matrix, int h) {
     double value = 0.0;
     size_t block_size = B_Matrix->get_block_sizepi(h);
     if (block_size > 0) {
-        size_t i;
         double* B_matrix = &(B_Matrix->get_matrix()[h][0][0]);
         double* C_matrix = &(C_Matrix->get_matrix()[h][0][0]);
+#pragma omp parallel for schedule(static) reduction(+ : value) num_threads(B_Matrix->wfn_->nthreads_) \
+    if (block_size > parallel_min_size)
         for (size_t i = 0; i < block_size; i++) value += B_matrix[i] * C_matrix[i];
     }
     return (value);
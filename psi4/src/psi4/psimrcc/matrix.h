@@ -209,6 +209,8 @@ class CCMatrix {
     std::shared_ptr<PSIMRCCWfn> wfn_;  // The wavefunction
    public:
     static double fraction_of_memory_for_buffer;
+    // Loops over blocks smaller than this are not worth splitting over the threads
+    static constexpr size_t parallel_min_size = 16384;
 };
 
 }  // namespace psimrcc
@@ -35,6 +35,7 @@
 #include "blas.h"
 #include "index.h"
 #include "matrix.h"
+#include "psimrcc_wfn.h"
 
 namespace psi {
 
@@ -86,19 +87,24 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
     // This routine performs the reindexing of CCMatrix objects
     // for matrices that have the same number of elements or
     // when size(A) < size(T)
+    // Every row of A is gathered from T on its own, so the rows are split over the threads
+
+    int nthread = wfn_->nthreads_;
+    size_t min_size = CCMatrix::parallel_min_size;
 
     if (assignment == "=" || assignment == "+=") {
         if (reindexing.size() == 2) {
-            int b_irrep;
-            size_t b_left, b_right;
-            auto* pq = new short[2];
             // A[x][x] <- T[x][x]
             if ((A_left_nelements == 1) && (T_left_nelements == 1)) {
                 auto& T_left_one_index_to_irrep = T_left->get_one_index_to_irrep();
                 auto& T_left_one_index_to_tuple = T_left->get_one_index_to_tuple_rel_index();
                 auto& T_right_one_index_to_tuple = T_right->get_one_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
+                        short pq[2];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pq[0] = A_left_tuples[i + A_left_first[n]][0];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
                             // Get the pqrs indices
@@ -116,7 +122,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_left_two_index_to_irrep = T_left->get_two_index_to_irrep();
                 auto& T_left_two_index_to_tuple = T_left->get_two_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
+                        short pq[2];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pq[0] = A_left_tuples[i + A_left_first[n]][0];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
                             // Get the pqrs indices
@@ -134,7 +144,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_left_one_index_to_tuple = T_left->get_one_index_to_tuple_rel_index();
                 auto& T_right_one_index_to_tuple = T_right->get_one_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
+                        short pq[2];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pq[0] = A_left_tuples[i + A_left_first[n]][0];
                         pq[1] = A_left_tuples[i + A_left_first[n]][1];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
@@ -151,7 +165,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_left_two_index_to_irrep = T_left->get_two_index_to_irrep();
                 auto& T_left_two_index_to_tuple = T_left->get_two_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
+                        short pq[2];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pq[0] = A_left_tuples[i + A_left_first[n]][0];
                         pq[1] = A_left_tuples[i + A_left_first[n]][1];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
@@ -162,19 +180,18 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                     }
                 }
             }
-            delete[] pq;
         } else if (reindexing.size() == 4) {
-            int b_irrep;
-            size_t b_left, b_right;
-            auto* pqrs = new short[4];
             // A[x][xxx] <- B[x][xxx]
             if ((A_left_nelements == 1) && (T_left_nelements == 1)) {
                 auto& T_left_one_index_to_irrep = T_left->get_one_index_to_irrep();
                 auto& T_left_one_index_to_tuple = T_left->get_one_index_to_tuple_rel_index();
                 auto& T_right_three_index_to_tuple = T_right->get_three_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
-                        // Check that this should be handled by this thread
+                        short pqrs[4];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pqrs[0] = A_left_tuples[i + A_left_first[n]][0];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
                             // Get the pqrs indices
@@ -196,8 +213,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_left_one_index_to_tuple = T_left->get_one_index_to_tuple_rel_index();
                 auto& T_right_three_index_to_tuple = T_right->get_three_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
-                        // Check that this should be handled by this thread
+                        short pqrs[4];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pqrs[0] = A_left_tuples[i + A_left_first[n]][0];
                         pqrs[1] = A_left_tuples[i + A_left_first[n]][1];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
@@ -220,8 +240,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_left_one_index_to_tuple = T_left->get_one_index_to_tuple_rel_index();
                 auto& T_right_three_index_to_tuple = T_right->get_three_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
-                        // Check that this should be handled by this thread
+                        short pqrs[4];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pqrs[0] = A_left_tuples[i + A_left_first[n]][0];
                         pqrs[1] = A_left_tuples[i + A_left_first[n]][1];
                         pqrs[2] = A_left_tuples[i + A_left_first[n]][2];
@@ -244,8 +267,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_left_two_index_to_tuple = T_left->get_two_index_to_tuple_rel_index();
                 auto& T_right_two_index_to_tuple = T_right->get_two_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
-                        // Check that this should be handled by this thread
+                        short pqrs[4];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pqrs[0] = A_left_tuples[i + A_left_first[n]][0];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
                             // Get the pqrs indices
@@ -267,8 +293,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_left_two_index_to_tuple = T_left->get_two_index_to_tuple_rel_index();
                 auto& T_right_two_index_to_tuple = T_right->get_two_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
-                        // Check that this should be handled by this thread
+                        short pqrs[4];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pqrs[0] = A_left_tuples[i + A_left_first[n]][0];
                         pqrs[1] = A_left_tuples[i + A_left_first[n]][1];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
@@ -290,8 +319,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_left_two_index_to_tuple = T_left->get_two_index_to_tuple_rel_index();
                 auto& T_right_two_index_to_tuple = T_right->get_two_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
-                        // Check that this should be handled by this thread
+                        short pqrs[4];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pqrs[0] = A_left_tuples[i + A_left_first[n]][0];
                         pqrs[1] = A_left_tuples[i + A_left_first[n]][1];
                         pqrs[2] = A_left_tuples[i + A_left_first[n]][2];
@@ -313,8 +345,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_right_one_index_to_irrep = T_right->get_one_index_to_irrep();
                 auto& T_right_one_index_to_tuple = T_right->get_one_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
-                        // Check that this should be handled by this thread
+                        short pqrs[4];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pqrs[0] = A_left_tuples[i + A_left_first[n]][0];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
                             // Get the pqrs indices
@@ -337,8 +372,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_right_one_index_to_irrep = T_right->get_one_index_to_irrep();
                 auto& T_right_one_index_to_tuple = T_right->get_one_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
-                        // Check that this should be handled by this thread
+                        short pqrs[4];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pqrs[0] = A_left_tuples[i + A_left_first[n]][0];
                         pqrs[1] = A_left_tuples[i + A_left_first[n]][1];
                         for (size_t j = 0; j < A_right_pairpi[n]; j++) {
@@ -361,8 +399,11 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                 auto& T_right_one_index_to_irrep = T_right->get_one_index_to_irrep();
                 auto& T_right_one_index_to_tuple = T_right->get_one_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
-                        // Check that this should be handled by this thread
+                        short pqrs[4];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         pqrs[0] = A_left_tuples[i + A_left_first[n]][0];
                         pqrs[1] = A_left_tuples[i + A_left_first[n]][1];
                         pqrs[2] = A_left_tuples[i + A_left_first[n]][2];
@@ -378,19 +419,19 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                     }
                 }
             }
-            delete[] pqrs;
         } else if (reindexing.size() == 6) {
             // This is a fast 6-index sorting algorithm used by the active-space computations
-            int b_irrep;
-            size_t b_left, b_right;
-            auto* pqrstu = new short[6];
             // A[xxx][xxx] <- T[xxx][xxx]
             if ((A_left_nelements == 3) && (T_left_nelements == 3)) {
                 auto& T_left_three_index_to_irrep = T_left->get_three_index_to_irrep();
                 auto& T_left_three_index_to_tuple = T_left->get_three_index_to_tuple_rel_index();
                 auto& T_right_three_index_to_tuple = T_right->get_three_index_to_tuple_rel_index();
                 for (int n = 0; n < wfn_->nirrep(); n++) {
+#pragma omp parallel for schedule(static) num_threads(nthread) if (A_Matrix->get_block_sizepi(n) > min_size)
                     for (size_t i = 0; i < A_left_pairpi[n]; i++) {
+                        short pqrstu[6];
+                        int b_irrep;
+                        size_t b_left, b_right;
                         // Get the pqr indices
                         pqrstu[0] = A_left_tuples[i + A_left_first[n]][0];
                         pqrstu[1] = A_left_tuples[i + A_left_first[n]][1];
@@ -417,7 +458,6 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
                     }
                 }
             }
-            delete[] pqrstu;
         }
     }
 
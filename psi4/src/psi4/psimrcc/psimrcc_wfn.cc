@@ -52,6 +52,9 @@ PSIMRCCWfn::PSIMRCCWfn(SharedWavefunction ref_wfn, Options &options) : Wavefunct
     moinfo_->setup_model_space();
     memory_ = Process::environment.get_memory();
     free_memory_ = memory_;
+    nthreads_ = Process::environment.get_n_threads();
+    if (options["CC_NUM_THREADS"].has_changed()) nthreads_ = options.get_int("CC_NUM_THREADS");
+    if (nthreads_ < 1) nthreads_ = 1;
 }
 
 void PSIMRCCWfn::active_space_warning() const {
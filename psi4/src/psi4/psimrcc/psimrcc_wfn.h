@@ -53,6 +53,8 @@ class PSIMRCCWfn : public Wavefunction {
     const std::shared_ptr<CCBLAS> blas() const { return blas_; }
     // Estimate the free memory.
     size_t free_memory_;
+    // Threads used by the CCBLAS kernels
+    int nthreads_;
 
    protected:
     // Class members
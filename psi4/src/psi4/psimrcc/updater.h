@@ -64,6 +64,10 @@ class MkUpdater : public Updater {
     MkUpdater(std::shared_ptr<PSIMRCCWfn> wfn, Options &options);
     ~MkUpdater() override;
     void update(int cycle, Hamiltonian *heff) override;
+
+   private:
+    double coupling_term(Hamiltonian *heff, int unique_i, int j, double omega);
+    void build_mk2(int unique_nu);
 };
 
 class BWUpdater : public Updater {
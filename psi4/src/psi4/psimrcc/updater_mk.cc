@@ -114,19 +114,20 @@ void MkUpdater::update(int cycle, Hamiltonian *heff) {
         wfn_->blas()->scale("t2_eqns[OO][VV]", mu_unique, c_mu);
     }
 
+    bool coupling = options_.get_bool("COUPLING_TERMS");
+    bool have_mk2 = false;
     for (int i = 0; i < wfn_->moinfo()->get_nunique(); i++) {
         int unique_i = wfn_->moinfo()->get_ref_number(i, UniqueRefs);
         std::string i_str = to_string(unique_i);
         // Form the coupling terms
-        if (options_.get_bool("COUPLING_TERMS")) {
+        if (coupling) {
             for (int j = 0; j < wfn_->moinfo()->get_nrefs(); j++) {
                 int unique_j = wfn_->moinfo()->get_ref_number(j);
                 std::string j_str = to_string(unique_j);
 
                 //        double term = heff->get_right_eigenvector(j);
 
-                double term = heff->get_right_eigenvector(j) * std::pow(heff->get_right_eigenvector(unique_i), 2.0) /
-                              (std::pow(heff->get_right_eigenvector(unique_i), 2.0) + std::pow(omega, 2.0));
+                double term = coupling_term(heff, unique_i, j, omega);
 
                 //        double term = heff->get_right_eigenvector(j) * heff->get_right_eigenvector(unique_i) /
                 //                      (std::pow(heff->get_right_eigenvector(unique_i),2.0) + std::pow(omega,2.0));
@@ -165,188 +166,82 @@ void MkUpdater::update(int cycle, Hamiltonian *heff) {
         }
         zero_internal_amps();
 
-        if (options_.get_bool("COUPLING_TERMS")) {
-            // Add the contribution from the other references
+        if (coupling) {
+            // The amplitudes of reference i just changed, the others still hold their cached Mk2
+            if (!have_mk2) {
+                for (int u = 0; u < wfn_->moinfo()->get_nunique(); u++)
+                    build_mk2(wfn_->moinfo()->get_ref_number(u, UniqueRefs));
+                have_mk2 = true;
+            } else {
+                build_mk2(unique_i);
+            }
+
+            // Add the contribution from the other references. With Mk2{nu} = t2(nu) + P(ij) t1(nu) t1(nu),
+            //   sum_nu f_nu [Mk2{nu} - P(ij)P(ab) t1(mu) t1(nu) + P(ij) t1(mu) t1(mu)]
+            //   = sum_nu f_nu Mk2{nu} - P(ij)P(ab) t1(mu) Mk1
+            // where Mk1 = sum_nu f_nu t1(nu) - F/2 t1(mu) and F = sum_nu f_nu
+            double F = 0.0;
+            for (int j = 0; j < wfn_->moinfo()->get_nrefs(); j++) {
+                if (unique_i != j) F += heff->get_matrix(unique_i, j) * coupling_term(heff, unique_i, j, omega);
+            }
+            wfn_->blas()->set_scalar("factor_mk", unique_i, -0.5 * F);
+            wfn_->blas()->solve("Mk1[o][v]{" + i_str + "} = factor_mk{" + i_str + "} t1[o][v]{" + i_str + "}");
+            wfn_->blas()->solve("Mk1[O][V]{" + i_str + "} = factor_mk{" + i_str + "} t1[O][V]{" + i_str + "}");
+
             for (int j = 0; j < wfn_->moinfo()->get_nrefs(); j++) {
                 int unique_j = wfn_->moinfo()->get_ref_number(j);
                 std::string j_str = to_string(unique_j);
+                if (unique_i == j) continue;
 
-                //        double term = heff->get_right_eigenvector(j);
-
-                double term = heff->get_right_eigenvector(j) * std::pow(heff->get_right_eigenvector(unique_i), 2.0) /
-                              (std::pow(heff->get_right_eigenvector(unique_i), 2.0) + std::pow(omega, 2.0));
-
-                //        double term = heff->get_right_eigenvector(j) * heff->get_right_eigenvector(unique_i) /
-                //                      (std::pow(heff->get_right_eigenvector(unique_i),2.0) + std::pow(omega,2.0));
-                //
-                //        if(std::fabs(term) > 100.0) {
-                //          outfile->Printf("\n  Warning: c_nu/c_mu = %e ."
-                //              "\n  1) turn on Tikhonow regularization or increase omega (TIKHONOW_OMEGA > 0)",term);
-                //        }
-
+                double term = coupling_term(heff, unique_i, j, omega);
                 wfn_->blas()->set_scalar("factor_mk", unique_j, heff->get_matrix(unique_i, j) * term);
-                if (unique_i != j) {
-                    if (j == unique_j) {
-                        // aaaa case
-                        // + t_ij^ab(nu/mu)
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "}  = t2[oo][vv]{" + j_str + "}");
-
-                        // P(ij)t_i^a(nu/mu)t_j^b(nu/mu)
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #1324#   t1[o][v]{" + j_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #2314# - t1[o][v]{" + j_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-
-                        // -P(ij)P(ab)t_i^a(mu)t_j^b(nu/mu)
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #1324# - t1[o][v]{" + i_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #2314#   t1[o][v]{" + i_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #1423#   t1[o][v]{" + i_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #2413# - t1[o][v]{" + i_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-
-                        // P(ij)t_i^a(mu)t_j^b(mu)
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #1324#   t1[o][v]{" + i_str +
-                                            "} X t1[o][v]{" + i_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #2314# - t1[o][v]{" + i_str +
-                                            "} X t1[o][v]{" + i_str + "}");
-
-                        wfn_->blas()->solve("t2_eqns[oo][vv]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[oo][vv]{" +
-                                            i_str + "}");
-
-                        // abab case
-                        // + t_ij^ab(nu/mu)
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "}  = t2[oO][vV]{" + j_str + "}");
-
-                        // P(ij)t_i^a(nu/mu)t_J^B(nu/mu)
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "} += #1324#   t1[o][v]{" + j_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-
-                        // -P(iJ)P(aB)t_i^a(mu)t_J^B(nu/mu)
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "} += #1324# - t1[o][v]{" + i_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "} += #1324# - t1[o][v]{" + j_str +
-                                            "} X t1[O][V]{" + i_str + "}");
-
-                        // P(iJ)t_i^a(mu)t_J^B(mu)
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "} += #1324#   t1[o][v]{" + i_str +
-                                            "} X t1[O][V]{" + i_str + "}");
-
-                        wfn_->blas()->solve("t2_eqns[oO][vV]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[oO][vV]{" +
-                                            i_str + "}");
-
-                        // bbbb case
-                        // + t_ij^ab(nu/mu)
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "}  = t2[OO][VV]{" + j_str + "}");
-
-                        // P(ij)t_i^a(nu/mu)t_j^b(nu/mu)
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #1324#   t1[O][V]{" + j_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #2314# - t1[O][V]{" + j_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-
-                        // -P(ij)P(ab)t_i^a(mu)t_j^b(nu/mu)
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #1324# - t1[O][V]{" + i_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #2314#   t1[O][V]{" + i_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #1423#   t1[O][V]{" + i_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #2413# - t1[O][V]{" + i_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-
-                        // P(ij)t_i^a(mu)t_j^b(mu)
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #1324#   t1[O][V]{" + i_str +
-                                            "} X t1[O][V]{" + i_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #2314# - t1[O][V]{" + i_str +
-                                            "} X t1[O][V]{" + i_str + "}");
-
-                        wfn_->blas()->solve("t2_eqns[OO][VV]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[OO][VV]{" +
-                                            i_str + "}");
-                    } else {
-                        // aaaa case
-                        // + t_ij^ab(nu/mu)
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "}  = t2[OO][VV]{" + j_str + "}");
-
-                        // P(ij)t_i^a(nu/mu)t_j^b(nu/mu)
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #1324#   t1[O][V]{" + j_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #2314# - t1[O][V]{" + j_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-
-                        // -P(ij)P(ab)t_i^a(mu)t_j^b(nu/mu)
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #1324# - t1[o][v]{" + i_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #2314#   t1[o][v]{" + i_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #1423#   t1[o][v]{" + i_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #2413# - t1[o][v]{" + i_str +
-                                            "} X t1[O][V]{" + j_str + "}");
-
-                        // P(ij)t_i^a(mu)t_j^b(mu)
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #1324#   t1[o][v]{" + i_str +
-                                            "} X t1[o][v]{" + i_str + "}");
-                        wfn_->blas()->solve("Mk2[oo][vv]{" + i_str + "} += #2314# - t1[o][v]{" + i_str +
-                                            "} X t1[o][v]{" + i_str + "}");
-
-                        wfn_->blas()->solve("t2_eqns[oo][vv]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[oo][vv]{" +
-                                            i_str + "}");
-
-                        // abab case
-                        // + t_ij^ab(nu/mu)
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "}  = #2143# t2[oO][vV]{" + j_str + "}");
-
-                        // P(ij)t_i^a(nu/mu)t_J^B(nu/mu)
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "} += #1324#   t1[O][V]{" + j_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-
-                        // -P(iJ)P(aB)t_i^a(mu)t_J^B(nu/mu)
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "} += #1324# - t1[o][v]{" + i_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "} += #1324# - t1[O][V]{" + j_str +
-                                            "} X t1[O][V]{" + i_str + "}");
-
-                        // P(iJ)t_i^a(mu)t_J^B(mu)
-                        wfn_->blas()->solve("Mk2[oO][vV]{" + i_str + "} += #1324#   t1[o][v]{" + i_str +
-                                            "} X t1[O][V]{" + i_str + "}");
-
-                        wfn_->blas()->solve("t2_eqns[oO][vV]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[oO][vV]{" +
-                                            i_str + "}");
-
-                        // bbbb case
-                        // + t_ij^ab(nu/mu)
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "}  = t2[oo][vv]{" + j_str + "}");
-
-                        // P(ij)t_i^a(nu/mu)t_j^b(nu/mu)
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #1324#   t1[o][v]{" + j_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #2314# - t1[o][v]{" + j_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-
-                        // -P(ij)P(ab)t_i^a(mu)t_j^b(nu/mu)
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #1324# - t1[O][V]{" + i_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #2314#   t1[O][V]{" + i_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #1423#   t1[O][V]{" + i_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #2413# - t1[O][V]{" + i_str +
-                                            "} X t1[o][v]{" + j_str + "}");
-
-                        // P(ij)t_i^a(mu)t_j^b(mu)
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #1324#   t1[O][V]{" + i_str +
-                                            "} X t1[O][V]{" + i_str + "}");
-                        wfn_->blas()->solve("Mk2[OO][VV]{" + i_str + "} += #2314# - t1[O][V]{" + i_str +
-                                            "} X t1[O][V]{" + i_str + "}");
-
-                        wfn_->blas()->solve("t2_eqns[OO][VV]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[OO][VV]{" +
-                                            i_str + "}");
-                    }
+                if (j == unique_j) {
+                    wfn_->blas()->solve("Mk1[o][v]{" + i_str + "} += factor_mk{" + j_str + "} t1[o][v]{" + j_str + "}");
+                    wfn_->blas()->solve("Mk1[O][V]{" + i_str + "} += factor_mk{" + j_str + "} t1[O][V]{" + j_str + "}");
+                    wfn_->blas()->solve("t2_eqns[oo][vv]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[oo][vv]{" +
+                                        j_str + "}");
+                    wfn_->blas()->solve("t2_eqns[oO][vV]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[oO][vV]{" +
+                                        j_str + "}");
+                    wfn_->blas()->solve("t2_eqns[OO][VV]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[OO][VV]{" +
+                                        j_str + "}");
+                } else {
+                    // Spin-flipped reference: exchange the alpha and beta labels of nu
+                    wfn_->blas()->solve("Mk1[o][v]{" + i_str + "} += factor_mk{" + j_str + "} t1[O][V]{" + j_str + "}");
+                    wfn_->blas()->solve("Mk1[O][V]{" + i_str + "} += factor_mk{" + j_str + "} t1[o][v]{" + j_str + "}");
+                    wfn_->blas()->solve("t2_eqns[oo][vv]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[OO][VV]{" +
+                                        j_str + "}");
+                    wfn_->blas()->solve("t2_eqns[oO][vV]{" + i_str + "} += #2143# factor_mk{" + j_str +
+                                        "} Mk2[oO][vV]{" + j_str + "}");
+                    wfn_->blas()->solve("t2_eqns[OO][VV]{" + i_str + "} += factor_mk{" + j_str + "} Mk2[oo][vv]{" +
+                                        j_str + "}");
                 }
             }
+
+            // aaaa case, -P(ij)P(ab)t_i^a(mu)Mk1_j^b
+            wfn_->blas()->solve("t2_eqns[oo][vv]{" + i_str + "} += #1324# - t1[o][v]{" + i_str + "} X Mk1[o][v]{" +
+                                i_str + "}");
+            wfn_->blas()->solve("t2_eqns[oo][vv]{" + i_str + "} += #2314#   t1[o][v]{" + i_str + "} X Mk1[o][v]{" +
+                                i_str + "}");
+            wfn_->blas()->solve("t2_eqns[oo][vv]{" + i_str + "} += #1423#   t1[o][v]{" + i_str + "} X Mk1[o][v]{" +
+                                i_str + "}");
+            wfn_->blas()->solve("t2_eqns[oo][vv]{" + i_str + "} += #2413# - t1[o][v]{" + i_str + "} X Mk1[o][v]{" +
+                                i_str + "}");
+
+            // abab case, -t_i^a(mu)Mk1_J^B - Mk1_i^a t_J^B(mu)
+            wfn_->blas()->solve("t2_eqns[oO][vV]{" + i_str + "} += #1324# - t1[o][v]{" + i_str + "} X Mk1[O][V]{" +
+                                i_str + "}");
+            wfn_->blas()->solve("t2_eqns[oO][vV]{" + i_str + "} += #1324# - Mk1[o][v]{" + i_str + "} X t1[O][V]{" +
+                                i_str + "}");
+
+            // bbbb case, -P(ij)P(ab)t_i^a(mu)Mk1_j^b
+            wfn_->blas()->solve("t2_eqns[OO][VV]{" + i_str + "} += #1324# - t1[O][V]{" + i_str + "} X Mk1[O][V]{" +
+                                i_str + "}");
+            wfn_->blas()->solve("t2_eqns[OO][VV]{" + i_str + "} += #2314#   t1[O][V]{" + i_str + "} X Mk1[O][V]{" +
+                                i_str + "}");
+            wfn_->blas()->solve("t2_eqns[OO][VV]{" + i_str + "} += #1423#   t1[O][V]{" + i_str + "} X Mk1[O][V]{" +
+                                i_str + "}");
+            wfn_->blas()->solve("t2_eqns[OO][VV]{" + i_str + "} += #2413# - t1[O][V]{" + i_str + "} X Mk1[O][V]{" +
+                                i_str + "}");
         }
         wfn_->blas()->solve("t2_delta[oo][vv]{" + i_str + "} = t2_eqns[oo][vv]{" + i_str + "} / d'2[oo][vv]{" + i_str +
                             "} - t2[oo][vv]{" + i_str + "}");
@@ -370,8 +265,39 @@ void MkUpdater::update(int cycle, Hamiltonian *heff) {
         wfn_->blas()->solve("t2_old[oo][vv]{" + i_str + "} = t2[oo][vv]{" + i_str + "}");
         wfn_->blas()->solve("t2_old[oO][vV]{" + i_str + "} = t2[oO][vV]{" + i_str + "}");
         wfn_->blas()->solve("t2_old[OO][VV]{" + i_str + "} = t2[OO][VV]{" + i_str + "}");
+        if (coupling) build_mk2(unique_i);
     }
 }
 
+/**
+ * Weight of reference j in the coupling terms of reference i, c_j c_i^2 / (c_i^2 + omega^2)
+ */
+double MkUpdater::coupling_term(Hamiltonian *heff, int unique_i, int j, double omega) {
+    double c_i2 = std::pow(heff->get_right_eigenvector(unique_i), 2.0);
+    return heff->get_right_eigenvector(j) * c_i2 / (c_i2 + std::pow(omega, 2.0));
+}
+
+/**
+ * Store the parts of the coupling terms that depend only on reference nu,
+ * Mk2{nu} = t_ij^ab(nu) + P(ij)t_i^a(nu)t_j^b(nu)
+ */
+void MkUpdater::build_mk2(int unique_nu) {
+    std::string nu_str = to_string(unique_nu);
+
+    // aaaa case
+    wfn_->blas()->solve("Mk2[oo][vv]{" + nu_str + "}  = t2[oo][vv]{" + nu_str + "}");
+    wfn_->blas()->solve("Mk2[oo][vv]{" + nu_str + "} += #1324#   t1[o][v]{" + nu_str + "} X t1[o][v]{" + nu_str + "}");
+    wfn_->blas()->solve("Mk2[oo][vv]{" + nu_str + "} += #2314# - t1[o][v]{" + nu_str + "} X t1[o][v]{" + nu_str + "}");
+
+    // abab case
+    wfn_->blas()->solve("Mk2[oO][vV]{" + nu_str + "}  = t2[oO][vV]{" + nu_str + "}");
+    wfn_->blas()->solve("Mk2[oO][vV]{" + nu_str + "} += #1324#   t1[o][v]{" + nu_str + "} X t1[O][V]{" + nu_str + "}");
+
+    // bbbb case
+    wfn_->blas()->solve("Mk2[OO][VV]{" + nu_str + "}  = t2[OO][VV]{" + nu_str + "}");
+    wfn_->blas()->solve("Mk2[OO][VV]{" + nu_str + "} += #1324#   t1[O][V]{" + nu_str + "} X t1[O][V]{" + nu_str + "}");
+    wfn_->blas()->solve("Mk2[OO][VV]{" + nu_str + "} += #2314# - t1[O][V]{" + nu_str + "} X t1[O][V]{" + nu_str + "}");
+}
+
 }  // namespace psimrcc
 }  // namespace psi
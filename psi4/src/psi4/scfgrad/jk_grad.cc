@@ -44,6 +44,10 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libfock/jk.h"
+#include "psi4/libfock/cubature.h"
+#include "psi4/libfock/points.h"
+#include "psi4/libmints/potential.h"
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -83,6 +87,22 @@ std::shared_ptr<JKGrad> JKGrad::build_JKGrad(int deriv, std::shared_ptr<MintsHel
     if (options.get_str("SCF_TYPE").find("DF") != std::string::npos) {
         DFJKGrad* jk = new DFJKGrad(deriv, mints);
 
+        if (options["INTS_TOLERANCE"].has_changed())
+            jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed())
+            jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed())
+            jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed())
+            jk->set_bench(options.get_int("BENCH"));
+        jk->set_condition(options.get_double("DF_FITTING_CONDITION"));
+        if (options["DF_INTS_NUM_THREADS"].has_changed())
+            jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+
+        return std::shared_ptr<JKGrad>(jk);
+    } else if (options.get_str("SCF_TYPE") == "COSX") {
+        COSXJKGrad* jk = new COSXJKGrad(deriv, mints);
+
         if (options["INTS_TOLERANCE"].has_changed())
             jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
         if (options["PRINT"].has_changed())
@@ -1068,29 +1088,26 @@ void DFJKGrad::build_Amn_x_terms() {
             int M = shell_pairs[MN].first;
             int N = shell_pairs[MN].second;
 
-            eri[thread]->compute_shell_deriv1(P, 0, M, N);
-
-            const double* buffer = eri[thread]->buffer();
-
             int nP = auxiliary_->shell(P).nfunction();
-            int cP = auxiliary_->shell(P).ncartesian();
             int aP = auxiliary_->shell(P).ncenter();
             int oP = auxiliary_->shell(P).function_index() - pstart;
 
             int nM = primary_->shell(M).nfunction();
-            int cM = primary_->shell(M).ncartesian();
             int aM = primary_->shell(M).ncenter();
             int oM = primary_->shell(M).function_index();
 
             int nN = primary_->shell(N).nfunction();
-            int cN = primary_->shell(N).ncartesian();
             int aN = primary_->shell(N).ncenter();
             int oN = primary_->shell(N).function_index();
 
+            // By translational invariance a triplet on a single atom has no net gradient
+            if (aP == aM && aM == aN) continue;
+
+            eri[thread]->compute_shell_deriv1(P, 0, M, N);
+
+            // Only the M and N derivatives are contracted, P = -(M + N) by translational invariance,
+            // and the sums are kept in registers until the triplet is done
             const auto& buffers = eri[thread]->buffers();
-            const double* Px = buffers[0];
-            const double* Py = buffers[1];
-            const double* Pz = buffers[2];
             const double* Mx = buffers[3];
             const double* My = buffers[4];
             const double* Mz = buffers[5];
@@ -1100,74 +1117,45 @@ void DFJKGrad::build_Amn_x_terms() {
 
             double perm = (M == N ? 1.0 : 2.0);
 
-            double** grad_Jp;
-            double** grad_Kp;
-            double** grad_wKp;
+            double J[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            double K[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            double wK[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
 
-            if (do_J_) {
-                grad_Jp = Jtemps[thread]->pointer();
-            }
-            if (do_K_) {
-                grad_Kp = Ktemps[thread]->pointer();
-            }
-            if (do_wK_) {
-                grad_wKp = wKtemps[thread]->pointer();
-            }
-
-            for (int p = 0; p < nP; p++) {
+            for (int p = 0, delta = 0; p < nP; p++) {
                 for (int m = 0; m < nM; m++) {
-                    for (int n = 0; n < nN; n++) {
+                    for (int n = 0; n < nN; n++, delta++) {
                         //  J^x = (A|pq)^x d_A Dt_pq
                         if (do_J_) {
                             double Ival = 1.0 * perm * dp[p + oP + pstart] * Dtp[m + oM][n + oN];
-                            grad_Jp[aP][0] += Ival * (*Px);
-                            grad_Jp[aP][1] += Ival * (*Py);
-                            grad_Jp[aP][2] += Ival * (*Pz);
-                            grad_Jp[aM][0] += Ival * (*Mx);
-                            grad_Jp[aM][1] += Ival * (*My);
-                            grad_Jp[aM][2] += Ival * (*Mz);
-                            grad_Jp[aN][0] += Ival * (*Nx);
-                            grad_Jp[aN][1] += Ival * (*Ny);
-                            grad_Jp[aN][2] += Ival * (*Nz);
+                            J[0] += Ival * Mx[delta];
+                            J[1] += Ival * My[delta];
+                            J[2] += Ival * Mz[delta];
+                            J[3] += Ival * Nx[delta];
+                            J[4] += Ival * Ny[delta];
+                            J[5] += Ival * Nz[delta];
                         }
 
                         //  K^x = (A|pq)^x (A|pq)
                         if (do_K_) {
                             double Kval = 1.0 * perm * Kmnp[p + oP][(m + oM) * nso + (n + oN)];
-                            grad_Kp[aP][0] += Kval * (*Px);
-                            grad_Kp[aP][1] += Kval * (*Py);
-                            grad_Kp[aP][2] += Kval * (*Pz);
-                            grad_Kp[aM][0] += Kval * (*Mx);
-                            grad_Kp[aM][1] += Kval * (*My);
-                            grad_Kp[aM][2] += Kval * (*Mz);
-                            grad_Kp[aN][0] += Kval * (*Nx);
-                            grad_Kp[aN][1] += Kval * (*Ny);
-                            grad_Kp[aN][2] += Kval * (*Nz);
+                            K[0] += Kval * Mx[delta];
+                            K[1] += Kval * My[delta];
+                            K[2] += Kval * Mz[delta];
+                            K[3] += Kval * Nx[delta];
+                            K[4] += Kval * Ny[delta];
+                            K[5] += Kval * Nz[delta];
                         }
 
                         // wK^x = 0.5 * (A|pq)^x (A|w|pq)
                         if (do_wK_) {
                             double wKval = 0.5 * perm * wKmnp[p + oP][(m + oM) * nso + (n + oN)];
-                            grad_wKp[aP][0] += wKval * (*Px);
-                            grad_wKp[aP][1] += wKval * (*Py);
-                            grad_wKp[aP][2] += wKval * (*Pz);
-                            grad_wKp[aM][0] += wKval * (*Mx);
-                            grad_wKp[aM][1] += wKval * (*My);
-                            grad_wKp[aM][2] += wKval * (*Mz);
-                            grad_wKp[aN][0] += wKval * (*Nx);
-                            grad_wKp[aN][1] += wKval * (*Ny);
-                            grad_wKp[aN][2] += wKval * (*Nz);
+                            wK[0] += wKval * Mx[delta];
+                            wK[1] += wKval * My[delta];
+                            wK[2] += wKval * Mz[delta];
+                            wK[3] += wKval * Nx[delta];
+                            wK[4] += wKval * Ny[delta];
+                            wK[5] += wKval * Nz[delta];
                         }
-
-                        Px++;
-                        Py++;
-                        Pz++;
-                        Mx++;
-                        My++;
-                        Mz++;
-                        Nx++;
-                        Ny++;
-                        Nz++;
                     }
                 }
             }
@@ -1175,45 +1163,40 @@ void DFJKGrad::build_Amn_x_terms() {
             //  wK^x = 0.5 * (A|w|pq)^x (A|pq)
             if (do_wK_) {
                 omega_eri[thread]->compute_shell_deriv1(P, 0, M, N);
-                const double* buffer = omega_eri[thread]->buffer();
-
-                const auto buffers = omega_eri[thread]->buffers();
-                const double* Px = buffers[0];
-                const double* Py = buffers[1];
-                const double* Pz = buffers[2];
-                const double* Mx = buffers[3];
-                const double* My = buffers[4];
-                const double* Mz = buffers[5];
-                const double* Nx = buffers[6];
-                const double* Ny = buffers[7];
-                const double* Nz = buffers[8];
-
-                for (int p = 0; p < nP; p++) {
+
+                const auto& wbuffers = omega_eri[thread]->buffers();
+                const double* wMx = wbuffers[3];
+                const double* wMy = wbuffers[4];
+                const double* wMz = wbuffers[5];
+                const double* wNx = wbuffers[6];
+                const double* wNy = wbuffers[7];
+                const double* wNz = wbuffers[8];
+
+                for (int p = 0, delta = 0; p < nP; p++) {
                     for (int m = 0; m < nM; m++) {
-                        for (int n = 0; n < nN; n++) {
+                        for (int n = 0; n < nN; n++, delta++) {
                             double wKval = 0.5 * perm * Kmnp[p + oP][(m + oM) * nso + (n + oN)];
-                            grad_wKp[aP][0] += wKval * (*Px);
-                            grad_wKp[aP][1] += wKval * (*Py);
-                            grad_wKp[aP][2] += wKval * (*Pz);
-                            grad_wKp[aM][0] += wKval * (*Mx);
-                            grad_wKp[aM][1] += wKval * (*My);
-                            grad_wKp[aM][2] += wKval * (*Mz);
-                            grad_wKp[aN][0] += wKval * (*Nx);
-                            grad_wKp[aN][1] += wKval * (*Ny);
-                            grad_wKp[aN][2] += wKval * (*Nz);
-                            Px++;
-                            Py++;
-                            Pz++;
-                            Mx++;
-                            My++;
-                            Mz++;
-                            Nx++;
-                            Ny++;
-                            Nz++;
+                            wK[0] += wKval * wMx[delta];
+                            wK[1] += wKval * wMy[delta];
+                            wK[2] += wKval * wMz[delta];
+                            wK[3] += wKval * wNx[delta];
+                            wK[4] += wKval * wNy[delta];
+                            wK[5] += wKval * wNz[delta];
                         }
                     }
                 }
             }
+
+            auto scatter = [&](double** gradp, const double* val) {
+                for (int x = 0; x < 3; x++) {
+                    gradp[aM][x] += val[x];
+                    gradp[aN][x] += val[3 + x];
+                    gradp[aP][x] -= val[x] + val[3 + x];
+                }
+            };
+            if (do_J_) scatter(Jtemps[thread]->pointer(), J);
+            if (do_K_) scatter(Ktemps[thread]->pointer(), K);
+            if (do_wK_) scatter(wKtemps[thread]->pointer(), wK);
         }
     }
 
@@ -2202,6 +2185,289 @@ void DFJKGrad::compute_hessian() {
     }
 }
 
+COSXJKGrad::COSXJKGrad(int deriv, std::shared_ptr<MintsHelper> mints) : DFJKGrad(deriv, mints) {
+    Options& options = Process::environment.options;
+    // the same points as the final COSX grid, blocked by atom so that each point knows the atom it moves with
+    grid_ = DFJCOSK::build_grid(primary_, options, true, true);
+    kscreen_ = options.get_double("COSX_INTS_TOLERANCE");
+}
+COSXJKGrad::~COSXJKGrad() {}
+void COSXJKGrad::print_header() const {
+    if (print_) {
+        outfile->Printf("  ==> COSXJKGrad: Density-Fitted J / Chain-of-Spheres K SCF Gradients <==\n\n");
+
+        outfile->Printf("    Gradient:          %11d\n", deriv_);
+        outfile->Printf("    J tasked:          %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf("    K tasked:          %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf("    wK tasked:         %11s\n", (do_wK_ ? "Yes" : "No"));
+        outfile->Printf("    OpenMP threads:    %11d\n", omp_num_threads_);
+        outfile->Printf("    Integrals threads: %11d\n", df_ints_num_threads_);
+        outfile->Printf("    Memory [MiB]:      %11ld\n", (memory_ * 8L) / (1024L * 1024L));
+        outfile->Printf("    Schwarz Cutoff:    %11.0E\n", cutoff_);
+        outfile->Printf("    Fitting Condition: %11.0E\n", condition_);
+        outfile->Printf("    K Screening Cutoff:%11.0E\n", kscreen_);
+        outfile->Printf("    K Grid Points:     %11d\n\n", grid_->npoints());
+
+        outfile->Printf("   => Auxiliary Basis Set <=\n\n");
+        auxiliary_->print_by_level("outfile", print_);
+    }
+}
+void COSXJKGrad::compute_gradient() {
+    if (do_wK_) throw PSIEXCEPTION("COSXJKGrad: COSX does not support wK gradients.");
+
+    // the Coulomb term is the DFJCOSK density-fitted J, so DFJKGrad handles it alone
+    bool do_K = do_K_;
+    do_K_ = false;
+    DFJKGrad::compute_gradient();
+    do_K_ = do_K;
+
+    if (do_K_) {
+        if (!(Da_ && Db_)) throw PSIEXCEPTION("Occupation/Density not set");
+        timer_on("JKGrad: COSX");
+        gradients_["Exchange"] = compute_K_gradient();
+        timer_off("JKGrad: COSX");
+    }
+}
+void COSXJKGrad::compute_hessian() {
+    throw PSIEXCEPTION("COSXJKGrad: Hessians are not available with SCF_TYPE COSX.");
+}
+SharedMatrix COSXJKGrad::compute_K_gradient() {
+    // The COSX exchange energy (DOI 10.1016/j.chemphys.2008.10.036, EQ. 4-7) is
+    //
+    //   E_K = 1/2 \sum_g \sum_{lk} F_gl A_lk(g) F_gk,   F_gl = \sum_m X_gm D_ml,   X_gm = w_g^1/2 phi_m(g)
+    //
+    // With the grid held fixed, its derivative has a basis function term and an ESP integral term
+    //
+    //   dE_K = \sum_g \sum_l dF_gl G_gl + 1/2 \sum_g \sum_{lk} F_gl F_gk dA_lk(g),   G_gl = \sum_k A_lk(g) F_gk
+    //
+    // where dF_gl only involves the (weighted) gradients of the functions on the displaced atom.
+    //
+    // The points move rigidly with their parent atom (weights held fixed), so that atom also picks up the
+    // charge-center derivative of A(g) and the point derivative of phi(g). Both terms make the gradient
+    // translationally invariant.
+
+    int natom = primary_->molecule()->natom();
+    int nbf = primary_->nbf();
+    int nshell = primary_->nshell();
+
+    // a restricted Db aliases Da, so its contribution is that of Da twice
+    std::vector<SharedMatrix> D = {Da_};
+    double spin_fac = 2.0;
+    if (Db_ != Da_) {
+        D.push_back(Db_);
+        spin_fac = 1.0;
+    }
+    size_t nD = D.size();
+
+    auto esp_bound = compute_esp_bound(*primary_);
+    auto esp_boundp = esp_bound.pointer();
+
+    // => Per-Thread Objects <= //
+
+    auto factory = std::make_shared<IntegralFactory>(primary_);
+    std::vector<std::shared_ptr<PotentialInt>> int_computers(omp_num_threads_);
+    std::vector<std::shared_ptr<PotentialInt>> deriv_computers(omp_num_threads_);
+    std::vector<std::shared_ptr<BasisFunctions>> bf_computers(omp_num_threads_);
+    std::vector<SharedMatrix> Ktemps(omp_num_threads_);
+    for (int rank = 0; rank < omp_num_threads_; rank++) {
+        int_computers[rank] = std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(factory->ao_potential(0)));
+        deriv_computers[rank] = std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(factory->ao_potential(1)));
+        bf_computers[rank] = std::make_shared<BasisFunctions>(primary_, grid_->max_points(), grid_->max_functions());
+        bf_computers[rank]->set_deriv(1);
+        Ktemps[rank] = std::make_shared<Matrix>("K Gradient", natom, 3);
+    }
+
+    const auto& blocks = grid_->blocks();
+
+#pragma omp parallel for schedule(dynamic) num_threads(omp_num_threads_)
+    for (size_t bi = 0; bi < blocks.size(); bi++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+
+        const auto& block = blocks[bi];
+        int npoints = block->npoints();
+        const double* x = block->x();
+        const double* y = block->y();
+        const double* z = block->z();
+        const double* w = block->w();
+
+        const auto& bf_map = block->functions_local_to_global();
+        int nlocal = bf_map.size();
+        if (npoints == 0 || nlocal == 0) continue;
+        int parent = block->parent_atom();
+
+        double** Kp = Ktemps[rank]->pointer();
+
+        // => Weighted Basis Function Values and Gradients <= //
+
+        bf_computers[rank]->compute_functions(block);
+        auto& values = bf_computers[rank]->basis_values();
+        double** phip = values["PHI"]->pointer();
+        double** phixyzp[3] = {values["PHI_X"]->pointer(), values["PHI_Y"]->pointer(), values["PHI_Z"]->pointer()};
+
+        auto X = std::make_shared<Matrix>(npoints, nlocal);
+        std::vector<SharedMatrix> Xd = {std::make_shared<Matrix>(npoints, nlocal), std::make_shared<Matrix>(npoints, nlocal),
+                                        std::make_shared<Matrix>(npoints, nlocal)};
+        auto Xp = X->pointer();
+        std::vector<double> Xd_max(npoints, 0.0);
+        for (int g = 0; g < npoints; g++) {
+            double sw = std::sqrt(w[g]);
+            for (int k = 0; k < nlocal; k++) {
+                Xp[g][k] = sw * phip[g][k];
+                for (int c = 0; c < 3; c++) {
+                    double val = sw * phixyzp[c][g][k];
+                    Xd[c]->pointer()[g][k] = val;
+                    Xd_max[g] = std::max(Xd_max[g], std::abs(val));
+                }
+            }
+        }
+        double Xd_block_max = *std::max_element(Xd_max.begin(), Xd_max.end());
+
+        // => F Matrices and Their Shell Maxima <= //
+
+        std::vector<SharedMatrix> Dl(nD), F(nD), G(nD);
+        // F_shell[g][S] and D_shell[S] bound the F and dF contributions of shell S at point g
+        auto F_shell = std::make_shared<Matrix>(npoints, nshell);
+        std::vector<double> D_shell(nshell, 0.0);
+        auto F_shellp = F_shell->pointer();
+        for (size_t i = 0; i < nD; i++) {
+            Dl[i] = std::make_shared<Matrix>(nlocal, nbf);
+            auto Dp = D[i]->pointer();
+            auto Dlp = Dl[i]->pointer();
+            for (int k = 0; k < nlocal; k++) {
+                ::memcpy(Dlp[k], Dp[bf_map[k]], sizeof(double) * nbf);
+            }
+            F[i] = linalg::doublet(X, Dl[i]);
+            G[i] = std::make_shared<Matrix>(npoints, nbf);
+
+            auto Fp = F[i]->pointer();
+            for (int S = 0; S < nshell; S++) {
+                int s_start = primary_->shell(S).function_index();
+                int num_s = primary_->shell(S).nfunction();
+                for (int s = s_start; s < s_start + num_s; s++) {
+                    for (int g = 0; g < npoints; g++) {
+                        F_shellp[g][S] = std::max(F_shellp[g][S], std::abs(Fp[g][s]));
+                    }
+                    for (int k = 0; k < nlocal; k++) {
+                        D_shell[S] = std::max(D_shell[S], std::abs(Dlp[k][s]));
+                    }
+                }
+            }
+        }
+
+        std::vector<double> F_block(nshell, 0.0);
+        for (int g = 0; g < npoints; g++) {
+            for (int S = 0; S < nshell; S++) {
+                F_block[S] = std::max(F_block[S], F_shellp[g][S]);
+            }
+        }
+
+        // shell pairs that survive screening over the whole block
+        std::vector<std::pair<int, int>> PQ_pairs;
+        for (int P = 0; P < nshell; P++) {
+            double W_P = std::max(F_block[P], Xd_block_max * D_shell[P]);
+            for (int Q = 0; Q <= P; Q++) {
+                double W_Q = std::max(F_block[Q], Xd_block_max * D_shell[Q]);
+                double bound = esp_boundp[P][Q] * std::max(W_P * F_block[Q], W_Q * F_block[P]);
+                if (bound >= kscreen_) PQ_pairs.emplace_back(P, Q);
+            }
+        }
+
+        // => ESP Integrals and Their Derivatives <= //
+
+        auto& ints = int_computers[rank];
+        auto& dints = deriv_computers[rank];
+        for (int g = 0; g < npoints; g++) {
+            bool point_set = false;
+
+            for (const auto& PQ : PQ_pairs) {
+                int P = PQ.first;
+                int Q = PQ.second;
+
+                double W_P = std::max(F_shellp[g][P], Xd_max[g] * D_shell[P]);
+                double W_Q = std::max(F_shellp[g][Q], Xd_max[g] * D_shell[Q]);
+                double bound = esp_boundp[P][Q] * std::max(W_P * F_shellp[g][Q], W_Q * F_shellp[g][P]);
+                if (bound < kscreen_) continue;
+
+                if (!point_set) {
+                    // l2 includes the electron charge, so a charge of -1.0 gives A_lk(g) as in DFJCOSK
+                    ints->set_charge_field({{-1.0, {x[g], y[g], z[g]}}});
+                    dints->set_charge_field({{-1.0, {x[g], y[g], z[g]}}});
+                    point_set = true;
+                }
+
+                int p_start = primary_->shell(P).function_index();
+                int num_p = primary_->shell(P).nfunction();
+                int center_P = primary_->shell(P).ncenter();
+                int q_start = primary_->shell(Q).function_index();
+                int num_q = primary_->shell(Q).nfunction();
+                int center_Q = primary_->shell(Q).ncenter();
+
+                // values and derivatives come from separate objects, as a deriv1 call resizes the chunks
+                ints->compute_shell(P, Q);
+                const double* A = ints->buffers()[0];
+                // d/dP, d/dQ, then d/d(point) in chunks 6-8
+                dints->compute_shell_deriv1(P, Q);
+                const auto& dA = dints->buffers();
+
+                double perm = (P == Q ? 0.5 : 1.0) * spin_fac;
+
+                for (size_t i = 0; i < nD; i++) {
+                    double* Fg = F[i]->pointer()[g];
+                    double* Gg = G[i]->pointer()[g];
+                    double grad[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+                    for (int p = 0, pq = 0; p < num_p; p++) {
+                        double Fp = Fg[p + p_start];
+                        double Gp = 0.0;
+                        for (int q = 0; q < num_q; q++, pq++) {
+                            double Fq = Fg[q + q_start];
+                            Gp += A[pq] * Fq;
+                            if (P != Q) Gg[q + q_start] += A[pq] * Fp;
+                            double FF = Fp * Fq;
+                            for (int c = 0; c < 9; c++) {
+                                grad[c] += FF * dA[c][pq];
+                            }
+                        }
+                        Gg[p + p_start] += Gp;
+                    }
+                    for (int c = 0; c < 3; c++) {
+                        Kp[center_P][c] += perm * grad[c];
+                        Kp[center_Q][c] += perm * grad[c + 3];
+                        Kp[parent][c] += perm * grad[c + 6];
+                    }
+                }
+            }
+        }
+
+        // => Basis Function Derivative Term <= //
+
+        // H_gm = \sum_l G_gl D_lm on the local functions, contracted with the weighted gradients
+        for (size_t i = 0; i < nD; i++) {
+            auto H = linalg::doublet(G[i], Dl[i], false, true);
+            auto Hp = H->pointer();
+            for (int k = 0; k < nlocal; k++) {
+                int center = primary_->function_to_center(bf_map[k]);
+                for (int c = 0; c < 3; c++) {
+                    auto Xdp = Xd[c]->pointer();
+                    double val = 0.0;
+                    for (int g = 0; g < npoints; g++) {
+                        val += Xdp[g][k] * Hp[g][k];
+                    }
+                    Kp[center][c] -= spin_fac * val;
+                    Kp[parent][c] += spin_fac * val;
+                }
+            }
+        }
+    }
+
+    auto Kgrad = std::make_shared<Matrix>("Exchange Gradient", natom, 3);
+    for (int rank = 0; rank < omp_num_threads_; rank++) {
+        Kgrad->add(Ktemps[rank]);
+    }
+    return Kgrad;
+}
 DirectJKGrad::DirectJKGrad(int deriv, std::shared_ptr<BasisSet> primary) : JKGrad(deriv, primary) { common_init(); }
 DirectJKGrad::~DirectJKGrad() {}
 void DirectJKGrad::common_init() {
@@ -2366,22 +2632,26 @@ std::map<std::string, std::shared_ptr<Matrix>> DirectJKGrad::compute1(
 
             if (!ints[rank]->shell_block_significant(blockPQ_idx, blockRS_idx)) continue;
 
+            // By translational invariance a quartet on a single atom has no net gradient
+            bool one_center = true;
+            int center = primary_->shell(blockPQ[0].first).ncenter();
+            for (const auto& pair : blockPQ) {
+                one_center = one_center && primary_->shell(pair.first).ncenter() == center &&
+                             primary_->shell(pair.second).ncenter() == center;
+            }
+            for (const auto& pair : blockRS) {
+                one_center = one_center && primary_->shell(pair.first).ncenter() == center &&
+                             primary_->shell(pair.second).ncenter() == center;
+            }
+            if (one_center) continue;
+
             // compute the integrals and continue if none were computed
             ints[rank]->compute_shell_blocks_deriv1(blockPQ_idx, blockRS_idx);
             const auto& buffers = ints[rank]->buffers();
 
-            const double* pAx = buffers[0];
-            const double* pAy = buffers[1];
-            const double* pAz = buffers[2];
-            const double* pBx = buffers[3];
-            const double* pBy = buffers[4];
-            const double* pBz = buffers[5];
-            const double* pCx = buffers[6];
-            const double* pCy = buffers[7];
-            const double* pCz = buffers[8];
-            const double* pDx = buffers[9];
-            const double* pDy = buffers[10];
-            const double* pDz = buffers[11];
+            // Only the A, B and C derivatives are contracted; D = -(A + B + C) by translational invariance
+            const double* pbuf[9];
+            for (int i = 0; i < 9; i++) pbuf[i] = buffers[i];
 
             // Loop over all of the P,Q,R,S shells within the blocks.  We have P>=Q, R>=S and PQ<=RS.
             for (const auto& pairPQ : blockPQ) {
@@ -2422,157 +2692,48 @@ std::map<std::string, std::shared_ptr<Matrix>> DirectJKGrad::compute1(
                     // When there are chunks of shellpairs in RS, we need to make sure
                     // we filter out redundant combinations.
                     if (use_batching && Pam == Ram && Qam == Sam && ((P > R) || (P == R && Q > S))) {
-                        pAx += block_size;
-                        pAy += block_size;
-                        pAz += block_size;
-                        pBx += block_size;
-                        pBy += block_size;
-                        pBz += block_size;
-                        pCx += block_size;
-                        pCy += block_size;
-                        pCz += block_size;
-                        pDx += block_size;
-                        pDy += block_size;
-                        pDz += block_size;
+                        for (int i = 0; i < 9; i++) pbuf[i] += block_size;
                         continue;
                     }
-                    double val;
-                    double Dpq, Drs;
-                    size_t delta;
-                    double Ax, Ay, Az;
-                    double Bx, By, Bz;
-                    double Cx, Cy, Cz;
-                    double Dx, Dy, Dz;
 
-                    // => Coulomb Term <= //
+                    // => Coulomb and Exchange Terms, in one pass over the integrals <= //
 
-                    Ax = 0.0;
-                    Ay = 0.0;
-                    Az = 0.0;
-                    Bx = 0.0;
-                    By = 0.0;
-                    Bz = 0.0;
-                    Cx = 0.0;
-                    Cy = 0.0;
-                    Cz = 0.0;
-                    Dx = 0.0;
-                    Dy = 0.0;
-                    Dz = 0.0;
-                    delta = 0L;
+                    double J[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+                    double K[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+                    size_t delta = 0L;
                     for (int p = 0; p < Psize; p++) {
                         for (int q = 0; q < Qsize; q++) {
+                            double Dpq = prefactor * Dtp[p + Poff][q + Qoff];
                             for (int r = 0; r < Rsize; r++) {
                                 for (int s = 0; s < Ssize; s++) {
-                                    Dpq = Dtp[p + Poff][q + Qoff];
-                                    Drs = Dtp[r + Roff][s + Soff];
-                                    val = prefactor * Dpq * Drs;
-                                    Ax += val * pAx[delta];
-                                    Ay += val * pAy[delta];
-                                    Az += val * pAz[delta];
-                                    Bx += val * pBx[delta];
-                                    By += val * pBy[delta];
-                                    Bz += val * pBz[delta];
-                                    Cx += val * pCx[delta];
-                                    Cy += val * pCy[delta];
-                                    Cz += val * pCz[delta];
-                                    Dx += val * pDx[delta];
-                                    Dy += val * pDy[delta];
-                                    Dz += val * pDz[delta];
+                                    double Jval = Dpq * Dtp[r + Roff][s + Soff];
+                                    double Kval = 0.5 * prefactor *
+                                                  (Dap[p + Poff][r + Roff] * Dap[q + Qoff][s + Soff] +
+                                                   Dap[p + Poff][s + Soff] * Dap[q + Qoff][r + Roff] +
+                                                   Dbp[p + Poff][r + Roff] * Dbp[q + Qoff][s + Soff] +
+                                                   Dbp[p + Poff][s + Soff] * Dbp[q + Qoff][r + Roff]);
+                                    for (int i = 0; i < 9; i++) {
+                                        J[i] += Jval * pbuf[i][delta];
+                                        K[i] += Kval * pbuf[i][delta];
+                                    }
                                     delta++;
                                 }
                             }
                         }
                     }
 
-                    Jp[Pcenter][0] += Ax;
-                    Jp[Pcenter][1] += Ay;
-                    Jp[Pcenter][2] += Az;
-                    Jp[Qcenter][0] += Bx;
-                    Jp[Qcenter][1] += By;
-                    Jp[Qcenter][2] += Bz;
-                    Jp[Rcenter][0] += Cx;
-                    Jp[Rcenter][1] += Cy;
-                    Jp[Rcenter][2] += Cz;
-                    Jp[Scenter][0] += Dx;
-                    Jp[Scenter][1] += Dy;
-                    Jp[Scenter][2] += Dz;
-
-                    // => Exchange Term <= //
-
-                    Ax = 0.0;
-                    Ay = 0.0;
-                    Az = 0.0;
-                    Bx = 0.0;
-                    By = 0.0;
-                    Bz = 0.0;
-                    Cx = 0.0;
-                    Cy = 0.0;
-                    Cz = 0.0;
-                    Dx = 0.0;
-                    Dy = 0.0;
-                    Dz = 0.0;
-                    delta = 0L;
-                    for (int p = 0; p < Psize; p++) {
-                        for (int q = 0; q < Qsize; q++) {
-                            for (int r = 0; r < Rsize; r++) {
-                                for (int s = 0; s < Ssize; s++) {
-                                    val = 0.0;
-                                    Dpq = Dap[p + Poff][r + Roff];
-                                    Drs = Dap[q + Qoff][s + Soff];
-                                    val += prefactor * Dpq * Drs;
-                                    Dpq = Dap[p + Poff][s + Soff];
-                                    Drs = Dap[q + Qoff][r + Roff];
-                                    val += prefactor * Dpq * Drs;
-                                    Dpq = Dbp[p + Poff][r + Roff];
-                                    Drs = Dbp[q + Qoff][s + Soff];
-                                    val += prefactor * Dpq * Drs;
-                                    Dpq = Dbp[p + Poff][s + Soff];
-                                    Drs = Dbp[q + Qoff][r + Roff];
-                                    val += prefactor * Dpq * Drs;
-                                    val *= 0.5;
-                                    Ax += val * pAx[delta];
-                                    Ay += val * pAy[delta];
-                                    Az += val * pAz[delta];
-                                    Bx += val * pBx[delta];
-                                    By += val * pBy[delta];
-                                    Bz += val * pBz[delta];
-                                    Cx += val * pCx[delta];
-                                    Cy += val * pCy[delta];
-                                    Cz += val * pCz[delta];
-                                    Dx += val * pDx[delta];
-                                    Dy += val * pDy[delta];
-                                    Dz += val * pDz[delta];
-                                    delta++;
-                                }
-                            }
-                        }
+                    for (int x = 0; x < 3; x++) {
+                        Jp[Pcenter][x] += J[x];
+                        Jp[Qcenter][x] += J[3 + x];
+                        Jp[Rcenter][x] += J[6 + x];
+                        Jp[Scenter][x] -= J[x] + J[3 + x] + J[6 + x];
+                        Kp[Pcenter][x] += K[x];
+                        Kp[Qcenter][x] += K[3 + x];
+                        Kp[Rcenter][x] += K[6 + x];
+                        Kp[Scenter][x] -= K[x] + K[3 + x] + K[6 + x];
                     }
 
-                    Kp[Pcenter][0] += Ax;
-                    Kp[Pcenter][1] += Ay;
-                    Kp[Pcenter][2] += Az;
-                    Kp[Qcenter][0] += Bx;
-                    Kp[Qcenter][1] += By;
-                    Kp[Qcenter][2] += Bz;
-                    Kp[Rcenter][0] += Cx;
-                    Kp[Rcenter][1] += Cy;
-                    Kp[Rcenter][2] += Cz;
-                    Kp[Scenter][0] += Dx;
-                    Kp[Scenter][1] += Dy;
-                    Kp[Scenter][2] += Dz;
-
-                    pAx += block_size;
-                    pAy += block_size;
-                    pAz += block_size;
-                    pBx += block_size;
-                    pBy += block_size;
-                    pBz += block_size;
-                    pCx += block_size;
-                    pCy += block_size;
-                    pCz += block_size;
-                    pDx += block_size;
-                    pDy += block_size;
-                    pDz += block_size;
+                    for (int i = 0; i < 9; i++) pbuf[i] += block_size;
                 }  // pairRS
             }      // pairPQ
         }          // blockRS
@@ -40,6 +40,7 @@ class BasisSet;
 class PSIO;
 class TwoBodyAOInt;
 class MintsHelper;
+class DFTGrid;
 
 namespace scfgrad {
 
@@ -231,6 +232,34 @@ public:
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
 };
 
+/**
+ * Class COSXJKGrad
+ *
+ * Gradients of the DFJCOSK energy: the density-fitted Coulomb gradient of DFJKGrad
+ * plus a semi-numerical chain-of-spheres exchange gradient on the final COSX grid.
+ * The grid points move rigidly with their parent atom (no grid weight derivatives)
+ * and the exchange gradient is that of the unfitted COSX exchange energy.
+ */
+class COSXJKGrad : public DFJKGrad {
+
+protected:
+    /// Large DFTGrid of the final COSX iteration
+    std::shared_ptr<DFTGrid> grid_;
+    /// Screening cutoff for the semi-numerical exchange contributions
+    double kscreen_;
+
+    /// Semi-numerical exchange gradient of Da and Db (a restricted Db aliasing Da is counted twice)
+    SharedMatrix compute_K_gradient();
+public:
+    COSXJKGrad(int deriv, std::shared_ptr<MintsHelper> mints);
+    ~COSXJKGrad() override;
+
+    void compute_gradient() override;
+    void compute_hessian() override;
+
+    void print_header() const override;
+};
+
 class DirectJKGrad : public JKGrad {
 
 protected:
@@ -2127,15 +2127,21 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response() {
     {
         rhf_wfn_->set_jk(jk);
 
+        // All perturbations of a chunk share one block CG search space. Per equation the solver keeps
+        // X, R, Z, P, A P, and the two Hx buffers, and the JK object a density and J/K per direction.
+        size_t per_eq = 7L * nocc * nvir + 3L * nso * nso + 1L * nocc * nso;
+        size_t max_eq = (mem / 2L) / per_eq;
+        max_eq = std::max<size_t>(1, std::min<size_t>(max_eq, 3 * natom));
+
         psio_address next_Bai = PSIO_ZERO;
         psio_address next_Uai = PSIO_ZERO;
 
         auto T = std::make_shared<Matrix>("T", nvir, nocc);
         double** Tp = T->pointer();
 
-        for (int A = 0; A < 3 * natom; A += max_A) {
-            int nA = max_A;
-            if (A + max_A >= 3 * natom) {
+        for (int A = 0; A < 3 * natom; A += max_eq) {
+            int nA = max_eq;
+            if (A + max_eq >= 3 * natom) {
                 nA = 3 * natom - A;
             }
 
@@ -2157,8 +2163,8 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response() {
 #ifdef USING_BrianQC
     brianCPHFLeftSideFlag = true;
 #endif
-            auto u_matrices = rhf_wfn_->cphf_solve(b_vecs, options_.get_double("SOLVER_CONVERGENCE"),
-                                                   options_.get_int("SOLVER_MAXITER"), print_);
+            auto u_matrices = rhf_wfn_->cphf_block_solve(b_vecs, options_.get_double("SOLVER_CONVERGENCE"),
+                                                         options_.get_int("SOLVER_MAXITER"), print_);
 
 #ifdef USING_BrianQC
     brianCPHFLeftSideFlag = false;
@@ -2512,8 +2518,11 @@ std::shared_ptr<Matrix> USCFDeriv::hessian_response()
     JK_deriv2(jk,mem, Ca, Ca_occ, Cb, Cb_occ, nso, naocc, nbocc, navir, true);
     JK_deriv2(jk,mem, Cb, Cb_occ, Ca, Ca_occ, nso, nbocc, naocc, nbvir, false);
 
-    VXC_deriv(Ca, Ca_occ, nso, naocc, navir, true);
-    VXC_deriv(Cb, Cb_occ, nso, nbocc, nbvir, false);
+    // Both spins of the XC Fock derivatives come from one pass over the grid
+    std::vector<SharedMatrix> Vxc_matrices;
+    if (functional_->needs_xc()) Vxc_matrices = potential_->compute_fock_derivatives();
+    VXC_deriv(Vxc_matrices, Ca, Ca_occ, nso, naocc, navir, true);
+    VXC_deriv(Vxc_matrices, Cb, Cb_occ, nso, nbocc, nbvir, false);
 
     assemble_Fock(naocc, navir,true);
     assemble_Fock(nbocc, nbvir,false);
@@ -2527,10 +2536,10 @@ std::shared_ptr<Matrix> USCFDeriv::hessian_response()
     {
         uhf_wfn_->set_jk(jk);
 
-        // using naocc here
-        size_t per_A = 3L * nso * nso + 1L * naocc * nso;
+        // using naocc here; see the RHF code for the block CG memory per equation
+        size_t per_A = 7L * (naocc * navir + nbocc * nbvir) + 6L * nso * nso + 1L * (naocc + nbocc) * nso;
         size_t max_A = (mem / 2L) / per_A;
-        max_A = (max_A > 3 * natom ? 3 * natom : max_A);
+        max_A = std::max<size_t>(1, std::min<size_t>(max_A, 3 * natom));
 
         psio_address next_Baia = PSIO_ZERO;
         psio_address next_Uaia = PSIO_ZERO;
@@ -2578,8 +2587,8 @@ std::shared_ptr<Matrix> USCFDeriv::hessian_response()
 #ifdef USING_BrianQC
     brianCPHFLeftSideFlag = true;
 #endif
-            auto u_matrices = uhf_wfn_->cphf_solve(b_vecs, options_.get_double("SOLVER_CONVERGENCE"),
-                                                   options_.get_int("SOLVER_MAXITER"), print_);
+            auto u_matrices = uhf_wfn_->cphf_block_solve(b_vecs, options_.get_double("SOLVER_CONVERGENCE"),
+                                                         options_.get_int("SOLVER_MAXITER"), print_);
 
 #ifdef USING_BrianQC
     brianCPHFLeftSideFlag = false;
@@ -4343,9 +4352,11 @@ void USCFDeriv::JK_deriv2(std::shared_ptr<JK> jk, int mem,
     size_t nmo = n1occ + n1vir;
     int natom = molecule_->natom();
 
-    size_t per_A = 3L * nso * nso + 1L * n1occ * nso;
+    size_t per_A = 5L * nso * nso + 1L * n1occ * nso;
     size_t max_A = (mem / 2L) / per_A;
     max_A = (max_A > 3 * natom ? 3 * natom : max_A);
+    // Position of spin 1 in the alpha/beta pairs of Dx and Vx
+    int s1 = (alpha ? 0 : 1);
 
     // Figure out DFT functional info
     double Kscale = functional_->x_alpha();
@@ -4381,8 +4392,10 @@ void USCFDeriv::JK_deriv2(std::shared_ptr<JK> jk, int mem,
         // Just pass C1 quantities in; this object doesn't respect symmetry anyway
         L.push_back(C1occ);
         R.push_back(std::make_shared<Matrix>("R",nso,n1occ));
-        Dx.push_back(std::make_shared<Matrix>("Dx", nso,nso));
-        Vx.push_back(std::make_shared<Matrix>("Vx", nso,nso));
+        for (int s = 0; s < 2; s++) {
+            Dx.push_back(std::make_shared<Matrix>("Dx", nso,nso));
+            Vx.push_back(std::make_shared<Matrix>("Vx", nso,nso));
+        }
 
         L.push_back(C2occ);
         R.push_back(std::make_shared<Matrix>("R",nso,n2occ));
@@ -4397,21 +4410,31 @@ void USCFDeriv::JK_deriv2(std::shared_ptr<JK> jk, int mem,
             nA = 3 * natom - A;
             L.resize(2*nA);
             R.resize(2*nA);
+            Dx.resize(2*nA);
+            Vx.resize(2*nA);
         }
         for (int a = 0; a < nA; a++) {
             psio_address next_Sij= psio_get_address(PSIO_ZERO,(A + a) * (size_t) n1occ * n1occ * sizeof(double));
             psio_->read(PSIF_HESS,Sij_1,(char*)Sij1p[0], static_cast<size_t> (n1occ)*n1occ*sizeof(double),next_Sij, &next_Sij);
             C_DGEMM('N','N',nso,n1occ,n1occ,1.0,C1op[0],n1occ,Sij1p[0],n1occ,0.0,R[2*a]->pointer()[0],n1occ);
-            Dx[a] = linalg::doublet(L[2*a], R[2*a], false, true);
-            // Symmetrize the pseudodensity
-            Dx[a]->add(Dx[a]->transpose());
-            Dx[a]->scale(0.5);
         }
         for (int a = 0; a < nA; a++) {
             psio_address next_Sij= psio_get_address(PSIO_ZERO,(A + a) * (size_t) n2occ * n2occ * sizeof(double));
             psio_->read(PSIF_HESS,Sij_2,(char*)Sij2p[0], static_cast<size_t> (n2occ)*n2occ*sizeof(double),next_Sij, &next_Sij);
             C_DGEMM('N','N',nso,n2occ,n2occ,1.0,C2op[0],n2occ,Sij2p[0],n2occ,0.0,R[2*a+1]->pointer()[0],n2occ);
         }
+        if(functional_->needs_xc()) {
+            // Both spins of the pseudodensity, in the alpha/beta pairs that UV::compute_Vx expects
+            for (int a = 0; a < nA; a++) {
+                Dx[2*a+s1] = linalg::doublet(L[2*a], R[2*a], false, true);
+                Dx[2*a+1-s1] = linalg::doublet(L[2*a+1], R[2*a+1], false, true);
+                for (int s = 0; s < 2; s++) {
+                    // Symmetrize the pseudodensity
+                    Dx[2*a+s]->add(Dx[2*a+s]->transpose());
+                    Dx[2*a+s]->scale(0.5);
+                }
+            }
+        }
 
         jk->compute();
         if(functional_->needs_xc()) {
@@ -4431,9 +4454,9 @@ void USCFDeriv::JK_deriv2(std::shared_ptr<JK> jk, int mem,
 
             if(functional_->needs_xc()) {
                 // Symmetrize the result, just to be safe
-                C_DGEMM('N','N',nso,n1occ,nso, 0.5,Vx[2*a]->pointer()[0],nso,C1op[0],n1occ,0.0,Tp[0],n1occ);
-                C_DGEMM('T','N',nso,n1occ,nso, 0.5,Vx[2*a]->pointer()[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
-                C_DGEMM('T','N',nmo,n1occ,nso,-2.0,C1p[0],nmo,Tp[0],n1occ,1.0,Up[0],n1occ);
+                C_DGEMM('N','N',nso,n1occ,nso, 0.5,Vx[2*a+s1]->pointer()[0],nso,C1op[0],n1occ,0.0,Tp[0],n1occ);
+                C_DGEMM('T','N',nso,n1occ,nso, 0.5,Vx[2*a+s1]->pointer()[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
+                C_DGEMM('T','N',nmo,n1occ,nso,-1.0,C1p[0],nmo,Tp[0],n1occ,1.0,Up[0],n1occ);
             }
 
             // Subtract the K term from G
@@ -4449,7 +4472,8 @@ void USCFDeriv::JK_deriv2(std::shared_ptr<JK> jk, int mem,
     }
 }
 
-void USCFDeriv::VXC_deriv(std::shared_ptr<Matrix> C, 
+void USCFDeriv::VXC_deriv(const std::vector<SharedMatrix>& Vxc_matrices,
+                          std::shared_ptr<Matrix> C,
                           std::shared_ptr<Matrix> Cocc,
                           int nso, int nocc, int nvir, bool alpha)
 {
@@ -4473,12 +4497,12 @@ void USCFDeriv::VXC_deriv(std::shared_ptr<Matrix> C,
         for (int A = 0; A < 3 * natom; A++)
             psio_->write(PSIF_HESS,VXCpi_str,(char*)Up[0], static_cast<size_t> (nmo)*nocc*sizeof(double),next_VXCpi,&next_VXCpi);
 
-        // For now we just compute all 3N matrices in one go.  If this becomes to burdensome
+        // All 6N matrices come in one go: alpha first, then beta.  If this becomes to burdensome
         // in terms of memory we can reevaluate and implement a batching mechanism instead.
-        auto Vxc_matrices = potential_->compute_fock_derivatives();
+        int offset = (alpha ? 0 : 3 * natom);
         for(int a =0; a < 3*natom; ++a){
             // Transform from SO basis to pi
-            C_DGEMM('N','N',nso,nocc,nso,1.0,Vxc_matrices[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
+            C_DGEMM('N','N',nso,nocc,nso,1.0,Vxc_matrices[offset + a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
             C_DGEMM('T','N',nmo,nocc,nso,1.0,Cp[0],nmo,Tp[0],nocc,0.0,Up[0],nocc);
             next_VXCpi = psio_get_address(PSIO_ZERO,a * (size_t) nmo * nocc * sizeof(double));
 
@@ -4607,8 +4631,10 @@ void USCFDeriv::assemble_Q(std::shared_ptr<JK> jk,
     size_t nmo = n1occ + n1vir;
     int natom = molecule_->natom();
     size_t mem = 0.9 * memory_ / 8L;
-    size_t per_A = 3L * nso * nso + 1L * n1occ * nso;
+    size_t per_A = 5L * nso * nso + 1L * n1occ * nso;
     size_t max_A = (mem / 2L) / per_A;
+    // Position of spin 1 in the alpha/beta pairs of Dx and Vx
+    int s1 = (alpha ? 0 : 1);
 
     double** C1p  = C1->pointer();  
     double** C1op = C1occ->pointer();
@@ -4627,8 +4653,10 @@ void USCFDeriv::assemble_Q(std::shared_ptr<JK> jk,
     for (int a = 0; a < max_A; a++) {
         L.push_back(C1occ);
         R.push_back(std::make_shared<Matrix>("R",nso,n1occ));
-        Dx.push_back(std::make_shared<Matrix>("Dx", nso,nso));
-        Vx.push_back(std::make_shared<Matrix>("Vx", nso,nso));
+        for (int s = 0; s < 2; s++) {
+            Dx.push_back(std::make_shared<Matrix>("Dx", nso,nso));
+            Vx.push_back(std::make_shared<Matrix>("Vx", nso,nso));
+        }
         L.push_back(C2occ);
         R.push_back(std::make_shared<Matrix>("R",nso,n2occ));
     }
@@ -4652,21 +4680,31 @@ void USCFDeriv::assemble_Q(std::shared_ptr<JK> jk,
             nA = 3 * natom - A;
             L.resize(2*nA);
             R.resize(2*nA);
+            Dx.resize(2*nA);
+            Vx.resize(2*nA);
         }
         for (int a = 0; a < nA; a++) {
             psio_address next_Upi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * n1occ * sizeof(double));
             psio_->read(PSIF_HESS,Ustr_1,(char*)U1pip[0], static_cast<size_t> (nmo)*n1occ*sizeof(double),next_Upi,&next_Upi);
             C_DGEMM('N','N',nso,n1occ,nmo,1.0,C1p[0],nmo,U1pip[0],n1occ,0.0,R[2*a]->pointer()[0],n1occ);
-            Dx[a] = linalg::doublet(L[2*a], R[2*a], false, true);
-            // Symmetrize the pseudodensity
-            Dx[a]->add(Dx[a]->transpose());
-            Dx[a]->scale(0.5);
         }
         for (int a = 0; a < nA; a++) {
             psio_address next_Upi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * n2occ * sizeof(double));
             psio_->read(PSIF_HESS,Ustr_2,(char*)U2pip[0], static_cast<size_t> (nmo)*n2occ*sizeof(double),next_Upi,&next_Upi);
             C_DGEMM('N','N',nso,n2occ,nmo,1.0,C2p[0],nmo,U2pip[0],n2occ,0.0,R[2*a+1]->pointer()[0],n2occ);
         }
+        if(functional_->needs_xc()) {
+            // Both spins of the pseudodensity, in the alpha/beta pairs that UV::compute_Vx expects
+            for (int a = 0; a < nA; a++) {
+                Dx[2*a+s1] = linalg::doublet(L[2*a], R[2*a], false, true);
+                Dx[2*a+1-s1] = linalg::doublet(L[2*a+1], R[2*a+1], false, true);
+                for (int s = 0; s < 2; s++) {
+                    // Symmetrize the pseudodensity
+                    Dx[2*a+s]->add(Dx[2*a+s]->transpose());
+                    Dx[2*a+s]->scale(0.5);
+                }
+            }
+        }
 
         jk->compute();
         if(functional_->needs_xc()) {
@@ -4683,8 +4721,8 @@ void USCFDeriv::assemble_Q(std::shared_ptr<JK> jk,
             }
             if(functional_->needs_xc()) {
                 // Symmetrize the result, just to be safe
-                C_DGEMM('N','N',nso,n1occ,nso, 2.0,Vx[2*a]->pointer()[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
-                C_DGEMM('T','N',nso,n1occ,nso, 2.0,Vx[2*a]->pointer()[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
+                C_DGEMM('N','N',nso,n1occ,nso, 1.0,Vx[2*a+s1]->pointer()[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
+                C_DGEMM('T','N',nso,n1occ,nso, 1.0,Vx[2*a+s1]->pointer()[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
             }
             C_DGEMM('T','N',nmo,n1occ,nso,1.0,C1p[0],nmo,Tp[0],n1occ,0.0,Up[0],n1occ);
             psio_address next_Qpi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * n1occ * sizeof(double));
@@ -505,14 +505,27 @@ SharedMatrix SCFDeriv::compute_hessian()
         hessians_["Effective Core Potential"] = SharedMatrix(hessians_["Nuclear"]->clone());
         hessians_["Effective Core Potential"]->set_name("Effective Core Potential Hessian");
         hessians_["Effective Core Potential"]->zero();
-        double** ECPp = hessians_["Effective Core Potential"]->pointer();
         hessian_terms.push_back("Effective Core Potential");
 
-        // Potential energy derivatives
-        std::shared_ptr<ECPInt> ecpint(dynamic_cast<ECPInt*>(integral_->ao_ecp(2)));
-        const auto& buffers = ecpint->buffers();
+        // Potential energy derivatives, with one integral object and accumulator per thread
+        int nthread = Process::environment.get_n_threads();
+        std::vector<std::shared_ptr<ECPInt>> ecpints;
+        std::vector<SharedMatrix> ECPtemps;
+        for (int t = 0; t < nthread; ++t) {
+            ecpints.push_back(std::shared_ptr<ECPInt>(dynamic_cast<ECPInt*>(integral_->ao_ecp(2))));
+            ECPtemps.push_back(SharedMatrix(hessians_["Effective Core Potential"]->clone()));
+        }
 
+        // Later shells have more Q partners, so hand them out dynamically
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
         for (int P = 0; P < basisset_->nshell(); P++) {
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            const auto& ecpint = ecpints[rank];
+            const auto& buffers = ecpint->buffers();
+            double** ECPp = ECPtemps[rank]->pointer();
             const GaussianShell& s1 = basisset_->shell(P);
             int nP = s1.nfunction();
             int oP = s1.function_index();
@@ -788,7 +801,12 @@ SharedMatrix SCFDeriv::compute_hessian()
                 }
             }
         }
+        for (int t = 0; t < nthread; ++t) {
+            hessians_["Effective Core Potential"]->add(ECPtemps[t]);
+        }
+
         // Symmetrize the result
+        double** ECPp = hessians_["Effective Core Potential"]->pointer();
         int dim = hessians_["Effective Core Potential"]->rowdim();
         for (int row = 0; row < dim; ++row){
             for (int col = 0; col < row; ++col){
@@ -1001,7 +1019,8 @@ SharedMatrix SCFDeriv::compute_hessian()
 #endif
     if (options_.get_str("REFERENCE") == "RHF" || 
         options_.get_str("REFERENCE") == "RKS" || 
-        options_.get_str("REFERENCE") == "UHF") {
+        options_.get_str("REFERENCE") == "UHF" ||
+        options_.get_str("REFERENCE") == "UKS") {
         hessians_["Response"] = hessian_response();
     } else {
         throw PSIEXCEPTION("SCFHessian: Response not implemented for this reference");
@@ -110,7 +110,8 @@ protected:
                    std::shared_ptr<Matrix> C2occ,
                    int nso, int n1occ, int n2occ, int nvir, bool alpha);
 
-    void VXC_deriv(std::shared_ptr<Matrix> C, 
+    void VXC_deriv(const std::vector<SharedMatrix>& Vxc_matrices,
+                   std::shared_ptr<Matrix> C,
                    std::shared_ptr<Matrix> Cocc,
                    int nso, int nocc, int nvir, bool alpha);
 
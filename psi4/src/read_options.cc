@@ -151,6 +151,16 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     /*- For displacements, symmetry (Schoenflies symbol) of 'parent' (undisplaced)
     reference molecule. Internal use only for finite difference. !expert -*/
     options.add_str("PARENT_SYMMETRY", "");
+    /*- Number of single-point tasks of a finite-difference or many-body computation to run at
+    once, each as a separate Psi4 process with an equal share of the threads and memory of this
+    job. Tasks are started largest first. The default of 1 runs them one after another in this
+    process; 0 runs as many as the threads allow while each gets at least 500 MiB. -*/
+    options.add_int("TASK_WORKERS", 1);
+    /*- Directory of a persistent cache of single-point task results for finite-difference,
+    many-body, and CBS computations. Tasks are keyed by a hash of molecule, method, basis, and
+    keywords; a task found in the cache is not run again, and a new result is added to it. The
+    default of an empty string keeps no cache. -*/
+    options.add_str_i("TASK_CACHE", "");
     /*- Number of columns to print in calls to ``Matrix::print_mat``. !expert -*/
     options.add_int("MAT_NUM_COLUMN_PRINT", 5);
     /*- List of properties to compute -*/
@@ -181,6 +191,16 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     /*- Assume external fields are arranged so that they have symmetry. It is up to the user to know what to do here.
        The code does NOT help you out in any way! !expert -*/
     options.add_bool("EXTERNAL_POTENTIAL_SYMMETRY", false);
+    /*- Treat external point charges far from the basis functions through multipole expansions
+       when forming the external potential matrix and its gradient. Near charges are still integrated exactly. -*/
+    options.add_bool("EXTERNAL_POTENTIAL_FMM", false);
+    /*- Order of the Cartesian multipole and local expansions of |EXTERNAL_POTENTIAL_FMM|. !expert -*/
+    options.add_int("EXTERNAL_POTENTIAL_FMM_ORDER", 10);
+    /*- Well-separatedness ratio of |EXTERNAL_POTENTIAL_FMM|: charges are expanded when their distance
+       exceeds this multiple of the sum of the box radii. The error falls off as its inverse power of the order. !expert -*/
+    options.add_double("EXTERNAL_POTENTIAL_FMM_WS", 3.0);
+    /*- Edge length [a0] of the boxes of |EXTERNAL_POTENTIAL_FMM|. !expert -*/
+    options.add_double("EXTERNAL_POTENTIAL_FMM_BOX", 6.0);
     /*- Text to be passed directly into CFOUR input files. May contain
     molecule, options, percent blocks, etc. Access through ``cfour {...}``
     block. -*/
@@ -200,6 +220,28 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     See :ref:`Cross-module Redundancies <table:managedmethods>` for details.
     Since v1.4, default for non-orbital-optimized MP2.5 and MP3 is DF. -*/
     options.add_str("MP_TYPE", "CONV", "DF CONV CD");
+    /*- How the SO-basis two-electron integrals are formed for modules that use the
+    integral transformation library (e.g., CCENERGY, DETCI, DCT, OCC). CONV reads the
+    exact integrals from disk, while DF builds them from |globals__df_basis_transform|
+    three-index integrals. -*/
+    options.add_str("TRANSFORM_TEI_TYPE", "CONV", "CONV DF");
+    /*- Auxiliary basis set for density fitting the two-electron integrals of the
+    integral transformation library when |globals__transform_tei_type| is DF.
+    Defaults to a RI basis. -*/
+    options.add_str("DF_BASIS_TRANSFORM", "");
+    /*- Storage of the four-index DPD quantities (integrals, amplitudes, intermediates)
+    written to disk by DPD-based modules such as CCENERGY, CCLAMBDA and CCEOM. ``NONE`` keeps
+    the plain layout; ``LOSSLESS`` stores each symmetry block compressed; ``LOSSY`` also drops
+    the low mantissa bits beyond |globals__dpd_compression_bits| before compressing. -*/
+    options.add_str("DPD_COMPRESSION", "NONE", "NONE LOSSLESS LOSSY");
+    /*- Mantissa bits kept by |globals__dpd_compression| ``LOSSY``; the relative error of each
+    stored element is below $2^{-bits}$. -*/
+    options.add_int("DPD_COMPRESSION_BITS", 40);
+    /*- Memory in MiB, on top of |globals__memory|, for four-index DPD quantities kept in core
+    from one DPD-based module to the next (e.g., the Hbar blocks built by CCHBAR and read again
+    by CCLAMBDA, CCEOM and CCDENSITY). Blocks are reused only while their file is unchanged.
+    Zero turns the cache off. -*/
+    options.add_int("DPD_PERSISTENT_CACHE", 0);
     // The type of integrals to use in coupled cluster computations. DF activates density fitting for the largest
     // integral files, while CONV results in no approximations being made.
     /*- Algorithm to use for CC or CEPA computation (e.g., CCD, CCSD(T), CEPA(3), ACPF, REMP).
@@ -232,12 +274,21 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     /*- Auxiliary basis set for solving Dirac equation in X2C and DKH
         calculations. Defaults to decontracted orbital basis. -*/
     options.add_str("BASIS_RELATIVISTIC", "");
+    /*- How X2C decouples the large and small components. FULL diagonalizes the Dirac matrix of the
+        whole molecule; DLU (diagonal local unitary) decouples each atom on its own and keeps the
+        atomic X and R blocks for reuse by later atoms, geometries, and calculations. !expert -*/
+    options.add_str("X2C_DECOUPLING", "FULL", "FULL DLU");
     /*- Order of Douglas-Kroll-Hess !expert -*/
     options.add_int("DKH_ORDER", 2);
 
     /*- Directory to which to write cube files. Default is the input file
     directory. -*/
     options.add_str_i("CUBEPROP_FILEPATH", ".");
+    /*- File format of the grid properties. ``CUBE`` writes Gaussian cube text files (name.cube). ``RAW``
+    writes compact binary files (name.raw): the 8 bytes ``PSI4RAW1``, the int32 numbers of points along x, y, z,
+    the double origin[3] and spacing[3], the int32 number of atoms followed by Z, x, y, z (doubles) per atom,
+    an int32 comment length and the comment, then the float32 values with z running fastest, as in a cube file. -*/
+    options.add_str("CUBEPROP_FORMAT", "CUBE", "CUBE RAW");
 
     /*- Properties to compute. Valid tasks include:
         ``DENSITY`` - Da, Db, Dt, Ds;
@@ -268,6 +319,13 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     options.add("CUBIC_GRID_SPACING", new ArrayType());
     /*- How many NOONS to print -- used in libscf_solver/uhf.cc and libmints/oeprop.cc -*/
     options.add_str("PRINT_NOONS", "3");
+    /*- Estimated contribution of a shell pair to the ESP or field at a grid point below which the pair is
+    skipped in grid ESP and field evaluations (``GRID_ESP``, ``GRID_FIELD``, and the in-memory grid
+    functions). !expert -*/
+    options.add_double("ESP_GRID_SCREENING", 1.0E-12);
+    /*- Distance [bohr] beyond its extent at which a shell pair contributes to the grid ESP and field through
+    its charge and dipole rather than integrals. 0 evaluates every pair with integrals. !expert -*/
+    options.add_double("ESP_GRID_FAR_FIELD", 0.0);
 
     ///MBIS Options (libmints/oeprop.cc)
 
@@ -300,6 +358,15 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str_i("PCMSOLVER_PARSED_FNAME", "");
         /*- PCM-CCSD algorithm type. -*/
         options.add_str("PCM_CC_TYPE", "PTE", "PTE");
+        /*- Shell pairs whose estimated contribution to the MEP or the PCM potential at a batch of
+        tesserae falls below this are skipped. !expert -*/
+        options.add_double("PCM_SCREENING", 1.0e-12);
+        /*- Update the MEP and the PCM potential in each SCF iteration from the change in the density
+        and in the surface charges, which the screening then mostly discards near convergence. -*/
+        options.add_bool("PCM_INCREMENTAL", false);
+        /*- With PCM_INCREMENTAL, rebuild the MEP and the PCM potential from scratch every this many
+        SCF iterations. -*/
+        options.add_int("PCM_INCREMENTAL_FULL_EVERY", 8);
     }
 
     if (name == "PE" || options.read_globals()) {
@@ -509,8 +576,22 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         if only one root is to be found.
         The ``SEM`` method is the most robust, but it also
         requires $2NM+1$ CI vectors on disk, where $N$ is the maximum number of
-        iterations and $M$ is the number of roots. -*/
-        options.add_str("DIAG_METHOD", "SEM", "RSP DAVIDSON SEM");
+        iterations and $M$ is the number of roots. ``HCI`` replaces the
+        full determinant space of the active orbitals by a heat-bath selected
+        CI space (see |detci__hci_epsilon|); it ignores the RAS restrictions,
+        does not form CI strings, and handles up to 64 active orbitals, so it
+        can be used for CASSCF on active spaces far beyond full CI. -*/
+        options.add_str("DIAG_METHOD", "SEM", "RSP DAVIDSON SEM HCI");
+
+        /*- Selection threshold of ``DIAG_METHOD HCI``: a single or double
+        excitation $|a\rangle$ of a determinant $|i\rangle$ in the space joins the
+        space when $|H_{ai} c_i| >$ |detci__hci_epsilon| for some root.
+        Smaller values give larger spaces closer to the full CI. -*/
+        options.add_double("HCI_EPSILON", 1.0e-4);
+
+        /*- Maximum number of heat-bath selection steps of ``DIAG_METHOD HCI``
+        per diagonalization. -*/
+        options.add_int("HCI_MAXITER", 20);
 
         /*- This specifies the type of preconditioner to use in the selected
         diagonalization method.  The valid options are: ``DAVIDSON`` which
@@ -631,6 +712,13 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         NUM_ROOTS previously converged vectors in the D file; !expert -*/
         options.add_str("GUESS_VECTOR", "H0_BLOCK", "UNIT H0_BLOCK DFILE");
 
+        /*- Do start the first CI diagonalization from the roots converged by the previous CI
+        calculation, as along a potential energy scan? Only used with the default ``H0_BLOCK``
+        guess and the ``SEM`` solver, when both calculations have the same CI space on the same
+        atoms in the same basis, and each active orbital overlaps its counterpart of the previous
+        calculation by at least 0.9; otherwise the usual guess is made. -*/
+        options.add_bool("CI_WARM_START", false);
+
         /*- The number of initial vectors to use in the CI iterative procedure.
         Defaults to the number of roots. !expert -*/
         options.add_int("NUM_INIT_VECS", 0);
@@ -858,6 +946,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         /*- Method to handle the two-electron integrals -*/
         options.add_str("MCSCF_TYPE", "CONV", "DF CONV AO");
 
+        /*- Do keep the AO three-index integrals of a ``DF`` MCSCF after the run and reuse them in the
+        next DF-MCSCF on the same geometry with the same basis sets? The memory stays in use until then. -*/
+        options.add_bool("MCSCF_DF_CACHE", false);
+
         /*- Initial MCSCF starting guess, MP2 natural orbitals only available for DF-RHF reference -*/
         options.add_str("MCSCF_GUESS", "SCF", "MP2 SCF");
 
@@ -1047,6 +1139,9 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("SAPT_DFT_GRAC_SHIFT_B", 0.0);
         /*- Compute the Delta-HF correction? -*/
         options.add_bool("SAPT_DFT_DO_DHF", true);
+        /*- Start the monomer SCFs from the converged orbitals of the previous SAPT(DFT) computation
+        on the same monomers (e.g., the previous point of a scan), projected onto the current basis? -*/
+        options.add_bool("SAPT_DFT_MONOMER_GUESS", false);
         /*- How is the GRAC correction determined? !expert -*/
         options.add_str("SAPT_DFT_GRAC_DETERMINATION", "INPUT", "INPUT");
         /*- Enables the hybrid xc kernel in dispersion? !expert -*/
@@ -1334,6 +1429,15 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_bool("DF_SCF_GUESS", true);
         /*- Keep JK object for later use? -*/
         options.add_bool("SAVE_JK", false);
+        /*- Do time each JK algorithm that builds the same Fock matrix as |globals__scf_type|
+        (``MEM_DF`` and ``DISK_DF`` for the DF types) for one Fock build in the first SCF iterations,
+        and continue with the one cheapest over a typical SCF? The conventional types are not tuned,
+        since a ``PK`` or ``OUT_OF_CORE`` trial would write the whole integral file for one build. -*/
+        options.add_bool("JK_AUTOTUNE", false);
+        /*- Directory (case sensitive) in which |scf__jk_autotune| decisions are kept, keyed by the
+        basis set and its size class, the node, the thread count and the memory class, so that later
+        jobs skip the trial builds. -*/
+        options.add_str_i("JK_AUTOTUNE_CACHE", "");
         /*- Memory safety factor for allocating JK -*/
         options.add_double("SCF_MEM_SAFETY_FACTOR", 0.75);
         /*- SO orthogonalization: automatic, symmetric, or canonical? -*/
@@ -1363,6 +1467,14 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_bool("GUESS_PERSIST", false);
         /*- File name (case sensitive) to which to serialize Wavefunction orbital data. -*/
         options.add_str_i("ORBITALS_WRITE", "");
+        /*- Directory (case sensitive) of an orbital cache shared between psi4 processes. Converged
+        occupied orbitals are stored there under a hash of the molecule, basis set and kind of reference,
+        and a later SCF on exactly the same system starts from them without basis projection. -*/
+        options.add_str_i("ORBITALS_CACHE", "");
+        /*- Wavefunction file (case sensitive) of a nearby geometry of the same molecule in the same
+        basis, as written with ``write_orbitals``. Its occupied orbitals start the SCF, split onto the
+        irreps of the current point group. Set for the displacements of finite-difference computations. -*/
+        options.add_str_i("ORBITALS_GUESS_FILE", "");
 
         /*- Do print the molecular orbitals? -*/
         options.add_bool("PRINT_MOS", false);
@@ -1453,6 +1565,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_int("SOSCF_MAX_ITER", 5);
         /*- Second order convergence threshold. Cease microiterating at this value. -*/
         options.add_double("SOSCF_CONV", 5.0E-3);
+        /*- Do tighten |scf__soscf_conv| from one SOSCF step to the next with the reduction of the orbital
+        gradient (Eisenstat-Walker forcing terms)? Early steps are then solved loosely and late steps
+        accurately, which usually saves Fock builds overall. -*/
+        options.add_bool("SOSCF_ADAPTIVE_CONV", false);
         /*- Do we print the SOSCF microiterations?. -*/
         options.add_bool("SOSCF_PRINT", false);
         /*- Whether to perform stability analysis after convergence.  NONE prevents analysis being
@@ -1486,9 +1602,33 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_int("INCFOCK_FULL_FOCK_EVERY", 5);
         /*- The density threshold at which to stop building the Fock matrix incrementally -*/
         options.add_double("INCFOCK_CONVERGENCE", 1.0e-5);
-
+        /*- Do rebuild the full Fock matrix once an accumulated bound on the contributions neglected by
+        density screening in the incremental builds reaches |scf__incfock_reset_tolerance|,
+        rather than every |scf__incfock_full_fock_every| iterations? Only implemented for |globals__scf_type| ``DIRECT``. -*/
+        options.add_bool("INCFOCK_ADAPTIVE", false);
+        /*- If |scf__incfock_adaptive|, the accumulated bound on the neglected two-electron contributions
+        above which the next Fock matrix is built in full. -*/
+        options.add_double("INCFOCK_RESET_TOLERANCE", 1.0e-6);
+        /*- Do build the J and K matrices of |globals__scf_type| ``DIRECT`` from the symmetry-unique
+        shell quartets only (a skeleton Fock build), symmetrizing the result? Only applies to totally
+        symmetric densities in point groups other than C1; other densities are built in full. -*/
+        options.add_bool("SKELETON_FOCK", false);
+        /*- Looser integral screening threshold for the early SCF iterations of |globals__scf_type| ``DIRECT``.
+        Each Fock build screens with a threshold tied to the latest density change, between this value and
+        |globals__ints_tolerance|; once converged, one more iteration at |globals__ints_tolerance| confirms the
+        energy. Zero (the default), or a value not above |globals__ints_tolerance|, turns the schedule off. -*/
+        options.add_double("INTS_TOLERANCE_EARLY", 0.0);
+
+        /*- Algorithm to form the density from the Fock matrix in the SCF iterations without diagonalizing it.
+        ``TC2`` is trace-correcting purification, built from matrix multiplications only; the occupations per
+        irrep are kept from the previous diagonalization, and the orbitals are diagonalized once more after
+        convergence. Only implemented for RHF/RKS, and not combined with SOSCF, MOM, or fractional occupation. -*/
+        options.add_str("DENSITY_PURIFICATION", "NONE", "NONE TC2");
         /*- The screening tolerance used for ERI/Density sparsity in the LinK algorithm -*/
         options.add_double("LINK_INTS_TOLERANCE", 1.0e-12);
+        /*- Do build the Coulomb/exchange matrices and the DFT exchange-correlation potential at the same time,
+        each on a part of the threads? The split follows the timings of the previous iteration. !expert -*/
+        options.add_bool("SCF_JK_XC_OVERLAP", false);
 
         /*- SUBSECTION Fractional Occupation UHF/UKS -*/
 
@@ -1560,6 +1700,22 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str("DF_INTS_IO", "NONE", "NONE SAVE LOAD");
         /*- Fitting Condition, i.e. eigenvalue threshold for RI basis. Analogous to S_TOLERANCE !expert -*/
         options.add_double("DF_FITTING_CONDITION", 1.0E-10);
+        /*- Coefficient tolerance for the sparse exchange build in |globals__scf_type| ``MEM_DF``. If nonzero,
+        symmetric K builds use Cholesky-localized occupied orbitals, dropping Cholesky vectors whose pivot falls below
+        this value, and skip those orbitals whose coefficients on the significant partners of each basis function
+        fall below it. 0.0 disables the sparse path. !expert -*/
+        options.add_double("MEMDF_SPARSE_K_TOLERANCE", 0.0);
+        /*- Share the in-core three-index integrals of |globals__scf_type| ``MEM_DF`` between concurrent Psi4
+        processes on one node (e.g. N-body or finite-difference runs). The first process to build the integrals
+        for a given basis, geometry and screening publishes them in POSIX shared memory; later processes attach
+        read-only. Not available on Windows. !expert -*/
+        options.add_bool("MEMDF_SHARED_AO", false);
+        /*- Use pair-atomic (local) density fitting in |globals__scf_type| ``MEM_DF``. The fitting coefficients
+        of each AO pair only span the auxiliary functions on its two atoms, so the metric is only inverted in
+        atom-pair blocks. J uses the robust fitting formula. The energy is no longer variational with
+        respect to the fitting and differs from regular DF at the 1E-5 to 1E-4 level. Not available with
+        range-separated functionals. !expert -*/
+        options.add_bool("MEMDF_PAIR_FITTING", false);
         /*- FastDF Fitting Metric -*/
         options.add_str("DF_METRIC", "COULOMB", "COULOMB EWALD OVERLAP");
         /*- FastDF SR Ewald metric range separation parameter -*/
@@ -1590,6 +1746,8 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         /*- Pruning scheme for COSX grids !expert -*/
         options.add_str("COSX_PRUNING_SCHEME", "ROBUST", 
                         "ROBUST TREUTLER NONE FLAT P_GAUSSIAN D_GAUSSIAN P_SLATER D_SLATER LOG_GAUSSIAN LOG_SLATER NONE");
+        /*- Blocking scheme for COSX grids. See |scf__dft_block_scheme|. !expert -*/
+        options.add_str("COSX_BLOCK_SCHEME", "OCTREE", "OCTREE HILBERT");
         /*- Do reduce numerical COSX errors with overlap fitting? !expert -*/
         options.add_bool("COSX_OVERLAP_FITTING", true);
         /*- Do allow for improved COSX screening performance by constructing the Fock matrix incrementally? !expert -*/
@@ -1673,14 +1831,19 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("DFT_BLOCK_MAX_RADIUS", 3.0);
         /*- Remove points from the quadrature grid that exceed the spatial extend of the basis functions. !expert -*/
         options.add_bool("DFT_REMOVE_DISTANT_POINTS",true);
-        /*- The blocking scheme for DFT. !expert -*/
-        options.add_str("DFT_BLOCK_SCHEME", "OCTREE", "NAIVE OCTREE ATOMIC");
+        /*- The blocking scheme for DFT. HILBERT builds the OCTREE blocks and orders them along
+        a Hilbert curve, so consecutive blocks share most of their basis functions. !expert -*/
+        options.add_str("DFT_BLOCK_SCHEME", "OCTREE", "NAIVE OCTREE ATOMIC HILBERT");
         /*- Parameters defining the dispersion correction. See Table
         :ref:`-D Functionals <table:dft_disp>` for default values and Table
         :ref:`Dispersion Corrections <table:dashd>` for the order in which
         parameters are to be specified in this array option.
         Unused for functionals constructed by user. -*/
         options.add("DFT_DISPERSION_PARAMETERS", new ArrayType());
+        /*- Atom pairs farther apart than this [a0] are left out of the -D1, -D2, and -CHG
+            corrections computed in-process by libdisp. Pairs within it are found with a cell
+            list, so the cost grows linearly with system size. 0.0 keeps every pair. !expert -*/
+        options.add_double("DISPERSION_CUTOFF", 0.0);
         /*- Parameters defining the -NL/-V dispersion correction. First b, then C -*/
         options.add("NL_DISPERSION_PARAMETERS", new ArrayType());
         /*- Number of spherical points (A :ref:`Lebedev Points <table:lebedevorder>` number) for VV10 NL integration.
@@ -1690,6 +1853,26 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_int("DFT_VV10_RADIAL_POINTS", 50);
         /*- Rho cutoff for VV10 NL integration. !expert -*/
         options.add_double("DFT_VV10_RHO_CUTOFF", 1.e-8);
+        /*- Store the DFT collocation cache in single precision? About twice as many grid blocks fit in the
+        same memory, at a relative error of about 1.0E-7 in the cached basis function values. !expert -*/
+        options.add_bool("DFT_COLLOCATION_CACHE_FLOAT", false);
+        /*- Keep the DFT collocation cache after the SCF, so that XC gradients and response (TDDFT, CPKS) kernels of
+        the same wavefunction reuse it, where the cached derivative level suffices. !expert -*/
+        options.add_bool("DFT_COLLOCATION_CACHE_KEEP", false);
+        /*- Do build the RKS XC potential incrementally? A grid block whose local density matrix differs by less
+        than |scf__dft_incxc_tolerance| from the one its last contribution was computed with reuses that
+        contribution. Each block stores its local density and potential matrices, which are taken out of the
+        SCF memory before the JK object and the collocation cache are served. !expert -*/
+        options.add_bool("DFT_INCXC", false);
+        /*- Largest change of a local density matrix element for which |scf__dft_incxc| reuses the
+        contribution of a grid block. !expert -*/
+        options.add_double("DFT_INCXC_TOLERANCE", 1.0E-8);
+        /*- Do form the RKS density and XC potential contractions on the grid in single precision (LSDA and GGA
+        functionals)? The SCF switches to double precision once the density error drops below
+        |scf__dft_mixed_precision_threshold|, so converged energies keep full accuracy. !expert -*/
+        options.add_bool("DFT_MIXED_PRECISION", false);
+        /*- The density error below which the SCF leaves |scf__dft_mixed_precision| for double precision. !expert -*/
+        options.add_double("DFT_MIXED_PRECISION_THRESHOLD", 1.0E-4);
         /*- Define VV10 parameter b -*/
         options.add_double("DFT_VV10_B", 0.0);
         /*- Define VV10 parameter C -*/
@@ -1878,8 +2061,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_bool("DIIS", true);
         /*- The algorithm to use for the $\left\langle VV||VV \right\rangle$ terms -*/
         options.add_str("AO_BASIS", "NONE", "NONE DISK DIRECT");
-        /*- Type of ABCD algorithm will be used -*/
-        options.add_str("ABCD", "NEW");
+        /*- Type of ABCD algorithm will be used. ``DF`` (RHF only) builds the
+        $\left\langle ab|cd \right\rangle$ integrals on the fly from the
+        |globals__df_basis_cc| three-index integrals written by |ccenergy__abcd| ``DF``. -*/
+        options.add_str("ABCD", "NEW", "NEW OLD DF");
         /*- Number of important CC amplitudes per excitation level to print.
         CC analog to |detci__num_dets_print|. -*/
         options.add_int("NUM_AMPS_PRINT", 10);
@@ -1984,8 +2169,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         which means that all four-index quantities with up to two virtual-orbital
         indices (e.g., $\left\langle ij | ab \right\rangle$ integrals) may be held in the cache. -*/
         options.add_int("CACHELEVEL", 2);
-        /*- The criterion used to retain/release cached data -*/
-        options.add_str("CACHETYPE", "LRU", "LOW LRU");
+        /*- The criterion used to retain/release cached data. ``COST`` releases the entry
+        with the least reuse rate times measured reload time per byte; ``LOW`` runs as
+        ``LRU`` here, since there are no priorities for this module. -*/
+        options.add_str("CACHETYPE", "LRU", "LRU LOW COST");
         /*- Number of threads -*/
         options.add_int("CC_NUM_THREADS", 1);
         /*- Type of ABCD algorithm will be used -*/
@@ -2271,8 +2458,9 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         If AO_BASIS is ``NONE``, the MO-basis integrals will be used;
         if AO_BASIS is ``DISK``, the AO-basis integrals stored on disk will
         be used; if AO_BASIS is ``DIRECT``, the AO-basis integrals will be computed
-        on the fly as necessary.  NB: The ``DIRECT`` option is not fully
-        implemented and should only be used by experts.  Default is NONE.
+        on the fly as necessary, screened with INTS_TOLERANCE against both the
+        Schwarz bound and the tau amplitudes.  The ``DIRECT`` option is only
+        available for RHF references in C1 symmetry.  Default is NONE.
         Note: The developers recommend use of this keyword only as a last
         resort because it significantly slows the calculation. The current
         algorithms for handling the MO-basis four-virtual-index integrals have
@@ -2291,8 +2479,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         cache used by the libdpd codes. A value of ``LOW`` selects a "low priority"
         scheme in which the deletion of items from the cache is based on
         pre-programmed priorities. A value of LRU selects a "least recently used"
-        scheme in which the oldest item in the cache will be the first one deleted. -*/
-        options.add_str("CACHETYPE", "LOW", "LOW LRU");
+        scheme in which the oldest item in the cache will be the first one deleted.
+        A value of ``COST`` deletes the item of least value per byte, where the value
+        is its reuse rate times its measured reload time, so no priorities are needed,
+        and it also applies to UHF references, for which ``LOW`` falls back to ``LRU``. -*/
+        options.add_str("CACHETYPE", "LOW", "LOW LRU COST");
         /*- Number of threads -*/
         options.add_int("CC_NUM_THREADS", 1);
         /*- Do use DIIS extrapolation to accelerate convergence? -*/
@@ -2303,8 +2494,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         (default) for dipole-polarizabilities, ``ROTATION`` for specific rotations,
         ``ROA`` for Raman Optical Activity, and ``ALL`` for all of the above. -*/
         options.add_str("PROPERTY", "POLARIZABILITY", "POLARIZABILITY ROTATION MAGNETIZABILITY ROA ALL");
-        /*- Type of ABCD algorithm will be used -*/
-        options.add_str("ABCD", "NEW", "NEW OLD");
+        /*- Type of ABCD algorithm will be used. ``DF`` (RHF only) evaluates the
+        particle-particle ladder from |globals__df_basis_cc| three-index integrals
+        instead of the $\left\langle ab|cd \right\rangle$ file, leaving the other
+        terms conventional. -*/
+        options.add_str("ABCD", "NEW", "NEW OLD DF");
         /*- Do simulate the effects of local correlation techniques? -*/
         options.add_bool("LOCAL", 0);
         /*- Value (always between one and zero) for the Broughton-Pulay completeness
@@ -2314,14 +2508,23 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("LOCAL_CUTOFF", 0.02);
         /*- Type of local-CCSD scheme to be simulated. ``WERNER`` selects the method
         developed by H.-J. Werner and co-workers, and ``AOBASIS`` selects the method
-        developed by G.E. Scuseria and co-workers (currently inoperative). -*/
-        options.add_str("LOCAL_METHOD", "WERNER", "WERNER AOBASIS");
+        developed by G.E. Scuseria and co-workers (currently inoperative). ``PNO``
+        (RHF, C1 only) expands the doubles of each occupied pair in its own truncated
+        set of pair natural orbitals, built from the MP2 amplitudes; see
+        |ccenergy__local_pno_cutoff|. This only simulates the PNO truncation: the
+        amplitudes and integrals stay in the full canonical space, so the cost is
+        that of canonical CCSD plus the per-pair projections. For reduced-scaling
+        local correlation use the DLPNO module. -*/
+        options.add_str("LOCAL_METHOD", "WERNER", "WERNER AOBASIS PNO");
         /*- Desired treatment of "weak pairs" in the local-CCSD method. A value of
         ``NEGLECT`` ignores weak pairs entirely. A value of ``NONE`` treats weak pairs in
         the same manner as strong pairs. A value of MP2 uses second-order perturbation
         theory to correct the local-CCSD energy computed with weak pairs ignored. -*/
         options.add_str("LOCAL_WEAKP", "NONE", "NONE NEGLECT MP2");
         // options.add_int("LOCAL_FILTER_SINGLES", 1);
+        /*- Occupation-number threshold for keeping a pair natural orbital when
+        |ccenergy__local_method| is ``PNO`` (cf. |dlpno__t_cut_pno|). -*/
+        options.add_double("LOCAL_PNO_CUTOFF", 1.0e-8);
         /*- Cutoff value for local-coupled-perturbed-Hartree-Fock -*/
         options.add_double("LOCAL_CPHF_CUTOFF", 0.10);
         /*- Definition of local pair domains, default is BP, Boughton-Pulay. -*/
@@ -2387,6 +2590,21 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_bool("OPDM_RELAX", true);
         /*- Do compute one-particle density matrix? -*/
         options.add_bool("ONEPDM", false);
+        /*- Do compute RMP2 energies by Laplace transformation over pivoted Cholesky factors of the
+        AO pseudo-densities? Energies only. -*/
+        options.add_bool("DFMP2_LAPLACE", false);
+        /*- Maximum error in the Laplace quadrature of the orbital energy denominators for |dfmp2__dfmp2_laplace|. -*/
+        options.add_double("DFMP2_LAPLACE_DELTA", 1.0E-6);
+        /*- Pivoted Cholesky tolerance of the pseudo-densities for |dfmp2__dfmp2_laplace|, relative to their
+        largest diagonal. -*/
+        options.add_double("DFMP2_LAPLACE_CHOLESKY_TOLERANCE", 1.0E-12);
+        /*- Exchange-like pair contributions below this Schwarz-type bound are neglected for
+        |dfmp2__dfmp2_laplace|. -*/
+        options.add_double("DFMP2_LAPLACE_PAIR_TOLERANCE", 1.0E-14);
+        /*- Do compute only the opposite-spin energy with |dfmp2__dfmp2_laplace|, skipping the fifth-order
+        exchange-like term (SOS-MP2)? Requires |dfmp2__mp2_ss_scale| = 0. Set automatically for double-hybrid
+        functionals without same-spin correlation. -*/
+        options.add_bool("DFMP2_LAPLACE_OS_ONLY", false);
     }
     if (name == "DFEP2" || options.read_globals()) {
         /*- MODULEDESCRIPTION Performs density-fitted EP2 computations for RHF reference wavefunctions. -*/
@@ -2407,7 +2625,7 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_int("EP2_MAXITER", 20);
     }
     if (name == "DLPNO" || options.read_globals()) {
-        /*- MODULEDESCRIPTION Performs DLPNO-MP2 computations for RHF reference wavefunctions. -*/
+        /*- MODULEDESCRIPTION Performs DLPNO-MP2 and DLPNO-CCSD(T) computations for RHF reference wavefunctions. -*/
 
         /*- SUBSECTION General Options -*/
 
@@ -2426,8 +2644,17 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("R_CONVERGENCE", 1e-6);
         /*- Orbital localizer -*/
         options.add_str("DLPNO_LOCAL_ORBITALS", "BOYS", "BOYS PIPEK_MEZEY");
+        /*- Start the orbital localization from the LMOs of an earlier DLPNO computation on the
+        same system in this process (e.g., the previous step of a geometry optimization or the
+        same fragment in an n-body expansion) -*/
+        options.add_bool("DLPNO_REUSE_LMOS", false);
+        /*- Largest atomic displacement, in bohr, for which |dlpno__dlpno_reuse_lmos| applies -*/
+        options.add_double("DLPNO_REUSE_MAX_DISPLACEMENT", 0.5);
         /*- Maximum number of iterations to determine the MP2 amplitudes. -*/
         options.add_int("DLPNO_MAXITER", 50);
+        /*- Correlation method. CCSD and CCSD_T solve local CCSD in the DLPNO-MP2 PNOs,
+        the latter followed by the semicanonical (T0) correction. Set by the driver. -*/
+        options.add_str("DLPNO_METHOD", "MP2", "MP2 CCSD CCSD_T");
 
         /*- SUBSECTION Expert Options -*/
 
@@ -2451,6 +2678,17 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("S_CUT", 1e-8);
         /*- Fock matrix threshold for treating ampltudes as coupled during local MP2 iterations !expert -*/
         options.add_double("F_CUT", 1e-5);
+        /*- Storage of the PNO/PNO overlaps coupling LMO pairs. CORE precomputes and stores all of
+        them; DIRECT computes them in the local MP2 iterations, keeping recently used ones
+        in a cache of |dlpno__pno_overlap_cache| MiB. !expert -*/
+        options.add_str("PNO_OVERLAP_ALGORITHM", "CORE", "CORE DIRECT");
+        /*- Memory in MiB, over all threads, of the PNO overlap cache with
+        |dlpno__pno_overlap_algorithm| DIRECT. !expert -*/
+        options.add_int("PNO_OVERLAP_CACHE", 1024);
+        /*- Storage of the pair integrals and PNO/PNO overlaps of local CCSD. AUTO stores them if they
+        fit in memory, and otherwise rebuilds the integrals of batches of pairs in each iteration;
+        DIRECT always rebuilds them. !expert -*/
+        options.add_str("DLPNO_CC_ALGORITHM", "AUTO", "AUTO DIRECT");
     }
     if (name == "PSIMRCC" || options.read_globals()) {
         /*- MODULEDESCRIPTION Performs multireference coupled cluster computations.  This theory
@@ -2470,7 +2708,7 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("DAMPING_PERCENTAGE", 0.0);
         /*- Maximum number of error vectors stored for DIIS extrapolation -*/
         options.add_int("DIIS_MAX_VECS", 7);
-        /*- Number of threads -*/
+        /*- Number of threads used by the tensor kernels. Defaults to the number of threads given to Psi4. -*/
         options.add_int("CC_NUM_THREADS", 1);
         /*- Which root of the effective hamiltonian is the target state? -*/
         options.add_int("FOLLOW_ROOT", 1);
@@ -2784,6 +3022,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         which means that all four-index quantities with up to two virtual-orbital
         indices (e.g., $\langle ij | ab \rangle$ integrals) may be held in the cache. -*/
         options.add_int("CACHELEVEL", 2);
+        /*- Do keep the DPD files of integrals and amplitudes in memory for the whole computation?
+        With AUTO they are kept when their estimated size fits in half of the memory not yet
+        granted to other subsystems. The pages live in the PSIO memory arena, which is set up
+        for the computation if there is none yet; with TRUE pages beyond it spill to disk. -*/
+        options.add_str("DPD_INCORE", "AUTO", "AUTO TRUE FALSE");
         /*- Minimum number of error vectors stored for DIIS extrapolation -*/
         options.add_int("DIIS_MIN_VECS", 2);
         /*- Maximum number of error vectors stored for DIIS extrapolation -*/
@@ -2922,6 +3165,8 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_int("PCG_MAXITER", 50);
         /*- Number of vectors used in orbital DIIS -*/
         options.add_int("MO_DIIS_NUM_VECS", 6);
+        /*- Number of previous orbital steps kept by the L-BFGS orbital optimizer (|dfocc__opt_method| LBFGS) -*/
+        options.add_int("MO_LBFGS_NUM_VECS", 8);
         /*- Minimum number of vectors used in amplitude DIIS -*/
         options.add_int("CC_DIIS_MIN_VECS", 2);
         /*- Maximum number of vectors used in amplitude DIIS -*/
@@ -2983,9 +3228,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str("LINEQ_SOLVER", "CDGESV", "CDGESV FLIN POPLE");
         /*- The algorithm for orthogonalization of MOs -*/
         options.add_str("ORTH_TYPE", "MGS", "GS MGS");
-        /*- The orbital optimization algorithm. Presently quasi-Newton-Raphson algorithm available with several Hessian
-         * options. -*/
-        options.add_str("OPT_METHOD", "QNR", "QNR");
+        /*- The orbital optimization algorithm. QNR is the quasi-Newton-Raphson algorithm with several Hessian
+         * options. LBFGS builds the orbital step from the recent steps and MO gradients on top of the diagonal
+         * Hessian chosen by |dfocc__hess_type| (the Fock diagonal for HF); the step history is dropped when the energy
+         * goes up. LBFGS avoids solving the orbital-response equations in every macro-iteration. -*/
+        options.add_str("OPT_METHOD", "QNR", "QNR LBFGS");
         /*- The algorithm will be used for solving the orbital-response equations. The LINEQ option create the MO
           Hessian and solve the simultaneous linear equations with method choosen by the LINEQ_SOLVER option. The PCG
           option does not create the MO Hessian explicitly, instead it solves the simultaneous equations iteratively
@@ -3013,8 +3260,16 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str("MP2_AMP_TYPE", "DIRECT", "DIRECT CONV");
         /*- Type of the CCSD PPL term. -*/
         options.add_str("PPL_TYPE", "AUTO", "LOW_MEM HIGH_MEM CD AUTO");
+        /*- Do keep freed tensor storage for reuse by later tensors of the same size (e.g., the temporaries
+        of each CC iteration)? Only tensors of 1 MiB and more are pooled, and pooled and live tensors stay
+        within the memory not held by other modules when the computation starts. -*/
+        options.add_bool("TENSOR_POOL", true);
         /*- The algorithm to handle (ia|bc) type integrals that used for (T) correction. -*/
         options.add_str("TRIPLES_IABC_TYPE", "DISK", "INCORE AUTO DIRECT DISK");
+        /*- Time in seconds between checkpoints of the (T) progress, or 0 to turn checkpointing off. A job
+        that is killed during the (T) step and rerun with the same scratch directory resumes from the last
+        checkpoint. -*/
+        options.add_int("TRIPLES_CHECKPOINT", 0);
 
         /*- Do compute natural orbitals? -*/
         options.add_bool("NAT_ORBS", false);
@@ -3146,6 +3401,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_bool("COMPUTE_TRIPLES", true);
         /*- Do compute MP4 triples contribution? !expert -*/
         options.add_bool("COMPUTE_MP4_TRIPLES", false);
+        /*- Time in seconds between checkpoints of (T) progress, or 0 to turn
+            checkpointing off. A job that is killed during the (T) step and
+            rerun with the same scratch directory resumes from the last
+            checkpoint. -*/
+        options.add_int("TRIPLES_CHECKPOINT", 0);
         /*- Do use MP2 NOs to truncate virtual space for QCISD/CCSD and (T)? -*/
         options.add_bool("NAT_ORBS", false);
         /*- Cutoff for occupation of MP2 virtual NOs in FNO-QCISD/CCSD(T).
@@ -3202,6 +3462,12 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str("DF_BASIS_CC", "");
         /*- tolerance for Cholesky decomposition of the ERI tensor -*/
         options.add_double("CHOLESKY_TOLERANCE", 1.0e-4);
+        /*- For DF-CCSD, evaluate the (ac|bd) ladder diagram with single-precision
+        integrals and amplitudes until the amplitude residual norm drops below
+        this value, or until it fails to drop by 10% in three successive iterations;
+        the remaining iterations are done in double precision.
+        A value of zero disables single-precision iterations. -*/
+        options.add_double("SINGLE_PRECISION_THRESHOLD", 0.0);
 
         /*- Is this a CEPA job? This parameter is used internally
         by the pythond driver.  Changing its value won't have any
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("quick;casscf;noc1")
+def test_casci_hci():
+    ctest_runner(__file__)
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("cc")
+def test_cc_ao_direct():
+    ctest_runner(__file__)
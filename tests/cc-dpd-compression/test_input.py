@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("cc")
+def test_cc_dpd_compression():
+    ctest_runner(__file__)
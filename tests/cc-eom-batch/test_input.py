@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("cc")
+def test_cc_eom_batch():
+    ctest_runner(__file__)
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("scf")
+def test_density_screen_3():
+    ctest_runner(__file__)
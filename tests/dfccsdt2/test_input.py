@@ -0,0 +1,6 @@
+from addons import *
+
+@ctest_labeler("df;dfccsdt")
+def test_dfccsdt2():
+    ctest_runner(__file__)
+
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("quick;df;dfmp2")
+def test_dfmp2_laplace():
+    ctest_runner(__file__)
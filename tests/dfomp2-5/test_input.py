@@ -0,0 +1,6 @@
+from addons import *
+
+@ctest_labeler("df;dfomp2")
+def test_dfomp2_5():
+    ctest_runner(__file__)
+
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("dft")
+def test_dft_collocation_float():
+    ctest_runner(__file__)
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("dft")
+def test_dft_incxc():
+    ctest_runner(__file__)
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("dft")
+def test_dft_mixed_precision():
+    ctest_runner(__file__)
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("dlpno;cc")
+def test_dlpno_ccsd():
+    ctest_runner(__file__)
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("scf;extern")
+def test_extern_fmm():
+    ctest_runner(__file__)
@@ -0,0 +1,6 @@
+from addons import *
+
+@ctest_labeler("fnocc")
+def test_fnocc8():
+    ctest_runner(__file__)
+
@@ -0,0 +1,16 @@
+import sys
+
+# The pairs are divided only if both ranks joined the DLPNO-MP2 computation; the energy checks of
+# rank 1 go to /dev/null, so a passing rank-1 run shows only as a zero exit status.
+with open(sys.argv[1]) as fp:
+    output = fp.read()
+
+checks = [
+    ("pair distribution reports", output.count("LMO pairs distributed over 2 MPI ranks"), 1),
+    ("passed energy checks", output.count("DLPNO-MP2 energy on rank 0"), 1),
+    ("energy checks of other ranks", output.count("DLPNO-MP2 energy on rank 1"), 0),
+]
+failed = [(label, count, expected) for label, count, expected in checks if count != expected]
+for label, count, expected in failed:
+    print("{}: found {}, expected {}".format(label, count, expected))
+sys.exit(1 if failed else 0)
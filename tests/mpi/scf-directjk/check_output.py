@@ -0,0 +1,17 @@
+import sys
+
+# With output gated to rank 0, the run's output file holds one copy of each header and reports
+# both ranks; ungated ranks would write over each other in the same file.
+with open(sys.argv[1]) as fp:
+    output = fp.read()
+
+checks = [
+    ("DirectJK headers", output.count("==> DirectJK: Integral-Direct J/K Matrices <=="), 1),
+    ("MPI rank reports", output.count("    MPI ranks:                   2"), 1),
+    ("passed energy checks", output.count("DirectJK energy on rank 0"), 1),
+    ("energy checks of other ranks", output.count("DirectJK energy on rank 1"), 0),
+]
+failed = [(label, count, expected) for label, count, expected in checks if count != expected]
+for label, count, expected in failed:
+    print("{}: found {}, expected {}".format(label, count, expected))
+sys.exit(1 if failed else 0)
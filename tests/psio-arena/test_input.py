@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("cc")
+def test_psio_arena():
+    ctest_runner(__file__)
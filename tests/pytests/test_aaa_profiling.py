@@ -51,3 +51,41 @@ def disabled_test_threaded_blas():
     print("   Psi4@n%d : Psi4@n%d ratio (want ~%d): %.2f" % (threads[0], threads[-1], threads[-1], rat2))
     assert pytest.approx(rat1, 0.2) == 1.0
     assert pytest.approx(rat2, 0.8) == threads[-1]
+
+
+def test_timer_json_and_trace(tmp_path):
+    import json
+
+    psi4.geometry("""
+    O
+    H 1 1.0
+    H 1 1.0 2 104.5
+    """)
+    psi4.set_options({"basis": "sto-3g", "scf_type": "pk"})
+
+    psi4.core.clean_timers()
+    psi4.core.set_timer_trace(True)
+    psi4.core.timer_on("test: outer")
+    psi4.core.timer_count("test: flops", 2.0e6)
+    psi4.energy("scf")
+    psi4.core.timer_off("test: outer")
+    psi4.core.set_timer_trace(False)
+
+    psi4.core.timer_write_json(str(tmp_path / "timers.json"))
+    psi4.core.timer_write_trace(str(tmp_path / "trace.json"))
+
+    with open(tmp_path / "timers.json") as fp:
+        timers = json.load(fp)
+    with open(tmp_path / "trace.json") as fp:
+        trace = json.load(fp)
+
+    outer = [t for t in timers["timers"]["children"] if t["name"] == "test: outer"]
+    assert len(outer) == 1
+    assert outer[0]["calls"] == 1
+    assert outer[0]["children"]
+    assert timers["counters"]["test: flops"] == 2.0e6
+    assert timers["max_rss_bytes"] > 0
+
+    spans = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+    assert any(e["name"] == "test: outer" for e in spans)
+    assert all(e["dur"] >= 0.0 for e in spans)
@@ -0,0 +1,47 @@
+import pytest
+import psi4
+from psi4.driver.task_planner import task_planner
+
+pytestmark = [pytest.mark.psi, pytest.mark.api, pytest.mark.cbs]
+
+_water = """
+    O
+    H 1 0.96
+    H 1 0.96 2 104.5
+"""
+
+# DLPNO-MP2 jobs do not provide the conventional MP2 energy, so the two cc-pVDZ jobs stay separate
+_cbs = "mp2/cc-pv[dt]z + D:dlpno-mp2/cc-pvdz"
+
+
+def test_cbs_reference_groups():
+    """The MP2 and DLPNO-MP2 jobs in cc-pVDZ form one reference group; the cc-pVTZ job is alone."""
+
+    mol = psi4.geometry(_water)
+    psi4.set_options({"scf_type": "pk", "mp2_type": "conv"})
+    plan = task_planner("energy", _cbs, mol)
+
+    groups = plan._reference_groups()
+    assert sorted(len(g) for g in groups) == [1, 2]
+    for group in groups:
+        assert len({t.basis for t in group}) == 1
+
+
+def test_cbs_shared_reference():
+    """CBS jobs that start from the SCF orbitals of the first job of their basis give the energies
+    of jobs that each start from SAD."""
+
+    psi4.geometry(_water)
+    psi4.set_options({
+        "scf_type": "pk",
+        "mp2_type": "conv",
+        "e_convergence": 10,
+        "d_convergence": 10,
+    })
+    e = psi4.energy(_cbs)
+
+    # an explicit GUESS turns the sharing off
+    psi4.set_options({"guess": "sad"})
+    ref = psi4.energy(_cbs)
+
+    assert psi4.compare_values(ref, e, 9, "CBS energy with shared SCF references")
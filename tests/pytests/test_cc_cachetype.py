@@ -0,0 +1,47 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water = """
+    0 1
+    O
+    H 1 0.958
+    H 1 0.958 2 104.4776
+"""
+
+_water_cation = """
+    1 2
+    O
+    H 1 1.0
+    H 1 1.0 2 104.5
+"""
+
+
+@pytest.mark.parametrize("reference, method, geometry", [
+    pytest.param("rhf", "ccsd", _water, id="rhf-ccsd"),
+    pytest.param("uhf", "ccsd", _water_cation, id="uhf-ccsd"),
+    pytest.param("rhf", "eom-ccsd", _water, id="rhf-eom-ccsd"),
+])
+def test_cc_cachetype_cost(reference, method, geometry):
+    """CC energies with the COST cache policy match those with the default policy of each module."""
+
+    psi4.geometry(geometry)
+    psi4.set_options({
+        "basis": "6-31g",
+        "reference": reference,
+        "roots_per_irrep": [1, 0, 0, 1],
+        "cachelevel": 6,
+        "e_convergence": 10,
+        "r_convergence": 8,
+    })
+    ref = psi4.energy(method)
+    ref_roots = psi4.variable("CCSD ROOT 1 TOTAL ENERGY") if method == "eom-ccsd" else None
+
+    psi4.set_options({"cachetype": "cost"})
+    e = psi4.energy(method)
+
+    assert psi4.compare_values(ref, e, 9, "{} {} energy with CACHETYPE COST".format(reference, method))
+    if ref_roots is not None:
+        assert psi4.compare_values(ref_roots, psi4.variable("CCSD ROOT 1 TOTAL ENERGY"), 8,
+                                   "EOM-CCSD root 1 with CACHETYPE COST")
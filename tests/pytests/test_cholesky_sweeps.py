@@ -0,0 +1,34 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+
+@pytest.mark.parametrize("reference, charge, multiplicity", [
+    pytest.param("rhf", 0, 1, id="rhf"),
+    pytest.param("uhf", 1, 2, id="uhf"),
+])
+def test_cholesky_sweeps(reference, charge, multiplicity):
+    """A tight Cholesky decomposition of the ERIs, built in blocked pivot sweeps whose unused candidate
+    rows carry over to the next sweep, gives the exact SCF energy."""
+
+    psi4.geometry("""
+        {} {}
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+    """.format(charge, multiplicity))
+    psi4.set_options({
+        "basis": "aug-cc-pvdz",
+        "reference": reference,
+        "scf_type": "pk",
+        "df_scf_guess": False,
+        "e_convergence": 10,
+        "d_convergence": 8,
+    })
+    ref = psi4.energy("scf")
+
+    psi4.set_options({"scf_type": "cd", "cholesky_tolerance": 1.0e-10})
+    e = psi4.energy("scf")
+
+    assert psi4.compare_values(ref, e, 8, "{} CD-SCF energy at a tight tolerance".format(reference.upper()))
@@ -0,0 +1,91 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water = """
+    O
+    H 1 {r}
+    H 1 {r} 2 104.5
+    symmetry c1
+"""
+
+
+def _casci_scan(warm_start):
+    """CASCI energies of two roots at three O-H distances, each point from a fresh SCF."""
+
+    psi4.set_options({
+        "basis": "6-31g",
+        "scf_type": "pk",
+        "restricted_docc": [1],
+        "active": [6],
+        "num_roots": 2,
+        "e_convergence": 10,
+        "r_convergence": 7,
+        "ci_warm_start": warm_start,
+    })
+
+    energies = []
+    for r in [0.95, 1.00, 1.05]:
+        psi4.geometry(_water.format(r=r))
+        psi4.energy("casci")
+        energies.append([psi4.variable("CI ROOT 0 TOTAL ENERGY"), psi4.variable("CI ROOT 1 TOTAL ENERGY")])
+    return energies
+
+
+def test_ci_warm_start_scan():
+    """Starting each scan point from the roots of the previous one converges to the same roots."""
+
+    cold = _casci_scan(False)
+    psi4.core.clean_options()
+    warm = _casci_scan(True)
+
+    for point, (ref, this) in enumerate(zip(cold, warm)):
+        for root in range(2):
+            assert psi4.compare_values(ref[root], this[root], 8, "Point {} root {} warm start".format(point, root))
+
+
+def test_ci_warm_start_other_active_space():
+    """Roots of a CI over another active space are not taken, and the default guess gives the same answer."""
+
+    psi4.geometry(_water.format(r=0.96))
+    psi4.set_options({"basis": "6-31g", "scf_type": "pk", "restricted_docc": [1], "active": [6]})
+    psi4.energy("casci")
+
+    psi4.set_options({"restricted_docc": [2], "active": [5]})
+    ref = psi4.energy("casci")
+
+    psi4.set_options({"restricted_docc": [1], "active": [6]})
+    psi4.energy("casci")
+    psi4.set_options({"restricted_docc": [2], "active": [5], "ci_warm_start": True})
+    this = psi4.energy("casci")
+
+    assert psi4.compare_values(ref, this, 9, "CASCI after a CI over another active space")
+
+
+def test_mcscf_df_cache():
+    """DF-CASSCF reusing the AO integrals of the previous run matches a run that rebuilds them."""
+
+    psi4.geometry(_water.format(r=0.96))
+    psi4.set_options({
+        "basis": "6-31g",
+        "scf_type": "df",
+        "mcscf_type": "df",
+        "restricted_docc": [1],
+        "active": [6],
+        "e_convergence": 10,
+        "mcscf_e_convergence": 1.e-9,
+    })
+    ref = psi4.energy("casscf")
+
+    psi4.set_options({"mcscf_df_cache": True})
+    first = psi4.energy("casscf")
+    cached = psi4.energy("casscf")
+
+    assert psi4.compare_values(ref, first, 8, "DF-CASSCF filling the integral cache")
+    assert psi4.compare_values(ref, cached, 8, "DF-CASSCF reusing the integral cache")
+
+    # switching the option off releases the kept integrals and the result does not change
+    psi4.set_options({"mcscf_df_cache": False})
+    again = psi4.energy("casscf")
+    assert psi4.compare_values(ref, again, 8, "DF-CASSCF after releasing the integral cache")
@@ -0,0 +1,40 @@
+import numpy as np
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+# Blocked matrices whose irrep products go through C_DGEMM_BATCH: tiny blocks done with plain
+# loops, batches with too little work to thread, batches spread over the threads, and a batch
+# with one product large enough to get threaded BLAS to itself
+_shapes = {
+    "tiny": [(3, 2, 4), (1, 5, 2), (0, 3, 3), (4, 4, 1)],
+    "serial": [(20, 30, 10), (25, 25, 25), (8, 16, 4), (30, 5, 40)],
+    "spread": [(60, 70, 50), (40, 90, 60), (80, 30, 70), (64, 64, 64)],
+    "large": [(150, 140, 160), (30, 20, 10), (70, 80, 90), (2, 3, 4)],
+}
+
+
+@pytest.mark.parametrize("nthread", [1, 4])
+@pytest.mark.parametrize("transa, transb", [(False, False), (True, False), (False, True), (True, True)])
+@pytest.mark.parametrize("shapes", list(_shapes.values()), ids=list(_shapes.keys()))
+def test_dgemm_batch(shapes, transa, transb, nthread):
+    """Every irrep block of a batched Matrix.gemm matches the numpy product."""
+
+    rng = np.random.default_rng(7)
+    a = [rng.standard_normal((k, m) if transa else (m, k)) for m, n, k in shapes]
+    b = [rng.standard_normal((n, k) if transb else (k, n)) for m, n, k in shapes]
+    c = [rng.standard_normal((m, n)) for m, n, k in shapes]
+    alpha, beta = 0.7, -1.3
+
+    nthread_saved = psi4.core.get_num_threads()
+    psi4.set_num_threads(nthread)
+    try:
+        C = psi4.core.Matrix.from_array(c)
+        C.gemm(transa, transb, alpha, psi4.core.Matrix.from_array(a), psi4.core.Matrix.from_array(b), beta)
+    finally:
+        psi4.set_num_threads(nthread_saved)
+
+    for h, (ah, bh, ch) in enumerate(zip(a, b, c)):
+        ref = alpha * (ah.T if transa else ah) @ (bh.T if transb else bh) + beta * ch
+        assert psi4.compare_arrays(ref, C.nph[h], 10, "DGEMM batch irrep {}".format(h))
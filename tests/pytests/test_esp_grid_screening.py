@@ -0,0 +1,54 @@
+import numpy as np
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+
+@pytest.fixture
+def water_wfn():
+    psi4.geometry("""
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+    """)
+    psi4.set_options({"basis": "aug-cc-pvdz", "scf_type": "pk", "d_convergence": 10})
+    e, wfn = psi4.energy("scf", return_wfn=True)
+    return wfn
+
+
+def _grid():
+    # points near the molecule, where nothing is screened, out to far away, where most pairs are
+    rng = np.random.default_rng(3)
+    directions = rng.standard_normal((60, 3))
+    directions /= np.linalg.norm(directions, axis=1)[:, None]
+    radii = np.repeat([2.0, 4.0, 8.0, 16.0, 30.0], 12)
+    return psi4.core.Matrix.from_array(directions * radii[:, None])
+
+
+def _esp_and_field(wfn, options):
+    psi4.set_options(options)
+    calc = psi4.core.ESPPropCalc(wfn)
+    grid = _grid()
+    return np.array(calc.compute_esp_over_grid_in_memory(grid)), \
+        np.array(calc.compute_field_over_grid_in_memory(grid))
+
+
+def test_esp_grid_screening(water_wfn):
+    """The default screening gives the grid ESP and field of the unscreened evaluation."""
+
+    esp, field = _esp_and_field(water_wfn, {})
+    esp_exact, field_exact = _esp_and_field(water_wfn, {"esp_grid_screening": 0.0})
+
+    assert psi4.compare_arrays(esp_exact, esp, 9, "screened grid ESP")
+    assert psi4.compare_arrays(field_exact, field, 9, "screened grid field")
+
+
+def test_esp_grid_far_field(water_wfn):
+    """Far pairs taken through their charge and dipole stay close to the integral evaluation."""
+
+    esp_exact, field_exact = _esp_and_field(water_wfn, {"esp_grid_screening": 0.0, "esp_grid_far_field": 0.0})
+    esp, field = _esp_and_field(water_wfn, {"esp_grid_screening": 0.0, "esp_grid_far_field": 6.0})
+
+    assert psi4.compare_arrays(esp_exact, esp, 5, "grid ESP with far-field pairs")
+    assert psi4.compare_arrays(field_exact, field, 5, "grid field with far-field pairs")
@@ -50,3 +50,26 @@ def test_fcidump_mp2_energy():
     fcidump_e = e_dict['SCF TOTAL ENERGY'] + e_dict['MP2 CORRELATION ENERGY']
 
     assert psi4.compare_values(mp2_e, fcidump_e, 5, 'MP2 energy')
+
+
+def test_fcidump_binary_scf_energy():
+    """Compare SCF energy from a binary FCIDUMP against call to energy()"""
+
+    Ne = psi4.geometry("""
+      Ne 0 0 0
+    """)
+
+    psi4.set_options({'basis': 'cc-pVDZ',
+                      'scf_type': 'pk',
+                      'reference': 'rhf',
+                      'd_convergence': 1e-8,
+                      'e_convergence': 1e-8
+                     })
+    scf_e, scf_wfn = psi4.energy('scf', return_wfn=True)
+
+    psi4.fcidump(scf_wfn, fname='FCIDUMP_SCF_BIN', oe_ints=['EIGENVALUES'], binary=True)
+    intdump = psi4.fcidump_from_file('FCIDUMP_SCF_BIN', binary=True)
+    e_dict = psi4.energies_from_fcidump(intdump)
+    fcidump_e = e_dict['SCF TOTAL ENERGY']
+
+    assert psi4.compare_values(scf_e, fcidump_e, 5, 'SCF energy')
@@ -0,0 +1,44 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water = """
+    O
+    H 1 {r}
+    H 1 0.96 2 104.5
+"""
+
+
+def test_findif_orbitals_guess():
+    """Displacements started from the reference orbitals give the same findif gradient as SAD starts."""
+
+    psi4.geometry(_water.format(r=0.96))
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "d_convergence": 10, "e_convergence": 11})
+
+    grad = psi4.gradient("scf", dertype=0)
+
+    # an explicit GUESS keeps every displacement on its own guess
+    psi4.set_options({"guess": "sad"})
+    ref = psi4.gradient("scf", dertype=0)
+
+    assert psi4.compare_values(ref, grad, 8, "findif gradient from the reference orbitals")
+
+
+def test_orbitals_guess_file_lower_symmetry(tmp_path):
+    """A C2v orbital file starts a Cs SCF at a nearby geometry, which converges to the SAD result."""
+
+    fname = str(tmp_path / "reference")
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "d_convergence": 10, "e_convergence": 11})
+    psi4.geometry(_water.format(r=0.96))
+    psi4.energy("scf", write_orbitals=fname)
+
+    psi4.geometry(_water.format(r=0.97))
+    ref = psi4.energy("scf")
+    niter_ref = psi4.variable("SCF ITERATIONS")
+
+    psi4.set_options({"orbitals_guess_file": fname})
+    e = psi4.energy("scf")
+
+    assert psi4.compare_values(ref, e, 9, "SCF energy from the orbitals of a nearby geometry")
+    assert psi4.variable("SCF ITERATIONS") <= niter_ref
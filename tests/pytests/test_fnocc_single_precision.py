@@ -0,0 +1,39 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water = """
+    0 1
+    O
+    H 1 1.0
+    H 1 1.0 2 104.5
+    symmetry c1
+"""
+
+
+@pytest.mark.parametrize("threshold", [
+    pytest.param(1.0e-3, id="switch"),
+    pytest.param(1.0e-14, id="stagnation"),
+])
+def test_fnocc_single_precision(threshold):
+    """DF-CCSD with single-precision ladder iterations converges to the double-precision energy, also when the
+    threshold is below what single precision reaches and the switch comes from the stagnation fallback."""
+
+    psi4.geometry(_water)
+    psi4.set_options({
+        "basis": "cc-pvdz",
+        "scf_type": "df",
+        "cc_type": "df",
+        "qc_module": "fnocc",
+        "freeze_core": True,
+        "e_convergence": 10,
+        "r_convergence": 8,
+        "maxiter": 60,
+    })
+    ref = psi4.energy("ccsd")
+
+    psi4.set_options({"single_precision_threshold": threshold})
+    e = psi4.energy("ccsd")
+
+    assert psi4.compare_values(ref, e, 8, "DF-CCSD with single-precision ladder, threshold {}".format(threshold))
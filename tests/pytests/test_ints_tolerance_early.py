@@ -0,0 +1,50 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water = """
+    0 1
+    O
+    H 1 0.96
+    H 1 0.96 2 104.5
+"""
+
+_water_cation = """
+    1 2
+    O
+    H 1 1.0
+    H 1 1.0 2 104.5
+"""
+
+
+@pytest.mark.parametrize("reference, geometry", [
+    pytest.param("rhf", _water, id="rhf"),
+    pytest.param("uhf", _water_cation, id="uhf"),
+])
+def test_ints_tolerance_early(reference, geometry):
+    """DirectJK with loose screening in the early iterations converges to the energy of the
+    DirectJK build screened at INTS_TOLERANCE throughout, and ends on a build at INTS_TOLERANCE."""
+
+    psi4.geometry(geometry)
+    psi4.set_options({
+        "basis": "cc-pvdz",
+        "reference": reference,
+        "scf_type": "direct",
+        "e_convergence": 10,
+        "d_convergence": 8,
+        "save_jk": True,
+    })
+    ref, ref_wfn = psi4.energy("scf", return_wfn=True)
+    assert not ref_wfn.jk().has_early_cutoff()
+
+    psi4.set_options({"ints_tolerance_early": 1.0e-6})
+    e, wfn = psi4.energy("scf", return_wfn=True)
+
+    label = reference.upper()
+    assert psi4.compare_values(ref, e, 9, "{} energy with INTS_TOLERANCE_EARLY".format(label))
+    assert psi4.compare_arrays(ref_wfn.Da(), wfn.Da(), 7, "{} density with INTS_TOLERANCE_EARLY".format(label))
+    jk = wfn.jk()
+    assert jk.has_early_cutoff()
+    assert psi4.compare_values(psi4.core.get_option("SCF", "INTS_TOLERANCE"), jk.screening_cutoff(), 16,
+                               "final build at INTS_TOLERANCE")
@@ -335,3 +335,73 @@ def test_transpose():
             transposed_mat.set(0, k, j, i)
             i += 1
     assert psi4.compare_matrices(mat.transpose(), transposed_mat)
+
+def test_block_pool():
+    psi4.core.set_block_pool(64 * 1024**2)
+    psi4.core.block_pool_stats(reset=True)
+    try:
+        mat = Matrix("Pooled", 300, 300)
+        mat.np[:] = 1.0
+        del mat
+        # the freed block serves the next matrix of the same size class, zeroed
+        mat = Matrix("Pooled", 299, 300)
+        assert np.all(mat.np == 0.0)
+        stats = psi4.core.block_pool_stats()
+        assert stats["hits"] >= 1
+        assert stats["peak_bytes"] >= 300 * 300 * 8
+    finally:
+        psi4.core.set_block_pool(0)
+    assert psi4.core.block_pool_stats()["pooled_bytes"] == 0
+
+    # a block from the pool is still taken back after the pool is turned off
+    del mat
+    assert psi4.core.block_pool_stats()["live_bytes"] == 0
+
+
+def test_block_pool_off():
+    # with the pool off, matrices bypass it and are not counted
+    psi4.core.set_block_pool(0)
+    before = psi4.core.block_pool_stats(reset=True)
+    mat = Matrix("Unpooled", 300, 300)
+    assert np.all(mat.np == 0.0)
+    del mat
+    after = psi4.core.block_pool_stats()
+    assert after["hits"] == 0 and after["misses"] == 0
+    assert after["live_bytes"] == before["live_bytes"]
+
+def test_axpby():
+    dim = Dimension([3, 2])
+    x = Matrix("X", dim, dim)
+    y = Matrix("Y", dim, dim)
+    for h in range(2):
+        x.nph[h][:] = np.arange(dim[h] * dim[h]).reshape(dim[h], dim[h])
+        y.nph[h][:] = 1.0
+    ref = [2.0 * x.nph[h] - 0.5 * y.nph[h] for h in range(2)]
+    y.axpby(2.0, x, -0.5)
+    for h in range(2):
+        assert compare_arrays(ref[h], y.nph[h], 12, "axpby irrep %d" % h)
+
+def test_from_array_no_copy():
+    data = np.arange(12.0).reshape(3, 4)
+    mat = Matrix.from_array(data, name="Adopted", copy=False)
+    check_dense_mat(mat, 3, 4, "Adopted")
+    assert not mat.owns_data()
+    assert np.shares_memory(mat.np, data)
+    mat.scale(2.0)
+    assert data[2, 3] == 22.0
+
+    # the matrix keeps the array alive
+    del data
+    assert mat.np[2, 3] == 22.0
+    assert compare_arrays(2.0 * np.arange(12.0).reshape(3, 4), mat.clone().np, 12, "clone of adopted")
+
+    blocks = [np.ones((2, 2)), np.empty((0, 3)), np.full((4, 4), 3.0)]
+    mat = Matrix.from_array(blocks, copy=False)
+    check_block_sparse_mat(mat, 3, [2, 0, 4], [2, 3, 4])
+    for h in (0, 2):
+        assert np.shares_memory(mat.nph[h], blocks[h])
+
+    with pytest.raises(psi4.ValidationError):
+        Matrix.from_array(np.ones((4, 4))[:, ::2], copy=False)
+    with pytest.raises(psi4.ValidationError):
+        Matrix.from_array(np.ones((4, 4), dtype=np.float32), copy=False)
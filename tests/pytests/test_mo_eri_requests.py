@@ -0,0 +1,45 @@
+import numpy as np
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+
+def test_mo_eri_requests():
+    """Several MO ERI classes from one AO pass match the single-request mo_eri and the numpy
+    transformation of the AO integrals, including requests flipped to (34|12) and distinct kets."""
+
+    psi4.geometry("""
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        symmetry c1
+    """)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "d_convergence": 10})
+    e, wfn = psi4.energy("scf", return_wfn=True)
+    mints = psi4.core.MintsHelper(wfn.basisset())
+
+    Co = wfn.Ca_subset("AO", "OCC")
+    Cv = wfn.Ca_subset("AO", "VIR")
+    C = wfn.Ca_subset("AO", "ALL")
+    # (ov|ov), (oo|vv), (ov|vv), (vv|ov) (the flip of (ov|vv)), (oo|oo), and a ket with all orbitals
+    requests = [
+        [Co, Cv, Co, Cv],
+        [Co, Co, Cv, Cv],
+        [Co, Cv, Cv, Cv],
+        [Cv, Cv, Co, Cv],
+        [Co, Co, Co, Co],
+        [Co, Cv, C, C],
+    ]
+    results = mints.mo_eri(requests)
+    assert len(results) == len(requests)
+
+    I = mints.ao_eri().np
+    for n, (request, result) in enumerate(zip(requests, results)):
+        C1, C2, C3, C4 = [c.np for c in request]
+        ref = np.einsum("pqrs,pi,qj,rk,sl->ijkl", I, C1, C2, C3, C4, optimize=True)
+        shape = (C1.shape[1] * C2.shape[1], C3.shape[1] * C4.shape[1])
+        assert psi4.compare_arrays(ref.reshape(shape), result.np, 10, "MO ERI request {}".format(n))
+
+        single = mints.mo_eri(*request)
+        assert psi4.compare_arrays(single.np, result.np, 12, "MO ERI request {} against mo_eri".format(n))
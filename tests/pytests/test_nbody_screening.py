@@ -0,0 +1,70 @@
+import itertools
+import math
+
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api, pytest.mark.nbody]
+
+# He chain with the outer atoms 6 A apart
+_he_chain = """
+    He 0.0 0.0 0.0
+    --
+    He 0.0 0.0 3.0
+    --
+    He 0.0 0.0 6.0
+    symmetry c1
+    no_reorient
+    no_com
+"""
+
+
+def test_screened_mbe_coefficients_unscreened():
+    """With every n-mer kept, the screened-expansion coefficients are the binomial ones."""
+
+    from psi4.driver.driver_nbody import _screened_mbe_coefficients
+
+    nfrag = 4
+    kept = {x for n in range(1, nfrag + 1) for x in itertools.combinations(range(1, nfrag + 1), n)}
+    for nb in range(1, nfrag + 1):
+        coefficients = _screened_mbe_coefficients(kept, nb)
+        for k in range(1, nb + 1):
+            expected = math.comb(nfrag - k - 1, nb - k) * (-1)**(nb - k) if nb < nfrag else int(k == nfrag)
+            for x in itertools.combinations(range(1, nfrag + 1), k):
+                assert coefficients.get(x, 0) == expected, (nb, x)
+
+
+@pytest.mark.parametrize("screening", [
+    pytest.param({"screening_distances": {2: 100.0, 3: 100.0}}, id="distance"),
+    pytest.param({"screening_energies": {2: 0.0, 3: 0.0}, "screening_method": "hf"}, id="energy"),
+])
+@pytest.mark.parametrize("bsse_type", ["cp", "nocp"])
+def test_nbody_screening_keeps_all(screening, bsse_type):
+    """Screening that keeps every n-mer reproduces the unscreened many-body energies."""
+
+    psi4.geometry(_he_chain)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "d_convergence": 10})
+    label = "{}-CORRECTED INTERACTION ENERGY THROUGH {}-BODY"
+
+    psi4.energy("scf", bsse_type=bsse_type, max_nbody=3)
+    ref = {nb: psi4.variable(label.format(bsse_type.upper(), nb)) for nb in (2, 3)}
+
+    psi4.energy("scf", bsse_type=bsse_type, max_nbody=3, **screening)
+    for nb in (2, 3):
+        assert psi4.compare_values(ref[nb], psi4.variable(label.format(bsse_type.upper(), nb)), 10,
+                                   "screened {} {}-body interaction energy".format(bsse_type, nb))
+
+
+def test_nbody_screening_truncated_sum():
+    """Dropping the outer dimer, and with it the trimer, sums the kept increments only."""
+
+    mol = psi4.geometry(_he_chain)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "d_convergence": 10})
+
+    e = psi4.energy("scf", bsse_type="nocp", max_nbody=3, return_total_data=True, screening_distances={2: 4.0})
+
+    # E1 + E2 + E3 + (E12 - E1 - E2) + (E23 - E2 - E3)
+    e12 = psi4.energy("scf", molecule=mol.extract_subsets([1, 2]))
+    e23 = psi4.energy("scf", molecule=mol.extract_subsets([2, 3]))
+    e2 = psi4.energy("scf", molecule=mol.extract_subsets(2))
+    assert psi4.compare_values(e12 + e23 - e2, e, 9, "screened NoCP total energy")
@@ -0,0 +1,47 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water = """
+    0 1
+    O
+    H 1 0.958
+    H 1 0.958 2 104.4776
+"""
+
+_water_cation = """
+    1 2
+    O
+    H 1 1.0
+    H 1 1.0 2 104.5
+"""
+
+
+@pytest.mark.parametrize("reference, method, geometry", [
+    pytest.param("rhf", "omp2", _water, id="rhf-omp2"),
+    pytest.param("uhf", "mp3", _water_cation, id="uhf-mp3"),
+])
+def test_occ_dpd_incore(reference, method, geometry):
+    """Conventional OCC gradients with the DPD files held in core match those with the files on disk."""
+
+    psi4.geometry(geometry)
+    psi4.set_options({
+        "basis": "6-31g",
+        "reference": reference,
+        "mp_type": "conv",
+        "mp2_type": "conv",
+        "qc_module": "occ",
+        "e_convergence": 10,
+        "r_convergence": 8,
+        "dpd_incore": "false",
+    })
+    ref_grad = psi4.gradient(method)
+    ref = psi4.variable("CURRENT ENERGY")
+
+    psi4.set_options({"dpd_incore": "true"})
+    grad = psi4.gradient(method)
+
+    assert psi4.compare_values(ref, psi4.variable("CURRENT ENERGY"), 9, "{} energy in core".format(method))
+    assert psi4.compare_values(ref_grad, grad, 8, "{} gradient in core".format(method))
+
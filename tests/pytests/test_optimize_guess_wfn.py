@@ -0,0 +1,42 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water = """
+    O
+    H 1 1.0
+    H 1 1.0 2 110.0
+"""
+
+
+@pytest.mark.parametrize("reference, method", [
+    pytest.param("rhf", "scf", id="rhf-scf"),
+    pytest.param("uhf", "mp2", id="uhf-mp2"),
+])
+def test_optimize_guess_wfn(reference, method):
+    """An optimization that starts every SCF from the previous step's wavefunction in memory reaches
+    the geometry and energy of one that starts every SCF from SAD."""
+
+    psi4.set_options({
+        "basis": "cc-pvdz",
+        "reference": reference,
+        "scf_type": "pk",
+        "mp2_type": "conv",
+        "e_convergence": 10,
+        "d_convergence": 10,
+        "g_convergence": "gau_tight",
+    })
+
+    mol = psi4.geometry(_water)
+    e = psi4.optimize(method, molecule=mol)
+    geom = mol.geometry().np
+
+    # with GUESS_PERSIST, no step takes the orbitals of the one before
+    psi4.set_options({"guess_persist": True, "guess": "sad"})
+    ref_mol = psi4.geometry(_water)
+    ref = psi4.optimize(method, molecule=ref_mol)
+
+    assert psi4.compare_values(ref, e, 9, "{} optimized energy with in-memory guesses".format(method))
+    assert psi4.compare_values(ref_mol.geometry().np, geom, 6,
+                               "{} optimized geometry with in-memory guesses".format(method))
@@ -0,0 +1,47 @@
+import os
+
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_unit = 250
+
+
+def _volume_files(dirs):
+    return [f for d in dirs for f in os.listdir(d) if f.endswith(".{}".format(_unit))]
+
+
+def test_psio_volumes_cleaned(tmp_path):
+    """Striped volumes open under the PSIOManager path of their unit, and psiclean removes every volume
+    unless the unit is retained."""
+
+    psio = psi4.core.IO.shared_object()
+    manager = psi4.core.IOManager.shared_object()
+    dirs = [tmp_path / "a", tmp_path / "b"]
+    for d in dirs:
+        d.mkdir()
+
+    # relative VOLUMEn paths are taken under the scratch path of the unit
+    manager.set_specific_path(_unit, str(tmp_path))
+    psio.filecfg_kwd("PSI", "NVOLUME", _unit, "2")
+    psio.filecfg_kwd("PSI", "VOLUME1", _unit, "a/")
+    psio.filecfg_kwd("PSI", "VOLUME2", _unit, "b/")
+    try:
+        psio.open(_unit, 0)  # PSIO_OPEN_NEW
+        psio.close(_unit, 1)
+        assert len(_volume_files(dirs)) == 2
+        assert all(len(os.listdir(d)) == 1 for d in dirs)
+
+        manager.set_specific_retention(_unit, True)
+        psio.open(_unit, 1)  # PSIO_OPEN_OLD
+        psio.close(_unit, 1)
+        manager.psiclean()
+        assert len(_volume_files(dirs)) == 2
+
+        manager.set_specific_retention(_unit, False)
+        manager.psiclean()
+        assert _volume_files(dirs) == []
+    finally:
+        psio.filecfg_kwd("PSI", "NVOLUME", _unit, "1")
+        manager.set_specific_path(_unit, manager.get_default_path())
@@ -0,0 +1,52 @@
+import copy
+
+import numpy as np
+import pytest
+import qcelemental as qcel
+
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+
+def _inputs():
+    water = {
+        "geometry": [0.0, 0.0, -0.1294769411935893, 0.0, -1.494187339479985, 1.0274465079245698,
+                     0.0, 1.494187339479985, 1.0274465079245698],
+        "symbols": ["O", "H", "H"],
+    }
+    jobs = []
+    for driver, method, basis in [
+        ("energy", "HF", "cc-pVDZ"),
+        ("energy", "MP2", "cc-pVDZ"),
+        ("gradient", "HF", "sto-3g"),
+        ("gradient", "MP2", "6-31g"),
+        ("energy", "nonsense-method", "sto-3g"),
+    ]:
+        jobs.append({
+            "molecule": copy.deepcopy(water),
+            "driver": driver,
+            "model": {"method": method, "basis": basis},
+            "keywords": {"scf_type": "df", "mp2_type": "df", "d_convergence": 10},
+        })
+    return jobs
+
+
+@pytest.mark.parametrize("workers", [1, 2])
+def test_qcschema_batch(workers):
+    """Every job of a batch, run in this process or by worker processes, gives the run_qcschema
+    record of that job; a failing job gives a FailedOperation without stopping the others."""
+
+    ref = [psi4.schema_wrapper.run_qcschema(job) for job in _inputs()]
+
+    # a generator, as for a lazy stream of jobs
+    results = dict(psi4.schema_wrapper.run_qcschema_batch((job for job in _inputs()), workers=workers))
+
+    assert sorted(results) == list(range(len(ref)))
+    for index, (r, ret) in enumerate(zip(ref, (results[i] for i in range(len(ref))))):
+        assert ret.success == r.success, index
+        if not r.success:
+            assert isinstance(ret, qcel.models.FailedOperation)
+            continue
+        assert psi4.compare_values(np.asarray(r.return_result), np.asarray(ret.return_result), 8,
+                                   "batch job {} on {} workers".format(index, workers))
@@ -0,0 +1,35 @@
+import pytest
+import psi4
+from psi4.driver import task_planner
+from psi4.driver.task_base import AtomicComputer
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water = """
+    O
+    H 1 {r}
+    H 1 0.96 2 104.5
+    symmetry c1
+"""
+
+
+@pytest.mark.parametrize("driver", [psi4.energy, psi4.gradient])
+def test_reuse_plan(driver, monkeypatch):
+    """A plan from the first step of a trajectory, as the MDI and i-PI engines keep it, gives the
+    results of a freshly planned call at later geometries, without planning again."""
+
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "df", "d_convergence": 10})
+    mol = psi4.geometry(_water.format(r=0.96))
+    plan = driver("scf", molecule=mol, return_plan=True)
+    assert isinstance(plan, AtomicComputer)
+
+    for r in [0.97, 0.98]:
+        mol = psi4.geometry(_water.format(r=r))
+        ref = driver("scf", molecule=mol)
+
+        with monkeypatch.context() as m:
+            m.setattr(task_planner, "task_planner", lambda *args, **kwargs: pytest.fail("planned again"))
+            result = driver("scf", molecule=mol, reuse_plan=plan)
+
+        assert psi4.compare_values(ref, result, 9, "{} with the plan of the first step at r={}".format(
+            driver.__name__, r))
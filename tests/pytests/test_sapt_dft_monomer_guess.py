@@ -0,0 +1,52 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_dimer = """
+    0 1
+    He 0.0 0.0 0.0
+    --
+    0 1
+    He 0.0 0.0 {r}
+    symmetry c1
+"""
+
+
+def _scan(monomer_guess):
+    psi4.set_options({
+        "basis": "cc-pvdz",
+        "sapt_dft_functional": "pbe0",
+        "sapt_dft_grac_shift_a": 0.0,
+        "sapt_dft_grac_shift_b": 0.0,
+        "e_convergence": 10,
+        "d_convergence": 8,
+        "sapt_dft_monomer_guess": monomer_guess,
+    })
+    energies = []
+    for r in [3.0, 3.2]:
+        psi4.geometry(_dimer.format(r=r))
+        energies.append(psi4.energy("sapt(dft)"))
+    return energies
+
+
+def test_sapt_dft_monomer_guess():
+    """Monomer SCFs started from the previous scan point give the same interaction energies, and only
+    orbitals, occupations and the basis name are kept between the points."""
+
+    from psi4.driver.procrouting.sapt import sapt_proc
+
+    ref = _scan(False)
+    psi4.core.clean_options()
+    sapt_proc._monomer_guess_cache.clear()
+    this = _scan(True)
+
+    for point, (e_ref, e_this) in enumerate(zip(ref, this)):
+        assert psi4.compare_values(e_ref, e_this, 8, "SAPT(DFT) point {} with monomer guesses".format(point))
+
+    assert set(sapt_proc._monomer_guess_cache) == {"HF A", "HF B", "A", "B"}
+    for key, (Ca, Cb, nalphapi, nbetapi, basis_name) in sapt_proc._monomer_guess_cache.values():
+        assert isinstance(Ca, psi4.core.Matrix) and isinstance(Cb, psi4.core.Matrix)
+        assert nalphapi.to_tuple() == (1, ) and nbetapi.to_tuple() == (1, )
+        assert basis_name.upper() == "CC-PVDZ"
+    sapt_proc._monomer_guess_cache.clear()
@@ -0,0 +1,80 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water = """
+    O
+    H 1 0.96
+    H 1 0.96 2 104.5
+"""
+
+
+@pytest.mark.parametrize("save_jk", [False, True])
+def test_scf_jk_grant_released(save_jk):
+    """The SCF JK grant covers the JK estimate only and is given back after the SCF, also with SAVE_JK."""
+
+    psi4.geometry(_water)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "mem_df", "save_jk": save_jk})
+    broker = psi4.core.MemoryBroker.shared_object()
+    available = broker.available()
+
+    e, wfn = psi4.energy("scf", return_wfn=True)
+
+    assert broker.granted("SCF JK") == 0
+    assert broker.granted("SCF DIIS") == 0
+    assert broker.available() == available
+    if save_jk:
+        # memory_jk_ is the grant in doubles, as handed to the JK object
+        assert wfn.memory_jk_ <= wfn.jk().memory_estimate()
+
+
+def test_scf_grants_released_on_failure():
+    """An SCF that fails to converge gives its grants back before the error reaches the caller."""
+
+    psi4.geometry(_water)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "maxiter": 2, "fail_on_maxiter": True})
+    broker = psi4.core.MemoryBroker.shared_object()
+    available = broker.available()
+
+    with pytest.raises(psi4.SCFConvergenceError):
+        psi4.energy("scf")
+
+    assert broker.granted("SCF JK") == 0
+    assert broker.granted("SCF DIIS") == 0
+    assert broker.available() == available
+
+
+def test_cosx_memory_estimate():
+    """The COSX estimate covers the Coulomb metric, the overlap fitting metrics and the grid collocation."""
+
+    psi4.geometry(_water)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "cosx", "save_jk": True})
+    e, wfn = psi4.energy("scf", return_wfn=True)
+
+    nbf = wfn.basisset().nbf()
+    naux = wfn.get_basisset("DF_BASIS_SCF").nbf()
+    estimate = wfn.jk().memory_estimate()
+    assert estimate > naux * naux + 2 * nbf * nbf
+
+
+def test_incxc_memory_grant():
+    """The incremental XC storage is granted out of the SCF memory before JK and given back afterwards."""
+
+    mol = psi4.geometry(_water)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "mem_df", "dft_incxc": True})
+
+    # a local density and V per block, and the quadrature values
+    ref_wfn = psi4.core.Wavefunction.build(mol, psi4.core.get_global_option("BASIS"))
+    V = psi4.driver.proc.scf_wavefunction_factory("b3lyp", ref_wfn, "RHF").V_potential()
+    V.initialize()
+    nbf = ref_wfn.basisset().nbf()
+    nblocks = V.nblocks()
+    assert 6 * nblocks < V.incxc_size() <= nblocks * (2 * nbf * nbf + 6)
+    V.finalize()
+
+    broker = psi4.core.MemoryBroker.shared_object()
+    available = broker.available()
+    psi4.energy("b3lyp")
+    assert broker.granted("SCF incremental XC") == 0
+    assert broker.available() == available
@@ -1,3 +1,5 @@
+import json
+
 import pytest
 
 import psi4
@@ -41,3 +43,305 @@ def test_guess_mix_for_broken_symmetry(inp):
     assert compare_values(refSCF, thisSCF, 10, "Reference energy")
     assert compare_values(refBSSCF, thisBSSCF, 10, "Reference broken-symmetry energy")
 
+
+
+@pytest.mark.parametrize("reference", ["rhf", "uhf"])
+def test_guess_extrapolated_trajectory(reference):
+    """Guess from the densities of the previous steps of a trajectory (ASPC)."""
+
+    psi4.set_options({"reference": reference, "basis": "cc-pvdz", "scf_type": "pk", "e_convergence": 10, "d_convergence": 8})
+
+    def water(step):
+        return psi4.geometry(f"""
+            0 1
+            O
+            H 1 {0.96 + 0.01 * step}
+            H 1 {0.96 + 0.01 * step} 2 104.5
+            symmetry c1
+            """)
+
+    history = []
+    for step in range(3):
+        _, wfn = psi4.energy("scf", molecule=water(step), return_wfn=True)
+        history.append(wfn)
+
+    mol = water(3)
+    refSCF = psi4.energy("scf", molecule=mol)
+    ref_iterations = psi4.variable("SCF ITERATIONS")
+
+    thisSCF = psi4.energy("scf", molecule=mol, guess_wfn=history)
+    this_iterations = psi4.variable("SCF ITERATIONS")
+
+    assert compare_values(refSCF, thisSCF, 9, "Energy from extrapolated guess")
+    assert this_iterations < ref_iterations
+
+
+@pytest.mark.parametrize("reference", ["rks", "uks"])
+@pytest.mark.parametrize("scf_type", ["mem_df", "direct"])
+def test_jk_xc_overlap(reference, scf_type):
+    """J/K and XC built concurrently on split threads give the sequential energy."""
+
+    charge_mult = "0 1" if reference == "rks" else "1 2"
+    psi4.geometry(f"""
+        {charge_mult}
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        symmetry c1
+        """)
+
+    psi4.set_options({"reference": reference, "basis": "cc-pvdz", "scf_type": scf_type, "e_convergence": 10, "d_convergence": 8})
+
+    nthread = psi4.core.get_num_threads()
+    psi4.set_num_threads(4)
+    try:
+        refSCF = psi4.energy("b3lyp")
+
+        psi4.set_options({"scf_jk_xc_overlap": True})
+        thisSCF = psi4.energy("b3lyp")
+    finally:
+        psi4.set_num_threads(nthread)
+
+    assert compare_values(refSCF, thisSCF, 9, "Energy with overlapped J/K and XC builds")
+
+
+@pytest.mark.parametrize("scf_type", ["pk", "df"])
+def test_density_purification(scf_type):
+    """TC2 purification in place of diagonalization converges to the same energy and orbitals."""
+
+    psi4.geometry("""
+        0 1
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        """)
+
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": scf_type, "e_convergence": 10, "d_convergence": 8})
+
+    refSCF, refwfn = psi4.energy("scf", return_wfn=True)
+
+    psi4.set_options({"density_purification": "tc2"})
+    thisSCF, thiswfn = psi4.energy("scf", return_wfn=True)
+
+    assert compare_values(refSCF, thisSCF, 9, "Energy with density purification")
+    assert compare_values(refwfn.epsilon_a(), thiswfn.epsilon_a(), 6, "Orbital energies with density purification")
+
+
+def test_density_purification_soscf():
+    """SOSCF switches purification off and converges to the diagonalization energy and orbitals."""
+
+    psi4.geometry("""
+        0 1
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        """)
+
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "e_convergence": 10, "d_convergence": 8, "soscf": True})
+
+    refSCF, refwfn = psi4.energy("scf", return_wfn=True)
+
+    psi4.set_options({"density_purification": "tc2"})
+    thisSCF, thiswfn = psi4.energy("scf", return_wfn=True)
+
+    assert compare_values(refSCF, thisSCF, 9, "Energy with density purification and SOSCF")
+    assert compare_values(refwfn.epsilon_a(), thiswfn.epsilon_a(), 6, "Orbital energies with purification and SOSCF")
+
+
+@pytest.mark.parametrize("reference", ["uhf", "rohf"])
+def test_density_purification_open_shell(reference):
+    """Purification is RHF/RKS only; open-shell references reject it."""
+
+    psi4.geometry("""
+        0 2
+        O
+        H 1 0.96
+        """)
+
+    psi4.set_options({"basis": "cc-pvdz", "reference": reference, "density_purification": "tc2"})
+
+    with pytest.raises(psi4.ValidationError):
+        psi4.energy("scf")
+
+
+@pytest.mark.long
+def test_density_purification_timing():
+    """On a few hundred basis functions in C1, forming C by purification beats diagonalizing F."""
+
+    import time
+
+    psi4.geometry("""
+        0 1
+        O   -1.551007  -0.114520   0.000000
+        H   -1.934259   0.762503   0.000000
+        H   -0.599677   0.040712   0.000000
+        O    1.350625   0.111469   0.000000
+        H    1.680398  -0.373741  -0.758561
+        H    1.680398  -0.373741   0.758561
+        O   -1.551007  -0.114520   3.000000
+        H   -1.934259   0.762503   3.000000
+        H   -0.599677   0.040712   3.000000
+        O    1.350625   0.111469   3.000000
+        H    1.680398  -0.373741   2.241439
+        H    1.680398  -0.373741   3.758561
+        symmetry c1
+        """)
+
+    psi4.set_options({"basis": "cc-pvtz", "scf_type": "df", "d_convergence": 6})
+    _, wfn = psi4.energy("scf", return_wfn=True)
+
+    def time_form_C(purify):
+        wfn.purify_ = purify
+        wfn.form_C()
+        t0 = time.perf_counter()
+        for _ in range(5):
+            wfn.form_C()
+        return time.perf_counter() - t0
+
+    t_diag = time_form_C(False)
+    t_purify = time_form_C(True)
+    print("form_C: diagonalization {:.3f} s, TC2 purification {:.3f} s".format(t_diag, t_purify))
+    assert t_purify < t_diag
+
+
+@pytest.mark.parametrize("reference", ["rhf", "uhf"])
+def test_soscf_adaptive_conv(reference):
+    """SOSCF with Eisenstat-Walker microiteration tolerances converges to the fixed-tolerance energy."""
+
+    charge_mult = "0 1" if reference == "rhf" else "1 2"
+    psi4.geometry(f"""
+        {charge_mult}
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        """)
+
+    psi4.set_options({"reference": reference, "basis": "cc-pvdz", "scf_type": "pk", "e_convergence": 10, "d_convergence": 8,
+                      "soscf": True, "soscf_max_iter": 10})
+
+    refSCF = psi4.energy("scf")
+
+    psi4.set_options({"soscf_adaptive_conv": True})
+    thisSCF = psi4.energy("scf")
+
+    assert compare_values(refSCF, thisSCF, 9, "Energy with adaptive SOSCF tolerance")
+
+
+@pytest.mark.parametrize("reference", ["rhf", "uhf"])
+def test_orbitals_cache(reference, tmp_path):
+    """A second SCF on the same system starts from the cached orbitals and converges at once."""
+
+    charge_mult = "0 1" if reference == "rhf" else "1 2"
+    psi4.geometry(f"""
+        {charge_mult}
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        """)
+
+    psi4.set_options({"reference": reference, "basis": "cc-pvdz", "scf_type": "pk", "e_convergence": 10, "d_convergence": 8,
+                      "orbitals_cache": str(tmp_path)})
+
+    refSCF = psi4.energy("scf")
+    ref_iterations = psi4.variable("SCF ITERATIONS")
+    assert len(list(tmp_path.glob("*.npz"))) == 1
+
+    thisSCF = psi4.energy("scf")
+    this_iterations = psi4.variable("SCF ITERATIONS")
+
+    assert compare_values(refSCF, thisSCF, 9, "Energy from cached orbitals")
+    assert this_iterations < ref_iterations
+
+
+def test_form_FDSmSDF_in_place():
+    """The preallocated form of the orbital gradient matches the allocating one and allocates nothing."""
+
+    mol = psi4.geometry("""
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        """)
+
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk"})
+
+    wfn = psi4.core.Wavefunction.build(mol, psi4.core.get_global_option("BASIS"))
+    scf_wfn = psi4.driver.procrouting.scf_wavefunction_factory("hf", wfn, "RHF")
+    scf_wfn.initialize()
+    scf_wfn.iterations()
+
+    ref = scf_wfn.form_FDSmSDF(scf_wfn.Fa(), scf_wfn.Da())
+    gradient = psi4.core.Matrix("FDS-SDF", scf_wfn.nmopi(), scf_wfn.nmopi())
+    scf_wfn.form_FDSmSDF(scf_wfn.Fa(), scf_wfn.Da(), gradient)
+    assert psi4.compare_matrices(ref, gradient, 10, "In-place FDS - SDF")
+
+    psi4.core.block_pool_stats(reset=True)
+    scf_wfn.form_FDSmSDF(scf_wfn.Fa(), scf_wfn.Da(), gradient)
+    stats = psi4.core.block_pool_stats()
+    assert stats["hits"] + stats["misses"] == 0
+
+
+@pytest.mark.parametrize("scf_type", ["df", "mem_df", "disk_df"])
+def test_jk_autotune(scf_type, tmp_path):
+    """Trial builds with every exact-equivalent JK algorithm give the plain SCF energy, and the decision is cached."""
+
+    psi4.geometry("""
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        """)
+
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": scf_type, "df_scf_guess": False, "e_convergence": 10,
+                      "d_convergence": 8})
+    refSCF = psi4.energy("scf")
+
+    psi4.set_options({"jk_autotune": True, "jk_autotune_cache": str(tmp_path)})
+    thisSCF = psi4.energy("scf")
+    assert compare_values(refSCF, thisSCF, 9, "Energy with JK autotune")
+
+    with open(tmp_path / "jk_autotune.json") as fp:
+        decisions = json.load(fp)
+    assert len(decisions) == 1
+    entry = list(decisions.values())[0]
+    assert entry["choice"] in entry["build"]
+
+    cachedSCF = psi4.energy("scf")
+    assert compare_values(refSCF, cachedSCF, 9, "Energy with cached JK autotune decision")
+
+
+@pytest.mark.parametrize("scf_type", ["pk", "out_of_core", "direct"])
+def test_jk_autotune_conventional(scf_type, tmp_path):
+    """The conventional types are not tuned: no trial builds, no cached decision."""
+
+    psi4.geometry("""
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        """)
+
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": scf_type, "df_scf_guess": False, "e_convergence": 10,
+                      "d_convergence": 8, "jk_autotune": True, "jk_autotune_cache": str(tmp_path)})
+    psi4.energy("scf")
+    assert not (tmp_path / "jk_autotune.json").exists()
+
+
+def test_memory_broker():
+    """Requests are granted by benefit per byte, and an SCF hands its grants back when done."""
+
+    broker = psi4.core.MemoryBroker.shared_object()
+    broker.request("test big", 100, [(1000, 1.0)])
+    broker.request("test small", 0, [(200, 1.0)])
+    grants = broker.allocate(600)
+    assert grants == {"test big": 400, "test small": 200}
+    assert broker.granted("test big") == 400
+    broker.release("test big")
+    broker.release("test small")
+    assert broker.available() == psi4.core.get_memory()
+
+    psi4.geometry("""
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        """)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "df"})
+    psi4.energy("scf")
+    assert broker.available() == psi4.core.get_memory()
@@ -0,0 +1,61 @@
+import numpy as np
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+
+@pytest.fixture
+def water_density():
+    psi4.geometry("""
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+        symmetry c1
+    """)
+    psi4.set_options({"basis": "aug-cc-pvdz", "scf_type": "pk", "d_convergence": 10})
+    e, wfn = psi4.energy("scf", return_wfn=True)
+    return wfn.basisset(), wfn.Da_subset("AO").np + wfn.Db_subset("AO").np
+
+
+def _sites():
+    # sites close in, where nothing is screened, out to far away, where most pairs are
+    rng = np.random.default_rng(5)
+    directions = rng.standard_normal((50, 3))
+    directions /= np.linalg.norm(directions, axis=1)[:, None]
+    return directions * np.repeat([2.5, 5.0, 10.0, 20.0, 40.0], 10)[:, None]
+
+
+def _site_integrals(basis, xyz):
+    """Field integrals (3, nbf, nbf) at every site, one ElectricFieldInt call per site."""
+
+    mints = psi4.core.MintsHelper(basis)
+    return [np.array([E.np for E in mints.electric_field(list(site))]) for site in xyz]
+
+
+@pytest.mark.parametrize("screening", [0.0, 1.0e-12])
+def test_site_fields(water_density, screening):
+    """Fields and induction operators of SiteFields, unscreened and with the default screening,
+    match the contractions of the per-site field integrals."""
+
+    basis, D = water_density
+    xyz = _sites()
+    ints = _site_integrals(basis, xyz)
+    mu = np.random.default_rng(11).standard_normal((len(xyz), 3))
+
+    ref_field = np.array([np.einsum("kmn,mn->k", E, D) for E in ints])
+    ref_induction = -sum(np.einsum("k,kmn->mn", mu[s], E) for s, E in enumerate(ints))
+
+    sites = psi4.core.SiteFields(basis, psi4.core.Matrix.from_array(xyz), screening=screening)
+    assert sites.nsite() == len(xyz)
+    assert psi4.compare_arrays(ref_field, sites.field(psi4.core.Matrix.from_array(D)).np, 9,
+                               "SiteFields field, screening {}".format(screening))
+    assert psi4.compare_arrays(ref_induction, sites.induction_operator(psi4.core.Matrix.from_array(mu)).np, 9,
+                               "SiteFields induction operator, screening {}".format(screening))
+
+    # MintsHelper goes through SiteFields with the default screening
+    mints = psi4.core.MintsHelper(basis)
+    assert psi4.compare_arrays(
+        ref_field,
+        mints.electric_field_value(psi4.core.Matrix.from_array(xyz), psi4.core.Matrix.from_array(D)).np, 9,
+        "MintsHelper electric_field_value")
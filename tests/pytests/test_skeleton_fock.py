@@ -0,0 +1,53 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_ethylene = """
+    0 1
+    C  0.000000  0.000000  0.667480
+    C  0.000000  0.000000 -0.667480
+    H  0.000000  0.922832  1.237695
+    H  0.000000 -0.922832  1.237695
+    H  0.000000  0.922832 -1.237695
+    H  0.000000 -0.922832 -1.237695
+"""
+
+_options = {
+    "basis": "cc-pvdz",
+    "scf_type": "direct",
+    "df_scf_guess": False,
+    "e_convergence": 10,
+    "d_convergence": 10,
+}
+
+
+@pytest.mark.parametrize("reference, charge", [("rhf", "0 1"), ("uhf", "1 2"), ("rohf", "1 2")])
+def test_skeleton_fock_energy(reference, charge):
+    """D2h SCF energies with the skeleton Fock build match the full build."""
+
+    psi4.geometry(_ethylene.replace("0 1", charge))
+    psi4.set_options(dict(_options, reference=reference))
+    ref = psi4.energy("scf")
+
+    psi4.set_options({"skeleton_fock": True})
+    e = psi4.energy("scf")
+
+    assert psi4.compare_values(ref, e, 9, "{} energy with the skeleton Fock build".format(reference))
+
+
+def test_skeleton_fock_response():
+    """CPHF perturbations outside the totally symmetric irrep fall back to the full build and give the
+    polarizability of the full build."""
+
+    psi4.geometry(_ethylene)
+    psi4.set_options(_options)
+    psi4.properties("scf", properties=["dipole_polarizabilities"])
+    ref = psi4.variable("DIPOLE POLARIZABILITY XX")
+    ref_zz = psi4.variable("DIPOLE POLARIZABILITY ZZ")
+
+    psi4.set_options({"skeleton_fock": True})
+    psi4.properties("scf", properties=["dipole_polarizabilities"])
+
+    assert psi4.compare_values(ref, psi4.variable("DIPOLE POLARIZABILITY XX"), 6, "alpha_xx, skeleton Fock")
+    assert psi4.compare_values(ref_zz, psi4.variable("DIPOLE POLARIZABILITY ZZ"), 6, "alpha_zz, skeleton Fock")
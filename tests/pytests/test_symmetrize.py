@@ -0,0 +1,31 @@
+import pytest
+
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+
+@pytest.mark.parametrize("geom,pg", [
+    pytest.param("""
+        units bohr
+        O  0.000  0.000 -0.124
+        H  0.000  1.447  0.996
+        H  0.000 -1.431  0.985
+        """, "c2v", id="h2o"),
+    # a rectangle with two of its atoms pushed out by 0.015 and two pulled in: equivalent atoms are 0.03 apart,
+    # but their squared distances from the center differ by 0.12
+    pytest.param("""
+        units bohr
+        H  1.612  1.209  0.000
+        H  1.588 -1.191  0.000
+        H -1.588  1.191  0.000
+        H -1.612 -1.209  0.000
+        """, "d2h", id="h4"),
+])
+def test_symmetrize_noisy_geometry(geom, pg):
+    mol = psi4.geometry(geom)
+    mol.update_geometry()
+    assert mol.schoenflies_symbol() != pg
+
+    mol.symmetrize(0.05)
+    assert psi4.compare_strings(pg, mol.schoenflies_symbol(), "symmetrized point group")
@@ -0,0 +1,79 @@
+import glob
+import os
+
+import pytest
+import psi4
+from psi4.driver.task_base import AtomicComputer
+from psi4.driver.task_planner import _task_planner, deduplicate_tasks
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water_dimer = """
+    0 1
+    O  -1.551007  -0.114520   0.000000
+    H  -1.934259   0.762503   0.000000
+    H  -0.599677   0.040712   0.000000
+    --
+    0 1
+    O   1.350625   0.111469   0.000000
+    H   1.680398  -0.373741  -0.758561
+    H   1.680398  -0.373741   0.758561
+    symmetry c1
+    no_reorient
+    no_com
+"""
+
+
+def _atomic_tasks(computer):
+    for task in getattr(computer, "task_list", {}).values():
+        if isinstance(task, AtomicComputer):
+            yield task
+        else:
+            yield from _atomic_tasks(task)
+
+
+def test_task_dedup():
+    """Monomers repeated across model-chemistry levels run once, with the same energies as without sharing."""
+
+    mol = psi4.geometry(_water_dimer)
+    psi4.set_options({"scf_type": "pk", "d_convergence": 10})
+    kwargs = {"bsse_type": "nocp", "return_total_data": True, "levels": {1: "scf/sto-3g", 2: "scf/sto-3g"}}
+
+    ref_plan = _task_planner("energy", "scf", mol, **kwargs)
+    ref_plan.compute()
+    ref = ref_plan.get_psi_results()
+
+    plan = _task_planner("energy", "scf", mol, **kwargs)
+    tasks = list(_atomic_tasks(plan))
+    nunique = len({t.task_hash() for t in tasks})
+    assert nunique < len(tasks)
+    assert deduplicate_tasks(plan) == len(tasks) - nunique
+    assert len({id(t) for t in _atomic_tasks(plan)}) == nunique
+
+    plan.compute()
+    assert psi4.compare_values(ref, plan.get_psi_results(), 10, "NoCP total energy with shared tasks")
+
+
+def test_task_cache(tmp_path):
+    """A second run reads every task from TASK_CACHE and gives the energies of the uncached run."""
+
+    cache = str(tmp_path / "cache")
+    psi4.set_output_file(str(tmp_path / "output.dat"), False)
+    psi4.geometry(_water_dimer)
+    psi4.set_options({"basis": "sto-3g", "scf_type": "pk", "d_convergence": 10})
+
+    ref = psi4.energy("scf", bsse_type="cp")
+
+    psi4.set_options({"task_cache": cache})
+    e_fill = psi4.energy("scf", bsse_type="cp")
+    files = sorted(glob.glob(os.path.join(cache, "*.json")))
+    stamps = [os.path.getmtime(f) for f in files]
+    assert len(files) == 3  # dimer and both monomers in the dimer basis
+    e_read = psi4.energy("scf", bsse_type="cp")
+
+    assert psi4.compare_values(ref, e_fill, 10, "CP energy filling the task cache")
+    assert psi4.compare_values(ref, e_read, 10, "CP energy from the task cache")
+    assert sorted(glob.glob(os.path.join(cache, "*.json"))) == files
+    assert [os.path.getmtime(f) for f in files] == stamps
+    with open(str(tmp_path / "output.dat")) as fp:
+        assert fp.read().count("Reusing the cached result") == 3
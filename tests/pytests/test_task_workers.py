@@ -0,0 +1,66 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_water_dimer = """
+    0 1
+    O  -1.551007  -0.114520   0.000000
+    H  -1.934259   0.762503   0.000000
+    H  -0.599677   0.040712   0.000000
+    --
+    0 1
+    O   1.350625   0.111469   0.000000
+    H   1.680398  -0.373741  -0.758561
+    H   1.680398  -0.373741   0.758561
+    symmetry c1
+    no_reorient
+    no_com
+"""
+
+
+@pytest.fixture
+def psi4_process():
+    """TASK_WORKERS > 1 runs tasks through QCEngine as separate Psi4 processes."""
+
+    import qcengine as qcng
+    from qcengine.exceptions import InputError, ResourceError
+
+    try:
+        qcng.get_program("psi4")
+    except (InputError, ResourceError):
+        pytest.skip("Psi4 cannot be run as a separate process")
+
+
+@pytest.mark.parametrize("workers", [2, 0])
+def test_task_workers_findif(psi4_process, workers):
+    """A gradient by energy differences computed on several workers matches the serial one."""
+
+    psi4.geometry("""
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+    """)
+    psi4.set_options({"basis": "sto-3g", "scf_type": "pk", "d_convergence": 10, "points": 3})
+    ref = psi4.gradient("scf", dertype=0)
+
+    psi4.set_options({"task_workers": workers})
+    grad = psi4.gradient("scf", dertype=0)
+
+    assert psi4.compare_values(ref, grad, 8, "findif gradient on TASK_WORKERS={}".format(workers))
+
+
+def test_task_workers_nbody(psi4_process):
+    """Counterpoise-corrected many-body energies computed on two workers match the serial ones."""
+
+    psi4.geometry(_water_dimer)
+    psi4.set_options({"basis": "6-31g", "scf_type": "df", "d_convergence": 10})
+    ref = psi4.energy("scf", bsse_type="cp")
+    ref_ie = psi4.variable("CP-CORRECTED INTERACTION ENERGY")
+
+    psi4.set_options({"task_workers": 2})
+    e = psi4.energy("scf", bsse_type="cp")
+
+    assert psi4.compare_values(ref, e, 8, "CP total energy on two workers")
+    assert psi4.compare_values(ref_ie, psi4.variable("CP-CORRECTED INTERACTION ENERGY"), 8,
+                               "CP interaction energy on two workers")
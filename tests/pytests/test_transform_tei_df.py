@@ -0,0 +1,40 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+
+def test_transform_tei_df():
+    """Conventional OCC MP2 on density-fitted SO integrals (TRANSFORM_TEI_TYPE DF) matches DF-MP2 in the same
+    auxiliary basis, and a later TRANSFORM_TEI_TYPE CONV run on the same reference is exact again."""
+
+    psi4.geometry("""
+        O
+        H 1 0.96
+        H 1 0.96 2 104.5
+    """)
+    psi4.set_options({
+        "basis": "cc-pvdz",
+        "scf_type": "pk",
+        "d_convergence": 10,
+        "e_convergence": 10,
+    })
+    e, wfn = psi4.energy("scf", return_wfn=True)
+
+    psi4.set_options({"mp2_type": "conv", "qc_module": "occ", "transform_tei_type": "conv"})
+    psi4.energy("mp2", ref_wfn=wfn)
+    conv = psi4.variable("MP2 CORRELATION ENERGY")
+
+    psi4.set_options({"mp2_type": "df", "qc_module": "dfmp2", "df_basis_mp2": "cc-pvdz-ri"})
+    psi4.energy("mp2", ref_wfn=wfn)
+    df = psi4.variable("MP2 CORRELATION ENERGY")
+
+    psi4.set_options({"mp2_type": "conv", "qc_module": "occ", "transform_tei_type": "df",
+                      "df_basis_transform": "cc-pvdz-ri"})
+    psi4.energy("mp2", ref_wfn=wfn)
+    assert psi4.compare_values(df, psi4.variable("MP2 CORRELATION ENERGY"), 8, "MP2 on DF SO integrals")
+    assert wfn.basisset_exists("DF_BASIS_TRANSFORM")
+
+    psi4.set_options({"transform_tei_type": "conv"})
+    psi4.energy("mp2", ref_wfn=wfn)
+    assert psi4.compare_values(conv, psi4.variable("MP2 CORRELATION ENERGY"), 10, "MP2 on exact SO integrals again")
@@ -0,0 +1,39 @@
+import pytest
+import psi4
+
+pytestmark = [pytest.mark.psi, pytest.mark.api]
+
+_options = {
+    "basis": "cc-pvdz-decon",
+    "basis_relativistic": "cc-pvdz-decon",
+    "relativistic": "x2c",
+    "scf_type": "pk",
+    "e_convergence": 10,
+    "d_convergence": 10,
+}
+
+
+def _x2c_energy(decoupling):
+    psi4.set_options(dict(_options, x2c_decoupling=decoupling))
+    return psi4.energy("scf")
+
+
+def test_x2c_dlu_atom():
+    """For a single atom the local decoupling is the full one."""
+
+    psi4.geometry("Ar")
+    ref = _x2c_energy("full")
+    assert psi4.compare_values(ref, _x2c_energy("dlu"), 8, "Ar X2C energy, DLU")
+
+
+def test_x2c_dlu_molecule():
+    """DLU energies of HCl stay close to the full decoupling, also at a second geometry, where the
+    cached atomic blocks are reused."""
+
+    for r in [1.27, 1.35]:
+        psi4.geometry("""
+            H
+            Cl 1 {}
+        """.format(r))
+        ref = _x2c_energy("full")
+        assert psi4.compare_values(ref, _x2c_energy("dlu"), 4, "HCl X2C energy at r={}, DLU".format(r))
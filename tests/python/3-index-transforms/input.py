@@ -139,6 +139,37 @@ for method in methods:
 
                     del dfh
 
+# single-precision disk tensors: same integrals, float32 accuracy
+for form in forms:
+    dfh = psi4.core.DFHelper(primary, aux)
+    dfh.set_method("STORE")
+    dfh.set_memory(mem)
+    dfh.set_MO_core(False)
+    dfh.set_float_disk(True)
+    dfh.initialize()
+
+    for i in spaces:
+        dfh.add_space(i, spaces[i])
+    for i in transformations:
+        j = transformations[i]
+        dfh.add_transformation(i, j[0], j[1], form)
+    dfh.transform()
+
+    test_string = 'Alg: STORE + ' + form + ' single-precision disk'
+    for ind, i in enumerate(transformations):
+        if(form == 'pqQ'):
+            j = space_pairs[ind]
+            dfh_Qmo = np.zeros((sizes[j[0]], sizes[j[1]], naux))
+            for k in range(sizes[j[0]]):
+                dfh_Qmo[k,:,:] = np.asarray(dfh.get_tensor(i, [k, k+1], [0, sizes[j[1]]], [0, naux]))
+            psi4.compare_arrays(dfh_Qmo, Qmo_pqQ[ind], 6, test_string)
+        elif(form == 'pQq'):
+            psi4.compare_arrays(np.asarray(dfh.get_tensor(i)), Qmo_pQq[ind], 6, test_string)
+        else:
+            psi4.compare_arrays(np.asarray(dfh.get_tensor(i)), Qmo[ind], 6, test_string)
+
+    del dfh
+
 # TODO:
 # test tensor slicing grabs
 # test pQq and pqQ builds for store and direct0
@@ -0,0 +1,59 @@
+#! THC factorization of the DF integrals on an ISDF point set: Coulomb and exchange energies against DF
+
+import psi4
+import numpy as np
+
+psi4.set_output_file("output.dat", False)
+
+mol = psi4.geometry("""
+O
+H 1 1.0
+H 1 1.0 2 104.5
+symmetry c1
+""")
+
+psi4.set_options({'basis': 'cc-pVDZ',
+                  'df_basis_scf': 'cc-pVDZ-jkfit',
+                  'scf_type': 'df'})
+
+e, wfn = psi4.energy('scf', return_wfn=True)
+D = np.asarray(wfn.Da())
+
+primary = wfn.basisset()
+aux = psi4.core.BasisSet.build(mol, "DF_BASIS_SCF", "cc-pVDZ-jkfit")
+nbf = primary.nbf()
+naux = aux.nbf()
+
+# DF reference, B^Q_mn = (Q|P)^-1/2 (P|mn)
+mints = psi4.core.MintsHelper(primary)
+zero_bas = psi4.core.BasisSet.zero_ao_basis_set()
+Jmetric_inv = mints.ao_eri(aux, zero_bas, aux, zero_bas)
+Jmetric_inv.power(-0.5, 1.e-12)
+Jmetric_inv = np.squeeze(Jmetric_inv)
+Qpq = np.squeeze(mints.ao_eri(aux, zero_bas, primary, primary))
+Qpq = Jmetric_inv.dot(Qpq.reshape(naux, -1)).reshape(naux, nbf, nbf)
+
+dQ = np.einsum('Qmn,mn->Q', Qpq, D)
+EJ_df = dQ.dot(dQ)
+EK_df = np.einsum('Qml,ls,Qsn,nm->', Qpq, D, Qpq, D)
+
+# THC, (mn|ls) ~= X_mP X_nP Z_PQ X_lQ X_sQ
+thc = psi4.core.THC(primary, aux)
+thc.set_tolerance(1.e-8)
+thc.build()
+X = np.asarray(thc.X())
+Z = np.asarray(thc.Z())
+psi4.compare_integers(nbf, X.shape[0], 'THC X rows')
+psi4.compare_integers(thc.npoint(), Z.shape[0], 'THC Z rows')
+
+XDX = X.T.dot(D).dot(X)
+dP = np.diag(XDX)
+EJ_thc = dP.dot(Z).dot(dP)
+EK_thc = np.sum(Z * XDX * XDX)
+
+psi4.compare_values(EJ_df, EJ_thc, 3, 'THC Coulomb energy')
+psi4.compare_values(EK_df, EK_thc, 3, 'THC exchange energy')
+
+# orbital collocation is C^T X
+C = wfn.Ca_subset("AO", "OCC")
+psi4.compare_arrays(np.asarray(C).T.dot(X), np.asarray(thc.transform(C)), 10, 'THC orbital collocation')
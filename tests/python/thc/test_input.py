@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("quick")
+def test_python_thc():
+    ctest_runner(__file__)
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("scf;cart")
+def test_scf_cosx_grad():
+    ctest_runner(__file__)
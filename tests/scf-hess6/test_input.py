@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("quick;scf;dft;freq;cart")
+def test_scf_hess6():
+    ctest_runner(__file__)
@@ -0,0 +1,5 @@
+from addons import *
+
+@ctest_labeler("scf")
+def test_scf_sparse_k():
+    ctest_runner(__file__)